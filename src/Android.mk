@@ -40,12 +40,14 @@ COMMON_SRC_FILES := \
 	Common/Resource.cpp \
 	Common/Socket.cpp \
 	Common/Thread.cpp \
-	Common/Timer.cpp
+	Common/Timer.cpp \
+	Common/TraceEvents.cpp
 
 COMMON_SRC_FILES += \
 	Main/Config.cpp \
 	Main/FrameBuffer.cpp \
 	Main/FrameBufferAndroid.cpp \
+	Main/FrameBufferYUV.cpp \
 	Main/SwiftConfig.cpp
 
 ifdef use_subzero
@@ -62,6 +64,7 @@ COMMON_SRC_FILES += \
 endif
 
 COMMON_SRC_FILES += \
+	Renderer/ASTC_Decoder.cpp \
 	Renderer/Blitter.cpp \
 	Renderer/Clipper.cpp \
 	Renderer/Color.cpp \
@@ -73,12 +76,14 @@ COMMON_SRC_FILES += \
 	Renderer/Point.cpp \
 	Renderer/QuadRasterizer.cpp \
 	Renderer/Renderer.cpp \
+	Renderer/RoutineStore.cpp \
 	Renderer/Sampler.cpp \
 	Renderer/SetupProcessor.cpp \
 	Renderer/Surface.cpp \
 	Renderer/TextureStage.cpp \
 	Renderer/Vector.cpp \
 	Renderer/VertexProcessor.cpp \
+	Renderer/WorkerPool.cpp \
 
 COMMON_SRC_FILES += \
 	Shader/Constants.cpp \
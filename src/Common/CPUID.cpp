@@ -20,11 +20,14 @@
 	#endif
 	#include <windows.h>
 	#include <intrin.h>
+	#include <immintrin.h>
 	#include <float.h>
 #else
 	#include <unistd.h>
 	#include <sched.h>
 	#include <sys/types.h>
+	#include <dirent.h>
+	#include <stdio.h>
 #endif
 
 namespace sw
@@ -36,6 +39,10 @@ namespace sw
 	bool CPUID::SSE3 = detectSSE3();
 	bool CPUID::SSSE3 = detectSSSE3();
 	bool CPUID::SSE4_1 = detectSSE4_1();
+	bool CPUID::AVX = detectAVX();
+	bool CPUID::AVX2 = detectAVX2();
+	bool CPUID::FMA = detectFMA();
+	bool CPUID::AVX512F = detectAVX512F();
 	int CPUID::cores = detectCoreCount();
 	int CPUID::affinity = detectAffinity();
 
@@ -178,6 +185,60 @@ namespace sw
 		#endif
 	}
 
+	static void cpuid(int registers[4], int info, int subinfo)
+	{
+		#if defined(__i386__) || defined(__x86_64__)
+			#if defined(_WIN32)
+				__cpuidex(registers, info, subinfo);
+			#else
+				__asm volatile("cpuid": "=a" (registers[0]), "=b" (registers[1]), "=c" (registers[2]), "=d" (registers[3]): "a" (info), "c" (subinfo));
+			#endif
+		#else
+			registers[0] = 0;
+			registers[1] = 0;
+			registers[2] = 0;
+			registers[3] = 0;
+		#endif
+	}
+
+	// Register state the OS saves on context switches, as enabled in XCR0
+	static unsigned int enabledState()
+	{
+		int registers[4];
+		cpuid(registers, 1);
+
+		if((registers[2] & 0x08000000) == 0)   // OSXSAVE
+		{
+			return 0;
+		}
+
+		#if defined(__i386__) || defined(__x86_64__)
+			#if defined(_WIN32)
+				return static_cast<unsigned int>(_xgetbv(0));
+			#else
+				unsigned int eax, edx;
+				__asm volatile(".byte 0x0F, 0x01, 0xD0": "=a" (eax), "=d" (edx): "c" (0));   // xgetbv
+				return eax;
+			#endif
+		#else
+			return 0;
+		#endif
+	}
+
+	static bool supportsExtendedLeaf(int registers[4])
+	{
+		cpuid(registers, 0);
+
+		if(registers[0] < 7)
+		{
+			return false;
+		}
+
+		cpuid(registers, 7, 0);
+
+		return true;
+	}
+
 	bool CPUID::detectMMX()
 	{
 		int registers[4];
@@ -227,6 +288,36 @@ namespace sw
 		return SSE4_1 = (registers[2] & 0x00080000) != 0;
 	}
 
+	bool CPUID::detectAVX()
+	{
+		int registers[4];
+		cpuid(registers, 1);
+		bool ymm = (enabledState() & 0x06) == 0x06;   // XMM and YMM state
+		return AVX = ymm && (registers[2] & 0x10000000) != 0;
+	}
+
+	bool CPUID::detectAVX2()
+	{
+		int registers[4];
+		bool leaf7 = supportsExtendedLeaf(registers);
+		return AVX2 = detectAVX() && leaf7 && (registers[1] & 0x00000020) != 0;
+	}
+
+	bool CPUID::detectFMA()
+	{
+		int registers[4];
+		cpuid(registers, 1);
+		return FMA = detectAVX() && (registers[2] & 0x00001000) != 0;
+	}
+
+	bool CPUID::detectAVX512F()
+	{
+		int registers[4];
+		bool leaf7 = supportsExtendedLeaf(registers);
+		bool zmm = (enabledState() & 0xE6) == 0xE6;   // Opmask and upper ZMM state
+		return AVX512F = detectAVX() && zmm && leaf7 && (registers[1] & 0x00010000) != 0;
+	}
+
 	int CPUID::detectCoreCount()
 	{
 		int cores = 0;
@@ -251,7 +342,6 @@ namespace sw
 		#endif
 
 		if(cores < 1)  cores = 1;
-		if(cores > 16) cores = 16;
 
 		return cores;   // FIXME: Number of physical cores
 	}
@@ -275,16 +365,121 @@ namespace sw
 
 				processAffinityMask >>= 1;
 			}
+		#elif defined(__linux__)
+			cpu_set_t affinity;
+
+			if(sched_getaffinity(0, sizeof(affinity), &affinity) == 0)
+			{
+				cores = CPU_COUNT(&affinity);
+			}
+			else
+			{
+				return detectCoreCount();
+			}
 		#else
 			return detectCoreCount();   // FIXME: Assumes no affinity limitation
 		#endif
 
 		if(cores < 1)  cores = 1;
-		if(cores > 16) cores = 16;
 
 		return cores;
 	}
 
+	int CPUID::affinityProcessors(int *processor, int *node, int capacity)
+	{
+		int count = 0;
+
+		#if defined(_WIN32)
+			DWORD_PTR processAffinityMask = 1;
+			DWORD_PTR systemAffinityMask = 1;
+
+			if(!GetProcessAffinityMask(GetCurrentProcess(), &processAffinityMask, &systemAffinityMask))
+			{
+				return 0;
+			}
+
+			for(int i = 0; processAffinityMask && count < capacity; i++, processAffinityMask >>= 1)
+			{
+				if(processAffinityMask & 1)
+				{
+					processor[count] = i;
+					node[count] = detectNode(i);
+					count++;
+				}
+			}
+		#elif defined(__linux__)
+			cpu_set_t affinity;
+
+			if(sched_getaffinity(0, sizeof(affinity), &affinity) != 0)
+			{
+				return 0;
+			}
+
+			for(int i = 0; i < CPU_SETSIZE && count < capacity; i++)
+			{
+				if(CPU_ISSET(i, &affinity))
+				{
+					processor[count] = i;
+					node[count] = detectNode(i);
+					count++;
+				}
+			}
+		#else
+			return 0;
+		#endif
+
+		// Stable insertion sort by node, keeping sibling processors adjacent
+		for(int i = 1; i < count; i++)
+		{
+			int p = processor[i];
+			int n = node[i];
+			int j = i;
+
+			for(; j > 0 && node[j - 1] > n; j--)
+			{
+				processor[j] = processor[j - 1];
+				node[j] = node[j - 1];
+			}
+
+			processor[j] = p;
+			node[j] = n;
+		}
+
+		return count;
+	}
+
+	int CPUID::detectNode(int processor)
+	{
+		int node = 0;
+
+		#if defined(_WIN32)
+			UCHAR number = 0;
+
+			if(GetNumaProcessorNode((UCHAR)processor, &number))
+			{
+				node = number;
+			}
+		#elif defined(__linux__)
+			char path[64];
+			sprintf(path, "/sys/devices/system/cpu/cpu%d", processor);
+
+			if(DIR *dir = opendir(path))
+			{
+				while(dirent *entry = readdir(dir))
+				{
+					if(sscanf(entry->d_name, "node%d", &node) == 1)
+					{
+						break;
+					}
+				}
+
+				closedir(dir);
+			}
+		#endif
+
+		return node;
+	}
+
 	void CPUID::setFlushToZero(bool enable)
 	{
 		#if defined(_MSC_VER)
@@ -36,9 +36,21 @@ namespace sw
 		static bool supportsSSE3();
 		static bool supportsSSSE3();
 		static bool supportsSSE4_1();
+
+		// 256-bit and 512-bit vector extensions, only reported when the OS preserves their registers.
+		// None of the JIT backends can encode VEX or EVEX instructions yet, so these don't affect code generation.
+		static bool supportsAVX();
+		static bool supportsAVX2();
+		static bool supportsFMA();
+		static bool supportsAVX512F();
+
 		static int coreCount();
 		static int processAffinity();
 
+		// Lists the logical processors available to the process, grouped by NUMA node.
+		// Returns the number of entries written, or 0 when this can't be determined.
+		static int affinityProcessors(int *processor, int *node, int capacity);
+
 		static void setEnableMMX(bool enable);
 		static void setEnableCMOV(bool enable);
 		static void setEnableSSE(bool enable);
@@ -58,6 +70,10 @@ namespace sw
 		static bool SSE3;
 		static bool SSSE3;
 		static bool SSE4_1;
+		static bool AVX;
+		static bool AVX2;
+		static bool FMA;
+		static bool AVX512F;
 		static int cores;
 		static int affinity;
 
@@ -76,8 +92,13 @@ namespace sw
 		static bool detectSSE3();
 		static bool detectSSSE3();
 		static bool detectSSE4_1();
+		static bool detectAVX();
+		static bool detectAVX2();
+		static bool detectFMA();
+		static bool detectAVX512F();
 		static int detectCoreCount();
 		static int detectAffinity();
+		static int detectNode(int processor);
 	};
 }
 
@@ -123,6 +144,26 @@ namespace sw
 		return SSE4_1 && enableSSE4_1;
 	}
 
+	inline bool CPUID::supportsAVX()
+	{
+		return AVX;
+	}
+
+	inline bool CPUID::supportsAVX2()
+	{
+		return AVX2;
+	}
+
+	inline bool CPUID::supportsFMA()
+	{
+		return FMA;
+	}
+
+	inline bool CPUID::supportsAVX512F()
+	{
+		return AVX512F;
+	}
+
 	inline int CPUID::coreCount()
 	{
 		return cores;
@@ -29,9 +29,10 @@ using namespace std;
 
 namespace sw
 {
-	Configurator::Configurator(string iniPath)
+	Configurator::Configurator(string iniPath, string environmentPrefix)
 	{
 		path = iniPath;
+		this->environmentPrefix = environmentPrefix;
 
 		readFile();
 	}
@@ -205,6 +206,21 @@ namespace sw
 
 	string Configurator::getValue(string keyName, string valueName, string defaultValue) const
 	{
+		if(!environmentPrefix.empty())
+		{
+			string variable = environmentPrefix + keyName + "_" + valueName;
+
+			for(char &c : variable)
+			{
+				c = toupper(c);
+			}
+
+			if(const char *value = getenv(variable.c_str()))
+			{
+				return value;
+			}
+		}
+
 		int keyID = findKey(keyName);
 		if(keyID == -1) return defaultValue;
 		int valueID = findValue((unsigned int)keyID, valueName);
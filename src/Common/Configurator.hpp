@@ -25,7 +25,8 @@ namespace sw
 	class Configurator
 	{
 	public:
-		Configurator(std::string iniPath = "");
+		// With an environment prefix, variables named <prefix><SECTION>_<NAME> in upper case take precedence over the file
+		Configurator(std::string iniPath = "", std::string environmentPrefix = "");
 
 		~Configurator();
 
@@ -51,6 +52,7 @@ namespace sw
 		int findValue(unsigned int sectionID, std::string valueName) const;
 
 		std::string path;
+		std::string environmentPrefix;
 
 		struct Section
 		{
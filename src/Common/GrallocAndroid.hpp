@@ -56,8 +56,14 @@ public:
 		}
 	}
 
-	int unlock(buffer_handle_t handle)
+	// Without a releaseFence to hand the fence to, waits until the writes are visible to other users of the buffer
+	int unlock(buffer_handle_t handle, int *releaseFence = nullptr)
 	{
+		if(releaseFence)
+		{
+			*releaseFence = -1;
+		}
+
 		switch(m_major_version)
 		{
 		case 0:
@@ -71,8 +77,15 @@ public:
 				int error = m_gralloc1_unlock(m_gralloc1_device, handle, &fenceFd);
 				if (!error)
 				{
-					sync_wait(fenceFd, -1);
-					close(fenceFd);
+					if(releaseFence)
+					{
+						*releaseFence = fenceFd;
+					}
+					else if(fenceFd >= 0)
+					{
+						sync_wait(fenceFd, -1);
+						close(fenceFd);
+					}
 				}
 				return error;
 			}
@@ -23,15 +23,27 @@
 	#endif
 	#include <windows.h>
 	#include <intrin.h>
+	#include <io.h>
 #else
 	#include <errno.h>
 	#include <sys/mman.h>
+	#include <sys/stat.h>
 	#include <stdlib.h>
 	#include <unistd.h>
 #endif
 
 #include <memory.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define USE_SSE2_CLEAR 1
+#endif
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #undef allocate
 #undef deallocate
 
@@ -45,11 +57,46 @@ namespace
 {
 struct Allocation
 {
-//	size_t bytes;
+	size_t bytes;   // Of the whole block
 	unsigned char *block;
+	size_t hugePages;   // Bytes advised to be backed by huge pages
+	MemoryCategory category;
+};
+
+enum
+{
+	HUGE_PAGE_SIZE = 2 * 1024 * 1024,
 };
 
-void *allocateRaw(size_t bytes, size_t alignment)
+std::atomic<size_t> hugePageThreshold(0);
+std::atomic<size_t> hugePageAllocationCount(0);
+std::atomic<size_t> hugePageByteCount(0);
+
+struct MemoryCounter
+{
+	std::atomic<size_t> current;
+	std::atomic<size_t> peak;
+};
+
+MemoryCounter memoryCounters[MEMORY_CATEGORIES] = {};
+
+void addMemoryUsage(MemoryCategory category, size_t bytes)
+{
+	MemoryCounter &counter = memoryCounters[category];
+	size_t current = counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	size_t peak = counter.peak.load(std::memory_order_relaxed);
+
+	while(current > peak && !counter.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+	{
+	}
+}
+
+void subtractMemoryUsage(MemoryCategory category, size_t bytes)
+{
+	memoryCounters[category].current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void *allocateRaw(size_t bytes, size_t alignment, MemoryCategory category)
 {
 	ASSERT((alignment & (alignment - 1)) == 0);   // Power of 2 alignment.
 
@@ -63,7 +110,8 @@ void *allocateRaw(size_t bytes, size_t alignment)
 		}
 		return allocation;
 	#else
-		unsigned char *block = new unsigned char[bytes + sizeof(Allocation) + alignment];
+		size_t blockBytes = bytes + sizeof(Allocation) + alignment;
+		unsigned char *block = new unsigned char[blockBytes];
 		unsigned char *aligned = nullptr;
 
 		if(block)
@@ -71,15 +119,23 @@ void *allocateRaw(size_t bytes, size_t alignment)
 			aligned = (unsigned char*)((uintptr_t)(block + sizeof(Allocation) + alignment - 1) & -(intptr_t)alignment);
 			Allocation *allocation = (Allocation*)(aligned - sizeof(Allocation));
 
-		//	allocation->bytes = bytes;
+			allocation->bytes = blockBytes;
 			allocation->block = block;
+			allocation->hugePages = 0;
+			allocation->category = category;
+
+			addMemoryUsage(category, blockBytes);
 		}
 
 		return aligned;
 	#endif
 }
 
-#if defined(LINUX_ENABLE_NAMED_MMAP)
+#if defined(__linux__)
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
 // Create a file descriptor for anonymous memory with the given
 // name. Returns -1 on failure.
 // TODO: remove once libc wrapper exists.
@@ -104,7 +160,9 @@ int memfd_create(const char* name, unsigned int flags)
 		return -1;
 	#endif
 }
+#endif  // defined(__linux__)
 
+#if defined(LINUX_ENABLE_NAMED_MMAP)
 // Returns a file descriptor for use with an anonymous mmap, if
 // memfd_create fails, -1 is returned. Note, the mappings should be
 // MAP_PRIVATE so that underlying pages aren't shared.
@@ -126,6 +184,426 @@ void ensureAnonFileSize(int anonFd, size_t length)
 }
 #endif  // defined(LINUX_ENABLE_NAMED_MMAP)
 
+enum Protection
+{
+	PROTECTION_READ_WRITE,
+	PROTECTION_READ_EXECUTE,
+};
+
+void *mapPages(size_t length)
+{
+	void *mapping;
+
+	#if defined(_WIN32)
+		mapping = VirtualAlloc(nullptr, length, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	#else
+		#if defined(LINUX_ENABLE_NAMED_MMAP)
+			// Try to name the memory region for the executable code,
+			// to aid profilers.
+			int anonFd = anonymousFd();
+			if(anonFd != -1)
+			{
+				ensureAnonFileSize(anonFd, length);
+				mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+				               MAP_PRIVATE, anonFd, 0);
+			}
+			else
+		#endif
+		{
+			mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+			               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		}
+
+		if(mapping == MAP_FAILED)
+		{
+			mapping = nullptr;
+		}
+	#endif
+
+	return mapping;
+}
+
+void unmapPages(void *mapping, size_t length)
+{
+	#if defined(_WIN32)
+		VirtualFree(mapping, 0, MEM_RELEASE);
+	#else
+		munmap(mapping, length);
+	#endif
+}
+
+// Maps the same memory twice, writable at the returned address and executable at the alias, so code can
+// be added to pages other routines are running from. Only x86-64 code gets rebased to run at the alias,
+// see Routine::rebaseCode(). Returns null where the memory can't be mapped twice.
+void *mapDualPages(size_t length, void *&executable)
+{
+	#if defined(__linux__) && defined(__x86_64__)
+		int fd = memfd_create("SwiftShader JIT", MFD_CLOEXEC);
+
+		if(fd == -1)
+		{
+			return nullptr;
+		}
+
+		void *mapping = MAP_FAILED;
+		executable = MAP_FAILED;
+
+		if(ftruncate(fd, length) == 0)
+		{
+			mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			executable = mmap(nullptr, length, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+		}
+
+		close(fd);   // The mappings keep the memory
+
+		if(mapping == MAP_FAILED || executable == MAP_FAILED)
+		{
+			if(mapping != MAP_FAILED) munmap(mapping, length);
+			if(executable != MAP_FAILED) munmap(executable, length);
+
+			executable = nullptr;
+			return nullptr;
+		}
+
+		return mapping;
+	#else
+		return nullptr;
+	#endif
+}
+
+bool protectPages(void *memory, size_t length, Protection protection)
+{
+	#if defined(_WIN32)
+		const DWORD flags[] = {PAGE_READWRITE, PAGE_EXECUTE_READ};
+		unsigned long oldProtection;
+		return VirtualProtect(memory, length, flags[protection], &oldProtection) != 0;
+	#else
+		const int flags[] = {PROT_READ | PROT_WRITE, PROT_READ | PROT_EXEC};
+		return mprotect(memory, length, flags[protection]) == 0;
+	#endif
+}
+
+// Packs generated code into large mappings instead of giving each routine its own mapping, without any
+// page ever being writable and executable at once. Where the memory can be mapped twice, routines are
+// written through a writable view and run from an executable alias of it, so they share pages. Otherwise
+// routines get whole pages, which are writable while the code is being written and executable once it's
+// marked executable. Those freed pages are made writable again when they get reused.
+class ExecutableMemory
+{
+public:
+	void *allocate(size_t bytes);
+	const void *executableAddress(const void *memory);
+	bool markExecutable(void *memory);
+	void shrink(void *memory, size_t bytes);
+	void deallocate(void *memory);
+
+private:
+	enum
+	{
+		CHUNK_SIZE = 256 * 1024,
+		ALIGNMENT = 64,   // Of routines sharing pages, a cache line
+	};
+
+	struct Chunk
+	{
+		unsigned char *base;
+		unsigned char *executable;       // The alias of the base when mapped twice, otherwise the base
+		size_t size;
+		size_t granularity;              // Of the allocations, whole pages unless mapped twice
+		size_t allocated;
+		std::map<size_t, size_t> free;   // Offset to size of the unallocated ranges
+		std::vector<Protection> pages;   // Unused when mapped twice, both views keep their protection
+	};
+
+	struct Allocation
+	{
+		Chunk *chunk;
+		size_t size;
+		bool writable;
+	};
+
+	Chunk *createChunk(size_t bytes);
+	void release(Chunk *chunk, size_t offset, size_t size);
+	bool protect(Chunk *chunk, size_t offset, size_t size, Protection protection);
+	static size_t roundUp(size_t bytes, size_t granularity);   // At least one unit
+
+	std::mutex mutex;
+	std::vector<Chunk*> chunks;
+	std::map<uintptr_t, Allocation> allocations;
+	bool dualMapping = true;   // Not retried once mapping memory twice failed
+};
+
+void *ExecutableMemory::allocate(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	Chunk *chunk = nullptr;
+	std::map<size_t, size_t>::iterator range;
+	size_t size = 0;
+
+	for(Chunk *candidate : chunks)   // First fit, to keep the code densely packed
+	{
+		size = roundUp(bytes, candidate->granularity);
+
+		for(range = candidate->free.begin(); range != candidate->free.end(); range++)
+		{
+			if(range->second >= size)
+			{
+				chunk = candidate;
+				break;
+			}
+		}
+
+		if(chunk)
+		{
+			break;
+		}
+	}
+
+	if(!chunk)
+	{
+		chunk = createChunk(bytes);
+
+		if(!chunk)
+		{
+			return nullptr;
+		}
+
+		size = roundUp(bytes, chunk->granularity);
+		range = chunk->free.begin();
+	}
+
+	size_t offset = range->first;
+	size_t remainder = range->second - size;
+	chunk->free.erase(range);
+
+	if(remainder)
+	{
+		chunk->free[offset + size] = remainder;
+	}
+
+	chunk->allocated += size;
+
+	if(!protect(chunk, offset, size, PROTECTION_READ_WRITE))
+	{
+		release(chunk, offset, size);
+		return nullptr;
+	}
+
+	unsigned char *memory = chunk->base + offset;
+	Allocation allocation = {chunk, size, true};
+	allocations[(uintptr_t)memory] = allocation;
+
+	return memory;
+}
+
+const void *ExecutableMemory::executableAddress(const void *memory)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto allocation = allocations.find((uintptr_t)memory);
+	ASSERT(allocation != allocations.end());
+
+	Chunk *chunk = allocation->second.chunk;
+
+	return chunk->executable + ((const unsigned char*)memory - chunk->base);
+}
+
+bool ExecutableMemory::markExecutable(void *memory)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto allocation = allocations.find((uintptr_t)memory);
+	ASSERT(allocation != allocations.end() && allocation->second.writable);
+
+	Chunk *chunk = allocation->second.chunk;
+
+	if(!protect(chunk, (unsigned char*)memory - chunk->base, allocation->second.size, PROTECTION_READ_EXECUTE))
+	{
+		return false;
+	}
+
+	allocation->second.writable = false;
+
+	return true;
+}
+
+void ExecutableMemory::shrink(void *memory, size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto allocation = allocations.find((uintptr_t)memory);
+	ASSERT(allocation != allocations.end() && allocation->second.writable);
+
+	Chunk *chunk = allocation->second.chunk;
+	size_t size = roundUp(bytes, chunk->granularity);
+
+	if(size >= allocation->second.size)
+	{
+		return;
+	}
+
+	size_t offset = (unsigned char*)memory - chunk->base;
+
+	release(chunk, offset + size, allocation->second.size - size);
+	allocation->second.size = size;
+}
+
+void ExecutableMemory::deallocate(void *memory)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto allocation = allocations.find((uintptr_t)memory);
+	ASSERT(allocation != allocations.end());
+
+	Chunk *chunk = allocation->second.chunk;
+	size_t offset = (unsigned char*)memory - chunk->base;
+	size_t size = allocation->second.size;
+
+	allocations.erase(allocation);
+	release(chunk, offset, size);
+
+	if(chunk->allocated == 0 && chunks.size() > 1)   // Keep one chunk around for the next routines
+	{
+		for(auto other = chunks.begin(); other != chunks.end(); other++)
+		{
+			if(*other == chunk)
+			{
+				chunks.erase(other);
+				break;
+			}
+		}
+
+		unmapPages(chunk->base, chunk->size);
+
+		if(chunk->executable != chunk->base)
+		{
+			unmapPages(chunk->executable, chunk->size);
+		}
+
+		subtractMemoryUsage(MEMORY_ROUTINE, chunk->size);
+		delete chunk;
+	}
+}
+
+ExecutableMemory::Chunk *ExecutableMemory::createChunk(size_t bytes)
+{
+	size_t pageSize = memoryPageSize();
+	size_t size = (bytes > CHUNK_SIZE) ? roundUp(bytes, pageSize) : CHUNK_SIZE;
+	void *executable = nullptr;
+	unsigned char *base = dualMapping ? (unsigned char*)mapDualPages(size, executable) : nullptr;
+
+	if(!base)
+	{
+		dualMapping = false;
+		base = (unsigned char*)mapPages(size);
+		executable = base;
+
+		if(!base)
+		{
+			return nullptr;
+		}
+	}
+
+	addMemoryUsage(MEMORY_ROUTINE, size);
+
+	Chunk *chunk = new Chunk;
+	chunk->base = base;
+	chunk->executable = (unsigned char*)executable;
+	chunk->size = size;
+	chunk->granularity = (executable != base) ? ALIGNMENT : pageSize;
+	chunk->allocated = 0;
+	chunk->free[0] = size;
+
+	if(executable == base)
+	{
+		chunk->pages.resize(size / pageSize, PROTECTION_READ_WRITE);
+	}
+
+	chunks.push_back(chunk);
+
+	return chunk;
+}
+
+void ExecutableMemory::release(Chunk *chunk, size_t offset, size_t size)
+{
+	chunk->allocated -= size;
+
+	auto next = chunk->free.lower_bound(offset);
+
+	if(next != chunk->free.end() && next->first == offset + size)
+	{
+		size += next->second;
+		next = chunk->free.erase(next);
+	}
+
+	if(next != chunk->free.begin())
+	{
+		auto previous = std::prev(next);
+
+		if(previous->first + previous->second == offset)
+		{
+			previous->second += size;
+			return;
+		}
+	}
+
+	chunk->free[offset] = size;
+}
+
+bool ExecutableMemory::protect(Chunk *chunk, size_t offset, size_t size, Protection protection)
+{
+	if(chunk->executable != chunk->base)
+	{
+		return true;   // Written through one view and executed from the other
+	}
+
+	size_t pageSize = memoryPageSize();
+	size_t end = (offset + size) / pageSize;
+
+	// Changes the protection of consecutive pages with a single call
+	for(size_t i = offset / pageSize; i < end;)
+	{
+		if(chunk->pages[i] == protection)
+		{
+			i++;
+			continue;
+		}
+
+		size_t runEnd = i + 1;
+
+		while(runEnd < end && chunk->pages[runEnd] != protection)
+		{
+			runEnd++;
+		}
+
+		if(!protectPages(chunk->base + i * pageSize, (runEnd - i) * pageSize, protection))
+		{
+			return false;
+		}
+
+		for(; i < runEnd; i++)
+		{
+			chunk->pages[i] = protection;
+		}
+	}
+
+	return true;
+}
+
+size_t ExecutableMemory::roundUp(size_t bytes, size_t granularity)
+{
+	size_t size = (bytes + granularity - 1) & ~(granularity - 1);
+
+	return size ? size : granularity;
+}
+
+ExecutableMemory &executableMemory()
+{
+	static ExecutableMemory *memory = new ExecutableMemory();   // Outlives routines freed at exit
+	return *memory;
+}
+
 }  // anonymous namespace
 
 size_t memoryPageSize()
@@ -146,11 +624,42 @@ size_t memoryPageSize()
 	return pageSize;
 }
 
-void *allocate(size_t bytes, size_t alignment)
+void *allocate(size_t bytes, size_t alignment, bool clearToZero, MemoryCategory category)
 {
-	void *memory = allocateRaw(bytes, alignment);
+	#if defined(__linux__) && defined(MADV_HUGEPAGE) && !defined(LINUX_ENABLE_NAMED_MMAP)
+		size_t threshold = hugePageThreshold;
 
-	if(memory)
+		if(threshold && bytes >= threshold && bytes >= HUGE_PAGE_SIZE)
+		{
+			// Only whole huge pages within the block can be advised, the tail keeps regular pages
+			unsigned char *memory = (unsigned char*)allocateRaw(bytes, (alignment > HUGE_PAGE_SIZE) ? alignment : HUGE_PAGE_SIZE, category);
+
+			if(memory)
+			{
+				size_t length = bytes & ~(size_t)(HUGE_PAGE_SIZE - 1);
+
+				if(madvise(memory, length, MADV_HUGEPAGE) == 0)
+				{
+					Allocation *allocation = (Allocation*)(memory - sizeof(Allocation));
+					allocation->hugePages = length;
+
+					hugePageAllocationCount++;
+					hugePageByteCount += length;
+				}
+
+				if(clearToZero)
+				{
+					memset(memory, 0, bytes);
+				}
+			}
+
+			return memory;
+		}
+	#endif
+
+	void *memory = allocateRaw(bytes, alignment, category);
+
+	if(memory && clearToZero)
 	{
 		memset(memory, 0, bytes);
 	}
@@ -168,68 +677,133 @@ void deallocate(void *memory)
 			unsigned char *aligned = (unsigned char*)memory;
 			Allocation *allocation = (Allocation*)(aligned - sizeof(Allocation));
 
+			if(allocation->hugePages)
+			{
+				hugePageAllocationCount--;
+				hugePageByteCount -= allocation->hugePages;
+			}
+
+			subtractMemoryUsage(allocation->category, allocation->bytes);
+
 			delete[] allocation->block;
 		}
 	#endif
 }
 
-void *allocateExecutable(size_t bytes)
+void setHugePageThreshold(size_t bytes)
 {
-	size_t pageSize = memoryPageSize();
-	size_t length = (bytes + pageSize - 1) & ~(pageSize - 1);
-	void *mapping;
+	hugePageThreshold = bytes;
+}
 
-	#if defined(LINUX_ENABLE_NAMED_MMAP)
-		// Try to name the memory region for the executable code,
-		// to aid profilers.
-		int anonFd = anonymousFd();
-		if(anonFd == -1)
+size_t hugePageAllocations()
+{
+	return hugePageAllocationCount;
+}
+
+size_t hugePageBytes()
+{
+	return hugePageByteCount;
+}
+
+MemoryUsage memoryUsage(MemoryCategory category)
+{
+	MemoryUsage usage;
+	usage.current = memoryCounters[category].current.load(std::memory_order_relaxed);
+	usage.peak = memoryCounters[category].peak.load(std::memory_order_relaxed);
+
+	return usage;
+}
+
+void resetPeakMemoryUsage()
+{
+	for(MemoryCounter &counter : memoryCounters)
+	{
+		counter.peak.store(counter.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+void *mapFile(int fileDescriptor, size_t bytes)
+{
+	void *mapping = nullptr;
+
+	#if defined(_WIN32)
+		HANDLE file = (HANDLE)_get_osfhandle(fileDescriptor);
+
+		if(file == INVALID_HANDLE_VALUE)
 		{
-			mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
-			               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			return nullptr;
 		}
-		else
+
+		// Creating the mapping extends the file, the view keeps it alive after closing its handle
+		HANDLE fileMapping = CreateFileMapping(file, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)bytes >> 32), (DWORD)bytes, nullptr);
+
+		if(fileMapping)
 		{
-			ensureAnonFileSize(anonFd, length);
-			mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
-			               MAP_PRIVATE, anonFd, 0);
+			mapping = MapViewOfFile(fileMapping, FILE_MAP_WRITE, 0, 0, bytes);
+			CloseHandle(fileMapping);
+		}
+	#else
+		struct stat status;
+
+		if(fstat(fileDescriptor, &status) != 0)
+		{
+			return nullptr;
 		}
 
+		if((size_t)status.st_size < bytes && ftruncate(fileDescriptor, bytes) != 0)
+		{
+			return nullptr;
+		}
+
+		mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+
 		if(mapping == MAP_FAILED)
 		{
 			mapping = nullptr;
 		}
-	#else
-		mapping = allocate(length, pageSize);
 	#endif
 
 	return mapping;
 }
 
-void markExecutable(void *memory, size_t bytes)
+void unmapFile(void *memory, size_t bytes)
 {
-	#if defined(_WIN32)
-		unsigned long oldProtection;
-		VirtualProtect(memory, bytes, PAGE_EXECUTE_READ, &oldProtection);
-	#else
-		mprotect(memory, bytes, PROT_READ | PROT_EXEC);
-	#endif
+	if(memory)
+	{
+		#if defined(_WIN32)
+			UnmapViewOfFile(memory);
+		#else
+			munmap(memory, bytes);
+		#endif
+	}
+}
+
+void *allocateExecutable(size_t bytes)
+{
+	return executableMemory().allocate(bytes);
+}
+
+void shrinkExecutable(void *memory, size_t bytes)
+{
+	executableMemory().shrink(memory, bytes);
+}
+
+const void *executableAddress(const void *memory)
+{
+	return executableMemory().executableAddress(memory);
+}
+
+bool markExecutable(void *memory, size_t bytes)
+{
+	return executableMemory().markExecutable(memory);
 }
 
 void deallocateExecutable(void *memory, size_t bytes)
 {
-	#if defined(_WIN32)
-		unsigned long oldProtection;
-		VirtualProtect(memory, bytes, PAGE_READWRITE, &oldProtection);
-		deallocate(memory);
-	#elif defined(LINUX_ENABLE_NAMED_MMAP)
-		size_t pageSize = memoryPageSize();
-		size_t length = (bytes + pageSize - 1) & ~(pageSize - 1);
-		munmap(memory, length);
-	#else
-		mprotect(memory, bytes, PROT_READ | PROT_WRITE);
-		deallocate(memory);
-	#endif
+	if(memory)
+	{
+		executableMemory().deallocate(memory);
+	}
 }
 
 void clear(uint16_t *memory, uint16_t element, size_t count)
@@ -259,4 +833,80 @@ void clear(uint32_t *memory, uint32_t element, size_t count)
 		}
 	#endif
 }
+
+#if USE_SSE2_CLEAR
+namespace
+{
+	// Spans this large are unlikely to be read back while still cached, so they bypass it
+	const size_t NON_TEMPORAL_CLEAR_BYTES = 0x1000;
+
+	void clear(__m128i *memory, __m128i pattern, size_t count)   // 16-byte aligned
+	{
+		if(count * sizeof(__m128i) >= NON_TEMPORAL_CLEAR_BYTES)
+		{
+			for(; count >= 4; count -= 4)
+			{
+				_mm_stream_si128(memory + 0, pattern);
+				_mm_stream_si128(memory + 1, pattern);
+				_mm_stream_si128(memory + 2, pattern);
+				_mm_stream_si128(memory + 3, pattern);
+
+				memory += 4;
+			}
+
+			_mm_sfence();   // Streaming stores aren't ordered with the unlock that publishes them
+		}
+
+		for(; count > 0; count--)
+		{
+			_mm_store_si128(memory++, pattern);
+		}
+	}
+}
+#endif
+
+void clear(uint64_t *memory, uint64_t element, size_t count)
+{
+	#if USE_SSE2_CLEAR
+		if(((uintptr_t)memory & 0xF) != 0 && count > 0)
+		{
+			*memory++ = element;
+			count--;
+		}
+
+		if(((uintptr_t)memory & 0xF) == 0)
+		{
+			__m128i pattern = _mm_loadl_epi64((const __m128i*)&element);
+			pattern = _mm_unpacklo_epi64(pattern, pattern);
+
+			clear((__m128i*)memory, pattern, count / 2);
+
+			memory += count & ~(size_t)1;
+			count &= 1;
+		}
+	#endif
+
+	for(size_t i = 0; i < count; i++)
+	{
+		memory[i] = element;
+	}
+}
+
+void clear(uint64_t *memory, const uint64_t element[2], size_t count)
+{
+	#if USE_SSE2_CLEAR
+		if(((uintptr_t)memory & 0xF) == 0)
+		{
+			clear((__m128i*)memory, _mm_loadu_si128((const __m128i*)element), count);
+
+			return;
+		}
+	#endif
+
+	for(size_t i = 0; i < count; i++)
+	{
+		memory[2 * i + 0] = element[0];
+		memory[2 * i + 1] = element[1];
+	}
+}
 }
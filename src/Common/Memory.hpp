@@ -22,15 +22,46 @@ namespace sw
 {
 size_t memoryPageSize();
 
-void *allocate(size_t bytes, size_t alignment = 16);
+enum MemoryCategory
+{
+	MEMORY_GENERAL,
+	MEMORY_SURFACE,    // Internal, external and stencil buffers, and their tile state
+	MEMORY_BUFFER,     // Resources, which back buffer objects and streaming vertex and index data
+	MEMORY_RENDERER,   // Draw calls, per-unit primitive batches and vertex caches
+	MEMORY_ROUTINE,    // Mapped chunks of executable memory holding generated code
+
+	MEMORY_CATEGORIES
+};
+
+struct MemoryUsage
+{
+	size_t current;
+	size_t peak;
+};
+
+void *allocate(size_t bytes, size_t alignment = 16, bool clearToZero = true, MemoryCategory category = MEMORY_GENERAL);   // Only skip clearing when all of the memory gets written
 void deallocate(void *memory);
 
-void *allocateExecutable(size_t bytes);   // Allocates memory that can be made executable using markExecutable()
-void markExecutable(void *memory, size_t bytes);
+MemoryUsage memoryUsage(MemoryCategory category);   // Bytes including allocation overhead, not tracked for allocate() with LINUX_ENABLE_NAMED_MMAP
+void resetPeakMemoryUsage();   // Peaks restart from the current usage
+
+void setHugePageThreshold(size_t bytes);   // Larger allocations get backed by huge pages where supported, 0 disables them
+size_t hugePageAllocations();   // Live allocations backed by huge pages
+size_t hugePageBytes();         // Memory they advised to use huge pages
+
+void *mapFile(int fileDescriptor, size_t bytes);   // Maps the start of the file for reading and writing through to it, growing the file to bytes if smaller
+void unmapFile(void *memory, size_t bytes);
+
+void *allocateExecutable(size_t bytes);   // Allocates memory that can be made executable using markExecutable(), null on failure
+const void *executableAddress(const void *memory);   // Where code written to the allocation runs, an alias of it when routines share pages
+void shrinkExecutable(void *memory, size_t bytes);   // Releases the end of memory which hasn't been made executable yet
+bool markExecutable(void *memory, size_t bytes);   // Makes it read-only, false if it couldn't be made executable
 void deallocateExecutable(void *memory, size_t bytes);
 
 void clear(uint16_t *memory, uint16_t element, size_t count);
 void clear(uint32_t *memory, uint32_t element, size_t count);
+void clear(uint64_t *memory, uint64_t element, size_t count);
+void clear(uint64_t *memory, const uint64_t element[2], size_t count);   // 128-bit elements
 }
 
 #endif   // Memory_hpp
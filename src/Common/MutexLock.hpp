@@ -21,6 +21,7 @@
 // Use a pthread mutex on Linux. Since many processes may use SwiftShader
 // at the same time it's best to just have the scheduler overhead.
 #include <pthread.h>
+#include <atomic>
 
 namespace sw
 {
@@ -39,12 +40,24 @@ namespace sw
 
 		bool attemptLock()
 		{
-			return pthread_mutex_trylock(&mutex) == 0;
+			if(pthread_mutex_trylock(&mutex) == 0)
+			{
+				acquired();
+				return true;
+			}
+
+			return false;
 		}
 
 		void lock()
 		{
-			pthread_mutex_lock(&mutex);
+			if(pthread_mutex_trylock(&mutex) != 0)
+			{
+				parks.fetch_add(1, std::memory_order_relaxed);   // The pthread mutex does its own brief spinning
+				pthread_mutex_lock(&mutex);
+			}
+
+			acquired();
 		}
 
 		void unlock()
@@ -52,8 +65,21 @@ namespace sw
 			pthread_mutex_unlock(&mutex);
 		}
 
+		// Contention counters, for profiling
+		unsigned int getAcquisitions() const { return acquisitions.load(std::memory_order_relaxed); }
+		unsigned int getSpins() const { return 0; }
+		unsigned int getParks() const { return parks.load(std::memory_order_relaxed); }
+
 	private:
+		void acquired()
+		{
+			// Only the owner increments it, so this doesn't need an atomic read-modify-write
+			acquisitions.store(acquisitions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
 		pthread_mutex_t mutex;
+		std::atomic<unsigned int> acquisitions = {0};
+		std::atomic<unsigned int> parks = {0};
 	};
 }
 
@@ -63,20 +89,29 @@ namespace sw
 
 namespace sw
 {
+	// Spins for a short while, in case the owner is about to release the lock, and then parks
+	// the thread until it's released. Spinning indefinitely burns the CPU quota of oversubscribed
+	// processes, and keeps the owner from running when it got preempted.
 	class BackoffLock
 	{
 	public:
 		BackoffLock()
 		{
-			mutex = 0;
+			line.state = UNLOCKED;
+			line.acquisitions = 0;
+			line.spins = 0;
+			line.parks = 0;
 		}
 
 		bool attemptLock()
 		{
 			if(!isLocked())
 			{
-				if(mutex.exchange(true) == false)
+				int expected = UNLOCKED;
+
+				if(line.state.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire))
 				{
+					acquired();
 					return true;
 				}
 			}
@@ -86,87 +121,121 @@ namespace sw
 
 		void lock()
 		{
-			int backoff = 1;
+			if(attemptLock())
+			{
+				return;
+			}
 
-			while(!attemptLock())
+			for(int backoff = 1; backoff <= 64; backoff *= 2)
 			{
-				if(backoff <= 64)
+				line.spins.fetch_add(1, std::memory_order_relaxed);
+
+				for(int i = 0; i < backoff; i++)
 				{
-					for(int i = 0; i < backoff; i++)
-					{
-						nop();
-						nop();
-						nop();
-						nop();
-						nop();
-
-						nop();
-						nop();
-						nop();
-						nop();
-						nop();
-
-						nop();
-						nop();
-						nop();
-						nop();
-						nop();
-
-						nop();
-						nop();
-						nop();
-						nop();
-						nop();
-
-						nop();
-						nop();
-						nop();
-						nop();
-						nop();
-
-						nop();
-						nop();
-						nop();
-						nop();
-						nop();
-
-						nop();
-						nop();
-						nop();
-						nop();
-						nop();
-					}
-
-					backoff *= 2;
+					nop();
+					nop();
+					nop();
+					nop();
+					nop();
+
+					nop();
+					nop();
+					nop();
+					nop();
+					nop();
+
+					nop();
+					nop();
+					nop();
+					nop();
+					nop();
+
+					nop();
+					nop();
+					nop();
+					nop();
+					nop();
+
+					nop();
+					nop();
+					nop();
+					nop();
+					nop();
+
+					nop();
+					nop();
+					nop();
+					nop();
+					nop();
+
+					nop();
+					nop();
+					nop();
+					nop();
+					nop();
 				}
-				else
-				{
-					Thread::yield();
 
-					backoff = 1;
+				if(attemptLock())
+				{
+					return;
 				}
-			};
+			}
+
+			// Announce the waiter, so the owner signals the event on unlock.
+			// The event stays signaled when that happens before we wait on it.
+			while(line.state.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED)
+			{
+				line.parks.fetch_add(1, std::memory_order_relaxed);
+				unblock.wait();
+			}
+
+			acquired();
 		}
 
 		void unlock()
 		{
-			mutex.store(false, std::memory_order_release);
+			if(line.state.exchange(UNLOCKED, std::memory_order_release) == CONTENDED)
+			{
+				unblock.signal();
+			}
 		}
 
 		bool isLocked()
 		{
-			return mutex.load(std::memory_order_acquire);
+			return line.state.load(std::memory_order_acquire) != UNLOCKED;
 		}
 
+		// Contention counters, for profiling
+		unsigned int getAcquisitions() const { return line.acquisitions.load(std::memory_order_relaxed); }
+		unsigned int getSpins() const { return line.spins.load(std::memory_order_relaxed); }
+		unsigned int getParks() const { return line.parks.load(std::memory_order_relaxed); }
+
 	private:
+		enum
+		{
+			UNLOCKED,
+			LOCKED,
+			CONTENDED   // Locked, and other threads may be parked
+		};
+
+		void acquired()
+		{
+			// Only the owner increments it, so this doesn't need an atomic read-modify-write
+			line.acquisitions.store(line.acquisitions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
 		struct
 		{
-			// Ensure that the mutex variable is on its own 64-byte cache line to avoid false sharing
-			// Padding must be public to avoid compiler warnings
+			// Ensure that the lock state is on its own 64-byte cache line to avoid false sharing
 			volatile int padding1[16];
-			std::atomic<bool> mutex;
-			volatile int padding2[15];
-		};
+			std::atomic<int> state;
+			std::atomic<unsigned int> acquisitions;
+			std::atomic<unsigned int> spins;
+			std::atomic<unsigned int> parks;
+			volatile int padding2[12];
+		} line;
+
+		Event unblock;
 	};
 
 	using MutexLock = BackoffLock;
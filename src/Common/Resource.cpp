@@ -15,10 +15,13 @@
 #include "Resource.hpp"
 
 #include "Memory.hpp"
+#include "Timer.hpp"
 
 namespace sw
 {
-	Resource::Resource(size_t bytes) : size(bytes)
+	std::atomic<int64_t> Resource::blockedTime(0);
+
+	Resource::Resource(size_t bytes, bool clearToZero) : size(bytes)
 	{
 		blocked = 0;
 
@@ -26,7 +29,7 @@ namespace sw
 		count = 0;
 		orphaned = false;
 
-		buffer = allocate(bytes);
+		buffer = allocate(bytes, 16, clearToZero, MEMORY_BUFFER);
 	}
 
 	Resource::~Resource()
@@ -40,13 +43,7 @@ namespace sw
 
 		while(count > 0 && accessor != claimer)
 		{
-			blocked++;
-			criticalSection.unlock();
-
-			unblock.wait();
-
-			criticalSection.lock();
-			blocked--;
+			wait();
 		}
 
 		accessor = claimer;
@@ -86,13 +83,7 @@ namespace sw
 		// Acquire
 		while(count > 0 && accessor != claimer)
 		{
-			blocked++;
-			criticalSection.unlock();
-
-			unblock.wait();
-
-			criticalSection.lock();
-			blocked--;
+			wait();
 		}
 
 		accessor = claimer;
@@ -103,6 +94,36 @@ namespace sw
 		return buffer;
 	}
 
+	void Resource::wait()
+	{
+		blocked++;
+		criticalSection.unlock();
+
+		int64_t startTick = Timer::ticks();
+		unblock.wait();
+		blockedTime += Timer::ticks() - startTick;
+
+		criticalSection.lock();
+		blocked--;
+	}
+
+	bool Resource::tryLock(Accessor claimer)
+	{
+		criticalSection.lock();
+
+		bool idle = (count == 0) && !blocked;
+
+		if(idle)
+		{
+			accessor = claimer;
+			count++;
+		}
+
+		criticalSection.unlock();
+
+		return idle;
+	}
+
 	void Resource::unlock()
 	{
 		criticalSection.lock();
@@ -156,6 +177,17 @@ namespace sw
 		criticalSection.unlock();
 	}
 
+	bool Resource::isIdle()
+	{
+		criticalSection.lock();
+
+		bool idle = (count == 0) && !blocked;
+
+		criticalSection.unlock();
+
+		return idle;
+	}
+
 	void Resource::destruct()
 	{
 		criticalSection.lock();
@@ -17,6 +17,8 @@
 
 #include "MutexLock.hpp"
 
+#include <atomic>
+
 namespace sw
 {
 	enum Accessor
@@ -30,21 +32,30 @@ namespace sw
 	class Resource
 	{
 	public:
-		Resource(size_t bytes);
+		Resource(size_t bytes, bool clearToZero = true);
 
 		void destruct();   // Asynchronous destructor
 
 		void *lock(Accessor claimer);
 		void *lock(Accessor relinquisher, Accessor claimer);
+		bool tryLock(Accessor claimer);   // Only succeeds if not locked or waited on by any accessor
 		void unlock();
 		void unlock(Accessor relinquisher);
 
+		bool isIdle();   // Not locked or waited on by any accessor
+
 		const void *data() const;
 		const size_t size;
 
+		static int64_t getBlockedTime() { return blockedTime; }   // Of all lock() calls which had to wait, in Timer::ticks() units
+
 	private:
 		~Resource();   // Always call destruct() instead
 
+		void wait();   // For unblock, must be called while holding the critical section
+
+		static std::atomic<int64_t> blockedTime;
+
 		MutexLock criticalSection;
 		Event unblock;
 		volatile int blocked;
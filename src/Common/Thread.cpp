@@ -50,6 +50,21 @@ namespace sw
 		}
 	}
 
+	bool Thread::pin(int processor)
+	{
+		#if defined(_WIN32)
+			return SetThreadAffinityMask(handle, (DWORD_PTR)1 << processor) != 0;
+		#elif defined(__linux__) && !defined(__ANDROID__)
+			cpu_set_t affinity;
+			CPU_ZERO(&affinity);
+			CPU_SET(processor, &affinity);
+
+			return pthread_setaffinity_np(handle, sizeof(affinity), &affinity) == 0;
+		#else
+			return false;   // Unimplemented
+		#endif
+	}
+
 	#if defined(_WIN32)
 		unsigned long __stdcall Thread::startFunction(void *parameters)
 		{
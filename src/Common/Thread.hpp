@@ -25,6 +25,8 @@
 	#include <pthread.h>
 	#include <sched.h>
 	#include <unistd.h>
+	#include <errno.h>
+	#include <time.h>
 	#define TLS_OUT_OF_INDEXES (pthread_key_t)(~0)
 #endif
 
@@ -55,6 +57,7 @@ namespace sw
 		~Thread();
 
 		void join();
+		bool pin(int processor);   // Restricts the thread to one logical processor
 
 		static void yield();
 		static void sleep(int milliseconds);
@@ -101,6 +104,7 @@ namespace sw
 
 		void signal();
 		void wait();
+		bool wait(int milliseconds);   // False when it timed out
 
 	private:
 		#if defined(_WIN32)
@@ -112,10 +116,6 @@ namespace sw
 		#endif
 	};
 
-	#if PERF_PROFILE
-	int64_t atomicExchange(int64_t volatile *target, int64_t value);
-	#endif
-
 	int atomicExchange(int volatile *target, int value);
 	int atomicIncrement(int volatile *value);
 	int atomicDecrement(int volatile *value);
@@ -234,18 +234,32 @@ namespace sw
 		#endif
 	}
 
-	#if PERF_PROFILE
-	inline int64_t atomicExchange(volatile int64_t *target, int64_t value)
+	inline bool Event::wait(int milliseconds)
 	{
 		#if defined(_WIN32)
-			return InterlockedExchange64(target, value);
+			return WaitForSingleObject(handle, milliseconds) == WAIT_OBJECT_0;
 		#else
-			int ret;
-			__asm__ __volatile__("lock; xchg8 %0,(%1)" : "=r" (ret) :"r" (target), "0" (value) : "memory" );
-			return ret;
+			timespec deadline;
+			clock_gettime(CLOCK_REALTIME, &deadline);   // The condition variable's clock
+			deadline.tv_sec += milliseconds / 1000;
+			deadline.tv_nsec += (milliseconds % 1000) * 1000000;
+
+			if(deadline.tv_nsec >= 1000000000)
+			{
+				deadline.tv_sec++;
+				deadline.tv_nsec -= 1000000000;
+			}
+
+			pthread_mutex_lock(&mutex);
+			int result = 0;
+			while(!signaled && result != ETIMEDOUT) result = pthread_cond_timedwait(&handle, &mutex, &deadline);
+			bool wasSignaled = signaled;
+			signaled = false;
+			pthread_mutex_unlock(&mutex);
+
+			return wasSignaled;
 		#endif
 	}
-	#endif
 
 	inline int atomicExchange(volatile int *target, int value)
 	{
@@ -14,6 +14,8 @@
 
 #include "Timer.hpp"
 
+#include <chrono>
+
 #if !defined(__i386__) && defined(_M_IX86)
 	#define __i386__ 1
 #endif
@@ -61,9 +63,7 @@ namespace sw
 		#if defined(_WIN32)
 			return __rdtsc();
 		#elif defined(__i386__) || defined(__x86_64__)
-			int64_t tsc;
-			__asm volatile("rdtsc": "=A" (tsc));
-			return tsc;
+			return __rdtsc();   // The "=A" constraint doesn't describe edx:eax on x86-64
 		#else
 			return 0;
 		#endif
@@ -92,4 +92,11 @@ namespace sw
 			return 1000000;   // gettimeofday uses microsecond resolution
 		#endif
 	}
+
+	int64_t Timer::nanoseconds()
+	{
+		using namespace std::chrono;
+
+		return duration_cast<std::chrono::nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
 }
@@ -31,6 +31,8 @@ namespace sw
 
 		static int64_t counter();
 		static int64_t frequency();
+
+		static int64_t nanoseconds();   // Monotonic, only meaningful relative to each other
 	};
 }
 
@@ -0,0 +1,234 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TraceEvents.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace sw
+{
+	namespace
+	{
+		struct Event
+		{
+			int64_t start;
+			int64_t end;
+			const char *category;   // Static string
+			char name[40];
+		};
+
+		struct ThreadBuffer
+		{
+			enum {CAPACITY = 1 << 14};   // Events, 1 MiB per thread
+
+			int threadID;
+			char threadName[40];
+			std::atomic<uint64_t> count;   // Events ever recorded, only written by the owning thread
+			Event event[CAPACITY];
+		};
+
+		// Copies the name without the characters which would need escaping in JSON
+		template<typename Char>
+		void copyName(char *destination, size_t size, const Char *source)
+		{
+			size_t i = 0;
+
+			for(; i < size - 1 && source[i]; i++)
+			{
+				Char c = source[i];
+				destination[i] = (c >= 0x20 && c < 0x7F && c != '"' && c != '\\') ? (char)c : '_';
+			}
+
+			destination[i] = '\0';
+		}
+
+		class Recorder
+		{
+		public:
+			Recorder()
+			{
+				const char *file = getenv("SWIFTSHADER_TRACE");
+
+				if(file && *file)
+				{
+					fileName = file;
+				}
+			}
+
+			~Recorder()
+			{
+				if(!fileName.empty())
+				{
+					TraceEvents::dump(fileName.c_str());
+				}
+
+				for(ThreadBuffer *buffer : buffers)
+				{
+					delete buffer;
+				}
+			}
+
+			bool isEnabled() const
+			{
+				return !fileName.empty();
+			}
+
+			ThreadBuffer *threadBuffer()
+			{
+				thread_local ThreadBuffer *buffer = nullptr;
+
+				if(!buffer)
+				{
+					buffer = new ThreadBuffer;
+					buffer->threadName[0] = '\0';
+					buffer->count = 0;
+
+					std::lock_guard<std::mutex> lock(mutex);
+					buffer->threadID = (int)buffers.size() + 1;
+					buffers.push_back(buffer);   // Outlives the thread, for dumping at exit
+				}
+
+				return buffer;
+			}
+
+			std::mutex mutex;
+			std::vector<ThreadBuffer*> buffers;
+			std::string fileName;
+		};
+
+		Recorder recorder;
+
+		template<typename Char>
+		void recordEvent(const Char *name, const char *category, int64_t start, int64_t end)
+		{
+			ThreadBuffer *buffer = recorder.threadBuffer();
+			uint64_t index = buffer->count.load(std::memory_order_relaxed);
+			Event &event = buffer->event[index % ThreadBuffer::CAPACITY];
+
+			event.start = start;
+			event.end = end;
+			event.category = category;
+			copyName(event.name, sizeof(event.name), name);
+
+			buffer->count.store(index + 1, std::memory_order_release);
+		}
+	}
+
+	bool TraceEvents::enabled = recorder.isEnabled();
+
+	int64_t TraceEvents::time()
+	{
+		using namespace std::chrono;
+
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	void TraceEvents::record(const char *name, const char *category, int64_t start, int64_t end)
+	{
+		recordEvent(name, category, start, end);
+	}
+
+	void TraceEvents::record(const wchar_t *name, const char *category, int64_t start, int64_t end)
+	{
+		recordEvent(name, category, start, end);
+	}
+
+	void TraceEvents::setThreadName(const char *name)
+	{
+		if(enabled)
+		{
+			ThreadBuffer *buffer = recorder.threadBuffer();
+			copyName(buffer->threadName, sizeof(buffer->threadName), name);
+		}
+	}
+
+	bool TraceEvents::dump(const char *fileName)
+	{
+		std::vector<ThreadBuffer*> buffers;
+
+		{
+			std::lock_guard<std::mutex> lock(recorder.mutex);
+			buffers = recorder.buffers;
+		}
+
+		FILE *file = fopen(fileName, "w");
+
+		if(!file)
+		{
+			return false;
+		}
+
+		const uint64_t capacity = ThreadBuffer::CAPACITY;
+		int64_t origin = 0;
+		std::vector<std::vector<Event>> events(buffers.size());
+
+		for(size_t i = 0; i < buffers.size(); i++)
+		{
+			uint64_t count = buffers[i]->count.load(std::memory_order_acquire);
+			uint64_t first = count > capacity ? count - capacity : 0;
+
+			for(uint64_t index = first; index < count; index++)
+			{
+				events[i].push_back(buffers[i]->event[index % capacity]);
+			}
+
+			// Drop the oldest events if the thread overwrote them while they were being copied
+			uint64_t overwritten = buffers[i]->count.load(std::memory_order_acquire);
+			overwritten = overwritten > capacity ? overwritten - capacity : 0;
+
+			if(overwritten > first)
+			{
+				events[i].erase(events[i].begin(), events[i].begin() + (size_t)std::min(overwritten - first, (uint64_t)events[i].size()));
+			}
+
+			for(const Event &event : events[i])
+			{
+				origin = (origin == 0 || event.start < origin) ? event.start : origin;
+			}
+		}
+
+		fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+
+		const char *separator = "";
+
+		for(size_t i = 0; i < buffers.size(); i++)
+		{
+			int threadID = buffers[i]->threadID;
+
+			if(buffers[i]->threadName[0])
+			{
+				fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", separator, threadID, buffers[i]->threadName);
+				separator = ",\n";
+			}
+
+			for(const Event &event : events[i])
+			{
+				fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				        separator, event.name, event.category, threadID, (event.start - origin) * 1.0e-3, (event.end - event.start) * 1.0e-3);
+				separator = ",\n";
+			}
+		}
+
+		fputs("\n]}\n", file);
+
+		return fclose(file) == 0;
+	}
+}
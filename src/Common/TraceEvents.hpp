@@ -0,0 +1,68 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_TraceEvents_hpp
+#define sw_TraceEvents_hpp
+
+#include "Types.hpp"
+
+namespace sw
+{
+	// Timeline of what each thread is doing, kept in a ring buffer per thread holding its most recent
+	// events. Recording is enabled by setting the SWIFTSHADER_TRACE environment variable to the name
+	// of the file to write at process exit. The file uses the Chrome trace event JSON format, which
+	// chrome://tracing and the Perfetto UI both load.
+	class TraceEvents
+	{
+	public:
+		static bool isEnabled() { return enabled; }
+
+		static int64_t time();   // Nanoseconds, only meaningful relative to each other
+
+		static void record(const char *name, const char *category, int64_t start, int64_t end);
+		static void record(const wchar_t *name, const char *category, int64_t start, int64_t end);
+		static void setThreadName(const char *name);
+
+		// Writes the events recorded so far. Events recorded by other threads while dumping may be missing.
+		static bool dump(const char *fileName);
+
+	private:
+		static bool enabled;
+	};
+
+	// Records the lifetime of the scope as an event when tracing is enabled
+	class TraceEvent
+	{
+	public:
+		TraceEvent(const char *name, const char *category) : name(name), category(category)
+		{
+			start = TraceEvents::isEnabled() ? TraceEvents::time() : 0;
+		}
+
+		~TraceEvent()
+		{
+			if(start)
+			{
+				TraceEvents::record(name, category, start, TraceEvents::time());
+			}
+		}
+
+	private:
+		const char *const name;
+		const char *const category;
+		int64_t start;
+	};
+}
+
+#endif   // sw_TraceEvents_hpp
@@ -45,6 +45,8 @@ namespace D3D8
 
 	class Direct3DDevice8 : public IDirect3DDevice8, protected Unknown
 	{
+		friend Direct3DStateBlock8;
+
 	public:
 		Direct3DDevice8(const HINSTANCE instance, Direct3D8 *d3d8, unsigned int adapter, D3DDEVTYPE deviceType, HWND focusWindow, unsigned long behaviourFlags, D3DPRESENT_PARAMETERS *presentParameters);
 
@@ -30,6 +30,11 @@ namespace D3D8
 	Direct3DIndexBuffer8::~Direct3DIndexBuffer8()
 	{
 		indexBuffer->destruct();
+
+		for(sw::Resource *resource : retired)
+		{
+			resource->destruct();
+		}
 	}
 
 	long Direct3DIndexBuffer8::QueryInterface(const IID &iid, void **object)
@@ -156,8 +161,17 @@ namespace D3D8
 		lockOffset = offset;
 		lockSize = size;
 
-		*data = (unsigned char*)indexBuffer->lock(sw::PUBLIC) + offset;
-		indexBuffer->unlock();
+		if(flags & D3DLOCK_DISCARD)
+		{
+			indexBuffer = discard();
+
+			*data = (unsigned char*)indexBuffer->data() + offset;
+		}
+		else
+		{
+			*data = (unsigned char*)indexBuffer->lock(sw::PUBLIC) + offset;
+			indexBuffer->unlock();
+		}
 
 		return D3D_OK;
 	}
@@ -188,4 +202,30 @@ namespace D3D8
 
 		return false;
 	}
-}
\ No newline at end of file
+
+	sw::Resource *Direct3DIndexBuffer8::discard()
+	{
+		// Draws still reading the current contents keep them, and retired contents they're done with get reused
+		sw::Resource *next = nullptr;
+
+		for(size_t i = 0; i < retired.size(); i++)
+		{
+			if(retired[i]->isIdle())
+			{
+				next = retired[i];
+				retired.erase(retired.begin() + i);
+				break;
+			}
+		}
+
+		if(retired.size() == MAX_RETIRED)
+		{
+			retired.front()->destruct();
+			retired.erase(retired.begin());
+		}
+
+		retired.push_back(indexBuffer);
+
+		return next ? next : new sw::Resource(length + 16);
+	}
+}
@@ -19,6 +19,8 @@
 
 #include <d3d8.h>
 
+#include <vector>
+
 namespace sw
 {
 	class Resource;
@@ -58,6 +60,13 @@ namespace D3D8
 		bool is32Bit() const;
 
 	private:
+		enum
+		{
+			MAX_RETIRED = 16,   // Discarded contents which pending draws may still read, reused once they are done
+		};
+
+		sw::Resource *discard();
+
 		// Creation parameters
 		const unsigned int length;
 		const long usage;
@@ -70,6 +79,7 @@ namespace D3D8
 		unsigned char *lockData;
 
 		sw::Resource *indexBuffer;
+		std::vector<sw::Resource*> retired;
 	};
 }
 
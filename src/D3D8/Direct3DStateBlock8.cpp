@@ -120,22 +120,25 @@ namespace D3D8
 			device->SetIndices(indexBuffer, baseVertexIndex);
 		}
 
-		for(int state = 0; state < D3DRS_NORMALORDER + 1; state++)
+		// Only call the setters for states which differ from the device's, unless they have to be recorded
+		bool recording = device->recordState;
+
+		for(unsigned short state : capturedRenderStates)
 		{
-			if(renderStateCaptured[state])
+			if(recording || device->init || device->renderState[state] != renderState[state])
 			{
 				device->SetRenderState((D3DRENDERSTATETYPE)state, renderState[state]);
 			}
 		}
 
-		for(int stage = 0; stage < 8; stage++)
+		for(unsigned short index : capturedTextureStageStates)
 		{
-			for(int state = 0; state < D3DTSS_RESULTARG + 1; state++)
+			int stage = index / (D3DTSS_RESULTARG + 1);
+			int state = index % (D3DTSS_RESULTARG + 1);
+
+			if(recording || device->init || device->textureStageState[stage][state] != textureStageState[stage][state])
 			{
-				if(textureStageStateCaptured[stage][state])
-				{
-					device->SetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)state, textureStageState[stage][state]);
-				}
+				device->SetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)state, textureStageState[stage][state]);
 			}
 		}
 
@@ -203,23 +206,17 @@ namespace D3D8
 			device->GetIndices(reinterpret_cast<IDirect3DIndexBuffer8**>(&indexBuffer), &baseVertexIndex);
 		}
 
-		for(int state = 0; state < D3DRS_NORMALORDER + 1; state++)
+		for(unsigned short state : capturedRenderStates)
 		{
-			if(renderStateCaptured[state])
-			{
-				device->GetRenderState((D3DRENDERSTATETYPE)state, &renderState[state]);
-			}
+			device->GetRenderState((D3DRENDERSTATETYPE)state, &renderState[state]);
 		}
 
-		for(int stage = 0; stage < 8; stage++)
+		for(unsigned short index : capturedTextureStageStates)
 		{
-			for(int state = 0; state < D3DTSS_RESULTARG + 1; state++)
-			{
-				if(textureStageStateCaptured[stage][state])
-				{
-					device->GetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)state, &textureStageState[stage][state]);
-				}
-			}
+			int stage = index / (D3DTSS_RESULTARG + 1);
+			int state = index % (D3DTSS_RESULTARG + 1);
+
+			device->GetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)state, &textureStageState[stage][state]);
 		}
 
 		for(int stream = 0; stream < 16; stream++)
@@ -343,7 +340,7 @@ namespace D3D8
 
 	void Direct3DStateBlock8::setRenderState(D3DRENDERSTATETYPE state, unsigned long value)
 	{
-		renderStateCaptured[state] = true;
+		flagRenderState(state);
 		renderState[state] = value;
 	}
 
@@ -371,7 +368,7 @@ namespace D3D8
 
 	void Direct3DStateBlock8::setTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type, unsigned long value)
 	{
-		textureStageStateCaptured[stage][type] = true;
+		flagTextureStageState(stage, type);
 		textureStageState[stage][type] = value;
 	}
 
@@ -418,6 +415,9 @@ namespace D3D8
 			}
 		}
 
+		capturedRenderStates.clear();
+		capturedTextureStageStates.clear();
+
 		for(int stream = 0; stream < 16; stream++)
 		{
 			streamSourceCaptured[stream] = false;
@@ -472,13 +472,31 @@ namespace D3D8
 	void Direct3DStateBlock8::captureRenderState(D3DRENDERSTATETYPE state)
 	{
 		device->GetRenderState(state, &renderState[state]);
-		renderStateCaptured[state] = true;
+		flagRenderState(state);
 	}
 
 	void Direct3DStateBlock8::captureTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type)
 	{
 		device->GetTextureStageState(stage, type, &textureStageState[stage][type]);
-		textureStageStateCaptured[stage][type] = true;
+		flagTextureStageState(stage, type);
+	}
+
+	void Direct3DStateBlock8::flagRenderState(D3DRENDERSTATETYPE state)
+	{
+		if(!renderStateCaptured[state])
+		{
+			renderStateCaptured[state] = true;
+			capturedRenderStates.push_back(state);
+		}
+	}
+
+	void Direct3DStateBlock8::flagTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type)
+	{
+		if(!textureStageStateCaptured[stage][type])
+		{
+			textureStageStateCaptured[stage][type] = true;
+			capturedTextureStageStates.push_back(stage * (D3DTSS_RESULTARG + 1) + type);
+		}
 	}
 
 	void Direct3DStateBlock8::captureTransform(D3DTRANSFORMSTATETYPE state)
@@ -70,6 +70,9 @@ namespace D3D8
 		void captureTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type);
 		void captureTransform(D3DTRANSFORMSTATETYPE state);
 
+		void flagRenderState(D3DRENDERSTATETYPE state);
+		void flagTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type);
+
 		// Pixel states
 		void capturePixelRenderStates();
 		void capturePixelTextureStates();
@@ -115,6 +118,10 @@ namespace D3D8
 		bool textureStageStateCaptured[8][D3DTSS_RESULTARG + 1];
 		unsigned long textureStageState[8][D3DTSS_RESULTARG + 1];
 
+		// Captured states in the order they were first flagged, so Capture() and Apply() don't scan every state
+		std::vector<unsigned short> capturedRenderStates;
+		std::vector<unsigned short> capturedTextureStageStates;   // stage * (D3DTSS_RESULTARG + 1) + type
+
 		bool streamSourceCaptured[16];
 		struct StreamSource
 		{
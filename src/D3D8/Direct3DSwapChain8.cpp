@@ -77,10 +77,6 @@ namespace D3D8
 	{
 		TRACE("");
 
-		#if PERF_PROFILE
-			profiler.nextFrame();
-		#endif
-
 		if(!sourceRect && !destRect)   // FIXME: More cases?
 		{
 			frameBuffer->flip(destWindowOverride, backBuffer[0]);
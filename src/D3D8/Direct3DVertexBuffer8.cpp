@@ -69,6 +69,11 @@ namespace D3D8
 	Direct3DVertexBuffer8::~Direct3DVertexBuffer8()
 	{
 		vertexBuffer->destruct();
+
+		for(sw::Resource *resource : retired)
+		{
+			resource->destruct();
+		}
 	}
 
 	long Direct3DVertexBuffer8::QueryInterface(const IID &iid, void **object)
@@ -177,8 +182,17 @@ namespace D3D8
 		lockOffset = offset;
 		lockSize = size;
 
-		*data = (unsigned char*)vertexBuffer->lock(sw::PUBLIC) + offset;
-		vertexBuffer->unlock();
+		if(flags & D3DLOCK_DISCARD)
+		{
+			vertexBuffer = discard();
+
+			*data = (unsigned char*)vertexBuffer->data() + offset;
+		}
+		else
+		{
+			*data = (unsigned char*)vertexBuffer->lock(sw::PUBLIC) + offset;
+			vertexBuffer->unlock();
+		}
 
 		return D3D_OK;
 	}
@@ -218,4 +232,30 @@ namespace D3D8
 	{
 		return vertexBuffer;
 	}
+
+	sw::Resource *Direct3DVertexBuffer8::discard()
+	{
+		// Draws still reading the current contents keep them, and retired contents they're done with get reused
+		sw::Resource *next = nullptr;
+
+		for(size_t i = 0; i < retired.size(); i++)
+		{
+			if(retired[i]->isIdle())
+			{
+				next = retired[i];
+				retired.erase(retired.begin() + i);
+				break;
+			}
+		}
+
+		if(retired.size() == MAX_RETIRED)
+		{
+			retired.front()->destruct();
+			retired.erase(retired.begin());
+		}
+
+		retired.push_back(vertexBuffer);
+
+		return next ? next : new sw::Resource(length + 192 + 1024);   // NOTE: Applications can 'overshoot' while writing vertices
+	}
 }
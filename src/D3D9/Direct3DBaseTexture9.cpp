@@ -160,8 +160,6 @@ namespace D3D9
 
 	unsigned long Direct3DBaseTexture9::GetLevelCount()
 	{
-		CriticalSection cs(device);
-
 		TRACE("");
 
 		if(usage & D3DUSAGE_AUTOGENMIPMAP)
@@ -298,8 +298,6 @@ namespace D3D9
 
 	long Direct3DCubeTexture9::LockRect(D3DCUBEMAP_FACES face, unsigned int level, D3DLOCKED_RECT *lockedRect, const RECT *rect, unsigned long flags)
 	{
-		CriticalSection cs(device);
-
 		TRACE("");
 
 		if(!lockedRect || face >= 6 || level >= GetLevelCount() || !surfaceLevel[face][level])
@@ -312,8 +310,6 @@ namespace D3D9
 
 	long Direct3DCubeTexture9::UnlockRect(D3DCUBEMAP_FACES face, unsigned int level)
 	{
-		CriticalSection cs(device);
-
 		TRACE("");
 
 		if(face >= 6 || level >= GetLevelCount() || !surfaceLevel[face][level])
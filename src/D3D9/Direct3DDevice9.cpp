@@ -529,8 +529,6 @@ namespace D3D9
 
 	long Direct3DDevice9::CreateCubeTexture(unsigned int edgeLength, unsigned int levels, unsigned long usage, D3DFORMAT format, D3DPOOL pool, IDirect3DCubeTexture9 **cubeTexture, void **sharedHandle)
 	{
-		CriticalSection cs(this);
-
 		TRACE("unsigned int edgeLength = %d, unsigned int levels = %d, unsigned long usage = %d, D3DFORMAT format = %d, D3DPOOL pool = %d, IDirect3DCubeTexture9 **cubeTexture = 0x%0.8p, void **sharedHandle = 0x%0.8p", edgeLength, levels, usage, format, pool, cubeTexture, sharedHandle);
 
 		*cubeTexture = 0;
@@ -562,8 +560,6 @@ namespace D3D9
 
 	long Direct3DDevice9::CreateDepthStencilSurface(unsigned int width, unsigned int height, D3DFORMAT format, D3DMULTISAMPLE_TYPE multiSample, unsigned long multiSampleQuality, int discard, IDirect3DSurface9 **surface, void **sharedHandle)
 	{
-		CriticalSection cs(this);
-
 		TRACE("unsigned int width = %d, unsigned int height = %d, D3DFORMAT format = %d, D3DMULTISAMPLE_TYPE multiSample = %d, unsigned long multiSampleQuality = %d, int discard = %d, IDirect3DSurface9 **surface = 0x%0.8p, void **sharedHandle = 0x%0.8p", width, height, format, multiSample, multiSampleQuality, discard, surface, sharedHandle);
 
 		*surface = 0;
@@ -621,8 +617,6 @@ namespace D3D9
 
 	long Direct3DDevice9::CreateIndexBuffer(unsigned int length, unsigned long usage, D3DFORMAT format, D3DPOOL pool, IDirect3DIndexBuffer9 **indexBuffer, void **sharedHandle)
 	{
-		CriticalSection cs(this);
-
 		TRACE("unsigned int length = %d, unsigned long usage = %d, D3DFORMAT format = %d, D3DPOOL pool = %d, IDirect3DIndexBuffer9 **indexBuffer = 0x%0.8p, void **sharedHandle = 0x%0.8p", length, usage, format, pool, indexBuffer, sharedHandle);
 
 		*indexBuffer = new Direct3DIndexBuffer9(this, length, usage, format, pool);
@@ -647,8 +641,6 @@ namespace D3D9
 
 	long Direct3DDevice9::CreateOffscreenPlainSurface(unsigned int width, unsigned int height, D3DFORMAT format, D3DPOOL pool, IDirect3DSurface9 **surface, void **sharedHandle)
 	{
-		CriticalSection cs(this);
-
 		TRACE("unsigned int width = %d, unsigned int height = %d, D3DFORMAT format = %d, D3DPOOL pool = %d, IDirect3DSurface9 **surface = 0x%0.8p, void **sharedHandle = 0x%0.8p", width, height, format, pool, surface, sharedHandle);
 
 		*surface = 0;
@@ -776,8 +768,6 @@ namespace D3D9
 
 	long Direct3DDevice9::CreateRenderTarget(unsigned int width, unsigned int height, D3DFORMAT format, D3DMULTISAMPLE_TYPE multiSample, unsigned long multiSampleQuality, int lockable, IDirect3DSurface9 **surface, void **sharedHandle)
 	{
-		CriticalSection cs(this);
-
 		TRACE("unsigned int width = %d, unsigned int height = %d, D3DFORMAT format = %d, D3DMULTISAMPLE_TYPE multiSample = %d, unsigned long multiSampleQuality = %d, int lockable = %d, IDirect3DSurface9 **surface = 0x%0.8p, void **sharedHandle = 0x%0.8p", width, height, format, multiSample, multiSampleQuality, lockable, surface, sharedHandle);
 
 		*surface = 0;
@@ -827,8 +817,6 @@ namespace D3D9
 
 	long Direct3DDevice9::CreateTexture(unsigned int width, unsigned int height, unsigned int levels, unsigned long usage, D3DFORMAT format, D3DPOOL pool, IDirect3DTexture9 **texture, void **sharedHandle)
 	{
-		CriticalSection cs(this);
-
 		TRACE("unsigned int width = %d, unsigned int height = %d, unsigned int levels = %d, unsigned long usage = %d, D3DFORMAT format = %d, D3DPOOL pool = %d, IDirect3DTexture9 **texture = 0x%0.8p, void **sharedHandle = 0x%0.8p", width, height, levels, usage, format, pool, texture, sharedHandle);
 
 		*texture = 0;
@@ -860,8 +848,6 @@ namespace D3D9
 
 	long Direct3DDevice9::CreateVertexBuffer(unsigned int length, unsigned long usage, unsigned long FVF, D3DPOOL pool, IDirect3DVertexBuffer9 **vertexBuffer, void **sharedHandle)
 	{
-		CriticalSection cs(this);
-
 		TRACE("unsigned int length = %d, unsigned long usage = %d, unsigned long FVF = 0x%0.8X, D3DPOOL pool = %d, IDirect3DVertexBuffer9 **vertexBuffer = 0x%0.8p, void **sharedHandle = 0x%0.8p", length, usage, FVF, pool, vertexBuffer, sharedHandle);
 
 		*vertexBuffer = new Direct3DVertexBuffer9(this, length, usage, FVF, pool);
@@ -951,8 +937,6 @@ namespace D3D9
 
 	long Direct3DDevice9::CreateVolumeTexture(unsigned int width, unsigned int height, unsigned int depth, unsigned int levels, unsigned long usage, D3DFORMAT format, D3DPOOL pool, IDirect3DVolumeTexture9 **volumeTexture, void **sharedHandle)
 	{
-		CriticalSection cs(this);
-
 		TRACE("unsigned int width = %d, unsigned int height = %d, unsigned int depth = %d, unsigned int levels = %d, unsigned long usage = %d, D3DFORMAT format = %d, D3DPOOL pool = %d, IDirect3DVolumeTexture9 **volumeTexture = 0x%0.8p, void **sharedHandle = 0x%0.8p", width, height, depth, levels, usage, format, pool, volumeTexture, sharedHandle);
 
 		*volumeTexture = 0;
@@ -1330,8 +1314,6 @@ namespace D3D9
 
 	unsigned int Direct3DDevice9::GetAvailableTextureMem()
 	{
-		CriticalSection cs(this);
-
 		TRACE("void");
 
 		int availableMemory = textureMemory - Direct3DResource9::getMemoryUsage();
@@ -1829,7 +1811,7 @@ namespace D3D9
 			void *sourceBuffer = source->lockExternal(0, 0, 0, sw::LOCK_READONLY, sw::PUBLIC);
 			void *destBuffer = dest->lockExternal(0, 0, 0, sw::LOCK_WRITEONLY, sw::PUBLIC);
 
-			static void (__cdecl *blitFunction)(void *dst, void *src);
+			static void (__cdecl *blitFunction)(void *dst, void *src, void *cursor, const sw::Rect *region);
 			static sw::Routine *blitRoutine;
 			static sw::BlitState blitState = {};
 
@@ -1849,10 +1831,11 @@ namespace D3D9
 				delete blitRoutine;
 
 				blitRoutine = sw::FrameBuffer::copyRoutine(blitState);
-				blitFunction = (void(__cdecl*)(void*, void*))blitRoutine->getEntry();
+				blitFunction = (void(__cdecl*)(void*, void*, void*, const sw::Rect*))blitRoutine->getEntry();
 			}
 
-			blitFunction(destBuffer, sourceBuffer);
+			sw::Rect region(0, 0, update.width, update.height);
+			blitFunction(destBuffer, sourceBuffer, nullptr, &region);
 
 			dest->unlockExternal();
 			source->unlockExternal();
@@ -45,11 +45,14 @@ namespace D3D9
 	class Direct3DVertexBuffer9;
 	class Direct3DIndexBuffer9;
 	class CriticalSection;
+	class ResourceSection;
 
 	class Direct3DDevice9 : public IDirect3DDevice9, public Unknown
 	{
 		friend CriticalSection;
+		friend ResourceSection;
 		friend Direct3DSwapChain9;
+		friend Direct3DStateBlock9;
 
 	public:
 		Direct3DDevice9(const HINSTANCE instance, Direct3D9 *d3d9, unsigned int adapter, D3DDEVTYPE deviceType, HWND focusWindow, unsigned long behaviourFlags, D3DPRESENT_PARAMETERS *presentParameters);
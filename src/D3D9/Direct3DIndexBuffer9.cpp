@@ -31,6 +31,11 @@ namespace D3D9
 	Direct3DIndexBuffer9::~Direct3DIndexBuffer9()
 	{
 		indexBuffer->destruct();
+
+		for(sw::Resource *resource : retired)
+		{
+			resource->destruct();
+		}
 	}
 
 	long Direct3DIndexBuffer9::QueryInterface(const IID &iid, void **object)
@@ -162,7 +167,7 @@ namespace D3D9
 
 	long Direct3DIndexBuffer9::Lock(unsigned int offset, unsigned int size, void **data, unsigned long flags)
 	{
-		CriticalSection cs(device);
+		ResourceSection rs(this);
 
 		TRACE("");
 
@@ -180,8 +185,7 @@ namespace D3D9
 
 		if(flags & D3DLOCK_DISCARD/* && usage & D3DUSAGE_DYNAMIC*/)
 		{
-			indexBuffer->destruct();
-			indexBuffer = new sw::Resource(length + 16);
+			indexBuffer = discard();
 
 			buffer = (void*)indexBuffer->data();
 		}
@@ -202,7 +206,7 @@ namespace D3D9
 
 	long Direct3DIndexBuffer9::Unlock()
 	{
-		CriticalSection cs(device);
+		ResourceSection rs(this);
 
 		TRACE("");
 
@@ -217,6 +221,8 @@ namespace D3D9
 
 	sw::Resource *Direct3DIndexBuffer9::getResource() const
 	{
+		ResourceSection rs(this);   // Lock(D3DLOCK_DISCARD) can swap the contents on another thread
+
 		return indexBuffer;
 	}
 
@@ -234,4 +240,36 @@ namespace D3D9
 
 		return false;
 	}
+
+	sw::Resource *Direct3DIndexBuffer9::discard()
+	{
+		// Draws still reading the current contents keep them, and retired contents they're done with get reused
+		sw::Resource *next = nullptr;
+
+		for(size_t i = 0; i < retired.size(); i++)
+		{
+			if(retired[i]->isIdle())
+			{
+				next = retired[i];
+				retired.erase(retired.begin() + i);
+				break;
+			}
+		}
+
+		if(retired.size() == MAX_RETIRED)
+		{
+			retired.front()->destruct();
+			retired.erase(retired.begin());
+		}
+
+		if(lockCount > 0)   // Still locked by a Lock() without a matching Unlock(), which can't apply to the new contents
+		{
+			indexBuffer->unlock(sw::PUBLIC);
+			lockCount = 0;
+		}
+
+		retired.push_back(indexBuffer);
+
+		return next ? next : new sw::Resource(length + 16);
+	}
 }
@@ -19,6 +19,8 @@
 
 #include <d3d9.h>
 
+#include <vector>
+
 namespace sw
 {
 	class Resource;
@@ -58,12 +60,20 @@ namespace D3D9
 		bool is32Bit() const;
 
 	private:
+		enum
+		{
+			MAX_RETIRED = 16,   // Discarded contents which pending draws may still read, reused once they are done
+		};
+
+		sw::Resource *discard();
+
 		// Creation parameters
 		const unsigned int length;
 		const long usage;
 		const D3DFORMAT format;
 
 		sw::Resource *indexBuffer;
+		std::vector<sw::Resource*> retired;
 		int lockCount;
 	};
 }
@@ -19,7 +19,7 @@
 
 namespace D3D9
 {
-	unsigned int Direct3DResource9::memoryUsage = 0;
+	std::atomic<unsigned int> Direct3DResource9::memoryUsage(0);
 
 	Direct3DResource9::PrivateData::PrivateData()
 	{
@@ -74,6 +74,8 @@ namespace D3D9
 
 	Direct3DResource9::Direct3DResource9(Direct3DDevice9 *device, D3DRESOURCETYPE type, D3DPOOL pool, unsigned int size) : device(device), type(type), pool(pool), size(size)
 	{
+		InitializeCriticalSection(&criticalSection);
+
 		priority = 0;
 
 		if(pool == D3DPOOL_DEFAULT)
@@ -88,6 +90,8 @@ namespace D3D9
 		{
 			memoryUsage -= size;
 		}
+
+		DeleteCriticalSection(&criticalSection);
 	}
 
 	long Direct3DResource9::QueryInterface(const IID &iid, void **object)
@@ -239,4 +243,21 @@ namespace D3D9
 	{
 		return pool;
 	}
-}
\ No newline at end of file
+
+	ResourceSection::ResourceSection(const Direct3DResource9 *resource)
+		: criticalSection((resource->device->behaviourFlags & D3DCREATE_MULTITHREADED) ? &resource->criticalSection : nullptr)
+	{
+		if(criticalSection)
+		{
+			EnterCriticalSection(criticalSection);
+		}
+	}
+
+	ResourceSection::~ResourceSection()
+	{
+		if(criticalSection)
+		{
+			LeaveCriticalSection(criticalSection);
+		}
+	}
+}
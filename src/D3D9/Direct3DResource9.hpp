@@ -20,13 +20,17 @@
 #include <d3d9.h>
 
 #include <map>
+#include <atomic>
 
 namespace D3D9
 {
 	class Direct3DDevice9;
+	class ResourceSection;
 
 	class Direct3DResource9 : public IDirect3DResource9, public Unknown
 	{
+		friend ResourceSection;
+
 	public:
 		Direct3DResource9(Direct3DDevice9 *device, D3DRESOURCETYPE type, D3DPOOL pool, unsigned int size);
 
@@ -61,6 +65,8 @@ namespace D3D9
 	private:
 		unsigned long priority;
 
+		mutable CRITICAL_SECTION criticalSection;   // Taken by ResourceSection instead of the device's
+
 		struct PrivateData
 		{
 			PrivateData();
@@ -87,7 +93,20 @@ namespace D3D9
 		typedef PrivateDataMap::iterator Iterator;
 		PrivateDataMap privateData;
 
-		static unsigned int memoryUsage;
+		static std::atomic<unsigned int> memoryUsage;   // Resources get created and released without the device's critical section
+	};
+
+	// Serializes the calls on a single resource, so threads working on independent resources don't contend for the
+	// device's critical section. The sw::Resource contents are synchronized with the renderer by their own locks.
+	class ResourceSection
+	{
+	public:
+		ResourceSection(const Direct3DResource9 *resource);
+
+		~ResourceSection();
+
+	private:
+		CRITICAL_SECTION *const criticalSection;
 	};
 }
 
@@ -149,9 +149,10 @@ namespace D3D9
 			device->SetIndices(indexBuffer);
 		}
 
-		for(int state = D3DRS_ZENABLE; state <= D3DRS_BLENDOPALPHA; state++)
+		// Only call the setters for states which differ from the device's, to leave the renderer state untouched otherwise
+		for(unsigned short state : capturedRenderStates)
 		{
-			if(renderStateCaptured[state])
+			if(device->init || device->renderState[state] != renderState[state])
 			{
 				device->SetRenderState((D3DRENDERSTATETYPE)state, renderState[state]);
 			}
@@ -162,26 +163,26 @@ namespace D3D9
 			device->SetNPatchMode(nPatchMode);
 		}
 
-		for(int stage = 0; stage < 8; stage++)
+		for(unsigned short index : capturedTextureStageStates)
 		{
-			for(int state = D3DTSS_COLOROP; state <= D3DTSS_CONSTANT; state++)
+			int stage = index / (D3DTSS_CONSTANT + 1);
+			int state = index % (D3DTSS_CONSTANT + 1);
+
+			if(device->init || device->textureStageState[stage][state] != textureStageState[stage][state])
 			{
-				if(textureStageStateCaptured[stage][state])
-				{
-					device->SetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)state, textureStageState[stage][state]);
-				}
+				device->SetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)state, textureStageState[stage][state]);
 			}
 		}
 
-		for(int sampler = 0; sampler < 16 + 4; sampler++)
+		for(unsigned short index : capturedSamplerStates)
 		{
-			for(int state = D3DSAMP_ADDRESSU; state <= D3DSAMP_DMAPOFFSET; state++)
+			int sampler = index / (D3DSAMP_DMAPOFFSET + 1);
+			int state = index % (D3DSAMP_DMAPOFFSET + 1);
+
+			if(device->init || device->samplerState[sampler][state] != samplerState[sampler][state])
 			{
-				if(samplerStateCaptured[sampler][state])
-				{
-					int index = sampler < 16 ? sampler : D3DVERTEXTEXTURESAMPLER0 + (sampler - 16);
-					device->SetSamplerState(index, (D3DSAMPLERSTATETYPE)state, samplerState[sampler][state]);
-				}
+				int samplerIndex = sampler < 16 ? sampler : D3DVERTEXTEXTURESAMPLER0 + (sampler - 16);
+				device->SetSamplerState(samplerIndex, (D3DSAMPLERSTATETYPE)state, samplerState[sampler][state]);
 			}
 		}
 
@@ -369,12 +370,9 @@ namespace D3D9
 			this->indexBuffer = indexBuffer;
 		}
 
-		for(int state = 0; state < D3DRS_BLENDOPALPHA + 1; state++)
+		for(unsigned short state : capturedRenderStates)
 		{
-			if(renderStateCaptured[state])
-			{
-				device->GetRenderState((D3DRENDERSTATETYPE)state, &renderState[state]);
-			}
+			device->GetRenderState((D3DRENDERSTATETYPE)state, &renderState[state]);
 		}
 
 		if(nPatchModeCaptured)
@@ -382,27 +380,21 @@ namespace D3D9
 			nPatchMode = device->GetNPatchMode();
 		}
 
-		for(int stage = 0; stage < 8; stage++)
+		for(unsigned short index : capturedTextureStageStates)
 		{
-			for(int state = 0; state < D3DTSS_CONSTANT + 1; state++)
-			{
-				if(textureStageStateCaptured[stage][state])
-				{
-					device->GetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)state, &textureStageState[stage][state]);
-				}
-			}
+			int stage = index / (D3DTSS_CONSTANT + 1);
+			int state = index % (D3DTSS_CONSTANT + 1);
+
+			device->GetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)state, &textureStageState[stage][state]);
 		}
 
-		for(int sampler = 0; sampler < 16 + 4; sampler++)
+		for(unsigned short index : capturedSamplerStates)
 		{
-			for(int state = 0; state < D3DSAMP_DMAPOFFSET + 1; state++)
-			{
-				if(samplerStateCaptured[sampler][state])
-				{
-					int index = sampler < 16 ? sampler : D3DVERTEXTEXTURESAMPLER0 + (sampler - 16);
-					device->GetSamplerState(index, (D3DSAMPLERSTATETYPE)state, &samplerState[sampler][state]);
-				}
-			}
+			int sampler = index / (D3DSAMP_DMAPOFFSET + 1);
+			int state = index % (D3DSAMP_DMAPOFFSET + 1);
+			int samplerIndex = sampler < 16 ? sampler : D3DVERTEXTEXTURESAMPLER0 + (sampler - 16);
+
+			device->GetSamplerState(samplerIndex, (D3DSAMPLERSTATETYPE)state, &samplerState[sampler][state]);
 		}
 
 		for(int stream = 0; stream < MAX_VERTEX_INPUTS; stream++)
@@ -702,7 +694,7 @@ namespace D3D9
 
 	void Direct3DStateBlock9::setRenderState(D3DRENDERSTATETYPE state, unsigned long value)
 	{
-		renderStateCaptured[state] = true;
+		flagRenderState(state);
 		renderState[state] = value;
 	}
 
@@ -715,7 +707,7 @@ namespace D3D9
 			return;
 		}
 
-		samplerStateCaptured[sampler][state] = true;
+		flagSamplerState(sampler, state);
 		samplerState[sampler][state] = value;
 	}
 
@@ -760,7 +752,7 @@ namespace D3D9
 
 	void Direct3DStateBlock9::setTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type, unsigned long value)
 	{
-		textureStageStateCaptured[stage][type] = true;
+		flagTextureStageState(stage, type);
 		textureStageState[stage][type] = value;
 	}
 
@@ -840,6 +832,10 @@ namespace D3D9
 			}
 		}
 
+		capturedRenderStates.clear();
+		capturedTextureStageStates.clear();
+		capturedSamplerStates.clear();
+
 		for(int stream = 0; stream < MAX_VERTEX_INPUTS; stream++)
 		{
 			streamSourceCaptured[stream] = false;
@@ -962,7 +958,7 @@ namespace D3D9
 	void Direct3DStateBlock9::captureRenderState(D3DRENDERSTATETYPE state)
 	{
 		device->GetRenderState(state, &renderState[state]);
-		renderStateCaptured[state] = true;
+		flagRenderState(state);
 	}
 
 	void Direct3DStateBlock9::captureSamplerState(unsigned long index, D3DSAMPLERSTATETYPE state)
@@ -970,21 +966,48 @@ namespace D3D9
 		if(index < 16)
 		{
 			device->GetSamplerState(index, state, &samplerState[index][state]);
-			samplerStateCaptured[index][state] = true;
+			flagSamplerState(index, state);
 		}
 		else if(index >= D3DVERTEXTEXTURESAMPLER0)
 		{
 			unsigned int sampler = 16 + (index - D3DVERTEXTEXTURESAMPLER0);
 
 			device->GetSamplerState(index, state, &samplerState[sampler][state]);
-			samplerStateCaptured[sampler][state] = true;
+			flagSamplerState(sampler, state);
 		}
 	}
 
 	void Direct3DStateBlock9::captureTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type)
 	{
 		device->GetTextureStageState(stage, type, &textureStageState[stage][type]);
-		textureStageStateCaptured[stage][type] = true;
+		flagTextureStageState(stage, type);
+	}
+
+	void Direct3DStateBlock9::flagRenderState(D3DRENDERSTATETYPE state)
+	{
+		if(!renderStateCaptured[state])
+		{
+			renderStateCaptured[state] = true;
+			capturedRenderStates.push_back(state);
+		}
+	}
+
+	void Direct3DStateBlock9::flagSamplerState(unsigned int sampler, D3DSAMPLERSTATETYPE state)
+	{
+		if(!samplerStateCaptured[sampler][state])
+		{
+			samplerStateCaptured[sampler][state] = true;
+			capturedSamplerStates.push_back(sampler * (D3DSAMP_DMAPOFFSET + 1) + state);
+		}
+	}
+
+	void Direct3DStateBlock9::flagTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type)
+	{
+		if(!textureStageStateCaptured[stage][type])
+		{
+			textureStageStateCaptured[stage][type] = true;
+			capturedTextureStageStates.push_back(stage * (D3DTSS_CONSTANT + 1) + type);
+		}
 	}
 
 	void Direct3DStateBlock9::captureTransform(D3DTRANSFORMSTATETYPE state)
@@ -84,6 +84,10 @@ namespace D3D9
 		void captureTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type);
 		void captureTransform(D3DTRANSFORMSTATETYPE state);
 
+		void flagRenderState(D3DRENDERSTATETYPE state);
+		void flagSamplerState(unsigned int sampler, D3DSAMPLERSTATETYPE state);
+		void flagTextureStageState(unsigned long stage, D3DTEXTURESTAGESTATETYPE type);
+
 		// Pixel states
 		void capturePixelRenderStates();
 		void capturePixelTextureStates();
@@ -139,6 +143,11 @@ namespace D3D9
 		bool samplerStateCaptured[16 + 4][D3DSAMP_DMAPOFFSET + 1];
 		unsigned long samplerState[16 + 4][D3DSAMP_DMAPOFFSET + 1];
 
+		// Captured states in the order they were first flagged, so Capture() and Apply() don't scan every state
+		std::vector<unsigned short> capturedRenderStates;
+		std::vector<unsigned short> capturedTextureStageStates;   // stage * (D3DTSS_CONSTANT + 1) + type
+		std::vector<unsigned short> capturedSamplerStates;   // sampler * (D3DSAMP_DMAPOFFSET + 1) + state
+
 		bool streamSourceCaptured[MAX_VERTEX_INPUTS];
 		struct StreamSource
 		{
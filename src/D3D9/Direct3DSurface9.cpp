@@ -242,7 +242,7 @@ namespace D3D9
 
 	long Direct3DSurface9::LockRect(D3DLOCKED_RECT *lockedRect, const RECT *rect, unsigned long flags)
 	{
-		CriticalSection cs(device);
+		ResourceSection rs(this);
 
 		TRACE("D3DLOCKED_RECT *lockedRect = 0x%0.8p, const RECT *rect = 0x%0.8p, unsigned long flags = %d", lockedRect, rect, flags);
 
@@ -287,7 +287,7 @@ namespace D3D9
 
 	long Direct3DSurface9::UnlockRect()
 	{
-		CriticalSection cs(device);
+		ResourceSection rs(this);
 
 		TRACE("");
 
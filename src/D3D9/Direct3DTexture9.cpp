@@ -251,8 +251,6 @@ namespace D3D9
 
 	long Direct3DTexture9::LockRect(unsigned int level, D3DLOCKED_RECT *lockedRect, const RECT *rect, unsigned long flags)
 	{
-		CriticalSection cs(device);
-
 		TRACE("unsigned int level = %d, D3DLOCKED_RECT *lockedRect = 0x%0.8p, const RECT *rect = 0x%0.8p, unsigned long flags = %d", level, lockedRect, rect, flags);
 
 		if(!lockedRect || level >= GetLevelCount() || !surfaceLevel[level])
@@ -284,8 +282,6 @@ namespace D3D9
 
 	long Direct3DTexture9::UnlockRect(unsigned int level)
 	{
-		CriticalSection cs(device);
-
 		TRACE("unsigned int level = %d", level);
 
 		if(level >= GetLevelCount() || !surfaceLevel[level])
@@ -70,6 +70,11 @@ namespace D3D9
 	Direct3DVertexBuffer9::~Direct3DVertexBuffer9()
 	{
 		vertexBuffer->destruct();
+
+		for(sw::Resource *resource : retired)
+		{
+			resource->destruct();
+		}
 	}
 
 	long Direct3DVertexBuffer9::QueryInterface(const IID &iid, void **object)
@@ -181,7 +186,7 @@ namespace D3D9
 
 	long Direct3DVertexBuffer9::Lock(unsigned int offset, unsigned int size, void **data, unsigned long flags)
 	{
-		CriticalSection cs(device);
+		ResourceSection rs(this);
 
 		TRACE("");
 
@@ -199,8 +204,7 @@ namespace D3D9
 
 		if(flags & D3DLOCK_DISCARD/* && usage & D3DUSAGE_DYNAMIC*/)
 		{
-			vertexBuffer->destruct();
-			vertexBuffer = new sw::Resource(length + 192 + 1024);   // NOTE: Applications can 'overshoot' while writing vertices
+			vertexBuffer = discard();
 
 			buffer = (void*)vertexBuffer->data();
 		}
@@ -221,7 +225,7 @@ namespace D3D9
 
 	long Direct3DVertexBuffer9::Unlock()
 	{
-		CriticalSection cs(device);
+		ResourceSection rs(this);
 
 		TRACE("");
 
@@ -262,6 +266,40 @@ namespace D3D9
 
 	sw::Resource *Direct3DVertexBuffer9::getResource() const
 	{
+		ResourceSection rs(this);   // Lock(D3DLOCK_DISCARD) can swap the contents on another thread
+
 		return vertexBuffer;
 	}
+
+	sw::Resource *Direct3DVertexBuffer9::discard()
+	{
+		// Draws still reading the current contents keep them, and retired contents they're done with get reused
+		sw::Resource *next = nullptr;
+
+		for(size_t i = 0; i < retired.size(); i++)
+		{
+			if(retired[i]->isIdle())
+			{
+				next = retired[i];
+				retired.erase(retired.begin() + i);
+				break;
+			}
+		}
+
+		if(retired.size() == MAX_RETIRED)
+		{
+			retired.front()->destruct();
+			retired.erase(retired.begin());
+		}
+
+		if(lockCount > 0)   // Still locked by a Lock() without a matching Unlock(), which can't apply to the new contents
+		{
+			vertexBuffer->unlock(sw::PUBLIC);
+			lockCount = 0;
+		}
+
+		retired.push_back(vertexBuffer);
+
+		return next ? next : new sw::Resource(length + 192 + 1024);   // NOTE: Applications can 'overshoot' while writing vertices
+	}
 }
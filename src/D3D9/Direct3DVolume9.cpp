@@ -158,7 +158,7 @@ namespace D3D9
 
 	long Direct3DVolume9::LockBox(D3DLOCKED_BOX *lockedVolume, const D3DBOX *box, unsigned long flags)
 	{
-		CriticalSection cs(device);
+		ResourceSection rs(resource);
 
 		TRACE("");
 
@@ -214,7 +214,7 @@ namespace D3D9
 
 	long Direct3DVolume9::UnlockBox()
 	{
-		CriticalSection cs(device);
+		ResourceSection rs(resource);
 
 		TRACE("");
 
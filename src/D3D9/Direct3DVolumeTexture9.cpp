@@ -301,8 +301,6 @@ namespace D3D9
 
 	long Direct3DVolumeTexture9::LockBox(unsigned int level, D3DLOCKED_BOX *lockedVolume, const D3DBOX *box, unsigned long flags)
 	{
-		CriticalSection cs(device);
-
 		TRACE("");
 
 		if(!lockedVolume || level >= GetLevelCount() || !volumeLevel[level])
@@ -315,8 +313,6 @@ namespace D3D9
 
 	long Direct3DVolumeTexture9::UnlockBox(unsigned int level)
 	{
-		CriticalSection cs(device);
-
 		TRACE("");
 
 		if(level >= GetLevelCount() || !volumeLevel[level])
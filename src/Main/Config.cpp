@@ -14,14 +14,95 @@
 
 #include "Config.hpp"
 
-#include "Common/Thread.hpp"
+#include "Common/MutexLock.hpp"
+#include "Common/Resource.hpp"
 #include "Common/Timer.hpp"
 
+#include <string.h>
+
 namespace sw
 {
+	static MutexLock pipelineMutex;   // Of Profiler::pipeline, constructed before the profiler which uses it
+
 	Profiler profiler;
 
-	Profiler::Profiler()
+	PipelineProfile::PipelineProfile()
+	{
+		memset(this, 0, sizeof(PipelineProfile));
+	}
+
+	void PipelineProfile::add(const PipelineProfile &other)
+	{
+		for(int i = 0; i < PERF_TIMERS; i++)
+		{
+			cycles[i] += other.cycles[i];
+		}
+
+		drawCalls += other.drawCalls;
+		ropOperations += other.ropOperations;
+		texOperations += other.texOperations;
+		compressedTex += other.compressedTex;
+		earlyDepthRejects += other.earlyDepthRejects;
+		coherentBranches += other.coherentBranches;
+		divergentBranches += other.divergentBranches;
+	}
+
+	double PipelineProfile::share(int stage) const
+	{
+		if(cycles[PERF_PIXEL] <= 0)
+		{
+			return 0.0;
+		}
+
+		int64_t exclusive = cycles[stage];
+
+		switch(stage)
+		{
+		case PERF_PIXEL:  exclusive -= cycles[PERF_PIPE];                                          break;   // Rasterization
+		case PERF_PIPE:   exclusive -= cycles[PERF_INTERP] + cycles[PERF_SHADER] + cycles[PERF_ROP]; break;   // Depth and stencil testing
+		case PERF_SHADER: exclusive -= cycles[PERF_TEX];                                           break;
+		}
+
+		return (double)exclusive / cycles[PERF_PIXEL];
+	}
+
+	FrameUtilization::FrameUtilization()
+	{
+		memset(this, 0, sizeof(FrameUtilization));
+	}
+
+	void FrameUtilization::add(const FrameUtilization &other)
+	{
+		frames += other.frames;
+		threads = (other.threads > threads) ? other.threads : threads;
+		frameTime += other.frameTime;
+
+		for(int i = 0; i < other.threads; i++)
+		{
+			busyTime[i] += other.busyTime[i];
+			idleTime[i] += other.idleTime[i];
+		}
+
+		schedulerWait += other.schedulerWait;
+		resourceWait += other.resourceWait;
+		presentTime += other.presentTime;
+	}
+
+	double FrameUtilization::busyShare() const
+	{
+		int64_t busy = 0;
+		int64_t total = 0;
+
+		for(int i = 0; i < threads; i++)
+		{
+			busy += busyTime[i];
+			total += busyTime[i] + idleTime[i];
+		}
+
+		return total > 0 ? (double)busy / total : 0.0;
+	}
+
+	Profiler::Profiler() : utilizationProfiling(false), threads(0)
 	{
 		reset();
 	}
@@ -32,37 +113,122 @@ namespace sw
 		framesTotal = 0;
 		FPS = 0;
 
-		#if PERF_PROFILE
-			for(int i = 0; i < PERF_TIMERS; i++)
-			{
-				cycles[i] = 0;
-			}
+		pipelineMutex.lock();
+		pipeline = PipelineProfile();
+		pipelineMutex.unlock();
+
+		pipelineFrame = PipelineProfile();
+		pipelineTotal = PipelineProfile();
+
+		for(int i = 0; i < MAX_PROFILED_THREADS; i++)
+		{
+			busyTime[i] = 0;
+		}
 
-			ropOperations = 0;
-			ropOperationsTotal = 0;
-			ropOperationsFrame = 0;
+		schedulerWait = 0;
+		presentTime = 0;
+		resourceWaitStart = Resource::getBlockedTime();
+		frameStart = Timer::ticks();
+		utilizationFrames = 0;
 
-			texOperations = 0;
-			texOperationsTotal = 0;
-			texOperationsFrame = 0;
+		utilizationFrame = FrameUtilization();
+		utilizationWindow = FrameUtilization();
 
-			compressedTex = 0;
-			compressedTexTotal = 0;
-			compressedTexFrame = 0;
-		#endif
+		for(int i = 0; i < UTILIZATION_WINDOW; i++)
+		{
+			utilizationHistory[i] = FrameUtilization();
+		}
 	};
 
+	void Profiler::setUtilizationProfiling(bool enable)
+	{
+		if(enable && !utilizationProfiling)
+		{
+			// The current frame only starts being measured now
+			resourceWaitStart = Resource::getBlockedTime();
+			frameStart = Timer::ticks();
+		}
+
+		utilizationProfiling = enable;
+	}
+
+	void Profiler::setThreadCount(int count)
+	{
+		count = (count < MAX_PROFILED_THREADS) ? count : MAX_PROFILED_THREADS;
+		int current = threads;
+
+		while(count > current && !threads.compare_exchange_weak(current, count)) {}
+	}
+
+	void Profiler::addBusyTime(int thread, int64_t ticks)
+	{
+		if(thread < MAX_PROFILED_THREADS)
+		{
+			busyTime[thread].fetch_add(ticks, std::memory_order_relaxed);
+		}
+	}
+
+	void Profiler::addSchedulerWait(int64_t ticks)
+	{
+		schedulerWait.fetch_add(ticks, std::memory_order_relaxed);
+	}
+
+	void Profiler::addPresentTime(int64_t ticks)
+	{
+		presentTime.fetch_add(ticks, std::memory_order_relaxed);
+	}
+
+	void Profiler::addDraw(const PipelineProfile &draw)
+	{
+		pipelineMutex.lock();
+		pipeline.add(draw);
+		pipelineMutex.unlock();
+	}
+
 	void Profiler::nextFrame()
 	{
-		#if PERF_PROFILE
-			ropOperationsFrame = sw::atomicExchange(&ropOperations, 0);
-			texOperationsFrame = sw::atomicExchange(&texOperations, 0);
-			compressedTexFrame = sw::atomicExchange(&compressedTex, 0);
+		pipelineMutex.lock();
+		pipelineFrame = pipeline;
+		pipeline = PipelineProfile();
+		pipelineMutex.unlock();
+
+		pipelineTotal.add(pipelineFrame);
+
+		if(utilizationProfiling)
+		{
+			FrameUtilization frame;
+			int64_t frameEnd = Timer::ticks();
+			int64_t resourceWaitEnd = Resource::getBlockedTime();
+
+			frame.frames = 1;
+			frame.threads = threads;
+			frame.frameTime = frameEnd - frameStart;
 
-			ropOperationsTotal += ropOperationsFrame;
-			texOperationsTotal += texOperationsFrame;
-			compressedTexTotal += compressedTexFrame;
-		#endif
+			for(int i = 0; i < frame.threads; i++)
+			{
+				// Threads of several renderers can share an index, and tasks straddle frames
+				frame.busyTime[i] = busyTime[i].exchange(0, std::memory_order_relaxed);
+				frame.idleTime[i] = (frame.frameTime > frame.busyTime[i]) ? frame.frameTime - frame.busyTime[i] : 0;
+			}
+
+			frame.schedulerWait = schedulerWait.exchange(0, std::memory_order_relaxed);
+			frame.resourceWait = resourceWaitEnd - resourceWaitStart;
+			frame.presentTime = presentTime.exchange(0, std::memory_order_relaxed);
+
+			utilizationFrame = frame;
+			utilizationHistory[utilizationFrames % UTILIZATION_WINDOW] = frame;
+			utilizationFrames++;
+
+			utilizationWindow = FrameUtilization();
+
+			for(int i = 0; i < UTILIZATION_WINDOW; i++)
+			{
+				utilizationWindow.add(utilizationHistory[i]);
+			}
+
+			frameStart = frameEnd;
+			resourceWaitStart = resourceWaitEnd;
+		}
 
 		static double fpsTime = sw::Timer::seconds();
 
@@ -79,4 +245,4 @@ namespace sw
 			framesSec = 0;
 		}
 	}
-}
\ No newline at end of file
+}
@@ -17,10 +17,11 @@
 
 #include "Common/Types.hpp"
 
+#include <atomic>
+
 #define PERF_HUD 0       // Display time spent on vertex, setup and pixel processing for each thread
-#define PERF_PROFILE 0   // Profile various pipeline stages and display the timing in SwiftConfig
 
-#define ASTC_SUPPORT 0
+#define ASTC_SUPPORT 1
 
 // Worker thread count when not set by SwiftConfig
 // 0 = process affinity count (recommended)
@@ -43,32 +44,88 @@ namespace sw
 		PERF_TIMERS
 	};
 
+	// Cost breakdown of the pixel pipeline, accumulated by the pixel routines generated while pipeline profiling is enabled
+	struct PipelineProfile
+	{
+		PipelineProfile();
+
+		void add(const PipelineProfile &other);
+		double share(int stage) const;   // Fraction of the PERF_PIXEL time spent in the stage, excluding the stages nested in it
+
+		int64_t cycles[PERF_TIMERS];   // Timer::ticks() units, PERF_PIXEL covers all of the pixel routine
+		int64_t drawCalls;
+		int64_t ropOperations;       // Pixels reaching the raster operations
+		int64_t texOperations;       // Pixels sampled, counted for each sampling instruction
+		int64_t compressedTex;       // Pixels sampled from compressed textures
+		int64_t earlyDepthRejects;   // Quads rejected by depth, stencil or coverage before shading
+		int64_t coherentBranches;    // Pixel shader branches taken the same way by all pixels of a quad
+		int64_t divergentBranches;
+	};
+
+	enum
+	{
+		MAX_PROFILED_THREADS = 64,   // Renderer threads with a higher index aren't included in the utilization
+		UTILIZATION_WINDOW = 60,     // Frames summed by Profiler::utilizationWindow
+	};
+
+	// Where the CPU time of frames went, in Timer::ticks() units, collected while utilization profiling is enabled
+	struct FrameUtilization
+	{
+		FrameUtilization();
+
+		void add(const FrameUtilization &other);
+		double busyShare() const;   // Fraction of the renderer threads' time spent executing tasks
+
+		int frames;
+		int threads;          // Renderer threads, of the renderer with the most
+		int64_t frameTime;    // Between the ends of consecutive presents
+		int64_t busyTime[MAX_PROFILED_THREADS];   // Executing tasks, by renderer thread index
+		int64_t idleTime[MAX_PROFILED_THREADS];   // The rest of the frame time, including scheduling, polling and parking
+		int64_t schedulerWait;    // Waiting for the scheduler lock, summed over the renderer threads
+		int64_t resourceWait;     // Blocked in Resource::lock(), summed over all threads
+		int64_t presentTime;      // Spent in FrameBuffer::copy()
+	};
+
 	struct Profiler
 	{
 		Profiler();
 
 		void reset();
 		void nextFrame();
+		void addDraw(const PipelineProfile &draw);   // Thread safe, for draw calls retiring on the worker threads
+
+		// Thread safe, the renderer threads only report their time while enabled
+		void setUtilizationProfiling(bool enable);
+		bool isUtilizationProfiling() const { return utilizationProfiling; }
+		void setThreadCount(int count);   // Of a renderer which (re)started its threads
+		void addBusyTime(int thread, int64_t ticks);
+		void addSchedulerWait(int64_t ticks);
+		void addPresentTime(int64_t ticks);
 
 		int framesSec;
 		int framesTotal;
 		double FPS;
 
-		#if PERF_PROFILE
-		double cycles[PERF_TIMERS];
+		PipelineProfile pipelineFrame;   // Of the last completed frame
+		PipelineProfile pipelineTotal;   // Of all completed frames
+
+		FrameUtilization utilizationFrame;    // Of the last completed frame
+		FrameUtilization utilizationWindow;   // Of the last UTILIZATION_WINDOW completed frames
 
-		int64_t ropOperations;
-		int64_t ropOperationsTotal;
-		int64_t ropOperationsFrame;
+	private:
+		PipelineProfile pipeline;   // Of the current frame, guarded by a mutex
 
-		int64_t texOperations;
-		int64_t texOperationsTotal;
-		int64_t texOperationsFrame;
+		// Of the current frame
+		std::atomic<bool> utilizationProfiling;
+		std::atomic<int> threads;
+		std::atomic<int64_t> busyTime[MAX_PROFILED_THREADS];
+		std::atomic<int64_t> schedulerWait;
+		std::atomic<int64_t> presentTime;
+		int64_t resourceWaitStart;   // Resource::getBlockedTime() when the frame started
+		int64_t frameStart;
+		int utilizationFrames;   // Completed since the reset
 
-		int64_t compressedTex;
-		int64_t compressedTexTotal;
-		int64_t compressedTexFrame;
-		#endif
+		FrameUtilization utilizationHistory[UTILIZATION_WINDOW];   // Ring buffer of completed frames
 	};
 
 	extern Profiler profiler;
@@ -82,6 +139,8 @@ namespace sw
 		TOTAL_IMAGE_UNITS = TEXTURE_IMAGE_UNITS + VERTEX_TEXTURE_IMAGE_UNITS,
 		FRAGMENT_UNIFORM_VECTORS = 264,
 		VERTEX_UNIFORM_VECTORS = 259,
+		PROLOGUE_UNIFORM_VECTORS = 32,   // Results of per-draw shader instructions, stored after the uniform vectors
+		MAX_SPECIALIZED_UNIFORMS = 4,    // Branch controlling uniform components which routines can be compiled for
 		MAX_VERTEX_INPUTS = 32,
 		MAX_VERTEX_OUTPUTS = 34,
 		MAX_FRAGMENT_INPUTS = 32,
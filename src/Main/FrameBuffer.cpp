@@ -16,7 +16,10 @@
 
 #include "Renderer/Surface.hpp"
 #include "Reactor/Reactor.hpp"
+#include "Common/Configurator.hpp"
+#include "Common/CPUID.hpp"
 #include "Common/Timer.hpp"
+#include "Common/TraceEvents.hpp"
 #include "Common/Debug.hpp"
 
 #include <stdio.h>
@@ -27,8 +30,6 @@
 #include <cutils/properties.h>
 #endif
 
-#define ASYNCHRONOUS_BLIT false   // FIXME: Currently leads to rare race conditions
-
 namespace sw
 {
 	extern bool forceWindowed;
@@ -48,32 +49,212 @@ namespace sw
 		stride = 0;
 
 		windowed = !fullscreen || forceWindowed;
+		persistent = false;
 
 		blitFunction = nullptr;
 		blitRoutine = nullptr;
 		blitState = {};
+		blitBuffer = nullptr;
+
+		sw::Configurator ini("SwiftShader.ini");
+		configuredFramesInFlight = clamp(ini.getInteger("FrameBuffer", "MaxFramesInFlight", 0), 0, (int)MAX_FRAMES_IN_FLIGHT);
+		maxFramesInFlight = configuredFramesInFlight;
+		dropFrames = false;
+		copyThreadCount = ini.getInteger("FrameBuffer", "CopyThreadCount", 0);
+		copyThreadCount = clamp(copyThreadCount > 0 ? copyThreadCount : CPUID::processAffinity(), 1, (int)MAX_COPY_THREADS);
+
+		for(CopyTask &task : copyTasks)
+		{
+			task.frameBuffer = this;
+			task.thread = nullptr;   // Started by the first copy large enough to need it
+		}
 
-		if(ASYNCHRONOUS_BLIT)
+		for(int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 		{
-			terminate = false;
-			FrameBuffer *parameters = this;
-			blitThread = new Thread(threadFunction, &parameters);
+			swapChain[i] = nullptr;
+		}
+
+		presentIndex = 0;
+		framesInFlight = 0;
+		terminate = false;
+		blitThread = nullptr;
+		presentedFrames = 0;
+		droppedFrames = 0;
+
+		if(maxFramesInFlight > 0)
+		{
+			blitThread = new Thread(threadFunction, this);
 		}
 	}
 
 	FrameBuffer::~FrameBuffer()
 	{
-		if(ASYNCHRONOUS_BLIT)
+		swapChainMutex.lock();
+		terminate = true;
+		swapChainMutex.unlock();
+
+		if(blitThread)
 		{
-			terminate = true;
-			blitEvent.signal();
+			ASSERT(framesInFlight == 0);   // The frames have to be flipped before the derived frame buffer goes away
+
+			frameQueued.signal();
 			blitThread->join();
 			delete blitThread;
 		}
 
+		for(CopyTask &task : copyTasks)
+		{
+			if(task.thread)
+			{
+				task.start.signal();
+				task.thread->join();
+				delete task.thread;
+			}
+		}
+
+		for(int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		{
+			delete swapChain[i];
+		}
+
 		delete blitRoutine;
 	}
 
+	void FrameBuffer::present(sw::Surface *source, const Rect *damage, int damageCount)
+	{
+		// Frames rendered into the native buffer itself can't be queued while the next one is rendered into it
+		if(!maxFramesInFlight || !source || isDirect(source))
+		{
+			setDamage(damage, damageCount, this->damage);
+			flip(source);
+			this->damage.clear();
+			presentedFrames++;
+			return;
+		}
+
+		swapChainMutex.lock();
+
+		bool replace = false;
+
+		while(framesInFlight == maxFramesInFlight)
+		{
+			// The newest frame is only read by the blit thread once the ones before it were flipped
+			if(dropFrames && framesInFlight > 1)
+			{
+				framesInFlight--;
+				droppedFrames++;
+				replace = true;
+				break;
+			}
+
+			swapChainMutex.unlock();
+			framePresented.wait();
+			swapChainMutex.lock();
+		}
+
+		int index = (presentIndex + framesInFlight) % maxFramesInFlight;
+
+		swapChainMutex.unlock();
+
+		// The blit thread only reads the frames in flight, so the next one is ours to fill
+		Surface *&frame = swapChain[index];
+		int frameWidth = source->getWidth();
+		int frameHeight = source->getHeight();
+		Format frameFormat = source->getInternalFormat();
+
+		if(frame && (frame->getWidth() != frameWidth || frame->getHeight() != frameHeight || frame->getInternalFormat() != frameFormat))
+		{
+			delete frame;
+			frame = nullptr;
+		}
+
+		if(!frame)
+		{
+			frame = Surface::create(nullptr, frameWidth, frameHeight, 1, 0, 1, frameFormat, false, false);
+		}
+
+		if(frame->getInternalFormat() != frameFormat)   // Not a format for intermediate surfaces
+		{
+			finishPresents();
+			setDamage(damage, damageCount, this->damage);
+			flip(source);
+			this->damage.clear();
+			presentedFrames++;
+			return;
+		}
+
+		if(replace && !swapChainDamage[index].empty() && damageCount > 0)
+		{
+			// The changes of the replaced frame weren't presented either
+			std::vector<Rect> regions;
+			setDamage(damage, damageCount, regions);
+			swapChainDamage[index].insert(swapChainDamage[index].end(), regions.begin(), regions.end());
+		}
+		else if(replace)
+		{
+			swapChainDamage[index].clear();   // The whole frame
+		}
+		else
+		{
+			setDamage(damage, damageCount, swapChainDamage[index]);
+		}
+
+		const byte *s = static_cast<const byte*>(source->lockInternal(0, 0, 0, LOCK_READONLY, PUBLIC));
+		byte *d = static_cast<byte*>(frame->lockInternal(0, 0, 0, LOCK_DISCARD, PUBLIC));
+		int sourcePitch = source->getInternalPitchB();
+		int framePitch = frame->getInternalPitchB();
+		int rowBytes = frameWidth * Surface::bytes(frameFormat);
+
+		for(int y = 0; y < frameHeight; y++)
+		{
+			memcpy(d + y * framePitch, s + y * sourcePitch, rowBytes);
+		}
+
+		frame->unlockInternal();
+		source->unlockInternal();
+
+		swapChainMutex.lock();
+		framesInFlight++;
+		swapChainMutex.unlock();
+
+		frameQueued.signal();
+	}
+
+	void FrameBuffer::finishPresents()
+	{
+		swapChainMutex.lock();
+
+		while(framesInFlight > 0)
+		{
+			swapChainMutex.unlock();
+			framePresented.wait();
+			swapChainMutex.lock();
+		}
+
+		swapChainMutex.unlock();
+	}
+
+	void FrameBuffer::setSwapInterval(int interval)
+	{
+		if(dropFrames == (interval == 0))
+		{
+			return;
+		}
+
+		finishPresents();   // The swap chain gets indexed by its new length
+
+		swapChainMutex.lock();
+		dropFrames = (interval == 0);
+		maxFramesInFlight = dropFrames ? max(configuredFramesInFlight, 2) : configuredFramesInFlight;
+		presentIndex = 0;
+		swapChainMutex.unlock();
+
+		if(maxFramesInFlight > 0 && !blitThread)
+		{
+			blitThread = new Thread(threadFunction, this);
+		}
+	}
+
 	void FrameBuffer::setCursorImage(sw::Surface *cursorImage)
 	{
 		if(cursorImage)
@@ -110,6 +291,9 @@ namespace sw
 			return;
 		}
 
+		TraceEvent event("FrameBuffer::copy", "present");
+		int64_t startTick = profiler.isUtilizationProfiling() ? Timer::ticks() : 0;
+
 		if(!lock())
 		{
 			return;
@@ -129,6 +313,8 @@ namespace sw
 
 		renderbuffer = source->lockInternal(0, 0, 0, sw::LOCK_READONLY, sw::PUBLIC);
 
+		bool direct = (renderbuffer == getDirectBuffer(updateState.sourceFormat));   // Already in place
+
 		if(!topLeftOrigin)
 		{
 			renderbuffer = (byte*)renderbuffer + (height - 1) * sourceStride;
@@ -137,57 +323,191 @@ namespace sw
 		cursor.x = cursor.positionX - cursor.hotspotX;
 		cursor.y = cursor.positionY - cursor.hotspotY;
 
-		if(ASYNCHRONOUS_BLIT)
-		{
-			blitEvent.signal();
-			syncEvent.wait();
-		}
-		else
+		if(!direct)
 		{
+			waitForBuffer();
 			copyLocked();
 		}
 
+		blitBuffer = direct ? nullptr : framebuffer;   // Copies of other sources start from a full frame
+
 		source->unlockInternal();
 		unlock();
 
+		if(startTick)
+		{
+			profiler.addPresentTime(Timer::ticks() - startTick);
+		}
+
 		profiler.nextFrame();   // Assumes every copy() is a full frame
 	}
 
 	void FrameBuffer::copyLocked()
 	{
-		if(memcmp(&blitState, &updateState, sizeof(BlitState)) != 0)
+		bool changed = memcmp(&blitState, &updateState, sizeof(BlitState)) != 0;
+		RoutineTelemetry::recordCacheQuery("FrameBuffer", !changed);
+
+		if(changed)
 		{
 			blitState = updateState;
 			delete blitRoutine;
 
 			blitRoutine = copyRoutine(blitState);
-			blitFunction = (void(*)(void*, void*, Cursor*))blitRoutine->getEntry();
+			blitFunction = (void(*)(void*, void*, Cursor*, const Rect*))blitRoutine->getEntry();
+		}
+
+		// The rest of the frame is still there from the previous copy, except for where the cursor was
+		if(changed || !persistent || framebuffer != blitBuffer || blitState.cursorWidth > 0)
+		{
+			damage.clear();
+		}
+
+		std::vector<Rect> frame;
+
+		if(damage.empty())
+		{
+			frame.push_back(Rect(0, 0, width, height));
+		}
+
+		const std::vector<Rect> &regions = damage.empty() ? frame : damage;
+
+		int pixels = 0;
+
+		for(const Rect &region : regions)
+		{
+			pixels += region.width() * region.height();
+		}
+
+		// Large copies are split into bands of rows of each region
+		int threadCount = max(min(copyThreadCount, pixels / MIN_COPY_PIXELS), 1);
+
+		if(threadCount == 1)
+		{
+			copyRegions(regions);
+			return;
+		}
+
+		for(int i = 0; i < threadCount; i++)
+		{
+			copyTasks[i].regions.clear();
+
+			for(const Rect &region : regions)
+			{
+				Rect band(region.x0, region.y0 + region.height() * i / threadCount, region.x1, region.y0 + region.height() * (i + 1) / threadCount);
+
+				if(band.height() > 0)
+				{
+					copyTasks[i].regions.push_back(band);
+				}
+			}
+		}
+
+		for(int i = 1; i < threadCount; i++)
+		{
+			if(!copyTasks[i].thread)
+			{
+				copyTasks[i].thread = new Thread(copyTask, &copyTasks[i]);
+			}
+
+			copyTasks[i].start.signal();
 		}
 
-		blitFunction(framebuffer, renderbuffer, &cursor);
+		copyRegions(copyTasks[0].regions);
+
+		for(int i = 1; i < threadCount; i++)
+		{
+			copyTasks[i].done.wait();
+		}
+	}
+
+	void FrameBuffer::copyRegions(const std::vector<Rect> &regions)
+	{
+		for(const Rect &region : regions)
+		{
+			blitFunction(framebuffer, renderbuffer, &cursor, &region);
+		}
+	}
+
+	void FrameBuffer::copyTask(void *parameters)
+	{
+		CopyTask *task = static_cast<CopyTask*>(parameters);
+
+		while(true)
+		{
+			task->start.wait();
+
+			if(task->frameBuffer->terminate)
+			{
+				return;
+			}
+
+			task->frameBuffer->copyRegions(task->regions);
+			task->done.signal();
+		}
+	}
+
+	bool FrameBuffer::isDirect(Surface *source)
+	{
+		void *directBuffer = getDirectBuffer(source->getInternalFormat());
+
+		if(!directBuffer)
+		{
+			return false;
+		}
+
+		bool direct = (source->lockInternal(0, 0, 0, LOCK_READONLY, PUBLIC) == directBuffer);
+		source->unlockInternal();
+
+		return direct;
+	}
+
+	void FrameBuffer::setDamage(const Rect *rects, int count, std::vector<Rect> &regions) const
+	{
+		regions.clear();
+
+		for(int i = 0; i < count; i++)
+		{
+			// Source rows are flipped vertically unless the origin is top-left
+			Rect region = rects[i];
+
+			if(!topLeftOrigin)
+			{
+				region = Rect(region.x0, height - region.y1, region.x1, height - region.y0);
+			}
+
+			region.clip(0, 0, width, height);
+			region.x0 &= ~3;   // Keeps the vectorized conversion aligned
+
+			if(region.width() > 0 && region.height() > 0)
+			{
+				regions.push_back(region);
+			}
+		}
 	}
 
 	Routine *FrameBuffer::copyRoutine(const BlitState &state)
 	{
-		const int width = state.width;
-		const int height = state.height;
 		const int dBytes = Surface::bytes(state.destFormat);
 		const int dStride = state.destStride;
 		const int sBytes = Surface::bytes(state.sourceFormat);
 		const int sStride = state.sourceStride;
 
-		Function<Void(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>)> function;
+		Function<Void(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Pointer<Byte>)> function;
 		{
 			Pointer<Byte> dst(function.Arg<0>());
 			Pointer<Byte> src(function.Arg<1>());
 			Pointer<Byte> cursor(function.Arg<2>());
+			Pointer<Byte> region(function.Arg<3>());
 
-			For(Int y = 0, y < height, y++)
-			{
-				Pointer<Byte> d = dst + y * dStride;
-				Pointer<Byte> s = src + y * sStride;
+			Int x0 = *Pointer<Int>(region + OFFSET(Rect,x0));
+			Int x1 = *Pointer<Int>(region + OFFSET(Rect,x1));
+			Int y0 = *Pointer<Int>(region + OFFSET(Rect,y0));
+			Int y1 = *Pointer<Int>(region + OFFSET(Rect,y1));
 
-				Int x0 = 0;
+			For(Int y = y0, y < y1, y++)
+			{
+				Pointer<Byte> d = dst + y * dStride + x0 * dBytes;
+				Pointer<Byte> s = src + y * sStride + x0 * sBytes;
 
 				switch(state.destFormat)
 				{
@@ -200,7 +520,7 @@ namespace sw
 						{
 						case FORMAT_X8R8G8B8:
 						case FORMAT_A8R8G8B8:
-							For(, x < width - 3, x += 4)
+							For(, x < x1 - 3, x += 4)
 							{
 								*Pointer<Int4>(d, 1) = *Pointer<Int4>(s, sStride % 16 ? 1 : 16);
 
@@ -210,7 +530,7 @@ namespace sw
 							break;
 						case FORMAT_X8B8G8R8:
 						case FORMAT_A8B8G8R8:
-							For(, x < width - 3, x += 4)
+							For(, x < x1 - 3, x += 4)
 							{
 								Int4 bgra = *Pointer<Int4>(s, sStride % 16 ? 1 : 16);
 
@@ -223,7 +543,7 @@ namespace sw
 							}
 							break;
 						case FORMAT_A16B16G16R16:
-							For(, x < width - 1, x += 2)
+							For(, x < x1 - 1, x += 2)
 							{
 								Short4 c0 = As<UShort4>(Swizzle(*Pointer<Short4>(s + 0), 0xC6)) >> 8;
 								Short4 c1 = As<UShort4>(Swizzle(*Pointer<Short4>(s + 8), 0xC6)) >> 8;
@@ -235,7 +555,7 @@ namespace sw
 							}
 							break;
 						case FORMAT_R5G6B5:
-							For(, x < width - 3, x += 4)
+							For(, x < x1 - 3, x += 4)
 							{
 								Int4 rgb = Int4(*Pointer<Short4>(s));
 
@@ -252,7 +572,7 @@ namespace sw
 							break;
 						}
 
-						For(, x < width, x++)
+						For(, x < x1, x++)
 						{
 							switch(state.sourceFormat)
 							{
@@ -308,7 +628,7 @@ namespace sw
 						{
 						case FORMAT_X8B8G8R8:
 						case FORMAT_A8B8G8R8:
-							For(, x < width - 3, x += 4)
+							For(, x < x1 - 3, x += 4)
 							{
 								*Pointer<Int4>(d, 1) = *Pointer<Int4>(s, sStride % 16 ? 1 : 16);
 
@@ -318,7 +638,7 @@ namespace sw
 							break;
 						case FORMAT_X8R8G8B8:
 						case FORMAT_A8R8G8B8:
-							For(, x < width - 3, x += 4)
+							For(, x < x1 - 3, x += 4)
 							{
 								Int4 bgra = *Pointer<Int4>(s, sStride % 16 ? 1 : 16);
 
@@ -331,7 +651,7 @@ namespace sw
 							}
 							break;
 						case FORMAT_A16B16G16R16:
-							For(, x < width - 1, x += 2)
+							For(, x < x1 - 1, x += 2)
 							{
 								Short4 c0 = *Pointer<UShort4>(s + 0) >> 8;
 								Short4 c1 = *Pointer<UShort4>(s + 8) >> 8;
@@ -343,7 +663,7 @@ namespace sw
 							}
 							break;
 						case FORMAT_R5G6B5:
-							For(, x < width - 3, x += 4)
+							For(, x < x1 - 3, x += 4)
 							{
 								Int4 rgb = Int4(*Pointer<Short4>(s));
 
@@ -361,7 +681,7 @@ namespace sw
 							break;
 						}
 
-						For(, x < width, x++)
+						For(, x < x1, x++)
 						{
 							switch(state.sourceFormat)
 							{
@@ -407,7 +727,7 @@ namespace sw
 					break;
 				case FORMAT_R8G8B8:
 					{
-						For(Int x = x0, x < width, x++)
+						For(Int x = x0, x < x1, x++)
 						{
 							switch(state.sourceFormat)
 							{
@@ -449,7 +769,7 @@ namespace sw
 					break;
 				case FORMAT_R5G6B5:
 					{
-						For(Int x = x0, x < width, x++)
+						For(Int x = x0, x < x1, x++)
 						{
 							switch(state.sourceFormat)
 							{
@@ -504,24 +824,25 @@ namespace sw
 
 			if(state.cursorWidth > 0 && state.cursorHeight > 0)
 			{
-				Int x0 = *Pointer<Int>(cursor + OFFSET(Cursor,x));
-				Int y0 = *Pointer<Int>(cursor + OFFSET(Cursor,y));
+				Int cursorX = *Pointer<Int>(cursor + OFFSET(Cursor,x));
+				Int cursorY = *Pointer<Int>(cursor + OFFSET(Cursor,y));
 
-				For(Int y1 = 0, y1 < state.cursorHeight, y1++)
+				// Only the part of the cursor within the region
+				For(Int cy = 0, cy < state.cursorHeight, cy++)
 				{
-					Int y = y0 + y1;
+					Int y = cursorY + cy;
 
-					If(y >= 0 && y < height)
+					If(y >= y0 && y < y1)
 					{
-						Pointer<Byte> d = dst + y * dStride + x0 * dBytes;
-						Pointer<Byte> s = src + y * sStride + x0 * sBytes;
-						Pointer<Byte> c = *Pointer<Pointer<Byte>>(cursor + OFFSET(Cursor,image)) + y1 * state.cursorWidth * 4;
+						Pointer<Byte> d = dst + y * dStride + cursorX * dBytes;
+						Pointer<Byte> s = src + y * sStride + cursorX * sBytes;
+						Pointer<Byte> c = *Pointer<Pointer<Byte>>(cursor + OFFSET(Cursor,image)) + cy * state.cursorWidth * 4;
 
-						For(Int x1 = 0, x1 < state.cursorWidth, x1++)
+						For(Int cx = 0, cx < state.cursorWidth, cx++)
 						{
-							Int x = x0 + x1;
+							Int x = cursorX + cx;
 
-							If(x >= 0 && x < width)
+							If(x >= x0 && x < x1)
 							{
 								blend(state, d, s, c);
 							}
@@ -625,18 +946,45 @@ namespace sw
 
 	void FrameBuffer::threadFunction(void *parameters)
 	{
-		FrameBuffer *frameBuffer = *static_cast<FrameBuffer**>(parameters);
+		// The parameters are the frame buffer itself, since the thread starts running after the constructor returns
+		static_cast<FrameBuffer*>(parameters)->presentLoop();
+	}
 
-		while(!frameBuffer->terminate)
+	void FrameBuffer::presentLoop()
+	{
+		while(true)
 		{
-			frameBuffer->blitEvent.wait();
+			swapChainMutex.lock();
 
-			if(!frameBuffer->terminate)
+			if(framesInFlight == 0)
 			{
-				frameBuffer->copyLocked();
+				bool exit = terminate;
+				swapChainMutex.unlock();
+
+				if(exit)
+				{
+					return;
+				}
 
-				frameBuffer->syncEvent.signal();
+				frameQueued.wait();
+				continue;
 			}
+
+			Surface *frame = swapChain[presentIndex];
+			damage.swap(swapChainDamage[presentIndex]);
+
+			swapChainMutex.unlock();
+
+			flip(frame);
+			damage.clear();
+			presentedFrames++;
+
+			swapChainMutex.lock();
+			presentIndex = (presentIndex + 1) % maxFramesInFlight;
+			framesInFlight--;
+			swapChainMutex.unlock();
+
+			framePresented.signal();
 		}
 	}
 }
@@ -18,6 +18,10 @@
 #include "Reactor/Reactor.hpp"
 #include "Renderer/Surface.hpp"
 #include "Common/Thread.hpp"
+#include "Common/MutexLock.hpp"
+
+#include <atomic>
+#include <vector>
 
 namespace sw
 {
@@ -45,6 +49,22 @@ namespace sw
 		virtual void flip(sw::Surface *source) = 0;
 		virtual void blit(sw::Surface *source, const Rect *sourceRect, const Rect *destRect) = 0;
 
+		// Flips to the source, or with frames in flight, copies it into the swap chain and returns
+		// while the blit thread flips to the copy. Must be finished before deleting the frame buffer.
+		// The damaged rectangles are in source coordinates, and without any the whole frame changed.
+		virtual void present(sw::Surface *source, const Rect *damage, int damageCount);
+		virtual void finishPresents();
+
+		// With an interval of 0, present() never waits for the blit thread. A frame which is still
+		// queued when the swap chain is full gets replaced by the new one and counted as dropped.
+		virtual void setSwapInterval(int interval);
+		int getPresentedFrames() const { return presentedFrames; }
+		int getDroppedFrames() const { return droppedFrames; }
+
+		// Native window memory with the layout of an even sized render target of the given format, so
+		// the source can be rendered into it directly and presented without copying. Null if it differs.
+		virtual void *getDirectBuffer(Format format) { return nullptr; }
+
 		virtual void *lock() = 0;
 		virtual void unlock() = 0;
 
@@ -57,7 +77,17 @@ namespace sw
 	protected:
 		void copy(sw::Surface *source);
 
+		// Called by copy() right before it writes to the locked buffer, so that buffers which the
+		// compositor may still be reading are waited for after the source finished rendering
+		virtual void waitForBuffer() {}
+
 		bool windowed;
+		bool persistent;   // The native window buffer keeps its contents between frames
+
+		// Regions of the frame buffer changed by the frame being flipped, or empty for all of it.
+		// Only the changed regions of persistent buffers get converted, after which copy() leaves
+		// the ones for the platform to update, which is none when it had to convert the whole frame.
+		std::vector<Rect> damage;
 
 		void *framebuffer;   // Native window buffer.
 		int width;
@@ -65,10 +95,34 @@ namespace sw
 		int stride;
 		Format format;
 
+		static bool topLeftOrigin;   // Of the source surfaces, rows are stored bottom-up otherwise
+
 	private:
+		enum
+		{
+			MAX_FRAMES_IN_FLIGHT = 3,
+			MAX_COPY_THREADS = 4,
+			MIN_COPY_PIXELS = 0x40000   // Per thread
+		};
+
+		// Bands of the regions being copied, converted by a worker thread or the copying one
+		struct CopyTask
+		{
+			FrameBuffer *frameBuffer;
+			std::vector<Rect> regions;
+			Thread *thread;
+			Event start;
+			Event done;
+		};
+
 		void copyLocked();
+		void copyRegions(const std::vector<Rect> &regions);
+		static void copyTask(void *parameters);
+		bool isDirect(Surface *source);
+		void setDamage(const Rect *rects, int count, std::vector<Rect> &regions) const;
 
 		static void threadFunction(void *parameters);
+		void presentLoop();
 
 		void *renderbuffer;   // Render target buffer.
 
@@ -87,19 +141,34 @@ namespace sw
 
 		static Cursor cursor;
 
-		void (*blitFunction)(void *dst, void *src, Cursor *cursor);
+		void (*blitFunction)(void *dst, void *src, Cursor *cursor, const Rect *region);
 		Routine *blitRoutine;
 		BlitState blitState;     // State of the current blitRoutine.
+		void *blitBuffer;        // Native window buffer it last copied to.
 		BlitState updateState;   // State of the routine to be generated.
 
+		int copyThreadCount;   // Including the copying thread, from SwiftShader.ini or the processor count
+		CopyTask copyTasks[MAX_COPY_THREADS];
+
 		static void blend(const BlitState &state, const Pointer<Byte> &d, const Pointer<Byte> &s, const Pointer<Byte> &c);
 
+		// Frames queued by present(), from the oldest at swapChain[presentIndex] on
+		int maxFramesInFlight;          // Zero for synchronous presentation
+		int configuredFramesInFlight;   // From SwiftShader.ini, at least two are used for dropping frames
+		bool dropFrames;
+		Surface *swapChain[MAX_FRAMES_IN_FLIGHT];
+		std::vector<Rect> swapChainDamage[MAX_FRAMES_IN_FLIGHT];
+		int presentIndex;
+		int framesInFlight;
+
 		Thread *blitThread;
-		Event syncEvent;
-		Event blitEvent;
-		volatile bool terminate;
+		MutexLock swapChainMutex;
+		Event frameQueued;
+		Event framePresented;
+		bool terminate;
 
-		static bool topLeftOrigin;
+		std::atomic<int> presentedFrames;
+		std::atomic<int> droppedFrames;
 	};
 }
 
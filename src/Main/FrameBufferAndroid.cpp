@@ -18,12 +18,18 @@
 
 #include <system/window.h>
 #include <cutils/log.h>
+#include <unistd.h>
 
 namespace sw
 {
-	inline int dequeueBuffer(ANativeWindow* window, ANativeWindowBuffer** buffer)
+	// The fence signals when the compositor is done with the buffer. Without libsync to wait on it, it's waited for here.
+	inline int dequeueBuffer(ANativeWindow* window, ANativeWindowBuffer** buffer, int *fenceFd)
 	{
-		#if ANDROID_PLATFORM_SDK_VERSION > 16
+		*fenceFd = -1;
+
+		#if defined(HAVE_GRALLOC1)
+			return window->dequeueBuffer(window, buffer, fenceFd);
+		#elif ANDROID_PLATFORM_SDK_VERSION > 16
 			return native_window_dequeue_buffer_and_wait(window, buffer);
 		#else
 			return window->dequeueBuffer(window, buffer);
@@ -50,7 +56,7 @@ namespace sw
 
 	FrameBufferAndroid::FrameBufferAndroid(ANativeWindow* window, int width, int height)
 		: FrameBuffer(width, height, false, false),
-		  nativeWindow(window), buffer(nullptr)
+		  nativeWindow(window), buffer(nullptr), acquireFence(-1), releaseFence(-1)
 	{
 		nativeWindow->common.incRef(&nativeWindow->common);
 		native_window_set_usage(nativeWindow, GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN);
@@ -58,6 +64,11 @@ namespace sw
 
 	FrameBufferAndroid::~FrameBufferAndroid()
 	{
+		if(acquireFence >= 0)
+		{
+			close(acquireFence);
+		}
+
 		nativeWindow->common.decRef(&nativeWindow->common);
 	}
 
@@ -73,19 +84,29 @@ namespace sw
 				unlock();
 			}
 
-			queueBuffer(nativeWindow, buffer, -1);
+			waitForBuffer();   // Still pending when locking failed
+
+			// The compositor waits for the writes to complete instead of us
+			queueBuffer(nativeWindow, buffer, releaseFence);
+			releaseFence = -1;
 		}
 	}
 
 	void *FrameBufferAndroid::lock()
 	{
-		if(dequeueBuffer(nativeWindow, &buffer) != 0)
+		if(acquireFence >= 0)   // Of a buffer which failed to lock
+		{
+			close(acquireFence);
+			acquireFence = -1;
+		}
+
+		if(dequeueBuffer(nativeWindow, &buffer, &acquireFence) != 0)
 		{
 			return nullptr;
 		}
 
-		if(GrallocModule::getInstance()->lock(buffer->handle,
-		                 GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN,
+		// The frame is written in full, so it doesn't have to be read back, which on emulators copies it from the host
+		if(GrallocModule::getInstance()->lock(buffer->handle, GRALLOC_USAGE_SW_WRITE_OFTEN,
 		                 0, 0, buffer->width, buffer->height, &framebuffer) != 0)
 		{
 			ALOGE("%s failed to lock buffer %p", __FUNCTION__, buffer);
@@ -133,11 +154,23 @@ namespace sw
 
 		framebuffer = nullptr;
 
-		if(GrallocModule::getInstance()->unlock(buffer->handle) != 0)
+		if(GrallocModule::getInstance()->unlock(buffer->handle, &releaseFence) != 0)
 		{
 			ALOGE("%s: badness unlock failed", __FUNCTION__);
 		}
 	}
+
+	void FrameBufferAndroid::waitForBuffer()
+	{
+		#if defined(HAVE_GRALLOC1)
+			if(acquireFence >= 0)
+			{
+				sync_wait(acquireFence, -1);
+				close(acquireFence);
+				acquireFence = -1;
+			}
+		#endif
+	}
 }
 
 sw::FrameBuffer *createFrameBuffer(void *display, ANativeWindow* window, int width, int height)
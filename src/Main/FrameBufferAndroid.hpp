@@ -38,9 +38,14 @@ namespace sw
 
 		bool setSwapRectangle(int l, int t, int w, int h);
 
+	protected:
+		void waitForBuffer() override;
+
 	private:
 		ANativeWindow *nativeWindow;
 		ANativeWindowBuffer *buffer;
+		int acquireFence;   // Of the dequeued buffer, until it's waited for before writing
+		int releaseFence;   // Of the unlocked buffer, handed to the compositor when queueing it
 	};
 }
 
@@ -20,7 +20,7 @@ namespace sw
 {
 	extern bool forceWindowed;
 
-	FrameBufferGDI::FrameBufferGDI(HWND windowHandle, int width, int height, bool fullscreen, bool topLeftOrigin) : FrameBufferWin(windowHandle, width, height, fullscreen, topLeftOrigin)
+	FrameBufferGDI::FrameBufferGDI(HWND windowHandle, int width, int height, bool fullscreen, bool topLeftOrigin) : FrameBufferWin(windowHandle, width, height, fullscreen, topLeftOrigin), bottomUp(!topLeftOrigin)
 	{
 		if(!windowed)
 		{
@@ -38,6 +38,7 @@ namespace sw
 		init(this->windowHandle);
 
 		format = FORMAT_X8R8G8B8;
+		persistent = true;
 	}
 
 	FrameBufferGDI::~FrameBufferGDI()
@@ -63,6 +64,13 @@ namespace sw
 	void *FrameBufferGDI::lock()
 	{
 		stride = width * 4;
+		framebuffer = bits;
+
+		if(bottomUp)
+		{
+			framebuffer = (byte*)bits + (height - 1) * stride;
+			stride = -stride;
+		}
 
 		return framebuffer;
 	}
@@ -71,6 +79,13 @@ namespace sw
 	{
 	}
 
+	void *FrameBufferGDI::getDirectBuffer(Format format)
+	{
+		bool direct = bottomUp && format == FORMAT_A8R8G8B8 && width % 2 == 0 && height % 2 == 0;
+
+		return direct ? bits : nullptr;
+	}
+
 	void FrameBufferGDI::flip(sw::Surface *source)
 	{
 		blit(source, nullptr, nullptr);
@@ -80,8 +95,9 @@ namespace sw
 	{
 		copy(source);
 
+		int padding = bottomUp ? 1 : 0;   // The bitmap's top row is past the end of the frame
 		int sourceLeft = sourceRect ? sourceRect->x0 : 0;
-		int sourceTop = sourceRect ? sourceRect->y0 : 0;
+		int sourceTop = (sourceRect ? sourceRect->y0 : 0) + padding;
 		int sourceWidth = sourceRect ? sourceRect->x1 - sourceRect->x0 : width;
 		int sourceHeight = sourceRect ? sourceRect->y1 - sourceRect->y0 : height;
 		int destLeft = destRect ? destRect->x0 : 0;
@@ -89,7 +105,17 @@ namespace sw
 		int destWidth = destRect ? destRect->x1 - destRect->x0 : bounds.right - bounds.left;
 		int destHeight = destRect ? destRect->y1 - destRect->y0 : bounds.bottom - bounds.top;
 
-		StretchBlt(windowContext, destLeft, destTop, destWidth, destHeight, bitmapContext, sourceLeft, sourceTop, sourceWidth, sourceHeight, SRCCOPY);
+		if(!damage.empty() && !sourceRect && !destRect && destWidth == width && destHeight == height)
+		{
+			for(const Rect &region : damage)
+			{
+				BitBlt(windowContext, region.x0, region.y0, region.width(), region.height(), bitmapContext, region.x0, region.y0 + padding, SRCCOPY);
+			}
+		}
+		else
+		{
+			StretchBlt(windowContext, destLeft, destTop, destWidth, destHeight, bitmapContext, sourceLeft, sourceTop, sourceWidth, sourceHeight, SRCCOPY);
+		}
 	}
 
 	void FrameBufferGDI::flip(HWND windowOverride, sw::Surface *source)
@@ -142,11 +168,11 @@ namespace sw
 		bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFO);
 		bitmapInfo.bmiHeader.biBitCount = 32;
 		bitmapInfo.bmiHeader.biPlanes = 1;
-		bitmapInfo.bmiHeader.biHeight = -height;
+		bitmapInfo.bmiHeader.biHeight = bottomUp ? height + 1 : -height;
 		bitmapInfo.bmiHeader.biWidth = width;
 		bitmapInfo.bmiHeader.biCompression = BI_RGB;
 
-		bitmap = CreateDIBSection(bitmapContext, &bitmapInfo, DIB_RGB_COLORS, &framebuffer, 0, 0);
+		bitmap = CreateDIBSection(bitmapContext, &bitmapInfo, DIB_RGB_COLORS, &bits, 0, 0);
 		SelectObject(bitmapContext, bitmap);
 
 		updateBounds(window);
@@ -35,6 +35,8 @@ namespace sw
 		void *lock() override;
 		void unlock() override;
 
+		void *getDirectBuffer(Format format) override;
+
 		void setGammaRamp(GammaRamp *gammaRamp, bool calibrate) override;
 		void getGammaRamp(GammaRamp *gammaRamp) override;
 
@@ -50,6 +52,8 @@ namespace sw
 		HWND bitmapWindow;
 
 		HBITMAP bitmap;
+		void *bits;
+		bool bottomUp;   // Laid out like render targets, with an extra row for reads past the end
 	};
 }
 
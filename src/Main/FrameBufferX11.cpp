@@ -60,6 +60,7 @@ namespace sw
 		Visual *visual = match ? x_visual.visual : libX11->XDefaultVisual(x_display, screen);
 
 		mit_shm = (libX11->XShmQueryExtension && libX11->XShmQueryExtension(x_display) == True);
+		persistent = true;
 
 		if(mit_shm)
 		{
@@ -143,13 +144,22 @@ namespace sw
 	{
 		copy(source);
 
-		if(!mit_shm)
-		{
-			libX11->XPutImage(x_display, x_window, x_gc, x_image, 0, 0, 0, 0, width, height);
-		}
-		else
+		Rect frame(0, 0, width, height);
+		const Rect *regions = damage.empty() ? &frame : damage.data();
+		size_t count = damage.empty() ? 1 : damage.size();
+
+		for(size_t i = 0; i < count; i++)
 		{
-			libX11->XShmPutImage(x_display, x_window, x_gc, x_image, 0, 0, 0, 0, width, height, False);
+			const Rect &region = regions[i];
+
+			if(!mit_shm)
+			{
+				libX11->XPutImage(x_display, x_window, x_gc, x_image, region.x0, region.y0, region.x0, region.y0, region.width(), region.height());
+			}
+			else
+			{
+				libX11->XShmPutImage(x_display, x_window, x_gc, x_image, region.x0, region.y0, region.x0, region.y0, region.width(), region.height(), False);
+			}
 		}
 
 		libX11->XSync(x_display, False);
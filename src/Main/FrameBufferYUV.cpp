@@ -0,0 +1,288 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "FrameBufferYUV.hpp"
+
+#include "Renderer/Surface.hpp"
+#include "Reactor/Reactor.hpp"
+#include "Common/Memory.hpp"
+#include "Common/TraceEvents.hpp"
+#include "Common/Debug.hpp"
+
+#include <string.h>
+
+namespace sw
+{
+	FrameBufferYUV::FrameBufferYUV(void *frames, YUVLayout layout, int frameCount, int width, int height)
+		: FrameBuffer(width, height, false, false), frames(frames), layout(layout), frameCount(frameCount)
+	{
+		frameIndex = 0;
+		pending.resize(frameCount, {true, {}});
+
+		conversionFunction = nullptr;
+		conversion = nullptr;
+		conversionState = {};
+	}
+
+	FrameBufferYUV::~FrameBufferYUV()
+	{
+		delete conversion;
+
+		sw::unmapFile(frames, frameSize(width, height) * frameCount);
+	}
+
+	void FrameBufferYUV::flip(sw::Surface *source)
+	{
+		if(!source || !isSupported(source->getInternalFormat()))
+		{
+			return;
+		}
+
+		ASSERT(source->getWidth() == width && source->getHeight() == height);
+
+		TraceEvent event("FrameBufferYUV::flip", "present");
+
+		// The frame's changes, rounded out to macroblocks, are stale in every slot
+		std::vector<Rect> regions;
+
+		for(const Rect &region : damage)
+		{
+			Rect macroblocks(region.x0 & ~15, region.y0 & ~15, align<16>(region.x1), align<16>(region.y1));
+			macroblocks.clip(0, 0, width, height);
+			regions.push_back(macroblocks);
+		}
+
+		for(PendingUpdate &update : pending)
+		{
+			if(damage.empty() || update.regions.size() + regions.size() > MAX_PENDING_REGIONS)
+			{
+				update.whole = true;
+				update.regions.clear();
+			}
+			else if(!update.whole)
+			{
+				update.regions.insert(update.regions.end(), regions.begin(), regions.end());
+			}
+		}
+
+		PendingUpdate &update = pending[frameIndex];
+
+		if(update.whole)
+		{
+			update.regions.assign(1, Rect(0, 0, width, height));
+		}
+
+		int sourcePitch = source->getInternalPitchB();
+
+		ConversionState state = {};
+		state.width = width;
+		state.height = height;
+		state.sourceFormat = source->getInternalFormat();
+		state.sourceStride = topLeftOrigin ? sourcePitch : -sourcePitch;
+		state.layout = layout;
+
+		if(!conversion || memcmp(&state, &conversionState, sizeof(ConversionState)) != 0)
+		{
+			delete conversion;
+
+			conversionState = state;
+			conversion = conversionRoutine(conversionState);
+			conversionFunction = (void(*)(void*, const void*, const Rect*))conversion->getEntry();
+		}
+
+		const byte *s = static_cast<const byte*>(source->lockInternal(0, 0, 0, LOCK_READONLY, PUBLIC));
+		byte *d = static_cast<byte*>(frames) + frameSize(width, height) * frameIndex;
+
+		if(!topLeftOrigin)
+		{
+			s += (height - 1) * sourcePitch;
+		}
+
+		for(const Rect &region : update.regions)
+		{
+			conversionFunction(d, s, &region);
+		}
+
+		source->unlockInternal();
+
+		update.whole = false;
+		update.regions.clear();
+
+		frameIndex = (frameIndex + 1) % frameCount;
+	}
+
+	void FrameBufferYUV::blit(sw::Surface *source, const Rect *sourceRect, const Rect *destRect)
+	{
+		flip(source);
+	}
+
+	void *FrameBufferYUV::lock()
+	{
+		return static_cast<byte*>(frames) + frameSize(width, height) * frameIndex;
+	}
+
+	void FrameBufferYUV::unlock()
+	{
+	}
+
+	size_t FrameBufferYUV::frameSize(int width, int height)
+	{
+		return (size_t)width * height * 3 / 2;
+	}
+
+	Routine *FrameBufferYUV::conversionRoutine(const ConversionState &state)
+	{
+		const int width = state.width;
+		const int sStride = state.sourceStride;
+		const int lumaBytes = width * state.height;
+		const bool bgra = (state.sourceFormat == FORMAT_X8R8G8B8 || state.sourceFormat == FORMAT_A8R8G8B8);
+		const bool nv12 = (state.layout == YUV_NV12);
+
+		Function<Void(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>)> function;
+		{
+			Pointer<Byte> dst(function.Arg<0>());
+			Pointer<Byte> src(function.Arg<1>());
+			Pointer<Byte> region(function.Arg<2>());
+
+			Int x0 = *Pointer<Int>(region + OFFSET(Rect,x0));
+			Int x1 = *Pointer<Int>(region + OFFSET(Rect,x1));
+			Int y0 = *Pointer<Int>(region + OFFSET(Rect,y0));
+			Int y1 = *Pointer<Int>(region + OFFSET(Rect,y1));
+
+			auto unpack = [&](const Int4 &c, Int4 &r, Int4 &g, Int4 &b)
+			{
+				Int4 low = c & Int4(0xFF);
+				Int4 high = (c >> 16) & Int4(0xFF);
+
+				r = bgra ? high : low;
+				g = (c >> 8) & Int4(0xFF);
+				b = bgra ? low : high;
+			};
+
+			auto luma = [](const Int4 &r, const Int4 &g, const Int4 &b)
+			{
+				return ((r * Int4(66) + g * Int4(129) + b * Int4(25) + Int4(128)) >> 8) + Int4(16);
+			};
+
+			// From the sums of 2x2 pixels
+			auto chroma = [](const Int4 &r, const Int4 &g, const Int4 &b, Int4 &cb, Int4 &cr)
+			{
+				cb = ((r * Int4(-38) + g * Int4(-74) + b * Int4(112) + Int4(512)) >> 10) + Int4(128);
+				cr = ((r * Int4(112) + g * Int4(-94) + b * Int4(-18) + Int4(512)) >> 10) + Int4(128);
+			};
+
+			// Row pairs share the chroma samples
+			For(Int y = y0, y < y1, y += 2)
+			{
+				Pointer<Byte> s0 = src + y * sStride + x0 * 4;
+				Pointer<Byte> s1 = s0 + sStride;
+				Pointer<Byte> l0 = dst + y * width + x0;
+				Pointer<Byte> l1 = l0 + width;
+				Pointer<Byte> cb = nv12 ? dst + lumaBytes + (y / 2) * width + x0 :
+				                          dst + lumaBytes + (y / 2) * (width / 2) + x0 / 2;
+				Pointer<Byte> cr = cb + (nv12 ? 1 : lumaBytes / 4);
+
+				Int x = x0;
+
+				For(, x < x1 - 7, x += 8)
+				{
+					Int4 r00, g00, b00, r01, g01, b01, r10, g10, b10, r11, g11, b11;
+					unpack(*Pointer<Int4>(s0 + 0, sStride % 16 ? 1 : 16), r00, g00, b00);
+					unpack(*Pointer<Int4>(s0 + 16, sStride % 16 ? 1 : 16), r01, g01, b01);
+					unpack(*Pointer<Int4>(s1 + 0, sStride % 16 ? 1 : 16), r10, g10, b10);
+					unpack(*Pointer<Int4>(s1 + 16, sStride % 16 ? 1 : 16), r11, g11, b11);
+
+					*Pointer<Int2>(l0) = As<Int2>(PackUnsigned(Short4(luma(r00, g00, b00)), Short4(luma(r01, g01, b01))));
+					*Pointer<Int2>(l1) = As<Int2>(PackUnsigned(Short4(luma(r10, g10, b10)), Short4(luma(r11, g11, b11))));
+
+					// Vertical sums of the 8 columns, then added up in horizontal pairs
+					Int4 r0 = r00 + r10, g0 = g00 + g10, b0 = b00 + b10;
+					Int4 r1 = r01 + r11, g1 = g01 + g11, b1 = b01 + b11;
+
+					Int4 r = As<Int4>(ShuffleLowHigh(As<Float4>(r0), As<Float4>(r1), 0x88)) + As<Int4>(ShuffleLowHigh(As<Float4>(r0), As<Float4>(r1), 0xDD));
+					Int4 g = As<Int4>(ShuffleLowHigh(As<Float4>(g0), As<Float4>(g1), 0x88)) + As<Int4>(ShuffleLowHigh(As<Float4>(g0), As<Float4>(g1), 0xDD));
+					Int4 b = As<Int4>(ShuffleLowHigh(As<Float4>(b0), As<Float4>(b1), 0x88)) + As<Int4>(ShuffleLowHigh(As<Float4>(b0), As<Float4>(b1), 0xDD));
+
+					Int4 u, v;
+					chroma(r, g, b, u, v);
+
+					Short4 u4 = Short4(u);
+					Short4 v4 = Short4(v);
+
+					if(nv12)
+					{
+						Short4 uv0 = As<Short4>(UnpackLow(u4, v4));
+						Short4 uv1 = As<Short4>(UnpackHigh(u4, v4));
+
+						*Pointer<Int2>(cb) = As<Int2>(PackUnsigned(uv0, uv1));
+						cb += 8;
+						cr += 8;
+					}
+					else
+					{
+						*Pointer<Int>(cb) = Int(As<Int2>(PackUnsigned(u4, u4)));
+						*Pointer<Int>(cr) = Int(As<Int2>(PackUnsigned(v4, v4)));
+						cb += 4;
+						cr += 4;
+					}
+
+					s0 += 32;
+					s1 += 32;
+					l0 += 8;
+					l1 += 8;
+				}
+
+				// Widths which aren't a multiple of 8, a 2x2 block at a time
+				For(, x < x1, x += 2)
+				{
+					Int4 r, g, b;
+					unpack(Int4(*Pointer<Int2>(s0), *Pointer<Int2>(s1)), r, g, b);
+
+					Int pixels = Int(As<Int2>(PackUnsigned(Short4(luma(r, g, b)), Short4(0))));
+					*Pointer<Short>(l0) = Short(pixels);
+					*Pointer<Short>(l1) = Short(pixels >> 16);
+
+					Int4 u, v;
+					chroma(Int4(Extract(r, 0) + Extract(r, 1) + Extract(r, 2) + Extract(r, 3)),
+					       Int4(Extract(g, 0) + Extract(g, 1) + Extract(g, 2) + Extract(g, 3)),
+					       Int4(Extract(b, 0) + Extract(b, 1) + Extract(b, 2) + Extract(b, 3)), u, v);
+
+					*Pointer<Byte>(cb) = Byte(Extract(u, 0));
+					*Pointer<Byte>(cr) = Byte(Extract(v, 0));
+					cb += nv12 ? 2 : 1;
+					cr += nv12 ? 2 : 1;
+
+					s0 += 8;
+					s1 += 8;
+					l0 += 2;
+					l1 += 2;
+				}
+			}
+		}
+
+		return function(L"FrameBufferYUV");
+	}
+}
+
+sw::FrameBuffer *createFrameBufferYUV(int fileDescriptor, sw::YUVLayout layout, int frameCount, int width, int height)
+{
+	void *frames = sw::mapFile(fileDescriptor, sw::FrameBufferYUV::frameSize(width, height) * frameCount);
+
+	if(!frames)
+	{
+		return nullptr;
+	}
+
+	return new sw::FrameBufferYUV(frames, layout, frameCount, width, height);
+}
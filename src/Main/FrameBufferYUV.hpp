@@ -0,0 +1,94 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_FrameBufferYUV_hpp
+#define sw_FrameBufferYUV_hpp
+
+#include "Main/FrameBuffer.hpp"
+
+#include <vector>
+
+namespace sw
+{
+	enum YUVLayout : unsigned char
+	{
+		YUV_NV12,   // Luma plane followed by a plane of interleaved Cb and Cr samples
+		YUV_I420    // Luma plane followed by a Cb and a Cr plane
+	};
+
+	// Converts presented frames to 4:2:0 limited range BT.601 YUV for video encoders. The frames
+	// go round robin into a ring of tightly packed frames at the start of a file, and only the
+	// 16x16 macroblocks which changed since a frame slot was last written get converted.
+	class FrameBufferYUV : public FrameBuffer
+	{
+	public:
+		FrameBufferYUV(void *frames, YUVLayout layout, int frameCount, int width, int height);
+
+		~FrameBufferYUV() override;
+
+		void flip(sw::Surface *source) override;
+		void blit(sw::Surface *source, const Rect *sourceRect, const Rect *destRect) override;
+
+		void *lock() override;
+		void unlock() override;
+
+		static bool isSupported(Format sourceFormat)
+		{
+			return sourceFormat == FORMAT_X8R8G8B8 || sourceFormat == FORMAT_A8R8G8B8 ||
+			       sourceFormat == FORMAT_X8B8G8R8 || sourceFormat == FORMAT_A8B8G8R8;
+		}
+
+		static size_t frameSize(int width, int height);   // Width and height have to be even
+
+	private:
+		enum
+		{
+			MAX_PENDING_REGIONS = 64   // Per frame slot, before converting all of it
+		};
+
+		struct ConversionState
+		{
+			int width;
+			int height;
+			Format sourceFormat;
+			int sourceStride;
+			YUVLayout layout;
+		};
+
+		// Macroblocks changed since the frame slot was last written
+		struct PendingUpdate
+		{
+			bool whole;
+			std::vector<Rect> regions;
+		};
+
+		static Routine *conversionRoutine(const ConversionState &state);
+
+		void *const frames;   // Mapping of the file
+		const YUVLayout layout;
+		const int frameCount;
+		int frameIndex;       // Slot of the next frame
+
+		std::vector<PendingUpdate> pending;
+
+		void (*conversionFunction)(void *dst, const void *src, const Rect *region);
+		Routine *conversion;
+		ConversionState conversionState;
+	};
+}
+
+// Maps frameCount frames of the file, or returns null if it can't
+sw::FrameBuffer *createFrameBufferYUV(int fileDescriptor, sw::YUVLayout layout, int frameCount, int width, int height);
+
+#endif   // sw_FrameBufferYUV_hpp
@@ -17,7 +17,9 @@
 #include "Config.hpp"
 #include "Common/Configurator.hpp"
 #include "Common/Debug.hpp"
+#include "Common/Memory.hpp"
 #include "Common/Version.h"
+#include "Renderer/Surface.hpp"
 
 #include <sstream>
 #include <stdio.h>
@@ -25,11 +27,30 @@
 #include <sys/stat.h>
 #include <string.h>
 #include <algorithm>
+#include <atomic>
+#include <map>
 
 namespace sw
 {
 	extern Profiler profiler;
 
+	namespace
+	{
+		struct Overrides
+		{
+			MutexLock mutex;
+			std::map<std::pair<std::string, std::string>, std::string> values;   // By section and name
+			std::atomic<int> generation{0};   // Incremented by every change
+		};
+
+		Overrides &overrides()
+		{
+			static Overrides overrides;
+
+			return overrides;
+		}
+	}
+
 	std::string itoa(int number)
 	{
 		std::stringstream ss;
@@ -99,6 +120,15 @@ namespace sw
 
 	bool SwiftConfig::hasNewConfiguration(bool reset)
 	{
+		if(overrideGeneration != overrides().generation)
+		{
+			criticalSection.lock();
+			readConfiguration(config.disableServer);
+			criticalSection.unlock();
+
+			newConfig = true;
+		}
+
 		bool value = newConfig;
 
 		if(reset)
@@ -116,6 +146,26 @@ namespace sw
 		criticalSection.unlock();
 	}
 
+	void SwiftConfig::setOverride(const char *section, const char *name, int value)
+	{
+		Overrides &overrides = sw::overrides();
+
+		overrides.mutex.lock();
+		overrides.values[std::make_pair(std::string(section), std::string(name))] = itoa(value);
+		overrides.generation++;
+		overrides.mutex.unlock();
+	}
+
+	void SwiftConfig::clearOverrides()
+	{
+		Overrides &overrides = sw::overrides();
+
+		overrides.mutex.lock();
+		overrides.values.clear();
+		overrides.generation++;
+		overrides.mutex.unlock();
+	}
+
 	void SwiftConfig::serverRoutine(void *parameters)
 	{
 		SwiftConfig *swiftConfig = (SwiftConfig*)parameters;
@@ -287,7 +337,7 @@ namespace sw
 		html += "<option value='21'" + (config.vertexShaderVersion == 21 ? selected : empty) + ">2.x</option>\n";
 		html += "<option value='30'" + (config.vertexShaderVersion == 30 ? selected : empty) + ">3.0 (default)</option>\n";
 		html += "</select></td></tr>\n";
-		html += "<tr><td>Texture memory:</td><td><select name='textureMemory' title='The maximum amount of memory used for textures and other resources.'>\n";
+		html += "<tr><td>Texture memory:</td><td><select name='textureMemory' title='The maximum amount of memory used for textures and other resources. Decoded copies of textures beyond it are freed, least recently used first, and decoded again when sampled.'>\n";
 		html += "<option value='128'"  + (config.textureMemory == 128  ? selected : empty) + ">128 MB</option>\n";
 		html += "<option value='256'"  + (config.textureMemory == 256  ? selected : empty) + ">256 MB (default)</option>\n";
 		html += "<option value='512'"  + (config.textureMemory == 512  ? selected : empty) + ">512 MB</option>\n";
@@ -335,7 +385,13 @@ namespace sw
 		html += "</select></td>\n";
 		html += "</tr>\n";
 		html += "<tr><td>Vertex cache size:</td><td><select name='vertexCacheSize' title='The number of processed vertices being cached for reuse. Lower numbers save memory but require more vertices to be reprocessed.'>\n";
+		html += "<option value='16'"   + (config.vertexCacheSize == 16   ? selected : empty) + ">16</option>\n";
+		html += "<option value='32'"   + (config.vertexCacheSize == 32   ? selected : empty) + ">32</option>\n";
 		html += "<option value='64'"   + (config.vertexCacheSize == 64   ? selected : empty) + ">64 (default)</option>\n";
+		html += "<option value='128'"  + (config.vertexCacheSize == 128  ? selected : empty) + ">128</option>\n";
+		html += "<option value='256'"  + (config.vertexCacheSize == 256  ? selected : empty) + ">256</option>\n";
+		html += "<option value='512'"  + (config.vertexCacheSize == 512  ? selected : empty) + ">512</option>\n";
+		html += "<option value='1024'" + (config.vertexCacheSize == 1024 ? selected : empty) + ">1024</option>\n";
 		html += "</select></td>\n";
 		html += "</tr>\n";
 		html += "</table>\n";
@@ -344,6 +400,7 @@ namespace sw
 		html += "<tr><td>Maximum texture sampling quality:</td><td><select name='textureSampleQuality' title='The maximum texture filtering quality. Lower settings can be faster but cause visual artifacts.'>\n";
 		html += "<option value='0'" + (config.textureSampleQuality == 0 ? selected : empty) + ">Point</option>\n";
 		html += "<option value='1'" + (config.textureSampleQuality == 1 ? selected : empty) + ">Linear</option>\n";
+		html += "<option value='3'" + (config.textureSampleQuality == 3 ? selected : empty) + ">Anisotropic, approximate</option>\n";
 		html += "<option value='2'" + (config.textureSampleQuality == 2 ? selected : empty) + ">Anisotropic (default)</option>\n";
 		html += "</select></td>\n";
 		html += "</tr>\n";
@@ -357,6 +414,11 @@ namespace sw
 		html += "<option value='1'" + (config.perspectiveCorrection == 1 ? selected : empty) + ">On (default)</option>\n";
 		html += "</select></td>\n";
 		html += "</tr>\n";
+		html += "<tr><td>Texture layout:</td><td><select name='tiledTextures' title='Whether textures are sampled from a copy stored in 4x4 texel tiles. Neighboring texels share cache lines, at the cost of extra memory and a copy after each texture update.'>\n";
+		html += "<option value='0'" + (config.tiledTextures == 0 ? selected : empty) + ">Linear (default)</option>\n";
+		html += "<option value='1'" + (config.tiledTextures == 1 ? selected : empty) + ">Tiled</option>\n";
+		html += "</select></td>\n";
+		html += "</tr>\n";
 		html += "<tr><td>Transcendental function precision:</td><td><select name='transcendentalPrecision' title='The precision at which log/exp/pow/rcp/rsq/nrm shader instructions are computed. Lower settings can be faster but cause visual artifacts.'>\n";
 		html += "<option value='0'" + (config.transcendentalPrecision == 0 ? selected : empty) + ">Approximate</option>\n";
 		html += "<option value='1'" + (config.transcendentalPrecision == 1 ? selected : empty) + ">Partial</option>\n";
@@ -392,6 +454,34 @@ namespace sw
 		html += "<option value='15'" + (config.threadCount == 15 ? selected : empty) + ">15</option>\n";
 		html += "<option value='16'" + (config.threadCount == 16 ? selected : empty) + ">16</option>\n";
 		html += "</select></td></tr>\n";
+		html += "<tr><td>Thread affinity:</td><td><select name='threadAffinity' title='Whether rendering threads are pinned to processors. Pinned threads are grouped per NUMA node so neighboring threads share work and memory.'>\n";
+		html += "<option value='0'" + (config.threadAffinity == 0 ? selected : empty) + ">None (default)</option>\n";
+		html += "<option value='1'" + (config.threadAffinity == 1 ? selected : empty) + ">Pin to processors</option>\n";
+		html += "</select></td></tr>\n";
+		html += "<tr><td>Huge pages:</td><td><select name='hugePageThreshold' title='The size from which render targets, textures and buffers are backed by huge pages, where the operating system supports them. Reduces TLB misses when rendering to and sampling from large surfaces.'>\n";
+		html += "<option value='0'"  + (config.hugePageThreshold == 0  ? selected : empty) + ">Disabled (default)</option>\n";
+		html += "<option value='2'"  + (config.hugePageThreshold == 2  ? selected : empty) + ">2 MB</option>\n";
+		html += "<option value='8'"  + (config.hugePageThreshold == 8  ? selected : empty) + ">8 MB</option>\n";
+		html += "<option value='32'" + (config.hugePageThreshold == 32 ? selected : empty) + ">32 MB</option>\n";
+		html += "</select></td></tr>\n";
+		html += "<tr><td>Routine compilation:</td><td><select name='concurrentCompilation' title='Whether the vertex, setup and pixel routines needed by a draw call are generated on separate threads. Reduces the stall on the first use of a new state.'>\n";
+		html += "<option value='0'" + (config.concurrentCompilation == 0 ? selected : empty) + ">Sequential (default)</option>\n";
+		html += "<option value='1'" + (config.concurrentCompilation == 1 ? selected : empty) + ">Concurrent</option>\n";
+		html += "</select></td></tr>\n";
+		html += "<tr><td>Raster tile height:</td><td><select name='rasterTileHeight' title='The number of consecutive rows rasterized by each thread. Taller tiles keep render target data in the cache of a single core.'>\n";
+		html += "<option value='2'"  + (config.rasterTileHeight == 2  ? selected : empty) + ">2 (default)</option>\n";
+		html += "<option value='8'"  + (config.rasterTileHeight == 8  ? selected : empty) + ">8</option>\n";
+		html += "<option value='16'" + (config.rasterTileHeight == 16 ? selected : empty) + ">16</option>\n";
+		html += "<option value='32'" + (config.rasterTileHeight == 32 ? selected : empty) + ">32</option>\n";
+		html += "<option value='64'" + (config.rasterTileHeight == 64 ? selected : empty) + ">64</option>\n";
+		html += "</select></td></tr>\n";
+		html += "<tr><td>Draw call queue size:</td><td><select name='drawQueueSize' title='The initial number of draw calls which can be queued before the application has to wait. The queue grows when the application stalls.'>\n";
+		html += "<option value='16'"  + (config.drawQueueSize == 16  ? selected : empty) + ">16 (default)</option>\n";
+		html += "<option value='32'"  + (config.drawQueueSize == 32  ? selected : empty) + ">32</option>\n";
+		html += "<option value='64'"  + (config.drawQueueSize == 64  ? selected : empty) + ">64</option>\n";
+		html += "<option value='128'" + (config.drawQueueSize == 128 ? selected : empty) + ">128</option>\n";
+		html += "<option value='256'" + (config.drawQueueSize == 256 ? selected : empty) + ">256</option>\n";
+		html += "</select></td></tr>\n";
 		html += "<tr><td>Enable SSE:</td><td><input name = 'enableSSE' type='checkbox'" + (config.enableSSE ? checked : empty) + " disabled='disabled' title='If checked enables the use of SSE instruction set extentions if supported by the CPU.'></td></tr>";
 		html += "<tr><td>Enable SSE2:</td><td><input name = 'enableSSE2' type='checkbox'" + (config.enableSSE2 ? checked : empty) + " title='If checked enables the use of SSE2 instruction set extentions if supported by the CPU.'></td></tr>";
 		html += "<tr><td>Enable SSE3:</td><td><input name = 'enableSSE3' type='checkbox'" + (config.enableSSE3 ? checked : empty) + " title='If checked enables the use of SSE3 instruction set extentions if supported by the CPU.'></td></tr>";
@@ -417,6 +507,31 @@ namespace sw
 			html += "</select></td></tr>\n";
 		}
 
+		html += "<tr><td>Tiered compilation:</td><td><select name='tieredCompilation' title='Whether routines are first generated with minimal optimizations and regenerated with additional passes once they are used by a number of draw calls. Reduces the stall on the first use of a new state.'>\n";
+		html += "<option value='0'"   + (config.tieredCompilation == 0   ? selected : empty) + ">Disabled (default)</option>\n";
+		html += "<option value='16'"  + (config.tieredCompilation == 16  ? selected : empty) + ">After 16 draws</option>\n";
+		html += "<option value='64'"  + (config.tieredCompilation == 64  ? selected : empty) + ">After 64 draws</option>\n";
+		html += "<option value='256'" + (config.tieredCompilation == 256 ? selected : empty) + ">After 256 draws</option>\n";
+		html += "</select></td></tr>\n";
+		html += "<tr><td>Uniform specialization:</td><td><select name='uniformSpecialization' title='Whether routines are generated for the current values of uniforms which control branches, once they kept their value for a number of draw calls. Removes the branches at the cost of more routines.'>\n";
+		html += "<option value='0'"   + (config.uniformSpecialization == 0   ? selected : empty) + ">Disabled (default)</option>\n";
+		html += "<option value='16'"  + (config.uniformSpecialization == 16  ? selected : empty) + ">After 16 draws</option>\n";
+		html += "<option value='64'"  + (config.uniformSpecialization == 64  ? selected : empty) + ">After 64 draws</option>\n";
+		html += "<option value='256'" + (config.uniformSpecialization == 256 ? selected : empty) + ">After 256 draws</option>\n";
+		html += "</select></td></tr>\n";
+		html += "<tr><td>Draw call culling:</td><td><select name='drawCulling' title='Whether the positions of the vertex range of indexed draw calls are computed first, to skip the draw when it lies entirely outside of the view frustum. Speeds up applications which issue many off-screen draws, at the cost of extra vertex processing for the visible ones.'>\n";
+		html += "<option value='0'" + (config.drawCulling == 0 ? selected : empty) + ">Disabled (default)</option>\n";
+		html += "<option value='1'" + (config.drawCulling == 1 ? selected : empty) + ">Enabled</option>\n";
+		html += "</select></td></tr>\n";
+		html += "<tr><td>Draw call merging:</td><td><select name='drawMerging' title='Whether draw calls which only continue where the previous one left off in the same vertex or index buffer, with the same state and bindings, get appended to it while it still has primitives left to process. Saves the per-draw overhead of long runs of small draws.'>\n";
+		html += "<option value='0'" + (config.drawMerging == 0 ? selected : empty) + ">Disabled</option>\n";
+		html += "<option value='1'" + (config.drawMerging == 1 ? selected : empty) + ">Enabled (default)</option>\n";
+		html += "</select></td></tr>\n";
+		html += "<tr><td>Routine warm-up:</td><td><select name='routineWarmUp' title='Whether the routines which read back and copy color buffers are compiled on a background thread when the EGL display gets initialized, so the first ones used by the process are ready. Takes effect for processes started afterwards.'>\n";
+		html += "<option value='-1'" + (config.routineWarmUp == -1 ? selected : empty) + ">With multiple cores (default)</option>\n";
+		html += "<option value='0'"  + (config.routineWarmUp == 0  ? selected : empty) + ">Disabled</option>\n";
+		html += "<option value='1'"  + (config.routineWarmUp == 1  ? selected : empty) + ">Enabled</option>\n";
+		html += "</select></td></tr>\n";
 		html += "</table>\n";
 		html += "<h2><em>Testing & Experimental</em></h2>\n";
 		html += "<table>\n";
@@ -431,7 +546,7 @@ namespace sw
 		html += "<option value='0'" + (config.frameBufferAPI == 0 ? selected : empty) + ">DirectDraw (default)</option>\n";
 		html += "<option value='1'" + (config.frameBufferAPI == 1 ? selected : empty) + ">GDI</option>\n";
 		html += "</select></td>\n";
-		html += "<tr><td>DLL precaching:</td><td><input name = 'precache' type='checkbox'" + (config.precache == true ? checked : empty) + " title='If checked dynamically generated routines will be stored in a DLL for faster loading on application restart.'></td></tr>";
+		html += "<tr><td>Routine precaching:</td><td><input name = 'precache' type='checkbox'" + (config.precache == true ? checked : empty) + " title='If checked dynamically generated routines will be stored in sw-*.cache files in the working directory for faster loading on application restart.'></td></tr>";
 		html += "<tr><td>Shadow mapping extensions:</td><td><select name='shadowMapping' title='Features that may accelerate or improve the quality of shadow mapping.'>\n";
 		html += "<option value='0'" + (config.shadowMapping == 0 ? selected : empty) + ">None</option>\n";
 		html += "<option value='1'" + (config.shadowMapping == 1 ? selected : empty) + ">Fetch4</option>\n";
@@ -439,6 +554,12 @@ namespace sw
 		html += "<option value='3'" + (config.shadowMapping == 3 ? selected : empty) + ">Fetch4 & DST (default)</option>\n";
 		html += "</select></td>\n";
 		html += "<tr><td>Force clearing registers that have no default value:</td><td><input name = 'forceClearRegisters' type='checkbox'" + (config.forceClearRegisters == true ? checked : empty) + " title='Initializes shader register values to 0 even if they have no default.'></td></tr>";
+		html += "<tr><td>Routine compilation trace:</td><td><input name = 'routineTrace' type='checkbox'" + (config.routineTrace == true ? checked : empty) + " title='If checked the compile time, code size and cache use of dynamically generated routines are recorded, and each compilation is written to sw-routines.json in the working directory for viewing with chrome://tracing.'></td></tr>";
+		html += "<tr><td>OpenGL ES command trace:</td><td><input name = 'commandTrace' type='checkbox'" + (config.commandTrace == true ? checked : empty) + " title='If checked the OpenGL ES 2.0 calls of contexts created from then on, and the memory they read, are captured to sw-gl-trace.bin in the working directory for playback with GLTraceReplay.'></td></tr>";
+		html += "<tr><td>Pixel shader profiling:</td><td><input name = 'shaderProfile' type='checkbox'" + (config.shaderProfile == true ? checked : empty) + " title='If checked the pixel shader routines generated from then on time each instruction, and the cycles and executions per instruction are written to sw-shader-profile.txt in the working directory on exit.'></td></tr>";
+		html += "<tr><td>Pixel pipeline profiling:</td><td><input name = 'pipelineProfile' type='checkbox'" + (config.pipelineProfile == true ? checked : empty) + " title='If checked the pixel routines generated from then on time the rasterization, interpolation, shading, texturing and raster operation stages, and count the operations of each, for display below and for eglQueryContext.'></td></tr>";
+		html += "<tr><td>Frame utilization profiling:</td><td><input name = 'utilizationProfile' type='checkbox'" + (config.utilizationProfile == true ? checked : empty) + " title='If checked the busy and idle time of each renderer thread, the time spent waiting for the scheduler lock and for locked resources, and the time spent presenting are summed per frame for display below.'></td></tr>";
+		html += "<tr><td>Reset peak memory usage:</td><td><input name = 'resetPeakMemoryUsage' type='checkbox' title='If checked the peaks of the allocated memory shown above, and reported by eglQueryContext, restart from the current usage when the changes are applied.'></td></tr>";
 		html += "</table>\n";
 	#ifndef NDEBUG
 		html += "<h2><em>Debugging</em></h2>\n";
@@ -466,17 +587,43 @@ namespace sw
 
 		html += "<p>FPS: " + ftoa(profiler.FPS) + "</p>\n";
 		html += "<p>Frame: " + itoa(profiler.framesTotal) + "</p>\n";
+		html += "<p>Evictable texture memory (MB): " + ftoa(Surface::getTextureMemoryUsage() / 1048576.0) + "</p>\n";
 
-		#if PERF_PROFILE
-			int texTime = (int)(1000 * profiler.cycles[PERF_TEX] / profiler.cycles[PERF_PIXEL] + 0.5);
-			int shaderTime = (int)(1000 * profiler.cycles[PERF_SHADER] / profiler.cycles[PERF_PIXEL] + 0.5);
-			int pipeTime = (int)(1000 * profiler.cycles[PERF_PIPE] / profiler.cycles[PERF_PIXEL] + 0.5);
-			int ropTime = (int)(1000 * profiler.cycles[PERF_ROP] / profiler.cycles[PERF_PIXEL] + 0.5);
-			int interpTime = (int)(1000 * profiler.cycles[PERF_INTERP] / profiler.cycles[PERF_PIXEL] + 0.5);
-			int rastTime = 1000 - pipeTime;
+		for(int format = FORMAT_NULL + 1; format <= FORMAT_LAST; format++)
+		{
+			size_t bytes = Surface::getResidentBytes((Format)format);
+
+			if(bytes)
+			{
+				html += "<p>Format " + itoa(format) + " resident (MB): " + ftoa(bytes / 1048576.0) + "</p>\n";
+			}
+		}
 
-			pipeTime -= shaderTime + ropTime + interpTime;
-			shaderTime -= texTime;
+		static const char *const memoryCategories[MEMORY_CATEGORIES] = {"General", "Surfaces", "Buffers", "Renderer", "Routines"};
+
+		html += "<p>Allocated memory (MB):</p>\n";
+		html += "<table>\n";
+
+		for(int category = 0; category < MEMORY_CATEGORIES; category++)
+		{
+			MemoryUsage usage = memoryUsage((MemoryCategory)category);
+
+			html += "<tr><td>" + std::string(memoryCategories[category]) + ":</td><td>" + ftoa(usage.current / 1048576.0) + " (" + ftoa(usage.peak / 1048576.0) + " peak)</td></tr>\n";
+		}
+
+		html += "</table>\n";
+
+		const PipelineProfile &frame = profiler.pipelineFrame;
+		const PipelineProfile &total = profiler.pipelineTotal;
+
+		if(total.drawCalls > 0)   // Pipeline profiling enabled
+		{
+			int rastTime = (int)(1000 * frame.share(PERF_PIXEL) + 0.5);
+			int pipeTime = (int)(1000 * frame.share(PERF_PIPE) + 0.5);
+			int interpTime = (int)(1000 * frame.share(PERF_INTERP) + 0.5);
+			int shaderTime = (int)(1000 * frame.share(PERF_SHADER) + 0.5);
+			int texTime = (int)(1000 * frame.share(PERF_TEX) + 0.5);
+			int ropTime = (int)(1000 * frame.share(PERF_ROP) + 0.5);
 
 			double texTimeF = (double)texTime / 10;
 			double shaderTimeF = (double)shaderTime / 10;
@@ -485,13 +632,18 @@ namespace sw
 			double interpTimeF = (double)interpTime / 10;
 			double rastTimeF = (double)rastTime / 10;
 
-			double averageRopOperations = profiler.ropOperationsTotal / std::max(profiler.framesTotal, 1) / 1.0e6f;
-			double averageCompressedTex = profiler.compressedTexTotal / std::max(profiler.framesTotal, 1) / 1.0e6f;
-			double averageTexOperations = profiler.texOperationsTotal / std::max(profiler.framesTotal, 1) / 1.0e6f;
+			double averageRopOperations = total.ropOperations / std::max(profiler.framesTotal, 1) / 1.0e6f;
+			double averageCompressedTex = total.compressedTex / std::max(profiler.framesTotal, 1) / 1.0e6f;
+			double averageTexOperations = total.texOperations / std::max(profiler.framesTotal, 1) / 1.0e6f;
+
+			double frameDraws = (double)std::max(frame.drawCalls, (int64_t)1);
+			double totalDraws = (double)std::max(total.drawCalls, (int64_t)1);
 
-			html += "<p>Raster operations (million): " + ftoa(profiler.ropOperationsFrame / 1.0e6f) + " (current), " + ftoa(averageRopOperations) + " (average)</p>\n";
-			html += "<p>Texture operations (million): " + ftoa(profiler.texOperationsFrame / 1.0e6f) + " (current), " + ftoa(averageTexOperations) + " (average)</p>\n";
-			html += "<p>Compressed texture operations (million): " + ftoa(profiler.compressedTexFrame / 1.0e6f) + " (current), " + ftoa(averageCompressedTex) + " (average)</p>\n";
+			html += "<p>Raster operations (million): " + ftoa(frame.ropOperations / 1.0e6f) + " (current), " + ftoa(averageRopOperations) + " (average)</p>\n";
+			html += "<p>Texture operations (million): " + ftoa(frame.texOperations / 1.0e6f) + " (current), " + ftoa(averageTexOperations) + " (average)</p>\n";
+			html += "<p>Compressed texture operations (million): " + ftoa(frame.compressedTex / 1.0e6f) + " (current), " + ftoa(averageCompressedTex) + " (average)</p>\n";
+			html += "<p>Early depth rejected quads per draw: " + ftoa(frame.earlyDepthRejects / frameDraws) + " (current), " + ftoa(total.earlyDepthRejects / totalDraws) + " (average)</p>\n";
+			html += "<p>Coherent pixel shader branches per draw: " + ftoa(frame.coherentBranches / frameDraws) + " of " + ftoa((frame.coherentBranches + frame.divergentBranches) / frameDraws) + " (current), " + ftoa(total.coherentBranches / totalDraws) + " of " + ftoa((total.coherentBranches + total.divergentBranches) / totalDraws) + " (average)</p>\n";
 			html += "<div id='profile' style='position:relative; width:1010px; height:50px; background-color:silver;'>";
 			html += "<div style='position:relative; width:1000px; height:40px; background-color:white; left:5px; top:5px;'>";
 			html += "<div style='position:relative; float:left; width:" + itoa(rastTime)   + "px; height:40px; border-style:none; text-align:center; line-height:40px; background-color:#FFFF7F; overflow:hidden;'>" + ftoa(rastTimeF)   + "% rast</div>\n";
@@ -501,12 +653,29 @@ namespace sw
 			html += "<div style='position:relative; float:left; width:" + itoa(texTime)    + "px; height:40px; border-style:none; text-align:center; line-height:40px; background-color:#FF7FFF; overflow:hidden;'>" + ftoa(texTimeF)    + "% tex</div>\n";
 			html += "<div style='position:relative; float:left; width:" + itoa(ropTime)    + "px; height:40px; border-style:none; text-align:center; line-height:40px; background-color:#7F7FFF; overflow:hidden;'>" + ftoa(ropTimeF)    + "% rop</div>\n";
 			html += "</div></div>\n";
+		}
 
-			for(int i = 0; i < PERF_TIMERS; i++)
+		const FrameUtilization &window = profiler.utilizationWindow;
+
+		if(window.frames > 0 && window.frameTime > 0)   // Utilization profiling enabled
+		{
+			// Shares of the wall time of the frames, the lock waits are summed over threads so can exceed it
+			double frameTime = (double)window.frameTime;
+
+			html += "<p>Frame utilization, last " + itoa(window.frames) + " frames:</p>\n";
+			html += "<table>\n";
+			html += "<tr><td>Renderer threads busy:</td><td>" + ftoa(100.0 * window.busyShare()) + "% (" + ftoa(100.0 * profiler.utilizationFrame.busyShare()) + "% last frame)</td></tr>\n";
+
+			for(int i = 0; i < window.threads; i++)
 			{
-				profiler.cycles[i] = 0;
+				html += "<tr><td>Thread " + itoa(i) + ":</td><td>" + ftoa(100.0 * window.busyTime[i] / frameTime) + "% busy, " + ftoa(100.0 * window.idleTime[i] / frameTime) + "% idle</td></tr>\n";
 			}
-		#endif
+
+			html += "<tr><td>Scheduler lock wait:</td><td>" + ftoa(100.0 * window.schedulerWait / frameTime) + "%</td></tr>\n";
+			html += "<tr><td>Resource lock wait:</td><td>" + ftoa(100.0 * window.resourceWait / frameTime) + "%</td></tr>\n";
+			html += "<tr><td>Presenting:</td><td>" + ftoa(100.0 * window.presentTime / frameTime) + "%</td></tr>\n";
+			html += "</table>\n";
+		}
 
 		return html;
 	}
@@ -548,6 +717,11 @@ namespace sw
 		config.disable10BitMode = false;
 		config.precache = false;
 		config.forceClearRegisters = false;
+		config.routineTrace = false;
+		config.commandTrace = false;
+		config.shaderProfile = false;
+		config.pipelineProfile = false;
+		config.utilizationProfile = false;
 
 		while(*post != 0)
 		{
@@ -598,6 +772,10 @@ namespace sw
 			{
 				config.perspectiveCorrection = integer != 0;
 			}
+			else if(sscanf(post, "tiledTextures=%d", &integer))
+			{
+				config.tiledTextures = integer != 0;
+			}
 			else if(sscanf(post, "transcendentalPrecision=%d", &integer))
 			{
 				config.transcendentalPrecision = integer;
@@ -610,6 +788,26 @@ namespace sw
 			{
 				config.threadCount = integer;
 			}
+			else if(sscanf(post, "rasterTileHeight=%d", &integer))
+			{
+				config.rasterTileHeight = integer;
+			}
+			else if(sscanf(post, "drawQueueSize=%d", &integer))
+			{
+				config.drawQueueSize = integer;
+			}
+			else if(sscanf(post, "threadAffinity=%d", &integer))
+			{
+				config.threadAffinity = integer;
+			}
+			else if(sscanf(post, "hugePageThreshold=%d", &integer))
+			{
+				config.hugePageThreshold = integer;
+			}
+			else if(sscanf(post, "concurrentCompilation=%d", &integer))
+			{
+				config.concurrentCompilation = integer;
+			}
 			else if(sscanf(post, "frameBufferAPI=%d", &integer))
 			{
 				config.frameBufferAPI = integer;
@@ -654,6 +852,26 @@ namespace sw
 			{
 				config.optimization[index - 1] = (Optimization)integer;
 			}
+			else if(sscanf(post, "tieredCompilation=%d", &integer))
+			{
+				config.tieredCompilation = integer;
+			}
+			else if(sscanf(post, "uniformSpecialization=%d", &integer))
+			{
+				config.uniformSpecialization = integer;
+			}
+			else if(sscanf(post, "drawCulling=%d", &integer))
+			{
+				config.drawCulling = integer;
+			}
+			else if(sscanf(post, "drawMerging=%d", &integer))
+			{
+				config.drawMerging = integer;
+			}
+			else if(sscanf(post, "routineWarmUp=%d", &integer))
+			{
+				config.routineWarmUp = integer;
+			}
 			else if(strstr(post, "disableServer=on"))
 			{
 				config.disableServer = true;
@@ -690,6 +908,30 @@ namespace sw
 			{
 				config.forceClearRegisters = true;
 			}
+			else if(strstr(post, "routineTrace=on"))
+			{
+				config.routineTrace = true;
+			}
+			else if(strstr(post, "commandTrace=on"))
+			{
+				config.commandTrace = true;
+			}
+			else if(strstr(post, "shaderProfile=on"))
+			{
+				config.shaderProfile = true;
+			}
+			else if(strstr(post, "pipelineProfile=on"))
+			{
+				config.pipelineProfile = true;
+			}
+			else if(strstr(post, "utilizationProfile=on"))
+			{
+				config.utilizationProfile = true;
+			}
+			else if(strstr(post, "resetPeakMemoryUsage=on"))
+			{
+				resetPeakMemoryUsage();   // An action rather than a setting, so it isn't saved
+			}
 		#ifndef NDEBUG
 			else if(sscanf(post, "minPrimitives=%d", &integer))
 			{
@@ -715,7 +957,18 @@ namespace sw
 
 	void SwiftConfig::readConfiguration(bool disableServerOverride)
 	{
-		Configurator ini("SwiftShader.ini");
+		Configurator ini("SwiftShader.ini", "SWIFTSHADER_");
+
+		Overrides &overrides = sw::overrides();
+		overrides.mutex.lock();
+
+		for(auto &value : overrides.values)
+		{
+			ini.addValue(value.first.first, value.first.second, value.second);
+		}
+
+		overrideGeneration = overrides.generation;
+		overrides.mutex.unlock();
 
 		config.pixelShaderVersion = ini.getInteger("Capabilities", "PixelShaderVersion", 30);
 		config.vertexShaderVersion = ini.getInteger("Capabilities", "VertexShaderVersion", 30);
@@ -728,9 +981,15 @@ namespace sw
 		config.textureSampleQuality = ini.getInteger("Quality", "TextureSampleQuality", 2);
 		config.mipmapQuality = ini.getInteger("Quality", "MipmapQuality", 1);
 		config.perspectiveCorrection = ini.getBoolean("Quality", "PerspectiveCorrection", true);
+		config.tiledTextures = ini.getBoolean("Quality", "TiledTextures", false);
 		config.transcendentalPrecision = ini.getInteger("Quality", "TranscendentalPrecision", 2);
 		config.transparencyAntialiasing = ini.getInteger("Quality", "TransparencyAntialiasing", 0);
 		config.threadCount = ini.getInteger("Processor", "ThreadCount", DEFAULT_THREAD_COUNT);
+		config.rasterTileHeight = ini.getInteger("Processor", "RasterTileHeight", 2);
+		config.drawQueueSize = ini.getInteger("Processor", "DrawQueueSize", 16);
+		config.threadAffinity = ini.getInteger("Processor", "ThreadAffinity", 0);
+		config.concurrentCompilation = ini.getInteger("Processor", "ConcurrentCompilation", 0);
+		config.hugePageThreshold = ini.getInteger("Processor", "HugePageThreshold", 0);
 		config.enableSSE = ini.getBoolean("Processor", "EnableSSE", true);
 		config.enableSSE2 = ini.getBoolean("Processor", "EnableSSE2", true);
 		config.enableSSE3 = ini.getBoolean("Processor", "EnableSSE3", true);
@@ -742,6 +1001,12 @@ namespace sw
 			config.optimization[pass] = (Optimization)ini.getInteger("Optimization", "OptimizationPass" + itoa(pass + 1), pass == 0 ? InstructionCombining : Disabled);
 		}
 
+		config.tieredCompilation = ini.getInteger("Optimization", "TieredCompilation", 0);
+		config.uniformSpecialization = ini.getInteger("Optimization", "UniformSpecialization", 0);
+		config.drawCulling = ini.getInteger("Optimization", "DrawCulling", 0);
+		config.drawMerging = ini.getInteger("Optimization", "DrawMerging", 1);
+		config.routineWarmUp = ini.getInteger("Optimization", "RoutineWarmUp", -1);
+
 		config.disableServer = ini.getBoolean("Testing", "DisableServer", false);
 		config.forceWindowed = ini.getBoolean("Testing", "ForceWindowed", false);
 		config.complementaryDepthBuffer = ini.getBoolean("Testing", "ComplementaryDepthBuffer", false);
@@ -753,6 +1018,11 @@ namespace sw
 		config.precache = ini.getBoolean("Testing", "Precache", false);
 		config.shadowMapping = ini.getInteger("Testing", "ShadowMapping", 3);
 		config.forceClearRegisters = ini.getBoolean("Testing", "ForceClearRegisters", false);
+		config.routineTrace = ini.getBoolean("Testing", "RoutineTrace", false);
+		config.commandTrace = ini.getBoolean("Testing", "CommandTrace", false);
+		config.shaderProfile = ini.getBoolean("Testing", "ShaderProfile", false);
+		config.pipelineProfile = ini.getBoolean("Testing", "PipelineProfile", false);
+		config.utilizationProfile = ini.getBoolean("Testing", "UtilizationProfile", false);
 
 	#ifndef NDEBUG
 		config.minPrimitives = 1;
@@ -786,9 +1056,15 @@ namespace sw
 		ini.addValue("Quality", "TextureSampleQuality", itoa(config.textureSampleQuality));
 		ini.addValue("Quality", "MipmapQuality", itoa(config.mipmapQuality));
 		ini.addValue("Quality", "PerspectiveCorrection", itoa(config.perspectiveCorrection));
+		ini.addValue("Quality", "TiledTextures", itoa(config.tiledTextures));
 		ini.addValue("Quality", "TranscendentalPrecision", itoa(config.transcendentalPrecision));
 		ini.addValue("Quality", "TransparencyAntialiasing", itoa(config.transparencyAntialiasing));
 		ini.addValue("Processor", "ThreadCount", itoa(config.threadCount));
+		ini.addValue("Processor", "RasterTileHeight", itoa(config.rasterTileHeight));
+		ini.addValue("Processor", "DrawQueueSize", itoa(config.drawQueueSize));
+		ini.addValue("Processor", "ThreadAffinity", itoa(config.threadAffinity));
+		ini.addValue("Processor", "ConcurrentCompilation", itoa(config.concurrentCompilation));
+		ini.addValue("Processor", "HugePageThreshold", itoa(config.hugePageThreshold));
 	//	ini.addValue("Processor", "EnableSSE", itoa(config.enableSSE));
 		ini.addValue("Processor", "EnableSSE2", itoa(config.enableSSE2));
 		ini.addValue("Processor", "EnableSSE3", itoa(config.enableSSE3));
@@ -800,6 +1076,12 @@ namespace sw
 			ini.addValue("Optimization", "OptimizationPass" + itoa(pass + 1), itoa(config.optimization[pass]));
 		}
 
+		ini.addValue("Optimization", "TieredCompilation", itoa(config.tieredCompilation));
+		ini.addValue("Optimization", "UniformSpecialization", itoa(config.uniformSpecialization));
+		ini.addValue("Optimization", "DrawCulling", itoa(config.drawCulling));
+		ini.addValue("Optimization", "DrawMerging", itoa(config.drawMerging));
+		ini.addValue("Optimization", "RoutineWarmUp", itoa(config.routineWarmUp));
+
 		ini.addValue("Testing", "DisableServer", itoa(config.disableServer));
 		ini.addValue("Testing", "ForceWindowed", itoa(config.forceWindowed));
 		ini.addValue("Testing", "ComplementaryDepthBuffer", itoa(config.complementaryDepthBuffer));
@@ -811,6 +1093,11 @@ namespace sw
 		ini.addValue("Testing", "Precache", itoa(config.precache));
 		ini.addValue("Testing", "ShadowMapping", itoa(config.shadowMapping));
 		ini.addValue("Testing", "ForceClearRegisters", itoa(config.forceClearRegisters));
+		ini.addValue("Testing", "RoutineTrace", itoa(config.routineTrace));
+		ini.addValue("Testing", "CommandTrace", itoa(config.commandTrace));
+		ini.addValue("Testing", "ShaderProfile", itoa(config.shaderProfile));
+		ini.addValue("Testing", "PipelineProfile", itoa(config.pipelineProfile));
+		ini.addValue("Testing", "UtilizationProfile", itoa(config.utilizationProfile));
 		ini.addValue("LastModified", "Time", itoa((int)time(0)));
 
 		ini.writeFile("SwiftShader Configuration File\n"
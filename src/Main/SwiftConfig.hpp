@@ -41,14 +41,25 @@ namespace sw
 			int textureSampleQuality;
 			int mipmapQuality;
 			bool perspectiveCorrection;
+			bool tiledTextures;
 			int transcendentalPrecision;
 			int threadCount;
+			int rasterTileHeight;
+			int drawQueueSize;
+			int threadAffinity;
+			int concurrentCompilation;
+			int hugePageThreshold;
 			bool enableSSE;
 			bool enableSSE2;
 			bool enableSSE3;
 			bool enableSSSE3;
 			bool enableSSE4_1;
 			Optimization optimization[10];
+			int tieredCompilation;
+			int uniformSpecialization;
+			int drawCulling;
+			int drawMerging;
+			int routineWarmUp;
 			bool disableServer;
 			bool keepSystemCursor;
 			bool forceWindowed;
@@ -62,6 +73,11 @@ namespace sw
 			bool precache;
 			int shadowMapping;
 			bool forceClearRegisters;
+			bool routineTrace;
+			bool commandTrace;
+			bool shaderProfile;
+			bool pipelineProfile;
+			bool utilizationProfile;
 		#ifndef NDEBUG
 			unsigned int minPrimitives;
 			unsigned int maxPrimitives;
@@ -75,6 +91,11 @@ namespace sw
 		bool hasNewConfiguration(bool reset = true);
 		void getConfiguration(Configuration &configuration);
 
+		// Process wide values which replace those of SwiftShader.ini, without writing it. Renderers apply
+		// them at their next draw call. SWIFTSHADER_<SECTION>_<NAME> environment variables still win.
+		static void setOverride(const char *section, const char *name, int value);
+		static void clearOverrides();
+
 	private:
 		enum Status
 		{
@@ -104,6 +125,7 @@ namespace sw
 		MutexLock criticalSection;   // Protects reading and writing the configuration settings
 
 		bool newConfig;
+		int overrideGeneration;   // Of the overrides the configuration was read with
 
 		Socket *listenSocket;
 
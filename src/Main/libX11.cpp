@@ -16,6 +16,8 @@
 
 #include "Common/SharedLibrary.hpp"
 
+#include <stdlib.h>
+
 #define Bool int
 
 LibX11exports::LibX11exports(void *libX11, void *libXext)
@@ -49,6 +51,13 @@ LibX11exports *LibX11::operator->()
 	return loadExports();
 }
 
+bool LibX11::hasServer()
+{
+	const char *display = getenv("DISPLAY");
+
+	return (display && *display) || getProcAddress(RTLD_DEFAULT, "XOpenDisplay");
+}
+
 LibX11exports *LibX11::loadExports()
 {
 	static void *libX11 = nullptr;
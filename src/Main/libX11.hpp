@@ -60,6 +60,9 @@ public:
 
 	LibX11exports *operator->();
 
+	// True when DISPLAY names a server or the process already uses X11, checked without loading the libraries
+	static bool hasServer();
+
 private:
 	LibX11exports *loadExports();
 };
@@ -16,7 +16,9 @@
 
 #include "../libEGL/Texture.hpp"
 #include "../common/debug.h"
+#include "Common/CPUID.hpp"
 #include "Common/Math.hpp"
+#include "Common/Memory.hpp"
 #include "Common/Thread.hpp"
 
 #include <GLES3/gl3.h>
@@ -24,6 +26,10 @@
 #include <string.h>
 #include <algorithm>
 
+#if defined(__i386__) || defined(__x86_64__)
+	#include <emmintrin.h>
+#endif
+
 #if defined(__APPLE__)
 #include <CoreFoundation/CoreFoundation.h>
 #include <IOSurface/IOSurface.h>
@@ -808,6 +814,196 @@ namespace egl
 	template<TransferType transferType>
 	void TransferRow(unsigned char *dest, const unsigned char *source, GLsizei width, GLsizei bytes);
 
+#if defined(__i386__) || defined(__x86_64__)
+	// The SSE2 row converters below return the number of pixels they converted, leaving the rest of the row to the scalar loop
+
+	// Converts four floats to halves in the low 16 bits of each lane, rounding like sw::half(float).
+	// Returns false if any of them becomes a denormal half, which is left to sw::half.
+	inline bool FloatToHalfSSE2(__m128 value, __m128i &half)
+	{
+		__m128i x = _mm_castps_si128(value);
+		__m128i sign = _mm_srli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x80000000)), 16);
+		__m128i abs = _mm_and_si128(x, _mm_set1_epi32(0x7FFFFFFF));
+
+		__m128i infinity = _mm_cmpgt_epi32(abs, _mm_set1_epi32(0x47FFEFFF));
+		__m128i zero = _mm_cmplt_epi32(abs, _mm_set1_epi32(0x2D000000));   // Too small to round up to the smallest denormal
+		__m128i denormal = _mm_andnot_si128(zero, _mm_cmplt_epi32(abs, _mm_set1_epi32(0x38800000)));
+
+		if(_mm_movemask_epi8(denormal))
+		{
+			return false;
+		}
+
+		__m128i odd = _mm_and_si128(_mm_srli_epi32(abs, 13), _mm_set1_epi32(1));
+		__m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(abs, _mm_set1_epi32(0xC8000FFF)), odd), 13);
+		normal = _mm_andnot_si128(zero, normal);
+		normal = _mm_or_si128(_mm_and_si128(infinity, _mm_set1_epi32(0x7FFF)), _mm_andnot_si128(infinity, normal));
+
+		half = _mm_or_si128(sign, normal);
+
+		return true;
+	}
+
+	// Packs the low 16 bits of each 32-bit lane, biased into the signed range of the saturating pack
+	inline __m128i PackUnsignedShortsSSE2(__m128i a, __m128i b)
+	{
+		const __m128i bias = _mm_set1_epi32(0x8000);
+		__m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias), _mm_sub_epi32(b, bias));
+
+		return _mm_xor_si128(packed, _mm_set1_epi16(-0x8000));
+	}
+
+	int FloatToHalfSSE2(sw::half *dest, const float *source, int count)
+	{
+		int i = 0;
+
+		for(; i + 8 <= count; i += 8)
+		{
+			__m128i low, high;
+
+			if(FloatToHalfSSE2(_mm_loadu_ps(source + i), low) && FloatToHalfSSE2(_mm_loadu_ps(source + i + 4), high))
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), PackUnsignedShortsSSE2(low, high));
+			}
+			else
+			{
+				for(int j = i; j < i + 8; j++)
+				{
+					dest[j] = source[j];
+				}
+			}
+		}
+
+		return i;
+	}
+
+	// Sets the alpha channel to 1.0 and, for unsigned formats, clamps negative colors to zero.
+	int RGB32FtoRGBX16FSSE2(sw::half *dest, const float *source, int width, bool clampNegative)
+	{
+		const __m128 rgb = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		const __m128 alpha = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+		int x = 0;
+
+		// Each 16-byte load reads the first component of the next pixel, which the loop condition keeps in the row
+		for(; x + 3 <= width; x += 2)
+		{
+			__m128 first = _mm_or_ps(_mm_and_ps(_mm_loadu_ps(source + 3 * x + 0), rgb), alpha);
+			__m128 second = _mm_or_ps(_mm_and_ps(_mm_loadu_ps(source + 3 * x + 3), rgb), alpha);
+
+			if(clampNegative)
+			{
+				// Zero as the first operand keeps NaN, like std::max(value, 0.0f)
+				first = _mm_max_ps(_mm_setzero_ps(), first);
+				second = _mm_max_ps(_mm_setzero_ps(), second);
+			}
+
+			__m128i low, high;
+
+			if(!FloatToHalfSSE2(first, low) || !FloatToHalfSSE2(second, high))
+			{
+				break;
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4 * x), PackUnsignedShortsSSE2(low, high));
+		}
+
+		return x;
+	}
+
+	int RGB8toRGBX8SSE2(unsigned char *dest, const unsigned char *source, int width)
+	{
+		const __m128i alpha = _mm_set1_epi32(0xFF000000);
+		int x = 0;
+
+		// Each 16-byte load covers four pixels and reads into the next two, which the loop condition keeps in the row
+		for(; x + 6 <= width; x += 4)
+		{
+			__m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 3 * x));
+			__m128i rgb01 = _mm_unpacklo_epi32(rgb, _mm_srli_si128(rgb, 3));
+			__m128i rgb23 = _mm_unpacklo_epi32(_mm_srli_si128(rgb, 6), _mm_srli_si128(rgb, 9));
+			__m128i rgbx = _mm_unpacklo_epi64(rgb01, rgb23);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4 * x), _mm_or_si128(rgbx, alpha));
+		}
+
+		return x;
+	}
+
+	// Interleaves 16-bit red-green and blue-alpha byte pairs into RGBA8 pixels
+	inline void StoreRGBA8SSE2(unsigned char *dest, __m128i rg, __m128i ba)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 0), _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 16), _mm_unpackhi_epi16(rg, ba));
+	}
+
+	int RGBA4toRGBA8SSE2(unsigned char *dest, const unsigned short *source, int width)
+	{
+		const __m128i nibble = _mm_set1_epi16(0x000F);
+		int x = 0;
+
+		for(; x + 8 <= width; x += 8)
+		{
+			__m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x));
+			__m128i rg = _mm_or_si128(_mm_srli_epi16(rgba, 12), _mm_and_si128(rgba, _mm_set1_epi16(0x0F00)));
+			__m128i ba = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(rgba, 4), nibble), _mm_slli_epi16(_mm_and_si128(rgba, nibble), 8));
+
+			// Each nibble is in the low half of its byte, and gets replicated into the high half
+			rg = _mm_or_si128(rg, _mm_slli_epi16(rg, 4));
+			ba = _mm_or_si128(ba, _mm_slli_epi16(ba, 4));
+
+			StoreRGBA8SSE2(dest + 4 * x, rg, ba);
+		}
+
+		return x;
+	}
+
+	inline __m128i Expand5to8SSE2(__m128i c)
+	{
+		return _mm_or_si128(_mm_slli_epi16(c, 3), _mm_srli_epi16(c, 2));
+	}
+
+	int RGBA5_A1toRGBA8SSE2(unsigned char *dest, const unsigned short *source, int width)
+	{
+		const __m128i five = _mm_set1_epi16(0x001F);
+		int x = 0;
+
+		for(; x + 8 <= width; x += 8)
+		{
+			__m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x));
+			__m128i r = Expand5to8SSE2(_mm_srli_epi16(rgba, 11));
+			__m128i g = Expand5to8SSE2(_mm_and_si128(_mm_srli_epi16(rgba, 6), five));
+			__m128i b = Expand5to8SSE2(_mm_and_si128(_mm_srli_epi16(rgba, 1), five));
+			__m128i a = _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(rgba, _mm_set1_epi16(1))), _mm_set1_epi16(-0x0100));
+
+			StoreRGBA8SSE2(dest + 4 * x, _mm_or_si128(r, _mm_slli_epi16(g, 8)), _mm_or_si128(b, a));
+		}
+
+		return x;
+	}
+
+	int R11G11B10FtoRGBX16FSSE2(unsigned short *dest, const unsigned int *source, int width)
+	{
+		const __m128i eleven = _mm_set1_epi32(0x000007FF);
+		const __m128i alpha = _mm_set1_epi32(0x3C000000);   // 1.0 in the upper half
+		int x = 0;
+
+		for(; x + 4 <= width; x += 4)
+		{
+			__m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x));
+			__m128i r = _mm_slli_epi32(_mm_and_si128(rgb, eleven), 4);
+			__m128i g = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(rgb, 11), eleven), 4 + 16);
+			__m128i b = _mm_slli_epi32(_mm_srli_epi32(rgb, 22), 5);
+			__m128i rg = _mm_or_si128(r, g);
+			__m128i ba = _mm_or_si128(b, alpha);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4 * x + 0), _mm_unpacklo_epi32(rg, ba));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4 * x + 8), _mm_unpackhi_epi32(rg, ba));
+		}
+
+		return x;
+	}
+#endif
+
 	template<>
 	void TransferRow<Bytes>(unsigned char *dest, const unsigned char *source, GLsizei width, GLsizei bytes)
 	{
@@ -818,8 +1014,16 @@ namespace egl
 	void TransferRow<RGB8toRGBX8>(unsigned char *dest, const unsigned char *source, GLsizei width, GLsizei bytes)
 	{
 		unsigned char *destB = dest;
+		int x = 0;
 
-		for(int x = 0; x < width; x++)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = RGB8toRGBX8SSE2(destB, source, width);
+			}
+		#endif
+
+		for(; x < width; x++)
 		{
 			destB[4 * x + 0] = source[x * 3 + 0];
 			destB[4 * x + 1] = source[x * 3 + 1];
@@ -893,8 +1097,16 @@ namespace egl
 	{
 		const unsigned short *source4444 = reinterpret_cast<const unsigned short*>(source);
 		unsigned char *dest4444 = dest;
+		int x = 0;
 
-		for(int x = 0; x < width; x++)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = RGBA4toRGBA8SSE2(dest4444, source4444, width);
+			}
+		#endif
+
+		for(; x < width; x++)
 		{
 			unsigned short rgba = source4444[x];
 			dest4444[4 * x + 0] = ((rgba & 0xF000) >> 8) | ((rgba & 0xF000) >> 12);
@@ -909,8 +1121,16 @@ namespace egl
 	{
 		const unsigned short *source5551 = reinterpret_cast<const unsigned short*>(source);
 		unsigned char *dest8888 = dest;
+		int x = 0;
 
-		for(int x = 0; x < width; x++)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = RGBA5_A1toRGBA8SSE2(dest8888, source5551, width);
+			}
+		#endif
+
+		for(; x < width; x++)
 		{
 			unsigned short rgba = source5551[x];
 			dest8888[4 * x + 0] = ((rgba & 0xF800) >> 8) | ((rgba & 0xF800) >> 13);
@@ -955,8 +1175,18 @@ namespace egl
 	{
 		const sw::R11G11B10F *sourceRGB = reinterpret_cast<const sw::R11G11B10F*>(source);
 		sw::half *destF = reinterpret_cast<sw::half*>(dest);
+		int x = 0;
 
-		for(int x = 0; x < width; x++, sourceRGB++, destF += 4)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = R11G11B10FtoRGBX16FSSE2(reinterpret_cast<unsigned short*>(dest), reinterpret_cast<const unsigned int*>(source), width);
+				sourceRGB += x;
+				destF += 4 * x;
+			}
+		#endif
+
+		for(; x < width; x++, sourceRGB++, destF += 4)
 		{
 			sourceRGB->toRGB16F(destF);
 			destF[3] = 1.0f;
@@ -981,8 +1211,16 @@ namespace egl
 	{
 		const float *source32F = reinterpret_cast<const float*>(source);
 		sw::half *dest16F = reinterpret_cast<sw::half*>(dest);
+		int x = 0;
 
-		for(int x = 0; x < width; x++)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = FloatToHalfSSE2(dest16F, source32F, width);
+			}
+		#endif
+
+		for(; x < width; x++)
 		{
 			dest16F[x] = source32F[x];
 		}
@@ -993,8 +1231,16 @@ namespace egl
 	{
 		const float *source32F = reinterpret_cast<const float*>(source);
 		sw::half *dest16F = reinterpret_cast<sw::half*>(dest);
+		int x = 0;
 
-		for(int x = 0; x < width; x++)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = FloatToHalfSSE2(dest16F, source32F, 2 * width) / 2;
+			}
+		#endif
+
+		for(; x < width; x++)
 		{
 			dest16F[2 * x + 0] = source32F[2 * x + 0];
 			dest16F[2 * x + 1] = source32F[2 * x + 1];
@@ -1006,8 +1252,16 @@ namespace egl
 	{
 		const float *source32F = reinterpret_cast<const float*>(source);
 		sw::half *dest16F = reinterpret_cast<sw::half*>(dest);
+		int x = 0;
 
-		for(int x = 0; x < width; x++)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = RGB32FtoRGBX16FSSE2(dest16F, source32F, width, false);
+			}
+		#endif
+
+		for(; x < width; x++)
 		{
 			dest16F[4 * x + 0] = source32F[3 * x + 0];
 			dest16F[4 * x + 1] = source32F[3 * x + 1];
@@ -1021,8 +1275,16 @@ namespace egl
 	{
 		const float *source32F = reinterpret_cast<const float*>(source);
 		sw::half *dest16F = reinterpret_cast<sw::half*>(dest);
+		int x = 0;
 
-		for(int x = 0; x < width; x++)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = RGB32FtoRGBX16FSSE2(dest16F, source32F, width, true);
+			}
+		#endif
+
+		for(; x < width; x++)
 		{
 			dest16F[4 * x + 0] = std::max(source32F[3 * x + 0], 0.0f);
 			dest16F[4 * x + 1] = std::max(source32F[3 * x + 1], 0.0f);
@@ -1036,8 +1298,16 @@ namespace egl
 	{
 		const float *source32F = reinterpret_cast<const float*>(source);
 		sw::half *dest16F = reinterpret_cast<sw::half*>(dest);
+		int x = 0;
 
-		for(int x = 0; x < width; x++)
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				x = FloatToHalfSSE2(dest16F, source32F, 4 * width) / 4;
+			}
+		#endif
+
+		for(; x < width; x++)
 		{
 			dest16F[4 * x + 0] = source32F[4 * x + 0];
 			dest16F[4 * x + 1] = source32F[4 * x + 1];
@@ -1144,21 +1414,91 @@ namespace egl
 		GLsizei destSlice;
 	};
 
+	// Transfers the rows from begin to end, counting the rows of all slices
 	template<TransferType transferType>
-	void Transfer(void *buffer, const void *input, const Rectangle &rect)
+	void TransferRows(void *buffer, const void *input, const Rectangle &rect, int begin, int end)
 	{
-		for(int z = 0; z < rect.depth; z++)
+		for(int row = begin; row < end; row++)
 		{
-			const unsigned char *inputStart = static_cast<const unsigned char*>(input) + (z * rect.inputPitch * rect.inputHeight);
-			unsigned char *destStart = static_cast<unsigned char*>(buffer) + (z * rect.destSlice);
-			for(int y = 0; y < rect.height; y++)
-			{
-				const unsigned char *source = inputStart + y * rect.inputPitch;
-				unsigned char *dest = destStart + y * rect.destPitch;
+			int z = row / rect.height;
+			int y = row % rect.height;
+
+			const unsigned char *source = static_cast<const unsigned char*>(input) + (z * rect.inputPitch * rect.inputHeight) + y * rect.inputPitch;
+			unsigned char *dest = static_cast<unsigned char*>(buffer) + (z * rect.destSlice) + y * rect.destPitch;
 
-				TransferRow<transferType>(dest, source, rect.width, rect.bytes);
+			TransferRow<transferType>(dest, source, rect.width, rect.bytes);
+		}
+	}
+
+	typedef void (*TransferRowsFunction)(void *buffer, const void *input, const Rectangle &rect, int begin, int end);
+
+	struct TransferSlice
+	{
+		TransferRowsFunction transferRows;
+		void *buffer;
+		const void *input;
+		const Rectangle *rect;
+		int begin;
+		int end;
+	};
+
+	void TransferSliceThread(void *parameters)
+	{
+		const TransferSlice *slice = static_cast<const TransferSlice*>(parameters);
+
+		slice->transferRows(slice->buffer, slice->input, *slice->rect, slice->begin, slice->end);
+	}
+
+	enum
+	{
+		MAX_TRANSFER_THREADS = 4,
+		MIN_TRANSFER_BYTES_PER_THREAD = 0x100000,   // Smaller slices don't pay for starting a thread
+	};
+
+	// Splits large transfers by rows across threads, with the calling thread taking the first slice
+	void TransferSplit(void *buffer, const void *input, const Rectangle &rect, TransferRowsFunction transferRows)
+	{
+		int rows = rect.height * rect.depth;
+		size_t bytes = (size_t)rows * rect.width * rect.bytes;
+		int threadCount = (int)std::min(bytes / MIN_TRANSFER_BYTES_PER_THREAD, (size_t)MAX_TRANSFER_THREADS);
+
+		if(threadCount > 1)
+		{
+			threadCount = std::min(threadCount, sw::CPUID::processAffinity());
+		}
+
+		if(threadCount <= 1)
+		{
+			transferRows(buffer, input, rect, 0, rows);
+			return;
+		}
+
+		TransferSlice slice[MAX_TRANSFER_THREADS];
+		sw::Thread *thread[MAX_TRANSFER_THREADS];
+
+		for(int i = 0; i < threadCount; i++)
+		{
+			slice[i] = {transferRows, buffer, input, &rect, rows * i / threadCount, rows * (i + 1) / threadCount};
+
+			if(i > 0)
+			{
+				thread[i] = new sw::Thread(TransferSliceThread, &slice[i]);
 			}
 		}
+
+		TransferSliceThread(&slice[0]);
+
+		for(int i = 1; i < threadCount; i++)
+		{
+			thread[i]->join();
+			delete thread[i];
+		}
+	}
+
+	template<TransferType transferType>
+	void Transfer(void *buffer, const void *input, const Rectangle &rect)
+	{
+		TransferSplit(buffer, input, rect, TransferRows<transferType>);
 	}
 
 	class ImageImplementation : public Image
@@ -1273,10 +1613,27 @@ namespace egl
 
 		return 0;
 #else
-		return sw::Surface::pitchP(width, 0, format, false);
+		// Files are rendered to in place, so they're laid out like render targets
+		return sw::Surface::pitchP(width, 0, format, isFile());
 #endif
 	}
 
+	size_t ClientBuffer::fileSize() const
+	{
+		// Quads of the last row pair are read and written back whole
+		return (size_t)sw::Surface::pitchB(width, 0, format, true) * sw::align<2>(height);
+	}
+
+	bool ClientBuffer::map()
+	{
+		if(isFile() && !buffer)
+		{
+			buffer = sw::mapFile(fileDescriptor, fileSize());
+		}
+
+		return buffer != nullptr;
+	}
+
 	void ClientBuffer::retain()
 	{
 #if defined(__APPLE__)
@@ -1295,6 +1652,12 @@ namespace egl
 			CFRelease(reinterpret_cast<IOSurfaceRef>(buffer));
 			buffer = nullptr;
 		}
+#else
+		if(isFile())
+		{
+			sw::unmapFile(buffer, fileSize());
+			buffer = nullptr;
+		}
 #endif
 	}
 
@@ -1315,7 +1678,7 @@ namespace egl
 		return nullptr;
 #else
 		int bytes = sw::Surface::bytes(format);
-		int pitchB = sw::Surface::pitchB(width, 0, format, false);
+		int pitchB = sw::Surface::pitchB(width, 0, format, isFile());
 		int sliceB = height * pitchB;
 		return (unsigned char*)buffer + x * bytes + y * pitchB + z * sliceB;
 #endif
@@ -1344,6 +1707,22 @@ namespace egl
 	class ClientBufferImage : public egl::Image
 	{
 	public:
+		static GLint getClientBufferInternalFormat(sw::Format format)
+		{
+			switch(format)
+			{
+			case sw::FORMAT_R8:            return GL_R8;
+			case sw::FORMAT_G8R8:          return GL_RG8;
+			case sw::FORMAT_A8R8G8B8:      return GL_BGRA8_EXT;
+			case sw::FORMAT_A8B8G8R8:      return GL_RGBA8;
+			case sw::FORMAT_X8B8G8R8:      return GL_RGB8;
+			case sw::FORMAT_R5G6B5:        return GL_RGB565;
+			case sw::FORMAT_R16UI:         return GL_R16UI;
+			case sw::FORMAT_A16B16G16R16F: return GL_RGBA16F;
+			default:                       return GL_NONE;
+			}
+		}
+
 		explicit ClientBufferImage(const ClientBuffer& clientBuffer) :
 			egl::Image(clientBuffer.getWidth(),
 				clientBuffer.getHeight(),
@@ -1353,6 +1732,11 @@ namespace egl
 		{
 			shared = false;
 			this->clientBuffer.retain();
+
+#if !defined(__APPLE__)
+			// The buffer is the internal one, so what gets written when locking it, like deferred clears, lands in the client's memory
+			setInternalStorage(new sw::Surface::Storage(this->clientBuffer.lock(0, 0, 0), getInternalSize()), 0);
+#endif
 		}
 
 	private:
@@ -1365,19 +1749,6 @@ namespace egl
 			clientBuffer.release();
 		}
 
-		static GLint getClientBufferInternalFormat(sw::Format format)
-		{
-			switch(format)
-			{
-			case sw::FORMAT_R8:            return GL_R8;
-			case sw::FORMAT_G8R8:          return GL_RG8;
-			case sw::FORMAT_A8R8G8B8:      return GL_BGRA8_EXT;
-			case sw::FORMAT_R16UI:         return GL_R16UI;
-			case sw::FORMAT_A16B16G16R16F: return GL_RGBA16F;
-			default:                       return GL_NONE;
-			}
-		}
-
 		void *lockInternal(int x, int y, int z, sw::Lock lock, sw::Accessor client) override
 		{
 			LOGLOCK("image=%p op=%s.swsurface lock=%d", this, __FUNCTION__, lock);
@@ -1422,6 +1793,11 @@ namespace egl
 			return clientBuffer.lock(x, y, z);
 		}
 
+		void *lock(int x, int y, int z, int width, int height, int depth, sw::Lock lock) override
+		{
+			return this->lock(x, y, z, lock);
+		}
+
 		void unlock() override
 		{
 			LOGLOCK("image=%p op=%s.ani", this, __FUNCTION__);
@@ -1444,7 +1820,203 @@ namespace egl
 
 	Image *Image::create(const egl::ClientBuffer& clientBuffer)
 	{
-		return new ClientBufferImage(clientBuffer);
+		if(ClientBufferImage::getClientBufferInternalFormat(clientBuffer.getFormat()) == GL_NONE)
+		{
+			return nullptr;
+		}
+
+		egl::ClientBuffer buffer = clientBuffer;
+
+		if(!buffer.map())   // The image owns the mapping, and releases it when destroyed
+		{
+			return nullptr;
+		}
+
+		return new ClientBufferImage(buffer);
+	}
+
+	class DmaBufImage : public egl::Image
+	{
+	public:
+		// Takes over the mappings of the dma-bufs, indexed like the planes
+		DmaBufImage(const DmaBuffer &dmaBuffer, void *const mapping[3], const size_t mappingBytes[3]) :
+			egl::Image(dmaBuffer.width, dmaBuffer.height, dmaBuffer.internalformat, dmaBuffer.y.pitchB),
+			lumaPitchB(dmaBuffer.y.pitchB)
+		{
+			for(int i = 0; i < 3; i++)
+			{
+				this->mapping[i] = mapping[i];
+				this->mappingBytes[i] = mappingBytes[i];
+			}
+
+			luma = plane(dmaBuffer.y, dmaBuffer, mapping);
+			chroma.offsetCb = plane(dmaBuffer.cb, dmaBuffer, mapping) - luma;
+			chroma.offsetCr = plane(dmaBuffer.cr, dmaBuffer, mapping) - luma;
+			chroma.pitchB = dmaBuffer.cb.pitchB;
+			chroma.stepB = dmaBuffer.chromaStepB;
+		}
+
+		// Planes in the same file share the mapping of the first one
+		static int mappingIndex(const DmaBuffer::Plane &plane, const DmaBuffer &dmaBuffer)
+		{
+			if(plane.fileDescriptor == dmaBuffer.y.fileDescriptor) return 0;
+			if(plane.fileDescriptor == dmaBuffer.cb.fileDescriptor) return 1;
+			return 2;
+		}
+
+	private:
+		unsigned char *luma;
+		const int lumaPitchB;
+		ChromaPlanes chroma;
+		void *mapping[3];
+		size_t mappingBytes[3];
+
+		static unsigned char *plane(const DmaBuffer::Plane &plane, const DmaBuffer &dmaBuffer, void *const mapping[3])
+		{
+			return (unsigned char*)mapping[mappingIndex(plane, dmaBuffer)] + plane.offset;
+		}
+
+		~DmaBufImage() override
+		{
+			sync();   // Wait for any threads that use this image to finish.
+
+			for(int i = 0; i < 3; i++)
+			{
+				sw::unmapFile(mapping[i], mappingBytes[i]);
+			}
+		}
+
+		// The planes are sampled where they are, so there's no internal copy to allocate or keep up to date
+		void *lockInternal(int x, int y, int z, sw::Lock lock, sw::Accessor client) override
+		{
+			if(lock != sw::LOCK_UNLOCKED)
+			{
+				getResource()->lock(client);
+			}
+
+			return luma + x + y * lumaPitchB;
+		}
+
+		void unlockInternal() override
+		{
+			getResource()->unlock();
+		}
+
+		void *lock(int x, int y, int z, sw::Lock lock) override
+		{
+			getResource()->lock(sw::PUBLIC);
+
+			return luma + x + y * lumaPitchB;
+		}
+
+		void *lock(int x, int y, int z, int width, int height, int depth, sw::Lock lock) override
+		{
+			return this->lock(x, y, z, lock);
+		}
+
+		void unlock() override
+		{
+			getResource()->unlock();
+		}
+
+		ChromaPlanes getChromaPlanes() const override
+		{
+			return chroma;
+		}
+
+		void release() override
+		{
+			Image::release();
+		}
+	};
+
+	// Single plane RGB dma-buf, rendered to and sampled in place as the internal buffer
+	class DmaBufRenderTarget : public egl::Image
+	{
+	public:
+		// Takes over the mapping of the dma-buf
+		DmaBufRenderTarget(const DmaBuffer &dmaBuffer, void *mapping, size_t mappingBytes) :
+			egl::Image(dmaBuffer.width, dmaBuffer.height, dmaBuffer.internalformat, dmaBuffer.y.pitchB / sw::Surface::bytes(gl::SelectInternalFormat(dmaBuffer.internalformat))),
+			mapping(mapping),
+			mappingBytes(mappingBytes)
+		{
+			setInternalStorage(new sw::Surface::Storage(mapping, mappingBytes), dmaBuffer.y.offset);
+		}
+
+	private:
+		void *mapping;
+		size_t mappingBytes;
+
+		~DmaBufRenderTarget() override
+		{
+			sync();   // Wait for any threads that use this image to finish.
+
+			sw::unmapFile(mapping, mappingBytes);
+		}
+
+		void *lockInternal(int x, int y, int z, sw::Lock lock, sw::Accessor client) override
+		{
+			return Image::lockInternal(x, y, z, lock, client);
+		}
+
+		void unlockInternal() override
+		{
+			return Image::unlockInternal();
+		}
+
+		void release() override
+		{
+			return Image::release();
+		}
+	};
+
+	Image *Image::create(const egl::DmaBuffer& dmaBuffer)
+	{
+		if(dmaBuffer.isRGB())
+		{
+			// Quads of the last row pair are read and written back whole
+			size_t bytes = dmaBuffer.y.offset + (size_t)dmaBuffer.y.pitchB * sw::align<2>(dmaBuffer.height);
+			void *mapping = sw::mapFile(dmaBuffer.y.fileDescriptor, bytes);
+
+			return mapping ? new DmaBufRenderTarget(dmaBuffer, mapping, bytes) : nullptr;
+		}
+
+		// Each file gets mapped once, up to the last byte of its planes which the sampler reads
+		const DmaBuffer::Plane *planes[3] = {&dmaBuffer.y, &dmaBuffer.cb, &dmaBuffer.cr};
+		int rows[3] = {dmaBuffer.height, dmaBuffer.height / 2, dmaBuffer.height / 2};
+		int rowBytes[3] = {dmaBuffer.width, (dmaBuffer.width / 2 - 1) * dmaBuffer.chromaStepB + 1, (dmaBuffer.width / 2 - 1) * dmaBuffer.chromaStepB + 1};
+		void *mapping[3] = {nullptr, nullptr, nullptr};
+		size_t mappingBytes[3] = {0, 0, 0};
+
+		for(int i = 0; i < 3; i++)
+		{
+			size_t end = planes[i]->offset + (size_t)planes[i]->pitchB * (std::max(rows[i], 1) - 1) + std::max(rowBytes[i], 1);
+			size_t &bytes = mappingBytes[DmaBufImage::mappingIndex(*planes[i], dmaBuffer)];
+			bytes = std::max(bytes, end);
+		}
+
+		bool mapped = true;
+
+		for(int i = 0; i < 3; i++)
+		{
+			if(mappingBytes[i])
+			{
+				mapping[i] = sw::mapFile(planes[i]->fileDescriptor, mappingBytes[i]);
+				mapped = mapped && mapping[i];
+			}
+		}
+
+		if(!mapped)
+		{
+			for(int i = 0; i < 3; i++)
+			{
+				sw::unmapFile(mapping[i], mappingBytes[i]);
+			}
+
+			return nullptr;
+		}
+
+		return new DmaBufImage(dmaBuffer, mapping, mappingBytes);
 	}
 
 	Image::~Image()
@@ -1503,7 +2075,7 @@ namespace egl
 		return parentTexture == parent;
 	}
 
-	void Image::loadImageData(GLsizei width, GLsizei height, GLsizei depth, int inputPitch, int inputHeight, GLenum format, GLenum type, const void *input, void *buffer)
+	void Image::loadImageData(GLsizei width, GLsizei height, GLsizei depth, int inputPitch, int inputHeight, GLenum format, GLenum type, const void *input, void *buffer, int destPitch, int destSlice)
 	{
 		Rectangle rect;
 		rect.bytes = gl::ComputePixelSize(format, type);
@@ -1512,8 +2084,8 @@ namespace egl
 		rect.depth = depth;
 		rect.inputPitch = inputPitch;
 		rect.inputHeight = inputHeight;
-		rect.destPitch = getPitch();
-		rect.destSlice = getSlice();
+		rect.destPitch = destPitch;
+		rect.destSlice = destSlice;
 
 		// [OpenGL ES 3.0.5] table 3.2 and 3.3.
 		switch(format)
@@ -1861,14 +2433,36 @@ namespace egl
 		GLsizei inputHeight = (unpackParameters.imageHeight == 0) ? height : unpackParameters.imageHeight;
 		char *input = ((char*)pixels) + gl::ComputePackingOffset(format, type, inputWidth, inputHeight, unpackParameters);
 
-		void *buffer = lock(xoffset, yoffset, zoffset, sw::LOCK_WRITEONLY);
+		bool entire = (xoffset == 0 && yoffset == 0 && zoffset == 0 && width == getWidth() && height == getHeight() && depth == getDepth());
+		sw::Lock lockType = entire ? sw::LOCK_DISCARD : sw::LOCK_WRITEONLY;
 
-		if(buffer)
+		// Texture images whose transfer already produces the internal format are written in place,
+		// so the external buffer is neither filled nor allocated unless it's read back.
+		bool direct = parentTexture && !shared && getExternalFormat() == getInternalFormat() &&
+		              !isDepth(getInternalFormat()) && !isStencil(getInternalFormat());
+
+		if(direct)
 		{
-			loadImageData(width, height, depth, inputPitch, inputHeight, format, type, input, buffer);
+			void *buffer = lockInternal(xoffset, yoffset, zoffset, lockType, sw::PUBLIC);
+
+			if(buffer)
+			{
+				loadImageData(width, height, depth, inputPitch, inputHeight, format, type, input, buffer, getInternalPitchB(), getInternalSliceB());
+			}
+
+			unlockInternal();
 		}
+		else
+		{
+			void *buffer = lock(xoffset, yoffset, zoffset, width, height, depth, lockType);
 
-		unlock();
+			if(buffer)
+			{
+				loadImageData(width, height, depth, inputPitch, inputHeight, format, type, input, buffer, getPitch(), getSlice());
+			}
+
+			unlock();
+		}
 
 		if(hasStencil())
 		{
@@ -1889,7 +2483,7 @@ namespace egl
 		int inputSlice = imageSize / depth;
 		int rows = inputSlice / inputPitch;
 
-		void *buffer = lock(xoffset, yoffset, zoffset, sw::LOCK_WRITEONLY);
+		void *buffer = lock(xoffset, yoffset, zoffset, width, height, depth, sw::LOCK_WRITEONLY);   // Only the updated blocks get decoded again
 
 		if(buffer)
 		{
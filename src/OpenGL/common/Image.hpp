@@ -70,11 +70,17 @@ public:
 		: width(width), height(height), format(format), buffer(buffer), plane(plane)
 	{}
 
+	// Backed by a shared mapping of the file, made by map(), so rendering writes through to the file
+	ClientBuffer(int width, int height, sw::Format format, int fileDescriptor)
+		: width(width), height(height), format(format), buffer(nullptr), plane(0), fileDescriptor(fileDescriptor)
+	{}
+
 	int getWidth() const;
 	int getHeight() const;
 	sw::Format getFormat() const;
 	size_t getPlane() const;
 	int pitchP() const;
+	bool map();   // Maps file backed buffers, returns false if that fails
 	void retain();
 	void release();
 	void* lock(int x, int y, int z);
@@ -87,6 +93,32 @@ private:
 	sw::Format format;
 	void* buffer;
 	size_t plane;
+	int fileDescriptor = -1;
+
+	bool isFile() const { return fileDescriptor >= 0; }
+	size_t fileSize() const;
+};
+
+// YUV 4:2:0 image in Linux dma-bufs, sampled in place (EGL_EXT_image_dma_buf_import),
+// or a single plane RGB image, which is also rendered to in place
+struct DmaBuffer
+{
+	struct Plane
+	{
+		int fileDescriptor;
+		size_t offset;   // Of the first sample
+		int pitchB;
+	};
+
+	int width;
+	int height;
+	GLint internalformat;   // One of the SW_YV12_* formats, for the color space and range, or a sized RGB format
+	Plane y;    // The only plane of RGB images
+	Plane cb;
+	Plane cr;
+	int chromaStepB;   // Two when Cb and Cr are interleaved in one plane, like NV12
+
+	bool isRGB() const { return cb.fileDescriptor < 0; }
 };
 
 class [[clang::lto_visibility_public]] Image : public sw::Surface, public gl::Object
@@ -146,6 +178,9 @@ public:
 	// Back buffer from client buffer
 	static Image *create(const egl::ClientBuffer& clientBuffer);
 
+	// Native EGL image from dma-bufs
+	static Image *create(const egl::DmaBuffer& dmaBuffer);
+
 	static size_t size(int width, int height, int depth, int border, int samples, GLint internalformat);
 
 	GLsizei getWidth() const
@@ -185,6 +220,11 @@ public:
 		return lockExternal(x, y, z, lock, sw::PUBLIC);
 	}
 
+	virtual void *lock(int x, int y, int z, int width, int height, int depth, sw::Lock lock)   // Writes stay within the box
+	{
+		return lockExternal(x, y, z, width, height, depth, lock, sw::PUBLIC);
+	}
+
 	unsigned int getPitch() const
 	{
 		return getExternalPitchB();
@@ -229,7 +269,7 @@ protected:
 
 	~Image() override = 0;
 
-	void loadImageData(GLsizei width, GLsizei height, GLsizei depth, int inputPitch, int inputHeight, GLenum format, GLenum type, const void *input, void *buffer);
+	void loadImageData(GLsizei width, GLsizei height, GLsizei depth, int inputPitch, int inputHeight, GLenum format, GLenum type, const void *input, void *buffer, int destPitch, int destSlice);
 	void loadStencilData(GLsizei width, GLsizei height, GLsizei depth, int inputPitch, int inputHeight, GLenum format, GLenum type, const void *input, void *buffer);
 };
 
@@ -299,7 +339,7 @@ private:
 			LOGLOCK("image=%p op=%s.ani lock=%d", this, __FUNCTION__, lock);
 
 			// Lock the ANativeWindowBuffer and use its address.
-			data = lockNativeBuffer(GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN);
+			data = lockNativeBuffer(nativeUsage(lock));
 
 			if(lock == sw::LOCK_UNLOCKED)
 			{
@@ -329,7 +369,12 @@ private:
 		LOGLOCK("image=%p op=%s lock=%d", this, __FUNCTION__, lock);
 		(void)sw::Surface::lockExternal(x, y, z, lock, sw::PUBLIC);
 
-		return lockNativeBuffer(GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN);
+		return lockNativeBuffer(nativeUsage(lock));
+	}
+
+	void *lock(int x, int y, int z, int width, int height, int depth, sw::Lock lock) override
+	{
+		return this->lock(x, y, z, lock);
 	}
 
 	void unlock() override
@@ -341,6 +386,18 @@ private:
 		sw::Surface::unlockExternal();
 	}
 
+	// Locking for reading can make gralloc fetch the contents, and locking for writing flush them,
+	// which on emulators means copying the whole buffer from or to the host
+	static int nativeUsage(sw::Lock lock)
+	{
+		switch(lock)
+		{
+		case sw::LOCK_READONLY: return GRALLOC_USAGE_SW_READ_OFTEN;
+		case sw::LOCK_DISCARD:  return GRALLOC_USAGE_SW_WRITE_OFTEN;
+		default:                return GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN;
+		}
+	}
+
 	void *lockNativeBuffer(int usage)
 	{
 		void *buffer = nullptr;
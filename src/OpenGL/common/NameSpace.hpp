@@ -21,7 +21,9 @@
 #include "Object.hpp"
 #include "debug.h"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 namespace gl
 {
@@ -41,17 +43,60 @@ public:
 
 	bool empty()
 	{
-		return map.empty();
+		return count == 0;
 	}
 
 	GLuint firstName()
 	{
+		for(GLuint name = 0; name < table.size(); name++)
+		{
+			if(table[name].reserved)
+			{
+				return name;
+			}
+		}
+
 		return map.begin()->first;
 	}
 
 	GLuint lastName()
 	{
-		return map.rbegin()->first;
+		if(!map.empty())
+		{
+			return map.rbegin()->first;
+		}
+
+		GLuint name = (GLuint)table.size() - 1;
+
+		while(!table[name].reserved)
+		{
+			name--;
+		}
+
+		return name;
+	}
+
+	// Advances to the next higher name in use, for visiting all objects
+	bool nextName(GLuint &name) const
+	{
+		for(GLuint next = name + 1; next > name && next < table.size(); next++)
+		{
+			if(table[next].reserved)
+			{
+				name = next;
+				return true;
+			}
+		}
+
+		auto element = map.upper_bound(name);
+
+		if(element == map.end())
+		{
+			return false;
+		}
+
+		name = element->first;
+		return true;
 	}
 
 	GLuint allocate(ObjectType *object = nullptr)
@@ -63,20 +108,53 @@ public:
 			name++;
 		}
 
-		map.insert({name, object});
-		freeName = name + 1;
+		insert(name, object);
 
 		return name;
 	}
 
 	bool isReserved(GLuint name) const
 	{
+		if(name < table.size())
+		{
+			return table[name].reserved;
+		}
+
 		return map.find(name) != map.end();
 	}
 
 	void insert(GLuint name, ObjectType *object)
 	{
-		map[name] = object;
+		if(name >= table.size() && name < 2 * table.size() + MIN_TABLE_SIZE)
+		{
+			grow(name);
+		}
+
+		if(name < table.size())
+		{
+			Slot &slot = table[name];
+
+			if(!slot.reserved)
+			{
+				slot.reserved = true;
+				count++;
+			}
+
+			slot.object = object;
+		}
+		else
+		{
+			auto element = map.insert({name, object});
+
+			if(element.second)
+			{
+				count++;
+			}
+			else
+			{
+				element.first->second = object;
+			}
+		}
 
 		if(name == freeName)
 		{
@@ -86,26 +164,51 @@ public:
 
 	ObjectType *remove(GLuint name)
 	{
-		auto element = map.find(name);
+		ObjectType *object = nullptr;
 
-		if(element != map.end())
+		if(name < table.size())
 		{
-			ObjectType *object = element->second;
-			map.erase(element);
+			Slot &slot = table[name];
 
-			if(name < freeName)
+			if(!slot.reserved)
 			{
-				freeName = name;
+				return nullptr;
 			}
 
-			return object;
+			object = slot.object;
+			slot.object = nullptr;
+			slot.reserved = false;
+		}
+		else
+		{
+			auto element = map.find(name);
+
+			if(element == map.end())
+			{
+				return nullptr;
+			}
+
+			object = element->second;
+			map.erase(element);
 		}
 
-		return nullptr;
+		count--;
+
+		if(name < freeName)
+		{
+			freeName = name;
+		}
+
+		return object;
 	}
 
 	ObjectType *find(GLuint name) const
 	{
+		if(name < table.size())
+		{
+			return table[name].object;   // Null when not reserved
+		}
+
 		auto element = map.find(name);
 
 		if(element == map.end())
@@ -117,9 +220,38 @@ public:
 	}
 
 private:
+	enum {MIN_TABLE_SIZE = 64};
+
+	// Extends the table to hold the name, moving the names it now covers out of the map
+	void grow(GLuint name)
+	{
+		size_t size = std::max<size_t>(name + 1, 2 * table.size());
+		size = std::max<size_t>(size, MIN_TABLE_SIZE);
+		table.resize(size);
+
+		while(!map.empty() && map.begin()->first < size)
+		{
+			Slot &slot = table[map.begin()->first];
+			slot.object = map.begin()->second;
+			slot.reserved = true;
+			map.erase(map.begin());
+		}
+	}
+
+	struct Slot
+	{
+		ObjectType *object = nullptr;
+		bool reserved = false;   // Allocated names may not have an object yet
+	};
+
+	// Names are mostly handed out densely by allocate(), so they index a table directly.
+	// Sparse names chosen by the application beyond its reach are kept in a map instead.
+	std::vector<Slot> table;
+
 	typedef std::map<GLuint, ObjectType*> Map;
-	Map map;
+	Map map;   // Only holds names >= table.size()
 
+	size_t count = 0;   // Names in use
 	GLuint freeName;   // Lowest known potentially free name
 };
 
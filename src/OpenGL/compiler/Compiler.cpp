@@ -17,30 +17,115 @@
 #include "AnalyzeCallDepth.h"
 #include "Initialize.h"
 #include "InitializeParseContext.h"
-#include "InitializeGlobals.h"
 #include "ParseHelper.h"
 #include "ValidateLimitations.h"
 
+#include <memory>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
 namespace
 {
 class TScopedPoolAllocator {
 public:
 	TScopedPoolAllocator(TPoolAllocator* allocator, bool pushPop)
-		: mAllocator(allocator), mPushPopAllocator(pushPop)
+		: mAllocator(allocator), mPushPopAllocator(pushPop), mPrevious(GetGlobalPoolAllocator())
 	{
 		if (mPushPopAllocator) mAllocator->push();
 		SetGlobalPoolAllocator(mAllocator);
 	}
 	~TScopedPoolAllocator()
 	{
-		SetGlobalPoolAllocator(nullptr);
+		SetGlobalPoolAllocator(mPrevious);
 		if (mPushPopAllocator) mAllocator->pop();
 	}
 
 private:
 	TPoolAllocator* mAllocator;
 	bool mPushPopAllocator;
+	TPoolAllocator* mPrevious;
+};
+
+// Built-in symbols for one shader type and set of resources, which all compilers
+// created for them share read-only. They live until the library is unloaded.
+struct TBuiltInSymbols
+{
+	GLenum shaderType;
+	ShBuiltInResources resources;
+	TPoolAllocator allocator;   // Declared before the table, which refers to its memory
+	TSymbolTable symbolTable;
+	int uniqueIdEnd;
 };
+
+std::mutex builtInSymbolsMutex;
+std::vector<std::unique_ptr<TBuiltInSymbols>> builtInSymbols;
+
+void InsertBuiltIns(GLenum shaderType, const ShBuiltInResources &resources, TSymbolTable &symbolTable)
+{
+	symbolTable.push();   // COMMON_BUILTINS
+	symbolTable.push();   // ESSL1_BUILTINS
+	symbolTable.push();   // ESSL3_BUILTINS
+
+	TPublicType integer;
+	integer.type = EbtInt;
+	integer.primarySize = 1;
+	integer.secondarySize = 1;
+	integer.array = false;
+
+	TPublicType floatingPoint;
+	floatingPoint.type = EbtFloat;
+	floatingPoint.primarySize = 1;
+	floatingPoint.secondarySize = 1;
+	floatingPoint.array = false;
+
+	switch(shaderType)
+	{
+	case GL_FRAGMENT_SHADER:
+		symbolTable.setDefaultPrecision(integer, EbpMedium);
+		break;
+	case GL_VERTEX_SHADER:
+		symbolTable.setDefaultPrecision(integer, EbpHigh);
+		symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
+		break;
+	default: assert(false && "Language not supported");
+	}
+
+	InsertBuiltInFunctions(shaderType, resources, symbolTable);
+
+	IdentifyBuiltIns(shaderType, resources, symbolTable);
+}
+
+const TBuiltInSymbols &GetBuiltInSymbols(GLenum shaderType, const ShBuiltInResources &resources)
+{
+	std::lock_guard<std::mutex> lock(builtInSymbolsMutex);
+
+	for(const auto &symbols : builtInSymbols)
+	{
+		// ShBuiltInResources only holds integers, so it has no padding to compare
+		if(symbols->shaderType == shaderType && memcmp(&symbols->resources, &resources, sizeof(ShBuiltInResources)) == 0)
+		{
+			return *symbols;
+		}
+	}
+
+	TBuiltInSymbols *symbols = new TBuiltInSymbols;
+	builtInSymbols.emplace_back(symbols);
+
+	symbols->shaderType = shaderType;
+	symbols->resources = resources;
+	symbols->allocator.push();
+
+	TScopedPoolAllocator scopedAlloc(&symbols->allocator, false);
+
+	// Number the built-ins from the start, so that every compile can continue after them
+	TSymbolTableLevel::resetUniqueId(0);
+	InsertBuiltIns(shaderType, resources, symbols->symbolTable);
+	symbols->symbolTable.finalizeBuiltIns();
+	symbols->uniqueIdEnd = TSymbolTableLevel::lastUniqueId();
+
+	return *symbols;
+}
 }  // namespace
 
 //
@@ -66,21 +151,22 @@ ShBuiltInResources::ShBuiltInResources()
 	OES_standard_derivatives = 0;
 	OES_fragment_precision_high = 0;
 	OES_EGL_image_external = 0;
+	EXT_draw_buffers = 0;
+	ARB_texture_rectangle = 0;
 
 	MaxCallStackDepth = UINT_MAX;
 }
 
 TCompiler::TCompiler(GLenum type)
 	: shaderType(type),
-	  maxCallStackDepth(UINT_MAX)
+	  maxCallStackDepth(UINT_MAX),
+	  builtInUniqueIdEnd(0)
 {
 	allocator.push();
-	SetGlobalPoolAllocator(&allocator);
 }
 
 TCompiler::~TCompiler()
 {
-	SetGlobalPoolAllocator(nullptr);
 	allocator.popAll();
 }
 
@@ -105,6 +191,12 @@ bool TCompiler::compile(const char* const shaderStrings[],
 	TScopedPoolAllocator scopedAlloc(&allocator, true);
 	clearResults();
 
+	// #extension directives of the previous shader don't carry over
+	ResetExtensionBehavior(extensionBehavior);
+
+	// User-defined symbols are numbered after the built-ins, whichever thread created those
+	TSymbolTableLevel::resetUniqueId(builtInUniqueIdEnd);
+
 	if (numStrings == 0)
 		return true;
 
@@ -158,43 +250,18 @@ bool TCompiler::compile(const char* const shaderStrings[],
 	while (!symbolTable.atBuiltInLevel())
 		symbolTable.pop();
 
+	SetGlobalParseContext(nullptr);
+
 	return success;
 }
 
 bool TCompiler::InitBuiltInSymbolTable(const ShBuiltInResources &resources)
 {
 	assert(symbolTable.isEmpty());
-	symbolTable.push();   // COMMON_BUILTINS
-	symbolTable.push();   // ESSL1_BUILTINS
-	symbolTable.push();   // ESSL3_BUILTINS
 
-	TPublicType integer;
-	integer.type = EbtInt;
-	integer.primarySize = 1;
-	integer.secondarySize = 1;
-	integer.array = false;
-
-	TPublicType floatingPoint;
-	floatingPoint.type = EbtFloat;
-	floatingPoint.primarySize = 1;
-	floatingPoint.secondarySize = 1;
-	floatingPoint.array = false;
-
-	switch(shaderType)
-	{
-	case GL_FRAGMENT_SHADER:
-		symbolTable.setDefaultPrecision(integer, EbpMedium);
-		break;
-	case GL_VERTEX_SHADER:
-		symbolTable.setDefaultPrecision(integer, EbpHigh);
-		symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
-		break;
-	default: assert(false && "Language not supported");
-	}
-
-	InsertBuiltInFunctions(shaderType, resources, symbolTable);
-
-	IdentifyBuiltIns(shaderType, resources, symbolTable);
+	const TBuiltInSymbols &builtIns = GetBuiltInSymbols(shaderType, resources);
+	symbolTable.shareBuiltIns(builtIns.symbolTable);
+	builtInUniqueIdEnd = builtIns.uniqueIdEnd;
 
 	return true;
 }
@@ -248,26 +315,3 @@ const TExtensionBehavior& TCompiler::getExtensionBehavior() const
 {
 	return extensionBehavior;
 }
-
-bool InitCompilerGlobals()
-{
-	if(!InitializePoolIndex())
-	{
-		assert(0 && "InitCompilerGlobals(): Failed to initalize global pool");
-		return false;
-	}
-
-	if(!InitializeParseContextIndex())
-	{
-		assert(0 && "InitCompilerGlobals(): Failed to initalize parse context");
-		return false;
-	}
-
-	return true;
-}
-
-void FreeCompilerGlobals()
-{
-	FreeParseContextIndex();
-	FreePoolIndex();
-}
@@ -111,6 +111,8 @@ private:
 	// Built-in symbol table for the given language, spec, and resources.
 	// It is preserved from compile-to-compile.
 	TSymbolTable symbolTable;
+	// Symbol IDs up to this one are taken by the built-ins.
+	int builtInUniqueIdEnd;
 	// Built-in extensions with default behavior.
 	TExtensionBehavior extensionBehavior;
 
@@ -123,7 +125,4 @@ private:
 	TPoolAllocator allocator;
 };
 
-bool InitCompilerGlobals();
-void FreeCompilerGlobals();
-
 #endif // _COMPILER_INCLUDED_
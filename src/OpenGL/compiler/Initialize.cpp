@@ -518,3 +518,11 @@ void InitExtensionBehavior(const ShBuiltInResources& resources,
 	if(resources.ARB_texture_rectangle)
 		extBehavior["GL_ARB_texture_rectangle"] = EBhUndefined;
 }
+
+void ResetExtensionBehavior(TExtensionBehavior& extBehavior)
+{
+	for(auto &extension : extBehavior)
+	{
+		extension.second = EBhUndefined;
+	}
+}
@@ -28,4 +28,7 @@ void IdentifyBuiltIns(GLenum shaderType,
 void InitExtensionBehavior(const ShBuiltInResources& resources,
                            TExtensionBehavior& extensionBehavior);
 
+// Returns the extensions to their default behavior before a compiler is reused.
+void ResetExtensionBehavior(TExtensionBehavior& extensionBehavior);
+
 #endif // _INITIALIZE_INCLUDED_
@@ -14,35 +14,15 @@
 
 #include "InitializeParseContext.h"
 
-#include "osinclude.h"
-
-OS_TLSIndex GlobalParseContextIndex = OS_INVALID_TLS_INDEX;
-
-bool InitializeParseContextIndex()
-{
-	assert(GlobalParseContextIndex == OS_INVALID_TLS_INDEX);
-
-	GlobalParseContextIndex = OS_AllocTLSIndex();
-	return GlobalParseContextIndex != OS_INVALID_TLS_INDEX;
-}
-
-void FreeParseContextIndex()
-{
-	assert(GlobalParseContextIndex != OS_INVALID_TLS_INDEX);
-
-	OS_FreeTLSIndex(GlobalParseContextIndex);
-	GlobalParseContextIndex = OS_INVALID_TLS_INDEX;
-}
+// The parse context of the compile running on this thread, if any
+static thread_local TParseContext *CurrentParseContext = nullptr;
 
 void SetGlobalParseContext(TParseContext* context)
 {
-	assert(GlobalParseContextIndex != OS_INVALID_TLS_INDEX);
-	OS_SetTLSValue(GlobalParseContextIndex, context);
+	CurrentParseContext = context;
 }
 
 TParseContext* GetGlobalParseContext()
 {
-	assert(GlobalParseContextIndex != OS_INVALID_TLS_INDEX);
-	return static_cast<TParseContext*>(OS_GetTLSValue(GlobalParseContextIndex));
+	return CurrentParseContext;
 }
-
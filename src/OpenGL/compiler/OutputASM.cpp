@@ -275,6 +275,11 @@ namespace glsl
 		}
 	}
 
+	ShaderVariable::ShaderVariable(GLenum type, GLenum precision, const std::string& name, int arraySize, int registerIndex) :
+		type(type), precision(precision), name(name), arraySize(arraySize), registerIndex(registerIndex)
+	{
+	}
+
 	Uniform::Uniform(const TType& type, const std::string &name, int registerIndex, int blockId, const BlockMemberInfo& blockMemberInfo) :
 		ShaderVariable(type, name, registerIndex), blockId(blockId), blockInfo(blockMemberInfo)
 	{
@@ -1282,6 +1287,11 @@ namespace glsl
 
 				if(emitScope == FUNCTION)
 				{
+					if(!node->getOptimize())   // The optimizations span functions, so they're off for the whole shader
+					{
+						shader->disableOptimization();
+					}
+
 					if(functionArray.size() > 1)   // No need for a label when there's only main()
 					{
 						Instruction *label = emit(sw::Shader::OPCODE_LABEL);
@@ -2073,6 +2083,7 @@ namespace glsl
 		{
 			TIntermTyped* src = src0->getAsTyped();
 			instruction->dst.partialPrecision = src && (src->getPrecision() <= EbpLow);
+			instruction->dst.mediumPrecision = src && (src->getPrecision() == EbpMedium);
 		}
 
 		source(instruction->src[0], src0, index0);
@@ -2656,6 +2667,11 @@ namespace glsl
 					}
 					else if(left->isArray() || left->isMatrix())
 					{
+						if(registerType(root) == sw::Shader::PARAMETER_TEMP)
+						{
+							shader->declareIndexedTemporaries(registerIndex(root), root->totalRegisterCount());
+						}
+
 						int scale = result->totalRegisterCount();
 
 						if(rel.type == sw::Shader::PARAMETER_VOID)   // Use the index register as the relative address directly
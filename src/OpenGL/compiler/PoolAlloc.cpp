@@ -17,40 +17,22 @@
 #ifndef _MSC_VER
 #include <stdint.h>
 #endif
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-#include "InitializeGlobals.h"
-#include "osinclude.h"
-
-OS_TLSIndex PoolIndex = OS_INVALID_TLS_INDEX;
-
-bool InitializePoolIndex()
-{
-	assert(PoolIndex == OS_INVALID_TLS_INDEX);
-
-	PoolIndex = OS_AllocTLSIndex();
-	return PoolIndex != OS_INVALID_TLS_INDEX;
-}
-
-void FreePoolIndex()
-{
-	assert(PoolIndex != OS_INVALID_TLS_INDEX);
-
-	OS_FreeTLSIndex(PoolIndex);
-	PoolIndex = OS_INVALID_TLS_INDEX;
-}
+// Each thread compiles with the allocator of the compiler it is currently running,
+// so compilers on different threads never share a pool.
+static thread_local TPoolAllocator *CurrentPoolAllocator = nullptr;
 
 TPoolAllocator* GetGlobalPoolAllocator()
 {
-	assert(PoolIndex != OS_INVALID_TLS_INDEX);
-	return static_cast<TPoolAllocator*>(OS_GetTLSValue(PoolIndex));
+	return CurrentPoolAllocator;
 }
 
 void SetGlobalPoolAllocator(TPoolAllocator* poolAllocator)
 {
-	assert(PoolIndex != OS_INVALID_TLS_INDEX);
-	OS_SetTLSValue(PoolIndex, poolAllocator);
+	CurrentPoolAllocator = poolAllocator;
 }
 
 //
@@ -31,7 +31,7 @@
 #define snprintf _snprintf
 #endif
 
-int TSymbolTableLevel::uniqueId = 0;
+thread_local int TSymbolTableLevel::uniqueId = 0;
 
 TType::TType(const TPublicType &p) :
 	type(p.type), precision(p.precision), qualifier(p.qualifier),
@@ -278,6 +278,33 @@ TSymbol *TSymbolTable::findBuiltIn(const TString &name, int shaderVersion) const
 	return 0;
 }
 
+void TSymbolTable::shareBuiltIns(const TSymbolTable &builtIns)
+{
+	assert(isEmpty() && builtIns.currentLevel() == LAST_BUILTIN_LEVEL);
+
+	table = builtIns.table;
+	precisionStack = builtIns.precisionStack;
+	mUnmangledBuiltinNames = builtIns.mUnmangledBuiltinNames;
+}
+
+void TSymbolTable::finalizeBuiltIns()
+{
+	for(int level = 0; level <= LAST_BUILTIN_LEVEL; level++)
+	{
+		for(auto &entry : *table[level])
+		{
+			if(entry.second->isVariable())
+			{
+				TType &type = static_cast<TVariable*>(entry.second)->getType();
+
+				type.getMangledName();
+				type.getObjectSize();
+				type.getDeepestStructNesting();
+			}
+		}
+	}
+}
+
 TSymbol::TSymbol(const TSymbol& copyOf)
 {
 	name = NewPoolTString(copyOf.name->c_str());
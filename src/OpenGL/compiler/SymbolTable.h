@@ -213,14 +213,28 @@ public:
 
 	TSymbol *find(const TString &name) const;
 
+	const_iterator begin() const { return level.begin(); }
+	const_iterator end() const { return level.end(); }
+
 	static int nextUniqueId()
 	{
 		return ++uniqueId;
 	}
 
+	static int lastUniqueId()
+	{
+		return uniqueId;
+	}
+
+	// Makes the following symbols on this thread continue after the given ID
+	static void resetUniqueId(int id)
+	{
+		uniqueId = id;
+	}
+
 protected:
 	tLevel level;
-	static int uniqueId;     // for unique identification in code generation
+	static thread_local int uniqueId;     // for unique identification in code generation, per compiler thread
 };
 
 enum ESymbolLevel
@@ -452,6 +466,14 @@ public:
 	TSymbol *find(const TString &name, int shaderVersion, bool *builtIn = nullptr, bool *sameScope = nullptr) const;
 	TSymbol *findBuiltIn(const TString &name, int shaderVersion) const;
 
+	// Makes the built-in levels of this table refer to those of the given one. The built-in symbols
+	// are shared read-only, and must stay allocated for as long as this table is used.
+	void shareBuiltIns(const TSymbolTable &builtIns);
+
+	// Computes the properties of built-in variables which would otherwise be cached on first use,
+	// so that compiles sharing the built-in levels only ever read them.
+	void finalizeBuiltIns();
+
 	TSymbolTableLevel *getOuterLevel() const
 	{
 		assert(currentLevel() >= 1);
@@ -28,11 +28,14 @@ class TranslatorASM : public TCompiler
 public:
     TranslatorASM(glsl::Shader *shaderObject, GLenum type);
 
+	// Compilers keep their built-in symbol table, so they can be reused for other shader objects
+	void setShaderObject(glsl::Shader *shader) { shaderObject = shader; }
+
 protected:
     virtual bool translate(TIntermNode* root);
 
 private:
-	glsl::Shader *const shaderObject;
+	glsl::Shader *shaderObject;
 };
 
 #endif  // COMPILER_TRANSLATORASM_H_
@@ -180,7 +180,7 @@ protected:
 			return;
 		}
 		MacroSet::const_iterator iter = mMacroSet->find(token->text);
-		std::string expression = iter != mMacroSet->end() ? "1" : "0";
+		const char *expression = iter != mMacroSet->end() ? "1" : "0";
 
 		if (paren)
 		{
@@ -414,6 +414,18 @@ void DirectiveParser::parseDefine(Token *token)
 		// list. Resetting it also allows us to reuse Token::equals() to
 		// compare macros.
 		token->location = SourceLocation();
+		if (macro->type == Macro::kTypeFunc)
+		{
+			int param = -1;
+			if (token->type == Token::IDENTIFIER)
+			{
+				Macro::Parameters::const_iterator iter =
+					std::find(macro->parameters.begin(), macro->parameters.end(), token->text);
+				if (iter != macro->parameters.end())
+					param = static_cast<int>(iter - macro->parameters.begin());
+			}
+			macro->replacementParams.push_back(param);
+		}
 		macro->replacements.push_back(*token);
 		mTokenizer->lex(token);
 	}
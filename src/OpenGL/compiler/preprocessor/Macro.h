@@ -15,9 +15,9 @@
 #ifndef COMPILER_PREPROCESSOR_MACRO_H_
 #define COMPILER_PREPROCESSOR_MACRO_H_
 
-#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace pp
@@ -47,9 +47,12 @@ struct Macro
     std::string name;
     Parameters parameters;
     Replacements replacements;
+    // Index of the parameter each replacement token of a function-like macro
+    // refers to, or -1 if the token is not a parameter.
+    std::vector<int> replacementParams;
 };
 
-typedef std::map<std::string, std::shared_ptr<Macro>> MacroSet;
+typedef std::unordered_map<std::string, std::shared_ptr<Macro>> MacroSet;
 
 void PredefineMacro(MacroSet *macroSet, const char *name, int value);
 
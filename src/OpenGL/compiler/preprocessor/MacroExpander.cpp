@@ -49,7 +49,8 @@ class TokenLexer : public Lexer
 		}
 		else
 		{
-			*token = *mIter++;
+			// Each token is only lexed once, so it can be moved out.
+			*token = std::move(*mIter++);
 		}
 	}
 
@@ -57,7 +58,7 @@ class TokenLexer : public Lexer
 	PP_DISALLOW_COPY_AND_ASSIGN(TokenLexer);
 
 	TokenVector mTokens;
-	TokenVector::const_iterator mIter;
+	TokenVector::iterator mIter;
 };
 
 }  // anonymous namespace
@@ -147,7 +148,7 @@ void MacroExpander::lex(Token *token)
 				break;
 			}
 			auto iter = mMacroSet->find(token->text);
-			std::string expression = iter != mMacroSet->end() ? "1" : "0";
+			const char *expression = iter != mMacroSet->end() ? "1" : "0";
 
 			if (paren)
 			{
@@ -201,7 +202,7 @@ void MacroExpander::getToken(Token *token)
 {
 	if (mReserveToken.get())
 	{
-		*token = *mReserveToken;
+		*token = std::move(*mReserveToken);
 		mReserveToken.reset();
 		return;
 	}
@@ -214,7 +215,8 @@ void MacroExpander::getToken(Token *token)
 
 	if (!mContextStack.empty())
 	{
-		*token = mContextStack.back()->get();
+		// Tokens are moved out of the context. The rare ungetToken() puts them back.
+		*token = std::move(mContextStack.back()->get());
 	}
 	else
 	{
@@ -229,7 +231,7 @@ void MacroExpander::ungetToken(const Token &token)
 	{
 		MacroContext *context = mContextStack.back();
 		context->unget();
-		assert(context->replacements[context->index] == token);
+		context->replacements[context->index] = token;
 	}
 	else
 	{
@@ -412,7 +414,7 @@ bool MacroExpander::collectMacroArgs(const Macro &macro,
 			// Initial whitespace is not part of the argument.
 			if (arg.empty())
 				token.setHasLeadingSpace(false);
-			arg.push_back(token);
+			arg.push_back(std::move(token));
 		}
 	}
 
@@ -438,6 +440,8 @@ bool MacroExpander::collectMacroArgs(const Macro &macro,
 	size_t numTokens = 0;
 	for (auto &arg : *args)
 	{
+		// Expansion rarely makes an argument shorter, so reserve its current length.
+		std::size_t argSize = arg.size();
 		TokenLexer lexer(&arg);
 		if (mAllowedMacroExpansionDepth < 1)
 		{
@@ -447,11 +451,11 @@ bool MacroExpander::collectMacroArgs(const Macro &macro,
 		}
 		MacroExpander expander(&lexer, mMacroSet, mDiagnostics, mParseDefined, mAllowedMacroExpansionDepth - 1);
 
-		arg.clear();
+		arg.reserve(argSize);
 		expander.lex(&token);
 		while (token.type != Token::LAST)
 		{
-			arg.push_back(token);
+			arg.push_back(std::move(token));
 			expander.lex(&token);
 			numTokens++;
 			if (numTokens + mTotalTokensInContexts > kMaxContextTokens)
@@ -468,6 +472,13 @@ void MacroExpander::replaceMacroParams(const Macro &macro,
                                        const std::vector<MacroArg> &args,
                                        std::vector<Token> *replacements)
 {
+	std::size_t size = 0;
+	for (int iArg : macro.replacementParams)
+	{
+		size += iArg < 0 ? 1 : args[iArg].size();
+	}
+	replacements->reserve(size);
+
 	for (std::size_t i = 0; i < macro.replacements.size(); ++i)
 	{
 		if (!replacements->empty() &&
@@ -485,18 +496,13 @@ void MacroExpander::replaceMacroParams(const Macro &macro,
 			continue;
 		}
 
-		// TODO(alokp): Optimize this.
-		// There is no need to search for macro params every time.
-		// The param index can be cached with the replacement token.
-		Macro::Parameters::const_iterator iter =
-			std::find(macro.parameters.begin(), macro.parameters.end(), repl.text);
-		if (iter == macro.parameters.end())
+		int iArg = macro.replacementParams[i];
+		if (iArg < 0)
 		{
 			replacements->push_back(repl);
 			continue;
 		}
 
-		std::size_t iArg = std::distance(macro.parameters.begin(), iter);
 		const MacroArg &arg = args[iArg];
 		if (arg.empty())
 		{
@@ -523,7 +529,7 @@ bool MacroExpander::MacroContext::empty() const
 	return index == replacements.size();
 }
 
-const Token &MacroExpander::MacroContext::get()
+Token &MacroExpander::MacroContext::get()
 {
 	return replacements[index++];
 }
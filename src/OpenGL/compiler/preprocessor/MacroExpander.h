@@ -62,7 +62,7 @@ private:
 		MacroContext();
 		~MacroContext();
 		bool empty() const;
-		const Token &get();
+		Token &get();
 		void unget();
 
 		std::shared_ptr<Macro> macro;
@@ -39,6 +39,10 @@ public:
 	virtual EGLint getConfigID() const = 0;
 	virtual void finish() = 0;
 	virtual void blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface *dest, const sw::SliceRect &dRect) = 0;
+	virtual bool getPipelineProfile(EGLint attribute, EGLint *value) = 0;   // EGL_SWIFTSHADER_pipeline_profile attributes
+	virtual bool getMemoryUsage(EGLint attribute, EGLint *value) = 0;       // EGL_SWIFTSHADER_memory_usage attributes
+	virtual void setScheduling(EGLint priority, EGLint cpuShare) = 0;      // EGL_IMG_context_priority and EGL_SWIFTSHADER_context_qos
+	virtual bool getScheduling(EGLint attribute, EGLint *value) = 0;
 
 	Display *getDisplay() const { return display; }
 
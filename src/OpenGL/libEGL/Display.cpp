@@ -24,6 +24,7 @@
 #include "common/Image.hpp"
 #include "common/debug.h"
 #include "Common/MutexLock.hpp"
+#include "Main/FrameBufferYUV.hpp"
 
 #ifdef __ANDROID__
 #include <system/window.h>
@@ -64,23 +65,14 @@ Display *Display::get(EGLDisplay dpy)
 		return nullptr;
 	}
 
-	static void *nativeDisplay = nullptr;
-
-	#if defined(USE_X11)
-		// Even if the application provides a native display handle, we open (and close) our own connection
-		if(!nativeDisplay && dpy != HEADLESS_DISPLAY && libX11 && libX11->XOpenDisplay)
-		{
-			nativeDisplay = libX11->XOpenDisplay(NULL);
-		}
-	#endif
-
-	static DisplayImplementation display(dpy, nativeDisplay);
+	static DisplayImplementation display(dpy, nullptr);
 
 	return &display;
 }
 
 Display::Display(EGLDisplay eglDisplay, void *nativeDisplay) : eglDisplay(eglDisplay), nativeDisplay(nativeDisplay)
 {
+	nativeDisplayOpened = (nativeDisplay != nullptr);
 	mMinSwapInterval = 1;
 	mMaxSwapInterval = 1;
 }
@@ -210,6 +202,12 @@ bool Display::initialize()
 		return false;
 	}
 
+	// Compiles common routines while the application creates its surfaces and contexts
+	if(libGLESv2)
+	{
+		libGLESv2->warmUpRoutines(renderTargetFormats, sizeof(renderTargetFormats) / sizeof(sw::Format));
+	}
+
 	return true;
 }
 
@@ -338,7 +336,9 @@ EGLSurface Display::createWindowSurface(EGLNativeWindowType window, EGLConfig co
 
 EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribList, EGLClientBuffer clientBuffer)
 {
-	EGLint width = -1, height = -1, ioSurfacePlane = -1;
+	EGLint width = -1, height = -1, ioSurfacePlane = -1, fileDescriptor = -1;
+	EGLint yuvFileDescriptor = -1, yuvFrameCount = 3;
+	sw::YUVLayout yuvLayout = sw::YUV_NV12;
 	EGLenum textureFormat = EGL_NO_TEXTURE;
 	EGLenum textureTarget = EGL_NO_TEXTURE;
 	EGLenum clientBufferFormat = EGL_NO_TEXTURE;
@@ -407,6 +407,40 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 				}
 				ioSurfacePlane = attribList[1];
 				break;
+			case EGL_FILE_DESCRIPTOR_SWIFTSHADER:
+				#if defined(__APPLE__)
+					return error(EGL_BAD_ATTRIBUTE, EGL_NO_SURFACE);   // Client buffers are IOSurfaces
+				#else
+					if(attribList[1] < 0)
+					{
+						return error(EGL_BAD_ATTRIBUTE, EGL_NO_SURFACE);
+					}
+					fileDescriptor = attribList[1];
+				#endif
+				break;
+			case EGL_YUV_OUTPUT_FILE_DESCRIPTOR_SWIFTSHADER:
+				if(attribList[1] < 0)
+				{
+					return error(EGL_BAD_ATTRIBUTE, EGL_NO_SURFACE);
+				}
+				yuvFileDescriptor = attribList[1];
+				break;
+			case EGL_YUV_OUTPUT_LAYOUT_SWIFTSHADER:
+				switch(attribList[1])
+				{
+				case EGL_YUV_OUTPUT_NV12_SWIFTSHADER: yuvLayout = sw::YUV_NV12; break;
+				case EGL_YUV_OUTPUT_I420_SWIFTSHADER: yuvLayout = sw::YUV_I420; break;
+				default:
+					return error(EGL_BAD_ATTRIBUTE, EGL_NO_SURFACE);
+				}
+				break;
+			case EGL_YUV_OUTPUT_FRAME_COUNT_SWIFTSHADER:
+				if(attribList[1] < 1)
+				{
+					return error(EGL_BAD_ATTRIBUTE, EGL_NO_SURFACE);
+				}
+				yuvFrameCount = attribList[1];
+				break;
 			case EGL_TEXTURE_TARGET:
 				switch(attribList[1])
 				{
@@ -459,6 +493,18 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 		return error(EGL_BAD_MATCH, EGL_NO_SURFACE);
 	}
 
+	// The file holds the pixels as they're rendered, which can't be multisampled or bound as a texture
+	if(fileDescriptor >= 0 && (clientBuffer || configuration->mSamples > 1 || textureFormat != EGL_NO_TEXTURE))
+	{
+		return error(EGL_BAD_MATCH, EGL_NO_SURFACE);
+	}
+
+	// Chroma is subsampled in both directions, and converted from the back buffer's color channels
+	if(yuvFileDescriptor >= 0 && (clientBuffer || width % 2 != 0 || height % 2 != 0 || !sw::FrameBufferYUV::isSupported(configuration->mRenderTargetFormat)))
+	{
+		return error(EGL_BAD_MATCH, EGL_NO_SURFACE);
+	}
+
 	if(clientBuffer)
 	{
 		switch(clientBufferType)
@@ -545,7 +591,7 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 		}
 	}
 
-	Surface *surface = new PBufferSurface(this, configuration, width, height, textureFormat, textureTarget, clientBufferFormat, clientBufferType, largestPBuffer, clientBuffer, ioSurfacePlane);
+	Surface *surface = new PBufferSurface(this, configuration, width, height, textureFormat, textureTarget, clientBufferFormat, clientBufferType, largestPBuffer, clientBuffer, ioSurfacePlane, fileDescriptor, yuvFileDescriptor, yuvLayout, yuvFrameCount);
 
 	if(!surface->initialize())
 	{
@@ -559,7 +605,7 @@ EGLSurface Display::createPBufferSurface(EGLConfig config, const EGLint *attribL
 	return success(surface);
 }
 
-EGLContext Display::createContext(EGLConfig configHandle, const egl::Context *shareContext, EGLint clientVersion)
+EGLContext Display::createContext(EGLConfig configHandle, const egl::Context *shareContext, EGLint clientVersion, EGLint priority, EGLint cpuShare)
 {
 	const egl::Config *config = mConfigSet.get(configHandle);
 	egl::Context *context = nullptr;
@@ -589,6 +635,7 @@ EGLContext Display::createContext(EGLConfig configHandle, const egl::Context *sh
 		return error(EGL_BAD_ALLOC, EGL_NO_CONTEXT);
 	}
 
+	context->setScheduling(priority, cpuShare);
 	context->addRef();
 	mContextSet.insert(context);
 
@@ -678,10 +725,12 @@ bool Display::isValidWindow(EGLNativeWindowType window)
 		}
 		return true;
 	#elif defined(USE_X11)
+		::Display *nativeDisplay = (::Display*)getNativeDisplay();
+
 		if(nativeDisplay)
 		{
 			XWindowAttributes windowAttributes;
-			Status status = libX11->XGetWindowAttributes((::Display*)nativeDisplay, window, &windowAttributes);
+			Status status = libX11->XGetWindowAttributes(nativeDisplay, window, &windowAttributes);
 
 			return status != 0;
 		}
@@ -738,6 +787,23 @@ EGLDisplay Display::getEGLDisplay() const
 
 void *Display::getNativeDisplay() const
 {
+	#if defined(USE_X11)
+		// Even if the application provides a native display handle, we open (and close) our own connection.
+		// Deferred until a window needs it, so clients which only render offscreen never load the X11
+		// libraries. Only attempted once, so servers without an X server don't retry on every call.
+		LockGuard lock(nativeDisplayMutex);
+
+		if(!nativeDisplayOpened && eglDisplay != HEADLESS_DISPLAY)
+		{
+			if(libX11 && libX11->XOpenDisplay)
+			{
+				nativeDisplay = libX11->XOpenDisplay(NULL);
+			}
+
+			nativeDisplayOpened = true;
+		}
+	#endif
+
 	return nativeDisplay;
 }
 
@@ -846,7 +912,7 @@ sw::Format Display::getDisplayFormat() const
 		// No framebuffer device found, or we're in user space
 		return sw::FORMAT_X8B8G8R8;
 	#elif defined(USE_X11)
-		if(nativeDisplay)
+		if(nativeDisplay)   // Not connected to just for this, the configs only use it for EGL_FRAMEBUFFER_TARGET_ANDROID
 		{
 			Screen *screen = libX11->XDefaultScreenOfDisplay((::Display*)nativeDisplay);
 			unsigned int bpp = libX11->XPlanesOfScreen(screen);
@@ -35,6 +35,90 @@
 #define EGL_TEXTURE_INTERNAL_FORMAT_ANGLE 0x345D
 #endif // EGL_ANGLE_iosurface_client_buffer
 
+#ifndef EGL_SWIFTSHADER_file_backed_pbuffer
+#define EGL_SWIFTSHADER_file_backed_pbuffer 1
+#define EGL_FILE_DESCRIPTOR_SWIFTSHADER 0x3490   // Pbuffer attribute, renders directly into the file opened for reading and writing
+#endif // EGL_SWIFTSHADER_file_backed_pbuffer
+
+#ifndef EGL_SWIFTSHADER_pipeline_profile
+#define EGL_SWIFTSHADER_pipeline_profile 1
+#define EGL_PIPELINE_PROFILE_SWIFTSHADER 0x3491                      // Context attribute, EGL_TRUE when pixel pipeline profiling is enabled in SwiftShader.ini
+#define EGL_PIPELINE_DRAW_CALLS_SWIFTSHADER 0x3492                   // Profiled draw calls since the context was created
+#define EGL_PIPELINE_RASTERIZATION_SWIFTSHADER 0x3493                // Shares of the pixel routine time, in per mille
+#define EGL_PIPELINE_DEPTH_STENCIL_SWIFTSHADER 0x3494
+#define EGL_PIPELINE_INTERPOLATION_SWIFTSHADER 0x3495
+#define EGL_PIPELINE_SHADER_SWIFTSHADER 0x3496
+#define EGL_PIPELINE_TEXTURE_SWIFTSHADER 0x3497
+#define EGL_PIPELINE_RASTER_OPERATIONS_SWIFTSHADER 0x3498
+#define EGL_PIPELINE_ROP_PIXELS_SWIFTSHADER 0x3499                   // Pixel counts per profiled draw call, on average
+#define EGL_PIPELINE_TEXTURE_PIXELS_SWIFTSHADER 0x349A
+#define EGL_PIPELINE_COMPRESSED_TEXTURE_PIXELS_SWIFTSHADER 0x349B
+#define EGL_PIPELINE_EARLY_DEPTH_REJECTS_SWIFTSHADER 0x349C          // Quads per profiled draw call, on average
+#define EGL_PIPELINE_COHERENT_BRANCHES_SWIFTSHADER 0x349D
+#define EGL_PIPELINE_DIVERGENT_BRANCHES_SWIFTSHADER 0x349E
+#endif // EGL_SWIFTSHADER_pipeline_profile
+
+#ifndef EGL_SWIFTSHADER_context_qos
+#define EGL_SWIFTSHADER_context_qos 1
+#define EGL_CPU_SHARE_SWIFTSHADER 0x349F      // Context attribute, percentage of the renderer threads the context may use while other contexts wait for them
+#define EGL_WORKER_TIME_SWIFTSHADER 0x34A0    // Milliseconds the renderer threads worked for the context since it was created
+#define EGL_WORKER_SHARE_SWIFTSHADER 0x34A1   // Share of the renderer threads the context used recently, in per mille
+#endif // EGL_SWIFTSHADER_context_qos
+
+#ifndef EGL_SWIFTSHADER_performance_profile
+#define EGL_SWIFTSHADER_performance_profile 1
+// Process wide settings for all contexts, which replace those of SwiftShader.ini. SWIFTSHADER_<SECTION>_<NAME>
+// environment variables still take precedence. Contexts apply them at their next draw call, without
+// regenerating routines unless the transcendental precision or raster tile height changed.
+#define EGL_THREAD_COUNT_SWIFTSHADER 0x34A2                  // Renderer threads per context, 0 for the process affinity, -1 for all cores
+#define EGL_DRAW_QUEUE_SIZE_SWIFTSHADER 0x34A3               // Draw calls in flight before the application waits
+#define EGL_RASTER_TILE_HEIGHT_SWIFTSHADER 0x34A4            // Rows per rasterization task, in pixels
+#define EGL_VERTEX_ROUTINE_CACHE_SIZE_SWIFTSHADER 0x34A5     // Generated routines kept for reuse
+#define EGL_PIXEL_ROUTINE_CACHE_SIZE_SWIFTSHADER 0x34A6
+#define EGL_SETUP_ROUTINE_CACHE_SIZE_SWIFTSHADER 0x34A7
+#define EGL_VERTEX_CACHE_SIZE_SWIFTSHADER 0x34A8             // Post-transform vertices cached per thread
+#define EGL_TEXTURE_SAMPLE_QUALITY_SWIFTSHADER 0x34A9        // 0 point, 1 linear, 2 anisotropic, 3 cheaper anisotropic
+#define EGL_MIPMAP_QUALITY_SWIFTSHADER 0x34AA                // 0 point, 1 linear
+#define EGL_TRANSCENDENTAL_PRECISION_SWIFTSHADER 0x34AB      // 0 approximate up to 4 IEEE
+#define EGL_CONCURRENT_COMPILATION_SWIFTSHADER 0x34AC        // Boolean, generate vertex and setup routines on separate threads
+#define EGL_TIERED_COMPILATION_SWIFTSHADER 0x34AD            // Draws after which quickly generated routines get optimized, 0 to optimize right away
+#define EGL_DRAW_MERGING_SWIFTSHADER 0x34BF                  // Boolean, append draws which continue the last draw call to it
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLSETPERFORMANCEPROFILESWIFTSHADERPROC) (const EGLint *attrib_list);   // Null or empty to clear the settings
+#ifdef EGL_EGLEXT_PROTOTYPES
+extern "C" EGLAPI EGLBoolean EGLAPIENTRY eglSetPerformanceProfileSWIFTSHADER(const EGLint *attrib_list);
+#endif
+#endif // EGL_SWIFTSHADER_performance_profile
+
+#ifndef EGL_SWIFTSHADER_present_statistics
+#define EGL_SWIFTSHADER_present_statistics 1
+#define EGL_PRESENTED_FRAMES_SWIFTSHADER 0x34AE   // Surface attribute, frames shown in the window or written to the YUV output since the surface was created
+#define EGL_DROPPED_FRAMES_SWIFTSHADER 0x34AF     // Frames replaced by newer ones before they were shown, with a swap interval of 0
+#endif // EGL_SWIFTSHADER_present_statistics
+
+#ifndef EGL_SWIFTSHADER_yuv_output
+#define EGL_SWIFTSHADER_yuv_output 1
+#define EGL_YUV_OUTPUT_FILE_DESCRIPTOR_SWIFTSHADER 0x34B0   // Pbuffer attribute, file which eglSwapBuffers converts frames into, as 4:2:0 limited range BT.601
+#define EGL_YUV_OUTPUT_LAYOUT_SWIFTSHADER 0x34B1            // EGL_YUV_OUTPUT_NV12_SWIFTSHADER (default) or EGL_YUV_OUTPUT_I420_SWIFTSHADER, without padding
+#define EGL_YUV_OUTPUT_NV12_SWIFTSHADER 0x34B2
+#define EGL_YUV_OUTPUT_I420_SWIFTSHADER 0x34B3
+#define EGL_YUV_OUTPUT_FRAME_COUNT_SWIFTSHADER 0x34B4       // Frames in the ring at the start of the file, 3 by default. Frame n of
+                                                            // EGL_PRESENTED_FRAMES_SWIFTSHADER is at index (n - 1) % count.
+#endif // EGL_SWIFTSHADER_yuv_output
+
+#ifndef EGL_SWIFTSHADER_memory_usage
+#define EGL_SWIFTSHADER_memory_usage 1
+#define EGL_MEMORY_GENERAL_SWIFTSHADER 0x34B5        // Context attributes, kibibytes currently allocated by the context's library
+#define EGL_MEMORY_SURFACE_SWIFTSHADER 0x34B6        // for each category of sw::MemoryCategory, in that order
+#define EGL_MEMORY_BUFFER_SWIFTSHADER 0x34B7
+#define EGL_MEMORY_RENDERER_SWIFTSHADER 0x34B8
+#define EGL_MEMORY_ROUTINE_SWIFTSHADER 0x34B9
+#define EGL_PEAK_MEMORY_GENERAL_SWIFTSHADER 0x34BA   // The most allocated at once since the library was loaded, or since
+#define EGL_PEAK_MEMORY_SURFACE_SWIFTSHADER 0x34BB   // the peaks were reset on the SwiftConfig page
+#define EGL_PEAK_MEMORY_BUFFER_SWIFTSHADER 0x34BC
+#define EGL_PEAK_MEMORY_RENDERER_SWIFTSHADER 0x34BD
+#define EGL_PEAK_MEMORY_ROUTINE_SWIFTSHADER 0x34BE
+#endif // EGL_SWIFTSHADER_memory_usage
+
 namespace egl
 {
 	class Surface;
@@ -61,7 +145,7 @@ namespace egl
 
 		EGLSurface createWindowSurface(EGLNativeWindowType window, EGLConfig config, const EGLAttrib *attribList);
 		EGLSurface createPBufferSurface(EGLConfig config, const EGLint *attribList, EGLClientBuffer clientBuffer = nullptr);
-		EGLContext createContext(EGLConfig configHandle, const Context *shareContext, EGLint clientVersion);
+		EGLContext createContext(EGLConfig configHandle, const Context *shareContext, EGLint clientVersion, EGLint priority, EGLint cpuShare);
 		EGLSyncKHR createSync(Context *context);
 
 		void destroySurface(Surface *surface);
@@ -90,7 +174,9 @@ namespace egl
 		sw::Format getDisplayFormat() const;
 
 		const EGLDisplay eglDisplay;
-		void *const nativeDisplay;
+		mutable sw::MutexLock nativeDisplayMutex;
+		mutable void *nativeDisplay;   // Opened by the first getNativeDisplay() call
+		mutable bool nativeDisplayOpened;
 
 		EGLint mMaxSwapInterval;
 		EGLint mMinSwapInterval;
@@ -35,6 +35,7 @@
 #endif
 
 #include <algorithm>
+#include <vector>
 
 namespace gl
 {
@@ -60,24 +61,27 @@ Surface::~Surface()
 
 bool Surface::initialize()
 {
-	ASSERT(!backBuffer && !depthStencil);
+	ASSERT(!depthStencil);
 
-	if(libGLESv2)
+	if(!backBuffer)   // Unless the derived surface provided it
 	{
-		if(clientBuffer)
+		if(libGLESv2)
 		{
-			backBuffer = libGLESv2->createBackBufferFromClientBuffer(
-				egl::ClientBuffer(width, height, getClientBufferFormat(), clientBuffer, clientBufferPlane));
+			if(clientBuffer)
+			{
+				backBuffer = libGLESv2->createBackBufferFromClientBuffer(
+					egl::ClientBuffer(width, height, getClientBufferFormat(), clientBuffer, clientBufferPlane));
+			}
+			else
+			{
+				backBuffer = libGLESv2->createBackBuffer(width, height, config->mRenderTargetFormat, config->mSamples);
+			}
 		}
-		else
+		else if(libGLES_CM)
 		{
-			backBuffer = libGLESv2->createBackBuffer(width, height, config->mRenderTargetFormat, config->mSamples);
+			backBuffer = libGLES_CM->createBackBuffer(width, height, config->mRenderTargetFormat, config->mSamples);
 		}
 	}
-	else if(libGLES_CM)
-	{
-		backBuffer = libGLES_CM->createBackBuffer(width, height, config->mRenderTargetFormat, config->mSamples);
-	}
 
 	if(!backBuffer)
 	{
@@ -310,21 +314,49 @@ bool WindowSurface::initialize()
 	return checkForResize();
 }
 
-void WindowSurface::swap()
+void WindowSurface::swap(const EGLint *rects, EGLint count)
 {
 	if(backBuffer && frameBuffer)
 	{
-		frameBuffer->flip(backBuffer);
+		std::vector<sw::Rect> damage(count);
+
+		for(EGLint i = 0; i < count; i++)
+		{
+			const EGLint *rect = &rects[4 * i];
+			damage[i] = sw::Rect(rect[0], rect[1], rect[0] + rect[2], rect[1] + rect[3]);
+		}
+
+		frameBuffer->present(backBuffer, damage.data(), count);
 
 		checkForResize();
 	}
 }
 
+void WindowSurface::setSwapInterval(EGLint interval)
+{
+	Surface::setSwapInterval(interval);
+
+	if(frameBuffer)
+	{
+		frameBuffer->setSwapInterval(swapInterval);
+	}
+}
+
 EGLNativeWindowType WindowSurface::getWindowHandle() const
 {
 	return window;
 }
 
+EGLint WindowSurface::getPresentedFrames() const
+{
+	return presentedFrames + (frameBuffer ? frameBuffer->getPresentedFrames() : 0);
+}
+
+EGLint WindowSurface::getDroppedFrames() const
+{
+	return droppedFrames + (frameBuffer ? frameBuffer->getDroppedFrames() : 0);
+}
+
 bool WindowSurface::checkForResize()
 {
 	#if defined(_WIN32)
@@ -385,10 +417,26 @@ bool WindowSurface::checkForResize()
 
 void WindowSurface::deleteResources()
 {
-	delete frameBuffer;
-	frameBuffer = nullptr;
+	if(frameBuffer)
+	{
+		frameBuffer->finishPresents();
+
+		presentedFrames += frameBuffer->getPresentedFrames();
+		droppedFrames += frameBuffer->getDroppedFrames();
+	}
+
+	if(directBackBuffer && backBuffer)
+	{
+		// Rendering into the frame buffer's memory has to finish before it goes away
+		backBuffer->lockInternal(0, 0, 0, sw::LOCK_READONLY, sw::PUBLIC);
+		backBuffer->unlockInternal();
+	}
 
 	Surface::deleteResources();
+	directBackBuffer = false;
+
+	delete frameBuffer;
+	frameBuffer = nullptr;
 }
 
 bool WindowSurface::reset(int backBufferWidth, int backBufferHeight)
@@ -415,6 +463,17 @@ bool WindowSurface::reset(int backBufferWidth, int backBufferHeight)
 			deleteResources();
 			return error(EGL_BAD_ALLOC, false);
 		}
+
+		frameBuffer->setSwapInterval(swapInterval);
+
+		// Render into the window's memory when it's laid out like the back buffer, so swaps don't copy it
+		void *directBuffer = (libGLESv2 && config->mSamples <= 1) ? frameBuffer->getDirectBuffer(config->mRenderTargetFormat) : nullptr;
+
+		if(directBuffer)
+		{
+			backBuffer = libGLESv2->createBackBufferFromClientBuffer(egl::ClientBuffer(width, height, config->mRenderTargetFormat, directBuffer, 0));
+			directBackBuffer = (backBuffer != nullptr);
+		}
 	}
 
 	return Surface::initialize();
@@ -423,8 +482,10 @@ bool WindowSurface::reset(int backBufferWidth, int backBufferHeight)
 PBufferSurface::PBufferSurface(Display *display, const Config *config, EGLint width, EGLint height,
                                EGLenum textureFormat, EGLenum textureTarget, EGLenum clientBufferFormat,
                                EGLenum clientBufferType, EGLBoolean largestPBuffer, EGLClientBuffer clientBuffer,
-                               EGLint clientBufferPlane)
-	: Surface(display, config)
+                               EGLint clientBufferPlane, EGLint fileDescriptor, EGLint yuvFileDescriptor,
+                               sw::YUVLayout yuvLayout, EGLint yuvFrameCount)
+	: Surface(display, config), fileDescriptor(fileDescriptor),
+	  yuvFileDescriptor(yuvFileDescriptor), yuvLayout(yuvLayout), yuvFrameCount(yuvFrameCount)
 {
 	this->width = width;
 	this->height = height;
@@ -442,9 +503,73 @@ PBufferSurface::~PBufferSurface()
 	PBufferSurface::deleteResources();
 }
 
-void PBufferSurface::swap()
+bool PBufferSurface::initialize()
 {
-	// No effect
+	if(fileDescriptor >= 0)
+	{
+		if(!libGLESv2)
+		{
+			return error(EGL_BAD_MATCH, false);
+		}
+
+		// Rendering writes straight through the page cache, so the file holds the image once rendering finishes
+		backBuffer = libGLESv2->createBackBufferFromClientBuffer(egl::ClientBuffer(width, height, config->mRenderTargetFormat, fileDescriptor));
+
+		if(!backBuffer)
+		{
+			ERR("Could not map the pbuffer's file");
+			return error(EGL_BAD_ALLOC, false);
+		}
+	}
+
+	if(yuvFileDescriptor >= 0)
+	{
+		if(libGLESv2)
+		{
+			frameBuffer = libGLESv2->createFrameBufferYUV(yuvFileDescriptor, yuvLayout, yuvFrameCount, width, height);
+		}
+		else if(libGLES_CM)
+		{
+			frameBuffer = libGLES_CM->createFrameBufferYUV(yuvFileDescriptor, yuvLayout, yuvFrameCount, width, height);
+		}
+
+		if(!frameBuffer)
+		{
+			ERR("Could not map the pbuffer's YUV output file");
+			deleteResources();
+			return error(EGL_BAD_ALLOC, false);
+		}
+
+		frameBuffer->setSwapInterval(swapInterval);
+	}
+
+	return Surface::initialize();
+}
+
+void PBufferSurface::swap(const EGLint *rects, EGLint count)
+{
+	if(backBuffer && frameBuffer)
+	{
+		std::vector<sw::Rect> damage(count);
+
+		for(EGLint i = 0; i < count; i++)
+		{
+			const EGLint *rect = &rects[4 * i];
+			damage[i] = sw::Rect(rect[0], rect[1], rect[0] + rect[2], rect[1] + rect[3]);
+		}
+
+		frameBuffer->present(backBuffer, damage.data(), count);
+	}
+}
+
+void PBufferSurface::setSwapInterval(EGLint interval)
+{
+	Surface::setSwapInterval(interval);
+
+	if(frameBuffer)
+	{
+		frameBuffer->setSwapInterval(swapInterval);
+	}
 }
 
 EGLNativeWindowType PBufferSurface::getWindowHandle() const
@@ -454,9 +579,27 @@ EGLNativeWindowType PBufferSurface::getWindowHandle() const
 	return 0;
 }
 
+EGLint PBufferSurface::getPresentedFrames() const
+{
+	return frameBuffer ? frameBuffer->getPresentedFrames() : 0;
+}
+
+EGLint PBufferSurface::getDroppedFrames() const
+{
+	return frameBuffer ? frameBuffer->getDroppedFrames() : 0;
+}
+
 void PBufferSurface::deleteResources()
 {
+	if(frameBuffer)
+	{
+		frameBuffer->finishPresents();
+	}
+
 	Surface::deleteResources();
+
+	delete frameBuffer;
+	frameBuffer = nullptr;
 }
 
 }
@@ -23,6 +23,7 @@
 #include "common/Surface.hpp"
 
 #include "Main/FrameBuffer.hpp"
+#include "Main/FrameBufferYUV.hpp"
 
 #include <EGL/egl.h>
 
@@ -35,7 +36,7 @@ class Surface : public gl::Surface, public gl::Object
 {
 public:
 	virtual bool initialize();
-	virtual void swap() = 0;
+	virtual void swap(const EGLint *rects, EGLint count) = 0;   // Damaged rectangles as x, y, width, height
 
 	egl::Image *getRenderTarget() override;
 	egl::Image *getDepthStencil() override;
@@ -43,7 +44,7 @@ public:
 	void setMipmapLevel(EGLint mipmapLevel);
 	void setMultisampleResolve(EGLenum multisampleResolve);
 	void setSwapBehavior(EGLenum swapBehavior);
-	void setSwapInterval(EGLint interval);
+	virtual void setSwapInterval(EGLint interval);
 
 	virtual EGLint getConfigID() const;
 	virtual EGLenum getSurfaceType() const;
@@ -59,6 +60,8 @@ public:
 	virtual EGLenum getTextureFormat() const;
 	virtual EGLBoolean getLargestPBuffer() const;
 	virtual EGLNativeWindowType getWindowHandle() const = 0;
+	virtual EGLint getPresentedFrames() const { return 0; }
+	virtual EGLint getDroppedFrames() const { return 0; }
 
 	void setBoundTexture(egl::Texture *texture) override;
 	virtual egl::Texture *getBoundTexture() const;
@@ -120,9 +123,12 @@ public:
 	bool initialize() override;
 
 	bool isWindowSurface() const override { return true; }
-	void swap() override;
+	void swap(const EGLint *rects, EGLint count) override;
+	void setSwapInterval(EGLint interval) override;
 
 	EGLNativeWindowType getWindowHandle() const override;
+	EGLint getPresentedFrames() const override;
+	EGLint getDroppedFrames() const override;
 
 private:
 	void deleteResources() override;
@@ -131,6 +137,11 @@ private:
 
 	const EGLNativeWindowType window;
 	sw::FrameBuffer *frameBuffer = nullptr;
+	bool directBackBuffer = false;   // Aliases the frame buffer's memory
+
+	// Of the frame buffers replaced by resizes
+	EGLint presentedFrames = 0;
+	EGLint droppedFrames = 0;
 };
 
 class PBufferSurface : public Surface
@@ -139,16 +150,30 @@ public:
 	PBufferSurface(Display *display, const egl::Config *config, EGLint width, EGLint height,
 	               EGLenum textureFormat, EGLenum textureTarget, EGLenum internalFormat,
 	               EGLenum textureType, EGLBoolean largestPBuffer, EGLClientBuffer clientBuffer,
-	               EGLint clientBufferPlane);
+	               EGLint clientBufferPlane, EGLint fileDescriptor, EGLint yuvFileDescriptor,
+	               sw::YUVLayout yuvLayout, EGLint yuvFrameCount);
 	~PBufferSurface() override;
 
+	bool initialize() override;
+
 	bool isPBufferSurface() const override { return true; }
-	void swap() override;
+	void swap(const EGLint *rects, EGLint count) override;
+	void setSwapInterval(EGLint interval) override;
 
 	EGLNativeWindowType getWindowHandle() const override;
+	EGLint getPresentedFrames() const override;
+	EGLint getDroppedFrames() const override;
 
 private:
 	void deleteResources() override;
+
+	const EGLint fileDescriptor;   // Backing file, or -1 for memory
+
+	// EGL_SWIFTSHADER_yuv_output attributes:
+	const EGLint yuvFileDescriptor;   // Or -1 when swaps have no effect
+	const sw::YUVLayout yuvLayout;
+	const EGLint yuvFrameCount;
+	sw::FrameBuffer *frameBuffer = nullptr;
 };
 }
 
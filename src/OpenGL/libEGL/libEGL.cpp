@@ -97,6 +97,16 @@ bool validateSurface(egl::Display *display, egl::Surface *surface)
 	return true;
 }
 
+void endFrame()
+{
+	egl::Context *context = egl::getCurrentContext();
+
+	if(context && context->getClientVersion() >= 2)
+	{
+		libGLESv2->es2EndFrame();
+	}
+}
+
 // Class to facilitate conversion from EGLint to EGLAttrib lists.
 class EGLAttribs
 {
@@ -123,6 +133,150 @@ public:
 private:
 	std::vector<EGLAttrib> attrib;
 };
+
+#if defined(__linux__) && !defined(__ANDROID__)
+// DRM fourcc codes of the layouts which can be sampled in place, from drm_fourcc.h
+const EGLAttrib DRM_FORMAT_NV12 = 0x3231564E;     // 'NV12', Y plane, then interleaved Cb and Cr
+const EGLAttrib DRM_FORMAT_NV21 = 0x3132564E;     // 'NV21', Y plane, then interleaved Cr and Cb
+const EGLAttrib DRM_FORMAT_YUV420 = 0x32315559;   // 'YU12', Y, Cb and Cr planes
+const EGLAttrib DRM_FORMAT_YVU420 = 0x32315659;   // 'YV12', Y, Cr and Cb planes
+
+// Single plane RGB layouts, which can also be rendered to in place
+const EGLAttrib DRM_FORMAT_ARGB8888 = 0x34325241;   // 'AR24', B, G, R, A bytes
+const EGLAttrib DRM_FORMAT_ABGR8888 = 0x34324241;   // 'AB24', R, G, B, A bytes
+const EGLAttrib DRM_FORMAT_XBGR8888 = 0x34324258;   // 'XB24', R, G, B, X bytes
+const EGLAttrib DRM_FORMAT_RGB565 = 0x36314752;     // 'RG16'
+
+// Describes the planes of an EGL_LINUX_DMA_BUF_EXT image, returns the error to raise if it can't be imported
+EGLint getDmaBuffer(const EGLAttrib *attrib_list, egl::DmaBuffer &dmaBuffer)
+{
+	EGLAttrib width = 0;
+	EGLAttrib height = 0;
+	EGLAttrib fourcc = 0;
+	EGLAttrib fd[3] = {-1, -1, -1};
+	EGLAttrib offset[3] = {0, 0, 0};
+	EGLAttrib pitch[3] = {0, 0, 0};
+	EGLAttrib colorSpace = EGL_ITU_REC601_EXT;
+	EGLAttrib range = EGL_YUV_NARROW_RANGE_EXT;
+
+	for(const EGLAttrib *attribute = attrib_list; attribute && attribute[0] != EGL_NONE; attribute += 2)
+	{
+		switch(attribute[0])
+		{
+		case EGL_WIDTH:                     width = attribute[1];      break;
+		case EGL_HEIGHT:                    height = attribute[1];     break;
+		case EGL_LINUX_DRM_FOURCC_EXT:      fourcc = attribute[1];     break;
+		case EGL_DMA_BUF_PLANE0_FD_EXT:     fd[0] = attribute[1];      break;
+		case EGL_DMA_BUF_PLANE0_OFFSET_EXT: offset[0] = attribute[1];  break;
+		case EGL_DMA_BUF_PLANE0_PITCH_EXT:  pitch[0] = attribute[1];   break;
+		case EGL_DMA_BUF_PLANE1_FD_EXT:     fd[1] = attribute[1];      break;
+		case EGL_DMA_BUF_PLANE1_OFFSET_EXT: offset[1] = attribute[1];  break;
+		case EGL_DMA_BUF_PLANE1_PITCH_EXT:  pitch[1] = attribute[1];   break;
+		case EGL_DMA_BUF_PLANE2_FD_EXT:     fd[2] = attribute[1];      break;
+		case EGL_DMA_BUF_PLANE2_OFFSET_EXT: offset[2] = attribute[1];  break;
+		case EGL_DMA_BUF_PLANE2_PITCH_EXT:  pitch[2] = attribute[1];   break;
+		case EGL_YUV_COLOR_SPACE_HINT_EXT:  colorSpace = attribute[1]; break;
+		case EGL_SAMPLE_RANGE_HINT_EXT:     range = attribute[1];      break;
+		case EGL_YUV_CHROMA_HORIZONTAL_SITING_HINT_EXT:   // Chroma is always sampled at the scaled luma coordinates
+		case EGL_YUV_CHROMA_VERTICAL_SITING_HINT_EXT:
+		case EGL_IMAGE_PRESERVED_KHR:
+			break;
+		default:
+			return EGL_BAD_ATTRIBUTE;
+		}
+	}
+
+	int planes = 0;
+	bool interleaved = false;
+	bool crFirst = false;
+	GLint rgbFormat = GL_NONE;
+	int rgbBytes = 0;
+
+	switch(fourcc)
+	{
+	case DRM_FORMAT_NV12:     planes = 2; interleaved = true;  crFirst = false; break;
+	case DRM_FORMAT_NV21:     planes = 2; interleaved = true;  crFirst = true;  break;
+	case DRM_FORMAT_YUV420:   planes = 3; interleaved = false; crFirst = false; break;
+	case DRM_FORMAT_YVU420:   planes = 3; interleaved = false; crFirst = true;  break;
+	case DRM_FORMAT_ARGB8888: planes = 1; rgbFormat = GL_BGRA8_EXT; rgbBytes = 4; break;
+	case DRM_FORMAT_ABGR8888: planes = 1; rgbFormat = GL_RGBA8;     rgbBytes = 4; break;
+	case DRM_FORMAT_XBGR8888: planes = 1; rgbFormat = GL_RGB8;      rgbBytes = 4; break;
+	case DRM_FORMAT_RGB565:   planes = 1; rgbFormat = GL_RGB565;    rgbBytes = 2; break;
+	default:
+		return EGL_BAD_MATCH;
+	}
+
+	if(width <= 0 || height <= 0)
+	{
+		return EGL_BAD_PARAMETER;
+	}
+
+	for(int i = 0; i < planes; i++)
+	{
+		if(fd[i] < 0 || pitch[i] <= 0 || offset[i] < 0)
+		{
+			return EGL_BAD_PARAMETER;
+		}
+
+		if(pitch[i] > 0x7FFF)   // Pitches get multiplied with 16-bit texel coordinates
+		{
+			return EGL_BAD_ACCESS;
+		}
+	}
+
+	dmaBuffer.width = (int)width;
+	dmaBuffer.height = (int)height;
+	dmaBuffer.y = {(int)fd[0], (size_t)offset[0], (int)pitch[0]};
+
+	if(rgbFormat != GL_NONE)
+	{
+		// Pixels are accessed whole, and the renderer writes pairs of them
+		if(offset[0] % rgbBytes != 0 || pitch[0] % rgbBytes != 0 || pitch[0] < sw::align<2>(width) * rgbBytes)
+		{
+			return EGL_BAD_ACCESS;
+		}
+
+		dmaBuffer.internalformat = rgbFormat;
+		dmaBuffer.cb = {-1, 0, 0};
+		dmaBuffer.cr = {-1, 0, 0};
+		dmaBuffer.chromaStepB = 0;
+
+		return EGL_SUCCESS;
+	}
+
+	if(colorSpace == EGL_ITU_REC601_EXT && range == EGL_YUV_NARROW_RANGE_EXT)
+	{
+		dmaBuffer.internalformat = SW_YV12_BT601;
+	}
+	else if(colorSpace == EGL_ITU_REC601_EXT && range == EGL_YUV_FULL_RANGE_EXT)
+	{
+		dmaBuffer.internalformat = SW_YV12_JFIF;
+	}
+	else if(colorSpace == EGL_ITU_REC709_EXT && range == EGL_YUV_NARROW_RANGE_EXT)
+	{
+		dmaBuffer.internalformat = SW_YV12_BT709;
+	}
+	else
+	{
+		return EGL_BAD_MATCH;
+	}
+
+	egl::DmaBuffer::Plane first = {(int)fd[1], (size_t)offset[1], (int)pitch[1]};
+	egl::DmaBuffer::Plane second = {(int)fd[2], (size_t)offset[2], (int)pitch[2]};
+
+	if(interleaved)
+	{
+		second = first;
+		second.offset += 1;
+	}
+
+	dmaBuffer.cb = crFirst ? second : first;
+	dmaBuffer.cr = crFirst ? first : second;
+	dmaBuffer.chromaStepB = interleaved ? 2 : 1;
+
+	return EGL_SUCCESS;
+}
+#endif
 }
 
 EGLint GetError(void)
@@ -150,7 +304,7 @@ EGLDisplay GetDisplay(EGLNativeDisplayType display_id)
 
 	#if defined(__linux__) && !defined(__ANDROID__)
 		#if defined(USE_X11)
-		if(!libX11)
+		if(!LibX11::hasServer())   // The libraries are only loaded once a window surface needs them
 		#endif  // Non X11 linux is headless only
 		{
 			return success(HEADLESS_DISPLAY);
@@ -209,6 +363,7 @@ const char *QueryString(EGLDisplay dpy, EGLint name)
 			"EGL_KHR_client_get_all_proc_addresses "
 #if defined(__linux__) && !defined(__ANDROID__)
 			"EGL_KHR_platform_gbm "
+			"EGL_MESA_platform_surfaceless "
 #endif
 #if defined(USE_X11)
 			"EGL_KHR_platform_x11 "
@@ -237,9 +392,15 @@ const char *QueryString(EGLDisplay dpy, EGLint name)
 		               "EGL_KHR_fence_sync "
 		               "EGL_KHR_image_base "
 		               "EGL_KHR_surfaceless_context "
+		               "EGL_KHR_swap_buffers_with_damage "
 		               "EGL_ANGLE_iosurface_client_buffer "
 		               "EGL_ANDROID_framebuffer_target "
-		               "EGL_ANDROID_recordable");
+		               "EGL_ANDROID_recordable "
+		               "EGL_IMG_context_priority"
+#if defined(__linux__) && !defined(__ANDROID__)
+		               " EGL_EXT_image_dma_buf_import"
+#endif
+		               );
 	case EGL_VENDOR:
 		return success("Google Inc.");
 	case EGL_VERSION:
@@ -523,6 +684,12 @@ EGLBoolean QuerySurface(EGLDisplay dpy, EGLSurface surface, EGLint attribute, EG
 	case EGL_WIDTH:
 		*value = eglSurface->getWidth();
 		break;
+	case EGL_PRESENTED_FRAMES_SWIFTSHADER:
+		*value = eglSurface->getPresentedFrames();
+		break;
+	case EGL_DROPPED_FRAMES_SWIFTSHADER:
+		*value = eglSurface->getDroppedFrames();
+		break;
 	default:
 		return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);
 	}
@@ -777,6 +944,8 @@ EGLContext CreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_cont
 
 	EGLint majorVersion = 1;
 	EGLint minorVersion = 0;
+	EGLint priority = EGL_CONTEXT_PRIORITY_MEDIUM_IMG;
+	EGLint cpuShare = 100;
 
 	if(attrib_list)
 	{
@@ -830,6 +999,25 @@ EGLContext CreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_cont
 					return error(EGL_BAD_ATTRIBUTE, EGL_NO_CONTEXT);
 				}
 				break;
+			case EGL_CONTEXT_PRIORITY_LEVEL_IMG:
+				switch(attribute[1])
+				{
+				case EGL_CONTEXT_PRIORITY_HIGH_IMG:
+				case EGL_CONTEXT_PRIORITY_MEDIUM_IMG:
+				case EGL_CONTEXT_PRIORITY_LOW_IMG:
+					priority = attribute[1];
+					break;
+				default:
+					return error(EGL_BAD_ATTRIBUTE, EGL_NO_CONTEXT);
+				}
+				break;
+			case EGL_CPU_SHARE_SWIFTSHADER:
+				if(attribute[1] < 1 || attribute[1] > 100)
+				{
+					return error(EGL_BAD_ATTRIBUTE, EGL_NO_CONTEXT);
+				}
+				cpuShare = attribute[1];
+				break;
 			default:
 				return error(EGL_BAD_ATTRIBUTE, EGL_NO_CONTEXT);
 			}
@@ -870,7 +1058,7 @@ EGLContext CreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_cont
 		return error(EGL_BAD_CONTEXT, EGL_NO_CONTEXT);
 	}
 
-	return display->createContext(config, shareContext, majorVersion);
+	return display->createContext(config, shareContext, majorVersion, priority, cpuShare);
 }
 
 EGLBoolean DestroyContext(EGLDisplay dpy, EGLContext ctx)
@@ -1035,8 +1223,17 @@ EGLBoolean QueryContext(EGLDisplay dpy, EGLContext ctx, EGLint attribute, EGLint
 	case EGL_RENDER_BUFFER:
 		*value = EGL_BACK_BUFFER;
 		break;
+	case EGL_CONTEXT_PRIORITY_LEVEL_IMG:
+	case EGL_CPU_SHARE_SWIFTSHADER:
+	case EGL_WORKER_TIME_SWIFTSHADER:
+	case EGL_WORKER_SHARE_SWIFTSHADER:
+		context->getScheduling(attribute, value);
+		break;
 	default:
-		return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);
+		if(!context->getPipelineProfile(attribute, value) && !context->getMemoryUsage(attribute, value))
+		{
+			return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);
+		}
 	}
 
 	return success(EGL_TRUE);
@@ -1105,7 +1302,36 @@ EGLBoolean SwapBuffers(EGLDisplay dpy, EGLSurface surface)
 		return error(EGL_BAD_SURFACE, EGL_FALSE);
 	}
 
-	eglSurface->swap();
+	eglSurface->swap(nullptr, 0);
+	endFrame();
+
+	return success(EGL_TRUE);
+}
+
+EGLBoolean SwapBuffersWithDamageKHR(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+	TRACE("(EGLDisplay dpy = %p, EGLSurface surface = %p, EGLint *rects = %p, EGLint n_rects = %d)", dpy, surface, rects, n_rects);
+
+	egl::Display *display = egl::Display::get(dpy);
+	egl::Surface *eglSurface = (egl::Surface*)surface;
+
+	if(!validateSurface(display, eglSurface))
+	{
+		return EGL_FALSE;
+	}
+
+	if(surface == EGL_NO_SURFACE)
+	{
+		return error(EGL_BAD_SURFACE, EGL_FALSE);
+	}
+
+	if(n_rects < 0 || (n_rects > 0 && !rects))
+	{
+		return error(EGL_BAD_PARAMETER, EGL_FALSE);
+	}
+
+	eglSurface->swap(rects, n_rects);
+	endFrame();
 
 	return success(EGL_TRUE);
 }
@@ -1144,6 +1370,36 @@ EGLImage CreateImage(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBu
 		return error(EGL_BAD_CONTEXT, EGL_NO_IMAGE_KHR);
 	}
 
+	#if defined(__linux__) && !defined(__ANDROID__)
+		if(target == EGL_LINUX_DMA_BUF_EXT)
+		{
+			if(context != EGL_NO_CONTEXT || buffer != nullptr)
+			{
+				return error(EGL_BAD_PARAMETER, EGL_NO_IMAGE_KHR);
+			}
+
+			egl::DmaBuffer dmaBuffer;
+			EGLint result = getDmaBuffer(attrib_list, dmaBuffer);
+
+			if(result != EGL_SUCCESS)
+			{
+				return error(result, EGL_NO_IMAGE_KHR);
+			}
+
+			// The planes get mapped and sampled in place, with the YUV to RGB conversion done by the sampler. RGB ones are also rendered to in place.
+			Image *image = libGLESv2 ? libGLESv2->createImageFromDmaBuffer(dmaBuffer) : nullptr;
+
+			if(!image)
+			{
+				return error(EGL_BAD_ACCESS, EGL_NO_IMAGE_KHR);
+			}
+
+			EGLImageKHR eglImage = display->createSharedImage(image);
+
+			return success(eglImage);
+		}
+	#endif
+
 	EGLenum imagePreserved = EGL_FALSE;
 	GLuint textureLevel = 0;
 	if(attrib_list)
@@ -1252,11 +1508,12 @@ EGLDisplay GetPlatformDisplay(EGLenum platform, void *native_display, const EGLA
 		case EGL_PLATFORM_X11_EXT: break;
 		#endif
 		case EGL_PLATFORM_GBM_KHR: break;
+		case EGL_PLATFORM_SURFACELESS_MESA: break;
 		default:
 			return error(EGL_BAD_PARAMETER, EGL_NO_DISPLAY);
 		}
 
-		if(platform == EGL_PLATFORM_GBM_KHR)
+		if(platform == EGL_PLATFORM_GBM_KHR || platform == EGL_PLATFORM_SURFACELESS_MESA)   // Headless, without probing the windowing system
 		{
 			if(native_display != (void*)EGL_DEFAULT_DISPLAY)
 			{
@@ -1437,6 +1694,73 @@ EGLBoolean GetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, E
 	return result;
 }
 
+EGLBoolean SetPerformanceProfileSWIFTSHADER(const EGLint *attrib_list)
+{
+	TRACE("(const EGLint *attrib_list = %p)", attrib_list);
+
+	struct Setting
+	{
+		EGLint attribute;
+		const char *section;
+		const char *name;
+	};
+
+	static const Setting settings[] =
+	{
+		{EGL_THREAD_COUNT_SWIFTSHADER,              "Processor",    "ThreadCount"},
+		{EGL_DRAW_QUEUE_SIZE_SWIFTSHADER,           "Processor",    "DrawQueueSize"},
+		{EGL_RASTER_TILE_HEIGHT_SWIFTSHADER,        "Processor",    "RasterTileHeight"},
+		{EGL_VERTEX_ROUTINE_CACHE_SIZE_SWIFTSHADER, "Caches",       "VertexRoutineCacheSize"},
+		{EGL_PIXEL_ROUTINE_CACHE_SIZE_SWIFTSHADER,  "Caches",       "PixelRoutineCacheSize"},
+		{EGL_SETUP_ROUTINE_CACHE_SIZE_SWIFTSHADER,  "Caches",       "SetupRoutineCacheSize"},
+		{EGL_VERTEX_CACHE_SIZE_SWIFTSHADER,         "Caches",       "VertexCacheSize"},
+		{EGL_TEXTURE_SAMPLE_QUALITY_SWIFTSHADER,    "Quality",      "TextureSampleQuality"},
+		{EGL_MIPMAP_QUALITY_SWIFTSHADER,            "Quality",      "MipmapQuality"},
+		{EGL_TRANSCENDENTAL_PRECISION_SWIFTSHADER,  "Quality",      "TranscendentalPrecision"},
+		{EGL_CONCURRENT_COMPILATION_SWIFTSHADER,    "Processor",    "ConcurrentCompilation"},
+		{EGL_TIERED_COMPILATION_SWIFTSHADER,        "Optimization", "TieredCompilation"},
+		{EGL_DRAW_MERGING_SWIFTSHADER,              "Optimization", "DrawMerging"},
+	};
+
+	const Setting *const settingsEnd = settings + sizeof(settings) / sizeof(Setting);
+
+	// Validated first, so a bad list changes nothing
+	for(const EGLint *attribute = attrib_list; attribute && attribute[0] != EGL_NONE; attribute += 2)
+	{
+		if(std::find_if(settings, settingsEnd, [&](const Setting &setting) { return setting.attribute == attribute[0]; }) == settingsEnd)
+		{
+			return error(EGL_BAD_ATTRIBUTE, EGL_FALSE);
+		}
+	}
+
+	// Each library has its own renderers and configuration
+	auto apply = [&](void (*overrideConfiguration)(const char *section, const char *name, int value))
+	{
+		if(!attrib_list || attrib_list[0] == EGL_NONE)
+		{
+			overrideConfiguration(nullptr, nullptr, 0);
+		}
+
+		for(const EGLint *attribute = attrib_list; attribute && attribute[0] != EGL_NONE; attribute += 2)
+		{
+			const Setting *setting = std::find_if(settings, settingsEnd, [&](const Setting &setting) { return setting.attribute == attribute[0]; });
+			overrideConfiguration(setting->section, setting->name, attribute[1]);
+		}
+	};
+
+	if(libGLESv2)
+	{
+		apply(libGLESv2->overrideConfiguration);
+	}
+
+	if(libGLES_CM)
+	{
+		apply(libGLES_CM->overrideConfiguration);
+	}
+
+	return success(EGL_TRUE);
+}
+
 __eglMustCastToProperFunctionPointerType GetProcAddress(const char *procname)
 {
 	TRACE("(const char *procname = \"%s\")", procname);
@@ -1506,8 +1830,10 @@ __eglMustCastToProperFunctionPointerType GetProcAddress(const char *procname)
 		FUNCTION(eglQuerySurface),
 		FUNCTION(eglReleaseTexImage),
 		FUNCTION(eglReleaseThread),
+		FUNCTION(eglSetPerformanceProfileSWIFTSHADER),
 		FUNCTION(eglSurfaceAttrib),
 		FUNCTION(eglSwapBuffers),
+		FUNCTION(eglSwapBuffersWithDamageKHR),
 		FUNCTION(eglSwapInterval),
 		FUNCTION(eglTerminate),
 		FUNCTION(eglWaitClient),
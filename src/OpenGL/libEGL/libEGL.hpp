@@ -20,6 +20,8 @@
 
 #include "Common/SharedLibrary.hpp"
 
+#include <atomic>
+
 class LibEGLexports
 {
 public:
@@ -65,9 +67,13 @@ public:
 	EGLBoolean (*eglDestroySyncKHR)(EGLDisplay dpy, EGLSyncKHR sync);
 	EGLint (*eglClientWaitSyncKHR)(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout);
 	EGLBoolean (*eglGetSyncAttribKHR)(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, EGLint *value);
+	EGLBoolean (*eglSwapBuffersWithDamageKHR)(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects);
 
 	// Functions that don't change the error code, for use by client APIs
 	egl::Context *(*clientGetCurrentContext)();
+
+	// Incremented whenever a thread's current context changes, so client APIs can cache theirs
+	const std::atomic<unsigned int> *clientCurrentContextSerial;
 };
 
 class LibEGL
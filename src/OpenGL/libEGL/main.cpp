@@ -28,6 +28,7 @@
 #include <EGL/eglext.h>
 
 static sw::Thread::LocalStorageKey currentTLS = TLS_OUT_OF_INDEXES;
+static std::atomic<unsigned int> currentContextSerial(0);
 
 #if !defined(_MSC_VER)
 #define CONSTRUCTOR __attribute__((constructor))
@@ -61,6 +62,7 @@ void releaseCurrent(void *storage)
 		if(current->context)
 		{
 			current->context->release();
+			currentContextSerial++;
 		}
 
 		free(current);
@@ -247,6 +249,7 @@ void setCurrentContext(egl::Context *ctx)
 	}
 
 	current->context = ctx;
+	currentContextSerial++;
 }
 
 NO_SANITIZE_FUNCTION egl::Context *getCurrentContext()
@@ -366,6 +369,7 @@ EGLBoolean QueryContext(EGLDisplay dpy, EGLContext ctx, EGLint attribute, EGLint
 EGLBoolean WaitGL(void);
 EGLBoolean WaitNative(EGLint engine);
 EGLBoolean SwapBuffers(EGLDisplay dpy, EGLSurface surface);
+EGLBoolean SwapBuffersWithDamageKHR(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects);
 EGLBoolean CopyBuffers(EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType target);
 EGLImageKHR CreateImageKHR(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list);
 EGLImageKHR CreateImage(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLAttrib *attrib_list);
@@ -382,6 +386,7 @@ EGLBoolean DestroySyncKHR(EGLDisplay dpy, EGLSyncKHR sync);
 EGLint ClientWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout);
 EGLBoolean GetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, EGLint *value);
 EGLBoolean GetSyncAttrib(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, EGLAttrib *value);
+EGLBoolean SetPerformanceProfileSWIFTSHADER(const EGLint *attrib_list);
 __eglMustCastToProperFunctionPointerType GetProcAddress(const char *procname);
 }
 
@@ -547,6 +552,11 @@ EGLAPI EGLBoolean EGLAPIENTRY eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
 	return egl::SwapBuffers(dpy, surface);
 }
 
+EGLAPI EGLBoolean EGLAPIENTRY eglSwapBuffersWithDamageKHR(EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects)
+{
+	return egl::SwapBuffersWithDamageKHR(dpy, surface, rects, n_rects);
+}
+
 EGLAPI EGLBoolean EGLAPIENTRY eglCopyBuffers(EGLDisplay dpy, EGLSurface surface, EGLNativePixmapType target)
 {
 	return egl::CopyBuffers(dpy, surface, target);
@@ -652,6 +662,11 @@ EGLAPI EGLBoolean EGLAPIENTRY eglWaitSync(EGLDisplay dpy, EGLSync sync, EGLint f
 	return egl::ClientWaitSyncKHR(dpy, sync, flags, EGL_FOREVER_KHR);
 }
 
+EGLAPI EGLBoolean EGLAPIENTRY eglSetPerformanceProfileSWIFTSHADER(const EGLint *attrib_list)
+{
+	return egl::SetPerformanceProfileSWIFTSHADER(attrib_list);
+}
+
 EGLAPI __eglMustCastToProperFunctionPointerType EGLAPIENTRY eglGetProcAddress(const char *procname)
 {
 	return egl::GetProcAddress(procname);
@@ -700,8 +715,10 @@ LibEGLexports::LibEGLexports()
 	this->eglDestroySyncKHR = egl::DestroySyncKHR;
 	this->eglClientWaitSyncKHR = egl::ClientWaitSyncKHR;
 	this->eglGetSyncAttribKHR = egl::GetSyncAttribKHR;
+	this->eglSwapBuffersWithDamageKHR = egl::SwapBuffersWithDamageKHR;
 
 	this->clientGetCurrentContext = egl::getCurrentContext;
+	this->clientCurrentContextSerial = &currentContextSerial;
 }
 
 extern "C" EGLAPI LibEGLexports *libEGL_swiftshader()
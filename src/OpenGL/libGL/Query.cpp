@@ -44,7 +44,7 @@ void Query::begin()
 		{
 		case GL_ANY_SAMPLES_PASSED:
 		case GL_ANY_SAMPLES_PASSED_CONSERVATIVE:
-			type = sw::Query::FRAGMENTS_PASSED;
+			type = sw::Query::ANY_FRAGMENTS_PASSED;
 			break;
 		default:
 			ASSERT(false);
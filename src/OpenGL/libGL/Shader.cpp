@@ -25,7 +25,6 @@
 
 namespace gl
 {
-bool Shader::compilerInitialized = false;
 
 Shader::Shader(ResourceManager *manager, GLuint handle) : mHandle(handle), mResourceManager(manager)
 {
@@ -155,12 +154,6 @@ void Shader::getSource(GLsizei bufSize, GLsizei *length, char *source)
 
 TranslatorASM *Shader::createCompiler(GLenum shaderType)
 {
-	if(!compilerInitialized)
-	{
-		InitCompilerGlobals();
-		compilerInitialized = true;
-	}
-
 	TranslatorASM *assembler = new TranslatorASM(this, shaderType);
 
 	ShBuiltInResources resources;
@@ -265,8 +258,7 @@ void Shader::flagForDeletion()
 
 void Shader::releaseCompiler()
 {
-	FreeCompilerGlobals();
-	compilerInitialized = false;
+	// The compiler has no global state to release
 }
 
 // true if varying x has a higher priority in packing than y
@@ -72,7 +72,6 @@ public:
 	static void releaseCompiler();
 
 protected:
-	static bool compilerInitialized;
 	TranslatorASM *createCompiler(GLenum shaderType);
 	void clear();
 
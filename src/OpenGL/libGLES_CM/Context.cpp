@@ -30,9 +30,12 @@
 #include "libEGL/Display.h"
 #include "common/Surface.hpp"
 #include "Common/Half.hpp"
+#include "Common/Memory.hpp"
 
 #include <EGL/eglext.h>
 
+#include <algorithm>
+
 using std::abs;
 
 namespace es1
@@ -288,6 +291,8 @@ Context::~Context()
 
 void Context::makeCurrent(gl::Surface *surface)
 {
+	bool firstCurrent = !mHasBeenCurrent;
+
 	if(!mHasBeenCurrent)
 	{
 		mState.viewportX = 0;
@@ -323,9 +328,43 @@ void Context::makeCurrent(gl::Surface *surface)
 		depthStencil->release();
 	}
 
+	if(firstCurrent && surface)
+	{
+		precompileRoutines();
+	}
+
 	markAllStateDirty();
 }
 
+void Context::precompileRoutines()
+{
+	// Generates the routines for drawing triangles from a float3 position array with the initial state,
+	// the configuration of most first draws, so these don't stall on code generation
+	if(!applyRenderTarget())
+	{
+		return;
+	}
+
+	applyState(GL_TRIANGLES);
+
+	GLenum err = applyVertexBuffer(0, 0, 1);
+	if(err != GL_NO_ERROR)
+	{
+		return;
+	}
+
+	sw::Stream position(nullptr, nullptr, 3 * sizeof(float));
+	position.type = sw::STREAMTYPE_FLOAT;
+	position.count = 3;
+	device->setInputStream(sw::Position, position);
+
+	applyTextures();
+
+	device->precompilePrimitive(sw::DRAW_TRIANGLELIST);
+
+	device->resetInputStreams(false);
+}
+
 EGLint Context::getClientVersion() const
 {
 	return 1;
@@ -347,6 +386,14 @@ void Context::markAllStateDirty()
 	mSampleStateDirty = true;
 	mDitherStateDirty = true;
 	mFrontFaceDirty = true;
+	mLightingStateDirty = true;
+	mModelViewMatrixDirty = true;
+	mProjectionMatrixDirty = true;
+
+	for(int i = 0; i < MAX_TEXTURE_UNITS; i++)
+	{
+		mTextureMatrixDirty[i] = true;
+	}
 }
 
 void Context::setClearColor(float red, float green, float blue, float alpha)
@@ -621,6 +668,7 @@ bool Context::isDitherEnabled() const
 void Context::setLightingEnabled(bool enable)
 {
 	lightingEnabled = enable;
+	mLightingStateDirty = true;
 }
 
 bool Context::isLightingEnabled() const
@@ -631,6 +679,7 @@ bool Context::isLightingEnabled() const
 void Context::setLightEnabled(int index, bool enable)
 {
 	light[index].enabled = enable;
+	mLightingStateDirty = true;
 }
 
 bool Context::isLightEnabled(int index) const
@@ -641,16 +690,19 @@ bool Context::isLightEnabled(int index) const
 void Context::setLightAmbient(int index, float r, float g, float b, float a)
 {
 	light[index].ambient = {r, g, b, a};
+	mLightingStateDirty = true;
 }
 
 void Context::setLightDiffuse(int index, float r, float g, float b, float a)
 {
 	light[index].diffuse = {r, g, b, a};
+	mLightingStateDirty = true;
 }
 
 void Context::setLightSpecular(int index, float r, float g, float b, float a)
 {
 	light[index].specular = {r, g, b, a};
+	mLightingStateDirty = true;
 }
 
 void Context::setLightPosition(int index, float x, float y, float z, float w)
@@ -661,37 +713,44 @@ void Context::setLightPosition(int index, float x, float y, float z, float w)
 	v = modelViewStack.current() * v;
 
 	light[index].position = {v.x, v.y, v.z, v.w};
+	mLightingStateDirty = true;
 }
 
 void Context::setLightDirection(int index, float x, float y, float z)
 {
 	// FIXME: Transform by inverse of 3x3 model-view matrix
 	light[index].direction = {x, y, z};
+	mLightingStateDirty = true;
 }
 
 void Context::setLightAttenuationConstant(int index, float constant)
 {
 	light[index].attenuation.constant = constant;
+	mLightingStateDirty = true;
 }
 
 void Context::setLightAttenuationLinear(int index, float linear)
 {
 	light[index].attenuation.linear = linear;
+	mLightingStateDirty = true;
 }
 
 void Context::setLightAttenuationQuadratic(int index, float quadratic)
 {
 	light[index].attenuation.quadratic = quadratic;
+	mLightingStateDirty = true;
 }
 
 void Context::setSpotLightExponent(int index, float exponent)
 {
 	light[index].spotExponent = exponent;
+	mLightingStateDirty = true;
 }
 
 void Context::setSpotLightCutoff(int index, float cutoff)
 {
 	light[index].spotCutoffAngle = cutoff;
+	mLightingStateDirty = true;
 }
 
 void Context::setGlobalAmbient(float red, float green, float blue, float alpha)
@@ -700,6 +759,7 @@ void Context::setGlobalAmbient(float red, float green, float blue, float alpha)
 	globalAmbient.green = green;
 	globalAmbient.blue = blue;
 	globalAmbient.alpha = alpha;
+	mLightingStateDirty = true;
 }
 
 void Context::setMaterialAmbient(float red, float green, float blue, float alpha)
@@ -708,6 +768,7 @@ void Context::setMaterialAmbient(float red, float green, float blue, float alpha
 	materialAmbient.green = green;
 	materialAmbient.blue = blue;
 	materialAmbient.alpha = alpha;
+	mLightingStateDirty = true;
 }
 
 void Context::setMaterialDiffuse(float red, float green, float blue, float alpha)
@@ -716,6 +777,7 @@ void Context::setMaterialDiffuse(float red, float green, float blue, float alpha
 	materialDiffuse.green = green;
 	materialDiffuse.blue = blue;
 	materialDiffuse.alpha = alpha;
+	mLightingStateDirty = true;
 }
 
 void Context::setMaterialSpecular(float red, float green, float blue, float alpha)
@@ -724,6 +786,7 @@ void Context::setMaterialSpecular(float red, float green, float blue, float alph
 	materialSpecular.green = green;
 	materialSpecular.blue = blue;
 	materialSpecular.alpha = alpha;
+	mLightingStateDirty = true;
 }
 
 void Context::setMaterialEmission(float red, float green, float blue, float alpha)
@@ -732,11 +795,13 @@ void Context::setMaterialEmission(float red, float green, float blue, float alph
 	materialEmission.green = green;
 	materialEmission.blue = blue;
 	materialEmission.alpha = alpha;
+	mLightingStateDirty = true;
 }
 
 void Context::setMaterialShininess(float shininess)
 {
 	materialShininess = shininess;
+	mLightingStateDirty = true;
 }
 
 void Context::setLightModelTwoSide(bool enable)
@@ -1961,46 +2026,72 @@ void Context::applyState(GLenum drawMode)
 	case GL_FLAT:   device->setShadingMode(sw::SHADING_FLAT);    break;
 	}
 
-	device->setLightingEnable(lightingEnabled);
-	device->setGlobalAmbient(sw::Color<float>(globalAmbient.red, globalAmbient.green, globalAmbient.blue, globalAmbient.alpha));
-
-	for(int i = 0; i < MAX_LIGHTS; i++)
+	if(mLightingStateDirty)
 	{
-		device->setLightEnable(i, light[i].enabled);
-		device->setLightAmbient(i, sw::Color<float>(light[i].ambient.red, light[i].ambient.green, light[i].ambient.blue, light[i].ambient.alpha));
-		device->setLightDiffuse(i, sw::Color<float>(light[i].diffuse.red, light[i].diffuse.green, light[i].diffuse.blue, light[i].diffuse.alpha));
-		device->setLightSpecular(i, sw::Color<float>(light[i].specular.red, light[i].specular.green, light[i].specular.blue, light[i].specular.alpha));
-		device->setLightAttenuation(i, light[i].attenuation.constant, light[i].attenuation.linear, light[i].attenuation.quadratic);
+		device->setLightingEnable(lightingEnabled);
+		device->setGlobalAmbient(sw::Color<float>(globalAmbient.red, globalAmbient.green, globalAmbient.blue, globalAmbient.alpha));
 
-		if(light[i].position.w != 0.0f)
+		for(int i = 0; i < MAX_LIGHTS; i++)
 		{
-			device->setLightPosition(i, sw::Point(light[i].position.x / light[i].position.w, light[i].position.y / light[i].position.w, light[i].position.z / light[i].position.w));
-		}
-		else   // Directional light
-		{
-			// Hack: set the position far way
-			float max = sw::max(abs(light[i].position.x), abs(light[i].position.y), abs(light[i].position.z));
-			device->setLightPosition(i, sw::Point(1e10f * (light[i].position.x / max), 1e10f * (light[i].position.y / max), 1e10f * (light[i].position.z / max)));
+			device->setLightEnable(i, light[i].enabled);
+			device->setLightAmbient(i, sw::Color<float>(light[i].ambient.red, light[i].ambient.green, light[i].ambient.blue, light[i].ambient.alpha));
+			device->setLightDiffuse(i, sw::Color<float>(light[i].diffuse.red, light[i].diffuse.green, light[i].diffuse.blue, light[i].diffuse.alpha));
+			device->setLightSpecular(i, sw::Color<float>(light[i].specular.red, light[i].specular.green, light[i].specular.blue, light[i].specular.alpha));
+			device->setLightAttenuation(i, light[i].attenuation.constant, light[i].attenuation.linear, light[i].attenuation.quadratic);
+
+			if(light[i].position.w != 0.0f)
+			{
+				device->setLightPosition(i, sw::Point(light[i].position.x / light[i].position.w, light[i].position.y / light[i].position.w, light[i].position.z / light[i].position.w));
+			}
+			else   // Directional light
+			{
+				// Hack: set the position far way
+				float max = sw::max(abs(light[i].position.x), abs(light[i].position.y), abs(light[i].position.z));
+				device->setLightPosition(i, sw::Point(1e10f * (light[i].position.x / max), 1e10f * (light[i].position.y / max), 1e10f * (light[i].position.z / max)));
+			}
 		}
+
+		device->setMaterialAmbient(sw::Color<float>(materialAmbient.red, materialAmbient.green, materialAmbient.blue, materialAmbient.alpha));
+		device->setMaterialDiffuse(sw::Color<float>(materialDiffuse.red, materialDiffuse.green, materialDiffuse.blue, materialDiffuse.alpha));
+		device->setMaterialSpecular(sw::Color<float>(materialSpecular.red, materialSpecular.green, materialSpecular.blue, materialSpecular.alpha));
+		device->setMaterialEmission(sw::Color<float>(materialEmission.red, materialEmission.green, materialEmission.blue, materialEmission.alpha));
+		device->setMaterialShininess(materialShininess);
+
+		device->setDiffuseMaterialSource(sw::MATERIAL_MATERIAL);
+		device->setSpecularMaterialSource(sw::MATERIAL_MATERIAL);
+		device->setAmbientMaterialSource(sw::MATERIAL_MATERIAL);
+		device->setEmissiveMaterialSource(sw::MATERIAL_MATERIAL);
+
+		mLightingStateDirty = false;
+	}
+
+	// Setting a matrix makes the renderer recompute the combined transforms and the normal matrix
+	if(mProjectionMatrixDirty)
+	{
+		device->setProjectionMatrix(projectionStack.current());
+		mProjectionMatrixDirty = false;
+	}
+
+	if(mModelViewMatrixDirty)
+	{
+		device->setModelMatrix(modelViewStack.current());
+		mModelViewMatrixDirty = false;
 	}
 
-	device->setMaterialAmbient(sw::Color<float>(materialAmbient.red, materialAmbient.green, materialAmbient.blue, materialAmbient.alpha));
-	device->setMaterialDiffuse(sw::Color<float>(materialDiffuse.red, materialDiffuse.green, materialDiffuse.blue, materialDiffuse.alpha));
-	device->setMaterialSpecular(sw::Color<float>(materialSpecular.red, materialSpecular.green, materialSpecular.blue, materialSpecular.alpha));
-	device->setMaterialEmission(sw::Color<float>(materialEmission.red, materialEmission.green, materialEmission.blue, materialEmission.alpha));
-	device->setMaterialShininess(materialShininess);
+	if(mTextureMatrixDirty[0])
+	{
+		device->setTextureMatrix(0, textureStack0.current());
+		device->setTextureTransform(0, textureStack0.isIdentity() ? 0 : 4, false);
+		mTextureMatrixDirty[0] = false;
+	}
 
-	device->setDiffuseMaterialSource(sw::MATERIAL_MATERIAL);
-	device->setSpecularMaterialSource(sw::MATERIAL_MATERIAL);
-	device->setAmbientMaterialSource(sw::MATERIAL_MATERIAL);
-	device->setEmissiveMaterialSource(sw::MATERIAL_MATERIAL);
+	if(mTextureMatrixDirty[1])
+	{
+		device->setTextureMatrix(1, textureStack1.current());
+		device->setTextureTransform(1, textureStack1.isIdentity() ? 0 : 4, false);
+		mTextureMatrixDirty[1] = false;
+	}
 
-	device->setProjectionMatrix(projectionStack.current());
-	device->setModelMatrix(modelViewStack.current());
-	device->setTextureMatrix(0, textureStack0.current());
-	device->setTextureMatrix(1, textureStack1.current());
-	device->setTextureTransform(0, textureStack0.isIdentity() ? 0 : 4, false);
-	device->setTextureTransform(1, textureStack1.isIdentity() ? 0 : 4, false);
 	device->setTexGen(0, sw::TEXGEN_NONE);
 	device->setTexGen(1, sw::TEXGEN_NONE);
 
@@ -2852,6 +2943,9 @@ void Context::drawTexture(GLfloat x, GLfloat y, GLfloat z, GLfloat width, GLfloa
 	projectionStack.identity();
 	modelViewStack.identity();
 	textureStack0.identity();
+	mProjectionMatrixDirty = true;
+	mModelViewMatrixDirty = true;
+	mTextureMatrixDirty[0] = true;
 
 	drawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
@@ -2865,6 +2959,9 @@ void Context::drawTexture(GLfloat x, GLfloat y, GLfloat z, GLfloat width, GLfloa
 	textureStack0.load(T);
 	modelViewStack.load(M);
 	projectionStack.load(P);
+	mProjectionMatrixDirty = true;
+	mModelViewMatrixDirty = true;
+	mTextureMatrixDirty[0] = true;
 }
 
 void Context::blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface *dest, const sw::SliceRect &dRect)
@@ -2873,6 +2970,103 @@ void Context::blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface
 	device->blit(source, sRectF, dest, dRect, false);
 }
 
+bool Context::getPipelineProfile(EGLint attribute, EGLint *value)
+{
+	if(attribute == EGL_PIPELINE_PROFILE_SWIFTSHADER)
+	{
+		*value = device->getPipelineProfiling() ? EGL_TRUE : EGL_FALSE;
+		return true;
+	}
+
+	if(attribute < EGL_PIPELINE_DRAW_CALLS_SWIFTSHADER || attribute > EGL_PIPELINE_DIVERGENT_BRANCHES_SWIFTSHADER)
+	{
+		return false;
+	}
+
+	device->finish();   // Draw calls are only accounted for once they retire
+	sw::PipelineProfile profile = device->getPipelineProfile();
+	int64_t drawCalls = std::max<int64_t>(profile.drawCalls, 1);
+	int64_t result = 0;
+
+	switch(attribute)
+	{
+	case EGL_PIPELINE_DRAW_CALLS_SWIFTSHADER:                result = profile.drawCalls;                                       break;
+	case EGL_PIPELINE_RASTERIZATION_SWIFTSHADER:             result = (int64_t)(1000 * profile.share(sw::PERF_PIXEL) + 0.5);  break;
+	case EGL_PIPELINE_DEPTH_STENCIL_SWIFTSHADER:             result = (int64_t)(1000 * profile.share(sw::PERF_PIPE) + 0.5);   break;
+	case EGL_PIPELINE_INTERPOLATION_SWIFTSHADER:             result = (int64_t)(1000 * profile.share(sw::PERF_INTERP) + 0.5); break;
+	case EGL_PIPELINE_SHADER_SWIFTSHADER:                    result = (int64_t)(1000 * profile.share(sw::PERF_SHADER) + 0.5); break;
+	case EGL_PIPELINE_TEXTURE_SWIFTSHADER:                   result = (int64_t)(1000 * profile.share(sw::PERF_TEX) + 0.5);    break;
+	case EGL_PIPELINE_RASTER_OPERATIONS_SWIFTSHADER:         result = (int64_t)(1000 * profile.share(sw::PERF_ROP) + 0.5);    break;
+	case EGL_PIPELINE_ROP_PIXELS_SWIFTSHADER:                result = profile.ropOperations / drawCalls;                       break;
+	case EGL_PIPELINE_TEXTURE_PIXELS_SWIFTSHADER:            result = profile.texOperations / drawCalls;                       break;
+	case EGL_PIPELINE_COMPRESSED_TEXTURE_PIXELS_SWIFTSHADER: result = profile.compressedTex / drawCalls;                       break;
+	case EGL_PIPELINE_EARLY_DEPTH_REJECTS_SWIFTSHADER:       result = profile.earlyDepthRejects / drawCalls;                   break;
+	case EGL_PIPELINE_COHERENT_BRANCHES_SWIFTSHADER:         result = profile.coherentBranches / drawCalls;                    break;
+	case EGL_PIPELINE_DIVERGENT_BRANCHES_SWIFTSHADER:        result = profile.divergentBranches / drawCalls;                   break;
+	}
+
+	*value = (EGLint)std::min<int64_t>(std::max<int64_t>(result, 0), 0x7FFFFFFF);
+
+	return true;
+}
+
+bool Context::getMemoryUsage(EGLint attribute, EGLint *value)
+{
+	if(attribute < EGL_MEMORY_GENERAL_SWIFTSHADER || attribute > EGL_PEAK_MEMORY_ROUTINE_SWIFTSHADER)
+	{
+		return false;
+	}
+
+	// Each library accounts for its own allocations, so this covers all of this library's contexts
+	int index = attribute - EGL_MEMORY_GENERAL_SWIFTSHADER;
+	sw::MemoryUsage usage = sw::memoryUsage((sw::MemoryCategory)(index % sw::MEMORY_CATEGORIES));
+	size_t bytes = (index < sw::MEMORY_CATEGORIES) ? usage.current : usage.peak;
+
+	*value = (EGLint)std::min<size_t>(bytes / 1024, 0x7FFFFFFF);
+
+	return true;
+}
+
+void Context::setScheduling(EGLint priority, EGLint cpuShare)
+{
+	switch(priority)
+	{
+	case EGL_CONTEXT_PRIORITY_HIGH_IMG: device->setSchedulingPriority(sw::PRIORITY_HIGH);   break;
+	case EGL_CONTEXT_PRIORITY_LOW_IMG:  device->setSchedulingPriority(sw::PRIORITY_LOW);    break;
+	default:                            device->setSchedulingPriority(sw::PRIORITY_MEDIUM); break;
+	}
+
+	device->setCpuShare(cpuShare);
+}
+
+bool Context::getScheduling(EGLint attribute, EGLint *value)
+{
+	switch(attribute)
+	{
+	case EGL_CONTEXT_PRIORITY_LEVEL_IMG:
+		switch(device->getSchedulingPriority())
+		{
+		case sw::PRIORITY_HIGH: *value = EGL_CONTEXT_PRIORITY_HIGH_IMG;   break;
+		case sw::PRIORITY_LOW:  *value = EGL_CONTEXT_PRIORITY_LOW_IMG;    break;
+		default:                *value = EGL_CONTEXT_PRIORITY_MEDIUM_IMG; break;
+		}
+		break;
+	case EGL_CPU_SHARE_SWIFTSHADER:
+		*value = device->getCpuShare();
+		break;
+	case EGL_WORKER_TIME_SWIFTSHADER:
+		*value = (EGLint)std::min<int64_t>(device->getWorkerTime() / 1000000, 0x7FFFFFFF);
+		break;
+	case EGL_WORKER_SHARE_SWIFTSHADER:
+		*value = device->getRecentWorkerShare();
+		break;
+	default:
+		return false;
+	}
+
+	return true;
+}
+
 void Context::finish()
 {
 	device->finish();
@@ -3227,14 +3421,16 @@ sw::MatrixStack &Context::currentMatrixStack()
 	switch(matrixMode)
 	{
 	case GL_MODELVIEW:
+		mModelViewMatrixDirty = true;
 		return modelViewStack;
 	case GL_PROJECTION:
+		mProjectionMatrixDirty = true;
 		return projectionStack;
 	case GL_TEXTURE:
 		switch(mState.activeSampler)
 		{
-		case 0: return textureStack0;
-		case 1: return textureStack1;
+		case 0: mTextureMatrixDirty[0] = true; return textureStack0;
+		case 1: mTextureMatrixDirty[1] = true; return textureStack1;
 		}
 		break;
 	}
@@ -3503,3 +3699,8 @@ egl::Context *es1CreateContext(egl::Display *display, const egl::Context *shareC
 	ASSERT(!shareContext || shareContext->getClientVersion() == 1);   // Should be checked by eglCreateContext
 	return new es1::Context(display, static_cast<const es1::Context*>(shareContext), config);
 }
+
+void overrideConfiguration(const char *section, const char *name, int value)
+{
+	sw::Renderer::overrideConfiguration(section, name, value);
+}
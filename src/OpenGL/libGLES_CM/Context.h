@@ -492,6 +492,10 @@ public:
 	void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices);
 	void drawTexture(GLfloat x, GLfloat y, GLfloat z, GLfloat width, GLfloat height);
 	void blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface *dest, const sw::SliceRect &dRect) override;
+	bool getPipelineProfile(EGLint attribute, EGLint *value) override;
+	bool getMemoryUsage(EGLint attribute, EGLint *value) override;
+	void setScheduling(EGLint priority, EGLint cpuShare) override;
+	bool getScheduling(EGLint attribute, EGLint *value) override;
 	void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLsizei *bufSize, void* pixels);
 	void clear(GLbitfield mask);
 	void flush();
@@ -581,6 +585,7 @@ public:
 private:
 	~Context() override;
 
+	void precompileRoutines();
 	bool applyRenderTarget();
 	void applyState(GLenum drawMode);
 	GLenum applyVertexBuffer(GLint base, GLint first, GLsizei count);
@@ -638,8 +643,12 @@ private:
 	bool mSampleStateDirty;
 	bool mFrontFaceDirty;
 	bool mDitherStateDirty;
+	bool mLightingStateDirty;
+	bool mModelViewMatrixDirty;
+	bool mProjectionMatrixDirty;
+	bool mTextureMatrixDirty[MAX_TEXTURE_UNITS];
 
-	sw::MatrixStack &currentMatrixStack();
+	sw::MatrixStack &currentMatrixStack();   // Marks the returned stack as modified
 	GLenum matrixMode;
 	sw::MatrixStack modelViewStack;
 	sw::MatrixStack projectionStack;
@@ -239,6 +239,16 @@ namespace es1
 		draw(type, 0, primitiveCount);
 	}
 
+	void Device::precompilePrimitive(sw::DrawType type)
+	{
+		if(!bindResources())
+		{
+			return;
+		}
+
+		precompile(type);
+	}
+
 	void Device::setScissorEnable(bool enable)
 	{
 		scissorEnable = enable;
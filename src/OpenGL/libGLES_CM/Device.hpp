@@ -51,6 +51,7 @@ namespace es1
 		void clearStencil(unsigned int stencil, unsigned int mask);
 		void drawIndexedPrimitive(sw::DrawType type, unsigned int indexOffset, unsigned int primitiveCount);
 		void drawPrimitive(sw::DrawType type, unsigned int primiveCount);
+		void precompilePrimitive(sw::DrawType type);
 		void setScissorEnable(bool enable);
 		void setRenderTarget(int index, egl::Image *renderTarget);
 		void setDepthBuffer(egl::Image *depthBuffer);
@@ -200,6 +200,7 @@ GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, Translat
 
 			translated[i].type = sw::STREAMTYPE_FLOAT;
 			translated[i].count = 4;
+			translated[i].normalized = false;
 			translated[i].stride = 0;
 			translated[i].offset = 0;
 		}
@@ -25,6 +25,7 @@ namespace sw
 {
 class FrameBuffer;
 enum Format : unsigned char;
+enum YUVLayout : unsigned char;
 }
 
 namespace egl
@@ -220,10 +221,12 @@ public:
 	void (*glDrawTexfvOES)(const GLfloat *coords);
 
 	egl::Context *(*es1CreateContext)(egl::Display *display, const egl::Context *shareContext, const egl::Config *config);
+	void (*overrideConfiguration)(const char *section, const char *name, int value);   // A null section clears the overrides
 	__eglMustCastToProperFunctionPointerType (*es1GetProcAddress)(const char *procname);
 	egl::Image *(*createBackBuffer)(int width, int height, sw::Format format, int multiSampleDepth);
 	egl::Image *(*createDepthStencil)(int width, int height, sw::Format format, int multiSampleDepth);
 	sw::FrameBuffer *(*createFrameBuffer)(void *nativeDisplay, EGLNativeWindowType window, int width, int height);
+	sw::FrameBuffer *(*createFrameBufferYUV)(int fileDescriptor, sw::YUVLayout layout, int frameCount, int width, int height);
 };
 
 class LibGLES_CM
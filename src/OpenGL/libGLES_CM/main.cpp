@@ -331,10 +331,12 @@ void DrawTexfvOES(const GLfloat *coords);
 }
 
 egl::Context *es1CreateContext(egl::Display *display, const egl::Context *shareContext, const egl::Config *config);
+void overrideConfiguration(const char *section, const char *name, int value);
 extern "C" __eglMustCastToProperFunctionPointerType es1GetProcAddress(const char *procname);
 egl::Image *createBackBuffer(int width, int height, sw::Format format, int multiSampleDepth);
 egl::Image *createDepthStencil(int width, int height, sw::Format format, int multiSampleDepth);
 sw::FrameBuffer *createFrameBuffer(void *nativeDisplay, EGLNativeWindowType window, int width, int height);
+sw::FrameBuffer *createFrameBufferYUV(int fileDescriptor, sw::YUVLayout layout, int frameCount, int width, int height);
 
 extern "C"
 {
@@ -1598,10 +1600,12 @@ LibGLES_CMexports::LibGLES_CMexports()
 	this->glDrawTexfvOES = es1::DrawTexfvOES;
 
 	this->es1CreateContext = ::es1CreateContext;
+	this->overrideConfiguration = ::overrideConfiguration;
 	this->es1GetProcAddress = ::es1GetProcAddress;
 	this->createBackBuffer = ::createBackBuffer;
 	this->createDepthStencil = ::createDepthStencil;
 	this->createFrameBuffer = ::createFrameBuffer;
+	this->createFrameBufferYUV = ::createFrameBufferYUV;
 }
 
 extern "C" GL_API LibGLES_CMexports *libGLES_CM_swiftshader()
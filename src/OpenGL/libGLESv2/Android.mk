@@ -33,6 +33,7 @@ endif
 
 COMMON_SRC_FILES := \
 	Buffer.cpp \
+	CommandTrace.cpp \
 	Context.cpp \
 	Device.cpp \
 	Fence.cpp \
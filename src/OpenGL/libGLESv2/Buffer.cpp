@@ -31,25 +31,42 @@ Buffer::Buffer(GLuint name) : NamedObject(name)
 	mSize = 0;
 	mUsage = GL_STATIC_DRAW;
 	mIsMapped = false;
+	mMapLocked = false;
 	mOffset = 0;
 	mLength = 0;
 	mAccess = 0;
+	mRendererWrites = false;
 }
 
 Buffer::~Buffer()
 {
+	invalidateIndexRanges();
+
 	if(mContents)
 	{
 		mContents->destruct();
 	}
+
+	releaseOrphans();
 }
 
 void Buffer::bufferData(const void *data, GLsizeiptr size, GLenum usage)
 {
-	if(mContents)
+	invalidateIndexRanges();
+
+	if(mContents && (size_t)size == mSize)
 	{
-		mContents->destruct();
-		mContents = 0;
+		orphan();
+	}
+	else
+	{
+		if(mContents)
+		{
+			mContents->destruct();
+			mContents = 0;
+		}
+
+		releaseOrphans();
 	}
 
 	mSize = size;
@@ -57,8 +74,7 @@ void Buffer::bufferData(const void *data, GLsizeiptr size, GLenum usage)
 
 	if(size > 0)
 	{
-		const int padding = 1024;   // For SIMD processing of vertices
-		mContents = new sw::Resource(size + padding);
+		mContents = newContents(!data);
 
 		if(!mContents)
 		{
@@ -75,8 +91,12 @@ void Buffer::bufferData(const void *data, GLsizeiptr size, GLenum usage)
 
 void Buffer::bufferSubData(const void *data, GLsizeiptr size, GLintptr offset)
 {
+	invalidateIndexRanges();
+
 	if(mContents && data)
 	{
+		detachPendingReads(size == (GLsizeiptr)mSize);
+
 		char *buffer = (char*)mContents->lock(sw::PUBLIC);
 		memcpy(buffer + offset, data, size);
 		mContents->unlock();
@@ -85,9 +105,30 @@ void Buffer::bufferSubData(const void *data, GLsizeiptr size, GLintptr offset)
 
 void* Buffer::mapRange(GLintptr offset, GLsizeiptr length, GLbitfield access)
 {
+	if(access & GL_MAP_WRITE_BIT)
+	{
+		invalidateIndexRanges();
+	}
+
+	if(mContents && (access & GL_MAP_INVALIDATE_BUFFER_BIT))
+	{
+		orphan();
+		mContents = newContents();
+	}
+
+	if(mContents && (access & GL_MAP_WRITE_BIT) && !(access & (GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)))
+	{
+		detachPendingReads((access & GL_MAP_INVALIDATE_RANGE_BIT) && offset == 0 && length == (GLsizeiptr)mSize);
+	}
+
 	if(mContents)
 	{
-		char* buffer = (char*)mContents->lock(sw::PUBLIC);
+		// Unsynchronized mappings leave it to the application to not modify data used by pending draws.
+		// Reading alongside pending draws is safe as long as they only read the contents too.
+		bool readOnly = !(access & GL_MAP_WRITE_BIT) && (!mRendererWrites || mContents->isIdle());
+		mMapLocked = !(access & GL_MAP_UNSYNCHRONIZED_BIT) && !readOnly;
+
+		char* buffer = mMapLocked ? (char*)mContents->lock(sw::PUBLIC) : (char*)mContents->data();
 		mIsMapped = true;
 		mOffset = offset;
 		mLength = length;
@@ -99,11 +140,12 @@ void* Buffer::mapRange(GLintptr offset, GLsizeiptr length, GLbitfield access)
 
 bool Buffer::unmap()
 {
-	if(mContents)
+	if(mContents && mMapLocked)
 	{
 		mContents->unlock();
 	}
 	mIsMapped = false;
+	mMapLocked = false;
 	mOffset = 0;
 	mLength = 0;
 	mAccess = 0;
@@ -115,4 +157,139 @@ sw::Resource *Buffer::getResource()
 	return mContents;
 }
 
+const IndexRange *Buffer::getIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart) const
+{
+	auto range = mIndexRanges.find({offset, count, type, primitiveRestart});
+
+	return (range != mIndexRanges.end()) ? &range->second : nullptr;
+}
+
+const IndexRange *Buffer::setIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart, IndexRange &range)
+{
+	if(mIndexRanges.size() == MAX_INDEX_RANGES)
+	{
+		invalidateIndexRanges();
+	}
+
+	IndexRange &entry = mIndexRanges[{offset, count, type, primitiveRestart}];
+	entry.minIndex = range.minIndex;
+	entry.maxIndex = range.maxIndex;
+	entry.restartIndices.swap(range.restartIndices);
+
+	return &entry;
+}
+
+void Buffer::setConvertedIndices(GLenum type, GLintptr offset, GLsizei count, GLenum mode, sw::Resource *indices)
+{
+	auto range = mIndexRanges.find({offset, count, type, true});
+
+	if(range == mIndexRanges.end())
+	{
+		indices->destruct();
+		return;
+	}
+
+	if(range->second.converted)
+	{
+		range->second.converted->destruct();
+	}
+
+	range->second.converted = indices;
+	range->second.convertedMode = mode;
+}
+
+void Buffer::invalidateIndexRanges()
+{
+	// Pending draws may still read the converted indices
+	for(auto &range : mIndexRanges)
+	{
+		if(range.second.converted)
+		{
+			range.second.converted->destruct();
+		}
+	}
+
+	mIndexRanges.clear();
+}
+
+void Buffer::rendererWrite()
+{
+	invalidateIndexRanges();
+	mRendererWrites = true;
+}
+
+void Buffer::orphan()
+{
+	if(mOrphans.size() == MAX_ORPHANS)
+	{
+		mOrphans.front()->destruct();
+		mOrphans.erase(mOrphans.begin());
+	}
+
+	mOrphans.push_back(mContents);
+	mContents = nullptr;
+	mRendererWrites = false;
+}
+
+void Buffer::copyOnWrite(bool overwrite)
+{
+	const void *previous = mContents->data();
+
+	orphan();
+	mContents = newContents(false);
+
+	if(!overwrite)
+	{
+		memcpy(const_cast<void*>(mContents->data()), previous, mSize);
+	}
+}
+
+void Buffer::detachPendingReads(bool overwrite)
+{
+	// Small buffers in use by pending draws get updated in a copy, instead of waiting for the draws
+	if(mContents->isIdle())
+	{
+		mRendererWrites = false;
+	}
+	else if(!mRendererWrites && (mSize <= MAX_COPY_ON_WRITE || overwrite))
+	{
+		copyOnWrite(overwrite);
+	}
+}
+
+sw::Resource *Buffer::newContents(bool clearToZero)
+{
+	for(size_t i = 0; i < mOrphans.size(); i++)
+	{
+		if(mOrphans[i]->isIdle())
+		{
+			sw::Resource *resource = mOrphans[i];
+			mOrphans.erase(mOrphans.begin() + i);
+
+			return resource;
+		}
+	}
+
+	if(clearToZero)
+	{
+		return new sw::Resource(mSize + PADDING);
+	}
+
+	// The caller writes the contents, only the padding read past them needs to be defined
+	sw::Resource *resource = new sw::Resource(mSize + PADDING, false);
+	memset((char*)resource->data() + mSize, 0, PADDING);
+
+	return resource;
+}
+
+void Buffer::releaseOrphans()
+{
+	for(sw::Resource *resource : mOrphans)
+	{
+		resource->destruct();
+	}
+
+	mOrphans.clear();
+}
+
 }
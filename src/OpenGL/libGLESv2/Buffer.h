@@ -25,10 +25,22 @@
 #include <GLES2/gl2.h>
 
 #include <cstddef>
+#include <map>
 #include <vector>
 
 namespace es2
 {
+// Result of scanning the indices of a draw call
+struct IndexRange
+{
+	GLuint minIndex;
+	GLuint maxIndex;
+	std::vector<GLsizei> restartIndices;   // Positions of the primitive restart index, when enabled
+
+	sw::Resource *converted = nullptr;   // The indices with the restarts left out, owned by the buffer
+	GLenum convertedMode = GL_NONE;      // Primitive type the indices were converted for
+};
+
 class Buffer : public gl::NamedObject
 {
 public:
@@ -53,11 +65,52 @@ public:
 
 	sw::Resource *getResource();
 
+	// Index ranges scanned by earlier draw calls, until the contents change
+	const IndexRange *getIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart) const;
+	const IndexRange *setIndexRange(GLenum type, GLintptr offset, GLsizei count, bool primitiveRestart, IndexRange &range);
+	void setConvertedIndices(GLenum type, GLintptr offset, GLsizei count, GLenum mode, sw::Resource *indices);
+	void invalidateIndexRanges();   // For writes which don't go through the methods above
+	void rendererWrite();           // Pending draw calls or readbacks write the contents
+
 private:
+	enum
+	{
+		MAX_ORPHANS = 4,               // Retired contents kept for reuse by the orphaning pattern
+		PADDING = 1024,                // For SIMD processing of vertices
+		MAX_INDEX_RANGES = 64,         // Distinct draw calls sourcing indices from the buffer
+		MAX_COPY_ON_WRITE = 0x4000,    // Larger buffers wait for in-flight draws instead of getting copied
+	};
+
+	struct IndexRangeKey
+	{
+		bool operator<(const IndexRangeKey &other) const
+		{
+			if(offset != other.offset) return offset < other.offset;
+			if(count != other.count) return count < other.count;
+			if(type != other.type) return type < other.type;
+			return primitiveRestart < other.primitiveRestart;
+		}
+
+		GLintptr offset;
+		GLsizei count;
+		GLenum type;
+		bool primitiveRestart;
+	};
+
+	void orphan();                // Retires the current contents, which in-flight draws keep using
+	sw::Resource *newContents(bool clearToZero = true);  // Reuses an idle retired resource when possible
+	void releaseOrphans();
+	void copyOnWrite(bool overwrite);   // Updates go to a copy while in-flight draws read the current contents
+	void detachPendingReads(bool overwrite);   // Copies on write when waiting for the draws can be avoided
+
 	sw::Resource *mContents;
+	std::vector<sw::Resource*> mOrphans;
+	std::map<IndexRangeKey, IndexRange> mIndexRanges;
+	bool mRendererWrites;   // The contents can't be copied until the renderer is done with them
 	size_t mSize;
 	GLenum mUsage;
 	bool mIsMapped;
+	bool mMapLocked;   // The mapping holds the public lock
 	GLintptr mOffset;
 	GLsizeiptr mLength;
 	GLbitfield mAccess;
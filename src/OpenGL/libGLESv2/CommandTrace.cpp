@@ -0,0 +1,316 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// CommandTrace.cpp: Implements the es2::CommandTrace class, which captures GL calls for replaying them.
+
+#include "CommandTrace.h"
+
+#include "main.h"
+#include "Buffer.h"
+#include "Context.h"
+#include "libEGL/Config.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace sw
+{
+	extern bool commandTrace;
+}
+
+namespace es2
+{
+
+CommandTrace *CommandTrace::trace = nullptr;
+
+CommandTrace::CommandTrace(FILE *file) : file(file)
+{
+	uint32_t header[2] = {MAGIC, VERSION};
+	fwrite(header, sizeof(header), 1, file);
+}
+
+void CommandTrace::configure()
+{
+	static std::mutex configureMutex;
+	std::lock_guard<std::mutex> lock(configureMutex);
+
+	if(sw::commandTrace && !trace)
+	{
+		FILE *file = fopen("sw-gl-trace.bin", "wb");
+
+		if(file)
+		{
+			trace = new CommandTrace(file);   // Never deleted, since other threads may be capturing
+		}
+	}
+}
+
+CommandTrace::Data CommandTrace::string(const char *string)
+{
+	return {string, string ? strlen(string) : 0, false};
+}
+
+CommandTrace::Data CommandTrace::pixels(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels)
+{
+	Context *context = getContext();
+
+	if(context && context->getPixelUnpackBuffer())
+	{
+		return {pixels, 0, true};
+	}
+
+	if(!pixels || !context || width <= 0 || height <= 0 || depth <= 0)
+	{
+		return {pixels, 0, false};
+	}
+
+	// Only the memory Image::loadImageData reads, which excludes the padding after the last row
+	const gl::PixelStorageModes &unpack = context->getUnpackParameters();
+	GLsizei inputWidth = (unpack.rowLength == 0) ? width : unpack.rowLength;
+	GLsizei inputPitch = gl::ComputePitch(inputWidth, format, type, unpack.alignment);
+	GLsizei inputHeight = (unpack.imageHeight == 0) ? height : unpack.imageHeight;
+	size_t offset = gl::ComputePackingOffset(format, type, inputWidth, inputHeight, unpack);
+	size_t size = offset + ((size_t)(depth - 1) * inputHeight + (height - 1)) * inputPitch + gl::ComputePitch(width, format, type, 1);
+
+	return {pixels, size, false};
+}
+
+CommandTrace::Data CommandTrace::compressed(GLsizei imageSize, const void *data)
+{
+	Context *context = getContext();
+
+	if(context && context->getPixelUnpackBuffer())
+	{
+		return {data, 0, true};
+	}
+
+	return {data, (size_t)std::max(imageSize, 0), false};
+}
+
+void CommandTrace::makeCurrent(const Context *context, const egl::Config *config, GLsizei width, GLsizei height)
+{
+	uint32_t id = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		while(id < contexts.size() && contexts[id] != context)
+		{
+			id++;
+		}
+
+		if(id == contexts.size())
+		{
+			contexts.push_back(context);
+		}
+	}
+
+	record(MakeCurrent, id, context->getClientVersion(), width, height,
+	       config->mRedSize, config->mGreenSize, config->mBlueSize, config->mAlphaSize,
+	       config->mDepthSize, config->mStencilSize, config->mSamples);
+}
+
+void CommandTrace::frame()
+{
+	record(Frame);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	fflush(file);
+}
+
+void CommandTrace::shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+{
+	if(count < 0 || !string)
+	{
+		return record(ShaderSource, shader, count);   // Fails the same way on replay
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	begin(ShaderSource);
+	write(shader, count);
+
+	for(GLsizei i = 0; i < count; i++)
+	{
+		size_t size = (length && length[i] >= 0) ? length[i] : (string[i] ? strlen(string[i]) : 0);
+		put(data(string[i], size));
+	}
+
+	end();
+}
+
+void CommandTrace::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels)
+{
+	Context *context = getContext();
+
+	if(context && context->getPixelPackBuffer())
+	{
+		return record(ReadPixels, x, y, width, height, format, type, Data{pixels, 0, true}, (uint32_t)0);
+	}
+
+	size_t size = 0;
+
+	if(context && width > 0 && height > 0)
+	{
+		GLint alignment = 4;
+		context->getIntegerv(GL_PACK_ALIGNMENT, &alignment);
+		size = (size_t)gl::ComputePitch(width, format, type, alignment) * height;
+	}
+
+	// Replay reads into memory of its own, so only the size of the client memory is captured
+	record(ReadPixels, x, y, width, height, format, type, Data{nullptr, 0, false}, (uint32_t)size);
+}
+
+void CommandTrace::drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+	if(first >= 0 && count > 0)
+	{
+		clientArrays(first + count, instanceCount);
+	}
+
+	if(instanceCount == 1)
+	{
+		record(DrawArrays, mode, first, count);
+	}
+	else
+	{
+		record(DrawArraysInstanced, mode, first, count, instanceCount);
+	}
+}
+
+template<typename Index>
+static GLsizei countVertices(const void *indices, GLsizei count, bool primitiveRestart)
+{
+	const Index *index = static_cast<const Index*>(indices);
+	const Index restartIndex = static_cast<Index>(-1);
+	GLsizei maxIndex = -1;
+
+	for(GLsizei i = 0; i < count; i++)
+	{
+		if(!(primitiveRestart && index[i] == restartIndex) && (GLsizei)index[i] > maxIndex)
+		{
+			maxIndex = index[i];
+		}
+	}
+
+	return maxIndex + 1;
+}
+
+void CommandTrace::drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount)
+{
+	Context *context = getContext();
+	Buffer *elementBuffer = context ? context->getElementArrayBuffer() : nullptr;
+
+	size_t indexSize = (type == GL_UNSIGNED_INT) ? 4 : (type == GL_UNSIGNED_SHORT) ? 2 : (type == GL_UNSIGNED_BYTE) ? 1 : 0;
+	Data indexData = elementBuffer ? Data{indices, 0, true} : data(indices, (indices && count > 0) ? count * indexSize : 0);
+
+	if(context && count > 0 && indexSize)
+	{
+		// The vertex count is only needed for client-side vertex arrays, but scanning the indices is cheap compared to capturing
+		const void *source = elementBuffer ? (const char*)elementBuffer->data() + (size_t)indices : indices;
+		size_t available = elementBuffer ? elementBuffer->size() : ~(size_t)0;
+
+		if(source && (!elementBuffer || (size_t)indices + count * indexSize <= available))
+		{
+			bool primitiveRestart = context->isPrimitiveRestartFixedIndexEnabled();
+			GLsizei vertices = 0;
+
+			switch(type)
+			{
+			case GL_UNSIGNED_BYTE:  vertices = countVertices<GLubyte>(source, count, primitiveRestart);  break;
+			case GL_UNSIGNED_SHORT: vertices = countVertices<GLushort>(source, count, primitiveRestart); break;
+			case GL_UNSIGNED_INT:   vertices = countVertices<GLuint>(source, count, primitiveRestart);   break;
+			}
+
+			clientArrays(vertices, instanceCount);
+		}
+	}
+
+	if(instanceCount == 1)
+	{
+		record(DrawElements, mode, count, type, indexData);
+	}
+	else
+	{
+		record(DrawElementsInstanced, mode, count, type, indexData, instanceCount);
+	}
+}
+
+void CommandTrace::clientArrays(GLsizei vertexCount, GLsizei instanceCount)
+{
+	Context *context = getContext();
+
+	if(!context || vertexCount <= 0)
+	{
+		return;
+	}
+
+	const VertexAttributeArray &attributes = context->getVertexArrayAttributes();
+
+	for(GLuint i = 0; i < MAX_VERTEX_ATTRIBS; i++)
+	{
+		const VertexAttribute &attribute = attributes[i];
+
+		if(!attribute.mArrayEnabled || attribute.mBoundBuffer || !attribute.mPointer)
+		{
+			continue;
+		}
+
+		GLsizei elements = attribute.mDivisor ? (std::max(instanceCount, 1) - 1) / attribute.mDivisor + 1 : vertexCount;
+		size_t size = (size_t)(elements - 1) * attribute.stride() + attribute.typeSize();
+
+		record(ClientArray, i, attribute.mSize, attribute.mType, (GLboolean)attribute.mNormalized, attribute.mStride, data(attribute.mPointer, size));
+	}
+}
+
+void CommandTrace::begin(Call call)
+{
+	buffer.clear();
+	put(call);
+	put((uint32_t)0);   // Patched by end()
+}
+
+void CommandTrace::end()
+{
+	uint32_t size = (uint32_t)(buffer.size() - sizeof(Call) - sizeof(uint32_t));
+	memcpy(&buffer[sizeof(Call)], &size, sizeof(size));
+
+	fwrite(buffer.data(), buffer.size(), 1, file);
+}
+
+void CommandTrace::put(Data data)
+{
+	if(data.offset)
+	{
+		put((uint32_t)OffsetData);
+		put((int64_t)(intptr_t)data.pointer);
+	}
+	else if(!data.pointer)
+	{
+		put((uint32_t)NullData);
+	}
+	else
+	{
+		put((uint32_t)data.size);
+		append(data.pointer, data.size);
+	}
+}
+
+void CommandTrace::append(const void *bytes, size_t size)
+{
+	const unsigned char *begin = static_cast<const unsigned char*>(bytes);
+	buffer.insert(buffer.end(), begin, begin + size);
+}
+
+}
@@ -0,0 +1,270 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// CommandTrace.h: Defines the es2::CommandTrace class, which captures the OpenGL ES 2.0 entry
+// points and the client memory they read into a binary stream, for tests/GLTraceReplay to play back.
+//
+// The stream starts with the 32-bit magic and version numbers, followed by one record per call:
+// a 16-bit Call, the 32-bit size of the arguments, and the arguments in the order of the entry
+// point's parameters. Arguments are stored in their native size, except pointer-sized integers
+// which the entry points cast to 64-bit. Memory arguments are a 32-bit size followed by that many
+// bytes, or one of the NullData and OffsetData sizes, the latter followed by a 64-bit offset.
+
+#ifndef LIBGLESV2_COMMANDTRACE_H_
+#define LIBGLESV2_COMMANDTRACE_H_
+
+#include <GLES2/gl2.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace egl
+{
+class Config;
+}
+
+namespace es2
+{
+
+class Context;
+
+class CommandTrace
+{
+public:
+	enum : uint32_t
+	{
+		MAGIC = 0x54475753,   // "SWGT"
+		VERSION = 2,
+
+		NullData = 0xFFFFFFFF,
+		OffsetData = 0xFFFFFFFE,   // Into the bound buffer object
+	};
+
+	enum Call : uint16_t
+	{
+		// Not GL entry points
+		MakeCurrent,   // Context ID, client version, surface width and height, then the red, green, blue, alpha, depth and stencil bits and samples of its config
+		Frame,         // eglSwapBuffers
+		ClientArray,   // Attribute index, size, type, normalized, stride and client memory read by the next draw
+
+		ActiveTexture,
+		AttachShader,
+		BeginQueryEXT,
+		BindAttribLocation,
+		BindBuffer,
+		BindFramebuffer,
+		BindRenderbuffer,
+		BindTexture,
+		BlendColor,
+		BlendEquation,
+		BlendEquationSeparate,
+		BlendFunc,
+		BlendFuncSeparate,
+		BlitFramebufferANGLE,
+		BlitFramebufferNV,
+		BufferData,
+		BufferSubData,
+		Clear,
+		ClearColor,
+		ClearDepthf,
+		ClearStencil,
+		ColorMask,
+		CompileShader,
+		CompressedTexImage2D,
+		CompressedTexImage3D,
+		CompressedTexSubImage2D,
+		CompressedTexSubImage3D,
+		CopyTexImage2D,
+		CopyTexSubImage2D,
+		CopyTexSubImage3D,
+		CreateProgram,
+		CreateShader,
+		CullFace,
+		DeleteBuffers,
+		DeleteFramebuffers,
+		DeleteProgram,
+		DeleteQueriesEXT,
+		DeleteRenderbuffers,
+		DeleteShader,
+		DeleteTextures,
+		DepthFunc,
+		DepthMask,
+		DepthRangef,
+		DetachShader,
+		Disable,
+		DisableVertexAttribArray,
+		DrawArrays,
+		DrawArraysInstanced,
+		DrawBuffersEXT,
+		DrawElements,
+		DrawElementsInstanced,
+		Enable,
+		EnableVertexAttribArray,
+		EndQueryEXT,
+		Finish,
+		Flush,
+		FramebufferRenderbuffer,
+		FramebufferTexture2D,
+		FramebufferTexture3D,
+		FrontFace,
+		GenBuffers,
+		GenerateMipmap,
+		GenFramebuffers,
+		GenQueriesEXT,
+		GenRenderbuffers,
+		GenTextures,
+		Hint,
+		LineWidth,
+		LinkProgram,
+		PixelStorei,
+		PolygonOffset,
+		QueryCounterEXT,
+		ReadPixels,   // Followed by the size of the client memory written to, if not a buffer offset
+		RenderbufferStorage,
+		RenderbufferStorageMultisample,
+		SampleCoverage,
+		Scissor,
+		ShaderSource,   // Shader, count, then each string without a terminator
+		StencilFunc,
+		StencilFuncSeparate,
+		StencilMask,
+		StencilMaskSeparate,
+		StencilOp,
+		StencilOpSeparate,
+		TexImage2D,
+		TexImage3D,
+		TexParameterf,
+		TexParameterfv,
+		TexParameteri,
+		TexParameteriv,
+		TexSubImage2D,
+		TexSubImage3D,
+		Uniform1f,
+		Uniform1fv,
+		Uniform1i,
+		Uniform1iv,
+		Uniform2f,
+		Uniform2fv,
+		Uniform2i,
+		Uniform2iv,
+		Uniform3f,
+		Uniform3fv,
+		Uniform3i,
+		Uniform3iv,
+		Uniform4f,
+		Uniform4fv,
+		Uniform4i,
+		Uniform4iv,
+		UniformMatrix2fv,
+		UniformMatrix3fv,
+		UniformMatrix4fv,
+		UseProgram,
+		VertexAttrib1f,
+		VertexAttrib1fv,
+		VertexAttrib2f,
+		VertexAttrib2fv,
+		VertexAttrib3f,
+		VertexAttrib3fv,
+		VertexAttrib4f,
+		VertexAttrib4fv,
+		VertexAttribDivisor,
+		VertexAttribPointer,   // The pointer is stored as a 64-bit offset
+		Viewport,
+
+		CallCount
+	};
+
+	struct Data
+	{
+		const void *pointer;
+		size_t size;
+		bool offset;   // The pointer is an offset into a buffer object
+	};
+
+	static CommandTrace *get() { return trace; }   // Null unless capturing
+
+	// Starts capturing to sw-gl-trace.bin in the working directory when enabled by the configuration.
+	// Capturing lasts until the process exits, with the stream flushed at each frame.
+	static void configure();
+
+	template<typename... Arguments>
+	void record(Call call, Arguments... arguments)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		begin(call);
+		write(arguments...);
+		end();
+	}
+
+	static Data data(const void *pointer, size_t size) { return {pointer, size, false}; }
+	static Data string(const char *string);
+
+	// Client memory, or an offset into the pixel unpack buffer when one is bound
+	static Data pixels(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels);
+	static Data compressed(GLsizei imageSize, const void *data);
+
+	void makeCurrent(const Context *context, const egl::Config *config, GLsizei width, GLsizei height);
+	void frame();
+	void shaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length);
+	void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels);
+	void drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+	void drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount);
+
+private:
+	CommandTrace(FILE *file);
+
+	void begin(Call call);
+	void end();
+
+	void write() {}
+
+	template<typename T, typename... Rest>
+	void write(T value, Rest... rest)
+	{
+		put(value);
+		write(rest...);
+	}
+
+	template<typename T>
+	void put(T value)
+	{
+		static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Only values and Data can be traced");
+		append(&value, sizeof(T));
+	}
+
+	void put(Data data);
+
+	void append(const void *bytes, size_t size);
+
+	// Client memory read by a draw call which sources vertices 0 to vertexCount - 1
+	void clientArrays(GLsizei vertexCount, GLsizei instanceCount);
+
+	static CommandTrace *trace;
+
+	std::mutex mutex;
+	FILE *file;
+	std::vector<unsigned char> buffer;   // Arguments of the call being captured
+	std::vector<const Context*> contexts;   // Indexed by the traced context ID
+};
+
+}
+
+// Captures the call if capturing, for entry points with only value and CommandTrace::Data arguments
+#define CAPTURE(call, ...) do { if(es2::CommandTrace *trace = es2::CommandTrace::get()) trace->record(es2::CommandTrace::call, __VA_ARGS__); } while(0)
+
+#endif   // LIBGLESV2_COMMANDTRACE_H_
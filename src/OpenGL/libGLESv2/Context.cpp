@@ -22,6 +22,7 @@
 #include "utilities.h"
 #include "ResourceManager.h"
 #include "Buffer.h"
+#include "CommandTrace.h"
 #include "Fence.h"
 #include "Framebuffer.h"
 #include "Program.h"
@@ -37,10 +38,13 @@
 #include "libEGL/Display.h"
 #include "common/Surface.hpp"
 #include "Common/Half.hpp"
+#include "Common/Memory.hpp"
+#include "Common/Timer.hpp"
 
 #include <EGL/eglext.h>
 
 #include <algorithm>
+#include <climits>
 #include <string>
 
 namespace es2
@@ -173,6 +177,7 @@ Context::Context(egl::Display *display, const Context *shareContext, const egl::
 	mInvalidFramebufferOperation = false;
 
 	mHasBeenCurrent = false;
+	mSkippedStateChanges = 0;
 
 	markAllStateDirty();
 }
@@ -260,12 +265,22 @@ Context::~Context()
 	delete mVertexDataManager;
 	delete mIndexDataManager;
 
+	// Sync objects are shared with other contexts and can outlive the device
+	device->finish();
+	mResourceManager->detachFenceSyncs(device);
+	releaseReadbacks();
+
 	mResourceManager->release();
 	delete device;
 }
 
 void Context::makeCurrent(gl::Surface *surface)
 {
+	if(CommandTrace *trace = CommandTrace::get())
+	{
+		trace->makeCurrent(this, config, surface ? surface->getWidth() : 0, surface ? surface->getHeight() : 0);
+	}
+
 	if(!mHasBeenCurrent)
 	{
 		mVertexDataManager = new VertexDataManager(this);
@@ -328,6 +343,8 @@ EGLint Context::getConfigID() const
 void Context::markAllStateDirty()
 {
 	mAppliedProgramSerial = 0;
+	mAppliedFramebufferVersion = 0;
+	mAppliedStorageVersion = 0;
 
 	mDepthStateDirty = true;
 	mMaskStateDirty = true;
@@ -337,6 +354,13 @@ void Context::markAllStateDirty()
 	mSampleStateDirty = true;
 	mDitherStateDirty = true;
 	mFrontFaceDirty = true;
+	mCullStateDirty = true;
+	mRasterizerDiscardDirty = true;
+
+	for(int i = 0; i < MAX_COMBINED_TEXTURE_IMAGE_UNITS; i++)
+	{
+		mSamplerStateDirty[i] = true;
+	}
 }
 
 void Context::setClearColor(float red, float green, float blue, float alpha)
@@ -359,7 +383,11 @@ void Context::setClearStencil(int stencil)
 
 void Context::setCullFaceEnabled(bool enabled)
 {
-	mState.cullFaceEnabled = enabled;
+	if(mState.cullFaceEnabled != enabled)
+	{
+		mState.cullFaceEnabled = enabled;
+		mCullStateDirty = true;
+	}
 }
 
 bool Context::isCullFaceEnabled() const
@@ -369,7 +397,11 @@ bool Context::isCullFaceEnabled() const
 
 void Context::setCullMode(GLenum mode)
 {
-   mState.cullMode = mode;
+	if(mState.cullMode != mode)
+	{
+		mState.cullMode = mode;
+		mCullStateDirty = true;
+	}
 }
 
 void Context::setFrontFace(GLenum front)
@@ -378,6 +410,7 @@ void Context::setFrontFace(GLenum front)
 	{
 		mState.frontFace = front;
 		mFrontFaceDirty = true;
+		mCullStateDirty = true;
 	}
 }
 
@@ -649,7 +682,11 @@ bool Context::isPrimitiveRestartFixedIndexEnabled() const
 
 void Context::setRasterizerDiscardEnabled(bool enabled)
 {
-	mState.rasterizerDiscardEnabled = enabled;
+	if(mState.rasterizerDiscardEnabled != enabled)
+	{
+		mState.rasterizerDiscardEnabled = enabled;
+		mRasterizerDiscardDirty = true;
+	}
 }
 
 bool Context::isRasterizerDiscardEnabled() const
@@ -804,6 +841,11 @@ GLuint Context::getActiveQuery(GLenum target) const
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 		queryObject = mState.activeQuery[QUERY_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN];
 		break;
+	case GL_TIME_ELAPSED_EXT:
+		queryObject = mState.activeQuery[QUERY_TIME_ELAPSED];
+		break;
+	case GL_TIMESTAMP_EXT:
+		break;   // Never active, QueryCounterEXT completes it at once
 	default:
 		ASSERT(false);
 	}
@@ -940,7 +982,7 @@ GLuint Context::createFramebuffer()
 
 GLuint Context::createFence()
 {
-	return mFenceNameSpace.allocate(new Fence());
+	return mFenceNameSpace.allocate(new Fence(device));
 }
 
 // Returns an unused query name
@@ -957,7 +999,7 @@ GLuint Context::createVertexArray()
 
 GLsync Context::createFenceSync(GLenum condition, GLbitfield flags)
 {
-	GLuint handle = mResourceManager->createFenceSync(condition, flags);
+	GLuint handle = mResourceManager->createFenceSync(condition, flags, device);
 
 	return reinterpret_cast<GLsync>(static_cast<uintptr_t>(handle));
 }
@@ -1344,6 +1386,12 @@ void Context::beginQuery(GLenum target, GLuint query)
 					return error(GL_INVALID_OPERATION);
 				}
 				break;
+			case GL_TIME_ELAPSED_EXT:
+				if(target == GL_TIME_ELAPSED_EXT)
+				{
+					return error(GL_INVALID_OPERATION);
+				}
+				break;
 			default:
 				break;
 			}
@@ -1362,6 +1410,9 @@ void Context::beginQuery(GLenum target, GLuint query)
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 		qType = QUERY_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN;
 		break;
+	case GL_TIME_ELAPSED_EXT:
+		qType = QUERY_TIME_ELAPSED;
+		break;
 	default:
 		UNREACHABLE(target);
 		return error(GL_INVALID_ENUM);
@@ -1397,6 +1448,7 @@ void Context::endQuery(GLenum target)
 	case GL_ANY_SAMPLES_PASSED_EXT:                qType = QUERY_ANY_SAMPLES_PASSED;                    break;
 	case GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT:   qType = QUERY_ANY_SAMPLES_PASSED_CONSERVATIVE;       break;
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN: qType = QUERY_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN; break;
+	case GL_TIME_ELAPSED_EXT:                      qType = QUERY_TIME_ELAPSED;                          break;
 	default: UNREACHABLE(target); return;
 	}
 
@@ -1412,6 +1464,27 @@ void Context::endQuery(GLenum target)
 	mState.activeQuery[qType] = nullptr;
 }
 
+void Context::queryCounter(GLuint query, GLenum target)
+{
+	ASSERT(target == GL_TIMESTAMP_EXT);
+
+	Query *queryObject = createQuery(query, target);
+
+	// Check that name was obtained with glGenQueries
+	if(!queryObject)
+	{
+		return error(GL_INVALID_OPERATION);
+	}
+
+	// Check for type mismatch, which includes the active queries
+	if(queryObject->getType() != target)
+	{
+		return error(GL_INVALID_OPERATION);
+	}
+
+	queryObject->counter();
+}
+
 void Context::setFramebufferZero(Framebuffer *buffer)
 {
 	delete mFramebufferNameSpace.remove(0);
@@ -2141,6 +2214,12 @@ template<typename T> bool Context::getIntegerv(GLenum pname, T *params) const
 
 		*params = mState.samplerTexture[TEXTURE_3D][mState.activeSampler].name();
 		return true;
+	case GL_TIMESTAMP_EXT:
+		*params = (T)sw::Timer::nanoseconds();   // Same clock as the timer queries, only fits GetInteger64v
+		return true;
+	case GL_GPU_DISJOINT_EXT:
+		*params = GL_FALSE;   // The clock is monotonic and doesn't depend on the CPU frequency
+		return true;
 	case GL_DRAW_BUFFER0:
 	case GL_DRAW_BUFFER1:
 	case GL_DRAW_BUFFER2:
@@ -2302,8 +2381,7 @@ template<typename T> bool Context::getIntegerv(GLenum pname, T *params) const
 		*params = mState.pixelUnpackBuffer.name();
 		return true;
 	case GL_PROGRAM_BINARY_FORMATS:
-		// Since NUM_PROGRAM_BINARY_FORMATS is 0, the input
-		// should be a 0 sized array, so don't write to params
+		*params = GL_PROGRAM_BINARY_SWIFTSHADER;
 		return true;
 	case GL_READ_BUFFER:
 		{
@@ -2545,6 +2623,8 @@ bool Context::getQueryParameterInfo(GLenum pname, GLenum *type, unsigned int *nu
 	case GL_TEXTURE_BINDING_RECTANGLE_ARB:
 	case GL_TEXTURE_BINDING_EXTERNAL_OES:
 	case GL_TEXTURE_BINDING_3D_OES:
+	case GL_TIMESTAMP_EXT:
+	case GL_GPU_DISJOINT_EXT:
 	case GL_COPY_READ_BUFFER_BINDING:
 	case GL_COPY_WRITE_BUFFER_BINDING:
 	case GL_DRAW_BUFFER0:
@@ -2719,6 +2799,7 @@ void Context::applyScissor(int width, int height)
 bool Context::applyRenderTarget()
 {
 	Framebuffer *framebuffer = getDrawFramebuffer();
+	unsigned int storageVersion = Framebuffer::getStorageVersion();
 	int width, height, samples;
 
 	if(!framebuffer || (framebuffer->completeness(width, height, samples) != GL_FRAMEBUFFER_COMPLETE))
@@ -2726,30 +2807,38 @@ bool Context::applyRenderTarget()
 		return error(GL_INVALID_FRAMEBUFFER_OPERATION, false);
 	}
 
-	for(int i = 0; i < MAX_DRAW_BUFFERS; i++)
+	// The device keeps the applied images referenced, so they're still the attached ones unless a version changed
+	if(framebuffer->getVersion() != mAppliedFramebufferVersion || storageVersion != mAppliedStorageVersion)
 	{
-		if(framebuffer->getDrawBuffer(i) != GL_NONE)
-		{
-			egl::Image *renderTarget = framebuffer->getRenderTarget(i);
-			GLint layer = framebuffer->getColorbufferLayer(i);
-			device->setRenderTarget(i, renderTarget, layer);
-			if(renderTarget) renderTarget->release();
-		}
-		else
+		for(int i = 0; i < MAX_DRAW_BUFFERS; i++)
 		{
-			device->setRenderTarget(i, nullptr, 0);
+			if(framebuffer->getDrawBuffer(i) != GL_NONE)
+			{
+				egl::Image *renderTarget = framebuffer->getRenderTarget(i);
+				GLint layer = framebuffer->getColorbufferLayer(i);
+				device->setRenderTarget(i, renderTarget, layer);
+				if(renderTarget) renderTarget->release();
+			}
+			else
+			{
+				device->setRenderTarget(i, nullptr, 0);
+			}
 		}
-	}
 
-	egl::Image *depthBuffer = framebuffer->getDepthBuffer();
-	GLint dLayer = framebuffer->getDepthbufferLayer();
-	device->setDepthBuffer(depthBuffer, dLayer);
-	if(depthBuffer) depthBuffer->release();
+		egl::Image *depthBuffer = framebuffer->getDepthBuffer();
+		GLint dLayer = framebuffer->getDepthbufferLayer();
+		device->setDepthBuffer(depthBuffer, dLayer);
+		if(depthBuffer) depthBuffer->release();
 
-	egl::Image *stencilBuffer = framebuffer->getStencilBuffer();
-	GLint sLayer = framebuffer->getStencilbufferLayer();
-	device->setStencilBuffer(stencilBuffer, sLayer);
-	if(stencilBuffer) stencilBuffer->release();
+		egl::Image *stencilBuffer = framebuffer->getStencilBuffer();
+		GLint sLayer = framebuffer->getStencilbufferLayer();
+		device->setStencilBuffer(stencilBuffer, sLayer);
+		if(stencilBuffer) stencilBuffer->release();
+
+		mAppliedFramebufferVersion = framebuffer->getVersion();
+		mAppliedStorageVersion = storageVersion;
+	}
+	else mSkippedStateChanges++;
 
 	Viewport viewport;
 	float zNear = clamp01(mState.zNear);
@@ -2770,10 +2859,7 @@ bool Context::applyRenderTarget()
 
 	if(program)
 	{
-		GLfloat nearFarDiff[3] = {zNear, zFar, zFar - zNear};
-		program->setUniform1fv(program->getUniformLocation("gl_DepthRange.near"), 1, &nearFarDiff[0]);
-		program->setUniform1fv(program->getUniformLocation("gl_DepthRange.far"), 1, &nearFarDiff[1]);
-		program->setUniform1fv(program->getUniformLocation("gl_DepthRange.diff"), 1, &nearFarDiff[2]);
+		program->setDepthRange(zNear, zFar);
 	}
 
 	return true;
@@ -2785,14 +2871,20 @@ void Context::applyState(GLenum drawMode)
 	Framebuffer *framebuffer = getDrawFramebuffer();
 	bool frontFaceCCW = (mState.frontFace == GL_CCW);
 
-	if(mState.cullFaceEnabled)
-	{
-		device->setCullMode(es2sw::ConvertCullMode(mState.cullMode, mState.frontFace), frontFaceCCW);
-	}
-	else
+	if(mCullStateDirty)
 	{
-		device->setCullMode(sw::CULL_NONE, frontFaceCCW);
+		if(mState.cullFaceEnabled)
+		{
+			device->setCullMode(es2sw::ConvertCullMode(mState.cullMode, mState.frontFace), frontFaceCCW);
+		}
+		else
+		{
+			device->setCullMode(sw::CULL_NONE, frontFaceCCW);
+		}
+
+		mCullStateDirty = false;
 	}
+	else mSkippedStateChanges++;
 
 	if(mDepthStateDirty)
 	{
@@ -2808,6 +2900,7 @@ void Context::applyState(GLenum drawMode)
 
 		mDepthStateDirty = false;
 	}
+	else mSkippedStateChanges++;
 
 	if(mBlendStateDirty)
 	{
@@ -2833,6 +2926,7 @@ void Context::applyState(GLenum drawMode)
 
 		mBlendStateDirty = false;
 	}
+	else mSkippedStateChanges++;
 
 	if(mStencilStateDirty || mFrontFaceDirty)
 	{
@@ -2898,6 +2992,7 @@ void Context::applyState(GLenum drawMode)
 		mStencilStateDirty = false;
 		mFrontFaceDirty = false;
 	}
+	else mSkippedStateChanges++;
 
 	if(mMaskStateDirty)
 	{
@@ -2910,6 +3005,7 @@ void Context::applyState(GLenum drawMode)
 
 		mMaskStateDirty = false;
 	}
+	else mSkippedStateChanges++;
 
 	if(mPolygonOffsetStateDirty)
 	{
@@ -2931,6 +3027,7 @@ void Context::applyState(GLenum drawMode)
 
 		mPolygonOffsetStateDirty = false;
 	}
+	else mSkippedStateChanges++;
 
 	if(mSampleStateDirty)
 	{
@@ -2979,6 +3076,7 @@ void Context::applyState(GLenum drawMode)
 
 		mSampleStateDirty = false;
 	}
+	else mSkippedStateChanges++;
 
 	if(mDitherStateDirty)
 	{
@@ -2987,14 +3085,20 @@ void Context::applyState(GLenum drawMode)
 		mDitherStateDirty = false;
 	}
 
-	device->setRasterizerDiscard(mState.rasterizerDiscardEnabled);
+	if(mRasterizerDiscardDirty)
+	{
+		device->setRasterizerDiscard(mState.rasterizerDiscardEnabled);
+
+		mRasterizerDiscardDirty = false;
+	}
+	else mSkippedStateChanges++;
 }
 
-GLenum Context::applyVertexBuffer(GLint base, GLint first, GLsizei count, GLsizei instanceId)
+GLenum Context::applyVertexBuffer(GLint base, GLint first, GLsizei count, GLsizei instanceId, GLsizei instanceCount)
 {
 	TranslatedAttribute attributes[MAX_VERTEX_ATTRIBS];
 
-	GLenum err = mVertexDataManager->prepareVertexData(first, count, attributes, instanceId);
+	GLenum err = mVertexDataManager->prepareVertexData(first, count, attributes, instanceId, instanceCount);
 	if(err != GL_NO_ERROR)
 	{
 		return err;
@@ -3016,13 +3120,17 @@ GLenum Context::applyVertexBuffer(GLint base, GLint first, GLsizei count, GLsize
 
 		int stride = attributes[i].stride;
 
-		buffer = (char*)buffer + stride * base;
+		if(!attributes[i].divisor)
+		{
+			buffer = (char*)buffer + stride * base;
+		}
 
 		sw::Stream attribute(resource, buffer, stride);
 
 		attribute.type = attributes[i].type;
 		attribute.count = attributes[i].count;
 		attribute.normalized = attributes[i].normalized;
+		attribute.divisor = attributes[i].divisor;
 
 		int stream = program->getAttributeStream(i);
 		device->setInputStream(stream, attribute);
@@ -3039,6 +3147,12 @@ GLenum Context::applyIndexBuffer(const void *indices, GLuint start, GLuint end,
 	if(err == GL_NO_ERROR)
 	{
 		device->setIndexBuffer(indexInfo->indexBuffer);
+		device->setIndexRange(indexInfo->minIndex, indexInfo->maxIndex);
+
+		if(indexInfo->restartIndices)
+		{
+			device->setRestartIndices(indexInfo->restartIndices->data(), indexInfo->restartIndices->size());
+		}
 	}
 
 	return err;
@@ -3127,23 +3241,53 @@ void Context::applyTextures(sw::SamplerType samplerType)
 				GLenum swizzleB = texture->getSwizzleB();
 				GLenum swizzleA = texture->getSwizzleA();
 
-				device->setAddressingModeU(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapS));
-				device->setAddressingModeV(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapT));
-				device->setAddressingModeW(samplerType, samplerIndex, es2sw::ConvertTextureWrap(wrapR));
-				device->setCompareFunc(samplerType, samplerIndex, es2sw::ConvertCompareFunc(compFunc, compMode));
-				device->setSwizzleR(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleR));
-				device->setSwizzleG(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleG));
-				device->setSwizzleB(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleB));
-				device->setSwizzleA(samplerType, samplerIndex, es2sw::ConvertSwizzleType(swizzleA));
-				device->setMinLod(samplerType, samplerIndex, minLOD);
-				device->setMaxLod(samplerType, samplerIndex, maxLOD);
-				device->setBaseLevel(samplerType, samplerIndex, baseLevel);
-				device->setMaxLevel(samplerType, samplerIndex, maxLevel);
-				device->setTextureFilter(samplerType, samplerIndex, es2sw::ConvertTextureFilter(minFilter, magFilter, maxAnisotropy));
-				device->setMipmapFilter(samplerType, samplerIndex, es2sw::ConvertMipMapFilter(minFilter));
-				device->setMaxAnisotropy(samplerType, samplerIndex, maxAnisotropy);
-				device->setHighPrecisionFiltering(samplerType, samplerIndex, mState.textureFilteringHint == GL_NICEST);
-				device->setSyncRequired(samplerType, samplerIndex, texture->requiresSync());
+				SamplerState state;
+				state.addressingModeU = es2sw::ConvertTextureWrap(wrapS);
+				state.addressingModeV = es2sw::ConvertTextureWrap(wrapT);
+				state.addressingModeW = es2sw::ConvertTextureWrap(wrapR);
+				state.compareFunc = es2sw::ConvertCompareFunc(compFunc, compMode);
+				state.swizzleR = es2sw::ConvertSwizzleType(swizzleR);
+				state.swizzleG = es2sw::ConvertSwizzleType(swizzleG);
+				state.swizzleB = es2sw::ConvertSwizzleType(swizzleB);
+				state.swizzleA = es2sw::ConvertSwizzleType(swizzleA);
+				state.minLod = minLOD;
+				state.maxLod = maxLOD;
+				state.baseLevel = baseLevel;
+				state.maxLevel = maxLevel;
+				state.textureFilter = es2sw::ConvertTextureFilter(minFilter, magFilter, maxAnisotropy);
+				state.mipmapFilter = es2sw::ConvertMipMapFilter(minFilter);
+				state.maxAnisotropy = maxAnisotropy;
+				state.highPrecisionFiltering = (mState.textureFilteringHint == GL_NICEST);
+				state.syncRequired = texture->requiresSync();
+
+				// Texture and sampler objects can be modified behind the context's back, so compare against what was last set
+				int unit = (samplerType == sw::SAMPLER_PIXEL) ? samplerIndex : MAX_TEXTURE_IMAGE_UNITS + samplerIndex;
+				SamplerState &applied = mAppliedSamplerState[unit];
+
+				if(mSamplerStateDirty[unit] || !(state == applied))
+				{
+					device->setAddressingModeU(samplerType, samplerIndex, state.addressingModeU);
+					device->setAddressingModeV(samplerType, samplerIndex, state.addressingModeV);
+					device->setAddressingModeW(samplerType, samplerIndex, state.addressingModeW);
+					device->setCompareFunc(samplerType, samplerIndex, state.compareFunc);
+					device->setSwizzleR(samplerType, samplerIndex, state.swizzleR);
+					device->setSwizzleG(samplerType, samplerIndex, state.swizzleG);
+					device->setSwizzleB(samplerType, samplerIndex, state.swizzleB);
+					device->setSwizzleA(samplerType, samplerIndex, state.swizzleA);
+					device->setMinLod(samplerType, samplerIndex, state.minLod);
+					device->setMaxLod(samplerType, samplerIndex, state.maxLod);
+					device->setBaseLevel(samplerType, samplerIndex, state.baseLevel);
+					device->setMaxLevel(samplerType, samplerIndex, state.maxLevel);
+					device->setTextureFilter(samplerType, samplerIndex, state.textureFilter);
+					device->setMipmapFilter(samplerType, samplerIndex, state.mipmapFilter);
+					device->setMaxAnisotropy(samplerType, samplerIndex, state.maxAnisotropy);
+					device->setHighPrecisionFiltering(samplerType, samplerIndex, state.highPrecisionFiltering);
+					device->setSyncRequired(samplerType, samplerIndex, state.syncRequired);
+
+					applied = state;
+					mSamplerStateDirty[unit] = false;
+				}
+				else mSkippedStateChanges++;
 
 				applyTexture(samplerType, samplerIndex, texture);
 			}
@@ -3303,9 +3447,16 @@ void Context::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 		return error(GL_INVALID_OPERATION);
 	}
 
+	releaseReadbacks();
+
 	GLsizei outputWidth = (mState.packParameters.rowLength > 0) ? mState.packParameters.rowLength : width;
 	GLsizei outputPitch = gl::ComputePitch(outputWidth, format, type, mState.packParameters.alignment);
 	GLsizei outputHeight = (mState.packParameters.imageHeight == 0) ? height : mState.packParameters.imageHeight;
+	if(getPixelPackBuffer())
+	{
+		getPixelPackBuffer()->rendererWrite();
+	}
+
 	pixels = getPixelPackBuffer() ? (unsigned char*)getPixelPackBuffer()->data() + (ptrdiff_t)pixels : (unsigned char*)pixels;
 	pixels = ((char*)pixels) + gl::ComputePackingOffset(format, type, outputWidth, outputHeight, mState.packParameters);
 
@@ -3335,11 +3486,35 @@ void Context::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 		return error(GL_INVALID_OPERATION);
 	}
 
+	// Pack buffers are written once the pending draw calls are done, without waiting for them here
+	Buffer *packBuffer = getPixelPackBuffer();
+
+	sw::Rect sourceRect(x, y, x + width, y + height);
+	sw::Format readFormat = gl::ConvertReadFormatType(format, type);
+
+	if(packBuffer && packBuffer->getResource())
+	{
+		int64_t sequence = device->queueReadback(renderTarget, sourceRect, packBuffer->getResource(), pixels, readFormat, outputPitch);
+
+		if(sequence)
+		{
+			mPendingReadbacks.push_back({renderTarget, sequence});
+			return;
+		}
+	}
+
+	// Rows are copied or converted straight into the destination, without wrapping it in a surface
+	if(device->readPixels(renderTarget, sourceRect, pixels, readFormat, outputPitch))
+	{
+		renderTarget->release();
+		return;
+	}
+
 	sw::RectF rect((float)x, (float)y, (float)(x + width), (float)(y + height));
 	sw::Rect dstRect(0, 0, width, height);
 	rect.clip(0.0f, 0.0f, (float)renderTarget->getWidth(), (float)renderTarget->getHeight());
 
-	sw::Surface *externalSurface = sw::Surface::create(width, height, 1, gl::ConvertReadFormatType(format, type), pixels, outputPitch, outputPitch * outputHeight);
+	sw::Surface *externalSurface = sw::Surface::create(width, height, 1, readFormat, pixels, outputPitch, outputPitch * outputHeight);
 	sw::SliceRectF sliceRect(rect);
 	sw::SliceRect dstSliceRect(dstRect);
 	device->blit(renderTarget, sliceRect, externalSurface, dstSliceRect, false, false, false);
@@ -3520,11 +3695,15 @@ void Context::drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instan
 
 	applyState(mode);
 
-	for(int i = 0; i < instanceCount; ++i)
+	TransformFeedback* transformFeedback = getTransformFeedback();
+	GLsizei instances = batchedInstances(primitiveCount, instanceCount);
+
+	for(int i = 0; i < instanceCount; i += instances)
 	{
 		device->setInstanceID(i);
+		device->setInstanceCount(instances);
 
-		GLenum err = applyVertexBuffer(0, first, count, i);
+		GLenum err = applyVertexBuffer(0, first, count, i, instances);
 		if(err != GL_NO_ERROR)
 		{
 			return error(err);
@@ -3543,7 +3722,6 @@ void Context::drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instan
 			return;
 		}
 
-		TransformFeedback* transformFeedback = getTransformFeedback();
 		if(!cullSkipsDraw(mode) || (transformFeedback->isActive() && !transformFeedback->isPaused()))
 		{
 			device->drawPrimitive(primitiveType, primitiveCount);
@@ -3572,22 +3750,11 @@ void Context::drawElements(GLenum mode, GLuint start, GLuint end, GLsizei count,
 		return error(GL_INVALID_OPERATION);
 	}
 
+	// Line loops are converted to lines around the restart indices, strips and fans are restarted by the renderer
 	GLenum internalMode = mode;
-	if(isPrimitiveRestartFixedIndexEnabled())
+	if(isPrimitiveRestartFixedIndexEnabled() && mode == GL_LINE_LOOP)
 	{
-		switch(mode)
-		{
-		case GL_TRIANGLE_FAN:
-		case GL_TRIANGLE_STRIP:
-			internalMode = GL_TRIANGLES;
-			break;
-		case GL_LINE_LOOP:
-		case GL_LINE_STRIP:
-			internalMode = GL_LINES;
-			break;
-		default:
-			break;
-		}
+		internalMode = GL_LINES;
 	}
 
 	sw::DrawType primitiveType;
@@ -3608,12 +3775,16 @@ void Context::drawElements(GLenum mode, GLuint start, GLuint end, GLsizei count,
 
 	applyState(internalMode);
 
-	for(int i = 0; i < instanceCount; ++i)
+	TransformFeedback* transformFeedback = getTransformFeedback();
+	GLsizei instances = batchedInstances(indexInfo.primitiveCount, instanceCount);
+
+	for(int i = 0; i < instanceCount; i += instances)
 	{
 		device->setInstanceID(i);
+		device->setInstanceCount(instances);
 
 		GLsizei vertexCount = indexInfo.maxIndex - indexInfo.minIndex + 1;
-		err = applyVertexBuffer(-(int)indexInfo.minIndex, indexInfo.minIndex, vertexCount, i);
+		err = applyVertexBuffer(-(int)indexInfo.minIndex, indexInfo.minIndex, vertexCount, i, instances);
 		if(err != GL_NO_ERROR)
 		{
 			return error(err);
@@ -3632,7 +3803,6 @@ void Context::drawElements(GLenum mode, GLuint start, GLuint end, GLsizei count,
 			return;
 		}
 
-		TransformFeedback* transformFeedback = getTransformFeedback();
 		if(!cullSkipsDraw(internalMode) || (transformFeedback->isActive() && !transformFeedback->isPaused()))
 		{
 			device->drawIndexedPrimitive(primitiveType, indexInfo.indexOffset, indexInfo.primitiveCount);
@@ -3644,20 +3814,145 @@ void Context::drawElements(GLenum mode, GLuint start, GLuint end, GLsizei count,
 	}
 }
 
+// Instances drawn by each renderer draw call. Transform feedback captures them one at a time, in order.
+GLsizei Context::batchedInstances(int primitiveCount, GLsizei instanceCount)
+{
+	TransformFeedback* transformFeedback = getTransformFeedback();
+
+	if(transformFeedback && transformFeedback->isActive() && !transformFeedback->isPaused())
+	{
+		return 1;
+	}
+
+	if(primitiveCount > 0 && instanceCount > INT_MAX / primitiveCount)
+	{
+		return 1;
+	}
+
+	return instanceCount;
+}
+
 void Context::blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface *dest, const sw::SliceRect &dRect)
 {
 	sw::SliceRectF sRectF((float)sRect.x0, (float)sRect.y0, (float)sRect.x1, (float)sRect.y1, sRect.slice);
 	device->blit(source, sRectF, dest, dRect, false);
 }
 
+bool Context::getPipelineProfile(EGLint attribute, EGLint *value)
+{
+	if(attribute == EGL_PIPELINE_PROFILE_SWIFTSHADER)
+	{
+		*value = device->getPipelineProfiling() ? EGL_TRUE : EGL_FALSE;
+		return true;
+	}
+
+	if(attribute < EGL_PIPELINE_DRAW_CALLS_SWIFTSHADER || attribute > EGL_PIPELINE_DIVERGENT_BRANCHES_SWIFTSHADER)
+	{
+		return false;
+	}
+
+	device->finish();   // Draw calls are only accounted for once they retire
+	sw::PipelineProfile profile = device->getPipelineProfile();
+	int64_t drawCalls = std::max<int64_t>(profile.drawCalls, 1);
+	int64_t result = 0;
+
+	switch(attribute)
+	{
+	case EGL_PIPELINE_DRAW_CALLS_SWIFTSHADER:                result = profile.drawCalls;                                       break;
+	case EGL_PIPELINE_RASTERIZATION_SWIFTSHADER:             result = (int64_t)(1000 * profile.share(sw::PERF_PIXEL) + 0.5);  break;
+	case EGL_PIPELINE_DEPTH_STENCIL_SWIFTSHADER:             result = (int64_t)(1000 * profile.share(sw::PERF_PIPE) + 0.5);   break;
+	case EGL_PIPELINE_INTERPOLATION_SWIFTSHADER:             result = (int64_t)(1000 * profile.share(sw::PERF_INTERP) + 0.5); break;
+	case EGL_PIPELINE_SHADER_SWIFTSHADER:                    result = (int64_t)(1000 * profile.share(sw::PERF_SHADER) + 0.5); break;
+	case EGL_PIPELINE_TEXTURE_SWIFTSHADER:                   result = (int64_t)(1000 * profile.share(sw::PERF_TEX) + 0.5);    break;
+	case EGL_PIPELINE_RASTER_OPERATIONS_SWIFTSHADER:         result = (int64_t)(1000 * profile.share(sw::PERF_ROP) + 0.5);    break;
+	case EGL_PIPELINE_ROP_PIXELS_SWIFTSHADER:                result = profile.ropOperations / drawCalls;                       break;
+	case EGL_PIPELINE_TEXTURE_PIXELS_SWIFTSHADER:            result = profile.texOperations / drawCalls;                       break;
+	case EGL_PIPELINE_COMPRESSED_TEXTURE_PIXELS_SWIFTSHADER: result = profile.compressedTex / drawCalls;                       break;
+	case EGL_PIPELINE_EARLY_DEPTH_REJECTS_SWIFTSHADER:       result = profile.earlyDepthRejects / drawCalls;                   break;
+	case EGL_PIPELINE_COHERENT_BRANCHES_SWIFTSHADER:         result = profile.coherentBranches / drawCalls;                    break;
+	case EGL_PIPELINE_DIVERGENT_BRANCHES_SWIFTSHADER:        result = profile.divergentBranches / drawCalls;                   break;
+	}
+
+	*value = (EGLint)std::min<int64_t>(std::max<int64_t>(result, 0), 0x7FFFFFFF);
+
+	return true;
+}
+
+bool Context::getMemoryUsage(EGLint attribute, EGLint *value)
+{
+	if(attribute < EGL_MEMORY_GENERAL_SWIFTSHADER || attribute > EGL_PEAK_MEMORY_ROUTINE_SWIFTSHADER)
+	{
+		return false;
+	}
+
+	// Each library accounts for its own allocations, so this covers all of this library's contexts
+	int index = attribute - EGL_MEMORY_GENERAL_SWIFTSHADER;
+	sw::MemoryUsage usage = sw::memoryUsage((sw::MemoryCategory)(index % sw::MEMORY_CATEGORIES));
+	size_t bytes = (index < sw::MEMORY_CATEGORIES) ? usage.current : usage.peak;
+
+	*value = (EGLint)std::min<size_t>(bytes / 1024, 0x7FFFFFFF);
+
+	return true;
+}
+
+void Context::setScheduling(EGLint priority, EGLint cpuShare)
+{
+	switch(priority)
+	{
+	case EGL_CONTEXT_PRIORITY_HIGH_IMG: device->setSchedulingPriority(sw::PRIORITY_HIGH);   break;
+	case EGL_CONTEXT_PRIORITY_LOW_IMG:  device->setSchedulingPriority(sw::PRIORITY_LOW);    break;
+	default:                            device->setSchedulingPriority(sw::PRIORITY_MEDIUM); break;
+	}
+
+	device->setCpuShare(cpuShare);
+}
+
+bool Context::getScheduling(EGLint attribute, EGLint *value)
+{
+	switch(attribute)
+	{
+	case EGL_CONTEXT_PRIORITY_LEVEL_IMG:
+		switch(device->getSchedulingPriority())
+		{
+		case sw::PRIORITY_HIGH: *value = EGL_CONTEXT_PRIORITY_HIGH_IMG;   break;
+		case sw::PRIORITY_LOW:  *value = EGL_CONTEXT_PRIORITY_LOW_IMG;    break;
+		default:                *value = EGL_CONTEXT_PRIORITY_MEDIUM_IMG; break;
+		}
+		break;
+	case EGL_CPU_SHARE_SWIFTSHADER:
+		*value = device->getCpuShare();
+		break;
+	case EGL_WORKER_TIME_SWIFTSHADER:
+		*value = (EGLint)std::min<int64_t>(device->getWorkerTime() / 1000000, 0x7FFFFFFF);
+		break;
+	case EGL_WORKER_SHARE_SWIFTSHADER:
+		*value = device->getRecentWorkerShare();
+		break;
+	default:
+		return false;
+	}
+
+	return true;
+}
+
 void Context::finish()
 {
 	device->finish();
+	releaseReadbacks();
+}
+
+void Context::releaseReadbacks()
+{
+	while(!mPendingReadbacks.empty() && device->hasRetired(mPendingReadbacks.front().sequence))
+	{
+		mPendingReadbacks.front().renderTarget->release();
+		mPendingReadbacks.pop_front();
+	}
 }
 
 void Context::flush()
 {
-	// We don't queue anything without processing it as fast as possible
+	// Draw calls are queued to the renderer's threads, which process them as fast as possible
 }
 
 void Context::recordInvalidEnum()
@@ -4421,6 +4716,7 @@ const GLubyte *Context::getExtensions(GLuint index, GLuint *numExt) const
 		"GL_EXT_blend_minmax",
 		"GL_EXT_color_buffer_float",   // OpenGL ES 3.0 specific.
 		"GL_EXT_color_buffer_half_float",
+		"GL_EXT_disjoint_timer_query",
 		"GL_EXT_draw_buffers",
 		"GL_EXT_instanced_arrays",
 		"GL_EXT_occlusion_query_boolean",
@@ -4483,5 +4779,26 @@ const GLubyte *Context::getExtensions(GLuint index, GLuint *numExt) const
 
 NO_SANITIZE_FUNCTION egl::Context *es2CreateContext(egl::Display *display, const egl::Context *shareContext, const egl::Config *config)
 {
-	return new es2::Context(display, static_cast<const es2::Context*>(shareContext), config);
+	es2::Context *context = new es2::Context(display, static_cast<const es2::Context*>(shareContext), config);
+	es2::CommandTrace::configure();   // After the context's renderer has read the configuration
+
+	return context;
+}
+
+void es2EndFrame()
+{
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->frame();
+	}
+}
+
+void warmUpRoutines(const sw::Format *renderTargetFormats, int count)
+{
+	sw::Renderer::warmUpRoutines(renderTargetFormats, count);
+}
+
+void overrideConfiguration(const char *section, const char *name, int value)
+{
+	sw::Renderer::overrideConfiguration(section, name, value);
 }
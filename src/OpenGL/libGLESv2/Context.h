@@ -31,6 +31,7 @@
 #include <GLES3/gl3.h>
 #include <EGL/egl.h>
 
+#include <deque>
 #include <map>
 #include <string>
 
@@ -104,7 +105,7 @@ enum
 	MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS = 4,
 	MAX_UNIFORM_BUFFER_BINDINGS = sw::MAX_UNIFORM_BUFFER_BINDINGS,
 	UNIFORM_BUFFER_OFFSET_ALIGNMENT = 4,
-	NUM_PROGRAM_BINARY_FORMATS = 0,
+	NUM_PROGRAM_BINARY_FORMATS = 1,
 };
 
 const GLenum compressedTextureFormats[] =
@@ -159,6 +160,7 @@ const GLenum compressedTextureFormats[] =
 };
 
 const GLenum GL_TEXTURE_FILTERING_HINT_CHROMIUM = 0x8AF0;
+const GLenum GL_PROGRAM_BINARY_SWIFTSHADER = 0x9998;   // Unregistered, binaries are specific to the library build
 
 const GLint NUM_COMPRESSED_TEXTURE_FORMATS = sizeof(compressedTextureFormats) / sizeof(compressedTextureFormats[0]);
 
@@ -177,6 +179,7 @@ enum QueryType
 	QUERY_ANY_SAMPLES_PASSED,
 	QUERY_ANY_SAMPLES_PASSED_CONSERVATIVE,
 	QUERY_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN,
+	QUERY_TIME_ELAPSED,
 
 	QUERY_TYPE_COUNT
 };
@@ -437,6 +440,7 @@ public:
 	EGLint getConfigID() const override;
 
 	void markAllStateDirty();
+	unsigned int getSkippedStateChanges() const { return mSkippedStateChanges; }   // State groups and sampler parameters not re-applied
 
 	// State manipulation
 	void setClearColor(float red, float green, float blue, float alpha);
@@ -601,6 +605,7 @@ public:
 
 	void beginQuery(GLenum target, GLuint query);
 	void endQuery(GLenum target);
+	void queryCounter(GLuint query, GLenum target);
 
 	void setFramebufferZero(Framebuffer *framebuffer);
 
@@ -667,6 +672,10 @@ public:
 	void drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount = 1);
 	void drawElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount = 1);
 	void blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface *dest, const sw::SliceRect &dRect) override;
+	bool getPipelineProfile(EGLint attribute, EGLint *value) override;
+	bool getMemoryUsage(EGLint attribute, EGLint *value) override;
+	void setScheduling(EGLint priority, EGLint cpuShare) override;
+	bool getScheduling(EGLint attribute, EGLint *value) override;
 	void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLsizei *bufSize, void* pixels);
 	void clear(GLbitfield mask);
 	void clearColorBuffer(GLint drawbuffer, const GLint *value);
@@ -706,7 +715,7 @@ private:
 	void applyScissor(int width, int height);
 	bool applyRenderTarget();
 	void applyState(GLenum drawMode);
-	GLenum applyVertexBuffer(GLint base, GLint first, GLsizei count, GLsizei instanceId);
+	GLenum applyVertexBuffer(GLint base, GLint first, GLsizei count, GLsizei instanceId, GLsizei instanceCount);
 	GLenum applyIndexBuffer(const void *indices, GLuint start, GLuint end, GLsizei count, GLenum mode, GLenum type, TranslatedIndexData *indexInfo);
 	void applyShaders();
 	void applyTextures();
@@ -721,6 +730,7 @@ private:
 	void detachSampler(GLuint sampler);
 
 	bool cullSkipsDraw(GLenum drawMode);
+	GLsizei batchedInstances(int primitiveCount, GLsizei instanceCount);
 	bool isTriangleMode(GLenum drawMode);
 
 	Query *createQuery(GLuint handle, GLenum type);
@@ -745,6 +755,16 @@ private:
 	VertexDataManager *mVertexDataManager;
 	IndexDataManager *mIndexDataManager;
 
+	// Render targets read into pixel pack buffers in the background, referenced until the copy is done
+	struct PendingReadback
+	{
+		egl::Image *renderTarget;
+		int64_t sequence;
+	};
+
+	std::deque<PendingReadback> mPendingReadbacks;
+	void releaseReadbacks();
+
 	// Recorded errors
 	bool mInvalidEnum;
 	bool mInvalidValue;
@@ -755,6 +775,8 @@ private:
 	bool mHasBeenCurrent;
 
 	unsigned int mAppliedProgramSerial;
+	unsigned int mAppliedFramebufferVersion;
+	unsigned int mAppliedStorageVersion;
 
 	// state caching flags
 	bool mDepthStateDirty;
@@ -765,6 +787,55 @@ private:
 	bool mSampleStateDirty;
 	bool mFrontFaceDirty;
 	bool mDitherStateDirty;
+	bool mCullStateDirty;
+	bool mRasterizerDiscardDirty;
+
+	// Sampler parameters last set on the device, which are only set again when they change
+	struct SamplerState
+	{
+		bool operator==(const SamplerState &other) const
+		{
+			return addressingModeU == other.addressingModeU &&
+			       addressingModeV == other.addressingModeV &&
+			       addressingModeW == other.addressingModeW &&
+			       compareFunc == other.compareFunc &&
+			       swizzleR == other.swizzleR &&
+			       swizzleG == other.swizzleG &&
+			       swizzleB == other.swizzleB &&
+			       swizzleA == other.swizzleA &&
+			       minLod == other.minLod &&
+			       maxLod == other.maxLod &&
+			       baseLevel == other.baseLevel &&
+			       maxLevel == other.maxLevel &&
+			       textureFilter == other.textureFilter &&
+			       mipmapFilter == other.mipmapFilter &&
+			       maxAnisotropy == other.maxAnisotropy &&
+			       highPrecisionFiltering == other.highPrecisionFiltering &&
+			       syncRequired == other.syncRequired;
+		}
+
+		sw::AddressingMode addressingModeU;
+		sw::AddressingMode addressingModeV;
+		sw::AddressingMode addressingModeW;
+		sw::CompareFunc compareFunc;
+		sw::SwizzleType swizzleR;
+		sw::SwizzleType swizzleG;
+		sw::SwizzleType swizzleB;
+		sw::SwizzleType swizzleA;
+		float minLod;
+		float maxLod;
+		int baseLevel;
+		int maxLevel;
+		sw::FilterType textureFilter;
+		sw::MipmapType mipmapFilter;
+		float maxAnisotropy;
+		bool highPrecisionFiltering;
+		bool syncRequired;
+	};
+
+	SamplerState mAppliedSamplerState[MAX_COMBINED_TEXTURE_IMAGE_UNITS];
+	bool mSamplerStateDirty[MAX_COMBINED_TEXTURE_IMAGE_UNITS];
+	unsigned int mSkippedStateChanges;
 
 	Device *device;
 	ResourceManager *mResourceManager;
@@ -17,13 +17,14 @@
 #include "Fence.h"
 
 #include "main.h"
-#include "Common/Thread.hpp"
+#include "Device.hpp"
 
 namespace es2
 {
 
-Fence::Fence()
+Fence::Fence(Device *device) : mDevice(device)
 {
+	mSequence = 0;
 	mQuery = false;
 	mCondition = GL_NONE;
 	mStatus = GL_FALSE;
@@ -51,6 +52,7 @@ void Fence::setFence(GLenum condition)
 	mQuery = true;
 	mCondition = condition;
 	mStatus = GL_FALSE;
+	mSequence = mDevice->getDrawSequence();
 }
 
 GLboolean Fence::testFence()
@@ -60,10 +62,10 @@ GLboolean Fence::testFence()
 		return error(GL_INVALID_OPERATION, GL_TRUE);
 	}
 
-	// The current assumtion is that no matter where the fence is placed, it is
-	// done by the time it is tested, which is similar to Context::flush(), since
-	// we don't queue anything without processing it as fast as possible.
-	mStatus = GL_TRUE;
+	if(!mStatus)
+	{
+		mStatus = mDevice->hasRetired(mSequence) ? GL_TRUE : GL_FALSE;
+	}
 
 	return mStatus;
 }
@@ -75,10 +77,8 @@ void Fence::finishFence()
 		return error(GL_INVALID_OPERATION);
 	}
 
-	while(!testFence())
-	{
-		sw::Thread::yield();
-	}
+	mDevice->waitForDraw(mSequence);
+	mStatus = GL_TRUE;
 }
 
 void Fence::getFenceiv(GLenum pname, GLint *params)
@@ -115,24 +115,75 @@ void Fence::getFenceiv(GLenum pname, GLint *params)
 	}
 }
 
-FenceSync::FenceSync(GLuint name, GLenum condition, GLbitfield flags) : NamedObject(name), mCondition(condition), mFlags(flags)
+FenceSync::FenceSync(GLuint name, GLenum condition, GLbitfield flags, Device *device) : NamedObject(name), mCondition(condition), mFlags(flags)
 {
+	mDevice = device;
+	mSequence = device->getDrawSequence();
+	mSignaled = false;
 }
 
 FenceSync::~FenceSync()
 {
 }
 
+void FenceSync::detach(Device *device)
+{
+	if(mDevice == device)
+	{
+		mDevice = nullptr;
+		mSignaled = true;
+	}
+}
+
+bool FenceSync::isSignaled()
+{
+	if(!mSignaled)
+	{
+		mSignaled = mDevice->hasRetired(mSequence);
+	}
+
+	return mSignaled;
+}
+
 GLenum FenceSync::clientWait(GLbitfield flags, GLuint64 timeout)
 {
-	// The current assumtion is that no matter where the fence is placed, it is
-	// done by the time it is tested, which is similar to Context::flush(), since
-	// we don't queue anything without processing it as fast as possible.
-	return GL_ALREADY_SIGNALED;
+	// Flushing is implicit, draw calls are processed as soon as they're issued
+	if(isSignaled())
+	{
+		return GL_ALREADY_SIGNALED;
+	}
+
+	if(mDevice == getDevice())
+	{
+		// Infinite waits can block until the renderer retires draw calls
+		if(timeout == GL_TIMEOUT_IGNORED)
+		{
+			mDevice->waitForDraw(mSequence);
+			mSignaled = true;
+
+			return GL_CONDITION_SATISFIED;
+		}
+	}
+
+	// Other contexts' retirement events belong to their own thread, so get notified of retirements instead
+	if(mDevice->waitForRetirement(mSequence, timeout * 1.0e-9))
+	{
+		mSignaled = true;
+
+		return GL_CONDITION_SATISFIED;
+	}
+
+	return GL_TIMEOUT_EXPIRED;
 }
 
 void FenceSync::serverWait(GLbitfield flags, GLuint64 timeout)
 {
+	// Draw calls of one renderer are executed in order. Other contexts' renderers have to be waited on.
+	if(mDevice != getDevice() && !isSignaled())
+	{
+		mDevice->waitForRetirement(mSequence, -1.0);
+		mSignaled = true;
+	}
 }
 
 void FenceSync::getSynciv(GLenum pname, GLsizei *length, GLint *values)
@@ -146,10 +197,7 @@ void FenceSync::getSynciv(GLenum pname, GLsizei *length, GLint *values)
 		}
 		break;
 	case GL_SYNC_STATUS:
-		// The current assumtion is that no matter where the fence is placed, it is
-		// done by the time it is tested, which is similar to Context::flush(), since
-		// we don't queue anything without processing it as fast as possible.
-		values[0] = GL_SIGNALED;
+		values[0] = isSignaled() ? GL_SIGNALED : GL_UNSIGNALED;
 		if(length) {
 			*length = 1;
 		}
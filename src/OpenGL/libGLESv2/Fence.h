@@ -20,13 +20,18 @@
 #include "common/Object.hpp"
 #include <GLES2/gl2.h>
 
+#include <cstdint>
+
 namespace es2
 {
 
+class Device;
+
+// Fences are signaled once the draw calls issued before them have retired
 class Fence
 {
 public:
-	Fence();
+	explicit Fence(Device *device);
 	virtual ~Fence();
 
 	GLboolean isFence();
@@ -36,6 +41,8 @@ public:
 	void getFenceiv(GLenum pname, GLint *params);
 
 private:
+	Device *const mDevice;
+	int64_t mSequence;   // Of the last draw call issued before the fence was set
 	bool mQuery;
 	GLenum mCondition;
 	GLboolean mStatus;
@@ -44,7 +51,7 @@ private:
 class FenceSync : public gl::NamedObject
 {
 public:
-	FenceSync(GLuint name, GLenum condition, GLbitfield flags);
+	FenceSync(GLuint name, GLenum condition, GLbitfield flags, Device *device);
 	virtual ~FenceSync();
 
 	GLenum clientWait(GLbitfield flags, GLuint64 timeout);
@@ -54,9 +61,16 @@ public:
 	GLenum getCondition() const { return mCondition; }
 	GLbitfield getFlags() const { return mFlags; }
 
+	void detach(Device *device);   // Signals the fence when it belongs to the destroyed device
+
 private:
+	bool isSignaled();
+
 	GLenum mCondition;
 	GLbitfield mFlags;
+	Device *mDevice;
+	int64_t mSequence;
+	bool mSignaled;
 };
 
 }
@@ -32,8 +32,15 @@ bool Framebuffer::IsRenderbuffer(GLenum type)
 	return type == GL_RENDERBUFFER || type == GL_FRAMEBUFFER_DEFAULT;
 }
 
+std::atomic<unsigned int> Framebuffer::currentVersion(1);
+std::atomic<unsigned int> Framebuffer::storageVersion(1);
+
 Framebuffer::Framebuffer()
 {
+	version = issueVersion();
+	statusVersion = 0;
+	statusStorageVersion = 0;
+
 	readBuffer = GL_COLOR_ATTACHMENT0;
 	drawBuffer[0] = GL_COLOR_ATTACHMENT0;
 	for(int i = 1; i < MAX_COLOR_ATTACHMENTS; i++)
@@ -90,6 +97,7 @@ void Framebuffer::setColorbuffer(GLenum type, GLuint colorbuffer, GLuint index,
 	mColorbufferType[index] = (colorbuffer != 0) ? type : GL_NONE;
 	mColorbufferPointer[index] = lookupRenderbuffer(type, colorbuffer, level);
 	mColorbufferLayer[index] = layer;
+	version = issueVersion();
 }
 
 void Framebuffer::setDepthbuffer(GLenum type, GLuint depthbuffer, GLint level, GLint layer)
@@ -97,6 +105,7 @@ void Framebuffer::setDepthbuffer(GLenum type, GLuint depthbuffer, GLint level, G
 	mDepthbufferType = (depthbuffer != 0) ? type : GL_NONE;
 	mDepthbufferPointer = lookupRenderbuffer(type, depthbuffer, level);
 	mDepthbufferLayer = layer;
+	version = issueVersion();
 }
 
 void Framebuffer::setStencilbuffer(GLenum type, GLuint stencilbuffer, GLint level, GLint layer)
@@ -104,16 +113,19 @@ void Framebuffer::setStencilbuffer(GLenum type, GLuint stencilbuffer, GLint leve
 	mStencilbufferType = (stencilbuffer != 0) ? type : GL_NONE;
 	mStencilbufferPointer = lookupRenderbuffer(type, stencilbuffer, level);
 	mStencilbufferLayer = layer;
+	version = issueVersion();
 }
 
 void Framebuffer::setReadBuffer(GLenum buf)
 {
 	readBuffer = buf;
+	version = issueVersion();
 }
 
 void Framebuffer::setDrawBuffer(GLuint index, GLenum buf)
 {
 	drawBuffer[index] = buf;
+	version = issueVersion();
 }
 
 GLenum Framebuffer::getReadBuffer() const
@@ -148,6 +160,8 @@ void Framebuffer::detachTexture(GLuint texture)
 		mStencilbufferType = GL_NONE;
 		mStencilbufferPointer = nullptr;
 	}
+
+	version = issueVersion();
 }
 
 void Framebuffer::detachRenderbuffer(GLuint renderbuffer)
@@ -172,6 +186,8 @@ void Framebuffer::detachRenderbuffer(GLuint renderbuffer)
 		mStencilbufferType = GL_NONE;
 		mStencilbufferPointer = nullptr;
 	}
+
+	version = issueVersion();
 }
 
 // Increments refcount on surface.
@@ -314,6 +330,71 @@ bool Framebuffer::hasStencil()
 	return false;
 }
 
+static void invalidateRenderbuffer(Renderbuffer *renderbuffer, const sw::Rect &rect)
+{
+	egl::Image *image = renderbuffer ? renderbuffer->getRenderTarget() : nullptr;
+
+	if(image)
+	{
+		image->invalidate(rect);
+		image->release();
+	}
+}
+
+void Framebuffer::invalidate(GLsizei numAttachments, const GLenum *attachments, const sw::Rect &rect)
+{
+	bool depth = false;
+	bool stencil = false;
+
+	for(int i = 0; i < numAttachments; i++)
+	{
+		switch(attachments[i])
+		{
+		case GL_COLOR:
+			invalidateRenderbuffer(getColorbuffer(0), rect);
+			break;
+		case GL_DEPTH:
+		case GL_DEPTH_ATTACHMENT:
+			depth = true;
+			break;
+		case GL_STENCIL:
+		case GL_STENCIL_ATTACHMENT:
+			stencil = true;
+			break;
+		case GL_DEPTH_STENCIL_ATTACHMENT:
+			depth = true;
+			stencil = true;
+			break;
+		default:
+			invalidateRenderbuffer(getColorbuffer(attachments[i] - GL_COLOR_ATTACHMENT0), rect);
+			break;
+		}
+	}
+
+	Renderbuffer *depthbuffer = getDepthbuffer();
+	Renderbuffer *stencilbuffer = getStencilbuffer();
+
+	if(depthbuffer == stencilbuffer)   // Packed depth and stencil share their image, which can only be invalidated as a whole
+	{
+		if(depth && stencil)
+		{
+			invalidateRenderbuffer(depthbuffer, rect);
+		}
+	}
+	else
+	{
+		if(depth)
+		{
+			invalidateRenderbuffer(depthbuffer, rect);
+		}
+
+		if(stencil)
+		{
+			invalidateRenderbuffer(stencilbuffer, rect);
+		}
+	}
+}
+
 GLenum Framebuffer::completeness()
 {
 	int width;
@@ -324,6 +405,34 @@ GLenum Framebuffer::completeness()
 }
 
 GLenum Framebuffer::completeness(int &width, int &height, int &samples)
+{
+	unsigned int storage = storageVersion;   // Before checking, so concurrent changes cause another check
+
+	if(statusVersion != version || statusStorageVersion != storage)
+	{
+		status = checkCompleteness(statusWidth, statusHeight, statusSamples);
+		statusVersion = version;
+		statusStorageVersion = storage;
+	}
+
+	width = statusWidth;
+	height = statusHeight;
+	samples = statusSamples;
+
+	return status;
+}
+
+unsigned int Framebuffer::issueVersion()
+{
+	return currentVersion++;
+}
+
+void Framebuffer::storageChanged()
+{
+	storageVersion++;
+}
+
+GLenum Framebuffer::checkCompleteness(int &width, int &height, int &samples)
 {
 	width = -1;
 	height = -1;
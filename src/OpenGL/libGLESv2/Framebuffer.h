@@ -24,6 +24,8 @@
 
 #include <GLES2/gl2.h>
 
+#include <atomic>
+
 namespace es2
 {
 class Renderbuffer;
@@ -76,8 +78,10 @@ public:
 
 	bool hasStencil();
 
+	void invalidate(GLsizei numAttachments, const GLenum *attachments, const sw::Rect &rect);   // Validated attachments
+
 	GLenum completeness();
-	GLenum completeness(int &width, int &height, int &samples);
+	GLenum completeness(int &width, int &height, int &samples);   // Cached until the attachments or their storage change
 
 	GLenum getImplementationColorReadFormat() const;
 	GLenum getImplementationColorReadType() const;
@@ -86,6 +90,13 @@ public:
 
 	virtual bool isDefaultFramebuffer() const { return false; }
 
+	// Changes along with the attachments and the draw and read buffers, unique among all framebuffers
+	unsigned int getVersion() const { return version; }
+
+	// Changes when images which may be attached are replaced, by redefining textures or renderbuffers
+	static unsigned int getStorageVersion() { return storageVersion; }
+	static void storageChanged();
+
 	static bool IsRenderbuffer(GLenum type);
 
 protected:
@@ -108,6 +119,21 @@ protected:
 
 private:
 	Renderbuffer *lookupRenderbuffer(GLenum type, GLuint handle, GLint level) const;
+	GLenum checkCompleteness(int &width, int &height, int &samples);
+	static unsigned int issueVersion();
+
+	unsigned int version;
+
+	// Result of the last completeness check
+	GLenum status;
+	int statusWidth;
+	int statusHeight;
+	int statusSamples;
+	unsigned int statusVersion;
+	unsigned int statusStorageVersion;
+
+	static std::atomic<unsigned int> currentVersion;
+	static std::atomic<unsigned int> storageVersion;
 };
 
 class DefaultFramebuffer : public Framebuffer
@@ -19,10 +19,15 @@
 
 #include "Buffer.h"
 #include "common/debug.h"
+#include "Common/CPUID.hpp"
 
 #include <string.h>
 #include <algorithm>
 
+#if defined(__i386__) || defined(__x86_64__)
+	#include <emmintrin.h>
+#endif
+
 namespace
 {
 	enum { INITIAL_INDEX_BUFFER_SIZE = 4096 * sizeof(GLuint) };
@@ -195,9 +200,6 @@ void copyIndices(GLenum mode, GLenum type, const std::vector<GLsizei>& restartIn
 template<class IndexType>
 void computeRange(const IndexType *indices, GLsizei count, GLuint *minIndex, GLuint *maxIndex, std::vector<GLsizei>* restartIndices)
 {
-	*maxIndex = 0;
-	*minIndex = MAX_ELEMENTS_INDICES;
-
 	for(GLsizei i = 0; i < count; i++)
 	{
 		if(restartIndices && indices[i] == IndexType(-1))
@@ -210,19 +212,129 @@ void computeRange(const IndexType *indices, GLsizei count, GLuint *minIndex, GLu
 	}
 }
 
-void computeRange(GLenum type, const void *indices, GLsizei count, GLuint *minIndex, GLuint *maxIndex, std::vector<GLsizei>* restartIndices)
+#if defined(__i386__) || defined(__x86_64__)
+// SSE2 lacks unsigned comparisons of 16 and 32-bit integers, so those are biased to use signed ones
+inline __m128i bias(GLubyte) { return _mm_setzero_si128(); }
+inline __m128i bias(GLushort) { return _mm_set1_epi16(-0x8000); }
+inline __m128i bias(GLuint) { return _mm_set1_epi32(static_cast<int>(0x80000000)); }
+
+inline __m128i equal(__m128i a, __m128i b, GLubyte) { return _mm_cmpeq_epi8(a, b); }
+inline __m128i equal(__m128i a, __m128i b, GLushort) { return _mm_cmpeq_epi16(a, b); }
+inline __m128i equal(__m128i a, __m128i b, GLuint) { return _mm_cmpeq_epi32(a, b); }
+
+inline __m128i select(__m128i mask, __m128i a, __m128i b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+
+inline __m128i min(__m128i a, __m128i b, GLubyte) { return _mm_min_epu8(a, b); }
+inline __m128i min(__m128i a, __m128i b, GLushort) { return _mm_min_epi16(a, b); }
+inline __m128i min(__m128i a, __m128i b, GLuint) { return select(_mm_cmpgt_epi32(a, b), b, a); }
+
+inline __m128i max(__m128i a, __m128i b, GLubyte) { return _mm_max_epu8(a, b); }
+inline __m128i max(__m128i a, __m128i b, GLushort) { return _mm_max_epi16(a, b); }
+inline __m128i max(__m128i a, __m128i b, GLuint) { return select(_mm_cmpgt_epi32(a, b), a, b); }
+
+// Processes 16 bytes of indices at a time, and returns the number of indices left for the scalar loop
+template<class IndexType>
+GLsizei computeRangeSSE2(const IndexType *indices, GLsizei count, GLuint *minIndex, GLuint *maxIndex, std::vector<GLsizei> *restartIndices)
+{
+	const int lanes = sizeof(__m128i) / sizeof(IndexType);
+	const IndexType zero = 0;
+	const __m128i offset = bias(zero);
+	const __m128i restart = _mm_xor_si128(_mm_set1_epi32(-1), offset);
+	__m128i minimum = restart;   // Largest value
+	__m128i maximum = offset;    // Smallest value
+	GLsizei i = 0;
+
+	for(; i + lanes <= count; i += lanes)
+	{
+		__m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), offset);
+
+		if(restartIndices)
+		{
+			__m128i isRestart = equal(x, restart, zero);
+
+			if(_mm_movemask_epi8(isRestart))
+			{
+				for(int j = 0; j < lanes; j++)
+				{
+					if(indices[i + j] == IndexType(-1))
+					{
+						restartIndices->push_back(i + j);
+					}
+				}
+
+				// Restart indices are the largest value, so they only affect the maximum
+				minimum = min(minimum, x, zero);
+				maximum = max(maximum, select(isRestart, offset, x), zero);
+				continue;
+			}
+		}
+
+		minimum = min(minimum, x, zero);
+		maximum = max(maximum, x, zero);
+	}
+
+	if(i == 0)
+	{
+		return count;
+	}
+
+	IndexType minimums[lanes];
+	IndexType maximums[lanes];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(minimums), _mm_xor_si128(minimum, offset));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(maximums), _mm_xor_si128(maximum, offset));
+
+	for(int j = 0; j < lanes; j++)
+	{
+		// With primitive restart the largest value only occurs for restart indices, so it is no minimum
+		if((!restartIndices || minimums[j] != IndexType(-1)) && *minIndex > minimums[j]) *minIndex = minimums[j];
+		if(*maxIndex < maximums[j]) *maxIndex = maximums[j];
+	}
+
+	return count - i;
+}
+#endif
+
+template<class IndexType>
+void computeRange(const IndexType *indices, GLsizei count, IndexRange *range, bool primitiveRestart)
+{
+	range->maxIndex = 0;
+	range->minIndex = MAX_ELEMENTS_INDICES;
+	std::vector<GLsizei> *restartIndices = primitiveRestart ? &range->restartIndices : nullptr;
+
+	#if defined(__i386__) || defined(__x86_64__)
+		if(sw::CPUID::supportsSSE2())
+		{
+			GLsizei remaining = computeRangeSSE2(indices, count, &range->minIndex, &range->maxIndex, restartIndices);
+			GLsizei scanned = count - remaining;
+
+			size_t first = range->restartIndices.size();
+			computeRange(indices + scanned, remaining, &range->minIndex, &range->maxIndex, restartIndices);
+
+			for(size_t i = first; i < range->restartIndices.size(); i++)
+			{
+				range->restartIndices[i] += scanned;
+			}
+
+			return;
+		}
+	#endif
+
+	computeRange(indices, count, &range->minIndex, &range->maxIndex, restartIndices);
+}
+
+void computeRange(GLenum type, const void *indices, GLsizei count, IndexRange *range, bool primitiveRestart)
 {
 	if(type == GL_UNSIGNED_BYTE)
 	{
-		computeRange(static_cast<const GLubyte*>(indices), count, minIndex, maxIndex, restartIndices);
+		computeRange(static_cast<const GLubyte*>(indices), count, range, primitiveRestart);
 	}
 	else if(type == GL_UNSIGNED_INT)
 	{
-		computeRange(static_cast<const GLuint*>(indices), count, minIndex, maxIndex, restartIndices);
+		computeRange(static_cast<const GLuint*>(indices), count, range, primitiveRestart);
 	}
 	else if(type == GL_UNSIGNED_SHORT)
 	{
-		computeRange(static_cast<const GLushort*>(indices), count, minIndex, maxIndex, restartIndices);
+		computeRange(static_cast<const GLushort*>(indices), count, range, primitiveRestart);
 	}
 	else UNREACHABLE(type);
 }
@@ -289,41 +401,81 @@ GLenum IndexDataManager::prepareIndexData(GLenum mode, GLenum type, GLuint start
 		indices = static_cast<const GLubyte*>(buffer->data()) + offset;
 	}
 
-	std::vector<GLsizei>* restartIndices = primitiveRestart ? new std::vector<GLsizei>() : nullptr;
-	computeRange(type, indices, count, &translated->minIndex, &translated->maxIndex, restartIndices);
+	// Static index buffers are typically drawn from many times, so their scans are kept
+	const IndexRange *range = buffer ? buffer->getIndexRange(type, offset, count, primitiveRestart) : nullptr;
+	bool unchanged = (range != nullptr);   // The buffer wasn't written since it was last drawn from
+
+	if(!range)
+	{
+		mScannedRange.restartIndices.clear();
+		computeRange(type, indices, count, &mScannedRange, primitiveRestart);
+		range = buffer ? buffer->setIndexRange(type, offset, count, primitiveRestart, mScannedRange) : &mScannedRange;
+	}
+
+	translated->minIndex = range->minIndex;
+	translated->maxIndex = range->maxIndex;
 
 	StreamingIndexBuffer *streamingBuffer = mStreamingBuffer;
 
 	sw::Resource *staticBuffer = buffer ? buffer->getResource() : NULL;
 
-	if(restartIndices)
+	// Strips and fans start over at the restart index in the renderer, other modes leave it out here
+	bool restartInRenderer = (mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN || mode == GL_LINE_STRIP);
+
+	if(primitiveRestart && restartInRenderer && !range->restartIndices.empty())
+	{
+		translated->restartIndices = &range->restartIndices;
+
+		if(range->minIndex > range->maxIndex)
+		{
+			translated->primitiveCount = 0;   // Only restart indices
+		}
+	}
+
+	if(primitiveRestart && !restartInRenderer)
 	{
-		int vertexPerPrimitive = recomputePrimitiveCount(mode, count, *restartIndices, &translated->primitiveCount);
+		int vertexPerPrimitive = recomputePrimitiveCount(mode, count, range->restartIndices, &translated->primitiveCount);
 		if(vertexPerPrimitive == -1)
 		{
-			delete restartIndices;
 			return GL_INVALID_ENUM;
 		}
 
 		size_t streamOffset = 0;
 		int convertCount = translated->primitiveCount * vertexPerPrimitive;
 
-		streamingBuffer->reserveSpace(convertCount * typeSize(type), type);
-		void *output = streamingBuffer->map(typeSize(type) * convertCount, &streamOffset);
-
-		if(output == NULL)
+		if(range->converted && range->convertedMode == mode)
 		{
-			delete restartIndices;
-			ERR("Failed to map index buffer.");
-			return GL_OUT_OF_MEMORY;
+			translated->indexBuffer = range->converted;
+			translated->indexOffset = 0;
 		}
+		else if(unchanged)
+		{
+			// Indices drawn again from an unchanged buffer are likely static, so their conversion is kept with the buffer
+			sw::Resource *converted = new sw::Resource(convertCount * typeSize(type) + 16);
 
-		copyIndices(mode, type, *restartIndices, indices, count, output);
-		streamingBuffer->unmap();
+			copyIndices(mode, type, range->restartIndices, indices, count, const_cast<void*>(converted->data()));
+			buffer->setConvertedIndices(type, offset, count, mode, converted);
 
-		translated->indexBuffer = streamingBuffer->getResource();
-		translated->indexOffset = static_cast<unsigned int>(streamOffset);
-		delete restartIndices;
+			translated->indexBuffer = converted;
+			translated->indexOffset = 0;
+		}
+		else
+		{
+			streamingBuffer->reserveSpace(convertCount * typeSize(type), type);
+			void *output = streamingBuffer->map(typeSize(type) * convertCount, &streamOffset);
+
+			if(output == NULL)
+			{
+				ERR("Failed to map index buffer.");
+				return GL_OUT_OF_MEMORY;
+			}
+
+			copyIndices(mode, type, range->restartIndices, indices, count, output);
+			streamingBuffer->unmap();
+
+			translated->indexBuffer = streamingBuffer->getResource();
+			translated->indexOffset = static_cast<unsigned int>(streamOffset);
+		}
 	}
 	else if(staticBuffer)
 	{
@@ -391,6 +543,8 @@ StreamingIndexBuffer::~StreamingIndexBuffer()
 	{
 		mIndexBuffer->destruct();
 	}
+
+	releaseRetired();
 }
 
 void *StreamingIndexBuffer::map(size_t requiredSpace, size_t *offset)
@@ -399,7 +553,8 @@ void *StreamingIndexBuffer::map(size_t requiredSpace, size_t *offset)
 
 	if(mIndexBuffer)
 	{
-		mapPtr = (char*)mIndexBuffer->lock(sw::PUBLIC) + mWritePosition;
+		// We can use a private lock because we never overwrite the content
+		mapPtr = (char*)mIndexBuffer->lock(sw::PRIVATE) + mWritePosition;
 
 		if(!mapPtr)
 		{
@@ -432,6 +587,8 @@ void StreamingIndexBuffer::reserveSpace(size_t requiredSpace, GLenum type)
 			mIndexBuffer = 0;
 		}
 
+		releaseRetired();
+
 		mBufferSize = std::max(requiredSpace, 2 * mBufferSize);
 
 		mIndexBuffer = new sw::Resource(mBufferSize + 16);
@@ -447,14 +604,49 @@ void StreamingIndexBuffer::reserveSpace(size_t requiredSpace, GLenum type)
 	{
 		if(mIndexBuffer)
 		{
-			mIndexBuffer->destruct();
-			mIndexBuffer = new sw::Resource(mBufferSize + 16);
+			mIndexBuffer = recycle(mIndexBuffer);
 		}
 
 		mWritePosition = 0;
 	}
 }
 
+sw::Resource *StreamingIndexBuffer::recycle(sw::Resource *full)
+{
+	// Draw calls still reading the full buffer keep it, it gets reused once they are done
+	sw::Resource *next = nullptr;
+
+	for(size_t i = 0; i < mRetired.size(); i++)
+	{
+		if(mRetired[i]->isIdle())
+		{
+			next = mRetired[i];
+			mRetired.erase(mRetired.begin() + i);
+			break;
+		}
+	}
+
+	if(mRetired.size() == MAX_RETIRED)
+	{
+		mRetired.front()->destruct();
+		mRetired.erase(mRetired.begin());
+	}
+
+	mRetired.push_back(full);
+
+	return next ? next : new sw::Resource(mBufferSize + 16);
+}
+
+void StreamingIndexBuffer::releaseRetired()
+{
+	for(sw::Resource *resource : mRetired)
+	{
+		resource->destruct();
+	}
+
+	mRetired.clear();
+}
+
 sw::Resource *StreamingIndexBuffer::getResource() const
 {
 	return mIndexBuffer;
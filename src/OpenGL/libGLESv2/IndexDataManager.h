@@ -19,15 +19,18 @@
 #define LIBGLESV2_INDEXDATAMANAGER_H_
 
 #include "Context.h"
+#include "Buffer.h"
 
 #include <GLES2/gl2.h>
 
+#include <vector>
+
 namespace es2
 {
 
 struct TranslatedIndexData
 {
-	TranslatedIndexData(unsigned int primitiveCount) : primitiveCount(primitiveCount) {}
+	TranslatedIndexData(unsigned int primitiveCount) : primitiveCount(primitiveCount), restartIndices(nullptr) {}
 
 	unsigned int minIndex;
 	unsigned int maxIndex;
@@ -35,6 +38,7 @@ struct TranslatedIndexData
 	unsigned int primitiveCount;
 
 	sw::Resource *indexBuffer;
+	const std::vector<GLsizei> *restartIndices;   // For strips and fans, which the renderer restarts itself
 };
 
 class StreamingIndexBuffer
@@ -50,7 +54,16 @@ public:
 	sw::Resource *getResource() const;
 
 private:
+	enum
+	{
+		MAX_RETIRED = 2,   // Full buffers which pending draws may still read, reused once they are done
+	};
+
+	sw::Resource *recycle(sw::Resource *full);
+	void releaseRetired();
+
 	sw::Resource *mIndexBuffer;
+	std::vector<sw::Resource*> mRetired;
 	size_t mBufferSize;
 	size_t mWritePosition;
 };
@@ -67,6 +80,7 @@ public:
 
 private:
 	StreamingIndexBuffer *mStreamingBuffer;
+	IndexRange mScannedRange;   // Of indices which aren't in a buffer, until the next draw call
 };
 
 }
@@ -25,6 +25,8 @@
 #include "common/debug.h"
 #include "Shader/PixelShader.hpp"
 #include "Shader/VertexShader.hpp"
+#include "Renderer/RoutineStore.hpp"
+#include "Common/Math.hpp"
 
 #include <algorithm>
 #include <string>
@@ -41,6 +43,122 @@ namespace es2
 		return buffer;
 	}
 
+	namespace
+	{
+		// Program binaries are a header followed by 32-bit words, like the serialized shaders they contain
+		struct BinaryHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint64_t module;     // Binaries are only valid for the library build which produced them
+			uint64_t checksum;   // Of the words following the header
+		};
+
+		const uint32_t BINARY_MAGIC = 0x47525053;   // "SPRG"
+		const uint32_t BINARY_VERSION = 1;
+
+		uint64_t checksum(const std::vector<unsigned int> &data)
+		{
+			return sw::FNV_1a(reinterpret_cast<const unsigned char*>(data.data()), static_cast<int>(data.size() * sizeof(unsigned int)));
+		}
+
+		void writeString(std::vector<unsigned int> &data, const std::string &string)
+		{
+			data.push_back(static_cast<unsigned int>(string.size()));
+
+			for(size_t i = 0; i < string.size(); i += sizeof(unsigned int))
+			{
+				unsigned int word = 0;
+				memcpy(&word, string.data() + i, std::min(sizeof(unsigned int), string.size() - i));
+				data.push_back(word);
+			}
+		}
+
+		void writeFields(std::vector<unsigned int> &data, const std::vector<glsl::ShaderVariable> &fields)
+		{
+			data.push_back(static_cast<unsigned int>(fields.size()));
+
+			for(const auto &field : fields)
+			{
+				data.push_back(field.type);
+				data.push_back(field.precision);
+				writeString(data, field.name);
+				data.push_back(field.arraySize);
+				data.push_back(field.registerIndex);
+				writeFields(data, field.fields);
+			}
+		}
+
+		// Reads words until the end of the data, after which it returns zero and flags the failure
+		struct BinaryReader
+		{
+			BinaryReader(const unsigned int *data, const unsigned int *end) : data(data), end(end), failed(false)
+			{
+			}
+
+			unsigned int read()
+			{
+				if(data == end)
+				{
+					failed = true;
+					return 0;
+				}
+
+				return *data++;
+			}
+
+			size_t readCount()   // Of elements which take at least one word each
+			{
+				size_t count = read();
+
+				if(count > static_cast<size_t>(end - data))
+				{
+					failed = true;
+					return 0;
+				}
+
+				return count;
+			}
+
+			std::string readString()
+			{
+				size_t size = read();
+
+				if(size > static_cast<size_t>(end - data) * sizeof(unsigned int))
+				{
+					failed = true;
+					return std::string();
+				}
+
+				std::string string(reinterpret_cast<const char*>(data), size);
+				data += (size + sizeof(unsigned int) - 1) / sizeof(unsigned int);
+
+				return string;
+			}
+
+			void readFields(std::vector<glsl::ShaderVariable> &fields)
+			{
+				size_t count = readCount();
+
+				for(size_t i = 0; i < count && !failed; i++)
+				{
+					GLenum type = read();
+					GLenum precision = read();
+					std::string name = readString();
+					int arraySize = read();
+					int registerIndex = read();
+
+					fields.push_back(glsl::ShaderVariable(type, precision, name, arraySize, registerIndex));
+					readFields(fields.back().fields);
+				}
+			}
+
+			const unsigned int *data;
+			const unsigned int *end;
+			bool failed;
+		};
+	}
+
 	Uniform::BlockInfo::BlockInfo(const glsl::Uniform& uniform, int blockIndex)
 	{
 		if(blockIndex >= 0)
@@ -54,10 +172,15 @@ namespace es2
 	}
 
 	Uniform::Uniform(const glsl::Uniform &uniform, const BlockInfo &blockInfo)
-	 : type(uniform.type), precision(uniform.precision), name(uniform.name),
-	   arraySize(uniform.arraySize), blockInfo(blockInfo), fields(uniform.fields)
+	 : Uniform(uniform.type, uniform.precision, uniform.name, uniform.arraySize, blockInfo, uniform.fields)
 	{
-		if((blockInfo.index == -1) && uniform.fields.empty())
+	}
+
+	Uniform::Uniform(GLenum type, GLenum precision, const std::string &name, unsigned int arraySize,
+	                 const BlockInfo &blockInfo, const std::vector<glsl::ShaderVariable> &fields)
+	 : type(type), precision(precision), name(name), arraySize(arraySize), blockInfo(blockInfo), fields(fields)
+	{
+		if((blockInfo.index == -1) && fields.empty())
 		{
 			size_t bytes = UniformTypeSize(type) * size();
 			data = new unsigned char[bytes];
@@ -245,24 +368,21 @@ namespace es2
 			std::string baseName(name);
 			unsigned int subscript = GL_INVALID_INDEX;
 			baseName = ParseUniformName(baseName, &subscript);
-			for(auto const &varying : fragmentShader->varyings)
+			for(auto const &output : fragmentOutputs)
 			{
-				if(varying.qualifier == EvqFragmentOut)
+				if(output.name == baseName)
 				{
-					if(varying.name == baseName)
-					{
-						ASSERT(varying.registerIndex >= 0);
+					ASSERT(output.reg >= 0);
 
-						if(subscript == GL_INVALID_INDEX)   // No subscript
-						{
-							return varying.registerIndex;
-						}
+					if(subscript == GL_INVALID_INDEX)   // No subscript
+					{
+						return output.reg;
+					}
 
-						int rowCount = VariableRowCount(varying.type);
-						int colCount = VariableColumnCount(varying.type);
+					int rowCount = VariableRowCount(output.type);
+					int colCount = VariableColumnCount(output.type);
 
-						return varying.registerIndex + (rowCount > 1 ? colCount * subscript : subscript);
-					}
+					return output.reg + (rowCount > 1 ? colCount * subscript : subscript);
 				}
 			}
 		}
@@ -270,6 +390,28 @@ namespace es2
 		return -1;
 	}
 
+	void Program::setDepthRange(GLfloat zNear, GLfloat zFar)
+	{
+		// Looked up once per link, since this is applied for every draw call
+		if(!depthRangeResolved)
+		{
+			depthRangeLocation[0] = getUniformLocation("gl_DepthRange.near");
+			depthRangeLocation[1] = getUniformLocation("gl_DepthRange.far");
+			depthRangeLocation[2] = getUniformLocation("gl_DepthRange.diff");
+			depthRangeResolved = true;
+		}
+
+		GLfloat nearFarDiff[3] = {zNear, zFar, zFar - zNear};
+
+		for(int i = 0; i < 3; i++)
+		{
+			if(depthRangeLocation[i] != -1)
+			{
+				setUniform1fv(depthRangeLocation[i], 1, &nearFarDiff[i]);
+			}
+		}
+	}
+
 	void Program::bindAttributeLocation(GLuint index, const char *name)
 	{
 		attributeBinding[name] = index;
@@ -505,7 +647,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		dirtyUniform(location);
 
 		int size = targetUniform->size();
 
@@ -595,7 +737,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		dirtyUniform(location);
 
 		if(targetUniform->type != type)
 		{
@@ -692,7 +834,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		dirtyUniform(location);
 
 		int size = targetUniform->size();
 
@@ -748,7 +890,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		dirtyUniform(location);
 
 		int size = targetUniform->size();
 
@@ -810,7 +952,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		dirtyUniform(location);
 
 		int size = targetUniform->size();
 
@@ -866,7 +1008,7 @@ namespace es2
 		}
 
 		Uniform *targetUniform = uniforms[uniformIndex[location].index];
-		targetUniform->dirty = true;
+		dirtyUniform(location);
 
 		int size = targetUniform->size();
 
@@ -1078,16 +1220,8 @@ namespace es2
 
 	void Program::dirtyAllUniforms()
 	{
-		size_t numUniforms = uniforms.size();
-		for(size_t index = 0; index < numUniforms; index++)
-		{
-			uniforms[index]->dirty = true;
-		}
-	}
+		dirtyUniforms.clear();
 
-	// Applies all the uniforms set for this program object to the device
-	void Program::applyUniforms(Device *device)
-	{
 		GLint numUniforms = static_cast<GLint>(uniformIndex.size());
 		for(GLint location = 0; location < numUniforms; location++)
 		{
@@ -1098,67 +1232,92 @@ namespace es2
 
 			Uniform *targetUniform = uniforms[uniformIndex[location].index];
 
-			if(targetUniform->dirty && (targetUniform->blockInfo.index == -1))
+			if(targetUniform->blockInfo.index == -1)
 			{
-				GLsizei size = targetUniform->size();
-				GLfloat *f = (GLfloat*)targetUniform->data;
-				GLint *i = (GLint*)targetUniform->data;
-				GLuint *ui = (GLuint*)targetUniform->data;
-				GLboolean *b = (GLboolean*)targetUniform->data;
+				targetUniform->dirty = true;
+				dirtyUniforms.push_back(location);
+			}
+		}
+	}
 
-				switch(targetUniform->type)
-				{
-				case GL_BOOL:       applyUniform1bv(device, location, size, b);       break;
-				case GL_BOOL_VEC2:  applyUniform2bv(device, location, size, b);       break;
-				case GL_BOOL_VEC3:  applyUniform3bv(device, location, size, b);       break;
-				case GL_BOOL_VEC4:  applyUniform4bv(device, location, size, b);       break;
-				case GL_FLOAT:      applyUniform1fv(device, location, size, f);       break;
-				case GL_FLOAT_VEC2: applyUniform2fv(device, location, size, f);       break;
-				case GL_FLOAT_VEC3: applyUniform3fv(device, location, size, f);       break;
-				case GL_FLOAT_VEC4: applyUniform4fv(device, location, size, f);       break;
-				case GL_FLOAT_MAT2:   applyUniformMatrix2fv(device, location, size, f);   break;
-				case GL_FLOAT_MAT2x3: applyUniformMatrix2x3fv(device, location, size, f); break;
-				case GL_FLOAT_MAT2x4: applyUniformMatrix2x4fv(device, location, size, f); break;
-				case GL_FLOAT_MAT3x2: applyUniformMatrix3x2fv(device, location, size, f); break;
-				case GL_FLOAT_MAT3:   applyUniformMatrix3fv(device, location, size, f);   break;
-				case GL_FLOAT_MAT3x4: applyUniformMatrix3x4fv(device, location, size, f); break;
-				case GL_FLOAT_MAT4x2: applyUniformMatrix4x2fv(device, location, size, f); break;
-				case GL_FLOAT_MAT4x3: applyUniformMatrix4x3fv(device, location, size, f); break;
-				case GL_FLOAT_MAT4:   applyUniformMatrix4fv(device, location, size, f);   break;
-				case GL_SAMPLER_2D:
-				case GL_SAMPLER_CUBE:
-				case GL_SAMPLER_2D_RECT_ARB:
-				case GL_SAMPLER_EXTERNAL_OES:
-				case GL_SAMPLER_3D_OES:
-				case GL_SAMPLER_2D_ARRAY:
-				case GL_SAMPLER_2D_SHADOW:
-				case GL_SAMPLER_CUBE_SHADOW:
-				case GL_SAMPLER_2D_ARRAY_SHADOW:
-				case GL_INT_SAMPLER_2D:
-				case GL_UNSIGNED_INT_SAMPLER_2D:
-				case GL_INT_SAMPLER_CUBE:
-				case GL_UNSIGNED_INT_SAMPLER_CUBE:
-				case GL_INT_SAMPLER_3D:
-				case GL_UNSIGNED_INT_SAMPLER_3D:
-				case GL_INT_SAMPLER_2D_ARRAY:
-				case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
-				case GL_INT:        applyUniform1iv(device, location, size, i);       break;
-				case GL_INT_VEC2:   applyUniform2iv(device, location, size, i);       break;
-				case GL_INT_VEC3:   applyUniform3iv(device, location, size, i);       break;
-				case GL_INT_VEC4:   applyUniform4iv(device, location, size, i);       break;
-				case GL_UNSIGNED_INT:      applyUniform1uiv(device, location, size, ui); break;
-				case GL_UNSIGNED_INT_VEC2: applyUniform2uiv(device, location, size, ui); break;
-				case GL_UNSIGNED_INT_VEC3: applyUniform3uiv(device, location, size, ui); break;
-				case GL_UNSIGNED_INT_VEC4: applyUniform4uiv(device, location, size, ui); break;
-				default:
-					UNREACHABLE(targetUniform->type);
-				}
+	void Program::dirtyUniform(GLint location)
+	{
+		Uniform *targetUniform = uniforms[uniformIndex[location].index];
 
-				targetUniform->dirty = false;
-			}
+		if(!targetUniform->dirty)
+		{
+			targetUniform->dirty = true;
+			dirtyUniforms.push_back(location - uniformIndex[location].element);   // The elements of an array have consecutive locations
 		}
 	}
 
+	// Applies the uniforms set since they were last applied to the device
+	void Program::applyUniforms(Device *device)
+	{
+		for(GLint location : dirtyUniforms)
+		{
+			Uniform *targetUniform = uniforms[uniformIndex[location].index];
+
+			GLsizei size = targetUniform->size();
+			GLfloat *f = (GLfloat*)targetUniform->data;
+			GLint *i = (GLint*)targetUniform->data;
+			GLuint *ui = (GLuint*)targetUniform->data;
+			GLboolean *b = (GLboolean*)targetUniform->data;
+
+			switch(targetUniform->type)
+			{
+			case GL_BOOL:       applyUniform1bv(device, location, size, b);       break;
+			case GL_BOOL_VEC2:  applyUniform2bv(device, location, size, b);       break;
+			case GL_BOOL_VEC3:  applyUniform3bv(device, location, size, b);       break;
+			case GL_BOOL_VEC4:  applyUniform4bv(device, location, size, b);       break;
+			case GL_FLOAT:      applyUniform1fv(device, location, size, f);       break;
+			case GL_FLOAT_VEC2: applyUniform2fv(device, location, size, f);       break;
+			case GL_FLOAT_VEC3: applyUniform3fv(device, location, size, f);       break;
+			case GL_FLOAT_VEC4: applyUniform4fv(device, location, size, f);       break;
+			case GL_FLOAT_MAT2:   applyUniformMatrix2fv(device, location, size, f);   break;
+			case GL_FLOAT_MAT2x3: applyUniformMatrix2x3fv(device, location, size, f); break;
+			case GL_FLOAT_MAT2x4: applyUniformMatrix2x4fv(device, location, size, f); break;
+			case GL_FLOAT_MAT3x2: applyUniformMatrix3x2fv(device, location, size, f); break;
+			case GL_FLOAT_MAT3:   applyUniformMatrix3fv(device, location, size, f);   break;
+			case GL_FLOAT_MAT3x4: applyUniformMatrix3x4fv(device, location, size, f); break;
+			case GL_FLOAT_MAT4x2: applyUniformMatrix4x2fv(device, location, size, f); break;
+			case GL_FLOAT_MAT4x3: applyUniformMatrix4x3fv(device, location, size, f); break;
+			case GL_FLOAT_MAT4:   applyUniformMatrix4fv(device, location, size, f);   break;
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_2D_RECT_ARB:
+			case GL_SAMPLER_EXTERNAL_OES:
+			case GL_SAMPLER_3D_OES:
+			case GL_SAMPLER_2D_ARRAY:
+			case GL_SAMPLER_2D_SHADOW:
+			case GL_SAMPLER_CUBE_SHADOW:
+			case GL_SAMPLER_2D_ARRAY_SHADOW:
+			case GL_INT_SAMPLER_2D:
+			case GL_UNSIGNED_INT_SAMPLER_2D:
+			case GL_INT_SAMPLER_CUBE:
+			case GL_UNSIGNED_INT_SAMPLER_CUBE:
+			case GL_INT_SAMPLER_3D:
+			case GL_UNSIGNED_INT_SAMPLER_3D:
+			case GL_INT_SAMPLER_2D_ARRAY:
+			case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+			case GL_INT:        applyUniform1iv(device, location, size, i);       break;
+			case GL_INT_VEC2:   applyUniform2iv(device, location, size, i);       break;
+			case GL_INT_VEC3:   applyUniform3iv(device, location, size, i);       break;
+			case GL_INT_VEC4:   applyUniform4iv(device, location, size, i);       break;
+			case GL_UNSIGNED_INT:      applyUniform1uiv(device, location, size, ui); break;
+			case GL_UNSIGNED_INT_VEC2: applyUniform2uiv(device, location, size, ui); break;
+			case GL_UNSIGNED_INT_VEC3: applyUniform3uiv(device, location, size, ui); break;
+			case GL_UNSIGNED_INT_VEC4: applyUniform4uiv(device, location, size, ui); break;
+			default:
+				UNREACHABLE(targetUniform->type);
+			}
+
+			targetUniform->dirty = false;
+		}
+
+		dirtyUniforms.clear();
+	}
+
 	void Program::applyUniformBuffers(Device *device, BufferBinding* uniformBuffers)
 	{
 		GLint vertexUniformBuffers[MAX_UNIFORM_BUFFER_BINDINGS];
@@ -1251,6 +1410,7 @@ namespace es2
 					transformFeedbackBuffers[index].getOffset() + baseOffset,
 					transformFeedbackLinkedVaryings[index].reg * 4 + transformFeedbackLinkedVaryings[index].col,
 					nbRegs, nbComponentsPerReg, componentStride);
+				transformFeedbackBuffers[index].get()->rendererWrite();
 				enableTransformFeedback |= 1ULL << index;
 			}
 		}
@@ -1262,6 +1422,7 @@ namespace es2
 			// written by a vertex shader are written, interleaved, into the buffer object
 			// bound to the first transform feedback binding point (index = 0).
 			sw::Resource* resource = transformFeedbackBuffers[0].get()->getResource();
+			transformFeedbackBuffers[0].get()->rendererWrite();
 			int componentStride = static_cast<int>(totalLinkedVaryingsComponents);
 			int baseOffset = transformFeedbackBuffers[0].getOffset() + (transformFeedback->vertexOffset() * componentStride * sizeof(float));
 			maxVaryings = sw::min(maxVaryings, (unsigned int)sw::MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS);
@@ -1377,9 +1538,21 @@ namespace es2
 							return false;
 						}
 
+						bool captured = false;
+
+						for(const std::string &indexedTfVaryingName : transformFeedbackVaryings)
+						{
+							captured = captured || (es2::ParseUniformName(indexedTfVaryingName, nullptr) == output.name);
+						}
+
+						// Components the fragment shader doesn't read are neither interpolated nor computed, unless they're captured
 						for(int i = 0; i < registers; i++)
 						{
-							vertexBinary->setOutput(out + i, components, sw::Shader::Semantic(sw::Shader::USAGE_COLOR, in + i, pixelBinary->getInput(in + i, 0).flat));
+							sw::Shader::Semantic interpolant = pixelBinary->getInput(in + i, 0);
+							unsigned int read = pixelBinary->getInputReadMask(in + i);
+
+							vertexBinary->setOutput(out + i, components, sw::Shader::Semantic(sw::Shader::USAGE_COLOR, in + i, interpolant.flat), captured ? 0xF : read);
+							pixelBinary->setInput(in + i, components, interpolant, read);
 						}
 					}
 					else   // Vertex varying is declared but not written to
@@ -1547,6 +1720,8 @@ namespace es2
 			return;
 		}
 
+		vertexBinary->eliminateDeadOutputs();
+
 		if(!linkAttributes())
 		{
 			return;
@@ -1573,6 +1748,24 @@ namespace es2
 			return;
 		}
 
+		// Pack the vertex outputs into the lowest registers, so cached vertices span fewer cache lines
+		int outputMap[sw::MAX_VERTEX_OUTPUTS];
+		vertexBinary->compactOutputs(outputMap);
+
+		for(auto &varying : transformFeedbackLinkedVaryings)
+		{
+			varying.reg = outputMap[varying.reg];
+		}
+
+		for(auto const &varying : fragmentShader->varyings)
+		{
+			if(varying.qualifier == EvqFragmentOut)
+			{
+				fragmentOutputs.push_back(LinkedVarying(varying.name, varying.type, varying.size(), varying.registerIndex, 0));
+			}
+		}
+
+		dirtyAllUniforms();
 		linked = true;   // Success
 	}
 
@@ -2657,7 +2850,10 @@ namespace es2
 		}
 
 		uniformIndex.clear();
+		dirtyUniforms.clear();
 		transformFeedbackLinkedVaryings.clear();
+		fragmentOutputs.clear();
+		depthRangeResolved = false;
 
 		delete[] infoLog;
 		infoLog = 0;
@@ -2677,8 +2873,390 @@ namespace es2
 
 	GLint Program::getBinaryLength() const
 	{
-		UNIMPLEMENTED();
-		return 0;
+		if(!linked)
+		{
+			return 0;
+		}
+
+		std::vector<unsigned int> data;
+		serialize(data);
+
+		return static_cast<GLint>(sizeof(BinaryHeader) + data.size() * sizeof(unsigned int));
+	}
+
+	bool Program::getBinary(GLsizei bufSize, GLsizei *length, void *binary) const
+	{
+		ASSERT(linked);
+
+		std::vector<unsigned int> data;
+		serialize(data);
+
+		size_t size = sizeof(BinaryHeader) + data.size() * sizeof(unsigned int);
+
+		if(static_cast<size_t>(bufSize) < size)
+		{
+			return false;
+		}
+
+		BinaryHeader header = {BINARY_MAGIC, BINARY_VERSION, sw::RoutineStore::getModuleFingerprint(), checksum(data)};
+		memcpy(binary, &header, sizeof(BinaryHeader));
+		memcpy(static_cast<unsigned char*>(binary) + sizeof(BinaryHeader), data.data(), data.size() * sizeof(unsigned int));
+
+		if(length)
+		{
+			*length = static_cast<GLsizei>(size);
+		}
+
+		return true;
+	}
+
+	// Restores the state of a linked program from a binary produced by getBinary(). The shader
+	// routines are generated again, or loaded from the routine store if that is enabled.
+	void Program::setBinary(const void *binary, GLsizei length)
+	{
+		unlink();
+
+		resetUniformBlockBindings();
+
+		BinaryHeader header = {};
+		std::vector<unsigned int> data;
+
+		if(static_cast<size_t>(length) >= sizeof(BinaryHeader) && (length - sizeof(BinaryHeader)) % sizeof(unsigned int) == 0)
+		{
+			memcpy(&header, binary, sizeof(BinaryHeader));
+			data.resize((length - sizeof(BinaryHeader)) / sizeof(unsigned int));
+			memcpy(data.data(), static_cast<const unsigned char*>(binary) + sizeof(BinaryHeader), data.size() * sizeof(unsigned int));
+		}
+
+		if(header.magic != BINARY_MAGIC || header.version != BINARY_VERSION ||
+		   header.module != sw::RoutineStore::getModuleFingerprint() || header.checksum != checksum(data))
+		{
+			appendToInfoLog("Program binary was not produced by this implementation");
+			return;
+		}
+
+		if(!deserialize(data.data(), data.data() + data.size()))
+		{
+			unlink();
+			appendToInfoLog("Program binary is invalid");
+			return;
+		}
+
+		dirtyAllUniforms();
+		linked = true;   // Success
+	}
+
+	void Program::serialize(std::vector<unsigned int> &data) const
+	{
+		pixelBinary->serialize(data);
+		vertexBinary->serialize(data);
+
+		data.push_back(static_cast<unsigned int>(linkedAttribute.size()));
+
+		for(const auto &attribute : linkedAttribute)
+		{
+			data.push_back(attribute.type);
+			writeString(data, attribute.name);
+			data.push_back(attribute.arraySize);
+			data.push_back(attribute.layoutLocation);
+			data.push_back(attribute.registerIndex);
+			data.push_back(linkedAttributeLocation.find(attribute.name)->second);
+		}
+
+		data.insert(data.end(), attributeStream, attributeStream + MAX_VERTEX_ATTRIBS);
+
+		for(const auto &sampler : samplersPS)
+		{
+			data.push_back(sampler.active);
+			data.push_back(sampler.textureType);
+		}
+
+		for(const auto &sampler : samplersVS)
+		{
+			data.push_back(sampler.active);
+			data.push_back(sampler.textureType);
+		}
+
+		data.push_back(static_cast<unsigned int>(uniforms.size()));
+
+		for(const Uniform *uniform : uniforms)
+		{
+			data.push_back(uniform->type);
+			data.push_back(uniform->precision);
+			writeString(data, uniform->name);
+			data.push_back(uniform->arraySize);
+			data.push_back(uniform->blockInfo.index);
+			data.push_back(uniform->blockInfo.offset);
+			data.push_back(uniform->blockInfo.arrayStride);
+			data.push_back(uniform->blockInfo.matrixStride);
+			data.push_back(uniform->blockInfo.isRowMajorMatrix);
+			writeFields(data, uniform->fields);
+			data.push_back(uniform->psRegisterIndex);
+			data.push_back(uniform->vsRegisterIndex);
+		}
+
+		data.push_back(static_cast<unsigned int>(uniformIndex.size()));
+
+		for(const auto &location : uniformIndex)
+		{
+			writeString(data, location.name);
+			data.push_back(location.element);
+			data.push_back(location.index);
+		}
+
+		data.push_back(static_cast<unsigned int>(uniformBlocks.size()));
+
+		for(const UniformBlock *block : uniformBlocks)
+		{
+			writeString(data, block->name);
+			data.push_back(block->elementIndex);
+			data.push_back(block->dataSize);
+			data.push_back(static_cast<unsigned int>(block->memberUniformIndexes.size()));
+			data.insert(data.end(), block->memberUniformIndexes.begin(), block->memberUniformIndexes.end());
+			data.push_back(block->psRegisterIndex);
+			data.push_back(block->vsRegisterIndex);
+		}
+
+		data.push_back(static_cast<unsigned int>(transformFeedbackVaryings.size()));
+
+		for(const auto &name : transformFeedbackVaryings)
+		{
+			writeString(data, name);
+		}
+
+		data.push_back(transformFeedbackBufferMode);
+		data.push_back(static_cast<unsigned int>(totalLinkedVaryingsComponents));
+
+		for(const LinkedVaryingArray *varyings : {&transformFeedbackLinkedVaryings, &fragmentOutputs})
+		{
+			data.push_back(static_cast<unsigned int>(varyings->size()));
+
+			for(const auto &varying : *varyings)
+			{
+				writeString(data, varying.name);
+				data.push_back(varying.type);
+				data.push_back(varying.size);
+				data.push_back(varying.reg);
+				data.push_back(varying.col);
+			}
+		}
+	}
+
+	bool Program::deserialize(const unsigned int *data, const unsigned int *end)
+	{
+		pixelBinary = new sw::PixelShader();
+		vertexBinary = new sw::VertexShader();
+
+		if(!pixelBinary->deserialize(data, end) || !vertexBinary->deserialize(data, end))
+		{
+			return false;
+		}
+
+		BinaryReader reader(data, end);
+
+		size_t attributeCount = reader.readCount();
+
+		for(size_t i = 0; i < attributeCount && !reader.failed; i++)
+		{
+			GLenum type = reader.read();
+			std::string name = reader.readString();
+			int arraySize = reader.read();
+			int layoutLocation = reader.read();
+			int registerIndex = reader.read();
+			int location = reader.read();
+
+			if(layoutLocation < -1 || layoutLocation >= MAX_VERTEX_ATTRIBS ||
+			   registerIndex < -1 || registerIndex >= MAX_VERTEX_ATTRIBS ||
+			   location < 0 || location >= MAX_VERTEX_ATTRIBS)
+			{
+				return false;
+			}
+
+			linkedAttribute.push_back(glsl::Attribute(type, name, arraySize, layoutLocation, registerIndex));
+			linkedAttributeLocation[name] = location;
+		}
+
+		for(int index = 0; index < MAX_VERTEX_ATTRIBS; index++)
+		{
+			attributeStream[index] = reader.read();
+
+			if(attributeStream[index] < -1 || attributeStream[index] >= MAX_VERTEX_ATTRIBS)
+			{
+				return false;
+			}
+		}
+
+		for(auto &sampler : samplersPS)
+		{
+			sampler.active = (reader.read() != 0);
+			sampler.logicalTextureUnit = 0;
+			sampler.textureType = static_cast<TextureType>(reader.read());
+
+			if(sampler.active && sampler.textureType >= TEXTURE_TYPE_COUNT)
+			{
+				return false;
+			}
+		}
+
+		for(auto &sampler : samplersVS)
+		{
+			sampler.active = (reader.read() != 0);
+			sampler.logicalTextureUnit = 0;
+			sampler.textureType = static_cast<TextureType>(reader.read());
+
+			if(sampler.active && sampler.textureType >= TEXTURE_TYPE_COUNT)
+			{
+				return false;
+			}
+		}
+
+		size_t uniformCount = reader.readCount();
+
+		for(size_t i = 0; i < uniformCount && !reader.failed; i++)
+		{
+			GLenum type = reader.read();
+			GLenum precision = reader.read();
+			std::string name = reader.readString();
+			unsigned int arraySize = reader.read();
+
+			Uniform::BlockInfo blockInfo;
+			blockInfo.index = reader.read();
+			blockInfo.offset = reader.read();
+			blockInfo.arrayStride = reader.read();
+			blockInfo.matrixStride = reader.read();
+			blockInfo.isRowMajorMatrix = (reader.read() != 0);
+
+			std::vector<glsl::ShaderVariable> fields;
+			reader.readFields(fields);
+
+			// Uniforms outside of blocks take at least a register per element, and allocate their storage up front
+			if(blockInfo.index == -1 && (arraySize > MAX_UNIFORM_VECTORS || UniformTypeSize(type) == 0))
+			{
+				return false;
+			}
+
+			Uniform *uniform = new Uniform(type, precision, name, arraySize, blockInfo, fields);
+			uniforms.push_back(uniform);
+
+			int psRegisterIndex = reader.read();
+			int vsRegisterIndex = reader.read();
+
+			if(psRegisterIndex < -1 || psRegisterIndex >= sw::FRAGMENT_UNIFORM_VECTORS ||
+			   vsRegisterIndex < -1 || vsRegisterIndex >= sw::VERTEX_UNIFORM_VECTORS)
+			{
+				return false;
+			}
+
+			uniform->psRegisterIndex = static_cast<short>(psRegisterIndex);
+			uniform->vsRegisterIndex = static_cast<short>(vsRegisterIndex);
+		}
+
+		size_t locationCount = reader.readCount();
+
+		for(size_t i = 0; i < locationCount && !reader.failed; i++)
+		{
+			std::string name = reader.readString();
+			unsigned int element = reader.read();
+			unsigned int index = reader.read();
+
+			if(index != GL_INVALID_INDEX && (index >= uniforms.size() || element >= static_cast<unsigned int>(uniforms[index]->size())))
+			{
+				return false;
+			}
+
+			uniformIndex.push_back(UniformLocation(name, element, index));
+		}
+
+		size_t blockCount = reader.readCount();
+
+		if(blockCount > MAX_UNIFORM_BUFFER_BINDINGS)   // Each block has a binding
+		{
+			return false;
+		}
+
+		for(size_t i = 0; i < blockCount && !reader.failed; i++)
+		{
+			std::string name = reader.readString();
+			unsigned int elementIndex = reader.read();
+			unsigned int dataSize = reader.read();
+
+			std::vector<unsigned int> memberUniformIndexes(reader.readCount());
+
+			for(auto &memberUniformIndex : memberUniformIndexes)
+			{
+				memberUniformIndex = reader.read();
+
+				if(memberUniformIndex >= uniforms.size())
+				{
+					return false;
+				}
+			}
+
+			UniformBlock *block = new UniformBlock(name, elementIndex, dataSize, memberUniformIndexes);
+			uniformBlocks.push_back(block);
+
+			block->psRegisterIndex = reader.read();
+			block->vsRegisterIndex = reader.read();
+
+			if((block->psRegisterIndex != GL_INVALID_INDEX && block->psRegisterIndex >= MAX_UNIFORM_BUFFER_BINDINGS) ||
+			   (block->vsRegisterIndex != GL_INVALID_INDEX && block->vsRegisterIndex >= MAX_UNIFORM_BUFFER_BINDINGS))
+			{
+				return false;
+			}
+		}
+
+		for(const Uniform *uniform : uniforms)
+		{
+			if(uniform->blockInfo.index < -1 || uniform->blockInfo.index >= static_cast<int>(uniformBlocks.size()))
+			{
+				return false;
+			}
+		}
+
+		std::vector<std::string> varyingNames(reader.readCount());
+
+		for(auto &name : varyingNames)
+		{
+			name = reader.readString();
+		}
+
+		GLenum bufferMode = reader.read();
+		size_t totalComponents = reader.read();
+
+		for(LinkedVaryingArray *varyings : {&transformFeedbackLinkedVaryings, &fragmentOutputs})
+		{
+			size_t varyingCount = reader.readCount();
+
+			for(size_t i = 0; i < varyingCount && !reader.failed; i++)
+			{
+				std::string name = reader.readString();
+				GLenum type = reader.read();
+				GLsizei size = reader.read();
+				int reg = reader.read();
+				int col = reader.read();
+
+				// Transform feedback reads the vertex output registers, fragment outputs are draw buffer locations
+				int registers = (varyings == &fragmentOutputs) ? MAX_DRAW_BUFFERS : sw::MAX_VERTEX_OUTPUTS;
+
+				if(size < 1 || size > registers || reg < 0 || reg > registers - VariableRegisterCount(type) * size || col < 0 || col > 3)
+				{
+					return false;
+				}
+
+				varyings->push_back(LinkedVarying(name, type, size, reg, col));
+			}
+		}
+
+		if(reader.failed || reader.data != reader.end)
+		{
+			return false;
+		}
+
+		transformFeedbackVaryings = varyingNames;
+		transformFeedbackBufferMode = bufferMode;
+		totalLinkedVaryingsComponents = totalComponents;
+
+		return true;
 	}
 
 	void Program::release()
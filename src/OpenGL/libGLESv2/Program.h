@@ -40,6 +40,7 @@ namespace es2
 	{
 		struct BlockInfo
 		{
+			BlockInfo() = default;
 			BlockInfo(const glsl::Uniform& uniform, int blockIndex);
 
 			int index = -1;
@@ -50,6 +51,8 @@ namespace es2
 		};
 
 		Uniform(const glsl::Uniform &uniform, const BlockInfo &blockInfo);
+		Uniform(GLenum type, GLenum precision, const std::string &name, unsigned int arraySize,
+		        const BlockInfo &blockInfo, const std::vector<glsl::ShaderVariable> &fields);
 
 		~Uniform();
 
@@ -146,6 +149,7 @@ namespace es2
 		void getActiveUniformBlockiv(GLuint uniformBlockIndex, GLenum pname, GLint *params) const;
 
 		GLint getUniformLocation(const std::string &name) const;
+		void setDepthRange(GLfloat zNear, GLfloat zFar);
 		bool setUniform1fv(GLint location, GLsizei count, const GLfloat *v);
 		bool setUniform2fv(GLint location, GLsizei count, const GLfloat *v);
 		bool setUniform3fv(GLint location, GLsizei count, const GLfloat *v);
@@ -219,11 +223,16 @@ namespace es2
 		bool getBinaryRetrievableHint() const { return retrievableBinary; }
 		void setBinaryRetrievable(bool retrievable) { retrievableBinary = retrievable; }
 		GLint getBinaryLength() const;
+		bool getBinary(GLsizei bufSize, GLsizei *length, void *binary) const;   // Fails if bufSize is too small
+		void setBinary(const void *binary, GLsizei length);   // Leaves the program unlinked if the binary was rejected
 
 	private:
 		void unlink();
 		void resetUniformBlockBindings();
 
+		void serialize(std::vector<unsigned int> &data) const;
+		bool deserialize(const unsigned int *data, const unsigned int *end);
+
 		bool linkVaryings();
 		bool linkTransformFeedback();
 
@@ -239,6 +248,7 @@ namespace es2
 		bool validateUniformStruct(GLenum shader, const glsl::Uniform &newUniformStruct);
 		bool defineUniform(GLenum shader, const glsl::Uniform &uniform, const Uniform::BlockInfo& blockInfo);
 		bool defineUniformBlock(const Shader *shader, const glsl::UniformBlock &block);
+		void dirtyUniform(GLint location);
 		bool applyUniform(Device *device, GLint location, float* data);
 		bool applyUniform1bv(Device *device, GLint location, GLsizei count, const GLboolean *v);
 		bool applyUniform2bv(Device *device, GLint location, GLsizei count, const GLboolean *v);
@@ -309,10 +319,14 @@ namespace es2
 		UniformStructArray uniformStructs;
 		typedef std::vector<UniformLocation> UniformIndex;
 		UniformIndex uniformIndex;
+		std::vector<GLint> dirtyUniforms;   // First locations of the uniforms changed since they were last applied
 		typedef std::vector<UniformBlock*> UniformBlockArray;
 		UniformBlockArray uniformBlocks;
 		typedef std::vector<LinkedVarying> LinkedVaryingArray;
 		LinkedVaryingArray transformFeedbackLinkedVaryings;
+		LinkedVaryingArray fragmentOutputs;
+		GLint depthRangeLocation[3];
+		bool depthRangeResolved;
 
 		bool linked;
 		bool orphaned;   // Flag to indicate that the program can be deleted when no longer in use
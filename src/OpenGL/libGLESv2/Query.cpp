@@ -17,7 +17,6 @@
 #include "Query.h"
 
 #include "main.h"
-#include "Common/Thread.hpp"
 
 namespace es2
 {
@@ -28,10 +27,17 @@ Query::Query(GLuint name, GLenum type) : NamedObject(name)
 	mStatus = GL_FALSE;
 	mResult = GL_FALSE;
 	mType = type;
+	mSequence = 0;
+	mDevice = nullptr;
 }
 
 Query::~Query()
 {
+	if(mDevice)
+	{
+		mDevice->removeTimestamp(mQuery);   // The renderer completes it asynchronously
+	}
+
 	delete mQuery;
 }
 
@@ -44,11 +50,14 @@ void Query::begin()
 		{
 		case GL_ANY_SAMPLES_PASSED_EXT:
 		case GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT:
-			type = sw::Query::FRAGMENTS_PASSED;
+			type = sw::Query::ANY_FRAGMENTS_PASSED;
 			break;
 		case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 			type = sw::Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN;
 			break;
+		case GL_TIME_ELAPSED_EXT:
+			type = sw::Query::TIME_ELAPSED;
+			break;
 		default:
 			UNREACHABLE(mType);
 			return;
@@ -75,6 +84,8 @@ void Query::begin()
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 		device->setTransformFeedbackQueryEnabled(true);
 		break;
+	case GL_TIME_ELAPSED_EXT:
+		break;
 	default:
 		ASSERT(false);
 	}
@@ -100,25 +111,61 @@ void Query::end()
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 		device->setTransformFeedbackQueryEnabled(false);
 		break;
+	case GL_TIME_ELAPSED_EXT:
+		break;
 	default:
 		ASSERT(false);
 	}
 
 	mStatus = GL_FALSE;
 	mResult = GL_FALSE;
+	mSequence = device->getDrawSequence();
+}
+
+void Query::counter()
+{
+	ASSERT(mType == GL_TIMESTAMP_EXT);
+
+	if(!mQuery)
+	{
+		mQuery = new sw::Query(sw::Query::TIMESTAMP);
+	}
+
+	Device *device = getDevice();
+
+	if(mDevice)
+	{
+		mDevice->removeTimestamp(mQuery);   // Superseded by the new one
+	}
+
+	mStatus = GL_FALSE;
+	mResult = 0;
+	mSequence = device->getDrawSequence();
+	mDevice = device;
+
+	mQuery->reference = 0;
+	device->addTimestamp(mQuery);
 }
 
-GLuint Query::getResult()
+GLuint64 Query::getResult()
 {
 	if(mQuery)
 	{
-		while(!testQuery())
+		if(!testQuery())
 		{
-			sw::Thread::yield();
+			Device *device = getDevice();
+			device->waitForDraw(mSequence);   // Only the draw calls issued before the query ended
+
+			if(mType == GL_TIMESTAMP_EXT)
+			{
+				device->resolveTimestamps();   // Instead of waiting for the thread which retired the last draw call
+			}
+
+			testQuery();
 		}
 	}
 
-	return (GLuint)mResult;
+	return mResult;
 }
 
 GLboolean Query::isResultAvailable()
@@ -140,10 +187,13 @@ GLboolean Query::testQuery()
 {
 	if(mQuery != nullptr && mStatus != GL_TRUE)
 	{
-		if(!mQuery->building && mQuery->reference == 0)
+		bool passed = (mQuery->type == sw::Query::ANY_FRAGMENTS_PASSED) && (mQuery->data > 0);   // Later draw calls can't change the result
+
+		if(!mQuery->building && (mQuery->reference == 0 || passed))
 		{
 			unsigned int resultSum = mQuery->data;
 			mStatus = GL_TRUE;
+			mDevice = nullptr;   // No longer pending
 
 			switch(mType)
 			{
@@ -154,6 +204,12 @@ GLboolean Query::testQuery()
 			case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 				mResult = resultSum;
 				break;
+			case GL_TIME_ELAPSED_EXT:
+				mResult = (mQuery->start != 0) ? (GLuint64)(mQuery->finish - mQuery->start) : 0;   // No draw calls
+				break;
+			case GL_TIMESTAMP_EXT:
+				mResult = (GLuint64)mQuery->finish.load();
+				break;
 			default:
 				ASSERT(false);
 			}
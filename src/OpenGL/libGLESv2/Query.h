@@ -24,6 +24,7 @@
 
 namespace es2
 {
+class Device;
 
 class Query : public gl::NamedObject
 {
@@ -33,7 +34,8 @@ public:
 
 	void begin();
 	void end();
-	GLuint getResult();
+	void counter();   // Records a GL_TIMESTAMP_EXT query
+	GLuint64 getResult();
 	GLboolean isResultAvailable();
 
 	GLenum getType() const;
@@ -44,7 +46,9 @@ private:
 	sw::Query* mQuery;
 	GLenum mType;
 	GLboolean mStatus;
-	GLint mResult;
+	GLuint64 mResult;
+	int64_t mSequence;   // Of the last draw call issued while the query was active
+	Device *mDevice;     // Which a pending timestamp was added to
 };
 
 }
@@ -20,6 +20,7 @@
 
 #include "main.h"
 #include "Texture.h"
+#include "Framebuffer.h"
 #include "utilities.h"
 
 namespace es2
@@ -436,7 +437,8 @@ GLsizei Renderbuffer::getSamples() const
 
 void Renderbuffer::setLevel(GLint level)
 {
-	return mInstance->setLevel(level);
+	mInstance->setLevel(level);
+	Framebuffer::storageChanged();   // Texture proxies are shared by the framebuffers they're attached to
 }
 
 void Renderbuffer::setStorage(RenderbufferStorage *newStorage)
@@ -445,6 +447,7 @@ void Renderbuffer::setStorage(RenderbufferStorage *newStorage)
 
 	delete mInstance;
 	mInstance = newStorage;
+	Framebuffer::storageChanged();
 }
 
 RenderbufferStorage::RenderbufferStorage()
@@ -136,11 +136,11 @@ GLuint ResourceManager::createSampler()
 }
 
 // Returns the next unused fence name, and allocates the fence
-GLuint ResourceManager::createFenceSync(GLenum condition, GLbitfield flags)
+GLuint ResourceManager::createFenceSync(GLenum condition, GLbitfield flags, Device *device)
 {
 	GLuint name = mFenceSyncNameSpace.allocate();
 
-	FenceSync *fenceSync = new FenceSync(name, condition, flags);
+	FenceSync *fenceSync = new FenceSync(name, condition, flags, device);
 	fenceSync->addRef();
 
 	mFenceSyncNameSpace.insert(name, fenceSync);
@@ -236,6 +236,21 @@ void ResourceManager::deleteFenceSync(GLuint fenceSync)
 	}
 }
 
+void ResourceManager::detachFenceSyncs(Device *device)
+{
+	GLuint name = 0;
+
+	while(mFenceSyncNameSpace.nextName(name))
+	{
+		FenceSync *fenceSync = mFenceSyncNameSpace.find(name);
+
+		if(fenceSync)
+		{
+			fenceSync->detach(device);
+		}
+	}
+}
+
 Buffer *ResourceManager::getBuffer(unsigned int handle)
 {
 	return mBufferNameSpace.find(handle);
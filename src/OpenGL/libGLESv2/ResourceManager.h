@@ -33,6 +33,7 @@ class Texture;
 class Renderbuffer;
 class Sampler;
 class FenceSync;
+class Device;
 
 enum TextureType
 {
@@ -62,7 +63,7 @@ public:
 	GLuint createTexture();
 	GLuint createRenderbuffer();
 	GLuint createSampler();
-	GLuint createFenceSync(GLenum condition, GLbitfield flags);
+	GLuint createFenceSync(GLenum condition, GLbitfield flags, Device *device);
 
 	void deleteBuffer(GLuint buffer);
 	void deleteShader(GLuint shader);
@@ -71,6 +72,7 @@ public:
 	void deleteRenderbuffer(GLuint renderbuffer);
 	void deleteSampler(GLuint sampler);
 	void deleteFenceSync(GLuint fenceSync);
+	void detachFenceSyncs(Device *device);   // The device is being destroyed, after finishing its draw calls
 
 	Buffer *getBuffer(GLuint handle);
 	Shader *getShader(GLuint handle);
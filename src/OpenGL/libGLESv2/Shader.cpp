@@ -20,17 +20,303 @@
 
 #include "main.h"
 #include "utilities.h"
+#include "Common/CPUID.hpp"
 
 #include <string>
 #include <algorithm>
+#include <deque>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace es2
 {
-bool Shader::compilerInitialized = false;
+// Keeps the results of recent compiles for the whole process, to hand them out again for identical
+// source. Entries are evicted in least recently used order.
+class ShaderCache
+{
+public:
+	// Compile result, keyed by the shader type followed by the source
+	struct Result
+	{
+		std::unique_ptr<sw::Shader> binary;   // Null if the compile failed
+		glsl::VaryingList varyings;
+		glsl::ActiveUniforms activeUniforms;
+		glsl::ActiveUniforms activeUniformStructs;
+		glsl::ActiveAttributes activeAttributes;
+		glsl::ActiveUniformBlocks activeUniformBlocks;
+		int shaderVersion;
+		std::string infoLog;
+	};
+
+	bool load(Shader *shader, const std::string &key);   // Copies an earlier result, if any
+	void store(Result *result, const std::string &key);   // Takes ownership of the result
+
+	static Result *save(const Shader *shader);
+	static void restore(const Result *result, Shader *shader);
+
+private:
+	enum
+	{
+		MAX_CACHED_SHADERS = 256,
+	};
+
+	typedef std::list<std::pair<std::string, std::unique_ptr<Result>>> ResultList;
+
+	ResultList results;   // Most recently used first
+	std::unordered_map<std::string, ResultList::iterator> index;
+	sw::MutexLock mutex;
+};
+
+// Translates shaders on background threads, which each reuse their own compiler per shader type.
+class ShaderCompiler
+{
+public:
+	ShaderCompiler(ShaderCache *cache);
+	~ShaderCompiler();   // Completes the queued compiles
+
+	void queue(Shader *shader, const std::string &key);
+
+private:
+	enum
+	{
+		MAX_COMPILER_THREADS = 4,
+	};
+
+	struct Job
+	{
+		std::vector<Shader*> shaders;   // Queued with the same source, only the first one gets translated
+		std::string key;
+	};
+
+	static void threadFunction(void *parameters);
+	void compileLoop();
+
+	ShaderCache *cache;
+
+	sw::Thread *thread[MAX_COMPILER_THREADS];
+	int threadCount;
+
+	std::deque<Job> jobs;
+	sw::MutexLock jobMutex;
+	sw::Event jobEvent;
+	bool terminate;
+};
+
+bool ShaderCache::load(Shader *shader, const std::string &key)
+{
+	mutex.lock();
+
+	auto entry = index.find(key);
+	bool found = (entry != index.end());
+
+	if(found)
+	{
+		results.splice(results.begin(), results, entry->second);
+		restore(entry->second->second.get(), shader);
+	}
+
+	mutex.unlock();
+
+	return found;
+}
+
+void ShaderCache::store(Result *result, const std::string &key)
+{
+	mutex.lock();
+
+	auto entry = index.find(key);
+
+	if(entry != index.end())
+	{
+		entry->second->second.reset(result);
+		results.splice(results.begin(), results, entry->second);
+	}
+	else
+	{
+		if(results.size() == MAX_CACHED_SHADERS)
+		{
+			index.erase(results.back().first);
+			results.pop_back();
+		}
+
+		results.emplace_front(key, std::unique_ptr<Result>(result));
+		index[key] = results.begin();
+	}
+
+	mutex.unlock();
+}
+
+ShaderCompiler::ShaderCompiler(ShaderCache *cache) : cache(cache)
+{
+	terminate = false;
+	threadCount = sw::max(sw::min(sw::CPUID::processAffinity(), (int)MAX_COMPILER_THREADS), 1);
+
+	for(int i = 0; i < threadCount; i++)
+	{
+		thread[i] = new sw::Thread(threadFunction, this);
+	}
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+	jobMutex.lock();
+	terminate = true;
+	jobMutex.unlock();
+	jobEvent.signal();
+
+	for(int i = 0; i < threadCount; i++)
+	{
+		thread[i]->join();
+		delete thread[i];
+	}
+}
+
+ShaderCache::Result *ShaderCache::save(const Shader *shader)
+{
+	Result *result = new Result;
+
+	if(shader->getVertexShader())
+	{
+		result->binary.reset(new sw::VertexShader(shader->getVertexShader()));
+	}
+	else if(shader->getPixelShader())
+	{
+		result->binary.reset(new sw::PixelShader(shader->getPixelShader()));
+	}
+
+	result->varyings = shader->varyings;
+	result->activeUniforms = shader->activeUniforms;
+	result->activeUniformStructs = shader->activeUniformStructs;
+	result->activeAttributes = shader->activeAttributes;
+	result->activeUniformBlocks = shader->activeUniformBlocks;
+	result->shaderVersion = shader->shaderVersion;
+	result->infoLog = shader->infoLog;
+
+	return result;
+}
+
+void ShaderCache::restore(const Result *result, Shader *shader)
+{
+	if(result->binary)
+	{
+		shader->createShader(result->binary.get());
+	}
+	else
+	{
+		shader->deleteShader();
+	}
+
+	shader->varyings = result->varyings;
+	shader->activeUniforms = result->activeUniforms;
+	shader->activeUniformStructs = result->activeUniformStructs;
+	shader->activeAttributes = result->activeAttributes;
+	shader->activeUniformBlocks = result->activeUniformBlocks;
+	shader->shaderVersion = result->shaderVersion;
+	shader->infoLog = result->infoLog;
+}
+
+void ShaderCompiler::queue(Shader *shader, const std::string &key)
+{
+	jobMutex.lock();
+
+	auto job = std::find_if(jobs.begin(), jobs.end(), [&](const Job &job) { return job.key == key; });
+
+	if(job != jobs.end())
+	{
+		job->shaders.push_back(shader);
+	}
+	else
+	{
+		jobs.push_back({{shader}, key});
+	}
+
+	jobMutex.unlock();
+
+	jobEvent.signal();
+}
+
+void ShaderCompiler::threadFunction(void *parameters)
+{
+	static_cast<ShaderCompiler*>(parameters)->compileLoop();
+}
+
+void ShaderCompiler::compileLoop()
+{
+	// Building the built-in symbol table dominates the cost of compiling a small shader, so each thread keeps its compilers
+	TranslatorASM *vertexCompiler = nullptr;
+	TranslatorASM *fragmentCompiler = nullptr;
+
+	while(true)
+	{
+		jobMutex.lock();
+
+		if(jobs.empty())
+		{
+			bool exit = terminate;
+			jobMutex.unlock();
+
+			if(exit)
+			{
+				jobEvent.signal();   // Pass it on to the next thread
+				break;
+			}
+
+			jobEvent.wait();
+			continue;
+		}
+
+		Job job = std::move(jobs.front());
+		jobs.pop_front();
+
+		if(!jobs.empty())
+		{
+			jobEvent.signal();   // Wake another thread for the rest
+		}
+
+		jobMutex.unlock();
+
+		Shader *shader = job.shaders[0];
+		GLenum type = shader->getType();
+		TranslatorASM *&compiler = (type == GL_VERTEX_SHADER) ? vertexCompiler : fragmentCompiler;
+
+		if(!compiler)
+		{
+			compiler = Shader::createCompiler(type);
+		}
+
+		shader->translate(compiler, job.key.c_str() + 1);
+		ShaderCache::Result *result = ShaderCache::save(shader);
+
+		for(Shader *queued : job.shaders)
+		{
+			if(queued != shader)
+			{
+				ShaderCache::restore(result, queued);
+			}
+
+			queued->mCompileDone.signal();   // The shader may be deleted from here on
+		}
+
+		cache->store(result, job.key);
+	}
+
+	delete vertexCompiler;
+	delete fragmentCompiler;
+}
+
+namespace
+{
+	ShaderCache *shaderCache = nullptr;   // Created on the first compile, kept for the life of the process
+	ShaderCompiler *shaderCompiler = nullptr;   // Created on the first compile, until the compiler is released
+	sw::MutexLock shaderCompilerMutex;
+}
 
 Shader::Shader(ResourceManager *manager, GLuint handle) : mHandle(handle), mResourceManager(manager)
 {
 	mSource = nullptr;
+	mCompiling = false;
 
 	clear();
 
@@ -90,6 +376,8 @@ void Shader::setSource(GLsizei count, const char *const *string, const GLint *le
 
 size_t Shader::getInfoLogLength() const
 {
+	finishCompile();
+
 	if(infoLog.empty())
 	{
 		return 0;
@@ -102,6 +390,8 @@ size_t Shader::getInfoLogLength() const
 
 void Shader::getInfoLog(GLsizei bufSize, GLsizei *length, char *infoLogOut)
 {
+	finishCompile();
+
 	int index = 0;
 
 	if(bufSize > 0)
@@ -156,13 +446,7 @@ void Shader::getSource(GLsizei bufSize, GLsizei *length, char *source)
 
 TranslatorASM *Shader::createCompiler(GLenum shaderType)
 {
-	if(!compilerInitialized)
-	{
-		InitCompilerGlobals();
-		compilerInitialized = true;
-	}
-
-	TranslatorASM *assembler = new TranslatorASM(this, shaderType);
+	TranslatorASM *assembler = new TranslatorASM(nullptr, shaderType);
 
 	ShBuiltInResources resources;
 	resources.MaxVertexAttribs = MAX_VERTEX_ATTRIBS;
@@ -194,23 +478,50 @@ void Shader::clear()
 
 	varyings.clear();
 	activeUniforms.clear();
+	activeUniformStructs.clear();
 	activeAttributes.clear();
+	activeUniformBlocks.clear();
 }
 
 void Shader::compile()
 {
+	finishCompile();
 	clear();
-
-	createShader();
-	TranslatorASM *compiler = createCompiler(getType());
+	deleteShader();
 
 	// Ensure we don't pass a nullptr source to the compiler
-	const char *source = "\0";
+	std::string key = (getType() == GL_VERTEX_SHADER) ? "v" : "f";
 	if(mSource)
 	{
-		source = mSource;
+		key += mSource;
+	}
+
+	shaderCompilerMutex.lock();
+
+	if(!shaderCache)
+	{
+		shaderCache = new ShaderCache();
 	}
 
+	if(!shaderCache->load(this, key))
+	{
+		if(!shaderCompiler)
+		{
+			shaderCompiler = new ShaderCompiler(shaderCache);
+		}
+
+		createShader(nullptr);
+		mCompiling = true;
+		shaderCompiler->queue(this, key);
+	}
+
+	shaderCompilerMutex.unlock();
+}
+
+void Shader::translate(TranslatorASM *compiler, const char *source)
+{
+	compiler->setShaderObject(this);
+
 	bool success = compiler->compile(&source, 1, SH_OBJECT_CODE);
 
 	if(false)
@@ -222,7 +533,7 @@ void Shader::compile()
 			char buffer[256];
 			sprintf(buffer, "shader-input-%d-%d.txt", getName(), serial);
 			FILE *file = fopen(buffer, "wt");
-			fprintf(file, "%s", mSource);
+			fprintf(file, "%s", source);
 			fclose(file);
 		}
 
@@ -240,12 +551,21 @@ void Shader::compile()
 
 		TRACE("\n%s", infoLog.c_str());
 	}
+}
 
-	delete compiler;
+void Shader::finishCompile() const
+{
+	if(mCompiling)
+	{
+		mCompileDone.wait();
+		mCompiling = false;
+	}
 }
 
 bool Shader::isCompiled()
 {
+	finishCompile();
+
 	return getShader() != 0;
 }
 
@@ -281,8 +601,10 @@ void Shader::flagForDeletion()
 
 void Shader::releaseCompiler()
 {
-	FreeCompilerGlobals();
-	compilerInitialized = false;
+	shaderCompilerMutex.lock();
+	delete shaderCompiler;
+	shaderCompiler = nullptr;
+	shaderCompilerMutex.unlock();
 }
 
 // true if varying x has a higher priority in packing than y
@@ -375,6 +697,8 @@ VertexShader::VertexShader(ResourceManager *manager, GLuint handle) : Shader(man
 
 VertexShader::~VertexShader()
 {
+	finishCompile();
+
 	delete vertexShader;
 }
 
@@ -409,10 +733,10 @@ sw::VertexShader *VertexShader::getVertexShader() const
 	return vertexShader;
 }
 
-void VertexShader::createShader()
+void VertexShader::createShader(const sw::Shader *binary)
 {
 	delete vertexShader;
-	vertexShader = new sw::VertexShader();
+	vertexShader = new sw::VertexShader(static_cast<const sw::VertexShader*>(binary));
 }
 
 void VertexShader::deleteShader()
@@ -428,6 +752,8 @@ FragmentShader::FragmentShader(ResourceManager *manager, GLuint handle) : Shader
 
 FragmentShader::~FragmentShader()
 {
+	finishCompile();
+
 	delete pixelShader;
 }
 
@@ -446,10 +772,10 @@ sw::PixelShader *FragmentShader::getPixelShader() const
 	return pixelShader;
 }
 
-void FragmentShader::createShader()
+void FragmentShader::createShader(const sw::Shader *binary)
 {
 	delete pixelShader;
-	pixelShader = new sw::PixelShader();
+	pixelShader = new sw::PixelShader(static_cast<const sw::PixelShader*>(binary));
 }
 
 void FragmentShader::deleteShader()
@@ -23,6 +23,7 @@
 #include "ResourceManager.h"
 
 #include "compiler/TranslatorASM.h"
+#include "Common/Thread.hpp"
 
 #include <GLES2/gl2.h>
 
@@ -37,10 +38,14 @@ namespace glsl
 
 namespace es2
 {
+class ShaderCache;
+class ShaderCompiler;
 
 class Shader : public glsl::Shader
 {
 	friend class Program;
+	friend class ShaderCache;
+	friend class ShaderCompiler;
 
 public:
 	Shader(ResourceManager *manager, GLuint handle);
@@ -57,7 +62,7 @@ public:
 	size_t getSourceLength() const;
 	void getSource(GLsizei bufSize, GLsizei *length, char *source);
 
-	void compile();
+	void compile();   // Translates on a compiler thread, unless a shader with the same source was compiled before in this process
 	bool isCompiled();
 
 	void addRef();
@@ -69,9 +74,9 @@ public:
 	static void releaseCompiler();
 
 protected:
-	static bool compilerInitialized;
-	TranslatorASM *createCompiler(GLenum shaderType);
+	static TranslatorASM *createCompiler(GLenum shaderType);
 	void clear();
+	void finishCompile() const;   // Waits for the pending compile to complete
 
 	static bool compareVarying(const glsl::Varying &x, const glsl::Varying &y);
 
@@ -79,9 +84,14 @@ protected:
 	std::string infoLog;
 
 private:
-	virtual void createShader() = 0;
+	void translate(TranslatorASM *compiler, const char *source);   // Runs on a compiler thread
+
+	virtual void createShader(const sw::Shader *binary) = 0;   // Copies the binary if not null
 	virtual void deleteShader() = 0;
 
+	mutable bool mCompiling;
+	mutable sw::Event mCompileDone;
+
 	const GLuint mHandle;
 	unsigned int mRefCount;     // Number of program objects this shader is attached to
 	bool mDeleteStatus;         // Flag to indicate that the shader can be deleted when no longer in use
@@ -105,7 +115,7 @@ public:
 	virtual sw::VertexShader *getVertexShader() const;
 
 private:
-	virtual void createShader();
+	virtual void createShader(const sw::Shader *binary);
 	virtual void deleteShader();
 
 	sw::VertexShader *vertexShader;
@@ -124,7 +134,7 @@ public:
 	virtual sw::PixelShader *getPixelShader() const;
 
 private:
-	virtual void createShader();
+	virtual void createShader(const sw::Shader *binary);
 	virtual void deleteShader();
 
 	sw::PixelShader *pixelShader;
@@ -415,6 +415,59 @@ bool Texture::isMipmapFiltered() const
 	return false;
 }
 
+bool Texture::reuseMipmapImage(const egl::Image *image, const egl::Image *base, int level)
+{
+	// Images shared with EGLImage siblings must keep their previous contents
+	return image && !image->isShared() &&
+	       image->getWidth() == std::max(base->getWidth() >> level, 1) &&
+	       image->getHeight() == std::max(base->getHeight() >> level, 1) &&
+	       image->getDepth() == 1 &&
+	       image->getFormat() == base->getFormat();
+}
+
+bool Texture::reuseCopyImage(const egl::Image *image, GLint x, GLint y, GLsizei width, GLsizei height, GLint internalformat, const egl::Image *source)
+{
+	// Images shared with EGLImage siblings must keep their previous contents, and a level attached
+	// to the read framebuffer gets new storage so the copy doesn't overwrite what it reads. Texels
+	// outside the framebuffer keep their cleared value, so the copy has to cover the whole level.
+	return image && !image->isShared() && source && image != source &&
+	       image->getWidth() == width &&
+	       image->getHeight() == height &&
+	       image->getFormat() == internalformat &&
+	       x >= 0 && y >= 0 && x + width <= source->getWidth() && y + height <= source->getHeight();
+}
+
+void Texture::allocateStorage(egl::Image *const *images, int count)
+{
+	const size_t alignment = 16;   // Like separately allocated buffers
+	size_t bytes = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		if(images[i])
+		{
+			bytes += (images[i]->getInternalSize() + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	if(bytes == 0)
+	{
+		return;
+	}
+
+	sw::Surface::Storage *storage = new sw::Surface::Storage(bytes);
+	size_t offset = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		if(images[i])
+		{
+			images[i]->setInternalStorage(storage, offset);
+			offset += (images[i]->getInternalSize() + alignment - 1) & ~(alignment - 1);
+		}
+	}
+}
+
 Texture2D::Texture2D(GLuint name) : Texture(name)
 {
 	for(int i = 0; i < IMPLEMENTATION_MAX_TEXTURE_LEVELS; i++)
@@ -541,6 +594,14 @@ bool Texture2D::requiresSync() const
 	return false;
 }
 
+void Texture2D::makeImmutable(GLsizei levels)
+{
+	Texture::makeImmutable(levels);
+
+	// The storage can't be respecified, so the whole mipmap chain goes in one allocation
+	allocateStorage(image, levels);
+}
+
 void Texture2D::setImage(GLint level, GLsizei width, GLsizei height, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels)
 {
 	if(image[level])
@@ -549,6 +610,7 @@ void Texture2D::setImage(GLint level, GLsizei width, GLsizei height, GLint inter
 	}
 
 	image[level] = egl::Image::create(this, width, height, internalformat);
+	Framebuffer::storageChanged();
 
 	if(!image[level])
 	{
@@ -570,6 +632,7 @@ void Texture2D::bindTexImage(gl::Surface *surface)
 	}
 
 	image[0] = surface->getRenderTarget();
+	Framebuffer::storageChanged();
 
 	mSurface = surface;
 	mSurface->setBoundTexture(this);
@@ -586,6 +649,8 @@ void Texture2D::releaseTexImage()
 		}
 	}
 
+	Framebuffer::storageChanged();
+
 	if(mSurface)
 	{
 		mSurface->setBoundTexture(nullptr);
@@ -601,6 +666,7 @@ void Texture2D::setCompressedImage(GLint level, GLenum format, GLsizei width, GL
 	}
 
 	image[level] = egl::Image::create(this, width, height, format);
+	Framebuffer::storageChanged();
 
 	if(!image[level])
 	{
@@ -622,22 +688,32 @@ void Texture2D::subImageCompressed(GLint level, GLint xoffset, GLint yoffset, GL
 
 void Texture2D::copyImage(GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, Renderbuffer *source)
 {
-	if(image[level])
+	egl::Image *renderTarget = (width != 0 && height != 0) ? source->getRenderTarget() : nullptr;
+
+	// Copies repeated every frame, like reflection and refraction grabs, don't reallocate the level
+	if(mSurface || !reuseCopyImage(image[level], x, y, width, height, internalformat, renderTarget))
 	{
-		image[level]->release();
-	}
+		if(image[level])
+		{
+			image[level]->release();
+		}
 
-	image[level] = egl::Image::create(this, width, height, internalformat);
+		image[level] = egl::Image::create(this, width, height, internalformat);
+		Framebuffer::storageChanged();
 
-	if(!image[level])
-	{
-		return error(GL_OUT_OF_MEMORY);
+		if(!image[level])
+		{
+			if(renderTarget)
+			{
+				renderTarget->release();
+			}
+
+			return error(GL_OUT_OF_MEMORY);
+		}
 	}
 
 	if(width != 0 && height != 0)
 	{
-		egl::Image *renderTarget = source->getRenderTarget();
-
 		if(!renderTarget)
 		{
 			ERR("Failed to retrieve the render target.");
@@ -699,6 +775,7 @@ void Texture2D::setSharedImage(egl::Image *sharedImage)
 	}
 
 	image[0] = sharedImage;
+	Framebuffer::storageChanged();
 }
 
 // Tests for 2D texture sampling completeness. [OpenGL ES 3.0.5] section 3.8.13 page 160.
@@ -796,21 +873,36 @@ void Texture2D::generateMipmaps()
 	int p = log2(maxsize) + mBaseLevel;
 	int q = std::min(p, mMaxLevel);
 
+	sw::Surface *levels[IMPLEMENTATION_MAX_TEXTURE_LEVELS];
+	levels[0] = image[mBaseLevel];
+
 	for(int i = mBaseLevel + 1; i <= q; i++)
 	{
-		if(image[i])
+		if(!reuseMipmapImage(image[i], image[mBaseLevel], i - mBaseLevel))
 		{
-			image[i]->release();
+			if(image[i])
+			{
+				image[i]->release();
+			}
+
+			image[i] = egl::Image::create(this, std::max(image[mBaseLevel]->getWidth() >> (i - mBaseLevel), 1), std::max(image[mBaseLevel]->getHeight() >> (i - mBaseLevel), 1), image[mBaseLevel]->getFormat());
+			Framebuffer::storageChanged();
+
+			if(!image[i])
+			{
+				return error(GL_OUT_OF_MEMORY);
+			}
 		}
 
-		image[i] = egl::Image::create(this, std::max(image[mBaseLevel]->getWidth() >> i, 1), std::max(image[mBaseLevel]->getHeight() >> i, 1), image[mBaseLevel]->getFormat());
+		levels[i - mBaseLevel] = image[i];
+	}
 
-		if(!image[i])
+	if(q > mBaseLevel && !getDevice()->generateMipmaps(levels, q - mBaseLevel + 1, 1))
+	{
+		for(int i = mBaseLevel + 1; i <= q; i++)
 		{
-			return error(GL_OUT_OF_MEMORY);
+			getDevice()->stretchRect(image[i - 1], 0, image[i], 0, Device::ALL_BUFFERS | Device::USE_FILTER);
 		}
-
-		getDevice()->stretchRect(image[i - 1], 0, image[i], 0, Device::ALL_BUFFERS | Device::USE_FILTER);
 	}
 }
 
@@ -1048,6 +1140,24 @@ bool TextureCubeMap::requiresSync() const
 	return false;
 }
 
+void TextureCubeMap::makeImmutable(GLsizei levels)
+{
+	Texture::makeImmutable(levels);
+
+	// Each face's mipmap chain is kept together, in one allocation for all faces
+	egl::Image *images[6 * IMPLEMENTATION_MAX_TEXTURE_LEVELS];
+
+	for(int face = 0; face < 6; face++)
+	{
+		for(int level = 0; level < levels; level++)
+		{
+			images[face * levels + level] = image[face][level];
+		}
+	}
+
+	allocateStorage(images, 6 * levels);
+}
+
 void TextureCubeMap::setCompressedImage(GLenum target, GLint level, GLenum format, GLsizei width, GLsizei height, GLsizei imageSize, const void *pixels)
 {
 	int face = CubeFaceIndex(target);
@@ -1058,6 +1168,7 @@ void TextureCubeMap::setCompressedImage(GLenum target, GLint level, GLenum forma
 	}
 
 	image[face][level] = egl::Image::create(this, width, height, 1, 1, format);
+	Framebuffer::storageChanged();
 
 	if(!image[face][level])
 	{
@@ -1178,65 +1289,84 @@ bool TextureCubeMap::isMipmapCubeComplete() const
 
 void TextureCubeMap::updateBorders(int level)
 {
-	egl::Image *posX = image[CubeFaceIndex(GL_TEXTURE_CUBE_MAP_POSITIVE_X)][level];
-	egl::Image *negX = image[CubeFaceIndex(GL_TEXTURE_CUBE_MAP_NEGATIVE_X)][level];
-	egl::Image *posY = image[CubeFaceIndex(GL_TEXTURE_CUBE_MAP_POSITIVE_Y)][level];
-	egl::Image *negY = image[CubeFaceIndex(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y)][level];
-	egl::Image *posZ = image[CubeFaceIndex(GL_TEXTURE_CUBE_MAP_POSITIVE_Z)][level];
-	egl::Image *negZ = image[CubeFaceIndex(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z)][level];
+	egl::Image *faces[6];
 
-	if(!posX || !negX || !posY || !negY || !posZ || !negZ)
+	for(int face = 0; face < 6; face++)
 	{
-		return;
+		faces[face] = image[face][level];
+
+		if(!faces[face])
+		{
+			return;
+		}
 	}
 
-	if(posX->getBorder() == 0)   // Non-seamless cube map.
+	if(faces[0]->getBorder() == 0)   // Non-seamless cube map.
 	{
 		return;
 	}
 
-	if(!posX->hasDirtyContents() || !posY->hasDirtyContents() || !posZ->hasDirtyContents() || !negX->hasDirtyContents() || !negY->hasDirtyContents() || !negZ->hasDirtyContents())
+	// Faces written since the last update. Copying the edges dirties the faces they're copied to, so sample this first.
+	bool dirty[6];
+	bool anyDirty = false;
+
+	for(int face = 0; face < 6; face++)
+	{
+		dirty[face] = faces[face]->hasDirtyContents();
+		anyDirty = anyDirty || dirty[face];
+	}
+
+	if(!anyDirty)
 	{
 		return;
 	}
 
-	// Copy top / bottom first.
-	posX->copyCubeEdge(sw::Surface::BOTTOM, negY, sw::Surface::RIGHT);
-	posY->copyCubeEdge(sw::Surface::BOTTOM, posZ, sw::Surface::TOP);
-	posZ->copyCubeEdge(sw::Surface::BOTTOM, negY, sw::Surface::TOP);
-	negX->copyCubeEdge(sw::Surface::BOTTOM, negY, sw::Surface::LEFT);
-	negY->copyCubeEdge(sw::Surface::BOTTOM, negZ, sw::Surface::BOTTOM);
-	negZ->copyCubeEdge(sw::Surface::BOTTOM, negY, sw::Surface::BOTTOM);
-
-	posX->copyCubeEdge(sw::Surface::TOP, posY, sw::Surface::RIGHT);
-	posY->copyCubeEdge(sw::Surface::TOP, negZ, sw::Surface::TOP);
-	posZ->copyCubeEdge(sw::Surface::TOP, posY, sw::Surface::BOTTOM);
-	negX->copyCubeEdge(sw::Surface::TOP, posY, sw::Surface::LEFT);
-	negY->copyCubeEdge(sw::Surface::TOP, posZ, sw::Surface::BOTTOM);
-	negZ->copyCubeEdge(sw::Surface::TOP, posY, sw::Surface::TOP);
-
-	// Copy left / right after top and bottom are done.
-	// The corner colors will be computed assuming top / bottom are already set.
-	posX->copyCubeEdge(sw::Surface::RIGHT, negZ, sw::Surface::LEFT);
-	posY->copyCubeEdge(sw::Surface::RIGHT, posX, sw::Surface::TOP);
-	posZ->copyCubeEdge(sw::Surface::RIGHT, posX, sw::Surface::LEFT);
-	negX->copyCubeEdge(sw::Surface::RIGHT, posZ, sw::Surface::LEFT);
-	negY->copyCubeEdge(sw::Surface::RIGHT, posX, sw::Surface::BOTTOM);
-	negZ->copyCubeEdge(sw::Surface::RIGHT, negX, sw::Surface::LEFT);
-
-	posX->copyCubeEdge(sw::Surface::LEFT, posZ, sw::Surface::RIGHT);
-	posY->copyCubeEdge(sw::Surface::LEFT, negX, sw::Surface::TOP);
-	posZ->copyCubeEdge(sw::Surface::LEFT, negX, sw::Surface::RIGHT);
-	negX->copyCubeEdge(sw::Surface::LEFT, negZ, sw::Surface::RIGHT);
-	negY->copyCubeEdge(sw::Surface::LEFT, negX, sw::Surface::BOTTOM);
-	negZ->copyCubeEdge(sw::Surface::LEFT, posX, sw::Surface::RIGHT);
-
-	posX->markContentsClean();
-	posY->markContentsClean();
-	posZ->markContentsClean();
-	negX->markContentsClean();
-	negY->markContentsClean();
-	negZ->markContentsClean();
+	// Where each border comes from, following the layout:
+	//
+	//      | +y |
+	// | -x | +z | +x | -z |
+	//      | -y |
+	struct Neighbor
+	{
+		sw::Surface::Edge edge;
+		int face;
+		sw::Surface::Edge faceEdge;
+	};
+
+	static const Neighbor neighbors[6][4] =
+	{
+		{{sw::Surface::TOP, 2, sw::Surface::RIGHT}, {sw::Surface::BOTTOM, 3, sw::Surface::RIGHT}, {sw::Surface::RIGHT, 5, sw::Surface::LEFT}, {sw::Surface::LEFT, 4, sw::Surface::RIGHT}},      // +x
+		{{sw::Surface::TOP, 2, sw::Surface::LEFT}, {sw::Surface::BOTTOM, 3, sw::Surface::LEFT}, {sw::Surface::RIGHT, 4, sw::Surface::LEFT}, {sw::Surface::LEFT, 5, sw::Surface::RIGHT}},        // -x
+		{{sw::Surface::TOP, 5, sw::Surface::TOP}, {sw::Surface::BOTTOM, 4, sw::Surface::TOP}, {sw::Surface::RIGHT, 0, sw::Surface::TOP}, {sw::Surface::LEFT, 1, sw::Surface::TOP}},             // +y
+		{{sw::Surface::TOP, 4, sw::Surface::BOTTOM}, {sw::Surface::BOTTOM, 5, sw::Surface::BOTTOM}, {sw::Surface::RIGHT, 0, sw::Surface::BOTTOM}, {sw::Surface::LEFT, 1, sw::Surface::BOTTOM}},  // -y
+		{{sw::Surface::TOP, 2, sw::Surface::BOTTOM}, {sw::Surface::BOTTOM, 3, sw::Surface::TOP}, {sw::Surface::RIGHT, 0, sw::Surface::LEFT}, {sw::Surface::LEFT, 1, sw::Surface::RIGHT}},       // +z
+		{{sw::Surface::TOP, 2, sw::Surface::TOP}, {sw::Surface::BOTTOM, 3, sw::Surface::BOTTOM}, {sw::Surface::RIGHT, 1, sw::Surface::LEFT}, {sw::Surface::LEFT, 0, sw::Surface::RIGHT}},       // -z
+	};
+
+	// Only the edges next to a written face are copied. The corners also depend on the face's own texels.
+	for(int face = 0; face < 6; face++)
+	{
+		bool corners = dirty[face];
+
+		for(const Neighbor &neighbor : neighbors[face])
+		{
+			if(dirty[neighbor.face])
+			{
+				faces[face]->copyCubeEdge(neighbor.edge, faces[neighbor.face], neighbor.faceEdge);
+				corners = true;
+			}
+		}
+
+		if(corners)
+		{
+			faces[face]->computeCubeCorners();
+		}
+	}
+
+	for(int face = 0; face < 6; face++)
+	{
+		faces[face]->markContentsClean();
+	}
 }
 
 bool TextureCubeMap::isCompressed(GLenum target, GLint level) const
@@ -1264,6 +1394,7 @@ void TextureCubeMap::setImage(GLenum target, GLint level, GLsizei width, GLsizei
 	}
 
 	image[face][level] = egl::Image::create(this, width, height, 1, 1, internalformat);
+	Framebuffer::storageChanged();
 
 	if(!image[face][level])
 	{
@@ -1276,23 +1407,31 @@ void TextureCubeMap::setImage(GLenum target, GLint level, GLsizei width, GLsizei
 void TextureCubeMap::copyImage(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, Renderbuffer *source)
 {
 	int face = CubeFaceIndex(target);
+	egl::Image *renderTarget = (width != 0 && height != 0) ? source->getRenderTarget() : nullptr;
 
-	if(image[face][level])
+	if(!reuseCopyImage(image[face][level], x, y, width, height, internalformat, renderTarget))
 	{
-		image[face][level]->release();
-	}
+		if(image[face][level])
+		{
+			image[face][level]->release();
+		}
 
-	image[face][level] = egl::Image::create(this, width, height, 1, 1, internalformat);
+		image[face][level] = egl::Image::create(this, width, height, 1, 1, internalformat);
+		Framebuffer::storageChanged();
 
-	if(!image[face][level])
-	{
-		return error(GL_OUT_OF_MEMORY);
+		if(!image[face][level])
+		{
+			if(renderTarget)
+			{
+				renderTarget->release();
+			}
+
+			return error(GL_OUT_OF_MEMORY);
+		}
 	}
 
 	if(width != 0 && height != 0)
 	{
-		egl::Image *renderTarget = source->getRenderTarget();
-
 		if(!renderTarget)
 		{
 			ERR("Failed to retrieve the render target.");
@@ -1362,26 +1501,46 @@ void TextureCubeMap::generateMipmaps()
 
 	int p = log2(image[0][mBaseLevel]->getWidth()) + mBaseLevel;
 	int q = std::min(p, mMaxLevel);
+	int levelCount = q - mBaseLevel + 1;
+
+	sw::Surface *levels[6 * IMPLEMENTATION_MAX_TEXTURE_LEVELS];
 
 	for(int f = 0; f < 6; f++)
 	{
 		ASSERT(image[f][mBaseLevel]);
 
+		levels[f * levelCount] = image[f][mBaseLevel];
+
 		for(int i = mBaseLevel + 1; i <= q; i++)
 		{
-			if(image[f][i])
+			if(!reuseMipmapImage(image[f][i], image[f][mBaseLevel], i - mBaseLevel))
 			{
-				image[f][i]->release();
+				if(image[f][i])
+				{
+					image[f][i]->release();
+				}
+
+				image[f][i] = egl::Image::create(this, std::max(image[f][mBaseLevel]->getWidth() >> (i - mBaseLevel), 1), std::max(image[f][mBaseLevel]->getHeight() >> (i - mBaseLevel), 1), 1, 1, image[f][mBaseLevel]->getFormat());
+				Framebuffer::storageChanged();
+
+				if(!image[f][i])
+				{
+					return error(GL_OUT_OF_MEMORY);
+				}
 			}
 
-			image[f][i] = egl::Image::create(this, std::max(image[f][mBaseLevel]->getWidth() >> i, 1), std::max(image[f][mBaseLevel]->getHeight() >> i, 1), 1, 1, image[f][mBaseLevel]->getFormat());
+			levels[f * levelCount + i - mBaseLevel] = image[f][i];
+		}
+	}
 
-			if(!image[f][i])
+	if(levelCount > 1 && !getDevice()->generateMipmaps(levels, levelCount, 6))
+	{
+		for(int f = 0; f < 6; f++)
+		{
+			for(int i = mBaseLevel + 1; i <= q; i++)
 			{
-				return error(GL_OUT_OF_MEMORY);
+				getDevice()->stretchRect(image[f][i - 1], 0, image[f][i], 0, Device::ALL_BUFFERS | Device::USE_FILTER);
 			}
-
-			getDevice()->stretchRect(image[f][i - 1], 0, image[f][i], 0, Device::ALL_BUFFERS | Device::USE_FILTER);
 		}
 	}
 }
@@ -1569,6 +1728,14 @@ bool Texture3D::requiresSync() const
 	return false;
 }
 
+void Texture3D::makeImmutable(GLsizei levels)
+{
+	Texture::makeImmutable(levels);
+
+	// The storage can't be respecified, so the whole mipmap chain goes in one allocation
+	allocateStorage(image, levels);
+}
+
 void Texture3D::setImage(GLint level, GLsizei width, GLsizei height, GLsizei depth, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels)
 {
 	if(image[level])
@@ -1577,6 +1744,7 @@ void Texture3D::setImage(GLint level, GLsizei width, GLsizei height, GLsizei dep
 	}
 
 	image[level] = egl::Image::create(this, width, height, depth, 0, internalformat);
+	Framebuffer::storageChanged();
 
 	if(!image[level])
 	{
@@ -1599,6 +1767,7 @@ void Texture3D::setCompressedImage(GLint level, GLenum format, GLsizei width, GL
 	}
 
 	image[level] = egl::Image::create(this, width, height, depth, 0, format);
+	Framebuffer::storageChanged();
 
 	if(!image[level])
 	{
@@ -1626,6 +1795,7 @@ void Texture3D::copyImage(GLint level, GLenum internalformat, GLint x, GLint y,
 	}
 
 	image[level] = egl::Image::create(this, width, height, depth, 0, internalformat);
+	Framebuffer::storageChanged();
 
 	if(!image[level])
 	{
@@ -1695,6 +1865,7 @@ void Texture3D::setSharedImage(egl::Image *sharedImage)
 	}
 
 	image[0] = sharedImage;
+	Framebuffer::storageChanged();
 }
 
 // Tests for 3D texture sampling completeness. [OpenGL ES 3.0.5] section 3.8.13 page 160.
@@ -1810,6 +1981,7 @@ void Texture3D::generateMipmaps()
 		}
 
 		image[i] = egl::Image::create(this, std::max(image[mBaseLevel]->getWidth() >> i, 1), std::max(image[mBaseLevel]->getHeight() >> i, 1), std::max(image[mBaseLevel]->getDepth() >> i, 1), 0, image[mBaseLevel]->getFormat());
+		Framebuffer::storageChanged();
 
 		if(!image[i])
 		{
@@ -1915,6 +2087,7 @@ void Texture2DArray::generateMipmaps()
 		GLsizei w = std::max(image[mBaseLevel]->getWidth() >> i, 1);
 		GLsizei h = std::max(image[mBaseLevel]->getHeight() >> i, 1);
 		image[i] = egl::Image::create(this, w, h, depth, 0, image[mBaseLevel]->getFormat());
+		Framebuffer::storageChanged();
 
 		if(!image[i])
 		{
@@ -1977,6 +2150,18 @@ NO_SANITIZE_FUNCTION egl::Image *createBackBufferFromClientBuffer(const egl::Cli
 	return egl::Image::create(clientBuffer);
 }
 
+NO_SANITIZE_FUNCTION egl::Image *createImageFromDmaBuffer(const egl::DmaBuffer& dmaBuffer)
+{
+	if(dmaBuffer.width > es2::IMPLEMENTATION_MAX_TEXTURE_SIZE ||
+	   dmaBuffer.height > es2::IMPLEMENTATION_MAX_TEXTURE_SIZE)
+	{
+		ERR("Invalid parameters: %dx%d", dmaBuffer.width, dmaBuffer.height);
+		return nullptr;
+	}
+
+	return egl::Image::create(dmaBuffer);
+}
+
 NO_SANITIZE_FUNCTION egl::Image *createDepthStencil(int width, int height, sw::Format format, int multiSampleDepth)
 {
 	if(width > es2::IMPLEMENTATION_MAX_RENDERBUFFER_SIZE || height > es2::IMPLEMENTATION_MAX_RENDERBUFFER_SIZE)
@@ -64,7 +64,7 @@ public:
 	bool setBaseLevel(GLint baseLevel);
 	bool setCompareFunc(GLenum compareFunc);
 	bool setCompareMode(GLenum compareMode);
-	void makeImmutable(GLsizei levels);
+	virtual void makeImmutable(GLsizei levels);
 	bool setMaxLevel(GLint maxLevel);
 	bool setMaxLOD(GLfloat maxLOD);
 	bool setMinLOD(GLfloat minLOD);
@@ -122,6 +122,9 @@ protected:
 	bool copy(egl::Image *source, const sw::SliceRect &sourceRect, GLint xoffset, GLint yoffset, GLint zoffset, egl::Image *dest);
 
 	bool isMipmapFiltered() const;
+	static bool reuseMipmapImage(const egl::Image *image, const egl::Image *base, int level);   // Generated levels of the right size are filtered in place
+	static bool reuseCopyImage(const egl::Image *image, GLint x, GLint y, GLsizei width, GLsizei height, GLint internalformat, const egl::Image *source);   // Copies into a level of the same size and format overwrite it in place
+	static void allocateStorage(egl::Image *const *images, int count);   // Backs the images with one allocation
 
 	GLenum mMinFilter;
 	GLenum mMagFilter;
@@ -161,6 +164,7 @@ public:
 	GLint getFormat(GLenum target, GLint level) const override;
 	int getTopLevel() const override;
 	bool requiresSync() const override;
+	void makeImmutable(GLsizei levels) override;
 
 	void setImage(GLint level, GLsizei width, GLsizei height, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels);
 	void setCompressedImage(GLint level, GLenum format, GLsizei width, GLsizei height, GLsizei imageSize, const void *pixels);
@@ -229,6 +233,7 @@ public:
 	GLint getFormat(GLenum target, GLint level) const override;
 	int getTopLevel() const override;
 	bool requiresSync() const override;
+	void makeImmutable(GLsizei levels) override;
 
 	void setImage(GLenum target, GLint level, GLsizei width, GLsizei height, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels);
 	void setCompressedImage(GLenum target, GLint level, GLenum format, GLsizei width, GLsizei height, GLsizei imageSize, const void *pixels);
@@ -291,6 +296,7 @@ public:
 	GLint getFormat(GLenum target, GLint level) const override;
 	int getTopLevel() const override;
 	bool requiresSync() const override;
+	void makeImmutable(GLsizei levels) override;
 
 	void setImage(GLint level, GLsizei width, GLsizei height, GLsizei depth, GLint internalformat, GLenum format, GLenum type, const gl::PixelStorageModes &unpackParameters, const void *pixels);
 	void setCompressedImage(GLint level, GLenum format, GLsizei width, GLsizei height, GLsizei depth, GLsizei imageSize, const void *pixels);
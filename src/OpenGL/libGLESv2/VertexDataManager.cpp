@@ -22,9 +22,46 @@
 #include "IndexDataManager.h"
 #include "common/debug.h"
 
+#include <cstdint>
+
 namespace
 {
 	enum {INITIAL_STREAM_BUFFER_SIZE = 1024 * 1024};
+
+	// Elements of an instanced array read by instances [instanceId, instanceId + instanceCount)
+	GLsizei instanceElements(GLuint divisor, GLsizei instanceId, GLsizei instanceCount)
+	{
+		return (instanceId + instanceCount - 1) / divisor - instanceId / divisor + 1;
+	}
+
+	// Gathers strided elements, avoiding a library call per element for the common multiple-of-four sizes
+	void copyElements(char *output, const char *input, int count, int elementSize, int inputStride)
+	{
+		if(elementSize % 4 == 0)
+		{
+			for(int i = 0; i < count; i++)
+			{
+				for(int j = 0; j < elementSize; j += 4)
+				{
+					uint32_t word;
+					memcpy(&word, input + j, 4);
+					memcpy(output + j, &word, 4);
+				}
+
+				output += elementSize;
+				input += inputStride;
+			}
+		}
+		else
+		{
+			for(int i = 0; i < count; i++)
+			{
+				memcpy(output, input, elementSize);
+				output += elementSize;
+				input += inputStride;
+			}
+		}
+	}
 }
 
 namespace es2
@@ -35,9 +72,13 @@ VertexDataManager::VertexDataManager(Context *context) : mContext(context)
 	for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
 	{
 		mDirtyCurrentValue[i] = true;
-		mCurrentValueBuffer[i] = nullptr;
+		mCurrentValueOffset[i] = 0;
+		mCurrentValueGeneration[i] = 0;
+		mBlockIndex[i] = -1;
 	}
 
+	resetStatistics();
+
 	mStreamingBuffer = new StreamingVertexBuffer(INITIAL_STREAM_BUFFER_SIZE);
 
 	if(!mStreamingBuffer)
@@ -49,11 +90,6 @@ VertexDataManager::VertexDataManager(Context *context) : mContext(context)
 VertexDataManager::~VertexDataManager()
 {
 	delete mStreamingBuffer;
-
-	for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
-	{
-		delete mCurrentValueBuffer[i];
-	}
 }
 
 unsigned int VertexDataManager::writeAttributeData(StreamingVertexBuffer *vertexBuffer, GLint start, GLsizei count, const VertexAttribute &attribute)
@@ -68,7 +104,7 @@ unsigned int VertexDataManager::writeAttributeData(StreamingVertexBuffer *vertex
 
 	if(vertexBuffer)
 	{
-		output = (char*)vertexBuffer->map(attribute, attribute.typeSize() * count, &streamOffset);
+		output = (char*)vertexBuffer->map(attribute.typeSize() * count, &streamOffset);
 	}
 
 	if(!output)
@@ -96,20 +132,106 @@ unsigned int VertexDataManager::writeAttributeData(StreamingVertexBuffer *vertex
 	}
 	else
 	{
-		for(int i = 0; i < count; i++)
-		{
-			memcpy(output, input, elementSize);
-			output += elementSize;
-			input += inputStride;
-		}
+		copyElements(output, input, count, elementSize, inputStride);
 	}
 
 	vertexBuffer->unmap();
 
+	mStatistics.copiedAttributes++;
+	mStatistics.copiedBytes += elementSize * count;
+
 	return streamOffset;
 }
 
-GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, TranslatedAttribute *translated, GLsizei instanceId)
+unsigned int VertexDataManager::writeBlockData(StreamingVertexBuffer *vertexBuffer, GLint start, GLsizei count, const InterleavedBlock &block)
+{
+	// The last vertex only needs the bytes used by the arrays, the remainder of its stride may not be addressable
+	unsigned int size = (count - 1) * block.stride + block.size;
+	unsigned int streamOffset = 0;
+
+	char *output = (char*)vertexBuffer->map(size, &streamOffset);
+
+	if(!output)
+	{
+		ERR("Failed to map vertex buffer.");
+		return ~0u;
+	}
+
+	memcpy(output, block.base + block.stride * start, size);
+
+	vertexBuffer->unmap();
+
+	mStatistics.copiedAttributes += block.attributes;
+	mStatistics.interleavedCopies++;
+	mStatistics.copiedBytes += size;
+
+	return streamOffset;
+}
+
+int VertexDataManager::groupInterleavedArrays(const VertexAttribute *attribs[MAX_VERTEX_ATTRIBS])
+{
+	int blockCount = 0;
+
+	for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
+	{
+		mBlockIndex[i] = -1;
+
+		if(!attribs[i])
+		{
+			continue;
+		}
+
+		const char *pointer = static_cast<const char*>(attribs[i]->mPointer);
+		unsigned int stride = attribs[i]->stride();
+		unsigned int size = attribs[i]->typeSize();
+
+		for(int b = 0; b < blockCount; b++)
+		{
+			InterleavedBlock &block = mBlocks[b];
+
+			if(block.stride != stride)
+			{
+				continue;
+			}
+
+			uintptr_t begin = std::min((uintptr_t)block.base, (uintptr_t)pointer);
+			uintptr_t end = std::max((uintptr_t)block.base + block.size, (uintptr_t)pointer + size);
+
+			if(end - begin <= stride)
+			{
+				block.base = (const char*)begin;
+				block.size = (unsigned int)(end - begin);
+				block.attributes++;
+				mBlockIndex[i] = b;
+				break;
+			}
+		}
+
+		if(mBlockIndex[i] == -1)
+		{
+			mBlocks[blockCount] = {pointer, size, stride, ~0u, 1};
+			mBlockIndex[i] = blockCount++;
+		}
+	}
+
+	// Arrays without interleaved neighbours are compacted instead
+	for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
+	{
+		if(mBlockIndex[i] != -1 && mBlocks[mBlockIndex[i]].attributes == 1)
+		{
+			mBlockIndex[i] = -1;
+		}
+	}
+
+	return blockCount;
+}
+
+void VertexDataManager::resetStatistics()
+{
+	mStatistics = {0, 0, 0, 0};
+}
+
+GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, TranslatedAttribute *translated, GLsizei instanceId, GLsizei instanceCount)
 {
 	if(!mStreamingBuffer)
 	{
@@ -120,6 +242,20 @@ GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, Translat
 	const VertexAttributeArray &currentAttribs = mContext->getCurrentVertexAttributes();
 	Program *program = mContext->getCurrentProgram();
 
+	// Buffer objects are read in place, with their own stride. Client memory can change once the draw call
+	// returns, so it is copied, keeping interleaved arrays together to be read with their original stride.
+	const VertexAttribute *interleaved[MAX_VERTEX_ATTRIBS];
+
+	for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
+	{
+		const VertexAttribute &attrib = attribs[i].mArrayEnabled ? attribs[i] : currentAttribs[i];
+		bool clientArray = program->getAttributeStream(i) != -1 && attrib.mArrayEnabled && !attrib.mBoundBuffer && attrib.mPointer;
+
+		interleaved[i] = (clientArray && attrib.mDivisor == 0 && count > 0) ? &attrib : nullptr;
+	}
+
+	int blockCount = groupInterleavedArrays(interleaved);
+
 	// Determine the required storage size per used buffer
 	for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
 	{
@@ -127,14 +263,31 @@ GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, Translat
 
 		if(program->getAttributeStream(i) != -1 && attrib.mArrayEnabled)
 		{
-			if(!attrib.mBoundBuffer)
+			if(!attrib.mBoundBuffer && mBlockIndex[i] == -1)
 			{
 				const bool isInstanced = attrib.mDivisor > 0;
-				mStreamingBuffer->addRequiredSpace(attrib.typeSize() * (isInstanced ? 1 : count));
+				mStreamingBuffer->addRequiredSpace(attrib.typeSize() * (isInstanced ? instanceElements(attrib.mDivisor, instanceId, instanceCount) : count));
 			}
 		}
 	}
 
+	for(int b = 0; b < blockCount; b++)
+	{
+		if(mBlocks[b].attributes > 1)
+		{
+			mStreamingBuffer->addRequiredSpace((count - 1) * mBlocks[b].stride + mBlocks[b].size);
+		}
+	}
+
+	// Current values are kept in the streaming buffer, until they change or the buffer gets recycled
+	for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
+	{
+		if(program->getAttributeStream(i) != -1 && !attribs[i].mArrayEnabled)
+		{
+			mStreamingBuffer->addRequiredSpace(4 * sizeof(float));
+		}
+	}
+
 	mStreamingBuffer->reserveRequiredSpace();
 
 	// Perform the vertex data translations
@@ -166,11 +319,31 @@ GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, Translat
 				{
 					translated[i].vertexBuffer = staticBuffer;
 					translated[i].offset = firstVertexIndex * attrib.stride() + static_cast<int>(attrib.mOffset);
-					translated[i].stride = isInstanced ? 0 : attrib.stride();
+					translated[i].stride = attrib.stride();
+
+					mStatistics.directAttributes++;
+				}
+				else if(mBlockIndex[i] != -1)
+				{
+					InterleavedBlock &block = mBlocks[mBlockIndex[i]];
+
+					if(block.streamOffset == ~0u)
+					{
+						block.streamOffset = writeBlockData(mStreamingBuffer, firstVertexIndex, count, block);
+
+						if(block.streamOffset == ~0u)
+						{
+							return GL_OUT_OF_MEMORY;
+						}
+					}
+
+					translated[i].vertexBuffer = mStreamingBuffer->getResource();
+					translated[i].offset = block.streamOffset + static_cast<unsigned int>(static_cast<const char*>(attrib.mPointer) - block.base);
+					translated[i].stride = block.stride;
 				}
 				else
 				{
-					unsigned int streamOffset = writeAttributeData(mStreamingBuffer, firstVertexIndex, isInstanced ? 1 : count, attrib);
+					unsigned int streamOffset = writeAttributeData(mStreamingBuffer, firstVertexIndex, isInstanced ? instanceElements(attrib.mDivisor, instanceId, instanceCount) : count, attrib);
 
 					if(streamOffset == ~0u)
 					{
@@ -179,9 +352,13 @@ GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, Translat
 
 					translated[i].vertexBuffer = mStreamingBuffer->getResource();
 					translated[i].offset = streamOffset;
-					translated[i].stride = isInstanced ? 0 : attrib.typeSize();
+					translated[i].stride = attrib.typeSize();
 				}
 
+				translated[i].divisor = attrib.mDivisor;
+
+				// Every attribute type has a stream type which the vertex routine reads natively,
+				// so arrays in buffer objects never need converting, whatever their usage hint.
 				switch(attrib.mType)
 				{
 				case GL_BYTE:           translated[i].type = sw::STREAMTYPE_SBYTE;  break;
@@ -204,14 +381,27 @@ GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, Translat
 			}
 			else
 			{
-				if(mDirtyCurrentValue[i])
+				if(mDirtyCurrentValue[i] || mCurrentValueGeneration[i] != mStreamingBuffer->getGeneration())
 				{
-					delete mCurrentValueBuffer[i];
-					mCurrentValueBuffer[i] = new ConstantVertexBuffer(attrib.getCurrentValueBitsAsFloat(0), attrib.getCurrentValueBitsAsFloat(1), attrib.getCurrentValueBitsAsFloat(2), attrib.getCurrentValueBitsAsFloat(3));
+					float *vector = (float*)mStreamingBuffer->map(4 * sizeof(float), &mCurrentValueOffset[i]);
+
+					if(!vector)
+					{
+						return GL_OUT_OF_MEMORY;
+					}
+
+					vector[0] = attrib.getCurrentValueBitsAsFloat(0);
+					vector[1] = attrib.getCurrentValueBitsAsFloat(1);
+					vector[2] = attrib.getCurrentValueBitsAsFloat(2);
+					vector[3] = attrib.getCurrentValueBitsAsFloat(3);
+
+					mStreamingBuffer->unmap();
+
 					mDirtyCurrentValue[i] = false;
+					mCurrentValueGeneration[i] = mStreamingBuffer->getGeneration();
 				}
 
-				translated[i].vertexBuffer = mCurrentValueBuffer[i]->getResource();
+				translated[i].vertexBuffer = mStreamingBuffer->getResource();
 
 				switch(attrib.currentValueType())
 				{
@@ -227,7 +417,8 @@ GLenum VertexDataManager::prepareVertexData(GLint start, GLsizei count, Translat
 				}
 				translated[i].count = 4;
 				translated[i].stride = 0;
-				translated[i].offset = 0;
+				translated[i].divisor = 0;
+				translated[i].offset = mCurrentValueOffset[i];
 				translated[i].normalized = false;
 			}
 		}
@@ -270,34 +461,17 @@ sw::Resource *VertexBuffer::getResource() const
 	return mVertexBuffer;
 }
 
-ConstantVertexBuffer::ConstantVertexBuffer(float x, float y, float z, float w) : VertexBuffer(4 * sizeof(float))
-{
-	if(mVertexBuffer)
-	{
-		float *vector = (float*)mVertexBuffer->lock(sw::PUBLIC);
-
-		vector[0] = x;
-		vector[1] = y;
-		vector[2] = z;
-		vector[3] = w;
-
-		mVertexBuffer->unlock();
-	}
-}
-
-ConstantVertexBuffer::~ConstantVertexBuffer()
-{
-}
-
 StreamingVertexBuffer::StreamingVertexBuffer(unsigned int size) : VertexBuffer(size)
 {
 	mBufferSize = size;
 	mWritePosition = 0;
 	mRequiredSpace = 0;
+	mGeneration = 0;
 }
 
 StreamingVertexBuffer::~StreamingVertexBuffer()
 {
+	releaseRetired();
 }
 
 void StreamingVertexBuffer::addRequiredSpace(unsigned int requiredSpace)
@@ -305,7 +479,7 @@ void StreamingVertexBuffer::addRequiredSpace(unsigned int requiredSpace)
 	mRequiredSpace += requiredSpace;
 }
 
-void *StreamingVertexBuffer::map(const VertexAttribute &attribute, unsigned int requiredSpace, unsigned int *offset)
+void *StreamingVertexBuffer::map(unsigned int requiredSpace, unsigned int *offset)
 {
 	void *mapPtr = nullptr;
 
@@ -331,9 +505,11 @@ void StreamingVertexBuffer::reserveRequiredSpace()
 			mVertexBuffer = 0;
 		}
 
+		releaseRetired();
+
 		mBufferSize = std::max(mRequiredSpace, 3 * mBufferSize / 2);   // 1.5 x mBufferSize is arbitrary and should be checked to see we don't have too many reallocations.
 
-		mVertexBuffer = new sw::Resource(mBufferSize);
+		mVertexBuffer = new sw::Resource(mBufferSize, false);
 
 		if(!mVertexBuffer)
 		{
@@ -341,19 +517,56 @@ void StreamingVertexBuffer::reserveRequiredSpace()
 		}
 
 		mWritePosition = 0;
+		mGeneration++;
 	}
 	else if(mWritePosition + mRequiredSpace > mBufferSize)   // Recycle
 	{
 		if(mVertexBuffer)
 		{
-			mVertexBuffer->destruct();
-			mVertexBuffer = new sw::Resource(mBufferSize);
+			mVertexBuffer = recycle(mVertexBuffer);
 		}
 
 		mWritePosition = 0;
+		mGeneration++;
 	}
 
 	mRequiredSpace = 0;
 }
 
+sw::Resource *StreamingVertexBuffer::recycle(sw::Resource *full)
+{
+	// Draw calls still reading the full buffer keep it, it gets reused once they are done
+	sw::Resource *next = nullptr;
+
+	for(size_t i = 0; i < mRetired.size(); i++)
+	{
+		if(mRetired[i]->isIdle())
+		{
+			next = mRetired[i];
+			mRetired.erase(mRetired.begin() + i);
+			break;
+		}
+	}
+
+	if(mRetired.size() == MAX_RETIRED)
+	{
+		mRetired.front()->destruct();
+		mRetired.erase(mRetired.begin());
+	}
+
+	mRetired.push_back(full);
+
+	return next ? next : new sw::Resource(mBufferSize, false);
+}
+
+void StreamingVertexBuffer::releaseRetired()
+{
+	for(sw::Resource *resource : mRetired)
+	{
+		resource->destruct();
+	}
+
+	mRetired.clear();
+}
+
 }
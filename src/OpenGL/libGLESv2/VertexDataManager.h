@@ -23,6 +23,8 @@
 
 #include <GLES2/gl2.h>
 
+#include <vector>
+
 namespace es2
 {
 
@@ -33,7 +35,8 @@ struct TranslatedAttribute
 	bool normalized;
 
 	unsigned int offset;
-	unsigned int stride;   // 0 means not to advance the read pointer at all
+	unsigned int stride;    // 0 means not to advance the read pointer at all
+	unsigned int divisor;   // Instances sharing each element, with the stride applying between elements. 0 for per-vertex data.
 
 	sw::Resource *vertexBuffer;
 };
@@ -52,27 +55,41 @@ protected:
 	sw::Resource *mVertexBuffer;
 };
 
-class ConstantVertexBuffer : public VertexBuffer
-{
-public:
-	ConstantVertexBuffer(float x, float y, float z, float w);
-	~ConstantVertexBuffer();
-};
-
 class StreamingVertexBuffer : public VertexBuffer
 {
 public:
 	StreamingVertexBuffer(unsigned int size);
 	~StreamingVertexBuffer();
 
-	void *map(const VertexAttribute &attribute, unsigned int requiredSpace, unsigned int *streamOffset);
+	void *map(unsigned int requiredSpace, unsigned int *streamOffset);
 	void reserveRequiredSpace();
 	void addRequiredSpace(unsigned int requiredSpace);
 
+	unsigned int getGeneration() const { return mGeneration; }   // Changes when earlier contents are no longer mapped
+
 protected:
+	enum
+	{
+		MAX_RETIRED = 2,   // Full buffers which pending draws may still read, reused once they are done
+	};
+
+	sw::Resource *recycle(sw::Resource *full);
+	void releaseRetired();
+
 	unsigned int mBufferSize;
 	unsigned int mWritePosition;
 	unsigned int mRequiredSpace;
+	unsigned int mGeneration;
+	std::vector<sw::Resource*> mRetired;
+};
+
+// Counts of how vertex attributes were sourced by draw calls
+struct VertexDataStatistics
+{
+	unsigned int directAttributes;   // Read in place from buffer objects
+	unsigned int copiedAttributes;   // Client memory copied into the streaming buffer
+	unsigned int interleavedCopies;  // Client arrays sharing one copy of an interleaved block
+	size_t copiedBytes;
 };
 
 class VertexDataManager
@@ -83,17 +100,38 @@ public:
 
 	void dirtyCurrentValue(int index) { mDirtyCurrentValue[index] = true; }
 
-	GLenum prepareVertexData(GLint start, GLsizei count, TranslatedAttribute *outAttribs, GLsizei instanceId);
+	GLenum prepareVertexData(GLint start, GLsizei count, TranslatedAttribute *outAttribs, GLsizei instanceId, GLsizei instanceCount);
+
+	const VertexDataStatistics &getStatistics() const { return mStatistics; }
+	void resetStatistics();
 
 private:
+	// Client arrays with a common stride whose elements lie within one stride are copied as a single block
+	struct InterleavedBlock
+	{
+		const char *base;
+		unsigned int size;     // Bytes of one vertex used by the arrays
+		unsigned int stride;
+		unsigned int streamOffset;
+		int attributes;
+	};
+
 	unsigned int writeAttributeData(StreamingVertexBuffer *vertexBuffer, GLint start, GLsizei count, const VertexAttribute &attribute);
+	unsigned int writeBlockData(StreamingVertexBuffer *vertexBuffer, GLint start, GLsizei count, const InterleavedBlock &block);
+	int groupInterleavedArrays(const VertexAttribute *attribs[MAX_VERTEX_ATTRIBS]);
 
 	Context *const mContext;
 
 	StreamingVertexBuffer *mStreamingBuffer;
 
 	bool mDirtyCurrentValue[MAX_VERTEX_ATTRIBS];
-	ConstantVertexBuffer *mCurrentValueBuffer[MAX_VERTEX_ATTRIBS];
+	unsigned int mCurrentValueOffset[MAX_VERTEX_ATTRIBS];       // Location of the current value in the streaming buffer
+	unsigned int mCurrentValueGeneration[MAX_VERTEX_ATTRIBS];   // Streaming buffer generation holding it
+
+	InterleavedBlock mBlocks[MAX_VERTEX_ATTRIBS];
+	int mBlockIndex[MAX_VERTEX_ATTRIBS];   // -1 for arrays copied on their own
+
+	VertexDataStatistics mStatistics;
 };
 
 }
@@ -15,6 +15,7 @@
 // entry_points.cpp: GL entry points exports and definition
 
 #include "main.h"
+#include "CommandTrace.h"
 
 #include "libEGL/main.h"
 
@@ -104,7 +105,10 @@ void GetIntegerv(GLenum pname, GLint* params);
 void GetProgramiv(GLuint program, GLenum pname, GLint* params);
 void GetProgramInfoLog(GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog);
 void GetQueryivEXT(GLenum target, GLenum pname, GLint *params);
+void GetQueryObjectivEXT(GLuint name, GLenum pname, GLint *params);
 void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params);
+void GetQueryObjecti64vEXT(GLuint name, GLenum pname, GLint64 *params);
+void GetQueryObjectui64vEXT(GLuint name, GLenum pname, GLuint64 *params);
 void GetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params);
 void GetShaderiv(GLuint shader, GLenum pname, GLint* params);
 void GetShaderInfoLog(GLuint shader, GLsizei bufsize, GLsizei* length, GLchar* infolog);
@@ -135,6 +139,7 @@ void LineWidth(GLfloat width);
 void LinkProgram(GLuint program);
 void PixelStorei(GLenum pname, GLint param);
 void PolygonOffset(GLfloat factor, GLfloat units);
+void QueryCounterEXT(GLuint name, GLenum target);
 void ReadnPixelsEXT(GLint x, GLint y, GLsizei width, GLsizei height,
                     GLenum format, GLenum type, GLsizei bufSize, GLvoid *data);
 void ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels);
@@ -227,86 +232,103 @@ extern "C"
 {
 GL_APICALL void GL_APIENTRY glActiveTexture(GLenum texture)
 {
+	CAPTURE(ActiveTexture, texture);
 	return es2::ActiveTexture(texture);
 }
 
 GL_APICALL void GL_APIENTRY glAttachShader(GLuint program, GLuint shader)
 {
+	CAPTURE(AttachShader, program, shader);
 	return es2::AttachShader(program, shader);
 }
 
 GL_APICALL void GL_APIENTRY glBeginQueryEXT(GLenum target, GLuint name)
 {
+	CAPTURE(BeginQueryEXT, target, name);
 	return es2::BeginQueryEXT(target, name);
 }
 
 GL_APICALL void GL_APIENTRY glBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
 {
+	CAPTURE(BindAttribLocation, program, index, es2::CommandTrace::string(name));
 	return es2::BindAttribLocation(program, index, name);
 }
 
 GL_APICALL void GL_APIENTRY glBindBuffer(GLenum target, GLuint buffer)
 {
+	CAPTURE(BindBuffer, target, buffer);
 	return es2::BindBuffer(target, buffer);
 }
 
 GL_APICALL void GL_APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer)
 {
+	CAPTURE(BindFramebuffer, target, framebuffer);
 	return es2::BindFramebuffer(target, framebuffer);
 }
 
 GL_APICALL void GL_APIENTRY glBindFramebufferOES(GLenum target, GLuint framebuffer)
 {
+	CAPTURE(BindFramebuffer, target, framebuffer);
 	return es2::BindFramebuffer(target, framebuffer);
 }
 
 GL_APICALL void GL_APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer)
 {
+	CAPTURE(BindRenderbuffer, target, renderbuffer);
 	return es2::BindRenderbuffer(target, renderbuffer);
 }
 
 GL_APICALL void GL_APIENTRY glBindRenderbufferOES(GLenum target, GLuint renderbuffer)
 {
+	CAPTURE(BindRenderbuffer, target, renderbuffer);
 	return es2::BindRenderbuffer(target, renderbuffer);
 }
 
 GL_APICALL void GL_APIENTRY glBindTexture(GLenum target, GLuint texture)
 {
+	CAPTURE(BindTexture, target, texture);
 	return es2::BindTexture(target, texture);
 }
 
 GL_APICALL void GL_APIENTRY glBlendColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
 {
+	CAPTURE(BlendColor, red, green, blue, alpha);
 	return es2::BlendColor(red, green, blue, alpha);
 }
 
 GL_APICALL void GL_APIENTRY glBlendEquation(GLenum mode)
 {
+	CAPTURE(BlendEquation, mode);
 	return es2::BlendEquation(mode);
 }
 
 GL_APICALL void GL_APIENTRY glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
 {
+	CAPTURE(BlendEquationSeparate, modeRGB, modeAlpha);
 	return es2::BlendEquationSeparate(modeRGB, modeAlpha);
 }
 
 GL_APICALL void GL_APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
 {
+	CAPTURE(BlendFunc, sfactor, dfactor);
 	return es2::BlendFunc(sfactor, dfactor);
 }
 
 GL_APICALL void GL_APIENTRY glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
 {
+	CAPTURE(BlendFuncSeparate, srcRGB, dstRGB, srcAlpha, dstAlpha);
 	return es2::BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
 }
 
 GL_APICALL void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
 {
+	CAPTURE(BufferData, target, (int64_t)size, es2::CommandTrace::data(data, size > 0 ? size : 0), usage);
 	return es2::BufferData(target, size, data, usage);
 }
 
 GL_APICALL void GL_APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
 {
+	CAPTURE(BufferSubData, target, (int64_t)offset, (int64_t)size, es2::CommandTrace::data(data, size > 0 ? size : 0));
 	return es2::BufferSubData(target, offset, size, data);
 }
 
@@ -322,73 +344,93 @@ GL_APICALL GLenum GL_APIENTRY glCheckFramebufferStatusOES(GLenum target)
 
 GL_APICALL void GL_APIENTRY glClear(GLbitfield mask)
 {
+	CAPTURE(Clear, mask);
 	return es2::Clear(mask);
 }
 
 GL_APICALL void GL_APIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
 {
+	CAPTURE(ClearColor, red, green, blue, alpha);
 	return es2::ClearColor(red, green, blue, alpha);
 }
 
 GL_APICALL void GL_APIENTRY glClearDepthf(GLclampf depth)
 {
+	CAPTURE(ClearDepthf, depth);
 	return es2::ClearDepthf(depth);
 }
 
 GL_APICALL void GL_APIENTRY glClearStencil(GLint s)
 {
+	CAPTURE(ClearStencil, s);
 	return es2::ClearStencil(s);
 }
 
 GL_APICALL void GL_APIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
 {
+	CAPTURE(ColorMask, red, green, blue, alpha);
 	return es2::ColorMask(red, green, blue, alpha);
 }
 
 GL_APICALL void GL_APIENTRY glCompileShader(GLuint shader)
 {
+	CAPTURE(CompileShader, shader);
 	return es2::CompileShader(shader);
 }
 
 GL_APICALL void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
                                                    GLint border, GLsizei imageSize, const GLvoid* data)
 {
+	CAPTURE(CompressedTexImage2D, target, level, internalformat, width, height, border, imageSize, es2::CommandTrace::compressed(imageSize, data));
 	return es2::CompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
 }
 
 GL_APICALL void GL_APIENTRY glCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
                                                       GLenum format, GLsizei imageSize, const GLvoid* data)
 {
+	CAPTURE(CompressedTexSubImage2D, target, level, xoffset, yoffset, width, height, format, imageSize, es2::CommandTrace::compressed(imageSize, data));
 	return es2::CompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
 }
 
 GL_APICALL void GL_APIENTRY glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border)
 {
+	CAPTURE(CopyTexImage2D, target, level, internalformat, x, y, width, height, border);
 	return es2::CopyTexImage2D(target, level, internalformat, x, y, width, height, border);
 }
 
 GL_APICALL void GL_APIENTRY glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height)
 {
+	CAPTURE(CopyTexSubImage2D, target, level, xoffset, yoffset, x, y, width, height);
 	return es2::CopyTexSubImage2D(target, level, xoffset, yoffset, x, y, width, height);
 }
 
 GL_APICALL GLuint GL_APIENTRY glCreateProgram(void)
 {
-	return es2::CreateProgram();
+	GLuint program = es2::CreateProgram();
+
+	CAPTURE(CreateProgram, program);
+
+	return program;
 }
 
 GL_APICALL GLuint GL_APIENTRY glCreateShader(GLenum type)
 {
-	return es2::CreateShader(type);
+	GLuint shader = es2::CreateShader(type);
+
+	CAPTURE(CreateShader, type, shader);
+
+	return shader;
 }
 
 GL_APICALL void GL_APIENTRY glCullFace(GLenum mode)
 {
+	CAPTURE(CullFace, mode);
 	return es2::CullFace(mode);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteBuffers(GLsizei n, const GLuint* buffers)
 {
+	CAPTURE(DeleteBuffers, n, es2::CommandTrace::data(buffers, n > 0 ? n * sizeof(GLuint) : 0));
 	return es2::DeleteBuffers(n, buffers);
 }
 
@@ -399,126 +441,175 @@ GL_APICALL void GL_APIENTRY glDeleteFencesNV(GLsizei n, const GLuint* fences)
 
 GL_APICALL void GL_APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
 {
+	CAPTURE(DeleteFramebuffers, n, es2::CommandTrace::data(framebuffers, n > 0 ? n * sizeof(GLuint) : 0));
 	return es2::DeleteFramebuffers(n, framebuffers);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteFramebuffersOES(GLsizei n, const GLuint* framebuffers)
 {
+	CAPTURE(DeleteFramebuffers, n, es2::CommandTrace::data(framebuffers, n > 0 ? n * sizeof(GLuint) : 0));
 	return es2::DeleteFramebuffers(n, framebuffers);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteProgram(GLuint program)
 {
+	CAPTURE(DeleteProgram, program);
 	return es2::DeleteProgram(program);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteQueriesEXT(GLsizei n, const GLuint *ids)
 {
+	CAPTURE(DeleteQueriesEXT, n, es2::CommandTrace::data(ids, n > 0 ? n * sizeof(GLuint) : 0));
 	return es2::DeleteQueriesEXT(n, ids);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
 {
+	CAPTURE(DeleteRenderbuffers, n, es2::CommandTrace::data(renderbuffers, n > 0 ? n * sizeof(GLuint) : 0));
 	return es2::DeleteRenderbuffers(n, renderbuffers);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteRenderbuffersOES(GLsizei n, const GLuint* renderbuffers)
 {
+	CAPTURE(DeleteRenderbuffers, n, es2::CommandTrace::data(renderbuffers, n > 0 ? n * sizeof(GLuint) : 0));
 	return es2::DeleteRenderbuffers(n, renderbuffers);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteShader(GLuint shader)
 {
+	CAPTURE(DeleteShader, shader);
 	return es2::DeleteShader(shader);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
 {
+	CAPTURE(DeleteTextures, n, es2::CommandTrace::data(textures, n > 0 ? n * sizeof(GLuint) : 0));
 	return es2::DeleteTextures(n, textures);
 }
 
 GL_APICALL void GL_APIENTRY glDepthFunc(GLenum func)
 {
+	CAPTURE(DepthFunc, func);
 	return es2::DepthFunc(func);
 }
 
 GL_APICALL void GL_APIENTRY glDepthMask(GLboolean flag)
 {
+	CAPTURE(DepthMask, flag);
 	return es2::DepthMask(flag);
 }
 
 GL_APICALL void GL_APIENTRY glDepthRangef(GLclampf zNear, GLclampf zFar)
 {
+	CAPTURE(DepthRangef, zNear, zFar);
 	return es2::DepthRangef(zNear, zFar);
 }
 
 GL_APICALL void GL_APIENTRY glDetachShader(GLuint program, GLuint shader)
 {
+	CAPTURE(DetachShader, program, shader);
 	return es2::DetachShader(program, shader);
 }
 
 GL_APICALL void GL_APIENTRY glDisable(GLenum cap)
 {
+	CAPTURE(Disable, cap);
 	return es2::Disable(cap);
 }
 
 GL_APICALL void GL_APIENTRY glDisableVertexAttribArray(GLuint index)
 {
+	CAPTURE(DisableVertexAttribArray, index);
 	return es2::DisableVertexAttribArray(index);
 }
 
 GL_APICALL void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->drawArrays(mode, first, count, 1);
+	}
+
 	return es2::DrawArrays(mode, first, count);
 }
 
 GL_APICALL void GL_APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->drawElements(mode, count, type, indices, 1);
+	}
+
 	return es2::DrawElements(mode, count, type, indices);
 }
 
 GL_APICALL void GL_APIENTRY glDrawArraysInstancedEXT(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->drawArrays(mode, first, count, instanceCount);
+	}
+
 	return es2::DrawArraysInstancedEXT(mode, first, count, instanceCount);
 }
 
 GL_APICALL void GL_APIENTRY glDrawElementsInstancedEXT(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->drawElements(mode, count, type, indices, instanceCount);
+	}
+
 	return es2::DrawElementsInstancedEXT(mode, count, type, indices, instanceCount);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttribDivisorEXT(GLuint index, GLuint divisor)
 {
+	CAPTURE(VertexAttribDivisor, index, divisor);
 	return es2::VertexAttribDivisorEXT(index, divisor);
 }
 
 GL_APICALL void GL_APIENTRY glDrawArraysInstancedANGLE(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->drawArrays(mode, first, count, instanceCount);
+	}
+
 	return es2::DrawArraysInstancedANGLE(mode, first, count, instanceCount);
 }
 
 GL_APICALL void GL_APIENTRY glDrawElementsInstancedANGLE(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->drawElements(mode, count, type, indices, instanceCount);
+	}
+
 	return es2::DrawElementsInstancedANGLE(mode, count, type, indices, instanceCount);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttribDivisorANGLE(GLuint index, GLuint divisor)
 {
+	CAPTURE(VertexAttribDivisor, index, divisor);
 	return es2::VertexAttribDivisorANGLE(index, divisor);
 }
 
 GL_APICALL void GL_APIENTRY glEnable(GLenum cap)
 {
+	CAPTURE(Enable, cap);
 	return es2::Enable(cap);
 }
 
 GL_APICALL void GL_APIENTRY glEnableVertexAttribArray(GLuint index)
 {
+	CAPTURE(EnableVertexAttribArray, index);
 	return es2::EnableVertexAttribArray(index);
 }
 
 GL_APICALL void GL_APIENTRY glEndQueryEXT(GLenum target)
 {
+	CAPTURE(EndQueryEXT, target);
 	return es2::EndQueryEXT(target);
 }
 
@@ -529,51 +620,70 @@ GL_APICALL void GL_APIENTRY glFinishFenceNV(GLuint fence)
 
 GL_APICALL void GL_APIENTRY glFinish(void)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->record(es2::CommandTrace::Finish);
+	}
+
 	return es2::Finish();
 }
 
 GL_APICALL void GL_APIENTRY glFlush(void)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->record(es2::CommandTrace::Flush);
+	}
+
 	return es2::Flush();
 }
 
 GL_APICALL void GL_APIENTRY glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
 {
+	CAPTURE(FramebufferRenderbuffer, target, attachment, renderbuffertarget, renderbuffer);
 	return es2::FramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
 }
 
 GL_APICALL void GL_APIENTRY glFramebufferRenderbufferOES(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
 {
+	CAPTURE(FramebufferRenderbuffer, target, attachment, renderbuffertarget, renderbuffer);
 	return es2::FramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
 }
 
 GL_APICALL void GL_APIENTRY glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
 {
+	CAPTURE(FramebufferTexture2D, target, attachment, textarget, texture, level);
 	return es2::FramebufferTexture2D(target, attachment, textarget, texture, level);
 }
 
 GL_APICALL void GL_APIENTRY glFramebufferTexture2DOES(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
 {
+	CAPTURE(FramebufferTexture2D, target, attachment, textarget, texture, level);
 	return es2::FramebufferTexture2D(target, attachment, textarget, texture, level);
 }
 
 GL_APICALL void GL_APIENTRY glFrontFace(GLenum mode)
 {
+	CAPTURE(FrontFace, mode);
 	return es2::FrontFace(mode);
 }
 
 GL_APICALL void GL_APIENTRY glGenBuffers(GLsizei n, GLuint* buffers)
 {
-	return es2::GenBuffers(n, buffers);
+	es2::GenBuffers(n, buffers);
+
+	CAPTURE(GenBuffers, n, es2::CommandTrace::data(buffers, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 GL_APICALL void GL_APIENTRY glGenerateMipmap(GLenum target)
 {
+	CAPTURE(GenerateMipmap, target);
 	return es2::GenerateMipmap(target);
 }
 
 GL_APICALL void GL_APIENTRY glGenerateMipmapOES(GLenum target)
 {
+	CAPTURE(GenerateMipmap, target);
 	return es2::GenerateMipmap(target);
 }
 
@@ -584,32 +694,44 @@ GL_APICALL void GL_APIENTRY glGenFencesNV(GLsizei n, GLuint* fences)
 
 GL_APICALL void GL_APIENTRY glGenFramebuffers(GLsizei n, GLuint* framebuffers)
 {
-	return es2::GenFramebuffers(n, framebuffers);
+	es2::GenFramebuffers(n, framebuffers);
+
+	CAPTURE(GenFramebuffers, n, es2::CommandTrace::data(framebuffers, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 GL_APICALL void GL_APIENTRY glGenFramebuffersOES(GLsizei n, GLuint* framebuffers)
 {
-	return es2::GenFramebuffers(n, framebuffers);
+	es2::GenFramebuffers(n, framebuffers);
+
+	CAPTURE(GenFramebuffers, n, es2::CommandTrace::data(framebuffers, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 GL_APICALL void GL_APIENTRY glGenQueriesEXT(GLsizei n, GLuint* ids)
 {
-	return es2::GenQueriesEXT(n, ids);
+	es2::GenQueriesEXT(n, ids);
+
+	CAPTURE(GenQueriesEXT, n, es2::CommandTrace::data(ids, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 GL_APICALL void GL_APIENTRY glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
 {
-	return es2::GenRenderbuffers(n, renderbuffers);
+	es2::GenRenderbuffers(n, renderbuffers);
+
+	CAPTURE(GenRenderbuffers, n, es2::CommandTrace::data(renderbuffers, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 GL_APICALL void GL_APIENTRY glGenRenderbuffersOES(GLsizei n, GLuint* renderbuffers)
 {
-	return es2::GenRenderbuffers(n, renderbuffers);
+	es2::GenRenderbuffers(n, renderbuffers);
+
+	CAPTURE(GenRenderbuffers, n, es2::CommandTrace::data(renderbuffers, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 GL_APICALL void GL_APIENTRY glGenTextures(GLsizei n, GLuint* textures)
 {
-	return es2::GenTextures(n, textures);
+	es2::GenTextures(n, textures);
+
+	CAPTURE(GenTextures, n, es2::CommandTrace::data(textures, n > 0 ? n * sizeof(GLuint) : 0));
 }
 
 GL_APICALL void GL_APIENTRY glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufsize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
@@ -692,11 +814,26 @@ GL_APICALL void GL_APIENTRY glGetQueryivEXT(GLenum target, GLenum pname, GLint *
 	return es2::GetQueryivEXT(target, pname, params);
 }
 
+GL_APICALL void GL_APIENTRY glGetQueryObjectivEXT(GLuint name, GLenum pname, GLint *params)
+{
+	return es2::GetQueryObjectivEXT(name, pname, params);
+}
+
 GL_APICALL void GL_APIENTRY glGetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
 {
 	return es2::GetQueryObjectuivEXT(name, pname, params);
 }
 
+GL_APICALL void GL_APIENTRY glGetQueryObjecti64vEXT(GLuint name, GLenum pname, GLint64 *params)
+{
+	return es2::GetQueryObjecti64vEXT(name, pname, params);
+}
+
+GL_APICALL void GL_APIENTRY glGetQueryObjectui64vEXT(GLuint name, GLenum pname, GLuint64 *params)
+{
+	return es2::GetQueryObjectui64vEXT(name, pname, params);
+}
+
 GL_APICALL void GL_APIENTRY glGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
 {
 	return es2::GetRenderbufferParameteriv(target, pname, params);
@@ -784,6 +921,7 @@ GL_APICALL void GL_APIENTRY glGetVertexAttribPointerv(GLuint index, GLenum pname
 
 GL_APICALL void GL_APIENTRY glHint(GLenum target, GLenum mode)
 {
+	CAPTURE(Hint, target, mode);
 	return es2::Hint(target, mode);
 }
 
@@ -844,32 +982,52 @@ GL_APICALL GLboolean GL_APIENTRY glIsTexture(GLuint texture)
 
 GL_APICALL void GL_APIENTRY glLineWidth(GLfloat width)
 {
+	CAPTURE(LineWidth, width);
 	return es2::LineWidth(width);
 }
 
 GL_APICALL void GL_APIENTRY glLinkProgram(GLuint program)
 {
+	CAPTURE(LinkProgram, program);
 	return es2::LinkProgram(program);
 }
 
 GL_APICALL void GL_APIENTRY glPixelStorei(GLenum pname, GLint param)
 {
+	CAPTURE(PixelStorei, pname, param);
 	return es2::PixelStorei(pname, param);
 }
 
 GL_APICALL void GL_APIENTRY glPolygonOffset(GLfloat factor, GLfloat units)
 {
+	CAPTURE(PolygonOffset, factor, units);
 	return es2::PolygonOffset(factor, units);
 }
 
+GL_APICALL void GL_APIENTRY glQueryCounterEXT(GLuint name, GLenum target)
+{
+	CAPTURE(QueryCounterEXT, name, target);
+	return es2::QueryCounterEXT(name, target);
+}
+
 GL_APICALL void GL_APIENTRY glReadnPixelsEXT(GLint x, GLint y, GLsizei width, GLsizei height,
                                              GLenum format, GLenum type, GLsizei bufSize, GLvoid *data)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->readPixels(x, y, width, height, format, type, data);
+	}
+
 	return es2::ReadnPixelsEXT(x, y, width, height, format, type, bufSize, data);
 }
 
 GL_APICALL void GL_APIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->readPixels(x, y, width, height, format, type, pixels);
+	}
+
 	return es2::ReadPixels(x, y, width, height, format, type, pixels);
 }
 
@@ -880,26 +1038,31 @@ GL_APICALL void GL_APIENTRY glReleaseShaderCompiler(void)
 
 GL_APICALL void GL_APIENTRY glRenderbufferStorageMultisample(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height)
 {
+	CAPTURE(RenderbufferStorageMultisample, target, samples, internalformat, width, height);
 	return es2::RenderbufferStorageMultisample(target, samples, internalformat, width, height);
 }
 
 GL_APICALL void GL_APIENTRY glRenderbufferStorageMultisampleANGLE(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height)
 {
+	CAPTURE(RenderbufferStorageMultisample, target, samples, internalformat, width, height);
 	return es2::RenderbufferStorageMultisampleANGLE(target, samples, internalformat, width, height);
 }
 
 GL_APICALL void GL_APIENTRY glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
 {
+	CAPTURE(RenderbufferStorage, target, internalformat, width, height);
 	return es2::RenderbufferStorage(target, internalformat, width, height);
 }
 
 GL_APICALL void GL_APIENTRY glRenderbufferStorageOES(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
 {
+	CAPTURE(RenderbufferStorage, target, internalformat, width, height);
 	return es2::RenderbufferStorage(target, internalformat, width, height);
 }
 
 GL_APICALL void GL_APIENTRY glSampleCoverage(GLclampf value, GLboolean invert)
 {
+	CAPTURE(SampleCoverage, value, invert);
 	return es2::SampleCoverage(value, invert);
 }
 
@@ -910,6 +1073,7 @@ GL_APICALL void GL_APIENTRY glSetFenceNV(GLuint fence, GLenum condition)
 
 GL_APICALL void GL_APIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
 {
+	CAPTURE(Scissor, x, y, width, height);
 	return es2::Scissor(x, y, width, height);
 }
 
@@ -920,36 +1084,47 @@ GL_APICALL void GL_APIENTRY glShaderBinary(GLsizei n, const GLuint* shaders, GLe
 
 GL_APICALL void GL_APIENTRY glShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
 {
+	if(es2::CommandTrace *trace = es2::CommandTrace::get())
+	{
+		trace->shaderSource(shader, count, string, length);
+	}
+
 	return es2::ShaderSource(shader, count, string, length);
 }
 
 GL_APICALL void GL_APIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask)
 {
+	CAPTURE(StencilFunc, func, ref, mask);
 	return es2::StencilFunc(func, ref, mask);
 }
 
 GL_APICALL void GL_APIENTRY glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
 {
+	CAPTURE(StencilFuncSeparate, face, func, ref, mask);
 	return es2::StencilFuncSeparate(face, func, ref, mask);
 }
 
 GL_APICALL void GL_APIENTRY glStencilMask(GLuint mask)
 {
+	CAPTURE(StencilMask, mask);
 	return es2::StencilMask(mask);
 }
 
 GL_APICALL void GL_APIENTRY glStencilMaskSeparate(GLenum face, GLuint mask)
 {
+	CAPTURE(StencilMaskSeparate, face, mask);
 	return es2::StencilMaskSeparate(face, mask);
 }
 
 GL_APICALL void GL_APIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
 {
+	CAPTURE(StencilOp, fail, zfail, zpass);
 	return es2::StencilOp(fail, zfail, zpass);
 }
 
 GL_APICALL void GL_APIENTRY glStencilOpSeparate(GLenum face, GLenum fail, GLenum zfail, GLenum zpass)
 {
+	CAPTURE(StencilOpSeparate, face, fail, zfail, zpass);
 	return es2::StencilOpSeparate(face, fail, zfail, zpass);
 }
 
@@ -961,132 +1136,158 @@ GLboolean GL_APIENTRY glTestFenceNV(GLuint fence)
 GL_APICALL void GL_APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
                                          GLint border, GLenum format, GLenum type, const GLvoid* pixels)
 {
+	CAPTURE(TexImage2D, target, level, internalformat, width, height, border, format, type, es2::CommandTrace::pixels(width, height, 1, format, type, pixels));
 	return es2::TexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
 }
 
 GL_APICALL void GL_APIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param)
 {
+	CAPTURE(TexParameterf, target, pname, param);
 	return es2::TexParameterf(target, pname, param);
 }
 
 GL_APICALL void GL_APIENTRY glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params)
 {
+	CAPTURE(TexParameterfv, target, pname, es2::CommandTrace::data(params, sizeof(GLfloat)));
 	return es2::TexParameterfv(target, pname, params);
 }
 
 GL_APICALL void GL_APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
 {
+	CAPTURE(TexParameteri, target, pname, param);
 	return es2::TexParameteri(target, pname, param);
 }
 
 GL_APICALL void GL_APIENTRY glTexParameteriv(GLenum target, GLenum pname, const GLint* params)
 {
+	CAPTURE(TexParameteriv, target, pname, es2::CommandTrace::data(params, sizeof(GLint)));
 	return es2::TexParameteriv(target, pname, params);
 }
 
 GL_APICALL void GL_APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
                                             GLenum format, GLenum type, const GLvoid* pixels)
 {
+	CAPTURE(TexSubImage2D, target, level, xoffset, yoffset, width, height, format, type, es2::CommandTrace::pixels(width, height, 1, format, type, pixels));
 	return es2::TexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
 }
 
 GL_APICALL void GL_APIENTRY glUniform1f(GLint location, GLfloat x)
 {
+	CAPTURE(Uniform1f, location, x);
 	return es2::Uniform1f(location, x);
 }
 
 GL_APICALL void GL_APIENTRY glUniform1fv(GLint location, GLsizei count, const GLfloat* v)
 {
+	CAPTURE(Uniform1fv, location, count, es2::CommandTrace::data(v, count > 0 ? count * 1 * sizeof(GLfloat) : 0));
 	return es2::Uniform1fv(location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform1i(GLint location, GLint x)
 {
+	CAPTURE(Uniform1i, location, x);
 	return es2::Uniform1i(location, x);
 }
 
 GL_APICALL void GL_APIENTRY glUniform1iv(GLint location, GLsizei count, const GLint* v)
 {
+	CAPTURE(Uniform1iv, location, count, es2::CommandTrace::data(v, count > 0 ? count * 1 * sizeof(GLint) : 0));
 	return es2::Uniform1iv(location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform2f(GLint location, GLfloat x, GLfloat y)
 {
+	CAPTURE(Uniform2f, location, x, y);
 	return es2::Uniform2f(location, x, y);
 }
 
 GL_APICALL void GL_APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat* v)
 {
+	CAPTURE(Uniform2fv, location, count, es2::CommandTrace::data(v, count > 0 ? count * 2 * sizeof(GLfloat) : 0));
 	return es2::Uniform2fv(location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform2i(GLint location, GLint x, GLint y)
 {
+	CAPTURE(Uniform2i, location, x, y);
 	return es2::Uniform2i(location, x, y);
 }
 
 GL_APICALL void GL_APIENTRY glUniform2iv(GLint location, GLsizei count, const GLint* v)
 {
+	CAPTURE(Uniform2iv, location, count, es2::CommandTrace::data(v, count > 0 ? count * 2 * sizeof(GLint) : 0));
 	return es2::Uniform2iv(location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z)
 {
+	CAPTURE(Uniform3f, location, x, y, z);
 	return es2::Uniform3f(location, x, y, z);
 }
 
 GL_APICALL void GL_APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat* v)
 {
+	CAPTURE(Uniform3fv, location, count, es2::CommandTrace::data(v, count > 0 ? count * 3 * sizeof(GLfloat) : 0));
 	return es2::Uniform3fv(location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform3i(GLint location, GLint x, GLint y, GLint z)
 {
+	CAPTURE(Uniform3i, location, x, y, z);
 	return es2::Uniform3i(location, x, y, z);
 }
 
 GL_APICALL void GL_APIENTRY glUniform3iv(GLint location, GLsizei count, const GLint* v)
 {
+	CAPTURE(Uniform3iv, location, count, es2::CommandTrace::data(v, count > 0 ? count * 3 * sizeof(GLint) : 0));
 	return es2::Uniform3iv(location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
+	CAPTURE(Uniform4f, location, x, y, z, w);
 	return es2::Uniform4f(location, x, y, z, w);
 }
 
 GL_APICALL void GL_APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat* v)
 {
+	CAPTURE(Uniform4fv, location, count, es2::CommandTrace::data(v, count > 0 ? count * 4 * sizeof(GLfloat) : 0));
 	return es2::Uniform4fv(location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform4i(GLint location, GLint x, GLint y, GLint z, GLint w)
 {
+	CAPTURE(Uniform4i, location, x, y, z, w);
 	return es2::Uniform4i(location, x, y, z, w);
 }
 
 GL_APICALL void GL_APIENTRY glUniform4iv(GLint location, GLsizei count, const GLint* v)
 {
+	CAPTURE(Uniform4iv, location, count, es2::CommandTrace::data(v, count > 0 ? count * 4 * sizeof(GLint) : 0));
 	return es2::Uniform4iv(location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
+	CAPTURE(UniformMatrix2fv, location, count, transpose, es2::CommandTrace::data(value, count > 0 ? count * 4 * sizeof(GLfloat) : 0));
 	return es2::UniformMatrix2fv(location, count, transpose, value);
 }
 
 GL_APICALL void GL_APIENTRY glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
+	CAPTURE(UniformMatrix3fv, location, count, transpose, es2::CommandTrace::data(value, count > 0 ? count * 9 * sizeof(GLfloat) : 0));
 	return es2::UniformMatrix3fv(location, count, transpose, value);
 }
 
 GL_APICALL void GL_APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
+	CAPTURE(UniformMatrix4fv, location, count, transpose, es2::CommandTrace::data(value, count > 0 ? count * 16 * sizeof(GLfloat) : 0));
 	return es2::UniformMatrix4fv(location, count, transpose, value);
 }
 
 GL_APICALL void GL_APIENTRY glUseProgram(GLuint program)
 {
+	CAPTURE(UseProgram, program);
 	return es2::UseProgram(program);
 }
 
@@ -1097,93 +1298,111 @@ GL_APICALL void GL_APIENTRY glValidateProgram(GLuint program)
 
 GL_APICALL void GL_APIENTRY glVertexAttrib1f(GLuint index, GLfloat x)
 {
+	CAPTURE(VertexAttrib1f, index, x);
 	return es2::VertexAttrib1f(index, x);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib1fv(GLuint index, const GLfloat* values)
 {
+	CAPTURE(VertexAttrib1fv, index, es2::CommandTrace::data(values, 1 * sizeof(GLfloat)));
 	return es2::VertexAttrib1fv(index, values);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib2f(GLuint index, GLfloat x, GLfloat y)
 {
+	CAPTURE(VertexAttrib2f, index, x, y);
 	return es2::VertexAttrib2f(index, x, y);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib2fv(GLuint index, const GLfloat* values)
 {
+	CAPTURE(VertexAttrib2fv, index, es2::CommandTrace::data(values, 2 * sizeof(GLfloat)));
 	return es2::VertexAttrib2fv(index, values);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib3f(GLuint index, GLfloat x, GLfloat y, GLfloat z)
 {
+	CAPTURE(VertexAttrib3f, index, x, y, z);
 	return es2::VertexAttrib3f(index, x, y, z);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib3fv(GLuint index, const GLfloat* values)
 {
+	CAPTURE(VertexAttrib3fv, index, es2::CommandTrace::data(values, 3 * sizeof(GLfloat)));
 	return es2::VertexAttrib3fv(index, values);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib4f(GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
+	CAPTURE(VertexAttrib4f, index, x, y, z, w);
 	return es2::VertexAttrib4f(index, x, y, z, w);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib4fv(GLuint index, const GLfloat* values)
 {
+	CAPTURE(VertexAttrib4fv, index, es2::CommandTrace::data(values, 4 * sizeof(GLfloat)));
 	return es2::VertexAttrib4fv(index, values);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* ptr)
 {
+	CAPTURE(VertexAttribPointer, index, size, type, normalized, stride, (int64_t)(intptr_t)ptr);
 	return es2::VertexAttribPointer(index, size, type, normalized, stride, ptr);
 }
 
 GL_APICALL void GL_APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
 {
+	CAPTURE(Viewport, x, y, width, height);
 	return es2::Viewport(x, y, width, height);
 }
 
 GL_APICALL void GL_APIENTRY glBlitFramebufferNV(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
 {
+	CAPTURE(BlitFramebufferNV, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
 	return es2::BlitFramebufferNV(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
 }
 
 GL_APICALL void GL_APIENTRY glBlitFramebufferANGLE(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1,
                                                    GLbitfield mask, GLenum filter)
 {
+	CAPTURE(BlitFramebufferANGLE, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
 	return es2::BlitFramebufferANGLE(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
 }
 
 GL_APICALL void GL_APIENTRY glTexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth,
                                             GLint border, GLenum format, GLenum type, const GLvoid* pixels)
 {
+	CAPTURE(TexImage3D, target, level, internalformat, width, height, depth, border, format, type, es2::CommandTrace::pixels(width, height, depth, format, type, pixels));
 	return es2::TexImage3DOES(target, level, internalformat, width, height, depth, border, format, type, pixels);
 }
 
 GL_APICALL void GL_APIENTRY glTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels)
 {
+	CAPTURE(TexSubImage3D, target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, es2::CommandTrace::pixels(width, height, depth, format, type, pixels));
 	return es2::TexSubImage3DOES(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels);
 }
 
 GL_APICALL void GL_APIENTRY glCopyTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height)
 {
+	CAPTURE(CopyTexSubImage3D, target, level, xoffset, yoffset, zoffset, x, y, width, height);
 	return es2::CopyTexSubImage3DOES(target, level, xoffset, yoffset, zoffset, x, y, width, height);
 }
 
 GL_APICALL void GL_APIENTRY glCompressedTexImage3DOES(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data)
 {
+	CAPTURE(CompressedTexImage3D, target, level, internalformat, width, height, depth, border, imageSize, es2::CommandTrace::compressed(imageSize, data));
 	return es2::CompressedTexImage3DOES(target, level,internalformat, width, height, depth, border, imageSize, data);
 }
 
 GL_APICALL void GL_APIENTRY glCompressedTexSubImage3DOES(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data)
 {
+	CAPTURE(CompressedTexSubImage3D, target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, es2::CommandTrace::compressed(imageSize, data));
 	return es2::CompressedTexSubImage3DOES(target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data);
 }
 
 GL_APICALL void GL_APIENTRY glFramebufferTexture3DOES(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset)
 {
+	CAPTURE(FramebufferTexture3D, target, attachment, textarget, texture, level, zoffset);
 	return es2::FramebufferTexture3DOES(target, attachment, textarget, texture, level, zoffset);
 }
 
@@ -1199,6 +1418,7 @@ GL_APICALL void GL_APIENTRY glEGLImageTargetRenderbufferStorageOES(GLenum target
 
 GL_APICALL void GL_APIENTRY glDrawBuffersEXT(GLsizei n, const GLenum *bufs)
 {
+	CAPTURE(DrawBuffersEXT, n, es2::CommandTrace::data(bufs, n > 0 ? n * sizeof(GLenum) : 0));
 	return es2::DrawBuffersEXT(n, bufs);
 }
 
@@ -1209,11 +1429,16 @@ void GL_APIENTRY Register(const char *licenseKey)
 }
 
 egl::Context *es2CreateContext(egl::Display *display, const egl::Context *shareContext, const egl::Config *config);
+void es2EndFrame();
+void warmUpRoutines(const sw::Format *renderTargetFormats, int count);
+void overrideConfiguration(const char *section, const char *name, int value);
 extern "C" __eglMustCastToProperFunctionPointerType es2GetProcAddress(const char *procname);
 egl::Image *createBackBuffer(int width, int height, sw::Format format, int multiSampleDepth);
 egl::Image *createBackBufferFromClientBuffer(const egl::ClientBuffer& clientBuffer);
+egl::Image *createImageFromDmaBuffer(const egl::DmaBuffer& dmaBuffer);
 egl::Image *createDepthStencil(int width, int height, sw::Format format, int multiSampleDepth);
 sw::FrameBuffer *createFrameBuffer(void *nativeDisplay, EGLNativeWindowType window, int width, int height);
+sw::FrameBuffer *createFrameBufferYUV(int fileDescriptor, sw::YUVLayout layout, int frameCount, int width, int height);
 
 LibGLESv2exports::LibGLESv2exports()
 {
@@ -1413,11 +1638,16 @@ LibGLESv2exports::LibGLESv2exports()
 	this->glDrawBuffersEXT = es2::DrawBuffersEXT;
 
 	this->es2CreateContext = ::es2CreateContext;
+	this->es2EndFrame = ::es2EndFrame;
+	this->warmUpRoutines = ::warmUpRoutines;
+	this->overrideConfiguration = ::overrideConfiguration;
 	this->es2GetProcAddress = ::es2GetProcAddress;
 	this->createBackBuffer = ::createBackBuffer;
 	this->createBackBufferFromClientBuffer = ::createBackBufferFromClientBuffer;
+	this->createImageFromDmaBuffer = ::createImageFromDmaBuffer;
 	this->createDepthStencil = ::createDepthStencil;
 	this->createFrameBuffer = ::createFrameBuffer;
+	this->createFrameBufferYUV = ::createFrameBufferYUV;
 }
 
 extern "C" GL_APICALL LibGLESv2exports *libGLESv2_swiftshader()
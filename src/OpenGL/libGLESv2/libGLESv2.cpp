@@ -121,6 +121,7 @@ void BeginQueryEXT(GLenum target, GLuint name)
 	{
 	case GL_ANY_SAMPLES_PASSED_EXT:
 	case GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT:
+	case GL_TIME_ELAPSED_EXT:
 		break;
 	default:
 		return error(GL_INVALID_ENUM);
@@ -1806,6 +1807,7 @@ void EndQueryEXT(GLenum target)
 	{
 	case GL_ANY_SAMPLES_PASSED_EXT:
 	case GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT:
+	case GL_TIME_ELAPSED_EXT:
 		break;
 	default:
 		return error(GL_INVALID_ENUM);
@@ -2994,10 +2996,27 @@ void GetQueryivEXT(GLenum target, GLenum pname, GLint *params)
 {
 	TRACE("GLenum target = 0x%X, GLenum pname = 0x%X, GLint *params = %p)", target, pname, params);
 
+	switch(target)
+	{
+	case GL_ANY_SAMPLES_PASSED_EXT:
+	case GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT:
+	case GL_TIME_ELAPSED_EXT:
+	case GL_TIMESTAMP_EXT:
+		break;
+	default:
+		return error(GL_INVALID_ENUM);
+	}
+
 	switch(pname)
 	{
 	case GL_CURRENT_QUERY_EXT:
 		break;
+	case GL_QUERY_COUNTER_BITS_EXT:
+		if(target != GL_TIME_ELAPSED_EXT && target != GL_TIMESTAMP_EXT)
+		{
+			return error(GL_INVALID_ENUM);
+		}
+		break;
 	default:
 		return error(GL_INVALID_ENUM);
 	}
@@ -3006,14 +3025,20 @@ void GetQueryivEXT(GLenum target, GLenum pname, GLint *params)
 
 	if(context)
 	{
-		params[0] = context->getActiveQuery(target);
+		if(pname == GL_QUERY_COUNTER_BITS_EXT)
+		{
+			params[0] = 64;   // Nanoseconds
+		}
+		else
+		{
+			params[0] = context->getActiveQuery(target);
+		}
 	}
 }
 
-void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
+template<typename T>
+static void GetQueryObject(GLuint name, GLenum pname, T *params)
 {
-	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLuint *params = %p)", name, pname, params);
-
 	switch(pname)
 	{
 	case GL_QUERY_RESULT_EXT:
@@ -3042,7 +3067,7 @@ void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
 		switch(pname)
 		{
 		case GL_QUERY_RESULT_EXT:
-			params[0] = queryObject->getResult();
+			params[0] = (T)queryObject->getResult();   // Narrower types keep the low bits
 			break;
 		case GL_QUERY_RESULT_AVAILABLE_EXT:
 			params[0] = queryObject->isResultAvailable();
@@ -3053,6 +3078,34 @@ void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
 	}
 }
 
+void GetQueryObjectivEXT(GLuint name, GLenum pname, GLint *params)
+{
+	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLint *params = %p)", name, pname, params);
+
+	GetQueryObject(name, pname, params);
+}
+
+void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
+{
+	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLuint *params = %p)", name, pname, params);
+
+	GetQueryObject(name, pname, params);
+}
+
+void GetQueryObjecti64vEXT(GLuint name, GLenum pname, GLint64 *params)
+{
+	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLint64 *params = %p)", name, pname, params);
+
+	GetQueryObject(name, pname, params);
+}
+
+void GetQueryObjectui64vEXT(GLuint name, GLenum pname, GLuint64 *params)
+{
+	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLuint64 *params = %p)", name, pname, params);
+
+	GetQueryObject(name, pname, params);
+}
+
 void GetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
 {
 	TRACE("(GLenum target = 0x%X, GLenum pname = 0x%X, GLint* params = %p)", target, pname, params);
@@ -4128,6 +4181,23 @@ void PolygonOffset(GLfloat factor, GLfloat units)
 	}
 }
 
+void QueryCounterEXT(GLuint name, GLenum target)
+{
+	TRACE("(GLuint name = %d, GLenum target = 0x%X)", name, target);
+
+	if(target != GL_TIMESTAMP_EXT)
+	{
+		return error(GL_INVALID_ENUM);
+	}
+
+	es2::Context *context = es2::getContext();
+
+	if(context)
+	{
+		context->queryCounter(name, target);
+	}
+}
+
 void ReadnPixelsEXT(GLint x, GLint y, GLsizei width, GLsizei height,
                     GLenum format, GLenum type, GLsizei bufSize, GLvoid *data)
 {
@@ -6271,6 +6341,9 @@ void DrawBuffersEXT(GLsizei n, const GLenum *bufs)
 
 }
 
+// Not declared by the OpenGL ES headers, which only list it in the EXT_disjoint_timer_query specification
+extern "C" GL_APICALL void GL_APIENTRY glGetInteger64vEXT(GLenum pname, GLint64 *data);
+
 extern "C" NO_SANITIZE_FUNCTION __eglMustCastToProperFunctionPointerType es2GetProcAddress(const char *procname)
 {
 	struct Function
@@ -6417,12 +6490,16 @@ extern "C" NO_SANITIZE_FUNCTION __eglMustCastToProperFunctionPointerType es2GetP
 		FUNCTION(glGetGraphicsResetStatusEXT),
 		FUNCTION(glGetInteger64i_v),
 		FUNCTION(glGetInteger64v),
+		FUNCTION(glGetInteger64vEXT),
 		FUNCTION(glGetIntegeri_v),
 		FUNCTION(glGetIntegerv),
 		FUNCTION(glGetInternalformativ),
 		FUNCTION(glGetProgramBinary),
 		FUNCTION(glGetProgramInfoLog),
 		FUNCTION(glGetProgramiv),
+		FUNCTION(glGetQueryObjecti64vEXT),
+		FUNCTION(glGetQueryObjectivEXT),
+		FUNCTION(glGetQueryObjectui64vEXT),
 		FUNCTION(glGetQueryObjectuiv),
 		FUNCTION(glGetQueryObjectuivEXT),
 		FUNCTION(glGetQueryiv),
@@ -6482,6 +6559,7 @@ extern "C" NO_SANITIZE_FUNCTION __eglMustCastToProperFunctionPointerType es2GetP
 		FUNCTION(glPolygonOffset),
 		FUNCTION(glProgramBinary),
 		FUNCTION(glProgramParameteri),
+		FUNCTION(glQueryCounterEXT),
 		FUNCTION(glReadBuffer),
 		FUNCTION(glReadPixels),
 		FUNCTION(glReadnPixelsEXT),
@@ -25,6 +25,7 @@ namespace sw
 {
 class FrameBuffer;
 enum Format : unsigned char;
+enum YUVLayout : unsigned char;
 }
 
 namespace egl
@@ -34,6 +35,7 @@ class Context;
 class Image;
 class Config;
 class ClientBuffer;
+struct DmaBuffer;
 }
 
 class LibGLESv2exports
@@ -244,11 +246,16 @@ public:
 	void (*glDrawBuffersEXT)(GLsizei n, const GLenum *bufs);
 
 	egl::Context *(*es2CreateContext)(egl::Display *display, const egl::Context *shareContext, const egl::Config *config);
+	void (*es2EndFrame)();   // Called by eglSwapBuffers for OpenGL ES 2.0 and 3.0 contexts
+	void (*warmUpRoutines)(const sw::Format *renderTargetFormats, int count);   // Called by eglInitialize, returns right away
+	void (*overrideConfiguration)(const char *section, const char *name, int value);   // A null section clears the overrides
 	__eglMustCastToProperFunctionPointerType (*es2GetProcAddress)(const char *procname);
 	egl::Image *(*createBackBuffer)(int width, int height, sw::Format format, int multiSampleDepth);
 	egl::Image *(*createBackBufferFromClientBuffer)(const egl::ClientBuffer& clientBuffer);
+	egl::Image *(*createImageFromDmaBuffer)(const egl::DmaBuffer& dmaBuffer);
 	egl::Image *(*createDepthStencil)(int width, int height, sw::Format format, int multiSampleDepth);
 	sw::FrameBuffer *(*createFrameBuffer)(void *nativeDisplay, EGLNativeWindowType window, int width, int height);
+	sw::FrameBuffer *(*createFrameBufferYUV)(int fileDescriptor, sw::YUVLayout layout, int frameCount, int width, int height);
 };
 
 class LibGLESv2
@@ -2983,6 +2983,12 @@ GL_APICALL void GL_APIENTRY glGetInteger64v(GLenum pname, GLint64 *data)
 	}
 }
 
+// From EXT_disjoint_timer_query, for querying GL_TIMESTAMP_EXT without OpenGL ES 3.0
+GL_APICALL void GL_APIENTRY glGetInteger64vEXT(GLenum pname, GLint64 *data)
+{
+	glGetInteger64v(pname, data);
+}
+
 GL_APICALL void GL_APIENTRY glGetSynciv(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei *length, GLint *values)
 {
 	TRACE("(GLsync sync = %p, GLenum pname = 0x%X, GLsizei bufSize = %d, GLsizei *length = %p, GLint *values = %p)",
@@ -3495,16 +3501,23 @@ GL_APICALL void GL_APIENTRY glGetProgramBinary(GLuint program, GLsizei bufSize,
 		{
 			return error(GL_INVALID_OPERATION);
 		}
-	}
 
-	// SwiftShader doesn't return a program binary and sets the program binay size to 0, so any attempt at getting one is invalid.
-	return error(GL_INVALID_OPERATION);
+		if(!programObject->getBinary(bufSize, length, binary))
+		{
+			return error(GL_INVALID_OPERATION);
+		}
+
+		if(binaryFormat)
+		{
+			*binaryFormat = GL_PROGRAM_BINARY_SWIFTSHADER;
+		}
+	}
 }
 
 GL_APICALL void GL_APIENTRY glProgramBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length)
 {
 	TRACE("(GLuint program = %d, GLenum binaryFormat = 0x%X, const void *binary = %p, GLsizei length = %d)",
-	      program, binaryFormat, binaryFormat, length);
+	      program, binaryFormat, binary, length);
 
 	if(length < 0)
 	{
@@ -3521,10 +3534,15 @@ GL_APICALL void GL_APIENTRY glProgramBinary(GLuint program, GLenum binaryFormat,
 		{
 			return error(GL_INVALID_OPERATION);
 		}
-	}
 
-	// Regardless of what the binaryFormat is, it is unrecognized by SwiftShader, since it supports no format.
-	return error(GL_INVALID_ENUM);
+		if(binaryFormat != GL_PROGRAM_BINARY_SWIFTSHADER)
+		{
+			return error(GL_INVALID_ENUM);
+		}
+
+		// A binary from another build or device doesn't produce an error, it leaves the program unlinked
+		programObject->setBinary(binary, length);
+	}
 }
 
 GL_APICALL void GL_APIENTRY glProgramParameteri(GLuint program, GLenum pname, GLint value)
@@ -3628,9 +3646,12 @@ GL_APICALL void GL_APIENTRY glInvalidateSubFramebuffer(GLenum target, GLsizei nu
 					break;
 				}
 			}
-		}
 
-		// UNIMPLEMENTED();   // It is valid for this function to be treated as a no-op
+			// Clamped, so the extent of glInvalidateFramebuffer() doesn't overflow
+			sw::Rect rect(x, y, (x > INT_MAX - width) ? INT_MAX : x + width, (y > INT_MAX - height) ? INT_MAX : y + height);
+
+			framebuffer->invalidate(numAttachments, attachments, rect);
+		}
 	}
 }
 
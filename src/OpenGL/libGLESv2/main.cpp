@@ -77,15 +77,33 @@ namespace es2
 {
 es2::Context *getContext()
 {
-	egl::Context *context = libEGL->clientGetCurrentContext();
+	// Every GL call needs the current context, so only ask libEGL again after some thread's current context changed
+	static const std::atomic<unsigned int> *currentContextSerial = libEGL->clientCurrentContextSerial;
+	thread_local es2::Context *currentContext = nullptr;
+	thread_local unsigned int currentSerial = 0;
+	thread_local bool cached = false;
 
-	if(context && (context->getClientVersion() == 2 ||
-	               context->getClientVersion() == 3))
+	unsigned int serial = currentContextSerial->load(std::memory_order_relaxed);
+
+	if(!cached || serial != currentSerial)
 	{
-		return static_cast<es2::Context*>(context);
+		egl::Context *context = libEGL->clientGetCurrentContext();
+
+		if(context && (context->getClientVersion() == 2 ||
+		               context->getClientVersion() == 3))
+		{
+			currentContext = static_cast<es2::Context*>(context);
+		}
+		else
+		{
+			currentContext = nullptr;
+		}
+
+		currentSerial = serial;
+		cached = true;
 	}
 
-	return nullptr;
+	return currentContext;
 }
 
 Device *getDevice()
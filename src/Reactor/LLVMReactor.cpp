@@ -27,6 +27,7 @@
 #include "llvm/Target/TargetData.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "../lib/ExecutionEngine/JIT/JIT.h"
 
 #include "LLVMRoutine.hpp"
@@ -36,8 +37,11 @@
 #include "Common/Thread.hpp"
 #include "Common/Memory.hpp"
 #include "Common/MutexLock.hpp"
+#include "Common/Debug.hpp"
+#include "Common/TraceEvents.hpp"
 
 #include <fstream>
+#include <vector>
 
 #if defined(__i386__) || defined(__x86_64__)
 #include <xmmintrin.h>
@@ -64,19 +68,79 @@ namespace llvm
 
 namespace
 {
-	sw::LLVMRoutineManager *routineManager = nullptr;
-	llvm::ExecutionEngine *executionEngine = nullptr;
-	llvm::IRBuilder<> *builder = nullptr;
-	llvm::LLVMContext *context = nullptr;
-	llvm::Module *module = nullptr;
-	llvm::Function *function = nullptr;
-
-	sw::MutexLock codegenMutex;
+	// State of the Nucleus being built on the current thread
+	thread_local sw::LLVMRoutineManager *routineManager = nullptr;
+	thread_local llvm::ExecutionEngine *executionEngine = nullptr;
+	thread_local llvm::IRBuilder<> *builder = nullptr;
+	thread_local llvm::LLVMContext *context = nullptr;
+	thread_local llvm::PassManager *passManager = nullptr;
+	thread_local llvm::Module *module = nullptr;
+	thread_local llvm::Function *function = nullptr;
+	thread_local double creationTime = 0.0;   // For the routine telemetry
+
+	// LLVM contexts can be used concurrently as long as each is only used by one thread at a time.
+	// They are recycled between routines since creating them and their types is not free.
+	struct CodegenContext
+	{
+		llvm::LLVMContext *context;
+		llvm::IRBuilder<> *builder;
+		llvm::PassManager *passManager;   // Created on first use
+	};
+
+	sw::MutexLock codegenContextMutex;
+	std::vector<CodegenContext> codegenContextPool;
+
+	bool initializeLLVM()
+	{
+		llvm::llvm_start_multithreaded();   // Makes LLVM's global state thread safe
+		llvm::InitializeNativeTarget();
+		llvm::JITEmitDebugInfo = false;
+
+		llvm::UnsafeFPMath = true;
+	//	llvm::NoInfsFPMath = true;
+	//	llvm::NoNaNsFPMath = true;
+
+		#if defined(_WIN32)
+			HMODULE CodeAnalyst = LoadLibrary("CAJitNtfyLib.dll");
+			if(CodeAnalyst)
+			{
+				CodeAnalystInitialize = (bool(*)())GetProcAddress(CodeAnalyst, "CAJIT_Initialize");
+				CodeAnalystCompleteJITLog = (void(*)())GetProcAddress(CodeAnalyst, "CAJIT_CompleteJITLog");
+				CodeAnalystLogJITCode = (bool(*)(const void*, unsigned int, const wchar_t*))GetProcAddress(CodeAnalyst, "CAJIT_LogJITCode");
+
+				CodeAnalystInitialize();
+			}
+		#endif
+
+		return true;
+	}
 }
 
 namespace sw
 {
 	Optimization optimization[10] = {InstructionCombining, Disabled};
+	Optimization hotOptimization[10] = {GVN, LICM, InstructionCombining, CFGSimplification, AggressiveDCE, Disabled};
+
+	thread_local OptimizationLevel optimizationLevel = OptimizationDefault;
+
+	static void addPass(llvm::PassManager *passManager, Optimization pass)
+	{
+		switch(pass)
+		{
+		case Disabled:                                                                     break;
+		case CFGSimplification:    passManager->add(llvm::createCFGSimplificationPass());    break;
+		case LICM:                 passManager->add(llvm::createLICMPass());                 break;
+		case AggressiveDCE:        passManager->add(llvm::createAggressiveDCEPass());        break;
+		case GVN:                  passManager->add(llvm::createGVNPass());                  break;
+		case InstructionCombining: passManager->add(llvm::createInstructionCombiningPass()); break;
+		case Reassociate:          passManager->add(llvm::createReassociatePass());          break;
+		case DeadStoreElimination: passManager->add(llvm::createDeadStoreEliminationPass()); break;
+		case SCCP:                 passManager->add(llvm::createSCCPPass());                 break;
+		case ScalarReplAggregates: passManager->add(llvm::createScalarReplAggregatesPass()); break;
+		default:
+			assert(false);
+		}
+	}
 
 	enum EmulatedType
 	{
@@ -181,16 +245,32 @@ namespace sw
 
 	Nucleus::Nucleus()
 	{
-		::codegenMutex.lock();   // Reactor and LLVM are currently not thread safe
+		static bool initialized = initializeLLVM();   // Thread safe static initialization
+		(void)initialized;
 
-		llvm::InitializeNativeTarget();
-		llvm::JITEmitDebugInfo = false;
+		::creationTime = RoutineTelemetry::time();
+
+		ASSERT(!::context);   // Only one Nucleus per thread at a time
 
-		if(!::context)
+		::codegenContextMutex.lock();
+
+		if(::codegenContextPool.empty())
 		{
 			::context = new llvm::LLVMContext();
+			::builder = new llvm::IRBuilder<>(*::context);
+			::passManager = nullptr;
+		}
+		else
+		{
+			CodegenContext &pooled = ::codegenContextPool.back();
+			::context = pooled.context;
+			::builder = pooled.builder;
+			::passManager = pooled.passManager;
+			::codegenContextPool.pop_back();
 		}
 
+		::codegenContextMutex.unlock();
+
 		::module = new llvm::Module("", *::context);
 		::routineManager = new LLVMRoutineManager();
 
@@ -208,27 +288,12 @@ namespace sw
 		MAttrs.push_back(CPUID::supportsSSE3()   ? "+sse3"  : "-sse3");
 		MAttrs.push_back(CPUID::supportsSSSE3()  ? "+ssse3" : "-ssse3");
 		MAttrs.push_back(CPUID::supportsSSE4_1() ? "+sse41" : "-sse41");
+		MAttrs.push_back("-avx");   // The JIT code emitter can't encode VEX prefixes, even when CPUID::supportsAVX()
 
 		std::string error;
 		llvm::TargetMachine *targetMachine = llvm::EngineBuilder::selectTarget(::module, architecture, "", MAttrs, llvm::Reloc::Default, llvm::CodeModel::JITDefault, &error);
-		::executionEngine = llvm::JIT::createJIT(::module, 0, ::routineManager, llvm::CodeGenOpt::Aggressive, true, targetMachine);
-
-		if(!::builder)
-		{
-			::builder = new llvm::IRBuilder<>(*::context);
-
-			#if defined(_WIN32)
-				HMODULE CodeAnalyst = LoadLibrary("CAJitNtfyLib.dll");
-				if(CodeAnalyst)
-				{
-					CodeAnalystInitialize = (bool(*)())GetProcAddress(CodeAnalyst, "CAJIT_Initialize");
-					CodeAnalystCompleteJITLog = (void(*)())GetProcAddress(CodeAnalyst, "CAJIT_CompleteJITLog");
-					CodeAnalystLogJITCode = (bool(*)(const void*, unsigned int, const wchar_t*))GetProcAddress(CodeAnalyst, "CAJIT_LogJITCode");
-
-					CodeAnalystInitialize();
-				}
-			#endif
-		}
+		llvm::CodeGenOpt::Level codeGenLevel = (optimizationLevel == OptimizationQuick) ? llvm::CodeGenOpt::None : llvm::CodeGenOpt::Aggressive;
+		::executionEngine = llvm::JIT::createJIT(::module, 0, ::routineManager, codeGenLevel, true, targetMachine);
 	}
 
 	Nucleus::~Nucleus()
@@ -240,7 +305,15 @@ namespace sw
 		::function = nullptr;
 		::module = nullptr;
 
-		::codegenMutex.unlock();
+		CodegenContext pooled = {::context, ::builder, ::passManager};
+
+		::codegenContextMutex.lock();
+		::codegenContextPool.push_back(pooled);
+		::codegenContextMutex.unlock();
+
+		::context = nullptr;
+		::builder = nullptr;
+		::passManager = nullptr;
 	}
 
 	Routine *Nucleus::acquireRoutine(const wchar_t *name, bool runOptimizations)
@@ -266,11 +339,15 @@ namespace sw
 			::module->print(file, 0);
 		}
 
+		double optimizeStart = RoutineTelemetry::time();
+
 		if(runOptimizations)
 		{
 			optimize();
 		}
 
+		double codegenStart = RoutineTelemetry::time();
+
 		if(false)
 		{
 			std::string error;
@@ -281,6 +358,18 @@ namespace sw
 		void *entry = ::executionEngine->getPointerToFunction(::function);
 		LLVMRoutine *routine = ::routineManager->acquireRoutine(entry);
 
+		if(!routine)   // Its memory couldn't be made executable
+		{
+			return nullptr;
+		}
+
+		RoutineTelemetry::recordCompilation(name, ::creationTime, optimizeStart, codegenStart, RoutineTelemetry::time(), routine->getCodeSize());
+
+		if(TraceEvents::isEnabled())   // Both clocks are steady_clock based
+		{
+			TraceEvents::record(name, "jit", (int64_t)(::creationTime * 1.0e9), TraceEvents::time());
+		}
+
 		if(CodeAnalystLogJITCode)
 		{
 			CodeAnalystLogJITCode(routine->getEntry(), routine->getCodeSize(), name);
@@ -291,40 +380,48 @@ namespace sw
 
 	void Nucleus::optimize()
 	{
-		static llvm::PassManager *passManager = nullptr;
-
-		if(!passManager)
+		if(optimizationLevel == OptimizationQuick)   // Rarely used pass sets aren't worth pooling
 		{
-			passManager = new llvm::PassManager();
+			llvm::PassManager quickPasses;
+			quickPasses.add(new llvm::TargetData(*::executionEngine->getTargetData()));
+			quickPasses.add(llvm::createScalarReplAggregatesPass());
+			quickPasses.run(*::module);
 
-			llvm::UnsafeFPMath = true;
-		//	llvm::NoInfsFPMath = true;
-		//	llvm::NoNaNsFPMath = true;
+			return;
+		}
 
-			passManager->add(new llvm::TargetData(*::executionEngine->getTargetData()));
-			passManager->add(llvm::createScalarReplAggregatesPass());
+		if(!::passManager)
+		{
+			::passManager = new llvm::PassManager();
+
+			::passManager->add(new llvm::TargetData(*::executionEngine->getTargetData()));
+			::passManager->add(llvm::createScalarReplAggregatesPass());
 
 			for(int pass = 0; pass < 10 && optimization[pass] != Disabled; pass++)
 			{
-				switch(optimization[pass])
-				{
-				case Disabled:                                                                       break;
-				case CFGSimplification:    passManager->add(llvm::createCFGSimplificationPass());    break;
-				case LICM:                 passManager->add(llvm::createLICMPass());                 break;
-				case AggressiveDCE:        passManager->add(llvm::createAggressiveDCEPass());        break;
-				case GVN:                  passManager->add(llvm::createGVNPass());                  break;
-				case InstructionCombining: passManager->add(llvm::createInstructionCombiningPass()); break;
-				case Reassociate:          passManager->add(llvm::createReassociatePass());          break;
-				case DeadStoreElimination: passManager->add(llvm::createDeadStoreEliminationPass()); break;
-				case SCCP:                 passManager->add(llvm::createSCCPPass());                 break;
-				case ScalarReplAggregates: passManager->add(llvm::createScalarReplAggregatesPass()); break;
-				default:
-					assert(false);
-				}
+				addPass(::passManager, optimization[pass]);
 			}
 		}
 
-		passManager->run(*::module);
+		::passManager->run(*::module);
+
+		if(optimizationLevel == OptimizationHot)
+		{
+			llvm::PassManager hotPasses;
+			hotPasses.add(new llvm::TargetData(*::executionEngine->getTargetData()));
+
+			for(int pass = 0; pass < 10 && hotOptimization[pass] != Disabled; pass++)
+			{
+				addPass(&hotPasses, hotOptimization[pass]);
+			}
+
+			hotPasses.run(*::module);
+		}
+	}
+
+	void Nucleus::setOptimizationLevel(OptimizationLevel level)
+	{
+		optimizationLevel = level;
 	}
 
 	Value *Nucleus::allocateStackVariable(Type *type, int arraySize)
@@ -5943,6 +6040,33 @@ namespace sw
 		return lhs = lhs - offset;
 	}
 
+	RValue<Float4> Gather(RValue<Pointer<Float>> base, RValue<Int4> offsets)
+	{
+		// None of the targeted instruction sets has gathers, so the lanes are loaded one by one
+		Pointer<Byte> bytes = base;
+		Float4 result;
+
+		for(int i = 0; i < 4; i++)
+		{
+			result = Insert(result, *Pointer<Float>(bytes + Extract(offsets, i)), i);
+		}
+
+		return result;
+	}
+
+	RValue<Int4> Gather(RValue<Pointer<Int>> base, RValue<Int4> offsets)
+	{
+		Pointer<Byte> bytes = base;
+		Int4 result;
+
+		for(int i = 0; i < 4; i++)
+		{
+			result = Insert(result, *Pointer<Int>(bytes + Extract(offsets, i)), i);
+		}
+
+		return result;
+	}
+
 	void Return()
 	{
 		Nucleus::createRetVoid();
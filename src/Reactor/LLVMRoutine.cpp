@@ -25,7 +25,8 @@ namespace sw
 		void *memory = allocateExecutable(bufferSize);
 
 		buffer = memory;
-		entry = memory;
+		code = memory ? executableAddress(memory) : nullptr;
+		entry = code;
 		functionSize = bufferSize;   // Updated by LLVMRoutineManager::endFunctionBody
 	}
 
@@ -41,6 +42,12 @@ namespace sw
 
 	int LLVMRoutine::getCodeSize()
 	{
-		return functionSize - static_cast<int>((uintptr_t)entry - (uintptr_t)buffer);
+		return functionSize - static_cast<int>((uintptr_t)entry - (uintptr_t)code);
+	}
+
+	bool LLVMRoutine::serialize(std::vector<unsigned char> &data)
+	{
+		// LLVMRoutineManager doesn't provide stubs or globals, so the constant pool and code form one block
+		return serializeCode(code, functionSize, (uintptr_t)entry - (uintptr_t)code, data);
 	}
 }
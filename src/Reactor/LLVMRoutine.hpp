@@ -40,8 +40,11 @@ namespace sw
 		int getCodeSize();       // Executable code only
 		//bool isDynamic();
 
+		bool serialize(std::vector<unsigned char> &data) override;
+
 	private:
 		void *buffer;
+		const void *code;   // Where the buffer executes
 		const void *entry;
 		int bufferSize;
 		int functionSize;
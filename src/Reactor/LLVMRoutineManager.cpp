@@ -29,6 +29,7 @@ namespace sw
 	LLVMRoutineManager::LLVMRoutineManager()
 	{
 		routine = nullptr;
+		executable = false;
 	}
 
 	LLVMRoutineManager::~LLVMRoutineManager()
@@ -70,6 +71,7 @@ namespace sw
 
 		delete routine;
 		routine = new LLVMRoutine(static_cast<int>(actualSize));
+		executable = false;
 
 		return (uint8_t*)routine->buffer;
 	}
@@ -128,7 +130,12 @@ namespace sw
 
 	void LLVMRoutineManager::setMemoryExecutable()
 	{
-		markExecutable(routine->buffer, routine->bufferSize);
+		// The size estimate is rounded up generously, so return what wasn't used to the executable memory pool
+		shrinkExecutable(routine->buffer, routine->functionSize);
+		routine->bufferSize = routine->functionSize;
+
+		Routine::rebaseCode(routine->buffer, routine->bufferSize, routine->code);
+		executable = markExecutable(routine->buffer, routine->bufferSize);
 	}
 
 	void LLVMRoutineManager::setPoisonMemory(bool poison)
@@ -138,7 +145,15 @@ namespace sw
 
 	LLVMRoutine *LLVMRoutineManager::acquireRoutine(void *entry)
 	{
-		routine->entry = entry;
+		if(!executable)
+		{
+			delete routine;
+			routine = nullptr;
+
+			return nullptr;
+		}
+
+		routine->entry = (const uint8_t*)routine->code + ((uint8_t*)entry - (uint8_t*)routine->buffer);   // Written to the buffer, runs from its executable address
 
 		LLVMRoutine *result = routine;
 		routine = nullptr;
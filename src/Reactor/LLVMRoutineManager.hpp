@@ -49,6 +49,7 @@ namespace sw
 
 	private:
 		LLVMRoutine *routine;
+		bool executable;   // Whether the routine's memory was made executable
 
 		static volatile int averageInstructionSize;
 	};
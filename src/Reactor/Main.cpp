@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "Reactor.hpp"
+#include "../Common/Memory.hpp"
 
 #include "gtest/gtest.h"
 
@@ -992,6 +993,237 @@ TEST(SubzeroReactorTest, MulAdd)
 	delete routine;
 }
 
+TEST(SubzeroReactorTest, RoutinesSharePages)
+{
+	Routine *routine[2] = {nullptr, nullptr};
+
+	for(int i = 0; i < 2; i++)
+	{
+		Function<Int(Int)> function;
+		{
+			Int x = function.Arg<0>();
+			Return(x + Int(i + 1));
+		}
+
+		routine[i] = function(L"small");
+	}
+
+	if(routine[0] && routine[1])
+	{
+		int(*callable0)(int) = (int(*)(int))routine[0]->getEntry();
+		int(*callable1)(int) = (int(*)(int))routine[1]->getEntry();
+
+		EXPECT_EQ(callable0(10), 11);
+		EXPECT_EQ(callable1(10), 12);
+
+		#if defined(__linux__) && defined(__x86_64__)
+			// Where the executable memory is mapped twice, small routines are packed instead of getting whole pages
+			uintptr_t page = memoryPageSize();
+			EXPECT_EQ((uintptr_t)routine[0]->getEntry() / page, (uintptr_t)routine[1]->getEntry() / page);
+		#endif
+	}
+
+	delete routine[0];
+	delete routine[1];
+}
+
+int referenceNestedLoops(int a, int b)
+{
+	int x = 0;
+
+	for(int i = 0; i < 5; i++)
+	{
+		for(int j = 0; j < 7; j++)
+		{
+			x += a * b + (a << 2) + i * (b + 3) + j;
+			x ^= a * b;
+		}
+
+		x -= (b << 1) + i;
+	}
+
+	return x;
+}
+
+TEST(SubzeroReactorTest, LoopInvariantsNestedLoops)
+{
+	Routine *routine = nullptr;
+
+	{
+		Function<Int(Int, Int)> function;
+		{
+			// Values instead of variables, which would be reloaded inside the loops
+			RValue<Int> a = Int(function.Arg<0>());
+			RValue<Int> b = Int(function.Arg<1>());
+			Int x = 0;
+
+			For(Int i = 0, i < 5, i++)
+			{
+				For(Int j = 0, j < 7, j++)
+				{
+					x += a * b + (a << 2) + i * (b + 3) + j;
+					x ^= a * b;
+				}
+
+				x -= (b << 1) + i;
+			}
+
+			Return(x);
+		}
+
+		routine = function(L"one");
+
+		if(routine)
+		{
+			int(*callable)(int, int) = (int(*)(int, int))routine->getEntry();
+
+			EXPECT_EQ(callable(3, 5), referenceNestedLoops(3, 5));
+			EXPECT_EQ(callable(-7, 11), referenceNestedLoops(-7, 11));
+			EXPECT_EQ(callable(0, 0), referenceNestedLoops(0, 0));
+		}
+	}
+
+	delete routine;
+}
+
+int referenceSeveralExits(const int *p, int n, int key)
+{
+	for(int i = 0; i < n; i++)
+	{
+		int invariant = key * 3 + n;
+
+		if(p[i] == key)
+		{
+			return i * invariant;
+		}
+
+		if(p[i] > invariant)
+		{
+			return -invariant - i;
+		}
+	}
+
+	return n * key + 1;
+}
+
+TEST(SubzeroReactorTest, LoopInvariantsSeveralExits)
+{
+	Routine *routine = nullptr;
+
+	{
+		Function<Int(Pointer<Int>, Int, Int)> function;
+		{
+			Pointer<Int> p = function.Arg<0>();
+			RValue<Int> n = Int(function.Arg<1>());
+			RValue<Int> key = Int(function.Arg<2>());
+
+			For(Int i = 0, i < n, i++)
+			{
+				Int invariant = key * 3 + n;
+
+				If(p[i] == key)
+				{
+					Return(i * invariant);
+				}
+
+				If(p[i] > invariant)
+				{
+					Return(-invariant - i);
+				}
+			}
+
+			Return(n * key + 1);
+		}
+
+		routine = function(L"one");
+
+		if(routine)
+		{
+			int(*callable)(int*, int, int) = (int(*)(int*, int, int))routine->getEntry();
+			int data[6] = {1, 2, 3, 4, 50, 6};
+
+			EXPECT_EQ(callable(data, 6, 3), referenceSeveralExits(data, 6, 3));     // Found
+			EXPECT_EQ(callable(data, 6, 5), referenceSeveralExits(data, 6, 5));     // Exceeded
+			EXPECT_EQ(callable(data, 4, 20), referenceSeveralExits(data, 4, 20));   // Exhausted
+			EXPECT_EQ(callable(data, 0, 1), referenceSeveralExits(data, 0, 1));     // Never entered
+		}
+	}
+
+	delete routine;
+}
+
+int referenceConditionalInvariants(int n, int a, int d)
+{
+	int x = 0;
+
+	for(int i = 0; i < n; i++)
+	{
+		if(d != 0)
+		{
+			x += a / d + a % d;
+		}
+		else
+		{
+			x += a * a + i;
+		}
+
+		if(i > 2)
+		{
+			x += (a ^ d) << 1;
+		}
+	}
+
+	return x;
+}
+
+TEST(SubzeroReactorTest, LoopInvariantsConditional)
+{
+	Routine *routine = nullptr;
+
+	{
+		Function<Int(Int, Int, Int)> function;
+		{
+			RValue<Int> n = Int(function.Arg<0>());
+			RValue<Int> a = Int(function.Arg<1>());
+			RValue<Int> d = Int(function.Arg<2>());
+			Int x = 0;
+
+			For(Int i = 0, i < n, i++)
+			{
+				If(d != 0)
+				{
+					x += a / d + a % d;   // Can't be hoisted, it would divide by zero when d is
+				}
+				Else
+				{
+					x += a * a + i;
+				}
+
+				If(i > 2)
+				{
+					x += (a ^ d) << 1;
+				}
+			}
+
+			Return(x);
+		}
+
+		routine = function(L"one");
+
+		if(routine)
+		{
+			int(*callable)(int, int, int) = (int(*)(int, int, int))routine->getEntry();
+
+			EXPECT_EQ(callable(6, 17, 5), referenceConditionalInvariants(6, 17, 5));
+			EXPECT_EQ(callable(6, 17, 0), referenceConditionalInvariants(6, 17, 0));
+			EXPECT_EQ(callable(0, 17, 0), referenceConditionalInvariants(0, 17, 0));
+			EXPECT_EQ(callable(2, -9, 4), referenceConditionalInvariants(2, -9, 4));
+		}
+	}
+
+	delete routine;
+}
+
 int main(int argc, char **argv)
 {
 	::testing::InitGoogleTest(&argc, argv);
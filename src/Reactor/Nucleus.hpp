@@ -45,6 +45,14 @@ namespace sw
 	};
 
 	extern Optimization optimization[10];
+	extern Optimization hotOptimization[10];   // Additional passes for routines recompiled because they're used often
+
+	enum OptimizationLevel
+	{
+		OptimizationQuick,     // Only promotes variables to registers, with the fastest instruction selection
+		OptimizationDefault,   // The passes configured in optimization[]
+		OptimizationHot,       // Followed by the hotOptimization[] passes
+	};
 
 	class Nucleus
 	{
@@ -55,6 +63,8 @@ namespace sw
 
 		Routine *acquireRoutine(const wchar_t *name, bool runOptimizations = true);
 
+		static void setOptimizationLevel(OptimizationLevel level);   // Of the routines subsequently created by the calling thread
+
 		static Value *allocateStackVariable(Type *type, int arraySize = 0);
 		static BasicBlock *createBasicBlock();
 		static BasicBlock *getInsertBlock();
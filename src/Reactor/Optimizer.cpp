@@ -17,6 +17,8 @@
 #include "src/IceCfg.h"
 #include "src/IceCfgNode.h"
 
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 namespace
@@ -32,6 +34,8 @@ namespace
 		void eliminateUnitializedLoads();
 		void eliminateLoadsFollowingSingleStore();
 		void optimizeStoresInSingleBasicBlock();
+		void hoistLoopInvariants();
+		void eliminateCommonSubexpressions();
 
 		void replace(Ice::Inst *instruction, Ice::Operand *newValue);
 		void deleteInstruction(Ice::Inst *instruction);
@@ -46,6 +50,8 @@ namespace
 		static Ice::Operand *storeData(const Ice::Inst *instruction);
 		static std::size_t storeSize(const Ice::Inst *instruction);
 		static bool loadTypeMatchesStore(const Ice::Inst *load, const Ice::Inst *store);
+		static bool isPure(const Ice::Inst *instruction);
+		static bool mayTrap(const Ice::Inst *instruction);
 
 		Ice::Cfg *function;
 		Ice::GlobalContext *context;
@@ -103,6 +109,8 @@ namespace
 		eliminateLoadsFollowingSingleStore();
 		optimizeStoresInSingleBasicBlock();
 		eliminateDeadCode();
+		hoistLoopInvariants();
+		eliminateCommonSubexpressions();
 
 		for(auto uses : allocatedUses)
 		{
@@ -427,6 +435,326 @@ namespace
 		}
 	}
 
+	void Optimizer::hoistLoopInvariants()
+	{
+		// Reactor doesn't compute the edges of the nodes, so they're derived from the terminators
+		const Ice::NodeList &nodes = function->getNodes();
+		const size_t count = nodes.size();
+		std::vector<std::vector<Ice::SizeT>> successors(count);
+		std::vector<std::vector<Ice::SizeT>> predecessors(count);
+
+		for(Ice::CfgNode *node : nodes)
+		{
+			if(node->getInsts().empty())
+			{
+				continue;
+			}
+
+			for(Ice::CfgNode *successor : node->getInsts().rbegin()->getTerminatorEdges())
+			{
+				successors[node->getIndex()].push_back(successor->getIndex());
+				predecessors[successor->getIndex()].push_back(node->getIndex());
+			}
+		}
+
+		// Depth-first order of the reachable nodes
+		const Ice::SizeT entry = function->getEntryNode()->getIndex();
+		std::vector<Ice::SizeT> postorder;
+		std::vector<int> order(count, -1);
+		std::vector<std::pair<Ice::SizeT, size_t>> stack(1, std::make_pair(entry, (size_t)0));
+		order[entry] = 0;
+
+		while(!stack.empty())
+		{
+			Ice::SizeT node = stack.back().first;
+			size_t next = stack.back().second++;
+
+			if(next < successors[node].size())
+			{
+				Ice::SizeT successor = successors[node][next];
+
+				if(order[successor] == -1)
+				{
+					order[successor] = 0;
+					stack.push_back(std::make_pair(successor, (size_t)0));
+				}
+			}
+			else
+			{
+				order[node] = static_cast<int>(postorder.size());
+				postorder.push_back(node);
+				stack.pop_back();
+			}
+		}
+
+		// Immediate dominators (Cooper, Harvey and Kennedy)
+		std::vector<int> dominator(count, -1);
+		dominator[entry] = static_cast<int>(entry);
+
+		for(bool changed = true; changed;)
+		{
+			changed = false;
+
+			for(auto node = postorder.rbegin(); node != postorder.rend(); node++)
+			{
+				if(*node == entry)
+				{
+					continue;
+				}
+
+				int idom = -1;
+
+				for(Ice::SizeT predecessor : predecessors[*node])
+				{
+					if(dominator[predecessor] == -1)
+					{
+						continue;   // Unreachable or not processed yet
+					}
+
+					int other = static_cast<int>(predecessor);
+
+					while(idom != -1 && idom != other)
+					{
+						while(order[other] < order[idom]) other = dominator[other];
+						while(order[idom] < order[other]) idom = dominator[idom];
+					}
+
+					idom = other;
+				}
+
+				if(dominator[*node] != idom)
+				{
+					dominator[*node] = idom;
+					changed = true;
+				}
+			}
+		}
+
+		auto dominates = [&](Ice::SizeT a, Ice::SizeT b)
+		{
+			for(int node = static_cast<int>(b); ; node = dominator[node])
+			{
+				if(node == static_cast<int>(a)) return true;
+				if(node == static_cast<int>(entry) || node == -1) return false;
+			}
+		};
+
+		// Natural loops, combining the ones which share a header
+		std::unordered_map<Ice::SizeT, std::vector<bool>> loops;
+
+		for(Ice::SizeT node : postorder)
+		{
+			for(Ice::SizeT header : successors[node])
+			{
+				if(!dominates(header, node))
+				{
+					continue;
+				}
+
+				std::vector<bool> &body = loops[header];
+				body.resize(count, false);
+				body[header] = true;
+
+				std::vector<Ice::SizeT> pending(1, node);
+
+				while(!pending.empty())
+				{
+					Ice::SizeT member = pending.back();
+					pending.pop_back();
+
+					if(!body[member])
+					{
+						body[member] = true;
+						pending.insert(pending.end(), predecessors[member].begin(), predecessors[member].end());
+					}
+				}
+			}
+		}
+
+		// Inner loops first, so their invariants can move further out
+		std::vector<std::pair<size_t, Ice::SizeT>> bySize;
+
+		for(auto &loop : loops)
+		{
+			bySize.push_back(std::make_pair((size_t)std::count(loop.second.begin(), loop.second.end(), true), loop.first));
+		}
+
+		std::sort(bySize.begin(), bySize.end());
+		bool hoisted = false;
+
+		for(auto &loop : bySize)
+		{
+			Ice::SizeT header = loop.second;
+			const std::vector<bool> &body = loops[header];
+			Ice::CfgNode *preheader = nullptr;
+
+			for(Ice::SizeT predecessor : predecessors[header])
+			{
+				if(!body[predecessor])
+				{
+					if(preheader)
+					{
+						preheader = nullptr;   // Entered from several places
+						break;
+					}
+
+					preheader = nodes[predecessor];
+				}
+			}
+
+			if(!preheader || dominator[header] != static_cast<int>(preheader->getIndex()))
+			{
+				continue;
+			}
+
+			Ice::InstList &preheaderInsts = preheader->getInsts();
+
+			for(bool changed = true; changed;)
+			{
+				changed = false;
+
+				for(Ice::SizeT index = 0; index < count; index++)
+				{
+					if(!body[index])
+					{
+						continue;
+					}
+
+					Ice::CfgNode *node = nodes[index];
+					std::vector<Ice::Inst*> instructions;
+
+					for(Ice::Inst &instruction : node->getInsts())
+					{
+						instructions.push_back(&instruction);
+					}
+
+					for(Ice::Inst *instruction : instructions)
+					{
+						if(instruction->isDeleted() || !isPure(instruction) || mayTrap(instruction))
+						{
+							continue;
+						}
+
+						bool invariant = true;
+
+						for(Ice::SizeT i = 0; i < instruction->getSrcSize() && invariant; i++)
+						{
+							if(Ice::Variable *source = llvm::dyn_cast<Ice::Variable>(instruction->getSrc(i)))
+							{
+								Ice::Inst *definition = getDefinition(source);
+
+								if(definition && body[getNode(definition)->getIndex()])
+								{
+									invariant = false;
+								}
+							}
+						}
+
+						if(invariant)
+						{
+							node->getInsts().remove(instruction);
+							preheaderInsts.insert(std::prev(preheaderInsts.end()), instruction);
+							setNode(instruction, preheader);
+							changed = true;
+							hoisted = true;
+						}
+					}
+				}
+			}
+		}
+
+		if(hoisted)
+		{
+			// Hoisted values are live across basic blocks, which liveness analysis only follows along edges
+			function->computeInOutEdges();
+		}
+	}
+
+	void Optimizer::eliminateCommonSubexpressions()
+	{
+		// Reactor assigns each variable once, so within a basic block the first of two instructions
+		// performing the same operation on the same operands already holds the result
+		struct Hash
+		{
+			size_t operator()(const std::vector<uintptr_t> &key) const
+			{
+				size_t hash = 0;
+
+				for(uintptr_t value : key)
+				{
+					hash = (hash ^ value) * 0x01000193;
+				}
+
+				return hash;
+			}
+		};
+
+		std::unordered_map<std::vector<uintptr_t>, Ice::Variable*, Hash> available;
+		std::vector<uintptr_t> key;
+
+		for(Ice::CfgNode *basicBlock : function->getNodes())
+		{
+			available.clear();
+
+			for(Ice::Inst &instruction : basicBlock->getInsts())
+			{
+				if(instruction.isDeleted() || !isPure(&instruction))
+				{
+					continue;
+				}
+
+				key.clear();
+				key.push_back(instruction.getKind());
+				key.push_back(instruction.getDest()->getType());
+
+				for(Ice::SizeT i = 0; i < instruction.getSrcSize(); i++)
+				{
+					key.push_back(reinterpret_cast<uintptr_t>(instruction.getSrc(i)));
+				}
+
+				if(auto *arithmetic = llvm::dyn_cast<Ice::InstArithmetic>(&instruction))
+				{
+					key.push_back(arithmetic->getOp());
+
+					if(arithmetic->isCommutative() && key[2] > key[3])
+					{
+						std::swap(key[2], key[3]);
+					}
+				}
+				else if(auto *cast = llvm::dyn_cast<Ice::InstCast>(&instruction))
+				{
+					key.push_back(cast->getCastKind());
+				}
+				else if(auto *icmp = llvm::dyn_cast<Ice::InstIcmp>(&instruction))
+				{
+					key.push_back(icmp->getCondition());
+				}
+				else if(auto *fcmp = llvm::dyn_cast<Ice::InstFcmp>(&instruction))
+				{
+					key.push_back(fcmp->getCondition());
+				}
+				else if(auto *shuffle = llvm::dyn_cast<Ice::InstShuffleVector>(&instruction))
+				{
+					for(Ice::SizeT i = 0; i < shuffle->getNumIndexes(); i++)
+					{
+						key.push_back(reinterpret_cast<uintptr_t>(shuffle->getIndex(i)));
+					}
+				}
+
+				auto existing = available.find(key);
+
+				if(existing != available.end())
+				{
+					replace(&instruction, existing->second);
+				}
+				else
+				{
+					available[key] = instruction.getDest();
+				}
+			}
+		}
+	}
+
 	void Optimizer::analyzeUses(Ice::Cfg *function)
 	{
 		for(Ice::CfgNode *basicBlock : function->getNodes())
@@ -707,6 +1035,43 @@ namespace
 		return false;
 	}
 
+	bool Optimizer::isPure(const Ice::Inst *instruction)
+	{
+		switch(instruction->getKind())
+		{
+		case Ice::Inst::Arithmetic:
+		case Ice::Inst::Cast:
+		case Ice::Inst::ExtractElement:
+		case Ice::Inst::Fcmp:
+		case Ice::Inst::Icmp:
+		case Ice::Inst::InsertElement:
+		case Ice::Inst::Select:
+		case Ice::Inst::ShuffleVector:
+			return instruction->getDest() != nullptr;
+		default:
+			return false;
+		}
+	}
+
+	bool Optimizer::mayTrap(const Ice::Inst *instruction)
+	{
+		if(auto *arithmetic = llvm::dyn_cast<Ice::InstArithmetic>(instruction))
+		{
+			switch(arithmetic->getOp())
+			{
+			case Ice::InstArithmetic::Udiv:
+			case Ice::InstArithmetic::Sdiv:
+			case Ice::InstArithmetic::Urem:
+			case Ice::InstArithmetic::Srem:
+				return true;   // Division by zero
+			default:
+				return false;
+			}
+		}
+
+		return false;
+	}
+
 	Optimizer::Uses* Optimizer::getUses(Ice::Operand* operand)
 	{
 		Optimizer::Uses* uses = (Optimizer::Uses*)operand->Ice::Operand::getExternalData();
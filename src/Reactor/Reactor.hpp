@@ -2184,6 +2184,10 @@ namespace sw
 	RValue<Pointer<Byte>> operator-=(Pointer<Byte> &lhs, RValue<Int> offset);
 	RValue<Pointer<Byte>> operator-=(Pointer<Byte> &lhs, RValue<UInt> offset);
 
+	// Loads the element at each lane's byte offset from the base
+	RValue<Float4> Gather(RValue<Pointer<Float>> base, RValue<Int4> offsets);
+	RValue<Int4> Gather(RValue<Pointer<Int>> base, RValue<Int4> offsets);
+
 	template<class T, int S = 1>
 	class Array : public LValue<T>
 	{
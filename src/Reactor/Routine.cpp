@@ -14,12 +14,156 @@
 
 #include "Routine.hpp"
 
+#include "../Common/Memory.hpp"
 #include "../Common/Thread.hpp"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+	#include <dlfcn.h>
+#endif
 
 namespace sw
 {
+	namespace
+	{
+		// Header of a serialized routine, followed by the fixup offsets and the code
+		struct SerializedRoutine
+		{
+			uint64_t base;          // Address of the code when it was serialized
+			uint32_t codeSize;
+			uint32_t entryOffset;
+			uint32_t fixupCount;    // Absolute addresses within the code, rebased when loaded
+			uint32_t reserved;
+		};
+
+		bool isModuleAddress(uint64_t address)
+		{
+			if(address < 0x10000 || address != (uintptr_t)address)
+			{
+				return false;
+			}
+
+			#if defined(_WIN32)
+				MEMORY_BASIC_INFORMATION info;
+				return VirtualQuery((void*)(uintptr_t)address, &info, sizeof(info)) == sizeof(info) && info.Type == MEM_IMAGE;
+			#else
+				Dl_info info;
+				return dladdr((void*)(uintptr_t)address, &info) != 0;
+			#endif
+		}
+
+		// Copies the code into executable memory, rebasing its absolute addresses. Returns null on failure.
+		void *loadCode(const unsigned char *code, size_t codeSize, uint64_t base, const uint32_t *fixup, size_t fixupCount)
+		{
+			void *buffer = allocateExecutable(codeSize);
+
+			if(!buffer)
+			{
+				return nullptr;
+			}
+
+			memcpy(buffer, code, codeSize);
+			uintptr_t executable = (uintptr_t)executableAddress(buffer);
+
+			for(size_t i = 0; i < fixupCount; i++)
+			{
+				uint64_t address;
+				memcpy(&address, (unsigned char*)buffer + fixup[i], sizeof(address));
+				address = address - base + executable;
+				memcpy((unsigned char*)buffer + fixup[i], &address, sizeof(address));
+			}
+
+			if(!markExecutable(buffer, codeSize))
+			{
+				deallocateExecutable(buffer, codeSize);
+				return nullptr;
+			}
+
+			return buffer;
+		}
+
+		class PrecompiledRoutine : public Routine
+		{
+		public:
+			// Takes ownership of executable memory from loadCode()
+			PrecompiledRoutine(void *buffer, size_t codeSize, size_t entryOffset)
+				: buffer(buffer), codeSize(codeSize), entryOffset(entryOffset)
+			{
+				code = static_cast<const unsigned char*>(executableAddress(buffer));
+			}
+
+			// Executes the code where it is
+			PrecompiledRoutine(const unsigned char *code, size_t codeSize, size_t entryOffset, const std::shared_ptr<const void> &image)
+				: codeSize(codeSize), entryOffset(entryOffset), image(image)
+			{
+				buffer = const_cast<unsigned char*>(code);
+				this->code = code;
+			}
+
+			~PrecompiledRoutine() override
+			{
+				if(!image)
+				{
+					deallocateExecutable(buffer, codeSize);
+				}
+			}
+
+			const void *getEntry() override
+			{
+				return code + entryOffset;
+			}
+
+			bool serialize(std::vector<unsigned char> &data) override
+			{
+				return serializeCode(code, codeSize, entryOffset, data);
+			}
+
+		private:
+			void *buffer;
+			const unsigned char *code;   // Where the buffer executes
+			const size_t codeSize;
+			const size_t entryOffset;
+			const std::shared_ptr<const void> image;   // Containing the code, when it isn't a copy
+		};
+	}
+
+	namespace
+	{
+		std::mutex telemetryMutex;
+		std::map<std::string, RoutineStatistics> telemetry;
+		FILE *traceFile = nullptr;
+		double traceStart = 0.0;
+
+		RoutineStatistics &statistics(const std::string &kind)
+		{
+			auto entry = telemetry.find(kind);
+
+			if(entry == telemetry.end())
+			{
+				RoutineStatistics empty = {};
+				entry = telemetry.insert(std::make_pair(kind, empty)).first;
+			}
+
+			return entry->second;
+		}
+
+		int traceThreadID()
+		{
+			static std::atomic<int> threadCount(0);
+			thread_local int threadID = ++threadCount;
+
+			return threadID;
+		}
+	}
+
+	volatile bool RoutineTelemetry::enabled = false;
+
 	Routine::Routine()
 	{
 		bindCount = 0;
@@ -44,4 +188,283 @@ namespace sw
 	{
 		assert(bindCount == 0);
 	}
+
+	bool Routine::serialize(std::vector<unsigned char> &data)
+	{
+		return false;
+	}
+
+	bool Routine::serializeCode(const void *code, size_t codeSize, size_t entryOffset, std::vector<unsigned char> &data)
+	{
+		#if defined(__x86_64__) || defined(_M_X64)
+			// Code without stubs or a GOT can only reference other memory through 64-bit immediates and
+			// jump tables. Those pointing into the code itself can be rebased, any others make it unmovable.
+			const unsigned char *bytes = static_cast<const unsigned char*>(code);
+			uint64_t begin = (uintptr_t)code;
+			uint64_t end = begin + codeSize;
+			std::vector<uint32_t> fixup;
+
+			for(size_t i = 0; i + sizeof(uint64_t) <= codeSize; i++)
+			{
+				uint64_t value;
+				memcpy(&value, bytes + i, sizeof(value));
+
+				if(value >= begin && value < end)
+				{
+					fixup.push_back(static_cast<uint32_t>(i));
+					i += sizeof(uint64_t) - 1;
+				}
+				else if(isModuleAddress(value))
+				{
+					return false;
+				}
+			}
+
+			SerializedRoutine header = {begin, static_cast<uint32_t>(codeSize), static_cast<uint32_t>(entryOffset), static_cast<uint32_t>(fixup.size()), 0};
+			size_t fixupSize = fixup.size() * sizeof(uint32_t);
+
+			data.resize(sizeof(header) + fixupSize + codeSize);
+			memcpy(&data[0], &header, sizeof(header));
+			if(fixupSize) memcpy(&data[sizeof(header)], &fixup[0], fixupSize);
+			memcpy(&data[sizeof(header) + fixupSize], code, codeSize);
+
+			return true;
+		#else
+			return false;   // 32-bit x86 and ARM code embed absolute addresses which can't be told apart from constants
+		#endif
+	}
+
+	void Routine::rebaseCode(void *code, size_t codeSize, const void *executable)
+	{
+		if(code == executable)
+		{
+			return;
+		}
+
+		#if defined(__x86_64__) || defined(_M_X64)
+			// Like serializeCode(), takes the 64-bit values pointing into the code to be its own addresses
+			unsigned char *bytes = static_cast<unsigned char*>(code);
+			uint64_t begin = (uintptr_t)code;
+			uint64_t end = begin + codeSize;
+
+			for(size_t i = 0; i + sizeof(uint64_t) <= codeSize; i++)
+			{
+				uint64_t address;
+				memcpy(&address, bytes + i, sizeof(address));
+
+				if(address >= begin && address < end)
+				{
+					address = address - begin + (uintptr_t)executable;
+					memcpy(bytes + i, &address, sizeof(address));
+					i += sizeof(uint64_t) - 1;
+				}
+			}
+		#else
+			assert(false && "Only x86-64 code runs from an alias of the memory it was written to");
+		#endif
+	}
+
+	size_t Routine::codeOffset(const void *data, size_t size)
+	{
+		SerializedRoutine header;
+
+		if(size < sizeof(header))
+		{
+			return 0;
+		}
+
+		memcpy(&header, data, sizeof(header));
+
+		size_t fixupSize = (size_t)header.fixupCount * sizeof(uint32_t);
+
+		if(header.codeSize == 0 || header.entryOffset >= header.codeSize || size != sizeof(header) + fixupSize + header.codeSize)
+		{
+			return 0;
+		}
+
+		return sizeof(header) + fixupSize;
+	}
+
+	void Routine::relocate(std::vector<unsigned char> &data, uint64_t codeAddress)
+	{
+		size_t offset = codeOffset(data.data(), data.size());
+
+		if(offset == 0)
+		{
+			return;
+		}
+
+		SerializedRoutine header;
+		memcpy(&header, &data[0], sizeof(header));
+
+		for(uint32_t i = 0; i < header.fixupCount; i++)
+		{
+			uint32_t fixup;
+			memcpy(&fixup, &data[sizeof(header) + i * sizeof(uint32_t)], sizeof(fixup));
+
+			if(fixup + sizeof(uint64_t) <= header.codeSize)
+			{
+				uint64_t address;
+				memcpy(&address, &data[offset + fixup], sizeof(address));
+				address = address - header.base + codeAddress;
+				memcpy(&data[offset + fixup], &address, sizeof(address));
+			}
+		}
+
+		header.base = codeAddress;
+		memcpy(&data[0], &header, sizeof(header));
+	}
+
+	Routine *Routine::deserialize(const void *data, size_t size, const std::shared_ptr<const void> &image)
+	{
+		size_t offset = codeOffset(data, size);
+
+		if(offset == 0)
+		{
+			return nullptr;
+		}
+
+		SerializedRoutine header;
+		memcpy(&header, data, sizeof(header));
+
+		const unsigned char *code = static_cast<const unsigned char*>(data) + offset;
+
+		if(!image || header.base != (uintptr_t)code)
+		{
+			return deserialize(data, size);
+		}
+
+		return new PrecompiledRoutine(code, header.codeSize, header.entryOffset, image);
+	}
+
+	Routine *Routine::deserialize(const void *data, size_t size)
+	{
+		size_t offset = codeOffset(data, size);
+
+		if(offset == 0)
+		{
+			return nullptr;
+		}
+
+		SerializedRoutine header;
+		memcpy(&header, data, sizeof(header));
+
+		size_t fixupSize = offset - sizeof(header);
+		const unsigned char *bytes = static_cast<const unsigned char*>(data);
+		std::vector<uint32_t> fixup(header.fixupCount);
+		if(fixupSize) memcpy(&fixup[0], bytes + sizeof(header), fixupSize);
+
+		for(uint32_t position : fixup)
+		{
+			if(position + sizeof(uint64_t) > header.codeSize)
+			{
+				return nullptr;
+			}
+		}
+
+		void *buffer = loadCode(bytes + sizeof(header) + fixupSize, header.codeSize, header.base, fixup.data(), fixup.size());
+
+		if(!buffer)
+		{
+			return nullptr;
+		}
+
+		return new PrecompiledRoutine(buffer, header.codeSize, header.entryOffset);
+	}
+
+	void RoutineTelemetry::setEnabled(bool enable, const char *traceFileName)
+	{
+		std::lock_guard<std::mutex> lock(telemetryMutex);
+
+		if(traceFile)
+		{
+			fclose(traceFile);   // The trace format allows leaving the array of events unterminated
+			traceFile = nullptr;
+		}
+
+		if(enable && traceFileName)
+		{
+			traceFile = fopen(traceFileName, "w");
+			traceStart = time();
+
+			if(traceFile)
+			{
+				fputs("[\n", traceFile);
+			}
+		}
+
+		enabled = enable;
+	}
+
+	void RoutineTelemetry::recordCompilation(const wchar_t *name, double start, double optimizeStart, double codegenStart, double end, size_t codeSize)
+	{
+		if(!enabled)
+		{
+			return;
+		}
+
+		std::wstring wideName(name);
+		std::string asciiName(wideName.begin(), wideName.end());
+		std::string kind = asciiName.substr(0, asciiName.find('_'));
+
+		std::lock_guard<std::mutex> lock(telemetryMutex);
+
+		RoutineStatistics &entry = statistics(kind);
+		entry.compilations++;
+		entry.buildTime += optimizeStart - start;
+		entry.optimizeTime += codegenStart - optimizeStart;
+		entry.codegenTime += end - codegenStart;
+		entry.codeSize += codeSize;
+
+		if(traceFile)
+		{
+			writeEvent(asciiName, kind, start, optimizeStart, codegenStart, end, codeSize);
+		}
+	}
+
+	void RoutineTelemetry::recordCacheQuery(const char *kind, bool hit)
+	{
+		if(!enabled)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(telemetryMutex);
+
+		RoutineStatistics &entry = statistics(kind);
+		(hit ? entry.cacheHits : entry.cacheMisses)++;
+	}
+
+	std::map<std::string, RoutineStatistics> RoutineTelemetry::getStatistics()
+	{
+		std::lock_guard<std::mutex> lock(telemetryMutex);
+
+		return telemetry;
+	}
+
+	void RoutineTelemetry::reset()
+	{
+		std::lock_guard<std::mutex> lock(telemetryMutex);
+
+		telemetry.clear();
+	}
+
+	double RoutineTelemetry::time()
+	{
+		using namespace std::chrono;
+
+		return duration<double>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	void RoutineTelemetry::writeEvent(const std::string &name, const std::string &kind, double start, double optimizeStart, double codegenStart, double end, size_t codeSize)
+	{
+		const double microseconds = 1.0e6;
+
+		fprintf(traceFile, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.1f,\"dur\":%.1f,"
+		                   "\"args\":{\"build_us\":%.1f,\"optimize_us\":%.1f,\"codegen_us\":%.1f,\"bytes\":%u}},\n",
+		        name.c_str(), kind.c_str(), traceThreadID(), (start - traceStart) * microseconds, (end - start) * microseconds,
+		        (optimizeStart - start) * microseconds, (codegenStart - optimizeStart) * microseconds, (end - codegenStart) * microseconds,
+		        static_cast<unsigned int>(codeSize));
+		fflush(traceFile);   // Complete up to the last routine when the process doesn't shut down cleanly
+	}
 }
@@ -15,6 +15,13 @@
 #ifndef sw_Routine_hpp
 #define sw_Routine_hpp
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
 namespace sw
 {
 	class Routine
@@ -26,13 +33,63 @@ namespace sw
 
 		virtual const void *getEntry() = 0;
 
+		// Persistent caching. Fails for code which references memory outside of itself.
+		virtual bool serialize(std::vector<unsigned char> &data);
+		static Routine *deserialize(const void *data, size_t size);   // Returns null for invalid data
+
+		// Serialized code relocated for the address it's stored at, in executable memory, runs in place
+		// instead of being copied into memory private to the process. The routine keeps the image referenced.
+		static size_t codeOffset(const void *data, size_t size);   // Returns 0 for invalid data
+		static void relocate(std::vector<unsigned char> &data, uint64_t codeAddress);
+		static Routine *deserialize(const void *data, size_t size, const std::shared_ptr<const void> &image);
+
+		// Rebases the absolute addresses within code written at its current address, to run it from the executable one
+		static void rebaseCode(void *code, size_t codeSize, const void *executable);
+
 		// Reference counting
 		void bind();
 		void unbind();
 
+	protected:
+		static bool serializeCode(const void *code, size_t codeSize, size_t entryOffset, std::vector<unsigned char> &data);
+
 	private:
 		volatile int bindCount;
 	};
+
+	struct RoutineStatistics
+	{
+		int64_t compilations;
+		double buildTime;      // Seconds spent constructing the routine before acquiring it
+		double optimizeTime;
+		double codegenTime;
+		int64_t codeSize;      // Bytes
+		int64_t cacheHits;
+		int64_t cacheMisses;
+	};
+
+	// Compile time, code size and cache use of generated routines, grouped by the routine name up to
+	// the first underscore. Nothing is recorded unless enabled. The trace file uses the Chrome trace
+	// event format, with one event per compiled routine.
+	class RoutineTelemetry
+	{
+	public:
+		static void setEnabled(bool enable, const char *traceFile = nullptr);
+		static bool isEnabled() { return enabled; }
+
+		static void recordCompilation(const wchar_t *name, double start, double optimizeStart, double codegenStart, double end, size_t codeSize);
+		static void recordCacheQuery(const char *kind, bool hit);
+
+		static std::map<std::string, RoutineStatistics> getStatistics();
+		static void reset();
+
+		static double time();   // Seconds, only meaningful relative to each other
+
+	private:
+		static void writeEvent(const std::string &name, const std::string &kind, double start, double optimizeStart, double codegenStart, double end, size_t codeSize);
+
+		static volatile bool enabled;
+	};
 }
 
 #endif   // sw_Routine_hpp
@@ -15,6 +15,8 @@
 #include "Reactor.hpp"
 
 #include "Optimizer.hpp"
+#include "../Common/Memory.hpp"
+#include "../Common/TraceEvents.hpp"
 
 #include "src/IceTypes.h"
 #include "src/IceCfg.h"
@@ -40,30 +42,31 @@
 #define NOMINMAX
 #endif // !NOMINMAX
 #include <Windows.h>
-#else
-#include <sys/mman.h>
-#if !defined(MAP_ANONYMOUS)
-#define MAP_ANONYMOUS MAP_ANON
-#endif
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
 #endif
 
-//#include <mutex>
+#include <mutex>
 #include <limits>
 #include <iostream>
 #include <cassert>
 
 namespace
 {
-	Ice::GlobalContext *context = nullptr;
-	Ice::Cfg *function = nullptr;
-	Ice::CfgNode *basicBlock = nullptr;
-	Ice::CfgLocalAllocatorScope *allocator = nullptr;
-	sw::Routine *routine = nullptr;
-
-	std::mutex codegenMutex;
-
-	Ice::ELFFileStreamer *elfFile = nullptr;
-	Ice::Fdstream *out = nullptr;
+	// State of the Nucleus being built on the current thread
+	thread_local Ice::GlobalContext *context = nullptr;
+	thread_local Ice::Cfg *function = nullptr;
+	thread_local Ice::CfgNode *basicBlock = nullptr;
+	thread_local Ice::CfgLocalAllocatorScope *allocator = nullptr;
+	thread_local sw::Routine *routine = nullptr;
+	thread_local double creationTime = 0.0;   // For the routine telemetry
+
+	// Subzero lazily creates its thread-local storage keys when a GlobalContext is constructed
+	std::mutex contextMutex;
+
+	thread_local Ice::ELFFileStreamer *elfFile = nullptr;
+	thread_local Ice::Fdstream *out = nullptr;
 }
 
 namespace
@@ -196,6 +199,9 @@ namespace sw
 	}
 
 	Optimization optimization[10] = {InstructionCombining, Disabled};
+	Optimization hotOptimization[10] = {Disabled};   // Not applicable to sw::Optimizer
+
+	thread_local OptimizationLevel optimizationLevel = OptimizationDefault;
 
 	using ElfHeader = std::conditional<sizeof(void*) == 8, Elf64_Ehdr, Elf32_Ehdr>::type;
 	using SectionHeader = std::conditional<sizeof(void*) == 8, Elf64_Shdr, Elf32_Shdr>::type;
@@ -210,12 +216,11 @@ namespace sw
 		return &sectionHeader(elfHeader)[index];
 	}
 
-	static void *relocateSymbol(const ElfHeader *elfHeader, const Elf32_Rel &relocation, const SectionHeader &relocationTable)
+	static void *relocateSymbol(const ElfHeader *elfHeader, const Elf32_Rel &relocation, const SectionHeader &relocationTable, intptr_t base)
 	{
 		const SectionHeader *target = elfSection(elfHeader, relocationTable.sh_info);
 
-		intptr_t address = (intptr_t)elfHeader + target->sh_offset;
-		int32_t *patchSite = (int*)(address + relocation.r_offset);
+		int32_t *patchSite = (int*)((intptr_t)elfHeader + target->sh_offset + relocation.r_offset);   // In the image
 		uint32_t index = relocation.getSymbol();
 		int table = relocationTable.sh_link;
 		void *symbolValue = nullptr;
@@ -239,7 +244,7 @@ namespace sw
 			if(section != SHN_UNDEF && section < SHN_LORESERVE)
 			{
 				const SectionHeader *target = elfSection(elfHeader, symbol.st_shndx);
-				symbolValue = reinterpret_cast<void*>((intptr_t)elfHeader + symbol.st_value + target->sh_offset);
+				symbolValue = reinterpret_cast<void*>(base + symbol.st_value + target->sh_offset);
 			}
 			else
 			{
@@ -294,12 +299,12 @@ namespace sw
 		return symbolValue;
 	}
 
-	static void *relocateSymbol(const ElfHeader *elfHeader, const Elf64_Rela &relocation, const SectionHeader &relocationTable)
+	static void *relocateSymbol(const ElfHeader *elfHeader, const Elf64_Rela &relocation, const SectionHeader &relocationTable, intptr_t base)
 	{
 		const SectionHeader *target = elfSection(elfHeader, relocationTable.sh_info);
 
-		intptr_t address = (intptr_t)elfHeader + target->sh_offset;
-		int32_t *patchSite = (int*)(address + relocation.r_offset);
+		int32_t *patchSite = (int*)((intptr_t)elfHeader + target->sh_offset + relocation.r_offset);   // In the image
+		intptr_t address = base + target->sh_offset + relocation.r_offset;   // Where it runs
 		uint32_t index = relocation.getSymbol();
 		int table = relocationTable.sh_link;
 		void *symbolValue = nullptr;
@@ -323,7 +328,7 @@ namespace sw
 			if(section != SHN_UNDEF && section < SHN_LORESERVE)
 			{
 				const SectionHeader *target = elfSection(elfHeader, symbol.st_shndx);
-				symbolValue = reinterpret_cast<void*>((intptr_t)elfHeader + symbol.st_value + target->sh_offset);
+				symbolValue = reinterpret_cast<void*>(base + symbol.st_value + target->sh_offset);
 			}
 			else
 			{
@@ -340,7 +345,7 @@ namespace sw
 			*(int64_t*)patchSite = (int64_t)((intptr_t)symbolValue + *(int64_t*)patchSite) + relocation.r_addend;
 			break;
 		case R_X86_64_PC32:
-			*patchSite = (int32_t)((intptr_t)symbolValue + *patchSite - (intptr_t)patchSite) + relocation.r_addend;
+			*patchSite = (int32_t)((intptr_t)symbolValue + *patchSite - address) + relocation.r_addend;
 			break;
 		case R_X86_64_32S:
 			*patchSite = (int32_t)((intptr_t)symbolValue + *patchSite) + relocation.r_addend;
@@ -353,7 +358,32 @@ namespace sw
 		return symbolValue;
 	}
 
-	void *loadImage(uint8_t *const elfImage, size_t &codeSize)
+	// Range of the image holding the code and constants
+	static void loadedRange(const uint8_t *elfImage, size_t &begin, size_t &end)
+	{
+		const ElfHeader *elfHeader = (const ElfHeader*)elfImage;
+		const SectionHeader *sectionHeader = (const SectionHeader*)(elfImage + elfHeader->e_shoff);
+
+		begin = std::numeric_limits<size_t>::max();
+		end = 0;
+
+		for(int i = 0; i < elfHeader->e_shnum; i++)
+		{
+			if(sectionHeader[i].sh_type == SHT_PROGBITS && (sectionHeader[i].sh_flags & SHF_ALLOC))
+			{
+				begin = std::min(begin, (size_t)sectionHeader[i].sh_offset);
+				end = std::max(end, (size_t)(sectionHeader[i].sh_offset + sectionHeader[i].sh_size));
+			}
+		}
+
+		if(begin > end)
+		{
+			begin = end;
+		}
+	}
+
+	// Applies the relocations within the image, for its sections being copied to base plus their offset
+	void *loadImage(uint8_t *const elfImage, intptr_t base, size_t &codeSize)
 	{
 		ElfHeader *elfHeader = (ElfHeader*)elfImage;
 
@@ -383,7 +413,7 @@ namespace sw
 			{
 				if(sectionHeader[i].sh_flags & SHF_EXECINSTR)
 				{
-					entry = elfImage + sectionHeader[i].sh_offset;
+					entry = reinterpret_cast<void*>(base + sectionHeader[i].sh_offset);
 					codeSize = sectionHeader[i].sh_size;
 				}
 			}
@@ -394,7 +424,7 @@ namespace sw
 				for(Elf32_Word index = 0; index < sectionHeader[i].sh_size / sectionHeader[i].sh_entsize; index++)
 				{
 					const Elf32_Rel &relocation = ((const Elf32_Rel*)(elfImage + sectionHeader[i].sh_offset))[index];
-					relocateSymbol(elfHeader, relocation, sectionHeader[i]);
+					relocateSymbol(elfHeader, relocation, sectionHeader[i], base);
 				}
 			}
 			else if(sectionHeader[i].sh_type == SHT_RELA)
@@ -404,7 +434,7 @@ namespace sw
 				for(Elf32_Word index = 0; index < sectionHeader[i].sh_size / sectionHeader[i].sh_entsize; index++)
 				{
 					const Elf64_Rela &relocation = ((const Elf64_Rela*)(elfImage + sectionHeader[i].sh_offset))[index];
-					relocateSymbol(elfHeader, relocation, sectionHeader[i]);
+					relocateSymbol(elfHeader, relocation, sectionHeader[i], base);
 				}
 			}
 		}
@@ -412,34 +442,6 @@ namespace sw
 		return entry;
 	}
 
-	template<typename T>
-	struct ExecutableAllocator
-	{
-		ExecutableAllocator() {};
-		template<class U> ExecutableAllocator(const ExecutableAllocator<U> &other) {};
-
-		using value_type = T;
-		using size_type = std::size_t;
-
-		T *allocate(size_type n)
-		{
-			#if defined(_WIN32)
-				return (T*)VirtualAlloc(NULL, sizeof(T) * n, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-			#else
-				return (T*)mmap(nullptr, sizeof(T) * n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-			#endif
-		}
-
-		void deallocate(T *p, size_type n)
-		{
-			#if defined(_WIN32)
-				VirtualFree(p, 0, MEM_RELEASE);
-			#else
-				munmap(p, sizeof(T) * n);
-			#endif
-		}
-	};
-
 	class ELFMemoryStreamer : public Ice::ELFStreamer, public Routine
 	{
 		ELFMemoryStreamer(const ELFMemoryStreamer &) = delete;
@@ -450,17 +452,14 @@ namespace sw
 		{
 			position = 0;
 			buffer.reserve(0x1000);
+
+			code = nullptr;
+			codeMemorySize = 0;
 		}
 
 		~ELFMemoryStreamer() override
 		{
-			#if defined(_WIN32)
-				if(buffer.size() != 0)
-				{
-					DWORD exeProtection;
-					VirtualProtect(&buffer[0], buffer.size(), oldProtection, &exeProtection);
-				}
-			#endif
+			sw::deallocateExecutable(code, codeMemorySize);
 		}
 
 		void write8(uint8_t Value) override
@@ -488,6 +487,8 @@ namespace sw
 
 		uint64_t tell() const override { return position; }
 
+		std::size_t getCodeSize() const { return codeMemorySize; }   // Known once loaded by getEntry()
+
 		void seek(uint64_t Off) override { position = Off; }
 
 		const void *getEntry() override
@@ -496,16 +497,41 @@ namespace sw
 			{
 				position = std::numeric_limits<std::size_t>::max();   // Can't stream more data after this
 
+				// Only the code and constants are copied to executable memory, leaving out the ELF headers and tables
+				size_t begin = 0;
+				size_t end = 0;
+				loadedRange(&buffer[0], begin, end);
+
+				codeMemorySize = end - begin;
+				code = sw::allocateExecutable(codeMemorySize);
+
+				if(!code)
+				{
+					return nullptr;
+				}
+
+				// Relocated for the executable address of the memory, before being written to it
+				const void *executable = sw::executableAddress(code);
 				size_t codeSize = 0;
-				entry = loadImage(&buffer[0], codeSize);
+				entry = loadImage(&buffer[0], (intptr_t)executable - (intptr_t)begin, codeSize);
+
+				memcpy(code, &buffer[begin], codeMemorySize);
+
+				if(!sw::markExecutable(code, codeMemorySize))
+				{
+					sw::deallocateExecutable(code, codeMemorySize);
+					code = nullptr;
+					entry = nullptr;
+					return nullptr;
+				}
 
 				#if defined(_WIN32)
-					VirtualProtect(&buffer[0], buffer.size(), PAGE_EXECUTE_READ, &oldProtection);
 					FlushInstructionCache(GetCurrentProcess(), NULL, 0);
 				#else
-					mprotect(&buffer[0], buffer.size(), PROT_READ | PROT_EXEC);
 					__builtin___clear_cache((char*)entry, (char*)entry + codeSize);
 				#endif
+
+				std::vector<uint8_t>().swap(buffer);   // The image is no longer needed
 			}
 
 			return entry;
@@ -513,24 +539,23 @@ namespace sw
 
 	private:
 		void *entry;
-		std::vector<uint8_t, ExecutableAllocator<uint8_t>> buffer;
+		std::vector<uint8_t> buffer;
 		std::size_t position;
 
-		#if defined(_WIN32)
-		DWORD oldProtection;
-		#endif
+		void *code;   // Relocated code and constants
+		std::size_t codeMemorySize;
 	};
 
-	Nucleus::Nucleus()
+	static bool configureFlags()
 	{
-		::codegenMutex.lock();   // Reactor is currently not thread safe
-
 		Ice::ClFlags &Flags = Ice::ClFlags::Flags;
 		Ice::ClFlags::getParsedClFlags(Flags);
 
 		#if defined(__arm__)
 			Flags.setTargetArch(Ice::Target_ARM32);
 			Flags.setTargetInstructionSet(Ice::ARM32InstructionSet_HWDivArm);
+		#elif defined(__aarch64__)
+			#error "Subzero has no AArch64 target, build Reactor with the LLVM back-end"
 		#else   // x86
 			Flags.setTargetArch(sizeof(void*) == 8 ? Ice::Target_X8664 : Ice::Target_X8632);
 			Flags.setTargetInstructionSet(CPUID::SSE4_1 ? Ice::X86InstructionSet_SSE4_1 : Ice::X86InstructionSet_SSE2);
@@ -541,9 +566,21 @@ namespace sw
 		Flags.setVerbose(false ? Ice::IceV_Most : Ice::IceV_None);
 		Flags.setDisableHybridAssembly(true);
 
+		return true;
+	}
+
+	Nucleus::Nucleus()
+	{
+		static bool configured = configureFlags();   // Shared by all threads, so only written once
+		(void)configured;
+
 		static llvm::raw_os_ostream cout(std::cout);
 		static llvm::raw_os_ostream cerr(std::cerr);
 
+		::creationTime = RoutineTelemetry::time();
+
+		std::lock_guard<std::mutex> lock(::contextMutex);
+
 		if(false)   // Write out to a file
 		{
 			std::error_code errorCode;
@@ -570,7 +607,13 @@ namespace sw
 		delete ::elfFile;
 		delete ::out;
 
-		::codegenMutex.unlock();
+		::routine = nullptr;
+		::allocator = nullptr;
+		::function = nullptr;
+		::basicBlock = nullptr;
+		::context = nullptr;
+		::elfFile = nullptr;
+		::out = nullptr;
 	}
 
 	Routine *Nucleus::acquireRoutine(const wchar_t *name, bool runOptimizations)
@@ -584,8 +627,12 @@ namespace sw
 		std::string asciiName(wideName.begin(), wideName.end());
 		::function->setFunctionName(Ice::GlobalString::createWithString(::context, asciiName));
 
+		double optimizeStart = RoutineTelemetry::time();
+
 		optimize();
 
+		double codegenStart = RoutineTelemetry::time();
+
 		::function->translate();
 		assert(!::function->hasError());
 
@@ -611,14 +658,39 @@ namespace sw
 		Routine *handoffRoutine = ::routine;
 		::routine = nullptr;
 
+		if(RoutineTelemetry::isEnabled() && handoffRoutine)
+		{
+			handoffRoutine->getEntry();   // Loads the image, so it counts towards the code generation time
+			size_t codeSize = static_cast<ELFMemoryStreamer*>(handoffRoutine)->getCodeSize();
+
+			RoutineTelemetry::recordCompilation(name, ::creationTime, optimizeStart, codegenStart, RoutineTelemetry::time(), codeSize);
+		}
+
+		if(TraceEvents::isEnabled())   // Both clocks are steady_clock based
+		{
+			TraceEvents::record(name, "jit", (int64_t)(::creationTime * 1.0e9), TraceEvents::time());
+		}
+
 		return handoffRoutine;
 	}
 
 	void Nucleus::optimize()
 	{
+		// The instruction selection level is part of the process wide flags, so only sw::Optimizer is skipped
+		// for quick routines. Hot routines get the same passes as by default.
+		if(optimizationLevel == OptimizationQuick)
+		{
+			return;
+		}
+
 		sw::optimize(::function);
 	}
 
+	void Nucleus::setOptimizationLevel(OptimizationLevel level)
+	{
+		optimizationLevel = level;
+	}
+
 	Value *Nucleus::allocateStackVariable(Type *t, int arraySize)
 	{
 		Ice::Type type = T(t);
@@ -7163,6 +7235,33 @@ namespace sw
 		return lhs = lhs - offset;
 	}
 
+	RValue<Float4> Gather(RValue<Pointer<Float>> base, RValue<Int4> offsets)
+	{
+		// None of the targeted instruction sets has gathers, so the lanes are loaded one by one
+		Pointer<Byte> bytes = base;
+		Float4 result;
+
+		for(int i = 0; i < 4; i++)
+		{
+			result = Insert(result, *Pointer<Float>(bytes + Extract(offsets, i)), i);
+		}
+
+		return result;
+	}
+
+	RValue<Int4> Gather(RValue<Pointer<Int>> base, RValue<Int4> offsets)
+	{
+		Pointer<Byte> bytes = base;
+		Int4 result;
+
+		for(int i = 0; i < 4; i++)
+		{
+			result = Insert(result, *Pointer<Int>(bytes + Extract(offsets, i)), i);
+		}
+
+		return result;
+	}
+
 	void Return()
 	{
 		Nucleus::createRetVoid();
@@ -7183,8 +7282,24 @@ namespace sw
 		Nucleus::setInsertBlock(bodyBB);
 	}
 
+	static int64_t readTicks()
+	{
+		#if defined(_WIN32) || defined(__i386__) || defined(__x86_64__)
+			return __rdtsc();
+		#else
+			return 0;
+		#endif
+	}
+
 	RValue<Long> Ticks()
 	{
-		assert(false && "UNIMPLEMENTED"); return RValue<Long>(V(nullptr));
+		// Subzero has no cycle counter intrinsic, so call into the host
+		Ice::Operand *target = (sizeof(void*) == 8) ? ::context->getConstantInt64(reinterpret_cast<intptr_t>(readTicks)) :
+		                                              ::context->getConstantInt32(reinterpret_cast<intptr_t>(readTicks));
+		Ice::Variable *result = ::function->makeVariable(Ice::IceType_i64);
+		auto call = Ice::InstCall::create(::function, 0, result, target, false);
+		::basicBlock->appendInst(call);
+
+		return RValue<Long>(V(result));
 	}
 }
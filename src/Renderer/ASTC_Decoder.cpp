@@ -0,0 +1,1245 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ASTC_Decoder.hpp"
+
+#include "Common/CPUID.hpp"
+#include "Common/Half.hpp"
+#include "Common/Math.hpp"
+#include "Common/Thread.hpp"
+
+#include <utility>
+
+// Implements the decoding process of the Khronos Data Format Specification, section "ASTC Compressed Texture Image Formats"
+namespace
+{
+	enum
+	{
+		MAX_BLOCK_TEXELS = 12 * 12,
+		MAX_WEIGHTS = 64,
+		MAX_COLOR_VALUES = 18,
+		MAX_DECODE_THREADS = 8,
+		MIN_DECODE_PIXELS = 0x40000,   // Smaller images aren't worth starting threads for
+	};
+
+	struct DecodeBand
+	{
+		const unsigned char *src;
+		unsigned char *dst;
+		int w;
+		int h;
+		int dstW;
+		int dstH;
+		int dstPitch;
+		int xBlockSize;
+		int yBlockSize;
+		bool isSRGB;
+	};
+
+	// Integer sequence encoding ranges, in increasing order of levels
+	struct Range
+	{
+		int levels;
+		int trits;
+		int quints;
+		int bits;
+	};
+
+	const Range ranges[21] =
+	{
+		{2, 0, 0, 1}, {3, 1, 0, 0}, {4, 0, 0, 2}, {5, 0, 1, 0}, {6, 1, 0, 1}, {8, 0, 0, 3}, {10, 0, 1, 1},
+		{12, 1, 0, 2}, {16, 0, 0, 4}, {20, 0, 1, 2}, {24, 1, 0, 3}, {32, 0, 0, 5}, {40, 0, 1, 3}, {48, 1, 0, 4},
+		{64, 0, 0, 6}, {80, 0, 1, 4}, {96, 1, 0, 5}, {128, 0, 0, 7}, {160, 0, 1, 5}, {192, 1, 0, 6}, {256, 0, 0, 8},
+	};
+
+	int sequenceBits(int range, int count)
+	{
+		const Range &r = ranges[range];
+
+		return count * r.bits + (r.trits ? (8 * count + 4) / 5 : 0) + (r.quints ? (7 * count + 2) / 3 : 0);
+	}
+
+	unsigned long long reverseBits(unsigned long long x)
+	{
+		x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+		x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+		x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+		x = ((x >> 8) & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+		x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+
+		return (x >> 32) | (x << 32);
+	}
+
+	// 128 bit block, with bits numbered from the least significant bit of the first byte
+	struct Bits
+	{
+		Bits(const unsigned char *block)
+		{
+			lo = 0;
+			hi = 0;
+
+			for(int i = 7; i >= 0; i--)
+			{
+				lo = (lo << 8) | block[i];
+				hi = (hi << 8) | block[i + 8];
+			}
+		}
+
+		Bits(unsigned long long lo, unsigned long long hi) : lo(lo), hi(hi)
+		{
+		}
+
+		Bits reversed() const
+		{
+			return Bits(reverseBits(hi), reverseBits(lo));
+		}
+
+		unsigned int get(int start, int count) const   // At most 32 bits
+		{
+			if(count <= 0)
+			{
+				return 0;
+			}
+
+			unsigned long long value = (start >= 64) ? (hi >> (start - 64)) : ((lo >> start) | ((start > 0) ? (hi << (64 - start)) : 0));
+
+			return static_cast<unsigned int>(value & ((1ull << count) - 1));
+		}
+
+		unsigned long long lo;
+		unsigned long long hi;
+	};
+
+	// Reads consecutive fields, with bits past the end of the sequence being zero
+	class BitReader
+	{
+	public:
+		BitReader(const Bits &bits, int start, int end) : bits(bits), position(start), end(end)
+		{
+		}
+
+		int read(int count)
+		{
+			int available = sw::clamp(end - position, 0, count);
+			int value = bits.get(position, available);
+			position += count;
+
+			return value;
+		}
+
+	private:
+		const Bits &bits;
+		int position;
+		const int end;
+	};
+
+	void decodeTrits(BitReader &reader, int n, int values[5])
+	{
+		int m0 = reader.read(n);
+		int T = reader.read(2);
+		int m1 = reader.read(n);
+		T |= reader.read(2) << 2;
+		int m2 = reader.read(n);
+		T |= reader.read(1) << 4;
+		int m3 = reader.read(n);
+		T |= reader.read(2) << 5;
+		int m4 = reader.read(n);
+		T |= reader.read(1) << 7;
+
+		int C;
+		int t[5];
+
+		if(((T >> 2) & 7) == 7)
+		{
+			C = (((T >> 5) & 7) << 2) | (T & 3);
+			t[4] = 2;
+			t[3] = 2;
+		}
+		else
+		{
+			C = T & 0x1F;
+
+			if(((T >> 5) & 3) == 3)
+			{
+				t[4] = 2;
+				t[3] = (T >> 7) & 1;
+			}
+			else
+			{
+				t[4] = (T >> 7) & 1;
+				t[3] = (T >> 5) & 3;
+			}
+		}
+
+		if((C & 3) == 3)
+		{
+			t[2] = 2;
+			t[1] = (C >> 4) & 1;
+			t[0] = (((C >> 3) & 1) << 1) | (((C >> 2) & 1) & ~((C >> 3) & 1));
+		}
+		else if(((C >> 2) & 3) == 3)
+		{
+			t[2] = 2;
+			t[1] = 2;
+			t[0] = C & 3;
+		}
+		else
+		{
+			t[2] = (C >> 4) & 1;
+			t[1] = (C >> 2) & 3;
+			t[0] = (((C >> 1) & 1) << 1) | ((C & 1) & ~((C >> 1) & 1));
+		}
+
+		values[0] = (t[0] << n) | m0;
+		values[1] = (t[1] << n) | m1;
+		values[2] = (t[2] << n) | m2;
+		values[3] = (t[3] << n) | m3;
+		values[4] = (t[4] << n) | m4;
+	}
+
+	void decodeQuints(BitReader &reader, int n, int values[3])
+	{
+		int m0 = reader.read(n);
+		int Q = reader.read(3);
+		int m1 = reader.read(n);
+		Q |= reader.read(2) << 3;
+		int m2 = reader.read(n);
+		Q |= reader.read(2) << 5;
+
+		int q[3];
+
+		if(((Q >> 1) & 3) == 3 && ((Q >> 5) & 3) == 0)
+		{
+			int q0 = Q & 1;
+			q[2] = (q0 << 2) | ((((Q >> 4) & 1) & ~q0) << 1) | (((Q >> 3) & 1) & ~q0);
+			q[1] = 4;
+			q[0] = 4;
+		}
+		else
+		{
+			int C;
+
+			if(((Q >> 1) & 3) == 3)
+			{
+				q[2] = 4;
+				C = (((Q >> 3) & 3) << 3) | ((~(Q >> 5) & 3) << 1) | (Q & 1);
+			}
+			else
+			{
+				q[2] = (Q >> 5) & 3;
+				C = Q & 0x1F;
+			}
+
+			if((C & 7) == 5)
+			{
+				q[1] = 4;
+				q[0] = (C >> 3) & 3;
+			}
+			else
+			{
+				q[1] = (C >> 3) & 3;
+				q[0] = C & 7;
+			}
+		}
+
+		values[0] = (q[0] << n) | m0;
+		values[1] = (q[1] << n) | m1;
+		values[2] = (q[2] << n) | m2;
+	}
+
+	void decodeSequence(const Bits &bits, int start, int range, int count, int *values)
+	{
+		const Range &r = ranges[range];
+		BitReader reader(bits, start, start + sequenceBits(range, count));
+
+		for(int i = 0; i < count;)
+		{
+			if(r.trits)
+			{
+				int group[5];
+				decodeTrits(reader, r.bits, group);
+
+				for(int j = 0; j < 5 && i < count; j++, i++)
+				{
+					values[i] = group[j];
+				}
+			}
+			else if(r.quints)
+			{
+				int group[3];
+				decodeQuints(reader, r.bits, group);
+
+				for(int j = 0; j < 3 && i < count; j++, i++)
+				{
+					values[i] = group[j];
+				}
+			}
+			else
+			{
+				values[i++] = reader.read(r.bits);
+			}
+		}
+	}
+
+	int replicate(int value, int bits, int targetBits)
+	{
+		int result = 0;
+
+		for(int shift = targetBits - bits; shift > -bits; shift -= bits)
+		{
+			result |= (shift >= 0) ? (value << shift) : (value >> -shift);
+		}
+
+		return result & ((1 << targetBits) - 1);
+	}
+
+	// Maps an endpoint value to 0 to 255
+	int unquantizeColor(int range, int value)
+	{
+		const Range &r = ranges[range];
+		int n = r.bits;
+
+		if(!r.trits && !r.quints)
+		{
+			return replicate(value, n, 8);
+		}
+
+		int D = value >> n;
+		int a = value & 1;
+		int b = (value >> 1) & 1;
+		int c = (value >> 2) & 1;
+		int d = (value >> 3) & 1;
+		int e = (value >> 4) & 1;
+		int f = (value >> 5) & 1;
+
+		int A = a ? 0x1FF : 0;
+		int B = 0;
+		int C = 0;
+
+		if(r.trits)
+		{
+			switch(n)
+			{
+			case 1: C = 204; break;
+			case 2: C = 93; B = b * 0x116; break;
+			case 3: C = 44; B = c * 0x10A + b * 0x85; break;
+			case 4: C = 22; B = d * 0x104 + c * 0x82 + b * 0x41; break;
+			case 5: C = 11; B = e * 0x102 + d * 0x81 + c * 0x40 + b * 0x20; break;
+			case 6: C = 5; B = f * 0x101 + e * 0x80 + d * 0x40 + c * 0x20 + b * 0x10; break;
+			}
+		}
+		else
+		{
+			switch(n)
+			{
+			case 1: C = 113; break;
+			case 2: C = 54; B = b * 0x10C; break;
+			case 3: C = 26; B = c * 0x105 + b * 0x82; break;
+			case 4: C = 13; B = d * 0x102 + c * 0x81 + b * 0x40; break;
+			case 5: C = 6; B = e * 0x101 + d * 0x80 + c * 0x40 + b * 0x20; break;
+			}
+		}
+
+		int T = (D * C + B) ^ A;
+
+		return (A & 0x80) | (T >> 2);
+	}
+
+	// Maps a weight value to 0 to 64
+	int unquantizeWeight(int range, int value)
+	{
+		const Range &r = ranges[range];
+		int n = r.bits;
+		int T;
+
+		if(!r.trits && !r.quints)
+		{
+			T = replicate(value, n, 6);
+		}
+		else if(n == 0)
+		{
+			static const int trits[3] = {0, 32, 63};
+			static const int quints[5] = {0, 16, 32, 47, 63};
+			T = r.trits ? trits[value] : quints[value];
+		}
+		else
+		{
+			int D = value >> n;
+			int a = value & 1;
+			int b = (value >> 1) & 1;
+			int c = (value >> 2) & 1;
+
+			int A = a ? 0x7F : 0;
+			int B = 0;
+			int C = 0;
+
+			if(r.trits)
+			{
+				switch(n)
+				{
+				case 1: C = 50; break;
+				case 2: C = 23; B = b * 0x45; break;
+				case 3: C = 11; B = c * 0x42 + b * 0x21; break;
+				}
+			}
+			else
+			{
+				switch(n)
+				{
+				case 1: C = 28; break;
+				case 2: C = 13; B = b * 0x42; break;
+				}
+			}
+
+			T = (D * C + B) ^ A;
+			T = (A & 0x20) | (T >> 2);
+		}
+
+		return (T > 32) ? T + 1 : T;
+	}
+
+	unsigned int hash52(unsigned int p)
+	{
+		p ^= p >> 15;
+		p -= p << 17;
+		p += p << 7;
+		p += p << 4;
+		p ^= p >> 5;
+		p += p << 16;
+		p ^= p >> 7;
+		p ^= p >> 3;
+		p ^= p << 6;
+		p ^= p >> 17;
+
+		return p;
+	}
+
+	int selectPartition(int seed, int x, int y, int partitions, bool smallBlock)
+	{
+		if(smallBlock)
+		{
+			x <<= 1;
+			y <<= 1;
+		}
+
+		seed += (partitions - 1) * 1024;
+		unsigned int rnum = hash52(seed);
+
+		int seeds[8];
+		for(int i = 0; i < 8; i++)
+		{
+			int s = (rnum >> (4 * i)) & 0xF;
+			seeds[i] = s * s;
+		}
+
+		int sh1, sh2;
+		if(seed & 1)
+		{
+			sh1 = (seed & 2) ? 4 : 5;
+			sh2 = (partitions == 3) ? 6 : 5;
+		}
+		else
+		{
+			sh1 = (partitions == 3) ? 6 : 5;
+			sh2 = (seed & 2) ? 4 : 5;
+		}
+
+		// The z coordinate and its seeds only apply to 3D blocks
+		int a = (((seeds[0] >> sh1) * x + (seeds[1] >> sh2) * y) + (rnum >> 14)) & 0x3F;
+		int b = (((seeds[2] >> sh1) * x + (seeds[3] >> sh2) * y) + (rnum >> 10)) & 0x3F;
+		int c = (((seeds[4] >> sh1) * x + (seeds[5] >> sh2) * y) + (rnum >> 6)) & 0x3F;
+		int d = (((seeds[6] >> sh1) * x + (seeds[7] >> sh2) * y) + (rnum >> 2)) & 0x3F;
+
+		if(partitions < 4) d = 0;
+		if(partitions < 3) c = 0;
+
+		if(a >= b && a >= c && a >= d) return 0;
+		else if(b >= c && b >= d) return 1;
+		else if(c >= d) return 2;
+		else return 3;
+	}
+
+	// Interpolation endpoints of one partition, as 8 bit LDR or 12 bit HDR values
+	struct Endpoints
+	{
+		int e0[4];
+		int e1[4];
+		bool hdr[4];
+
+		void set(int r0, int g0, int b0, int a0, int r1, int g1, int b1, int a1)
+		{
+			e0[0] = sw::clamp(r0, 0, 255); e0[1] = sw::clamp(g0, 0, 255); e0[2] = sw::clamp(b0, 0, 255); e0[3] = sw::clamp(a0, 0, 255);
+			e1[0] = sw::clamp(r1, 0, 255); e1[1] = sw::clamp(g1, 0, 255); e1[2] = sw::clamp(b1, 0, 255); e1[3] = sw::clamp(a1, 0, 255);
+			hdr[0] = hdr[1] = hdr[2] = hdr[3] = false;
+		}
+
+		void setBlueContracted(int r0, int g0, int b0, int a0, int r1, int g1, int b1, int a1)
+		{
+			set((r0 + b0) >> 1, (g0 + b0) >> 1, b0, a0, (r1 + b1) >> 1, (g1 + b1) >> 1, b1, a1);
+		}
+
+		void setHDR(int r0, int g0, int b0, int r1, int g1, int b1)
+		{
+			e0[0] = sw::clamp(r0, 0, 0xFFF); e0[1] = sw::clamp(g0, 0, 0xFFF); e0[2] = sw::clamp(b0, 0, 0xFFF); e0[3] = 0x780;
+			e1[0] = sw::clamp(r1, 0, 0xFFF); e1[1] = sw::clamp(g1, 0, 0xFFF); e1[2] = sw::clamp(b1, 0, 0xFFF); e1[3] = 0x780;
+			hdr[0] = hdr[1] = hdr[2] = hdr[3] = true;
+		}
+	};
+
+	void bitTransferSigned(int &a, int &b)
+	{
+		b >>= 1;
+		b |= a & 0x80;
+		a >>= 1;
+		a &= 0x3F;
+
+		if(a & 0x20)
+		{
+			a -= 0x40;
+		}
+	}
+
+	void decodeHDRLuminanceLargeRange(Endpoints &endpoints, const int *v)
+	{
+		int y0, y1;
+
+		if(v[1] >= v[0])
+		{
+			y0 = v[0] << 4;
+			y1 = v[1] << 4;
+		}
+		else
+		{
+			y0 = (v[1] << 4) + 8;
+			y1 = (v[0] << 4) - 8;
+		}
+
+		endpoints.setHDR(y0, y0, y0, y1, y1, y1);
+	}
+
+	void decodeHDRLuminanceSmallRange(Endpoints &endpoints, const int *v)
+	{
+		int y0, d;
+
+		if(v[0] & 0x80)
+		{
+			y0 = ((v[1] & 0xE0) << 4) | ((v[0] & 0x7F) << 2);
+			d = (v[1] & 0x1F) << 2;
+		}
+		else
+		{
+			y0 = ((v[1] & 0xF0) << 4) | ((v[0] & 0x7F) << 1);
+			d = (v[1] & 0x0F) << 1;
+		}
+
+		int y1 = sw::min(y0 + d, 0xFFF);
+
+		endpoints.setHDR(y0, y0, y0, y1, y1, y1);
+	}
+
+	void decodeHDRRGBBaseScale(Endpoints &endpoints, const int *v)
+	{
+		int modeValue = ((v[0] & 0xC0) >> 6) | ((v[1] & 0x80) >> 5) | ((v[2] & 0x80) >> 4);
+		int majorComponent;
+		int mode;
+
+		if((modeValue & 0xC) != 0xC)
+		{
+			majorComponent = modeValue >> 2;
+			mode = modeValue & 3;
+		}
+		else if(modeValue != 0xF)
+		{
+			majorComponent = modeValue & 3;
+			mode = 4;
+		}
+		else
+		{
+			majorComponent = 0;
+			mode = 5;
+		}
+
+		int red = v[0] & 0x3F;
+		int green = v[1] & 0x1F;
+		int blue = v[2] & 0x1F;
+		int scale = v[3] & 0x1F;
+
+		int x0 = (v[1] >> 6) & 1;
+		int x1 = (v[1] >> 5) & 1;
+		int x2 = (v[2] >> 6) & 1;
+		int x3 = (v[2] >> 5) & 1;
+		int x4 = (v[3] >> 7) & 1;
+		int x5 = (v[3] >> 6) & 1;
+		int x6 = (v[3] >> 5) & 1;
+
+		int ohm = 1 << mode;
+		if(ohm & 0x30) green |= x0 << 6;
+		if(ohm & 0x3A) green |= x1 << 5;
+		if(ohm & 0x30) blue |= x2 << 6;
+		if(ohm & 0x3A) blue |= x3 << 5;
+		if(ohm & 0x3D) scale |= x6 << 5;
+		if(ohm & 0x2D) scale |= x5 << 6;
+		if(ohm & 0x04) scale |= x4 << 7;
+		if(ohm & 0x3B) red |= x4 << 6;
+		if(ohm & 0x04) red |= x3 << 6;
+		if(ohm & 0x10) red |= x5 << 7;
+		if(ohm & 0x0F) red |= x2 << 7;
+		if(ohm & 0x05) red |= x1 << 8;
+		if(ohm & 0x0A) red |= x0 << 8;
+		if(ohm & 0x05) red |= x0 << 9;
+		if(ohm & 0x02) red |= x6 << 9;
+		if(ohm & 0x01) red |= x3 << 10;
+		if(ohm & 0x02) red |= x5 << 10;
+
+		static const int shifts[6] = {1, 1, 2, 3, 4, 5};
+		int shift = shifts[mode];
+		red <<= shift;
+		green <<= shift;
+		blue <<= shift;
+		scale <<= shift;
+
+		if(mode != 5)
+		{
+			green = red - green;
+			blue = red - blue;
+		}
+
+		if(majorComponent == 1) std::swap(red, green);
+		if(majorComponent == 2) std::swap(red, blue);
+
+		endpoints.setHDR(red - scale, green - scale, blue - scale, red, green, blue);
+	}
+
+	void decodeHDRRGB(Endpoints &endpoints, const int *v)
+	{
+		int majorComponent = ((v[4] & 0x80) >> 7) | ((v[5] & 0x80) >> 6);
+
+		if(majorComponent == 3)
+		{
+			endpoints.setHDR(v[0] << 4, v[2] << 4, (v[4] & 0x7F) << 5, v[1] << 4, v[3] << 4, (v[5] & 0x7F) << 5);
+			return;
+		}
+
+		int mode = ((v[1] & 0x80) >> 7) | ((v[2] & 0x80) >> 6) | ((v[3] & 0x80) >> 5);
+		int va = v[0] | ((v[1] & 0x40) << 2);
+		int vb0 = v[2] & 0x3F;
+		int vb1 = v[3] & 0x3F;
+		int vc = v[1] & 0x3F;
+		int vd0 = v[4] & 0x7F;
+		int vd1 = v[5] & 0x7F;
+
+		static const int dBits[8] = {7, 6, 7, 6, 5, 6, 5, 6};
+		int dShift = 32 - dBits[mode];
+		vd0 = static_cast<int>(static_cast<unsigned int>(vd0) << dShift) >> dShift;
+		vd1 = static_cast<int>(static_cast<unsigned int>(vd1) << dShift) >> dShift;
+
+		int x0 = (v[2] >> 6) & 1;
+		int x1 = (v[3] >> 6) & 1;
+		int x2 = (v[4] >> 6) & 1;
+		int x3 = (v[5] >> 6) & 1;
+		int x4 = (v[4] >> 5) & 1;
+		int x5 = (v[5] >> 5) & 1;
+
+		int ohm = 1 << mode;
+		if(ohm & 0xA4) va |= x0 << 9;
+		if(ohm & 0x08) va |= x2 << 9;
+		if(ohm & 0x50) va |= x4 << 9;
+		if(ohm & 0x50) va |= x5 << 10;
+		if(ohm & 0xA0) va |= x1 << 10;
+		if(ohm & 0xC0) va |= x2 << 11;
+		if(ohm & 0x04) vc |= x1 << 6;
+		if(ohm & 0xE8) vc |= x3 << 6;
+		if(ohm & 0x20) vc |= x2 << 7;
+		if(ohm & 0x5B) vb0 |= x0 << 6;
+		if(ohm & 0x5B) vb1 |= x1 << 6;
+		if(ohm & 0x12) vb0 |= x2 << 7;
+		if(ohm & 0x12) vb1 |= x3 << 7;
+
+		int shift = (mode >> 1) ^ 3;
+		va <<= shift;
+		vb0 <<= shift;
+		vb1 <<= shift;
+		vc <<= shift;
+		vd0 *= 1 << shift;
+		vd1 *= 1 << shift;
+
+		int r1 = va;
+		int g1 = va - vb0;
+		int b1 = va - vb1;
+		int r0 = va - vc;
+		int g0 = va - vb0 - vc - vd0;
+		int b0 = va - vb1 - vc - vd1;
+
+		if(majorComponent == 1)
+		{
+			std::swap(r0, g0);
+			std::swap(r1, g1);
+		}
+		else if(majorComponent == 2)
+		{
+			std::swap(r0, b0);
+			std::swap(r1, b1);
+		}
+
+		endpoints.setHDR(r0, g0, b0, r1, g1, b1);
+	}
+
+	void decodeHDRAlpha(Endpoints &endpoints, int v6, int v7)
+	{
+		int mode = ((v6 >> 7) & 1) | ((v7 >> 6) & 2);
+		v6 &= 0x7F;
+		v7 &= 0x7F;
+
+		if(mode == 3)
+		{
+			endpoints.e0[3] = v6 << 5;
+			endpoints.e1[3] = v7 << 5;
+		}
+		else
+		{
+			v6 |= (v7 << (mode + 1)) & 0x780;
+			v7 &= 0x3F >> mode;
+			v7 ^= 0x20 >> mode;
+			v7 -= 0x20 >> mode;
+			v6 <<= 4 - mode;
+			v7 *= 1 << (4 - mode);
+			v7 += v6;
+
+			endpoints.e0[3] = v6;
+			endpoints.e1[3] = sw::clamp(v7, 0, 0xFFF);
+		}
+	}
+
+	bool isHDRMode(int mode)
+	{
+		return mode == 2 || mode == 3 || mode == 7 || mode == 11 || mode == 14 || mode == 15;
+	}
+
+	void decodeEndpoints(Endpoints &endpoints, int mode, const int *v)
+	{
+		switch(mode)
+		{
+		case 0:   // LDR luminance, direct
+			endpoints.set(v[0], v[0], v[0], 0xFF, v[1], v[1], v[1], 0xFF);
+			break;
+		case 1:   // LDR luminance, base+offset
+			{
+				int l0 = (v[0] >> 2) | (v[1] & 0xC0);
+				int l1 = sw::min(l0 + (v[1] & 0x3F), 0xFF);
+				endpoints.set(l0, l0, l0, 0xFF, l1, l1, l1, 0xFF);
+			}
+			break;
+		case 2:   // HDR luminance, large range
+			decodeHDRLuminanceLargeRange(endpoints, v);
+			break;
+		case 3:   // HDR luminance, small range
+			decodeHDRLuminanceSmallRange(endpoints, v);
+			break;
+		case 4:   // LDR luminance+alpha, direct
+			endpoints.set(v[0], v[0], v[0], v[2], v[1], v[1], v[1], v[3]);
+			break;
+		case 5:   // LDR luminance+alpha, base+offset
+			{
+				int v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3];
+				bitTransferSigned(v1, v0);
+				bitTransferSigned(v3, v2);
+				endpoints.set(v0, v0, v0, v2, v0 + v1, v0 + v1, v0 + v1, v2 + v3);
+			}
+			break;
+		case 6:   // LDR RGB, base+scale
+			endpoints.set((v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 0xFF, v[0], v[1], v[2], 0xFF);
+			break;
+		case 7:   // HDR RGB, base+scale
+			decodeHDRRGBBaseScale(endpoints, v);
+			break;
+		case 8:   // LDR RGB, direct
+			if(v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+			{
+				endpoints.set(v[0], v[2], v[4], 0xFF, v[1], v[3], v[5], 0xFF);
+			}
+			else
+			{
+				endpoints.setBlueContracted(v[1], v[3], v[5], 0xFF, v[0], v[2], v[4], 0xFF);
+			}
+			break;
+		case 9:   // LDR RGB, base+offset
+		case 13:   // LDR RGBA, base+offset
+			{
+				int v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3], v4 = v[4], v5 = v[5];
+				int v6 = (mode == 13) ? v[6] : 0xFF;
+				int v7 = 0;
+				bitTransferSigned(v1, v0);
+				bitTransferSigned(v3, v2);
+				bitTransferSigned(v5, v4);
+
+				if(mode == 13)
+				{
+					v7 = v[7];
+					bitTransferSigned(v7, v6);
+				}
+
+				if(v1 + v3 + v5 >= 0)
+				{
+					endpoints.set(v0, v2, v4, v6, v0 + v1, v2 + v3, v4 + v5, v6 + v7);
+				}
+				else
+				{
+					endpoints.setBlueContracted(v0 + v1, v2 + v3, v4 + v5, v6 + v7, v0, v2, v4, v6);
+				}
+			}
+			break;
+		case 10:   // LDR RGB, base+scale plus two alpha
+			endpoints.set((v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4], v[0], v[1], v[2], v[5]);
+			break;
+		case 11:   // HDR RGB, direct
+			decodeHDRRGB(endpoints, v);
+			break;
+		case 12:   // LDR RGBA, direct
+			if(v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+			{
+				endpoints.set(v[0], v[2], v[4], v[6], v[1], v[3], v[5], v[7]);
+			}
+			else
+			{
+				endpoints.setBlueContracted(v[1], v[3], v[5], v[7], v[0], v[2], v[4], v[6]);
+			}
+			break;
+		case 14:   // HDR RGB, direct, plus LDR alpha
+			decodeHDRRGB(endpoints, v);
+			endpoints.e0[3] = v[6];
+			endpoints.e1[3] = v[7];
+			endpoints.hdr[3] = false;
+			break;
+		case 15:   // HDR RGB, direct, plus HDR alpha
+			decodeHDRRGB(endpoints, v);
+			decodeHDRAlpha(endpoints, v[6], v[7]);
+			break;
+		}
+	}
+
+	// Converts a 16 bit logarithmic value to half-precision floating-point
+	unsigned short LNStoFP16(int C)
+	{
+		int E = C >> 11;
+		int M = C & 0x7FF;
+		int Mt;
+
+		if(M < 512)
+		{
+			Mt = 3 * M;
+		}
+		else if(M < 1536)
+		{
+			Mt = 4 * M - 512;
+		}
+		else
+		{
+			Mt = 5 * M - 2048;
+		}
+
+		return static_cast<unsigned short>(sw::min((E << 10) | (Mt >> 3), 0x7BFF));
+	}
+
+	// Decoded texels hold 16 bit UNORM values for LDR components, or half-precision floating-point for HDR components
+	struct Texels
+	{
+		unsigned short texel[MAX_BLOCK_TEXELS][4];
+		bool hdr[MAX_BLOCK_TEXELS][4];
+	};
+
+	void setErrorColor(Texels &texels, int count)
+	{
+		for(int i = 0; i < count; i++)
+		{
+			texels.texel[i][0] = 0xFFFF;
+			texels.texel[i][1] = 0;
+			texels.texel[i][2] = 0xFFFF;
+			texels.texel[i][3] = 0xFFFF;
+			texels.hdr[i][0] = texels.hdr[i][1] = texels.hdr[i][2] = texels.hdr[i][3] = false;
+		}
+	}
+
+	void decodeBlock(const unsigned char *source, Texels &texels, int blockWidth, int blockHeight, bool isSRGB)
+	{
+		const Bits bits(source);
+		const int texelCount = blockWidth * blockHeight;
+
+		int blockMode = bits.get(0, 11);
+
+		if((blockMode & 0x1FF) == 0x1FC)   // Void-extent, a constant color
+		{
+			bool hdr = (blockMode & 0x200) != 0;
+
+			if(bits.get(10, 2) != 3 || (hdr && isSRGB))
+			{
+				setErrorColor(texels, texelCount);
+				return;
+			}
+
+			for(int i = 0; i < texelCount; i++)
+			{
+				for(int c = 0; c < 4; c++)
+				{
+					texels.texel[i][c] = static_cast<unsigned short>(bits.get(64 + 16 * c, 16));
+					texels.hdr[i][c] = hdr;
+				}
+			}
+
+			return;
+		}
+
+		// Weight grid dimensions and quantization
+		int gridWidth, gridHeight;
+		int R;
+		bool highPrecision = (blockMode & 0x200) != 0;
+		bool dualPlane = (blockMode & 0x400) != 0;
+		int A = (blockMode >> 5) & 3;
+
+		if(blockMode & 3)
+		{
+			R = ((blockMode >> 4) & 1) | ((blockMode & 3) << 1);
+			int B = (blockMode >> 7) & 3;
+
+			switch((blockMode >> 2) & 3)
+			{
+			case 0: gridWidth = B + 4; gridHeight = A + 2; break;
+			case 1: gridWidth = B + 8; gridHeight = A + 2; break;
+			case 2: gridWidth = A + 2; gridHeight = B + 8; break;
+			default:
+				if(blockMode & 0x100)
+				{
+					gridWidth = (B & 1) + 2;
+					gridHeight = A + 2;
+				}
+				else
+				{
+					gridWidth = A + 2;
+					gridHeight = (B & 1) + 6;
+				}
+				break;
+			}
+		}
+		else
+		{
+			R = ((blockMode >> 4) & 1) | (((blockMode >> 2) & 3) << 1);
+			int B = (blockMode >> 9) & 3;
+
+			if(((blockMode >> 2) & 3) == 0)
+			{
+				setErrorColor(texels, texelCount);   // Reserved
+				return;
+			}
+
+			switch((blockMode >> 7) & 3)
+			{
+			case 0: gridWidth = 12; gridHeight = A + 2; break;
+			case 1: gridWidth = A + 2; gridHeight = 12; break;
+			case 2:
+				gridWidth = A + 6;
+				gridHeight = B + 6;
+				highPrecision = false;
+				dualPlane = false;
+				break;
+			default:
+				switch((blockMode >> 5) & 3)
+				{
+				case 0: gridWidth = 6; gridHeight = 10; break;
+				case 1: gridWidth = 10; gridHeight = 6; break;
+				default:
+					setErrorColor(texels, texelCount);   // Reserved
+					return;
+				}
+				break;
+			}
+		}
+
+		int weightRange = (R - 2) + (highPrecision ? 6 : 0);
+		int planes = dualPlane ? 2 : 1;
+		int weightCount = gridWidth * gridHeight * planes;
+		int weightBits = sequenceBits(weightRange, weightCount);
+		int partitions = bits.get(11, 2) + 1;
+
+		if(weightCount > MAX_WEIGHTS || weightBits < 24 || weightBits > 96 || gridWidth > blockWidth || gridHeight > blockHeight || (partitions == 4 && dualPlane))
+		{
+			setErrorColor(texels, texelCount);
+			return;
+		}
+
+		// Color endpoint modes
+		int modes[4];
+		int partitionSeed = 0;
+		int colorStart;
+		int extraModeBits = 0;
+
+		if(partitions == 1)
+		{
+			modes[0] = bits.get(13, 4);
+			colorStart = 17;
+		}
+		else
+		{
+			partitionSeed = bits.get(13, 10);
+			colorStart = 29;
+			int modeField = bits.get(23, 6);
+
+			if((modeField & 3) == 0)
+			{
+				for(int i = 0; i < partitions; i++)
+				{
+					modes[i] = modeField >> 2;
+				}
+			}
+			else
+			{
+				extraModeBits = 3 * partitions - 4;
+				int modeBits = modeField | (bits.get(128 - weightBits - extraModeBits, extraModeBits) << 6);
+				int baseClass = (modeBits & 3) - 1;
+
+				for(int i = 0; i < partitions; i++)
+				{
+					int classOffset = (modeBits >> (2 + i)) & 1;
+					int mode = (modeBits >> (2 + partitions + 2 * i)) & 3;
+					modes[i] = ((baseClass + classOffset) << 2) | mode;
+				}
+			}
+		}
+
+		int planeComponent = dualPlane ? bits.get(128 - weightBits - extraModeBits - 2, 2) : -1;
+		int colorBits = 128 - weightBits - extraModeBits - (dualPlane ? 2 : 0) - colorStart;
+		int colorValueCount = 0;
+
+		for(int i = 0; i < partitions; i++)
+		{
+			colorValueCount += ((modes[i] >> 2) + 1) * 2;
+
+			if(isSRGB && isHDRMode(modes[i]))
+			{
+				setErrorColor(texels, texelCount);
+				return;
+			}
+		}
+
+		if(colorValueCount > MAX_COLOR_VALUES)
+		{
+			setErrorColor(texels, texelCount);
+			return;
+		}
+
+		// The color endpoints use the largest range which fits
+		int colorRange = 20;
+		while(colorRange >= 4 && sequenceBits(colorRange, colorValueCount) > colorBits)
+		{
+			colorRange--;
+		}
+
+		if(colorRange < 4)
+		{
+			setErrorColor(texels, texelCount);
+			return;
+		}
+
+		int colorValues[MAX_COLOR_VALUES];
+		decodeSequence(bits, colorStart, colorRange, colorValueCount, colorValues);
+
+		for(int i = 0; i < colorValueCount; i++)
+		{
+			colorValues[i] = unquantizeColor(colorRange, colorValues[i]);
+		}
+
+		Endpoints endpoints[4];
+		const int *v = colorValues;
+
+		for(int i = 0; i < partitions; i++)
+		{
+			decodeEndpoints(endpoints[i], modes[i], v);
+			v += ((modes[i] >> 2) + 1) * 2;
+		}
+
+		// Weights are stored from the most significant bit downwards
+		int weights[MAX_WEIGHTS];
+		decodeSequence(bits.reversed(), 0, weightRange, weightCount, weights);
+
+		for(int i = 0; i < weightCount; i++)
+		{
+			weights[i] = unquantizeWeight(weightRange, weights[i]);
+		}
+
+		int Ds = (1024 + blockWidth / 2) / (blockWidth - 1);
+		int Dt = (1024 + blockHeight / 2) / (blockHeight - 1);
+		bool smallBlock = texelCount < 31;
+
+		for(int t = 0; t < blockHeight; t++)
+		{
+			int gt = (Dt * t * (gridHeight - 1) + 32) >> 6;
+			int jt = gt >> 4;
+			int ft = gt & 0xF;
+
+			for(int s = 0; s < blockWidth; s++)
+			{
+				int gs = (Ds * s * (gridWidth - 1) + 32) >> 6;
+				int js = gs >> 4;
+				int fs = gs & 0xF;
+
+				int w11 = (fs * ft + 8) >> 4;
+				int w10 = ft - w11;
+				int w01 = fs - w11;
+				int w00 = 16 - fs - ft + w11;
+
+				int v0 = js + jt * gridWidth;
+				int v1 = (js + 1 < gridWidth) ? v0 + 1 : v0;
+				int v2 = (jt + 1 < gridHeight) ? v0 + gridWidth : v0;
+				int v3 = (js + 1 < gridWidth) ? v2 + 1 : v2;
+
+				int weight[2];
+				for(int p = 0; p < planes; p++)
+				{
+					weight[p] = (weights[v0 * planes + p] * w00 + weights[v1 * planes + p] * w01 +
+					             weights[v2 * planes + p] * w10 + weights[v3 * planes + p] * w11 + 8) >> 4;
+				}
+
+				const Endpoints &e = endpoints[(partitions > 1) ? selectPartition(partitionSeed, s, t, partitions, smallBlock) : 0];
+				int i = s + t * blockWidth;
+
+				for(int c = 0; c < 4; c++)
+				{
+					int w = weight[(c == planeComponent) ? 1 : 0];
+					int C0, C1;
+
+					if(e.hdr[c])
+					{
+						C0 = e.e0[c] << 4;
+						C1 = e.e1[c] << 4;
+					}
+					else if(isSRGB)
+					{
+						C0 = (e.e0[c] << 8) | 0x80;
+						C1 = (e.e1[c] << 8) | 0x80;
+					}
+					else
+					{
+						C0 = e.e0[c] * 257;
+						C1 = e.e1[c] * 257;
+					}
+
+					int C = (C0 * (64 - w) + C1 * w + 32) >> 6;
+
+					texels.texel[i][c] = e.hdr[c] ? LNStoFP16(C) : static_cast<unsigned short>(C);
+					texels.hdr[i][c] = e.hdr[c];
+				}
+			}
+		}
+	}
+}
+
+// Decodes 2D images to 32 bit float RGBA, or 8 bit sRGB encoded BGRA output
+bool ASTC_Decoder::Decode(const unsigned char* src, unsigned char *dst, int w, int h, int dstW, int dstH, int dstPitch, int dstBpp, int xBlockSize, int yBlockSize, bool isSRGB)
+{
+	if(xBlockSize < 4 || xBlockSize > 12 || yBlockSize < 4 || yBlockSize > 12 || dstBpp != (isSRGB ? 4 : 16))
+	{
+		return false;
+	}
+
+	// Large images are split into bands of block rows, decoded concurrently
+	int blockRows = (h + yBlockSize - 1) / yBlockSize;
+	int threadCount = sw::max(sw::min(sw::min(sw::CPUID::processAffinity(), (int)MAX_DECODE_THREADS), w * h / MIN_DECODE_PIXELS), 1);
+	DecodeBand band[MAX_DECODE_THREADS];
+	sw::Thread *thread[MAX_DECODE_THREADS] = {};
+
+	for(int i = threadCount - 1; i >= 0; i--)
+	{
+		int y0 = yBlockSize * (blockRows * i / threadCount);
+		int y1 = yBlockSize * (blockRows * (i + 1) / threadCount);
+
+		band[i].src = src + (y0 / yBlockSize) * ((w + xBlockSize - 1) / xBlockSize) * 16;
+		band[i].dst = dst + y0 * dstPitch;
+		band[i].w = w;
+		band[i].h = sw::min(y1, h) - y0;
+		band[i].dstW = dstW;
+		band[i].dstH = dstH - y0;
+		band[i].dstPitch = dstPitch;
+		band[i].xBlockSize = xBlockSize;
+		band[i].yBlockSize = yBlockSize;
+		band[i].isSRGB = isSRGB;
+
+		if(i > 0)
+		{
+			thread[i] = new sw::Thread(DecodeTask, &band[i]);
+		}
+	}
+
+	DecodeTask(&band[0]);
+
+	for(int i = 1; i < threadCount; i++)
+	{
+		thread[i]->join();
+		delete thread[i];
+	}
+
+	return true;
+}
+
+void ASTC_Decoder::DecodeTask(void *parameters)
+{
+	const DecodeBand *band = static_cast<const DecodeBand*>(parameters);
+
+	DecodeRows(band->src, band->dst, band->w, band->h, band->dstW, band->dstH, band->dstPitch, band->xBlockSize, band->yBlockSize, band->isSRGB);
+}
+
+void ASTC_Decoder::DecodeRows(const unsigned char* src, unsigned char *dst, int w, int h, int dstW, int dstH, int dstPitch, int xBlockSize, int yBlockSize, bool isSRGB)
+{
+	Texels texels;
+
+	for(int y = 0; y < h; y += yBlockSize)
+	{
+		int rows = sw::min(sw::min(yBlockSize, h - y), dstH - y);
+
+		for(int x = 0; x < w; x += xBlockSize, src += 16)
+		{
+			decodeBlock(src, texels, xBlockSize, yBlockSize, isSRGB);
+
+			int columns = sw::min(sw::min(xBlockSize, w - x), dstW - x);
+
+			for(int j = 0; j < rows; j++)
+			{
+				const unsigned short (*texel)[4] = &texels.texel[j * xBlockSize];
+				const bool (*hdr)[4] = &texels.hdr[j * xBlockSize];
+
+				if(isSRGB)
+				{
+					unsigned char *bgra = dst + (y + j) * dstPitch + x * 4;
+
+					for(int i = 0; i < columns; i++, bgra += 4)
+					{
+						bgra[0] = static_cast<unsigned char>(texel[i][2] >> 8);
+						bgra[1] = static_cast<unsigned char>(texel[i][1] >> 8);
+						bgra[2] = static_cast<unsigned char>(texel[i][0] >> 8);
+						bgra[3] = static_cast<unsigned char>(texel[i][3] >> 8);
+					}
+				}
+				else
+				{
+					float *rgba = reinterpret_cast<float*>(dst + (y + j) * dstPitch) + x * 4;
+
+					for(int i = 0; i < columns; i++, rgba += 4)
+					{
+						for(int c = 0; c < 4; c++)
+						{
+							rgba[c] = hdr[i][c] ? static_cast<float>(sw::shortAsHalf(texel[i][c])) : texel[i][c] * (1.0f / 0xFFFF);
+						}
+					}
+				}
+			}
+		}
+	}
+}
@@ -14,21 +14,28 @@
 
 #include "Blitter.hpp"
 
+#include "Shader/Constants.hpp"
 #include "Shader/ShaderCore.hpp"
 #include "Reactor/Reactor.hpp"
+#include "Common/CPUID.hpp"
+#include "Common/Thread.hpp"
 #include "Common/Memory.hpp"
 #include "Common/Debug.hpp"
 
+#include <algorithm>
+
 namespace sw
 {
+	static std::map<std::pair<Format, Format>, int> fallbacks;
+	static MutexLock fallbackMutex;
+
 	Blitter::Blitter()
 	{
-		blitCache = new RoutineCache<State>(1024);
+		blitCache = RoutineCache<State>::shared(1024, nullptr);
 	}
 
 	Blitter::~Blitter()
 	{
-		delete blitCache;
 	}
 
 	void Blitter::clear(void *pixel, sw::Format format, Surface *dest, const SliceRect &dRect, unsigned int rgbaMask)
@@ -44,6 +51,23 @@ namespace sw
 		delete color;
 	}
 
+	static void clearSpan(uint8_t *d, int bytes, const uint32_t packed[4], int count)
+	{
+		switch(bytes)
+		{
+		case 2: sw::clear((uint16_t*)d, (uint16_t)packed[0], count); break;
+		case 4: sw::clear((uint32_t*)d, packed[0], count); break;
+		case 8: sw::clear((uint64_t*)d, (uint64_t)packed[1] << 32 | packed[0], count); break;
+		case 16:
+			{
+				uint64_t element[2] = {(uint64_t)packed[1] << 32 | packed[0], (uint64_t)packed[3] << 32 | packed[2]};
+				sw::clear((uint64_t*)d, element, count);
+			}
+			break;
+		default: assert(false);
+		}
+	}
+
 	bool Blitter::fastClear(void *pixel, sw::Format format, Surface *dest, const SliceRect &dRect, unsigned int rgbaMask)
 	{
 		if(format != FORMAT_A32B32G32R32F)
@@ -57,78 +81,97 @@ namespace sw
 		float b = color[2];
 		float a = color[3];
 
-		uint32_t packed;
+		uint32_t packed[4];
 
 		switch(dest->getFormat())
 		{
 		case FORMAT_R5G6B5:
 			if((rgbaMask & 0x7) != 0x7) return false;
-			packed = ((uint16_t)(31 * b + 0.5f) << 0) |
+			packed[0] = ((uint16_t)(31 * b + 0.5f) << 0) |
 			         ((uint16_t)(63 * g + 0.5f) << 5) |
 			         ((uint16_t)(31 * r + 0.5f) << 11);
 			break;
 		case FORMAT_X8B8G8R8:
 			if((rgbaMask & 0x7) != 0x7) return false;
-			packed = ((uint32_t)(255) << 24) |
+			packed[0] = ((uint32_t)(255) << 24) |
 			         ((uint32_t)(255 * b + 0.5f) << 16) |
 			         ((uint32_t)(255 * g + 0.5f) << 8) |
 			         ((uint32_t)(255 * r + 0.5f) << 0);
 			break;
 		case FORMAT_A8B8G8R8:
 			if((rgbaMask & 0xF) != 0xF) return false;
-			packed = ((uint32_t)(255 * a + 0.5f) << 24) |
+			packed[0] = ((uint32_t)(255 * a + 0.5f) << 24) |
 			         ((uint32_t)(255 * b + 0.5f) << 16) |
 			         ((uint32_t)(255 * g + 0.5f) << 8) |
 			         ((uint32_t)(255 * r + 0.5f) << 0);
 			break;
 		case FORMAT_X8R8G8B8:
 			if((rgbaMask & 0x7) != 0x7) return false;
-			packed = ((uint32_t)(255) << 24) |
+			packed[0] = ((uint32_t)(255) << 24) |
 			         ((uint32_t)(255 * r + 0.5f) << 16) |
 			         ((uint32_t)(255 * g + 0.5f) << 8) |
 			         ((uint32_t)(255 * b + 0.5f) << 0);
 			break;
 		case FORMAT_A8R8G8B8:
 			if((rgbaMask & 0xF) != 0xF) return false;
-			packed = ((uint32_t)(255 * a + 0.5f) << 24) |
+			packed[0] = ((uint32_t)(255 * a + 0.5f) << 24) |
 			         ((uint32_t)(255 * r + 0.5f) << 16) |
 			         ((uint32_t)(255 * g + 0.5f) << 8) |
 			         ((uint32_t)(255 * b + 0.5f) << 0);
 			break;
+		case FORMAT_R32F:
+			if((rgbaMask & 0x1) != 0x1) return false;
+			memcpy(packed, color, 4);
+			break;
+		case FORMAT_G32R32F:
+			if((rgbaMask & 0x3) != 0x3) return false;
+			memcpy(packed, color, 8);
+			break;
+		case FORMAT_A32B32G32R32F:
+			if((rgbaMask & 0xF) != 0xF) return false;
+			memcpy(packed, color, 16);
+			break;
 		default:
 			return false;
 		}
 
 		bool useDestInternal = !dest->isExternalDirty();
-		uint8_t *slice = (uint8_t*)dest->lock(dRect.x0, dRect.y0, dRect.slice, sw::LOCK_WRITEONLY, sw::PUBLIC, useDestInternal);
+		Rect tiles = useDestInternal ? dest->beginClear(dRect.x0, dRect.y0, dRect.x1, dRect.y1) : Rect(0, 0, 0, 0);
+		uint8_t *slice = (uint8_t*)dest->lock(dRect.x0, dRect.y0, dRect.slice, dest->isEntire(dRect) ? sw::LOCK_DISCARD : sw::LOCK_WRITEONLY, sw::PUBLIC, useDestInternal);
+		int bytes = Surface::bytes(dest->getFormat());
 
 		for(int j = 0; j < dest->getSamples(); j++)
 		{
 			uint8_t *d = slice;
 
-			switch(Surface::bytes(dest->getFormat()))
+			for(int i = dRect.y0; i < dRect.y1; i++)
 			{
-			case 2:
-				for(int i = dRect.y0; i < dRect.y1; i++)
+				if(i >= tiles.y0 && i < tiles.y1)   // Only the pixels around the deferred tiles
 				{
-					sw::clear((uint16_t*)d, packed, dRect.x1 - dRect.x0);
-					d += dest->getPitchB(useDestInternal);
+					clearSpan(d, bytes, packed, tiles.x0 - dRect.x0);
+					clearSpan(d + bytes * (tiles.x1 - dRect.x0), bytes, packed, dRect.x1 - tiles.x1);
 				}
-				break;
-			case 4:
-				for(int i = dRect.y0; i < dRect.y1; i++)
+				else
 				{
-					sw::clear((uint32_t*)d, packed, dRect.x1 - dRect.x0);
-					d += dest->getPitchB(useDestInternal);
+					clearSpan(d, bytes, packed, dRect.x1 - dRect.x0);
 				}
-				break;
-			default:
-				assert(false);
+
+				d += dest->getPitchB(useDestInternal);
 			}
 
 			slice += dest->getSliceB(useDestInternal);
 		}
 
+		if(tiles.width() > 0)
+		{
+			dest->endClear(packed, tiles);
+		}
+
+		if(useDestInternal)
+		{
+			dest->setUniformSamples(dRect);
+		}
+
 		dest->unlock(useDestInternal);
 
 		return true;
@@ -232,6 +275,18 @@ namespace sw
 		case FORMAT_A8:
 			c.w = Float(Int(*Pointer<Byte>(element)));
 			break;
+		case FORMAT_A8L8:
+			c.xyz = Float(Int(*Pointer<Byte>(element + 0)));
+			c.w = Float(Int(*Pointer<Byte>(element + 1)));
+			break;
+		case FORMAT_A4L4:
+			c.xyz = Float(Int(*Pointer<Byte>(element) & Byte(0x0F)));
+			c.w = Float(Int((*Pointer<Byte>(element) & Byte(0xF0)) >> Byte(4)));
+			break;
+		case FORMAT_L16:
+			c.xyz = Float(Int(*Pointer<UShort>(element)));
+			c.w = float(0xFFFF);
+			break;
 		case FORMAT_R8I:
 		case FORMAT_R8_SNORM:
 			c.x = Float(Int(*Pointer<SByte>(element)));
@@ -373,11 +428,74 @@ namespace sw
 		case FORMAT_R32F:
 			c.x = *Pointer<Float>(element);
 			break;
+		case FORMAT_A16B16G16R16F:
+			c = halfToFloat(Int4(*Pointer<UShort4>(element)));
+			break;
+		case FORMAT_X16B16G16R16F:
+		case FORMAT_X16B16G16R16F_UNSIGNED:
+			c.xyz = halfToFloat(Int4(*Pointer<UShort4>(element)));
+			break;
+		case FORMAT_B16G16R16F:
+			c.z = Extract(halfToFloat(Int4(Int(*Pointer<UShort>(element + 4)))), 0);
+		case FORMAT_G16R16F:
+			c.y = Extract(halfToFloat(Int4(Int(*Pointer<UShort>(element + 2)))), 0);
+		case FORMAT_R16F:
+			c.x = Extract(halfToFloat(Int4(Int(*Pointer<UShort>(element)))), 0);
+			break;
+		case FORMAT_A32L32F:
+			c.w = *Pointer<Float>(element + 4);
+		case FORMAT_L32F:
+			c.xyz = *Pointer<Float>(element);
+			break;
+		case FORMAT_A16L16F:
+			c.w = Extract(halfToFloat(Int4(Int(*Pointer<UShort>(element + 2)))), 0);
+		case FORMAT_L16F:
+			c.xyz = Extract(halfToFloat(Int4(Int(*Pointer<UShort>(element)))), 0);
+			break;
+		case FORMAT_A32F:
+			c.w = *Pointer<Float>(element);
+			break;
+		case FORMAT_A16F:
+			c.w = Extract(halfToFloat(Int4(Int(*Pointer<UShort>(element)))), 0);
+			break;
 		case FORMAT_R5G6B5:
 			c.x = Float(Int((*Pointer<UShort>(element) & UShort(0xF800)) >> UShort(11)));
 			c.y = Float(Int((*Pointer<UShort>(element) & UShort(0x07E0)) >> UShort(5)));
 			c.z = Float(Int(*Pointer<UShort>(element) & UShort(0x001F)));
 			break;
+		case FORMAT_A4R4G4B4:
+			c.w = Float(Int((*Pointer<UShort>(element) & UShort(0xF000)) >> UShort(12)));
+		case FORMAT_X4R4G4B4:
+			c.x = Float(Int((*Pointer<UShort>(element) & UShort(0x0F00)) >> UShort(8)));
+			c.y = Float(Int((*Pointer<UShort>(element) & UShort(0x00F0)) >> UShort(4)));
+			c.z = Float(Int(*Pointer<UShort>(element) & UShort(0x000F)));
+			break;
+		case FORMAT_R4G4B4A4:
+			c.x = Float(Int((*Pointer<UShort>(element) & UShort(0xF000)) >> UShort(12)));
+			c.y = Float(Int((*Pointer<UShort>(element) & UShort(0x0F00)) >> UShort(8)));
+			c.z = Float(Int((*Pointer<UShort>(element) & UShort(0x00F0)) >> UShort(4)));
+			c.w = Float(Int(*Pointer<UShort>(element) & UShort(0x000F)));
+			break;
+		case FORMAT_A1R5G5B5:
+			c.w = Float(Int((*Pointer<UShort>(element) & UShort(0x8000)) >> UShort(15)));
+		case FORMAT_X1R5G5B5:
+			c.x = Float(Int((*Pointer<UShort>(element) & UShort(0x7C00)) >> UShort(10)));
+			c.y = Float(Int((*Pointer<UShort>(element) & UShort(0x03E0)) >> UShort(5)));
+			c.z = Float(Int(*Pointer<UShort>(element) & UShort(0x001F)));
+			break;
+		case FORMAT_R5G5B5A1:
+			c.x = Float(Int((*Pointer<UShort>(element) & UShort(0xF800)) >> UShort(11)));
+			c.y = Float(Int((*Pointer<UShort>(element) & UShort(0x07C0)) >> UShort(6)));
+			c.z = Float(Int((*Pointer<UShort>(element) & UShort(0x003E)) >> UShort(1)));
+			c.w = Float(Int(*Pointer<UShort>(element) & UShort(0x0001)));
+			break;
+		case FORMAT_A8R3G3B2:
+			c.w = Float(Int(*Pointer<Byte>(element + 1)));
+		case FORMAT_R3G3B2:
+			c.x = Float(Int((*Pointer<Byte>(element) & Byte(0xE0)) >> Byte(5)));
+			c.y = Float(Int((*Pointer<Byte>(element) & Byte(0x1C)) >> Byte(2)));
+			c.z = Float(Int(*Pointer<Byte>(element) & Byte(0x03)));
+			break;
 		case FORMAT_A2B10G10R10:
 		case FORMAT_A2B10G10R10UI:
 			c.x = Float(Int((*Pointer<UInt>(element) & UInt(0x000003FF))));
@@ -385,6 +503,46 @@ namespace sw
 			c.z = Float(Int((*Pointer<UInt>(element) & UInt(0x3FF00000)) >> 20));
 			c.w = Float(Int((*Pointer<UInt>(element) & UInt(0xC0000000)) >> 30));
 			break;
+		case FORMAT_A2R10G10B10:
+			c.z = Float(Int((*Pointer<UInt>(element) & UInt(0x000003FF))));
+			c.y = Float(Int((*Pointer<UInt>(element) & UInt(0x000FFC00)) >> 10));
+			c.x = Float(Int((*Pointer<UInt>(element) & UInt(0x3FF00000)) >> 20));
+			c.w = Float(Int((*Pointer<UInt>(element) & UInt(0xC0000000)) >> 30));
+			break;
+		case FORMAT_V8U8:
+			c.x = Float(Int(*Pointer<SByte>(element + 0)));
+			c.y = Float(Int(*Pointer<SByte>(element + 1)));
+			break;
+		case FORMAT_X8L8V8U8:
+			c.x = Float(Int(*Pointer<SByte>(element + 0)));
+			c.y = Float(Int(*Pointer<SByte>(element + 1)));
+			c.z = Float(Int(*Pointer<Byte>(element + 2)));
+			break;
+		case FORMAT_Q8W8V8U8:
+			c = Float4(*Pointer<SByte4>(element));
+			break;
+		case FORMAT_V16U16:
+			c.x = Float(Int(*Pointer<Short>(element + 0)));
+			c.y = Float(Int(*Pointer<Short>(element + 2)));
+			break;
+		case FORMAT_A16W16V16U16:
+			c = Float4(*Pointer<Short4>(element));
+			c.w = Float(Int(*Pointer<UShort>(element + 6)));
+			break;
+		case FORMAT_Q16W16V16U16:
+			c = Float4(*Pointer<Short4>(element));
+			break;
+		case FORMAT_L6V5U5:
+			c.x = Float((Int(*Pointer<UShort>(element)) << Int(27)) >> Int(27));
+			c.y = Float((Int(*Pointer<UShort>(element)) << Int(22)) >> Int(27));
+			c.z = Float(Int(*Pointer<UShort>(element) >> UShort(10)));
+			break;
+		case FORMAT_A2W10V10U10:
+			c.x = Float((*Pointer<Int>(element) << Int(22)) >> Int(22));
+			c.y = Float((*Pointer<Int>(element) << Int(12)) >> Int(22));
+			c.z = Float((*Pointer<Int>(element) << Int(2)) >> Int(22));
+			c.w = Float(Int((*Pointer<UInt>(element) & UInt(0xC0000000)) >> 30));
+			break;
 		case FORMAT_D16:
 			c.x = Float(Int((*Pointer<UShort>(element))));
 			break;
@@ -432,6 +590,16 @@ namespace sw
 		case FORMAT_A8:
 			if(writeA) { *Pointer<Byte>(element) = Byte(RoundInt(Float(c.w))); }
 			break;
+		case FORMAT_A8L8:
+			if(writeR) { *Pointer<Byte>(element + 0) = Byte(RoundInt(Float(c.x))); }
+			if(writeA) { *Pointer<Byte>(element + 1) = Byte(RoundInt(Float(c.w))); }
+			break;
+		case FORMAT_A4L4:
+			WritePacked(c, element, 1, {4, 0, 0, 4}, {0, 0, 0, 4}, 0x00, state);
+			break;
+		case FORMAT_L16:
+			if(writeR) { *Pointer<UShort>(element) = UShort(RoundInt(Float(c.x))); }
+			break;
 		case FORMAT_A8R8G8B8:
 			if(writeRGBA)
 			{
@@ -535,6 +703,65 @@ namespace sw
 		case FORMAT_R32F:
 			if(writeR) { *Pointer<Float>(element) = c.x; }
 			break;
+		case FORMAT_A32L32F:
+			if(writeA) { *Pointer<Float>(element + 4) = c.w; }
+		case FORMAT_L32F:
+			if(writeR) { *Pointer<Float>(element) = c.x; }
+			break;
+		case FORMAT_A32F:
+			if(writeA) { *Pointer<Float>(element) = c.w; }
+			break;
+		case FORMAT_A16B16G16R16F:
+			if(writeRGBA)
+			{
+				*Pointer<UShort4>(element) = UShort4(floatToHalf(c));
+			}
+			else
+			{
+				Int4 h = floatToHalf(c);
+				if(writeR) { *Pointer<UShort>(element) = UShort(Extract(h, 0)); }
+				if(writeG) { *Pointer<UShort>(element + 2) = UShort(Extract(h, 1)); }
+				if(writeB) { *Pointer<UShort>(element + 4) = UShort(Extract(h, 2)); }
+				if(writeA) { *Pointer<UShort>(element + 6) = UShort(Extract(h, 3)); }
+			}
+			break;
+		case FORMAT_X16B16G16R16F:
+		case FORMAT_X16B16G16R16F_UNSIGNED:
+			if(writeA) { *Pointer<UShort>(element + 6) = UShort(0x3C00); }   // 1.0
+		case FORMAT_B16G16R16F:
+			{
+				Int4 h = floatToHalf(c);
+				if(writeR) { *Pointer<UShort>(element) = UShort(Extract(h, 0)); }
+				if(writeG) { *Pointer<UShort>(element + 2) = UShort(Extract(h, 1)); }
+				if(writeB) { *Pointer<UShort>(element + 4) = UShort(Extract(h, 2)); }
+			}
+			break;
+		case FORMAT_G16R16F:
+			if(writeR && writeG)
+			{
+				*Pointer<UShort2>(element) = UShort2(UShort4(floatToHalf(c)));
+			}
+			else
+			{
+				Int4 h = floatToHalf(c);
+				if(writeR) { *Pointer<UShort>(element) = UShort(Extract(h, 0)); }
+				if(writeG) { *Pointer<UShort>(element + 2) = UShort(Extract(h, 1)); }
+			}
+			break;
+		case FORMAT_R16F:
+		case FORMAT_L16F:
+			if(writeR) { *Pointer<UShort>(element) = UShort(Extract(floatToHalf(c), 0)); }
+			break;
+		case FORMAT_A16L16F:
+			{
+				Int4 h = floatToHalf(c);
+				if(writeR) { *Pointer<UShort>(element) = UShort(Extract(h, 0)); }
+				if(writeA) { *Pointer<UShort>(element + 2) = UShort(Extract(h, 3)); }
+			}
+			break;
+		case FORMAT_A16F:
+			if(writeA) { *Pointer<UShort>(element) = UShort(Extract(floatToHalf(c), 3)); }
+			break;
 		case FORMAT_A8B8G8R8I:
 		case FORMAT_A8B8G8R8_SNORM:
 			if(writeA) { *Pointer<SByte>(element + 3) = SByte(RoundInt(Float(c.w))); }
@@ -751,6 +978,65 @@ namespace sw
 				                                  (RoundInt(Float(c.w)) << 30)) & UInt(mask));
 			}
 			break;
+		case FORMAT_A2R10G10B10:
+			WritePacked(c, element, 4, {10, 10, 10, 2}, {20, 10, 0, 30}, 0x00000000, state);
+			break;
+		case FORMAT_A4R4G4B4:
+			WritePacked(c, element, 2, {4, 4, 4, 4}, {8, 4, 0, 12}, 0x0000, state);
+			break;
+		case FORMAT_X4R4G4B4:
+			WritePacked(c, element, 2, {4, 4, 4, 0}, {8, 4, 0, 0}, 0xF000, state);
+			break;
+		case FORMAT_R4G4B4A4:
+			WritePacked(c, element, 2, {4, 4, 4, 4}, {12, 8, 4, 0}, 0x0000, state);
+			break;
+		case FORMAT_A1R5G5B5:
+			WritePacked(c, element, 2, {5, 5, 5, 1}, {10, 5, 0, 15}, 0x0000, state);
+			break;
+		case FORMAT_X1R5G5B5:
+			WritePacked(c, element, 2, {5, 5, 5, 0}, {10, 5, 0, 0}, 0x8000, state);
+			break;
+		case FORMAT_R5G5B5A1:
+			WritePacked(c, element, 2, {5, 5, 5, 1}, {11, 6, 1, 0}, 0x0000, state);
+			break;
+		case FORMAT_A8R3G3B2:
+			WritePacked(c, element, 2, {3, 3, 2, 8}, {5, 2, 0, 8}, 0x0000, state);
+			break;
+		case FORMAT_R3G3B2:
+			WritePacked(c, element, 1, {3, 3, 2, 0}, {5, 2, 0, 0}, 0x00, state);
+			break;
+		case FORMAT_L6V5U5:
+			WritePacked(c, element, 2, {5, 5, 6, 0}, {0, 5, 10, 0}, 0x0000, state);
+			break;
+		case FORMAT_A2W10V10U10:
+			WritePacked(c, element, 4, {10, 10, 10, 2}, {0, 10, 20, 30}, 0x00000000, state);
+			break;
+		case FORMAT_Q8W8V8U8:
+			if(writeA) { *Pointer<SByte>(element + 3) = SByte(RoundInt(Float(c.w))); }
+			if(writeB) { *Pointer<SByte>(element + 2) = SByte(RoundInt(Float(c.z))); }
+		case FORMAT_V8U8:
+			if(writeG) { *Pointer<SByte>(element + 1) = SByte(RoundInt(Float(c.y))); }
+			if(writeR) { *Pointer<SByte>(element + 0) = SByte(RoundInt(Float(c.x))); }
+			break;
+		case FORMAT_X8L8V8U8:
+			if(writeR) { *Pointer<SByte>(element + 0) = SByte(RoundInt(Float(c.x))); }
+			if(writeG) { *Pointer<SByte>(element + 1) = SByte(RoundInt(Float(c.y))); }
+			if(writeB) { *Pointer<Byte>(element + 2) = Byte(RoundInt(Float(c.z))); }
+			if(writeA) { *Pointer<Byte>(element + 3) = Byte(0xFF); }
+			break;
+		case FORMAT_A16W16V16U16:
+			if(writeA) { *Pointer<UShort>(element + 6) = UShort(RoundInt(Float(c.w))); }
+			if(writeB) { *Pointer<Short>(element + 4) = Short(RoundInt(Float(c.z))); }
+			if(writeG) { *Pointer<Short>(element + 2) = Short(RoundInt(Float(c.y))); }
+			if(writeR) { *Pointer<Short>(element + 0) = Short(RoundInt(Float(c.x))); }
+			break;
+		case FORMAT_Q16W16V16U16:
+			if(writeA) { *Pointer<Short>(element + 6) = Short(RoundInt(Float(c.w))); }
+			if(writeB) { *Pointer<Short>(element + 4) = Short(RoundInt(Float(c.z))); }
+		case FORMAT_V16U16:
+			if(writeG) { *Pointer<Short>(element + 2) = Short(RoundInt(Float(c.y))); }
+			if(writeR) { *Pointer<Short>(element + 0) = Short(RoundInt(Float(c.x))); }
+			break;
 		case FORMAT_D16:
 			*Pointer<UShort>(element) = UShort(RoundInt(Float(c.x)));
 			break;
@@ -995,8 +1281,54 @@ namespace sw
 		case FORMAT_A8B8G8R8:
 		case FORMAT_SRGB8_X8:
 		case FORMAT_SRGB8_A8:
+		case FORMAT_A8L8:
 			scale = vector(0xFF, 0xFF, 0xFF, 0xFF);
 			break;
+		case FORMAT_A4L4:
+		case FORMAT_A4R4G4B4:
+		case FORMAT_R4G4B4A4:
+			scale = vector(0xF, 0xF, 0xF, 0xF);
+			break;
+		case FORMAT_X4R4G4B4:
+			scale = vector(0xF, 0xF, 0xF, 1.0f);
+			break;
+		case FORMAT_A1R5G5B5:
+		case FORMAT_R5G5B5A1:
+			scale = vector(0x1F, 0x1F, 0x1F, 0x01);
+			break;
+		case FORMAT_X1R5G5B5:
+			scale = vector(0x1F, 0x1F, 0x1F, 1.0f);
+			break;
+		case FORMAT_R3G3B2:
+			scale = vector(0x07, 0x07, 0x03, 1.0f);
+			break;
+		case FORMAT_A8R3G3B2:
+			scale = vector(0x07, 0x07, 0x03, 0xFF);
+			break;
+		case FORMAT_V8U8:
+			scale = vector(0x7F, 0x7F, 0x7F, 1.0f);
+			break;
+		case FORMAT_X8L8V8U8:
+			scale = vector(0x7F, 0x7F, 0xFF, 1.0f);
+			break;
+		case FORMAT_Q8W8V8U8:
+			scale = vector(0x7F, 0x7F, 0x7F, 0x7F);
+			break;
+		case FORMAT_V16U16:
+			scale = vector(0x7FFF, 0x7FFF, 0x7FFF, 1.0f);
+			break;
+		case FORMAT_A16W16V16U16:
+			scale = vector(0x7FFF, 0x7FFF, 0x7FFF, 0xFFFF);
+			break;
+		case FORMAT_Q16W16V16U16:
+			scale = vector(0x7FFF, 0x7FFF, 0x7FFF, 0x7FFF);
+			break;
+		case FORMAT_L6V5U5:
+			scale = vector(0x0F, 0x0F, 0x3F, 1.0f);
+			break;
+		case FORMAT_A2W10V10U10:
+			scale = vector(0x1FF, 0x1FF, 0x1FF, 0x03);
+			break;
 		case FORMAT_R8_SNORM:
 		case FORMAT_G8R8_SNORM:
 		case FORMAT_X8B8G8R8_SNORM:
@@ -1004,6 +1336,8 @@ namespace sw
 			scale = vector(0x7F, 0x7F, 0x7F, 0x7F);
 			break;
 		case FORMAT_A16B16G16R16:
+		case FORMAT_G16R16:
+		case FORMAT_L16:
 			scale = vector(0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF);
 			break;
 		case FORMAT_R8I:
@@ -1016,7 +1350,6 @@ namespace sw
 		case FORMAT_A8B8G8R8UI:
 		case FORMAT_R16I:
 		case FORMAT_R16UI:
-		case FORMAT_G16R16:
 		case FORMAT_G16R16I:
 		case FORMAT_G16R16UI:
 		case FORMAT_X16B16G16R16I:
@@ -1037,6 +1370,18 @@ namespace sw
 		case FORMAT_B32G32R32F:
 		case FORMAT_G32R32F:
 		case FORMAT_R32F:
+		case FORMAT_A16B16G16R16F:
+		case FORMAT_X16B16G16R16F:
+		case FORMAT_X16B16G16R16F_UNSIGNED:
+		case FORMAT_B16G16R16F:
+		case FORMAT_G16R16F:
+		case FORMAT_R16F:
+		case FORMAT_A32L32F:
+		case FORMAT_L32F:
+		case FORMAT_A16L16F:
+		case FORMAT_L16F:
+		case FORMAT_A32F:
+		case FORMAT_A16F:
 		case FORMAT_A2B10G10R10UI:
 			scale = vector(1.0f, 1.0f, 1.0f, 1.0f);
 			break;
@@ -1044,6 +1389,7 @@ namespace sw
 			scale = vector(0x1F, 0x3F, 0x1F, 1.0f);
 			break;
 		case FORMAT_A2B10G10R10:
+		case FORMAT_A2R10G10B10:
 			scale = vector(0x3FF, 0x3FF, 0x3FF, 0x03);
 			break;
 		case FORMAT_D16:
@@ -1073,7 +1419,7 @@ namespace sw
 		return true;
 	}
 
-	bool Blitter::ApplyScaleAndClamp(Float4 &value, const State &state, bool preScaled)
+	bool Blitter::ApplyScaleAndClamp(Float4 &value, const State &state, Pointer<Byte> &constants, bool preScaled)
 	{
 		float4 scale, unscale;
 		if(state.clearOperation &&
@@ -1106,12 +1452,22 @@ namespace sw
 
 		bool srcSRGB = Surface::isSRGBformat(state.sourceFormat);
 		bool dstSRGB = Surface::isSRGBformat(state.destFormat);
+		bool srcSNORM = (state.sourceFormat == FORMAT_R8_SNORM) ||
+		                (state.sourceFormat == FORMAT_G8R8_SNORM) ||
+		                (state.sourceFormat == FORMAT_X8B8G8R8_SNORM) ||
+		                (state.sourceFormat == FORMAT_A8B8G8R8_SNORM);
+		bool srcBump = (state.sourceFormat >= FORMAT_V8U8) && (state.sourceFormat <= FORMAT_Q16W16V16U16);
+
+		if(srcSNORM && !preScaled)
+		{
+			value = Max(value, Float4(-float(0x7F)));   // Both -128 and -127 represent -1.0
+		}
 
 		if(state.convertSRGB && ((srcSRGB && !preScaled) || dstSRGB))   // One of the formats is sRGB encoded.
 		{
 			value *= preScaled ? Float4(1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z, 1.0f / scale.w) : // Unapply scale
 			                     Float4(1.0f / unscale.x, 1.0f / unscale.y, 1.0f / unscale.z, 1.0f / unscale.w); // Apply unscale
-			value = (srcSRGB && !preScaled) ? sRGBtoLinear(value) : LinearToSRGB(value);
+			value = (srcSRGB && !preScaled) ? sRGBtoLinear(value, constants) : LinearToSRGB(value, constants);
 			value *= Float4(scale.x, scale.y, scale.z, scale.w); // Apply scale
 		}
 		else if(unscale != scale)
@@ -1119,11 +1475,11 @@ namespace sw
 			value *= Float4(scale.x / unscale.x, scale.y / unscale.y, scale.z / unscale.z, scale.w / unscale.w);
 		}
 
-		if(state.destFormat == FORMAT_X32B32G32R32F_UNSIGNED)
+		if(state.destFormat == FORMAT_X32B32G32R32F_UNSIGNED || state.destFormat == FORMAT_X16B16G16R16F_UNSIGNED)
 		{
 			value = Max(value, Float4(0.0f));  // TODO: Only necessary if source is signed.
 		}
-		else if(Surface::isFloatFormat(state.sourceFormat) && !Surface::isFloatFormat(state.destFormat))
+		else if((Surface::isFloatFormat(state.sourceFormat) || srcSNORM || srcBump) && !Surface::isFloatFormat(state.destFormat))
 		{
 			value = Min(value, Float4(scale.x, scale.y, scale.z, scale.w));
 
@@ -1150,32 +1506,100 @@ namespace sw
 		}
 	}
 
-	Float4 Blitter::LinearToSRGB(Float4 &c)
+	void Blitter::WritePacked(Float4 &c, Pointer<Byte> element, int bytes, const int (&bits)[4], const int (&shift)[4], unsigned int fill, const State &state)
+	{
+		bool writeComponent[4] = {state.writeRed, state.writeGreen, state.writeBlue, state.writeAlpha};
+		unsigned int all = (bytes == 4) ? 0xFFFFFFFF : (1u << (8 * bytes)) - 1;
+		unsigned int mask = state.writeAlpha ? fill : 0;
+		Int packed = Int(mask);
+
+		for(int i = 0; i < 4; i++)
+		{
+			if(bits[i] && writeComponent[i])
+			{
+				unsigned int field = ((1u << bits[i]) - 1) << shift[i];
+				packed |= (RoundInt(Extract(c, i)) << Int(shift[i])) & Int(field);
+				mask |= field;
+			}
+		}
+
+		if(mask == 0)
+		{
+			return;
+		}
+
+		switch(bytes)
+		{
+		case 1:
+			if(mask != all) { packed |= Int(*Pointer<Byte>(element)) & Int(~mask & all); }
+			*Pointer<Byte>(element) = Byte(packed);
+			break;
+		case 2:
+			if(mask != all) { packed |= Int(*Pointer<UShort>(element)) & Int(~mask & all); }
+			*Pointer<UShort>(element) = UShort(packed);
+			break;
+		case 4:
+			if(mask != all) { packed |= *Pointer<Int>(element) & Int(~mask); }
+			*Pointer<Int>(element) = packed;
+			break;
+		default:
+			ASSERT(false);
+		}
+	}
+
+	// The sRGB formats all have 8-bit components. The renderer's 12-bit linear to sRGB table gets within one of the
+	// nearest 8-bit value, which comparing against the linear values halfway between the neighboring ones settles.
+	Float4 Blitter::LinearToSRGB(Float4 &c, Pointer<Byte> &constants)
 	{
-		Float4 lc = Min(c, Float4(0.0031308f)) * Float4(12.92f);
-		Float4 ec = Float4(1.055f) * power(c, Float4(1.0f / 2.4f)) - Float4(0.055f);
+		Pointer<Byte> LUT = constants + OFFSET(Constants,linearToSRGB12_16);
+		Pointer<Byte> boundary = constants + OFFSET(Constants,sRGB8boundary);
+
+		Float4 v = Min(Max(c, Float4(0.0f)), Float4(1.0f));
+		Int4 i = RoundInt(v * Float4(0x0FFF));
+
+		Float4 e = Float4(0.0f);
+		e = Insert(e, Float(Int(*Pointer<UShort>(LUT + 2 * Extract(i, 0)))), 0);
+		e = Insert(e, Float(Int(*Pointer<UShort>(LUT + 2 * Extract(i, 1)))), 1);
+		e = Insert(e, Float(Int(*Pointer<UShort>(LUT + 2 * Extract(i, 2)))), 2);
+		Int4 k = RoundInt(e * Float4(255.0f / 0xFFFF));
+
+		Float4 low = Float4(0.0f);
+		Float4 high = Float4(2.0f);
+		low = Insert(low, *Pointer<Float>(boundary + 4 * Extract(k, 0)), 0);
+		low = Insert(low, *Pointer<Float>(boundary + 4 * Extract(k, 1)), 1);
+		low = Insert(low, *Pointer<Float>(boundary + 4 * Extract(k, 2)), 2);
+		high = Insert(high, *Pointer<Float>(boundary + 4 * Extract(k, 0) + 4), 0);
+		high = Insert(high, *Pointer<Float>(boundary + 4 * Extract(k, 1) + 4), 1);
+		high = Insert(high, *Pointer<Float>(boundary + 4 * Extract(k, 2) + 4), 2);
+		k = k + CmpLT(v, low) - CmpNLT(v, high);   // Comparisons are -1 when true
 
 		Float4 s = c;
-		s.xyz = Max(lc, ec);
+		s.xyz = Float4(k) * Float4(1.0f / 0xFF);
 
 		return s;
 	}
 
-	Float4 Blitter::sRGBtoLinear(Float4 &c)
+	// Looks up each of the 256 values 8-bit sRGB components can have
+	Float4 Blitter::sRGBtoLinear(Float4 &c, Pointer<Byte> &constants)
 	{
-		Float4 lc = c * Float4(1.0f / 12.92f);
-		Float4 ec = power((c + Float4(0.055f)) * Float4(1.0f / 1.055f), Float4(2.4f));
-
-		Int4 linear = CmpLT(c, Float4(0.04045f));
+		Pointer<Byte> LUT = constants + OFFSET(Constants,sRGBtoLinear8_32F);
+		Int4 i = Min(Max(RoundInt(c * Float4(0xFF)), Int4(0)), Int4(0xFF));
 
 		Float4 s = c;
-		s.xyz = As<Float4>((linear & As<Int4>(lc)) | (~linear & As<Int4>(ec)));   // FIXME: IfThenElse()
+		s = Insert(s, *Pointer<Float>(LUT + 4 * Extract(i, 0)), 0);
+		s = Insert(s, *Pointer<Float>(LUT + 4 * Extract(i, 1)), 1);
+		s = Insert(s, *Pointer<Float>(LUT + 4 * Extract(i, 2)), 2);
 
 		return s;
 	}
 
 	Routine *Blitter::generate(const State &state)
 	{
+		if(state.swizzleRows)
+		{
+			return generateSwizzle(state);
+		}
+
 		Function<Void(Pointer<Byte>)> function;
 		{
 			Pointer<Byte> blit(function.Arg<0>());
@@ -1197,6 +1621,7 @@ namespace sw
 
 			Int sWidth = *Pointer<Int>(blit + OFFSET(BlitData,sWidth));
 			Int sHeight = *Pointer<Int>(blit + OFFSET(BlitData,sHeight));
+			Pointer<Byte> constants = *Pointer<Pointer<Byte>>(blit + OFFSET(BlitData,constants));
 
 			bool intSrc = Surface::isNonNormalizedInteger(state.sourceFormat);
 			bool intDst = Surface::isNonNormalizedInteger(state.destFormat);
@@ -1228,7 +1653,7 @@ namespace sw
 					}
 					hasConstantColorF = true;
 
-					if(!ApplyScaleAndClamp(constantColorF, state))
+					if(!ApplyScaleAndClamp(constantColorF, state, constants))
 					{
 						return nullptr;
 					}
@@ -1345,10 +1770,10 @@ namespace sw
 
 							if(state.convertSRGB && Surface::isSRGBformat(state.sourceFormat)) // sRGB -> RGB
 							{
-								if(!ApplyScaleAndClamp(c00, state)) return nullptr;
-								if(!ApplyScaleAndClamp(c01, state)) return nullptr;
-								if(!ApplyScaleAndClamp(c10, state)) return nullptr;
-								if(!ApplyScaleAndClamp(c11, state)) return nullptr;
+								if(!ApplyScaleAndClamp(c00, state, constants)) return nullptr;
+								if(!ApplyScaleAndClamp(c01, state, constants)) return nullptr;
+								if(!ApplyScaleAndClamp(c10, state, constants)) return nullptr;
+								if(!ApplyScaleAndClamp(c11, state, constants)) return nullptr;
 								preScaled = true;
 							}
 
@@ -1361,7 +1786,7 @@ namespace sw
 							        (c10 * ix + c11 * fx) * fy;
 						}
 
-						if(!ApplyScaleAndClamp(color, state, preScaled))
+						if(!ApplyScaleAndClamp(color, state, constants, preScaled))
 						{
 							return nullptr;
 						}
@@ -1414,24 +1839,17 @@ namespace sw
 		state.destFormat = isStencil ? dest->getStencilFormat() : dest->getFormat(useDestInternal);
 		state.destSamples = dest->getSamples();
 
-		criticalSection.lock();
-		Routine *blitRoutine = blitCache->query(state);
+		Routine *blitRoutine = getRoutine(state);
 
 		if(!blitRoutine)
 		{
-			blitRoutine = generate(state);
-
-			if(!blitRoutine)
-			{
-				criticalSection.unlock();
-				return false;
-			}
+			fallbackMutex.lock();
+			fallbacks[{state.sourceFormat, state.destFormat}]++;
+			fallbackMutex.unlock();
 
-			blitCache->add(state, blitRoutine);
+			return false;
 		}
 
-		criticalSection.unlock();
-
 		void (*blitFunction)(const BlitData *data) = (void(*)(const BlitData*))blitRoutine->getEntry();
 
 		BlitData data;
@@ -1459,8 +1877,15 @@ namespace sw
 
 		data.sWidth = source->getWidth();
 		data.sHeight = source->getHeight();
+		data.constants = &constants;
 
-		blitFunction(&data);
+		run(blitFunction, data, dRect.width() * dRect.height() * state.destSamples);
+		blitRoutine->unbind();
+
+		if(!isStencil && isRGBA && useDestInternal && state.destSamples > 1)
+		{
+			dest->setUniformSamples(dRect);   // Every sample got the same color
+		}
 
 		if(isStencil)
 		{
@@ -1475,4 +1900,429 @@ namespace sw
 
 		return true;
 	}
+
+	bool Blitter::isSwizzle(Format sourceFormat, Format destFormat)
+	{
+		auto isRGBA8 = [](Format format)
+		{
+			return format == FORMAT_A8R8G8B8 || format == FORMAT_X8R8G8B8 || format == FORMAT_A8B8G8R8 || format == FORMAT_X8B8G8R8;
+		};
+
+		return isRGBA8(sourceFormat) && isRGBA8(destFormat);
+	}
+
+	Routine *Blitter::generateSwizzle(const State &state)
+	{
+		bool swapRB = (state.sourceFormat == FORMAT_A8R8G8B8 || state.sourceFormat == FORMAT_X8R8G8B8) !=
+		              (state.destFormat == FORMAT_A8R8G8B8 || state.destFormat == FORMAT_X8R8G8B8);
+		bool opaque = (state.sourceFormat == FORMAT_X8R8G8B8 || state.sourceFormat == FORMAT_X8B8G8R8 ||
+		               state.destFormat == FORMAT_X8R8G8B8 || state.destFormat == FORMAT_X8B8G8R8);   // Alpha reads and writes as 0xFF
+
+		Function<Void(Pointer<Byte>)> function;
+		{
+			Pointer<Byte> blit(function.Arg<0>());
+
+			Pointer<Byte> source = *Pointer<Pointer<Byte>>(blit + OFFSET(BlitData,source));
+			Pointer<Byte> dest = *Pointer<Pointer<Byte>>(blit + OFFSET(BlitData,dest));
+			Int sPitchB = *Pointer<Int>(blit + OFFSET(BlitData,sPitchB));
+			Int dPitchB = *Pointer<Int>(blit + OFFSET(BlitData,dPitchB));
+
+			Int x0d = *Pointer<Int>(blit + OFFSET(BlitData,x0d));
+			Int x1d = *Pointer<Int>(blit + OFFSET(BlitData,x1d));
+			Int y0d = *Pointer<Int>(blit + OFFSET(BlitData,y0d));
+			Int y1d = *Pointer<Int>(blit + OFFSET(BlitData,y1d));
+
+			For(Int j = y0d, j < y1d, j++)
+			{
+				Pointer<Byte> s = source + j * sPitchB + x0d * 4;
+				Pointer<Byte> d = dest + j * dPitchB + x0d * 4;
+				Int i = x0d;
+
+				For(, i < x1d - 3, i += 4)
+				{
+					Int4 c = *Pointer<Int4>(s, 1);
+
+					if(swapRB)
+					{
+						c = (c & Int4(0xFF00FF00)) | ((c >> 16) & Int4(0x000000FF)) | ((c & Int4(0x000000FF)) << 16);
+					}
+
+					if(opaque)
+					{
+						c |= Int4(0xFF000000);
+					}
+
+					*Pointer<Int4>(d, 1) = c;
+
+					s += 16;
+					d += 16;
+				}
+
+				For(, i < x1d, i++)
+				{
+					Int c = *Pointer<Int>(s);
+
+					if(swapRB)
+					{
+						c = (c & Int(0xFF00FF00)) | ((c >> 16) & Int(0x000000FF)) | ((c & Int(0x000000FF)) << 16);
+					}
+
+					if(opaque)
+					{
+						c |= Int(0xFF000000);
+					}
+
+					*Pointer<Int>(d) = c;
+
+					s += 4;
+					d += 4;
+				}
+			}
+		}
+
+		return function(L"BlitRoutine");
+	}
+
+	Routine *Blitter::getRoutine(const State &state)
+	{
+		criticalSection.lock();
+		Routine *blitRoutine = blitCache->acquire(state);
+		RoutineTelemetry::recordCacheQuery("BlitRoutine", blitRoutine != nullptr);
+
+		if(!blitRoutine && std::find(unsupported.begin(), unsupported.end(), state) == unsupported.end())
+		{
+			blitRoutine = generate(state);
+
+			if(blitRoutine)
+			{
+				blitRoutine = blitCache->acquire(state, blitRoutine);
+			}
+			else
+			{
+				unsupported.push_back(state);   // Don't retry generating it for every blit
+			}
+		}
+
+		criticalSection.unlock();
+
+		return blitRoutine;
+	}
+
+	std::map<std::pair<Format, Format>, int> Blitter::getFallbacks()
+	{
+		fallbackMutex.lock();
+		std::map<std::pair<Format, Format>, int> copy = fallbacks;
+		fallbackMutex.unlock();
+
+		return copy;
+	}
+
+	namespace
+	{
+		struct WarmUp
+		{
+			~WarmUp()
+			{
+				if(thread)
+				{
+					thread->join();   // Code generation can't outlive the library
+					delete thread;
+				}
+
+				delete blitter;
+			}
+
+			MutexLock mutex;
+			Thread *thread = nullptr;
+			Blitter *blitter = nullptr;   // Keeps the shared cache alive until the application's blitters use it
+			std::vector<Format> formats;
+		};
+	}
+
+	void Blitter::warmUp(const Format *renderTargetFormats, int count)
+	{
+		static WarmUp warmUp;
+
+		warmUp.mutex.lock();
+
+		if(!warmUp.thread)   // Once per process
+		{
+			warmUp.blitter = new Blitter();
+			warmUp.formats.assign(renderTargetFormats, renderTargetFormats + count);
+			warmUp.thread = new Thread(warmUpTask, &warmUp);
+		}
+
+		warmUp.mutex.unlock();
+	}
+
+	void Blitter::warmUpTask(void *parameters)
+	{
+		const WarmUp &warmUp = *static_cast<const WarmUp*>(parameters);
+		const std::vector<Format> &formats = warmUp.formats;
+		Blitter &blitter = *warmUp.blitter;
+
+		// Like glReadPixels() with GL_RGBA and GL_UNSIGNED_BYTE, and glCopyTexImage2D() to GL_RGBA8 textures
+		for(bool convertSRGB : {false, true})
+		{
+			for(Format format : formats)
+			{
+				State state(Options(false, false, convertSRGB));
+				state.clampToEdge = false;
+				state.sourceFormat = format;
+				state.destFormat = FORMAT_A8B8G8R8;
+				state.destSamples = 1;
+
+				if(Routine *routine = blitter.getRoutine(state))
+				{
+					routine->unbind();
+				}
+			}
+		}
+
+		// Reads of the other 8-bit RGBA layouts only swap channels
+		for(Format format : formats)
+		{
+			if(isSwizzle(format, FORMAT_A8B8G8R8) && format != FORMAT_A8B8G8R8)
+			{
+				State state(Options(false, false, false));
+				state.swizzleRows = true;
+				state.sourceFormat = format;
+				state.destFormat = FORMAT_A8B8G8R8;
+				state.destSamples = 1;
+
+				if(Routine *routine = blitter.getRoutine(state))
+				{
+					routine->unbind();
+				}
+			}
+		}
+	}
+
+	bool Blitter::generateMipmaps(Surface *const *levels, int levelCount, int faceCount)
+	{
+		State state(Options(true, false, true));
+		state.clampToEdge = false;
+		state.sourceFormat = levels[0]->getInternalFormat();
+		state.destFormat = state.sourceFormat;
+		state.destSamples = 1;
+
+		for(int i = 0; i < levelCount * faceCount; i++)
+		{
+			if(levels[i]->getInternalFormat() != state.sourceFormat || levels[i]->getSamples() != 1 || levels[i]->getDepth() != 1)
+			{
+				return false;
+			}
+		}
+
+		Routine *blitRoutine = getRoutine(state);
+
+		if(!blitRoutine)
+		{
+			return false;
+		}
+
+		void (*blitFunction)(const BlitData *data) = (void(*)(const BlitData*))blitRoutine->getEntry();
+
+		std::vector<void*> buffer(levelCount * faceCount);
+		std::vector<BlitData> data(levelCount * faceCount);
+
+		for(int i = 0; i < levelCount * faceCount; i++)
+		{
+			int level = i % levelCount;
+			buffer[i] = levels[i]->lockInternal(0, 0, 0, (level == 0) ? sw::LOCK_READONLY : sw::LOCK_DISCARD, sw::PUBLIC);
+
+			if(level > 0)
+			{
+				Surface *source = levels[i - 1];
+				Surface *dest = levels[i];
+
+				data[i].source = buffer[i - 1];
+				data[i].dest = buffer[i];
+				data[i].sPitchB = source->getInternalPitchB();
+				data[i].dPitchB = dest->getInternalPitchB();
+				data[i].dSliceB = dest->getInternalSliceB();
+				data[i].w = (float)source->getWidth() / dest->getWidth();
+				data[i].h = (float)source->getHeight() / dest->getHeight();
+				data[i].x0 = 0.5f * data[i].w;
+				data[i].y0 = 0.5f * data[i].h;
+				data[i].x0d = 0;
+				data[i].x1d = dest->getWidth();
+				data[i].y0d = 0;
+				data[i].y1d = dest->getHeight();
+				data[i].sWidth = source->getWidth();
+				data[i].sHeight = source->getHeight();
+				data[i].constants = &constants;
+			}
+		}
+
+		// While each level is exactly half the height of the previous one, bands of rows of the base level
+		// aligned to the number of levels only read rows of the previous level within the same band. Each
+		// thread filters several levels of its band while they're still in the cache.
+		int bandLevels = 0;
+
+		while(bandLevels + 1 < levelCount && levels[bandLevels + 1]->getHeight() * 2 == levels[bandLevels]->getHeight())
+		{
+			bandLevels++;
+		}
+
+		int height = levels[0]->getHeight();
+		int texels = levels[0]->getWidth() * height * faceCount / 3;   // Written to the filtered levels, roughly
+		int threadCount = max(min(min(CPUID::processAffinity(), (int)MAX_BLIT_THREADS), texels / MIN_BLIT_TEXELS), 1);
+		int bandCount = (bandLevels > 0) ? max(min(threadCount / faceCount, height >> bandLevels), 1) : 1;
+		int faceGroups = (bandLevels == 0) ? 1 : (bandCount > 1) ? faceCount : min(faceCount, threadCount);
+		int taskCount = faceGroups * bandCount;
+
+		MipmapTask task[MAX_BLIT_THREADS];
+		Thread *thread[MAX_BLIT_THREADS] = {};
+
+		for(int i = taskCount - 1; i >= 0; i--)
+		{
+			int group = i / bandCount;
+			int band = i % bandCount;
+			int face = faceCount * group / faceGroups;
+
+			task[i].function = blitFunction;
+			task[i].data = &data[face * levelCount];
+			task[i].levelCount = levelCount;
+			task[i].faceCount = faceCount * (group + 1) / faceGroups - face;
+			task[i].bandLevels = bandLevels;
+			task[i].y0 = (height * band / bandCount) & -(1 << bandLevels);
+			task[i].y1 = (band < bandCount - 1) ? (height * (band + 1) / bandCount) & -(1 << bandLevels) : height;
+
+			if(i > 0)
+			{
+				thread[i] = new Thread(mipmapTask, &task[i]);
+			}
+		}
+
+		mipmapTask(&task[0]);
+
+		for(int i = 1; i < taskCount; i++)
+		{
+			thread[i]->join();
+			delete thread[i];
+		}
+
+		// The smallest levels, after a level of odd height
+		for(int face = 0; face < faceCount; face++)
+		{
+			for(int level = bandLevels + 1; level < levelCount; level++)
+			{
+				const BlitData &levelData = data[face * levelCount + level];
+				run(blitFunction, levelData, levelData.x1d * levelData.y1d);
+			}
+		}
+
+		blitRoutine->unbind();
+
+		for(int i = 0; i < levelCount * faceCount; i++)
+		{
+			levels[i]->unlockInternal();
+		}
+
+		return true;
+	}
+
+	void Blitter::mipmapTask(void *parameters)
+	{
+		MipmapTask *task = static_cast<MipmapTask*>(parameters);
+
+		for(int face = 0; face < task->faceCount; face++)
+		{
+			for(int level = 1; level <= task->bandLevels; level++)
+			{
+				BlitData data = task->data[face * task->levelCount + level];
+				data.y0d = task->y0 >> level;
+				data.y1d = task->y1 >> level;
+
+				task->function(&data);
+			}
+		}
+	}
+
+	bool Blitter::convert(void *dest, Format destFormat, int dPitchB, const void *source, Format sourceFormat, int sPitchB, int width, int height)
+	{
+		if(Surface::hasQuadLayout(sourceFormat) || Surface::hasQuadLayout(destFormat))
+		{
+			return false;   // Updates copy quad layouts linearly
+		}
+
+		State state(Options(false, false, false));
+		state.clampToEdge = false;
+		state.swizzleRows = isSwizzle(sourceFormat, destFormat);
+		state.sourceFormat = sourceFormat;
+		state.destFormat = destFormat;
+		state.destSamples = 1;
+
+		Routine *blitRoutine = getRoutine(state);
+
+		if(!blitRoutine)
+		{
+			return false;
+		}
+
+		BlitData data;
+
+		data.source = const_cast<void*>(source);
+		data.dest = dest;
+		data.sPitchB = sPitchB;
+		data.dPitchB = dPitchB;
+		data.dSliceB = 0;
+		data.x0 = 0.5f;
+		data.y0 = 0.5f;
+		data.w = 1.0f;
+		data.h = 1.0f;
+		data.x0d = 0;
+		data.x1d = width;
+		data.y0d = 0;
+		data.y1d = height;
+		data.sWidth = width;
+		data.sHeight = height;
+		data.constants = &constants;
+
+		run((void(*)(const BlitData*))blitRoutine->getEntry(), data, width * height);
+		blitRoutine->unbind();
+
+		return true;
+	}
+
+	void Blitter::run(void (*function)(const BlitData *data), const BlitData &data, int texels)
+	{
+		BlitTask task[MAX_BLIT_THREADS];
+
+		task[0].function = function;
+		task[0].data = data;
+
+		// Large blits are split into bands of destination rows
+		int rows = data.y1d - data.y0d;
+		int threadCount = max(min(min(CPUID::processAffinity(), (int)MAX_BLIT_THREADS), min(texels / MIN_BLIT_TEXELS, rows)), 1);
+		Thread *thread[MAX_BLIT_THREADS] = {};
+
+		for(int i = threadCount - 1; i >= 0; i--)
+		{
+			task[i] = task[0];
+			task[i].data.y0d = data.y0d + rows * i / threadCount;
+			task[i].data.y1d = data.y0d + rows * (i + 1) / threadCount;
+
+			if(i > 0)
+			{
+				thread[i] = new Thread(blitTask, &task[i]);
+			}
+		}
+
+		blitTask(&task[0]);
+
+		for(int i = 1; i < threadCount; i++)
+		{
+			thread[i]->join();
+			delete thread[i];
+		}
+	}
+
+	void Blitter::blitTask(void *parameters)
+	{
+		BlitTask *task = static_cast<BlitTask*>(parameters);
+
+		task->function(&task->data);
+	}
 }
@@ -19,19 +19,24 @@
 #include "RoutineCache.hpp"
 #include "Reactor/Reactor.hpp"
 
+#include <map>
 #include <string.h>
+#include <utility>
+#include <vector>
 
 namespace sw
 {
+	struct Constants;
+
 	class Blitter
 	{
 		struct Options
 		{
 			Options() = default;
 			Options(bool filter, bool useStencil, bool convertSRGB)
-				: writeMask(0xF), clearOperation(false), filter(filter), useStencil(useStencil), convertSRGB(convertSRGB), clampToEdge(false) {}
+				: writeMask(0xF), clearOperation(false), filter(filter), useStencil(useStencil), convertSRGB(convertSRGB), clampToEdge(false), swizzleRows(false) {}
 			Options(unsigned int writeMask)
-				: writeMask(writeMask), clearOperation(true), filter(false), useStencil(false), convertSRGB(true), clampToEdge(false) {}
+				: writeMask(writeMask), clearOperation(true), filter(false), useStencil(false), convertSRGB(true), clampToEdge(false), swizzleRows(false) {}
 
 			union
 			{
@@ -51,12 +56,17 @@ namespace sw
 			bool useStencil : 1;
 			bool convertSRGB : 1;
 			bool clampToEdge : 1;
+			bool swizzleRows : 1;   // Unscaled, between 8-bit RGBA formats which only differ in channel order
 		};
 
 		struct State : Options
 		{
 			State() = default;
-			State(const Options &options) : Options(options) {}
+			State(const Options &options)
+			{
+				memset(this, 0, sizeof(State));   // The padding is compared and hashed too
+				static_cast<Options&>(*this) = options;
+			}
 
 			bool operator==(const State &state) const
 			{
@@ -88,6 +98,31 @@ namespace sw
 
 			int sWidth;
 			int sHeight;
+
+			const Constants *constants;   // For the sRGB conversion tables
+		};
+
+		struct BlitTask
+		{
+			void (*function)(const BlitData *data);
+			BlitData data;
+		};
+
+		struct MipmapTask
+		{
+			void (*function)(const BlitData *data);
+			const BlitData *data;   // Filtering of each level from the previous one, for each face
+			int levelCount;
+			int faceCount;
+			int bandLevels;         // Levels filtered within the band
+			int y0;                 // Band of rows of the base level
+			int y1;
+		};
+
+		enum
+		{
+			MAX_BLIT_THREADS = 8,
+			MIN_BLIT_TEXELS = 0x40000,   // Per thread
 		};
 
 	public:
@@ -98,6 +133,20 @@ namespace sw
 		void blit(Surface *source, const SliceRectF &sRect, Surface *dest, const SliceRect &dRect, const Options &options);
 		void blit3D(Surface *source, Surface *dest);
 
+		// Filters each level from the previous one, for levelCount levels of faceCount faces stored face by face.
+		// Returns false when the formats aren't supported.
+		bool generateMipmaps(Surface *const *levels, int levelCount, int faceCount);
+
+		// Converts a slice of a surface update, returns false when the formats aren't supported
+		bool convert(void *dest, Format destFormat, int dPitchB, const void *source, Format sourceFormat, int sPitchB, int width, int height);
+
+		// Number of blits per source and destination format which no routine supports, and were done per pixel
+		static std::map<std::pair<Format, Format>, int> getFallbacks();
+
+		// Starts compiling the routines which read back and copy color buffers of the given formats on a background
+		// thread, so a process's first glReadPixels() or glCopyTexImage2D() finds them in the shared cache
+		static void warmUp(const Format *renderTargetFormats, int count);
+
 	private:
 		bool fastClear(void *pixel, sw::Format format, Surface *dest, const SliceRect &dRect, unsigned int rgbaMask);
 
@@ -106,14 +155,23 @@ namespace sw
 		bool read(Int4 &color, Pointer<Byte> element, const State &state);
 		bool write(Int4 &color, Pointer<Byte> element, const State &state);
 		static bool GetScale(float4& scale, Format format);
-		static bool ApplyScaleAndClamp(Float4 &value, const State &state, bool preScaled = false);
+		static bool ApplyScaleAndClamp(Float4 &value, const State &state, Pointer<Byte> &constants, bool preScaled = false);
 		static Int ComputeOffset(Int &x, Int &y, Int &pitchB, int bytes, bool quadLayout);
-		static Float4 LinearToSRGB(Float4 &color);
-		static Float4 sRGBtoLinear(Float4 &color);
+		static void WritePacked(Float4 &color, Pointer<Byte> element, int bytes, const int (&bits)[4], const int (&shift)[4], unsigned int fill, const State &state);   // Leaves masked out fields unchanged
+		static Float4 LinearToSRGB(Float4 &color, Pointer<Byte> &constants);
+		static Float4 sRGBtoLinear(Float4 &color, Pointer<Byte> &constants);
 		bool blitReactor(Surface *source, const SliceRectF &sRect, Surface *dest, const SliceRect &dRect, const Options &options);
 		Routine *generate(const State &state);
-
-		RoutineCache<State> *blitCache;
+		Routine *generateSwizzle(const State &state);
+		static bool isSwizzle(Format sourceFormat, Format destFormat);
+		Routine *getRoutine(const State &state);
+		static void run(void (*function)(const BlitData *data), const BlitData &data, int texels);   // Splits large blits across threads
+		static void blitTask(void *parameters);
+		static void mipmapTask(void *parameters);
+		static void warmUpTask(void *parameters);
+
+		std::shared_ptr<RoutineCache<State>> blitCache;   // Shared by all blitters
+		std::vector<State> unsupported;
 		MutexLock criticalSection;
 	};
 }
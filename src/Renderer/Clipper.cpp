@@ -29,13 +29,16 @@ namespace sw
 	{
 	}
 
-	unsigned int Clipper::computeClipFlags(const float4 &v)
+	unsigned int Clipper::computeClipFlags(const float4 &v, const DrawData &data)
 	{
-		return ((v.x > v.w)     ? CLIP_RIGHT  : 0) |
-		       ((v.y > v.w)     ? CLIP_TOP    : 0) |
+		float wx = v.w * data.guardBandX[0];
+		float wy = v.w * data.guardBandY[0];
+
+		return ((v.x > wx)      ? CLIP_RIGHT  : 0) |
+		       ((v.y > wy)      ? CLIP_TOP    : 0) |
 		       ((v.z > v.w)     ? CLIP_FAR    : 0) |
-		       ((v.x < -v.w)    ? CLIP_LEFT   : 0) |
-		       ((v.y < -v.w)    ? CLIP_BOTTOM : 0) |
+		       ((v.x < -wx)     ? CLIP_LEFT   : 0) |
+		       ((v.y < -wy)     ? CLIP_BOTTOM : 0) |
 		       ((v.z < n * v.w) ? CLIP_NEAR   : 0) |
 		       Clipper::CLIP_FINITE;   // FIXME: xyz finite
 	}
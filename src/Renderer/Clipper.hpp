@@ -56,7 +56,7 @@ namespace sw
 
 		~Clipper();
 
-		unsigned int computeClipFlags(const float4 &v);
+		unsigned int computeClipFlags(const float4 &v, const DrawData &data);   // Sides against the guard band, like the vertex routine
 		bool clip(Polygon &polygon, int clipFlagsOr, const DrawCall &draw);
 
 	private:
@@ -36,13 +36,18 @@ namespace sw
 	bool colorsDefaultToZero = false;
 
 	bool forceWindowed = false;
-	bool quadLayoutEnabled = false;
+	bool quadLayoutEnabled = false;         // Unfinished, sampling, blits and presentation only read linear color buffers
 	bool veryEarlyDepthTest = true;
+	bool hierarchicalDepthTest = true;
+	bool deferredClears = true;
+	bool tiledTextures = false;
 	bool complementaryDepthBuffer = false;
 	bool postBlendSRGB = false;
 	bool exactColorRounding = false;
 	TransparencyAntialiasing transparencyAntialiasing = TRANSPARENCY_NONE;
 	bool forceClearRegisters = false;
+	bool commandTrace = false;   // Capture the API calls, for the APIs which support it
+	int uniformSpecialization = 0;   // Draws after which routines are specialized on unchanged branch uniforms, 0 disables it
 
 	Context::Context()
 	{
@@ -304,8 +309,10 @@ namespace sw
 		vertexShader = 0;
 
 		instanceID = 0;
+		instanceCount = 1;
 
 		occlusionEnabled = false;
+		occlusionAnySample = false;
 		transformFeedbackQueryEnabled = false;
 		transformFeedbackEnabled = 0;
 
@@ -492,6 +492,7 @@ namespace sw
 
 		// Instancing
 		int instanceID;
+		int instanceCount;   // Instances drawn by one draw call, starting at instanceID
 
 		// Fixed-function vertex pipeline state
 		bool lightingEnable;
@@ -506,6 +507,7 @@ namespace sw
 		bool colorVertexEnable;
 
 		bool occlusionEnabled;
+		bool occlusionAnySample;   // The active occlusion queries only need to know whether any sample passed
 		bool transformFeedbackQueryEnabled;
 		uint64_t transformFeedbackEnabled;
 
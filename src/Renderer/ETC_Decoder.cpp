@@ -14,6 +14,10 @@
 
 #include "ETC_Decoder.hpp"
 
+#include "Common/CPUID.hpp"
+#include "Common/Math.hpp"
+#include "Common/Thread.hpp"
+
 namespace
 {
 	inline int clampByte(int value)
@@ -91,52 +95,48 @@ namespace
 		// Decodes unsigned single or dual channel block to bytes
 		static void DecodeBlock(const ETC2** sources, unsigned char *dest, int nbChannels, int x, int y, int w, int h, int pitch, bool isSigned, bool isEAC)
 		{
-			if(isEAC)
+			// Each channel only has 8 distinct values, looked up by the 3-bit index of the pixel
+			int values[2][8];
+			unsigned long long indices[2];
+
+			for(int c = 0; c < nbChannels; c++)
 			{
-				for(int j = 0; j < 4 && (y + j) < h; j++)
-				{
-					int* sDst = reinterpret_cast<int*>(dest);
-					for(int i = 0; i < 4 && (x + i) < w; i++)
-					{
-						for(int c = nbChannels - 1; c >= 0; c--)
-						{
-							sDst[i * nbChannels + c] = clampEAC(sources[c]->getSingleChannel(i, j, isSigned, true), isSigned);
-						}
-					}
-					dest += pitch;
-				}
+				sources[c]->getSingleChannelValues(values[c], isSigned, isEAC);
+				indices[c] = sources[c]->getSingleChannelIndices();
 			}
-			else
+
+			int columns = (w - x < 4) ? w - x : 4;
+			int rows = (h - y < 4) ? h - y : 4;
+
+			for(int j = 0; j < rows; j++)
 			{
-				if(isSigned)
+				int* iDst = reinterpret_cast<int*>(dest);
+				signed char* sDst = reinterpret_cast<signed char*>(dest);
+
+				for(int i = 0; i < columns; i++)
 				{
-					signed char* sDst = reinterpret_cast<signed char*>(dest);
-					for(int j = 0; j < 4 && (y + j) < h; j++)
+					int shift = 45 - 3 * (i * 4 + j);
+
+					for(int c = nbChannels - 1; c >= 0; c--)
 					{
-						for(int i = 0; i < 4 && (x + i) < w; i++)
+						int value = values[c][(indices[c] >> shift) & 7];
+
+						if(isEAC)
 						{
-							for(int c = nbChannels - 1; c >= 0; c--)
-							{
-								sDst[i * nbChannels + c] = clampSByte(sources[c]->getSingleChannel(i, j, isSigned, false));
-							}
+							iDst[i * nbChannels + c] = value;
 						}
-						sDst += pitch;
-					}
-				}
-				else
-				{
-					for(int j = 0; j < 4 && (y + j) < h; j++)
-					{
-						for(int i = 0; i < 4 && (x + i) < w; i++)
+						else if(isSigned)
 						{
-							for(int c = nbChannels - 1; c >= 0; c--)
-							{
-								dest[i * nbChannels + c] = clampByte(sources[c]->getSingleChannel(i, j, isSigned, false));
-							}
+							sDst[i * nbChannels + c] = static_cast<signed char>(value);
+						}
+						else
+						{
+							dest[i * nbChannels + c] = static_cast<unsigned char>(value);
 						}
-						dest += pitch;
 					}
 				}
+
+				dest += pitch;
 			}
 		}
 
@@ -616,40 +616,41 @@ namespace
 		}
 
 		// Single channel utility functions
-		inline int getSingleChannel(int x, int y, bool isSigned, bool isEAC) const
+		void getSingleChannelValues(int values[8], bool isSigned, bool isEAC) const   // Clamped value of each index
 		{
 			int codeword = isSigned ? signed_base_codeword : base_codeword;
-			return isEAC ?
-			       ((multiplier == 0) ?
-			        (codeword * 8 + 4 + getSingleChannelModifier(x, y)) :
-			        (codeword * 8 + 4 + getSingleChannelModifier(x, y) * multiplier * 8)) :
-			       codeword + getSingleChannelModifier(x, y) * multiplier;
+			const int *modifiers = getSingleChannelModifiers();
+
+			for(int i = 0; i < 8; i++)
+			{
+				if(isEAC)
+				{
+					int value = codeword * 8 + 4 + ((multiplier == 0) ? modifiers[i] : modifiers[i] * multiplier * 8);
+					values[i] = clampEAC(value, isSigned);
+				}
+				else
+				{
+					int value = codeword + modifiers[i] * multiplier;
+					values[i] = isSigned ? clampSByte(value) : clampByte(value);
+				}
+			}
 		}
 
-		inline int getSingleChannelIndex(int x, int y) const
+		// The 16 3-bit indices, stored big endian with the index of pixel (x, y) at bit 45 - 3 * (x * 4 + y)
+		inline unsigned long long getSingleChannelIndices() const
 		{
-			switch(x * 4 + y)
+			const unsigned char *bytes = reinterpret_cast<const unsigned char*>(this);
+			unsigned long long indices = 0;
+
+			for(int i = 2; i < 8; i++)
 			{
-			case 0: return ma;
-			case 1: return mb;
-			case 2: return mc1 << 1 | mc2;
-			case 3: return md;
-			case 4: return me;
-			case 5: return mf1 << 2 | mf2;
-			case 6: return mg;
-			case 7: return mh;
-			case 8: return mi;
-			case 9: return mj;
-			case 10: return mk1 << 1 | mk2;
-			case 11: return ml;
-			case 12: return mm;
-			case 13: return mn1 << 2 | mn2;
-			case 14: return mo;
-			default: return mp; // 15
+				indices = (indices << 8) | bytes[i];
 			}
+
+			return indices;
 		}
 
-		inline int getSingleChannelModifier(int x, int y) const
+		inline const int *getSingleChannelModifiers() const
 		{
 			static const int modifierTable[16][8] = { { -3, -6, -9, -15, 2, 5, 8, 14 },
 			{ -3, -7, -10, -13, 2, 6, 9, 12 },
@@ -668,16 +669,100 @@ namespace
 			{ -4, -6, -8, -9, 3, 5, 7, 8 },
 			{ -3, -5, -7, -9, 2, 4, 6, 8 } };
 
-			return modifierTable[table_index][getSingleChannelIndex(x, y)];
+			return modifierTable[table_index];
 		}
 	};
 }
 
+namespace
+{
+	enum
+	{
+		MAX_DECODE_THREADS = 8,
+		MIN_DECODE_PIXELS = 0x40000,   // Smaller images aren't worth starting threads for
+	};
+
+	struct DecodeBand
+	{
+		const unsigned char *src;
+		int srcPitch;
+		unsigned char *dst;
+		int w;
+		int h;
+		int dstW;
+		int dstH;
+		int dstPitch;
+		int dstBpp;
+		ETC_Decoder::InputType inputType;
+	};
+}
+
 // Decodes 1 to 4 channel images to 8 bit output
-bool ETC_Decoder::Decode(const unsigned char* src, unsigned char *dst, int w, int h, int dstW, int dstH, int dstPitch, int dstBpp, InputType inputType)
+bool ETC_Decoder::Decode(const unsigned char* src, int srcPitch, unsigned char *dst, int w, int h, int dstW, int dstH, int dstPitch, int dstBpp, InputType inputType)
+{
+	switch(inputType)
+	{
+	case ETC_R_SIGNED:
+	case ETC_R_UNSIGNED:
+	case ETC_RGB:
+	case ETC_RGB_PUNCHTHROUGH_ALPHA:
+	case ETC_RG_SIGNED:
+	case ETC_RG_UNSIGNED:
+	case ETC_RGBA:
+		break;
+	default:
+		return false;
+	}
+
+	// Large images are split into bands of block rows, decoded concurrently
+	int blockRows = (h + 3) / 4;
+	int threadCount = sw::max(sw::min(sw::min(sw::CPUID::processAffinity(), (int)MAX_DECODE_THREADS), w * h / MIN_DECODE_PIXELS), 1);
+	DecodeBand band[MAX_DECODE_THREADS];
+	sw::Thread *thread[MAX_DECODE_THREADS] = {};
+
+	for(int i = threadCount - 1; i >= 0; i--)
+	{
+		int y0 = 4 * (blockRows * i / threadCount);
+		int y1 = 4 * (blockRows * (i + 1) / threadCount);
+
+		band[i].src = src + (y0 / 4) * srcPitch;
+		band[i].srcPitch = srcPitch;
+		band[i].dst = dst + y0 * dstPitch;
+		band[i].w = w;
+		band[i].h = sw::min(y1, h) - y0;
+		band[i].dstW = dstW;
+		band[i].dstH = dstH - y0;
+		band[i].dstPitch = dstPitch;
+		band[i].dstBpp = dstBpp;
+		band[i].inputType = inputType;
+
+		if(i > 0)
+		{
+			thread[i] = new sw::Thread(DecodeTask, &band[i]);
+		}
+	}
+
+	DecodeTask(&band[0]);
+
+	for(int i = 1; i < threadCount; i++)
+	{
+		thread[i]->join();
+		delete thread[i];
+	}
+
+	return true;
+}
+
+void ETC_Decoder::DecodeTask(void *parameters)
+{
+	const DecodeBand *band = static_cast<const DecodeBand*>(parameters);
+
+	DecodeRows(band->src, band->srcPitch, band->dst, band->w, band->h, band->dstW, band->dstH, band->dstPitch, band->dstBpp, band->inputType);
+}
+
+bool ETC_Decoder::DecodeRows(const unsigned char* src, int srcPitch, unsigned char *dst, int w, int h, int dstW, int dstH, int dstPitch, int dstBpp, InputType inputType)
 {
 	const ETC2* sources[2];
-	sources[0] = (const ETC2*)src;
 
 	unsigned char alphaValues[4][4] = { { 255, 255, 255, 255 }, { 255, 255, 255, 255 }, { 255, 255, 255, 255 }, { 255, 255, 255, 255 } };
 
@@ -687,6 +772,7 @@ bool ETC_Decoder::Decode(const unsigned char* src, unsigned char *dst, int w, in
 	case ETC_R_UNSIGNED:
 		for(int y = 0; y < h; y += 4)
 		{
+			sources[0] = (const ETC2*)(src + (y / 4) * srcPitch);
 			unsigned char *dstRow = dst + (y * dstPitch);
 			for(int x = 0; x < w; x += 4, sources[0]++)
 			{
@@ -696,9 +782,10 @@ bool ETC_Decoder::Decode(const unsigned char* src, unsigned char *dst, int w, in
 		break;
 	case ETC_RG_SIGNED:
 	case ETC_RG_UNSIGNED:
-		sources[1] = sources[0] + 1;
 		for(int y = 0; y < h; y += 4)
 		{
+			sources[0] = (const ETC2*)(src + (y / 4) * srcPitch);
+			sources[1] = sources[0] + 1;
 			unsigned char *dstRow = dst + (y * dstPitch);
 			for(int x = 0; x < w; x += 4, sources[0] += 2, sources[1] += 2)
 			{
@@ -710,6 +797,7 @@ bool ETC_Decoder::Decode(const unsigned char* src, unsigned char *dst, int w, in
 	case ETC_RGB_PUNCHTHROUGH_ALPHA:
 		for(int y = 0; y < h; y += 4)
 		{
+			sources[0] = (const ETC2*)(src + (y / 4) * srcPitch);
 			unsigned char *dstRow = dst + (y * dstPitch);
 			for(int x = 0; x < w; x += 4, sources[0]++)
 			{
@@ -720,6 +808,7 @@ bool ETC_Decoder::Decode(const unsigned char* src, unsigned char *dst, int w, in
 	case ETC_RGBA:
 		for(int y = 0; y < h; y += 4)
 		{
+			sources[0] = (const ETC2*)(src + (y / 4) * srcPitch);
 			unsigned char *dstRow = dst + (y * dstPitch);
 			for(int x = 0; x < w; x += 4)
 			{
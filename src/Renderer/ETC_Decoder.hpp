@@ -28,6 +28,7 @@ public:
 
 	/// ETC_Decoder::Decode - Decodes 1 to 4 channel images to 8 bit output
 	/// @param src            Pointer to ETC2 encoded image
+	/// @param srcPitch       src image pitch (bytes per row of blocks)
 	/// @param dst            Pointer to BGRA, 8 bit output
 	/// @param w              src image width
 	/// @param h              src image height
@@ -37,5 +38,10 @@ public:
 	/// @param dstBpp         dst image bytes per pixel
 	/// @param inputType      src's format
 	/// @return               true if the decoding was performed
-	static bool Decode(const unsigned char* src, unsigned char *dst, int w, int h, int dstW, int dstH, int dstPitch, int dstBpp, InputType inputType);
+	static bool Decode(const unsigned char* src, int srcPitch, unsigned char *dst, int w, int h, int dstW, int dstH, int dstPitch, int dstBpp, InputType inputType);
+
+private:
+	// Decodes the rows of blocks of a band of the image on the calling thread
+	static bool DecodeRows(const unsigned char* src, int srcPitch, unsigned char *dst, int w, int h, int dstW, int dstH, int dstPitch, int dstBpp, InputType inputType);
+	static void DecodeTask(void *parameters);
 };
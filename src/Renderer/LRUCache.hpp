@@ -17,9 +17,21 @@
 
 #include "Common/Math.hpp"
 
+#include <utility>
+
 namespace sw
 {
-	template<class Key, class Data>
+	// Hashes all bytes of the key. Keys which already store a hash can provide a cheaper functor.
+	template<class Key>
+	struct LRUHash
+	{
+		unsigned int operator()(const Key &key) const
+		{
+			return static_cast<unsigned int>(FNV_1a(reinterpret_cast<const unsigned char*>(&key), sizeof(Key)));
+		}
+	};
+
+	template<class Key, class Data, class Hash = LRUHash<Key>>
 	class LRUCache
 	{
 	public:
@@ -27,55 +39,85 @@ namespace sw
 
 		~LRUCache();
 
-		Data *query(const Key &key) const;
+		Data *query(const Key &key);
 		Data *add(const Key &key, Data *data);
-	
+		Data *replace(const Key &key, Data *data);   // Adds the key when it isn't cached
+		void resize(int n);   // Keeps the most recently used entries which fit
+
 		int getSize() {return size;}
-		Key &getKey(int i) {return key[i];}
+
+		unsigned int getHits() {return hits;}
+		unsigned int getMisses() {return misses;}
+		unsigned int getEvictions() {return evictions;}
 
 	private:
+		enum {NONE = -1};
+
+		void unlink(int i);       // From the recency list
+		void pushFront(int i);
+		void unchain(int i);      // From its hash bucket
+		int bucketOf(unsigned int h) const;
+
 		int size;
-		int mask;
-		int top;
+		int shift;                // Selects the bucket from the top hash bits, there are twice as many as entries
 		int fill;
+		int head;                 // Most recently used
+		int tail;                 // Evicted next
 
 		Key *key;
-		Key **ref;
 		Data **data;
+		unsigned int *hash;
+		int *next;                // Recency list
+		int *prev;
+		int *chain;               // Next entry in the same bucket
+		int *bucket;
+
+		unsigned int hits;
+		unsigned int misses;
+		unsigned int evictions;
 	};
 }
 
 namespace sw
 {
-	template<class Key, class Data>
-	LRUCache<Key, Data>::LRUCache(int n)
+	template<class Key, class Data, class Hash>
+	LRUCache<Key, Data, Hash>::LRUCache(int n)
 	{
 		size = ceilPow2(n);
-		mask = size - 1;
-		top = 0;
+		shift = 32 - static_cast<int>(log2(2 * size));
 		fill = 0;
+		head = NONE;
+		tail = NONE;
 
 		key = new Key[size];
-		ref = new Key*[size];
 		data = new Data*[size];
+		hash = new unsigned int[size];
+		next = new int[size];
+		prev = new int[size];
+		chain = new int[size];
+		bucket = new int[2 * size];
 
 		for(int i = 0; i < size; i++)
 		{
 			data[i] = nullptr;
+		}
 
-			ref[i] = &key[i];
+		for(int i = 0; i < 2 * size; i++)
+		{
+			bucket[i] = NONE;
 		}
+
+		hits = 0;
+		misses = 0;
+		evictions = 0;
 	}
 
-	template<class Key, class Data>
-	LRUCache<Key, Data>::~LRUCache()
+	template<class Key, class Data, class Hash>
+	LRUCache<Key, Data, Hash>::~LRUCache()
 	{
 		delete[] key;
 		key = nullptr;
 
-		delete[] ref;
-		ref = nullptr;
-
 		for(int i = 0; i < size; i++)
 		{
 			if(data[i])
@@ -87,58 +129,174 @@ namespace sw
 
 		delete[] data;
 		data = nullptr;
+
+		delete[] hash;
+		delete[] next;
+		delete[] prev;
+		delete[] chain;
+		delete[] bucket;
 	}
 
-	template<class Key, class Data>
-	Data *LRUCache<Key, Data>::query(const Key &key) const
+	template<class Key, class Data, class Hash>
+	Data *LRUCache<Key, Data, Hash>::query(const Key &key)
 	{
-		for(int i = top; i > top - fill; i--)
-		{
-			int j = i & mask;
+		unsigned int h = Hash()(key);
 
-			if(key == *ref[j])
+		for(int i = bucket[bucketOf(h)]; i != NONE; i = chain[i])
+		{
+			if(hash[i] == h && key == this->key[i])
 			{
-				Data *hit = data[j];
-
-				if(i != top)
+				if(i != head)
 				{
-					// Move one up
-					int k = (j + 1) & mask;
-
-					Data *swapD = data[k];
-					data[k] = data[j];
-					data[j] = swapD;
-
-					Key *swapK = ref[k];
-					ref[k] = ref[j];
-					ref[j] = swapK;
+					unlink(i);
+					pushFront(i);
 				}
 
-				return hit;
+				hits++;
+
+				return data[i];
 			}
 		}
 
+		misses++;
+
 		return nullptr;   // Not found
 	}
 
-	template<class Key, class Data>
-	Data *LRUCache<Key, Data>::add(const Key &key, Data *data)
+	template<class Key, class Data, class Hash>
+	Data *LRUCache<Key, Data, Hash>::add(const Key &key, Data *data)
 	{
-		top = (top + 1) & mask;
-		fill = fill + 1 < size ? fill + 1 : size;
+		int i;
+
+		if(fill < size)
+		{
+			i = fill++;
+		}
+		else   // Replace the least recently used entry
+		{
+			i = tail;
+
+			unlink(i);
+			unchain(i);
 
-		*ref[top] = key;
+			this->data[i]->unbind();
+			evictions++;
+		}
+
+		unsigned int h = Hash()(key);
+		int b = bucketOf(h);
+
+		this->key[i] = key;
+		this->data[i] = data;
+		hash[i] = h;
+		chain[i] = bucket[b];
+		bucket[b] = i;
+
+		pushFront(i);
 
 		data->bind();
 
-		if(this->data[top])
+		return data;
+	}
+
+	template<class Key, class Data, class Hash>
+	Data *LRUCache<Key, Data, Hash>::replace(const Key &key, Data *data)
+	{
+		unsigned int h = Hash()(key);
+
+		for(int i = bucket[bucketOf(h)]; i != NONE; i = chain[i])
 		{
-			this->data[top]->unbind();
+			if(hash[i] == h && key == this->key[i])
+			{
+				data->bind();
+				this->data[i]->unbind();
+				this->data[i] = data;
+
+				return data;
+			}
 		}
 
-		this->data[top] = data;
+		return add(key, data);
+	}
 
-		return data;
+	template<class Key, class Data, class Hash>
+	void LRUCache<Key, Data, Hash>::resize(int n)
+	{
+		if(ceilPow2(n) == size)
+		{
+			return;
+		}
+
+		LRUCache resized(n);
+		int excess = max(fill - resized.size, 0);
+
+		// Least recently used first, so the kept entries retain their order
+		for(int i = tail; i != NONE; i = prev[i])
+		{
+			if(excess > 0)
+			{
+				excess--;
+				evictions++;
+			}
+			else
+			{
+				resized.add(key[i], data[i]);
+			}
+
+			data[i]->unbind();
+			data[i] = nullptr;
+		}
+
+		// The statistics carry over, the old arrays get deleted with the temporary
+		std::swap(size, resized.size);
+		std::swap(shift, resized.shift);
+		std::swap(fill, resized.fill);
+		std::swap(head, resized.head);
+		std::swap(tail, resized.tail);
+		std::swap(key, resized.key);
+		std::swap(this->data, resized.data);
+		std::swap(hash, resized.hash);
+		std::swap(next, resized.next);
+		std::swap(prev, resized.prev);
+		std::swap(chain, resized.chain);
+		std::swap(bucket, resized.bucket);
+	}
+
+	template<class Key, class Data, class Hash>
+	void LRUCache<Key, Data, Hash>::unlink(int i)
+	{
+		if(prev[i] != NONE) next[prev[i]] = next[i]; else head = next[i];
+		if(next[i] != NONE) prev[next[i]] = prev[i]; else tail = prev[i];
+	}
+
+	template<class Key, class Data, class Hash>
+	void LRUCache<Key, Data, Hash>::pushFront(int i)
+	{
+		prev[i] = NONE;
+		next[i] = head;
+
+		if(head != NONE) prev[head] = i; else tail = i;
+
+		head = i;
+	}
+
+	template<class Key, class Data, class Hash>
+	int LRUCache<Key, Data, Hash>::bucketOf(unsigned int h) const
+	{
+		return static_cast<int>((h * 0x9E3779B1u) >> shift);   // Fibonacci hashing spreads weak hashes like XOR folds
+	}
+
+	template<class Key, class Data, class Hash>
+	void LRUCache<Key, Data, Hash>::unchain(int i)
+	{
+		int *link = &bucket[bucketOf(hash[i])];
+
+		while(*link != i)
+		{
+			link = &chain[*link];
+		}
+
+		*link = chain[i];
 	}
 }
 
@@ -14,6 +14,7 @@
 
 #include "PixelProcessor.hpp"
 
+#include "Renderer.hpp"
 #include "Surface.hpp"
 #include "Primitive.hpp"
 #include "Shader/PixelPipeline.hpp"
@@ -27,8 +28,11 @@
 namespace sw
 {
 	extern bool complementaryDepthBuffer;
+	extern bool hierarchicalDepthTest;
+	extern bool deferredClears;
 	extern TransparencyAntialiasing transparencyAntialiasing;
 	extern bool perspectiveCorrection;
+	extern int uniformSpecialization;
 
 	bool precachePixel = false;
 
@@ -72,14 +76,13 @@ namespace sw
 		                             // Round to nearest LOD [0.7, 1.4]:  0.0
 		                             // Round to lowest LOD  [1.0, 2.0]:  0.5
 
-		routineCache = 0;
-		setRoutineCacheSize(1024);
+		shaderProfiling = false;
+		pipelineProfiling = false;
+		quadCounting = false;
 	}
 
 	PixelProcessor::~PixelProcessor()
 	{
-		delete routineCache;
-		routineCache = 0;
 	}
 
 	void PixelProcessor::setFloatConstant(unsigned int index, const float value[4])
@@ -159,6 +162,21 @@ namespace sw
 		}
 	}
 
+	bool PixelProcessor::uniformBuffersLocked(byte *const *u, sw::Resource *const uniformBuffers[]) const
+	{
+		for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; ++i)
+		{
+			const Resource *buffer = uniformBufferInfo[i].buffer;
+
+			if(buffer != uniformBuffers[i] || (buffer && static_cast<const byte*>(buffer->data()) + uniformBufferInfo[i].offset != u[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	void PixelProcessor::setRenderTarget(int index, Surface *renderTarget, unsigned int layer)
 	{
 		context->renderTarget[index] = renderTarget;
@@ -932,8 +950,7 @@ namespace sw
 
 	void PixelProcessor::setRoutineCacheSize(int cacheSize)
 	{
-		delete routineCache;
-		routineCache = new RoutineCache<State>(clamp(cacheSize, 1, 65536), precachePixel ? "sw-pixel" : 0);
+		routineCache = RoutineCache<State, State::Hash>::shared(clamp(cacheSize, 1, 65536), precachePixel ? "sw-pixel" : 0);
 	}
 
 	void PixelProcessor::setFogRanges(float start, float end)
@@ -966,8 +983,19 @@ namespace sw
 			state.shaderID = 0;
 		}
 
+		state.clusterCount = Renderer::getClusterCount();
+		state.rasterTileHeight = Renderer::getRasterTileHeight();
+
+		if(context->pixelShader && uniformSpecialization > 0)
+		{
+			state.specializedUniforms = context->pixelShader->specializeConstants(c, uniformSpecialization, state.specializedValue);
+		}
+
 		state.depthOverride = context->pixelShader && context->pixelShader->depthOverride();
 		state.shaderContainsKill = context->pixelShader ? context->pixelShader->containsKill() : false;
+		state.shaderProfiled = shaderProfiling && context->pixelShaderModel() > 0x0104;   // Not by the integer pipeline
+		state.pipelineProfiled = pipelineProfiling;
+		state.quadsCounted = quadCounting;
 
 		if(context->alphaTestActive())
 		{
@@ -1004,14 +1032,20 @@ namespace sw
 			state.depthTestActive = true;
 			state.depthCompareMode = context->depthCompareMode;
 			state.quadLayoutDepthBuffer = Surface::hasQuadLayout(context->depthBuffer->getInternalFormat());
+			state.hierarchicalDepth = hierarchicalDepthTest && context->depthBuffer->hasHierarchicalDepth();
+			state.depthClearTiles = deferredClears && context->depthBuffer->hasClearTiles();
 		}
 
+		// Depth and stencil only quads don't run the shader, so they interpolate neither its inputs, w, nor z for fog
+		const bool colorUsed = context->colorUsed();
+
 		state.occlusionEnabled = context->occlusionEnabled;
+		state.occlusionAnySample = context->occlusionEnabled && context->occlusionAnySample && !colorUsed && !context->depthWriteActive() && !context->stencilActive();
 
 		state.fogActive = context->fogActive();
-		state.pixelFogMode = context->pixelFogActive();
-		state.wBasedFog = context->wBasedFog && context->pixelFogActive() != FOG_NONE;
-		state.perspective = context->perspectiveActive();
+		state.pixelFogMode = colorUsed ? context->pixelFogActive() : FOG_NONE;
+		state.wBasedFog = context->wBasedFog && state.pixelFogMode != FOG_NONE;
+		state.perspective = colorUsed && context->perspectiveActive();
 		state.depthClamp = (context->depthBias != 0.0f) || (context->slopeDepthBias != 0.0f);
 
 		if(context->alphaBlendActive())
@@ -1031,13 +1065,15 @@ namespace sw
 		{
 			state.colorWriteMask |= context->colorWriteActive(i) << (4 * i);
 			state.targetFormat[i] = context->renderTargetInternalFormat(i);
+			state.colorClearTiles |= (deferredClears && context->renderTarget[i] && context->renderTarget[i]->hasClearTiles()) << i;
+			state.colorSampleTiles |= (context->renderTarget[i] && context->renderTarget[i]->hasSampleTiles()) << i;
 		}
 
 		state.writeSRGB	= context->writeSRGB && context->renderTarget[0] && Surface::isSRGBwritable(context->renderTarget[0]->getExternalFormat());
 		state.multiSample = context->getMultiSampleCount();
 		state.multiSampleMask = context->multiSampleMask;
 
-		if(state.multiSample > 1 && context->pixelShader)
+		if(state.multiSample > 1 && context->pixelShader && colorUsed)
 		{
 			state.centroid = context->pixelShader->containsCentroid();
 		}
@@ -1071,13 +1107,22 @@ namespace sw
 				}
 				else break;
 			}
+
+			if(state.pipelineProfiled && state.sampler[i].textureType != TEXTURE_NULL)
+			{
+				state.sampler[i].compressedFormat = context->sampler[i].hasCompressedTexture();
+			}
 		}
 
 		const bool point = context->isDrawPoint(true);
 		const bool sprite = context->pointSpriteActive();
 		const bool flatShading = (context->shadingMode == SHADING_FLAT) || point;
 
-		if(context->pixelShaderModel() < 0x0300)
+		if(!colorUsed)
+		{
+			// The pixel shader doesn't run, only depth and stencil are written
+		}
+		else if(context->pixelShaderModel() < 0x0300)
 		{
 			for(int coordinate = 0; coordinate < 8; coordinate++)
 			{
@@ -1182,31 +1227,101 @@ namespace sw
 		return state;
 	}
 
-	Routine *PixelProcessor::routine(const State &state)
+	Routine *PixelProcessor::routine(const State &state, OptimizationLevel level)
 	{
-		Routine *routine = routineCache->query(state);
+		Routine *routine = routineCache->acquire(state);
+		RoutineTelemetry::recordCacheQuery("PixelRoutine", routine != nullptr);
+
+		if(routine)
+		{
+			return routine;
+		}
+
+		State key;
+		uint64_t shaderFingerprint = 0;
 
-		if(!routine)
+		if(routineCache->isPersistent())
 		{
-			const bool integerPipeline = (context->pixelShaderModel() <= 0x0104);
-			QuadRasterizer *generator = nullptr;
+			key = state;
+			key.shaderID = 0;
+			key.hash = 0;
+			shaderFingerprint = context->pixelShader ? context->pixelShader->getFingerprint() : 0;
+
+			routine = routineCache->load(key, shaderFingerprint);
+
+			if(routine)
+			{
+				return routineCache->acquire(state, routine);
+			}
+		}
 
-			if(integerPipeline)
+		routine = generate(state, level);
+
+		Routine *cached = routineCache->acquire(state, routine);
+
+		if(cached == routine)
+		{
+			if(level == OptimizationQuick)
 			{
-				generator = new PixelPipeline(state, context->pixelShader);
+				routineCache->addQuick(routine);   // Not stored, the optimized one replaces it
 			}
 			else
 			{
-				generator = new PixelProgram(state, context->pixelShader);
+				routineCache->store(key, shaderFingerprint, routine);
 			}
+		}
 
-			generator->generate();
-			routine = (*generator)(L"PixelRoutine_%0.8X", state.shaderID);
-			delete generator;
+		return cached;
+	}
+
+	Routine *PixelProcessor::cachedRoutine(const State &state)
+	{
+		return routineCache->acquire(state);
+	}
+
+	bool PixelProcessor::isHot(Routine *routine, int threshold)
+	{
+		return routineCache->countUse(routine, threshold);
+	}
+
+	Routine *PixelProcessor::optimizedRoutine(const State &state)
+	{
+		Routine *routine = routineCache->replace(state, generate(state, OptimizationHot));
+
+		if(routineCache->isPersistent())
+		{
+			State key = state;
+			key.shaderID = 0;
+			key.hash = 0;
 
-			routineCache->add(state, routine);
+			routineCache->store(key, context->pixelShader ? context->pixelShader->getFingerprint() : 0, routine);
 		}
 
 		return routine;
 	}
+
+	Routine *PixelProcessor::generate(const State &state, OptimizationLevel level)
+	{
+		const bool integerPipeline = (context->pixelShaderModel() <= 0x0104);
+		QuadRasterizer *generator = nullptr;
+
+		Nucleus::setOptimizationLevel(level);
+
+		if(integerPipeline)
+		{
+			generator = new PixelPipeline(state, context->pixelShader);
+		}
+		else
+		{
+			generator = new PixelProgram(state, context->pixelShader);
+		}
+
+		generator->generate();
+		Routine *routine = (*generator)(L"PixelRoutine_%0.8X", state.shaderID);
+		delete generator;
+
+		Nucleus::setOptimizationLevel(OptimizationDefault);
+
+		return routine;
+	}
 }
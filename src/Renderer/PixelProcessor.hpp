@@ -33,14 +33,24 @@ namespace sw
 			unsigned int computeHash();
 
 			int shaderID;
+			unsigned int specializedUniforms;   // Specializable constants of the shader folded into the routine
+			unsigned int specializedValue[MAX_SPECIALIZED_UNIFORMS];
+
+			int clusterCount;       // Rows are interleaved between this many clusters, which the thread count can change
+			int rasterTileHeight;
 
 			bool depthOverride                        : 1;   // TODO: Eliminate by querying shader.
 			bool shaderContainsKill                   : 1;   // TODO: Eliminate by querying shader.
+			bool shaderProfiled                       : 1;   // Instructions accumulate their cycles into DrawData::shaderProfile
+			bool pipelineProfiled                     : 1;   // Stages accumulate their cycles and operation counts into DrawData::pipelineProfile
+			bool quadsCounted                         : 1;   // Covered, shaded and written quads are counted into DrawData::quadStatistics
 
 			DepthCompareMode depthCompareMode         : BITS(DEPTH_LAST);
 			AlphaCompareMode alphaCompareMode         : BITS(ALPHA_LAST);
 			bool depthWriteEnable                     : 1;
 			bool quadLayoutDepthBuffer                : 1;
+			bool hierarchicalDepth                    : 1;
+			bool depthClearTiles                      : 1;
 
 			bool stencilActive                        : 1;
 			StencilCompareMode stencilCompareMode     : BITS(STENCIL_LAST);
@@ -64,6 +74,7 @@ namespace sw
 			FogMode pixelFogMode                      : BITS(FOG_LAST);
 			bool specularAdd                          : 1;
 			bool occlusionEnabled                     : 1;
+			bool occlusionAnySample                   : 1;
 			bool wBasedFog                            : 1;
 			bool perspective                          : 1;
 			bool depthClamp                           : 1;
@@ -77,6 +88,8 @@ namespace sw
 			BlendOperation blendOperationAlpha        : BITS(BLENDOP_LAST);
 
 			unsigned int colorWriteMask                       : RENDERTARGETS * 4;   // Four component bit masks
+			unsigned int colorClearTiles                      : RENDERTARGETS;
+			unsigned int colorSampleTiles                     : RENDERTARGETS;
 			Format targetFormat[RENDERTARGETS];
 			bool writeSRGB                                    : 1;
 			unsigned int multiSample                          : 3;
@@ -133,6 +146,11 @@ namespace sw
 			}
 
 			unsigned int hash;
+
+			struct Hash   // Computed when the state is set up
+			{
+				unsigned int operator()(const State &state) const { return state.hash; }
+			};
 		};
 
 		struct Stencil
@@ -197,6 +215,7 @@ namespace sw
 
 		void setUniformBuffer(int index, sw::Resource* buffer, int offset);
 		void lockUniformBuffers(byte** u, sw::Resource* uniformBuffers[]);
+		bool uniformBuffersLocked(byte *const *u, sw::Resource *const uniformBuffers[]) const;   // Whether lockUniformBuffers() returned the current bindings
 
 		void setRenderTarget(int index, Surface *renderTarget, unsigned int layer = 0);
 		void setDepthBuffer(Surface *depthBuffer, unsigned int layer = 0);
@@ -306,7 +325,10 @@ namespace sw
 
 	protected:
 		const State update() const;
-		Routine *routine(const State &state);
+		Routine *routine(const State &state, OptimizationLevel level = OptimizationDefault);   // Bound, has to be unbound by the caller
+		Routine *cachedRoutine(const State &state);      // Null when the routine still has to be generated
+		bool isHot(Routine *routine, int threshold);     // Counts a draw using a routine generated with OptimizationQuick
+		Routine *optimizedRoutine(const State &state);   // Regenerates a hot routine, replacing the cached one
 		void setRoutineCacheSize(int routineCacheSize);
 
 		// Shader constants
@@ -321,6 +343,10 @@ namespace sw
 		Fog fog;
 		Factor factor;
 
+		bool shaderProfiling;     // Shader routines generated from now on are instrumented
+		bool pipelineProfiling;   // Pixel routines generated from now on time their stages
+		bool quadCounting;        // Pixel routines generated from now on count the quads they process
+
 	private:
 		struct UniformBufferInfo
 		{
@@ -332,10 +358,11 @@ namespace sw
 		UniformBufferInfo uniformBufferInfo[MAX_UNIFORM_BUFFER_BINDINGS];
 
 		void setFogRanges(float start, float end);
+		Routine *generate(const State &state, OptimizationLevel level);
 
 		Context *const context;
 
-		RoutineCache<State> *routineCache;
+		std::shared_ptr<RoutineCache<State, State::Hash>> routineCache;   // Shared by all renderers, set by the renderer's configuration
 	};
 }
 
@@ -36,15 +36,42 @@ namespace sw
 
 	struct Primitive
 	{
+		struct Span
+		{
+			unsigned short left;
+			unsigned short right;
+		};
+
+		// The rasterizer adds a zero length span to the top and bottom of the polygon to allow
+		// for 2x2 pixel processing. We need an even number of spans to keep accesses aligned.
+		struct Outline
+		{
+			Span underflow[2];
+			Span span[OUTLINE_RESOLUTION];
+			Span overflow[2];
+		};
+
 		int yMin;
 		int yMax;
 
 		float4 xQuad;
 		float4 yQuad;
 
+		float area;
+		int affine;   // Same w at all vertices, so the interpolants were set up without perspective
+
+		// Masks for two-sided stencil
+		int64_t clockwiseMask;
+		int64_t invClockwiseMask;
+
+		// Room for one outline per sample, kept outside of the record so it can be sized to the interpolants.
+		// With multisampling the rows hold the spans of all samples next to each other, using the same memory.
+		Outline *outline;
+
 		PlaneEquation z;
 		PlaneEquation w;
 
+		// Must be last, only the planes up to the highest interpolant of the draw are stored
 		union
 		{
 			struct
@@ -57,23 +84,10 @@ namespace sw
 			PlaneEquation V[MAX_FRAGMENT_INPUTS][4];
 		};
 
-		float area;
-
-		// Masks for two-sided stencil
-		int64_t clockwiseMask;
-		int64_t invClockwiseMask;
-
-		struct Span
+		static int stride(int interpolants)   // Size of a record holding the first interpolants
 		{
-			unsigned short left;
-			unsigned short right;
-		};
-
-		// The rasterizer adds a zero length span to the top and bottom of the polygon to allow
-		// for 2x2 pixel processing. We need an even number of spans to keep accesses aligned.
-		Span outlineUnderflow[2];
-		Span outline[OUTLINE_RESOLUTION];
-		Span outlineOverflow[2];
+			return OFFSET(Primitive,V) + interpolants * sizeof(V[0]);
+		}
 	};
 }
 
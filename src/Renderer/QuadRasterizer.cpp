@@ -38,54 +38,127 @@ namespace sw
 
 	void QuadRasterizer::generate()
 	{
-		#if PERF_PROFILE
+		Long pixelTime;
+
+		if(state.pipelineProfiled)
+		{
 			for(int i = 0; i < PERF_TIMERS; i++)
 			{
 				cycles[i] = 0;
 			}
 
-			Long pixelTime = Ticks();
-		#endif
+			ropOperations = 0;
+			texOperations = 0;
+			compressedTex = 0;
+			earlyDepthRejects = 0;
+			coherentBranches = 0;
+			divergentBranches = 0;
+
+			pixelTime = Ticks();
+		}
+
+		if(state.quadsCounted)
+		{
+			quadsCovered = 0;
+			quadsShaded = 0;
+			quadsWritten = 0;
+		}
 
 		constants = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,constants));
 		occlusion = 0;
-		int clusterCount = Renderer::getClusterCount();
+
+		if(state.occlusionAnySample)   // Continue from the cluster's count, so draws stop once any sample passed
+		{
+			Pointer<Byte> occlusionArray = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,occlusion));
+			occlusion = *Pointer<UInt>(occlusionArray + DrawData::CLUSTER_STRIDE * cluster);
+		}
+
+		int clusterCount = state.clusterCount;
+		int tileHeight = state.rasterTileHeight;
+		Int primitiveStride = *Pointer<Int>(data + OFFSET(DrawData,primitiveStride));
 
 		Do
 		{
 			Int yMin = *Pointer<Int>(primitive + OFFSET(Primitive,yMin));
 			Int yMax = *Pointer<Int>(primitive + OFFSET(Primitive,yMax));
 
-			Int cluster2 = cluster + cluster;
-			yMin += clusterCount * 2 - 2 - cluster2;
-			yMin &= -clusterCount * 2;
-			yMin += cluster2;
+			if(tileHeight == 2)   // Interleaved scanline pairs
+			{
+				Int cluster2 = cluster + cluster;
+				yMin += clusterCount * 2 - 2 - cluster2;
+				yMin &= -clusterCount * 2;
+				yMin += cluster2;
+			}
+			else   // Bands of tileHeight rows, primitives which don't reach the first band of this cluster are skipped
+			{
+				Int tileStart = (yMin & -(clusterCount * tileHeight)) + cluster * tileHeight;
+
+				If(tileStart + tileHeight <= yMin)
+				{
+					tileStart += clusterCount * tileHeight;
+				}
+
+				yMin = Max(tileStart, yMin & 0xFFFFFFFE);
+			}
 
 			If(yMin < yMax)
 			{
 				rasterize(yMin, yMax);
 			}
 
-			primitive += sizeof(Primitive) * state.multiSample;
+			primitive += primitiveStride;
 			count--;
+
+			if(state.occlusionAnySample)
+			{
+				If(occlusion != 0)
+				{
+					count = 0;   // The remaining primitives can't change the result
+				}
+			}
 		}
 		Until(count == 0)
 
-		if(state.occlusionEnabled)
+		if(state.occlusionAnySample)
 		{
-			UInt clusterOcclusion = *Pointer<UInt>(data + OFFSET(DrawData,occlusion) + 4 * cluster);
+			Pointer<Byte> occlusionArray = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,occlusion));
+			*Pointer<UInt>(occlusionArray + DrawData::CLUSTER_STRIDE * cluster) = occlusion;
+		}
+		else if(state.occlusionEnabled)
+		{
+			Pointer<Byte> occlusionArray = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,occlusion));
+			UInt clusterOcclusion = *Pointer<UInt>(occlusionArray + DrawData::CLUSTER_STRIDE * cluster);
 			clusterOcclusion += occlusion;
-			*Pointer<UInt>(data + OFFSET(DrawData,occlusion) + 4 * cluster) = clusterOcclusion;
+			*Pointer<UInt>(occlusionArray + DrawData::CLUSTER_STRIDE * cluster) = clusterOcclusion;
 		}
 
-		#if PERF_PROFILE
+		if(state.pipelineProfiled)
+		{
 			cycles[PERF_PIXEL] = Ticks() - pixelTime;
 
+			Pointer<Byte> profile = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,pipelineProfile)) + DrawData::PIPELINE_STRIDE * cluster;
+
 			for(int i = 0; i < PERF_TIMERS; i++)
 			{
-				*Pointer<Long>(data + OFFSET(DrawData,cycles[i]) + 8 * cluster) += cycles[i];
+				*Pointer<Long>(profile + OFFSET(PipelineProfile,cycles[i])) += cycles[i];
 			}
-		#endif
+
+			*Pointer<Long>(profile + OFFSET(PipelineProfile,ropOperations)) += ropOperations;
+			*Pointer<Long>(profile + OFFSET(PipelineProfile,texOperations)) += texOperations;
+			*Pointer<Long>(profile + OFFSET(PipelineProfile,compressedTex)) += compressedTex;
+			*Pointer<Long>(profile + OFFSET(PipelineProfile,earlyDepthRejects)) += earlyDepthRejects;
+			*Pointer<Long>(profile + OFFSET(PipelineProfile,coherentBranches)) += coherentBranches;
+			*Pointer<Long>(profile + OFFSET(PipelineProfile,divergentBranches)) += divergentBranches;
+		}
+
+		if(state.quadsCounted)
+		{
+			Pointer<Byte> statistics = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,quadStatistics)) + DrawData::CLUSTER_STRIDE * cluster;
+
+			*Pointer<Long>(statistics + OFFSET(QuadStatistics,covered)) += Long(quadsCovered);
+			*Pointer<Long>(statistics + OFFSET(QuadStatistics,shaded)) += Long(quadsShaded);
+			*Pointer<Long>(statistics + OFFSET(QuadStatistics,written)) += Long(quadsWritten);
+		}
 
 		Return();
 	}
@@ -114,34 +187,102 @@ namespace sw
 			sBuffer = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,stencilBuffer)) + yMin * *Pointer<Int>(data + OFFSET(DrawData,stencilPitchB));
 		}
 
+		Pointer<Byte> hBuffer;
+		Int hPitchB;
+
+		if(state.hierarchicalDepth)
+		{
+			hBuffer = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,hierarchicalDepth));
+			hPitchB = *Pointer<Int>(data + OFFSET(DrawData,hierarchicalDepthPitchB));
+		}
+
+		Pointer<Byte> cTiles[RENDERTARGETS];
+		Pointer<Byte> zTiles;
+
+		for(int index = 0; index < RENDERTARGETS; index++)
+		{
+			if(state.colorWriteActive(index) && (state.colorClearTiles & (1 << index)))
+			{
+				cTiles[index] = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,colorClearTiles[index]));
+			}
+		}
+
+		if(state.depthTestActive && state.depthClearTiles)
+		{
+			zTiles = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,depthClearTiles));
+		}
+
+		// Rejects 16x2 pixel tiles which are entirely behind the stored depth
+		bool hierarchicalDepthTest = state.hierarchicalDepth && !complementaryDepthBuffer && state.multiSample == 1 && !state.depthOverride && !state.stencilActive &&
+		                             (state.depthCompareMode == DEPTH_LESSEQUAL || state.depthCompareMode == DEPTH_LESS);
+
+		Pointer<Byte> outline = *Pointer<Pointer<Byte>>(primitive + OFFSET(Primitive,outline));
+		const int rowB = state.multiSample * sizeof(Primitive::Span);   // The spans of all samples are interleaved per row
+
 		Int y = yMin;
 
 		Do
 		{
-			Int x0a = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->left) + (y + 0) * sizeof(Primitive::Span)));
-			Int x0b = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->left) + (y + 1) * sizeof(Primitive::Span)));
+			Pointer<Byte> row = outline + (y + 2) * rowB;
+
+			Int x0a = Int(*Pointer<Short>(row + OFFSET(Primitive::Span,left)));
+			Int x0b = Int(*Pointer<Short>(row + rowB + OFFSET(Primitive::Span,left)));
 			Int x0 = Min(x0a, x0b);
 
 			for(unsigned int q = 1; q < state.multiSample; q++)
 			{
-				x0a = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left) + (y + 0) * sizeof(Primitive::Span)));
-				x0b = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left) + (y + 1) * sizeof(Primitive::Span)));
+				x0a = Int(*Pointer<Short>(row + q * sizeof(Primitive::Span) + OFFSET(Primitive::Span,left)));
+				x0b = Int(*Pointer<Short>(row + rowB + q * sizeof(Primitive::Span) + OFFSET(Primitive::Span,left)));
 				x0 = Min(x0, Min(x0a, x0b));
 			}
 
 			x0 &= 0xFFFFFFFE;
 
-			Int x1a = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->right) + (y + 0) * sizeof(Primitive::Span)));
-			Int x1b = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->right) + (y + 1) * sizeof(Primitive::Span)));
+			Int x1a = Int(*Pointer<Short>(row + OFFSET(Primitive::Span,right)));
+			Int x1b = Int(*Pointer<Short>(row + rowB + OFFSET(Primitive::Span,right)));
 			Int x1 = Max(x1a, x1b);
 
 			for(unsigned int q = 1; q < state.multiSample; q++)
 			{
-				x1a = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right) + (y + 0) * sizeof(Primitive::Span)));
-				x1b = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right) + (y + 1) * sizeof(Primitive::Span)));
+				x1a = Int(*Pointer<Short>(row + q * sizeof(Primitive::Span) + OFFSET(Primitive::Span,right)));
+				x1b = Int(*Pointer<Short>(row + rowB + q * sizeof(Primitive::Span) + OFFSET(Primitive::Span,right)));
 				x1 = Max(x1, Max(x1a, x1b));
 			}
 
+			// Quads between the spans of two rows which don't overlap are entirely uncovered, e.g. along thin slanted edges
+			Int gapBegin = x1;
+			Int gapEnd = x1;
+
+			if(state.multiSample == 1)
+			{
+				gapBegin = (Min(x1a, x1b) + 1) & 0xFFFFFFFE;
+				gapEnd = Min(Max(x0a, x0b), x1 - 1) & 0xFFFFFFFE;
+			}
+
+			// Tiles with a pending clear get written before their first access
+			for(int index = 0; index < RENDERTARGETS; index++)
+			{
+				if(state.colorWriteActive(index) && (state.colorClearTiles & (1 << index)))
+				{
+					Int tilesPitchB = *Pointer<Int>(data + OFFSET(DrawData,colorClearTilesPitchB[index]));
+					Pointer<Byte> tiles = cTiles[index] + (y >> 1) * tilesPitchB;
+					Int pitchB = *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index]));
+					Int pattern = *Pointer<Int>(data + OFFSET(DrawData,colorClearPattern[index]));
+
+					writeClearTiles(tiles, tilesPitchB, cBuffer[index], pitchB, pattern, Surface::bytes(state.targetFormat[index]), false, x0, x1);
+				}
+			}
+
+			if(state.depthTestActive && state.depthClearTiles)
+			{
+				Int tilesPitchB = *Pointer<Int>(data + OFFSET(DrawData,depthClearTilesPitchB));
+				Pointer<Byte> tiles = zTiles + (y >> 1) * tilesPitchB;
+				Int pitchB = *Pointer<Int>(data + OFFSET(DrawData,depthPitchB));
+				Int pattern = *Pointer<Int>(data + OFFSET(DrawData,depthClearPattern));
+
+				writeClearTiles(tiles, tilesPitchB, zBuffer, pitchB, pattern, 4, state.quadLayoutDepthBuffer, x0, x1);
+			}
+
 			Float4 yyyy = Float4(Float(y)) + *Pointer<Float4>(primitive + OFFSET(Primitive,yQuad), 16);
 
 			if(interpolateZ())
@@ -269,51 +410,307 @@ namespace sw
 
 				for(unsigned int q = 0; q < state.multiSample; q++)
 				{
-					xLeft[q] = *Pointer<Short4>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline) + y * sizeof(Primitive::Span));
+					if(state.multiSample == 1)
+					{
+						xLeft[q] = *Pointer<Short4>(row);
+					}
+					else
+					{
+						xLeft[q] = As<Short4>(Int2(*Pointer<Int>(row + q * sizeof(Primitive::Span)), *Pointer<Int>(row + rowB + q * sizeof(Primitive::Span))));
+					}
+
 					xRight[q] = xLeft[q];
 
 					xLeft[q] = Swizzle(xLeft[q], 0xA0) - Short4(1, 2, 1, 2);
 					xRight[q] = Swizzle(xRight[q], 0xF5) - Short4(0, 1, 0, 1);
 				}
 
-				For(Int x = x0, x < x1, x += 2)
+				Pointer<Byte> hRow;
+
+				if(state.hierarchicalDepth)
 				{
-					Short4 xxxx = Short4(x);
-					Int cMask[4];
+					hRow = hBuffer + (y >> 1) * hPitchB;
+				}
+
+				if(hierarchicalDepthTest)
+				{
+					Bool occluded = false;
+
+					For(Int x = x0, x < x1, x += 2)
+					{
+						Bool newTile = x == x0 || (x & 15) == 0;
+
+						If(x >= gapBegin && x < gapEnd)
+						{
+							x = gapEnd;
+							newTile = Bool(true);
+						}
+
+						If(newTile)
+						{
+							occluded = hierarchicalDepthOccluded(hRow, hPitchB, x, x1);
+						}
+
+						If(occluded)
+						{
+							if(state.pipelineProfiled)
+							{
+								earlyDepthRejects += Long((Min(x1, (x | 15) + 1) - x + 1) >> 1);
+							}
 
-					for(unsigned int q = 0; q < state.multiSample; q++)
+							x = (x | 15) - 1;   // Skip to the next tile
+						}
+						Else
+						{
+							coverQuad(cBuffer, zBuffer, sBuffer, xLeft, xRight, x, y);
+						}
+					}
+				}
+				else
+				{
+					For(Int x = x0, x < x1, x += 2)
 					{
-						Short4 mask = CmpGT(xxxx, xLeft[q]) & CmpGT(xRight[q], xxxx);
-						cMask[q] = SignMask(PackSigned(mask, mask)) & 0x0000000F;
+						If(x >= gapBegin && x < gapEnd)
+						{
+							x = gapEnd;
+						}
+
+						coverQuad(cBuffer, zBuffer, sBuffer, xLeft, xRight, x, y);
 					}
+				}
 
-					quad(cBuffer, zBuffer, sBuffer, cMask, x, y);
+				if(state.hierarchicalDepth && state.depthWriteEnable && state.depthCompareMode != DEPTH_NEVER)
+				{
+					updateHierarchicalDepth(hRow, hPitchB, zBuffer, x0, x1);
 				}
 			}
 
-			int clusterCount = Renderer::getClusterCount();
+			int clusterCount = state.clusterCount;
+			int tileHeight = state.rasterTileHeight;
 
-			for(int index = 0; index < RENDERTARGETS; index++)
+			if(tileHeight == 2)
+			{
+				advance(cBuffer, zBuffer, sBuffer, 1 + sw::log2(clusterCount));
+
+				y += 2 * clusterCount;
+			}
+			else
 			{
-				if(state.colorWriteActive(index))
+				advance(cBuffer, zBuffer, sBuffer, 1);
+
+				y += 2;
+
+				If((y & (tileHeight - 1)) == 0 && y < yMax)   // Skip the bands of the other clusters
 				{
-					cBuffer[index] += *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index])) << (1 + sw::log2(clusterCount));   // FIXME: Precompute
+					Int skip = (clusterCount - 1) * tileHeight;
+
+					for(int index = 0; index < RENDERTARGETS; index++)
+					{
+						if(state.colorWriteActive(index))
+						{
+							cBuffer[index] += skip * *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index]));
+						}
+					}
+
+					if(state.depthTestActive)
+					{
+						zBuffer += skip * *Pointer<Int>(data + OFFSET(DrawData,depthPitchB));
+					}
+
+					if(state.stencilActive)
+					{
+						sBuffer += skip * *Pointer<Int>(data + OFFSET(DrawData,stencilPitchB));
+					}
+
+					y += skip;
 				}
 			}
 
-			if(state.depthTestActive)
+			if(state.occlusionAnySample)
 			{
-				zBuffer += *Pointer<Int>(data + OFFSET(DrawData,depthPitchB)) << (1 + sw::log2(clusterCount));   // FIXME: Precompute
+				If(occlusion != 0)
+				{
+					y = yMax;
+				}
 			}
+		}
+		Until(y >= yMax)
+	}
 
-			if(state.stencilActive)
+	void QuadRasterizer::advance(Pointer<Byte> cBuffer[RENDERTARGETS], Pointer<Byte> &zBuffer, Pointer<Byte> &sBuffer, int pitchShift)
+	{
+		for(int index = 0; index < RENDERTARGETS; index++)
+		{
+			if(state.colorWriteActive(index))
 			{
-				sBuffer += *Pointer<Int>(data + OFFSET(DrawData,stencilPitchB)) << (1 + sw::log2(clusterCount));   // FIXME: Precompute
+				cBuffer[index] += *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index])) << pitchShift;   // FIXME: Precompute
 			}
+		}
 
-			y += 2 * clusterCount;
+		if(state.depthTestActive)
+		{
+			zBuffer += *Pointer<Int>(data + OFFSET(DrawData,depthPitchB)) << pitchShift;   // FIXME: Precompute
+		}
+
+		if(state.stencilActive)
+		{
+			sBuffer += *Pointer<Int>(data + OFFSET(DrawData,stencilPitchB)) << pitchShift;   // FIXME: Precompute
+		}
+	}
+
+	void QuadRasterizer::coverQuad(Pointer<Byte> cBuffer[RENDERTARGETS], Pointer<Byte> &zBuffer, Pointer<Byte> &sBuffer, Short4 xLeft[4], Short4 xRight[4], Int &x, Int &y)
+	{
+		Short4 xxxx = Short4(x);
+		Int cMask[4];
+
+		for(unsigned int q = 0; q < state.multiSample; q++)
+		{
+			Short4 mask = CmpGT(xxxx, xLeft[q]) & CmpGT(xRight[q], xxxx);
+			cMask[q] = SignMask(PackSigned(mask, mask)) & 0x0000000F;
+		}
+
+		Int coverage = cMask[0];
+
+		for(unsigned int q = 1; q < state.multiSample; q++)
+		{
+			coverage |= cMask[q];
+		}
+
+		If(coverage != 0)   // Quads outside of the outline aren't worth a stencil, depth or shading pass
+		{
+			if(state.quadsCounted)
+			{
+				quadsCovered++;
+			}
+
+			quad(cBuffer, zBuffer, sBuffer, cMask, x, y);
+		}
+	}
+
+	Bool QuadRasterizer::hierarchicalDepthOccluded(Pointer<Byte> &hRow, Int &hPitchB, Int &x, Int &x1)
+	{
+		Bool occluded = false;
+		Int tile = x >> 4;
+
+		If(tile < (hPitchB >> 2))   // Partial tiles at the right edge aren't tracked
+		{
+			// Depth is linear across the tile, so the nearest covered quad is at either end
+			Int right = (Min(x1, (tile << 4) + 16) - 1) & 0xFFFFFFFE;
+
+			Float4 xLeft = Float4(Float(x)) + *Pointer<Float4>(primitive + OFFSET(Primitive,xQuad), 16);
+			Float4 xRight = Float4(Float(right)) + *Pointer<Float4>(primitive + OFFSET(Primitive,xQuad), 16);
+
+			Float4 zLeft = interpolate(xLeft, Dz[0], zLeft, primitive + OFFSET(Primitive,z), false, false, state.depthClamp);
+			Float4 zRight = interpolate(xRight, Dz[0], zRight, primitive + OFFSET(Primitive,z), false, false, state.depthClamp);
+
+			Float4 zMin = Min(zLeft, zRight);
+			zMin = Min(zMin, Swizzle(zMin, 0x4E));
+			zMin = Min(zMin, Swizzle(zMin, 0xB1));
+
+			Float z = Extract(zMin, 0) - Float(1.0e-5f);   // Tolerates rounding differences with the per-quad interpolation
+			Float tileMax = *Pointer<Float>(hRow + 4 * tile);   // NaN when unknown
+
+			if(state.depthCompareMode == DEPTH_LESS)
+			{
+				occluded = z >= tileMax;
+			}
+			else
+			{
+				occluded = z > tileMax;
+			}
+		}
+
+		return occluded;
+	}
+
+	void QuadRasterizer::writeClearTiles(Pointer<Byte> &tiles, Int &tilesPitchB, Pointer<Byte> &buffer, Int &pitchB, Int &pattern, int bytes, bool quadLayout, Int &x0, Int &x1)
+	{
+		Int4 value = Int4(pattern);
+		Int tileEnd = Min((x1 + 15) >> 4, tilesPitchB);
+		int tileB = 16 * bytes;
+
+		For(Int tile = x0 >> 4, tile < tileEnd, tile++)
+		{
+			If(Int(*Pointer<Byte>(tiles + tile)) != 0)
+			{
+				if(quadLayout)   // Both lines of the tile are contiguous
+				{
+					Pointer<Byte> line = buffer + 2 * tileB * tile;
+
+					for(int i = 0; i < 2 * tileB; i += 16)
+					{
+						*Pointer<Int4>(line + i, 16) = value;
+					}
+				}
+				else
+				{
+					Pointer<Byte> line = buffer + tileB * tile;
+
+					for(int i = 0; i < tileB; i += 16)
+					{
+						*Pointer<Int4>(line + i) = value;
+						*Pointer<Int4>(line + pitchB + i) = value;
+					}
+				}
+
+				*Pointer<Byte>(tiles + tile) = Byte(0);
+			}
+		}
+	}
+
+	void QuadRasterizer::updateHierarchicalDepth(Pointer<Byte> &hRow, Int &hPitchB, Pointer<Byte> &zBuffer, Int &x0, Int &x1)
+	{
+		Int pitch = *Pointer<Int>(data + OFFSET(DrawData,depthPitchB));
+		Int tileEnd = Min((x1 + 15) >> 4, hPitchB >> 2);
+
+		For(Int tile = x0 >> 4, tile < tileEnd, tile++)
+		{
+			Int4 z[8];
+
+			if(!state.quadLayoutDepthBuffer)
+			{
+				Pointer<Byte> buffer = zBuffer + 64 * tile;
+
+				for(int i = 0; i < 4; i++)
+				{
+					z[i] = *Pointer<Int4>(buffer + 16 * i);
+					z[i + 4] = *Pointer<Int4>(buffer + pitch + 16 * i);
+				}
+			}
+			else
+			{
+				Pointer<Byte> buffer = zBuffer + 128 * tile;
+
+				for(int i = 0; i < 8; i++)
+				{
+					z[i] = *Pointer<Int4>(buffer + 16 * i, 16);
+				}
+			}
+
+			// Non-negative floats order like integers, NaN sorts above everything
+			Int4 zMax = z[0];
+			Int4 zMin = z[0];
+
+			for(int i = 1; i < 8; i++)
+			{
+				zMax = Max(zMax, z[i]);
+				zMin = Min(zMin, z[i]);
+			}
+
+			zMax = Max(zMax, Swizzle(zMax, 0x4E));
+			zMax = Max(zMax, Swizzle(zMax, 0xB1));
+			zMin = Min(zMin, Swizzle(zMin, 0x4E));
+			zMin = Min(zMin, Swizzle(zMin, 0xB1));
+
+			Int tileMax = Extract(zMax, 0);
+
+			If(Extract(zMin, 0) < 0)   // Negative depth or sign bit set
+			{
+				tileMax = 0x7FFFFFFF;
+			}
+
+			*Pointer<Int>(hRow + 4 * tile) = tileMax;
 		}
-		Until(y >= yMax)
 	}
 
 	Float4 QuadRasterizer::interpolate(Float4 &x, Float4 &D, Float4 &rhw, Pointer<Byte> planeEquation, bool flat, bool perspective, bool clamp)
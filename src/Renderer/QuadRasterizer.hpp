@@ -40,9 +40,19 @@ namespace sw
 
 		UInt occlusion;
 
-#if PERF_PROFILE
+		// Pipeline profile of this invocation, only used when state.pipelineProfiled
 		Long cycles[PERF_TIMERS];
-#endif
+		Long ropOperations;
+		Long texOperations;
+		Long compressedTex;
+		Long earlyDepthRejects;   // Quads rejected before shading
+		Long coherentBranches;    // Dynamic branches taken the same way by the whole quad
+		Long divergentBranches;
+
+		// Quad statistics of this invocation, only used when state.quadsCounted
+		Int quadsCovered;
+		Int quadsShaded;
+		Int quadsWritten;
 
 		virtual void quad(Pointer<Byte> cBuffer[4], Pointer<Byte> &zBuffer, Pointer<Byte> &sBuffer, Int cMask[4], Int &x, Int &y) = 0;
 
@@ -55,6 +65,11 @@ namespace sw
 
 	private:
 		void rasterize(Int &yMin, Int &yMax);
+		void advance(Pointer<Byte> cBuffer[RENDERTARGETS], Pointer<Byte> &zBuffer, Pointer<Byte> &sBuffer, int pitchShift);
+		void coverQuad(Pointer<Byte> cBuffer[RENDERTARGETS], Pointer<Byte> &zBuffer, Pointer<Byte> &sBuffer, Short4 xLeft[4], Short4 xRight[4], Int &x, Int &y);
+		Bool hierarchicalDepthOccluded(Pointer<Byte> &hRow, Int &hPitchB, Int &x, Int &x1);
+		void updateHierarchicalDepth(Pointer<Byte> &hRow, Int &hPitchB, Pointer<Byte> &zBuffer, Int &x0, Int &x1);
+		void writeClearTiles(Pointer<Byte> &tiles, Int &tilesPitchB, Pointer<Byte> &buffer, Int &pitchB, Int &pattern, int bytes, bool quadLayout, Int &x0, Int &x1);
 	};
 }
 
@@ -18,6 +18,8 @@
 #include "Surface.hpp"
 #include "Primitive.hpp"
 #include "Polygon.hpp"
+#include "RoutineStore.hpp"
+#include "WorkerPool.hpp"
 #include "Main/FrameBuffer.hpp"
 #include "Main/SwiftConfig.hpp"
 #include "Reactor/Reactor.hpp"
@@ -29,8 +31,12 @@
 #include "Common/Half.hpp"
 #include "Common/Math.hpp"
 #include "Common/Timer.hpp"
+#include "Common/TraceEvents.hpp"
 #include "Common/Debug.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 #undef max
 
 bool disableServer = true;
@@ -52,19 +58,28 @@ namespace sw
 
 	extern bool forceWindowed;
 	extern bool complementaryDepthBuffer;
+	extern bool hierarchicalDepthTest;
+	extern bool deferredClears;
+	extern bool tiledTextures;
 	extern bool postBlendSRGB;
 	extern bool exactColorRounding;
 	extern TransparencyAntialiasing transparencyAntialiasing;
 	extern bool forceClearRegisters;
+	extern bool commandTrace;
+	extern int uniformSpecialization;
 
 	extern bool precacheVertex;
 	extern bool precacheSetup;
 	extern bool precachePixel;
 
 	static const int batchSize = 128;
+	static const int64_t minTaskTicks = 50000;   // Minimum estimated duration of a primitive task
+	static const int64_t idleBatchTime = 1000000000;   // Nanoseconds between draws after which the batch memory is freed
+	static const Texture nullTexture = {};
 	AtomicInt threadCount(1);
 	AtomicInt Renderer::unitCount(1);
 	AtomicInt Renderer::clusterCount(1);
+	AtomicInt Renderer::rasterTileHeight(2);
 
 	TranscendentalPrecision logPrecision = ACCURATE;
 	TranscendentalPrecision expPrecision = ACCURATE;
@@ -72,6 +87,25 @@ namespace sw
 	TranscendentalPrecision rsqPrecision = ACCURATE;
 	bool perspectiveCorrection = true;
 
+	// Settings which are compiled into the routines without being part of their states
+	static uint64_t routineSettingsFingerprint()
+	{
+		int settings[] =
+		{
+			CPUID::supportsMMX(), CPUID::supportsCMOV(), CPUID::supportsMMX2(), CPUID::supportsSSE(), CPUID::supportsSSE2(),
+			CPUID::supportsSSE3(), CPUID::supportsSSSE3(), CPUID::supportsSSE4_1(),
+			halfIntegerCoordinates, symmetricNormalizedDepth, booleanFaceRegister, fullPixelPositionRegister,
+			leadingVertexFirst, secondaryColor, colorsDefaultToZero,
+			complementaryDepthBuffer, postBlendSRGB, exactColorRounding, transparencyAntialiasing, forceClearRegisters,
+			logPrecision, expPrecision, rcpPrecision, rsqPrecision, perspectiveCorrection,
+			static_cast<int>(sizeof(void*)),
+			optimization[0], optimization[1], optimization[2], optimization[3], optimization[4],
+			optimization[5], optimization[6], optimization[7], optimization[8], optimization[9],
+		};
+
+		return FNV_1a(reinterpret_cast<const unsigned char*>(settings), sizeof(settings));
+	}
+
 	static void setGlobalRenderingSettings(Conventions conventions, bool exactColorRounding)
 	{
 		static bool initialized = false;
@@ -90,37 +124,71 @@ namespace sw
 		}
 	}
 
-	struct Parameters
-	{
-		Renderer *renderer;
-		int threadIndex;
-	};
-
 	DrawCall::DrawCall()
 	{
 		queries = 0;
+		timed = false;
+		startTime = 0;
 
+		vsDirtyConstFBegin = 0;
 		vsDirtyConstF = VERTEX_UNIFORM_VECTORS + 1;
 		vsDirtyConstI = 16;
 		vsDirtyConstB = 16;
 
+		psDirtyConstFBegin = 0;
 		psDirtyConstF = FRAGMENT_UNIFORM_VECTORS;
 		psDirtyConstI = 16;
 		psDirtyConstB = 16;
 
 		references = -1;
+		sequence = 0;
+		dependency = 0;
+		managedTextures = 0;
+
+		prepassVertices = nullptr;
+		prepassFirst = 0;
+		prepassCount = 0;
+		prepassVertexSize = 0;
+		prepassChunks = 0;
+		prepassIssued = 0;
+		prepassPending = 0;
 
-		data = (DrawData*)allocate(sizeof(DrawData));
+		instancePrimitives = 0;
+
+		vertexLookups = 0;
+		vertexMisses = 0;
+
+		profiledShader = 0;
+
+		data = (DrawData*)allocate(sizeof(DrawData), 16, true, MEMORY_RENDERER);
 		data->constants = &constants;
+		data->shaderProfile = nullptr;
+		data->pipelineProfile = nullptr;
+		data->quadStatistics = nullptr;
 	}
 
 	DrawCall::~DrawCall()
 	{
 		delete queries;
 
+		freeClusterData();
+		delete[] data->shaderProfile;
+		deallocate(data->pipelineProfile);
+		deallocate(data->quadStatistics);
 		deallocate(data);
 	}
 
+	void DrawCall::allocateClusterData(int clusterCount)
+	{
+		data->occlusion = (unsigned int*)allocate(clusterCount * DrawData::CLUSTER_STRIDE, DrawData::CLUSTER_STRIDE, true, MEMORY_RENDERER);
+	}
+
+	void DrawCall::freeClusterData()
+	{
+		deallocate(data->occlusion);
+		data->occlusion = nullptr;
+	}
+
 	Renderer::Renderer(Context *context, Conventions conventions, bool exactColorRounding) : VertexProcessor(context), PixelProcessor(context), SetupProcessor(context), context(context), viewport()
 	{
 		setGlobalRenderingSettings(conventions, exactColorRounding);
@@ -134,49 +202,68 @@ namespace sw
 		updateProjectionMatrix = true;
 		updateClipPlanes = true;
 
-		#if PERF_HUD
-			resetTimers();
-		#endif
+		profiling = PERF_HUD != 0;
+		quadCounting = profiling;
+		profileCallback = nullptr;
+		profileUserData = nullptr;
 
-		for(int i = 0; i < 16; i++)
-		{
-			vertexTask[i] = 0;
+		vertexTask = nullptr;
+		lastDrawTime = 0;
 
-			worker[i] = 0;
-			resume[i] = 0;
-			suspend[i] = 0;
-		}
+		vertexRoutine = nullptr;
+		setupRoutine = nullptr;
+		pixelRoutine = nullptr;
+
+		threadState = nullptr;
+		threadStateCount = 0;
 
 		threadsAwake = 0;
 		resumeApp = new Event();
 
 		currentDraw = 0;
 		nextDraw = 0;
+		drawSequence = 0;
+		retireWaiters = 0;
 
-		qHead = 0;
-		qSize = 0;
+		triangleBatch = nullptr;
+		primitiveBatch = nullptr;
+		outlineBatch = nullptr;
 
-		for(int i = 0; i < 16; i++)
-		{
-			triangleBatch[i] = 0;
-			primitiveBatch[i] = 0;
-		}
+		primitiveProgress = nullptr;
+		pixelProgress = nullptr;
+		taskDeque = nullptr;
 
-		for(int draw = 0; draw < DRAW_COUNT; draw++)
-		{
-			drawCall[draw] = new DrawCall();
-			drawList[draw] = drawCall[draw];
-		}
+		drawCount = 0;
+		drawCountBits = 0;
+		drawCall = nullptr;
+		drawList = nullptr;
+		drawQueueStalled = false;
 
-		for(int unit = 0; unit < 16; unit++)
-		{
-			primitiveProgress[unit].init();
-		}
+		primitiveCost = 0;
+		resetBatchSizeCounts();
 
-		for(int cluster = 0; cluster < 16; cluster++)
-		{
-			pixelProgress[cluster].init();
-		}
+		vertexCacheSize = 64;
+		resetVertexCacheCounts();
+
+		pinThreads = false;
+		concurrentCompilation = false;
+		tieredCompilation = 0;
+
+		indexRangeValid = false;
+		indexRangeMin = 0;
+		indexRangeMax = 0;
+		prepassBuffer = nullptr;
+		prepassCapacity = 0;
+		prepassDraw = nullptr;
+
+		drawCulling = false;
+		cullingRoutine = nullptr;
+		cullingData = nullptr;
+		cullingTask = nullptr;
+		cullingVertices = nullptr;
+
+		drawMerging = true;
+		lastDrawMergeable = false;
 
 		clipFlags = 0;
 
@@ -184,12 +271,35 @@ namespace sw
 		updateConfiguration(true);
 
 		sync = new Resource(0);
+
+		readbackThread = nullptr;
+		pendingReadbacks = 0;
+		readbackEvent = new Event();
+
+		pendingTimestamps = 0;
+		readbackDone = new Event();
+		drawRetired = new Event();
+		terminateReadbacks = false;
 	}
 
 	Renderer::~Renderer()
 	{
 		sync->destruct();
 
+		if(readbackThread)
+		{
+			finishReadbacks();
+
+			terminateReadbacks = true;
+			readbackEvent->signal();
+			readbackThread->join();
+			delete readbackThread;
+		}
+
+		delete readbackEvent;
+		delete readbackDone;
+		delete drawRetired;
+
 		delete clipper;
 		clipper = nullptr;
 
@@ -199,11 +309,35 @@ namespace sw
 		terminateThreads();
 		delete resumeApp;
 
-		for(int draw = 0; draw < DRAW_COUNT; draw++)
+		for(int draw = 0; draw < drawCount; draw++)
 		{
 			delete drawCall[draw];
 		}
 
+		delete[] drawCall;
+		delete[] drawList;
+
+		deallocate(prepassBuffer);
+
+		if(cullingTask)
+		{
+			cullingTask->vertexCache.free();
+		}
+
+		deallocate(cullingData);
+		deallocate(cullingTask);
+		deallocate(cullingVertices);
+
+		if(cullingRoutine) cullingRoutine->unbind();
+		if(vertexRoutine) vertexRoutine->unbind();
+		if(setupRoutine) setupRoutine->unbind();
+		if(pixelRoutine) pixelRoutine->unbind();
+
+		if(!shaderProfiles.empty())
+		{
+			printShaderProfiles("sw-shader-profile.txt");
+		}
+
 		delete swiftConfig;
 	}
 
@@ -211,7 +345,7 @@ namespace sw
 	void* Renderer::operator new(size_t size)
 	{
 		ASSERT(size == sizeof(Renderer)); // This operator can't be called from a derived class
-		return sw::allocate(sizeof(Renderer), 16);
+		return sw::allocate(sizeof(Renderer), 16, true, MEMORY_RENDERER);
 	}
 
 	void Renderer::operator delete(void * mem)
@@ -230,9 +364,41 @@ namespace sw
 
 		context->drawType = drawType;
 
+		if(pendingReadbacks)
+		{
+			// Readbacks of the render targets have to see them before this draw modifies them
+			for(int index = 0; index < RENDERTARGETS; index++)
+			{
+				if(context->renderTarget[index])
+				{
+					finishReadbacks(context->renderTarget[index]);
+				}
+			}
+
+			if(context->depthBuffer)
+			{
+				finishReadbacks(context->depthBuffer);
+			}
+
+			if(context->stencilBuffer)
+			{
+				finishReadbacks(context->stencilBuffer);
+			}
+		}
+
 		updateConfiguration();
 		updateClipper();
 
+		// Batch memory is allocated again as units and threads take on work
+		int64_t drawTime = Timer::nanoseconds();
+
+		if(drawTime - lastDrawTime > idleBatchTime && threadsAwake == 0 && drawsRetired(drawSequence))
+		{
+			freeBatches();
+		}
+
+		lastDrawTime = drawTime;
+
 		int ss = context->getSuperSampleCount();
 		int ms = context->getMultiSampleCount();
 		bool requiresSync = false;
@@ -251,13 +417,37 @@ namespace sw
 
 			if(update || oldMultiSampleMask != context->multiSampleMask)
 			{
-				vertexState = VertexProcessor::update(drawType);
-				setupState = SetupProcessor::update();
-				pixelState = PixelProcessor::update();
+				const VertexShader *vertexShader = context->vertexShader;
+				context->vertexShader = routineVertexShader();
+
+				const VertexProcessor::State newVertexState = VertexProcessor::update(drawType);
+				const SetupProcessor::State newSetupState = SetupProcessor::update();
+				const PixelProcessor::State newPixelState = PixelProcessor::update();
+
+				// Consecutive draws mostly share their states, which then keep the bound routines without a cache lookup
+				bool vertexChanged = !vertexRoutine || !(newVertexState == vertexState);
+				bool setupChanged = !setupRoutine || !(newSetupState == setupState);
+				bool pixelChanged = !pixelRoutine || !(newPixelState == pixelState);
+
+				if(vertexChanged) vertexState = newVertexState;
+				if(setupChanged) setupState = newSetupState;
+				if(pixelChanged) pixelState = newPixelState;
+
+				updateRoutines(vertexChanged, setupChanged, pixelChanged);
+
+				context->vertexShader = vertexShader;
+			}
+
+			if(drawCulling && isCulled(count))
+			{
+				sync->unlock();
+				continue;
+			}
 
-				vertexRoutine = VertexProcessor::routine(vertexState);
-				setupRoutine = SetupProcessor::routine(setupState);
-				pixelRoutine = PixelProcessor::routine(pixelState);
+			if(pixelState.occlusionAnySample && !vertexState.transformFeedbackEnabled && anySamplesPassed())
+			{
+				sync->unlock();   // Nothing is written and the result of the queries can't change
+				continue;
 			}
 
 			int batch = batchSize / ms;
@@ -293,16 +483,36 @@ namespace sw
 				setupPrimitives = &Renderer::setupPoints;
 			}
 
+			// Runs of small draws which continue the last one get appended to it, paying its setup and scheduling once
+			bool mergeable = drawMerging && ss == 1 && isMergeable(drawType);
+			DrawInputs inputs;
+
+			if(mergeable)
+			{
+				getDrawInputs(inputs);
+
+				if(mergeDraw(inputs, indexOffset, count, batch, setupPrimitives))
+				{
+					sync->unlock();
+					continue;
+				}
+			}
+
+			if(drawQueueStalled)
+			{
+				growDrawQueue();
+			}
+
 			DrawCall *draw = nullptr;
 
 			do
 			{
-				for(int i = 0; i < DRAW_COUNT; i++)
+				for(int i = 0; i < drawCount; i++)
 				{
 					if(drawCall[i]->references == -1)
 					{
 						draw = drawCall[i];
-						drawList[nextDraw & DRAW_COUNT_BITS] = draw;
+						drawList[nextDraw & drawCountBits] = draw;
 
 						break;
 					}
@@ -310,6 +520,7 @@ namespace sw
 
 				if(!draw)
 				{
+					drawQueueStalled = drawCount < MAX_DRAW_COUNT;
 					resumeApp->wait();
 				}
 			}
@@ -317,6 +528,11 @@ namespace sw
 
 			DrawData *data = draw->data;
 
+			draw->timed = false;
+			draw->startTime = 0;
+			draw->dependency = 0;
+			draw->managedTextures = 0;
+
 			if(queries.size() != 0)
 			{
 				draw->queries = new std::list<Query*>();
@@ -327,12 +543,109 @@ namespace sw
 					{
 						++query->reference; // Atomic
 						draw->queries->push_back(query);
+						draw->timed |= (query->type == Query::TIME_ELAPSED);
 					}
 				}
 			}
 
+			int instanceCount = context->instanceCount;
+
+			if(batch > 1)
+			{
+				batch = chooseBatchSize(count * instanceCount, batch);
+			}
+
+			batchSizeCount[sw::log2(batch)]++;
+
 			draw->drawType = drawType;
 			draw->batchSize = batch;
+			draw->ticks = 0;
+
+			draw->prepassVertices = nullptr;
+			draw->prepassPending = 0;
+			draw->vertexLookups = 0;
+			draw->vertexMisses = 0;
+			draw->visiblePrimitives = 0;
+			draw->vertexTime = 0;
+			draw->setupTime = 0;
+			draw->pixelTime = 0;
+
+			if(pixelState.shaderProfiled)
+			{
+				const PixelShader *shader = context->pixelShader;
+				size_t length = shader->getLength();
+
+				draw->profiledShader = shader->getSerialID();
+				data->shaderProfile = new int64_t[2 * length * clusterCount]();
+
+				shaderProfileMutex.lock();
+
+				ShaderProfile &profile = shaderProfiles[draw->profiledShader];
+
+				if(profile.instructions.empty())
+				{
+					for(size_t i = 0; i < length; i++)
+					{
+						profile.instructions.push_back(shader->getInstruction(i)->string(shader->getShaderType(), shader->getShaderModel()));
+					}
+
+					profile.cycles.resize(length);
+					profile.executions.resize(length);
+					profile.draws = 0;
+				}
+
+				shaderProfileMutex.unlock();
+			}
+
+			if(pixelState.pipelineProfiled)
+			{
+				data->pipelineProfile = (PipelineProfile*)allocate(clusterCount * DrawData::PIPELINE_STRIDE, DrawData::CLUSTER_STRIDE, true, MEMORY_RENDERER);   // Cleared to zero
+			}
+
+			if(pixelState.quadsCounted)
+			{
+				data->quadStatistics = (QuadStatistics*)allocate(clusterCount * DrawData::CLUSTER_STRIDE, DrawData::CLUSTER_STRIDE, true, MEMORY_RENDERER);
+			}
+
+			// Large indexed draws transform their vertex range once, in parallel, instead of per batch
+			if(indexRangeValid && threadCount > 1 && !prepassDraw && !vertexState.transformFeedbackEnabled && instanceCount == 1)
+			{
+				unsigned int first = indexRangeMin & ~3;   // Keep the routine's groups of four vertices aligned
+				unsigned int vertexCount = indexRangeMax - first + 1;
+
+				// Only pays off when vertices are referenced by several primitives
+				if(vertexCount >= PREPASS_MIN_VERTICES && vertexCount <= PREPASS_MAX_VERTICES && 3 * count >= 2 * vertexCount)
+				{
+					if(vertexCount > prepassCapacity)
+					{
+						deallocate(prepassBuffer);
+						prepassCapacity = ceilPow2(vertexCount);
+						prepassBuffer = (Vertex*)allocate(prepassCapacity * sizeof(Vertex), 16, true, MEMORY_RENDERER);
+					}
+
+					draw->prepassVertices = prepassBuffer;
+					draw->prepassFirst = first;
+					draw->prepassCount = vertexCount;
+
+					// Outputs follow the projected coordinates, so the unwritten ones at the end needn't be copied
+					int outputs = 0;
+
+					for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
+					{
+						if(vertexState.output[i].write)
+						{
+							outputs = i + 1;
+						}
+					}
+
+					draw->prepassVertexSize = OFFSET(Vertex,v[outputs]);
+					draw->prepassChunks = (vertexCount + PREPASS_CHUNK_SIZE - 1) / PREPASS_CHUNK_SIZE;
+					draw->prepassIssued = 0;
+					draw->prepassPending = draw->prepassChunks;
+
+					prepassDraw = draw;
+				}
+			}
 
 			vertexRoutine->bind();
 			setupRoutine->bind();
@@ -349,9 +662,14 @@ namespace sw
 
 			for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
 			{
-				draw->vertexStream[i] = context->input[i].resource;
-				data->input[i] = context->input[i].buffer;
-				data->stride[i] = context->input[i].stride;
+				const Stream &input = context->input[i];
+
+				draw->vertexStream[i] = input.resource;
+				data->input[i] = input.buffer;
+				data->stride[i] = input.divisor ? 0 : input.stride;
+
+				draw->instanceDivisor[i] = vertexState.input[i].instanced ? input.divisor : 0;
+				draw->instanceStride[i] = input.stride;
 
 				if(draw->vertexStream[i])
 				{
@@ -365,10 +683,13 @@ namespace sw
 			}
 
 			draw->indexBuffer = context->indexBuffer;
+			draw->restartIndices = restartIndices;
+			draw->restartVertex = indexRangeMin;
 
 			for(int sampler = 0; sampler < TOTAL_IMAGE_UNITS; sampler++)
 			{
 				draw->texture[sampler] = 0;
+				data->mipmap[sampler] = &nullTexture;   // Unused samplers can still be read by size queries
 			}
 
 			for(int sampler = 0; sampler < TEXTURE_IMAGE_UNITS; sampler++)
@@ -376,9 +697,25 @@ namespace sw
 				if(pixelState.sampler[sampler].textureType != TEXTURE_NULL)
 				{
 					draw->texture[sampler] = context->texture[sampler];
-					draw->texture[sampler]->lock(PUBLIC, isReadWriteTexture(sampler) ? MANAGED : PRIVATE);   // If the texure is both read and written, use the same read/write lock as render targets
 
-					data->mipmap[sampler] = context->sampler[sampler].getTextureData();
+					// Share the lock of draw calls in flight which render to the texture, instead of waiting for them to retire
+					// here, and only start processing this draw call once they did
+					bool managed = false;
+					int64_t writer = lastWriter(draw->texture[sampler], managed);
+					draw->dependency = max(draw->dependency, writer);
+
+					if(managed || isReadWriteTexture(sampler))   // If the texure is both read and written, use the same read/write lock as render targets
+					{
+						draw->texture[sampler]->lock(PUBLIC, MANAGED);
+						draw->managedTextures |= 1u << sampler;
+					}
+					else
+					{
+						draw->texture[sampler]->lock(PUBLIC, PRIVATE);
+					}
+
+					draw->textureData[sampler] = context->sampler[sampler].getTextureData();
+					data->mipmap[sampler] = draw->textureData[sampler].get();
 
 					requiresSync |= context->sampler[sampler].requiresSync();
 				}
@@ -388,11 +725,22 @@ namespace sw
 			{
 				if(draw->psDirtyConstF)
 				{
-					memcpy(&data->ps.cW, PixelProcessor::cW, sizeof(word4) * 4 * (draw->psDirtyConstF < 8 ? draw->psDirtyConstF : 8));
-					memcpy(&data->ps.c, PixelProcessor::c, sizeof(float4) * draw->psDirtyConstF);
+					unsigned int begin = draw->psDirtyConstFBegin;
+
+					if(begin < 8)
+					{
+						memcpy(&data->ps.cW[begin], PixelProcessor::cW[begin], sizeof(word4) * 4 * ((draw->psDirtyConstF < 8 ? draw->psDirtyConstF : 8) - begin));
+					}
+
+					memcpy(&data->ps.c[begin], &PixelProcessor::c[begin], sizeof(float4) * (draw->psDirtyConstF - begin));
 					draw->psDirtyConstF = 0;
 				}
 
+				if(context->pixelShader->hasPrologue())
+				{
+					context->pixelShader->evaluatePrologue(data->ps.c);   // Depends on the uniforms of this draw
+				}
+
 				if(draw->psDirtyConstI)
 				{
 					memcpy(&data->ps.i, PixelProcessor::i, sizeof(int4) * draw->psDirtyConstI);
@@ -436,9 +784,23 @@ namespace sw
 						if(vertexState.sampler[sampler].textureType != TEXTURE_NULL)
 						{
 							draw->texture[TEXTURE_IMAGE_UNITS + sampler] = context->texture[TEXTURE_IMAGE_UNITS + sampler];
-							draw->texture[TEXTURE_IMAGE_UNITS + sampler]->lock(PUBLIC, PRIVATE);
 
-							data->mipmap[TEXTURE_IMAGE_UNITS + sampler] = context->sampler[TEXTURE_IMAGE_UNITS + sampler].getTextureData();
+							bool managed = false;
+							int64_t writer = lastWriter(draw->texture[TEXTURE_IMAGE_UNITS + sampler], managed);
+							draw->dependency = max(draw->dependency, writer);
+
+							if(managed)
+							{
+								draw->texture[TEXTURE_IMAGE_UNITS + sampler]->lock(PUBLIC, MANAGED);
+								draw->managedTextures |= 1u << (TEXTURE_IMAGE_UNITS + sampler);
+							}
+							else
+							{
+								draw->texture[TEXTURE_IMAGE_UNITS + sampler]->lock(PUBLIC, PRIVATE);
+							}
+
+							draw->textureData[TEXTURE_IMAGE_UNITS + sampler] = context->sampler[TEXTURE_IMAGE_UNITS + sampler].getTextureData();
+							data->mipmap[TEXTURE_IMAGE_UNITS + sampler] = draw->textureData[TEXTURE_IMAGE_UNITS + sampler].get();
 
 							requiresSync |= context->sampler[TEXTURE_IMAGE_UNITS + sampler].requiresSync();
 						}
@@ -447,10 +809,17 @@ namespace sw
 
 				if(draw->vsDirtyConstF)
 				{
-					memcpy(&data->vs.c, VertexProcessor::c, sizeof(float4) * draw->vsDirtyConstF);
+					unsigned int begin = draw->vsDirtyConstFBegin;
+
+					memcpy(&data->vs.c[begin], &VertexProcessor::c[begin], sizeof(float4) * (draw->vsDirtyConstF - begin));
 					draw->vsDirtyConstF = 0;
 				}
 
+				if(context->vertexShader->hasPrologue())
+				{
+					context->vertexShader->evaluatePrologue(data->vs.c);
+				}
+
 				if(draw->vsDirtyConstI)
 				{
 					memcpy(&data->vs.i, VertexProcessor::i, sizeof(int4) * draw->vsDirtyConstI);
@@ -463,11 +832,6 @@ namespace sw
 					draw->vsDirtyConstB = 0;
 				}
 
-				if(context->vertexShader->isInstanceIdDeclared())
-				{
-					data->instanceID = context->instanceID;
-				}
-
 				VertexProcessor::lockUniformBuffers(data->vs.u, draw->vUniformBuffers);
 				VertexProcessor::lockTransformFeedbackBuffers(data->vs.t, data->vs.reg, data->vs.row, data->vs.col, data->vs.str, draw->transformFeedbackBuffers);
 			}
@@ -475,6 +839,7 @@ namespace sw
 			{
 				data->ff = ff;
 
+				draw->vsDirtyConstFBegin = 0;
 				draw->vsDirtyConstF = VERTEX_UNIFORM_VECTORS + 1;
 				draw->vsDirtyConstI = 16;
 				draw->vsDirtyConstB = 16;
@@ -534,20 +899,10 @@ namespace sw
 			{
 				for(int cluster = 0; cluster < clusterCount; cluster++)
 				{
-					data->occlusion[cluster] = 0;
+					data->occlusion[cluster * DrawData::OCCLUSION_STRIDE] = 0;
 				}
 			}
 
-			#if PERF_PROFILE
-				for(int cluster = 0; cluster < clusterCount; cluster++)
-				{
-					for(int i = 0; i < PERF_TIMERS; i++)
-					{
-						data->cycles[i][cluster] = 0;
-					}
-				}
-			#endif
-
 			// Viewport
 			{
 				float W = 0.5f * viewport.width;
@@ -597,6 +952,15 @@ namespace sw
 				data->YYYY = replicate(Y[s][q] / H);
 				data->halfPixelX = replicate(0.5f / W);
 				data->halfPixelY = replicate(0.5f / H);
+
+				// Triangles only get clipped against the sides once they leave the guard band, the scissor discards
+				// the pixels outside the viewport. Its size keeps the setup's 28.4 fixed-point edge products in 32-bit.
+				float width = abs(viewport.width);
+				float height = abs(viewport.height);
+				float guard = max(floorf(0.25f * (sqrtf((width - height) * (width - height) + 33554432.0f) - (width + height))), 0.0f);
+
+				data->guardBandX = replicate((width > 0.0f) ? 1.0f + 2.0f * guard / width : 1.0f);
+				data->guardBandY = replicate((height > 0.0f) ? 1.0f + 2.0f * guard / height : 1.0f);
 				data->viewportHeight = abs(viewport.height);
 				data->slopeDepthBias = context->slopeDepthBias;
 				data->depthRange = Z;
@@ -624,30 +988,60 @@ namespace sw
 					{
 						unsigned int layer = context->renderTargetLayer[index];
 						requiresSync |= context->renderTarget[index]->requiresSync();
+						draw->dependency = max(draw->dependency, lastReader(context->renderTarget[index]->getResource()));   // Doesn't wait when they share the lock
 						data->colorBuffer[index] = (unsigned int*)context->renderTarget[index]->lockInternal(0, 0, layer, LOCK_READWRITE, MANAGED);
 						data->colorBuffer[index] += q * ms * context->renderTarget[index]->getSliceB(true);
 						data->colorPitchB[index] = context->renderTarget[index]->getInternalPitchB();
 						data->colorSliceB[index] = context->renderTarget[index]->getInternalSliceB();
+
+						if(deferredClears && context->renderTarget[index]->hasClearTiles())
+						{
+							data->colorClearTiles[index] = context->renderTarget[index]->getClearTiles();
+							data->colorClearTilesPitchB[index] = context->renderTarget[index]->getClearTilesPitchB();
+							data->colorClearPattern[index] = context->renderTarget[index]->getClearPattern();
+						}
+
+						if(context->renderTarget[index]->hasSampleTiles())
+						{
+							data->colorSampleTiles[index] = context->renderTarget[index]->getSampleTiles();
+							data->colorSampleTilesPitchB[index] = context->renderTarget[index]->getSampleTilesPitchB();
+						}
 					}
 				}
 
-				draw->depthBuffer = context->depthBuffer;
-				draw->stencilBuffer = context->stencilBuffer;
+				// Buffers which aren't tested don't get locked, so they're only allocated once used
+				draw->depthBuffer = context->depthBufferActive() ? context->depthBuffer : nullptr;
+				draw->stencilBuffer = context->stencilActive() ? context->stencilBuffer : nullptr;
 
 				if(draw->depthBuffer)
 				{
 					unsigned int layer = context->depthBufferLayer;
 					requiresSync |= context->depthBuffer->requiresSync();
+					draw->dependency = max(draw->dependency, lastReader(context->depthBuffer->getResource()));
 					data->depthBuffer = (float*)context->depthBuffer->lockInternal(0, 0, layer, LOCK_READWRITE, MANAGED);
 					data->depthBuffer += q * ms * context->depthBuffer->getSliceB(true);
 					data->depthPitchB = context->depthBuffer->getInternalPitchB();
 					data->depthSliceB = context->depthBuffer->getInternalSliceB();
+
+					if(hierarchicalDepthTest && context->depthBuffer->hasHierarchicalDepth())
+					{
+						data->hierarchicalDepth = context->depthBuffer->getHierarchicalDepth();
+						data->hierarchicalDepthPitchB = context->depthBuffer->getHierarchicalDepthPitchB();
+					}
+
+					if(deferredClears && context->depthBuffer->hasClearTiles())
+					{
+						data->depthClearTiles = context->depthBuffer->getClearTiles();
+						data->depthClearTilesPitchB = context->depthBuffer->getClearTilesPitchB();
+						data->depthClearPattern = context->depthBuffer->getClearPattern();
+					}
 				}
 
 				if(draw->stencilBuffer)
 				{
 					unsigned int layer = context->stencilBufferLayer;
 					requiresSync |= context->stencilBuffer->requiresSync();
+					draw->dependency = max(draw->dependency, lastReader(context->stencilBuffer->getResource()));
 					data->stencilBuffer = (unsigned char*)context->stencilBuffer->lockStencil(0, 0, layer, MANAGED);
 					data->stencilBuffer += q * ms * context->stencilBuffer->getSliceB(true);
 					data->stencilPitchB = context->stencilBuffer->getStencilPitchB();
@@ -657,16 +1051,52 @@ namespace sw
 
 			// Scissor
 			{
-				data->scissorX0 = scissor.x0;
-				data->scissorX1 = scissor.x1;
-				data->scissorY0 = scissor.y0;
-				data->scissorY1 = scissor.y1;
+				// Limited to the pixel centers within the viewport, since the guard band leaves its edges unclipped
+				float x0 = min(viewport.x0, viewport.x0 + viewport.width);
+				float x1 = max(viewport.x0, viewport.x0 + viewport.width);
+				float y0 = min(viewport.y0, viewport.y0 + viewport.height);
+				float y1 = max(viewport.y0, viewport.y0 + viewport.height);
+
+				data->scissorX0 = max(scissor.x0, (int)ceil(x0 - 0.5f));
+				data->scissorX1 = min(scissor.x1, (int)ceil(x1 - 0.5f));
+				data->scissorY0 = max(scissor.y0, (int)ceil(y0 - 0.5f));
+				data->scissorY1 = min(scissor.y1, (int)ceil(y1 - 0.5f));
+			}
+
+			// Primitive records end after the planes of the highest interpolant
+			{
+				int interpolants = 0;
+
+				for(int interpolant = 0; interpolant < MAX_FRAGMENT_INPUTS; interpolant++)
+				{
+					for(int component = 0; component < 4; component++)
+					{
+						if(setupState.gradient[interpolant][component].attribute != Unused)
+						{
+							interpolants = interpolant + 1;
+						}
+					}
+				}
+
+				data->primitiveStride = Primitive::stride(interpolants);
+			}
+
+			data->instanceID = context->instanceID;
+
+			// Textures locked for the renderer may be what this draw renders to, so later draws have to see it retire
+			lastDrawMergeable = mergeable && !draw->prepassVertices && !draw->managedTextures && !requiresSync;
+
+			if(lastDrawMergeable)
+			{
+				lastDrawInputs = inputs;
 			}
 
 			draw->primitive = 0;
-			draw->count = count;
+			draw->count = count * instanceCount;
+			draw->instancePrimitives = count;
 
-			draw->references = (count + batch - 1) / batch;
+			draw->references = instanceCount * ((count + batch - 1) / batch);
+			draw->sequence = ++drawSequence;
 
 			schedulerMutex.lock();
 			++nextDraw; // Atomic
@@ -676,21 +1106,25 @@ namespace sw
 			if(threadCount == 1)   // Use main thread for draw execution
 			{
 				threadsAwake = 1;
-				task[0].type = Task::RESUME;
+				threadState[0].task.type = Task::RESUME;
 
-				taskLoop(0);
+				while(taskLoop(0))
+				{
+				}
 			}
 			else
 			#endif
 			{
 				if(!threadsAwake)
 				{
-					suspend[0]->wait();
-
-					threadsAwake = 1;
-					task[0].type = Task::RESUME;
+					schedulerMutex.lock();
+					bool resumed = resumeThreads(1);
+					schedulerMutex.unlock();
 
-					resume[0]->signal();
+					if(resumed)
+					{
+						signalResumedThreads();
+					}
 				}
 			}
 		}
@@ -700,10 +1134,18 @@ namespace sw
 		{
 			synchronize();
 		}
+
+		// Pending draws keep their textures locked, the others get bound again before being sampled
+		Surface::trimTextureMemory();
 	}
 
 	void Renderer::clear(void *value, Format format, Surface *dest, const Rect &clearRect, unsigned int rgbaMask)
 	{
+		if(pendingReadbacks)
+		{
+			finishReadbacks(dest);   // Clears can be deferred without locking the surface
+		}
+
 		blitter->clear(value, format, dest, clearRect, rgbaMask);
 	}
 
@@ -717,83 +1159,367 @@ namespace sw
 		blitter->blit3D(source, dest);
 	}
 
-	void Renderer::threadFunction(void *parameters)
+	bool Renderer::generateMipmaps(Surface *const *levels, int levelCount, int faceCount)
 	{
-		Renderer *renderer = static_cast<Parameters*>(parameters)->renderer;
-		int threadIndex = static_cast<Parameters*>(parameters)->threadIndex;
-
-		if(logPrecision < IEEE)
-		{
-			CPUID::setFlushToZero(true);
-			CPUID::setDenormalsAreZero(true);
-		}
-
-		renderer->threadLoop(threadIndex);
+		return blitter->generateMipmaps(levels, levelCount, faceCount);
 	}
 
-	void Renderer::threadLoop(int threadIndex)
+	void Renderer::precompile(DrawType drawType)
 	{
-		while(!exitThreads)
-		{
-			taskLoop(threadIndex);
+		DrawType previousDrawType = context->drawType;
+		unsigned int previousMultiSampleMask = context->multiSampleMask;
+
+		context->drawType = drawType;
+		context->multiSampleMask = context->sampleMask & ((unsigned)0xFFFFFFFF >> (32 - context->getMultiSampleCount()));
+
+		updateConfiguration();
+		updateClipper();
+
+		sync->lock(sw::PRIVATE);
+
+		const VertexShader *vertexShader = context->vertexShader;
+		context->vertexShader = routineVertexShader();
+
+		// Generated into the shared caches without replacing the routines bound for drawing
+		Routine *routine[3];
+		routine[0] = VertexProcessor::routine(VertexProcessor::update(drawType), initialOptimization());
+		routine[1] = SetupProcessor::routine(SetupProcessor::update(), initialOptimization());
+		routine[2] = PixelProcessor::routine(PixelProcessor::update(), initialOptimization());
+
+		context->vertexShader = vertexShader;
 
-			suspend[threadIndex]->signal();
-			resume[threadIndex]->wait();
+		for(int i = 0; i < 3; i++)
+		{
+			if(routine[i]) routine[i]->unbind();
 		}
+
+		sync->unlock();
+
+		context->drawType = previousDrawType;
+		context->multiSampleMask = previousMultiSampleMask;
 	}
 
-	void Renderer::taskLoop(int threadIndex)
+	const VertexShader *Renderer::routineVertexShader() const
 	{
-		while(task[threadIndex].type != Task::SUSPEND)
+		const VertexShader *shader = context->vertexShader;
+
+		// Without color output the pixel shader doesn't run, so only the position needs to be computed
+		if(shader && !context->colorUsed() && !context->transformFeedbackEnabled)
 		{
-			scheduleTask(threadIndex);
-			executeTask(threadIndex);
+			return shader->getPositionShader();
 		}
+
+		return shader;
 	}
 
-	void Renderer::findAvailableTasks()
+	void Renderer::updateRoutines(bool vertexChanged, bool setupChanged, bool pixelChanged)
 	{
-		// Find pixel tasks
-		for(int cluster = 0; cluster < clusterCount; cluster++)
-		{
-			if(!pixelProgress[cluster].executing)
-			{
-				for(int unit = 0; unit < unitCount; unit++)
-				{
-					if(primitiveProgress[unit].references > 0)   // Contains processed primitives
-					{
-						if(pixelProgress[cluster].drawCall == primitiveProgress[unit].drawCall)
-						{
-							if(pixelProgress[cluster].processedPrimitives == primitiveProgress[unit].firstPrimitive)   // Previous primitives have been rendered
-							{
-								Task &task = taskQueue[qHead];
-								task.type = Task::PIXELS;
-								task.primitiveUnit = unit;
-								task.pixelCluster = cluster;
+		// Held bound, since the routine caches are shared with other renderers which may evict them
+		Routine *previousVertexRoutine = vertexChanged ? vertexRoutine : nullptr;
+		Routine *previousSetupRoutine = setupChanged ? setupRoutine : nullptr;
+		Routine *previousPixelRoutine = pixelChanged ? pixelRoutine : nullptr;
 
-								pixelProgress[cluster].executing = true;
+		if(vertexChanged) vertexRoutine = VertexProcessor::cachedRoutine(vertexState);
+		if(setupChanged) setupRoutine = SetupProcessor::cachedRoutine(setupState);
+		if(pixelChanged) pixelRoutine = PixelProcessor::cachedRoutine(pixelState);
 
-								// Commit to the task queue
-								qHead = (qHead + 1) & TASK_COUNT_BITS;
-								qSize++;
+		int misses = !vertexRoutine + !setupRoutine + !pixelRoutine;
 
-								break;
-							}
-						}
-					}
-				}
+		if(concurrentCompilation && misses > 1)
+		{
+			// Each processor only accesses its own routine cache and the shaders are not modified during
+			// code generation, so the draw only waits for the slowest routine instead of all three in turn.
+			Thread *vertexThread = vertexRoutine ? nullptr : new Thread(generateVertexRoutine, this);
+			Thread *setupThread = setupRoutine ? nullptr : new Thread(generateSetupRoutine, this);
+
+			if(!pixelRoutine)
+			{
+				pixelRoutine = PixelProcessor::routine(pixelState, initialOptimization());
 			}
-		}
 
-		// Find primitive tasks
-		if(currentDraw == nextDraw)
+			if(vertexThread)
+			{
+				vertexThread->join();
+				delete vertexThread;
+			}
+
+			if(setupThread)
+			{
+				setupThread->join();
+				delete setupThread;
+			}
+		}
+		else if(misses > 0)
+		{
+			if(!vertexRoutine) vertexRoutine = VertexProcessor::routine(vertexState, initialOptimization());
+			if(!setupRoutine) setupRoutine = SetupProcessor::routine(setupState, initialOptimization());
+			if(!pixelRoutine) pixelRoutine = PixelProcessor::routine(pixelState, initialOptimization());
+		}
+
+		if(tieredCompilation > 0)
+		{
+			// Regenerated on the calling thread, since the shaders are only guaranteed to exist during the draw call
+			if(VertexProcessor::isHot(vertexRoutine, tieredCompilation))
+			{
+				vertexRoutine->unbind();
+				vertexRoutine = VertexProcessor::optimizedRoutine(vertexState);
+			}
+
+			if(SetupProcessor::isHot(setupRoutine, tieredCompilation))
+			{
+				setupRoutine->unbind();
+				setupRoutine = SetupProcessor::optimizedRoutine(setupState);
+			}
+
+			if(PixelProcessor::isHot(pixelRoutine, tieredCompilation))
+			{
+				pixelRoutine->unbind();
+				pixelRoutine = PixelProcessor::optimizedRoutine(pixelState);
+			}
+		}
+
+		if(previousVertexRoutine) previousVertexRoutine->unbind();
+		if(previousSetupRoutine) previousSetupRoutine->unbind();
+		if(previousPixelRoutine) previousPixelRoutine->unbind();
+	}
+
+	void Renderer::generateVertexRoutine(void *parameters)
+	{
+		Renderer *renderer = static_cast<Renderer*>(parameters);
+
+		renderer->vertexRoutine = renderer->VertexProcessor::routine(renderer->vertexState, renderer->initialOptimization());
+	}
+
+	void Renderer::generateSetupRoutine(void *parameters)
+	{
+		Renderer *renderer = static_cast<Renderer*>(parameters);
+
+		renderer->setupRoutine = renderer->SetupProcessor::routine(renderer->setupState, renderer->initialOptimization());
+	}
+
+	bool Renderer::workerFunction(void *renderer, int threadIndex)
+	{
+		return static_cast<Renderer*>(renderer)->workerLoop(threadIndex);
+	}
+
+	// Runs the tasks of one worker thread on a thread of the pool, until it suspends or yields to other renderers
+	bool Renderer::workerLoop(int threadIndex)
+	{
+		ThreadState &state = threadState[threadIndex];
+
+		if(logPrecision < IEEE)   // The pool's threads are shared with other renderers
+		{
+			CPUID::setFlushToZero(true);
+			CPUID::setDenormalsAreZero(true);
+		}
+
+		if(state.idleTick)
+		{
+			state.profile.idleTime += Timer::ticks() - state.idleTick;
+			state.idleTick = 0;
+		}
+
+		int64_t start = Timer::nanoseconds();
+
+		while(true)
+		{
+			bool yield = taskLoop(threadIndex);
+
+			int64_t now = Timer::nanoseconds();
+			workerClient.addThreadTime(now - start);
+			start = now;
+
+			if(yield)
+			{
+				return true;   // Queued again behind the waiting threads
+			}
+
+			state.idleTick = profiling ? Timer::ticks() : 0;
+
+			// The renderer may be destroyed as soon as the thread is idle, so it's not accessed after this
+			int expected = THREAD_SCHEDULED;
+
+			if(state.schedule.compare_exchange_strong(expected, THREAD_IDLE))
+			{
+				return false;
+			}
+
+			state.schedule = THREAD_SCHEDULED;   // Resumed while suspending
+		}
+	}
+
+	// Returns true when the thread should yield to the other threads waiting for the worker pool
+	bool Renderer::taskLoop(int threadIndex)
+	{
+		while(threadState[threadIndex].task.type != Task::SUSPEND)
+		{
+			if(profiling)
+			{
+				int64_t startTick = Timer::ticks();
+				scheduleTask(threadIndex);
+				threadState[threadIndex].profile.scheduleTime += Timer::ticks() - startTick;
+			}
+			else
+			{
+				scheduleTask(threadIndex);
+			}
+
+			if(profiler.isUtilizationProfiling())
+			{
+				int64_t startTick = Timer::ticks();
+				executeTask(threadIndex);
+				profiler.addBusyTime(threadIndex, Timer::ticks() - startTick);
+			}
+			else
+			{
+				executeTask(threadIndex);
+			}
+
+			if(threadState[threadIndex].task.type != Task::SUSPEND && WorkerPool::isContended())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Tasks are packed into a single integer so deque slots can be read and written atomically
+	static int packTask(int type, int primitiveUnit, int pixelCluster)
+	{
+		return type | (primitiveUnit << 4) | (pixelCluster << 18);
+	}
+
+	Renderer::TaskDeque::TaskDeque() : slot(nullptr), mask(0)
+	{
+		top = 0;
+		bottom = 0;
+	}
+
+	Renderer::TaskDeque::~TaskDeque()
+	{
+		delete[] slot;
+	}
+
+	void Renderer::TaskDeque::init(int capacity)
+	{
+		ASSERT((capacity & (capacity - 1)) == 0);
+
+		delete[] slot;
+		slot = new std::atomic<int>[capacity];
+		mask = capacity - 1;
+
+		for(int i = 0; i < capacity; i++)
+		{
+			slot[i] = 0;
+		}
+
+		top = 0;
+		bottom = 0;
+	}
+
+	void Renderer::TaskDeque::push(int task)
+	{
+		unsigned int b = bottom.load(std::memory_order_relaxed);
+		ASSERT(b - top.load(std::memory_order_acquire) <= mask);
+
+		slot[b & mask].store(task, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	bool Renderer::TaskDeque::pop(int &task)
+	{
+		unsigned int b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		unsigned int t = top.load(std::memory_order_relaxed);
+
+		if((int)(b - t) < 0)   // Empty
+		{
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		task = slot[b & mask].load(std::memory_order_relaxed);
+
+		if(b != t)   // More than one task left, no thief can reach this one
+		{
+			return true;
+		}
+
+		// Last task, race against thieves for it
+		bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_relaxed);
+
+		return won;
+	}
+
+	Renderer::TaskDeque::StealResult Renderer::TaskDeque::steal(int &task)
+	{
+		unsigned int t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		unsigned int b = bottom.load(std::memory_order_acquire);
+
+		if((int)(b - t) <= 0)
+		{
+			return EMPTY;
+		}
+
+		task = slot[t & mask].load(std::memory_order_relaxed);
+
+		if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return ABORT;
+		}
+
+		return STOLEN;
+	}
+
+	int Renderer::TaskDeque::size() const
+	{
+		int size = (int)(bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed));
+
+		return size > 0 ? size : 0;
+	}
+
+	void Renderer::findAvailableTasks(TaskDeque &deque)
+	{
+		// Find pixel tasks
+		for(int cluster = 0; cluster < clusterCount; cluster++)
+		{
+			if(!pixelProgress[cluster].executing)
+			{
+				for(int unit = 0; unit < unitCount; unit++)
+				{
+					if(primitiveProgress[unit].references > 0)   // Contains processed primitives
+					{
+						if(pixelProgress[cluster].drawCall == primitiveProgress[unit].drawCall)
+						{
+							if(pixelProgress[cluster].processedPrimitives == primitiveProgress[unit].firstPrimitive)   // Previous primitives have been rendered
+							{
+								pixelProgress[cluster].executing = true;
+
+								// Commit to the task deque
+								deque.push(packTask(Task::PIXELS, unit, cluster));
+
+								break;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// Find primitive tasks
+		if(currentDraw == nextDraw)
 		{
 			return;   // No more primitives to process
 		}
 
 		for(int unit = 0; unit < unitCount; unit++)
 		{
-			DrawCall *draw = drawList[currentDraw & DRAW_COUNT_BITS];
+			DrawCall *draw = drawList[currentDraw & drawCountBits];
 
 			int primitive = draw->primitive;
 			int count = draw->count;
@@ -807,102 +1533,213 @@ namespace sw
 					return;   // No more primitives to process
 				}
 
-				draw = drawList[currentDraw & DRAW_COUNT_BITS];
+				draw = drawList[currentDraw & drawCountBits];
+			}
+
+			if(draw->dependency)
+			{
+				if(inFlight(draw->dependency))
+				{
+					return;   // Accesses surfaces of earlier draw calls which haven't retired yet
+				}
+
+				draw->dependency = 0;
+			}
+
+			if(draw->prepassPending > 0)   // Primitives can't be assembled before the shared vertices are transformed
+			{
+				int inFlight = draw->prepassIssued - (draw->prepassChunks - draw->prepassPending);
+
+				for(; draw->prepassIssued < draw->prepassChunks && inFlight < threadCount; inFlight++)
+				{
+					// Commit to the task deque
+					deque.push(packTask(Task::VERTICES, draw->prepassIssued++, 0));
+				}
+
+				return;
 			}
 
 			if(!primitiveProgress[unit].references)   // Task not already being executed and not still in use by a pixel unit
 			{
 				primitive = draw->primitive;
-				count = draw->count;
 				int batch = draw->batchSize;
+				int remaining = draw->instancePrimitives - primitive % draw->instancePrimitives;   // In the current instance
 
 				primitiveProgress[unit].drawCall = currentDraw;
 				primitiveProgress[unit].firstPrimitive = primitive;
-				primitiveProgress[unit].primitiveCount = count - primitive >= batch ? batch : count - primitive;
-
-				draw->primitive += batch;
+				primitiveProgress[unit].primitiveCount = remaining >= batch ? batch : remaining;
 
-				Task &task = taskQueue[qHead];
-				task.type = Task::PRIMITIVES;
-				task.primitiveUnit = unit;
+				draw->primitive += primitiveProgress[unit].primitiveCount;
 
 				primitiveProgress[unit].references = -1;
 
-				// Commit to the task queue
-				qHead = (qHead + 1) & TASK_COUNT_BITS;
-				qSize++;
+				// Commit to the task deque
+				deque.push(packTask(Task::PRIMITIVES, unit, 0));
 			}
 		}
 	}
 
-	void Renderer::scheduleTask(int threadIndex)
+	bool Renderer::stealTask(int threadIndex, int &packedTask)
 	{
-		schedulerMutex.lock();
+		for(int i = 1; i < threadCount; i++)
+		{
+			TaskDeque &victim = taskDeque[(threadIndex + i) % threadCount];
+			TaskDeque::StealResult result;
 
-		int curThreadsAwake = threadsAwake;
+			do
+			{
+				result = victim.steal(packedTask);
+			}
+			while(result == TaskDeque::ABORT);
 
-		if((int)qSize < threadCount - curThreadsAwake + 1)
-		{
-			findAvailableTasks();
+			if(result == TaskDeque::STOLEN)
+			{
+				return true;
+			}
 		}
 
-		if(qSize != 0)
+		return false;
+	}
+
+	void Renderer::scheduleTask(int threadIndex)
+	{
+		TaskDeque &deque = taskDeque[threadIndex];
+		int packedTask;
+
+		// Tasks are only ever available immediately, so no ordering is lost by taking them from any deque
+		if(!deque.pop(packedTask) && !stealTask(threadIndex, packedTask))
 		{
-			task[threadIndex] = taskQueue[(qHead - qSize) & TASK_COUNT_BITS];
-			qSize--;
+			if(profiler.isUtilizationProfiling())
+			{
+				int64_t startTick = Timer::ticks();
+				schedulerMutex.lock();
+				profiler.addSchedulerWait(Timer::ticks() - startTick);
+			}
+			else
+			{
+				schedulerMutex.lock();
+			}
+
+			// New tasks are only pushed while holding the lock, so a failed search here is conclusive
+			findAvailableTasks(deque);
 
-			if(curThreadsAwake != threadCount)
+			if(profiling)
 			{
-				int wakeup = qSize - curThreadsAwake + 1;
+				unsigned int &maxQueueDepth = threadState[threadIndex].profile.maxQueueDepth;
+				maxQueueDepth = sw::max(maxQueueDepth, (unsigned int)deque.size());
+			}
 
-				for(int i = 0; i < threadCount && wakeup > 0; i++)
-				{
-					if(task[i].type == Task::SUSPEND)
-					{
-						suspend[i]->wait();
-						task[i].type = Task::RESUME;
-						resume[i]->signal();
+			if(deque.pop(packedTask) || stealTask(threadIndex, packedTask))
+			{
+				int wakeup = deque.size() - threadsAwake + 1;
+				bool resumed = wakeup > 0 && resumeThreads(wakeup);
 
-						++threadsAwake; // Atomic
-						wakeup--;
-					}
+				schedulerMutex.unlock();
+
+				if(resumed)
+				{
+					signalResumedThreads();
 				}
 			}
+			else
+			{
+				threadState[threadIndex].task.type = Task::SUSPEND;
+
+				--threadsAwake; // Atomic
+
+				schedulerMutex.unlock();
+
+				return;
+			}
 		}
-		else
+
+		threadState[threadIndex].task.primitiveUnit = (packedTask >> 4) & 0x3FFF;
+		threadState[threadIndex].task.pixelCluster = (packedTask >> 18) & 0x3FFF;
+		threadState[threadIndex].task.type = packedTask & 0xF;
+	}
+
+	// Hands work to up to count suspended threads. Must be called while holding the scheduler lock.
+	bool Renderer::resumeThreads(int count)
+	{
+		bool resumed = false;
+
+		for(int i = 0; i < threadCount && count > 0; i++)
 		{
-			task[threadIndex].type = Task::SUSPEND;
+			if(threadState[i].task.type == Task::SUSPEND)
+			{
+				threadState[i].task.type = Task::RESUME;
+				threadState[i].resumePending = true;
 
-			--threadsAwake; // Atomic
+				++threadsAwake; // Atomic
+				count--;
+				resumed = true;
+			}
 		}
 
-		schedulerMutex.unlock();
+		return resumed;
+	}
+
+	// Wakes the threads resumed by resumeThreads(), without holding the scheduler lock
+	void Renderer::signalResumedThreads()
+	{
+		for(int i = 0; i < threadCount; i++)
+		{
+			if(threadState[i].resumePending.exchange(false))
+			{
+				// A thread which is still running gets flagged to look for tasks again instead of being queued twice
+				std::atomic<int> &schedule = threadState[i].schedule;
+				int expected = THREAD_IDLE;
+
+				while(!schedule.compare_exchange_weak(expected, expected == THREAD_IDLE ? THREAD_SCHEDULED : THREAD_RESCHEDULE))
+				{
+				}
+
+				if(expected == THREAD_IDLE)
+				{
+					WorkerPool::submit(&workerClient, workerFunction, this, i);
+				}
+			}
+		}
 	}
 
 	void Renderer::executeTask(int threadIndex)
 	{
-		#if PERF_HUD
-			int64_t startTick = Timer::ticks();
-		#endif
+		int64_t startTick = Timer::ticks();
+		int64_t taskTick = startTick;
+		ThreadProfile *profile = profiling ? &threadState[threadIndex].profile : nullptr;
 
-		switch(task[threadIndex].type)
+		switch(threadState[threadIndex].task.type)
 		{
 		case Task::PRIMITIVES:
 			{
-				int unit = task[threadIndex].primitiveUnit;
+				TraceEvent event("Primitives", "renderer");
+				int unit = threadState[threadIndex].task.primitiveUnit;
 
 				int input = primitiveProgress[unit].firstPrimitive;
 				int count = primitiveProgress[unit].primitiveCount;
-				DrawCall *draw = drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
+				DrawCall *draw = drawList[primitiveProgress[unit].drawCall & drawCountBits];
 				int (Renderer::*setupPrimitives)(int batch, int count) = draw->setupPrimitives;
 
-				processPrimitiveVertices(unit, input, count, draw->count, threadIndex);
+				if(draw->timed && draw->startTime == 0)
+				{
+					int64_t unset = 0;
+					draw->startTime.compare_exchange_strong(unset, Timer::nanoseconds());
+				}
+
+				if(!triangleBatch[unit])
+				{
+					allocateBatches(unit);   // Units are taken in order, so light loads only touch the first ones
+				}
+
+				processPrimitiveVertices(unit, input, count, draw->instancePrimitives, threadIndex);
 
-				#if PERF_HUD
+				if(profile)
+				{
 					int64_t time = Timer::ticks();
-					vertexTime[threadIndex] += time - startTick;
-					startTick = time;
-				#endif
+					profile->vertexTime += time - taskTick;
+					draw->vertexTime += time - taskTick;
+					taskTick = time;
+				}
 
 				int visible = 0;
 
@@ -911,42 +1748,87 @@ namespace sw
 					visible = (this->*setupPrimitives)(unit, count);
 				}
 
+				// Before publishing, so it's counted when the draw retires
+				int64_t endTick = Timer::ticks();
+				draw->ticks += endTick - startTick;
+
+				if(profile)
+				{
+					profile->setupTime += endTick - taskTick;
+					profile->primitiveTasks++;
+					draw->setupTime += endTick - taskTick;
+					draw->visiblePrimitives += visible;
+				}
+
 				primitiveProgress[unit].visible = visible;
 				primitiveProgress[unit].references = clusterCount;
-
-				#if PERF_HUD
-					setupTime[threadIndex] += Timer::ticks() - startTick;
-				#endif
 			}
 			break;
 		case Task::PIXELS:
 			{
-				int unit = task[threadIndex].primitiveUnit;
+				TraceEvent event("Pixels", "renderer");
+				int unit = threadState[threadIndex].task.primitiveUnit;
 				int visible = primitiveProgress[unit].visible;
 
 				if(visible > 0)
 				{
-					int cluster = task[threadIndex].pixelCluster;
+					int cluster = threadState[threadIndex].task.pixelCluster;
 					Primitive *primitive = primitiveBatch[unit];
-					DrawCall *draw = drawList[pixelProgress[cluster].drawCall & DRAW_COUNT_BITS];
+					DrawCall *draw = drawList[pixelProgress[cluster].drawCall & drawCountBits];
 					DrawData *data = draw->data;
 					PixelProcessor::RoutinePointer pixelRoutine = draw->pixelPointer;
 
 					pixelRoutine(primitive, visible, cluster, data);
+
+					int64_t time = Timer::ticks() - startTick;
+					draw->ticks += time;
+
+					if(profile)
+					{
+						draw->pixelTime += time;
+					}
 				}
 
-				finishRendering(task[threadIndex]);
+				finishRendering(threadState[threadIndex].task);
 
-				#if PERF_HUD
-					pixelTime[threadIndex] += Timer::ticks() - startTick;
-				#endif
+				if(profile)
+				{
+					profile->pixelTime += Timer::ticks() - taskTick;
+					profile->pixelTasks++;
+				}
 			}
 			break;
-		case Task::RESUME:
-			break;
-		case Task::SUSPEND:
-			break;
-		default:
+		case Task::VERTICES:
+			{
+				TraceEvent event("Vertices", "renderer");
+				DrawCall *draw = prepassDraw;
+
+				if(draw->timed && draw->startTime == 0)
+				{
+					int64_t unset = 0;
+					draw->startTime.compare_exchange_strong(unset, Timer::nanoseconds());
+				}
+
+				processPrepassVertices(threadState[threadIndex].task.primitiveUnit, threadIndex);
+
+				int64_t time = Timer::ticks() - startTick;
+				draw->ticks += time;
+
+				if(profile)
+				{
+					profile->vertexTime += time;
+					profile->vertexTasks++;
+					draw->vertexTime += time;
+				}
+
+				--draw->prepassPending; // Atomic
+			}
+			break;
+		case Task::RESUME:
+			break;
+		case Task::SUSPEND:
+			break;
+		default:
 			ASSERT(false);
 		}
 	}
@@ -955,6 +1837,266 @@ namespace sw
 	{
 		sync->lock(sw::PUBLIC);
 		sync->unlock();
+
+		if(pendingReadbacks)
+		{
+			finishReadbacks();
+		}
+	}
+
+	bool Renderer::hasRetired(int64_t sequence)
+	{
+		if(!drawsRetired(sequence))
+		{
+			return false;
+		}
+
+		if(pendingReadbacks)
+		{
+			readbackMutex.lock();
+			bool retired = readbacks.empty() || readbacks.front().sequence > sequence;
+			readbackMutex.unlock();
+
+			return retired;
+		}
+
+		return true;
+	}
+
+	bool Renderer::drawsRetired(int64_t sequence)
+	{
+		// Also called by the readback thread, while the application thread may grow the draw queue
+		schedulerMutex.lock();
+		bool retired = !inFlight(sequence);
+		schedulerMutex.unlock();
+
+		return retired;
+	}
+
+	bool Renderer::inFlight(int64_t sequence)
+	{
+		// Draw calls can retire out of order, so check all of the ones still in flight
+		for(int i = 0; i < drawCount; i++)
+		{
+			if(drawCall[i]->references != -1 && drawCall[i]->sequence <= sequence)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void Renderer::waitForDraw(int64_t sequence)
+	{
+		while(!drawsRetired(sequence))
+		{
+			resumeApp->wait();   // Signaled each time a draw call retires
+		}
+
+		while(!hasRetired(sequence))
+		{
+			readbackDone->wait();
+		}
+	}
+
+	bool Renderer::waitForRetirement(int64_t sequence, double timeout)
+	{
+		std::unique_lock<std::mutex> lock(retireMutex);
+		++retireWaiters;   // Atomic, either the retiring threads see it or the check below sees them retired
+
+		auto retired = [&]() { return hasRetired(sequence); };
+		bool satisfied = true;
+
+		if(timeout < 0)
+		{
+			retireCondition.wait(lock, retired);
+		}
+		else
+		{
+			auto duration = std::chrono::duration<double>(std::min(timeout, 1.0e9));   // Practically infinite, without overflowing the clock
+			satisfied = retireCondition.wait_for(lock, std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration), retired);
+		}
+
+		--retireWaiters;
+
+		return satisfied;
+	}
+
+	void Renderer::notifyRetirement()
+	{
+		// Taking the lock orders this after a waiter's check, so it's either waiting or sees the retirement
+		std::lock_guard<std::mutex> lock(retireMutex);
+		retireCondition.notify_all();
+	}
+
+	int64_t Renderer::queueReadback(Surface *source, const Rect &rect, Resource *buffer, void *dest, Format format, int pitchB)
+	{
+		Format sourceFormat = source->getInternalFormat();
+
+		// Multisampled surfaces need to be resolved, and quad layouts can't be converted by rows
+		if(source->getMultiSampleCount() > 1 || source->getSuperSampleCount() > 1 ||
+		   Surface::hasQuadLayout(sourceFormat) || Surface::hasQuadLayout(format) ||
+		   rect.x0 < 0 || rect.y0 < 0 || rect.x1 > source->getWidth() || rect.y1 > source->getHeight() || rect.width() <= 0 || rect.height() <= 0)
+		{
+			return 0;
+		}
+
+		// Generates the conversion routine now, or finds it unsupported, without converting anything
+		if(!blitter->convert(dest, format, pitchB, nullptr, sourceFormat, 0, 0, 0))
+		{
+			return 0;
+		}
+
+		// A readback gives up all managed locks of its surface once it starts
+		finishReadbacks(source);
+
+		// Draw calls in flight keep writing the surface with the managed accessor. Later ones wait in draw().
+		source->getResource()->lock(MANAGED);
+		buffer->lock(EXCLUSIVE);
+
+		if(!readbackThread)
+		{
+			readbackThread = new Thread(readbackRoutine, this);
+		}
+
+		Readback readback = {source, rect, buffer, dest, format, pitchB, ++drawSequence};
+
+		readbackMutex.lock();
+		readbacks.push_back(readback);
+		pendingReadbacks++;
+		readbackMutex.unlock();
+
+		readbackEvent->signal();
+
+		return readback.sequence;
+	}
+
+	bool Renderer::readPixels(Surface *source, const Rect &rect, void *dest, Format format, int pitchB)
+	{
+		Format sourceFormat = source->getInternalFormat();
+
+		if(source->getMultiSampleCount() > 1 || source->getSuperSampleCount() > 1 ||
+		   Surface::hasQuadLayout(sourceFormat) || Surface::isDepth(sourceFormat) || Surface::isStencil(sourceFormat) ||
+		   rect.x0 < 0 || rect.y0 < 0 || rect.x1 > source->getWidth() || rect.y1 > source->getHeight() || rect.width() <= 0 || rect.height() <= 0)
+		{
+			return false;
+		}
+
+		bool copy = (format == sourceFormat);
+
+		// Finds the conversion routine, or finds it unsupported, before waiting for the surface
+		if(!copy && !blitter->convert(dest, format, pitchB, nullptr, sourceFormat, 0, 0, 0))
+		{
+			return false;
+		}
+
+		const byte *s = static_cast<const byte*>(source->lockInternal(rect.x0, rect.y0, 0, LOCK_READONLY, PUBLIC));
+		int sPitchB = source->getInternalPitchB();
+
+		if(copy)
+		{
+			byte *d = static_cast<byte*>(dest);
+			size_t rowB = (size_t)Surface::bytes(format) * rect.width();
+
+			for(int y = 0; y < rect.height(); y++)
+			{
+				memcpy(d, s, rowB);
+				s += sPitchB;
+				d += pitchB;
+			}
+		}
+		else
+		{
+			blitter->convert(dest, format, pitchB, s, sourceFormat, sPitchB, rect.width(), rect.height());
+		}
+
+		source->unlockInternal();
+
+		return true;
+	}
+
+	bool Renderer::isReadbackPending(Surface *source)
+	{
+		readbackMutex.lock();
+
+		bool pending = false;
+
+		for(const Readback &readback : readbacks)
+		{
+			if(!source || readback.source == source)
+			{
+				pending = true;
+				break;
+			}
+		}
+
+		readbackMutex.unlock();
+
+		return pending;
+	}
+
+	void Renderer::finishReadbacks(Surface *source)
+	{
+		while(isReadbackPending(source))
+		{
+			readbackDone->wait();
+		}
+	}
+
+	void Renderer::readbackRoutine(void *parameters)
+	{
+		static_cast<Renderer*>(parameters)->processReadbacks();
+	}
+
+	void Renderer::processReadbacks()
+	{
+		while(!terminateReadbacks)
+		{
+			readbackEvent->wait();
+
+			while(true)
+			{
+				readbackMutex.lock();
+				bool empty = readbacks.empty();
+				Readback readback = empty ? Readback() : readbacks.front();
+				readbackMutex.unlock();
+
+				if(empty)
+				{
+					break;
+				}
+
+				while(!drawsRetired(readback.sequence))
+				{
+					drawRetired->wait();
+				}
+
+				// Trade the managed lock for an exclusive one, which doesn't let anyone else in
+				Resource *resource = readback.source->getResource();
+				resource->lock(MANAGED, EXCLUSIVE);
+
+				const Rect &rect = readback.rect;
+				void *source = readback.source->lockInternal(rect.x0, rect.y0, 0, LOCK_READONLY, EXCLUSIVE);
+				blitter->convert(readback.dest, readback.format, readback.pitchB, source, readback.source->getInternalFormat(), readback.source->getInternalPitchB(), rect.width(), rect.height());
+				readback.source->unlockInternal();
+
+				resource->unlock();
+				readback.buffer->unlock();
+
+				readbackMutex.lock();
+				readbacks.pop_front();
+				pendingReadbacks--;
+				readbackMutex.unlock();
+
+				readbackDone->signal();
+
+				if(retireWaiters > 0)
+				{
+					notifyRetirement();
+				}
+			}
+		}
 	}
 
 	void Renderer::finishRendering(Task &pixelTask)
@@ -962,157 +2104,751 @@ namespace sw
 		int unit = pixelTask.primitiveUnit;
 		int cluster = pixelTask.pixelCluster;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
+		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & drawCountBits];
 		DrawData &data = *draw.data;
 		int primitive = primitiveProgress[unit].firstPrimitive;
 		int count = primitiveProgress[unit].primitiveCount;
 		int processedPrimitives = primitive + count;
 
-		pixelProgress[cluster].processedPrimitives = processedPrimitives;
+		pixelProgress[cluster].processedPrimitives = processedPrimitives;
+
+		if(pixelProgress[cluster].processedPrimitives >= draw.count)
+		{
+			++pixelProgress[cluster].drawCall; // Atomic
+			pixelProgress[cluster].processedPrimitives = 0;
+		}
+
+		int ref = primitiveProgress[unit].references--; // Atomic
+
+		if(ref == 0)
+		{
+			ref = draw.references--; // Atomic
+
+			if(ref == 0)
+			{
+				if(data.pipelineProfile)
+				{
+					PipelineProfile profile;
+
+					for(int cluster = 0; cluster < clusterCount; cluster++)
+					{
+						profile.add(*(PipelineProfile*)((char*)data.pipelineProfile + cluster * DrawData::PIPELINE_STRIDE));
+					}
+
+					profile.drawCalls = 1;
+
+					pipelineProfileMutex.lock();
+					pipelineProfile.add(profile);
+					pipelineProfileMutex.unlock();
+
+					profiler.addDraw(profile);
+
+					deallocate(data.pipelineProfile);
+					data.pipelineProfile = nullptr;
+				}
+
+				if(data.shaderProfile)
+				{
+					shaderProfileMutex.lock();
+
+					ShaderProfile &profile = shaderProfiles[draw.profiledShader];
+					size_t length = profile.cycles.size();
+
+					for(int cluster = 0; cluster < clusterCount; cluster++)
+					{
+						const int64_t *clusterProfile = data.shaderProfile + 2 * length * cluster;
+
+						for(size_t i = 0; i < length; i++)
+						{
+							profile.cycles[i] += clusterProfile[2 * i + 0];
+							profile.executions[i] += clusterProfile[2 * i + 1];
+						}
+					}
+
+					profile.draws++;
+
+					shaderProfileMutex.unlock();
+
+					delete[] data.shaderProfile;
+					data.shaderProfile = nullptr;
+				}
+
+				if(draw.queries)
+				{
+					for(auto &query : *(draw.queries))
+					{
+						switch(query->type)
+						{
+						case Query::FRAGMENTS_PASSED:
+						case Query::ANY_FRAGMENTS_PASSED:
+							for(int cluster = 0; cluster < clusterCount; cluster++)
+							{
+								query->data += data.occlusion[cluster * DrawData::OCCLUSION_STRIDE];
+							}
+							break;
+						case Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
+							query->data += processedPrimitives;
+							break;
+						case Query::TIME_ELAPSED:
+							{
+								// Draw calls of the query can run concurrently and retire out of order
+								int64_t now = Timer::nanoseconds();
+								int64_t started = draw.startTime ? (int64_t)draw.startTime : now;
+								int64_t start = query->start;
+								int64_t finish = query->finish;
+
+								while((start == 0 || started < start) && !query->start.compare_exchange_weak(start, started)) {}
+								while(now > finish && !query->finish.compare_exchange_weak(finish, now)) {}
+							}
+							break;
+						default:
+							break;
+						}
+
+						--query->reference; // Atomic
+					}
+
+					delete draw.queries;
+					draw.queries = 0;
+				}
+
+				for(int i = 0; i < RENDERTARGETS; i++)
+				{
+					if(draw.renderTarget[i])
+					{
+						draw.renderTarget[i]->unlockInternal();
+					}
+				}
+
+				if(draw.depthBuffer)
+				{
+					draw.depthBuffer->unlockInternal();
+				}
+
+				if(draw.stencilBuffer)
+				{
+					draw.stencilBuffer->unlockStencil();
+				}
+
+				for(int i = 0; i < TOTAL_IMAGE_UNITS; i++)
+				{
+					if(draw.texture[i])
+					{
+						draw.texture[i]->unlock();
+					}
+
+					draw.textureData[i].reset();
+				}
+
+				for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+				{
+					if(draw.vertexStream[i])
+					{
+						draw.vertexStream[i]->unlock();
+					}
+				}
+
+				if(draw.indexBuffer)
+				{
+					draw.indexBuffer->unlock();
+				}
+
+				for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; i++)
+				{
+					if(draw.pUniformBuffers[i])
+					{
+						draw.pUniformBuffers[i]->unlock();
+					}
+					if(draw.vUniformBuffers[i])
+					{
+						draw.vUniformBuffers[i]->unlock();
+					}
+				}
+
+				for(int i = 0; i < MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS; i++)
+				{
+					if(draw.transformFeedbackBuffers[i])
+					{
+						draw.transformFeedbackBuffers[i]->unlock();
+					}
+				}
+
+				if(draw.count > 0 && draw.ticks > 0)
+				{
+					// Exponential moving average of the processing time per primitive, used to size batches
+					int64_t cost = draw.ticks / draw.count;
+					int64_t average = primitiveCost;
+					primitiveCost = average ? (3 * average + cost) / 4 : cost;
+				}
+
+				if(draw.prepassVertices)
+				{
+					draw.prepassVertices = nullptr;
+					prepassDraw = nullptr;   // Release the shared vertex buffer
+				}
+
+				vertexCacheLookups += draw.vertexLookups;
+				vertexCacheMisses += draw.vertexMisses;
+
+				if(profiling && profileCallback)
+				{
+					DrawProfile profile;
+					profile.drawCall = primitiveProgress[unit].drawCall;
+					profile.primitives = draw.count;
+					profile.vertexTime = draw.vertexTime;
+					profile.setupTime = draw.setupTime;
+					profile.pixelTime = draw.pixelTime;
+					profile.totalTime = draw.ticks;
+
+					profile.verticesShaded = 4 * draw.vertexMisses;
+					profile.vertexCacheHits = draw.vertexLookups - draw.vertexMisses;
+					profile.primitivesCulled = draw.count - draw.visiblePrimitives;
+
+					profile.quadsCovered = 0;
+					profile.quadsShaded = 0;
+					profile.quadsWritten = 0;
+
+					if(data.quadStatistics)
+					{
+						for(int cluster = 0; cluster < clusterCount; cluster++)
+						{
+							const QuadStatistics &statistics = *(QuadStatistics*)((char*)data.quadStatistics + cluster * DrawData::CLUSTER_STRIDE);
+
+							profile.quadsCovered += statistics.covered;
+							profile.quadsShaded += statistics.shaded;
+							profile.quadsWritten += statistics.written;
+						}
+					}
+
+					profileCallback(profile, profileUserData);
+				}
+
+				if(data.quadStatistics)
+				{
+					deallocate(data.quadStatistics);
+					data.quadStatistics = nullptr;
+				}
+
+				draw.vertexRoutine->unbind();
+				draw.setupRoutine->unbind();
+				draw.pixelRoutine->unbind();
+
+				draw.references = -1;
+
+				std::atomic_thread_fence(std::memory_order_seq_cst);   // Pairs with the one in addTimestamp()
+
+				if(pendingTimestamps > 0)
+				{
+					resolveTimestamps();
+				}
+
+				sync->unlock();   // Only now, so synchronize() returns with the timestamps completed
+				resumeApp->signal();
+
+				if(retireWaiters > 0)
+				{
+					notifyRetirement();
+				}
+
+				if(pendingReadbacks)
+				{
+					drawRetired->signal();
+				}
+			}
+		}
+
+		pixelProgress[cluster].executing = false;
+	}
+
+	int Renderer::chooseBatchSize(unsigned int count, int maxBatch)
+	{
+		int64_t cost = primitiveCost;
+
+		if(threadCount == 1 || cost <= 0)   // No previous draws measured yet
+		{
+			return maxBatch;
+		}
+
+		// Give every thread primitives to process, but keep tasks long enough to amortize the scheduling overhead
+		int batch = (count + threadCount - 1) / threadCount;
+		int minBatch = (int)clamp(minTaskTicks / cost, (int64_t)1, (int64_t)maxBatch);
+
+		return clamp(batch, minBatch, maxBatch);
+	}
+
+	bool Renderer::isMergeable(DrawType drawType)
+	{
+		// Only lists continue where the previous draw's vertices or indices ended
+		switch(drawType & 0x0F)
+		{
+		case DRAW_POINTLIST:
+		case DRAW_LINELIST:
+		case DRAW_TRIANGLELIST:
+			break;
+		default:
+			return false;
+		}
+
+		// Merged vertices are numbered from the start of the draw call, which would change gl_VertexID
+		if((drawType & 0xF0) == DRAW_NONINDEXED && context->vertexShader && context->vertexShader->isVertexIdDeclared())
+		{
+			return false;
+		}
+
+		// Fixed-function and per-draw data like queries, profiles and transform feedback can't be shared
+		return context->vertexShader && context->pixelShader && context->pixelShaderModel() > 0x0104 &&
+		       context->instanceCount == 1 && restartIndices.empty() && queries.empty() &&
+		       !vertexState.transformFeedbackEnabled && !pixelState.occlusionEnabled &&
+		       !pixelState.shaderProfiled && !pixelState.pipelineProfiled && !pixelState.quadsCounted;
+	}
+
+	void Renderer::getDrawInputs(DrawInputs &inputs)
+	{
+		memset(&inputs, 0, sizeof(DrawInputs));
+
+		inputs.viewport = viewport;
+		inputs.scissor = scissor;
+		inputs.clipFlags = clipFlags;
+
+		for(int i = 0; i < MAX_CLIP_PLANES; i++)
+		{
+			if(clipFlags & (Clipper::CLIP_PLANE0 << i))
+			{
+				inputs.clipPlane[i] = clipPlane[i];
+			}
+		}
+
+		inputs.depthBias = context->depthBias;
+		inputs.slopeDepthBias = context->slopeDepthBias;
+		inputs.lineWidth = context->lineWidth;
+		inputs.alphaReference = context->alphaReference;
+		inputs.instanceID = context->instanceID;
+
+		for(int index = 0; index < RENDERTARGETS; index++)
+		{
+			inputs.renderTargetLayer[index] = context->renderTargetLayer[index];
+		}
+
+		inputs.depthBufferLayer = context->depthBufferLayer;
+		inputs.stencilBufferLayer = context->stencilBufferLayer;
+
+		// Like the draw call's data, only what the routines use
+		if(pixelState.stencilActive)
+		{
+			inputs.stencil = stencil;
+			inputs.stencilCCW = stencilCCW;
+		}
+
+		if(pixelState.fogActive)
+		{
+			inputs.fog = fog;
+		}
+
+		if(setupState.isDrawPoint)
+		{
+			inputs.point = point;
+		}
+
+		inputs.factor = factor;
+	}
+
+	bool Renderer::mergeDraw(const DrawInputs &inputs, unsigned int indexOffset, unsigned int count, int batch, int (Renderer::*setupPrimitives)(int batch, int count))
+	{
+		if(!lastDrawMergeable || memcmp(&inputs, &lastDrawInputs, sizeof(DrawInputs)) != 0)
+		{
+			return false;
+		}
+
+		DrawCall *draw = drawList[(nextDraw - 1) & drawCountBits];
+		const DrawData *data = draw->data;
+		DrawType drawType = context->drawType;
+
+		if(draw->drawType != drawType || draw->setupPrimitives != setupPrimitives || draw->clipFlags != clipFlags ||
+		   draw->vertexRoutine != vertexRoutine || draw->setupRoutine != setupRoutine || draw->pixelRoutine != pixelRoutine)
+		{
+			return false;
+		}
+
+		// Constants changed since the draw was set up
+		if(draw->vsDirtyConstF || draw->vsDirtyConstI || draw->vsDirtyConstB ||
+		   draw->psDirtyConstF || draw->psDirtyConstI || draw->psDirtyConstB)
+		{
+			return false;
+		}
+
+		// Vertices or indices following those of the draw's last primitive
+		unsigned int vertices = (drawType & 0x0F) == DRAW_TRIANGLELIST ? 3 : (drawType & 0x0F) == DRAW_LINELIST ? 2 : 1;
+		unsigned int next = draw->count * vertices;
+		bool indexed = (drawType & 0xF0) != DRAW_NONINDEXED;
+
+		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+		{
+			if(!vertexState.input[i])
+			{
+				continue;
+			}
+
+			const Stream &input = context->input[i];
+			unsigned int stride = input.divisor ? 0 : input.stride;
+			unsigned int divisor = vertexState.input[i].instanced ? input.divisor : 0;
+			const unsigned char *buffer = (const unsigned char*)data->input[i] + (indexed ? 0 : next * stride);
+
+			if(input.resource != draw->vertexStream[i] || input.buffer != buffer || stride != data->stride[i] || divisor != draw->instanceDivisor[i])
+			{
+				return false;
+			}
+		}
+
+		if(indexed)
+		{
+			unsigned int indexSize = (drawType & 0xF0) == DRAW_INDEXED32 ? 4 : (drawType & 0xF0) == DRAW_INDEXED16 ? 2 : 1;
+			const unsigned char *indices = (const unsigned char*)data->indices + next * indexSize;
+
+			if(context->indexBuffer != draw->indexBuffer || (const unsigned char*)context->indexBuffer->data() + indexOffset != indices)
+			{
+				return false;
+			}
+		}
+
+		for(int sampler = 0; sampler < TOTAL_IMAGE_UNITS; sampler++)
+		{
+			bool used = (sampler < TEXTURE_IMAGE_UNITS) ? pixelState.sampler[sampler].textureType != TEXTURE_NULL :
+			            (context->vertexShader->getShaderModel() >= 0x0300 && vertexState.sampler[sampler - TEXTURE_IMAGE_UNITS].textureType != TEXTURE_NULL);
+
+			if(used && (context->texture[sampler] != draw->texture[sampler] || context->sampler[sampler].requiresSync() ||
+			            context->sampler[sampler].getTextureData() != draw->textureData[sampler]))
+			{
+				return false;
+			}
+		}
+
+		if(!PixelProcessor::uniformBuffersLocked(data->ps.u, draw->pUniformBuffers) ||
+		   !VertexProcessor::uniformBuffersLocked(data->vs.u, draw->vUniformBuffers))
+		{
+			return false;
+		}
+
+		for(int index = 0; index < RENDERTARGETS; index++)
+		{
+			if(context->renderTarget[index] != draw->renderTarget[index] || (draw->renderTarget[index] && draw->renderTarget[index]->requiresSync()))
+			{
+				return false;
+			}
+		}
+
+		Surface *depthBuffer = context->depthBufferActive() ? context->depthBuffer : nullptr;
+		Surface *stencilBuffer = context->stencilActive() ? context->stencilBuffer : nullptr;
+
+		if(depthBuffer != draw->depthBuffer || stencilBuffer != draw->stencilBuffer ||
+		   (depthBuffer && depthBuffer->requiresSync()) || (stencilBuffer && stencilBuffer->requiresSync()))
+		{
+			return false;
+		}
+
+		schedulerMutex.lock();
+
+		// Primitives left to hand out keep the draw from retiring, and the pixel clusters from moving past it
+		bool pending = draw->primitive < draw->count;
+
+		if(pending)
+		{
+			unsigned int total = draw->count + count;
+
+			if(draw->primitive == 0 && batch > 1)   // Batches get sized for the whole run if none were handed out yet
+			{
+				draw->batchSize = chooseBatchSize(total, batch);
+				draw->references = (total + draw->batchSize - 1) / draw->batchSize;
+			}
+			else
+			{
+				int size = draw->batchSize;
+				draw->references += (total + size - 1) / size - (draw->count + size - 1) / size;
+			}
+
+			draw->count = total;
+			draw->instancePrimitives = total;
+		}
+
+		schedulerMutex.unlock();
+
+		return pending;
+	}
+
+	bool Renderer::isCulled(unsigned int count)
+	{
+		const VertexShader *shader = context->vertexShader;
+
+		// Lines and points can be wider than the clip volume of their vertices
+		if(!shader || !indexRangeValid || !context->isDrawTriangle() || context->instanceCount != 1 ||
+		   vertexState.transformFeedbackEnabled || vertexState.superSampling || vertexState.preTransformed)
+		{
+			return false;
+		}
+
+		unsigned int vertexCount = indexRangeMax - indexRangeMin + 1;
+
+		if(vertexCount > 3 * count)   // Only uses part of the vertex range, transforming all of it costs more than it saves
+		{
+			return false;
+		}
+
+		const VertexShader *positionShader = shader->getPositionShader();
+
+		if(positionShader->containsTextureSampling())
+		{
+			return false;
+		}
+
+		// The routine is generated from the shader in the context
+		context->vertexShader = positionShader;
+
+		VertexProcessor::State state = VertexProcessor::update(context->drawType);
+
+		if(!cullingRoutine || !(state == cullingState))
+		{
+			Routine *previousRoutine = cullingRoutine;
+
+			cullingRoutine = VertexProcessor::cachedRoutine(state);
+
+			if(!cullingRoutine)
+			{
+				cullingRoutine = VertexProcessor::routine(state, OptimizationDefault);
+			}
+
+			cullingState = state;
+
+			if(previousRoutine) previousRoutine->unbind();
+		}
+
+		context->vertexShader = shader;
+
+		if(!cullingData)
+		{
+			cullingData = (DrawData*)allocate(sizeof(DrawData), 16, true, MEMORY_RENDERER);
+			cullingData->constants = &constants;
+			cullingTask = (VertexTask*)allocate(sizeof(VertexTask), 16, true, MEMORY_RENDERER);
+			cullingTask->vertexCache.init(PREPASS_CHUNK_SIZE);
+			cullingVertices = (Vertex*)allocate(PREPASS_CHUNK_SIZE * sizeof(Vertex), 16, true, MEMORY_RENDERER);
+		}
+
+		DrawData *data = cullingData;
+		VertexTask *task = cullingTask;
+
+		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+		{
+			const Stream &input = context->input[i];
+
+			data->input[i] = input.buffer;
+			data->stride[i] = input.divisor ? 0 : input.stride;
+			task->instanceOffset[i] = 0;
+		}
+
+		memcpy(&data->vs.c, VertexProcessor::c, sizeof(VertexProcessor::c));
+		memcpy(&data->vs.i, VertexProcessor::i, sizeof(VertexProcessor::i));
+		memcpy(&data->vs.b, VertexProcessor::b, sizeof(VertexProcessor::b));
+
+		if(shader->hasPrologue())
+		{
+			shader->evaluatePrologue(data->vs.c);
+		}
+
+		Resource *uniformBuffers[MAX_UNIFORM_BUFFER_BINDINGS];
+		VertexProcessor::lockUniformBuffers(data->vs.u, uniformBuffers);
+
+		// Same projection as the draw, but tested against the viewport instead of the guard band
+		float W = 0.5f * viewport.width;
+		float H = 0.5f * viewport.height;
+
+		data->Wx16 = replicate(W * 16);
+		data->Hx16 = replicate(H * 16);
+		data->X0x16 = replicate((viewport.x0 + W) * 16 - 8);
+		data->Y0x16 = replicate((viewport.y0 + H) * 16 - 8);
+		data->halfPixelX = replicate(0.5f / W);
+		data->halfPixelY = replicate(0.5f / H);
+		data->guardBandX = replicate(1.0f);
+		data->guardBandY = replicate(1.0f);
+
+		task->instanceID = context->instanceID;
+
+		VertexProcessor::RoutinePointer routine = (VertexProcessor::RoutinePointer)cullingRoutine->getEntry();
+		unsigned int batch[PREPASS_CHUNK_SIZE];
+
+		// The draw is outside when all of its vertices are outside of the same plane
+		int clipFlagsAnd = Clipper::CLIP_FRUSTUM;
+
+		for(unsigned int first = 0; first < vertexCount && clipFlagsAnd; first += PREPASS_CHUNK_SIZE)
+		{
+			unsigned int chunk = sw::min(vertexCount - first, (unsigned int)PREPASS_CHUNK_SIZE);
+
+			for(unsigned int i = 0; i < chunk; i++)
+			{
+				batch[i] = indexRangeMin + first + i;
+			}
+
+			task->vertexCache.clear();
+			task->primitiveStart = 0;
+			task->vertexCount = chunk;
+			routine(cullingVertices, batch, task, data);
+
+			for(unsigned int i = 0; i < chunk; i++)
+			{
+				clipFlagsAnd &= cullingVertices[i].clipFlags;
+			}
+		}
+
+		for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; i++)
+		{
+			if(uniformBuffers[i])
+			{
+				uniformBuffers[i]->unlock();
+			}
+		}
+
+		return clipFlagsAnd != 0;
+	}
+
+	unsigned int Renderer::getBatchSizeCount(int bucket) const
+	{
+		ASSERT(bucket >= 0 && bucket < BATCH_SIZE_BUCKETS);
 
-		if(pixelProgress[cluster].processedPrimitives >= draw.count)
+		return batchSizeCount[bucket];
+	}
+
+	void Renderer::resetBatchSizeCounts()
+	{
+		for(int bucket = 0; bucket < BATCH_SIZE_BUCKETS; bucket++)
 		{
-			++pixelProgress[cluster].drawCall; // Atomic
-			pixelProgress[cluster].processedPrimitives = 0;
+			batchSizeCount[bucket] = 0;
 		}
+	}
 
-		int ref = primitiveProgress[unit].references--; // Atomic
-
-		if(ref == 0)
-		{
-			ref = draw.references--; // Atomic
+	int64_t Renderer::getVertexCacheLookups() const
+	{
+		return vertexCacheLookups;
+	}
 
-			if(ref == 0)
-			{
-				#if PERF_PROFILE
-					for(int cluster = 0; cluster < clusterCount; cluster++)
-					{
-						for(int i = 0; i < PERF_TIMERS; i++)
-						{
-							profiler.cycles[i] += data.cycles[i][cluster];
-						}
-					}
-				#endif
+	int64_t Renderer::getVertexCacheMisses() const
+	{
+		return vertexCacheMisses;
+	}
 
-				if(draw.queries)
-				{
-					for(auto &query : *(draw.queries))
-					{
-						switch(query->type)
-						{
-						case Query::FRAGMENTS_PASSED:
-							for(int cluster = 0; cluster < clusterCount; cluster++)
-							{
-								query->data += data.occlusion[cluster];
-							}
-							break;
-						case Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
-							query->data += processedPrimitives;
-							break;
-						default:
-							break;
-						}
+	void Renderer::resetVertexCacheCounts()
+	{
+		vertexCacheLookups = 0;
+		vertexCacheMisses = 0;
+	}
 
-						--query->reference; // Atomic
-					}
+	// Indexed strips and fans with primitive restart. Primitive p still starts at index p, but its strip
+	// or fan begins after the last restart at or before p, and primitives which would include a restart
+	// collapse onto one vertex, which setup discards for having no area or length. Vertices are ordered
+	// like the non-indexed strips and fans, so the provoking vertex is the same as without restarts.
+	template<class Index>
+	static void assembleRestartBatch(unsigned int (*batch)[3], const DrawCall &draw, const Index *index, unsigned int start, unsigned int count)
+	{
+		const std::vector<unsigned int> &restart = draw.restartIndices;
+		auto next = std::upper_bound(restart.begin(), restart.end(), start);
+		unsigned int begin = (next == restart.begin()) ? 0 : next[-1] + 1;   // First index of the current strip or fan
+		unsigned int end = (next == restart.end()) ? ~0u : *next;           // Next restart
 
-					delete draw.queries;
-					draw.queries = 0;
-				}
+		DrawType primitiveType = DrawType(draw.drawType & 0x0F);
+		unsigned int last = (primitiveType == DRAW_LINESTRIP) ? 1 : 2;     // Offset of the primitive's last index
 
-				for(int i = 0; i < RENDERTARGETS; i++)
-				{
-					if(draw.renderTarget[i])
-					{
-						draw.renderTarget[i]->unlockInternal();
-					}
-				}
+		for(unsigned int i = 0; i < count; i++)
+		{
+			unsigned int p = start + i;
 
-				if(draw.depthBuffer)
-				{
-					draw.depthBuffer->unlockInternal();
-				}
+			while(p >= end)
+			{
+				begin = end + 1;
+				++next;
+				end = (next == restart.end()) ? ~0u : *next;
+			}
 
-				if(draw.stencilBuffer)
-				{
-					draw.stencilBuffer->unlockStencil();
-				}
+			if(p < begin || p + last >= end)
+			{
+				batch[i][0] = draw.restartVertex;
+				batch[i][1] = draw.restartVertex;
+				batch[i][2] = draw.restartVertex;
 
-				for(int i = 0; i < TOTAL_IMAGE_UNITS; i++)
-				{
-					if(draw.texture[i])
-					{
-						draw.texture[i]->unlock();
-					}
-				}
+				continue;
+			}
 
-				for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+			switch(primitiveType)
+			{
+			case DRAW_LINESTRIP:
+				batch[i][0] = index[p];
+				batch[i][1] = index[p + 1];
+				batch[i][2] = index[p + 1];
+				break;
+			case DRAW_TRIANGLESTRIP:
+				if(leadingVertexFirst)
 				{
-					if(draw.vertexStream[i])
-					{
-						draw.vertexStream[i]->unlock();
-					}
+					batch[i][0] = index[p];
+					batch[i][1] = index[p + ((p - begin) & 1) + 1];
+					batch[i][2] = index[p + (~(p - begin) & 1) + 1];
 				}
-
-				if(draw.indexBuffer)
+				else
 				{
-					draw.indexBuffer->unlock();
+					batch[i][0] = index[p + ((p - begin) & 1)];
+					batch[i][1] = index[p + (~(p - begin) & 1)];
+					batch[i][2] = index[p + 2];
 				}
-
-				for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; i++)
+				break;
+			case DRAW_TRIANGLEFAN:
+				if(leadingVertexFirst)
 				{
-					if(draw.pUniformBuffers[i])
-					{
-						draw.pUniformBuffers[i]->unlock();
-					}
-					if(draw.vUniformBuffers[i])
-					{
-						draw.vUniformBuffers[i]->unlock();
-					}
+					batch[i][0] = index[p + 1];
+					batch[i][1] = index[p + 2];
+					batch[i][2] = index[begin];
 				}
-
-				for(int i = 0; i < MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS; i++)
+				else
 				{
-					if(draw.transformFeedbackBuffers[i])
-					{
-						draw.transformFeedbackBuffers[i]->unlock();
-					}
+					batch[i][0] = index[begin];
+					batch[i][1] = index[p + 1];
+					batch[i][2] = index[p + 2];
 				}
-
-				draw.vertexRoutine->unbind();
-				draw.setupRoutine->unbind();
-				draw.pixelRoutine->unbind();
-
-				sync->unlock();
-
-				draw.references = -1;
-				resumeApp->signal();
+				break;
+			default:
+				ASSERT(false);
 			}
 		}
-
-		pixelProgress[cluster].executing = false;
 	}
 
 	void Renderer::processPrimitiveVertices(int unit, unsigned int start, unsigned int triangleCount, unsigned int loop, int thread)
 	{
 		Triangle *triangle = triangleBatch[unit];
 		int primitiveDrawCall = primitiveProgress[unit].drawCall;
-		DrawCall *draw = drawList[primitiveDrawCall & DRAW_COUNT_BITS];
+		DrawCall *draw = drawList[primitiveDrawCall & drawCountBits];
 		DrawData *data = draw->data;
-		VertexTask *task = vertexTask[thread];
+		VertexTask *task = getVertexTask(thread);
 
 		const void *indices = data->indices;
 		VertexProcessor::RoutinePointer vertexRoutine = draw->vertexPointer;
 
-		if(task->vertexCache.drawCall != primitiveDrawCall)
+		unsigned int instance = start / loop;
+		start -= instance * loop;
+
+		if(task->vertexCache.drawCall != primitiveDrawCall || task->instanceID != data->instanceID + (int)instance)
 		{
 			task->vertexCache.clear();
 			task->vertexCache.drawCall = primitiveDrawCall;
+
+			setupInstance(task, draw, instance);
 		}
 
 		unsigned int batch[128][3];   // FIXME: Adjust to dynamic batch size
 
-		switch(draw->drawType)
+		if(!draw->restartIndices.empty())
+		{
+			switch(draw->drawType & 0xF0)
+			{
+			case DRAW_INDEXED8:  assembleRestartBatch(batch, *draw, (const unsigned char*)indices, start, triangleCount);  break;
+			case DRAW_INDEXED16: assembleRestartBatch(batch, *draw, (const unsigned short*)indices, start, triangleCount); break;
+			case DRAW_INDEXED32: assembleRestartBatch(batch, *draw, (const unsigned int*)indices, start, triangleCount);   break;
+			default: ASSERT(false);
+			}
+		}
+		else switch(draw->drawType)
 		{
 		case DRAW_POINTLIST:
 			{
@@ -1535,17 +3271,81 @@ namespace sw
 			return;
 		}
 
+		if(draw->prepassVertices)   // Gather the vertices transformed by the pre-pass
+		{
+			const Vertex *vertex = draw->prepassVertices - draw->prepassFirst;
+
+			for(unsigned int i = 0; i < triangleCount; i++)
+			{
+				ASSERT(batch[i][0] - draw->prepassFirst < draw->prepassCount);
+				ASSERT(batch[i][1] - draw->prepassFirst < draw->prepassCount);
+				ASSERT(batch[i][2] - draw->prepassFirst < draw->prepassCount);
+
+				memcpy(&triangle[i].v0, &vertex[batch[i][0]], draw->prepassVertexSize);
+				memcpy(&triangle[i].v1, &vertex[batch[i][1]], draw->prepassVertexSize);
+				memcpy(&triangle[i].v2, &vertex[batch[i][2]], draw->prepassVertexSize);
+			}
+
+			return;
+		}
+
 		task->primitiveStart = start;
 		task->vertexCount = triangleCount * 3;
 		vertexRoutine(&triangle->v0, (unsigned int*)&batch, task, data);
+
+		draw->vertexLookups += triangleCount * 3;
+		draw->vertexMisses += task->vertexCache.misses;
+	}
+
+	void Renderer::processPrepassVertices(int chunk, int thread)
+	{
+		DrawCall *draw = prepassDraw;
+		VertexTask *task = getVertexTask(thread);
+
+		unsigned int first = chunk * PREPASS_CHUNK_SIZE;
+		unsigned int count = sw::min(draw->prepassCount - first, (unsigned int)PREPASS_CHUNK_SIZE);
+
+		unsigned int batch[PREPASS_CHUNK_SIZE];
+
+		for(unsigned int i = 0; i < count; i++)
+		{
+			batch[i] = draw->prepassFirst + first + i;
+		}
+
+		// The cache may still hold another draw call's vertices with the same indices
+		task->vertexCache.clear();
+		task->vertexCache.drawCall = -1;
+
+		setupInstance(task, draw, 0);
+
+		task->primitiveStart = 0;
+		task->vertexCount = count;
+		draw->vertexPointer(&draw->prepassVertices[first], batch, task, draw->data);
+
+		draw->vertexLookups += count;
+		draw->vertexMisses += task->vertexCache.misses;
+	}
+
+	void Renderer::setupInstance(VertexTask *task, DrawCall *draw, unsigned int instance)
+	{
+		task->instanceID = draw->data->instanceID + instance;
+
+		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+		{
+			if(draw->instanceDivisor[i])
+			{
+				task->instanceOffset[i] = (instance / draw->instanceDivisor[i]) * draw->instanceStride[i];
+			}
+		}
 	}
 
 	int Renderer::setupSolidTriangles(int unit, int count)
 	{
 		Triangle *triangle = triangleBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
+		Primitive::Outline *outline = outlineBatch[unit];
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
+		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & drawCountBits];
 		SetupProcessor::State &state = draw.setupState;
 		const SetupProcessor::RoutinePointer &setupRoutine = draw.setupPointer;
 
@@ -1574,9 +3374,12 @@ namespace sw
 					}
 				}
 
+				primitive->outline = outline;
+
 				if(setupRoutine(primitive, triangle, &polygon, data))
 				{
-					primitive += ms;
+					primitive = (Primitive*)((char*)primitive + data->primitiveStride);
+					outline += ms;
 					visible++;
 				}
 			}
@@ -1589,9 +3392,10 @@ namespace sw
 	{
 		Triangle *triangle = triangleBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
+		Primitive::Outline *outline = outlineBatch[unit];
 		int visible = 0;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
+		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & drawCountBits];
 		SetupProcessor::State &state = draw.setupState;
 
 		const Vertex &v0 = triangle[0].v0;
@@ -1628,11 +3432,14 @@ namespace sw
 
 		for(int i = 0; i < 3; i++)
 		{
+			primitive->outline = outline;
+
 			if(setupLine(*primitive, *triangle, draw))
 			{
 				primitive->area = 0.5f * d;
 
-				primitive++;
+				primitive = (Primitive*)((char*)primitive + draw.data->primitiveStride);
+				outline += state.multiSample;
 				visible++;
 			}
 
@@ -1646,9 +3453,10 @@ namespace sw
 	{
 		Triangle *triangle = triangleBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
+		Primitive::Outline *outline = outlineBatch[unit];
 		int visible = 0;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
+		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & drawCountBits];
 		SetupProcessor::State &state = draw.setupState;
 
 		const Vertex &v0 = triangle[0].v0;
@@ -1672,11 +3480,14 @@ namespace sw
 
 		for(int i = 0; i < 3; i++)
 		{
+			primitive->outline = outline;
+
 			if(setupPoint(*primitive, *triangle, draw))
 			{
 				primitive->area = 0.5f * d;
 
-				primitive++;
+				primitive = (Primitive*)((char*)primitive + draw.data->primitiveStride);
+				outline += state.multiSample;
 				visible++;
 			}
 
@@ -1690,18 +3501,22 @@ namespace sw
 	{
 		Triangle *triangle = triangleBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
+		Primitive::Outline *outline = outlineBatch[unit];
 		int visible = 0;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
+		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & drawCountBits];
 		SetupProcessor::State &state = draw.setupState;
 
 		int ms = state.multiSample;
 
 		for(int i = 0; i < count; i++)
 		{
+			primitive->outline = outline;
+
 			if(setupLine(*primitive, *triangle, draw))
 			{
-				primitive += ms;
+				primitive = (Primitive*)((char*)primitive + draw.data->primitiveStride);
+				outline += ms;
 				visible++;
 			}
 
@@ -1715,18 +3530,22 @@ namespace sw
 	{
 		Triangle *triangle = triangleBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
+		Primitive::Outline *outline = outlineBatch[unit];
 		int visible = 0;
 
-		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & DRAW_COUNT_BITS];
+		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall & drawCountBits];
 		SetupProcessor::State &state = draw.setupState;
 
 		int ms = state.multiSample;
 
 		for(int i = 0; i < count; i++)
 		{
+			primitive->outline = outline;
+
 			if(setupPoint(*primitive, *triangle, draw))
 			{
-				primitive += ms;
+				primitive = (Primitive*)((char*)primitive + draw.data->primitiveStride);
+				outline += ms;
 				visible++;
 			}
 
@@ -1791,19 +3610,19 @@ namespace sw
 
 			P[0].x += -dy0w;
 			P[0].y += +dx0h;
-			C[0] = clipper->computeClipFlags(P[0]);
+			C[0] = clipper->computeClipFlags(P[0], data);
 
 			P[1].x += -dy1w;
 			P[1].y += +dx1h;
-			C[1] = clipper->computeClipFlags(P[1]);
+			C[1] = clipper->computeClipFlags(P[1], data);
 
 			P[2].x += +dy1w;
 			P[2].y += -dx1h;
-			C[2] = clipper->computeClipFlags(P[2]);
+			C[2] = clipper->computeClipFlags(P[2], data);
 
 			P[3].x += +dy0w;
 			P[3].y += -dx0h;
-			C[3] = clipper->computeClipFlags(P[3]);
+			C[3] = clipper->computeClipFlags(P[3], data);
 
 			if((C[0] & C[1] & C[2] & C[3]) == Clipper::CLIP_FINITE)
 			{
@@ -1843,28 +3662,28 @@ namespace sw
 			float dy1 = lineWidth * 0.5f * P1.w / H;
 
 			P[0].x += -dx0;
-			C[0] = clipper->computeClipFlags(P[0]);
+			C[0] = clipper->computeClipFlags(P[0], data);
 
 			P[1].y += +dy0;
-			C[1] = clipper->computeClipFlags(P[1]);
+			C[1] = clipper->computeClipFlags(P[1], data);
 
 			P[2].x += +dx0;
-			C[2] = clipper->computeClipFlags(P[2]);
+			C[2] = clipper->computeClipFlags(P[2], data);
 
 			P[3].y += -dy0;
-			C[3] = clipper->computeClipFlags(P[3]);
+			C[3] = clipper->computeClipFlags(P[3], data);
 
 			P[4].x += -dx1;
-			C[4] = clipper->computeClipFlags(P[4]);
+			C[4] = clipper->computeClipFlags(P[4], data);
 
 			P[5].y += +dy1;
-			C[5] = clipper->computeClipFlags(P[5]);
+			C[5] = clipper->computeClipFlags(P[5], data);
 
 			P[6].x += +dx1;
-			C[6] = clipper->computeClipFlags(P[6]);
+			C[6] = clipper->computeClipFlags(P[6], data);
 
 			P[7].y += -dy1;
-			C[7] = clipper->computeClipFlags(P[7]);
+			C[7] = clipper->computeClipFlags(P[7], data);
 
 			if((C[0] & C[1] & C[2] & C[3] & C[4] & C[5] & C[6] & C[7]) == Clipper::CLIP_FINITE)
 			{
@@ -1970,25 +3789,25 @@ namespace sw
 
 		P[0].x -= X;
 		P[0].y += Y;
-		C[0] = clipper->computeClipFlags(P[0]);
+		C[0] = clipper->computeClipFlags(P[0], data);
 
 		P[1].x += X;
 		P[1].y += Y;
-		C[1] = clipper->computeClipFlags(P[1]);
+		C[1] = clipper->computeClipFlags(P[1], data);
 
 		P[2].x += X;
 		P[2].y -= Y;
-		C[2] = clipper->computeClipFlags(P[2]);
+		C[2] = clipper->computeClipFlags(P[2], data);
 
 		P[3].x -= X;
 		P[3].y -= Y;
-		C[3] = clipper->computeClipFlags(P[3]);
+		C[3] = clipper->computeClipFlags(P[3], data);
 
-		triangle.v1 = triangle.v0;
-		triangle.v2 = triangle.v0;
-
-		triangle.v1.X += iround(16 * 0.5f * pSize);
-		triangle.v2.Y -= iround(16 * 0.5f * pSize) * (data.Hx16[0] > 0.0f ? 1 : -1);   // Both Direct3D and OpenGL expect (0, 0) in the top-left corner
+		// Sprite corners for the setup routine, which takes all other vertex data from v0
+		triangle.v1.X = v.X + iround(16 * 0.5f * pSize);
+		triangle.v1.Y = v.Y;
+		triangle.v2.X = v.X;
+		triangle.v2.Y = v.Y - iround(16 * 0.5f * pSize) * (data.Hx16[0] > 0.0f ? 1 : -1);   // Both Direct3D and OpenGL expect (0, 0) in the top-left corner
 
 		Polygon polygon(P, 4);
 
@@ -2010,73 +3829,231 @@ namespace sw
 		return false;
 	}
 
+	void Renderer::resizeDrawQueue(int count)
+	{
+		ASSERT((count & (count - 1)) == 0 && count > drawCount);
+
+		DrawCall **newDrawCall = new DrawCall*[count];
+		DrawCall **newDrawList = new DrawCall*[count];
+
+		for(int draw = 0; draw < count; draw++)
+		{
+			if(draw < drawCount)
+			{
+				newDrawCall[draw] = drawCall[draw];
+			}
+			else
+			{
+				newDrawCall[draw] = new DrawCall();
+
+				if(threadState)
+				{
+					newDrawCall[draw]->allocateClusterData(clusterCount);
+				}
+			}
+
+			// Repeat the old ring so that previously issued draw indices keep referring to the same draw calls
+			newDrawList[draw] = drawCount ? drawList[draw & drawCountBits] : newDrawCall[draw];
+		}
+
+		delete[] drawCall;
+		delete[] drawList;
+
+		drawCall = newDrawCall;
+		drawList = newDrawList;
+		drawCount = count;
+		drawCountBits = count - 1;
+	}
+
+	void Renderer::growDrawQueue()
+	{
+		// Only resize when all draw calls have retired, so no worker can be indexing the ring
+		for(int draw = 0; draw < drawCount; draw++)
+		{
+			if(drawCall[draw]->references != -1)
+			{
+				return;
+			}
+		}
+
+		schedulerMutex.lock();
+		resizeDrawQueue(drawCount * 2);
+		schedulerMutex.unlock();
+
+		drawQueueStalled = false;
+	}
+
 	void Renderer::initializeThreads()
 	{
+		threadStateCount = threadCount;
 		unitCount = ceilPow2(threadCount);
 		clusterCount = ceilPow2(threadCount);
 
+		ASSERT(unitCount <= 0x4000 && clusterCount <= 0x4000);   // Must fit in a packed task
+
+		profiler.setThreadCount(threadCount);
+
+		triangleBatch = new Triangle*[unitCount];
+		primitiveBatch = new Primitive*[unitCount];
+		outlineBatch = new Primitive::Outline*[unitCount];
+		primitiveProgress = (PrimitiveProgress*)allocate(unitCount * sizeof(PrimitiveProgress), 64, true, MEMORY_RENDERER);
+
 		for(int i = 0; i < unitCount; i++)
 		{
-			triangleBatch[i] = (Triangle*)allocate(batchSize * sizeof(Triangle));
-			primitiveBatch[i] = (Primitive*)allocate(batchSize * sizeof(Primitive));
+			triangleBatch[i] = nullptr;   // Allocated on first use
+			primitiveBatch[i] = nullptr;
+			outlineBatch[i] = nullptr;
+			new (&primitiveProgress[i]) PrimitiveProgress();
+			primitiveProgress[i].init();
+		}
+
+		pixelProgress = (PixelProgress*)allocate(clusterCount * sizeof(PixelProgress), 64, true, MEMORY_RENDERER);
+
+		for(int cluster = 0; cluster < clusterCount; cluster++)
+		{
+			new (&pixelProgress[cluster]) PixelProgress();
+			pixelProgress[cluster].init();
+		}
+
+		for(int draw = 0; draw < drawCount; draw++)
+		{
+			drawCall[draw]->allocateClusterData(clusterCount);
 		}
 
+		vertexTask = new VertexTask*[threadCount];
+		taskDeque = new TaskDeque[threadCount];
+
+		threadState = (ThreadState*)allocate(threadCount * sizeof(ThreadState), 64, true, MEMORY_RENDERER);
+
 		for(int i = 0; i < threadCount; i++)
 		{
-			vertexTask[i] = (VertexTask*)allocate(sizeof(VertexTask));
-			vertexTask[i]->vertexCache.drawCall = -1;
+			new (&threadState[i]) ThreadState();
+		}
 
-			task[i].type = Task::SUSPEND;
+		resetTimers();
 
-			resume[i] = new Event();
-			suspend[i] = new Event();
+		// Each unit and cluster can have at most one task outstanding, plus one pre-pass chunk per thread
+		int dequeCapacity = ceilPow2(unitCount + clusterCount + threadCount);
 
-			Parameters parameters;
-			parameters.threadIndex = i;
-			parameters.renderer = this;
+		for(int i = 0; i < threadCount; i++)
+		{
+			vertexTask[i] = nullptr;   // Allocated on first use
 
-			exitThreads = false;
-			worker[i] = new Thread(threadFunction, &parameters);
+			threadState[i].task.type = Task::SUSPEND;
+			taskDeque[i].init(dequeCapacity);
 
-			suspend[i]->wait();
-			suspend[i]->signal();
+			threadState[i].resumePending = false;
+			threadState[i].schedule = THREAD_IDLE;
+			threadState[i].idleTick = 0;
 		}
+
+		// Shared by all renderers, sized for the one with the most threads
+		WorkerPool::acquire(threadCount, pinThreads);
 	}
 
 	void Renderer::terminateThreads()
 	{
+		if(!threadState)
+		{
+			return;
+		}
+
+		waitForIdleThreads();
+
+		WorkerPool::release();
+
+		freeBatches();
+
+		delete[] vertexTask;
+		vertexTask = nullptr;
+		delete[] taskDeque;
+		taskDeque = nullptr;
+
+		for(int thread = 0; thread < threadStateCount; thread++)
+		{
+			threadState[thread].~ThreadState();
+		}
+
+		deallocate(threadState);
+		threadState = nullptr;
+
+		for(int draw = 0; draw < drawCount; draw++)
+		{
+			drawCall[draw]->freeClusterData();
+		}
+
+		delete[] triangleBatch;
+		triangleBatch = nullptr;
+		delete[] primitiveBatch;
+		primitiveBatch = nullptr;
+		delete[] outlineBatch;
+		outlineBatch = nullptr;
+		deallocate(primitiveProgress);
+		primitiveProgress = nullptr;
+		deallocate(pixelProgress);
+		pixelProgress = nullptr;
+	}
+
+	void Renderer::waitForIdleThreads()
+	{
+		if(!threadState)
+		{
+			return;
+		}
+
 		while(threadsAwake != 0)
 		{
-			Thread::sleep(1);
+			Thread::sleep(1);
+		}
+
+		// Suspended threads may still be returning to the pool
+		for(int thread = 0; thread < threadStateCount; thread++)
+		{
+			while(threadState[thread].schedule != THREAD_IDLE)
+			{
+				Thread::yield();
+			}
+		}
+	}
+
+	void Renderer::allocateBatches(int unit)
+	{
+		triangleBatch[unit] = (Triangle*)allocate(batchSize * sizeof(Triangle), 16, true, MEMORY_RENDERER);
+		primitiveBatch[unit] = (Primitive*)allocate(batchSize * sizeof(Primitive), 16, true, MEMORY_RENDERER);
+		outlineBatch[unit] = (Primitive::Outline*)allocate(batchSize * sizeof(Primitive::Outline), 16, true, MEMORY_RENDERER);
+	}
+
+	VertexTask *Renderer::getVertexTask(int thread)
+	{
+		if(!vertexTask[thread])
+		{
+			vertexTask[thread] = (VertexTask*)allocate(sizeof(VertexTask), 64, true, MEMORY_RENDERER);   // Written by this thread only, keep it off others' cache lines
+			vertexTask[thread]->vertexCache.init(vertexCacheSize);
+		}
+
+		return vertexTask[thread];
+	}
+
+	void Renderer::freeBatches()
+	{
+		for(int unit = 0; unit < unitCount; unit++)
+		{
+			deallocate(triangleBatch[unit]);
+			triangleBatch[unit] = nullptr;
+			deallocate(primitiveBatch[unit]);
+			primitiveBatch[unit] = nullptr;
+			deallocate(outlineBatch[unit]);
+			outlineBatch[unit] = nullptr;
 		}
 
 		for(int thread = 0; thread < threadCount; thread++)
 		{
-			if(worker[thread])
+			if(vertexTask[thread])
 			{
-				exitThreads = true;
-				resume[thread]->signal();
-				worker[thread]->join();
-
-				delete worker[thread];
-				worker[thread] = 0;
-				delete resume[thread];
-				resume[thread] = 0;
-				delete suspend[thread];
-				suspend[thread] = 0;
+				vertexTask[thread]->vertexCache.free();
+				deallocate(vertexTask[thread]);
+				vertexTask[thread] = nullptr;
 			}
-
-			deallocate(vertexTask[thread]);
-			vertexTask[thread] = 0;
-		}
-
-		for(int i = 0; i < 16; i++)
-		{
-			deallocate(triangleBatch[i]);
-			triangleBatch[i] = 0;
-
-			deallocate(primitiveBatch[i]);
-			primitiveBatch[i] = 0;
 		}
 	}
 
@@ -2084,12 +4061,8 @@ namespace sw
 	{
 		if(!vertexShader) return;
 
-		size_t count = vertexShader->getLength();
-
-		for(size_t i = 0; i < count; i++)
+		for(const Shader::Instruction *instruction : vertexShader->getDefinitions())
 		{
-			const Shader::Instruction *instruction = vertexShader->getInstruction(i);
-
 			if(instruction->opcode == Shader::OPCODE_DEF)
 			{
 				int index = instruction->dst.index;
@@ -2128,12 +4101,8 @@ namespace sw
 	{
 		if(!pixelShader) return;
 
-		size_t count = pixelShader->getLength();
-
-		for(size_t i = 0; i < count; i++)
+		for(const Shader::Instruction *instruction : pixelShader->getDefinitions())
 		{
-			const Shader::Instruction *instruction = pixelShader->getInstruction(i);
-
 			if(instruction->opcode == Shader::OPCODE_DEF)
 			{
 				int index = instruction->dst.index;
@@ -2171,6 +4140,20 @@ namespace sw
 	void Renderer::setIndexBuffer(Resource *indexBuffer)
 	{
 		context->indexBuffer = indexBuffer;
+		indexRangeValid = false;
+		restartIndices.clear();
+	}
+
+	void Renderer::setIndexRange(unsigned int minIndex, unsigned int maxIndex)
+	{
+		indexRangeValid = minIndex <= maxIndex;
+		indexRangeMin = minIndex;
+		indexRangeMax = maxIndex;
+	}
+
+	void Renderer::setRestartIndices(const int *positions, size_t count)
+	{
+		restartIndices.assign(positions, positions + count);
 	}
 
 	void Renderer::setMultiSampleMask(unsigned int mask)
@@ -2201,6 +4184,71 @@ namespace sw
 		return false;
 	}
 
+	// Returns the sequence of the latest draw call in flight which renders to the resource, or 0. Also reports whether
+	// any draw calls in flight hold it for the renderer, so it can be sampled without waiting for them.
+	int64_t Renderer::lastWriter(Resource *resource, bool &managed)
+	{
+		int64_t sequence = 0;
+
+		for(int i = 0; i < drawCount; i++)
+		{
+			const DrawCall &draw = *drawCall[i];
+
+			if(draw.references == -1)
+			{
+				continue;   // Retired, its surfaces may have been deleted since
+			}
+
+			bool writes = (draw.depthBuffer && draw.depthBuffer->getResource() == resource) ||
+			              (draw.stencilBuffer && draw.stencilBuffer->getResource() == resource);
+
+			for(int index = 0; index < RENDERTARGETS; index++)
+			{
+				writes = writes || (draw.renderTarget[index] && draw.renderTarget[index]->getResource() == resource);
+			}
+
+			if(writes)
+			{
+				sequence = max(sequence, (int64_t)draw.sequence);
+				managed = true;
+			}
+
+			for(int sampler = 0; sampler < TOTAL_IMAGE_UNITS && !managed; sampler++)
+			{
+				managed = (draw.managedTextures & (1u << sampler)) && draw.texture[sampler] == resource;
+			}
+		}
+
+		return sequence;
+	}
+
+	// Returns the sequence of the latest draw call in flight which samples the resource, or 0
+	int64_t Renderer::lastReader(Resource *resource)
+	{
+		int64_t sequence = 0;
+
+		for(int i = 0; i < drawCount; i++)
+		{
+			const DrawCall &draw = *drawCall[i];
+
+			if(draw.references == -1)
+			{
+				continue;
+			}
+
+			for(int sampler = 0; sampler < TOTAL_IMAGE_UNITS; sampler++)
+			{
+				if(draw.texture[sampler] == resource)
+				{
+					sequence = max(sequence, (int64_t)draw.sequence);
+					break;
+				}
+			}
+		}
+
+		return sequence;
+	}
+
 	void Renderer::updateClipper()
 	{
 		if(updateClipPlanes)
@@ -2542,24 +4590,47 @@ namespace sw
 
 	void Renderer::setPixelShaderConstantF(unsigned int index, const float value[4], unsigned int count)
 	{
-		for(unsigned int i = 0; i < DRAW_COUNT; i++)
+		// Only the registers which actually change make the draw calls copy them again
+		unsigned int begin = index;
+		unsigned int end = min(index + count, (unsigned int)FRAGMENT_UNIFORM_VECTORS);
+
+		while(begin < end && memcmp(&PixelProcessor::c[begin], &value[4 * (begin - index)], sizeof(float4)) == 0)
+		{
+			begin++;
+		}
+
+		while(end > begin && memcmp(&PixelProcessor::c[end - 1], &value[4 * (end - 1 - index)], sizeof(float4)) == 0)
+		{
+			end--;
+		}
+
+		if(begin == end)
+		{
+			return;
+		}
+
+		for(int i = 0; i < drawCount; i++)
 		{
-			if(drawCall[i]->psDirtyConstF < index + count)
+			if(drawCall[i]->psDirtyConstF == 0 || drawCall[i]->psDirtyConstFBegin > begin)
+			{
+				drawCall[i]->psDirtyConstFBegin = begin;
+			}
+
+			if(drawCall[i]->psDirtyConstF < end)
 			{
-				drawCall[i]->psDirtyConstF = index + count;
+				drawCall[i]->psDirtyConstF = end;
 			}
 		}
 
-		for(unsigned int i = 0; i < count; i++)
+		for(unsigned int i = begin; i < end; i++)
 		{
-			PixelProcessor::setFloatConstant(index + i, value);
-			value += 4;
+			PixelProcessor::setFloatConstant(i, &value[4 * (i - index)]);
 		}
 	}
 
 	void Renderer::setPixelShaderConstantI(unsigned int index, const int value[4], unsigned int count)
 	{
-		for(unsigned int i = 0; i < DRAW_COUNT; i++)
+		for(int i = 0; i < drawCount; i++)
 		{
 			if(drawCall[i]->psDirtyConstI < index + count)
 			{
@@ -2576,7 +4647,7 @@ namespace sw
 
 	void Renderer::setPixelShaderConstantB(unsigned int index, const int *boolean, unsigned int count)
 	{
-		for(unsigned int i = 0; i < DRAW_COUNT; i++)
+		for(int i = 0; i < drawCount; i++)
 		{
 			if(drawCall[i]->psDirtyConstB < index + count)
 			{
@@ -2593,24 +4664,47 @@ namespace sw
 
 	void Renderer::setVertexShaderConstantF(unsigned int index, const float value[4], unsigned int count)
 	{
-		for(unsigned int i = 0; i < DRAW_COUNT; i++)
+		// Only the registers which actually change make the draw calls copy them again
+		unsigned int begin = index;
+		unsigned int end = min(index + count, (unsigned int)VERTEX_UNIFORM_VECTORS);
+
+		while(begin < end && memcmp(&VertexProcessor::c[begin], &value[4 * (begin - index)], sizeof(float4)) == 0)
+		{
+			begin++;
+		}
+
+		while(end > begin && memcmp(&VertexProcessor::c[end - 1], &value[4 * (end - 1 - index)], sizeof(float4)) == 0)
+		{
+			end--;
+		}
+
+		if(begin == end)
+		{
+			return;
+		}
+
+		for(int i = 0; i < drawCount; i++)
 		{
-			if(drawCall[i]->vsDirtyConstF < index + count)
+			if(drawCall[i]->vsDirtyConstF == 0 || drawCall[i]->vsDirtyConstFBegin > begin)
+			{
+				drawCall[i]->vsDirtyConstFBegin = begin;
+			}
+
+			if(drawCall[i]->vsDirtyConstF < end)
 			{
-				drawCall[i]->vsDirtyConstF = index + count;
+				drawCall[i]->vsDirtyConstF = end;
 			}
 		}
 
-		for(unsigned int i = 0; i < count; i++)
+		for(unsigned int i = begin; i < end; i++)
 		{
-			VertexProcessor::setFloatConstant(index + i, value);
-			value += 4;
+			VertexProcessor::setFloatConstant(i, &value[4 * (i - index)]);
 		}
 	}
 
 	void Renderer::setVertexShaderConstantI(unsigned int index, const int value[4], unsigned int count)
 	{
-		for(unsigned int i = 0; i < DRAW_COUNT; i++)
+		for(int i = 0; i < drawCount; i++)
 		{
 			if(drawCall[i]->vsDirtyConstI < index + count)
 			{
@@ -2627,7 +4721,7 @@ namespace sw
 
 	void Renderer::setVertexShaderConstantB(unsigned int index, const int *boolean, unsigned int count)
 	{
-		for(unsigned int i = 0; i < DRAW_COUNT; i++)
+		for(int i = 0; i < drawCount; i++)
 		{
 			if(drawCall[i]->vsDirtyConstB < index + count)
 			{
@@ -2668,44 +4762,264 @@ namespace sw
 	void Renderer::addQuery(Query *query)
 	{
 		queries.push_back(query);
+		updateOcclusionAnySample();
 	}
 
 	void Renderer::removeQuery(Query *query)
 	{
 		queries.remove(query);
+		updateOcclusionAnySample();
+	}
+
+	void Renderer::addTimestamp(Query *query)
+	{
+		query->begin();
+		query->end();
+		++query->reference; // Atomic
+
+		timestampMutex.lock();
+		timestamps.push_back({drawSequence, query});
+		pendingTimestamps++;
+		timestampMutex.unlock();
+
+		// Either this sees the last draw call retired, or the retiring thread sees the pending timestamp
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		resolveTimestamps();
+	}
+
+	void Renderer::removeTimestamp(Query *query)
+	{
+		timestampMutex.lock();
+
+		for(auto timestamp = timestamps.begin(); timestamp != timestamps.end();)
+		{
+			if(timestamp->query == query)
+			{
+				timestamp = timestamps.erase(timestamp);
+				pendingTimestamps--;
+			}
+			else
+			{
+				timestamp++;
+			}
+		}
+
+		timestampMutex.unlock();
+	}
+
+	void Renderer::resolveTimestamps()
+	{
+		timestampMutex.lock();
+
+		// Completed in issue order, later ones can't finish before earlier ones
+		while(!timestamps.empty() && drawsRetired(timestamps.front().sequence))
+		{
+			Query *query = timestamps.front().query;
+			timestamps.pop_front();
+			pendingTimestamps--;
+
+			query->finish = Timer::nanoseconds();
+			--query->reference; // Atomic
+		}
+
+		timestampMutex.unlock();
 	}
 
-	#if PERF_HUD
-		int Renderer::getThreadCount()
+	void Renderer::updateOcclusionAnySample()
+	{
+		bool any = false;
+		bool counted = false;
+
+		for(auto &query : queries)
 		{
-			return threadCount;
+			any |= (query->type == Query::ANY_FRAGMENTS_PASSED);
+			counted |= (query->type == Query::FRAGMENTS_PASSED);
 		}
 
-		int64_t Renderer::getVertexTime(int thread)
+		context->occlusionAnySample = any && !counted;
+	}
+
+	bool Renderer::anySamplesPassed()
+	{
+		for(auto &query : queries)
 		{
-			return vertexTime[thread];
+			if(query->type == Query::ANY_FRAGMENTS_PASSED && query->data == 0)
+			{
+				return false;
+			}
 		}
 
-		int64_t Renderer::getSetupTime(int thread)
+		return true;
+	}
+
+	void Renderer::setProfiling(bool enable)
+	{
+		profiling = enable;
+		quadCounting = enable;
+	}
+
+	void Renderer::setProfileCallback(ProfileCallback callback, void *userData)
+	{
+		sync->lock(sw::PUBLIC);   // Wait for draw calls which may still invoke the previous callback
+
+		profileCallback = callback;
+		profileUserData = userData;
+
+		sync->unlock();
+	}
+
+	void Renderer::setShaderProfiling(bool enable)
+	{
+		shaderProfiling = enable;
+	}
+
+	void Renderer::setPipelineProfiling(bool enable)
+	{
+		pipelineProfiling = enable;
+	}
+
+	bool Renderer::getPipelineProfiling() const
+	{
+		return pipelineProfiling;
+	}
+
+	PipelineProfile Renderer::getPipelineProfile()
+	{
+		pipelineProfileMutex.lock();
+		PipelineProfile profile = pipelineProfile;
+		pipelineProfileMutex.unlock();
+
+		return profile;
+	}
+
+	void Renderer::resetPipelineProfile()
+	{
+		pipelineProfileMutex.lock();
+		pipelineProfile = PipelineProfile();
+		pipelineProfileMutex.unlock();
+	}
+
+	void Renderer::setSchedulingPriority(SchedulingPriority priority)
+	{
+		workerClient.setPriority(priority);
+	}
+
+	void Renderer::setCpuShare(int percent)
+	{
+		workerClient.setCpuShare(percent);
+	}
+
+	SchedulingPriority Renderer::getSchedulingPriority() const
+	{
+		return workerClient.getPriority();
+	}
+
+	int Renderer::getCpuShare() const
+	{
+		return workerClient.getCpuShare();
+	}
+
+	int64_t Renderer::getWorkerTime() const
+	{
+		return workerClient.getThreadTime();
+	}
+
+	int Renderer::getRecentWorkerShare()
+	{
+		return workerClient.getRecentShare();
+	}
+
+	bool Renderer::getShaderProfile(int shaderID, ShaderProfile &profile)
+	{
+		shaderProfileMutex.lock();
+
+		auto entry = shaderProfiles.find(shaderID);
+		bool found = entry != shaderProfiles.end() && entry->second.draws > 0;
+
+		if(found)
 		{
-			return setupTime[thread];
+			profile = entry->second;
 		}
 
-		int64_t Renderer::getPixelTime(int thread)
+		shaderProfileMutex.unlock();
+
+		return found;
+	}
+
+	void Renderer::printShaderProfiles(const char *fileName)
+	{
+		FILE *file = fopen(fileName, "w");
+
+		if(!file)
 		{
-			return pixelTime[thread];
+			return;
 		}
 
-		void Renderer::resetTimers()
+		shaderProfileMutex.lock();
+
+		for(const auto &entry : shaderProfiles)
 		{
-			for(int thread = 0; thread < threadCount; thread++)
+			const ShaderProfile &profile = entry.second;
+
+			int64_t total = 0;
+
+			for(int64_t cycles : profile.cycles)
+			{
+				total += cycles;
+			}
+
+			fprintf(file, "// Pixel shader %d, %u draws, %lld ticks\n", entry.first, profile.draws, (long long)total);
+
+			for(size_t i = 0; i < profile.instructions.size(); i++)
 			{
-				vertexTime[thread] = 0;
-				setupTime[thread] = 0;
-				pixelTime[thread] = 0;
+				double share = total ? 100.0 * profile.cycles[i] / total : 0.0;
+
+				fprintf(file, "%14lld %12lld %5.1f%%  %s\n", (long long)profile.cycles[i], (long long)profile.executions[i], share, profile.instructions[i].c_str());
 			}
+
+			fprintf(file, "\n");
+		}
+
+		shaderProfileMutex.unlock();
+
+		fclose(file);
+	}
+
+	ThreadProfile Renderer::getThreadProfile(int thread) const
+	{
+		ASSERT(thread >= 0 && thread < threadCount);
+
+		return threadState[thread].profile;
+	}
+
+	int Renderer::getThreadCount()
+	{
+		return threadCount;
+	}
+
+	int64_t Renderer::getVertexTime(int thread)
+	{
+		return threadState[thread].profile.vertexTime;
+	}
+
+	int64_t Renderer::getSetupTime(int thread)
+	{
+		return threadState[thread].profile.setupTime;
+	}
+
+	int64_t Renderer::getPixelTime(int thread)
+	{
+		return threadState[thread].profile.pixelTime;
+	}
+
+	void Renderer::resetTimers()
+	{
+		for(int thread = 0; thread < threadCount; thread++)
+		{
+			threadState[thread].profile = ThreadProfile();
 		}
-	#endif
+	}
 
 	void Renderer::setViewport(const Viewport &viewport)
 	{
@@ -2733,24 +5047,70 @@ namespace sw
 		updateClipPlanes = true;
 	}
 
+	void Renderer::warmUpRoutines(const Format *renderTargetFormats, int count)
+	{
+		#if !defined(_WIN32)   // The thread gets joined when the library is unloaded, which DllMain can't do
+			SwiftConfig::Configuration configuration = {};
+			SwiftConfig(true).getConfiguration(configuration);
+
+			// With a single core it would only delay the application's own work
+			bool warmUp = (configuration.routineWarmUp < 0) ? (CPUID::processAffinity() > 1) : (configuration.routineWarmUp != 0);
+
+			if(warmUp)
+			{
+				Blitter::warmUp(renderTargetFormats, count);
+			}
+		#endif
+	}
+
+	void Renderer::overrideConfiguration(const char *section, const char *name, int value)
+	{
+		if(section)
+		{
+			SwiftConfig::setOverride(section, name, value);
+		}
+		else
+		{
+			SwiftConfig::clearOverrides();
+		}
+	}
+
 	void Renderer::updateConfiguration(bool initialUpdate)
 	{
 		bool newConfiguration = swiftConfig->hasNewConfiguration();
 
 		if(newConfiguration || initialUpdate)
 		{
-			terminateThreads();
-
 			SwiftConfig::Configuration configuration = {};
 			swiftConfig->getConfiguration(configuration);
 
-			precacheVertex = !newConfiguration && configuration.precache;
-			precacheSetup = !newConfiguration && configuration.precache;
-			precachePixel = !newConfiguration && configuration.precache;
+			int newThreadCount;
 
-			VertexProcessor::setRoutineCacheSize(configuration.vertexRoutineCacheSize);
-			PixelProcessor::setRoutineCacheSize(configuration.pixelRoutineCacheSize);
-			SetupProcessor::setRoutineCacheSize(configuration.setupRoutineCacheSize);
+			switch(configuration.threadCount)
+			{
+			case -1: newThreadCount = CPUID::coreCount();        break;
+			case 0:  newThreadCount = CPUID::processAffinity();  break;
+			default: newThreadCount = configuration.threadCount; break;
+			}
+
+			int newVertexCacheSize = clamp(ceilPow2(configuration.vertexCacheSize), 4 * VertexCache::WAYS, 4096);
+			bool newPinThreads = configuration.threadAffinity != 0;
+
+			// The thread state is only reallocated when it's sized by a changed setting, the rest just needs the threads idle.
+			// Cached pixel routines are keyed on the cluster count, so the ones for a previous thread count no longer match.
+			if(threadState && (newThreadCount != threadStateCount || newVertexCacheSize != vertexCacheSize || newPinThreads != pinThreads))
+			{
+				terminateThreads();
+			}
+			else
+			{
+				waitForIdleThreads();
+			}
+
+			// Stored routines are only reused when the settings fingerprint matches
+			precacheVertex = configuration.precache;
+			precacheSetup = configuration.precache;
+			precachePixel = configuration.precache;
 
 			switch(configuration.textureSampleQuality)
 			{
@@ -2760,6 +5120,15 @@ namespace sw
 			default: Sampler::setFilterQuality(FILTER_ANISOTROPIC); break;
 			}
 
+			if(configuration.textureSampleQuality == 3)
+			{
+				Sampler::setAnisotropyQuality(8.0f, true);   // At most 4 taps per level
+			}
+			else
+			{
+				Sampler::setAnisotropyQuality(16.0f, false);
+			}
+
 			switch(configuration.mipmapQuality)
 			{
 			case 0:  Sampler::setMipmapQuality(MIPMAP_POINT);  break;
@@ -2768,6 +5137,7 @@ namespace sw
 			}
 
 			setPerspectiveCorrection(configuration.perspectiveCorrection);
+			tiledTextures = configuration.tiledTextures;
 
 			switch(configuration.transcendentalPrecision)
 			{
@@ -2816,11 +5186,23 @@ namespace sw
 			default: transparencyAntialiasing = TRANSPARENCY_NONE;              break;
 			}
 
-			switch(configuration.threadCount)
+			threadCount = newThreadCount;
+			rasterTileHeight = clamp(ceilPow2(configuration.rasterTileHeight), 2, 256);
+			vertexCacheSize = newVertexCacheSize;
+			pinThreads = newPinThreads;
+			concurrentCompilation = configuration.concurrentCompilation != 0;
+			tieredCompilation = configuration.tieredCompilation;
+			uniformSpecialization = max(configuration.uniformSpecialization, 0);
+			drawCulling = configuration.drawCulling != 0;
+			drawMerging = configuration.drawMerging != 0;
+			setHugePageThreshold((size_t)max(configuration.hugePageThreshold, 0) << 20);   // In megabytes
+			Surface::setTextureMemoryBudget((size_t)max(configuration.textureMemory, 0) << 20);
+
+			int drawQueueSize = clamp(ceilPow2(configuration.drawQueueSize), 1, (int)MAX_DRAW_COUNT);
+
+			if(drawQueueSize > drawCount)
 			{
-			case -1: threadCount = CPUID::coreCount();        break;
-			case 0:  threadCount = CPUID::processAffinity();  break;
-			default: threadCount = configuration.threadCount; break;
+				resizeDrawQueue(drawQueueSize);
 			}
 
 			CPUID::setEnableSSE4_1(configuration.enableSSE4_1);
@@ -2839,14 +5221,31 @@ namespace sw
 			postBlendSRGB = configuration.postBlendSRGB;
 			exactColorRounding = configuration.exactColorRounding;
 			forceClearRegisters = configuration.forceClearRegisters;
+			commandTrace = configuration.commandTrace;
+
+			if(configuration.routineTrace != RoutineTelemetry::isEnabled())
+			{
+				RoutineTelemetry::setEnabled(configuration.routineTrace, "sw-routines.json");
+			}
+
+			setShaderProfiling(configuration.shaderProfile);
+			setPipelineProfiling(configuration.pipelineProfile);
+			profiler.setUtilizationProfiling(configuration.utilizationProfile);
 
 		#ifndef NDEBUG
 			minPrimitives = configuration.minPrimitives;
 			maxPrimitives = configuration.maxPrimitives;
 		#endif
+
+			RoutineStore::setFingerprint(routineSettingsFingerprint());
+
+			// After the fingerprint is known, so renderers with the same settings share their routines
+			VertexProcessor::setRoutineCacheSize(configuration.vertexRoutineCacheSize);
+			PixelProcessor::setRoutineCacheSize(configuration.pixelRoutineCacheSize);
+			SetupProcessor::setRoutineCacheSize(configuration.setupRoutineCacheSize);
 		}
 
-		if(!initialUpdate && !worker[0])
+		if(!initialUpdate && !threadState)
 		{
 			initializeThreads();
 		}
@@ -19,12 +19,20 @@
 #include "PixelProcessor.hpp"
 #include "SetupProcessor.hpp"
 #include "Plane.hpp"
+#include "Primitive.hpp"
 #include "Blitter.hpp"
+#include "WorkerPool.hpp"
 #include "Common/MutexLock.hpp"
 #include "Common/Thread.hpp"
 #include "Main/Config.hpp"
 
+#include <atomic>
+#include <condition_variable>
 #include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace sw
 {
@@ -87,9 +95,12 @@ namespace sw
 
 	struct Query
 	{
-		enum Type { FRAGMENTS_PASSED, TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN };
+		// ANY_FRAGMENTS_PASSED only keeps counting until the first fragment passed, and is available from then on.
+		// TIME_ELAPSED spans from the first task of the draw calls issued while building until the last one retired.
+		// TIMESTAMP is added through Renderer::addTimestamp() instead, and is the time all earlier draw calls retired.
+		enum Type { FRAGMENTS_PASSED, ANY_FRAGMENTS_PASSED, TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, TIME_ELAPSED, TIMESTAMP };
 
-		Query(Type type) : building(false), reference(0), data(0), type(type)
+		Query(Type type) : building(false), reference(0), data(0), start(0), finish(0), type(type)
 		{
 		}
 
@@ -97,6 +108,8 @@ namespace sw
 		{
 			building = true;
 			data = 0;
+			start = 0;
+			finish = 0;
 		}
 
 		void end()
@@ -107,22 +120,78 @@ namespace sw
 		bool building;
 		AtomicInt reference;
 		AtomicInt data;
+		std::atomic<int64_t> start;    // Timer::nanoseconds(), 0 until known
+		std::atomic<int64_t> finish;
 
 		const Type type;
 	};
 
+	// Runtime profiling statistics, times are in Timer::ticks() units
+	struct ThreadProfile
+	{
+		int64_t vertexTime;
+		int64_t setupTime;
+		int64_t pixelTime;
+		int64_t scheduleTime;   // Finding, stealing and waiting for the lock of tasks
+		int64_t idleTime;       // Polling and parked while no tasks were available
+
+		unsigned int primitiveTasks;
+		unsigned int pixelTasks;
+		unsigned int vertexTasks;   // Vertex pre-pass chunks
+
+		unsigned int maxQueueDepth;   // Most tasks found in this thread's deque after a search
+	};
+
+	struct DrawProfile
+	{
+		unsigned int drawCall;   // Sequence number of the draw call
+		unsigned int primitives;
+
+		int64_t vertexTime;
+		int64_t setupTime;
+		int64_t pixelTime;
+		int64_t totalTime;
+
+		unsigned int verticesShaded;     // Vertex shader invocations, each post-transform cache miss transforms four
+		unsigned int vertexCacheHits;    // Vertices which were already transformed
+		unsigned int primitivesCulled;   // Clipped, facing away or not covering any sample
+
+		int64_t quadsCovered;   // Quads reaching the pixel routine, after hierarchical depth rejection
+		int64_t quadsShaded;    // Quads passing the early depth and stencil tests
+		int64_t quadsWritten;   // Quads reaching the depth and color writes, the remaining shaded ones were killed
+	};
+
+	// Per cluster quad counts of a draw call, while profiling
+	struct QuadStatistics
+	{
+		int64_t covered;
+		int64_t shaded;
+		int64_t written;
+	};
+
+	typedef void (*ProfileCallback)(const DrawProfile &profile, void *userData);
+
+	// Cost of each pixel shader instruction, indexed like Shader::getInstruction(), in Timer::ticks() units
+	struct ShaderProfile
+	{
+		std::vector<std::string> instructions;   // As listed by Shader::print()
+		std::vector<int64_t> cycles;
+		std::vector<int64_t> executions;   // Per quad, zero for control flow instructions which aren't timed
+		unsigned int draws;
+	};
+
 	struct DrawData
 	{
 		const Constants *constants;
 
 		const void *input[MAX_VERTEX_INPUTS];
 		unsigned int stride[MAX_VERTEX_INPUTS];
-		Texture mipmap[TOTAL_IMAGE_UNITS];
+		const Texture *mipmap[TOTAL_IMAGE_UNITS];
 		const void *indices;
 
 		struct VS
 		{
-			float4 c[VERTEX_UNIFORM_VECTORS + 1];   // One extra for indices out of range, c[VERTEX_UNIFORM_VECTORS] = {0, 0, 0, 0}
+			float4 c[VERTEX_UNIFORM_VECTORS + 1 + PROLOGUE_UNIFORM_VECTORS];   // One extra for indices out of range, c[VERTEX_UNIFORM_VECTORS] = {0, 0, 0, 0}, then the shader prologue's results
 			byte* u[MAX_UNIFORM_BUFFER_BINDINGS];
 			byte* t[MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS];
 			unsigned int reg[MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS]; // Offset used when reading from registers, in components
@@ -136,7 +205,7 @@ namespace sw
 		struct PS
 		{
 			word4 cW[8][4];
-			float4 c[FRAGMENT_UNIFORM_VECTORS];
+			float4 c[FRAGMENT_UNIFORM_VECTORS + PROLOGUE_UNIFORM_VECTORS];   // Followed by the shader prologue's results
 			byte* u[MAX_UNIFORM_BUFFER_BINDINGS];
 			int4 i[16];
 			bool b[16];
@@ -159,11 +228,17 @@ namespace sw
 		PixelProcessor::Stencil stencilCCW;
 		PixelProcessor::Fog fog;
 		PixelProcessor::Factor factor;
-		unsigned int occlusion[16];   // Number of pixels passing depth test
+		enum
+		{
+			CLUSTER_STRIDE = 64,   // Bytes between the clusters' entries of the per-cluster counters, so threads rendering different clusters don't write to the same cache line
+			OCCLUSION_STRIDE = CLUSTER_STRIDE / sizeof(unsigned int),
+			PIPELINE_STRIDE = (sizeof(PipelineProfile) + CLUSTER_STRIDE - 1) & ~(CLUSTER_STRIDE - 1),
+		};
 
-		#if PERF_PROFILE
-			int64_t cycles[PERF_TIMERS][16];
-		#endif
+		unsigned int *occlusion;   // Number of pixels passing depth test, per cluster, OCCLUSION_STRIDE apart
+		int64_t *shaderProfile;    // Cycles and executions of each pixel shader instruction, per cluster, null unless profiled
+		PipelineProfile *pipelineProfile;   // Per cluster, PIPELINE_STRIDE bytes apart, null unless profiled
+		QuadStatistics *quadStatistics;     // Per cluster, CLUSTER_STRIDE bytes apart, null unless profiling
 
 		TextureStage::Uniforms textureStage[8];
 
@@ -175,6 +250,8 @@ namespace sw
 		float4 YYYY;
 		float4 halfPixelX;
 		float4 halfPixelY;
+		float4 guardBandX;   // Clip space extent beyond which vertices require clipping, relative to w
+		float4 guardBandY;
 		float viewportHeight;
 		float slopeDepthBias;
 		float depthRange;
@@ -184,9 +261,19 @@ namespace sw
 		unsigned int *colorBuffer[RENDERTARGETS];
 		int colorPitchB[RENDERTARGETS];
 		int colorSliceB[RENDERTARGETS];
+		unsigned char *colorClearTiles[RENDERTARGETS];   // Pending clears of each 16x2 pixel tile
+		int colorClearTilesPitchB[RENDERTARGETS];
+		unsigned char *colorSampleTiles[RENDERTARGETS];   // Set for each 16x2 pixel tile whose samples may differ
+		int colorSampleTilesPitchB[RENDERTARGETS];
+		unsigned int colorClearPattern[RENDERTARGETS];
 		float *depthBuffer;
 		int depthPitchB;
 		int depthSliceB;
+		float *hierarchicalDepth;   // Maximum depth of each 16x2 pixel tile
+		int hierarchicalDepthPitchB;
+		unsigned char *depthClearTiles;
+		int depthClearTilesPitchB;
+		unsigned int depthClearPattern;
 		unsigned char *stencilBuffer;
 		int stencilPitchB;
 		int stencilSliceB;
@@ -196,6 +283,8 @@ namespace sw
 		int scissorY0;
 		int scissorY1;
 
+		int primitiveStride;   // Size of the draw's Primitive records, see Primitive::stride()
+
 		float4 a2c0;
 		float4 a2c1;
 		float4 a2c2;
@@ -220,6 +309,7 @@ namespace sw
 			{
 				PRIMITIVES,
 				PIXELS,
+				VERTICES,   // Vertex pre-pass chunk, index in primitiveUnit
 
 				RESUME,
 				SUSPEND
@@ -230,7 +320,57 @@ namespace sw
 			AtomicInt pixelCluster;
 		};
 
-		struct PrimitiveProgress
+		// Bounded Chase-Lev work-stealing deque of packed tasks. Only the owning
+		// thread pushes and pops at the bottom, other threads steal from the top.
+		struct TaskDeque
+		{
+			enum StealResult
+			{
+				STOLEN,
+				EMPTY,
+				ABORT   // Lost a race with another thread, retry
+			};
+
+			TaskDeque();
+
+			~TaskDeque();
+
+			void init(int capacity);   // Power of 2, must hold all outstanding tasks
+
+			void push(int task);
+			bool pop(int &task);
+			StealResult steal(int &task);
+			int size() const;
+
+			// Ensure the indices don't share cache lines with other deques
+			volatile int padding1[16];
+			std::atomic<unsigned int> top;
+			volatile int padding2[15];
+			std::atomic<unsigned int> bottom;
+			std::atomic<int> *slot;
+			unsigned int mask;
+		};
+
+		// Written by its worker thread all the time, and only occasionally by others. Each thread's
+		// state is on its own cache lines so these writes don't keep invalidating the other threads'.
+		enum ThreadSchedule
+		{
+			THREAD_IDLE,         // Not queued on the worker pool
+			THREAD_SCHEDULED,    // Queued or running on the worker pool
+			THREAD_RESCHEDULE    // Resumed while running, runs the task loop again before returning to the pool
+		};
+
+		ALIGN(64, struct ThreadState
+		{
+			Task task;   // Current task
+			std::atomic<bool> resumePending;   // Resumed but not signaled yet
+			std::atomic<int> schedule;   // ThreadSchedule
+			int64_t idleTick;   // When the thread last left the worker pool, for profiling
+			ThreadProfile profile;
+		});
+
+		// Each unit and cluster's progress is updated by whichever thread works on it, so they get separate cache lines
+		ALIGN(64, struct PrimitiveProgress
 		{
 			void init()
 			{
@@ -246,9 +386,9 @@ namespace sw
 			AtomicInt primitiveCount;
 			AtomicInt visible;
 			AtomicInt references;
-		};
+		});
 
-		struct PixelProgress
+		ALIGN(64, struct PixelProgress
 		{
 			void init()
 			{
@@ -260,6 +400,29 @@ namespace sw
 			AtomicInt drawCall;
 			AtomicInt processedPrimitives;
 			AtomicInt executing;
+		});
+
+		// State copied into a draw call's data which the routines don't depend on. Compared bytewise,
+		// so it's cleared before being filled in.
+		struct DrawInputs
+		{
+			Viewport viewport;
+			Rect scissor;
+			int clipFlags;
+			Plane clipPlane[MAX_CLIP_PLANES];
+			float depthBias;
+			float slopeDepthBias;
+			float lineWidth;
+			float alphaReference;
+			int instanceID;
+			unsigned int renderTargetLayer[RENDERTARGETS];
+			unsigned int depthBufferLayer;
+			unsigned int stencilBufferLayer;
+			PixelProcessor::Stencil stencil;
+			PixelProcessor::Stencil stencilCCW;
+			PixelProcessor::Fog fog;
+			PixelProcessor::Factor factor;
+			VertexProcessor::PointSprite point;
 		};
 
 	public:
@@ -271,12 +434,18 @@ namespace sw
 		void operator delete(void * mem);
 
 		void draw(DrawType drawType, unsigned int indexOffset, unsigned int count, bool update = true);
+		void precompile(DrawType drawType);   // Generates the routines a draw with the current state would use
+		static void warmUpRoutines(const Format *renderTargetFormats, int count);   // Starts generating common routines in the background, as configured
+		static void overrideConfiguration(const char *section, const char *name, int value);   // See SwiftConfig::setOverride(), a null section clears the overrides
 
 		void clear(void *value, Format format, Surface *dest, const Rect &rect, unsigned int rgbaMask);
 		void blit(Surface *source, const SliceRectF &sRect, Surface *dest, const SliceRect &dRect, bool filter, bool isStencil = false, bool sRGBconversion = true);
 		void blit3D(Surface *source, Surface *dest);
+		bool generateMipmaps(Surface *const *levels, int levelCount, int faceCount);   // Levels stored face by face
 
 		void setIndexBuffer(Resource *indexBuffer);
+		void setIndexRange(unsigned int minIndex, unsigned int maxIndex);   // Reset by setIndexBuffer()
+		void setRestartIndices(const int *positions, size_t count);         // Ascending positions of the restart index in indexed strips and fans, reset by setIndexBuffer()
 
 		void setMultiSampleMask(unsigned int mask);
 		void setTransparencyAntialiasing(TransparencyAntialiasing transparencyAntialiasing);
@@ -341,30 +510,107 @@ namespace sw
 
 		void addQuery(Query *query);
 		void removeQuery(Query *query);
+		void addTimestamp(Query *query);   // Completes once the draw calls issued so far have retired
+		void removeTimestamp(Query *query);   // Before deleting one which may still be pending
+		void resolveTimestamps();   // Completes the ones whose draw calls have retired
 
 		void synchronize();
 
-		#if PERF_HUD
-			// Performance timers
-			int getThreadCount();
-			int64_t getVertexTime(int thread);
-			int64_t getSetupTime(int thread);
-			int64_t getPixelTime(int thread);
-			void resetTimers();
-		#endif
+		// Draw calls are numbered in the order they're issued, starting at 1
+		int64_t getDrawSequence() const { return drawSequence; }
+		bool hasRetired(int64_t sequence);     // All draw calls and readbacks up to the sequence number released their resources
+		void waitForDraw(int64_t sequence);    // Only by the application thread, which the retirement events belong to
+		bool waitForRetirement(int64_t sequence, double timeout);   // By any thread, false when the timeout in seconds expired, negative ones wait indefinitely
+
+		// Converts a rectangle of the surface into the resource's memory on a separate thread, once the draw calls issued
+		// so far have retired. Both stay locked until then. Returns the readback's sequence number, or 0 when the copy has
+		// to be performed synchronously.
+		int64_t queueReadback(Surface *source, const Rect &rect, Resource *buffer, void *dest, Format format, int pitchB);
+		void finishReadbacks(Surface *source = nullptr);   // Of the surface, or all of them
+
+		// Copies or converts a rectangle of the surface into client memory, once the draw calls writing it are done.
+		// Returns false when it needs a blit, for multisampled or quad layout surfaces, depth, or clipped rectangles.
+		bool readPixels(Surface *source, const Rect &rect, void *dest, Format format, int pitchB);
+
+		// Runtime profiling, disabled by default unless PERF_HUD is set
+		void setProfiling(bool enable);
+		void setProfileCallback(ProfileCallback callback, void *userData);   // Called on worker threads as draw calls retire
+		ThreadProfile getThreadProfile(int thread) const;
+
+		// Per instruction pixel shader profiling, instruments the routines generated while enabled
+		void setShaderProfiling(bool enable);
+		bool getShaderProfile(int shaderID, ShaderProfile &profile);   // False until a profiled draw of the shader retired
+		void printShaderProfiles(const char *fileName);
+
+		// Pixel pipeline stage profiling, instruments the routines generated while enabled
+		void setPipelineProfiling(bool enable);
+		bool getPipelineProfiling() const;
+		PipelineProfile getPipelineProfile();   // Of the profiled draw calls which retired since the last reset
+		void resetPipelineProfile();
+
+		// Scheduling of the worker threads relative to other renderers, and the time they spent working
+		void setSchedulingPriority(SchedulingPriority priority);
+		void setCpuShare(int percent);   // Of the worker pool while other renderers wait for it
+		SchedulingPriority getSchedulingPriority() const;
+		int getCpuShare() const;
+		int64_t getWorkerTime() const;   // In nanoseconds, since the renderer was created
+		int getRecentWorkerShare();      // Of the worker pool during the last accounting period, in per mille
+
+		// Performance timers
+		int getThreadCount();
+		int64_t getVertexTime(int thread);
+		int64_t getSetupTime(int thread);
+		int64_t getPixelTime(int thread);
+		void resetTimers();
+
+		// Number of draw calls which were split in batches of [2^bucket, 2^(bucket + 1)) primitives
+		unsigned int getBatchSizeCount(int bucket) const;
+		void resetBatchSizeCounts();
+
+		// Post-transform vertex cache lookups and misses of retired draw calls
+		int64_t getVertexCacheLookups() const;
+		int64_t getVertexCacheMisses() const;
+		void resetVertexCacheCounts();
 
 		static int getClusterCount() { return clusterCount; }
+		static int getRasterTileHeight() { return rasterTileHeight; }
 
 	private:
-		static void threadFunction(void *parameters);
-		void threadLoop(int threadIndex);
-		void taskLoop(int threadIndex);
-		void findAvailableTasks();
+		const VertexShader *routineVertexShader() const;
+		void updateRoutines(bool vertexChanged, bool setupChanged, bool pixelChanged);
+		static void generateVertexRoutine(void *parameters);
+		OptimizationLevel initialOptimization() const { return tieredCompilation > 0 ? OptimizationQuick : OptimizationDefault; }
+		static void generateSetupRoutine(void *parameters);
+
+		static bool workerFunction(void *renderer, int threadIndex);
+		bool workerLoop(int threadIndex);
+		bool taskLoop(int threadIndex);
+		void findAvailableTasks(TaskDeque &deque);
+		bool stealTask(int threadIndex, int &packedTask);
+		bool resumeThreads(int count);
+		void signalResumedThreads();
 		void scheduleTask(int threadIndex);
 		void executeTask(int threadIndex);
 		void finishRendering(Task &pixelTask);
 
+		bool drawsRetired(int64_t sequence);
+		void notifyRetirement();   // Wakes up the threads in waitForRetirement()
+		bool inFlight(int64_t sequence);   // Any draw call up to the sequence number not retired yet. Must hold the scheduler lock.
+		bool isReadbackPending(Surface *source);
+		static void readbackRoutine(void *parameters);
+		void processReadbacks();
+
+		int chooseBatchSize(unsigned int count, int maxBatch);
+		bool isCulled(unsigned int count);
+		bool isMergeable(DrawType drawType);
+		void getDrawInputs(DrawInputs &inputs);
+		bool mergeDraw(const DrawInputs &inputs, unsigned int indexOffset, unsigned int count, int batch, int (Renderer::*setupPrimitives)(int batch, int count));
+		void updateOcclusionAnySample();
+		bool anySamplesPassed();   // By all active occlusion queries, as far as retired draw calls have counted
+
 		void processPrimitiveVertices(int unit, unsigned int start, unsigned int count, unsigned int loop, int thread);
+		void processPrepassVertices(int chunk, int thread);
+		void setupInstance(VertexTask *task, DrawCall *draw, unsigned int instance);
 
 		int setupSolidTriangles(int batch, int count);
 		int setupWireframeTriangle(int batch, int count);
@@ -376,10 +622,18 @@ namespace sw
 		bool setupPoint(Primitive &primitive, Triangle &triangle, const DrawCall &draw);
 
 		bool isReadWriteTexture(int sampler);
+		int64_t lastWriter(Resource *resource, bool &managed);
+		int64_t lastReader(Resource *resource);
 		void updateClipper();
 		void updateConfiguration(bool initialUpdate = false);
+		void resizeDrawQueue(int count);
+		void growDrawQueue();
 		void initializeThreads();
 		void terminateThreads();
+		void waitForIdleThreads();
+		void allocateBatches(int unit);             // On first use of the primitive unit
+		VertexTask *getVertexTask(int thread);      // Allocated on first use by the thread
+		void freeBatches();                         // Of all units and threads, while no draw is in flight
 
 		void loadConstants(const VertexShader *vertexShader);
 		void loadConstants(const PixelShader *pixelShader);
@@ -391,61 +645,134 @@ namespace sw
 		Rect scissor;
 		int clipFlags;
 
-		Triangle *triangleBatch[16];
-		Primitive *primitiveBatch[16];
+		Triangle **triangleBatch;     // One batch per primitive unit
+		Primitive **primitiveBatch;   // One batch per primitive unit
+		Primitive::Outline **outlineBatch;   // Room for one outline per primitive sample, for each primitive unit
 
 		// User-defined clipping planes
 		Plane userPlane[MAX_CLIP_PLANES];
 		Plane clipPlane[MAX_CLIP_PLANES];   // Tranformed to clip space
 		bool updateClipPlanes;
 
-		AtomicInt exitThreads;
 		AtomicInt threadsAwake;
-		Thread *worker[16];
-		Event *resume[16];         // Events for resuming threads
-		Event *suspend[16];        // Events for suspending threads
+		ThreadState *threadState;  // Sized by initializeThreads(), one per worker thread, which run on the WorkerPool
+		int threadStateCount;      // The global thread count when the thread state was sized
+		WorkerPool::Client workerClient;
 		Event *resumeApp;          // Event for resuming the application thread
 
-		PrimitiveProgress primitiveProgress[16];
-		PixelProgress pixelProgress[16];
-		Task task[16];   // Current tasks for threads
+		// Sized by initializeThreads() for the current thread, unit and cluster counts
+		PrimitiveProgress *primitiveProgress;
+		PixelProgress *pixelProgress;
+
+		enum {
+			MAX_DRAW_COUNT = 256,   // Upper limit for growing the draw call queue
+		};
+		int drawCount;       // Number of draw calls buffered (power of 2), grows when the application stalls
+		int drawCountBits;
+		bool drawQueueStalled;
+		DrawCall **drawCall;   // Pool of draw calls, recycled when they retire
+		DrawCall **drawList;   // Ring of issued draw calls
 
 		enum {
-			DRAW_COUNT = 16,   // Number of draw calls buffered (must be power of 2)
-			DRAW_COUNT_BITS = DRAW_COUNT - 1,
+			BATCH_SIZE_BUCKETS = 8,   // Up to the maximum batch size of 128
 		};
-		DrawCall *drawCall[DRAW_COUNT];
-		DrawCall *drawList[DRAW_COUNT];
+		std::atomic<int64_t> primitiveCost;   // Moving average of ticks spent per primitive
+		unsigned int batchSizeCount[BATCH_SIZE_BUCKETS];
+
+		int vertexCacheSize;   // Vertices per thread's post-transform cache
+		bool pinThreads;       // Pin workers to processors, consecutive threads on the same NUMA node
+		bool concurrentCompilation;   // Generate missing vertex and setup routines on separate threads
+		int tieredCompilation;        // Draws after which quickly generated routines get optimized, 0 optimizes them right away
+		std::atomic<int64_t> vertexCacheLookups;
+		std::atomic<int64_t> vertexCacheMisses;
 
 		AtomicInt currentDraw;
 		AtomicInt nextDraw;
+		std::atomic<int64_t> drawSequence;   // Of the last issued draw call, incremented by the application thread and read by other contexts' fences
+
+		std::mutex retireMutex;
+		std::condition_variable retireCondition;   // Notified when draw calls or readbacks retire, while other threads wait for them
+		std::atomic<int> retireWaiters;
 
 		enum {
-			TASK_COUNT = 32,   // Size of the task queue (must be power of 2)
-			TASK_COUNT_BITS = TASK_COUNT - 1,
+			PREPASS_CHUNK_SIZE = 128,      // Vertices per pre-pass task, multiple of 4
+			PREPASS_MIN_VERTICES = 1024,   // Smaller draws are handled fine by the per-batch vertex cache
+			PREPASS_MAX_VERTICES = 65536,  // Bounds the size of the shared post-transform buffer
 		};
-		Task taskQueue[TASK_COUNT];
-		AtomicInt qHead;
-		AtomicInt qSize;
+		bool indexRangeValid;
+		unsigned int indexRangeMin;
+		unsigned int indexRangeMax;
+		std::vector<unsigned int> restartIndices;
+		Vertex *prepassBuffer;          // Post-transform vertices shared by the primitive units
+		unsigned int prepassCapacity;
+		std::atomic<DrawCall*> prepassDraw;   // Draw call using the buffer, at most one at a time
+
+		bool drawCulling;   // Skip indexed draws whose vertex range lies outside the view frustum
+		bool drawMerging;   // Extend the last draw call with the primitives of draws which continue it
+		bool lastDrawMergeable;     // The last issued draw call can still be extended, if it has primitives left to schedule
+		DrawInputs lastDrawInputs;  // Of the last issued draw call
+		VertexProcessor::State cullingState;
+		Routine *cullingRoutine;      // Position-only vertex routine, held bound
+		DrawData *cullingData;        // Constants and streams of the draw call being tested
+		VertexTask *cullingTask;
+		Vertex *cullingVertices;      // PREPASS_CHUNK_SIZE transformed positions
+
+		TaskDeque *taskDeque;   // Per-thread queues of available tasks
 
 		static AtomicInt unitCount;
 		static AtomicInt clusterCount;
+		static AtomicInt rasterTileHeight;   // Rows per band assigned to a pixel cluster, 2 interleaves scanline pairs
+
+		MutexLock schedulerMutex;   // Serializes task discovery and thread suspension
 
-		MutexLock schedulerMutex;
+		std::atomic<bool> profiling;
+		ProfileCallback profileCallback;
+		void *profileUserData;
 
-		#if PERF_HUD
-			int64_t vertexTime[16];
-			int64_t setupTime[16];
-			int64_t pixelTime[16];
-		#endif
+		std::map<int, ShaderProfile> shaderProfiles;   // By shader serial ID
+		MutexLock shaderProfileMutex;
 
-		VertexTask *vertexTask[16];
+		PipelineProfile pipelineProfile;
+		MutexLock pipelineProfileMutex;
+
+		VertexTask **vertexTask;
+		int64_t lastDrawTime;   // Timer::nanoseconds() of the last draw, to free the batches after idling
 
 		SwiftConfig *swiftConfig;
 
 		std::list<Query*> queries;
+
+		struct Timestamp
+		{
+			int64_t sequence;
+			Query *query;
+		};
+
+		MutexLock timestampMutex;
+		std::list<Timestamp> timestamps;   // Waiting for their draw calls to retire
+		std::atomic<int> pendingTimestamps;
 		Resource *sync;
 
+		struct Readback
+		{
+			Surface *source;
+			Rect rect;
+			Resource *buffer;
+			void *dest;
+			Format format;
+			int pitchB;
+			int64_t sequence;
+		};
+
+		Thread *readbackThread;            // Started by the first readback
+		MutexLock readbackMutex;
+		std::list<Readback> readbacks;     // Queued or in progress, in sequence order
+		std::atomic<int> pendingReadbacks;
+		Event *readbackEvent;              // Signaled when readbacks are queued, or to terminate
+		Event *readbackDone;               // Signaled when a readback completes, waited on by the application thread
+		Event *drawRetired;                // Signaled when a draw call retires while readbacks are pending
+		volatile bool terminateReadbacks;
+
 		VertexProcessor::State vertexState;
 		SetupProcessor::State setupState;
 		PixelProcessor::State pixelState;
@@ -461,6 +788,9 @@ namespace sw
 
 		~DrawCall();
 
+		void allocateClusterData(int clusterCount);
+		void freeClusterData();
+
 		AtomicInt drawType;
 		AtomicInt batchSize;
 
@@ -477,29 +807,62 @@ namespace sw
 
 		Resource *vertexStream[MAX_VERTEX_INPUTS];
 		Resource *indexBuffer;
+		std::vector<unsigned int> restartIndices;   // Where strips and fans start over, empty without primitive restart
+		unsigned int restartVertex;                 // Index which primitives containing a restart collapse onto
 		Surface *renderTarget[RENDERTARGETS];
 		Surface *depthBuffer;
 		Surface *stencilBuffer;
 		Resource *texture[TOTAL_IMAGE_UNITS];
+		std::shared_ptr<const Texture> textureData[TOTAL_IMAGE_UNITS];   // Keeps the sampler data referenced by DrawData::mipmap alive
 		Resource* pUniformBuffers[MAX_UNIFORM_BUFFER_BINDINGS];
 		Resource* vUniformBuffers[MAX_UNIFORM_BUFFER_BINDINGS];
 		Resource* transformFeedbackBuffers[MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS];
 
+		unsigned int vsDirtyConstFBegin;   // Float registers [vsDirtyConstFBegin, vsDirtyConstF) changed since the slot's previous draw
 		unsigned int vsDirtyConstF;
 		unsigned int vsDirtyConstI;
 		unsigned int vsDirtyConstB;
 
+		unsigned int psDirtyConstFBegin;
 		unsigned int psDirtyConstF;
 		unsigned int psDirtyConstI;
 		unsigned int psDirtyConstB;
 
 		std::list<Query*> *queries;
+		bool timed;   // Has TIME_ELAPSED queries
+		std::atomic<int64_t> startTime;   // Timer::nanoseconds() when the first task started, 0 before
 
 		AtomicInt clipFlags;
 
+		std::atomic<int64_t> ticks;   // Time spent processing this draw call, for batch size selection
+
+		std::atomic<int64_t> vertexTime;   // Only measured while profiling
+		std::atomic<int64_t> setupTime;
+		std::atomic<int64_t> pixelTime;
+		int profiledShader;   // Serial ID of the pixel shader whose instructions are timed, when data->shaderProfile is set
+
+		Vertex *prepassVertices;    // Transformed vertices of the index range, null when not pre-passed
+		unsigned int prepassFirst;  // Index of prepassVertices[0]
+		unsigned int prepassCount;
+		unsigned int prepassVertexSize;   // Bytes gathered per vertex, up to its last written output
+		int prepassChunks;
+		int prepassIssued;          // Chunks handed out to threads
+		AtomicInt prepassPending;   // Chunks not yet transformed, primitives wait until 0
+
+		AtomicInt vertexLookups;   // Post-transform vertex cache statistics
+		AtomicInt vertexMisses;
+		AtomicInt visiblePrimitives;   // Only counted while profiling
+
 		AtomicInt primitive;    // Current primitive to enter pipeline
-		AtomicInt count;        // Number of primitives to render
+		AtomicInt count;        // Number of primitives to render, of all instances
+
+		int instancePrimitives;   // Primitives per instance, which batches don't straddle
+		unsigned int instanceDivisor[MAX_VERTEX_INPUTS];   // Of instanced streams, 0 otherwise
+		unsigned int instanceStride[MAX_VERTEX_INPUTS];
 		AtomicInt references;   // Remaining references to this draw call, 0 when done drawing, -1 when resources unlocked and slot is free
+		std::atomic<int64_t> sequence;   // Renderer::drawSequence when issued
+		int64_t dependency;   // Sequence of the latest earlier draw call accessing its surfaces, which has to retire before this one starts, 0 when none
+		unsigned int managedTextures;   // Mask of the samplers whose textures are locked for the renderer, as when rendered to
 
 		DrawData *data;
 	};
@@ -16,33 +16,251 @@
 #define sw_RoutineCache_hpp
 
 #include "LRUCache.hpp"
+#include "RoutineStore.hpp"
 
 #include "Reactor/Reactor.hpp"
+#include "Common/MutexLock.hpp"
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <string.h>
 
 namespace sw
 {
-	template<class State>
-	class RoutineCache : public LRUCache<State, Routine>
+	template<class State, class Hash = LRUHash<State>>
+	class RoutineCache : public LRUCache<State, Routine, Hash>
 	{
 	public:
 		RoutineCache(int n, const char *precache = 0);
 		~RoutineCache();
 
+		// Process wide cache, since the settings which affect code generation are global too. A new size or
+		// persistence is applied in place, keeping the routines. Only a change of the settings replaces the
+		// cache, renderers still using the old one keep it alive.
+		static std::shared_ptr<RoutineCache> shared(int n, const char *precache);
+
+		// Thread safe query() and add(), returning routines bound for the caller
+		Routine *acquire(const State &state);
+		Routine *acquire(const State &state, Routine *routine);   // Returns the existing one when another thread was first
+
+		// Tiered compilation. Quickly generated routines are held until enough draws used them to be worth
+		// regenerating with more optimizations, which then replace them.
+		void addQuick(Routine *routine);
+		bool countUse(Routine *routine, int threshold);           // True once, when the threshold is reached
+		Routine *replace(const State &state, Routine *routine);   // Returns it bound
+
+		void resize(int n);
+
+		// Routines of earlier processes. The state can't contain process specific values like shader serial
+		// IDs, so those get replaced by a fingerprint of the shader contents.
+		bool isPersistent() const { return precache != nullptr; }
+		void setPersistence(const char *precache);
+		Routine *load(const State &state, uint64_t shaderFingerprint);
+		void store(const State &state, uint64_t shaderFingerprint, Routine *routine);
+
 	private:
-		const char *precache;
-		#if defined(_WIN32)
-		HMODULE precacheDLL;
-		#endif
+		std::atomic<RoutineStore*> precache;
+		const uint64_t fingerprint;   // Settings the routines are generated with
+
+		std::unordered_map<Routine*, int> quickUses;
+
+		MutexLock mutex;
 	};
 
-	template<class State>
-	RoutineCache<State>::RoutineCache(int n, const char *precache) : LRUCache<State, Routine>(n), precache(precache)
+	template<class State, class Hash>
+	RoutineCache<State, Hash>::RoutineCache(int n, const char *precache) : LRUCache<State, Routine, Hash>(n), fingerprint(RoutineStore::getFingerprint())
+	{
+		this->precache = precache ? new RoutineStore(precache) : nullptr;
+	}
+
+	template<class State, class Hash>
+	RoutineCache<State, Hash>::~RoutineCache()
+	{
+		for(auto &quick : quickUses)
+		{
+			quick.first->unbind();
+		}
+
+		delete precache.load();
+	}
+
+	template<class State, class Hash>
+	std::shared_ptr<RoutineCache<State, Hash>> RoutineCache<State, Hash>::shared(int n, const char *precache)
+	{
+		static MutexLock sharedMutex;
+		static std::weak_ptr<RoutineCache> sharedCache;
+
+		sharedMutex.lock();
+
+		std::shared_ptr<RoutineCache> cache = sharedCache.lock();
+
+		if(!cache || cache->fingerprint != RoutineStore::getFingerprint())
+		{
+			cache = std::make_shared<RoutineCache>(n, precache);
+			sharedCache = cache;
+		}
+		else
+		{
+			cache->resize(n);
+			cache->setPersistence(precache);
+		}
+
+		sharedMutex.unlock();
+
+		return cache;
+	}
+
+	template<class State, class Hash>
+	Routine *RoutineCache<State, Hash>::acquire(const State &state)
+	{
+		mutex.lock();
+
+		Routine *routine = this->query(state);
+
+		if(routine)
+		{
+			routine->bind();
+		}
+
+		mutex.unlock();
+
+		return routine;
+	}
+
+	template<class State, class Hash>
+	Routine *RoutineCache<State, Hash>::acquire(const State &state, Routine *routine)
 	{
+		mutex.lock();
+
+		Routine *existing = this->query(state);
+
+		if(existing)
+		{
+			delete routine;   // Not bound yet
+			routine = existing;
+		}
+		else
+		{
+			this->add(state, routine);
+		}
+
+		routine->bind();
+
+		mutex.unlock();
+
+		return routine;
 	}
 
-	template<class State>
-	RoutineCache<State>::~RoutineCache()
+	template<class State, class Hash>
+	void RoutineCache<State, Hash>::addQuick(Routine *routine)
 	{
+		mutex.lock();
+
+		if(quickUses.size() >= static_cast<size_t>(this->getSize()))   // Mostly routines which are rarely used
+		{
+			for(auto &quick : quickUses)
+			{
+				quick.first->unbind();
+			}
+
+			quickUses.clear();
+		}
+
+		routine->bind();   // Keeps the address unique while it's counted
+		quickUses[routine] = 0;
+
+		mutex.unlock();
+	}
+
+	template<class State, class Hash>
+	bool RoutineCache<State, Hash>::countUse(Routine *routine, int threshold)
+	{
+		mutex.lock();
+
+		bool hot = false;
+		auto quick = quickUses.find(routine);
+
+		if(quick != quickUses.end() && ++quick->second >= threshold)
+		{
+			quick->first->unbind();
+			quickUses.erase(quick);
+			hot = true;
+		}
+
+		mutex.unlock();
+
+		return hot;
+	}
+
+	template<class State, class Hash>
+	Routine *RoutineCache<State, Hash>::replace(const State &state, Routine *routine)
+	{
+		mutex.lock();
+
+		this->LRUCache<State, Routine, Hash>::replace(state, routine);
+		routine->bind();
+
+		mutex.unlock();
+
+		return routine;
+	}
+
+	template<class State, class Hash>
+	void RoutineCache<State, Hash>::resize(int n)
+	{
+		mutex.lock();
+		this->LRUCache<State, Routine, Hash>::resize(n);
+		mutex.unlock();
+	}
+
+	template<class State, class Hash>
+	void RoutineCache<State, Hash>::setPersistence(const char *precache)
+	{
+		mutex.lock();
+
+		if(!precache)
+		{
+			delete this->precache.load();
+			this->precache = nullptr;
+		}
+		else if(!this->precache)
+		{
+			this->precache = new RoutineStore(precache);
+		}
+
+		mutex.unlock();
+	}
+
+	template<class State, class Hash>
+	Routine *RoutineCache<State, Hash>::load(const State &state, uint64_t shaderFingerprint)
+	{
+		unsigned char key[sizeof(State) + sizeof(uint64_t)];
+		memcpy(key, &state, sizeof(State));
+		memcpy(key + sizeof(State), &shaderFingerprint, sizeof(uint64_t));
+
+		mutex.lock();
+		Routine *routine = precache ? precache.load()->load(key, sizeof(key)) : nullptr;   // Persistence may have been turned off since the caller checked
+		mutex.unlock();
+
+		return routine;
+	}
+
+	template<class State, class Hash>
+	void RoutineCache<State, Hash>::store(const State &state, uint64_t shaderFingerprint, Routine *routine)
+	{
+		unsigned char key[sizeof(State) + sizeof(uint64_t)];
+		memcpy(key, &state, sizeof(State));
+		memcpy(key + sizeof(State), &shaderFingerprint, sizeof(uint64_t));
+
+		mutex.lock();
+
+		if(precache)
+		{
+			precache.load()->store(key, sizeof(key), routine);
+		}
+
+		mutex.unlock();
 	}
 }
 
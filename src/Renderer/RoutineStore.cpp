@@ -0,0 +1,398 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "RoutineStore.hpp"
+
+#include "Common/Math.hpp"
+#include "Common/Debug.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+	#include <process.h>
+	#define getpid _getpid
+#else
+	#include <dlfcn.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace sw
+{
+	enum
+	{
+		MAGIC = 0x52485753,   // "SWHR"
+		VERSION = 2,
+		MAX_FILE_SIZE = 64 << 20,
+		MAX_PENDING = 4096,
+		CODE_ALIGNMENT = 64,   // At least the alignment of the constants LLVM places in the code
+	};
+
+	uint64_t RoutineStore::settingsFingerprint = 0;
+
+	// Identifies the library file, so rebuilding it invalidates the stored code
+	static uint64_t moduleFingerprint()
+	{
+		uint64_t data[3] = {};
+
+		#if defined(_WIN32)
+			HMODULE module = nullptr;
+			char path[MAX_PATH];
+			WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+			if(GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)&moduleFingerprint, &module) &&
+			   GetModuleFileNameA(module, path, MAX_PATH) && GetFileAttributesExA(path, GetFileExInfoStandard, &attributes))
+			{
+				data[0] = (uint64_t)attributes.nFileSizeHigh << 32 | attributes.nFileSizeLow;
+				data[1] = (uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32 | attributes.ftLastWriteTime.dwLowDateTime;
+			}
+		#else
+			Dl_info info;
+			struct stat status;
+
+			if(dladdr((void*)&moduleFingerprint, &info) && info.dli_fname && stat(info.dli_fname, &status) == 0)
+			{
+				data[0] = status.st_size;
+				data[1] = status.st_mtime;
+				data[2] = status.st_ino;
+			}
+		#endif
+
+		if(!data[0])   // Fall back to when this file was compiled
+		{
+			const char *date = __DATE__ " " __TIME__;
+			data[0] = FNV_1a(reinterpret_cast<const unsigned char*>(date), static_cast<int>(strlen(date)));
+		}
+
+		return FNV_1a(reinterpret_cast<const unsigned char*>(data), sizeof(data));
+	}
+
+	RoutineStore::RoutineStore(const char *name) : fileName(std::string(name) + ".cache")
+	{
+		opened = false;
+
+		mapping = nullptr;
+		mappingSize = 0;
+		entriesEnd = 0;
+		executable = false;
+	}
+
+	RoutineStore::~RoutineStore()
+	{
+		if(!pending.empty())
+		{
+			write();
+		}
+
+		for(Pending &entry : pending)
+		{
+			entry.routine->unbind();
+		}
+
+		close();
+	}
+
+	Routine *RoutineStore::load(const void *key, size_t keySize)
+	{
+		if(!opened)
+		{
+			open();
+		}
+
+		uint64_t hash = FNV_1a(static_cast<const unsigned char*>(key), static_cast<int>(keySize));
+		auto range = index.equal_range(hash);
+
+		for(auto i = range.first; i != range.second; i++)
+		{
+			const Entry *entry = i->second;
+			const unsigned char *entryKey = reinterpret_cast<const unsigned char*>(entry + 1);
+
+			if(entry->keySize == keySize && memcmp(entryKey, key, keySize) == 0)
+			{
+				const unsigned char *data = reinterpret_cast<const unsigned char*>(entry) + entry->dataOffset;
+
+				return executable ? Routine::deserialize(data, entry->dataSize, image) : Routine::deserialize(data, entry->dataSize);
+			}
+		}
+
+		return nullptr;
+	}
+
+	void RoutineStore::store(const void *key, size_t keySize, Routine *routine)
+	{
+		if(!opened)
+		{
+			open();
+		}
+
+		if(pending.size() >= MAX_PENDING)
+		{
+			return;
+		}
+
+		const unsigned char *bytes = static_cast<const unsigned char*>(key);
+		Pending entry = {std::vector<unsigned char>(bytes, bytes + keySize), routine};
+		pending.push_back(entry);
+
+		routine->bind();   // Serialized when the store is written out
+	}
+
+	void RoutineStore::setFingerprint(uint64_t fingerprint)
+	{
+		settingsFingerprint = fingerprint;
+	}
+
+	uint64_t RoutineStore::getFingerprint()
+	{
+		return settingsFingerprint;
+	}
+
+	uint64_t RoutineStore::getModuleFingerprint()
+	{
+		static const uint64_t module = moduleFingerprint();
+
+		return module;
+	}
+
+	uint64_t RoutineStore::fileFingerprint()
+	{
+		uint64_t data[2] = {settingsFingerprint, getModuleFingerprint()};
+
+		return FNV_1a(reinterpret_cast<const unsigned char*>(data), sizeof(data));
+	}
+
+	uint64_t RoutineStore::imageAddress() const
+	{
+		if(sizeof(void*) < sizeof(uint64_t))
+		{
+			return 0;
+		}
+
+		// One of 64K slots of the maximum file size, starting at 16 TB
+		uint64_t data[2] = {FNV_1a(reinterpret_cast<const unsigned char*>(fileName.c_str()), static_cast<int>(fileName.size())), fileFingerprint()};
+		uint64_t slot = FNV_1a(reinterpret_cast<const unsigned char*>(data), sizeof(data)) % 0x10000;
+
+		return 0x100000000000ull + slot * MAX_FILE_SIZE;
+	}
+
+	size_t RoutineStore::entrySize(size_t dataOffset, size_t dataSize)
+	{
+		return (dataOffset + dataSize + 7) & ~(size_t)7;
+	}
+
+	void RoutineStore::open()
+	{
+		opened = true;
+
+		#if defined(_WIN32)
+			HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+			if(file == INVALID_HANDLE_VALUE)
+			{
+				return;
+			}
+
+			LARGE_INTEGER size;
+			HANDLE fileMapping = nullptr;
+			const void *view = nullptr;
+
+			if(GetFileSizeEx(file, &size) && size.QuadPart >= (LONGLONG)sizeof(Header) && size.QuadPart <= MAX_FILE_SIZE)
+			{
+				fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				view = fileMapping ? MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			}
+
+			if(!view)
+			{
+				if(fileMapping) CloseHandle(fileMapping);
+				CloseHandle(file);
+				return;
+			}
+
+			image = std::shared_ptr<const void>(view, [file, fileMapping](const void *pointer)
+			{
+				UnmapViewOfFile(pointer);
+				CloseHandle(fileMapping);
+				CloseHandle(file);
+			});
+
+			mapping = static_cast<const unsigned char*>(view);
+			mappingSize = static_cast<size_t>(size.QuadPart);
+		#else
+			int file = ::open(fileName.c_str(), O_RDONLY);
+
+			if(file == -1)
+			{
+				return;
+			}
+
+			struct stat status;
+			void *view = MAP_FAILED;
+
+			if(fstat(file, &status) == 0 && status.st_size >= (off_t)sizeof(Header) && status.st_size <= MAX_FILE_SIZE)
+			{
+				void *address = reinterpret_cast<void*>(static_cast<uintptr_t>(imageAddress()));
+				view = mmap(address, status.st_size, PROT_READ | PROT_EXEC, MAP_PRIVATE, file, 0);
+
+				if(view == MAP_FAILED)   // File systems mounted without execute permission
+				{
+					view = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+				}
+				else
+				{
+					executable = (view == address);
+				}
+			}
+
+			::close(file);   // The mapping keeps the file referenced
+
+			if(view == MAP_FAILED)
+			{
+				return;
+			}
+
+			size_t size = static_cast<size_t>(status.st_size);
+			image = std::shared_ptr<const void>(view, [size](const void *pointer)
+			{
+				munmap(const_cast<void*>(pointer), size);
+			});
+
+			mapping = static_cast<const unsigned char*>(view);
+			mappingSize = size;
+		#endif
+
+		const Header *header = reinterpret_cast<const Header*>(mapping);
+
+		if(header->magic != MAGIC || header->version != VERSION || header->fingerprint != fileFingerprint())
+		{
+			return;   // Written by another build, CPU or configuration. Gets replaced by this process' routines.
+		}
+
+		size_t offset = sizeof(Header);
+
+		while(offset + sizeof(Entry) <= mappingSize)
+		{
+			const Entry *entry = reinterpret_cast<const Entry*>(mapping + offset);
+			size_t size = entrySize(entry->dataOffset, entry->dataSize);
+
+			if(size > mappingSize - offset || entry->dataOffset < sizeof(Entry) + (size_t)entry->keySize)
+			{
+				break;   // Truncated or corrupt
+			}
+
+			index.insert(std::make_pair(entry->hash, entry));
+			offset += size;
+		}
+
+		entriesEnd = offset;
+	}
+
+	void RoutineStore::close()
+	{
+		index.clear();
+
+		image.reset();   // Unmapped once no routine executes from it
+		mapping = nullptr;
+		mappingSize = 0;
+		entriesEnd = 0;
+		executable = false;
+	}
+
+	void RoutineStore::write()
+	{
+		std::vector<unsigned char> file(sizeof(Header));
+		Header header = {MAGIC, VERSION, fileFingerprint()};
+		memcpy(&file[0], &header, sizeof(Header));
+
+		if(!index.empty())   // Keep the routines of earlier processes, at the offsets they're relocated for
+		{
+			file.insert(file.end(), mapping + sizeof(Header), mapping + entriesEnd);
+		}
+
+		std::vector<unsigned char> data;
+		uint64_t address = imageAddress();
+
+		for(Pending &entry : pending)
+		{
+			if(!entry.routine->serialize(data))
+			{
+				continue;
+			}
+
+			size_t offset = file.size();
+			size_t codeOffset = Routine::codeOffset(data.data(), data.size());
+			size_t dataOffset = sizeof(Entry) + entry.key.size();
+			dataOffset += (CODE_ALIGNMENT - (offset + dataOffset + codeOffset) % CODE_ALIGNMENT) % CODE_ALIGNMENT;
+			size_t size = entrySize(dataOffset, data.size());
+
+			if(codeOffset == 0)
+			{
+				continue;
+			}
+
+			if(offset + size > MAX_FILE_SIZE)
+			{
+				break;
+			}
+
+			Routine::relocate(data, address + offset + dataOffset + codeOffset);
+
+			Entry entryHeader = {};
+			entryHeader.hash = FNV_1a(&entry.key[0], static_cast<int>(entry.key.size()));
+			entryHeader.keySize = static_cast<uint32_t>(entry.key.size());
+			entryHeader.dataSize = static_cast<uint32_t>(data.size());
+			entryHeader.dataOffset = static_cast<uint32_t>(dataOffset);
+
+			file.resize(offset + size, 0);
+			memcpy(&file[offset], &entryHeader, sizeof(Entry));
+			memcpy(&file[offset + sizeof(Entry)], &entry.key[0], entry.key.size());
+			memcpy(&file[offset + dataOffset], &data[0], data.size());
+		}
+
+		close();   // Windows can't replace a mapped file
+
+		// Other processes only ever see complete files
+		char suffix[32];
+		sprintf(suffix, ".%d.tmp", static_cast<int>(getpid()));
+		std::string temporary = fileName + suffix;
+
+		FILE *output = fopen(temporary.c_str(), "wb");
+
+		if(!output)
+		{
+			return;
+		}
+
+		bool written = fwrite(&file[0], 1, file.size(), output) == file.size();
+		written = (fclose(output) == 0) && written;
+
+		#if defined(_WIN32)
+			bool replaced = written && MoveFileExA(temporary.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING);
+		#else
+			bool replaced = written && rename(temporary.c_str(), fileName.c_str()) == 0;
+		#endif
+
+		if(!replaced)
+		{
+			remove(temporary.c_str());
+		}
+	}
+}
@@ -0,0 +1,94 @@
+// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_RoutineStore_hpp
+#define sw_RoutineStore_hpp
+
+#include "Reactor/Routine.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+namespace sw
+{
+	// Memory mapped file of routines generated by earlier processes. The routines added by this
+	// process are written out together with the existing ones when the store is destroyed. Their
+	// code is relocated for mapping the file at an address derived from its name and fingerprint,
+	// so processes which get that address execute it in place and share its pages.
+	class RoutineStore
+	{
+	public:
+		explicit RoutineStore(const char *name);
+
+		~RoutineStore();
+
+		Routine *load(const void *key, size_t keySize);   // Returns null when not stored
+		void store(const void *key, size_t keySize, Routine *routine);
+
+		// Everything besides the keys which affects code generation: CPU, build and settings
+		static void setFingerprint(uint64_t fingerprint);
+		static uint64_t getFingerprint();
+		static uint64_t getModuleFingerprint();   // Identifies the library build
+
+	private:
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint64_t fingerprint;
+		};
+
+		struct Entry   // Followed by the key and the serialized routine, padded to 8 bytes
+		{
+			uint64_t hash;
+			uint32_t keySize;
+			uint32_t dataSize;
+			uint32_t dataOffset;   // From the start of the entry, aligning the routine's code
+			uint32_t reserved;
+		};
+
+		struct Pending
+		{
+			std::vector<unsigned char> key;
+			Routine *routine;
+		};
+
+		static size_t entrySize(size_t dataOffset, size_t dataSize);
+		static uint64_t fileFingerprint();   // Combined with the library build
+		uint64_t imageAddress() const;       // Which the stored code is relocated for
+
+		void open();
+		void close();
+		void write();
+
+		const std::string fileName;
+		bool opened;
+
+		std::shared_ptr<const void> image;   // Also referenced by the routines executing in place
+		const unsigned char *mapping;
+		size_t mappingSize;
+		size_t entriesEnd;     // Valid entries of the mapped file
+		bool executable;       // Mapped at the image address with execute access
+
+		std::unordered_multimap<uint64_t, const Entry*> index;
+		std::vector<Pending> pending;
+
+		static uint64_t settingsFingerprint;
+	};
+}
+
+#endif   // sw_RoutineStore_hpp
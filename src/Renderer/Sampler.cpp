@@ -17,6 +17,7 @@
 #include "Context.hpp"
 #include "Surface.hpp"
 #include "Shader/PixelRoutine.hpp"
+#include "Common/Memory.hpp"
 #include "Common/Debug.hpp"
 
 #include <memory.h>
@@ -26,6 +27,8 @@ namespace sw
 {
 	FilterType Sampler::maximumTextureFilterQuality = FILTER_LINEAR;
 	MipmapType Sampler::maximumMipmapFilterQuality = MIPMAP_POINT;
+	float Sampler::maximumAnisotropyQuality = 16.0f;
+	bool Sampler::approximateAnisotropyQuality = false;
 
 	Sampler::State::State()
 	{
@@ -42,6 +45,7 @@ namespace sw
 			Mipmap &mipmap = texture.mipmap[level];
 
 			memset(&mipmap, 0, sizeof(Mipmap));
+			tiledLevel[level] = false;
 
 			for(int face = 0; face < 6; face++)
 			{
@@ -103,10 +107,13 @@ namespace sw
 			state.swizzleA = swizzleA;
 			state.highPrecisionFiltering = highPrecisionFiltering;
 			state.compare = getCompareFunc();
+			state.approximateAnisotropy = (state.textureFilter == FILTER_ANISOTROPIC) && approximateAnisotropyQuality;
+			state.tiledTexture = true;
 
-			#if PERF_PROFILE
-				state.compressedFormat = Surface::isCompressed(externalTextureFormat);
-			#endif
+			for(int level = 0; level < MIPMAP_LEVELS; level++)
+			{
+				state.tiledTexture = state.tiledTexture && tiledLevel[level];
+			}
 		}
 
 		return state;
@@ -132,6 +139,16 @@ namespace sw
 				int pitchP = surface->getInternalPitchP();
 				int sliceP = surface->getInternalSliceP();
 
+				void *tiledBuffer = (type == TEXTURE_2D || type == TEXTURE_RECTANGLE) ? surface->getTiledBuffer(mipmap.buffer[face]) : nullptr;
+				tiledLevel[level] = tiledBuffer != nullptr;
+
+				if(tiledBuffer)
+				{
+					mipmap.buffer[face] = tiledBuffer;
+					pitchP = surface->getTiledPitchP();
+					sliceP = surface->getTiledSliceP();
+				}
+
 				if(level == 0)
 				{
 					texture.widthHeightLOD[0] = width * exp2LOD;
@@ -226,13 +243,10 @@ namespace sw
 				   internalTextureFormat == FORMAT_YV12_BT709 ||
 				   internalTextureFormat == FORMAT_YV12_JFIF)
 				{
-					unsigned int YStride = pitchP;
-					unsigned int YSize = YStride * height;
-					unsigned int CStride = align<16>(YStride / 2);
-					unsigned int CSize = CStride * height / 2;
+					Surface::ChromaPlanes chroma = surface->getChromaPlanes();
 
-					mipmap.buffer[1] = (byte*)mipmap.buffer[0] + YSize;
-					mipmap.buffer[2] = (byte*)mipmap.buffer[1] + CSize;
+					mipmap.buffer[1] = (byte*)mipmap.buffer[0] + chroma.offsetCr;
+					mipmap.buffer[2] = (byte*)mipmap.buffer[0] + chroma.offsetCb;
 
 					texture.mipmap[1].width[0] = width / 2;
 					texture.mipmap[1].width[1] = width / 2;
@@ -242,10 +256,10 @@ namespace sw
 					texture.mipmap[1].height[1] = height / 2;
 					texture.mipmap[1].height[2] = height / 2;
 					texture.mipmap[1].height[3] = height / 2;
-					texture.mipmap[1].onePitchP[0] = 1;
-					texture.mipmap[1].onePitchP[1] = CStride;
-					texture.mipmap[1].onePitchP[2] = 1;
-					texture.mipmap[1].onePitchP[3] = CStride;
+					texture.mipmap[1].onePitchP[0] = chroma.stepB;
+					texture.mipmap[1].onePitchP[1] = chroma.pitchB;
+					texture.mipmap[1].onePitchP[2] = chroma.stepB;
+					texture.mipmap[1].onePitchP[3] = chroma.pitchB;
 				}
 			}
 		}
@@ -255,12 +269,12 @@ namespace sw
 
 	void Sampler::setTextureFilter(FilterType textureFilter)
 	{
-		this->textureFilter = (FilterType)min(textureFilter, maximumTextureFilterQuality);
+		this->textureFilter = textureFilter;   // Limited to the configured quality when the draw state is generated
 	}
 
 	void Sampler::setMipmapFilter(MipmapType mipmapFilter)
 	{
-		mipmapFilterState = (MipmapType)min(mipmapFilter, maximumMipmapFilterQuality);
+		mipmapFilterState = mipmapFilter;
 	}
 
 	void Sampler::setGatherEnable(bool enable)
@@ -309,7 +323,7 @@ namespace sw
 
 	void Sampler::setMaxAnisotropy(float maxAnisotropy)
 	{
-		texture.maxAnisotropy = maxAnisotropy;
+		texture.maxAnisotropy = min(maxAnisotropy, maximumAnisotropyQuality);
 	}
 
 	void Sampler::setHighPrecisionFiltering(bool highPrecisionFiltering)
@@ -372,6 +386,12 @@ namespace sw
 		Sampler::maximumMipmapFilterQuality = maximumFilterQuality;
 	}
 
+	void Sampler::setAnisotropyQuality(float maximumAnisotropy, bool approximate)
+	{
+		Sampler::maximumAnisotropyQuality = maximumAnisotropy;
+		Sampler::approximateAnisotropyQuality = approximate;
+	}
+
 	void Sampler::setMipmapLOD(float LOD)
 	{
 		texture.LOD = LOD;
@@ -401,6 +421,11 @@ namespace sw
 		return textureType == TEXTURE_3D || textureType == TEXTURE_2D_ARRAY;
 	}
 
+	bool Sampler::hasCompressedTexture() const
+	{
+		return textureType != TEXTURE_NULL && Surface::isCompressed(externalTextureFormat);
+	}
+
 	void Sampler::setSyncRequired(bool isSyncRequired)
 	{
 		syncRequired = isSyncRequired;
@@ -411,9 +436,18 @@ namespace sw
 		return syncRequired;
 	}
 
-	const Texture &Sampler::getTextureData()
+	std::shared_ptr<const Texture> Sampler::getTextureData()
 	{
-		return texture;
+		// The front-ends set the sampler state again for every draw, so compare the data itself to find changes
+		if(!textureData || memcmp(textureData.get(), &texture, sizeof(Texture)) != 0)
+		{
+			Texture *copy = (Texture*)allocate(sizeof(Texture));
+			memcpy(copy, &texture, sizeof(Texture));
+
+			textureData = std::shared_ptr<const Texture>(copy, [](const Texture *data) { deallocate(const_cast<Texture*>(data)); });
+		}
+
+		return textureData;
 	}
 
 	MipmapType Sampler::mipmapFilter() const
@@ -424,7 +458,7 @@ namespace sw
 			{
 				if(texture.mipmap[0].buffer[0] != texture.mipmap[i].buffer[0])
 				{
-					return mipmapFilterState;
+					return (MipmapType)min(mipmapFilterState, maximumMipmapFilterQuality);
 				}
 			}
 		}
@@ -449,7 +483,7 @@ namespace sw
 			}
 		}
 
-		FilterType filter = textureFilter;
+		FilterType filter = (FilterType)min(textureFilter, maximumTextureFilterQuality);
 
 		if(gather && Surface::componentCount(internalTextureFormat) == 1)
 		{
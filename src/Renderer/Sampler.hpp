@@ -19,6 +19,8 @@
 #include "Renderer/Surface.hpp"
 #include "Common/Types.hpp"
 
+#include <memory>
+
 namespace sw
 {
 	struct Mipmap
@@ -160,10 +162,9 @@ namespace sw
 			SwizzleType swizzleA           : BITS(SWIZZLE_LAST);
 			bool highPrecisionFiltering    : 1;
 			CompareFunc compare            : BITS(COMPARE_LAST);
-
-			#if PERF_PROFILE
-			bool compressedFormat          : 1;
-			#endif
+			bool tiledTexture              : 1;   // Every level is stored in 4x4 texel tiles
+			bool approximateAnisotropy     : 1;   // Half as many taps, each covering twice the footprint
+			bool compressedFormat          : 1;   // Only set for profiled pixel routines, which count the samples of compressed textures
 		};
 
 		Sampler();
@@ -197,15 +198,17 @@ namespace sw
 
 		static void setFilterQuality(FilterType maximumFilterQuality);
 		static void setMipmapQuality(MipmapType maximumFilterQuality);
+		static void setAnisotropyQuality(float maximumAnisotropy, bool approximate);
 		void setMipmapLOD(float lod);
 
 		bool hasTexture() const;
 		bool hasUnsignedTexture() const;
 		bool hasCubeTexture() const;
 		bool hasVolumeTexture() const;
+		bool hasCompressedTexture() const;
 		bool requiresSync() const;
 
-		const Texture &getTextureData();
+		std::shared_ptr<const Texture> getTextureData();   // Immutable copy of the texture data, only replaced when the data changes
 
 	private:
 		MipmapType mipmapFilter() const;
@@ -230,6 +233,7 @@ namespace sw
 		bool highPrecisionFiltering;
 		bool syncRequired;
 		int border;
+		bool tiledLevel[MIPMAP_LEVELS];
 
 		SwizzleType swizzleR;
 		SwizzleType swizzleG;
@@ -238,10 +242,13 @@ namespace sw
 		CompareFunc compare;
 
 		Texture texture;
+		std::shared_ptr<const Texture> textureData;
 		float exp2LOD;
 
 		static FilterType maximumTextureFilterQuality;
 		static MipmapType maximumMipmapFilterQuality;
+		static float maximumAnisotropyQuality;
+		static bool approximateAnisotropyQuality;
 	};
 }
 
@@ -59,14 +59,10 @@ namespace sw
 
 	SetupProcessor::SetupProcessor(Context *context) : context(context)
 	{
-		routineCache = 0;
-		setRoutineCacheSize(1024);
 	}
 
 	SetupProcessor::~SetupProcessor()
 	{
-		delete routineCache;
-		routineCache = 0;
 	}
 
 	SetupProcessor::State SetupProcessor::update() const
@@ -79,9 +75,12 @@ namespace sw
 		state.isDrawLine = context->isDrawLine(true);
 		state.isDrawTriangle = context->isDrawTriangle(false);
 		state.isDrawSolidTriangle = context->isDrawTriangle(true);
-		state.interpolateZ = context->depthBufferActive() || context->pixelFogActive() != FOG_NONE || vPosZW;
-		state.interpolateW = context->perspectiveActive() || vPosZW;
-		state.perspective = context->perspectiveActive();
+		// Must match the PixelProcessor state, which drops fog and perspective for depth and stencil only quads
+		const bool colorUsed = context->colorUsed();
+
+		state.interpolateZ = context->depthBufferActive() || (colorUsed && context->pixelFogActive() != FOG_NONE) || vPosZW;
+		state.interpolateW = (colorUsed && context->perspectiveActive()) || vPosZW;
+		state.perspective = colorUsed && context->perspectiveActive();
 		state.pointSprite = context->pointSpriteActive();
 		state.cullMode = context->cullMode;
 		state.twoSidedStencil = context->stencilActive() && context->twoSidedStencil;
@@ -122,7 +121,11 @@ namespace sw
 		const bool sprite = context->pointSpriteActive();
 		const bool flatShading = (context->shadingMode == SHADING_FLAT) || point;
 
-		if(context->vertexShader && context->pixelShader)
+		if(!context->colorUsed())
+		{
+			// The pixel shader doesn't run, only depth and stencil are written
+		}
+		else if(context->vertexShader && context->pixelShader)
 		{
 			for(int interpolant = 0; interpolant < MAX_FRAGMENT_INPUTS; interpolant++)
 			{
@@ -223,26 +226,91 @@ namespace sw
 		return state;
 	}
 
-	Routine *SetupProcessor::routine(const State &state)
+	Routine *SetupProcessor::routine(const State &state, OptimizationLevel level)
+	{
+		Routine *routine = routineCache->acquire(state);
+		RoutineTelemetry::recordCacheQuery("SetupRoutine", routine != nullptr);
+
+		if(routine)
+		{
+			return routine;
+		}
+
+		State key;
+
+		if(routineCache->isPersistent())
+		{
+			key = state;
+			key.hash = 0;
+
+			routine = routineCache->load(key, 0);
+
+			if(routine)
+			{
+				return routineCache->acquire(state, routine);
+			}
+		}
+
+		routine = generate(state, level);
+
+		Routine *cached = routineCache->acquire(state, routine);
+
+		if(cached == routine)
+		{
+			if(level == OptimizationQuick)
+			{
+				routineCache->addQuick(routine);   // Not stored, the optimized one replaces it
+			}
+			else
+			{
+				routineCache->store(key, 0, routine);
+			}
+		}
+
+		return cached;
+	}
+
+	Routine *SetupProcessor::cachedRoutine(const State &state)
+	{
+		return routineCache->acquire(state);
+	}
+
+	bool SetupProcessor::isHot(Routine *routine, int threshold)
 	{
-		Routine *routine = routineCache->query(state);
+		return routineCache->countUse(routine, threshold);
+	}
+
+	Routine *SetupProcessor::optimizedRoutine(const State &state)
+	{
+		Routine *routine = routineCache->replace(state, generate(state, OptimizationHot));
 
-		if(!routine)
+		if(routineCache->isPersistent())
 		{
-			SetupRoutine *generator = new SetupRoutine(state);
-			generator->generate();
-			routine = generator->getRoutine();
-			delete generator;
+			State key = state;
+			key.hash = 0;
 
-			routineCache->add(state, routine);
+			routineCache->store(key, 0, routine);
 		}
 
 		return routine;
 	}
 
+	Routine *SetupProcessor::generate(const State &state, OptimizationLevel level)
+	{
+		Nucleus::setOptimizationLevel(level);
+
+		SetupRoutine *generator = new SetupRoutine(state);
+		generator->generate();
+		Routine *routine = generator->getRoutine();
+		delete generator;
+
+		Nucleus::setOptimizationLevel(OptimizationDefault);
+
+		return routine;
+	}
+
 	void SetupProcessor::setRoutineCacheSize(int cacheSize)
 	{
-		delete routineCache;
-		routineCache = new RoutineCache<State>(clamp(cacheSize, 1, 65536), precacheSetup ? "sw-setup" : 0);
+		routineCache = RoutineCache<State, State::Hash>::shared(clamp(cacheSize, 1, 65536), precacheSetup ? "sw-setup" : 0);
 	}
 }
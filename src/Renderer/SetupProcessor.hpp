@@ -81,6 +81,11 @@ namespace sw
 			bool operator==(const State &states) const;
 
 			unsigned int hash;
+
+			struct Hash   // Computed when the state is set up
+			{
+				unsigned int operator()(const State &state) const { return state.hash; }
+			};
 		};
 
 		typedef bool (*RoutinePointer)(Primitive *primitive, const Triangle *triangle, const Polygon *polygon, const DrawData *draw);
@@ -91,14 +96,19 @@ namespace sw
 
 	protected:
 		State update() const;
-		Routine *routine(const State &state);
+		Routine *routine(const State &state, OptimizationLevel level = OptimizationDefault);   // Bound, has to be unbound by the caller
+		Routine *cachedRoutine(const State &state);      // Null when the routine still has to be generated
+		bool isHot(Routine *routine, int threshold);     // Counts a draw using a routine generated with OptimizationQuick
+		Routine *optimizedRoutine(const State &state);   // Regenerates a hot routine, replacing the cached one
 
 		void setRoutineCacheSize(int cacheSize);
 
 	private:
+		Routine *generate(const State &state, OptimizationLevel level);
+
 		Context *const context;
 
-		RoutineCache<State> *routineCache;
+		std::shared_ptr<RoutineCache<State, State::Hash>> routineCache;   // Shared by all renderers, set by the renderer's configuration
 	};
 }
 
@@ -56,6 +56,7 @@ namespace sw
 			this->resource = resource;
 			this->buffer = buffer;
 			this->stride = stride;
+			this->divisor = 0;
 		}
 
 		Stream &define(StreamType type, unsigned int count, bool normalized = false)
@@ -87,6 +88,7 @@ namespace sw
 			type = STREAMTYPE_FLOAT;
 			count = 0;
 			normalized = false;
+			divisor = 0;
 
 			return *this;
 		}
@@ -99,6 +101,7 @@ namespace sw
 		StreamType type;
 		unsigned char count;
 		bool normalized;
+		unsigned int divisor;   // Instances sharing each element, with stride between elements instead of vertices. 0 for per-vertex data.
 	};
 }
 
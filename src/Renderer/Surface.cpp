@@ -16,6 +16,7 @@
 
 #include "Color.hpp"
 #include "Context.hpp"
+#include "ASTC_Decoder.hpp"
 #include "ETC_Decoder.hpp"
 #include "Renderer.hpp"
 #include "Common/Half.hpp"
@@ -23,8 +24,13 @@
 #include "Common/CPUID.hpp"
 #include "Common/Resource.hpp"
 #include "Common/Debug.hpp"
+#include "Common/Thread.hpp"
 #include "Reactor/Reactor.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 #if defined(__i386__) || defined(__x86_64__)
 	#include <xmmintrin.h>
 	#include <emmintrin.h>
@@ -37,11 +43,21 @@ namespace sw
 {
 	extern bool quadLayoutEnabled;
 	extern bool complementaryDepthBuffer;
+	extern bool deferredClears;
+	extern bool tiledTextures;
 	extern TranscendentalPrecision logPrecision;
 
 	unsigned int *Surface::palette = 0;
 	unsigned int Surface::paletteID = 0;
 
+	namespace
+	{
+		std::atomic<unsigned int> residencyClock(0);
+		std::atomic<size_t> textureMemoryBudget(0);
+		std::atomic<size_t> textureMemoryUsage(0);
+		std::atomic<size_t> residentBytes[FORMAT_LAST + 1] = {};
+	}
+
 	void Surface::Buffer::write(int x, int y, int z, const Color<float> &color)
 	{
 		ASSERT((x >= -border) && (x < (width + border)));
@@ -1137,12 +1153,30 @@ namespace sw
 		case LOCK_WRITEONLY:
 		case LOCK_READWRITE:
 		case LOCK_DISCARD:
-			dirty = true;
+			markDirty(0, 0, 0, width, height, depth);
 			break;
 		default:
 			ASSERT(false);
 		}
 
+		return address(x, y, z);
+	}
+
+	void *Surface::Buffer::lockRect(int x, int y, int z, int width, int height, int depth, Lock lock)
+	{
+		if(lock != LOCK_WRITEONLY && lock != LOCK_READWRITE)
+		{
+			return lockRect(x, y, z, lock);
+		}
+
+		this->lock = lock;
+		markDirty(x, y, z, x + width, y + height, z + depth);
+
+		return address(x, y, z);
+	}
+
+	void *Surface::Buffer::address(int x, int y, int z) const
+	{
 		if(buffer)
 		{
 			x += border;
@@ -1223,6 +1257,26 @@ namespace sw
 		lock = LOCK_UNLOCKED;
 	}
 
+	void Surface::Buffer::markDirty(int x0, int y0, int z0, int x1, int y1, int z1)
+	{
+		Rect rect(x0, y0, x1, y1);
+		rect.clip(0, 0, width, height);
+		z0 = clamp(z0, 0, depth);
+		z1 = clamp(z1, 0, depth);
+
+		if(dirty)   // The sibling is still missing the earlier writes
+		{
+			rect = Rect(min(rect.x0, dirtyRect.x0), min(rect.y0, dirtyRect.y0), max(rect.x1, dirtyRect.x1), max(rect.y1, dirtyRect.y1));
+			z0 = min(z0, dirtyFront);
+			z1 = max(z1, dirtyBack);
+		}
+
+		dirty = true;
+		dirtyRect = rect;
+		dirtyFront = z0;
+		dirtyBack = z1;
+	}
+
 	class SurfaceImplementation : public Surface
 	{
 	public:
@@ -1258,6 +1312,7 @@ namespace sw
 		resource = new Resource(0);
 		hasParent = false;
 		ownExternal = false;
+		internalStorage = nullptr;
 		depth = max(1, depth);
 
 		external.buffer = pixels;
@@ -1273,7 +1328,8 @@ namespace sw
 		external.sliceP = external.bytes ? slice / external.bytes : 0;
 		external.border = 0;
 		external.lock = LOCK_UNLOCKED;
-		external.dirty = true;
+		external.dirty = false;
+		external.markDirty(0, 0, 0, width, height, depth);
 
 		internal.buffer = nullptr;
 		internal.width = width;
@@ -1306,7 +1362,18 @@ namespace sw
 		stencil.dirty = false;
 
 		dirtyContents = true;
+		hierarchicalDepth = nullptr;
+		clearTiles = nullptr;
+		clearPattern = 0;
+		pendingClears = false;
+		sampleTiles = nullptr;
+		sampleTilesStale = false;
+		tiledBuffer = nullptr;
+		tiledDirty = true;
+		renderedTo = false;
 		paletteUsed = 0;
+		lastUse = 0;
+		resident = false;
 	}
 
 	Surface::Surface(Resource *texture, int width, int height, int depth, int border, int samples, Format format, bool lockable, bool renderTarget, int pitchPprovided) : lockable(lockable), renderTarget(renderTarget)
@@ -1314,6 +1381,7 @@ namespace sw
 		resource = texture ? texture : new Resource(0);
 		hasParent = texture != nullptr;
 		ownExternal = true;
+		internalStorage = nullptr;
 		depth = max(1, depth);
 		samples = max(1, samples);
 
@@ -1363,7 +1431,18 @@ namespace sw
 		stencil.dirty = false;
 
 		dirtyContents = true;
+		hierarchicalDepth = nullptr;
+		clearTiles = nullptr;
+		clearPattern = 0;
+		pendingClears = false;
+		sampleTiles = nullptr;
+		sampleTilesStale = false;
+		tiledBuffer = nullptr;
+		tiledDirty = true;
+		renderedTo = false;
 		paletteUsed = 0;
+		lastUse = 0;
+		resident = false;
 	}
 
 	Surface::~Surface()
@@ -1372,22 +1451,33 @@ namespace sw
 		// We can't call it here because the parent resource may already have been destroyed.
 		ASSERT(isUnlocked());
 
+		untrackResidency();
+
 		if(!hasParent)
 		{
 			resource->destruct();
 		}
 
-		if(ownExternal)
+		if(ownExternal && !(internalStorage && external.buffer == internal.buffer))
 		{
-			deallocate(external.buffer);
+			deallocateBuffer(external.buffer, external.width, external.height, external.depth, external.border, external.samples, external.format);
 		}
 
-		if(internal.buffer != external.buffer)
+		if(internalStorage)
 		{
-			deallocate(internal.buffer);
+			residentBytes[internal.format] -= getInternalSize();
+			internalStorage->unbind();
+		}
+		else if(internal.buffer != external.buffer)
+		{
+			deallocateBuffer(internal.buffer, internal.width, internal.height, internal.depth, internal.border, internal.samples, internal.format);
 		}
 
-		deallocate(stencil.buffer);
+		deallocateBuffer(stencil.buffer, stencil.width, stencil.height, stencil.depth, stencil.border, stencil.samples, stencil.format);
+		deallocate(hierarchicalDepth);
+		deallocate(clearTiles);
+		deallocate(sampleTiles);
+		deallocate(tiledBuffer);
 
 		external.buffer = 0;
 		internal.buffer = 0;
@@ -1395,6 +1485,20 @@ namespace sw
 	}
 
 	void *Surface::lockExternal(int x, int y, int z, Lock lock, Accessor client)
+	{
+		syncExternal(lock, client);
+
+		return external.lockRect(x, y, z, lock);
+	}
+
+	void *Surface::lockExternal(int x, int y, int z, int width, int height, int depth, Lock lock, Accessor client)
+	{
+		syncExternal(lock, client);
+
+		return external.lockRect(x, y, z, width, height, depth, lock);
+	}
+
+	void Surface::syncExternal(Lock lock, Accessor client)
 	{
 		resource->lock(client);
 
@@ -1406,7 +1510,19 @@ namespace sw
 			}
 			else
 			{
-				external.buffer = allocateBuffer(external.width, external.height, external.depth, external.border, external.samples, external.format);
+				external.buffer = allocateBuffer(external.width, external.height, external.depth, external.border, external.samples, external.format, lock != LOCK_DISCARD);
+			}
+		}
+
+		if(pendingClears)
+		{
+			if(lock != LOCK_DISCARD)
+			{
+				writeClearTiles();
+			}
+			else
+			{
+				discardClearTiles(getRect());
 			}
 		}
 
@@ -1432,8 +1548,6 @@ namespace sw
 		default:
 			ASSERT(false);
 		}
-
-		return external.lockRect(x, y, z, lock);
 	}
 
 	void Surface::unlockExternal()
@@ -1458,10 +1572,19 @@ namespace sw
 			}
 			else
 			{
-				internal.buffer = allocateBuffer(internal.width, internal.height, internal.depth, internal.border, internal.samples, internal.format);
+				internal.buffer = allocateBuffer(internal.width, internal.height, internal.depth, internal.border, internal.samples, internal.format, lock != LOCK_DISCARD);
+
+				if(external.dirty)   // Nothing outside the dirty box was converted yet
+				{
+					external.markDirty(0, 0, 0, external.width, external.height, external.depth);
+				}
+
+				trackResidency();
 			}
 		}
 
+		lastUse = residencyClock++;
+
 		// FIXME: WHQL requires conversion to lower external precision and back
 		if(logPrecision >= WHQL)
 		{
@@ -1487,6 +1610,30 @@ namespace sw
 			}
 		}
 
+		if(external.dirty || (lock != LOCK_UNLOCKED && lock != LOCK_READONLY && client != MANAGED))
+		{
+			invalidateHierarchicalDepth();   // Only the renderer keeps it up to date
+		}
+
+		// The renderer clears the pending tiles it accesses, everyone else needs the whole surface to be up to date
+		if(pendingClears && (client != MANAGED || external.dirty))
+		{
+			if(external.dirty || lock == LOCK_DISCARD)
+			{
+				discardClearTiles(getRect());
+			}
+			else if(lock == LOCK_UNLOCKED)
+			{
+				resource->lock(client);   // Wait for the renderer to stop writing them
+				writeClearTiles();
+				resource->unlock();
+			}
+			else
+			{
+				writeClearTiles();
+			}
+		}
+
 		if(external.dirty || (isPalette(external.format) && paletteUsed != Surface::paletteID))
 		{
 			if(lock != LOCK_DISCARD)
@@ -1494,8 +1641,11 @@ namespace sw
 				update(internal, external);
 			}
 
+			markSampleTiles();
+
 			external.dirty = false;
 			paletteUsed = Surface::paletteID;
+			tiledDirty = true;
 		}
 
 		switch(lock)
@@ -1507,6 +1657,9 @@ namespace sw
 		case LOCK_READWRITE:
 		case LOCK_DISCARD:
 			dirtyContents = true;
+			tiledDirty = true;
+			renderedTo = renderedTo || client == MANAGED;
+			sampleTilesStale = sampleTilesStale || (client != MANAGED && sampleTiles);   // The renderer flags the tiles it writes
 			break;
 		default:
 			ASSERT(false);
@@ -1522,6 +1675,11 @@ namespace sw
 
 	void Surface::unlockInternal()
 	{
+		if(sampleTilesStale)
+		{
+			markSampleTiles();   // Written without telling which samples are the same
+		}
+
 		internal.unlockRect();
 
 		resource->unlock();
@@ -1538,7 +1696,7 @@ namespace sw
 
 		if(!stencil.buffer)
 		{
-			stencil.buffer = allocateBuffer(stencil.width, stencil.height, stencil.depth, stencil.border, stencil.samples, stencil.format);
+			stencil.buffer = allocateBuffer(stencil.width, stencil.height, stencil.depth, stencil.border, stencil.samples, stencil.format, true);
 		}
 
 		return stencil.lockRect(x, y, front, LOCK_READWRITE);   // FIXME
@@ -1944,19 +2102,43 @@ namespace sw
 
 	void Surface::genericUpdate(Buffer &destination, Buffer &source)
 	{
-		unsigned char *sourceSlice = (unsigned char*)source.lockRect(0, 0, 0, sw::LOCK_READONLY);
-		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(0, 0, 0, sw::LOCK_UPDATE);
+		// Only convert the part written since the buffers last matched
+		Rect rect(0, 0, min(destination.width, source.width), min(destination.height, source.height));
+		int front = 0;
+		int back = min(destination.depth, source.depth);
 
-		int depth = min(destination.depth, source.depth);
-		int height = min(destination.height, source.height);
-		int width = min(destination.width, source.width);
+		if(source.dirty)
+		{
+			rect.clip(source.dirtyRect.x0, source.dirtyRect.y0, source.dirtyRect.x1, source.dirtyRect.y1);
+			front = clamp(source.dirtyFront, front, back);
+			back = clamp(source.dirtyBack, front, back);
+		}
+
+		unsigned char *sourceSlice = (unsigned char*)source.lockRect(rect.x0, rect.y0, front, sw::LOCK_READONLY);
+		unsigned char *destinationSlice = (unsigned char*)destination.lockRect(rect.x0, rect.y0, front, sw::LOCK_UPDATE);
+
+		int depth = back - front;
+		int height = rect.height();
+		int width = rect.width();
 		int rowBytes = width * source.bytes;
 
+		// Generated conversion routines only pay off for larger updates
+		static Blitter *converter = new Blitter();   // Outlives surfaces freed at exit
+		bool convert = source.format != destination.format && width * height >= 256 &&   // Same results as Buffer::read() and write()
+		               isFloatFormat(source.format) && isFloatFormat(destination.format) && !isDepth(source.format) && !isDepth(destination.format);
+
 		for(int z = 0; z < depth; z++)
 		{
 			unsigned char *sourceRow = sourceSlice;
 			unsigned char *destinationRow = destinationSlice;
 
+			if(convert && converter->convert(destinationSlice, destination.format, destination.pitchB, sourceSlice, source.format, source.pitchB, width, height))
+			{
+				sourceSlice += source.sliceB;
+				destinationSlice += destination.sliceB;
+				continue;
+			}
+
 			for(int y = 0; y < height; y++)
 			{
 				if(source.format == destination.format)
@@ -2591,73 +2773,127 @@ namespace sw
 
 	void Surface::decodeETC2(Buffer &internal, Buffer &external, int nbAlphaBits, bool isSRGB)
 	{
-		ETC_Decoder::Decode((const byte*)external.lockRect(0, 0, 0, LOCK_READONLY), (byte*)internal.lockRect(0, 0, 0, LOCK_UPDATE), external.width, external.height, internal.width, internal.height, internal.pitchB, internal.bytes,
-		                    (nbAlphaBits == 8) ? ETC_Decoder::ETC_RGBA : ((nbAlphaBits == 1) ? ETC_Decoder::ETC_RGB_PUNCHTHROUGH_ALPHA : ETC_Decoder::ETC_RGB));
+		Rect rect;
+		int front, back;
+		dirtyBlocks(external, 4, 4, rect, front, back);
+
+		for(int z = front; z < back; z++)
+		{
+			ETC_Decoder::Decode((const byte*)external.lockRect(rect.x0, rect.y0, z, LOCK_READONLY), external.pitchB, (byte*)internal.lockRect(rect.x0, rect.y0, z, LOCK_UPDATE), rect.width(), rect.height(), internal.width - rect.x0, internal.height - rect.y0, internal.pitchB, internal.bytes,
+			                    (nbAlphaBits == 8) ? ETC_Decoder::ETC_RGBA : ((nbAlphaBits == 1) ? ETC_Decoder::ETC_RGB_PUNCHTHROUGH_ALPHA : ETC_Decoder::ETC_RGB));
+		}
+
 		external.unlockRect();
 		internal.unlockRect();
 
 		if(isSRGB)
 		{
-			static byte sRGBtoLinearTable[256];
-			static bool sRGBtoLinearTableDirty = true;
-			if(sRGBtoLinearTableDirty)
-			{
-				for(int i = 0; i < 256; i++)
-				{
-					sRGBtoLinearTable[i] = static_cast<byte>(sRGBtoLinear(static_cast<float>(i) / 255.0f) * 255.0f + 0.5f);
-				}
-				sRGBtoLinearTableDirty = false;
-			}
+			linearizeSRGB8(internal, rect, front, back);
+		}
+	}
 
-			// Perform sRGB conversion in place after decoding
-			byte *src = (byte*)internal.lockRect(0, 0, 0, LOCK_READWRITE);
-			for(int y = 0; y < internal.height; y++)
+	void Surface::decodeEAC(Buffer &internal, Buffer &external, int nbChannels, bool isSigned)
+	{
+		ASSERT(nbChannels == 1 || nbChannels == 2);
+
+		Rect rect;
+		int front, back;
+		dirtyBlocks(external, 4, 4, rect, front, back);
+
+		for(int z = front; z < back; z++)
+		{
+			byte *src = (byte*)internal.lockRect(rect.x0, rect.y0, z, LOCK_UPDATE);
+			ETC_Decoder::Decode((const byte*)external.lockRect(rect.x0, rect.y0, z, LOCK_READONLY), external.pitchB, src, rect.width(), rect.height(), internal.width - rect.x0, internal.height - rect.y0, internal.pitchB, internal.bytes,
+			                    (nbChannels == 1) ? (isSigned ? ETC_Decoder::ETC_R_SIGNED : ETC_Decoder::ETC_R_UNSIGNED) : (isSigned ? ETC_Decoder::ETC_RG_SIGNED : ETC_Decoder::ETC_RG_UNSIGNED));
+
+			// FIXME: We convert EAC data to float, until signed short internal formats are supported
+			//        This code can be removed if ETC2 images are decoded to internal 16 bit signed R/RG formats
+			const float normalization = isSigned ? (1.0f / (8.0f * 127.875f)) : (1.0f / (8.0f * 255.875f));
+			for(int y = 0; y < rect.height(); y++)
 			{
-				byte *srcRow = src + y * internal.pitchB;
-				for(int x = 0; x <  internal.width; x++)
+				byte* srcRow = src + y * internal.pitchB;
+				for(int x = rect.width() - 1; x >= 0; x--)
 				{
-					byte *srcPix = srcRow + x * internal.bytes;
-					for(int i = 0; i < 3; i++)
+					int* srcPix = reinterpret_cast<int*>(srcRow + x * internal.bytes);
+					float* dstPix = reinterpret_cast<float*>(srcPix);
+					for(int c = nbChannels - 1; c >= 0; c--)
 					{
-						srcPix[i] = sRGBtoLinearTable[srcPix[i]];
+						dstPix[c] = clamp(static_cast<float>(srcPix[c]) * normalization, -1.0f, 1.0f);
 					}
 				}
 			}
-			internal.unlockRect();
 		}
+
+		external.unlockRect();
+		internal.unlockRect();
 	}
 
-	void Surface::decodeEAC(Buffer &internal, Buffer &external, int nbChannels, bool isSigned)
+	void Surface::decodeASTC(Buffer &internal, Buffer &external, int xBlockSize, int yBlockSize, int zBlockSize, bool isSRGB)
 	{
-		ASSERT(nbChannels == 1 || nbChannels == 2);
+		ASSERT(zBlockSize == 1);   // 3D blocks are not exposed
 
-		byte *src = (byte*)internal.lockRect(0, 0, 0, LOCK_READWRITE);
-		ETC_Decoder::Decode((const byte*)external.lockRect(0, 0, 0, LOCK_READONLY), src, external.width, external.height, internal.width, internal.height, internal.pitchB, internal.bytes,
-		                    (nbChannels == 1) ? (isSigned ? ETC_Decoder::ETC_R_SIGNED : ETC_Decoder::ETC_R_UNSIGNED) : (isSigned ? ETC_Decoder::ETC_RG_SIGNED : ETC_Decoder::ETC_RG_UNSIGNED));
+		ASTC_Decoder::Decode((const byte*)external.lockRect(0, 0, 0, LOCK_READONLY), (byte*)internal.lockRect(0, 0, 0, LOCK_UPDATE), external.width, external.height, internal.width, internal.height, internal.pitchB, internal.bytes,
+		                     xBlockSize, yBlockSize, isSRGB);
 		external.unlockRect();
+		internal.unlockRect();
+
+		if(isSRGB)
+		{
+			linearizeSRGB8(internal, Rect(0, 0, internal.width, internal.height), 0, 1);
+		}
+	}
+
+	void Surface::linearizeSRGB8(Buffer &internal, const Rect &rect, int front, int back)
+	{
+		static byte sRGBtoLinearTable[256];
+		static bool sRGBtoLinearTableDirty = true;
+		if(sRGBtoLinearTableDirty)
+		{
+			for(int i = 0; i < 256; i++)
+			{
+				sRGBtoLinearTable[i] = static_cast<byte>(sRGBtoLinear(static_cast<float>(i) / 255.0f) * 255.0f + 0.5f);
+			}
+			sRGBtoLinearTableDirty = false;
+		}
 
-		// FIXME: We convert EAC data to float, until signed short internal formats are supported
-		//        This code can be removed if ETC2 images are decoded to internal 16 bit signed R/RG formats
-		const float normalization = isSigned ? (1.0f / (8.0f * 127.875f)) : (1.0f / (8.0f * 255.875f));
-		for(int y = 0; y < internal.height; y++)
+		// Perform sRGB conversion in place after decoding
+		for(int z = front; z < back; z++)
 		{
-			byte* srcRow = src + y * internal.pitchB;
-			for(int x = internal.width - 1; x >= 0; x--)
+			byte *src = (byte*)internal.lockRect(rect.x0, rect.y0, z, LOCK_UPDATE);
+			for(int y = 0; y < rect.height(); y++)
 			{
-				int* srcPix = reinterpret_cast<int*>(srcRow + x * internal.bytes);
-				float* dstPix = reinterpret_cast<float*>(srcPix);
-				for(int c = nbChannels - 1; c >= 0; c--)
+				byte *srcRow = src + y * internal.pitchB;
+				for(int x = 0; x < rect.width(); x++)
 				{
-					dstPix[c] = clamp(static_cast<float>(srcPix[c]) * normalization, -1.0f, 1.0f);
+					byte *srcPix = srcRow + x * internal.bytes;
+					for(int i = 0; i < 3; i++)
+					{
+						srcPix[i] = sRGBtoLinearTable[srcPix[i]];
+					}
 				}
 			}
 		}
-
 		internal.unlockRect();
 	}
 
-	void Surface::decodeASTC(Buffer &internal, Buffer &external, int xBlockSize, int yBlockSize, int zBlockSize, bool isSRGB)
+	void Surface::dirtyBlocks(const Buffer &external, int blockWidth, int blockHeight, Rect &rect, int &front, int &back)
 	{
+		rect = Rect(0, 0, external.width, external.height);
+		front = 0;
+		back = external.depth;
+
+		if(external.dirty)   // Only the blocks uploaded since the last decode need it again
+		{
+			rect.clip(external.dirtyRect.x0, external.dirtyRect.y0, external.dirtyRect.x1, external.dirtyRect.y1);
+			front = clamp(external.dirtyFront, front, back);
+			back = clamp(external.dirtyBack, front, back);
+		}
+
+		// Blocks are decoded whole, up to the edges of the image
+		rect.x0 -= rect.x0 % blockWidth;
+		rect.y0 -= rect.y0 % blockHeight;
+		rect.x1 = min(rect.x1 + (blockWidth - rect.x1 % blockWidth) % blockWidth, external.width);
+		rect.y1 = min(rect.y1 + (blockHeight - rect.y1 % blockHeight) % blockHeight, external.height);
 	}
 
 	size_t Surface::size(int width, int height, int depth, int border, int samples, Format format)
@@ -2845,6 +3081,16 @@ namespace sw
 		case FORMAT_L8:
 		case FORMAT_L16:
 		case FORMAT_A8L8:
+		case FORMAT_A4L4:
+		case FORMAT_R3G3B2:
+		case FORMAT_A8R3G3B2:
+		case FORMAT_X4R4G4B4:
+		case FORMAT_A4R4G4B4:
+		case FORMAT_R4G4B4A4:
+		case FORMAT_X1R5G5B5:
+		case FORMAT_A1R5G5B5:
+		case FORMAT_R5G5B5A1:
+		case FORMAT_A2R10G10B10:
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
@@ -2881,6 +3127,8 @@ namespace sw
 		case FORMAT_A16L16F:
 		case FORMAT_L32F:
 		case FORMAT_A32L32F:
+		case FORMAT_A16F:
+		case FORMAT_A32F:
 			return true;
 		default:
 			ASSERT(false);
@@ -2934,6 +3182,16 @@ namespace sw
 		case FORMAT_L8:
 		case FORMAT_L16:
 		case FORMAT_A8L8:
+		case FORMAT_A4L4:
+		case FORMAT_R3G3B2:
+		case FORMAT_A8R3G3B2:
+		case FORMAT_X4R4G4B4:
+		case FORMAT_A4R4G4B4:
+		case FORMAT_R4G4B4A4:
+		case FORMAT_X1R5G5B5:
+		case FORMAT_A1R5G5B5:
+		case FORMAT_R5G5B5A1:
+		case FORMAT_A2R10G10B10:
 		case FORMAT_YV12_BT601:
 		case FORMAT_YV12_BT709:
 		case FORMAT_YV12_JFIF:
@@ -2953,6 +3211,7 @@ namespace sw
 		case FORMAT_R8_SNORM:
 			return component >= 1;
 		case FORMAT_V8U8:
+		case FORMAT_L6V5U5:
 		case FORMAT_X8L8V8U8:
 		case FORMAT_V16U16:
 		case FORMAT_G32R32F:
@@ -2962,6 +3221,7 @@ namespace sw
 		case FORMAT_G8R8_SNORM:
 			return component >= 2;
 		case FORMAT_A16W16V16U16:
+		case FORMAT_A2W10V10U10:
 		case FORMAT_B32G32R32F:
 		case FORMAT_X32B32G32R32F:
 		case FORMAT_X8B8G8R8I:
@@ -3225,112 +3485,442 @@ namespace sw
 		return 1;
 	}
 
-	void *Surface::allocateBuffer(int width, int height, int depth, int border, int samples, Format format)
-	{
-		return allocate(size(width, height, depth, border, samples, format));
-	}
-
-	void Surface::memfill4(void *buffer, int pattern, int bytes)
+	namespace
 	{
-		while((size_t)buffer & 0x1 && bytes >= 1)
+		// Buffers of destroyed surfaces, oldest first
+		class BufferPool
 		{
-			*(char*)buffer = (char)pattern;
-			(char*&)buffer += 1;
-			bytes -= 1;
-		}
+		public:
+			void *take(size_t bytes)
+			{
+				void *buffer = nullptr;
 
-		while((size_t)buffer & 0x3 && bytes >= 2)
-		{
-			*(short*)buffer = (short)pattern;
-			(short*&)buffer += 1;
-			bytes -= 2;
-		}
+				mutex.lock();
 
-		#if defined(__i386__) || defined(__x86_64__)
-			if(CPUID::supportsSSE())
-			{
-				while((size_t)buffer & 0xF && bytes >= 4)
+				for(size_t i = entries.size(); i-- > 0;)   // Most recently released first, its memory is the most likely to be cached
 				{
-					*(int*)buffer = pattern;
-					(int*&)buffer += 1;
-					bytes -= 4;
+					if(entries[i].bytes == bytes)
+					{
+						buffer = entries[i].buffer;
+						pooledBytes -= bytes;
+						entries.erase(entries.begin() + i);
+						break;
+					}
 				}
 
-				__m128 quad = _mm_set_ps1((float&)pattern);
+				mutex.unlock();
 
-				float *pointer = (float*)buffer;
-				int qxwords = bytes / 64;
-				bytes -= qxwords * 64;
+				return buffer;
+			}
 
-				while(qxwords--)
-				{
-					_mm_stream_ps(pointer + 0, quad);
-					_mm_stream_ps(pointer + 4, quad);
-					_mm_stream_ps(pointer + 8, quad);
-					_mm_stream_ps(pointer + 12, quad);
+			void put(void *buffer, size_t bytes, size_t maxBytes, size_t maxBuffers)
+			{
+				std::vector<void*> evicted;
 
-					pointer += 16;
+				mutex.lock();
+
+				entries.push_back({buffer, bytes});
+				pooledBytes += bytes;
+
+				while(pooledBytes > maxBytes || entries.size() > maxBuffers)
+				{
+					evicted.push_back(entries.front().buffer);
+					pooledBytes -= entries.front().bytes;
+					entries.erase(entries.begin());
 				}
 
-				buffer = pointer;
+				mutex.unlock();
+
+				for(void *memory : evicted)
+				{
+					deallocate(memory);
+				}
 			}
-		#endif
 
-		while(bytes >= 4)
-		{
-			*(int*)buffer = (int)pattern;
-			(int*&)buffer += 1;
-			bytes -= 4;
-		}
+		private:
+			struct Entry
+			{
+				void *buffer;
+				size_t bytes;
+			};
 
-		while(bytes >= 2)
-		{
-			*(short*)buffer = (short)pattern;
-			(short*&)buffer += 1;
-			bytes -= 2;
-		}
+			MutexLock mutex;
+			std::vector<Entry> entries;
+			size_t pooledBytes = 0;
+		};
 
-		while(bytes >= 1)
+		BufferPool &bufferPool()
 		{
-			*(char*)buffer = (char)pattern;
-			(char*&)buffer += 1;
-			bytes -= 1;
+			static BufferPool *pool = new BufferPool();   // Never destroyed, static objects holding surfaces may get destroyed after it
+
+			return *pool;
 		}
 	}
 
-	void Surface::sync()
+	void *Surface::allocateBuffer(int width, int height, int depth, int border, int samples, Format format, bool clear)
 	{
-		resource->lock(EXCLUSIVE);
-		resource->unlock();
+		size_t bytes = size(width, height, depth, border, samples, format);
+		residentBytes[format] += bytes;
+
+		return allocateBuffer(bytes, clear);
 	}
 
-	bool Surface::isEntire(const Rect& rect) const
+	void Surface::deallocateBuffer(void *buffer, int width, int height, int depth, int border, int samples, Format format)
 	{
-		return (rect.x0 == 0 && rect.y0 == 0 && rect.x1 == internal.width && rect.y1 == internal.height && internal.depth == 1);
+		if(!buffer)
+		{
+			return;
+		}
+
+		size_t bytes = size(width, height, depth, border, samples, format);
+		residentBytes[format] -= bytes;
+
+		deallocateBuffer(buffer, bytes);
 	}
 
-	Rect Surface::getRect() const
+	void *Surface::allocateBuffer(size_t bytes, bool clear)
 	{
-		return Rect(0, 0, internal.width, internal.height);
+		if(bytes >= MIN_POOLED_BYTES)
+		{
+			void *buffer = bufferPool().take(bytes);
+
+			if(buffer)
+			{
+				if(clear)   // Unless it's entirely overwritten, the contents of other surfaces must not be observable
+				{
+					memset(buffer, 0, bytes);
+				}
+
+				return buffer;
+			}
+		}
+
+		return allocate(bytes, 16, clear, MEMORY_SURFACE);
 	}
 
-	void Surface::clearDepth(float depth, int x0, int y0, int width, int height)
+	void Surface::deallocateBuffer(void *buffer, size_t bytes)
 	{
-		if(width == 0 || height == 0)
+		if(bytes >= MIN_POOLED_BYTES && bytes <= MAX_POOLED_BYTES)
 		{
-			return;
+			bufferPool().put(buffer, bytes, MAX_POOLED_BYTES, MAX_POOLED_BUFFERS);
 		}
-
-		if(internal.format == FORMAT_NULL)
+		else
 		{
-			return;
+			deallocate(buffer);
 		}
+	}
 
-		// Not overlapping
-		if(x0 > internal.width) return;
-		if(y0 > internal.height) return;
-		if(x0 + width < 0) return;
-		if(y0 + height < 0) return;
+	size_t Surface::getInternalSize() const
+	{
+		return size(internal.width, internal.height, internal.depth, internal.border, internal.samples, internal.format);
+	}
+
+	Surface::ChromaPlanes Surface::getChromaPlanes() const
+	{
+		// The Cr and Cb planes follow the luma plane, with 16-byte aligned rows half as wide
+		int YStride = internal.pitchB;
+		int CStride = align<16>(YStride / 2);
+
+		ChromaPlanes planes;
+		planes.offsetCr = (ptrdiff_t)YStride * internal.height;
+		planes.offsetCb = planes.offsetCr + (ptrdiff_t)CStride * internal.height / 2;
+		planes.pitchB = CStride;
+		planes.stepB = 1;
+
+		return planes;
+	}
+
+	void Surface::setInternalStorage(Storage *storage, size_t offset)
+	{
+		ASSERT(!internal.buffer && !external.buffer && !internalStorage);
+
+		storage->bind();
+		internalStorage = storage;
+		internal.buffer = storage->address(offset);
+		residentBytes[internal.format] += getInternalSize();
+	}
+
+	Surface::Storage::Storage(size_t bytes) : bytes(bytes), owned(true), bindings(0)
+	{
+		buffer = allocateBuffer(bytes, true);
+	}
+
+	Surface::Storage::Storage(void *buffer, size_t bytes) : buffer(buffer), bytes(bytes), owned(false), bindings(0)
+	{
+	}
+
+	Surface::Storage::~Storage()
+	{
+		if(owned)
+		{
+			deallocateBuffer(buffer, bytes);
+		}
+	}
+
+	void *Surface::Storage::address(size_t offset) const
+	{
+		return (unsigned char*)buffer + offset;
+	}
+
+	void Surface::Storage::bind()
+	{
+		bindings++;
+	}
+
+	void Surface::Storage::unbind()
+	{
+		if(--bindings == 0)
+		{
+			delete this;
+		}
+	}
+
+	namespace
+	{
+		// Surfaces with an internal copy which can be recreated from the external one
+		class ResidencySet
+		{
+		public:
+			MutexLock mutex;
+			std::vector<Surface*> surfaces;
+		};
+
+		ResidencySet &residencySet()
+		{
+			static ResidencySet *set = new ResidencySet();   // Never destroyed, like the buffer pool
+
+			return *set;
+		}
+	}
+
+	void Surface::setTextureMemoryBudget(size_t bytes)
+	{
+		textureMemoryBudget = bytes;
+	}
+
+	size_t Surface::getTextureMemoryUsage()
+	{
+		return textureMemoryUsage;
+	}
+
+	size_t Surface::getResidentBytes(Format format)
+	{
+		return residentBytes[format];
+	}
+
+	void Surface::trimTextureMemory()
+	{
+		size_t budget = textureMemoryBudget;
+
+		if(budget == 0 || textureMemoryUsage <= budget)
+		{
+			return;
+		}
+
+		ResidencySet &set = residencySet();
+		set.mutex.lock();
+
+		std::vector<std::pair<unsigned int, size_t>> coldest;   // Last use, index into the set
+
+		for(size_t i = 0; i < set.surfaces.size(); i++)
+		{
+			coldest.push_back({set.surfaces[i]->lastUse, i});
+		}
+
+		std::sort(coldest.begin(), coldest.end());
+
+		for(auto &entry : coldest)
+		{
+			if(textureMemoryUsage <= budget)
+			{
+				break;
+			}
+
+			Surface *surface = set.surfaces[entry.second];
+
+			if(surface->evictInternal())
+			{
+				textureMemoryUsage -= size(surface->internal.width, surface->internal.height, surface->internal.depth, surface->internal.border, surface->internal.samples, surface->internal.format);
+				surface->resident = false;
+			}
+		}
+
+		set.surfaces.erase(std::remove_if(set.surfaces.begin(), set.surfaces.end(), [](const Surface *surface) { return !surface->resident; }), set.surfaces.end());
+
+		set.mutex.unlock();
+	}
+
+	bool Surface::isEvictable() const
+	{
+		// Cube borders and multisample resolves aren't recreated by updating from the external buffer
+		return ownExternal && !internalStorage && internal.border == 0 && internal.samples == 1 && !identicalBuffers() &&
+		       !isDepth(internal.format) && !isStencil(internal.format);
+	}
+
+	void Surface::trackResidency()
+	{
+		if(!isEvictable())
+		{
+			return;
+		}
+
+		ResidencySet &set = residencySet();
+		set.mutex.lock();
+
+		set.surfaces.push_back(this);
+		resident = true;
+		textureMemoryUsage += size(internal.width, internal.height, internal.depth, internal.border, internal.samples, internal.format);
+
+		set.mutex.unlock();
+	}
+
+	void Surface::untrackResidency()
+	{
+		ResidencySet &set = residencySet();
+		set.mutex.lock();
+
+		if(resident)
+		{
+			set.surfaces.erase(std::find(set.surfaces.begin(), set.surfaces.end(), this));
+			resident = false;
+			textureMemoryUsage -= size(internal.width, internal.height, internal.depth, internal.border, internal.samples, internal.format);
+		}
+
+		set.mutex.unlock();
+	}
+
+	bool Surface::evictInternal()
+	{
+		// Draws in flight and other threads accessing the surface hold its resource
+		if(!resource->tryLock(EXCLUSIVE))
+		{
+			return false;
+		}
+
+		// Only evict when the external buffer has all the contents, and the copy isn't in use
+		bool evictable = external.buffer && internal.buffer != external.buffer && !internal.dirty && !pendingClears &&
+		                 internal.lock == LOCK_UNLOCKED && external.lock == LOCK_UNLOCKED;
+
+		if(evictable)
+		{
+			deallocateBuffer(internal.buffer, internal.width, internal.height, internal.depth, internal.border, internal.samples, internal.format);
+			internal.buffer = nullptr;
+
+			deallocate(tiledBuffer);
+			tiledBuffer = nullptr;
+			tiledDirty = true;
+
+			external.markDirty(0, 0, 0, external.width, external.height, external.depth);   // Converted again on the next internal lock
+		}
+
+		resource->unlock();
+
+		return evictable;
+	}
+
+	void Surface::memfill4(void *buffer, int pattern, int bytes)
+	{
+		while((size_t)buffer & 0x1 && bytes >= 1)
+		{
+			*(char*)buffer = (char)pattern;
+			(char*&)buffer += 1;
+			bytes -= 1;
+		}
+
+		while((size_t)buffer & 0x3 && bytes >= 2)
+		{
+			*(short*)buffer = (short)pattern;
+			(short*&)buffer += 1;
+			bytes -= 2;
+		}
+
+		#if defined(__i386__) || defined(__x86_64__)
+			if(CPUID::supportsSSE())
+			{
+				while((size_t)buffer & 0xF && bytes >= 4)
+				{
+					*(int*)buffer = pattern;
+					(int*&)buffer += 1;
+					bytes -= 4;
+				}
+
+				__m128 quad = _mm_set_ps1((float&)pattern);
+
+				float *pointer = (float*)buffer;
+				int qxwords = bytes / 64;
+				bytes -= qxwords * 64;
+
+				while(qxwords--)
+				{
+					_mm_stream_ps(pointer + 0, quad);
+					_mm_stream_ps(pointer + 4, quad);
+					_mm_stream_ps(pointer + 8, quad);
+					_mm_stream_ps(pointer + 12, quad);
+
+					pointer += 16;
+				}
+
+				_mm_sfence();   // Streaming stores aren't ordered with the unlock that publishes them
+
+				buffer = pointer;
+			}
+		#endif
+
+		while(bytes >= 4)
+		{
+			*(int*)buffer = (int)pattern;
+			(int*&)buffer += 1;
+			bytes -= 4;
+		}
+
+		while(bytes >= 2)
+		{
+			*(short*)buffer = (short)pattern;
+			(short*&)buffer += 1;
+			bytes -= 2;
+		}
+
+		while(bytes >= 1)
+		{
+			*(char*)buffer = (char)pattern;
+			(char*&)buffer += 1;
+			bytes -= 1;
+		}
+	}
+
+	void Surface::sync()
+	{
+		resource->lock(EXCLUSIVE);
+		resource->unlock();
+	}
+
+	bool Surface::isEntire(const Rect& rect) const
+	{
+		return (rect.x0 == 0 && rect.y0 == 0 && rect.x1 == internal.width && rect.y1 == internal.height && internal.depth == 1);
+	}
+
+	Rect Surface::getRect() const
+	{
+		return Rect(0, 0, internal.width, internal.height);
+	}
+
+	void Surface::clearDepth(float depth, int x0, int y0, int width, int height)
+	{
+		if(width == 0 || height == 0)
+		{
+			return;
+		}
+
+		if(internal.format == FORMAT_NULL)
+		{
+			return;
+		}
+
+		// Not overlapping
+		if(x0 > internal.width) return;
+		if(y0 > internal.height) return;
+		if(x0 + width < 0) return;
+		if(y0 + height < 0) return;
 
 		// Clip against dimensions
 		if(x0 < 0) {width += x0; x0 = 0;}
@@ -3344,32 +3934,56 @@ namespace sw
 		int x1 = x0 + width;
 		int y1 = y0 + height;
 
+		if(hasQuadLayout(internal.format) && complementaryDepthBuffer)
+		{
+			depth = 1 - depth;
+		}
+
+		Rect tiles = beginClear(x0, y0, x1, y1);
+		float *buffer = (float*)lockInternal(0, 0, 0, lock, PUBLIC);
+
+		if(tiles.width() > 0)   // Only the pixels around the deferred tiles are written now
+		{
+			fillDepth(buffer, depth, x0, y0, x1, tiles.y0);
+			fillDepth(buffer, depth, x0, tiles.y0, tiles.x0, tiles.y1);
+			fillDepth(buffer, depth, tiles.x1, tiles.y0, x1, tiles.y1);
+			fillDepth(buffer, depth, x0, tiles.y1, x1, y1);
+
+			endClear(&depth, tiles);
+		}
+		else
+		{
+			fillDepth(buffer, depth, x0, y0, x1, y1);
+		}
+
+		clearHierarchicalDepth(depth, x0, y0, x1, y1);
+		unlockInternal();
+	}
+
+	void Surface::fillDepth(float *buffer, float depth, int x0, int y0, int x1, int y1)
+	{
+		if(x0 >= x1 || y0 >= y1)
+		{
+			return;
+		}
+
 		if(!hasQuadLayout(internal.format))
 		{
-			float *target = (float*)lockInternal(x0, y0, 0, lock, PUBLIC);
+			float *target = buffer + y0 * internal.pitchP + x0;
 
 			for(int z = 0; z < internal.samples; z++)
 			{
 				float *row = target;
 				for(int y = y0; y < y1; y++)
 				{
-					memfill4(row, (int&)depth, width * sizeof(float));
+					memfill4(row, (int&)depth, (x1 - x0) * sizeof(float));
 					row += internal.pitchP;
 				}
 				target += internal.sliceP;
 			}
-
-			unlockInternal();
 		}
 		else   // Quad layout
 		{
-			if(complementaryDepthBuffer)
-			{
-				depth = 1 - depth;
-			}
-
-			float *buffer = (float*)lockInternal(0, 0, 0, lock, PUBLIC);
-
 			int oddX0 = (x0 & ~1) * 2 + (x0 & 1);
 			int oddX1 = (x1 & ~1) * 2;
 			int evenX0 = ((x0 + 1) & ~1) * 2;
@@ -3440,9 +4054,371 @@ namespace sw
 
 				buffer += internal.sliceP;
 			}
+		}
+	}
 
-			unlockInternal();
+	bool Surface::hasHierarchicalDepth() const
+	{
+		return isDepth(internal.format) && internal.samples == 1 && internal.depth == 1 && internal.border == 0 && internal.width >= 16;
+	}
+
+	float *Surface::getHierarchicalDepth()
+	{
+		if(!hierarchicalDepth)
+		{
+			size_t tiles = (internal.width / 16) * ((internal.height + 1) / 2);
+			hierarchicalDepth = static_cast<float*>(allocate(tiles * sizeof(float), 16, true, MEMORY_SURFACE));
+			invalidateHierarchicalDepth();
 		}
+
+		return hierarchicalDepth;
+	}
+
+	int Surface::getHierarchicalDepthPitchB() const
+	{
+		return (internal.width / 16) * sizeof(float);   // 16x2 pixel tiles, partial tiles aren't tracked
+	}
+
+	void Surface::invalidateHierarchicalDepth()
+	{
+		if(hierarchicalDepth)
+		{
+			int tiles = (internal.width / 16) * ((internal.height + 1) / 2);
+			memfill4(hierarchicalDepth, 0x7FFFFFFF, tiles * sizeof(float));   // NaN never culls
+		}
+	}
+
+	void Surface::clearHierarchicalDepth(float depth, int x0, int y0, int x1, int y1)
+	{
+		if(!hierarchicalDepth || !(depth >= 0.0f))
+		{
+			return;
+		}
+
+		int pitch = getHierarchicalDepthPitchB() / sizeof(float);
+
+		// Tiles entirely inside the cleared rectangle
+		for(int tileY = (y0 + 1) / 2; tileY * 2 < y1; tileY++)
+		{
+			if(tileY * 2 + 1 >= y1 && tileY * 2 + 1 < internal.height)
+			{
+				break;
+			}
+
+			for(int tileX = (x0 + 15) / 16; tileX * 16 + 16 <= x1; tileX++)
+			{
+				hierarchicalDepth[tileY * pitch + tileX] = depth;
+			}
+		}
+	}
+
+	Rect Surface::beginClear(int x0, int y0, int x1, int y1)
+	{
+		Rect tiles((x0 + 15) & ~15, (y0 + 1) & ~1, x1 & ~15, y1 & ~1);
+
+		if(!deferredClears || !hasClearTiles() || tiles.x0 >= tiles.x1 || tiles.y0 >= tiles.y1)
+		{
+			return Rect(0, 0, 0, 0);
+		}
+
+		// Tiles which get cleared again don't have to be written when the surface gets locked
+		resource->lock(PUBLIC);
+		discardClearTiles(tiles);
+		resource->unlock();
+
+		return tiles;
+	}
+
+	void Surface::endClear(const void *pixel, const Rect &tiles)
+	{
+		ASSERT(!pendingClears);   // Written by locking the surface
+
+		switch(internal.bytes)
+		{
+		case 2: clearPattern = *(const unsigned short*)pixel * 0x00010001; break;
+		case 4: clearPattern = *(const unsigned int*)pixel;                break;
+		default: ASSERT(false);
+		}
+
+		unsigned char *flags = getClearTiles();
+		int pitch = getClearTilesPitchB();
+
+		for(int tileY = tiles.y0 / 2; tileY < tiles.y1 / 2; tileY++)
+		{
+			memset(&flags[tileY * pitch + tiles.x0 / 16], 1, (tiles.x1 - tiles.x0) / 16);
+		}
+
+		pendingClears = true;
+	}
+
+	bool Surface::hasClearTiles() const
+	{
+		if(internal.samples != 1 || internal.depth != 1 || internal.border != 0 || internal.width < 16 || internal.height < 2)
+		{
+			return false;
+		}
+
+		if(isDepth(internal.format))
+		{
+			return internal.bytes == 4;
+		}
+
+		return (internal.bytes == 2 || internal.bytes == 4) && !hasQuadLayout(internal.format);
+	}
+
+	unsigned char *Surface::getClearTiles()
+	{
+		if(!clearTiles)
+		{
+			size_t tiles = (internal.width / 16) * ((internal.height + 1) / 2);
+			clearTiles = static_cast<unsigned char*>(allocate(tiles, 16, true, MEMORY_SURFACE));
+			memset(clearTiles, 0, tiles);
+		}
+
+		return clearTiles;
+	}
+
+	int Surface::getClearTilesPitchB() const
+	{
+		return internal.width / 16;   // 16x2 pixel tiles like the hierarchical depth buffer
+	}
+
+	unsigned int Surface::getClearPattern() const
+	{
+		return clearPattern;
+	}
+
+	void Surface::writeClearTiles()
+	{
+		int pitch = getClearTilesPitchB();
+		int tileB = 16 * internal.bytes;
+		bool quadLayout = hasQuadLayout(internal.format);
+
+		for(int tileY = 0; tileY < internal.height / 2; tileY++)
+		{
+			unsigned char *row = (unsigned char*)internal.buffer + 2 * tileY * internal.pitchB;
+
+			for(int tileX = 0; tileX < pitch; tileX++)
+			{
+				if(!clearTiles[tileY * pitch + tileX])
+				{
+					continue;
+				}
+
+				if(quadLayout)   // Both lines of the tile are contiguous
+				{
+					memfill4(row + 2 * tileB * tileX, clearPattern, 2 * tileB);
+				}
+				else
+				{
+					memfill4(row + tileB * tileX, clearPattern, tileB);
+					memfill4(row + tileB * tileX + internal.pitchB, clearPattern, tileB);
+				}
+
+				clearTiles[tileY * pitch + tileX] = 0;
+			}
+		}
+
+		pendingClears = false;
+		tiledDirty = true;
+	}
+
+	void Surface::discardClearTiles(const Rect &tiles)
+	{
+		if(!clearTiles)
+		{
+			return;
+		}
+
+		int pitch = getClearTilesPitchB();
+		int tileX0 = tiles.x0 / 16;
+		int tileX1 = tiles.x1 / 16;
+
+		for(int tileY = tiles.y0 / 2; tileY < tiles.y1 / 2 && tileX0 < tileX1; tileY++)
+		{
+			memset(&clearTiles[tileY * pitch + tileX0], 0, tileX1 - tileX0);
+		}
+
+		if(isEntire(tiles))
+		{
+			pendingClears = false;
+		}
+	}
+
+	void Surface::invalidate(const Rect &rect)
+	{
+		Rect clipped = rect;
+		clipped.clip(0, 0, internal.width, internal.height);
+
+		if(internal.depth != 1 || clipped.x0 >= clipped.x1 || clipped.y0 >= clipped.y1)
+		{
+			return;   // Layers of array and 3D surfaces don't get tracked separately
+		}
+
+		auto covers = [&clipped](const Rect &dirtyRect)
+		{
+			return dirtyRect.x0 >= clipped.x0 && dirtyRect.y0 >= clipped.y0 && dirtyRect.x1 <= clipped.x1 && dirtyRect.y1 <= clipped.y1;
+		};
+
+		resource->lock(PUBLIC);   // Wait for the renderer to finish with the current contents
+
+		// Neither the resolve and conversion into the external buffer nor the other way around are needed
+		if(internal.dirty && covers(internal.dirtyRect))
+		{
+			internal.dirty = false;
+		}
+
+		if(external.dirty && covers(external.dirtyRect))
+		{
+			external.dirty = false;
+		}
+
+		if(pendingClears)
+		{
+			discardClearTiles(isEntire(clipped) ? getRect() : Rect((clipped.x0 + 15) & ~15, (clipped.y0 + 1) & ~1, clipped.x1 & ~15, clipped.y1 & ~1));
+		}
+
+		if(hasSampleTiles())
+		{
+			setUniformSamples(clipped);   // Only the tiles the renderer writes again need resolving
+		}
+
+		resource->unlock();
+	}
+
+	bool Surface::hasSampleTiles() const
+	{
+		// Supersampled surfaces get rendered in several passes, which don't shade their samples the same
+		return internal.samples > 1 && internal.samples <= 4 && renderTarget && internal.depth == 1 && internal.border == 0 &&
+		       !isDepth(internal.format) && !isStencil(internal.format) && !hasQuadLayout(internal.format);
+	}
+
+	unsigned char *Surface::getSampleTiles()
+	{
+		if(!sampleTiles)
+		{
+			size_t tiles = getSampleTilesPitchB() * ((internal.height + 1) / 2);
+			sampleTiles = static_cast<unsigned char*>(allocate(tiles, 16, true, MEMORY_SURFACE));
+			memset(sampleTiles, 1, tiles);
+		}
+
+		return sampleTiles;
+	}
+
+	int Surface::getSampleTilesPitchB() const
+	{
+		return (internal.width + 15) / 16;   // Partial tiles at the right edge included
+	}
+
+	void Surface::markSampleTiles()
+	{
+		if(sampleTiles)
+		{
+			memset(sampleTiles, 1, getSampleTilesPitchB() * ((internal.height + 1) / 2));
+		}
+
+		sampleTilesStale = false;
+	}
+
+	void Surface::setUniformSamples(const Rect &rect)
+	{
+		sampleTilesStale = false;
+
+		if(!hasSampleTiles())
+		{
+			return;
+		}
+
+		getSampleTiles();
+
+		// Tiles partially inside the rectangle keep their samples as they were
+		int pitch = getSampleTilesPitchB();
+		int tileX0 = (rect.x0 + 15) / 16;
+		int tileX1 = (rect.x1 == internal.width) ? pitch : rect.x1 / 16;
+		int tileY0 = (rect.y0 + 1) / 2;
+		int tileY1 = (rect.y1 == internal.height) ? (internal.height + 1) / 2 : rect.y1 / 2;
+
+		for(int tileY = tileY0; tileY < tileY1 && tileX0 < tileX1; tileY++)
+		{
+			memset(&sampleTiles[tileY * pitch + tileX0], 0, tileX1 - tileX0);
+		}
+	}
+
+	bool Surface::isTiled() const
+	{
+		if(!tiledTextures || renderedTo || internal.depth != 1 || internal.border != 0 || internal.samples != 1 || internal.width > 4096)
+		{
+			return false;   // The sampler computes tiled indices of up to 4 * width with 16-bit arithmetic
+		}
+
+		switch(internal.format)
+		{
+		case FORMAT_YV12_BT601:
+		case FORMAT_YV12_BT709:
+		case FORMAT_YV12_JFIF:
+			return false;
+		default:
+			break;
+		}
+
+		if(isDepth(internal.format) || isStencil(internal.format) || hasQuadLayout(internal.format) || isCompressed(internal.format))
+		{
+			return false;
+		}
+
+		switch(internal.bytes)
+		{
+		case 1: case 2: case 4: case 8: case 16:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	void *Surface::getTiledBuffer(const void *buffer)
+	{
+		if(buffer != internal.buffer || !isTiled())
+		{
+			return nullptr;   // Locking returned memory which this surface doesn't keep track of
+		}
+
+		if(!tiledBuffer)
+		{
+			tiledBuffer = allocate(getTiledSliceP() * internal.bytes + 4, 16, true, MEMORY_SURFACE);
+			tiledDirty = true;
+		}
+
+		if(tiledDirty)
+		{
+			// Texel (x, y) is at (y / 4) * tiledPitchP + (x & ~3) * 4 + (y % 4) * 4 + x % 4
+			int bytes = internal.bytes;
+			int pitchB = getTiledPitchP() * bytes;
+
+			for(int y = 0; y < internal.height; y++)
+			{
+				const unsigned char *source = (const unsigned char*)internal.buffer + y * internal.pitchB;
+				unsigned char *row = (unsigned char*)tiledBuffer + (y / 4) * pitchB + (y % 4) * 4 * bytes;
+
+				for(int x = 0; x < internal.width; x += 4)
+				{
+					memcpy(row + x * 4 * bytes, source + x * bytes, min(4, internal.width - x) * bytes);
+				}
+			}
+
+			tiledDirty = false;
+		}
+
+		return tiledBuffer;
+	}
+
+	int Surface::getTiledPitchP() const
+	{
+		return 4 * align<4>(internal.width);
+	}
+
+	int Surface::getTiledSliceP() const
+	{
+		return align<4>(internal.width) * align<4>(internal.height);
 	}
 
 	void Surface::clearStencil(unsigned char s, unsigned char mask, int x0, int y0, int width, int height)
@@ -3556,6 +4532,25 @@ namespace sw
 				row += buffer->pitchB;
 			}
 		}
+		else if(buffer->bytes == 8 || buffer->bytes == 16)
+		{
+			uint64_t c[2];
+			buffer->write(c, color);
+
+			for(int y = 0; y < height; y++)
+			{
+				if(buffer->bytes == 8)
+				{
+					sw::clear((uint64_t*)row, c[0], width);
+				}
+				else
+				{
+					sw::clear((uint64_t*)row, c, width);
+				}
+
+				row += buffer->pitchB;
+			}
+		}
 		else   // Generic
 		{
 			for(int y = 0; y < height; y++)
@@ -3665,23 +4660,26 @@ namespace sw
 			memcpy(dstBuf, srcBuf, srcBytes);
 		}
 
-		if(dstEdge == LEFT || dstEdge == RIGHT)
-		{
-			// TOP and BOTTOM are already set, let's average out the corners
-			int x0 = (dstEdge == RIGHT) ? dstW : -1;
-			int y0 = -1;
-			int x1 = (dstEdge == RIGHT) ? dstW - 1 : 0;
-			int y1 = 0;
-			dst->computeCubeCorner(x0, y0, x1, y1);
-			y0 = dstH;
-			y1 = dstH - 1;
-			dst->computeCubeCorner(x0, y0, x1, y1);
-		}
-
 		src->unlockInternal();
 		dst->unlockInternal();
 	}
 
+	void Surface::computeCubeCorners()
+	{
+		// Averages the two border texels and the face texel next to each corner, so the edges must be set
+		lockInternal(-1, -1, 0, sw::LOCK_READWRITE, sw::PRIVATE);
+
+		int w = getWidth();
+		int h = getHeight();
+
+		computeCubeCorner(-1, -1, 0, 0);
+		computeCubeCorner(w, -1, w - 1, 0);
+		computeCubeCorner(-1, h, 0, h - 1);
+		computeCubeCorner(w, h, w - 1, h - 1);
+
+		unlockInternal();
+	}
+
 	void Surface::computeCubeCorner(int x0, int y0, int x1, int y1)
 	{
 		ASSERT(internal.lock != LOCK_UNLOCKED);
@@ -4009,12 +5007,78 @@ namespace sw
 
 		void *source = internal.lockRect(0, 0, 0, LOCK_READWRITE);
 
-		int width = internal.width;
+		// Large surfaces are resolved in bands of rows
 		int height = internal.height;
+		int threadCount = max(min(min(CPUID::processAffinity(), (int)MAX_RESOLVE_THREADS), internal.width * height * internal.samples / MIN_RESOLVE_SAMPLES), 1);
+		ResolveTask task[MAX_RESOLVE_THREADS];
+		Thread *thread[MAX_RESOLVE_THREADS] = {};
+
+		for(int i = threadCount - 1; i >= 0; i--)
+		{
+			task[i].surface = this;
+			task[i].source = source;
+			task[i].y0 = (height * i / threadCount) & ~1;   // Keeps quad layout row pairs together
+			task[i].y1 = (i == threadCount - 1) ? height : (height * (i + 1) / threadCount) & ~1;
+
+			if(i > 0)
+			{
+				thread[i] = new Thread(resolveTask, &task[i]);
+			}
+		}
+
+		resolveTask(&task[0]);
+
+		for(int i = 1; i < threadCount; i++)
+		{
+			thread[i]->join();
+			delete thread[i];
+		}
+	}
+
+	void Surface::resolveTask(void *parameters)
+	{
+		ResolveTask *task = static_cast<ResolveTask*>(parameters);
+		Surface *surface = task->surface;
+
+		if(!surface->sampleTiles)
+		{
+			surface->resolve(task->source, 0, surface->internal.width, task->y0, task->y1);
+			return;
+		}
+
+		// Tiles of which all samples are the same already have the resolved color in the first sample
+		int pitch = surface->getSampleTilesPitchB();
+
+		for(int y = task->y0; y < task->y1; y += 2)
+		{
+			const unsigned char *tiles = &surface->sampleTiles[(y / 2) * pitch];
+
+			for(int tileX = 0; tileX < pitch; tileX++)
+			{
+				if(tiles[tileX])
+				{
+					int tileX1 = tileX + 1;
+
+					while(tileX1 < pitch && tiles[tileX1])
+					{
+						tileX1++;
+					}
+
+					surface->resolve(task->source, 16 * tileX, min(16 * tileX1, surface->internal.width), y, min(y + 2, task->y1));
+					tileX = tileX1;
+				}
+			}
+		}
+	}
+
+	void Surface::resolve(void *source, int x0, int x1, int y0, int y1)
+	{
+		int width = x1 - x0;
+		int height = y1 - y0;
 		int pitch = internal.pitchB;
 		int slice = internal.sliceB;
 
-		unsigned char *source0 = (unsigned char*)source;
+		unsigned char *source0 = (unsigned char*)source + y0 * pitch + x0 * internal.bytes;   // Aligned when x0 is a multiple of 16
 		unsigned char *source1 = source0 + slice;
 		unsigned char *source2 = source1 + slice;
 		unsigned char *source3 = source2 + slice;
@@ -4036,7 +5100,7 @@ namespace sw
 		   internal.format == FORMAT_SRGB8_X8 || internal.format == FORMAT_SRGB8_A8)
 		{
 			#if defined(__i386__) || defined(__x86_64__)
-				if(CPUID::supportsSSE2() && (width % 4) == 0)
+				if(CPUID::supportsSSE2() && (width % 4) == 0 && (pitch % 16) == 0)
 				{
 					if(internal.samples == 2)
 					{
@@ -4330,7 +5394,7 @@ namespace sw
 		{
 
 			#if defined(__i386__) || defined(__x86_64__)
-				if(CPUID::supportsSSE2() && (width % 4) == 0)
+				if(CPUID::supportsSSE2() && (width % 4) == 0 && (pitch % 16) == 0)
 				{
 					if(internal.samples == 2)
 					{
@@ -4623,7 +5687,7 @@ namespace sw
 		else if(internal.format == FORMAT_A16B16G16R16)
 		{
 			#if defined(__i386__) || defined(__x86_64__)
-				if(CPUID::supportsSSE2() && (width % 2) == 0)
+				if(CPUID::supportsSSE2() && (width % 2) == 0 && (pitch % 16) == 0)
 				{
 					if(internal.samples == 2)
 					{
@@ -4916,7 +5980,7 @@ namespace sw
 		else if(internal.format == FORMAT_R32F)
 		{
 			#if defined(__i386__) || defined(__x86_64__)
-				if(CPUID::supportsSSE() && (width % 4) == 0)
+				if(CPUID::supportsSSE() && (width % 4) == 0 && (pitch % 16) == 0)
 				{
 					if(internal.samples == 2)
 					{
@@ -5213,7 +6277,7 @@ namespace sw
 		else if(internal.format == FORMAT_G32R32F)
 		{
 			#if defined(__i386__) || defined(__x86_64__)
-				if(CPUID::supportsSSE() && (width % 2) == 0)
+				if(CPUID::supportsSSE() && (width % 2) == 0 && (pitch % 16) == 0)
 				{
 					if(internal.samples == 2)
 					{
@@ -5809,7 +6873,7 @@ namespace sw
 		else if(internal.format == FORMAT_R5G6B5)
 		{
 			#if defined(__i386__) || defined(__x86_64__)
-				if(CPUID::supportsSSE2() && (width % 8) == 0)
+				if(CPUID::supportsSSE2() && (width % 8) == 0 && (pitch % 16) == 0)
 				{
 					if(internal.samples == 2)
 					{
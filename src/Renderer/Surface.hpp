@@ -19,6 +19,8 @@
 #include "Main/Config.hpp"
 #include "Common/Resource.hpp"
 
+#include <stddef.h>
+
 namespace sw
 {
 	class Resource;
@@ -254,9 +256,13 @@ namespace sw
 			Color<float> sample(float x, float y, float z) const;
 			Color<float> sample(float x, float y, int layer) const;
 
-			void *lockRect(int x, int y, int z, Lock lock);
+			void *lockRect(int x, int y, int z, Lock lock);   // Writing dirties the whole buffer
+			void *lockRect(int x, int y, int z, int width, int height, int depth, Lock lock);   // Writing only dirties the given box
 			void unlockRect();
 
+			void *address(int x, int y, int z) const;
+			void markDirty(int x0, int y0, int z0, int x1, int y1, int z1);
+
 			void *buffer;
 			int width;
 			int height;
@@ -274,6 +280,31 @@ namespace sw
 			AtomicInt lock;
 
 			bool dirty;   // Sibling internal/external buffer doesn't match.
+			Rect dirtyRect;   // Part of the sibling which doesn't match, while dirty
+			int dirtyFront;
+			int dirtyBack;
+		};
+
+	public:
+		// One allocation holding the internal buffers of several surfaces, like all levels and faces of an
+		// immutable texture. It's released when the last surface using it is destroyed.
+		class Storage
+		{
+		public:
+			explicit Storage(size_t bytes);
+			Storage(void *buffer, size_t bytes);   // Memory of the caller, which has to outlive the surfaces using it
+
+			void *address(size_t offset) const;
+			void bind();
+			void unbind();
+
+		private:
+			~Storage();
+
+			void *buffer;
+			const size_t bytes;
+			const bool owned;
+			std::atomic<int> bindings;
 		};
 
 	protected:
@@ -299,6 +330,7 @@ namespace sw
 		inline int getSliceP(bool internal = false) const;
 
 		void *lockExternal(int x, int y, int z, Lock lock, Accessor client);
+		void *lockExternal(int x, int y, int z, int width, int height, int depth, Lock lock, Accessor client);   // Writes stay within the box
 		void unlockExternal();
 		inline Format getExternalFormat() const;
 		inline int getExternalPitchB() const;
@@ -313,6 +345,18 @@ namespace sw
 		inline int getInternalPitchP() const;
 		inline int getInternalSliceB() const;
 		inline int getInternalSliceP() const;
+		size_t getInternalSize() const;
+		void setInternalStorage(Storage *storage, size_t offset);   // Before the first lock, instead of allocating the internal buffer
+
+		struct ChromaPlanes   // Of YUV formats, relative to the luma plane returned by lockInternal()
+		{
+			ptrdiff_t offsetCr;
+			ptrdiff_t offsetCb;
+			int pitchB;
+			int stepB;   // Two for semi-planar layouts like NV12, which interleave Cb and Cr
+		};
+
+		virtual ChromaPlanes getChromaPlanes() const;   // YV12, unless the buffer comes from elsewhere
 
 		void *lockStencil(int x, int y, int front, Accessor client);
 		void unlockStencil();
@@ -331,6 +375,23 @@ namespace sw
 		bool isEntire(const Rect& rect) const;
 		Rect getRect() const;
 		void clearDepth(float depth, int x0, int y0, int width, int height);
+		bool hasHierarchicalDepth() const;
+		float *getHierarchicalDepth();   // Maximum depth of each tile of the depth buffer, NaN when unknown
+		int getHierarchicalDepthPitchB() const;
+		Rect beginClear(int x0, int y0, int x1, int y1);     // Returns the tiles which can be cleared lazily, call before locking
+		void endClear(const void *pixel, const Rect &tiles);   // Defers clearing them, call while locked
+		void invalidate(const Rect &rect);   // Contents within the rectangle become undefined and don't have to be preserved
+		bool hasClearTiles() const;
+		unsigned char *getClearTiles();   // Nonzero for each 16x2 pixel tile which still has to be cleared
+		int getClearTilesPitchB() const;
+		unsigned int getClearPattern() const;
+		bool hasSampleTiles() const;
+		unsigned char *getSampleTiles();   // Nonzero for each 16x2 pixel tile whose samples may differ, written by the renderer
+		int getSampleTilesPitchB() const;
+		void setUniformSamples(const Rect &rect);   // All samples were written the same within the rectangle, call while locked
+		void *getTiledBuffer(const void *buffer);   // Copy of the internal buffer in 4x4 texel tiles for sampling, null when not tiled
+		int getTiledPitchP() const;                 // Texels per row of tiles
+		int getTiledSliceP() const;
 		void clearStencil(unsigned char stencil, unsigned char mask, int x0, int y0, int width, int height);
 		void fill(const Color<float> &color, int x0, int y0, int width, int height);
 
@@ -346,6 +407,7 @@ namespace sw
 
 		enum Edge { TOP, BOTTOM, RIGHT, LEFT };
 		void copyCubeEdge(Edge dstEdge, Surface *src, Edge srcEdge);
+		void computeCubeCorners();   // After the edges are copied
 		void computeCubeCorner(int x0, int y0, int x1, int y1);
 
 		bool hasStencil() const;
@@ -384,6 +446,11 @@ namespace sw
 
 		static void setTexturePalette(unsigned int *palette);
 
+		static void setTextureMemoryBudget(size_t bytes);   // For internal copies which can be recreated from the external ones, 0 for unlimited
+		static void trimTextureMemory();   // Evicts the least recently used internal copies that exceed the budget
+		static size_t getTextureMemoryUsage();   // Bytes of internal copies which can be evicted
+		static size_t getResidentBytes(Format format);   // Bytes of all surface buffers of the given format
+
 	private:
 		sw::Resource *resource;
 
@@ -392,6 +459,23 @@ namespace sw
 		typedef unsigned int dword;
 		typedef uint64_t qword;
 
+		enum
+		{
+			MAX_RESOLVE_THREADS = 8,
+			MIN_RESOLVE_SAMPLES = 0x80000,   // Per thread
+			MIN_POOLED_BYTES = 0x10000,      // Smaller buffers come from the heap just as fast
+			MAX_POOLED_BYTES = 0x4000000,    // Memory of destroyed surfaces kept for reuse
+			MAX_POOLED_BUFFERS = 64,
+		};
+
+		struct ResolveTask
+		{
+			Surface *surface;
+			void *source;
+			int y0;
+			int y1;
+		};
+
 		struct DXT1
 		{
 			word c0;
@@ -480,16 +564,35 @@ namespace sw
 		static void decodeEAC(Buffer &internal, Buffer &external, int nbChannels, bool isSigned);
 		static void decodeETC2(Buffer &internal, Buffer &external, int nbAlphaBits, bool isSRGB);
 		static void decodeASTC(Buffer &internal, Buffer &external, int xSize, int ySize, int zSize, bool isSRGB);
+		static void linearizeSRGB8(Buffer &internal, const Rect &rect, int front, int back);   // In place, for decoded 8 bit sRGB formats
+		static void dirtyBlocks(const Buffer &external, int blockWidth, int blockHeight, Rect &rect, int &front, int &back);   // Blocks written since the last decode
 
 		static void update(Buffer &destination, Buffer &source);
 		static void genericUpdate(Buffer &destination, Buffer &source);
-		static void *allocateBuffer(int width, int height, int depth, int border, int samples, Format format);
+		static void *allocateBuffer(int width, int height, int depth, int border, int samples, Format format, bool clear);   // Reuses the memory of destroyed surfaces of the same size
+		static void deallocateBuffer(void *buffer, int width, int height, int depth, int border, int samples, Format format);
+		static void *allocateBuffer(size_t bytes, bool clear);
+		static void deallocateBuffer(void *buffer, size_t bytes);
 		static void memfill4(void *buffer, int pattern, int bytes);
 
 		bool identicalBuffers() const;
+		void syncExternal(Lock lock, Accessor client);
 		Format selectInternalFormat(Format format) const;
 
 		void resolve();
+		void resolve(void *source, int x0, int x1, int y0, int y1);   // Rectangle of the locked internal buffer
+		static void resolveTask(void *parameters);
+		void invalidateHierarchicalDepth();
+		void clearHierarchicalDepth(float depth, int x0, int y0, int x1, int y1);
+		void fillDepth(float *buffer, float depth, int x0, int y0, int x1, int y1);
+		void writeClearTiles();
+		void discardClearTiles(const Rect &tiles);
+		void markSampleTiles();
+		bool isTiled() const;
+		bool isEvictable() const;
+		void trackResidency();
+		void untrackResidency();
+		bool evictInternal();
 
 		Buffer external;
 		Buffer internal;
@@ -499,13 +602,25 @@ namespace sw
 		const bool renderTarget;
 
 		bool dirtyContents;   // Sibling surfaces need updating (mipmaps / cube borders).
+		float *hierarchicalDepth;   // Allocated on first use by the renderer
+		unsigned char *clearTiles;
+		unsigned int clearPattern;   // Cleared value of the pending tiles, repeated to 32 bits
+		bool pendingClears;
+		unsigned char *sampleTiles;
+		bool sampleTilesStale;   // Locked for writing by someone other than the renderer
+		void *tiledBuffer;   // Allocated on first use by the sampler
+		bool tiledDirty;
+		bool renderedTo;     // Not worth re-tiling after each draw
 		unsigned int paletteUsed;
+		unsigned int lastUse;   // Residency clock at the last internal lock, to evict the coldest copies first
+		bool resident;          // Internal copy counts towards the texture memory budget
 
 		static unsigned int *palette;   // FIXME: Not multi-device safe
 		static unsigned int paletteID;
 
 		bool hasParent;
 		bool ownExternal;
+		Storage *internalStorage;   // Shared with other surfaces, never evicted
 	};
 }
 
@@ -80,7 +80,30 @@ namespace sw
 			state.secondModifierAlpha = secondModifierAlpha;
 			state.thirdModifierAlpha = thirdModifierAlpha;
 			state.destinationArgument = destinationArgument;
-			state.texCoordIndex = texCoordIndex;
+
+			// Reset the arguments the operations don't read, so equivalent configurations share a routine
+			int colorArguments = argumentMask(stageOperation);
+			int alphaArguments = (stageOperation == STAGE_DOT3) ? 0 : argumentMask(stageOperationAlpha);
+
+			switch(stageOperationAlpha)
+			{
+			case STAGE_DOT3:
+			case STAGE_MODULATEALPHA_ADDCOLOR:
+			case STAGE_MODULATECOLOR_ADDALPHA:
+			case STAGE_MODULATEINVALPHA_ADDCOLOR:
+			case STAGE_MODULATEINVCOLOR_ADDALPHA:
+				alphaArguments = 0;   // Not valid alpha operations
+				break;
+			default:
+				break;
+			}
+
+			if(!(colorArguments & 0x1)) { state.firstArgument = SOURCE_CURRENT; state.firstModifier = MODIFIER_COLOR; }
+			if(!(colorArguments & 0x2)) { state.secondArgument = SOURCE_CURRENT; state.secondModifier = MODIFIER_COLOR; }
+			if(!(colorArguments & 0x4)) { state.thirdArgument = SOURCE_CURRENT; state.thirdModifier = MODIFIER_COLOR; }
+			if(!(alphaArguments & 0x1)) { state.firstArgumentAlpha = SOURCE_CURRENT; state.firstModifierAlpha = MODIFIER_COLOR; }
+			if(!(alphaArguments & 0x2)) { state.secondArgumentAlpha = SOURCE_CURRENT; state.secondModifierAlpha = MODIFIER_COLOR; }
+			if(!(alphaArguments & 0x4)) { state.thirdArgumentAlpha = SOURCE_CURRENT; state.thirdModifierAlpha = MODIFIER_COLOR; }
 
 			state.cantUnderflow = sampler->hasUnsignedTexture() || !usesTexture();
 			state.usesTexture = usesTexture();
@@ -212,6 +235,29 @@ namespace sw
 		this->destinationArgument = destinationArgument;
 	}
 
+	int TextureStage::argumentMask(StageOperation operation)
+	{
+		switch(operation)
+		{
+		case STAGE_DISABLE:
+		case STAGE_BUMPENVMAP:
+		case STAGE_BUMPENVMAPLUMINANCE:
+			return 0x0;
+		case STAGE_SELECTARG1:
+		case STAGE_PREMODULATE:
+			return 0x1;
+		case STAGE_SELECTARG2:
+			return 0x2;
+		case STAGE_SELECTARG3:
+			return 0x4;
+		case STAGE_MULTIPLYADD:
+		case STAGE_LERP:
+			return 0x7;
+		default:
+			return 0x3;
+		}
+	}
+
 	bool TextureStage::usesColor(SourceArgument source) const
 	{
 		// One argument
@@ -113,7 +113,6 @@ namespace sw
 			unsigned int secondModifierAlpha	: BITS(MODIFIER_LAST);
 			unsigned int thirdModifierAlpha		: BITS(MODIFIER_LAST);
 			unsigned int destinationArgument	: BITS(DESTINATION_LAST);
-			unsigned int texCoordIndex			: BITS(7);
 
 			unsigned int cantUnderflow			: 1;
 			unsigned int usesTexture			: 1;
@@ -161,6 +160,7 @@ namespace sw
 		Uniforms uniforms;   // FIXME: Private
 
 	private:
+		static int argumentMask(StageOperation operation);   // Bit i set if argument i + 1 is read
 		bool usesColor(SourceArgument source) const;
 		bool usesAlpha(SourceArgument source) const;
 		bool uses(SourceArgument source) const;
@@ -61,6 +61,16 @@ namespace sw
 
 	ALIGN(16, struct Vertex
 	{
+		// Projected coordinates
+		int X;
+		int Y;
+		float Z;
+		float W;
+
+		int clipFlags;
+		int padding[3];
+
+		// Outputs follow the fields used by every vertex, so vertices with few outputs span few cache lines
 		union
 		{
 			struct   // Fixed semantics
@@ -81,15 +91,6 @@ namespace sw
 
 			float4 v[MAX_VERTEX_OUTPUTS];   // Generic components using semantic declaration
 		};
-
-		// Projected coordinates
-		int X;
-		int Y;
-		float Z;
-		float W;
-
-		int clipFlags;
-		int padding[3];
 	});
 
 	static_assert((sizeof(Vertex) & 0x0000000F) == 0, "Vertex size not a multiple of 16 bytes (alignment requirement)");
@@ -20,19 +20,51 @@
 #include "Shader/PixelShader.hpp"
 #include "Shader/Constants.hpp"
 #include "Common/Math.hpp"
+#include "Common/Memory.hpp"
 #include "Common/Debug.hpp"
 
 #include <string.h>
 
 namespace sw
 {
+	extern int uniformSpecialization;
+
 	bool precacheVertex = false;
 
+	void VertexCache::init(int size)
+	{
+		int sets = max(size / (4 * WAYS), 1);
+
+		vertex = (Vertex(*)[4])allocate(sets * WAYS * sizeof(Vertex[4]), 16, true, MEMORY_RENDERER);
+		tag = new unsigned int[sets * WAYS];
+		victim = new unsigned int[sets];
+		setMask = sets - 1;
+		misses = 0;
+		drawCall = -1;
+
+		clear();
+	}
+
+	void VertexCache::free()
+	{
+		deallocate(vertex);
+		vertex = nullptr;
+		delete[] tag;
+		tag = nullptr;
+		delete[] victim;
+		victim = nullptr;
+	}
+
 	void VertexCache::clear()
 	{
-		for(int i = 0; i < 16; i++)
+		for(unsigned int set = 0; set <= setMask; set++)
 		{
-			tag[i] = 0x80000000;
+			for(int way = 0; way < WAYS; way++)
+			{
+				tag[set * WAYS + way] = 0x80000000;
+			}
+
+			victim[set] = 0;
 		}
 	}
 
@@ -112,20 +144,16 @@ namespace sw
 		updateBaseMatrix = true;
 		updateProjectionMatrix = true;
 		updateLighting = true;
+		updateLightColors = true;
 
 		for(int i = 0; i < 12; i++)
 		{
 			updateModelMatrix[i] = true;
 		}
-
-		routineCache = 0;
-		setRoutineCacheSize(1024);
 	}
 
 	VertexProcessor::~VertexProcessor()
 	{
-		delete routineCache;
-		routineCache = 0;
 	}
 
 	void VertexProcessor::setInputStream(int index, const Stream &stream)
@@ -191,6 +219,21 @@ namespace sw
 		}
 	}
 
+	bool VertexProcessor::uniformBuffersLocked(byte *const *u, sw::Resource *const uniformBuffers[]) const
+	{
+		for(int i = 0; i < MAX_UNIFORM_BUFFER_BINDINGS; ++i)
+		{
+			const Resource *buffer = uniformBufferInfo[i].buffer;
+
+			if(buffer != uniformBuffers[i] || (buffer && static_cast<const byte*>(buffer->data()) + uniformBufferInfo[i].offset != u[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	void VertexProcessor::setTransformFeedbackBuffer(int index, sw::Resource* buffer, int offset, unsigned int reg, unsigned int row, unsigned int col, unsigned int stride)
 	{
 		transformFeedbackInfo[index].buffer = buffer;
@@ -298,6 +341,8 @@ namespace sw
 			ff.lightDiffuse[light][3] = lightDiffuse.a;
 		}
 		else ASSERT(false);
+
+		updateLightColors = true;
 	}
 
 	void VertexProcessor::setLightSpecular(unsigned int light, const Color<float> &lightSpecular)
@@ -310,6 +355,8 @@ namespace sw
 			ff.lightSpecular[light][3] = lightSpecular.a;
 		}
 		else ASSERT(false);
+
+		updateLightColors = true;
 	}
 
 	void VertexProcessor::setLightAmbient(unsigned int light, const Color<float> &lightAmbient)
@@ -322,6 +369,8 @@ namespace sw
 			ff.lightAmbient[light][3] = lightAmbient.a;
 		}
 		else ASSERT(false);
+
+		updateLightColors = true;
 	}
 
 	void VertexProcessor::setLightAttenuation(unsigned int light, float constant, float linear, float quadratic)
@@ -359,6 +408,11 @@ namespace sw
 		context->instanceID = instanceID;
 	}
 
+	void VertexProcessor::setInstanceCount(int instanceCount)
+	{
+		context->instanceCount = instanceCount;
+	}
+
 	void VertexProcessor::setColorVertexEnable(bool colorVertexEnable)
 	{
 		context->setColorVertexEnable(colorVertexEnable);
@@ -390,6 +444,8 @@ namespace sw
 		ff.globalAmbient[1] = globalAmbient.g;
 		ff.globalAmbient[2] = globalAmbient.b;
 		ff.globalAmbient[3] = globalAmbient.a;
+
+		updateLightColors = true;
 	}
 
 	void VertexProcessor::setMaterialEmission(const Color<float> &emission)
@@ -406,6 +462,8 @@ namespace sw
 		ff.materialAmbient[1] = materialAmbient.g;
 		ff.materialAmbient[2] = materialAmbient.b;
 		ff.materialAmbient[3] = materialAmbient.a;
+
+		updateLightColors = true;
 	}
 
 	void VertexProcessor::setMaterialDiffuse(const Color<float> &diffuseColor)
@@ -414,6 +472,8 @@ namespace sw
 		ff.materialDiffuse[1] = diffuseColor.g;
 		ff.materialDiffuse[2] = diffuseColor.b;
 		ff.materialDiffuse[3] = diffuseColor.a;
+
+		updateLightColors = true;
 	}
 
 	void VertexProcessor::setMaterialSpecular(const Color<float> &specularColor)
@@ -422,6 +482,8 @@ namespace sw
 		ff.materialSpecular[1] = specularColor.g;
 		ff.materialSpecular[2] = specularColor.b;
 		ff.materialSpecular[3] = specularColor.a;
+
+		updateLightColors = true;
 	}
 
 	void VertexProcessor::setMaterialShininess(float specularPower)
@@ -896,10 +958,27 @@ namespace sw
 		updateMatrix = false;
 	}
 
+	void VertexProcessor::updateLightMaterial()
+	{
+		for(int i = 0; i < 8; i++)
+		{
+			for(int c = 0; c < 4; c++)
+			{
+				ff.lightAmbientMaterial[i][c] = ff.lightAmbient[i][c] * ff.materialAmbient[c];
+				ff.lightDiffuseMaterial[i][c] = ff.lightDiffuse[i][c] * ff.materialDiffuse[c];
+				ff.lightSpecularMaterial[i][c] = ff.lightSpecular[i][c] * ff.materialSpecular[c];
+			}
+		}
+
+		for(int c = 0; c < 4; c++)
+		{
+			ff.globalAmbientMaterial[c] = ff.globalAmbient[c] * ff.materialAmbient[c];
+		}
+	}
+
 	void VertexProcessor::setRoutineCacheSize(int cacheSize)
 	{
-		delete routineCache;
-		routineCache = new RoutineCache<State>(clamp(cacheSize, 1, 65536), precacheVertex ? "sw-vertex" : 0);
+		routineCache = RoutineCache<State, State::Hash>::shared(clamp(cacheSize, 1, 65536), precacheVertex ? "sw-vertex" : 0);
 	}
 
 	const VertexProcessor::State VertexProcessor::update(DrawType drawType)
@@ -921,6 +1000,12 @@ namespace sw
 
 				updateLighting = false;
 			}
+
+			if(updateLightColors)
+			{
+				updateLightMaterial();
+				updateLightColors = false;
+			}
 		}
 
 		State state;
@@ -934,6 +1019,11 @@ namespace sw
 			state.shaderID = 0;
 		}
 
+		if(context->vertexShader && uniformSpecialization > 0)
+		{
+			state.specializedUniforms = context->vertexShader->specializeConstants(c, uniformSpecialization, state.specializedValue);
+		}
+
 		state.fixedFunction = !context->vertexShader && context->pixelShaderModel() < 0x0300;
 		state.textureSampling = context->vertexShader ? context->vertexShader->containsTextureSampling() : false;
 		state.positionRegister = context->vertexShader ? context->vertexShader->getPositionRegister() : Pos;
@@ -986,6 +1076,7 @@ namespace sw
 			state.input[i].count = context->input[i].count;
 			state.input[i].normalized = context->input[i].normalized;
 			state.input[i].attribType = context->vertexShader ? context->vertexShader->getAttribType(i) : VertexShader::ATTRIBTYPE_FLOAT;
+			state.input[i].instanced = context->input[i].divisor != 0 && context->instanceCount > 1;
 		}
 
 		if(!context->vertexShader)
@@ -997,6 +1088,32 @@ namespace sw
 				state.textureState[i].textureTransformCountActive = context->textureTransformCountActive(i);
 				state.textureState[i].texCoordIndexActive = context->texCoordIndexActive(i);
 			}
+
+			// Canonicalize the state which the enabled features don't read, so equivalent configurations share a routine
+			bool normalUsed = state.vertexLightingActive;
+			bool reflectionUsed = false;
+
+			for(int i = 0; i < 8; i++)
+			{
+				TexGen texGen = state.textureState[i].texGenActive;
+
+				normalUsed = normalUsed || texGen == TEXGEN_NORMAL || texGen == TEXGEN_REFLECTION || texGen == TEXGEN_SPHEREMAP;
+				reflectionUsed = reflectionUsed || texGen == TEXGEN_REFLECTION || texGen == TEXGEN_SPHEREMAP;
+			}
+
+			state.vertexNormalActive = state.vertexNormalActive && normalUsed;
+			if(!state.vertexNormalActive) state.input[Normal] = State::Input();
+			state.normalizeNormals = state.normalizeNormals && state.vertexNormalActive;
+			state.localViewerActive = state.localViewerActive && state.vertexNormalActive && reflectionUsed;
+
+			if(!state.vertexLightingActive)
+			{
+				state.vertexLightActive = 0;
+				state.vertexDiffuseMaterialSourceActive = MATERIAL_MATERIAL;
+				state.vertexSpecularMaterialSourceActive = MATERIAL_MATERIAL;
+				state.vertexAmbientMaterialSourceActive = MATERIAL_MATERIAL;
+				state.vertexEmissiveMaterialSourceActive = MATERIAL_MATERIAL;
+			}
 		}
 		else
 		{
@@ -1089,30 +1206,100 @@ namespace sw
 		return state;
 	}
 
-	Routine *VertexProcessor::routine(const State &state)
+	Routine *VertexProcessor::routine(const State &state, OptimizationLevel level)
 	{
-		Routine *routine = routineCache->query(state);
+		Routine *routine = routineCache->acquire(state);
+		RoutineTelemetry::recordCacheQuery("VertexRoutine", routine != nullptr);
 
-		if(!routine)   // Create one
+		if(routine)
 		{
-			VertexRoutine *generator = nullptr;
+			return routine;
+		}
+
+		State key;
+		uint64_t shaderFingerprint = 0;
 
-			if(state.fixedFunction)
+		if(routineCache->isPersistent())
+		{
+			key = state;
+			key.shaderID = 0;
+			key.hash = 0;
+			shaderFingerprint = state.fixedFunction ? 0 : context->vertexShader->getFingerprint();
+
+			routine = routineCache->load(key, shaderFingerprint);
+
+			if(routine)
+			{
+				return routineCache->acquire(state, routine);
+			}
+		}
+
+		routine = generate(state, level);
+
+		Routine *cached = routineCache->acquire(state, routine);
+
+		if(cached == routine)
+		{
+			if(level == OptimizationQuick)
 			{
-				generator = new VertexPipeline(state);
+				routineCache->addQuick(routine);   // Not stored, the optimized one replaces it
 			}
 			else
 			{
-				generator = new VertexProgram(state, context->vertexShader);
+				routineCache->store(key, shaderFingerprint, routine);
 			}
+		}
 
-			generator->generate();
-			routine = (*generator)(L"VertexRoutine_%0.8X", state.shaderID);
-			delete generator;
+		return cached;
+	}
 
-			routineCache->add(state, routine);
+	Routine *VertexProcessor::cachedRoutine(const State &state)
+	{
+		return routineCache->acquire(state);
+	}
+
+	bool VertexProcessor::isHot(Routine *routine, int threshold)
+	{
+		return routineCache->countUse(routine, threshold);
+	}
+
+	Routine *VertexProcessor::optimizedRoutine(const State &state)
+	{
+		Routine *routine = routineCache->replace(state, generate(state, OptimizationHot));
+
+		if(routineCache->isPersistent())
+		{
+			State key = state;
+			key.shaderID = 0;
+			key.hash = 0;
+
+			routineCache->store(key, state.fixedFunction ? 0 : context->vertexShader->getFingerprint(), routine);
+		}
+
+		return routine;
+	}
+
+	Routine *VertexProcessor::generate(const State &state, OptimizationLevel level)
+	{
+		VertexRoutine *generator = nullptr;
+
+		Nucleus::setOptimizationLevel(level);
+
+		if(state.fixedFunction)
+		{
+			generator = new VertexPipeline(state);
+		}
+		else
+		{
+			generator = new VertexProgram(state, context->vertexShader);
 		}
 
+		generator->generate();
+		Routine *routine = (*generator)(L"VertexRoutine_%0.8X", state.shaderID);
+		delete generator;
+
+		Nucleus::setOptimizationLevel(OptimizationDefault);
+
 		return routine;
 	}
 }
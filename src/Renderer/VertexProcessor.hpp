@@ -24,12 +24,20 @@ namespace sw
 {
 	struct DrawData;
 
-	struct VertexCache   // FIXME: Variable size
+	struct VertexCache   // Set associative, lines of four vertices
 	{
+		enum { WAYS = 2 };   // VertexRoutine::generate() picks between exactly two ways
+
+		void init(int size);   // Number of vertices, power of two
+		void free();
 		void clear();
 
-		Vertex vertex[16][4];
-		unsigned int tag[16];
+		Vertex (*vertex)[4];     // WAYS consecutive lines per set
+		unsigned int *tag;       // Index of the first vertex of each line
+		unsigned int *victim;    // Way to replace next, per set
+		unsigned int setMask;
+
+		unsigned int misses;     // Lookups which had to transform their line, during the last routine call
 
 		int drawCall;
 	};
@@ -39,6 +47,9 @@ namespace sw
 		unsigned int vertexCount;
 		unsigned int primitiveStart;
 		VertexCache vertexCache;
+
+		int instanceID;
+		unsigned int instanceOffset[MAX_VERTEX_INPUTS];   // Bytes to the current instance's element, of instanced streams
 	};
 
 	class VertexProcessor
@@ -49,6 +60,8 @@ namespace sw
 			unsigned int computeHash();
 
 			uint64_t shaderID;
+			unsigned int specializedUniforms;   // Specializable constants of the shader folded into the routine
+			unsigned int specializedValue[MAX_SPECIALIZED_UNIFORMS];
 
 			bool fixedFunction             : 1;   // TODO: Eliminate by querying shader.
 			bool textureSampling           : 1;   // TODO: Eliminate by querying shader.
@@ -104,6 +117,7 @@ namespace sw
 				unsigned int count : 3;
 				bool normalized    : 1;
 				unsigned int attribType : BITS(VertexShader::ATTRIBTYPE_LAST);
+				bool instanced     : 1;   // Offset per instance within the draw call
 			};
 
 			struct Output
@@ -146,6 +160,11 @@ namespace sw
 			bool operator==(const State &state) const;
 
 			unsigned int hash;
+
+			struct Hash   // Computed when the state is set up
+			{
+				unsigned int operator()(const State &state) const { return state.hash; }
+			};
 		};
 
 		struct FixedFunction
@@ -169,6 +188,12 @@ namespace sw
 			float4 globalAmbient;
 			float4 materialEmission;
 			float4 materialAmbient;
+
+			// Light colors multiplied by the material's, for material sources which aren't vertex colors
+			float4 lightAmbientMaterial[8];
+			float4 lightDiffuseMaterial[8];
+			float4 lightSpecularMaterial[8];
+			float4 globalAmbientMaterial;
 		};
 
 		struct PointSprite
@@ -196,6 +221,7 @@ namespace sw
 
 		void setUniformBuffer(int index, sw::Resource* uniformBuffer, int offset);
 		void lockUniformBuffers(byte** u, sw::Resource* uniformBuffers[]);
+		bool uniformBuffersLocked(byte *const *u, sw::Resource *const uniformBuffers[]) const;   // Whether lockUniformBuffers() returned the current bindings
 
 		void setTransformFeedbackBuffer(int index, sw::Resource* transformFeedbackBuffer, int offset, unsigned int reg, unsigned int row, unsigned int col, unsigned int stride);
 		void lockTransformFeedbackBuffers(byte** t, unsigned int* v, unsigned int* r, unsigned int* c, unsigned int* s, sw::Resource* transformFeedbackBuffers[]);
@@ -221,6 +247,7 @@ namespace sw
 		void setLightRange(unsigned int light, float lightRange);
 
 		void setInstanceID(int instanceID);
+		void setInstanceCount(int instanceCount);
 
 		void setFogEnable(bool fogEnable);
 		void setVertexFogMode(FogMode fogMode);
@@ -285,7 +312,10 @@ namespace sw
 		const Matrix &getViewTransform();
 
 		const State update(DrawType drawType);
-		Routine *routine(const State &state);
+		Routine *routine(const State &state, OptimizationLevel level = OptimizationDefault);   // Bound, has to be unbound by the caller
+		Routine *cachedRoutine(const State &state);      // Null when the routine still has to be generated
+		bool isHot(Routine *routine, int threshold);     // Counts a draw using a routine generated with OptimizationQuick
+		Routine *optimizedRoutine(const State &state);   // Regenerates a hot routine, replacing the cached one
 
 		bool isFixedFunction();
 		void setRoutineCacheSize(int cacheSize);
@@ -325,10 +355,12 @@ namespace sw
 		void setTransform(const Matrix &M, int i);
 		void setCameraTransform(const Matrix &M, int i);
 		void setNormalTransform(const Matrix &M, int i);
+		void updateLightMaterial();
+		Routine *generate(const State &state, OptimizationLevel level);
 
 		Context *const context;
 
-		RoutineCache<State> *routineCache;
+		std::shared_ptr<RoutineCache<State, State::Hash>> routineCache;   // Shared by all renderers, set by the renderer's configuration
 
 	protected:
 		Matrix M[12];      // Model/Geometry/World matrix
@@ -346,6 +378,7 @@ namespace sw
 		bool updateBaseMatrix;
 		bool updateProjectionMatrix;
 		bool updateLighting;
+		bool updateLightColors;   // Light or material colors changed
 	};
 }
 
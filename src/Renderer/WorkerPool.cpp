@@ -0,0 +1,409 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "WorkerPool.hpp"
+
+#include "Common/CPUID.hpp"
+#include "Common/Math.hpp"
+#include "Common/Thread.hpp"
+#include "Common/Timer.hpp"
+#include "Common/TraceEvents.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace sw
+{
+	namespace
+	{
+		// Bounds for the number of polls an idle thread makes before it parks
+		const int minSpinCount = 16;
+		const int maxSpinCount = 16384;
+
+		const int64_t accountingPeriod = 100000000;   // Nanoseconds over which CPU shares are enforced
+		const int idleTimeout = 1000;                  // Milliseconds a parked thread waits for work before it exits
+
+		struct Job
+		{
+			WorkerPool::Client *client;
+			WorkerPool::Function function;
+			void *object;
+			int slot;
+		};
+
+		struct Pool
+		{
+			std::mutex lifetimeMutex;   // Serializes acquire() and release()
+			int users = 0;
+
+			std::mutex mutex;   // Guards the members below
+			std::deque<Job> queue;
+			std::vector<Thread*> thread;    // Up to the largest thread count acquired, null while not running
+			std::vector<Event*> wakeup;     // One per thread
+			std::vector<int> parked;        // Threads waiting for their wakeup event
+			std::vector<Thread*> retired;   // Threads which exited after idling, still to be joined
+			std::vector<int> processor;     // Grouped by NUMA node, empty unless threads are pinned
+			int running = 0;
+			bool exiting = false;
+
+			std::atomic<int> queued{0};     // Size of the queue, read without holding the lock
+			std::atomic<int> spinning{0};   // Threads polling the queue
+		};
+
+		// Never destroyed, so threads of contexts which are still alive at process exit don't use a destroyed pool
+		Pool &pool()
+		{
+			static Pool *pool = new Pool();
+
+			return *pool;
+		}
+
+		// Must be called while holding the pool's lock, with a non-empty queue
+		Job takeJob(Pool &pool)
+		{
+			int64_t now = Timer::nanoseconds();
+			int threadCount = (int)pool.thread.size();
+			size_t best = 0;
+			int bestRank = 0x7FFFFFFF;
+
+			for(size_t i = 0; i < pool.queue.size(); i++)
+			{
+				WorkerPool::Client *client = pool.queue[i].client;
+				int rank = client->getPriority() + (client->overBudget(now, threadCount) ? PRIORITY_LOW + 1 : 0);
+
+				if(rank < bestRank)
+				{
+					best = i;
+					bestRank = rank;
+				}
+			}
+
+			Job job = pool.queue[best];
+			pool.queue.erase(pool.queue.begin() + best);
+
+			return job;
+		}
+	}
+
+	WorkerPool::Client::Client()
+	{
+		priority = PRIORITY_MEDIUM;
+		cpuShare = 100;
+		threadTime = 0;
+
+		periodStart = Timer::nanoseconds();
+		periodThreadTime = 0;
+		recentShare = 0;
+	}
+
+	void WorkerPool::Client::setPriority(SchedulingPriority priority)
+	{
+		this->priority = priority;
+	}
+
+	void WorkerPool::Client::setCpuShare(int percent)
+	{
+		cpuShare = sw::clamp(percent, 1, 100);
+	}
+
+	SchedulingPriority WorkerPool::Client::getPriority() const
+	{
+		return (SchedulingPriority)priority.load();
+	}
+
+	int WorkerPool::Client::getCpuShare() const
+	{
+		return cpuShare;
+	}
+
+	void WorkerPool::Client::addThreadTime(int64_t nanoseconds)
+	{
+		threadTime += nanoseconds;
+	}
+
+	int64_t WorkerPool::Client::getThreadTime() const
+	{
+		return threadTime;
+	}
+
+	int WorkerPool::Client::getRecentShare()
+	{
+		Pool &pool = sw::pool();
+		std::lock_guard<std::mutex> lock(pool.mutex);
+
+		overBudget(Timer::nanoseconds(), (int)pool.thread.size());
+
+		return recentShare;
+	}
+
+	bool WorkerPool::Client::overBudget(int64_t now, int threadCount)
+	{
+		int64_t elapsed = now - periodStart;
+
+		if(elapsed >= accountingPeriod)
+		{
+			int64_t capacity = elapsed * sw::max(threadCount, 1);
+			recentShare = (int)((threadTime - periodThreadTime) * 1000 / capacity);
+
+			periodStart = now;
+			periodThreadTime = threadTime;
+		}
+
+		return cpuShare < 100 && (threadTime - periodThreadTime) * 100 > cpuShare * accountingPeriod * threadCount;
+	}
+
+	void WorkerPool::acquire(int threadCount, bool pinThreads)
+	{
+		Pool &pool = sw::pool();
+		std::lock_guard<std::mutex> lifetimeLock(pool.lifetimeMutex);
+
+		pool.users++;
+
+		// Consecutive threads stay on the same node
+		std::vector<int> processor;
+
+		if(pinThreads)
+		{
+			int capacity = CPUID::coreCount();
+			std::vector<int> node(capacity);
+			processor.resize(capacity);
+
+			processor.resize(CPUID::affinityProcessors(processor.data(), node.data(), capacity));
+		}
+
+		// Threads are only started once slots are waiting for them
+		std::lock_guard<std::mutex> lock(pool.mutex);
+
+		pool.exiting = false;
+
+		if(pool.processor.empty())
+		{
+			pool.processor = processor;
+		}
+
+		while((int)pool.thread.size() < threadCount)
+		{
+			pool.thread.push_back(nullptr);
+			pool.wakeup.push_back(new Event());
+		}
+	}
+
+	void WorkerPool::release()
+	{
+		Pool &pool = sw::pool();
+		std::lock_guard<std::mutex> lifetimeLock(pool.lifetimeMutex);
+
+		if(--pool.users > 0)
+		{
+			return;
+		}
+
+		// All slots have retired, so every thread is idle
+		std::vector<Thread*> threads;
+
+		{
+			std::lock_guard<std::mutex> lock(pool.mutex);
+			pool.exiting = true;
+			pool.parked.clear();
+
+			for(Thread *thread : pool.thread)
+			{
+				if(thread)
+				{
+					threads.push_back(thread);
+				}
+			}
+
+			threads.insert(threads.end(), pool.retired.begin(), pool.retired.end());
+			pool.retired.clear();
+		}
+
+		for(Event *wakeup : pool.wakeup)
+		{
+			wakeup->signal();
+		}
+
+		for(Thread *thread : threads)
+		{
+			thread->join();
+			delete thread;
+		}
+
+		for(Event *wakeup : pool.wakeup)
+		{
+			delete wakeup;
+		}
+
+		std::lock_guard<std::mutex> lock(pool.mutex);
+		pool.thread.clear();
+		pool.wakeup.clear();
+		pool.processor.clear();
+		pool.running = 0;
+	}
+
+	void WorkerPool::submit(Client *client, Function function, void *object, int slot)
+	{
+		Pool &pool = sw::pool();
+		Event *wakeup = nullptr;
+		std::vector<Thread*> retired;
+
+		{
+			std::lock_guard<std::mutex> lock(pool.mutex);
+
+			pool.queue.push_back({client, function, object, slot});
+			pool.queued++;
+
+			if(!pool.parked.empty())
+			{
+				wakeup = pool.wakeup[pool.parked.back()];
+				pool.parked.pop_back();
+			}
+			else if((int)pool.queue.size() > pool.spinning && pool.running < (int)pool.thread.size())
+			{
+				// No thread is about to take the slot, so start one
+				int index = 0;
+
+				while(pool.thread[index])
+				{
+					index++;
+				}
+
+				Thread *thread = new Thread(threadFunction, (void*)(intptr_t)index);
+
+				if(!pool.processor.empty())
+				{
+					thread->pin(pool.processor[index % pool.processor.size()]);
+				}
+
+				pool.thread[index] = thread;
+				pool.running++;
+			}
+
+			retired.swap(pool.retired);
+		}
+
+		if(wakeup)
+		{
+			wakeup->signal();
+		}
+
+		for(Thread *thread : retired)
+		{
+			thread->join();
+			delete thread;
+		}
+	}
+
+	bool WorkerPool::isContended()
+	{
+		return pool().queued.load(std::memory_order_relaxed) > 0;
+	}
+
+	void WorkerPool::threadFunction(void *parameters)
+	{
+		int index = (int)(intptr_t)parameters;
+		Pool &pool = sw::pool();
+
+		if(TraceEvents::isEnabled())
+		{
+			char name[32];
+			sprintf(name, "Renderer worker %d", index);
+			TraceEvents::setThreadName(name);
+		}
+
+		int spinLimit = CPUID::coreCount() > 1 ? maxSpinCount : 0;
+		int spinCount = sw::min(minSpinCount, spinLimit);
+
+		while(true)
+		{
+			// Poll for a while before parking, longer when work tends to arrive while polling
+			if(spinCount > 0 && pool.queued.load(std::memory_order_relaxed) == 0)
+			{
+				TraceEvent event("Spinning", "scheduler");
+				pool.spinning++;
+
+				for(int spin = 0; spin < spinCount && pool.queued.load(std::memory_order_relaxed) == 0; spin++)
+				{
+					nop();
+				}
+
+				pool.spinning--;
+			}
+
+			std::unique_lock<std::mutex> lock(pool.mutex);
+
+			if(pool.exiting)
+			{
+				return;
+			}
+
+			if(pool.queue.empty())
+			{
+				spinCount = sw::max(spinCount / 2, sw::min(minSpinCount, spinLimit));
+
+				pool.parked.push_back(index);
+				Event *wakeup = pool.wakeup[index];
+
+				lock.unlock();
+
+				TraceEvent event("Suspended", "scheduler");
+
+				// Taken off the parked list by whoever signals it, a stale signal just repeats the search
+				if(!wakeup->wait(idleTimeout))
+				{
+					lock.lock();
+
+					auto parked = std::find(pool.parked.begin(), pool.parked.end(), index);
+
+					if(parked != pool.parked.end())   // Not signaled while timing out
+					{
+						pool.parked.erase(parked);
+						pool.retired.push_back(pool.thread[index]);
+						pool.thread[index] = nullptr;
+						pool.running--;
+
+						return;
+					}
+
+					lock.unlock();
+				}
+
+				continue;
+			}
+
+			spinCount = sw::min(spinCount * 2, spinLimit);
+
+			Job job = takeJob(pool);
+			pool.queued--;
+
+			lock.unlock();
+
+			// Slots which yield go behind the ones waiting, but keep this thread when no other slot took their place
+			while(job.function(job.object, job.slot))
+			{
+				lock.lock();
+
+				pool.queue.push_back(job);
+				job = takeJob(pool);
+
+				lock.unlock();
+			}
+		}
+	}
+}
@@ -0,0 +1,81 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_WorkerPool_hpp
+#define sw_WorkerPool_hpp
+
+#include <atomic>
+#include <stdint.h>
+
+namespace sw
+{
+	enum SchedulingPriority
+	{
+		PRIORITY_HIGH,
+		PRIORITY_MEDIUM,
+		PRIORITY_LOW
+	};
+
+	// Process-wide threads which run the worker slots of all renderers, so that the number of threads
+	// follows the hardware instead of the number of contexts. Threads are started as slots wait for
+	// them, and exit after idling for a second. Waiting slots get a thread by priority, except that
+	// clients which used up their CPU share only get threads no other client waits for. Within the
+	// same priority slots run in the order they were submitted, and a busy slot yields its thread
+	// when others are waiting, so each renderer gets a fair share of the threads.
+	class WorkerPool
+	{
+	public:
+		// Scheduling policy and thread time accounting of one renderer's slots
+		class Client
+		{
+		public:
+			Client();
+
+			void setPriority(SchedulingPriority priority);
+			void setCpuShare(int percent);   // Of the pool's threads while other clients wait, 100 for no limit
+			SchedulingPriority getPriority() const;
+			int getCpuShare() const;
+
+			void addThreadTime(int64_t nanoseconds);   // Called by the slots as they stop running
+			int64_t getThreadTime() const;             // Nanoseconds, since the client was created
+			int getRecentShare();                      // Of the pool's threads during the last accounting period, in per mille
+
+			bool overBudget(int64_t now, int threadCount);   // Must be called while holding the pool's lock
+
+		private:
+			std::atomic<int> priority;
+			std::atomic<int> cpuShare;
+			std::atomic<int64_t> threadTime;
+
+			int64_t periodStart;        // Timer::nanoseconds() at the start of the current accounting period
+			int64_t periodThreadTime;   // Thread time at the start of the current accounting period
+			int recentShare;
+		};
+
+		// Runs the slot until it has no work left and returns false, or returns true to be queued
+		// behind the waiting slots. A slot must only be submitted again after its function returned.
+		typedef bool (*Function)(void *object, int slot);
+
+		static void acquire(int threadCount, bool pinThreads);   // Lets the pool run up to threadCount threads
+		static void release();   // Joins the threads when the last user releases the pool
+
+		static void submit(Client *client, Function function, void *object, int slot);
+		static bool isContended();   // Submitted slots are waiting for a thread
+
+	private:
+		static void threadFunction(void *parameters);
+	};
+}
+
+#endif   // sw_WorkerPool_hpp
@@ -1,4 +1,4 @@
-// Copyright 2016 The SwiftShader Authors. All Rights Reserved.
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -12,351 +12,2113 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "Constants.hpp"
-
-#include "Common/Math.hpp"
-#include "Common/Half.hpp"
+// Generated by generate_constants.py, do not edit.
 
-#include <memory.h>
+#include "Constants.hpp"
 
 namespace sw
 {
-	Constants constants;
-
-	Constants::Constants()
+	const Constants constants =   // Declared extern in Constants.hpp, so it gets external linkage
 	{
-		static const unsigned int transposeBit0[16] =
-		{
-			0x00000000,
-			0x00000001,
-			0x00000010,
-			0x00000011,
-			0x00000100,
-			0x00000101,
-			0x00000110,
-			0x00000111,
-			0x00001000,
-			0x00001001,
-			0x00001010,
-			0x00001011,
-			0x00001100,
-			0x00001101,
-			0x00001110,
-			0x00001111
-		};
-
-		static const unsigned int transposeBit1[16] =
-		{
-			0x00000000,
-			0x00000002,
-			0x00000020,
-			0x00000022,
-			0x00000200,
-			0x00000202,
-			0x00000220,
-			0x00000222,
-			0x00002000,
-			0x00002002,
-			0x00002020,
-			0x00002022,
-			0x00002200,
-			0x00002202,
-			0x00002220,
-			0x00002222
-		};
-
-		static const unsigned int transposeBit2[16] =
-		{
-			0x00000000,
-			0x00000004,
-			0x00000040,
-			0x00000044,
-			0x00000400,
-			0x00000404,
-			0x00000440,
-			0x00000444,
-			0x00004000,
-			0x00004004,
-			0x00004040,
-			0x00004044,
-			0x00004400,
-			0x00004404,
-			0x00004440,
-			0x00004444
-		};
-
-		memcpy(&this->transposeBit0, transposeBit0, sizeof(transposeBit0));
-		memcpy(&this->transposeBit1, transposeBit1, sizeof(transposeBit1));
-		memcpy(&this->transposeBit2, transposeBit2, sizeof(transposeBit2));
-
-		static const ushort4 cWeight[17] =
-		{
-			{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF},   // 0xFFFF / 1  = 0xFFFF
-			{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF},   // 0xFFFF / 1  = 0xFFFF
-			{0x8000, 0x8000, 0x8000, 0x8000},   // 0xFFFF / 2  = 0x8000
-			{0x5555, 0x5555, 0x5555, 0x5555},   // 0xFFFF / 3  = 0x5555
-			{0x4000, 0x4000, 0x4000, 0x4000},   // 0xFFFF / 4  = 0x4000
-			{0x3333, 0x3333, 0x3333, 0x3333},   // 0xFFFF / 5  = 0x3333
-			{0x2AAA, 0x2AAA, 0x2AAA, 0x2AAA},   // 0xFFFF / 6  = 0x2AAA
-			{0x2492, 0x2492, 0x2492, 0x2492},   // 0xFFFF / 7  = 0x2492
-			{0x2000, 0x2000, 0x2000, 0x2000},   // 0xFFFF / 8  = 0x2000
-			{0x1C71, 0x1C71, 0x1C71, 0x1C71},   // 0xFFFF / 9  = 0x1C71
-			{0x1999, 0x1999, 0x1999, 0x1999},   // 0xFFFF / 10 = 0x1999
-			{0x1745, 0x1745, 0x1745, 0x1745},   // 0xFFFF / 11 = 0x1745
-			{0x1555, 0x1555, 0x1555, 0x1555},   // 0xFFFF / 12 = 0x1555
-			{0x13B1, 0x13B1, 0x13B1, 0x13B1},   // 0xFFFF / 13 = 0x13B1
-			{0x1249, 0x1249, 0x1249, 0x1249},   // 0xFFFF / 14 = 0x1249
-			{0x1111, 0x1111, 0x1111, 0x1111},   // 0xFFFF / 15 = 0x1111
-			{0x1000, 0x1000, 0x1000, 0x1000},   // 0xFFFF / 16 = 0x1000
-		};
-
-		static const float4 uvWeight[17] =
-		{
-			{1.0f / 1.0f,  1.0f / 1.0f,  1.0f / 1.0f,  1.0f / 1.0f},
-			{1.0f / 1.0f,  1.0f / 1.0f,  1.0f / 1.0f,  1.0f / 1.0f},
-			{1.0f / 2.0f,  1.0f / 2.0f,  1.0f / 2.0f,  1.0f / 2.0f},
-			{1.0f / 3.0f,  1.0f / 3.0f,  1.0f / 3.0f,  1.0f / 3.0f},
-			{1.0f / 4.0f,  1.0f / 4.0f,  1.0f / 4.0f,  1.0f / 4.0f},
-			{1.0f / 5.0f,  1.0f / 5.0f,  1.0f / 5.0f,  1.0f / 5.0f},
-			{1.0f / 6.0f,  1.0f / 6.0f,  1.0f / 6.0f,  1.0f / 6.0f},
-			{1.0f / 7.0f,  1.0f / 7.0f,  1.0f / 7.0f,  1.0f / 7.0f},
-			{1.0f / 8.0f,  1.0f / 8.0f,  1.0f / 8.0f,  1.0f / 8.0f},
-			{1.0f / 9.0f,  1.0f / 9.0f,  1.0f / 9.0f,  1.0f / 9.0f},
-			{1.0f / 10.0f, 1.0f / 10.0f, 1.0f / 10.0f, 1.0f / 10.0f},
-			{1.0f / 11.0f, 1.0f / 11.0f, 1.0f / 11.0f, 1.0f / 11.0f},
-			{1.0f / 12.0f, 1.0f / 12.0f, 1.0f / 12.0f, 1.0f / 12.0f},
-			{1.0f / 13.0f, 1.0f / 13.0f, 1.0f / 13.0f, 1.0f / 13.0f},
-			{1.0f / 14.0f, 1.0f / 14.0f, 1.0f / 14.0f, 1.0f / 14.0f},
-			{1.0f / 15.0f, 1.0f / 15.0f, 1.0f / 15.0f, 1.0f / 15.0f},
-			{1.0f / 16.0f, 1.0f / 16.0f, 1.0f / 16.0f, 1.0f / 16.0f},
-		};
-
-		static const float4 uvStart[17] =
-		{
-			{-0.0f / 2.0f,   -0.0f / 2.0f,   -0.0f / 2.0f,   -0.0f / 2.0f},
-			{-0.0f / 2.0f,   -0.0f / 2.0f,   -0.0f / 2.0f,   -0.0f / 2.0f},
-			{-1.0f / 4.0f,   -1.0f / 4.0f,   -1.0f / 4.0f,   -1.0f / 4.0f},
-			{-2.0f / 6.0f,   -2.0f / 6.0f,   -2.0f / 6.0f,   -2.0f / 6.0f},
-			{-3.0f / 8.0f,   -3.0f / 8.0f,   -3.0f / 8.0f,   -3.0f / 8.0f},
-			{-4.0f / 10.0f,  -4.0f / 10.0f,  -4.0f / 10.0f,  -4.0f / 10.0f},
-			{-5.0f / 12.0f,  -5.0f / 12.0f,  -5.0f / 12.0f,  -5.0f / 12.0f},
-			{-6.0f / 14.0f,  -6.0f / 14.0f,  -6.0f / 14.0f,  -6.0f / 14.0f},
-			{-7.0f / 16.0f,  -7.0f / 16.0f,  -7.0f / 16.0f,  -7.0f / 16.0f},
-			{-8.0f / 18.0f,  -8.0f / 18.0f,  -8.0f / 18.0f,  -8.0f / 18.0f},
-			{-9.0f / 20.0f,  -9.0f / 20.0f,  -9.0f / 20.0f,  -9.0f / 20.0f},
-			{-10.0f / 22.0f, -10.0f / 22.0f, -10.0f / 22.0f, -10.0f / 22.0f},
-			{-11.0f / 24.0f, -11.0f / 24.0f, -11.0f / 24.0f, -11.0f / 24.0f},
-			{-12.0f / 26.0f, -12.0f / 26.0f, -12.0f / 26.0f, -12.0f / 26.0f},
-			{-13.0f / 28.0f, -13.0f / 28.0f, -13.0f / 28.0f, -13.0f / 28.0f},
-			{-14.0f / 30.0f, -14.0f / 30.0f, -14.0f / 30.0f, -14.0f / 30.0f},
-			{-15.0f / 32.0f, -15.0f / 32.0f, -15.0f / 32.0f, -15.0f / 32.0f},
-		};
-
-		memcpy(&this->cWeight, cWeight, sizeof(cWeight));
-		memcpy(&this->uvWeight, uvWeight, sizeof(uvWeight));
-		memcpy(&this->uvStart, uvStart, sizeof(uvStart));
-
-		static const unsigned int occlusionCount[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
-
-		memcpy(&this->occlusionCount, &occlusionCount, sizeof(occlusionCount));
-
-		for(int i = 0; i < 16; i++)
-		{
-			maskB4Q[i][0] = -(i >> 0 & 1);
-			maskB4Q[i][1] = -(i >> 1 & 1);
-			maskB4Q[i][2] = -(i >> 2 & 1);
-			maskB4Q[i][3] = -(i >> 3 & 1);
-			maskB4Q[i][4] = -(i >> 0 & 1);
-			maskB4Q[i][5] = -(i >> 1 & 1);
-			maskB4Q[i][6] = -(i >> 2 & 1);
-			maskB4Q[i][7] = -(i >> 3 & 1);
-
-			invMaskB4Q[i][0] = ~maskB4Q[i][0];
-			invMaskB4Q[i][1] = ~maskB4Q[i][1];
-			invMaskB4Q[i][2] = ~maskB4Q[i][2];
-			invMaskB4Q[i][3] = ~maskB4Q[i][3];
-			invMaskB4Q[i][4] = ~maskB4Q[i][4];
-			invMaskB4Q[i][5] = ~maskB4Q[i][5];
-			invMaskB4Q[i][6] = ~maskB4Q[i][6];
-			invMaskB4Q[i][7] = ~maskB4Q[i][7];
-
-			maskW4Q[i][0] = -(i >> 0 & 1);
-			maskW4Q[i][1] = -(i >> 1 & 1);
-			maskW4Q[i][2] = -(i >> 2 & 1);
-			maskW4Q[i][3] = -(i >> 3 & 1);
-
-			invMaskW4Q[i][0] = ~maskW4Q[i][0];
-			invMaskW4Q[i][1] = ~maskW4Q[i][1];
-			invMaskW4Q[i][2] = ~maskW4Q[i][2];
-			invMaskW4Q[i][3] = ~maskW4Q[i][3];
-
-			maskD4X[i][0] = -(i >> 0 & 1);
-			maskD4X[i][1] = -(i >> 1 & 1);
-			maskD4X[i][2] = -(i >> 2 & 1);
-			maskD4X[i][3] = -(i >> 3 & 1);
-
-			invMaskD4X[i][0] = ~maskD4X[i][0];
-			invMaskD4X[i][1] = ~maskD4X[i][1];
-			invMaskD4X[i][2] = ~maskD4X[i][2];
-			invMaskD4X[i][3] = ~maskD4X[i][3];
-
-			maskQ0Q[i] = -(i >> 0 & 1);
-			maskQ1Q[i] = -(i >> 1 & 1);
-			maskQ2Q[i] = -(i >> 2 & 1);
-			maskQ3Q[i] = -(i >> 3 & 1);
-
-			invMaskQ0Q[i] = ~maskQ0Q[i];
-			invMaskQ1Q[i] = ~maskQ1Q[i];
-			invMaskQ2Q[i] = ~maskQ2Q[i];
-			invMaskQ3Q[i] = ~maskQ3Q[i];
-
-			maskX0X[i][0] = maskX0X[i][1] = maskX0X[i][2] = maskX0X[i][3] = -(i >> 0 & 1);
-			maskX1X[i][0] = maskX1X[i][1] = maskX1X[i][2] = maskX1X[i][3] = -(i >> 1 & 1);
-			maskX2X[i][0] = maskX2X[i][1] = maskX2X[i][2] = maskX2X[i][3] = -(i >> 2 & 1);
-			maskX3X[i][0] = maskX3X[i][1] = maskX3X[i][2] = maskX3X[i][3] = -(i >> 3 & 1);
-
-			invMaskX0X[i][0] = invMaskX0X[i][1] = invMaskX0X[i][2] = invMaskX0X[i][3] = ~maskX0X[i][0];
-			invMaskX1X[i][0] = invMaskX1X[i][1] = invMaskX1X[i][2] = invMaskX1X[i][3] = ~maskX1X[i][0];
-			invMaskX2X[i][0] = invMaskX2X[i][1] = invMaskX2X[i][2] = invMaskX2X[i][3] = ~maskX2X[i][0];
-			invMaskX3X[i][0] = invMaskX3X[i][1] = invMaskX3X[i][2] = invMaskX3X[i][3] = ~maskX3X[i][0];
-
-			maskD01Q[i][0] = -(i >> 0 & 1);
-			maskD01Q[i][1] = -(i >> 1 & 1);
-			maskD23Q[i][0] = -(i >> 2 & 1);
-			maskD23Q[i][1] = -(i >> 3 & 1);
-
-			invMaskD01Q[i][0] = ~maskD01Q[i][0];
-			invMaskD01Q[i][1] = ~maskD01Q[i][1];
-			invMaskD23Q[i][0] = ~maskD23Q[i][0];
-			invMaskD23Q[i][1] = ~maskD23Q[i][1];
-
-			maskQ01X[i][0] = -(i >> 0 & 1);
-			maskQ01X[i][1] = -(i >> 1 & 1);
-			maskQ23X[i][0] = -(i >> 2 & 1);
-			maskQ23X[i][1] = -(i >> 3 & 1);
-
-			invMaskQ01X[i][0] = ~maskQ01X[i][0];
-			invMaskQ01X[i][1] = ~maskQ01X[i][1];
-			invMaskQ23X[i][0] = ~maskQ23X[i][0];
-			invMaskQ23X[i][1] = ~maskQ23X[i][1];
-		}
-
-		for(int i = 0; i < 8; i++)
-		{
-			mask565Q[i][0] =
-			mask565Q[i][1] =
-			mask565Q[i][2] =
-			mask565Q[i][3] = (i & 0x1 ? 0x001F : 0) | (i & 0x2 ? 0x07E0 : 0) | (i & 0x4 ? 0xF800 : 0);
-		}
-
-		for(int i = 0; i < 4; i++)
-		{
-			maskW01Q[i][0] =  -(i >> 0 & 1);
-			maskW01Q[i][1] =  -(i >> 1 & 1);
-			maskW01Q[i][2] =  -(i >> 0 & 1);
-			maskW01Q[i][3] =  -(i >> 1 & 1);
+		// transposeBit0
+		{
+			0x00000000, 0x00000001, 0x00000010, 0x00000011, 0x00000100, 0x00000101, 0x00000110, 0x00000111,
+			0x00001000, 0x00001001, 0x00001010, 0x00001011, 0x00001100, 0x00001101, 0x00001110, 0x00001111
+		},
+
+		// transposeBit1
+		{
+			0x00000000, 0x00000002, 0x00000020, 0x00000022, 0x00000200, 0x00000202, 0x00000220, 0x00000222,
+			0x00002000, 0x00002002, 0x00002020, 0x00002022, 0x00002200, 0x00002202, 0x00002220, 0x00002222
+		},
+
+		// transposeBit2
+		{
+			0x00000000, 0x00000004, 0x00000040, 0x00000044, 0x00000400, 0x00000404, 0x00000440, 0x00000444,
+			0x00004000, 0x00004004, 0x00004040, 0x00004044, 0x00004400, 0x00004404, 0x00004440, 0x00004444
+		},
+
+		// cWeight
+		{
+			{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF},
+			{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF},
+			{0x8000, 0x8000, 0x8000, 0x8000},
+			{0x5555, 0x5555, 0x5555, 0x5555},
+			{0x4000, 0x4000, 0x4000, 0x4000},
+			{0x3333, 0x3333, 0x3333, 0x3333},
+			{0x2AAA, 0x2AAA, 0x2AAA, 0x2AAA},
+			{0x2492, 0x2492, 0x2492, 0x2492},
+			{0x2000, 0x2000, 0x2000, 0x2000},
+			{0x1C71, 0x1C71, 0x1C71, 0x1C71},
+			{0x1999, 0x1999, 0x1999, 0x1999},
+			{0x1745, 0x1745, 0x1745, 0x1745},
+			{0x1555, 0x1555, 0x1555, 0x1555},
+			{0x13B1, 0x13B1, 0x13B1, 0x13B1},
+			{0x1249, 0x1249, 0x1249, 0x1249},
+			{0x1111, 0x1111, 0x1111, 0x1111},
+			{0x1000, 0x1000, 0x1000, 0x1000}
+		},
+
+		// uvWeight
+		{
+			{1.0f, 1.0f, 1.0f, 1.0f},
+			{1.0f, 1.0f, 1.0f, 1.0f},
+			{0.5f, 0.5f, 0.5f, 0.5f},
+			{0.333333343f, 0.333333343f, 0.333333343f, 0.333333343f},
+			{0.25f, 0.25f, 0.25f, 0.25f},
+			{0.200000003f, 0.200000003f, 0.200000003f, 0.200000003f},
+			{0.166666672f, 0.166666672f, 0.166666672f, 0.166666672f},
+			{0.142857149f, 0.142857149f, 0.142857149f, 0.142857149f},
+			{0.125f, 0.125f, 0.125f, 0.125f},
+			{0.111111112f, 0.111111112f, 0.111111112f, 0.111111112f},
+			{0.100000001f, 0.100000001f, 0.100000001f, 0.100000001f},
+			{0.0909090936f, 0.0909090936f, 0.0909090936f, 0.0909090936f},
+			{0.0833333358f, 0.0833333358f, 0.0833333358f, 0.0833333358f},
+			{0.0769230798f, 0.0769230798f, 0.0769230798f, 0.0769230798f},
+			{0.0714285746f, 0.0714285746f, 0.0714285746f, 0.0714285746f},
+			{0.0666666701f, 0.0666666701f, 0.0666666701f, 0.0666666701f},
+			{0.0625f, 0.0625f, 0.0625f, 0.0625f}
+		},
+
+		// uvStart
+		{
+			{-0.0f, -0.0f, -0.0f, -0.0f},
+			{-0.0f, -0.0f, -0.0f, -0.0f},
+			{-0.25f, -0.25f, -0.25f, -0.25f},
+			{-0.333333343f, -0.333333343f, -0.333333343f, -0.333333343f},
+			{-0.375f, -0.375f, -0.375f, -0.375f},
+			{-0.400000006f, -0.400000006f, -0.400000006f, -0.400000006f},
+			{-0.416666657f, -0.416666657f, -0.416666657f, -0.416666657f},
+			{-0.428571433f, -0.428571433f, -0.428571433f, -0.428571433f},
+			{-0.4375f, -0.4375f, -0.4375f, -0.4375f},
+			{-0.444444448f, -0.444444448f, -0.444444448f, -0.444444448f},
+			{-0.449999988f, -0.449999988f, -0.449999988f, -0.449999988f},
+			{-0.454545468f, -0.454545468f, -0.454545468f, -0.454545468f},
+			{-0.458333343f, -0.458333343f, -0.458333343f, -0.458333343f},
+			{-0.461538464f, -0.461538464f, -0.461538464f, -0.461538464f},
+			{-0.464285702f, -0.464285702f, -0.464285702f, -0.464285702f},
+			{-0.466666669f, -0.466666669f, -0.466666669f, -0.466666669f},
+			{-0.46875f, -0.46875f, -0.46875f, -0.46875f}
+		},
+
+		// occlusionCount
+		{0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4},
+
+		// maskB4Q
+		{
+			{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+			{0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00},
+			{0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00},
+			{0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00},
+			{0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00},
+			{0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00},
+			{0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00},
+			{0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0x00},
+			{0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF},
+			{0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF},
+			{0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF},
+			{0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0xFF},
+			{0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF},
+			{0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF},
+			{0x00, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF},
+			{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}
+		},
+
+		// invMaskB4Q
+		{
+			{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF},
+			{0x00, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF},
+			{0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF},
+			{0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF},
+			{0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0xFF},
+			{0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF},
+			{0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF},
+			{0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF},
+			{0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0x00},
+			{0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00},
+			{0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00},
+			{0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00},
+			{0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00},
+			{0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00},
+			{0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00},
+			{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}
+		},
+
+		// maskW4Q
+		{
+			{0x0000, 0x0000, 0x0000, 0x0000},
+			{0xFFFF, 0x0000, 0x0000, 0x0000},
+			{0x0000, 0xFFFF, 0x0000, 0x0000},
+			{0xFFFF, 0xFFFF, 0x0000, 0x0000},
+			{0x0000, 0x0000, 0xFFFF, 0x0000},
+			{0xFFFF, 0x0000, 0xFFFF, 0x0000},
+			{0x0000, 0xFFFF, 0xFFFF, 0x0000},
+			{0xFFFF, 0xFFFF, 0xFFFF, 0x0000},
+			{0x0000, 0x0000, 0x0000, 0xFFFF},
+			{0xFFFF, 0x0000, 0x0000, 0xFFFF},
+			{0x0000, 0xFFFF, 0x0000, 0xFFFF},
+			{0xFFFF, 0xFFFF, 0x0000, 0xFFFF},
+			{0x0000, 0x0000, 0xFFFF, 0xFFFF},
+			{0xFFFF, 0x0000, 0xFFFF, 0xFFFF},
+			{0x0000, 0xFFFF, 0xFFFF, 0xFFFF},
+			{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF}
+		},
+
+		// invMaskW4Q
+		{
+			{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF},
+			{0x0000, 0xFFFF, 0xFFFF, 0xFFFF},
+			{0xFFFF, 0x0000, 0xFFFF, 0xFFFF},
+			{0x0000, 0x0000, 0xFFFF, 0xFFFF},
+			{0xFFFF, 0xFFFF, 0x0000, 0xFFFF},
+			{0x0000, 0xFFFF, 0x0000, 0xFFFF},
+			{0xFFFF, 0x0000, 0x0000, 0xFFFF},
+			{0x0000, 0x0000, 0x0000, 0xFFFF},
+			{0xFFFF, 0xFFFF, 0xFFFF, 0x0000},
+			{0x0000, 0xFFFF, 0xFFFF, 0x0000},
+			{0xFFFF, 0x0000, 0xFFFF, 0x0000},
+			{0x0000, 0x0000, 0xFFFF, 0x0000},
+			{0xFFFF, 0xFFFF, 0x0000, 0x0000},
+			{0x0000, 0xFFFF, 0x0000, 0x0000},
+			{0xFFFF, 0x0000, 0x0000, 0x0000},
+			{0x0000, 0x0000, 0x0000, 0x0000}
+		},
+
+		// maskD4X
+		{
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0xFFFFFFFF, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0x00000000, 0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000, 0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+		},
+
+		// invMaskD4X
+		{
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000, 0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0x00000000, 0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0x00000000, 0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000},
+			{0x00000000, 0xFFFFFFFF, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000}
+		},
+
+		// maskQ0Q
+		{
+			0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF
+		},
+
+		// maskQ1Q
+		{
+			0x0000000000000000, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF
+		},
+
+		// maskQ2Q
+		{
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF
+		},
 
-			maskD01X[i][0] =  -(i >> 0 & 1);
-			maskD01X[i][1] =  -(i >> 1 & 1);
-			maskD01X[i][2] =  -(i >> 0 & 1);
-			maskD01X[i][3] =  -(i >> 1 & 1);
-		}
-
-		for(int i = 0; i < 256; i++)
-		{
-			sRGBtoLinear8_16[i] = (unsigned short)(sw::sRGBtoLinear((float)i / 0xFF) * 0xFFFF + 0.5f);
-		}
-
-		for(int i = 0; i < 64; i++)
-		{
-			sRGBtoLinear6_16[i] = (unsigned short)(sw::sRGBtoLinear((float)i / 0x3F) * 0xFFFF + 0.5f);
-		}
-
-		for(int i = 0; i < 32; i++)
-		{
-			sRGBtoLinear5_16[i] = (unsigned short)(sw::sRGBtoLinear((float)i / 0x1F) * 0xFFFF + 0.5f);
-		}
+		// maskQ3Q
+		{
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF
+		},
+
+		// invMaskQ0Q
+		{
+			0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000
+		},
+
+		// invMaskQ1Q
+		{
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0x0000000000000000
+		},
+
+		// invMaskQ2Q
+		{
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000
+		},
+
+		// invMaskQ3Q
+		{
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+			0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000
+		},
+
+		// maskX0X
+		{
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+		},
+
+		// maskX1X
+		{
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+		},
+
+		// maskX2X
+		{
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+		},
+
+		// maskX3X
+		{
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+		},
+
+		// invMaskX0X
+		{
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000}
+		},
+
+		// invMaskX1X
+		{
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000}
+		},
+
+		// invMaskX2X
+		{
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000}
+		},
+
+		// invMaskX3X
+		{
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000}
+		},
+
+		// maskD01Q
+		{
+			{0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF}
+		},
+
+		// maskD23Q
+		{
+			{0x00000000, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF}
+		},
+
+		// invMaskD01Q
+		{
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0x00000000}
+		},
+
+		// invMaskD23Q
+		{
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0x00000000, 0x00000000},
+			{0x00000000, 0x00000000}
+		},
 
-		for(int i = 0; i < 0x1000; i++)
+		// maskQ01X
 		{
-			linearToSRGB12_16[i] = (unsigned short)(clamp(sw::linearToSRGB((float)i / 0x0FFF) * 0xFFFF + 0.5f, 0.0f, (float)0xFFFF));
-			sRGBtoLinear12_16[i] = (unsigned short)(clamp(sw::sRGBtoLinear((float)i / 0x0FFF) * 0xFFFF + 0.5f, 0.0f, (float)0xFFFF));
-		}
+			{0x0000000000000000, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF}
+		},
 
-		for(int q = 0; q < 4; q++)
+		// maskQ23X
+		{
+			{0x0000000000000000, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF}
+		},
+
+		// invMaskQ01X
+		{
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000}
+		},
+
+		// invMaskQ23X
+		{
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0x0000000000000000, 0xFFFFFFFFFFFFFFFF},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0xFFFFFFFFFFFFFFFF, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000},
+			{0x0000000000000000, 0x0000000000000000}
+		},
+
+		// maskW01Q
+		{
+			{0x0000, 0x0000, 0x0000, 0x0000},
+			{0xFFFF, 0x0000, 0xFFFF, 0x0000},
+			{0x0000, 0xFFFF, 0x0000, 0xFFFF},
+			{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF}
+		},
+
+		// maskD01X
+		{
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000, 0xFFFFFFFF, 0x00000000},
+			{0x00000000, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+		},
+
+		// mask565Q
+		{
+			{0x0000, 0x0000, 0x0000, 0x0000},
+			{0x001F, 0x001F, 0x001F, 0x001F},
+			{0x07E0, 0x07E0, 0x07E0, 0x07E0},
+			{0x07FF, 0x07FF, 0x07FF, 0x07FF},
+			{0xF800, 0xF800, 0xF800, 0xF800},
+			{0xF81F, 0xF81F, 0xF81F, 0xF81F},
+			{0xFFE0, 0xFFE0, 0xFFE0, 0xFFE0},
+			{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF}
+		},
+
+		// sRGBtoLinear8_16
+		{
+			0x0000, 0x0014, 0x0028, 0x003C, 0x0050, 0x0063, 0x0077, 0x008B,
+			0x009F, 0x00B3, 0x00C7, 0x00DB, 0x00F1, 0x0108, 0x0120, 0x0139,
+			0x0154, 0x016F, 0x018C, 0x01AB, 0x01CA, 0x01EB, 0x020E, 0x0232,
+			0x0257, 0x027D, 0x02A5, 0x02CE, 0x02F9, 0x0325, 0x0353, 0x0382,
+			0x03B3, 0x03E5, 0x0418, 0x044D, 0x0484, 0x04BC, 0x04F6, 0x0532,
+			0x056F, 0x05AD, 0x05ED, 0x062F, 0x0673, 0x06B8, 0x06FE, 0x0747,
+			0x0791, 0x07DD, 0x082A, 0x087A, 0x08CA, 0x091D, 0x0972, 0x09C8,
+			0x0A20, 0x0A79, 0x0AD5, 0x0B32, 0x0B91, 0x0BF2, 0x0C55, 0x0CBA,
+			0x0D20, 0x0D88, 0x0DF2, 0x0E5E, 0x0ECC, 0x0F3C, 0x0FAE, 0x1021,
+			0x1097, 0x110E, 0x1188, 0x1203, 0x1280, 0x1300, 0x1381, 0x1404,
+			0x1489, 0x1510, 0x159A, 0x1625, 0x16B2, 0x1741, 0x17D3, 0x1866,
+			0x18FB, 0x1993, 0x1A2C, 0x1AC8, 0x1B66, 0x1C06, 0x1CA7, 0x1D4C,
+			0x1DF2, 0x1E9A, 0x1F44, 0x1FF1, 0x20A0, 0x2150, 0x2204, 0x22B9,
+			0x2370, 0x242A, 0x24E5, 0x25A3, 0x2664, 0x2726, 0x27EB, 0x28B1,
+			0x297B, 0x2A46, 0x2B14, 0x2BE3, 0x2CB6, 0x2D8A, 0x2E61, 0x2F3A,
+			0x3015, 0x30F2, 0x31D2, 0x32B4, 0x3399, 0x3480, 0x3569, 0x3655,
+			0x3742, 0x3833, 0x3925, 0x3A1A, 0x3B12, 0x3C0B, 0x3D07, 0x3E06,
+			0x3F07, 0x400A, 0x4110, 0x4218, 0x4323, 0x4430, 0x453F, 0x4651,
+			0x4765, 0x487C, 0x4995, 0x4AB1, 0x4BCF, 0x4CF0, 0x4E13, 0x4F39,
+			0x5061, 0x518C, 0x52B9, 0x53E9, 0x551B, 0x5650, 0x5787, 0x58C1,
+			0x59FE, 0x5B3D, 0x5C7E, 0x5DC2, 0x5F09, 0x6052, 0x619E, 0x62ED,
+			0x643E, 0x6591, 0x66E8, 0x6840, 0x699C, 0x6AFA, 0x6C5B, 0x6DBE,
+			0x6F24, 0x708D, 0x71F8, 0x7366, 0x74D7, 0x764A, 0x77C0, 0x7939,
+			0x7AB4, 0x7C32, 0x7DB3, 0x7F37, 0x80BD, 0x8246, 0x83D1, 0x855F,
+			0x86F0, 0x8884, 0x8A1B, 0x8BB4, 0x8D50, 0x8EEF, 0x9090, 0x9235,
+			0x93DC, 0x9586, 0x9732, 0x98E2, 0x9A94, 0x9C49, 0x9E01, 0x9FBB,
+			0xA179, 0xA339, 0xA4FC, 0xA6C2, 0xA88B, 0xAA56, 0xAC25, 0xADF6,
+			0xAFCA, 0xB1A1, 0xB37B, 0xB557, 0xB737, 0xB919, 0xBAFF, 0xBCE7,
+			0xBED2, 0xC0C0, 0xC2B1, 0xC4A5, 0xC69C, 0xC895, 0xCA92, 0xCC91,
+			0xCE94, 0xD099, 0xD2A1, 0xD4AD, 0xD6BB, 0xD8CC, 0xDAE0, 0xDCF7,
+			0xDF11, 0xE12E, 0xE34E, 0xE571, 0xE797, 0xE9C0, 0xEBEC, 0xEE1B,
+			0xF04D, 0xF282, 0xF4BA, 0xF6F5, 0xF933, 0xFB74, 0xFDB8, 0xFFFF
+		},
+
+		// sRGBtoLinear6_16
+		{
+			0x0000, 0x0051, 0x00A1, 0x00F4, 0x0159, 0x01D2, 0x0261, 0x0308,
+			0x03C5, 0x049C, 0x058C, 0x0697, 0x07BC, 0x08FD, 0x0A5B, 0x0BD6,
+			0x0D6F, 0x0F27, 0x10FD, 0x12F3, 0x150A, 0x1741, 0x199A, 0x1C15,
+			0x1EB2, 0x2172, 0x2456, 0x275E, 0x2A8A, 0x2DDB, 0x3152, 0x34EF,
+			0x38B1, 0x3C9B, 0x40AC, 0x44E4, 0x4945, 0x4DCE, 0x5280, 0x575B,
+			0x5C60, 0x618E, 0x66E8, 0x6C6C, 0x721B, 0x77F6, 0x7DFD, 0x8430,
+			0x8A8F, 0x911C, 0x97D6, 0x9EBE, 0xA5D4, 0xAD18, 0xB48B, 0xBC2D,
+			0xC3FE, 0xCBFF, 0xD430, 0xDC91, 0xE523, 0xEDE5, 0xF6D9, 0xFFFF
+		},
+
+		// sRGBtoLinear5_16
+		{
+			0x0000, 0x00A4, 0x0160, 0x0271, 0x03E0, 0x05B5, 0x07F8, 0x0AAE,
+			0x0DDE, 0x118C, 0x15BD, 0x1A77, 0x1FBF, 0x2597, 0x2C05, 0x330D,
+			0x3AB2, 0x42F7, 0x4BE2, 0x5575, 0x5FB3, 0x6A9F, 0x763E, 0x8292,
+			0x8F9E, 0x9D64, 0xABE9, 0xBB2E, 0xCB36, 0xDC05, 0xED9C, 0xFFFF
+		},
+
+		// sRGBtoLinear8_32F
+		{
+			0.0f, 0.000303526991f, 0.000607053982f, 0.000910580973f,
+			0.00121410796f, 0.00151763496f, 0.00182116195f, 0.00212468882f,
+			0.00242821593f, 0.00273174304f, 0.00303526991f, 0.00334653491f,
+			0.00367650692f, 0.00402471656f, 0.00439144112f, 0.00477695232f,
+			0.00518151606f, 0.00560539076f, 0.00604883162f, 0.00651208917f,
+			0.00699540833f, 0.00749902939f, 0.00802319217f, 0.00856812485f,
+			0.00913405698f, 0.00972121581f, 0.0103298202f, 0.0109600909f,
+			0.0116122421f, 0.0122864842f, 0.0129830306f, 0.0137020806f,
+			0.0144438408f, 0.0152085116f, 0.0159962904f, 0.0168073718f,
+			0.0176419485f, 0.0185002144f, 0.0193823576f, 0.0202885587f,
+			0.0212190058f, 0.0221738797f, 0.0231533609f, 0.0241576266f,
+			0.0251868516f, 0.0262412131f, 0.0273208879f, 0.0284260344f,
+			0.0295568276f, 0.0307134371f, 0.0318960249f, 0.0331047587f,
+			0.0343397968f, 0.035601303f, 0.036889445f, 0.0382043645f,
+			0.0395462252f, 0.0409151874f, 0.0423114002f, 0.0437350161f,
+			0.0451861918f, 0.0466650724f, 0.0481718108f, 0.0497065485f,
+			0.051269453f, 0.05286064f, 0.0544802696f, 0.0561284944f,
+			0.0578054339f, 0.0595112406f, 0.0612460561f, 0.063010022f,
+			0.064803265f, 0.0666259378f, 0.0684781671f, 0.0703600943f,
+			0.0722718462f, 0.0742135644f, 0.0761853755f, 0.0781874135f,
+			0.0802198127f, 0.0822826996f, 0.084376201f, 0.0865004659f,
+			0.088655591f, 0.0908417106f, 0.0930589661f, 0.0953074619f,
+			0.097587347f, 0.0998987257f, 0.102241725f, 0.104616478f,
+			0.107023098f, 0.109461702f, 0.111932419f, 0.11443536f,
+			0.116970651f, 0.119538411f, 0.122138776f, 0.124771819f,
+			0.127437681f, 0.130136475f, 0.13286832f, 0.13563332f,
+			0.138431609f, 0.141263276f, 0.144128457f, 0.147027254f,
+			0.149959773f, 0.152926132f, 0.155926451f, 0.158960819f,
+			0.162029356f, 0.165132165f, 0.168269366f, 0.171441078f,
+			0.174647376f, 0.177888379f, 0.181164205f, 0.18447496f,
+			0.187820733f, 0.191201672f, 0.194617808f, 0.198069304f,
+			0.201556236f, 0.205078706f, 0.20863685f, 0.212230727f,
+			0.215860531f, 0.219526231f, 0.223227978f, 0.226965889f,
+			0.23074007f, 0.234550595f, 0.238397583f, 0.242281139f,
+			0.246201336f, 0.25015828f, 0.254152089f, 0.258182853f,
+			0.262250662f, 0.266355604f, 0.270497799f, 0.274677306f,
+			0.278894246f, 0.283148736f, 0.287440836f, 0.291770637f,
+			0.296138257f, 0.300543785f, 0.304987282f, 0.309468895f,
+			0.313988686f, 0.318546742f, 0.323143184f, 0.327778131f,
+			0.332451582f, 0.337163657f, 0.341914445f, 0.346704096f,
+			0.351532638f, 0.356400162f, 0.361306787f, 0.366252601f,
+			0.371237695f, 0.376262128f, 0.38132602f, 0.386429429f,
+			0.391572475f, 0.396755219f, 0.401977777f, 0.407240212f,
+			0.412542611f, 0.417885065f, 0.423267663f, 0.428690463f,
+			0.434153616f, 0.439657152f, 0.445201159f, 0.450785756f,
+			0.456410974f, 0.462076962f, 0.467783749f, 0.473531455f,
+			0.479320139f, 0.48514989f, 0.491020888f, 0.496933043f,
+			0.502886474f, 0.50888133f, 0.514917672f, 0.520995617f,
+			0.527115166f, 0.533276439f, 0.539479494f, 0.545724452f,
+			0.55201143f, 0.558340371f, 0.564711511f, 0.571124852f,
+			0.577580452f, 0.584078431f, 0.590618849f, 0.597201765f,
+			0.603827298f, 0.610495567f, 0.617206514f, 0.623960376f,
+			0.630757093f, 0.637596846f, 0.644479632f, 0.651405573f,
+			0.658374786f, 0.665387213f, 0.672443092f, 0.679542422f,
+			0.686685264f, 0.693871677f, 0.701101899f, 0.708375812f,
+			0.715693533f, 0.723055124f, 0.730460763f, 0.73791045f,
+			0.745404243f, 0.752942204f, 0.760524511f, 0.768151164f,
+			0.775822222f, 0.783537805f, 0.791297913f, 0.799102724f,
+			0.806952238f, 0.814846516f, 0.822785735f, 0.830769837f,
+			0.83879894f, 0.846873164f, 0.854992568f, 0.863157153f,
+			0.871367037f, 0.879622221f, 0.887923062f, 0.896269143f,
+			0.904661119f, 0.913098454f, 0.921581745f, 0.930110633f,
+			0.938685596f, 0.947306454f, 0.955973387f, 0.964686155f,
+			0.973445296f, 0.982250392f, 0.991102099f, 0.999999881f
+		},
+
+		// linearToSRGB12_16
+		{
+			0x0000, 0x00CF, 0x019E, 0x026C, 0x033B, 0x040A, 0x04D9, 0x05A7,
+			0x0676, 0x0745, 0x0814, 0x08E2, 0x09B1, 0x0A7F, 0x0B45, 0x0C02,
+			0x0CB8, 0x0D67, 0x0E11, 0x0EB5, 0x0F54, 0x0FEF, 0x1085, 0x1118,
+			0x11A6, 0x1232, 0x12BA, 0x133F, 0x13C1, 0x1441, 0x14BE, 0x1538,
+			0x15B1, 0x1627, 0x169B, 0x170D, 0x177D, 0x17EC, 0x1859, 0x18C4,
+			0x192D, 0x1995, 0x19FB, 0x1A61, 0x1AC4, 0x1B27, 0x1B88, 0x1BE8,
+			0x1C46, 0x1CA4, 0x1D00, 0x1D5C, 0x1DB6, 0x1E0F, 0x1E68, 0x1EBF,
+			0x1F16, 0x1F6B, 0x1FC0, 0x2014, 0x2067, 0x20B9, 0x210A, 0x215B,
+			0x21AB, 0x21FA, 0x2249, 0x2297, 0x22E4, 0x2330, 0x237C, 0x23C7,
+			0x2412, 0x245C, 0x24A5, 0x24EE, 0x2536, 0x257E, 0x25C5, 0x260C,
+			0x2652, 0x2698, 0x26DD, 0x2721, 0x2766, 0x27A9, 0x27EC, 0x282F,
+			0x2872, 0x28B3, 0x28F5, 0x2936, 0x2976, 0x29B7, 0x29F6, 0x2A36,
+			0x2A75, 0x2AB3, 0x2AF2, 0x2B30, 0x2B6D, 0x2BAA, 0x2BE7, 0x2C24,
+			0x2C60, 0x2C9B, 0x2CD7, 0x2D12, 0x2D4D, 0x2D87, 0x2DC2, 0x2DFB,
+			0x2E35, 0x2E6E, 0x2EA7, 0x2EE0, 0x2F18, 0x2F50, 0x2F88, 0x2FC0,
+			0x2FF7, 0x302E, 0x3065, 0x309B, 0x30D2, 0x3108, 0x313D, 0x3173,
+			0x31A8, 0x31DD, 0x3212, 0x3246, 0x327B, 0x32AF, 0x32E2, 0x3316,
+			0x3349, 0x337D, 0x33AF, 0x33E2, 0x3415, 0x3447, 0x3479, 0x34AB,
+			0x34DD, 0x350E, 0x353F, 0x3571, 0x35A1, 0x35D2, 0x3603, 0x3633,
+			0x3663, 0x3693, 0x36C3, 0x36F2, 0x3722, 0x3751, 0x3780, 0x37AF,
+			0x37DE, 0x380C, 0x383B, 0x3869, 0x3897, 0x38C5, 0x38F3, 0x3920,
+			0x394E, 0x397B, 0x39A8, 0x39D5, 0x3A02, 0x3A2E, 0x3A5B, 0x3A87,
+			0x3AB3, 0x3ADF, 0x3B0B, 0x3B37, 0x3B62, 0x3B8E, 0x3BB9, 0x3BE4,
+			0x3C0F, 0x3C3A, 0x3C65, 0x3C90, 0x3CBA, 0x3CE5, 0x3D0F, 0x3D39,
+			0x3D63, 0x3D8D, 0x3DB7, 0x3DE0, 0x3E0A, 0x3E33, 0x3E5C, 0x3E85,
+			0x3EAE, 0x3ED7, 0x3F00, 0x3F29, 0x3F51, 0x3F7A, 0x3FA2, 0x3FCA,
+			0x3FF2, 0x401A, 0x4042, 0x406A, 0x4091, 0x40B9, 0x40E0, 0x4108,
+			0x412F, 0x4156, 0x417D, 0x41A4, 0x41CB, 0x41F1, 0x4218, 0x423E,
+			0x4265, 0x428B, 0x42B1, 0x42D7, 0x42FD, 0x4323, 0x4349, 0x436E,
+			0x4394, 0x43BA, 0x43DF, 0x4404, 0x442A, 0x444F, 0x4474, 0x4499,
+			0x44BD, 0x44E2, 0x4507, 0x452B, 0x4550, 0x4574, 0x4599, 0x45BD,
+			0x45E1, 0x4605, 0x4629, 0x464D, 0x4671, 0x4695, 0x46B8, 0x46DC,
+			0x46FF, 0x4723, 0x4746, 0x4769, 0x478C, 0x47B0, 0x47D3, 0x47F6,
+			0x4818, 0x483B, 0x485E, 0x4881, 0x48A3, 0x48C6, 0x48E8, 0x490A,
+			0x492D, 0x494F, 0x4971, 0x4993, 0x49B5, 0x49D7, 0x49F9, 0x4A1A,
+			0x4A3C, 0x4A5E, 0x4A7F, 0x4AA1, 0x4AC2, 0x4AE3, 0x4B05, 0x4B26,
+			0x4B47, 0x4B68, 0x4B89, 0x4BAA, 0x4BCB, 0x4BEC, 0x4C0C, 0x4C2D,
+			0x4C4E, 0x4C6E, 0x4C8F, 0x4CAF, 0x4CCF, 0x4CF0, 0x4D10, 0x4D30,
+			0x4D50, 0x4D70, 0x4D90, 0x4DB0, 0x4DD0, 0x4DF0, 0x4E0F, 0x4E2F,
+			0x4E4F, 0x4E6E, 0x4E8E, 0x4EAD, 0x4ECD, 0x4EEC, 0x4F0B, 0x4F2A,
+			0x4F49, 0x4F69, 0x4F88, 0x4FA7, 0x4FC6, 0x4FE4, 0x5003, 0x5022,
+			0x5041, 0x505F, 0x507E, 0x509C, 0x50BB, 0x50D9, 0x50F8, 0x5116,
+			0x5134, 0x5153, 0x5171, 0x518F, 0x51AD, 0x51CB, 0x51E9, 0x5207,
+			0x5225, 0x5242, 0x5260, 0x527E, 0x529C, 0x52B9, 0x52D7, 0x52F4,
+			0x5312, 0x532F, 0x534D, 0x536A, 0x5387, 0x53A4, 0x53C2, 0x53DF,
+			0x53FC, 0x5419, 0x5436, 0x5453, 0x5470, 0x548C, 0x54A9, 0x54C6,
+			0x54E3, 0x54FF, 0x551C, 0x5539, 0x5555, 0x5572, 0x558E, 0x55AA,
+			0x55C7, 0x55E3, 0x55FF, 0x561C, 0x5638, 0x5654, 0x5670, 0x568C,
+			0x56A8, 0x56C4, 0x56E0, 0x56FC, 0x5718, 0x5733, 0x574F, 0x576B,
+			0x5787, 0x57A2, 0x57BE, 0x57D9, 0x57F5, 0x5810, 0x582C, 0x5847,
+			0x5862, 0x587E, 0x5899, 0x58B4, 0x58CF, 0x58EB, 0x5906, 0x5921,
+			0x593C, 0x5957, 0x5972, 0x598D, 0x59A7, 0x59C2, 0x59DD, 0x59F8,
+			0x5A13, 0x5A2D, 0x5A48, 0x5A63, 0x5A7D, 0x5A98, 0x5AB2, 0x5ACD,
+			0x5AE7, 0x5B01, 0x5B1C, 0x5B36, 0x5B50, 0x5B6B, 0x5B85, 0x5B9F,
+			0x5BB9, 0x5BD3, 0x5BED, 0x5C07, 0x5C21, 0x5C3B, 0x5C55, 0x5C6F,
+			0x5C89, 0x5CA3, 0x5CBD, 0x5CD6, 0x5CF0, 0x5D0A, 0x5D23, 0x5D3D,
+			0x5D57, 0x5D70, 0x5D8A, 0x5DA3, 0x5DBD, 0x5DD6, 0x5DF0, 0x5E09,
+			0x5E22, 0x5E3C, 0x5E55, 0x5E6E, 0x5E87, 0x5EA0, 0x5EBA, 0x5ED3,
+			0x5EEC, 0x5F05, 0x5F1E, 0x5F37, 0x5F50, 0x5F69, 0x5F82, 0x5F9A,
+			0x5FB3, 0x5FCC, 0x5FE5, 0x5FFD, 0x6016, 0x602F, 0x6048, 0x6060,
+			0x6079, 0x6091, 0x60AA, 0x60C2, 0x60DB, 0x60F3, 0x610C, 0x6124,
+			0x613C, 0x6155, 0x616D, 0x6185, 0x619D, 0x61B6, 0x61CE, 0x61E6,
+			0x61FE, 0x6216, 0x622E, 0x6246, 0x625E, 0x6276, 0x628E, 0x62A6,
+			0x62BE, 0x62D6, 0x62EE, 0x6305, 0x631D, 0x6335, 0x634D, 0x6364,
+			0x637C, 0x6394, 0x63AB, 0x63C3, 0x63DB, 0x63F2, 0x640A, 0x6421,
+			0x6438, 0x6450, 0x6467, 0x647F, 0x6496, 0x64AD, 0x64C5, 0x64DC,
+			0x64F3, 0x650A, 0x6522, 0x6539, 0x6550, 0x6567, 0x657E, 0x6595,
+			0x65AC, 0x65C3, 0x65DA, 0x65F1, 0x6608, 0x661F, 0x6636, 0x664D,
+			0x6664, 0x667B, 0x6691, 0x66A8, 0x66BF, 0x66D6, 0x66EC, 0x6703,
+			0x671A, 0x6730, 0x6747, 0x675E, 0x6774, 0x678B, 0x67A1, 0x67B8,
+			0x67CE, 0x67E5, 0x67FB, 0x6811, 0x6828, 0x683E, 0x6854, 0x686B,
+			0x6881, 0x6897, 0x68AE, 0x68C4, 0x68DA, 0x68F0, 0x6906, 0x691C,
+			0x6932, 0x6949, 0x695F, 0x6975, 0x698B, 0x69A1, 0x69B7, 0x69CD,
+			0x69E2, 0x69F8, 0x6A0E, 0x6A24, 0x6A3A, 0x6A50, 0x6A66, 0x6A7B,
+			0x6A91, 0x6AA7, 0x6ABC, 0x6AD2, 0x6AE8, 0x6AFD, 0x6B13, 0x6B29,
+			0x6B3E, 0x6B54, 0x6B69, 0x6B7F, 0x6B94, 0x6BAA, 0x6BBF, 0x6BD5,
+			0x6BEA, 0x6C00, 0x6C15, 0x6C2A, 0x6C40, 0x6C55, 0x6C6A, 0x6C7F,
+			0x6C95, 0x6CAA, 0x6CBF, 0x6CD4, 0x6CEA, 0x6CFF, 0x6D14, 0x6D29,
+			0x6D3E, 0x6D53, 0x6D68, 0x6D7D, 0x6D92, 0x6DA7, 0x6DBC, 0x6DD1,
+			0x6DE6, 0x6DFB, 0x6E10, 0x6E25, 0x6E3A, 0x6E4E, 0x6E63, 0x6E78,
+			0x6E8D, 0x6EA2, 0x6EB6, 0x6ECB, 0x6EE0, 0x6EF4, 0x6F09, 0x6F1E,
+			0x6F32, 0x6F47, 0x6F5C, 0x6F70, 0x6F85, 0x6F99, 0x6FAE, 0x6FC2,
+			0x6FD7, 0x6FEB, 0x7000, 0x7014, 0x7028, 0x703D, 0x7051, 0x7066,
+			0x707A, 0x708E, 0x70A3, 0x70B7, 0x70CB, 0x70DF, 0x70F4, 0x7108,
+			0x711C, 0x7130, 0x7144, 0x7159, 0x716D, 0x7181, 0x7195, 0x71A9,
+			0x71BD, 0x71D1, 0x71E5, 0x71F9, 0x720D, 0x7221, 0x7235, 0x7249,
+			0x725D, 0x7271, 0x7285, 0x7298, 0x72AC, 0x72C0, 0x72D4, 0x72E8,
+			0x72FC, 0x730F, 0x7323, 0x7337, 0x734B, 0x735E, 0x7372, 0x7386,
+			0x7399, 0x73AD, 0x73C1, 0x73D4, 0x73E8, 0x73FB, 0x740F, 0x7422,
+			0x7436, 0x7449, 0x745D, 0x7470, 0x7484, 0x7497, 0x74AB, 0x74BE,
+			0x74D2, 0x74E5, 0x74F8, 0x750C, 0x751F, 0x7532, 0x7546, 0x7559,
+			0x756C, 0x7580, 0x7593, 0x75A6, 0x75B9, 0x75CC, 0x75E0, 0x75F3,
+			0x7606, 0x7619, 0x762C, 0x763F, 0x7652, 0x7665, 0x7679, 0x768C,
+			0x769F, 0x76B2, 0x76C5, 0x76D8, 0x76EB, 0x76FE, 0x7710, 0x7723,
+			0x7736, 0x7749, 0x775C, 0x776F, 0x7782, 0x7795, 0x77A8, 0x77BA,
+			0x77CD, 0x77E0, 0x77F3, 0x7805, 0x7818, 0x782B, 0x783E, 0x7850,
+			0x7863, 0x7876, 0x7888, 0x789B, 0x78AE, 0x78C0, 0x78D3, 0x78E5,
+			0x78F8, 0x790A, 0x791D, 0x7930, 0x7942, 0x7955, 0x7967, 0x797A,
+			0x798C, 0x799E, 0x79B1, 0x79C3, 0x79D6, 0x79E8, 0x79FA, 0x7A0D,
+			0x7A1F, 0x7A32, 0x7A44, 0x7A56, 0x7A68, 0x7A7B, 0x7A8D, 0x7A9F,
+			0x7AB1, 0x7AC4, 0x7AD6, 0x7AE8, 0x7AFA, 0x7B0D, 0x7B1F, 0x7B31,
+			0x7B43, 0x7B55, 0x7B67, 0x7B79, 0x7B8B, 0x7B9D, 0x7BB0, 0x7BC2,
+			0x7BD4, 0x7BE6, 0x7BF8, 0x7C0A, 0x7C1C, 0x7C2E, 0x7C40, 0x7C51,
+			0x7C63, 0x7C75, 0x7C87, 0x7C99, 0x7CAB, 0x7CBD, 0x7CCF, 0x7CE1,
+			0x7CF2, 0x7D04, 0x7D16, 0x7D28, 0x7D3A, 0x7D4B, 0x7D5D, 0x7D6F,
+			0x7D81, 0x7D92, 0x7DA4, 0x7DB6, 0x7DC7, 0x7DD9, 0x7DEB, 0x7DFC,
+			0x7E0E, 0x7E20, 0x7E31, 0x7E43, 0x7E54, 0x7E66, 0x7E78, 0x7E89,
+			0x7E9B, 0x7EAC, 0x7EBE, 0x7ECF, 0x7EE1, 0x7EF2, 0x7F04, 0x7F15,
+			0x7F26, 0x7F38, 0x7F49, 0x7F5B, 0x7F6C, 0x7F7E, 0x7F8F, 0x7FA0,
+			0x7FB2, 0x7FC3, 0x7FD4, 0x7FE6, 0x7FF7, 0x8008, 0x8019, 0x802B,
+			0x803C, 0x804D, 0x805E, 0x8070, 0x8081, 0x8092, 0x80A3, 0x80B4,
+			0x80C6, 0x80D7, 0x80E8, 0x80F9, 0x810A, 0x811B, 0x812C, 0x813D,
+			0x814F, 0x8160, 0x8171, 0x8182, 0x8193, 0x81A4, 0x81B5, 0x81C6,
+			0x81D7, 0x81E8, 0x81F9, 0x820A, 0x821B, 0x822C, 0x823C, 0x824D,
+			0x825E, 0x826F, 0x8280, 0x8291, 0x82A2, 0x82B3, 0x82C3, 0x82D4,
+			0x82E5, 0x82F6, 0x8307, 0x8317, 0x8328, 0x8339, 0x834A, 0x835A,
+			0x836B, 0x837C, 0x838D, 0x839D, 0x83AE, 0x83BF, 0x83CF, 0x83E0,
+			0x83F1, 0x8401, 0x8412, 0x8423, 0x8433, 0x8444, 0x8454, 0x8465,
+			0x8475, 0x8486, 0x8497, 0x84A7, 0x84B8, 0x84C8, 0x84D9, 0x84E9,
+			0x84FA, 0x850A, 0x851A, 0x852B, 0x853B, 0x854C, 0x855C, 0x856D,
+			0x857D, 0x858D, 0x859E, 0x85AE, 0x85BF, 0x85CF, 0x85DF, 0x85F0,
+			0x8600, 0x8610, 0x8621, 0x8631, 0x8641, 0x8651, 0x8662, 0x8672,
+			0x8682, 0x8692, 0x86A3, 0x86B3, 0x86C3, 0x86D3, 0x86E3, 0x86F4,
+			0x8704, 0x8714, 0x8724, 0x8734, 0x8744, 0x8754, 0x8765, 0x8775,
+			0x8785, 0x8795, 0x87A5, 0x87B5, 0x87C5, 0x87D5, 0x87E5, 0x87F5,
+			0x8805, 0x8815, 0x8825, 0x8835, 0x8845, 0x8855, 0x8865, 0x8875,
+			0x8885, 0x8895, 0x88A5, 0x88B5, 0x88C5, 0x88D4, 0x88E4, 0x88F4,
+			0x8904, 0x8914, 0x8924, 0x8934, 0x8943, 0x8953, 0x8963, 0x8973,
+			0x8983, 0x8992, 0x89A2, 0x89B2, 0x89C2, 0x89D2, 0x89E1, 0x89F1,
+			0x8A01, 0x8A10, 0x8A20, 0x8A30, 0x8A40, 0x8A4F, 0x8A5F, 0x8A6F,
+			0x8A7E, 0x8A8E, 0x8A9E, 0x8AAD, 0x8ABD, 0x8ACC, 0x8ADC, 0x8AEC,
+			0x8AFB, 0x8B0B, 0x8B1A, 0x8B2A, 0x8B39, 0x8B49, 0x8B58, 0x8B68,
+			0x8B77, 0x8B87, 0x8B96, 0x8BA6, 0x8BB5, 0x8BC5, 0x8BD4, 0x8BE4,
+			0x8BF3, 0x8C03, 0x8C12, 0x8C22, 0x8C31, 0x8C40, 0x8C50, 0x8C5F,
+			0x8C6F, 0x8C7E, 0x8C8D, 0x8C9D, 0x8CAC, 0x8CBB, 0x8CCB, 0x8CDA,
+			0x8CE9, 0x8CF9, 0x8D08, 0x8D17, 0x8D26, 0x8D36, 0x8D45, 0x8D54,
+			0x8D63, 0x8D73, 0x8D82, 0x8D91, 0x8DA0, 0x8DB0, 0x8DBF, 0x8DCE,
+			0x8DDD, 0x8DEC, 0x8DFB, 0x8E0B, 0x8E1A, 0x8E29, 0x8E38, 0x8E47,
+			0x8E56, 0x8E65, 0x8E75, 0x8E84, 0x8E93, 0x8EA2, 0x8EB1, 0x8EC0,
+			0x8ECF, 0x8EDE, 0x8EED, 0x8EFC, 0x8F0B, 0x8F1A, 0x8F29, 0x8F38,
+			0x8F47, 0x8F56, 0x8F65, 0x8F74, 0x8F83, 0x8F92, 0x8FA1, 0x8FB0,
+			0x8FBF, 0x8FCE, 0x8FDD, 0x8FEB, 0x8FFA, 0x9009, 0x9018, 0x9027,
+			0x9036, 0x9045, 0x9054, 0x9062, 0x9071, 0x9080, 0x908F, 0x909E,
+			0x90AD, 0x90BB, 0x90CA, 0x90D9, 0x90E8, 0x90F6, 0x9105, 0x9114,
+			0x9123, 0x9131, 0x9140, 0x914F, 0x915E, 0x916C, 0x917B, 0x918A,
+			0x9198, 0x91A7, 0x91B6, 0x91C4, 0x91D3, 0x91E2, 0x91F0, 0x91FF,
+			0x920E, 0x921C, 0x922B, 0x9239, 0x9248, 0x9257, 0x9265, 0x9274,
+			0x9282, 0x9291, 0x92A0, 0x92AE, 0x92BD, 0x92CB, 0x92DA, 0x92E8,
+			0x92F7, 0x9305, 0x9314, 0x9322, 0x9331, 0x933F, 0x934E, 0x935C,
+			0x936B, 0x9379, 0x9387, 0x9396, 0x93A4, 0x93B3, 0x93C1, 0x93D0,
+			0x93DE, 0x93EC, 0x93FB, 0x9409, 0x9417, 0x9426, 0x9434, 0x9443,
+			0x9451, 0x945F, 0x946E, 0x947C, 0x948A, 0x9498, 0x94A7, 0x94B5,
+			0x94C3, 0x94D2, 0x94E0, 0x94EE, 0x94FC, 0x950B, 0x9519, 0x9527,
+			0x9535, 0x9544, 0x9552, 0x9560, 0x956E, 0x957C, 0x958B, 0x9599,
+			0x95A7, 0x95B5, 0x95C3, 0x95D2, 0x95E0, 0x95EE, 0x95FC, 0x960A,
+			0x9618, 0x9626, 0x9634, 0x9643, 0x9651, 0x965F, 0x966D, 0x967B,
+			0x9689, 0x9697, 0x96A5, 0x96B3, 0x96C1, 0x96CF, 0x96DD, 0x96EB,
+			0x96F9, 0x9707, 0x9715, 0x9723, 0x9731, 0x973F, 0x974D, 0x975B,
+			0x9769, 0x9777, 0x9785, 0x9793, 0x97A1, 0x97AF, 0x97BD, 0x97CB,
+			0x97D9, 0x97E7, 0x97F5, 0x9803, 0x9810, 0x981E, 0x982C, 0x983A,
+			0x9848, 0x9856, 0x9864, 0x9871, 0x987F, 0x988D, 0x989B, 0x98A9,
+			0x98B7, 0x98C4, 0x98D2, 0x98E0, 0x98EE, 0x98FC, 0x9909, 0x9917,
+			0x9925, 0x9933, 0x9940, 0x994E, 0x995C, 0x996A, 0x9977, 0x9985,
+			0x9993, 0x99A1, 0x99AE, 0x99BC, 0x99CA, 0x99D7, 0x99E5, 0x99F3,
+			0x9A00, 0x9A0E, 0x9A1C, 0x9A29, 0x9A37, 0x9A45, 0x9A52, 0x9A60,
+			0x9A6D, 0x9A7B, 0x9A89, 0x9A96, 0x9AA4, 0x9AB1, 0x9ABF, 0x9ACD,
+			0x9ADA, 0x9AE8, 0x9AF5, 0x9B03, 0x9B10, 0x9B1E, 0x9B2C, 0x9B39,
+			0x9B47, 0x9B54, 0x9B62, 0x9B6F, 0x9B7D, 0x9B8A, 0x9B98, 0x9BA5,
+			0x9BB3, 0x9BC0, 0x9BCE, 0x9BDB, 0x9BE8, 0x9BF6, 0x9C03, 0x9C11,
+			0x9C1E, 0x9C2C, 0x9C39, 0x9C46, 0x9C54, 0x9C61, 0x9C6F, 0x9C7C,
+			0x9C89, 0x9C97, 0x9CA4, 0x9CB2, 0x9CBF, 0x9CCC, 0x9CDA, 0x9CE7,
+			0x9CF4, 0x9D02, 0x9D0F, 0x9D1C, 0x9D2A, 0x9D37, 0x9D44, 0x9D52,
+			0x9D5F, 0x9D6C, 0x9D79, 0x9D87, 0x9D94, 0x9DA1, 0x9DAE, 0x9DBC,
+			0x9DC9, 0x9DD6, 0x9DE3, 0x9DF1, 0x9DFE, 0x9E0B, 0x9E18, 0x9E26,
+			0x9E33, 0x9E40, 0x9E4D, 0x9E5A, 0x9E67, 0x9E75, 0x9E82, 0x9E8F,
+			0x9E9C, 0x9EA9, 0x9EB6, 0x9EC4, 0x9ED1, 0x9EDE, 0x9EEB, 0x9EF8,
+			0x9F05, 0x9F12, 0x9F1F, 0x9F2D, 0x9F3A, 0x9F47, 0x9F54, 0x9F61,
+			0x9F6E, 0x9F7B, 0x9F88, 0x9F95, 0x9FA2, 0x9FAF, 0x9FBC, 0x9FC9,
+			0x9FD6, 0x9FE3, 0x9FF0, 0x9FFD, 0xA00A, 0xA017, 0xA024, 0xA031,
+			0xA03E, 0xA04B, 0xA058, 0xA065, 0xA072, 0xA07F, 0xA08C, 0xA099,
+			0xA0A6, 0xA0B3, 0xA0C0, 0xA0CD, 0xA0DA, 0xA0E7, 0xA0F4, 0xA101,
+			0xA10E, 0xA11A, 0xA127, 0xA134, 0xA141, 0xA14E, 0xA15B, 0xA168,
+			0xA175, 0xA181, 0xA18E, 0xA19B, 0xA1A8, 0xA1B5, 0xA1C2, 0xA1CE,
+			0xA1DB, 0xA1E8, 0xA1F5, 0xA202, 0xA20F, 0xA21B, 0xA228, 0xA235,
+			0xA242, 0xA24E, 0xA25B, 0xA268, 0xA275, 0xA281, 0xA28E, 0xA29B,
+			0xA2A8, 0xA2B4, 0xA2C1, 0xA2CE, 0xA2DB, 0xA2E7, 0xA2F4, 0xA301,
+			0xA30D, 0xA31A, 0xA327, 0xA334, 0xA340, 0xA34D, 0xA35A, 0xA366,
+			0xA373, 0xA380, 0xA38C, 0xA399, 0xA3A5, 0xA3B2, 0xA3BF, 0xA3CB,
+			0xA3D8, 0xA3E5, 0xA3F1, 0xA3FE, 0xA40A, 0xA417, 0xA424, 0xA430,
+			0xA43D, 0xA449, 0xA456, 0xA462, 0xA46F, 0xA47C, 0xA488, 0xA495,
+			0xA4A1, 0xA4AE, 0xA4BA, 0xA4C7, 0xA4D3, 0xA4E0, 0xA4EC, 0xA4F9,
+			0xA505, 0xA512, 0xA51E, 0xA52B, 0xA537, 0xA544, 0xA550, 0xA55D,
+			0xA569, 0xA576, 0xA582, 0xA58F, 0xA59B, 0xA5A8, 0xA5B4, 0xA5C0,
+			0xA5CD, 0xA5D9, 0xA5E6, 0xA5F2, 0xA5FF, 0xA60B, 0xA617, 0xA624,
+			0xA630, 0xA63D, 0xA649, 0xA655, 0xA662, 0xA66E, 0xA67A, 0xA687,
+			0xA693, 0xA69F, 0xA6AC, 0xA6B8, 0xA6C4, 0xA6D1, 0xA6DD, 0xA6E9,
+			0xA6F6, 0xA702, 0xA70E, 0xA71B, 0xA727, 0xA733, 0xA740, 0xA74C,
+			0xA758, 0xA764, 0xA771, 0xA77D, 0xA789, 0xA795, 0xA7A2, 0xA7AE,
+			0xA7BA, 0xA7C6, 0xA7D3, 0xA7DF, 0xA7EB, 0xA7F7, 0xA804, 0xA810,
+			0xA81C, 0xA828, 0xA834, 0xA841, 0xA84D, 0xA859, 0xA865, 0xA871,
+			0xA87E, 0xA88A, 0xA896, 0xA8A2, 0xA8AE, 0xA8BA, 0xA8C7, 0xA8D3,
+			0xA8DF, 0xA8EB, 0xA8F7, 0xA903, 0xA90F, 0xA91B, 0xA928, 0xA934,
+			0xA940, 0xA94C, 0xA958, 0xA964, 0xA970, 0xA97C, 0xA988, 0xA994,
+			0xA9A0, 0xA9AC, 0xA9B9, 0xA9C5, 0xA9D1, 0xA9DD, 0xA9E9, 0xA9F5,
+			0xAA01, 0xAA0D, 0xAA19, 0xAA25, 0xAA31, 0xAA3D, 0xAA49, 0xAA55,
+			0xAA61, 0xAA6D, 0xAA79, 0xAA85, 0xAA91, 0xAA9D, 0xAAA9, 0xAAB5,
+			0xAAC1, 0xAACD, 0xAAD9, 0xAAE5, 0xAAF1, 0xAAFD, 0xAB08, 0xAB14,
+			0xAB20, 0xAB2C, 0xAB38, 0xAB44, 0xAB50, 0xAB5C, 0xAB68, 0xAB74,
+			0xAB80, 0xAB8C, 0xAB97, 0xABA3, 0xABAF, 0xABBB, 0xABC7, 0xABD3,
+			0xABDF, 0xABEB, 0xABF6, 0xAC02, 0xAC0E, 0xAC1A, 0xAC26, 0xAC32,
+			0xAC3D, 0xAC49, 0xAC55, 0xAC61, 0xAC6D, 0xAC79, 0xAC84, 0xAC90,
+			0xAC9C, 0xACA8, 0xACB4, 0xACBF, 0xACCB, 0xACD7, 0xACE3, 0xACEE,
+			0xACFA, 0xAD06, 0xAD12, 0xAD1D, 0xAD29, 0xAD35, 0xAD41, 0xAD4C,
+			0xAD58, 0xAD64, 0xAD70, 0xAD7B, 0xAD87, 0xAD93, 0xAD9E, 0xADAA,
+			0xADB6, 0xADC2, 0xADCD, 0xADD9, 0xADE5, 0xADF0, 0xADFC, 0xAE08,
+			0xAE13, 0xAE1F, 0xAE2B, 0xAE36, 0xAE42, 0xAE4E, 0xAE59, 0xAE65,
+			0xAE71, 0xAE7C, 0xAE88, 0xAE93, 0xAE9F, 0xAEAB, 0xAEB6, 0xAEC2,
+			0xAECE, 0xAED9, 0xAEE5, 0xAEF0, 0xAEFC, 0xAF08, 0xAF13, 0xAF1F,
+			0xAF2A, 0xAF36, 0xAF41, 0xAF4D, 0xAF59, 0xAF64, 0xAF70, 0xAF7B,
+			0xAF87, 0xAF92, 0xAF9E, 0xAFA9, 0xAFB5, 0xAFC0, 0xAFCC, 0xAFD7,
+			0xAFE3, 0xAFEE, 0xAFFA, 0xB006, 0xB011, 0xB01D, 0xB028, 0xB033,
+			0xB03F, 0xB04A, 0xB056, 0xB061, 0xB06D, 0xB078, 0xB084, 0xB08F,
+			0xB09B, 0xB0A6, 0xB0B2, 0xB0BD, 0xB0C8, 0xB0D4, 0xB0DF, 0xB0EB,
+			0xB0F6, 0xB102, 0xB10D, 0xB118, 0xB124, 0xB12F, 0xB13B, 0xB146,
+			0xB151, 0xB15D, 0xB168, 0xB174, 0xB17F, 0xB18A, 0xB196, 0xB1A1,
+			0xB1AC, 0xB1B8, 0xB1C3, 0xB1CF, 0xB1DA, 0xB1E5, 0xB1F1, 0xB1FC,
+			0xB207, 0xB213, 0xB21E, 0xB229, 0xB235, 0xB240, 0xB24B, 0xB257,
+			0xB262, 0xB26D, 0xB278, 0xB284, 0xB28F, 0xB29A, 0xB2A6, 0xB2B1,
+			0xB2BC, 0xB2C7, 0xB2D3, 0xB2DE, 0xB2E9, 0xB2F4, 0xB300, 0xB30B,
+			0xB316, 0xB321, 0xB32D, 0xB338, 0xB343, 0xB34E, 0xB35A, 0xB365,
+			0xB370, 0xB37B, 0xB387, 0xB392, 0xB39D, 0xB3A8, 0xB3B3, 0xB3BF,
+			0xB3CA, 0xB3D5, 0xB3E0, 0xB3EB, 0xB3F6, 0xB402, 0xB40D, 0xB418,
+			0xB423, 0xB42E, 0xB439, 0xB445, 0xB450, 0xB45B, 0xB466, 0xB471,
+			0xB47C, 0xB487, 0xB493, 0xB49E, 0xB4A9, 0xB4B4, 0xB4BF, 0xB4CA,
+			0xB4D5, 0xB4E0, 0xB4EC, 0xB4F7, 0xB502, 0xB50D, 0xB518, 0xB523,
+			0xB52E, 0xB539, 0xB544, 0xB54F, 0xB55A, 0xB565, 0xB570, 0xB57C,
+			0xB587, 0xB592, 0xB59D, 0xB5A8, 0xB5B3, 0xB5BE, 0xB5C9, 0xB5D4,
+			0xB5DF, 0xB5EA, 0xB5F5, 0xB600, 0xB60B, 0xB616, 0xB621, 0xB62C,
+			0xB637, 0xB642, 0xB64D, 0xB658, 0xB663, 0xB66E, 0xB679, 0xB684,
+			0xB68F, 0xB69A, 0xB6A5, 0xB6B0, 0xB6BB, 0xB6C6, 0xB6D1, 0xB6DC,
+			0xB6E6, 0xB6F1, 0xB6FC, 0xB707, 0xB712, 0xB71D, 0xB728, 0xB733,
+			0xB73E, 0xB749, 0xB754, 0xB75F, 0xB76A, 0xB774, 0xB77F, 0xB78A,
+			0xB795, 0xB7A0, 0xB7AB, 0xB7B6, 0xB7C1, 0xB7CC, 0xB7D6, 0xB7E1,
+			0xB7EC, 0xB7F7, 0xB802, 0xB80D, 0xB818, 0xB822, 0xB82D, 0xB838,
+			0xB843, 0xB84E, 0xB859, 0xB863, 0xB86E, 0xB879, 0xB884, 0xB88F,
+			0xB89A, 0xB8A4, 0xB8AF, 0xB8BA, 0xB8C5, 0xB8D0, 0xB8DA, 0xB8E5,
+			0xB8F0, 0xB8FB, 0xB906, 0xB910, 0xB91B, 0xB926, 0xB931, 0xB93B,
+			0xB946, 0xB951, 0xB95C, 0xB966, 0xB971, 0xB97C, 0xB987, 0xB991,
+			0xB99C, 0xB9A7, 0xB9B2, 0xB9BC, 0xB9C7, 0xB9D2, 0xB9DC, 0xB9E7,
+			0xB9F2, 0xB9FD, 0xBA07, 0xBA12, 0xBA1D, 0xBA27, 0xBA32, 0xBA3D,
+			0xBA48, 0xBA52, 0xBA5D, 0xBA68, 0xBA72, 0xBA7D, 0xBA88, 0xBA92,
+			0xBA9D, 0xBAA8, 0xBAB2, 0xBABD, 0xBAC8, 0xBAD2, 0xBADD, 0xBAE7,
+			0xBAF2, 0xBAFD, 0xBB07, 0xBB12, 0xBB1D, 0xBB27, 0xBB32, 0xBB3C,
+			0xBB47, 0xBB52, 0xBB5C, 0xBB67, 0xBB72, 0xBB7C, 0xBB87, 0xBB91,
+			0xBB9C, 0xBBA6, 0xBBB1, 0xBBBC, 0xBBC6, 0xBBD1, 0xBBDB, 0xBBE6,
+			0xBBF0, 0xBBFB, 0xBC06, 0xBC10, 0xBC1B, 0xBC25, 0xBC30, 0xBC3A,
+			0xBC45, 0xBC4F, 0xBC5A, 0xBC64, 0xBC6F, 0xBC7A, 0xBC84, 0xBC8F,
+			0xBC99, 0xBCA4, 0xBCAE, 0xBCB9, 0xBCC3, 0xBCCE, 0xBCD8, 0xBCE3,
+			0xBCED, 0xBCF8, 0xBD02, 0xBD0D, 0xBD17, 0xBD22, 0xBD2C, 0xBD36,
+			0xBD41, 0xBD4B, 0xBD56, 0xBD60, 0xBD6B, 0xBD75, 0xBD80, 0xBD8A,
+			0xBD95, 0xBD9F, 0xBDA9, 0xBDB4, 0xBDBE, 0xBDC9, 0xBDD3, 0xBDDE,
+			0xBDE8, 0xBDF2, 0xBDFD, 0xBE07, 0xBE12, 0xBE1C, 0xBE27, 0xBE31,
+			0xBE3B, 0xBE46, 0xBE50, 0xBE5B, 0xBE65, 0xBE6F, 0xBE7A, 0xBE84,
+			0xBE8E, 0xBE99, 0xBEA3, 0xBEAE, 0xBEB8, 0xBEC2, 0xBECD, 0xBED7,
+			0xBEE1, 0xBEEC, 0xBEF6, 0xBF00, 0xBF0B, 0xBF15, 0xBF1F, 0xBF2A,
+			0xBF34, 0xBF3E, 0xBF49, 0xBF53, 0xBF5D, 0xBF68, 0xBF72, 0xBF7C,
+			0xBF87, 0xBF91, 0xBF9B, 0xBFA6, 0xBFB0, 0xBFBA, 0xBFC4, 0xBFCF,
+			0xBFD9, 0xBFE3, 0xBFEE, 0xBFF8, 0xC002, 0xC00C, 0xC017, 0xC021,
+			0xC02B, 0xC035, 0xC040, 0xC04A, 0xC054, 0xC05E, 0xC069, 0xC073,
+			0xC07D, 0xC087, 0xC092, 0xC09C, 0xC0A6, 0xC0B0, 0xC0BB, 0xC0C5,
+			0xC0CF, 0xC0D9, 0xC0E3, 0xC0EE, 0xC0F8, 0xC102, 0xC10C, 0xC116,
+			0xC121, 0xC12B, 0xC135, 0xC13F, 0xC149, 0xC154, 0xC15E, 0xC168,
+			0xC172, 0xC17C, 0xC186, 0xC191, 0xC19B, 0xC1A5, 0xC1AF, 0xC1B9,
+			0xC1C3, 0xC1CE, 0xC1D8, 0xC1E2, 0xC1EC, 0xC1F6, 0xC200, 0xC20A,
+			0xC214, 0xC21F, 0xC229, 0xC233, 0xC23D, 0xC247, 0xC251, 0xC25B,
+			0xC265, 0xC270, 0xC27A, 0xC284, 0xC28E, 0xC298, 0xC2A2, 0xC2AC,
+			0xC2B6, 0xC2C0, 0xC2CA, 0xC2D4, 0xC2DF, 0xC2E9, 0xC2F3, 0xC2FD,
+			0xC307, 0xC311, 0xC31B, 0xC325, 0xC32F, 0xC339, 0xC343, 0xC34D,
+			0xC357, 0xC361, 0xC36B, 0xC375, 0xC37F, 0xC389, 0xC393, 0xC39E,
+			0xC3A8, 0xC3B2, 0xC3BC, 0xC3C6, 0xC3D0, 0xC3DA, 0xC3E4, 0xC3EE,
+			0xC3F8, 0xC402, 0xC40C, 0xC416, 0xC420, 0xC42A, 0xC434, 0xC43E,
+			0xC448, 0xC452, 0xC45C, 0xC465, 0xC46F, 0xC479, 0xC483, 0xC48D,
+			0xC497, 0xC4A1, 0xC4AB, 0xC4B5, 0xC4BF, 0xC4C9, 0xC4D3, 0xC4DD,
+			0xC4E7, 0xC4F1, 0xC4FB, 0xC505, 0xC50F, 0xC519, 0xC523, 0xC52C,
+			0xC536, 0xC540, 0xC54A, 0xC554, 0xC55E, 0xC568, 0xC572, 0xC57C,
+			0xC586, 0xC590, 0xC599, 0xC5A3, 0xC5AD, 0xC5B7, 0xC5C1, 0xC5CB,
+			0xC5D5, 0xC5DF, 0xC5E9, 0xC5F2, 0xC5FC, 0xC606, 0xC610, 0xC61A,
+			0xC624, 0xC62E, 0xC637, 0xC641, 0xC64B, 0xC655, 0xC65F, 0xC669,
+			0xC673, 0xC67C, 0xC686, 0xC690, 0xC69A, 0xC6A4, 0xC6AE, 0xC6B7,
+			0xC6C1, 0xC6CB, 0xC6D5, 0xC6DF, 0xC6E8, 0xC6F2, 0xC6FC, 0xC706,
+			0xC710, 0xC719, 0xC723, 0xC72D, 0xC737, 0xC741, 0xC74A, 0xC754,
+			0xC75E, 0xC768, 0xC772, 0xC77B, 0xC785, 0xC78F, 0xC799, 0xC7A2,
+			0xC7AC, 0xC7B6, 0xC7C0, 0xC7C9, 0xC7D3, 0xC7DD, 0xC7E7, 0xC7F0,
+			0xC7FA, 0xC804, 0xC80E, 0xC817, 0xC821, 0xC82B, 0xC835, 0xC83E,
+			0xC848, 0xC852, 0xC85B, 0xC865, 0xC86F, 0xC879, 0xC882, 0xC88C,
+			0xC896, 0xC89F, 0xC8A9, 0xC8B3, 0xC8BC, 0xC8C6, 0xC8D0, 0xC8DA,
+			0xC8E3, 0xC8ED, 0xC8F7, 0xC900, 0xC90A, 0xC914, 0xC91D, 0xC927,
+			0xC931, 0xC93A, 0xC944, 0xC94E, 0xC957, 0xC961, 0xC96B, 0xC974,
+			0xC97E, 0xC987, 0xC991, 0xC99B, 0xC9A4, 0xC9AE, 0xC9B8, 0xC9C1,
+			0xC9CB, 0xC9D5, 0xC9DE, 0xC9E8, 0xC9F1, 0xC9FB, 0xCA05, 0xCA0E,
+			0xCA18, 0xCA21, 0xCA2B, 0xCA35, 0xCA3E, 0xCA48, 0xCA51, 0xCA5B,
+			0xCA65, 0xCA6E, 0xCA78, 0xCA81, 0xCA8B, 0xCA95, 0xCA9E, 0xCAA8,
+			0xCAB1, 0xCABB, 0xCAC4, 0xCACE, 0xCAD8, 0xCAE1, 0xCAEB, 0xCAF4,
+			0xCAFE, 0xCB07, 0xCB11, 0xCB1A, 0xCB24, 0xCB2D, 0xCB37, 0xCB41,
+			0xCB4A, 0xCB54, 0xCB5D, 0xCB67, 0xCB70, 0xCB7A, 0xCB83, 0xCB8D,
+			0xCB96, 0xCBA0, 0xCBA9, 0xCBB3, 0xCBBC, 0xCBC6, 0xCBCF, 0xCBD9,
+			0xCBE2, 0xCBEC, 0xCBF5, 0xCBFF, 0xCC08, 0xCC12, 0xCC1B, 0xCC25,
+			0xCC2E, 0xCC38, 0xCC41, 0xCC4B, 0xCC54, 0xCC5E, 0xCC67, 0xCC71,
+			0xCC7A, 0xCC83, 0xCC8D, 0xCC96, 0xCCA0, 0xCCA9, 0xCCB3, 0xCCBC,
+			0xCCC6, 0xCCCF, 0xCCD9, 0xCCE2, 0xCCEB, 0xCCF5, 0xCCFE, 0xCD08,
+			0xCD11, 0xCD1B, 0xCD24, 0xCD2D, 0xCD37, 0xCD40, 0xCD4A, 0xCD53,
+			0xCD5C, 0xCD66, 0xCD6F, 0xCD79, 0xCD82, 0xCD8B, 0xCD95, 0xCD9E,
+			0xCDA8, 0xCDB1, 0xCDBA, 0xCDC4, 0xCDCD, 0xCDD7, 0xCDE0, 0xCDE9,
+			0xCDF3, 0xCDFC, 0xCE05, 0xCE0F, 0xCE18, 0xCE22, 0xCE2B, 0xCE34,
+			0xCE3E, 0xCE47, 0xCE50, 0xCE5A, 0xCE63, 0xCE6C, 0xCE76, 0xCE7F,
+			0xCE88, 0xCE92, 0xCE9B, 0xCEA4, 0xCEAE, 0xCEB7, 0xCEC0, 0xCECA,
+			0xCED3, 0xCEDC, 0xCEE6, 0xCEEF, 0xCEF8, 0xCF02, 0xCF0B, 0xCF14,
+			0xCF1E, 0xCF27, 0xCF30, 0xCF39, 0xCF43, 0xCF4C, 0xCF55, 0xCF5F,
+			0xCF68, 0xCF71, 0xCF7A, 0xCF84, 0xCF8D, 0xCF96, 0xCFA0, 0xCFA9,
+			0xCFB2, 0xCFBB, 0xCFC5, 0xCFCE, 0xCFD7, 0xCFE0, 0xCFEA, 0xCFF3,
+			0xCFFC, 0xD005, 0xD00F, 0xD018, 0xD021, 0xD02A, 0xD034, 0xD03D,
+			0xD046, 0xD04F, 0xD059, 0xD062, 0xD06B, 0xD074, 0xD07E, 0xD087,
+			0xD090, 0xD099, 0xD0A2, 0xD0AC, 0xD0B5, 0xD0BE, 0xD0C7, 0xD0D0,
+			0xD0DA, 0xD0E3, 0xD0EC, 0xD0F5, 0xD0FE, 0xD108, 0xD111, 0xD11A,
+			0xD123, 0xD12C, 0xD136, 0xD13F, 0xD148, 0xD151, 0xD15A, 0xD163,
+			0xD16D, 0xD176, 0xD17F, 0xD188, 0xD191, 0xD19A, 0xD1A4, 0xD1AD,
+			0xD1B6, 0xD1BF, 0xD1C8, 0xD1D1, 0xD1DB, 0xD1E4, 0xD1ED, 0xD1F6,
+			0xD1FF, 0xD208, 0xD211, 0xD21A, 0xD224, 0xD22D, 0xD236, 0xD23F,
+			0xD248, 0xD251, 0xD25A, 0xD263, 0xD26D, 0xD276, 0xD27F, 0xD288,
+			0xD291, 0xD29A, 0xD2A3, 0xD2AC, 0xD2B5, 0xD2BF, 0xD2C8, 0xD2D1,
+			0xD2DA, 0xD2E3, 0xD2EC, 0xD2F5, 0xD2FE, 0xD307, 0xD310, 0xD319,
+			0xD322, 0xD32B, 0xD335, 0xD33E, 0xD347, 0xD350, 0xD359, 0xD362,
+			0xD36B, 0xD374, 0xD37D, 0xD386, 0xD38F, 0xD398, 0xD3A1, 0xD3AA,
+			0xD3B3, 0xD3BC, 0xD3C5, 0xD3CE, 0xD3D7, 0xD3E0, 0xD3EA, 0xD3F3,
+			0xD3FC, 0xD405, 0xD40E, 0xD417, 0xD420, 0xD429, 0xD432, 0xD43B,
+			0xD444, 0xD44D, 0xD456, 0xD45F, 0xD468, 0xD471, 0xD47A, 0xD483,
+			0xD48C, 0xD495, 0xD49E, 0xD4A7, 0xD4B0, 0xD4B9, 0xD4C2, 0xD4CB,
+			0xD4D4, 0xD4DD, 0xD4E6, 0xD4EF, 0xD4F7, 0xD500, 0xD509, 0xD512,
+			0xD51B, 0xD524, 0xD52D, 0xD536, 0xD53F, 0xD548, 0xD551, 0xD55A,
+			0xD563, 0xD56C, 0xD575, 0xD57E, 0xD587, 0xD590, 0xD599, 0xD5A2,
+			0xD5AA, 0xD5B3, 0xD5BC, 0xD5C5, 0xD5CE, 0xD5D7, 0xD5E0, 0xD5E9,
+			0xD5F2, 0xD5FB, 0xD604, 0xD60D, 0xD616, 0xD61E, 0xD627, 0xD630,
+			0xD639, 0xD642, 0xD64B, 0xD654, 0xD65D, 0xD666, 0xD66F, 0xD677,
+			0xD680, 0xD689, 0xD692, 0xD69B, 0xD6A4, 0xD6AD, 0xD6B6, 0xD6BE,
+			0xD6C7, 0xD6D0, 0xD6D9, 0xD6E2, 0xD6EB, 0xD6F4, 0xD6FD, 0xD705,
+			0xD70E, 0xD717, 0xD720, 0xD729, 0xD732, 0xD73A, 0xD743, 0xD74C,
+			0xD755, 0xD75E, 0xD767, 0xD770, 0xD778, 0xD781, 0xD78A, 0xD793,
+			0xD79C, 0xD7A5, 0xD7AD, 0xD7B6, 0xD7BF, 0xD7C8, 0xD7D1, 0xD7D9,
+			0xD7E2, 0xD7EB, 0xD7F4, 0xD7FD, 0xD805, 0xD80E, 0xD817, 0xD820,
+			0xD829, 0xD831, 0xD83A, 0xD843, 0xD84C, 0xD855, 0xD85D, 0xD866,
+			0xD86F, 0xD878, 0xD881, 0xD889, 0xD892, 0xD89B, 0xD8A4, 0xD8AC,
+			0xD8B5, 0xD8BE, 0xD8C7, 0xD8CF, 0xD8D8, 0xD8E1, 0xD8EA, 0xD8F2,
+			0xD8FB, 0xD904, 0xD90D, 0xD915, 0xD91E, 0xD927, 0xD930, 0xD938,
+			0xD941, 0xD94A, 0xD953, 0xD95B, 0xD964, 0xD96D, 0xD976, 0xD97E,
+			0xD987, 0xD990, 0xD998, 0xD9A1, 0xD9AA, 0xD9B3, 0xD9BB, 0xD9C4,
+			0xD9CD, 0xD9D5, 0xD9DE, 0xD9E7, 0xD9F0, 0xD9F8, 0xDA01, 0xDA0A,
+			0xDA12, 0xDA1B, 0xDA24, 0xDA2C, 0xDA35, 0xDA3E, 0xDA47, 0xDA4F,
+			0xDA58, 0xDA61, 0xDA69, 0xDA72, 0xDA7B, 0xDA83, 0xDA8C, 0xDA95,
+			0xDA9D, 0xDAA6, 0xDAAF, 0xDAB7, 0xDAC0, 0xDAC9, 0xDAD1, 0xDADA,
+			0xDAE3, 0xDAEB, 0xDAF4, 0xDAFC, 0xDB05, 0xDB0E, 0xDB16, 0xDB1F,
+			0xDB28, 0xDB30, 0xDB39, 0xDB42, 0xDB4A, 0xDB53, 0xDB5C, 0xDB64,
+			0xDB6D, 0xDB75, 0xDB7E, 0xDB87, 0xDB8F, 0xDB98, 0xDBA0, 0xDBA9,
+			0xDBB2, 0xDBBA, 0xDBC3, 0xDBCC, 0xDBD4, 0xDBDD, 0xDBE5, 0xDBEE,
+			0xDBF7, 0xDBFF, 0xDC08, 0xDC10, 0xDC19, 0xDC21, 0xDC2A, 0xDC33,
+			0xDC3B, 0xDC44, 0xDC4C, 0xDC55, 0xDC5E, 0xDC66, 0xDC6F, 0xDC77,
+			0xDC80, 0xDC88, 0xDC91, 0xDC9A, 0xDCA2, 0xDCAB, 0xDCB3, 0xDCBC,
+			0xDCC4, 0xDCCD, 0xDCD5, 0xDCDE, 0xDCE7, 0xDCEF, 0xDCF8, 0xDD00,
+			0xDD09, 0xDD11, 0xDD1A, 0xDD22, 0xDD2B, 0xDD33, 0xDD3C, 0xDD44,
+			0xDD4D, 0xDD56, 0xDD5E, 0xDD67, 0xDD6F, 0xDD78, 0xDD80, 0xDD89,
+			0xDD91, 0xDD9A, 0xDDA2, 0xDDAB, 0xDDB3, 0xDDBC, 0xDDC4, 0xDDCD,
+			0xDDD5, 0xDDDE, 0xDDE6, 0xDDEF, 0xDDF7, 0xDE00, 0xDE08, 0xDE11,
+			0xDE19, 0xDE22, 0xDE2A, 0xDE33, 0xDE3B, 0xDE44, 0xDE4C, 0xDE55,
+			0xDE5D, 0xDE66, 0xDE6E, 0xDE76, 0xDE7F, 0xDE87, 0xDE90, 0xDE98,
+			0xDEA1, 0xDEA9, 0xDEB2, 0xDEBA, 0xDEC3, 0xDECB, 0xDED4, 0xDEDC,
+			0xDEE4, 0xDEED, 0xDEF5, 0xDEFE, 0xDF06, 0xDF0F, 0xDF17, 0xDF20,
+			0xDF28, 0xDF30, 0xDF39, 0xDF41, 0xDF4A, 0xDF52, 0xDF5B, 0xDF63,
+			0xDF6B, 0xDF74, 0xDF7C, 0xDF85, 0xDF8D, 0xDF95, 0xDF9E, 0xDFA6,
+			0xDFAF, 0xDFB7, 0xDFC0, 0xDFC8, 0xDFD0, 0xDFD9, 0xDFE1, 0xDFEA,
+			0xDFF2, 0xDFFA, 0xE003, 0xE00B, 0xE014, 0xE01C, 0xE024, 0xE02D,
+			0xE035, 0xE03D, 0xE046, 0xE04E, 0xE057, 0xE05F, 0xE067, 0xE070,
+			0xE078, 0xE080, 0xE089, 0xE091, 0xE09A, 0xE0A2, 0xE0AA, 0xE0B3,
+			0xE0BB, 0xE0C3, 0xE0CC, 0xE0D4, 0xE0DC, 0xE0E5, 0xE0ED, 0xE0F5,
+			0xE0FE, 0xE106, 0xE10E, 0xE117, 0xE11F, 0xE127, 0xE130, 0xE138,
+			0xE141, 0xE149, 0xE151, 0xE159, 0xE162, 0xE16A, 0xE172, 0xE17B,
+			0xE183, 0xE18B, 0xE194, 0xE19C, 0xE1A4, 0xE1AD, 0xE1B5, 0xE1BD,
+			0xE1C6, 0xE1CE, 0xE1D6, 0xE1DF, 0xE1E7, 0xE1EF, 0xE1F7, 0xE200,
+			0xE208, 0xE210, 0xE219, 0xE221, 0xE229, 0xE231, 0xE23A, 0xE242,
+			0xE24A, 0xE253, 0xE25B, 0xE263, 0xE26B, 0xE274, 0xE27C, 0xE284,
+			0xE28D, 0xE295, 0xE29D, 0xE2A5, 0xE2AE, 0xE2B6, 0xE2BE, 0xE2C6,
+			0xE2CF, 0xE2D7, 0xE2DF, 0xE2E7, 0xE2F0, 0xE2F8, 0xE300, 0xE308,
+			0xE311, 0xE319, 0xE321, 0xE329, 0xE332, 0xE33A, 0xE342, 0xE34A,
+			0xE353, 0xE35B, 0xE363, 0xE36B, 0xE373, 0xE37C, 0xE384, 0xE38C,
+			0xE394, 0xE39D, 0xE3A5, 0xE3AD, 0xE3B5, 0xE3BD, 0xE3C6, 0xE3CE,
+			0xE3D6, 0xE3DE, 0xE3E6, 0xE3EF, 0xE3F7, 0xE3FF, 0xE407, 0xE40F,
+			0xE418, 0xE420, 0xE428, 0xE430, 0xE438, 0xE441, 0xE449, 0xE451,
+			0xE459, 0xE461, 0xE46A, 0xE472, 0xE47A, 0xE482, 0xE48A, 0xE492,
+			0xE49B, 0xE4A3, 0xE4AB, 0xE4B3, 0xE4BB, 0xE4C3, 0xE4CC, 0xE4D4,
+			0xE4DC, 0xE4E4, 0xE4EC, 0xE4F4, 0xE4FD, 0xE505, 0xE50D, 0xE515,
+			0xE51D, 0xE525, 0xE52D, 0xE536, 0xE53E, 0xE546, 0xE54E, 0xE556,
+			0xE55E, 0xE566, 0xE56F, 0xE577, 0xE57F, 0xE587, 0xE58F, 0xE597,
+			0xE59F, 0xE5A7, 0xE5B0, 0xE5B8, 0xE5C0, 0xE5C8, 0xE5D0, 0xE5D8,
+			0xE5E0, 0xE5E8, 0xE5F0, 0xE5F9, 0xE601, 0xE609, 0xE611, 0xE619,
+			0xE621, 0xE629, 0xE631, 0xE639, 0xE641, 0xE64A, 0xE652, 0xE65A,
+			0xE662, 0xE66A, 0xE672, 0xE67A, 0xE682, 0xE68A, 0xE692, 0xE69A,
+			0xE6A2, 0xE6AB, 0xE6B3, 0xE6BB, 0xE6C3, 0xE6CB, 0xE6D3, 0xE6DB,
+			0xE6E3, 0xE6EB, 0xE6F3, 0xE6FB, 0xE703, 0xE70B, 0xE713, 0xE71B,
+			0xE724, 0xE72C, 0xE734, 0xE73C, 0xE744, 0xE74C, 0xE754, 0xE75C,
+			0xE764, 0xE76C, 0xE774, 0xE77C, 0xE784, 0xE78C, 0xE794, 0xE79C,
+			0xE7A4, 0xE7AC, 0xE7B4, 0xE7BC, 0xE7C4, 0xE7CC, 0xE7D4, 0xE7DC,
+			0xE7E4, 0xE7EC, 0xE7F4, 0xE7FC, 0xE804, 0xE80C, 0xE814, 0xE81C,
+			0xE824, 0xE82C, 0xE835, 0xE83D, 0xE845, 0xE84D, 0xE855, 0xE85D,
+			0xE865, 0xE86D, 0xE874, 0xE87C, 0xE884, 0xE88C, 0xE894, 0xE89C,
+			0xE8A4, 0xE8AC, 0xE8B4, 0xE8BC, 0xE8C4, 0xE8CC, 0xE8D4, 0xE8DC,
+			0xE8E4, 0xE8EC, 0xE8F4, 0xE8FC, 0xE904, 0xE90C, 0xE914, 0xE91C,
+			0xE924, 0xE92C, 0xE934, 0xE93C, 0xE944, 0xE94C, 0xE954, 0xE95C,
+			0xE964, 0xE96C, 0xE974, 0xE97B, 0xE983, 0xE98B, 0xE993, 0xE99B,
+			0xE9A3, 0xE9AB, 0xE9B3, 0xE9BB, 0xE9C3, 0xE9CB, 0xE9D3, 0xE9DB,
+			0xE9E3, 0xE9EB, 0xE9F3, 0xE9FA, 0xEA02, 0xEA0A, 0xEA12, 0xEA1A,
+			0xEA22, 0xEA2A, 0xEA32, 0xEA3A, 0xEA42, 0xEA4A, 0xEA52, 0xEA59,
+			0xEA61, 0xEA69, 0xEA71, 0xEA79, 0xEA81, 0xEA89, 0xEA91, 0xEA99,
+			0xEAA1, 0xEAA8, 0xEAB0, 0xEAB8, 0xEAC0, 0xEAC8, 0xEAD0, 0xEAD8,
+			0xEAE0, 0xEAE8, 0xEAEF, 0xEAF7, 0xEAFF, 0xEB07, 0xEB0F, 0xEB17,
+			0xEB1F, 0xEB27, 0xEB2E, 0xEB36, 0xEB3E, 0xEB46, 0xEB4E, 0xEB56,
+			0xEB5E, 0xEB66, 0xEB6D, 0xEB75, 0xEB7D, 0xEB85, 0xEB8D, 0xEB95,
+			0xEB9D, 0xEBA4, 0xEBAC, 0xEBB4, 0xEBBC, 0xEBC4, 0xEBCC, 0xEBD3,
+			0xEBDB, 0xEBE3, 0xEBEB, 0xEBF3, 0xEBFB, 0xEC02, 0xEC0A, 0xEC12,
+			0xEC1A, 0xEC22, 0xEC2A, 0xEC31, 0xEC39, 0xEC41, 0xEC49, 0xEC51,
+			0xEC59, 0xEC60, 0xEC68, 0xEC70, 0xEC78, 0xEC80, 0xEC87, 0xEC8F,
+			0xEC97, 0xEC9F, 0xECA7, 0xECAF, 0xECB6, 0xECBE, 0xECC6, 0xECCE,
+			0xECD6, 0xECDD, 0xECE5, 0xECED, 0xECF5, 0xECFD, 0xED04, 0xED0C,
+			0xED14, 0xED1C, 0xED23, 0xED2B, 0xED33, 0xED3B, 0xED43, 0xED4A,
+			0xED52, 0xED5A, 0xED62, 0xED69, 0xED71, 0xED79, 0xED81, 0xED89,
+			0xED90, 0xED98, 0xEDA0, 0xEDA8, 0xEDAF, 0xEDB7, 0xEDBF, 0xEDC7,
+			0xEDCE, 0xEDD6, 0xEDDE, 0xEDE6, 0xEDED, 0xEDF5, 0xEDFD, 0xEE05,
+			0xEE0C, 0xEE14, 0xEE1C, 0xEE24, 0xEE2B, 0xEE33, 0xEE3B, 0xEE43,
+			0xEE4A, 0xEE52, 0xEE5A, 0xEE62, 0xEE69, 0xEE71, 0xEE79, 0xEE80,
+			0xEE88, 0xEE90, 0xEE98, 0xEE9F, 0xEEA7, 0xEEAF, 0xEEB7, 0xEEBE,
+			0xEEC6, 0xEECE, 0xEED5, 0xEEDD, 0xEEE5, 0xEEEC, 0xEEF4, 0xEEFC,
+			0xEF04, 0xEF0B, 0xEF13, 0xEF1B, 0xEF22, 0xEF2A, 0xEF32, 0xEF3A,
+			0xEF41, 0xEF49, 0xEF51, 0xEF58, 0xEF60, 0xEF68, 0xEF6F, 0xEF77,
+			0xEF7F, 0xEF86, 0xEF8E, 0xEF96, 0xEF9D, 0xEFA5, 0xEFAD, 0xEFB4,
+			0xEFBC, 0xEFC4, 0xEFCC, 0xEFD3, 0xEFDB, 0xEFE3, 0xEFEA, 0xEFF2,
+			0xEFFA, 0xF001, 0xF009, 0xF010, 0xF018, 0xF020, 0xF027, 0xF02F,
+			0xF037, 0xF03E, 0xF046, 0xF04E, 0xF055, 0xF05D, 0xF065, 0xF06C,
+			0xF074, 0xF07C, 0xF083, 0xF08B, 0xF093, 0xF09A, 0xF0A2, 0xF0A9,
+			0xF0B1, 0xF0B9, 0xF0C0, 0xF0C8, 0xF0D0, 0xF0D7, 0xF0DF, 0xF0E6,
+			0xF0EE, 0xF0F6, 0xF0FD, 0xF105, 0xF10D, 0xF114, 0xF11C, 0xF123,
+			0xF12B, 0xF133, 0xF13A, 0xF142, 0xF149, 0xF151, 0xF159, 0xF160,
+			0xF168, 0xF170, 0xF177, 0xF17F, 0xF186, 0xF18E, 0xF196, 0xF19D,
+			0xF1A5, 0xF1AC, 0xF1B4, 0xF1BB, 0xF1C3, 0xF1CB, 0xF1D2, 0xF1DA,
+			0xF1E1, 0xF1E9, 0xF1F1, 0xF1F8, 0xF200, 0xF207, 0xF20F, 0xF216,
+			0xF21E, 0xF226, 0xF22D, 0xF235, 0xF23C, 0xF244, 0xF24B, 0xF253,
+			0xF25B, 0xF262, 0xF26A, 0xF271, 0xF279, 0xF280, 0xF288, 0xF290,
+			0xF297, 0xF29F, 0xF2A6, 0xF2AE, 0xF2B5, 0xF2BD, 0xF2C4, 0xF2CC,
+			0xF2D3, 0xF2DB, 0xF2E3, 0xF2EA, 0xF2F2, 0xF2F9, 0xF301, 0xF308,
+			0xF310, 0xF317, 0xF31F, 0xF326, 0xF32E, 0xF335, 0xF33D, 0xF345,
+			0xF34C, 0xF354, 0xF35B, 0xF363, 0xF36A, 0xF372, 0xF379, 0xF381,
+			0xF388, 0xF390, 0xF397, 0xF39F, 0xF3A6, 0xF3AE, 0xF3B5, 0xF3BD,
+			0xF3C4, 0xF3CC, 0xF3D3, 0xF3DB, 0xF3E2, 0xF3EA, 0xF3F1, 0xF3F9,
+			0xF400, 0xF408, 0xF40F, 0xF417, 0xF41E, 0xF426, 0xF42D, 0xF435,
+			0xF43C, 0xF444, 0xF44B, 0xF453, 0xF45A, 0xF462, 0xF469, 0xF471,
+			0xF478, 0xF480, 0xF487, 0xF48F, 0xF496, 0xF49D, 0xF4A5, 0xF4AC,
+			0xF4B4, 0xF4BB, 0xF4C3, 0xF4CA, 0xF4D2, 0xF4D9, 0xF4E1, 0xF4E8,
+			0xF4F0, 0xF4F7, 0xF4FF, 0xF506, 0xF50D, 0xF515, 0xF51C, 0xF524,
+			0xF52B, 0xF533, 0xF53A, 0xF542, 0xF549, 0xF550, 0xF558, 0xF55F,
+			0xF567, 0xF56E, 0xF576, 0xF57D, 0xF585, 0xF58C, 0xF593, 0xF59B,
+			0xF5A2, 0xF5AA, 0xF5B1, 0xF5B9, 0xF5C0, 0xF5C7, 0xF5CF, 0xF5D6,
+			0xF5DE, 0xF5E5, 0xF5ED, 0xF5F4, 0xF5FB, 0xF603, 0xF60A, 0xF612,
+			0xF619, 0xF620, 0xF628, 0xF62F, 0xF637, 0xF63E, 0xF645, 0xF64D,
+			0xF654, 0xF65C, 0xF663, 0xF66B, 0xF672, 0xF679, 0xF681, 0xF688,
+			0xF68F, 0xF697, 0xF69E, 0xF6A6, 0xF6AD, 0xF6B4, 0xF6BC, 0xF6C3,
+			0xF6CB, 0xF6D2, 0xF6D9, 0xF6E1, 0xF6E8, 0xF6F0, 0xF6F7, 0xF6FE,
+			0xF706, 0xF70D, 0xF714, 0xF71C, 0xF723, 0xF72B, 0xF732, 0xF739,
+			0xF741, 0xF748, 0xF74F, 0xF757, 0xF75E, 0xF765, 0xF76D, 0xF774,
+			0xF77C, 0xF783, 0xF78A, 0xF792, 0xF799, 0xF7A0, 0xF7A8, 0xF7AF,
+			0xF7B6, 0xF7BE, 0xF7C5, 0xF7CC, 0xF7D4, 0xF7DB, 0xF7E2, 0xF7EA,
+			0xF7F1, 0xF7F8, 0xF800, 0xF807, 0xF80E, 0xF816, 0xF81D, 0xF824,
+			0xF82C, 0xF833, 0xF83A, 0xF842, 0xF849, 0xF850, 0xF858, 0xF85F,
+			0xF866, 0xF86E, 0xF875, 0xF87C, 0xF884, 0xF88B, 0xF892, 0xF89A,
+			0xF8A1, 0xF8A8, 0xF8B0, 0xF8B7, 0xF8BE, 0xF8C5, 0xF8CD, 0xF8D4,
+			0xF8DB, 0xF8E3, 0xF8EA, 0xF8F1, 0xF8F9, 0xF900, 0xF907, 0xF90E,
+			0xF916, 0xF91D, 0xF924, 0xF92C, 0xF933, 0xF93A, 0xF942, 0xF949,
+			0xF950, 0xF957, 0xF95F, 0xF966, 0xF96D, 0xF975, 0xF97C, 0xF983,
+			0xF98A, 0xF992, 0xF999, 0xF9A0, 0xF9A7, 0xF9AF, 0xF9B6, 0xF9BD,
+			0xF9C5, 0xF9CC, 0xF9D3, 0xF9DA, 0xF9E2, 0xF9E9, 0xF9F0, 0xF9F7,
+			0xF9FF, 0xFA06, 0xFA0D, 0xFA14, 0xFA1C, 0xFA23, 0xFA2A, 0xFA31,
+			0xFA39, 0xFA40, 0xFA47, 0xFA4E, 0xFA56, 0xFA5D, 0xFA64, 0xFA6B,
+			0xFA73, 0xFA7A, 0xFA81, 0xFA88, 0xFA90, 0xFA97, 0xFA9E, 0xFAA5,
+			0xFAAD, 0xFAB4, 0xFABB, 0xFAC2, 0xFACA, 0xFAD1, 0xFAD8, 0xFADF,
+			0xFAE6, 0xFAEE, 0xFAF5, 0xFAFC, 0xFB03, 0xFB0B, 0xFB12, 0xFB19,
+			0xFB20, 0xFB27, 0xFB2F, 0xFB36, 0xFB3D, 0xFB44, 0xFB4B, 0xFB53,
+			0xFB5A, 0xFB61, 0xFB68, 0xFB70, 0xFB77, 0xFB7E, 0xFB85, 0xFB8C,
+			0xFB94, 0xFB9B, 0xFBA2, 0xFBA9, 0xFBB0, 0xFBB7, 0xFBBF, 0xFBC6,
+			0xFBCD, 0xFBD4, 0xFBDB, 0xFBE3, 0xFBEA, 0xFBF1, 0xFBF8, 0xFBFF,
+			0xFC07, 0xFC0E, 0xFC15, 0xFC1C, 0xFC23, 0xFC2A, 0xFC32, 0xFC39,
+			0xFC40, 0xFC47, 0xFC4E, 0xFC56, 0xFC5D, 0xFC64, 0xFC6B, 0xFC72,
+			0xFC79, 0xFC81, 0xFC88, 0xFC8F, 0xFC96, 0xFC9D, 0xFCA4, 0xFCAB,
+			0xFCB3, 0xFCBA, 0xFCC1, 0xFCC8, 0xFCCF, 0xFCD6, 0xFCDE, 0xFCE5,
+			0xFCEC, 0xFCF3, 0xFCFA, 0xFD01, 0xFD08, 0xFD10, 0xFD17, 0xFD1E,
+			0xFD25, 0xFD2C, 0xFD33, 0xFD3A, 0xFD42, 0xFD49, 0xFD50, 0xFD57,
+			0xFD5E, 0xFD65, 0xFD6C, 0xFD73, 0xFD7B, 0xFD82, 0xFD89, 0xFD90,
+			0xFD97, 0xFD9E, 0xFDA5, 0xFDAC, 0xFDB4, 0xFDBB, 0xFDC2, 0xFDC9,
+			0xFDD0, 0xFDD7, 0xFDDE, 0xFDE5, 0xFDED, 0xFDF4, 0xFDFB, 0xFE02,
+			0xFE09, 0xFE10, 0xFE17, 0xFE1E, 0xFE25, 0xFE2C, 0xFE34, 0xFE3B,
+			0xFE42, 0xFE49, 0xFE50, 0xFE57, 0xFE5E, 0xFE65, 0xFE6C, 0xFE73,
+			0xFE7B, 0xFE82, 0xFE89, 0xFE90, 0xFE97, 0xFE9E, 0xFEA5, 0xFEAC,
+			0xFEB3, 0xFEBA, 0xFEC1, 0xFEC8, 0xFED0, 0xFED7, 0xFEDE, 0xFEE5,
+			0xFEEC, 0xFEF3, 0xFEFA, 0xFF01, 0xFF08, 0xFF0F, 0xFF16, 0xFF1D,
+			0xFF24, 0xFF2C, 0xFF33, 0xFF3A, 0xFF41, 0xFF48, 0xFF4F, 0xFF56,
+			0xFF5D, 0xFF64, 0xFF6B, 0xFF72, 0xFF79, 0xFF80, 0xFF87, 0xFF8E,
+			0xFF95, 0xFF9C, 0xFFA3, 0xFFAB, 0xFFB2, 0xFFB9, 0xFFC0, 0xFFC7,
+			0xFFCE, 0xFFD5, 0xFFDC, 0xFFE3, 0xFFEA, 0xFFF1, 0xFFF8, 0xFFFF
+		},
+
+		// sRGB8boundary
+		{
+			0.0f, 0.000151763496f, 0.000455290487f, 0.000758817478f,
+			0.00106234441f, 0.00136587152f, 0.00166939839f, 0.00197292538f,
+			0.00227645249f, 0.0025799796f, 0.00288350647f, 0.00318830018f,
+			0.00350925839f, 0.00384831452f, 0.00420574751f, 0.00458183186f,
+			0.00497683603f, 0.00539102359f, 0.00582464971f, 0.00627796818f,
+			0.0067512258f, 0.00724466611f, 0.00775852799f, 0.00829304755f,
+			0.00884845201f, 0.00942496955f, 0.0100228237f, 0.0106422342f,
+			0.0112834182f, 0.0119465888f, 0.0126319556f, 0.01333973f,
+			0.0140701095f, 0.0148232998f, 0.0155994995f, 0.0163989048f,
+			0.0172217116f, 0.0180681087f, 0.0189382881f, 0.0198324397f,
+			0.0207507405f, 0.0216933787f, 0.022660533f, 0.0236523841f,
+			0.0246691089f, 0.0257108808f, 0.0267778747f, 0.0278702658f,
+			0.0289882142f, 0.0301318951f, 0.0313014723f, 0.0324971117f,
+			0.0337189771f, 0.0349672325f, 0.036242038f, 0.0375435464f,
+			0.0388719179f, 0.0402273089f, 0.0416098759f, 0.0430197753f,
+			0.0444571525f, 0.0459221601f, 0.047414951f, 0.0489356704f,
+			0.0504844673f, 0.0520615019f, 0.0536668897f, 0.0553008057f,
+			0.0569633655f, 0.0586547218f, 0.0603750125f, 0.0621243864f,
+			0.0639029741f, 0.0657109171f, 0.0675483495f, 0.0694154128f,
+			0.0713122338f, 0.0732389539f, 0.0751956999f, 0.0771826059f,
+			0.0791998059f, 0.081247434f, 0.0833256096f, 0.085434489f,
+			0.0875741616f, 0.089744769f, 0.091946438f, 0.0941793025f,
+			0.0964434743f, 0.0987390876f, 0.101066262f, 0.103425123f,
+			0.105815791f, 0.108238392f, 0.110693038f, 0.113179855f,
+			0.115698956f, 0.118250467f, 0.1208345f, 0.123451203f,
+			0.126100644f, 0.128782958f, 0.131498262f, 0.134246662f,
+			0.137028292f, 0.13984327f, 0.142691672f, 0.145573646f,
+			0.148489296f, 0.151438713f, 0.154422045f, 0.157439366f,
+			0.160490811f, 0.163576469f, 0.166696459f, 0.169850931f,
+			0.173039913f, 0.176263556f, 0.179521963f, 0.182815239f,
+			0.186143488f, 0.189506784f, 0.192905307f, 0.19633916f,
+			0.199808359f, 0.203313053f, 0.206853345f, 0.210429341f,
+			0.214041144f, 0.217688844f, 0.22137256f, 0.225092381f,
+			0.228848413f, 0.232640758f, 0.236469507f, 0.240334749f,
+			0.244236618f, 0.248175189f, 0.252150565f, 0.256162822f,
+			0.260212094f, 0.264298439f, 0.268422008f, 0.272582829f,
+			0.276781052f, 0.281016767f, 0.285290033f, 0.289600968f,
+			0.293949664f, 0.298336238f, 0.30276075f, 0.30722329f,
+			0.311723977f, 0.316262901f, 0.32084021f, 0.325455844f,
+			0.330109984f, 0.334802747f, 0.339534163f, 0.344304383f,
+			0.349113435f, 0.353961468f, 0.358848542f, 0.363774776f,
+			0.368740201f, 0.373744935f, 0.378789097f, 0.383872747f,
+			0.388995975f, 0.39415884f, 0.399361491f, 0.404603958f,
+			0.40988636f, 0.415208787f, 0.420571297f, 0.425973982f,
+			0.431416959f, 0.436900288f, 0.442424059f, 0.447988331f,
+			0.453593224f, 0.459238827f, 0.4649252f, 0.470652431f,
+			0.476420611f, 0.482229829f, 0.488080233f, 0.493971765f,
+			0.499904543f, 0.505878687f, 0.511894286f, 0.517951369f,
+			0.524050117f, 0.530190527f, 0.536372662f, 0.542596698f,
+			0.548862636f, 0.555170596f, 0.561520636f, 0.567912817f,
+			0.574347258f, 0.580824077f, 0.587343276f, 0.593904912f,
+			0.600509167f, 0.607156038f, 0.613845646f, 0.620578051f,
+			0.627353311f, 0.634171546f, 0.641032815f, 0.647937179f,
+			0.654884696f, 0.661875546f, 0.668909669f, 0.675987244f,
+			0.68310833f, 0.690272927f, 0.697481334f, 0.704733312f,
+			0.712029099f, 0.719368756f, 0.7267524f, 0.734180033f,
+			0.741651714f, 0.749167621f, 0.756727755f, 0.764332235f,
+			0.771981061f, 0.779674351f, 0.787412226f, 0.795194685f,
+			0.803021789f, 0.810893714f, 0.818810463f, 0.826772094f,
+			0.834778726f, 0.84283036f, 0.850927174f, 0.859069109f,
+			0.867256343f, 0.875488937f, 0.88376683f, 0.89209038f,
+			0.90045929f, 0.908874035f, 0.917334259f, 0.925840437f,
+			0.934392393f, 0.942990363f, 0.95163399f, 0.960323989f,
+			0.969059825f, 0.977842093f, 0.986670315f, 0.995545208f,
+			2.0f
+		},
+
+		// sRGBtoLinear12_16
+		{
+			0x0000, 0x0001, 0x0002, 0x0004, 0x0005, 0x0006, 0x0007, 0x0009,
+			0x000A, 0x000B, 0x000C, 0x000E, 0x000F, 0x0010, 0x0011, 0x0013,
+			0x0014, 0x0015, 0x0016, 0x0018, 0x0019, 0x001A, 0x001B, 0x001C,
+			0x001E, 0x001F, 0x0020, 0x0021, 0x0023, 0x0024, 0x0025, 0x0026,
+			0x0028, 0x0029, 0x002A, 0x002B, 0x002D, 0x002E, 0x002F, 0x0030,
+			0x0032, 0x0033, 0x0034, 0x0035, 0x0037, 0x0038, 0x0039, 0x003A,
+			0x003B, 0x003D, 0x003E, 0x003F, 0x0040, 0x0042, 0x0043, 0x0044,
+			0x0045, 0x0047, 0x0048, 0x0049, 0x004A, 0x004C, 0x004D, 0x004E,
+			0x004F, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0057, 0x0058,
+			0x0059, 0x005A, 0x005C, 0x005D, 0x005E, 0x005F, 0x0061, 0x0062,
+			0x0063, 0x0064, 0x0066, 0x0067, 0x0068, 0x0069, 0x006B, 0x006C,
+			0x006D, 0x006E, 0x006F, 0x0071, 0x0072, 0x0073, 0x0074, 0x0076,
+			0x0077, 0x0078, 0x0079, 0x007B, 0x007C, 0x007D, 0x007E, 0x0080,
+			0x0081, 0x0082, 0x0083, 0x0085, 0x0086, 0x0087, 0x0088, 0x0089,
+			0x008B, 0x008C, 0x008D, 0x008E, 0x0090, 0x0091, 0x0092, 0x0093,
+			0x0095, 0x0096, 0x0097, 0x0098, 0x009A, 0x009B, 0x009C, 0x009D,
+			0x009F, 0x00A0, 0x00A1, 0x00A2, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+			0x00A8, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AF, 0x00B0, 0x00B1,
+			0x00B2, 0x00B4, 0x00B5, 0x00B6, 0x00B7, 0x00B9, 0x00BA, 0x00BB,
+			0x00BC, 0x00BE, 0x00BF, 0x00C0, 0x00C1, 0x00C2, 0x00C4, 0x00C5,
+			0x00C6, 0x00C7, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CE, 0x00CF,
+			0x00D0, 0x00D1, 0x00D3, 0x00D4, 0x00D5, 0x00D7, 0x00D8, 0x00D9,
+			0x00DA, 0x00DC, 0x00DD, 0x00DE, 0x00E0, 0x00E1, 0x00E2, 0x00E4,
+			0x00E5, 0x00E6, 0x00E8, 0x00E9, 0x00EA, 0x00EC, 0x00ED, 0x00EF,
+			0x00F0, 0x00F1, 0x00F3, 0x00F4, 0x00F6, 0x00F7, 0x00F8, 0x00FA,
+			0x00FB, 0x00FD, 0x00FE, 0x00FF, 0x0101, 0x0102, 0x0104, 0x0105,
+			0x0107, 0x0108, 0x010A, 0x010B, 0x010D, 0x010E, 0x010F, 0x0111,
+			0x0112, 0x0114, 0x0115, 0x0117, 0x0118, 0x011A, 0x011B, 0x011D,
+			0x011F, 0x0120, 0x0122, 0x0123, 0x0125, 0x0126, 0x0128, 0x0129,
+			0x012B, 0x012D, 0x012E, 0x0130, 0x0131, 0x0133, 0x0134, 0x0136,
+			0x0138, 0x0139, 0x013B, 0x013C, 0x013E, 0x0140, 0x0141, 0x0143,
+			0x0145, 0x0146, 0x0148, 0x014A, 0x014B, 0x014D, 0x014F, 0x0150,
+			0x0152, 0x0154, 0x0155, 0x0157, 0x0159, 0x015A, 0x015C, 0x015E,
+			0x0160, 0x0161, 0x0163, 0x0165, 0x0167, 0x0168, 0x016A, 0x016C,
+			0x016E, 0x016F, 0x0171, 0x0173, 0x0175, 0x0176, 0x0178, 0x017A,
+			0x017C, 0x017E, 0x017F, 0x0181, 0x0183, 0x0185, 0x0187, 0x0189,
+			0x018A, 0x018C, 0x018E, 0x0190, 0x0192, 0x0194, 0x0196, 0x0197,
+			0x0199, 0x019B, 0x019D, 0x019F, 0x01A1, 0x01A3, 0x01A5, 0x01A7,
+			0x01A9, 0x01AB, 0x01AC, 0x01AE, 0x01B0, 0x01B2, 0x01B4, 0x01B6,
+			0x01B8, 0x01BA, 0x01BC, 0x01BE, 0x01C0, 0x01C2, 0x01C4, 0x01C6,
+			0x01C8, 0x01CA, 0x01CC, 0x01CE, 0x01D0, 0x01D2, 0x01D4, 0x01D6,
+			0x01D8, 0x01DA, 0x01DC, 0x01DE, 0x01E1, 0x01E3, 0x01E5, 0x01E7,
+			0x01E9, 0x01EB, 0x01ED, 0x01EF, 0x01F1, 0x01F3, 0x01F5, 0x01F8,
+			0x01FA, 0x01FC, 0x01FE, 0x0200, 0x0202, 0x0204, 0x0207, 0x0209,
+			0x020B, 0x020D, 0x020F, 0x0212, 0x0214, 0x0216, 0x0218, 0x021A,
+			0x021D, 0x021F, 0x0221, 0x0223, 0x0225, 0x0228, 0x022A, 0x022C,
+			0x022E, 0x0231, 0x0233, 0x0235, 0x0238, 0x023A, 0x023C, 0x023E,
+			0x0241, 0x0243, 0x0245, 0x0248, 0x024A, 0x024C, 0x024F, 0x0251,
+			0x0253, 0x0256, 0x0258, 0x025A, 0x025D, 0x025F, 0x0261, 0x0264,
+			0x0266, 0x0269, 0x026B, 0x026D, 0x0270, 0x0272, 0x0275, 0x0277,
+			0x0279, 0x027C, 0x027E, 0x0281, 0x0283, 0x0286, 0x0288, 0x028B,
+			0x028D, 0x0290, 0x0292, 0x0295, 0x0297, 0x029A, 0x029C, 0x029F,
+			0x02A1, 0x02A4, 0x02A6, 0x02A9, 0x02AB, 0x02AE, 0x02B0, 0x02B3,
+			0x02B5, 0x02B8, 0x02BB, 0x02BD, 0x02C0, 0x02C2, 0x02C5, 0x02C8,
+			0x02CA, 0x02CD, 0x02CF, 0x02D2, 0x02D5, 0x02D7, 0x02DA, 0x02DD,
+			0x02DF, 0x02E2, 0x02E4, 0x02E7, 0x02EA, 0x02EC, 0x02EF, 0x02F2,
+			0x02F5, 0x02F7, 0x02FA, 0x02FD, 0x02FF, 0x0302, 0x0305, 0x0308,
+			0x030A, 0x030D, 0x0310, 0x0313, 0x0315, 0x0318, 0x031B, 0x031E,
+			0x0320, 0x0323, 0x0326, 0x0329, 0x032C, 0x032E, 0x0331, 0x0334,
+			0x0337, 0x033A, 0x033D, 0x033F, 0x0342, 0x0345, 0x0348, 0x034B,
+			0x034E, 0x0351, 0x0354, 0x0356, 0x0359, 0x035C, 0x035F, 0x0362,
+			0x0365, 0x0368, 0x036B, 0x036E, 0x0371, 0x0374, 0x0377, 0x037A,
+			0x037D, 0x0380, 0x0382, 0x0385, 0x0388, 0x038B, 0x038E, 0x0391,
+			0x0394, 0x0398, 0x039B, 0x039E, 0x03A1, 0x03A4, 0x03A7, 0x03AA,
+			0x03AD, 0x03B0, 0x03B3, 0x03B6, 0x03B9, 0x03BC, 0x03BF, 0x03C2,
+			0x03C5, 0x03C9, 0x03CC, 0x03CF, 0x03D2, 0x03D5, 0x03D8, 0x03DB,
+			0x03DF, 0x03E2, 0x03E5, 0x03E8, 0x03EB, 0x03EE, 0x03F2, 0x03F5,
+			0x03F8, 0x03FB, 0x03FE, 0x0402, 0x0405, 0x0408, 0x040B, 0x040F,
+			0x0412, 0x0415, 0x0418, 0x041C, 0x041F, 0x0422, 0x0425, 0x0429,
+			0x042C, 0x042F, 0x0433, 0x0436, 0x0439, 0x043D, 0x0440, 0x0443,
+			0x0447, 0x044A, 0x044D, 0x0451, 0x0454, 0x0457, 0x045B, 0x045E,
+			0x0462, 0x0465, 0x0468, 0x046C, 0x046F, 0x0473, 0x0476, 0x0479,
+			0x047D, 0x0480, 0x0484, 0x0487, 0x048B, 0x048E, 0x0492, 0x0495,
+			0x0499, 0x049C, 0x04A0, 0x04A3, 0x04A7, 0x04AA, 0x04AE, 0x04B1,
+			0x04B5, 0x04B8, 0x04BC, 0x04BF, 0x04C3, 0x04C6, 0x04CA, 0x04CE,
+			0x04D1, 0x04D5, 0x04D8, 0x04DC, 0x04E0, 0x04E3, 0x04E7, 0x04EA,
+			0x04EE, 0x04F2, 0x04F5, 0x04F9, 0x04FD, 0x0500, 0x0504, 0x0508,
+			0x050B, 0x050F, 0x0513, 0x0516, 0x051A, 0x051E, 0x0522, 0x0525,
+			0x0529, 0x052D, 0x0531, 0x0534, 0x0538, 0x053C, 0x0540, 0x0543,
+			0x0547, 0x054B, 0x054F, 0x0552, 0x0556, 0x055A, 0x055E, 0x0562,
+			0x0566, 0x0569, 0x056D, 0x0571, 0x0575, 0x0579, 0x057D, 0x0581,
+			0x0584, 0x0588, 0x058C, 0x0590, 0x0594, 0x0598, 0x059C, 0x05A0,
+			0x05A4, 0x05A8, 0x05AC, 0x05AF, 0x05B3, 0x05B7, 0x05BB, 0x05BF,
+			0x05C3, 0x05C7, 0x05CB, 0x05CF, 0x05D3, 0x05D7, 0x05DB, 0x05DF,
+			0x05E3, 0x05E7, 0x05EB, 0x05EF, 0x05F4, 0x05F8, 0x05FC, 0x0600,
+			0x0604, 0x0608, 0x060C, 0x0610, 0x0614, 0x0618, 0x061C, 0x0621,
+			0x0625, 0x0629, 0x062D, 0x0631, 0x0635, 0x0639, 0x063E, 0x0642,
+			0x0646, 0x064A, 0x064E, 0x0653, 0x0657, 0x065B, 0x065F, 0x0663,
+			0x0668, 0x066C, 0x0670, 0x0674, 0x0679, 0x067D, 0x0681, 0x0685,
+			0x068A, 0x068E, 0x0692, 0x0697, 0x069B, 0x069F, 0x06A4, 0x06A8,
+			0x06AC, 0x06B1, 0x06B5, 0x06B9, 0x06BE, 0x06C2, 0x06C6, 0x06CB,
+			0x06CF, 0x06D4, 0x06D8, 0x06DC, 0x06E1, 0x06E5, 0x06EA, 0x06EE,
+			0x06F2, 0x06F7, 0x06FB, 0x0700, 0x0704, 0x0709, 0x070D, 0x0712,
+			0x0716, 0x071B, 0x071F, 0x0724, 0x0728, 0x072D, 0x0731, 0x0736,
+			0x073A, 0x073F, 0x0743, 0x0748, 0x074D, 0x0751, 0x0756, 0x075A,
+			0x075F, 0x0763, 0x0768, 0x076D, 0x0771, 0x0776, 0x077B, 0x077F,
+			0x0784, 0x0789, 0x078D, 0x0792, 0x0797, 0x079B, 0x07A0, 0x07A5,
+			0x07A9, 0x07AE, 0x07B3, 0x07B7, 0x07BC, 0x07C1, 0x07C6, 0x07CA,
+			0x07CF, 0x07D4, 0x07D9, 0x07DD, 0x07E2, 0x07E7, 0x07EC, 0x07F1,
+			0x07F5, 0x07FA, 0x07FF, 0x0804, 0x0809, 0x080D, 0x0812, 0x0817,
+			0x081C, 0x0821, 0x0826, 0x082B, 0x082F, 0x0834, 0x0839, 0x083E,
+			0x0843, 0x0848, 0x084D, 0x0852, 0x0857, 0x085C, 0x0861, 0x0866,
+			0x086B, 0x0870, 0x0875, 0x087A, 0x087F, 0x0884, 0x0889, 0x088E,
+			0x0893, 0x0898, 0x089D, 0x08A2, 0x08A7, 0x08AC, 0x08B1, 0x08B6,
+			0x08BB, 0x08C0, 0x08C5, 0x08CA, 0x08CF, 0x08D4, 0x08D9, 0x08DF,
+			0x08E4, 0x08E9, 0x08EE, 0x08F3, 0x08F8, 0x08FD, 0x0903, 0x0908,
+			0x090D, 0x0912, 0x0917, 0x091D, 0x0922, 0x0927, 0x092C, 0x0931,
+			0x0937, 0x093C, 0x0941, 0x0946, 0x094C, 0x0951, 0x0956, 0x095B,
+			0x0961, 0x0966, 0x096B, 0x0971, 0x0976, 0x097B, 0x0981, 0x0986,
+			0x098B, 0x0991, 0x0996, 0x099B, 0x09A1, 0x09A6, 0x09AB, 0x09B1,
+			0x09B6, 0x09BC, 0x09C1, 0x09C6, 0x09CC, 0x09D1, 0x09D7, 0x09DC,
+			0x09E2, 0x09E7, 0x09ED, 0x09F2, 0x09F7, 0x09FD, 0x0A02, 0x0A08,
+			0x0A0D, 0x0A13, 0x0A19, 0x0A1E, 0x0A24, 0x0A29, 0x0A2F, 0x0A34,
+			0x0A3A, 0x0A3F, 0x0A45, 0x0A4A, 0x0A50, 0x0A56, 0x0A5B, 0x0A61,
+			0x0A66, 0x0A6C, 0x0A72, 0x0A77, 0x0A7D, 0x0A83, 0x0A88, 0x0A8E,
+			0x0A94, 0x0A99, 0x0A9F, 0x0AA5, 0x0AAA, 0x0AB0, 0x0AB6, 0x0ABC,
+			0x0AC1, 0x0AC7, 0x0ACD, 0x0AD3, 0x0AD8, 0x0ADE, 0x0AE4, 0x0AEA,
+			0x0AEF, 0x0AF5, 0x0AFB, 0x0B01, 0x0B07, 0x0B0C, 0x0B12, 0x0B18,
+			0x0B1E, 0x0B24, 0x0B2A, 0x0B2F, 0x0B35, 0x0B3B, 0x0B41, 0x0B47,
+			0x0B4D, 0x0B53, 0x0B59, 0x0B5F, 0x0B64, 0x0B6A, 0x0B70, 0x0B76,
+			0x0B7C, 0x0B82, 0x0B88, 0x0B8E, 0x0B94, 0x0B9A, 0x0BA0, 0x0BA6,
+			0x0BAC, 0x0BB2, 0x0BB8, 0x0BBE, 0x0BC4, 0x0BCA, 0x0BD0, 0x0BD6,
+			0x0BDC, 0x0BE2, 0x0BE9, 0x0BEF, 0x0BF5, 0x0BFB, 0x0C01, 0x0C07,
+			0x0C0D, 0x0C13, 0x0C19, 0x0C20, 0x0C26, 0x0C2C, 0x0C32, 0x0C38,
+			0x0C3E, 0x0C45, 0x0C4B, 0x0C51, 0x0C57, 0x0C5D, 0x0C64, 0x0C6A,
+			0x0C70, 0x0C76, 0x0C7D, 0x0C83, 0x0C89, 0x0C8F, 0x0C96, 0x0C9C,
+			0x0CA2, 0x0CA8, 0x0CAF, 0x0CB5, 0x0CBB, 0x0CC2, 0x0CC8, 0x0CCE,
+			0x0CD5, 0x0CDB, 0x0CE1, 0x0CE8, 0x0CEE, 0x0CF5, 0x0CFB, 0x0D01,
+			0x0D08, 0x0D0E, 0x0D15, 0x0D1B, 0x0D21, 0x0D28, 0x0D2E, 0x0D35,
+			0x0D3B, 0x0D42, 0x0D48, 0x0D4F, 0x0D55, 0x0D5C, 0x0D62, 0x0D69,
+			0x0D6F, 0x0D76, 0x0D7C, 0x0D83, 0x0D89, 0x0D90, 0x0D96, 0x0D9D,
+			0x0DA4, 0x0DAA, 0x0DB1, 0x0DB7, 0x0DBE, 0x0DC5, 0x0DCB, 0x0DD2,
+			0x0DD9, 0x0DDF, 0x0DE6, 0x0DEC, 0x0DF3, 0x0DFA, 0x0E01, 0x0E07,
+			0x0E0E, 0x0E15, 0x0E1B, 0x0E22, 0x0E29, 0x0E2F, 0x0E36, 0x0E3D,
+			0x0E44, 0x0E4A, 0x0E51, 0x0E58, 0x0E5F, 0x0E66, 0x0E6C, 0x0E73,
+			0x0E7A, 0x0E81, 0x0E88, 0x0E8E, 0x0E95, 0x0E9C, 0x0EA3, 0x0EAA,
+			0x0EB1, 0x0EB8, 0x0EBE, 0x0EC5, 0x0ECC, 0x0ED3, 0x0EDA, 0x0EE1,
+			0x0EE8, 0x0EEF, 0x0EF6, 0x0EFD, 0x0F04, 0x0F0B, 0x0F12, 0x0F19,
+			0x0F20, 0x0F27, 0x0F2E, 0x0F35, 0x0F3C, 0x0F43, 0x0F4A, 0x0F51,
+			0x0F58, 0x0F5F, 0x0F66, 0x0F6D, 0x0F74, 0x0F7B, 0x0F82, 0x0F89,
+			0x0F90, 0x0F98, 0x0F9F, 0x0FA6, 0x0FAD, 0x0FB4, 0x0FBB, 0x0FC2,
+			0x0FCA, 0x0FD1, 0x0FD8, 0x0FDF, 0x0FE6, 0x0FED, 0x0FF5, 0x0FFC,
+			0x1003, 0x100A, 0x1012, 0x1019, 0x1020, 0x1027, 0x102F, 0x1036,
+			0x103D, 0x1044, 0x104C, 0x1053, 0x105A, 0x1062, 0x1069, 0x1070,
+			0x1078, 0x107F, 0x1086, 0x108E, 0x1095, 0x109D, 0x10A4, 0x10AB,
+			0x10B3, 0x10BA, 0x10C2, 0x10C9, 0x10D0, 0x10D8, 0x10DF, 0x10E7,
+			0x10EE, 0x10F6, 0x10FD, 0x1105, 0x110C, 0x1114, 0x111B, 0x1123,
+			0x112A, 0x1132, 0x1139, 0x1141, 0x1148, 0x1150, 0x1157, 0x115F,
+			0x1167, 0x116E, 0x1176, 0x117D, 0x1185, 0x118D, 0x1194, 0x119C,
+			0x11A4, 0x11AB, 0x11B3, 0x11BB, 0x11C2, 0x11CA, 0x11D2, 0x11D9,
+			0x11E1, 0x11E9, 0x11F0, 0x11F8, 0x1200, 0x1208, 0x120F, 0x1217,
+			0x121F, 0x1227, 0x122E, 0x1236, 0x123E, 0x1246, 0x124E, 0x1255,
+			0x125D, 0x1265, 0x126D, 0x1275, 0x127D, 0x1284, 0x128C, 0x1294,
+			0x129C, 0x12A4, 0x12AC, 0x12B4, 0x12BC, 0x12C4, 0x12CC, 0x12D4,
+			0x12DB, 0x12E3, 0x12EB, 0x12F3, 0x12FB, 0x1303, 0x130B, 0x1313,
+			0x131B, 0x1323, 0x132B, 0x1333, 0x133B, 0x1344, 0x134C, 0x1354,
+			0x135C, 0x1364, 0x136C, 0x1374, 0x137C, 0x1384, 0x138C, 0x1394,
+			0x139D, 0x13A5, 0x13AD, 0x13B5, 0x13BD, 0x13C5, 0x13CD, 0x13D6,
+			0x13DE, 0x13E6, 0x13EE, 0x13F6, 0x13FF, 0x1407, 0x140F, 0x1417,
+			0x1420, 0x1428, 0x1430, 0x1438, 0x1441, 0x1449, 0x1451, 0x145A,
+			0x1462, 0x146A, 0x1473, 0x147B, 0x1483, 0x148C, 0x1494, 0x149C,
+			0x14A5, 0x14AD, 0x14B6, 0x14BE, 0x14C6, 0x14CF, 0x14D7, 0x14E0,
+			0x14E8, 0x14F1, 0x14F9, 0x1501, 0x150A, 0x1512, 0x151B, 0x1523,
+			0x152C, 0x1534, 0x153D, 0x1545, 0x154E, 0x1557, 0x155F, 0x1568,
+			0x1570, 0x1579, 0x1581, 0x158A, 0x1593, 0x159B, 0x15A4, 0x15AC,
+			0x15B5, 0x15BE, 0x15C6, 0x15CF, 0x15D8, 0x15E0, 0x15E9, 0x15F2,
+			0x15FA, 0x1603, 0x160C, 0x1614, 0x161D, 0x1626, 0x162F, 0x1637,
+			0x1640, 0x1649, 0x1652, 0x165A, 0x1663, 0x166C, 0x1675, 0x167E,
+			0x1686, 0x168F, 0x1698, 0x16A1, 0x16AA, 0x16B3, 0x16BB, 0x16C4,
+			0x16CD, 0x16D6, 0x16DF, 0x16E8, 0x16F1, 0x16FA, 0x1703, 0x170C,
+			0x1714, 0x171D, 0x1726, 0x172F, 0x1738, 0x1741, 0x174A, 0x1753,
+			0x175C, 0x1765, 0x176E, 0x1777, 0x1780, 0x1789, 0x1792, 0x179C,
+			0x17A5, 0x17AE, 0x17B7, 0x17C0, 0x17C9, 0x17D2, 0x17DB, 0x17E4,
+			0x17ED, 0x17F7, 0x1800, 0x1809, 0x1812, 0x181B, 0x1824, 0x182E,
+			0x1837, 0x1840, 0x1849, 0x1852, 0x185C, 0x1865, 0x186E, 0x1877,
+			0x1881, 0x188A, 0x1893, 0x189C, 0x18A6, 0x18AF, 0x18B8, 0x18C2,
+			0x18CB, 0x18D4, 0x18DE, 0x18E7, 0x18F0, 0x18FA, 0x1903, 0x190C,
+			0x1916, 0x191F, 0x1929, 0x1932, 0x193B, 0x1945, 0x194E, 0x1958,
+			0x1961, 0x196B, 0x1974, 0x197E, 0x1987, 0x1991, 0x199A, 0x19A4,
+			0x19AD, 0x19B7, 0x19C0, 0x19CA, 0x19D3, 0x19DD, 0x19E6, 0x19F0,
+			0x19FA, 0x1A03, 0x1A0D, 0x1A16, 0x1A20, 0x1A2A, 0x1A33, 0x1A3D,
+			0x1A46, 0x1A50, 0x1A5A, 0x1A63, 0x1A6D, 0x1A77, 0x1A81, 0x1A8A,
+			0x1A94, 0x1A9E, 0x1AA7, 0x1AB1, 0x1ABB, 0x1AC5, 0x1ACE, 0x1AD8,
+			0x1AE2, 0x1AEC, 0x1AF5, 0x1AFF, 0x1B09, 0x1B13, 0x1B1D, 0x1B27,
+			0x1B30, 0x1B3A, 0x1B44, 0x1B4E, 0x1B58, 0x1B62, 0x1B6C, 0x1B75,
+			0x1B7F, 0x1B89, 0x1B93, 0x1B9D, 0x1BA7, 0x1BB1, 0x1BBB, 0x1BC5,
+			0x1BCF, 0x1BD9, 0x1BE3, 0x1BED, 0x1BF7, 0x1C01, 0x1C0B, 0x1C15,
+			0x1C1F, 0x1C29, 0x1C33, 0x1C3D, 0x1C47, 0x1C51, 0x1C5B, 0x1C65,
+			0x1C70, 0x1C7A, 0x1C84, 0x1C8E, 0x1C98, 0x1CA2, 0x1CAC, 0x1CB6,
+			0x1CC1, 0x1CCB, 0x1CD5, 0x1CDF, 0x1CE9, 0x1CF4, 0x1CFE, 0x1D08,
+			0x1D12, 0x1D1C, 0x1D27, 0x1D31, 0x1D3B, 0x1D45, 0x1D50, 0x1D5A,
+			0x1D64, 0x1D6F, 0x1D79, 0x1D83, 0x1D8E, 0x1D98, 0x1DA2, 0x1DAD,
+			0x1DB7, 0x1DC1, 0x1DCC, 0x1DD6, 0x1DE1, 0x1DEB, 0x1DF5, 0x1E00,
+			0x1E0A, 0x1E15, 0x1E1F, 0x1E2A, 0x1E34, 0x1E3E, 0x1E49, 0x1E53,
+			0x1E5E, 0x1E68, 0x1E73, 0x1E7D, 0x1E88, 0x1E93, 0x1E9D, 0x1EA8,
+			0x1EB2, 0x1EBD, 0x1EC7, 0x1ED2, 0x1EDC, 0x1EE7, 0x1EF2, 0x1EFC,
+			0x1F07, 0x1F12, 0x1F1C, 0x1F27, 0x1F32, 0x1F3C, 0x1F47, 0x1F52,
+			0x1F5C, 0x1F67, 0x1F72, 0x1F7C, 0x1F87, 0x1F92, 0x1F9D, 0x1FA7,
+			0x1FB2, 0x1FBD, 0x1FC8, 0x1FD2, 0x1FDD, 0x1FE8, 0x1FF3, 0x1FFE,
+			0x2008, 0x2013, 0x201E, 0x2029, 0x2034, 0x203F, 0x204A, 0x2054,
+			0x205F, 0x206A, 0x2075, 0x2080, 0x208B, 0x2096, 0x20A1, 0x20AC,
+			0x20B7, 0x20C2, 0x20CD, 0x20D8, 0x20E3, 0x20EE, 0x20F9, 0x2104,
+			0x210F, 0x211A, 0x2125, 0x2130, 0x213B, 0x2146, 0x2151, 0x215C,
+			0x2167, 0x2172, 0x217E, 0x2189, 0x2194, 0x219F, 0x21AA, 0x21B5,
+			0x21C0, 0x21CC, 0x21D7, 0x21E2, 0x21ED, 0x21F8, 0x2204, 0x220F,
+			0x221A, 0x2225, 0x2230, 0x223C, 0x2247, 0x2252, 0x225E, 0x2269,
+			0x2274, 0x227F, 0x228B, 0x2296, 0x22A1, 0x22AD, 0x22B8, 0x22C3,
+			0x22CF, 0x22DA, 0x22E6, 0x22F1, 0x22FC, 0x2308, 0x2313, 0x231F,
+			0x232A, 0x2335, 0x2341, 0x234C, 0x2358, 0x2363, 0x236F, 0x237A,
+			0x2386, 0x2391, 0x239D, 0x23A8, 0x23B4, 0x23BF, 0x23CB, 0x23D6,
+			0x23E2, 0x23EE, 0x23F9, 0x2405, 0x2410, 0x241C, 0x2428, 0x2433,
+			0x243F, 0x244B, 0x2456, 0x2462, 0x246E, 0x2479, 0x2485, 0x2491,
+			0x249C, 0x24A8, 0x24B4, 0x24BF, 0x24CB, 0x24D7, 0x24E3, 0x24EE,
+			0x24FA, 0x2506, 0x2512, 0x251E, 0x2529, 0x2535, 0x2541, 0x254D,
+			0x2559, 0x2565, 0x2570, 0x257C, 0x2588, 0x2594, 0x25A0, 0x25AC,
+			0x25B8, 0x25C4, 0x25D0, 0x25DC, 0x25E7, 0x25F3, 0x25FF, 0x260B,
+			0x2617, 0x2623, 0x262F, 0x263B, 0x2647, 0x2653, 0x265F, 0x266B,
+			0x2677, 0x2684, 0x2690, 0x269C, 0x26A8, 0x26B4, 0x26C0, 0x26CC,
+			0x26D8, 0x26E4, 0x26F0, 0x26FD, 0x2709, 0x2715, 0x2721, 0x272D,
+			0x2739, 0x2746, 0x2752, 0x275E, 0x276A, 0x2776, 0x2783, 0x278F,
+			0x279B, 0x27A7, 0x27B4, 0x27C0, 0x27CC, 0x27D9, 0x27E5, 0x27F1,
+			0x27FD, 0x280A, 0x2816, 0x2823, 0x282F, 0x283B, 0x2848, 0x2854,
+			0x2860, 0x286D, 0x2879, 0x2886, 0x2892, 0x289E, 0x28AB, 0x28B7,
+			0x28C4, 0x28D0, 0x28DD, 0x28E9, 0x28F6, 0x2902, 0x290F, 0x291B,
+			0x2928, 0x2934, 0x2941, 0x294D, 0x295A, 0x2967, 0x2973, 0x2980,
+			0x298C, 0x2999, 0x29A6, 0x29B2, 0x29BF, 0x29CC, 0x29D8, 0x29E5,
+			0x29F1, 0x29FE, 0x2A0B, 0x2A18, 0x2A24, 0x2A31, 0x2A3E, 0x2A4A,
+			0x2A57, 0x2A64, 0x2A71, 0x2A7D, 0x2A8A, 0x2A97, 0x2AA4, 0x2AB1,
+			0x2ABD, 0x2ACA, 0x2AD7, 0x2AE4, 0x2AF1, 0x2AFE, 0x2B0A, 0x2B17,
+			0x2B24, 0x2B31, 0x2B3E, 0x2B4B, 0x2B58, 0x2B65, 0x2B72, 0x2B7F,
+			0x2B8C, 0x2B99, 0x2BA5, 0x2BB2, 0x2BBF, 0x2BCC, 0x2BD9, 0x2BE6,
+			0x2BF3, 0x2C01, 0x2C0E, 0x2C1B, 0x2C28, 0x2C35, 0x2C42, 0x2C4F,
+			0x2C5C, 0x2C69, 0x2C76, 0x2C83, 0x2C90, 0x2C9E, 0x2CAB, 0x2CB8,
+			0x2CC5, 0x2CD2, 0x2CDF, 0x2CED, 0x2CFA, 0x2D07, 0x2D14, 0x2D21,
+			0x2D2F, 0x2D3C, 0x2D49, 0x2D56, 0x2D64, 0x2D71, 0x2D7E, 0x2D8B,
+			0x2D99, 0x2DA6, 0x2DB3, 0x2DC1, 0x2DCE, 0x2DDB, 0x2DE9, 0x2DF6,
+			0x2E04, 0x2E11, 0x2E1E, 0x2E2C, 0x2E39, 0x2E47, 0x2E54, 0x2E61,
+			0x2E6F, 0x2E7C, 0x2E8A, 0x2E97, 0x2EA5, 0x2EB2, 0x2EC0, 0x2ECD,
+			0x2EDB, 0x2EE8, 0x2EF6, 0x2F03, 0x2F11, 0x2F1E, 0x2F2C, 0x2F3A,
+			0x2F47, 0x2F55, 0x2F62, 0x2F70, 0x2F7E, 0x2F8B, 0x2F99, 0x2FA7,
+			0x2FB4, 0x2FC2, 0x2FD0, 0x2FDD, 0x2FEB, 0x2FF9, 0x3006, 0x3014,
+			0x3022, 0x302F, 0x303D, 0x304B, 0x3059, 0x3067, 0x3074, 0x3082,
+			0x3090, 0x309E, 0x30AC, 0x30B9, 0x30C7, 0x30D5, 0x30E3, 0x30F1,
+			0x30FF, 0x310D, 0x311A, 0x3128, 0x3136, 0x3144, 0x3152, 0x3160,
+			0x316E, 0x317C, 0x318A, 0x3198, 0x31A6, 0x31B4, 0x31C2, 0x31D0,
+			0x31DE, 0x31EC, 0x31FA, 0x3208, 0x3216, 0x3224, 0x3232, 0x3240,
+			0x324E, 0x325C, 0x326A, 0x3279, 0x3287, 0x3295, 0x32A3, 0x32B1,
+			0x32BF, 0x32CD, 0x32DC, 0x32EA, 0x32F8, 0x3306, 0x3314, 0x3323,
+			0x3331, 0x333F, 0x334D, 0x335C, 0x336A, 0x3378, 0x3386, 0x3395,
+			0x33A3, 0x33B1, 0x33C0, 0x33CE, 0x33DC, 0x33EB, 0x33F9, 0x3407,
+			0x3416, 0x3424, 0x3433, 0x3441, 0x344F, 0x345E, 0x346C, 0x347B,
+			0x3489, 0x3498, 0x34A6, 0x34B5, 0x34C3, 0x34D2, 0x34E0, 0x34EF,
+			0x34FD, 0x350C, 0x351A, 0x3529, 0x3537, 0x3546, 0x3554, 0x3563,
+			0x3572, 0x3580, 0x358F, 0x359D, 0x35AC, 0x35BB, 0x35C9, 0x35D8,
+			0x35E7, 0x35F5, 0x3604, 0x3613, 0x3621, 0x3630, 0x363F, 0x364E,
+			0x365C, 0x366B, 0x367A, 0x3689, 0x3697, 0x36A6, 0x36B5, 0x36C4,
+			0x36D3, 0x36E1, 0x36F0, 0x36FF, 0x370E, 0x371D, 0x372C, 0x373B,
+			0x3749, 0x3758, 0x3767, 0x3776, 0x3785, 0x3794, 0x37A3, 0x37B2,
+			0x37C1, 0x37D0, 0x37DF, 0x37EE, 0x37FD, 0x380C, 0x381B, 0x382A,
+			0x3839, 0x3848, 0x3857, 0x3866, 0x3875, 0x3884, 0x3893, 0x38A2,
+			0x38B1, 0x38C1, 0x38D0, 0x38DF, 0x38EE, 0x38FD, 0x390C, 0x391B,
+			0x392B, 0x393A, 0x3949, 0x3958, 0x3967, 0x3977, 0x3986, 0x3995,
+			0x39A4, 0x39B4, 0x39C3, 0x39D2, 0x39E1, 0x39F1, 0x3A00, 0x3A0F,
+			0x3A1F, 0x3A2E, 0x3A3D, 0x3A4D, 0x3A5C, 0x3A6B, 0x3A7B, 0x3A8A,
+			0x3A9A, 0x3AA9, 0x3AB8, 0x3AC8, 0x3AD7, 0x3AE7, 0x3AF6, 0x3B06,
+			0x3B15, 0x3B25, 0x3B34, 0x3B44, 0x3B53, 0x3B63, 0x3B72, 0x3B82,
+			0x3B91, 0x3BA1, 0x3BB0, 0x3BC0, 0x3BD0, 0x3BDF, 0x3BEF, 0x3BFE,
+			0x3C0E, 0x3C1E, 0x3C2D, 0x3C3D, 0x3C4D, 0x3C5C, 0x3C6C, 0x3C7C,
+			0x3C8B, 0x3C9B, 0x3CAB, 0x3CBA, 0x3CCA, 0x3CDA, 0x3CEA, 0x3CF9,
+			0x3D09, 0x3D19, 0x3D29, 0x3D39, 0x3D48, 0x3D58, 0x3D68, 0x3D78,
+			0x3D88, 0x3D98, 0x3DA7, 0x3DB7, 0x3DC7, 0x3DD7, 0x3DE7, 0x3DF7,
+			0x3E07, 0x3E17, 0x3E27, 0x3E37, 0x3E47, 0x3E57, 0x3E67, 0x3E77,
+			0x3E87, 0x3E97, 0x3EA7, 0x3EB7, 0x3EC7, 0x3ED7, 0x3EE7, 0x3EF7,
+			0x3F07, 0x3F17, 0x3F27, 0x3F37, 0x3F47, 0x3F57, 0x3F67, 0x3F78,
+			0x3F88, 0x3F98, 0x3FA8, 0x3FB8, 0x3FC8, 0x3FD9, 0x3FE9, 0x3FF9,
+			0x4009, 0x4019, 0x402A, 0x403A, 0x404A, 0x405A, 0x406B, 0x407B,
+			0x408B, 0x409C, 0x40AC, 0x40BC, 0x40CD, 0x40DD, 0x40ED, 0x40FE,
+			0x410E, 0x411E, 0x412F, 0x413F, 0x414F, 0x4160, 0x4170, 0x4181,
+			0x4191, 0x41A2, 0x41B2, 0x41C3, 0x41D3, 0x41E4, 0x41F4, 0x4205,
+			0x4215, 0x4226, 0x4236, 0x4247, 0x4257, 0x4268, 0x4278, 0x4289,
+			0x429A, 0x42AA, 0x42BB, 0x42CB, 0x42DC, 0x42ED, 0x42FD, 0x430E,
+			0x431F, 0x432F, 0x4340, 0x4351, 0x4361, 0x4372, 0x4383, 0x4394,
+			0x43A4, 0x43B5, 0x43C6, 0x43D7, 0x43E7, 0x43F8, 0x4409, 0x441A,
+			0x442B, 0x443B, 0x444C, 0x445D, 0x446E, 0x447F, 0x4490, 0x44A1,
+			0x44B2, 0x44C2, 0x44D3, 0x44E4, 0x44F5, 0x4506, 0x4517, 0x4528,
+			0x4539, 0x454A, 0x455B, 0x456C, 0x457D, 0x458E, 0x459F, 0x45B0,
+			0x45C1, 0x45D2, 0x45E3, 0x45F4, 0x4605, 0x4617, 0x4628, 0x4639,
+			0x464A, 0x465B, 0x466C, 0x467D, 0x468F, 0x46A0, 0x46B1, 0x46C2,
+			0x46D3, 0x46E4, 0x46F6, 0x4707, 0x4718, 0x4729, 0x473B, 0x474C,
+			0x475D, 0x476E, 0x4780, 0x4791, 0x47A2, 0x47B4, 0x47C5, 0x47D6,
+			0x47E8, 0x47F9, 0x480A, 0x481C, 0x482D, 0x483F, 0x4850, 0x4861,
+			0x4873, 0x4884, 0x4896, 0x48A7, 0x48B9, 0x48CA, 0x48DC, 0x48ED,
+			0x48FF, 0x4910, 0x4922, 0x4933, 0x4945, 0x4956, 0x4968, 0x497A,
+			0x498B, 0x499D, 0x49AE, 0x49C0, 0x49D2, 0x49E3, 0x49F5, 0x4A06,
+			0x4A18, 0x4A2A, 0x4A3B, 0x4A4D, 0x4A5F, 0x4A71, 0x4A82, 0x4A94,
+			0x4AA6, 0x4AB7, 0x4AC9, 0x4ADB, 0x4AED, 0x4AFF, 0x4B10, 0x4B22,
+			0x4B34, 0x4B46, 0x4B58, 0x4B69, 0x4B7B, 0x4B8D, 0x4B9F, 0x4BB1,
+			0x4BC3, 0x4BD5, 0x4BE7, 0x4BF9, 0x4C0A, 0x4C1C, 0x4C2E, 0x4C40,
+			0x4C52, 0x4C64, 0x4C76, 0x4C88, 0x4C9A, 0x4CAC, 0x4CBE, 0x4CD0,
+			0x4CE2, 0x4CF4, 0x4D06, 0x4D19, 0x4D2B, 0x4D3D, 0x4D4F, 0x4D61,
+			0x4D73, 0x4D85, 0x4D97, 0x4DA9, 0x4DBC, 0x4DCE, 0x4DE0, 0x4DF2,
+			0x4E04, 0x4E17, 0x4E29, 0x4E3B, 0x4E4D, 0x4E5F, 0x4E72, 0x4E84,
+			0x4E96, 0x4EA9, 0x4EBB, 0x4ECD, 0x4EDF, 0x4EF2, 0x4F04, 0x4F16,
+			0x4F29, 0x4F3B, 0x4F4E, 0x4F60, 0x4F72, 0x4F85, 0x4F97, 0x4FAA,
+			0x4FBC, 0x4FCE, 0x4FE1, 0x4FF3, 0x5006, 0x5018, 0x502B, 0x503D,
+			0x5050, 0x5062, 0x5075, 0x5087, 0x509A, 0x50AD, 0x50BF, 0x50D2,
+			0x50E4, 0x50F7, 0x5109, 0x511C, 0x512F, 0x5141, 0x5154, 0x5167,
+			0x5179, 0x518C, 0x519F, 0x51B1, 0x51C4, 0x51D7, 0x51E9, 0x51FC,
+			0x520F, 0x5222, 0x5234, 0x5247, 0x525A, 0x526D, 0x5280, 0x5292,
+			0x52A5, 0x52B8, 0x52CB, 0x52DE, 0x52F1, 0x5304, 0x5316, 0x5329,
+			0x533C, 0x534F, 0x5362, 0x5375, 0x5388, 0x539B, 0x53AE, 0x53C1,
+			0x53D4, 0x53E7, 0x53FA, 0x540D, 0x5420, 0x5433, 0x5446, 0x5459,
+			0x546C, 0x547F, 0x5492, 0x54A5, 0x54B8, 0x54CB, 0x54DE, 0x54F2,
+			0x5505, 0x5518, 0x552B, 0x553E, 0x5551, 0x5565, 0x5578, 0x558B,
+			0x559E, 0x55B1, 0x55C5, 0x55D8, 0x55EB, 0x55FE, 0x5612, 0x5625,
+			0x5638, 0x564B, 0x565F, 0x5672, 0x5685, 0x5699, 0x56AC, 0x56BF,
+			0x56D3, 0x56E6, 0x56FA, 0x570D, 0x5720, 0x5734, 0x5747, 0x575B,
+			0x576E, 0x5782, 0x5795, 0x57A9, 0x57BC, 0x57D0, 0x57E3, 0x57F7,
+			0x580A, 0x581E, 0x5831, 0x5845, 0x5858, 0x586C, 0x5880, 0x5893,
+			0x58A7, 0x58BA, 0x58CE, 0x58E2, 0x58F5, 0x5909, 0x591D, 0x5930,
+			0x5944, 0x5958, 0x596B, 0x597F, 0x5993, 0x59A7, 0x59BA, 0x59CE,
+			0x59E2, 0x59F6, 0x5A09, 0x5A1D, 0x5A31, 0x5A45, 0x5A59, 0x5A6C,
+			0x5A80, 0x5A94, 0x5AA8, 0x5ABC, 0x5AD0, 0x5AE4, 0x5AF8, 0x5B0B,
+			0x5B1F, 0x5B33, 0x5B47, 0x5B5B, 0x5B6F, 0x5B83, 0x5B97, 0x5BAB,
+			0x5BBF, 0x5BD3, 0x5BE7, 0x5BFB, 0x5C0F, 0x5C23, 0x5C37, 0x5C4B,
+			0x5C60, 0x5C74, 0x5C88, 0x5C9C, 0x5CB0, 0x5CC4, 0x5CD8, 0x5CEC,
+			0x5D01, 0x5D15, 0x5D29, 0x5D3D, 0x5D51, 0x5D65, 0x5D7A, 0x5D8E,
+			0x5DA2, 0x5DB6, 0x5DCB, 0x5DDF, 0x5DF3, 0x5E08, 0x5E1C, 0x5E30,
+			0x5E44, 0x5E59, 0x5E6D, 0x5E82, 0x5E96, 0x5EAA, 0x5EBF, 0x5ED3,
+			0x5EE7, 0x5EFC, 0x5F10, 0x5F25, 0x5F39, 0x5F4E, 0x5F62, 0x5F77,
+			0x5F8B, 0x5FA0, 0x5FB4, 0x5FC9, 0x5FDD, 0x5FF2, 0x6006, 0x601B,
+			0x602F, 0x6044, 0x6058, 0x606D, 0x6082, 0x6096, 0x60AB, 0x60BF,
+			0x60D4, 0x60E9, 0x60FD, 0x6112, 0x6127, 0x613B, 0x6150, 0x6165,
+			0x617A, 0x618E, 0x61A3, 0x61B8, 0x61CD, 0x61E1, 0x61F6, 0x620B,
+			0x6220, 0x6235, 0x6249, 0x625E, 0x6273, 0x6288, 0x629D, 0x62B2,
+			0x62C7, 0x62DB, 0x62F0, 0x6305, 0x631A, 0x632F, 0x6344, 0x6359,
+			0x636E, 0x6383, 0x6398, 0x63AD, 0x63C2, 0x63D7, 0x63EC, 0x6401,
+			0x6416, 0x642B, 0x6440, 0x6455, 0x646A, 0x647F, 0x6495, 0x64AA,
+			0x64BF, 0x64D4, 0x64E9, 0x64FE, 0x6513, 0x6529, 0x653E, 0x6553,
+			0x6568, 0x657D, 0x6593, 0x65A8, 0x65BD, 0x65D2, 0x65E8, 0x65FD,
+			0x6612, 0x6627, 0x663D, 0x6652, 0x6667, 0x667D, 0x6692, 0x66A7,
+			0x66BD, 0x66D2, 0x66E8, 0x66FD, 0x6712, 0x6728, 0x673D, 0x6753,
+			0x6768, 0x677E, 0x6793, 0x67A9, 0x67BE, 0x67D4, 0x67E9, 0x67FF,
+			0x6814, 0x682A, 0x683F, 0x6855, 0x686A, 0x6880, 0x6896, 0x68AB,
+			0x68C1, 0x68D6, 0x68EC, 0x6902, 0x6917, 0x692D, 0x6943, 0x6958,
+			0x696E, 0x6984, 0x6999, 0x69AF, 0x69C5, 0x69DB, 0x69F0, 0x6A06,
+			0x6A1C, 0x6A32, 0x6A48, 0x6A5D, 0x6A73, 0x6A89, 0x6A9F, 0x6AB5,
+			0x6ACA, 0x6AE0, 0x6AF6, 0x6B0C, 0x6B22, 0x6B38, 0x6B4E, 0x6B64,
+			0x6B7A, 0x6B90, 0x6BA6, 0x6BBC, 0x6BD2, 0x6BE8, 0x6BFE, 0x6C14,
+			0x6C2A, 0x6C40, 0x6C56, 0x6C6C, 0x6C82, 0x6C98, 0x6CAE, 0x6CC4,
+			0x6CDA, 0x6CF0, 0x6D06, 0x6D1C, 0x6D33, 0x6D49, 0x6D5F, 0x6D75,
+			0x6D8B, 0x6DA1, 0x6DB8, 0x6DCE, 0x6DE4, 0x6DFA, 0x6E11, 0x6E27,
+			0x6E3D, 0x6E53, 0x6E6A, 0x6E80, 0x6E96, 0x6EAD, 0x6EC3, 0x6ED9,
+			0x6EF0, 0x6F06, 0x6F1C, 0x6F33, 0x6F49, 0x6F60, 0x6F76, 0x6F8C,
+			0x6FA3, 0x6FB9, 0x6FD0, 0x6FE6, 0x6FFD, 0x7013, 0x702A, 0x7040,
+			0x7057, 0x706D, 0x7084, 0x709A, 0x70B1, 0x70C7, 0x70DE, 0x70F4,
+			0x710B, 0x7122, 0x7138, 0x714F, 0x7166, 0x717C, 0x7193, 0x71AA,
+			0x71C0, 0x71D7, 0x71EE, 0x7204, 0x721B, 0x7232, 0x7248, 0x725F,
+			0x7276, 0x728D, 0x72A4, 0x72BA, 0x72D1, 0x72E8, 0x72FF, 0x7316,
+			0x732C, 0x7343, 0x735A, 0x7371, 0x7388, 0x739F, 0x73B6, 0x73CD,
+			0x73E4, 0x73FA, 0x7411, 0x7428, 0x743F, 0x7456, 0x746D, 0x7484,
+			0x749B, 0x74B2, 0x74C9, 0x74E0, 0x74F7, 0x750E, 0x7526, 0x753D,
+			0x7554, 0x756B, 0x7582, 0x7599, 0x75B0, 0x75C7, 0x75DE, 0x75F6,
+			0x760D, 0x7624, 0x763B, 0x7652, 0x766A, 0x7681, 0x7698, 0x76AF,
+			0x76C7, 0x76DE, 0x76F5, 0x770C, 0x7724, 0x773B, 0x7752, 0x776A,
+			0x7781, 0x7798, 0x77B0, 0x77C7, 0x77DE, 0x77F6, 0x780D, 0x7825,
+			0x783C, 0x7854, 0x786B, 0x7882, 0x789A, 0x78B1, 0x78C9, 0x78E0,
+			0x78F8, 0x790F, 0x7927, 0x793E, 0x7956, 0x796E, 0x7985, 0x799D,
+			0x79B4, 0x79CC, 0x79E3, 0x79FB, 0x7A13, 0x7A2A, 0x7A42, 0x7A5A,
+			0x7A71, 0x7A89, 0x7AA1, 0x7AB8, 0x7AD0, 0x7AE8, 0x7B00, 0x7B17,
+			0x7B2F, 0x7B47, 0x7B5F, 0x7B76, 0x7B8E, 0x7BA6, 0x7BBE, 0x7BD6,
+			0x7BEE, 0x7C05, 0x7C1D, 0x7C35, 0x7C4D, 0x7C65, 0x7C7D, 0x7C95,
+			0x7CAD, 0x7CC5, 0x7CDC, 0x7CF4, 0x7D0C, 0x7D24, 0x7D3C, 0x7D54,
+			0x7D6C, 0x7D84, 0x7D9C, 0x7DB4, 0x7DCD, 0x7DE5, 0x7DFD, 0x7E15,
+			0x7E2D, 0x7E45, 0x7E5D, 0x7E75, 0x7E8D, 0x7EA5, 0x7EBE, 0x7ED6,
+			0x7EEE, 0x7F06, 0x7F1E, 0x7F37, 0x7F4F, 0x7F67, 0x7F7F, 0x7F97,
+			0x7FB0, 0x7FC8, 0x7FE0, 0x7FF9, 0x8011, 0x8029, 0x8041, 0x805A,
+			0x8072, 0x808A, 0x80A3, 0x80BB, 0x80D4, 0x80EC, 0x8104, 0x811D,
+			0x8135, 0x814E, 0x8166, 0x817F, 0x8197, 0x81B0, 0x81C8, 0x81E1,
+			0x81F9, 0x8212, 0x822A, 0x8243, 0x825B, 0x8274, 0x828C, 0x82A5,
+			0x82BE, 0x82D6, 0x82EF, 0x8307, 0x8320, 0x8339, 0x8351, 0x836A,
+			0x8383, 0x839B, 0x83B4, 0x83CD, 0x83E5, 0x83FE, 0x8417, 0x8430,
+			0x8448, 0x8461, 0x847A, 0x8493, 0x84AC, 0x84C4, 0x84DD, 0x84F6,
+			0x850F, 0x8528, 0x8541, 0x855A, 0x8572, 0x858B, 0x85A4, 0x85BD,
+			0x85D6, 0x85EF, 0x8608, 0x8621, 0x863A, 0x8653, 0x866C, 0x8685,
+			0x869E, 0x86B7, 0x86D0, 0x86E9, 0x8702, 0x871B, 0x8734, 0x874D,
+			0x8767, 0x8780, 0x8799, 0x87B2, 0x87CB, 0x87E4, 0x87FD, 0x8817,
+			0x8830, 0x8849, 0x8862, 0x887B, 0x8895, 0x88AE, 0x88C7, 0x88E0,
+			0x88FA, 0x8913, 0x892C, 0x8946, 0x895F, 0x8978, 0x8991, 0x89AB,
+			0x89C4, 0x89DE, 0x89F7, 0x8A10, 0x8A2A, 0x8A43, 0x8A5D, 0x8A76,
+			0x8A8F, 0x8AA9, 0x8AC2, 0x8ADC, 0x8AF5, 0x8B0F, 0x8B28, 0x8B42,
+			0x8B5B, 0x8B75, 0x8B8E, 0x8BA8, 0x8BC2, 0x8BDB, 0x8BF5, 0x8C0E,
+			0x8C28, 0x8C42, 0x8C5B, 0x8C75, 0x8C8F, 0x8CA8, 0x8CC2, 0x8CDC,
+			0x8CF5, 0x8D0F, 0x8D29, 0x8D42, 0x8D5C, 0x8D76, 0x8D90, 0x8DA9,
+			0x8DC3, 0x8DDD, 0x8DF7, 0x8E11, 0x8E2B, 0x8E44, 0x8E5E, 0x8E78,
+			0x8E92, 0x8EAC, 0x8EC6, 0x8EE0, 0x8EFA, 0x8F13, 0x8F2D, 0x8F47,
+			0x8F61, 0x8F7B, 0x8F95, 0x8FAF, 0x8FC9, 0x8FE3, 0x8FFD, 0x9017,
+			0x9031, 0x904B, 0x9065, 0x907F, 0x909A, 0x90B4, 0x90CE, 0x90E8,
+			0x9102, 0x911C, 0x9136, 0x9150, 0x916B, 0x9185, 0x919F, 0x91B9,
+			0x91D3, 0x91EE, 0x9208, 0x9222, 0x923C, 0x9257, 0x9271, 0x928B,
+			0x92A6, 0x92C0, 0x92DA, 0x92F4, 0x930F, 0x9329, 0x9344, 0x935E,
+			0x9378, 0x9393, 0x93AD, 0x93C8, 0x93E2, 0x93FC, 0x9417, 0x9431,
+			0x944C, 0x9466, 0x9481, 0x949B, 0x94B6, 0x94D0, 0x94EB, 0x9505,
+			0x9520, 0x953B, 0x9555, 0x9570, 0x958A, 0x95A5, 0x95C0, 0x95DA,
+			0x95F5, 0x960F, 0x962A, 0x9645, 0x965F, 0x967A, 0x9695, 0x96B0,
+			0x96CA, 0x96E5, 0x9700, 0x971B, 0x9735, 0x9750, 0x976B, 0x9786,
+			0x97A1, 0x97BB, 0x97D6, 0x97F1, 0x980C, 0x9827, 0x9842, 0x985D,
+			0x9877, 0x9892, 0x98AD, 0x98C8, 0x98E3, 0x98FE, 0x9919, 0x9934,
+			0x994F, 0x996A, 0x9985, 0x99A0, 0x99BB, 0x99D6, 0x99F1, 0x9A0C,
+			0x9A27, 0x9A43, 0x9A5E, 0x9A79, 0x9A94, 0x9AAF, 0x9ACA, 0x9AE5,
+			0x9B00, 0x9B1C, 0x9B37, 0x9B52, 0x9B6D, 0x9B88, 0x9BA4, 0x9BBF,
+			0x9BDA, 0x9BF5, 0x9C11, 0x9C2C, 0x9C47, 0x9C63, 0x9C7E, 0x9C99,
+			0x9CB5, 0x9CD0, 0x9CEB, 0x9D07, 0x9D22, 0x9D3D, 0x9D59, 0x9D74,
+			0x9D90, 0x9DAB, 0x9DC6, 0x9DE2, 0x9DFD, 0x9E19, 0x9E34, 0x9E50,
+			0x9E6B, 0x9E87, 0x9EA2, 0x9EBE, 0x9EDA, 0x9EF5, 0x9F11, 0x9F2C,
+			0x9F48, 0x9F63, 0x9F7F, 0x9F9B, 0x9FB6, 0x9FD2, 0x9FEE, 0xA009,
+			0xA025, 0xA041, 0xA05C, 0xA078, 0xA094, 0xA0B0, 0xA0CB, 0xA0E7,
+			0xA103, 0xA11F, 0xA13B, 0xA156, 0xA172, 0xA18E, 0xA1AA, 0xA1C6,
+			0xA1E1, 0xA1FD, 0xA219, 0xA235, 0xA251, 0xA26D, 0xA289, 0xA2A5,
+			0xA2C1, 0xA2DD, 0xA2F9, 0xA315, 0xA331, 0xA34D, 0xA369, 0xA385,
+			0xA3A1, 0xA3BD, 0xA3D9, 0xA3F5, 0xA411, 0xA42D, 0xA449, 0xA465,
+			0xA481, 0xA49E, 0xA4BA, 0xA4D6, 0xA4F2, 0xA50E, 0xA52A, 0xA547,
+			0xA563, 0xA57F, 0xA59B, 0xA5B8, 0xA5D4, 0xA5F0, 0xA60C, 0xA629,
+			0xA645, 0xA661, 0xA67E, 0xA69A, 0xA6B6, 0xA6D3, 0xA6EF, 0xA70B,
+			0xA728, 0xA744, 0xA760, 0xA77D, 0xA799, 0xA7B6, 0xA7D2, 0xA7EF,
+			0xA80B, 0xA828, 0xA844, 0xA861, 0xA87D, 0xA89A, 0xA8B6, 0xA8D3,
+			0xA8EF, 0xA90C, 0xA929, 0xA945, 0xA962, 0xA97E, 0xA99B, 0xA9B8,
+			0xA9D4, 0xA9F1, 0xAA0E, 0xAA2A, 0xAA47, 0xAA64, 0xAA80, 0xAA9D,
+			0xAABA, 0xAAD7, 0xAAF3, 0xAB10, 0xAB2D, 0xAB4A, 0xAB67, 0xAB83,
+			0xABA0, 0xABBD, 0xABDA, 0xABF7, 0xAC14, 0xAC30, 0xAC4D, 0xAC6A,
+			0xAC87, 0xACA4, 0xACC1, 0xACDE, 0xACFB, 0xAD18, 0xAD35, 0xAD52,
+			0xAD6F, 0xAD8C, 0xADA9, 0xADC6, 0xADE3, 0xAE00, 0xAE1D, 0xAE3A,
+			0xAE57, 0xAE74, 0xAE92, 0xAEAF, 0xAECC, 0xAEE9, 0xAF06, 0xAF23,
+			0xAF40, 0xAF5E, 0xAF7B, 0xAF98, 0xAFB5, 0xAFD3, 0xAFF0, 0xB00D,
+			0xB02A, 0xB048, 0xB065, 0xB082, 0xB09F, 0xB0BD, 0xB0DA, 0xB0F7,
+			0xB115, 0xB132, 0xB150, 0xB16D, 0xB18A, 0xB1A8, 0xB1C5, 0xB1E3,
+			0xB200, 0xB21E, 0xB23B, 0xB259, 0xB276, 0xB294, 0xB2B1, 0xB2CF,
+			0xB2EC, 0xB30A, 0xB327, 0xB345, 0xB362, 0xB380, 0xB39E, 0xB3BB,
+			0xB3D9, 0xB3F6, 0xB414, 0xB432, 0xB44F, 0xB46D, 0xB48B, 0xB4A8,
+			0xB4C6, 0xB4E4, 0xB502, 0xB51F, 0xB53D, 0xB55B, 0xB579, 0xB596,
+			0xB5B4, 0xB5D2, 0xB5F0, 0xB60E, 0xB62C, 0xB649, 0xB667, 0xB685,
+			0xB6A3, 0xB6C1, 0xB6DF, 0xB6FD, 0xB71B, 0xB739, 0xB757, 0xB775,
+			0xB793, 0xB7B1, 0xB7CF, 0xB7ED, 0xB80B, 0xB829, 0xB847, 0xB865,
+			0xB883, 0xB8A1, 0xB8BF, 0xB8DD, 0xB8FB, 0xB919, 0xB938, 0xB956,
+			0xB974, 0xB992, 0xB9B0, 0xB9CE, 0xB9ED, 0xBA0B, 0xBA29, 0xBA47,
+			0xBA66, 0xBA84, 0xBAA2, 0xBAC0, 0xBADF, 0xBAFD, 0xBB1B, 0xBB3A,
+			0xBB58, 0xBB76, 0xBB95, 0xBBB3, 0xBBD1, 0xBBF0, 0xBC0E, 0xBC2D,
+			0xBC4B, 0xBC6A, 0xBC88, 0xBCA6, 0xBCC5, 0xBCE3, 0xBD02, 0xBD20,
+			0xBD3F, 0xBD5D, 0xBD7C, 0xBD9B, 0xBDB9, 0xBDD8, 0xBDF6, 0xBE15,
+			0xBE33, 0xBE52, 0xBE71, 0xBE8F, 0xBEAE, 0xBECD, 0xBEEB, 0xBF0A,
+			0xBF29, 0xBF47, 0xBF66, 0xBF85, 0xBFA4, 0xBFC2, 0xBFE1, 0xC000,
+			0xC01F, 0xC03D, 0xC05C, 0xC07B, 0xC09A, 0xC0B9, 0xC0D8, 0xC0F7,
+			0xC115, 0xC134, 0xC153, 0xC172, 0xC191, 0xC1B0, 0xC1CF, 0xC1EE,
+			0xC20D, 0xC22C, 0xC24B, 0xC26A, 0xC289, 0xC2A8, 0xC2C7, 0xC2E6,
+			0xC305, 0xC324, 0xC343, 0xC362, 0xC381, 0xC3A0, 0xC3C0, 0xC3DF,
+			0xC3FE, 0xC41D, 0xC43C, 0xC45B, 0xC47B, 0xC49A, 0xC4B9, 0xC4D8,
+			0xC4F7, 0xC517, 0xC536, 0xC555, 0xC575, 0xC594, 0xC5B3, 0xC5D2,
+			0xC5F2, 0xC611, 0xC630, 0xC650, 0xC66F, 0xC68F, 0xC6AE, 0xC6CD,
+			0xC6ED, 0xC70C, 0xC72C, 0xC74B, 0xC76B, 0xC78A, 0xC7AA, 0xC7C9,
+			0xC7E9, 0xC808, 0xC828, 0xC847, 0xC867, 0xC886, 0xC8A6, 0xC8C5,
+			0xC8E5, 0xC905, 0xC924, 0xC944, 0xC964, 0xC983, 0xC9A3, 0xC9C3,
+			0xC9E2, 0xCA02, 0xCA22, 0xCA41, 0xCA61, 0xCA81, 0xCAA1, 0xCAC0,
+			0xCAE0, 0xCB00, 0xCB20, 0xCB40, 0xCB5F, 0xCB7F, 0xCB9F, 0xCBBF,
+			0xCBDF, 0xCBFF, 0xCC1F, 0xCC3F, 0xCC5E, 0xCC7E, 0xCC9E, 0xCCBE,
+			0xCCDE, 0xCCFE, 0xCD1E, 0xCD3E, 0xCD5E, 0xCD7E, 0xCD9E, 0xCDBE,
+			0xCDDE, 0xCDFE, 0xCE1F, 0xCE3F, 0xCE5F, 0xCE7F, 0xCE9F, 0xCEBF,
+			0xCEDF, 0xCEFF, 0xCF20, 0xCF40, 0xCF60, 0xCF80, 0xCFA0, 0xCFC1,
+			0xCFE1, 0xD001, 0xD021, 0xD042, 0xD062, 0xD082, 0xD0A2, 0xD0C3,
+			0xD0E3, 0xD103, 0xD124, 0xD144, 0xD165, 0xD185, 0xD1A5, 0xD1C6,
+			0xD1E6, 0xD207, 0xD227, 0xD247, 0xD268, 0xD288, 0xD2A9, 0xD2C9,
+			0xD2EA, 0xD30A, 0xD32B, 0xD34C, 0xD36C, 0xD38D, 0xD3AD, 0xD3CE,
+			0xD3EE, 0xD40F, 0xD430, 0xD450, 0xD471, 0xD492, 0xD4B2, 0xD4D3,
+			0xD4F4, 0xD514, 0xD535, 0xD556, 0xD577, 0xD597, 0xD5B8, 0xD5D9,
+			0xD5FA, 0xD61A, 0xD63B, 0xD65C, 0xD67D, 0xD69E, 0xD6BF, 0xD6DF,
+			0xD700, 0xD721, 0xD742, 0xD763, 0xD784, 0xD7A5, 0xD7C6, 0xD7E7,
+			0xD808, 0xD829, 0xD84A, 0xD86B, 0xD88C, 0xD8AD, 0xD8CE, 0xD8EF,
+			0xD910, 0xD931, 0xD952, 0xD973, 0xD994, 0xD9B5, 0xD9D6, 0xD9F8,
+			0xDA19, 0xDA3A, 0xDA5B, 0xDA7C, 0xDA9E, 0xDABF, 0xDAE0, 0xDB01,
+			0xDB22, 0xDB44, 0xDB65, 0xDB86, 0xDBA8, 0xDBC9, 0xDBEA, 0xDC0B,
+			0xDC2D, 0xDC4E, 0xDC6F, 0xDC91, 0xDCB2, 0xDCD4, 0xDCF5, 0xDD16,
+			0xDD38, 0xDD59, 0xDD7B, 0xDD9C, 0xDDBE, 0xDDDF, 0xDE01, 0xDE22,
+			0xDE44, 0xDE65, 0xDE87, 0xDEA8, 0xDECA, 0xDEEC, 0xDF0D, 0xDF2F,
+			0xDF50, 0xDF72, 0xDF94, 0xDFB5, 0xDFD7, 0xDFF9, 0xE01A, 0xE03C,
+			0xE05E, 0xE07F, 0xE0A1, 0xE0C3, 0xE0E5, 0xE106, 0xE128, 0xE14A,
+			0xE16C, 0xE18D, 0xE1AF, 0xE1D1, 0xE1F3, 0xE215, 0xE237, 0xE259,
+			0xE27A, 0xE29C, 0xE2BE, 0xE2E0, 0xE302, 0xE324, 0xE346, 0xE368,
+			0xE38A, 0xE3AC, 0xE3CE, 0xE3F0, 0xE412, 0xE434, 0xE456, 0xE478,
+			0xE49A, 0xE4BC, 0xE4DE, 0xE501, 0xE523, 0xE545, 0xE567, 0xE589,
+			0xE5AB, 0xE5CD, 0xE5F0, 0xE612, 0xE634, 0xE656, 0xE679, 0xE69B,
+			0xE6BD, 0xE6DF, 0xE702, 0xE724, 0xE746, 0xE769, 0xE78B, 0xE7AD,
+			0xE7D0, 0xE7F2, 0xE814, 0xE837, 0xE859, 0xE87B, 0xE89E, 0xE8C0,
+			0xE8E3, 0xE905, 0xE928, 0xE94A, 0xE96D, 0xE98F, 0xE9B2, 0xE9D4,
+			0xE9F7, 0xEA19, 0xEA3C, 0xEA5E, 0xEA81, 0xEAA4, 0xEAC6, 0xEAE9,
+			0xEB0B, 0xEB2E, 0xEB51, 0xEB73, 0xEB96, 0xEBB9, 0xEBDC, 0xEBFE,
+			0xEC21, 0xEC44, 0xEC66, 0xEC89, 0xECAC, 0xECCF, 0xECF2, 0xED14,
+			0xED37, 0xED5A, 0xED7D, 0xEDA0, 0xEDC3, 0xEDE5, 0xEE08, 0xEE2B,
+			0xEE4E, 0xEE71, 0xEE94, 0xEEB7, 0xEEDA, 0xEEFD, 0xEF20, 0xEF43,
+			0xEF66, 0xEF89, 0xEFAC, 0xEFCF, 0xEFF2, 0xF015, 0xF038, 0xF05B,
+			0xF07E, 0xF0A1, 0xF0C5, 0xF0E8, 0xF10B, 0xF12E, 0xF151, 0xF174,
+			0xF198, 0xF1BB, 0xF1DE, 0xF201, 0xF224, 0xF248, 0xF26B, 0xF28E,
+			0xF2B1, 0xF2D5, 0xF2F8, 0xF31B, 0xF33F, 0xF362, 0xF385, 0xF3A9,
+			0xF3CC, 0xF3F0, 0xF413, 0xF436, 0xF45A, 0xF47D, 0xF4A1, 0xF4C4,
+			0xF4E8, 0xF50B, 0xF52F, 0xF552, 0xF576, 0xF599, 0xF5BD, 0xF5E0,
+			0xF604, 0xF627, 0xF64B, 0xF66F, 0xF692, 0xF6B6, 0xF6D9, 0xF6FD,
+			0xF721, 0xF744, 0xF768, 0xF78C, 0xF7B0, 0xF7D3, 0xF7F7, 0xF81B,
+			0xF83E, 0xF862, 0xF886, 0xF8AA, 0xF8CE, 0xF8F1, 0xF915, 0xF939,
+			0xF95D, 0xF981, 0xF9A5, 0xF9C9, 0xF9EC, 0xFA10, 0xFA34, 0xFA58,
+			0xFA7C, 0xFAA0, 0xFAC4, 0xFAE8, 0xFB0C, 0xFB30, 0xFB54, 0xFB78,
+			0xFB9C, 0xFBC0, 0xFBE4, 0xFC08, 0xFC2C, 0xFC50, 0xFC75, 0xFC99,
+			0xFCBD, 0xFCE1, 0xFD05, 0xFD29, 0xFD4D, 0xFD72, 0xFD96, 0xFDBA,
+			0xFDDE, 0xFE02, 0xFE27, 0xFE4B, 0xFE6F, 0xFE94, 0xFEB8, 0xFEDC,
+			0xFF00, 0xFF25, 0xFF49, 0xFF6D, 0xFF92, 0xFFB6, 0xFFDB, 0xFFFF
+		},
+
+		// sampleX
+		{
+			{
+				{0.0f, 0.0f, 0.0f, 0.0f},
+				{0.3125f, 0.0f, 0.0f, 0.0f},
+				{0.0f, 0.3125f, 0.0f, 0.0f},
+				{0.3125f, 0.3125f, 0.0f, 0.0f},
+				{0.0f, 0.0f, 0.3125f, 0.0f},
+				{0.3125f, 0.0f, 0.3125f, 0.0f},
+				{0.0f, 0.3125f, 0.3125f, 0.0f},
+				{0.3125f, 0.3125f, 0.3125f, 0.0f},
+				{0.0f, 0.0f, 0.0f, 0.3125f},
+				{0.3125f, 0.0f, 0.0f, 0.3125f},
+				{0.0f, 0.3125f, 0.0f, 0.3125f},
+				{0.3125f, 0.3125f, 0.0f, 0.3125f},
+				{0.0f, 0.0f, 0.3125f, 0.3125f},
+				{0.3125f, 0.0f, 0.3125f, 0.3125f},
+				{0.0f, 0.3125f, 0.3125f, 0.3125f},
+				{0.3125f, 0.3125f, 0.3125f, 0.3125f}
+			},
+			{
+				{0.0f, 0.0f, 0.0f, 0.0f},
+				{-0.3125f, 0.0f, 0.0f, 0.0f},
+				{0.0f, -0.3125f, 0.0f, 0.0f},
+				{-0.3125f, -0.3125f, 0.0f, 0.0f},
+				{0.0f, 0.0f, -0.3125f, 0.0f},
+				{-0.3125f, 0.0f, -0.3125f, 0.0f},
+				{0.0f, -0.3125f, -0.3125f, 0.0f},
+				{-0.3125f, -0.3125f, -0.3125f, 0.0f},
+				{0.0f, 0.0f, 0.0f, -0.3125f},
+				{-0.3125f, 0.0f, 0.0f, -0.3125f},
+				{0.0f, -0.3125f, 0.0f, -0.3125f},
+				{-0.3125f, -0.3125f, 0.0f, -0.3125f},
+				{0.0f, 0.0f, -0.3125f, -0.3125f},
+				{-0.3125f, 0.0f, -0.3125f, -0.3125f},
+				{0.0f, -0.3125f, -0.3125f, -0.3125f},
+				{-0.3125f, -0.3125f, -0.3125f, -0.3125f}
+			},
+			{
+				{0.0f, 0.0f, 0.0f, 0.0f},
+				{-0.125f, 0.0f, 0.0f, 0.0f},
+				{0.0f, -0.125f, 0.0f, 0.0f},
+				{-0.125f, -0.125f, 0.0f, 0.0f},
+				{0.0f, 0.0f, -0.125f, 0.0f},
+				{-0.125f, 0.0f, -0.125f, 0.0f},
+				{0.0f, -0.125f, -0.125f, 0.0f},
+				{-0.125f, -0.125f, -0.125f, 0.0f},
+				{0.0f, 0.0f, 0.0f, -0.125f},
+				{-0.125f, 0.0f, 0.0f, -0.125f},
+				{0.0f, -0.125f, 0.0f, -0.125f},
+				{-0.125f, -0.125f, 0.0f, -0.125f},
+				{0.0f, 0.0f, -0.125f, -0.125f},
+				{-0.125f, 0.0f, -0.125f, -0.125f},
+				{0.0f, -0.125f, -0.125f, -0.125f},
+				{-0.125f, -0.125f, -0.125f, -0.125f}
+			},
+			{
+				{0.0f, 0.0f, 0.0f, 0.0f},
+				{0.125f, 0.0f, 0.0f, 0.0f},
+				{0.0f, 0.125f, 0.0f, 0.0f},
+				{0.125f, 0.125f, 0.0f, 0.0f},
+				{0.0f, 0.0f, 0.125f, 0.0f},
+				{0.125f, 0.0f, 0.125f, 0.0f},
+				{0.0f, 0.125f, 0.125f, 0.0f},
+				{0.125f, 0.125f, 0.125f, 0.0f},
+				{0.0f, 0.0f, 0.0f, 0.125f},
+				{0.125f, 0.0f, 0.0f, 0.125f},
+				{0.0f, 0.125f, 0.0f, 0.125f},
+				{0.125f, 0.125f, 0.0f, 0.125f},
+				{0.0f, 0.0f, 0.125f, 0.125f},
+				{0.125f, 0.0f, 0.125f, 0.125f},
+				{0.0f, 0.125f, 0.125f, 0.125f},
+				{0.125f, 0.125f, 0.125f, 0.125f}
+			}
+		},
+
+		// sampleY
 		{
-			for(int c = 0; c < 16; c++)
 			{
-				for(int i = 0; i < 4; i++)
-				{
-					const float X[4] = {+0.3125f, -0.3125f, -0.1250f, +0.1250f};
-					const float Y[4] = {+0.1250f, -0.1250f, +0.3125f, -0.3125f};
-
-					sampleX[q][c][i] = c & (1 << i) ? X[q] : 0.0f;
-					sampleY[q][c][i] = c & (1 << i) ? Y[q] : 0.0f;
-					weight[c][i] = c & (1 << i) ? 1.0f : 0.0f;
-				}
+				{0.0f, 0.0f, 0.0f, 0.0f},
+				{0.125f, 0.0f, 0.0f, 0.0f},
+				{0.0f, 0.125f, 0.0f, 0.0f},
+				{0.125f, 0.125f, 0.0f, 0.0f},
+				{0.0f, 0.0f, 0.125f, 0.0f},
+				{0.125f, 0.0f, 0.125f, 0.0f},
+				{0.0f, 0.125f, 0.125f, 0.0f},
+				{0.125f, 0.125f, 0.125f, 0.0f},
+				{0.0f, 0.0f, 0.0f, 0.125f},
+				{0.125f, 0.0f, 0.0f, 0.125f},
+				{0.0f, 0.125f, 0.0f, 0.125f},
+				{0.125f, 0.125f, 0.0f, 0.125f},
+				{0.0f, 0.0f, 0.125f, 0.125f},
+				{0.125f, 0.0f, 0.125f, 0.125f},
+				{0.0f, 0.125f, 0.125f, 0.125f},
+				{0.125f, 0.125f, 0.125f, 0.125f}
+			},
+			{
+				{0.0f, 0.0f, 0.0f, 0.0f},
+				{-0.125f, 0.0f, 0.0f, 0.0f},
+				{0.0f, -0.125f, 0.0f, 0.0f},
+				{-0.125f, -0.125f, 0.0f, 0.0f},
+				{0.0f, 0.0f, -0.125f, 0.0f},
+				{-0.125f, 0.0f, -0.125f, 0.0f},
+				{0.0f, -0.125f, -0.125f, 0.0f},
+				{-0.125f, -0.125f, -0.125f, 0.0f},
+				{0.0f, 0.0f, 0.0f, -0.125f},
+				{-0.125f, 0.0f, 0.0f, -0.125f},
+				{0.0f, -0.125f, 0.0f, -0.125f},
+				{-0.125f, -0.125f, 0.0f, -0.125f},
+				{0.0f, 0.0f, -0.125f, -0.125f},
+				{-0.125f, 0.0f, -0.125f, -0.125f},
+				{0.0f, -0.125f, -0.125f, -0.125f},
+				{-0.125f, -0.125f, -0.125f, -0.125f}
+			},
+			{
+				{0.0f, 0.0f, 0.0f, 0.0f},
+				{0.3125f, 0.0f, 0.0f, 0.0f},
+				{0.0f, 0.3125f, 0.0f, 0.0f},
+				{0.3125f, 0.3125f, 0.0f, 0.0f},
+				{0.0f, 0.0f, 0.3125f, 0.0f},
+				{0.3125f, 0.0f, 0.3125f, 0.0f},
+				{0.0f, 0.3125f, 0.3125f, 0.0f},
+				{0.3125f, 0.3125f, 0.3125f, 0.0f},
+				{0.0f, 0.0f, 0.0f, 0.3125f},
+				{0.3125f, 0.0f, 0.0f, 0.3125f},
+				{0.0f, 0.3125f, 0.0f, 0.3125f},
+				{0.3125f, 0.3125f, 0.0f, 0.3125f},
+				{0.0f, 0.0f, 0.3125f, 0.3125f},
+				{0.3125f, 0.0f, 0.3125f, 0.3125f},
+				{0.0f, 0.3125f, 0.3125f, 0.3125f},
+				{0.3125f, 0.3125f, 0.3125f, 0.3125f}
+			},
+			{
+				{0.0f, 0.0f, 0.0f, 0.0f},
+				{-0.3125f, 0.0f, 0.0f, 0.0f},
+				{0.0f, -0.3125f, 0.0f, 0.0f},
+				{-0.3125f, -0.3125f, 0.0f, 0.0f},
+				{0.0f, 0.0f, -0.3125f, 0.0f},
+				{-0.3125f, 0.0f, -0.3125f, 0.0f},
+				{0.0f, -0.3125f, -0.3125f, 0.0f},
+				{-0.3125f, -0.3125f, -0.3125f, 0.0f},
+				{0.0f, 0.0f, 0.0f, -0.3125f},
+				{-0.3125f, 0.0f, 0.0f, -0.3125f},
+				{0.0f, -0.3125f, 0.0f, -0.3125f},
+				{-0.3125f, -0.3125f, 0.0f, -0.3125f},
+				{0.0f, 0.0f, -0.3125f, -0.3125f},
+				{-0.3125f, 0.0f, -0.3125f, -0.3125f},
+				{0.0f, -0.3125f, -0.3125f, -0.3125f},
+				{-0.3125f, -0.3125f, -0.3125f, -0.3125f}
 			}
-		}
-
-		const int Xf[4] = {-5, +5, +2, -2};   // Fragment offsets
-		const int Yf[4] = {-2, +2, -5, +5};   // Fragment offsets
-
-		memcpy(&this->Xf, &Xf, sizeof(Xf));
-		memcpy(&this->Yf, &Yf, sizeof(Yf));
-
-		static const float4 X[4] = {{-0.3125f, -0.3125f, -0.3125f, -0.3125f},
-					                {+0.3125f, +0.3125f, +0.3125f, +0.3125f},
-					                {+0.1250f, +0.1250f, +0.1250f, +0.1250f},
-					                {-0.1250f, -0.1250f, -0.1250f, -0.1250f}};
-
-		static const float4 Y[4] = {{-0.1250f, -0.1250f, -0.1250f, -0.1250f},
-		                            {+0.1250f, +0.1250f, +0.1250f, +0.1250f},
-		                            {-0.3125f, -0.3125f, -0.3125f, -0.3125f},
-		                            {+0.3125f, +0.3125f, +0.3125f, +0.3125f}};
-
-		memcpy(&this->X, &X, sizeof(X));
-		memcpy(&this->Y, &Y, sizeof(Y));
-
-		const dword maxX[16] = {0x00000000, 0x00000001, 0x00000100, 0x00000101, 0x00010000, 0x00010001, 0x00010100, 0x00010101, 0x01000000, 0x01000001, 0x01000100, 0x01000101, 0x01010000, 0x01010001, 0x01010100, 0x01010101};
-		const dword maxY[16] = {0x00000000, 0x00000002, 0x00000200, 0x00000202, 0x00020000, 0x00020002, 0x00020200, 0x00020202, 0x02000000, 0x02000002, 0x02000200, 0x02000202, 0x02020000, 0x02020002, 0x02020200, 0x02020202};
-		const dword maxZ[16] = {0x00000000, 0x00000004, 0x00000400, 0x00000404, 0x00040000, 0x00040004, 0x00040400, 0x00040404, 0x04000000, 0x04000004, 0x04000400, 0x04000404, 0x04040000, 0x04040004, 0x04040400, 0x04040404};
-		const dword minX[16] = {0x00000000, 0x00000008, 0x00000800, 0x00000808, 0x00080000, 0x00080008, 0x00080800, 0x00080808, 0x08000000, 0x08000008, 0x08000800, 0x08000808, 0x08080000, 0x08080008, 0x08080800, 0x08080808};
-		const dword minY[16] = {0x00000000, 0x00000010, 0x00001000, 0x00001010, 0x00100000, 0x00100010, 0x00101000, 0x00101010, 0x10000000, 0x10000010, 0x10001000, 0x10001010, 0x10100000, 0x10100010, 0x10101000, 0x10101010};
-		const dword minZ[16] = {0x00000000, 0x00000020, 0x00002000, 0x00002020, 0x00200000, 0x00200020, 0x00202000, 0x00202020, 0x20000000, 0x20000020, 0x20002000, 0x20002020, 0x20200000, 0x20200020, 0x20202000, 0x20202020};
-		const dword fini[16] = {0x00000000, 0x00000080, 0x00008000, 0x00008080, 0x00800000, 0x00800080, 0x00808000, 0x00808080, 0x80000000, 0x80000080, 0x80008000, 0x80008080, 0x80800000, 0x80800080, 0x80808000, 0x80808080};
-
-		memcpy(&this->maxX, &maxX, sizeof(maxX));
-		memcpy(&this->maxY, &maxY, sizeof(maxY));
-		memcpy(&this->maxZ, &maxZ, sizeof(maxZ));
-		memcpy(&this->minX, &minX, sizeof(minX));
-		memcpy(&this->minY, &minY, sizeof(minY));
-		memcpy(&this->minZ, &minZ, sizeof(minZ));
-		memcpy(&this->fini, &fini, sizeof(fini));
-
-		static const dword4 maxPos = {0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFE};
-
-		memcpy(&this->maxPos, &maxPos, sizeof(maxPos));
-
-		static const float4 unscaleByte = {1.0f / 0xFF, 1.0f / 0xFF, 1.0f / 0xFF, 1.0f / 0xFF};
-		static const float4 unscaleSByte = {1.0f / 0x7F, 1.0f / 0x7F, 1.0f / 0x7F, 1.0f / 0x7F};
-		static const float4 unscaleShort = {1.0f / 0x7FFF, 1.0f / 0x7FFF, 1.0f / 0x7FFF, 1.0f / 0x7FFF};
-		static const float4 unscaleUShort = {1.0f / 0xFFFF, 1.0f / 0xFFFF, 1.0f / 0xFFFF, 1.0f / 0xFFFF};
-		static const float4 unscaleInt = {1.0f / 0x7FFFFFFF, 1.0f / 0x7FFFFFFF, 1.0f / 0x7FFFFFFF, 1.0f / 0x7FFFFFFF};
-		static const float4 unscaleUInt = {1.0f / 0xFFFFFFFF, 1.0f / 0xFFFFFFFF, 1.0f / 0xFFFFFFFF, 1.0f / 0xFFFFFFFF};
-		static const float4 unscaleFixed = {1.0f / 0x00010000, 1.0f / 0x00010000, 1.0f / 0x00010000, 1.0f / 0x00010000};
-
-		memcpy(&this->unscaleByte, &unscaleByte, sizeof(unscaleByte));
-		memcpy(&this->unscaleSByte, &unscaleSByte, sizeof(unscaleSByte));
-		memcpy(&this->unscaleShort, &unscaleShort, sizeof(unscaleShort));
-		memcpy(&this->unscaleUShort, &unscaleUShort, sizeof(unscaleUShort));
-		memcpy(&this->unscaleInt, &unscaleInt, sizeof(unscaleInt));
-		memcpy(&this->unscaleUInt, &unscaleUInt, sizeof(unscaleUInt));
-		memcpy(&this->unscaleFixed, &unscaleFixed, sizeof(unscaleFixed));
-
-		for(int i = 0; i <= 0xFFFF; i++)
-		{
-			half2float[i] = (float)reinterpret_cast<half&>(i);
-		}
-	}
-}
\ No newline at end of file
+		},
+
+		// weight
+		{
+			{0.0f, 0.0f, 0.0f, 0.0f},
+			{1.0f, 0.0f, 0.0f, 0.0f},
+			{0.0f, 1.0f, 0.0f, 0.0f},
+			{1.0f, 1.0f, 0.0f, 0.0f},
+			{0.0f, 0.0f, 1.0f, 0.0f},
+			{1.0f, 0.0f, 1.0f, 0.0f},
+			{0.0f, 1.0f, 1.0f, 0.0f},
+			{1.0f, 1.0f, 1.0f, 0.0f},
+			{0.0f, 0.0f, 0.0f, 1.0f},
+			{1.0f, 0.0f, 0.0f, 1.0f},
+			{0.0f, 1.0f, 0.0f, 1.0f},
+			{1.0f, 1.0f, 0.0f, 1.0f},
+			{0.0f, 0.0f, 1.0f, 1.0f},
+			{1.0f, 0.0f, 1.0f, 1.0f},
+			{0.0f, 1.0f, 1.0f, 1.0f},
+			{1.0f, 1.0f, 1.0f, 1.0f}
+		},
+
+		// Xf
+		{-5, 5, 2, -2},
+
+		// Yf
+		{-2, 2, -5, 5},
+
+		// X
+		{
+			{-0.3125f, -0.3125f, -0.3125f, -0.3125f},
+			{0.3125f, 0.3125f, 0.3125f, 0.3125f},
+			{0.125f, 0.125f, 0.125f, 0.125f},
+			{-0.125f, -0.125f, -0.125f, -0.125f}
+		},
+
+		// Y
+		{
+			{-0.125f, -0.125f, -0.125f, -0.125f},
+			{0.125f, 0.125f, 0.125f, 0.125f},
+			{-0.3125f, -0.3125f, -0.3125f, -0.3125f},
+			{0.3125f, 0.3125f, 0.3125f, 0.3125f}
+		},
+
+		// maxX
+		{
+			0x00000000, 0x00000001, 0x00000100, 0x00000101, 0x00010000, 0x00010001, 0x00010100, 0x00010101,
+			0x01000000, 0x01000001, 0x01000100, 0x01000101, 0x01010000, 0x01010001, 0x01010100, 0x01010101
+		},
+
+		// maxY
+		{
+			0x00000000, 0x00000002, 0x00000200, 0x00000202, 0x00020000, 0x00020002, 0x00020200, 0x00020202,
+			0x02000000, 0x02000002, 0x02000200, 0x02000202, 0x02020000, 0x02020002, 0x02020200, 0x02020202
+		},
+
+		// maxZ
+		{
+			0x00000000, 0x00000004, 0x00000400, 0x00000404, 0x00040000, 0x00040004, 0x00040400, 0x00040404,
+			0x04000000, 0x04000004, 0x04000400, 0x04000404, 0x04040000, 0x04040004, 0x04040400, 0x04040404
+		},
+
+		// minX
+		{
+			0x00000000, 0x00000008, 0x00000800, 0x00000808, 0x00080000, 0x00080008, 0x00080800, 0x00080808,
+			0x08000000, 0x08000008, 0x08000800, 0x08000808, 0x08080000, 0x08080008, 0x08080800, 0x08080808
+		},
+
+		// minY
+		{
+			0x00000000, 0x00000010, 0x00001000, 0x00001010, 0x00100000, 0x00100010, 0x00101000, 0x00101010,
+			0x10000000, 0x10000010, 0x10001000, 0x10001010, 0x10100000, 0x10100010, 0x10101000, 0x10101010
+		},
+
+		// minZ
+		{
+			0x00000000, 0x00000020, 0x00002000, 0x00002020, 0x00200000, 0x00200020, 0x00202000, 0x00202020,
+			0x20000000, 0x20000020, 0x20002000, 0x20002020, 0x20200000, 0x20200020, 0x20202000, 0x20202020
+		},
+
+		// fini
+		{
+			0x00000000, 0x00000080, 0x00008000, 0x00008080, 0x00800000, 0x00800080, 0x00808000, 0x00808080,
+			0x80000000, 0x80000080, 0x80008000, 0x80008080, 0x80800000, 0x80800080, 0x80808000, 0x80808080
+		},
+
+		// maxPos
+		{0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFE},
+
+		// unscaleByte
+		{0.00392156886f, 0.00392156886f, 0.00392156886f, 0.00392156886f},
+
+		// unscaleSByte
+		{0.00787401572f, 0.00787401572f, 0.00787401572f, 0.00787401572f},
+
+		// unscaleShort
+		{3.05185094e-05f, 3.05185094e-05f, 3.05185094e-05f, 3.05185094e-05f},
+
+		// unscaleUShort
+		{1.52590219e-05f, 1.52590219e-05f, 1.52590219e-05f, 1.52590219e-05f},
+
+		// unscaleInt
+		{4.65661287e-10f, 4.65661287e-10f, 4.65661287e-10f, 4.65661287e-10f},
+
+		// unscaleUInt
+		{2.32830644e-10f, 2.32830644e-10f, 2.32830644e-10f, 2.32830644e-10f},
+
+		// unscaleFixed
+		{1.52587891e-05f, 1.52587891e-05f, 1.52587891e-05f, 1.52587891e-05f}
+	};
+}
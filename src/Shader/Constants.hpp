@@ -19,10 +19,10 @@
 
 namespace sw
 {
+	// Lookup tables used by the generated routines. Constants.cpp holds their values, generated by
+	// generate_constants.py, so they're constant initialized into read-only memory shared by all processes.
 	struct Constants
 	{
-		Constants();
-
 		unsigned int transposeBit0[16];
 		unsigned int transposeBit1[16];
 		unsigned int transposeBit2[16];
@@ -70,8 +70,10 @@ namespace sw
 		unsigned short sRGBtoLinear8_16[256];
 		unsigned short sRGBtoLinear6_16[64];
 		unsigned short sRGBtoLinear5_16[32];
+		float sRGBtoLinear8_32F[256];
 
 		unsigned short linearToSRGB12_16[4096];
+		float sRGB8boundary[257];   // Linear values which get encoded halfway between 8-bit sRGB values
 		unsigned short sRGBtoLinear12_16[4096];
 
 		// Centroid parameters
@@ -103,11 +105,9 @@ namespace sw
 		float4 unscaleInt;
 		float4 unscaleUInt;
 		float4 unscaleFixed;
-
-		float half2float[65536];
 	};
 
-	extern Constants constants;
+	extern const Constants constants;
 }
 
 #endif   // sw_Constants_hpp
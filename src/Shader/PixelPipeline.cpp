@@ -1230,14 +1230,17 @@ namespace sw
 	{
 		Vector4s c;
 
-		#if PERF_PROFILE
-			Long texTime = Ticks();
-		#endif
+		Long texTime;
+
+		if(state.pipelineProfiled)
+		{
+			texTime = Ticks();
+		}
 
 		Vector4f dsx;
 		Vector4f dsy;
 
-		Pointer<Byte> texture = data + OFFSET(DrawData, mipmap) + stage * sizeof(Texture);
+		Pointer<Byte> texture = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData, mipmap) + stage * sizeof(Texture*));
 
 		if(!project)
 		{
@@ -1254,9 +1257,16 @@ namespace sw
 			c = SamplerCore(constants, state.sampler[stage]).sampleTexture(texture, u_q, v_q, w_q, q, q, dsx, dsy);
 		}
 
-		#if PERF_PROFILE
+		if(state.pipelineProfiled)
+		{
 			cycles[PERF_TEX] += Ticks() - texTime;
-		#endif
+			texOperations += Long(Int(4));
+
+			if(state.sampler[stage].compressedFormat)
+			{
+				compressedTex += Long(Int(4));
+			}
+		}
 
 		return c;
 	}
@@ -84,7 +84,12 @@ namespace sw
 			}
 		}
 
-		// Create all call site return blocks up front
+		for(int i = 0; i < TEXTURE_IMAGE_UNITS; i++)
+		{
+			samplerSites[i] = 0;
+		}
+
+		// Create all call site return blocks up front, and count the sampling sites
 		for(size_t i = 0; i < shader->getLength(); i++)
 		{
 			const Shader::Instruction *instruction = shader->getInstruction(i);
@@ -97,10 +102,32 @@ namespace sw
 				ASSERT(callRetBlock[dst.label].size() == dst.callSite);
 				callRetBlock[dst.label].push_back(Nucleus::createBasicBlock());
 			}
+
+			const Src &sampler = instruction->src[1];
+
+			if(sampler.type == Shader::PARAMETER_SAMPLER && opcode != Shader::OPCODE_TEXSIZE)
+			{
+				for(int j = 0; j < TEXTURE_IMAGE_UNITS; j++)
+				{
+					if(sampler.rel.type == Shader::PARAMETER_VOID ? j == (int)sampler.index : shader->usesSampler(j))
+					{
+						samplerSites[j]++;
+					}
+				}
+			}
 		}
 
 		bool broadcastColor0 = true;
 
+		// Cycles and executions of each instruction, accumulated per cluster
+		Pointer<Byte> profile;
+		Long profileStart;
+
+		if(state.shaderProfiled)
+		{
+			profile = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,shaderProfile)) + cluster * Int(static_cast<int>(2 * sizeof(int64_t) * shader->getLength()));
+		}
+
 		for(size_t i = 0; i < shader->getLength(); i++)
 		{
 			const Shader::Instruction *instruction = shader->getInstruction(i);
@@ -111,6 +138,13 @@ namespace sw
 				continue;
 			}
 
+			bool profiled = state.shaderProfiled && !changesControlFlow(opcode);
+
+			if(profiled)
+			{
+				profileStart = Ticks();
+			}
+
 			const Dst &dst = instruction->dst;
 			const Src &src0 = instruction->src[0];
 			const Src &src1 = instruction->src[1];
@@ -121,6 +155,7 @@ namespace sw
 			bool predicate = instruction->predicate;
 			Control control = instruction->control;
 			bool pp = dst.partialPrecision;
+			bool mp = pp || dst.mediumPrecision;   // 2^-10 relative precision suffices
 			bool project = instruction->project;
 			bool bias = instruction->bias;
 
@@ -200,11 +235,11 @@ namespace sw
 			case Shader::OPCODE_ROUNDEVEN:  roundEven(d, s0);                              break;
 			case Shader::OPCODE_CEIL:       ceil(d, s0);                                   break;
 			case Shader::OPCODE_EXP2X:      exp2x(d, s0, pp);                              break;
-			case Shader::OPCODE_EXP2:       exp2(d, s0, pp);                               break;
+			case Shader::OPCODE_EXP2:       exp2(d, s0, mp);                               break;
 			case Shader::OPCODE_LOG2X:      log2x(d, s0, pp);                              break;
-			case Shader::OPCODE_LOG2:       log2(d, s0, pp);                               break;
-			case Shader::OPCODE_EXP:        exp(d, s0, pp);                                break;
-			case Shader::OPCODE_LOG:        log(d, s0, pp);                                break;
+			case Shader::OPCODE_LOG2:       log2(d, s0, mp);                               break;
+			case Shader::OPCODE_EXP:        exp(d, s0, mp);                                break;
+			case Shader::OPCODE_LOG:        log(d, s0, mp);                                break;
 			case Shader::OPCODE_RCPX:       rcpx(d, s0, pp);                               break;
 			case Shader::OPCODE_DIV:        div(d, s0, s1);                                break;
 			case Shader::OPCODE_IDIV:       idiv(d, s0, s1);                               break;
@@ -217,7 +252,7 @@ namespace sw
 			case Shader::OPCODE_USHR:       ushr(d, s0, s1);                               break;
 			case Shader::OPCODE_RSQX:       rsqx(d, s0, pp);                               break;
 			case Shader::OPCODE_SQRT:       sqrt(d, s0, pp);                               break;
-			case Shader::OPCODE_RSQ:        rsq(d, s0, pp);                                break;
+			case Shader::OPCODE_RSQ:        rsq(d, s0, mp);                                break;
 			case Shader::OPCODE_LEN2:       len2(d.x, s0, pp);                             break;
 			case Shader::OPCODE_LEN3:       len3(d.x, s0, pp);                             break;
 			case Shader::OPCODE_LEN4:       len4(d.x, s0, pp);                             break;
@@ -247,7 +282,7 @@ namespace sw
 			case Shader::OPCODE_UNPACKUNORM2x16: unpackUnorm2x16(d, s0);                   break;
 			case Shader::OPCODE_UNPACKHALF2x16:  unpackHalf2x16(d, s0);                    break;
 			case Shader::OPCODE_POWX:       powx(d, s0, s1, pp);                           break;
-			case Shader::OPCODE_POW:        pow(d, s0, s1, pp);                            break;
+			case Shader::OPCODE_POW:        pow(d, s0, s1, mp);                            break;
 			case Shader::OPCODE_SGN:        sgn(d, s0);                                    break;
 			case Shader::OPCODE_ISGN:       isgn(d, s0);                                   break;
 			case Shader::OPCODE_CRS:        crs(d, s0, s1);                                break;
@@ -269,8 +304,8 @@ namespace sw
 			case Shader::OPCODE_ABS:        abs(d, s0);                                    break;
 			case Shader::OPCODE_IABS:       iabs(d, s0);                                   break;
 			case Shader::OPCODE_SINCOS:     sincos(d, s0, pp);                             break;
-			case Shader::OPCODE_COS:        cos(d, s0, pp);                                break;
-			case Shader::OPCODE_SIN:        sin(d, s0, pp);                                break;
+			case Shader::OPCODE_COS:        cos(d, s0, pp, mp);                            break;
+			case Shader::OPCODE_SIN:        sin(d, s0, pp, mp);                            break;
 			case Shader::OPCODE_TAN:        tan(d, s0, pp);                                break;
 			case Shader::OPCODE_ACOS:       acos(d, s0, pp);                               break;
 			case Shader::OPCODE_ASIN:       asin(d, s0, pp);                               break;
@@ -318,8 +353,8 @@ namespace sw
 			case Shader::OPCODE_ENDREP:     ENDREP();                                      break;
 			case Shader::OPCODE_ENDWHILE:   ENDWHILE();                                    break;
 			case Shader::OPCODE_ENDSWITCH:  ENDSWITCH();                                   break;
-			case Shader::OPCODE_IF:         IF(src0);                                      break;
-			case Shader::OPCODE_IFC:        IFC(s0, s1, control);                          break;
+			case Shader::OPCODE_IF:         IF(src0, instruction->analysisUniform);        break;
+			case Shader::OPCODE_IFC:        IFC(s0, s1, control, instruction->analysisUniform); break;
 			case Shader::OPCODE_LABEL:      LABEL(dst.index);                              break;
 			case Shader::OPCODE_LOOP:       LOOP(src1);                                    break;
 			case Shader::OPCODE_REP:        REP(src0);                                     break;
@@ -545,6 +580,27 @@ namespace sw
 					ASSERT(false);
 				}
 			}
+
+			if(profiled)
+			{
+				Pointer<Byte> entry = profile + static_cast<int>(2 * sizeof(int64_t) * i);
+				*Pointer<Long>(entry) += Ticks() - profileStart;
+				*Pointer<Long>(entry + static_cast<int>(sizeof(int64_t))) += Long(Int(1));
+			}
+		}
+
+		if(!sharedSampler.empty())
+		{
+			BasicBlock *continuationBlock = Nucleus::getInsertBlock();
+
+			for(auto &shared : sharedSampler)
+			{
+				shared.second->emit();
+				delete shared.second;
+			}
+
+			sharedSampler.clear();
+			Nucleus::setInsertBlock(continuationBlock);
 		}
 
 		if(currentLabel != -1)
@@ -751,16 +807,43 @@ namespace sw
 
 	Vector4f PixelProgram::sampleTexture(int samplerIndex, Vector4f &uvwq, Float4 &bias, Vector4f &dsx, Vector4f &dsy, Vector4f &offset, SamplerFunction function)
 	{
-		#if PERF_PROFILE
-			Long texTime = Ticks();
-		#endif
+		Long texTime;
+
+		if(state.pipelineProfiled)
+		{
+			texTime = Ticks();
+		}
+
+		Pointer<Byte> texture = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData, mipmap) + samplerIndex * sizeof(Texture*));
+		Vector4f c;
+
+		// Sampling code is large, so emit it once for samplers used by several instructions
+		if(samplerSites[samplerIndex] > 1)
+		{
+			SharedSampler *&shared = sharedSampler[(samplerIndex << 8) | (function.method << 4) | function.option];
 
-		Pointer<Byte> texture = data + OFFSET(DrawData, mipmap) + samplerIndex * sizeof(Texture);
-		Vector4f c = SamplerCore(constants, state.sampler[samplerIndex]).sampleTexture(texture, uvwq.x, uvwq.y, uvwq.z, uvwq.w, bias, dsx, dsy, offset, function);
+			if(!shared)
+			{
+				shared = new SharedSampler(constants, state.sampler[samplerIndex], function);
+			}
+
+			c = shared->sampleTexture(texture, uvwq, bias, dsx, dsy, offset);
+		}
+		else
+		{
+			c = SamplerCore(constants, state.sampler[samplerIndex]).sampleTexture(texture, uvwq.x, uvwq.y, uvwq.z, uvwq.w, bias, dsx, dsy, offset, function);
+		}
 
-		#if PERF_PROFILE
+		if(state.pipelineProfiled)
+		{
 			cycles[PERF_TEX] += Ticks() - texTime;
-		#endif
+			texOperations += Long(Int(4));
+
+			if(state.sampler[samplerIndex].compressedFormat)
+			{
+				compressedTex += Long(Int(4));
+			}
+		}
 
 		return c;
 	}
@@ -830,6 +913,38 @@ namespace sw
 		}
 	}
 
+	bool PixelProgram::changesControlFlow(Shader::Opcode opcode)
+	{
+		switch(opcode)
+		{
+		case Shader::OPCODE_BREAK:
+		case Shader::OPCODE_BREAKC:
+		case Shader::OPCODE_BREAKP:
+		case Shader::OPCODE_CONTINUE:
+		case Shader::OPCODE_TEST:
+		case Shader::OPCODE_CALL:
+		case Shader::OPCODE_CALLNZ:
+		case Shader::OPCODE_ELSE:
+		case Shader::OPCODE_ENDIF:
+		case Shader::OPCODE_ENDLOOP:
+		case Shader::OPCODE_ENDREP:
+		case Shader::OPCODE_ENDWHILE:
+		case Shader::OPCODE_ENDSWITCH:
+		case Shader::OPCODE_IF:
+		case Shader::OPCODE_IFC:
+		case Shader::OPCODE_LABEL:
+		case Shader::OPCODE_LOOP:
+		case Shader::OPCODE_REP:
+		case Shader::OPCODE_WHILE:
+		case Shader::OPCODE_SWITCH:
+		case Shader::OPCODE_RET:
+		case Shader::OPCODE_LEAVE:
+			return true;
+		default:
+			return false;
+		}
+	}
+
 	Int4 PixelProgram::enableMask(const Shader::Instruction *instruction)
 	{
 		Int4 enable = instruction->analysisBranch ? Int4(enableStack[enableIndex]) : Int4(0xFFFFFFFF);
@@ -1019,24 +1134,20 @@ namespace sw
 			c.z = c.z.zzzz;
 			c.w = c.w.wwww;
 
-			if(shader->containsDefineInstruction())   // Constant may be known at compile time
+			if(const Shader::Instruction *definition = shader->getDefinition(i))   // Constant known at compile time
 			{
-				for(size_t j = 0; j < shader->getLength(); j++)
-				{
-					const Shader::Instruction &instruction = *shader->getInstruction(j);
-
-					if(instruction.opcode == Shader::OPCODE_DEF)
-					{
-						if(instruction.dst.index == i)
-						{
-							c.x = Float4(instruction.src[0].value[0]);
-							c.y = Float4(instruction.src[0].value[1]);
-							c.z = Float4(instruction.src[0].value[2]);
-							c.w = Float4(instruction.src[0].value[3]);
+				c.x = Float4(definition->src[0].value[0]);
+				c.y = Float4(definition->src[0].value[1]);
+				c.z = Float4(definition->src[0].value[2]);
+				c.w = Float4(definition->src[0].value[3]);
+			}
 
-							break;
-						}
-					}
+			for(int k = 0; k < MAX_SPECIALIZED_UNIFORMS; k++)
+			{
+				// Uniform known when the routine was selected
+				if((state.specializedUniforms & (1 << k)) && src.bufferIndex == -1 && shader->getSpecializableConstant(k) / 4 == i)
+				{
+					c[shader->getSpecializableConstant(k) % 4] = As<Float4>(Int4(static_cast<int>(state.specializedValue[k])));
 				}
 			}
 		}
@@ -1276,7 +1387,7 @@ namespace sw
 
 	void PixelProgram::TEXSIZE(Vector4f &dst, Float4 &lod, const Src &src1)
 	{
-		Pointer<Byte> texture = data + OFFSET(DrawData, mipmap) + src1.index * sizeof(Texture);
+		Pointer<Byte> texture = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData, mipmap) + src1.index * sizeof(Texture*));
 		dst = SamplerCore::textureSize(texture, lod);
 	}
 
@@ -1587,7 +1698,7 @@ namespace sw
 		Nucleus::setInsertBlock(endBlock);
 	}
 
-	void PixelProgram::IF(const Src &src)
+	void PixelProgram::IF(const Src &src, bool uniform)
 	{
 		if(src.type == Shader::PARAMETER_CONSTBOOL)
 		{
@@ -1600,7 +1711,7 @@ namespace sw
 		else
 		{
 			Int4 condition = As<Int4>(fetchRegister(src).x);
-			IF(condition);
+			IF(condition, uniform);
 		}
 	}
 
@@ -1638,7 +1749,7 @@ namespace sw
 		IF(condition);
 	}
 
-	void PixelProgram::IFC(Vector4f &src0, Vector4f &src1, Control control)
+	void PixelProgram::IFC(Vector4f &src0, Vector4f &src1, Control control, bool uniform)
 	{
 		Int4 condition;
 
@@ -1654,13 +1765,43 @@ namespace sw
 			ASSERT(false);
 		}
 
-		IF(condition);
+		IF(condition, uniform);
 	}
 
-	void PixelProgram::IF(Int4 &condition)
+	void PixelProgram::IF(Int4 &condition, bool uniform)
 	{
 		condition &= enableStack[enableIndex];
 
+		if(state.pipelineProfiled)
+		{
+			Int conditionMask = SignMask(condition);
+			Int enableMask = SignMask(enableStack[enableIndex]);
+
+			If(conditionMask == 0 || conditionMask == enableMask)
+			{
+				coherentBranches += Long(Int(1));
+			}
+			Else
+			{
+				divergentBranches += Long(Int(1));
+			}
+		}
+
+		if(uniform)   // All enabled pixels take the same path, so don't mask the body
+		{
+			BasicBlock *trueBlock = Nucleus::createBasicBlock();
+			BasicBlock *falseBlock = Nucleus::createBasicBlock();
+
+			branch(SignMask(condition) != 0, trueBlock, falseBlock);
+
+			isConditionalIf[ifDepth] = false;
+			ifFalseBlock[ifDepth] = falseBlock;
+
+			ifDepth++;
+
+			return;
+		}
+
 		enableIndex++;
 		enableStack[enableIndex] = condition;
 
@@ -18,13 +18,15 @@
 #include "PixelRoutine.hpp"
 #include "SamplerCore.hpp"
 
+#include <map>
+
 namespace sw
 {
 	class PixelProgram : public PixelRoutine
 	{
 	public:
 		PixelProgram(const PixelProcessor::State &state, const PixelShader *shader) :
-			PixelRoutine(state, shader), r(shader->indirectAddressableTemporaries),
+			PixelRoutine(state, shader), r(shader->indexedTemporariesBegin, shader->indexedTemporariesEnd),
 			loopDepth(-1), ifDepth(0), loopRepDepth(0), currentLabel(-1), whileTest(false)
 		{
 			for(int i = 0; i < 2048; ++i)
@@ -89,6 +91,7 @@ namespace sw
 		void clampColor(Vector4f oC[RENDERTARGETS]);
 
 		Int4 enableMask(const Shader::Instruction *instruction);
+		static bool changesControlFlow(Shader::Opcode opcode);   // Switches the insertion block, not profiled
 
 		Vector4f fetchRegister(const Src &src, unsigned int offset = 0);
 		Vector4f readConstant(const Src &src, unsigned int offset = 0);
@@ -139,11 +142,11 @@ namespace sw
 		void ENDREP();
 		void ENDWHILE();
 		void ENDSWITCH();
-		void IF(const Src &src);
+		void IF(const Src &src, bool uniform);
 		void IFb(const Src &boolRegister);
 		void IFp(const Src &predicateRegister);
-		void IFC(Vector4f &src0, Vector4f &src1, Control);
-		void IF(Int4 &condition);
+		void IFC(Vector4f &src0, Vector4f &src1, Control, bool uniform);
+		void IF(Int4 &condition, bool uniform = false);
 		void LABEL(int labelIndex);
 		void LOOP(const Src &integerRegister);
 		void REP(const Src &integerRegister);
@@ -164,6 +167,9 @@ namespace sw
 		std::vector<BasicBlock*> callRetBlock[2048];
 		BasicBlock *returnBlock;
 		bool isConditionalIf[24 + 24];
+
+		int samplerSites[TEXTURE_IMAGE_UNITS];   // Sampling instructions using each sampler
+		std::map<int, SharedSampler*> sharedSampler;   // By sampler index and function
 	};
 }
 
@@ -50,9 +50,12 @@ namespace sw
 
 	void PixelRoutine::quad(Pointer<Byte> cBuffer[RENDERTARGETS], Pointer<Byte> &zBuffer, Pointer<Byte> &sBuffer, Int cMask[4], Int &x, Int &y)
 	{
-		#if PERF_PROFILE
-			Long pipeTime = Ticks();
-		#endif
+		Long pipeTime;
+
+		if(state.pipelineProfiled)
+		{
+			pipeTime = Ticks();
+		}
 
 		const bool earlyDepthTest = !state.depthOverride && !state.alphaTestActive();
 
@@ -71,7 +74,6 @@ namespace sw
 		}
 
 		Float4 f;
-		Float4 rhwCentroid;
 
 		Float4 xxxx = Float4(Float(x)) + *Pointer<Float4>(primitive + OFFSET(Primitive,xQuad), 16);
 
@@ -92,19 +94,35 @@ namespace sw
 
 		Bool depthPass = false;
 
-		if(earlyDepthTest)
+		if(earlyDepthTest)   // Depth, stencil and coverage reject the quad before any shading
 		{
 			for(unsigned int q = 0; q < state.multiSample; q++)
 			{
 				depthPass = depthPass || depthTest(zBuffer, q, x, z[q], sMask[q], zMask[q], cMask[q]);
 			}
+
+			if(state.pipelineProfiled)
+			{
+				If(!depthPass)
+				{
+					earlyDepthRejects += Long(Int(1));
+				}
+			}
 		}
 
 		If(depthPass || Bool(!earlyDepthTest))
 		{
-			#if PERF_PROFILE
-				Long interpTime = Ticks();
-			#endif
+			if(state.quadsCounted)
+			{
+				quadsShaded++;
+			}
+
+			Long interpTime;
+
+			if(state.pipelineProfiled)
+			{
+				interpTime = Ticks();
+			}
 
 			Float4 yyyy = Float4(Float(y)) + *Pointer<Float4>(primitive + OFFSET(Primitive,yQuad), 16);
 
@@ -131,82 +149,47 @@ namespace sw
 				YYYY += yyyy;
 			}
 
-			if(interpolateW())
+			if(state.perspective)
 			{
-				w = interpolate(xxxx, Dw, rhw, primitive + OFFSET(Primitive,w), false, false, false);
-				rhw = reciprocal(w, false, false, true);
-
-				if(state.centroid)
+				// Primitives with the same w at all vertices have linear plane equations
+				If(*Pointer<Int>(primitive + OFFSET(Primitive,affine)) != 0)
 				{
-					rhwCentroid = reciprocal(interpolateCentroid(XXXX, YYYY, rhwCentroid, primitive + OFFSET(Primitive,w), false, false));
-				}
-			}
-
-			for(int interpolant = 0; interpolant < MAX_FRAGMENT_INPUTS; interpolant++)
-			{
-				for(int component = 0; component < 4; component++)
-				{
-					if(state.interpolant[interpolant].component & (1 << component))
-					{
-						if(!state.interpolant[interpolant].centroid)
-						{
-							v[interpolant][component] = interpolate(xxxx, Dv[interpolant][component], rhw, primitive + OFFSET(Primitive, V[interpolant][component]), (state.interpolant[interpolant].flat & (1 << component)) != 0, state.perspective, false);
-						}
-						else
-						{
-							v[interpolant][component] = interpolateCentroid(XXXX, YYYY, rhwCentroid, primitive + OFFSET(Primitive, V[interpolant][component]), (state.interpolant[interpolant].flat & (1 << component)) != 0, state.perspective);
-						}
-					}
+					interpolateInputs(xxxx, XXXX, YYYY, f, false);
 				}
-
-				Float4 rcp;
-
-				switch(state.interpolant[interpolant].project)
+				Else
 				{
-				case 0:
-					break;
-				case 1:
-					rcp = reciprocal(v[interpolant].y);
-					v[interpolant].x = v[interpolant].x * rcp;
-					break;
-				case 2:
-					rcp = reciprocal(v[interpolant].z);
-					v[interpolant].x = v[interpolant].x * rcp;
-					v[interpolant].y = v[interpolant].y * rcp;
-					break;
-				case 3:
-					rcp = reciprocal(v[interpolant].w);
-					v[interpolant].x = v[interpolant].x * rcp;
-					v[interpolant].y = v[interpolant].y * rcp;
-					v[interpolant].z = v[interpolant].z * rcp;
-					break;
+					interpolateInputs(xxxx, XXXX, YYYY, f, true);
 				}
 			}
-
-			if(state.fog.component)
+			else
 			{
-				f = interpolate(xxxx, Df, rhw, primitive + OFFSET(Primitive,f), state.fog.flat & 0x01, state.perspective, false);
+				interpolateInputs(xxxx, XXXX, YYYY, f, false);
 			}
 
 			setBuiltins(x, y, z, w);
 
-			#if PERF_PROFILE
+			if(state.pipelineProfiled)
+			{
 				cycles[PERF_INTERP] += Ticks() - interpTime;
-			#endif
+			}
 
 			Bool alphaPass = true;
 
 			if(colorUsed())
 			{
-				#if PERF_PROFILE
-					Long shaderTime = Ticks();
-				#endif
+				Long shaderTime;
+
+				if(state.pipelineProfiled)
+				{
+					shaderTime = Ticks();
+				}
 
 				applyShader(cMask);
 
-				#if PERF_PROFILE
+				if(state.pipelineProfiled)
+				{
 					cycles[PERF_SHADER] += Ticks() - shaderTime;
-				#endif
+				}
 
 				alphaPass = alphaTest(cMask);
 
@@ -230,12 +213,30 @@ namespace sw
 					}
 				}
 
-				#if PERF_PROFILE
-					Long ropTime = Ticks();
-				#endif
+				Long ropTime;
+
+				if(state.pipelineProfiled)
+				{
+					ropTime = Ticks();
+				}
 
 				If(depthPass || Bool(earlyDepthTest))
 				{
+					if(state.quadsCounted)
+					{
+						Int writeMask = 0;
+
+						for(unsigned int q = 0; q < state.multiSample; q++)
+						{
+							writeMask |= zMask[q] & sMask[q];
+						}
+
+						If(writeMask != 0)   // Not killed by discard, alpha testing or late depth testing
+						{
+							quadsWritten++;
+						}
+					}
+
 					for(unsigned int q = 0; q < state.multiSample; q++)
 					{
 						if(state.multiSampleMask & (1 << q))
@@ -251,17 +252,24 @@ namespace sw
 
 					if(colorUsed())
 					{
-						#if PERF_PROFILE
-							AddAtomic(Pointer<Long>(&profiler.ropOperations), 4);
-						#endif
+						if(state.pipelineProfiled)
+						{
+							ropOperations += Long(Int(4));
+						}
+
+						if(state.colorSampleTiles)
+						{
+							markSampleTiles(x, y, sMask, zMask, cMask);
+						}
 
 						rasterOperation(f, cBuffer, x, sMask, zMask, cMask);
 					}
 				}
 
-				#if PERF_PROFILE
+				if(state.pipelineProfiled)
+				{
 					cycles[PERF_ROP] += Ticks() - ropTime;
-				#endif
+				}
 			}
 		}
 
@@ -273,9 +281,76 @@ namespace sw
 			}
 		}
 
-		#if PERF_PROFILE
+		if(state.pipelineProfiled)
+		{
 			cycles[PERF_PIPE] += Ticks() - pipeTime;
-		#endif
+		}
+	}
+
+	void PixelRoutine::interpolateInputs(Float4 &xxxx, Float4 &XXXX, Float4 &YYYY, Float4 &f, bool perspective)
+	{
+		Float4 rhwCentroid;
+
+		if(interpolateW())
+		{
+			w = interpolate(xxxx, Dw, rhw, primitive + OFFSET(Primitive,w), false, false, false);
+
+			if(perspective || state.wBasedFog)
+			{
+				rhw = reciprocal(w, false, false, true);
+			}
+
+			if(perspective && state.centroid)
+			{
+				rhwCentroid = reciprocal(interpolateCentroid(XXXX, YYYY, rhwCentroid, primitive + OFFSET(Primitive,w), false, false));
+			}
+		}
+
+		for(int interpolant = 0; interpolant < MAX_FRAGMENT_INPUTS; interpolant++)
+		{
+			for(int component = 0; component < 4; component++)
+			{
+				if(state.interpolant[interpolant].component & (1 << component))
+				{
+					if(!state.interpolant[interpolant].centroid)
+					{
+						v[interpolant][component] = interpolate(xxxx, Dv[interpolant][component], rhw, primitive + OFFSET(Primitive, V[interpolant][component]), (state.interpolant[interpolant].flat & (1 << component)) != 0, perspective, false);
+					}
+					else
+					{
+						v[interpolant][component] = interpolateCentroid(XXXX, YYYY, rhwCentroid, primitive + OFFSET(Primitive, V[interpolant][component]), (state.interpolant[interpolant].flat & (1 << component)) != 0, perspective);
+					}
+				}
+			}
+
+			Float4 rcp;
+
+			switch(state.interpolant[interpolant].project)
+			{
+			case 0:
+				break;
+			case 1:
+				rcp = reciprocal(v[interpolant].y);
+				v[interpolant].x = v[interpolant].x * rcp;
+				break;
+			case 2:
+				rcp = reciprocal(v[interpolant].z);
+				v[interpolant].x = v[interpolant].x * rcp;
+				v[interpolant].y = v[interpolant].y * rcp;
+				break;
+			case 3:
+				rcp = reciprocal(v[interpolant].w);
+				v[interpolant].x = v[interpolant].x * rcp;
+				v[interpolant].y = v[interpolant].y * rcp;
+				v[interpolant].z = v[interpolant].z * rcp;
+				break;
+			}
+		}
+
+		if(state.fog.component)
+		{
+			f = interpolate(xxxx, Df, rhw, primitive + OFFSET(Primitive,f), state.fog.flat & 0x01, perspective, false);
+		}
 	}
 
 	Float4 PixelRoutine::interpolateCentroid(Float4 &x, Float4 &y, Float4 &rhw, Pointer<Byte> planeEquation, bool flat, bool perspective)
@@ -389,7 +464,7 @@ namespace sw
 	{
 		if(!state.depthTestActive)
 		{
-			return true;
+			return sMask != 0;   // Stencil and coverage
 		}
 
 		Float4 Z = z;
@@ -656,6 +731,46 @@ namespace sw
 		}
 	}
 
+	void PixelRoutine::markSampleTiles(Int &x, Int &y, Int sMask[4], Int zMask[4], Int cMask[4])
+	{
+		// Flags the tile when the samples of the quad don't all get written alike
+		Int xMask[4];
+		Int differ = 0;
+
+		for(unsigned int q = 0; q < state.multiSample; q++)
+		{
+			if(state.multiSampleMask & (1 << q))
+			{
+				xMask[q] = state.depthTestActive ? zMask[q] : cMask[q];
+
+				if(state.stencilActive)
+				{
+					xMask[q] &= sMask[q];
+				}
+			}
+			else
+			{
+				xMask[q] = 0;
+			}
+
+			differ |= xMask[q] ^ xMask[0];
+		}
+
+		If(differ != 0)
+		{
+			for(int index = 0; index < RENDERTARGETS; index++)
+			{
+				if(state.colorWriteActive(index) && (state.colorSampleTiles & (1 << index)))
+				{
+					Pointer<Byte> tiles = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,colorSampleTiles[index]));
+					Int tilesPitchB = *Pointer<Int>(data + OFFSET(DrawData,colorSampleTilesPitchB[index]));
+
+					*Pointer<Byte>(tiles + (y >> 1) * tilesPitchB + (x >> 4)) = Byte(1);
+				}
+			}
+		}
+	}
+
 	void PixelRoutine::writeDepth(Pointer<Byte> &zBuffer, int q, Int &x, Float4 &z, Int &zMask)
 	{
 		if(!state.depthWriteEnable)
@@ -896,8 +1011,8 @@ namespace sw
 			break;
 		case BLEND_INVSOURCEALPHA:
 			blendFactor.x = Short4(0xFFFFu) - current.w;
-			blendFactor.y = Short4(0xFFFFu) - current.w;
-			blendFactor.z = Short4(0xFFFFu) - current.w;
+			blendFactor.y = blendFactor.x;
+			blendFactor.z = blendFactor.x;
 			break;
 		case BLEND_DESTALPHA:
 			blendFactor.x = pixel.w;
@@ -906,8 +1021,8 @@ namespace sw
 			break;
 		case BLEND_INVDESTALPHA:
 			blendFactor.x = Short4(0xFFFFu) - pixel.w;
-			blendFactor.y = Short4(0xFFFFu) - pixel.w;
-			blendFactor.z = Short4(0xFFFFu) - pixel.w;
+			blendFactor.y = blendFactor.x;
+			blendFactor.z = blendFactor.x;
 			break;
 		case BLEND_SRCALPHASAT:
 			blendFactor.x = Short4(0xFFFFu) - pixel.w;
@@ -927,13 +1042,13 @@ namespace sw
 			break;
 		case BLEND_CONSTANTALPHA:
 			blendFactor.x = *Pointer<Short4>(data + OFFSET(DrawData,factor.blendConstant4W[3]));
-			blendFactor.y = *Pointer<Short4>(data + OFFSET(DrawData,factor.blendConstant4W[3]));
-			blendFactor.z = *Pointer<Short4>(data + OFFSET(DrawData,factor.blendConstant4W[3]));
+			blendFactor.y = blendFactor.x;
+			blendFactor.z = blendFactor.x;
 			break;
 		case BLEND_INVCONSTANTALPHA:
 			blendFactor.x = *Pointer<Short4>(data + OFFSET(DrawData,factor.invBlendConstant4W[3]));
-			blendFactor.y = *Pointer<Short4>(data + OFFSET(DrawData,factor.invBlendConstant4W[3]));
-			blendFactor.z = *Pointer<Short4>(data + OFFSET(DrawData,factor.invBlendConstant4W[3]));
+			blendFactor.y = blendFactor.x;
+			blendFactor.z = blendFactor.x;
 			break;
 		default:
 			ASSERT(false);
@@ -990,6 +1105,23 @@ namespace sw
 		}
 	}
 
+	bool PixelRoutine::sharesAlphaFactor(BlendFactor colorFactor, BlendFactor alphaFactor)
+	{
+		// Factors replicating an alpha value, which the color blend doesn't modify
+		switch(colorFactor)
+		{
+		case BLEND_SOURCEALPHA:
+		case BLEND_INVSOURCEALPHA:
+		case BLEND_DESTALPHA:
+		case BLEND_INVDESTALPHA:
+		case BLEND_CONSTANTALPHA:
+		case BLEND_INVCONSTANTALPHA:
+			return alphaFactor == colorFactor;
+		default:
+			return false;
+		}
+	}
+
 	bool PixelRoutine::isSRGB(int index) const
 	{
 		return Surface::isSRGBformat(state.targetFormat[index]);
@@ -1243,8 +1375,23 @@ namespace sw
 			ASSERT(false);
 		}
 
-		blendFactorAlpha(sourceFactor, current, pixel, state.sourceBlendFactorAlpha);
-		blendFactorAlpha(destFactor, current, pixel, state.destBlendFactorAlpha);
+		if(sharesAlphaFactor(state.sourceBlendFactor, state.sourceBlendFactorAlpha))
+		{
+			sourceFactor.w = sourceFactor.x;
+		}
+		else
+		{
+			blendFactorAlpha(sourceFactor, current, pixel, state.sourceBlendFactorAlpha);
+		}
+
+		if(sharesAlphaFactor(state.destBlendFactor, state.destBlendFactorAlpha))
+		{
+			destFactor.w = destFactor.x;
+		}
+		else
+		{
+			blendFactorAlpha(destFactor, current, pixel, state.destBlendFactorAlpha);
+		}
 
 		if(state.sourceBlendFactorAlpha != BLEND_ONE && state.sourceBlendFactorAlpha != BLEND_ZERO)
 		{
@@ -1654,40 +1801,50 @@ namespace sw
 		case FORMAT_X8R8G8B8:   // FIXME: Don't touch alpha?
 			{
 				Pointer<Byte> buffer = cBuffer + x * 4;
-				Short4 value = *Pointer<Short4>(buffer);
 
-				if((state.targetFormat[index] == FORMAT_A8R8G8B8 && bgraWriteMask != 0x0000000F) ||
-				   ((state.targetFormat[index] == FORMAT_X8R8G8B8 && bgraWriteMask != 0x00000007) &&
-					(state.targetFormat[index] == FORMAT_X8R8G8B8 && bgraWriteMask != 0x0000000F)))   // FIXME: Need for masking when XRGB && Fh?
+				bool masked = ((state.targetFormat[index] == FORMAT_A8R8G8B8 && bgraWriteMask != 0x0000000F) ||
+				               ((state.targetFormat[index] == FORMAT_X8R8G8B8 && bgraWriteMask != 0x00000007) &&
+				                (state.targetFormat[index] == FORMAT_X8R8G8B8 && bgraWriteMask != 0x0000000F)));   // FIXME: Need for masking when XRGB && Fh?
+
+				// Fully covered quads replace the destination without reading it
+				If(Bool(!masked) && xMask == 0xF)
 				{
-					Short4 masked = value;
-					c01 &= *Pointer<Short4>(constants + OFFSET(Constants,maskB4Q[bgraWriteMask][0]));
-					masked &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskB4Q[bgraWriteMask][0]));
-					c01 |= masked;
+					*Pointer<Short4>(buffer) = c01;
+					*Pointer<Short4>(buffer + *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index]))) = c23;
 				}
+				Else
+				{
+					Short4 value = *Pointer<Short4>(buffer);
 
-				c01 &= *Pointer<Short4>(constants + OFFSET(Constants,maskD01Q) + xMask * 8);
-				value &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskD01Q) + xMask * 8);
-				c01 |= value;
-				*Pointer<Short4>(buffer) = c01;
+					if(masked)
+					{
+						Short4 masked = value;
+						c01 &= *Pointer<Short4>(constants + OFFSET(Constants,maskB4Q[bgraWriteMask][0]));
+						masked &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskB4Q[bgraWriteMask][0]));
+						c01 |= masked;
+					}
 
-				buffer += *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index]));
-				value = *Pointer<Short4>(buffer);
+					c01 &= *Pointer<Short4>(constants + OFFSET(Constants,maskD01Q) + xMask * 8);
+					value &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskD01Q) + xMask * 8);
+					c01 |= value;
+					*Pointer<Short4>(buffer) = c01;
 
-				if((state.targetFormat[index] == FORMAT_A8R8G8B8 && bgraWriteMask != 0x0000000F) ||
-				   ((state.targetFormat[index] == FORMAT_X8R8G8B8 && bgraWriteMask != 0x00000007) &&
-					(state.targetFormat[index] == FORMAT_X8R8G8B8 && bgraWriteMask != 0x0000000F)))   // FIXME: Need for masking when XRGB && Fh?
-				{
-					Short4 masked = value;
-					c23 &= *Pointer<Short4>(constants + OFFSET(Constants,maskB4Q[bgraWriteMask][0]));
-					masked &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskB4Q[bgraWriteMask][0]));
-					c23 |= masked;
-				}
+					buffer += *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index]));
+					value = *Pointer<Short4>(buffer);
 
-				c23 &= *Pointer<Short4>(constants + OFFSET(Constants,maskD23Q) + xMask * 8);
-				value &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskD23Q) + xMask * 8);
-				c23 |= value;
-				*Pointer<Short4>(buffer) = c23;
+					if(masked)
+					{
+						Short4 masked = value;
+						c23 &= *Pointer<Short4>(constants + OFFSET(Constants,maskB4Q[bgraWriteMask][0]));
+						masked &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskB4Q[bgraWriteMask][0]));
+						c23 |= masked;
+					}
+
+					c23 &= *Pointer<Short4>(constants + OFFSET(Constants,maskD23Q) + xMask * 8);
+					value &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskD23Q) + xMask * 8);
+					c23 |= value;
+					*Pointer<Short4>(buffer) = c23;
+				}
 			}
 			break;
 		case FORMAT_A8B8G8R8:
@@ -1696,40 +1853,50 @@ namespace sw
 		case FORMAT_SRGB8_A8:
 			{
 				Pointer<Byte> buffer = cBuffer + x * 4;
-				Short4 value = *Pointer<Short4>(buffer);
 
 				bool masked = (((state.targetFormat[index] == FORMAT_A8B8G8R8 || state.targetFormat[index] == FORMAT_SRGB8_A8) && rgbaWriteMask != 0x0000000F) ||
 				              (((state.targetFormat[index] == FORMAT_X8B8G8R8 || state.targetFormat[index] == FORMAT_SRGB8_X8) && rgbaWriteMask != 0x00000007) &&
 				               ((state.targetFormat[index] == FORMAT_X8B8G8R8 || state.targetFormat[index] == FORMAT_SRGB8_X8) && rgbaWriteMask != 0x0000000F))); // FIXME: Need for masking when XBGR && Fh?
 
-				if(masked)
+				// Fully covered quads replace the destination without reading it
+				If(Bool(!masked) && xMask == 0xF)
 				{
-					Short4 masked = value;
-					c01 &= *Pointer<Short4>(constants + OFFSET(Constants,maskB4Q[rgbaWriteMask][0]));
-					masked &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskB4Q[rgbaWriteMask][0]));
-					c01 |= masked;
+					*Pointer<Short4>(buffer) = c01;
+					*Pointer<Short4>(buffer + *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index]))) = c23;
 				}
+				Else
+				{
+					Short4 value = *Pointer<Short4>(buffer);
 
-				c01 &= *Pointer<Short4>(constants + OFFSET(Constants,maskD01Q) + xMask * 8);
-				value &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskD01Q) + xMask * 8);
-				c01 |= value;
-				*Pointer<Short4>(buffer) = c01;
+					if(masked)
+					{
+						Short4 masked = value;
+						c01 &= *Pointer<Short4>(constants + OFFSET(Constants,maskB4Q[rgbaWriteMask][0]));
+						masked &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskB4Q[rgbaWriteMask][0]));
+						c01 |= masked;
+					}
 
-				buffer += *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index]));
-				value = *Pointer<Short4>(buffer);
+					c01 &= *Pointer<Short4>(constants + OFFSET(Constants,maskD01Q) + xMask * 8);
+					value &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskD01Q) + xMask * 8);
+					c01 |= value;
+					*Pointer<Short4>(buffer) = c01;
 
-				if(masked)
-				{
-					Short4 masked = value;
-					c23 &= *Pointer<Short4>(constants + OFFSET(Constants,maskB4Q[rgbaWriteMask][0]));
-					masked &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskB4Q[rgbaWriteMask][0]));
-					c23 |= masked;
-				}
+					buffer += *Pointer<Int>(data + OFFSET(DrawData,colorPitchB[index]));
+					value = *Pointer<Short4>(buffer);
 
-				c23 &= *Pointer<Short4>(constants + OFFSET(Constants,maskD23Q) + xMask * 8);
-				value &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskD23Q) + xMask * 8);
-				c23 |= value;
-				*Pointer<Short4>(buffer) = c23;
+					if(masked)
+					{
+						Short4 masked = value;
+						c23 &= *Pointer<Short4>(constants + OFFSET(Constants,maskB4Q[rgbaWriteMask][0]));
+						masked &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskB4Q[rgbaWriteMask][0]));
+						c23 |= masked;
+					}
+
+					c23 &= *Pointer<Short4>(constants + OFFSET(Constants,maskD23Q) + xMask * 8);
+					value &= *Pointer<Short4>(constants + OFFSET(Constants,invMaskD23Q) + xMask * 8);
+					c23 |= value;
+					*Pointer<Short4>(buffer) = c23;
+				}
 			}
 			break;
 		case FORMAT_G8R8:
@@ -1945,8 +2112,8 @@ namespace sw
 			break;
 		case BLEND_INVSOURCEALPHA:
 			blendFactor.x = Float4(1.0f) - oC.w;
-			blendFactor.y = Float4(1.0f) - oC.w;
-			blendFactor.z = Float4(1.0f) - oC.w;
+			blendFactor.y = blendFactor.x;
+			blendFactor.z = blendFactor.x;
 			break;
 		case BLEND_DESTALPHA:
 			blendFactor.x = pixel.w;
@@ -1955,8 +2122,8 @@ namespace sw
 			break;
 		case BLEND_INVDESTALPHA:
 			blendFactor.x = Float4(1.0f) - pixel.w;
-			blendFactor.y = Float4(1.0f) - pixel.w;
-			blendFactor.z = Float4(1.0f) - pixel.w;
+			blendFactor.y = blendFactor.x;
+			blendFactor.z = blendFactor.x;
 			break;
 		case BLEND_SRCALPHASAT:
 			blendFactor.x = Float4(1.0f) - pixel.w;
@@ -2173,8 +2340,23 @@ namespace sw
 			ASSERT(false);
 		}
 
-		blendFactorAlpha(sourceFactor, oC, pixel, state.sourceBlendFactorAlpha);
-		blendFactorAlpha(destFactor, oC, pixel, state.destBlendFactorAlpha);
+		if(sharesAlphaFactor(state.sourceBlendFactor, state.sourceBlendFactorAlpha))
+		{
+			sourceFactor.w = sourceFactor.x;
+		}
+		else
+		{
+			blendFactorAlpha(sourceFactor, oC, pixel, state.sourceBlendFactorAlpha);
+		}
+
+		if(sharesAlphaFactor(state.destBlendFactor, state.destBlendFactorAlpha))
+		{
+			destFactor.w = destFactor.x;
+		}
+		else
+		{
+			blendFactorAlpha(destFactor, oC, pixel, state.destBlendFactorAlpha);
+		}
 
 		if(state.sourceBlendFactorAlpha != BLEND_ONE && state.sourceBlendFactorAlpha != BLEND_ZERO)
 		{
@@ -53,6 +53,7 @@ namespace sw
 		void alphaToCoverage(Int cMask[4], Float4 &alpha);
 		void fogBlend(Vector4f &c0, Float4 &fog);
 		void pixelFog(Float4 &visibility);
+		void markSampleTiles(Int &x, Int &y, Int sMask[4], Int zMask[4], Int cMask[4]);
 
 		// Raster operations
 		void alphaBlend(int index, Pointer<Byte> &cBuffer, Vector4s &current, Int &x);
@@ -66,6 +67,7 @@ namespace sw
 		void linearToSRGB12_16(Vector4s &c);
 
 	private:
+		void interpolateInputs(Float4 &xxxx, Float4 &XXXX, Float4 &YYYY, Float4 &f, bool perspective);
 		Float4 interpolateCentroid(Float4 &x, Float4 &y, Float4 &rhw, Pointer<Byte> planeEquation, bool flat, bool perspective);
 		void stencilTest(Pointer<Byte> &sBuffer, int q, Int &x, Int &sMask, Int &cMask);
 		void stencilTest(Byte8 &value, StencilCompareMode stencilCompareMode, bool CCW);
@@ -79,6 +81,7 @@ namespace sw
 		void readPixel(int index, Pointer<Byte> &cBuffer, Int &x, Vector4s &pixel);
 		void blendFactor(Vector4f &blendFactor, const Vector4f &oC, const Vector4f &pixel, BlendFactor blendFactorActive);
 		void blendFactorAlpha(Vector4f &blendFactor, const Vector4f &oC, const Vector4f &pixel, BlendFactor blendFactorAlphaActive);
+		static bool sharesAlphaFactor(BlendFactor colorFactor, BlendFactor alphaFactor);   // The color factor already holds the alpha factor
 		void writeStencil(Pointer<Byte> &sBuffer, int q, Int &x, Int &sMask, Int &zMask, Int &cMask);
 		void writeDepth(Pointer<Byte> &zBuffer, int q, Int &x, Float4 &z, Int &zMask);
 
@@ -16,12 +16,16 @@
 
 #include "Common/Debug.hpp"
 
+#include <algorithm>
+#include <map>
+#include <set>
 #include <string.h>
 
 namespace sw
 {
 	PixelShader::PixelShader(const PixelShader *ps) : Shader()
 	{
+		shaderType = SHADER_PIXEL;
 		shaderModel = 0x0300;
 		vPosDeclared = false;
 		vFaceDeclared = false;
@@ -34,10 +38,16 @@ namespace sw
 				append(new sw::Shader::Instruction(*ps->getInstruction(i)));
 			}
 
+			for(const Instruction *inst : ps->prologue)
+			{
+				prologue.push_back(new Instruction(*inst));
+			}
+
 			memcpy(input, ps->input, sizeof(input));
 			vPosDeclared = ps->vPosDeclared;
 			vFaceDeclared = ps->vFaceDeclared;
 			usedSamplers = ps->usedSamplers;
+			optimization = ps->optimization;
 
 			optimize();
 			analyze();
@@ -60,6 +70,61 @@ namespace sw
 	{
 	}
 
+	void PixelShader::serialize(std::vector<unsigned int> &data) const
+	{
+		Shader::serialize(data);
+
+		for(int i = 0; i < MAX_FRAGMENT_INPUTS; i++)
+		{
+			for(int j = 0; j < 4; j++)
+			{
+				const Semantic &semantic = input[i][j];
+				data.push_back(semantic.pack());
+			}
+		}
+
+		data.push_back(vPosDeclared | vFaceDeclared << 1 | zOverride << 2 | kill << 3 | centroid << 4);
+	}
+
+	bool PixelShader::deserialize(const unsigned int *&data, const unsigned int *end)
+	{
+		if(!Shader::deserialize(data, end) || end - data < MAX_FRAGMENT_INPUTS * 4 + 1)
+		{
+			return false;
+		}
+
+		for(int i = 0; i < MAX_FRAGMENT_INPUTS; i++)
+		{
+			for(int j = 0; j < 4; j++)
+			{
+				input[i][j] = Semantic::unpack(*data++);
+			}
+		}
+
+		unsigned int flags = *data++;
+		vPosDeclared = (flags & 1) != 0;
+		vFaceDeclared = (flags & 2) != 0;
+		zOverride = (flags & 4) != 0;
+		kill = (flags & 8) != 0;
+		centroid = (flags & 16) != 0;
+
+		return true;
+	}
+
+	unsigned int PixelShader::registerCount(ParameterType type) const
+	{
+		switch(type)
+		{
+		case PARAMETER_INPUT:    return MAX_FRAGMENT_INPUTS;
+		case PARAMETER_TEXTURE:  return MAX_FRAGMENT_INPUTS - 2;   // Follow the two colors
+		case PARAMETER_MISCTYPE: return VFaceIndex + 1;
+		case PARAMETER_COLOROUT: return RENDERTARGETS;
+		case PARAMETER_DEPTHOUT: return 1;
+		case PARAMETER_SAMPLER:  return TEXTURE_IMAGE_UNITS;
+		default:                 return Shader::registerCount(type);
+		}
+	}
+
 	int PixelShader::validate(const unsigned long *const token)
 	{
 		if(!token)
@@ -138,11 +203,11 @@ namespace sw
 		return input[2 + coordinate][component].active();
 	}
 
-	void PixelShader::setInput(int inputIdx, int nbComponents, const sw::Shader::Semantic& semantic)
+	void PixelShader::setInput(int inputIdx, int nbComponents, const sw::Shader::Semantic& semantic, unsigned int mask)
 	{
 		for(int i = 0; i < nbComponents; ++i)
 		{
-			input[inputIdx][i] = semantic;
+			input[inputIdx][i] = (mask & (1 << i)) ? semantic : sw::Shader::Semantic();
 		}
 	}
 
@@ -151,16 +216,70 @@ namespace sw
 		return input[inputIdx][component];
 	}
 
+	unsigned int PixelShader::getInputReadMask(int inputIdx) const
+	{
+		// Shader model 1.x and 2.x instructions access texture coordinates implicitly
+		if(shaderModel < 0x0300 || indirectAddressableInput)
+		{
+			return 0xF;
+		}
+
+		unsigned int mask = 0;
+
+		for(const auto &inst : instruction)
+		{
+			for(int i = 0; i < 5; i++)
+			{
+				const SourceParameter &src = inst->src[i];
+
+				if(src.type != PARAMETER_INPUT)
+				{
+					continue;
+				}
+
+				if(src.rel.type != PARAMETER_VOID)
+				{
+					return 0xF;
+				}
+
+				// Matrix operands span the consecutive registers following the indexed one
+				int rows = 1;
+
+				if(i == 1)
+				{
+					switch(inst->opcode)
+					{
+					case OPCODE_M3X2: rows = 2; break;
+					case OPCODE_M3X3: rows = 3; break;
+					case OPCODE_M3X4: rows = 4; break;
+					case OPCODE_M4X3: rows = 3; break;
+					case OPCODE_M4X4: rows = 4; break;
+					default: break;
+					}
+				}
+
+				if(inputIdx >= (int)src.index && inputIdx < (int)src.index + rows)
+				{
+					mask |= (rows > 1) ? 0xF : readComponents(inst, src);
+				}
+			}
+		}
+
+		return mask;
+	}
+
 	void PixelShader::analyze()
 	{
 		analyzeZOverride();
 		analyzeKill();
 		analyzeInterpolants();
 		analyzeDirtyConstants();
+		analyzeCoherentBranches();
 		analyzeDynamicBranching();
 		analyzeSamplers();
 		analyzeCallSites();
 		analyzeIndirectAddressing();
+		analyzeSpecializableConstants();
 	}
 
 	void PixelShader::analyzeZOverride()
@@ -743,4 +862,298 @@ namespace sw
 			}
 		}
 	}
+	void PixelShader::analyzeCoherentBranches()
+	{
+		// Determine which if statements have a condition that depends only on constants, literals and flat
+		// interpolants, or temporaries computed from those outside of any divergent control flow.
+		// They can branch for the whole quad at once instead of masking execution.
+		unsigned int temporaries = 0;
+
+		for(const auto &inst : instruction)
+		{
+			if(inst->dst.type == PARAMETER_TEMP)
+			{
+				temporaries = std::max(temporaries, inst->dst.index + 1);
+			}
+		}
+
+		// Temporaries written by each function, including the functions it calls
+		std::map<unsigned int, std::vector<unsigned char>> written;
+		std::map<unsigned int, std::set<unsigned int>> callees;
+		bool function = false;
+		unsigned int label = 0;
+
+		for(const auto &inst : instruction)
+		{
+			if(inst->opcode == OPCODE_LABEL)
+			{
+				function = true;
+				label = inst->dst.label;
+				written[label].assign(temporaries, 0);
+			}
+			else if(!function)
+			{
+				continue;
+			}
+			else if(inst->isCall())
+			{
+				callees[label].insert(inst->dst.label);
+			}
+			else if(inst->dst.type == PARAMETER_TEMP)
+			{
+				if(inst->dst.rel.type != PARAMETER_VOID)
+				{
+					written[label].assign(temporaries, 0xF);
+				}
+				else
+				{
+					written[label][inst->dst.index] |= inst->dst.mask;
+				}
+			}
+		}
+
+		for(bool grown = true; grown;)   // Shaders can't recurse, so this terminates
+		{
+			grown = false;
+
+			for(const auto &caller : callees)
+			{
+				for(unsigned int callee : caller.second)
+				{
+					auto calleeWritten = written.find(callee);
+
+					for(unsigned int t = 0; t < temporaries && calleeWritten != written.end(); t++)
+					{
+						unsigned char &mask = written[caller.first][t];
+
+						if((mask | calleeWritten->second[t]) != mask)
+						{
+							mask |= calleeWritten->second[t];
+							grown = true;
+						}
+					}
+				}
+			}
+		}
+
+		struct Scope
+		{
+			bool divergent;   // Masks execution
+			bool isIf;
+			bool inElse;
+			std::vector<unsigned char> before;   // Uniform temporaries on entry
+			std::vector<unsigned char> taken;    // Uniform temporaries at the end of the true block
+		};
+
+		std::set<unsigned int> uniformEntry;   // Functions only called with all pixels of the quad enabled
+		bool changed = true;
+
+		while(changed)
+		{
+			std::map<unsigned int, bool> uniformCalls;   // Whether all call sites of a function so far are unmasked
+			std::vector<unsigned char> uniformTemps(temporaries, 0);   // Per-component mask of quad-uniform values
+			std::vector<Scope> scope;
+			bool entered = true;
+			bool left = false;   // Some pixels returned early
+
+			for(unsigned int i = 0; i < instruction.size(); i++)
+			{
+				Instruction *inst = instruction[i];
+				bool masked = !entered || left;
+
+				for(const Scope &s : scope)
+				{
+					masked = masked || s.divergent;
+				}
+
+				switch(inst->opcode)
+				{
+				case OPCODE_LABEL:
+					entered = uniformEntry.find(inst->dst.label) != uniformEntry.end();
+					left = false;
+					scope.clear();
+					uniformTemps.assign(temporaries, 0);
+					break;
+				case OPCODE_IF:
+				case OPCODE_IFC:
+					inst->analysisUniform = isQuadUniform(inst->src[0], inst->src[0].swizzle & 0x3, uniformTemps) &&
+					                        (inst->opcode == OPCODE_IF || isQuadUniform(inst->src[1], inst->src[1].swizzle & 0x3, uniformTemps));
+					scope.push_back({!inst->analysisUniform, true, false, uniformTemps, {}});
+					break;
+				case OPCODE_ELSE:
+					if(!scope.empty() && scope.back().isIf)
+					{
+						// Pixels executing the else block didn't execute the true block
+						scope.back().inElse = true;
+						scope.back().taken = uniformTemps;
+						uniformTemps = scope.back().before;
+					}
+					break;
+				case OPCODE_ENDIF:
+					if(!scope.empty() && scope.back().isIf)
+					{
+						const std::vector<unsigned char> &other = scope.back().inElse ? scope.back().taken : scope.back().before;
+
+						for(unsigned int t = 0; t < temporaries; t++)
+						{
+							uniformTemps[t] &= other[t];
+						}
+
+						scope.pop_back();
+					}
+					break;
+				case OPCODE_LOOP:
+				case OPCODE_REP:
+				case OPCODE_WHILE:
+					// Values written in the body differ between iterations and pixels
+					for(unsigned int j = i + 1, depth = 1; j < instruction.size() && depth > 0; j++)
+					{
+						const Instruction *body = instruction[j];
+
+						if(body->isLoop())
+						{
+							depth++;
+						}
+						else if(body->isEndLoop())
+						{
+							depth--;
+						}
+						else if(body->isCall())
+						{
+							auto callee = written.find(body->dst.label);
+
+							for(unsigned int t = 0; t < temporaries; t++)
+							{
+								uniformTemps[t] &= (callee != written.end()) ? ~callee->second[t] : 0;
+							}
+						}
+						else if(body->dst.type == PARAMETER_TEMP && body->dst.rel.type != PARAMETER_VOID)
+						{
+							uniformTemps.assign(temporaries, 0);
+						}
+						else if(body->dst.type == PARAMETER_TEMP)
+						{
+							uniformTemps[body->dst.index] &= ~body->dst.mask;
+						}
+					}
+					scope.push_back({true, false, false, {}, {}});
+					break;
+				case OPCODE_SWITCH:
+					scope.push_back({true, false, false, {}, {}});
+					break;
+				case OPCODE_ENDLOOP:
+				case OPCODE_ENDREP:
+				case OPCODE_ENDWHILE:
+				case OPCODE_ENDSWITCH:
+					if(!scope.empty() && !scope.back().isIf)
+					{
+						scope.pop_back();
+					}
+					break;
+				case OPCODE_CALL:
+				case OPCODE_CALLNZ:
+					{
+						bool unmasked = inst->opcode == OPCODE_CALL && !masked;
+						auto call = uniformCalls.insert(std::make_pair(inst->dst.label, unmasked));
+						call.first->second = call.first->second && unmasked;
+
+						auto callee = written.find(inst->dst.label);
+
+						for(unsigned int t = 0; t < temporaries; t++)
+						{
+							uniformTemps[t] &= (callee != written.end()) ? ~callee->second[t] : 0;
+						}
+					}
+					break;
+				case OPCODE_LEAVE:
+					left = left || masked;
+					break;
+				default:
+					if(inst->dst.type != PARAMETER_TEMP)
+					{
+						break;
+					}
+					else if(inst->dst.rel.type != PARAMETER_VOID)
+					{
+						uniformTemps.assign(temporaries, 0);
+					}
+					else
+					{
+						bool componentwise = isComponentwise(inst->opcode);
+						bool pure = !masked && !inst->predicate && (componentwise || isSideEffectFree(inst->opcode));
+						unsigned char uniform = 0;
+
+						switch(inst->opcode)
+						{
+						case OPCODE_M4X4:
+						case OPCODE_M4X3:
+						case OPCODE_M3X4:
+						case OPCODE_M3X3:
+						case OPCODE_M3X2:
+							pure = false;   // Read consecutive registers
+							break;
+						default:
+							break;
+						}
+
+						for(int c = 0; c < 4 && pure; c++)
+						{
+							bool u = (inst->dst.mask & (1 << c)) != 0;
+
+							for(int j = 0; j < 5 && u; j++)
+							{
+								const SourceParameter &src = inst->src[j];
+
+								if(src.type == PARAMETER_VOID)
+								{
+									continue;
+								}
+
+								for(int k = componentwise ? c : 0; k < (componentwise ? c + 1 : 4) && u; k++)
+								{
+									u = isQuadUniform(src, (src.swizzle >> (2 * k)) & 0x3, uniformTemps);
+								}
+							}
+
+							uniform |= u ? (1 << c) : 0;
+						}
+
+						uniformTemps[inst->dst.index] = (uniformTemps[inst->dst.index] & ~inst->dst.mask) | uniform;
+					}
+					break;
+				}
+			}
+
+			changed = false;
+
+			for(const auto &call : uniformCalls)
+			{
+				if(call.second && uniformEntry.insert(call.first).second)
+				{
+					changed = true;
+				}
+			}
+		}
+	}
+
+	bool PixelShader::isQuadUniform(const SourceParameter &src, int component, const std::vector<unsigned char> &uniformTemps) const
+	{
+		switch(src.type)
+		{
+		case PARAMETER_FLOAT4LITERAL:
+		case PARAMETER_BOOL1LITERAL:
+		case PARAMETER_INT4LITERAL:
+			return true;
+		case PARAMETER_CONST:
+		case PARAMETER_CONSTINT:
+		case PARAMETER_CONSTBOOL:
+			return src.rel.type == PARAMETER_VOID;
+		case PARAMETER_INPUT:
+			return src.rel.type == PARAMETER_VOID && src.index < MAX_FRAGMENT_INPUTS && input[src.index][component].flat;
+		case PARAMETER_TEMP:
+			return src.rel.type == PARAMETER_VOID && src.index < uniformTemps.size() && (uniformTemps[src.index] & (1 << component)) != 0;
+		default:
+			return false;
+		}
+	}
 }
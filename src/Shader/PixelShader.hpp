@@ -29,6 +29,8 @@ namespace sw
 		virtual ~PixelShader();
 
 		static int validate(const unsigned long *const token);   // Returns number of instructions if valid
+		void serialize(std::vector<unsigned int> &data) const override;
+		bool deserialize(const unsigned int *&data, const unsigned int *end) override;
 		bool depthOverride() const;
 		bool containsKill() const;
 		bool containsCentroid() const;
@@ -36,8 +38,9 @@ namespace sw
 		bool usesSpecular(int component) const;
 		bool usesTexture(int coordinate, int component) const;
 
-		void setInput(int inputIdx, int nbComponents, const Semantic& semantic);
+		void setInput(int inputIdx, int nbComponents, const Semantic& semantic, unsigned int mask = 0xF);   // Other components get no semantic
 		const Semantic& getInput(int inputIdx, int component) const;
+		unsigned int getInputReadMask(int inputIdx) const;   // Components read by the shader, all of them for dynamically indexed inputs
 
 		void declareVPos() { vPosDeclared = true; }
 		void declareVFace() { vFaceDeclared = true; }
@@ -45,10 +48,14 @@ namespace sw
 		bool isVFaceDeclared() const { return vFaceDeclared; }
 
 	private:
+		unsigned int registerCount(ParameterType type) const override;
+
 		void analyze();
 		void analyzeZOverride();
 		void analyzeKill();
 		void analyzeInterpolants();
+		void analyzeCoherentBranches();
+		bool isQuadUniform(const SourceParameter &src, int component, const std::vector<unsigned char> &uniformTemps) const;
 
 		Semantic input[MAX_FRAGMENT_INPUTS][4];
 
@@ -65,15 +65,6 @@ namespace sw
 	{
 		Vector4s c;
 
-		#if PERF_PROFILE
-			AddAtomic(Pointer<Long>(&profiler.texOperations), 4);
-
-			if(state.compressedFormat)
-			{
-				AddAtomic(Pointer<Long>(&profiler.compressedTex), 4);
-			}
-		#endif
-
 		if(state.textureType == TEXTURE_NULL)
 		{
 			c.x = Short4(0x0000);
@@ -102,33 +93,51 @@ namespace sw
 			Float4 uDelta;
 			Float4 vDelta;
 
-			if(state.textureType != TEXTURE_3D)
+			if(isUnfilteredTexture2D(function))
 			{
-				if(state.textureType != TEXTURE_CUBE)
+				lod = Float(0.0f);   // Unused
+
+				if(!hasFloatTexture())
 				{
-					computeLod(texture, lod, anisotropy, uDelta, vDelta, uuuu, vvvv, bias.x, dsx, dsy, function);
+					c = sampleQuad2D(texture, uuuu, vvvv, wwww, offset, lod, face, false, function);
 				}
 				else
 				{
-					Float4 M;
-					cubeFace(face, uuuu, vvvv, u, v, w, M);
-					computeLodCube(texture, lod, u, v, w, bias.x, dsx, dsy, M, function);
+					Vector4f cf = sampleFloat2D(texture, uuuu, vvvv, wwww, qqqq, offset, lod, face, false, function);
+
+					convertFixed12(c, cf);
 				}
 			}
 			else
 			{
-				computeLod3D(texture, lod, uuuu, vvvv, wwww, bias.x, dsx, dsy, function);
-			}
+				if(state.textureType != TEXTURE_3D)
+				{
+					if(state.textureType != TEXTURE_CUBE)
+					{
+						computeLod(texture, lod, anisotropy, uDelta, vDelta, uuuu, vvvv, bias.x, dsx, dsy, function);
+					}
+					else
+					{
+						Float4 M;
+						cubeFace(face, uuuu, vvvv, u, v, w, M);
+						computeLodCube(texture, lod, u, v, w, bias.x, dsx, dsy, M, function);
+					}
+				}
+				else
+				{
+					computeLod3D(texture, lod, uuuu, vvvv, wwww, bias.x, dsx, dsy, function);
+				}
 
-			if(!hasFloatTexture())
-			{
-				c = sampleFilter(texture, uuuu, vvvv, wwww, offset, lod, anisotropy, uDelta, vDelta, face, function);
-			}
-			else
-			{
-				Vector4f cf = sampleFloatFilter(texture, uuuu, vvvv, wwww, qqqq, offset, lod, anisotropy, uDelta, vDelta, face, function);
+				if(!hasFloatTexture())
+				{
+					c = sampleFilter(texture, uuuu, vvvv, wwww, offset, lod, anisotropy, uDelta, vDelta, face, function);
+				}
+				else
+				{
+					Vector4f cf = sampleFloatFilter(texture, uuuu, vvvv, wwww, qqqq, offset, lod, anisotropy, uDelta, vDelta, face, function);
 
-				convertFixed12(c, cf);
+					convertFixed12(c, cf);
+				}
 			}
 
 			if(fixed12)
@@ -278,15 +287,6 @@ namespace sw
 	{
 		Vector4f c;
 
-		#if PERF_PROFILE
-			AddAtomic(Pointer<Long>(&profiler.texOperations), 4);
-
-			if(state.compressedFormat)
-			{
-				AddAtomic(Pointer<Long>(&profiler.compressedTex), 4);
-			}
-		#endif
-
 		if(state.textureType == TEXTURE_NULL)
 		{
 			c.x = Float4(0.0f);
@@ -313,25 +313,34 @@ namespace sw
 				Float4 uDelta;
 				Float4 vDelta;
 
-				if(state.textureType != TEXTURE_3D)
+				if(isUnfilteredTexture2D(function))
 				{
-					if(state.textureType != TEXTURE_CUBE)
+					lod = Float(0.0f);   // Unused
+
+					c = sampleFloat2D(texture, uuuu, vvvv, wwww, qqqq, offset, lod, face, false, function);
+				}
+				else
+				{
+					if(state.textureType != TEXTURE_3D)
 					{
-						computeLod(texture, lod, anisotropy, uDelta, vDelta, uuuu, vvvv, bias.x, dsx, dsy, function);
+						if(state.textureType != TEXTURE_CUBE)
+						{
+							computeLod(texture, lod, anisotropy, uDelta, vDelta, uuuu, vvvv, bias.x, dsx, dsy, function);
+						}
+						else
+						{
+							Float4 M;
+							cubeFace(face, uuuu, vvvv, u, v, w, M);
+							computeLodCube(texture, lod, u, v, w, bias.x, dsx, dsy, M, function);
+						}
 					}
 					else
 					{
-						Float4 M;
-						cubeFace(face, uuuu, vvvv, u, v, w, M);
-						computeLodCube(texture, lod, u, v, w, bias.x, dsx, dsy, M, function);
+						computeLod3D(texture, lod, uuuu, vvvv, wwww, bias.x, dsx, dsy, function);
 					}
-				}
-				else
-				{
-					computeLod3D(texture, lod, uuuu, vvvv, wwww, bias.x, dsx, dsy, function);
-				}
 
-				c = sampleFloatFilter(texture, uuuu, vvvv, wwww, qqqq, offset, lod, anisotropy, uDelta, vDelta, face, function);
+					c = sampleFloatFilter(texture, uuuu, vvvv, wwww, qqqq, offset, lod, anisotropy, uDelta, vDelta, face, function);
+				}
 
 				if(!hasFloatTexture() && !hasUnnormalizedIntegerTexture())
 				{
@@ -756,11 +765,17 @@ namespace sw
 
 		Short4 uuuu = texelFetch ? Short4(As<Int4>(u)) : address(u, state.addressingModeU, mipmap);
 		Short4 vvvv = texelFetch ? Short4(As<Int4>(v)) : address(v, state.addressingModeV, mipmap);
-		Short4 wwww = texelFetch ? Short4(As<Int4>(w)) : address(w, state.addressingModeW, mipmap);
+		UInt4 slice;
+
+		if(hasThirdCoordinate())   // The array layer is the same for all texels
+		{
+			Short4 wwww = texelFetch ? Short4(As<Int4>(w)) : address(w, state.addressingModeW, mipmap);
+			slice = sliceIndex(wwww, offset, mipmap, function);
+		}
 
 		if(state.textureFilter == FILTER_POINT || texelFetch)
 		{
-			c = sampleTexel(uuuu, vvvv, wwww, offset, mipmap, buffer, function);
+			c = sampleTexel(uuuu, vvvv, slice, offset, mipmap, buffer, function);
 		}
 		else
 		{
@@ -769,10 +784,10 @@ namespace sw
 			Short4 uuuu1 = offsetSample(uuuu, mipmap, OFFSET(Mipmap,uHalf), state.addressingModeU == ADDRESSING_WRAP, gather ? 2 : +1, lod);
 			Short4 vvvv1 = offsetSample(vvvv, mipmap, OFFSET(Mipmap,vHalf), state.addressingModeV == ADDRESSING_WRAP, gather ? 2 : +1, lod);
 
-			Vector4s c0 = sampleTexel(uuuu0, vvvv0, wwww, offset, mipmap, buffer, function);
-			Vector4s c1 = sampleTexel(uuuu1, vvvv0, wwww, offset, mipmap, buffer, function);
-			Vector4s c2 = sampleTexel(uuuu0, vvvv1, wwww, offset, mipmap, buffer, function);
-			Vector4s c3 = sampleTexel(uuuu1, vvvv1, wwww, offset, mipmap, buffer, function);
+			Vector4s c0 = sampleTexel(uuuu0, vvvv0, slice, offset, mipmap, buffer, function);
+			Vector4s c1 = sampleTexel(uuuu1, vvvv0, slice, offset, mipmap, buffer, function);
+			Vector4s c2 = sampleTexel(uuuu0, vvvv1, slice, offset, mipmap, buffer, function);
+			Vector4s c3 = sampleTexel(uuuu1, vvvv1, slice, offset, mipmap, buffer, function);
 
 			if(!gather)   // Blend
 			{
@@ -955,33 +970,31 @@ namespace sw
 
 		if(state.textureFilter == FILTER_POINT || texelFetch)
 		{
-			c_ = sampleTexel(uuuu, vvvv, wwww, offset, mipmap, buffer, function);
+			UInt4 slice = sliceIndex(wwww, offset, mipmap, function);
+			c_ = sampleTexel(uuuu, vvvv, slice, offset, mipmap, buffer, function);
 		}
 		else
 		{
 			Vector4s c[2][2][2];
 
-			Short4 u[2][2][2];
-			Short4 v[2][2][2];
-			Short4 s[2][2][2];
+			// Each axis has two coordinates, and each slice is only indexed once for all the texels in it
+			Short4 u[2];
+			Short4 v[2];
+			Short4 s[2];
+			UInt4 slice[2];
 
 			for(int i = 0; i < 2; i++)
 			{
-				for(int j = 0; j < 2; j++)
-				{
-					for(int k = 0; k < 2; k++)
-					{
-						u[i][j][k] = offsetSample(uuuu, mipmap, OFFSET(Mipmap,uHalf), state.addressingModeU == ADDRESSING_WRAP, i * 2 - 1, lod);
-						v[i][j][k] = offsetSample(vvvv, mipmap, OFFSET(Mipmap,vHalf), state.addressingModeV == ADDRESSING_WRAP, j * 2 - 1, lod);
-						s[i][j][k] = offsetSample(wwww, mipmap, OFFSET(Mipmap,wHalf), state.addressingModeW == ADDRESSING_WRAP, k * 2 - 1, lod);
-					}
-				}
+				u[i] = offsetSample(uuuu, mipmap, OFFSET(Mipmap,uHalf), state.addressingModeU == ADDRESSING_WRAP, i * 2 - 1, lod);
+				v[i] = offsetSample(vvvv, mipmap, OFFSET(Mipmap,vHalf), state.addressingModeV == ADDRESSING_WRAP, i * 2 - 1, lod);
+				s[i] = offsetSample(wwww, mipmap, OFFSET(Mipmap,wHalf), state.addressingModeW == ADDRESSING_WRAP, i * 2 - 1, lod);
+				slice[i] = sliceIndex(s[i], offset, mipmap, function);
 			}
 
 			// Fractions
-			UShort4 f0u = As<UShort4>(u[0][0][0]) * *Pointer<UShort4>(mipmap + OFFSET(Mipmap,width));
-			UShort4 f0v = As<UShort4>(v[0][0][0]) * *Pointer<UShort4>(mipmap + OFFSET(Mipmap,height));
-			UShort4 f0s = As<UShort4>(s[0][0][0]) * *Pointer<UShort4>(mipmap + OFFSET(Mipmap,depth));
+			UShort4 f0u = As<UShort4>(u[0]) * *Pointer<UShort4>(mipmap + OFFSET(Mipmap,width));
+			UShort4 f0v = As<UShort4>(v[0]) * *Pointer<UShort4>(mipmap + OFFSET(Mipmap,height));
+			UShort4 f0s = As<UShort4>(s[0]) * *Pointer<UShort4>(mipmap + OFFSET(Mipmap,depth));
 
 			UShort4 f1u = ~f0u;
 			UShort4 f1v = ~f0v;
@@ -1027,7 +1040,7 @@ namespace sw
 				{
 					for(int k = 0; k < 2; k++)
 					{
-						c[i][j][k] = sampleTexel(u[i][j][k], v[i][j][k], s[i][j][k], offset, mipmap, buffer, function);
+						c[i][j][k] = sampleTexel(u[i], v[j], slice[k], offset, mipmap, buffer, function);
 
 						if(componentCount >= 1) { if(hasUnsignedTextureComponent(0)) c[i][j][k].x = MulHigh(As<UShort4>(c[i][j][k].x), f[1 - i][1 - j][1 - k]); else c[i][j][k].x = MulHigh(c[i][j][k].x, fs[1 - i][1 - j][1 - k]); }
 						if(componentCount >= 2) { if(hasUnsignedTextureComponent(1)) c[i][j][k].y = MulHigh(As<UShort4>(c[i][j][k].y), f[1 - i][1 - j][1 - k]); else c[i][j][k].y = MulHigh(c[i][j][k].y, fs[1 - i][1 - j][1 - k]); }
@@ -1230,7 +1243,8 @@ namespace sw
 		address(w, z0, z0, fv, mipmap, offset.z, filter, OFFSET(Mipmap, depth), state.addressingModeW, function);
 
 		Int4 pitchP = *Pointer<Int4>(mipmap + OFFSET(Mipmap, pitchP), 16);
-		y0 *= pitchP;
+		x0 = columnIndex(x0);
+		y0 = rowIndex(y0, pitchP);
 		if(hasThirdCoordinate())
 		{
 			Int4 sliceP = *Pointer<Int4>(mipmap + OFFSET(Mipmap, sliceP), 16);
@@ -1243,7 +1257,8 @@ namespace sw
 		}
 		else
 		{
-			y1 *= pitchP;
+			x1 = columnIndex(x1);
+			y1 = rowIndex(y1, pitchP);
 
 			Vector4f c0 = sampleTexel(x0, y0, z0, q, mipmap, buffer, function);
 			Vector4f c1 = sampleTexel(x1, y0, z0, q, mipmap, buffer, function);
@@ -1424,6 +1439,11 @@ namespace sw
 				anisotropy = lod * Rcp_pp(det);
 				anisotropy = Min(anisotropy, *Pointer<Float>(texture + OFFSET(Texture,maxAnisotropy)));
 
+				if(state.approximateAnisotropy)
+				{
+					anisotropy = Max(anisotropy * Float(0.5f), Float(1.0f));
+				}
+
 				lod *= Rcp_pp(anisotropy * anisotropy);
 			}
 
@@ -1637,7 +1657,7 @@ namespace sw
 		switch(mode)
 		{
 		case AddressingMode::ADDRESSING_WRAP:
-			tmp = (tmp + whd * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % whd;
+			tmp = wrapOffsetCoordinate(tmp, whd);
 			break;
 		case AddressingMode::ADDRESSING_CLAMP:
 		case AddressingMode::ADDRESSING_MIRROR:
@@ -1656,7 +1676,18 @@ namespace sw
 		return As<Short4>(UShort4(tmp));
 	}
 
-	void SamplerCore::computeIndices(UInt index[4], Short4 uuuu, Short4 vvvv, Short4 wwww, Vector4f &offset, const Pointer<Byte> &mipmap, SamplerFunction function)
+	Int4 SamplerCore::wrapOffsetCoordinate(const Int4 &xyz, const Int4 &dim)
+	{
+		// Texel offsets move coordinates less than MIN_PROGRAM_TEXEL_OFFSET times the dimension outside of it.
+		// Vector integer division gets scalarized, while the quotient of these small multiples is exact in
+		// single precision, which makes wrapping PCF taps at neighbouring offsets much cheaper.
+		Int4 positive = xyz + dim * Int4(-MIN_PROGRAM_TEXEL_OFFSET);
+		Int4 quotient = Int4(Float4(positive) / Float4(dim));
+
+		return positive - quotient * dim;
+	}
+
+	void SamplerCore::computeIndices(UInt index[4], Short4 uuuu, Short4 vvvv, UInt4 &slice, Vector4f &offset, const Pointer<Byte> &mipmap, SamplerFunction function)
 	{
 		bool texelFetch = (function == Fetch);
 		bool hasOffset = (function.option == Offset);
@@ -1675,6 +1706,14 @@ namespace sw
 			vvvv = applyOffset(vvvv, offset.y, Int4(h), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeV);
 		}
 
+		if(state.tiledTexture)   // See Surface::getTiledBuffer()
+		{
+			UShort4 x = As<UShort4>(uuuu);
+			UShort4 y = As<UShort4>(vvvv);
+			uuuu = As<Short4>(((x & UShort4(0xFFFCu)) << 2) | ((y & UShort4(0x0003u)) << 2) | (x & UShort4(0x0003u)));
+			vvvv = As<Short4>(y >> 2);
+		}
+
 		Short4 uuu2 = uuuu;
 		uuuu = As<Short4>(UnpackLow(uuuu, vvvv));
 		uuu2 = As<Short4>(UnpackHigh(uuu2, vvvv));
@@ -1683,22 +1722,8 @@ namespace sw
 
 		if(hasThirdCoordinate())
 		{
-			if(state.textureType != TEXTURE_2D_ARRAY)
-			{
-				if(!texelFetch)
-				{
-					wwww = MulHigh(As<UShort4>(wwww), *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth)));
-				}
-
-				if(hasOffset)
-				{
-					UShort4 d = *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth));
-					wwww = applyOffset(wwww, offset.z, Int4(d), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeW);
-				}
-			}
-
 			UInt4 uv(As<UInt2>(uuuu), As<UInt2>(uuu2));
-			uv += As<UInt4>(Int4(As<UShort4>(wwww))) * *Pointer<UInt4>(mipmap + OFFSET(Mipmap, sliceP));
+			uv += slice;
 
 			index[0] = Extract(As<Int4>(uv), 0);
 			index[1] = Extract(As<Int4>(uv), 1);
@@ -1730,7 +1755,7 @@ namespace sw
 		}
 	}
 
-	void SamplerCore::computeIndices(UInt index[4], Int4& uuuu, Int4& vvvv, Int4& wwww, const Pointer<Byte> &mipmap, SamplerFunction function)
+	UInt4 SamplerCore::computeIndices(UInt index[4], Int4& uuuu, Int4& vvvv, Int4& wwww, const Pointer<Byte> &mipmap, SamplerFunction function)
 	{
 		UInt4 indices = uuuu + vvvv;
 
@@ -1743,6 +1768,8 @@ namespace sw
 		{
 			index[i] = Extract(As<Int4>(indices), i);
 		}
+
+		return indices;
 	}
 
 	Vector4s SamplerCore::sampleTexel(UInt index[4], Pointer<Byte> buffer[4])
@@ -2006,12 +2033,12 @@ namespace sw
 		return c;
 	}
 
-	Vector4s SamplerCore::sampleTexel(Short4 &uuuu, Short4 &vvvv, Short4 &wwww, Vector4f &offset, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function)
+	Vector4s SamplerCore::sampleTexel(Short4 &uuuu, Short4 &vvvv, UInt4 &slice, Vector4f &offset, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function)
 	{
 		Vector4s c;
 
 		UInt index[4];
-		computeIndices(index, uuuu, vvvv, wwww, offset, mipmap, function);
+		computeIndices(index, uuuu, vvvv, slice, offset, mipmap, function);
 
 		if(hasYuvFormat())
 		{
@@ -2073,7 +2100,7 @@ namespace sw
 			c0 = c0 | (c1 << 8) | (c2 << 16) | (c3 << 24);
 			UShort4 Y = As<UShort4>(Unpack(As<Byte4>(c0)));
 
-			computeIndices(index, uuuu, vvvv, wwww, offset, mipmap + sizeof(Mipmap), function);
+			computeIndices(index, uuuu, vvvv, slice, offset, mipmap + sizeof(Mipmap), function);
 			c0 = Int(buffer[1][index[0]]);
 			c1 = Int(buffer[1][index[1]]);
 			c2 = Int(buffer[1][index[2]]);
@@ -2120,7 +2147,7 @@ namespace sw
 		Vector4f c;
 
 		UInt index[4];
-		computeIndices(index, uuuu, vvvv, wwww, mipmap, function);
+		UInt4 indices = computeIndices(index, uuuu, vvvv, wwww, mipmap, function);
 
 		if(hasFloatTexture() || has32bitIntegerTextureComponents())
 		{
@@ -2157,11 +2184,18 @@ namespace sw
 				c.y = Float4(c.y.yw, c.z.yw);
 				break;
 			case 1:
-				// FIXME: Optimal shuffling?
-				c.x.x = *Pointer<Float>(buffer[f0] + index[0] * 4);
-				c.x.y = *Pointer<Float>(buffer[f1] + index[1] * 4);
-				c.x.z = *Pointer<Float>(buffer[f2] + index[2] * 4);
-				c.x.w = *Pointer<Float>(buffer[f3] + index[3] * 4);
+				if(state.textureType != TEXTURE_CUBE)   // All lanes read the same face
+				{
+					c.x = Gather(Pointer<Float>(buffer[f0]), As<Int4>(indices) << 2);
+				}
+				else
+				{
+					// FIXME: Optimal shuffling?
+					c.x.x = *Pointer<Float>(buffer[f0] + index[0] * 4);
+					c.x.y = *Pointer<Float>(buffer[f1] + index[1] * 4);
+					c.x.z = *Pointer<Float>(buffer[f2] + index[2] * 4);
+					c.x.w = *Pointer<Float>(buffer[f3] + index[3] * 4);
+				}
 				break;
 			default:
 				ASSERT(false);
@@ -2276,6 +2310,29 @@ namespace sw
 		}
 	}
 
+	// Returns the texel index of the slice or array layer, which is shared by the texels of a sample's footprint in it,
+	// so that it gets computed once instead of for each texel
+	UInt4 SamplerCore::sliceIndex(Short4 wwww, Vector4f &offset, Pointer<Byte> &mipmap, SamplerFunction function)
+	{
+		bool texelFetch = (function == Fetch);
+
+		if(state.textureType == TEXTURE_3D)
+		{
+			if(!texelFetch)
+			{
+				wwww = MulHigh(As<UShort4>(wwww), *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth)));
+			}
+
+			if(function.option == Offset)
+			{
+				UShort4 d = *Pointer<UShort4>(mipmap + OFFSET(Mipmap, depth));
+				wwww = applyOffset(wwww, offset.z, Int4(d), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeW);
+			}
+		}
+
+		return As<UInt4>(Int4(As<UShort4>(wwww))) * *Pointer<UInt4>(mipmap + OFFSET(Mipmap, sliceP));
+	}
+
 	Int4 SamplerCore::computeFilterOffset(Float &lod)
 	{
 		Int4 filter = -1;
@@ -2296,6 +2353,26 @@ namespace sw
 		return filter;
 	}
 
+	Int4 SamplerCore::columnIndex(Int4 &x)
+	{
+		if(state.tiledTexture)   // See Surface::getTiledBuffer()
+		{
+			return ((x & Int4(~3)) << 2) | (x & Int4(3));
+		}
+
+		return x;
+	}
+
+	Int4 SamplerCore::rowIndex(Int4 &y, Int4 &pitchP)
+	{
+		if(state.tiledTexture)
+		{
+			return (y >> 2) * pitchP + ((y & Int4(3)) << 2);
+		}
+
+		return y * pitchP;
+	}
+
 	Short4 SamplerCore::address(Float4 &uw, AddressingMode addressingMode, Pointer<Byte> &mipmap)
 	{
 		if(addressingMode == ADDRESSING_LAYER && state.textureType != TEXTURE_2D_ARRAY)
@@ -2466,8 +2543,8 @@ namespace sw
 					xyz1 = Min(Max(xyz1, Int4(0)), maxXYZ);
 					break;
 				default:   // Wrap
-					xyz0 = (xyz0 + dim * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % dim;
-					xyz1 = (xyz1 + dim * Int4(-MIN_PROGRAM_TEXEL_OFFSET)) % dim;
+					xyz0 = wrapOffsetCoordinate(xyz0, dim);
+					xyz1 = wrapOffsetCoordinate(xyz1, dim);
 					break;
 				}
 			}
@@ -2570,6 +2647,15 @@ namespace sw
 		c = Insert(c, *Pointer<Short>(LUT + 2 * Int(Extract(c, 3))), 3);
 	}
 
+	bool SamplerCore::isUnfilteredTexture2D(SamplerFunction function) const
+	{
+		// Point sampling the base level doesn't depend on the level of detail, and clamping or wrapping never requires the border color
+		bool clampOrWrap = (state.addressingModeU == ADDRESSING_CLAMP || state.addressingModeU == ADDRESSING_WRAP) &&
+		                   (state.addressingModeV == ADDRESSING_CLAMP || state.addressingModeV == ADDRESSING_WRAP);
+
+		return state.textureType == TEXTURE_2D && state.textureFilter == FILTER_POINT && state.mipmapFilter == MIPMAP_NONE && clampOrWrap && function != Fetch;
+	}
+
 	bool SamplerCore::hasFloatTexture() const
 	{
 		return Surface::isFloatFormat(state.textureFormat);
@@ -3048,4 +3134,54 @@ namespace sw
 
 		return false;
 	}
+
+	SharedSampler::SharedSampler(Pointer<Byte> &constants, const Sampler::State &state, SamplerFunction function)
+		: constants(constants), state(state), function(function)
+	{
+		entry = Nucleus::createBasicBlock();
+	}
+
+	Vector4f SharedSampler::sampleTexture(Pointer<Byte> &texture, Vector4f &uvwq, Float4 &bias, Vector4f &dsx, Vector4f &dsy, Vector4f &offset)
+	{
+		this->texture = texture;
+		this->uvwq = uvwq;
+		this->bias = bias;
+		this->dsx = dsx;
+		this->dsy = dsy;
+		this->offset = offset;
+		site = Int((int)sites.size());
+
+		BasicBlock *returnBlock = Nucleus::createBasicBlock();
+		sites.push_back(returnBlock);
+
+		Nucleus::createBr(entry);
+		Nucleus::setInsertBlock(returnBlock);
+
+		return result;
+	}
+
+	void SharedSampler::emit()
+	{
+		Nucleus::setInsertBlock(entry);
+
+		result = SamplerCore(constants, state).sampleTexture(texture, uvwq.x, uvwq.y, uvwq.z, uvwq.w, bias, dsx, dsy, offset, function);
+
+		if(sites.size() == 1)
+		{
+			Nucleus::createBr(sites[0]);
+		}
+		else
+		{
+			BasicBlock *unreachableBlock = Nucleus::createBasicBlock();
+			SwitchCases *switchCases = Nucleus::createSwitch(site.loadValue(), unreachableBlock, (int)sites.size());
+
+			for(unsigned int i = 0; i < sites.size(); i++)
+			{
+				Nucleus::addSwitchCase(switchCases, i, sites[i]);
+			}
+
+			Nucleus::setInsertBlock(unreachableBlock);
+			Nucleus::createUnreachable();
+		}
+	}
 }
@@ -18,6 +18,8 @@
 #include "PixelRoutine.hpp"
 #include "Reactor/Reactor.hpp"
 
+#include <vector>
+
 namespace sw
 {
 	enum SamplerMethod
@@ -77,15 +79,19 @@ namespace sw
 		void computeLod3D(Pointer<Byte> &texture, Float &lod, Float4 &u, Float4 &v, Float4 &w, const Float &lodBias, Vector4f &dsx, Vector4f &dsy, SamplerFunction function);
 		void cubeFace(Int face[4], Float4 &U, Float4 &V, Float4 &x, Float4 &y, Float4 &z, Float4 &M);
 		Short4 applyOffset(Short4 &uvw, Float4 &offset, const Int4 &whd, AddressingMode mode);
-		void computeIndices(UInt index[4], Short4 uuuu, Short4 vvvv, Short4 wwww, Vector4f &offset, const Pointer<Byte> &mipmap, SamplerFunction function);
-		void computeIndices(UInt index[4], Int4& uuuu, Int4& vvvv, Int4& wwww, const Pointer<Byte> &mipmap, SamplerFunction function);
-		Vector4s sampleTexel(Short4 &u, Short4 &v, Short4 &s, Vector4f &offset, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function);
+		Int4 wrapOffsetCoordinate(const Int4 &xyz, const Int4 &dim);
+		void computeIndices(UInt index[4], Short4 uuuu, Short4 vvvv, UInt4 &slice, Vector4f &offset, const Pointer<Byte> &mipmap, SamplerFunction function);
+		UInt4 computeIndices(UInt index[4], Int4& uuuu, Int4& vvvv, Int4& wwww, const Pointer<Byte> &mipmap, SamplerFunction function);
+		Vector4s sampleTexel(Short4 &u, Short4 &v, UInt4 &slice, Vector4f &offset, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function);
 		Vector4s sampleTexel(UInt index[4], Pointer<Byte> buffer[4]);
 		Vector4f sampleTexel(Int4 &u, Int4 &v, Int4 &s, Float4 &z, Pointer<Byte> &mipmap, Pointer<Byte> buffer[4], SamplerFunction function);
 		void selectMipmap(Pointer<Byte> &texture, Pointer<Byte> buffer[4], Pointer<Byte> &mipmap, Float &lod, Int face[4], bool secondLOD);
+		UInt4 sliceIndex(Short4 wwww, Vector4f &offset, Pointer<Byte> &mipmap, SamplerFunction function);
 		Short4 address(Float4 &uw, AddressingMode addressingMode, Pointer<Byte>& mipmap);
 		void address(Float4 &uw, Int4& xyz0, Int4& xyz1, Float4& f, Pointer<Byte>& mipmap, Float4 &texOffset, Int4 &filter, int whd, AddressingMode addressingMode, SamplerFunction function);
 		Int4 computeFilterOffset(Float &lod);
+		Int4 columnIndex(Int4 &x);
+		Int4 rowIndex(Int4 &y, Int4 &pitchP);
 
 		void convertFixed12(Short4 &ci, Float4 &cf);
 		void convertFixed12(Vector4s &cs, Vector4f &cf);
@@ -96,6 +102,7 @@ namespace sw
 		void sRGBtoLinear16_6_16(Short4 &c);
 		void sRGBtoLinear16_5_16(Short4 &c);
 
+		bool isUnfilteredTexture2D(SamplerFunction function) const;
 		bool hasFloatTexture() const;
 		bool hasUnnormalizedIntegerTexture() const;
 		bool hasUnsignedTextureComponent(int component) const;
@@ -111,6 +118,34 @@ namespace sw
 		Pointer<Byte> &constants;
 		const Sampler::State &state;
 	};
+
+	// Sampling code emitted once per routine for a sampler and function, instead of inline at each site.
+	// Sites store their arguments and branch to it, and it returns to them through a switch on the site.
+	class SharedSampler
+	{
+	public:
+		SharedSampler(Pointer<Byte> &constants, const Sampler::State &state, SamplerFunction function);
+
+		Vector4f sampleTexture(Pointer<Byte> &texture, Vector4f &uvwq, Float4 &bias, Vector4f &dsx, Vector4f &dsy, Vector4f &offset);
+		void emit();   // After the last site, changes the insertion point
+
+	private:
+		Pointer<Byte> &constants;
+		const Sampler::State &state;
+		const SamplerFunction function;
+
+		Pointer<Byte> texture;
+		Vector4f uvwq;
+		Float4 bias;
+		Vector4f dsx;
+		Vector4f dsy;
+		Vector4f offset;
+		Vector4f result;
+		Int site;
+
+		BasicBlock *entry;
+		std::vector<BasicBlock*> sites;   // Return blocks
+	};
 }
 
 #endif   // sw_SamplerCore_hpp
@@ -49,12 +49,12 @@ namespace sw
 			const bool point = state.isDrawPoint;
 			const bool sprite = state.pointSprite;
 			const bool line = state.isDrawLine;
-			const bool triangle = state.isDrawSolidTriangle || sprite;
 			const bool solidTriangle = state.isDrawSolidTriangle;
 
+			// Point sprites only store their corners' projected positions in v1 and v2, their attributes are those of v0
 			const int V0 = OFFSET(Triangle,v0);
-			const int V1 = (triangle || line) ? OFFSET(Triangle,v1) : OFFSET(Triangle,v0);
-			const int V2 = triangle ? OFFSET(Triangle,v2) : (line ? OFFSET(Triangle,v1) : OFFSET(Triangle,v0));
+			const int V1 = (solidTriangle || line) ? OFFSET(Triangle,v1) : OFFSET(Triangle,v0);
+			const int V2 = solidTriangle ? OFFSET(Triangle,v2) : (line ? OFFSET(Triangle,v1) : OFFSET(Triangle,v0));
 
 			int pos = state.positionRegister;
 
@@ -65,13 +65,16 @@ namespace sw
 			Array<Int> X(16);
 			Array<Int> Y(16);
 
+			Pointer<Byte> p1 = tri + (sprite ? OFFSET(Triangle,v1) : V1);
+			Pointer<Byte> p2 = tri + (sprite ? OFFSET(Triangle,v2) : V2);
+
 			X[0] = *Pointer<Int>(v0 + OFFSET(Vertex,X));
-			X[1] = *Pointer<Int>(v1 + OFFSET(Vertex,X));
-			X[2] = *Pointer<Int>(v2 + OFFSET(Vertex,X));
+			X[1] = *Pointer<Int>(p1 + OFFSET(Vertex,X));
+			X[2] = *Pointer<Int>(p2 + OFFSET(Vertex,X));
 
 			Y[0] = *Pointer<Int>(v0 + OFFSET(Vertex,Y));
-			Y[1] = *Pointer<Int>(v1 + OFFSET(Vertex,Y));
-			Y[2] = *Pointer<Int>(v2 + OFFSET(Vertex,Y));
+			Y[1] = *Pointer<Int>(p1 + OFFSET(Vertex,Y));
+			Y[2] = *Pointer<Int>(p2 + OFFSET(Vertex,Y));
 
 			Int d = 1;     // Winding direction
 
@@ -93,9 +96,9 @@ namespace sw
 					Return(false);
 				}
 
-				Int w0w1w2 = *Pointer<Int>(v0 + pos * 16 + 12) ^
-							 *Pointer<Int>(v1 + pos * 16 + 12) ^
-							 *Pointer<Int>(v2 + pos * 16 + 12);
+				Int w0w1w2 = *Pointer<Int>(v0 + OFFSET(Vertex,v[pos].w)) ^
+							 *Pointer<Int>(v1 + OFFSET(Vertex,v[pos].w)) ^
+							 *Pointer<Int>(v2 + OFFSET(Vertex,v[pos].w));
 
 				A = IfThenElse(w0w1w2 < 0, -A, A);
 
@@ -163,9 +166,11 @@ namespace sw
 				Until(i >= n)
 			}
 
-			// Vertical range
+			// Vertical and horizontal range
 			Int yMin = Y[0];
 			Int yMax = Y[0];
+			Int xMin = X[0];
+			Int xMax = X[0];
 
 			Int i = 1;
 
@@ -173,6 +178,8 @@ namespace sw
 			{
 				yMin = Min(Y[i], yMin);
 				yMax = Max(Y[i], yMax);
+				xMin = Min(X[i], xMin);
+				xMax = Max(X[i], xMax);
 
 				i++;
 			}
@@ -182,11 +189,15 @@ namespace sw
 			{
 				yMin = (yMin + 0x0A) >> 4;
 				yMax = (yMax + 0x14) >> 4;
+				xMin = (xMin + 0x0A) >> 4;
+				xMax = (xMax + 0x14) >> 4;
 			}
 			else
 			{
 				yMin = (yMin + 0x0F) >> 4;
 				yMax = (yMax + 0x0F) >> 4;
+				xMin = (xMin + 0x0F) >> 4;
+				xMax = (xMax + 0x0F) >> 4;
 			}
 
 			If(yMin == yMax)
@@ -197,82 +208,93 @@ namespace sw
 			yMin = Max(yMin, *Pointer<Int>(data + OFFSET(DrawData,scissorY0)));
 			yMax = Min(yMax, *Pointer<Int>(data + OFFSET(DrawData,scissorY1)));
 
-			For(Int q = 0, q < state.multiSample, q++)
+			If(yMin >= yMax)   // Above or below the scissor, possibly within the guard band
 			{
-				Array<Int> Xq(16);
-				Array<Int> Yq(16);
+				Return(false);
+			}
 
-				Int i = 0;
+			// Sub-pixel triangles between sample columns, or beside the scissor, skip the edge walk
+			xMin = Max(xMin, *Pointer<Int>(data + OFFSET(DrawData,scissorX0)));
+			xMax = Min(xMax, *Pointer<Int>(data + OFFSET(DrawData,scissorX1)));
 
-				Do
-				{
-					Xq[i] = X[i];
-					Yq[i] = Y[i];
+			If(xMin >= xMax)
+			{
+				Return(false);
+			}
 
-					if(state.multiSample > 1)
-					{
-						Xq[i] = Xq[i] + *Pointer<Int>(constants + OFFSET(Constants,Xf) + q * sizeof(int));
-						Yq[i] = Yq[i] + *Pointer<Int>(constants + OFFSET(Constants,Yf) + q * sizeof(int));
-					}
+			Pointer<Byte> outline = *Pointer<Pointer<Byte>>(primitive + OFFSET(Primitive,outline));
 
-					i++;
-				}
-				Until(i >= n)
+			X[n] = X[0];
+			Y[n] = Y[0];
 
-				Pointer<Byte> leftEdge = Pointer<Byte>(primitive + OFFSET(Primitive,outline->left)) + q * sizeof(Primitive);
-				Pointer<Byte> rightEdge = Pointer<Byte>(primitive + OFFSET(Primitive,outline->right)) + q * sizeof(Primitive);
+			if(state.multiSample > 1)
+			{
+				// Rows which none of a sample's edges cross stay empty
+				Int xMin = *Pointer<Int>(data + OFFSET(DrawData,scissorX0));
+				Int xMax = *Pointer<Int>(data + OFFSET(DrawData,scissorX1));
+				Int x = Clamp((X[0] + 0xF) >> 4, xMin, xMax);
+				Int span = x | (x << 16);
 
-				if(state.multiSample > 1)
+				For(Int y = yMin - 1, y < yMax + 1, y++)
 				{
-					Int xMin = *Pointer<Int>(data + OFFSET(DrawData, scissorX0));
-					Int xMax = *Pointer<Int>(data + OFFSET(DrawData, scissorX1));
-					Short x = Short(Clamp((X[0] + 0xF) >> 4, xMin, xMax));
+					Pointer<Byte> row = outline + (y + 2) * Int(state.multiSample * sizeof(Primitive::Span));
 
-					For(Int y = yMin - 1, y < yMax + 1, y++)
+					for(unsigned int q = 0; q < state.multiSample; q++)
 					{
-						*Pointer<Short>(leftEdge + y * sizeof(Primitive::Span)) = x;
-						*Pointer<Short>(rightEdge + y * sizeof(Primitive::Span)) = x;
+						*Pointer<Int>(row + q * sizeof(Primitive::Span)) = span;
 					}
 				}
 
-				Xq[n] = Xq[0];
-				Yq[n] = Yq[0];
-
 				// Rasterize
 				{
 					Int i = 0;
 
 					Do
 					{
-						edge(primitive, data, Xq[i + 1 - d], Yq[i + 1 - d], Xq[i + d], Yq[i + d], q);
+						edgeSamples(outline, data, constants, X[i + 1 - d], Y[i + 1 - d], X[i + d], Y[i + d]);
 
 						i++;
 					}
 					Until(i >= n)
 				}
-
-				if(state.multiSample == 1)
+			}
+			else
+			{
+				// Rasterize
 				{
-					For(, yMin < yMax && *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + yMin * sizeof(Primitive::Span)), yMin++)
-					{
-						// Increments yMin
-					}
+					Int i = 0;
 
-					For(, yMax > yMin && *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + (yMax - 1) * sizeof(Primitive::Span)), yMax--)
+					Do
 					{
-						// Decrements yMax
-					}
+						edge(outline, data, X[i + 1 - d], Y[i + 1 - d], X[i + d], Y[i + d]);
 
-					If(yMin == yMax)
-					{
-						Return(false);
+						i++;
 					}
+					Until(i >= n)
+				}
+
+				Pointer<Byte> leftEdge = outline + OFFSET(Primitive::Outline,span->left);
+				Pointer<Byte> rightEdge = outline + OFFSET(Primitive::Outline,span->right);
 
-					*Pointer<Short>(leftEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
-					*Pointer<Short>(rightEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
-					*Pointer<Short>(leftEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
-					*Pointer<Short>(rightEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
+				For(, yMin < yMax && *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + yMin * sizeof(Primitive::Span)), yMin++)
+				{
+					// Increments yMin
 				}
+
+				For(, yMax > yMin && *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + (yMax - 1) * sizeof(Primitive::Span)), yMax--)
+				{
+					// Decrements yMax
+				}
+
+				If(yMin == yMax)
+				{
+					Return(false);
+				}
+
+				*Pointer<Short>(leftEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
+				*Pointer<Short>(rightEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
+				*Pointer<Short>(leftEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
+				*Pointer<Short>(rightEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
 			}
 
 			*Pointer<Int>(primitive + OFFSET(Primitive,yMin)) = yMin;
@@ -281,9 +303,9 @@ namespace sw
 			// Sort by minimum y
 			if(solidTriangle && logPrecision >= WHQL)
 			{
-				Float y0 = *Pointer<Float>(v0 + pos * 16 + 4);
-				Float y1 = *Pointer<Float>(v1 + pos * 16 + 4);
-				Float y2 = *Pointer<Float>(v2 + pos * 16 + 4);
+				Float y0 = *Pointer<Float>(v0 + OFFSET(Vertex,v[pos].y));
+				Float y1 = *Pointer<Float>(v1 + OFFSET(Vertex,v[pos].y));
+				Float y2 = *Pointer<Float>(v2 + OFFSET(Vertex,v[pos].y));
 
 				Float yMin = Min(Min(y0, y1), y2);
 
@@ -294,9 +316,9 @@ namespace sw
 			// Sort by maximum w
 			if(solidTriangle)
 			{
-				Float w0 = *Pointer<Float>(v0 + pos * 16 + 12);
-				Float w1 = *Pointer<Float>(v1 + pos * 16 + 12);
-				Float w2 = *Pointer<Float>(v2 + pos * 16 + 12);
+				Float w0 = *Pointer<Float>(v0 + OFFSET(Vertex,v[pos].w));
+				Float w1 = *Pointer<Float>(v1 + OFFSET(Vertex,v[pos].w));
+				Float w2 = *Pointer<Float>(v2 + OFFSET(Vertex,v[pos].w));
 
 				Float wMax = Max(Max(w0, w1), w2);
 
@@ -304,9 +326,9 @@ namespace sw
 				conditionalRotate2(wMax == w2, v0, v1, v2);
 			}
 
-			Float w0 = *Pointer<Float>(v0 + pos * 16 + 12);
-			Float w1 = *Pointer<Float>(v1 + pos * 16 + 12);
-			Float w2 = *Pointer<Float>(v2 + pos * 16 + 12);
+			Float w0 = *Pointer<Float>(v0 + OFFSET(Vertex,v[pos].w));
+			Float w1 = *Pointer<Float>(v1 + OFFSET(Vertex,v[pos].w));
+			Float w2 = *Pointer<Float>(v2 + OFFSET(Vertex,v[pos].w));
 
 			Float4 w012;
 
@@ -315,15 +337,34 @@ namespace sw
 			w012.z = w2;
 			w012.w = 1;
 
+			if(state.perspective)
+			{
+				// Orthographic primitives have the same w at all vertices, so their interpolants are set up
+				// to be linear in screen space and the pixel routine skips the division by w
+				*Pointer<Int>(primitive + OFFSET(Primitive,affine)) = 1;
+
+				If(w0 != w1 || w0 != w2)
+				{
+					*Pointer<Int>(primitive + OFFSET(Primitive,affine)) = 0;
+					w012 = Float4(1.0f);
+				}
+			}
+
 			Float rhw0 = *Pointer<Float>(v0 + OFFSET(Vertex,W));
 
+			if(!sprite)   // Follow the rotated vertices
+			{
+				p1 = v1;
+				p2 = v2;
+			}
+
 			Int X0 = *Pointer<Int>(v0 + OFFSET(Vertex,X));
-			Int X1 = *Pointer<Int>(v1 + OFFSET(Vertex,X));
-			Int X2 = *Pointer<Int>(v2 + OFFSET(Vertex,X));
+			Int X1 = *Pointer<Int>(p1 + OFFSET(Vertex,X));
+			Int X2 = *Pointer<Int>(p2 + OFFSET(Vertex,X));
 
 			Int Y0 = *Pointer<Int>(v0 + OFFSET(Vertex,Y));
-			Int Y1 = *Pointer<Int>(v1 + OFFSET(Vertex,Y));
-			Int Y2 = *Pointer<Int>(v2 + OFFSET(Vertex,Y));
+			Int Y1 = *Pointer<Int>(p1 + OFFSET(Vertex,Y));
+			Int Y2 = *Pointer<Int>(p2 + OFFSET(Vertex,Y));
 
 			if(line)
 			{
@@ -455,22 +496,48 @@ namespace sw
 
 			for(int interpolant = 0; interpolant < MAX_FRAGMENT_INPUTS; interpolant++)
 			{
+				// Smoothly interpolated components of the same vertex output share their plane equation setup
+				int components = 0;
+				int sharedAttribute = Unused;
+
+				for(int component = 0; component < 4; component++)
+				{
+					const SetupProcessor::States::Gradient &gradient = state.gradient[interpolant][component];
+
+					if(gradient.attribute != Unused && !gradient.flat && !gradient.wrap && !sprite &&
+					   (sharedAttribute == Unused || gradient.attribute == sharedAttribute))
+					{
+						sharedAttribute = gradient.attribute;
+						components |= 1 << component;
+					}
+				}
+
+				if((components & (components - 1)) == 0)   // Fewer than two
+				{
+					components = 0;
+				}
+
+				if(components)
+				{
+					setupGradients(primitive, w012, M, v0, v1, v2, OFFSET(Vertex,v[sharedAttribute]), OFFSET(Primitive,V[interpolant]), components);
+				}
+
 				for(int component = 0; component < 4; component++)
 				{
 					int attribute = state.gradient[interpolant][component].attribute;
 					bool flat = state.gradient[interpolant][component].flat;
 					bool wrap = state.gradient[interpolant][component].wrap;
 
-					if(attribute != Unused)
+					if(attribute != Unused && !(components & (1 << component)))
 					{
-						setupGradient(primitive, tri, w012, M, v0, v1, v2, OFFSET(Vertex,v[attribute][component]), OFFSET(Primitive,V[interpolant][component]), flat, sprite, state.perspective, wrap, component);
+						setupGradient(primitive, tri, w012, M, v0, v1, v2, OFFSET(Vertex,v[attribute][component]), OFFSET(Primitive,V[interpolant][component]), flat, sprite, wrap, component);
 					}
 				}
 			}
 
 			if(state.fog.attribute == Fog)
 			{
-				setupGradient(primitive, tri, w012, M, v0, v1, v2, OFFSET(Vertex,f), OFFSET(Primitive,f), state.fog.flat, false, state.perspective, false, 0);
+				setupGradient(primitive, tri, w012, M, v0, v1, v2, OFFSET(Vertex,f), OFFSET(Primitive,f), state.fog.flat, false, false, 0);
 			}
 
 			Return(true);
@@ -479,7 +546,7 @@ namespace sw
 		routine = function(L"SetupRoutine");
 	}
 
-	void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool sprite, bool perspective, bool wrap, int component)
+	void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool sprite, bool wrap, int component)
 	{
 		Float4 i;
 
@@ -527,10 +594,7 @@ namespace sw
 				If(Float(i.z) < m) i.z = i.z + 1.0f;
 			}
 
-			if(!perspective)
-			{
-				i *= w012;
-			}
+			i *= w012;   // One for perspective correct planes
 
 			Float4 A = i.xxxx * m[0];
 			Float4 B = i.yyyy * m[1];
@@ -548,7 +612,7 @@ namespace sw
 		}
 		else
 		{
-			int leadingVertex = leadingVertexFirst ? OFFSET(Triangle,v0) : OFFSET(Triangle,v2);
+			int leadingVertex = (leadingVertexFirst || state.isDrawPoint) ? OFFSET(Triangle,v0) : OFFSET(Triangle,v2);
 			Float C = *Pointer<Float>(triangle + leadingVertex + attribute);
 
 			*Pointer<Float4>(primitive + planeEquation + 0, 16) = Float4(0, 0, 0, 0);
@@ -557,7 +621,55 @@ namespace sw
 		}
 	}
 
-	void SetupRoutine::edge(Pointer<Byte> &primitive, Pointer<Byte> &data, const Int &Xa, const Int &Ya, const Int &Xb, const Int &Yb, Int &q)
+	void SetupRoutine::setupGradients(Pointer<Byte> &primitive, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, int components)
+	{
+		// Same arithmetic as setupGradient(), with a lane per component instead of per vertex
+		Float4 i0 = *Pointer<Float4>(v0 + attribute, 16);
+		Float4 i1 = *Pointer<Float4>(v1 + attribute, 16);
+		Float4 i2 = *Pointer<Float4>(v2 + attribute, 16);
+
+		i0 *= w012.xxxx;
+		i1 *= w012.yyyy;
+		i2 *= w012.zzzz;
+
+		Float4 A = i0 * m[0].xxxx + i1 * m[1].xxxx + i2 * m[2].xxxx;
+		Float4 B = i0 * m[0].yyyy + i1 * m[1].yyyy + i2 * m[2].yyyy;
+		Float4 C = i0 * m[0].zzzz + i1 * m[1].zzzz + i2 * m[2].zzzz;
+
+		for(int component = 0; component < 4; component++)
+		{
+			if(components & (1 << component))
+			{
+				int plane = planeEquation + component * sizeof(PlaneEquation);
+
+				switch(component)
+				{
+				case 0:
+					*Pointer<Float4>(primitive + plane + 0, 16) = A.xxxx;
+					*Pointer<Float4>(primitive + plane + 16, 16) = B.xxxx;
+					*Pointer<Float4>(primitive + plane + 32, 16) = C.xxxx;
+					break;
+				case 1:
+					*Pointer<Float4>(primitive + plane + 0, 16) = A.yyyy;
+					*Pointer<Float4>(primitive + plane + 16, 16) = B.yyyy;
+					*Pointer<Float4>(primitive + plane + 32, 16) = C.yyyy;
+					break;
+				case 2:
+					*Pointer<Float4>(primitive + plane + 0, 16) = A.zzzz;
+					*Pointer<Float4>(primitive + plane + 16, 16) = B.zzzz;
+					*Pointer<Float4>(primitive + plane + 32, 16) = C.zzzz;
+					break;
+				case 3:
+					*Pointer<Float4>(primitive + plane + 0, 16) = A.wwww;
+					*Pointer<Float4>(primitive + plane + 16, 16) = B.wwww;
+					*Pointer<Float4>(primitive + plane + 32, 16) = C.wwww;
+					break;
+				}
+			}
+		}
+	}
+
+	void SetupRoutine::edge(Pointer<Byte> &outline, Pointer<Byte> &data, const Int &Xa, const Int &Ya, const Int &Xb, const Int &Yb)
 	{
 		If(Ya != Yb)
 		{
@@ -576,8 +688,8 @@ namespace sw
 				Int xMin = *Pointer<Int>(data + OFFSET(DrawData,scissorX0));
 				Int xMax = *Pointer<Int>(data + OFFSET(DrawData,scissorX1));
 
-				Pointer<Byte> leftEdge = primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left);
-				Pointer<Byte> rightEdge = primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right);
+				Pointer<Byte> leftEdge = outline + OFFSET(Primitive::Outline,span->left);
+				Pointer<Byte> rightEdge = outline + OFFSET(Primitive::Outline,span->right);
 				Pointer<Byte> edge = IfThenElse(swap, rightEdge, leftEdge);
 
 				// Deltas
@@ -587,18 +699,33 @@ namespace sw
 				Int FDX12 = DX12 << 4;
 				Int FDY12 = DY12 << 4;
 
-				Int X = DX12 * ((y1 << 4) - Y1) + (X1 & 0x0000000F) * DY12;
-				Int x = (X1 >> 4) + X / FDY12;   // Edge
-				Int d = X % FDY12;               // Error-term
-				Int ceil = -d >> 31;             // Ceiling division: remainder <= 0
-				x -= ceil;
-				d -= ceil & FDY12;
+				Int x;   // Edge
+				Int d;   // Error-term
+				Int Q;   // Edge-step
+				Int R;   // Error-step
 
-				Int Q = FDX12 / FDY12;   // Edge-step
-				Int R = FDX12 % FDY12;   // Error-step
-				Int floor = R >> 31;     // Flooring division: remainder >= 0
-				Q += floor;
-				R += floor & FDY12;
+				If(DX12 == 0)   // Vertical, like the sides of points, skips the divisions
+				{
+					x = (X1 + 0x0000000F) >> 4;
+					d = 0;
+					Q = 0;
+					R = 0;
+				}
+				Else
+				{
+					Int X = DX12 * ((y1 << 4) - Y1) + (X1 & 0x0000000F) * DY12;
+					x = (X1 >> 4) + X / FDY12;
+					d = X % FDY12;
+					Int ceil = -d >> 31;   // Ceiling division: remainder <= 0
+					x -= ceil;
+					d -= ceil & FDY12;
+
+					Q = FDX12 / FDY12;
+					R = FDX12 % FDY12;
+					Int floor = R >> 31;   // Flooring division: remainder >= 0
+					Q += floor;
+					R += floor & FDY12;
+				}
 
 				Int D = FDY12;   // Error-overflow
 				Int y = y1;
@@ -622,6 +749,115 @@ namespace sw
 		}
 	}
 
+	void SetupRoutine::edgeSamples(Pointer<Byte> &outline, Pointer<Byte> &data, Pointer<Byte> &constants, const Int &Xa, const Int &Ya, const Int &Xb, const Int &Yb)
+	{
+		If(Ya != Yb)
+		{
+			Bool swap = Yb < Ya;
+
+			Int X1 = IfThenElse(swap, Xb, Xa);
+			Int X2 = IfThenElse(swap, Xa, Xb);
+			Int Y1 = IfThenElse(swap, Yb, Ya);
+			Int Y2 = IfThenElse(swap, Ya, Yb);
+
+			// One lane per sample, the edge is offset by the sample's position
+			Int4 Xf = *Pointer<Int4>(constants + OFFSET(Constants,Xf));
+			Int4 Yf = *Pointer<Int4>(constants + OFFSET(Constants,Yf));
+			Int4 X1q = Int4(X1) + Xf;
+			Int4 Y1q = Int4(Y1) + Yf;
+
+			Int4 y1 = Max((Y1q + Int4(0x0000000F)) >> 4, Int4(*Pointer<Int>(data + OFFSET(DrawData,scissorY0))));
+			Int4 y2 = Min((Int4(Y2) + Yf + Int4(0x0000000F)) >> 4, Int4(*Pointer<Int>(data + OFFSET(DrawData,scissorY1))));
+
+			if(state.multiSample == 2)
+			{
+				y2 = y2 & Int4(-1, -1, 0, 0);   // Lanes without a sample stay empty
+				y1 = y1 | Int4(0, 0, 0x7FFFFFFF, 0x7FFFFFFF);
+			}
+
+			Int yBegin = Min(Min(Extract(y1, 0), Extract(y1, 1)), Min(Extract(y1, 2), Extract(y1, 3)));
+			Int yEnd = Max(Max(Extract(y2, 0), Extract(y2, 1)), Max(Extract(y2, 2), Extract(y2, 3)));
+
+			If(yBegin < yEnd)
+			{
+				Int4 xMin = Int4(*Pointer<Int>(data + OFFSET(DrawData,scissorX0)));
+				Int4 xMax = Int4(*Pointer<Int>(data + OFFSET(DrawData,scissorX1)));
+
+				// Left edges store the low half of each span, right edges the high half
+				Int4 keep = IfThenElse(swap, Int(0x0000FFFF), Int(0xFFFF0000));
+				Int4 store = ~keep;
+
+				// Deltas
+				Int DX12 = X2 - X1;
+				Int DY12 = Y2 - Y1;
+
+				Int FDX12 = DX12 << 4;
+				Int FDY12 = DY12 << 4;
+
+				Int4 x;   // Edge
+				Int4 d;   // Error-term
+				Int Q;    // Edge-step
+				Int R;    // Error-step
+
+				If(DX12 == 0)   // Vertical, like the sides of points, skips the divisions
+				{
+					x = (X1q + Int4(0x0000000F)) >> 4;
+					d = Int4(0);
+					Q = 0;
+					R = 0;
+				}
+				Else
+				{
+					// Starts all samples on the first row of any of them, the error-term keeps them exact
+					for(unsigned int q = 0; q < state.multiSample; q++)
+					{
+						Int X1s = Extract(X1q, q);
+						Int X = DX12 * ((yBegin << 4) - Extract(Y1q, q)) + (X1s & 0x0000000F) * DY12;
+						Int xs = (X1s >> 4) + X / FDY12;
+						Int ds = X % FDY12;
+						Int ceil = -ds >> 31;   // Ceiling division: remainder <= 0
+						xs -= ceil;
+						ds -= ceil & FDY12;
+
+						x = Insert(x, xs, q);
+						d = Insert(d, ds, q);
+					}
+
+					Q = FDX12 / FDY12;
+					R = FDX12 % FDY12;
+					Int floor = R >> 31;   // Flooring division: remainder >= 0
+					Q += floor;
+					R += floor & FDY12;
+				}
+
+				Int4 D = Int4(FDY12);   // Error-overflow
+				Int y = yBegin;
+
+				Do
+				{
+					Pointer<Byte> row = outline + (y + 2) * Int(state.multiSample * sizeof(Primitive::Span));
+
+					Int4 covered = CmpLE(y1, Int4(y)) & CmpLT(Int4(y), y2);
+					Int4 spans = *Pointer<Int4>(row);
+					Int4 value = Min(Max(x, xMin), xMax);
+					value = (value | (value << 16)) & store;
+					*Pointer<Int4>(row) = (((spans & keep) | value) & covered) | (spans & ~covered);   // Two samples of the next row pass through for 2x
+
+					x += Int4(Q);
+					d += Int4(R);
+
+					Int4 overflow = CmpNLE(d, Int4(0));
+
+					d -= D & overflow;
+					x -= overflow;
+
+					y++;
+				}
+				Until(y >= yEnd)
+			}
+		}
+	}
+
 	void SetupRoutine::conditionalRotate1(Bool condition, Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2)
 	{
 		#if 0   // Rely on LLVM optimization
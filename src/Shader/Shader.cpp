@@ -19,14 +19,18 @@
 #include "Common/Math.hpp"
 #include "Common/Debug.hpp"
 
+#include <algorithm>
 #include <set>
+#include <climits>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <stdarg.h>
+#include <string.h>
 
 namespace sw
 {
-	volatile int Shader::serialCounter = 1;
+	AtomicInt Shader::serialCounter(0);
 
 	Shader::Opcode Shader::OPCODE_DP(int i)
 	{
@@ -327,6 +331,11 @@ namespace sw
 			modifierString += "_pp";
 		}
 
+		if(mediumPrecision)
+		{
+			modifierString += "_mp";
+		}
+
 		if(centroid)
 		{
 			modifierString += "_centroid";
@@ -1132,6 +1141,10 @@ namespace sw
 	Shader::Shader() : serialID(serialCounter++)
 	{
 		usedSamplers = 0;
+		unoptimizedLength = 0;
+		optimization = true;
+		indexedTemporariesBegin = 0;
+		indexedTemporariesEnd = 0;
 	}
 
 	Shader::~Shader()
@@ -1141,6 +1154,12 @@ namespace sw
 			delete inst;
 			inst = 0;
 		}
+
+		for(auto &inst : prologue)
+		{
+			delete inst;
+			inst = 0;
+		}
 	}
 
 	void Shader::parse(const unsigned long *token)
@@ -1418,6 +1437,24 @@ namespace sw
 		return containsDefine;
 	}
 
+	const std::vector<const Shader::Instruction*> &Shader::getDefinitions() const
+	{
+		return definitions;
+	}
+
+	const Shader::Instruction *Shader::getDefinition(unsigned int index) const
+	{
+		for(const Instruction *inst : definitions)
+		{
+			if(inst->opcode == OPCODE_DEF && inst->dst.index == index)
+			{
+				return inst;
+			}
+		}
+
+		return nullptr;
+	}
+
 	bool Shader::usesSampler(int index) const
 	{
 		return (usedSamplers & (1 << index)) != 0;
@@ -1428,6 +1465,301 @@ namespace sw
 		return serialID;
 	}
 
+	uint64_t Shader::getFingerprint() const
+	{
+		std::vector<unsigned int> data;
+		serialize(data);
+
+		return FNV_1a(reinterpret_cast<const unsigned char*>(data.data()), static_cast<int>(data.size() * sizeof(unsigned int)));
+	}
+
+	static void appendParameter(std::vector<unsigned int> &data, const Shader::Parameter &parameter)
+	{
+		data.push_back(parameter.type);
+
+		switch(parameter.type)
+		{
+		case Shader::PARAMETER_FLOAT4LITERAL:
+		case Shader::PARAMETER_BOOL1LITERAL:
+		case Shader::PARAMETER_INT4LITERAL:
+			data.insert(data.end(), parameter.integer, parameter.integer + 4);
+			break;
+		case Shader::PARAMETER_LABEL:
+			data.push_back(parameter.label);
+			data.push_back(parameter.callSite);
+			break;
+		default:
+			data.push_back(parameter.index);
+			data.push_back(parameter.rel.type);
+			data.push_back(parameter.rel.index);
+			data.push_back(parameter.rel.swizzle);
+			data.push_back(parameter.rel.scale);
+			data.push_back(parameter.rel.dynamic);
+			break;
+		}
+	}
+
+	static bool readParameter(const unsigned int *&data, const unsigned int *end, Shader::Parameter &parameter)
+	{
+		if(end - data < 1)
+		{
+			return false;
+		}
+
+		parameter.type = static_cast<Shader::ParameterType>(*data++);
+
+		switch(parameter.type)
+		{
+		case Shader::PARAMETER_FLOAT4LITERAL:
+		case Shader::PARAMETER_BOOL1LITERAL:
+		case Shader::PARAMETER_INT4LITERAL:
+			if(end - data < 4) return false;
+			for(int i = 0; i < 4; i++) parameter.integer[i] = *data++;
+			break;
+		case Shader::PARAMETER_LABEL:
+			if(end - data < 2) return false;
+			parameter.label = *data++;
+			parameter.callSite = *data++;
+			break;
+		default:
+			if(end - data < 6) return false;
+			parameter.index = *data++;
+			parameter.rel.type = static_cast<Shader::ParameterType>(*data++);
+			parameter.rel.index = *data++;
+			parameter.rel.swizzle = *data++;
+			parameter.rel.scale = *data++;
+			parameter.rel.dynamic = (*data++ != 0);
+			break;
+		}
+
+		return true;
+	}
+
+	static void appendInstruction(std::vector<unsigned int> &data, const Shader::Instruction *inst)
+	{
+		data.push_back(inst->opcode);
+		data.push_back(inst->control);
+		data.push_back(inst->predicate | inst->predicateNot << 1 | inst->coissue << 2);
+		data.push_back(inst->predicateSwizzle);
+		data.push_back(inst->samplerType);
+		data.push_back(inst->usage);
+		data.push_back(inst->usageIndex);
+		data.push_back(inst->analysis);
+
+		appendParameter(data, inst->dst);
+		data.push_back(inst->dst.mask);
+		data.push_back(inst->dst.saturate | inst->dst.partialPrecision << 1 | inst->dst.centroid << 2 | inst->dst.mediumPrecision << 3);
+		data.push_back(inst->dst.shift);
+
+		for(const Shader::SourceParameter &src : inst->src)
+		{
+			appendParameter(data, src);
+			data.push_back(src.swizzle);
+			data.push_back(src.modifier);
+			data.push_back(src.bufferIndex);
+		}
+	}
+
+	static Shader::Instruction *readInstruction(const unsigned int *&data, const unsigned int *end)
+	{
+		if(end - data < 8)
+		{
+			return nullptr;
+		}
+
+		Shader::Instruction *inst = new Shader::Instruction(static_cast<Shader::Opcode>(data[0]));
+
+		inst->control = static_cast<Shader::Control>(data[1]);
+		inst->predicate = (data[2] & 1) != 0;
+		inst->predicateNot = (data[2] & 2) != 0;
+		inst->coissue = (data[2] & 4) != 0;
+		inst->predicateSwizzle = static_cast<unsigned char>(data[3]);
+		inst->samplerType = static_cast<Shader::SamplerType>(data[4]);
+		inst->usage = static_cast<Shader::Usage>(data[5]);
+		inst->usageIndex = static_cast<unsigned char>(data[6]);
+		inst->analysis = data[7];
+		data += 8;
+
+		if(!readParameter(data, end, inst->dst) || end - data < 3)
+		{
+			delete inst;
+			return nullptr;
+		}
+
+		inst->dst.mask = static_cast<unsigned char>(data[0]);
+		inst->dst.saturate = (data[1] & 1) != 0;
+		inst->dst.partialPrecision = (data[1] & 2) != 0;
+		inst->dst.centroid = (data[1] & 4) != 0;
+		inst->dst.mediumPrecision = (data[1] & 8) != 0;
+		inst->dst.shift = static_cast<signed char>(data[2]);
+		data += 3;
+
+		for(Shader::SourceParameter &src : inst->src)
+		{
+			if(!readParameter(data, end, src) || end - data < 3)
+			{
+				delete inst;
+				return nullptr;
+			}
+
+			src.swizzle = data[0];
+			src.modifier = static_cast<Shader::Modifier>(data[1]);
+			src.bufferIndex = static_cast<int>(data[2]);
+			data += 3;
+		}
+
+		return inst;
+	}
+
+	void Shader::serialize(std::vector<unsigned int> &data) const
+	{
+		// Only state which affects code generation, so it can't contain pointers or padding
+		data.push_back(shaderType);
+		data.push_back(shaderModel);
+		data.push_back(usedSamplers);
+		data.push_back(dirtyConstantsF);
+		data.push_back(dirtyConstantsI);
+		data.push_back(dirtyConstantsB);
+		data.push_back(indirectAddressableTemporaries | indirectAddressableInput << 1 | indirectAddressableOutput << 2);
+		data.push_back(indexedTemporariesBegin | indexedTemporariesEnd << 16);
+		data.push_back(dynamicBranching | containsBreak << 1 | containsContinue << 2 | containsLeave << 3 | containsDefine << 4);
+		data.push_back(static_cast<unsigned int>(instruction.size()));
+
+		for(const Instruction *inst : instruction)
+		{
+			appendInstruction(data, inst);
+		}
+
+		data.push_back(static_cast<unsigned int>(prologue.size()));
+
+		for(const Instruction *inst : prologue)
+		{
+			appendInstruction(data, inst);
+		}
+	}
+
+	bool Shader::deserialize(const unsigned int *&data, const unsigned int *end)
+	{
+		if(end - data < 10 || data[0] != static_cast<unsigned int>(shaderType))
+		{
+			return false;
+		}
+
+		data++;
+		shaderModel = static_cast<unsigned short>(*data++);
+		usedSamplers = static_cast<unsigned short>(*data++);
+		dirtyConstantsF = *data++;
+		dirtyConstantsI = *data++;
+		dirtyConstantsB = *data++;
+
+		unsigned int addressing = *data++;
+		indirectAddressableTemporaries = (addressing & 1) != 0;
+		indirectAddressableInput = (addressing & 2) != 0;
+		indirectAddressableOutput = (addressing & 4) != 0;
+
+		unsigned int indexed = *data++;
+		indexedTemporariesBegin = indexed & 0xFFFF;
+		indexedTemporariesEnd = indexed >> 16;
+
+		if(indexedTemporariesBegin > indexedTemporariesEnd || indexedTemporariesEnd > NUM_TEMPORARY_REGISTERS)
+		{
+			return false;
+		}
+
+		unsigned int flow = *data++;
+		dynamicBranching = (flow & 1) != 0;
+		containsBreak = (flow & 2) != 0;
+		containsContinue = (flow & 4) != 0;
+		containsLeave = (flow & 8) != 0;
+		containsDefine = (flow & 16) != 0;
+
+		size_t count = *data++;
+
+		if(count > static_cast<size_t>(end - data))   // Each instruction takes several words
+		{
+			return false;
+		}
+
+		std::vector<unsigned int> callSites(MAX_LABELS, 0);   // Per label, numbered in program order like analyzeCallSites()
+
+		for(size_t i = 0; i < count; i++)
+		{
+			Instruction *inst = readInstruction(data, end);
+
+			if(!inst)
+			{
+				return false;
+			}
+
+			append(inst);
+
+			if(!isValidInstruction(inst))
+			{
+				return false;
+			}
+
+			if(inst->isCall() && inst->dst.callSite != callSites[inst->dst.label]++)
+			{
+				return false;
+			}
+		}
+
+		if(end - data < 1)
+		{
+			return false;
+		}
+
+		count = *data++;
+
+		if(count > MAX_PROLOGUE_INSTRUCTIONS)
+		{
+			return false;
+		}
+
+		for(size_t i = 0; i < count; i++)
+		{
+			Instruction *inst = readInstruction(data, end);
+
+			if(!inst)
+			{
+				return false;
+			}
+
+			prologue.push_back(inst);
+
+			if(!isValidInstruction(inst) || !isPrologueInstruction(inst) || inst->isPredicated())
+			{
+				return false;
+			}
+
+			// Registers must be within the evaluator's temporaries and the draw's constants
+			const Parameter *operand[4] = {&inst->dst, &inst->src[0], &inst->src[1], &inst->src[2]};
+
+			for(const Parameter *param : operand)
+			{
+				if(param->type == PARAMETER_TEMP && param->index >= MAX_PROLOGUE_TEMPORARIES)
+				{
+					return false;
+				}
+
+				if(param->type == PARAMETER_CONST && param->index >= prologueBase() + PROLOGUE_UNIFORM_VECTORS)
+				{
+					return false;
+				}
+			}
+
+			if(inst->dst.type == PARAMETER_CONST && inst->dst.index < prologueBase())
+			{
+				return false;
+			}
+		}
+
+		analyzeDefinitions();
+		analyzeSpecializableConstants();
+
+		return true;
+	}
+
 	size_t Shader::getLength() const
 	{
 		return instruction.size();
@@ -1454,6 +1786,11 @@ namespace sw
 
 		std::ofstream file(fullName, std::ofstream::out);
 
+		if(unoptimizedLength != 0)
+		{
+			file << "// " << instruction.size() << " instructions, " << unoptimizedLength << " before optimization" << std::endl;
+		}
+
 		for(const auto &inst : instruction)
 		{
 			file << inst->string(shaderType, shaderModel) << std::endl;
@@ -1480,6 +1817,27 @@ namespace sw
 		}
 	}
 
+	void Shader::declareIndexedTemporaries(int first, int count)
+	{
+		unsigned int end = first + count;
+
+		if(count <= 0 || first < 0 || end > NUM_TEMPORARY_REGISTERS)
+		{
+			return;
+		}
+
+		if(indexedTemporariesBegin == indexedTemporariesEnd)
+		{
+			indexedTemporariesBegin = first;
+			indexedTemporariesEnd = end;
+		}
+		else
+		{
+			indexedTemporariesBegin = min(indexedTemporariesBegin, static_cast<unsigned int>(first));
+			indexedTemporariesEnd = max(indexedTemporariesEnd, end);
+		}
+	}
+
 	const Shader::Instruction *Shader::getInstruction(size_t i) const
 	{
 		ASSERT(i < instruction.size());
@@ -1489,8 +1847,36 @@ namespace sw
 
 	void Shader::optimize()
 	{
+		unoptimizedLength = instruction.size();
+
 		optimizeLeave();
 		optimizeCall();
+
+		// Shader model 1.x instructions access registers implicitly, and indexed temporaries can't be tracked
+		std::vector<unsigned char> readMask;
+
+		if(optimization && shaderModel >= 0x0200 && analyzeTemporaryReads(readMask))
+		{
+			for(int pass = 0; pass < 2; pass++)
+			{
+				bool changed = true;
+
+				while(changed)
+				{
+					changed = propagateCopies();
+					changed = foldConstants() || changed;
+					changed = eliminateDeadWrites() || changed;
+					changed = eliminateRedundantSamples() || changed;
+				}
+
+				// Hoist per-draw computations once their operands have been propagated, then clean up the movs replacing them
+				if(pass != 0 || !hoistUniforms())
+				{
+					break;
+				}
+			}
+		}
+
 		removeNull();
 	}
 
@@ -1572,97 +1958,1487 @@ namespace sw
 		}
 	}
 
-	void Shader::removeNull()
+	bool Shader::propagateCopies()
 	{
-		size_t size = 0;
+		// Let instructions read the source of a temporary register copy directly, up to the next
+		// control flow instruction or overwrite of either register. Identity copies are removed.
+		bool changed = false;
+
 		for(size_t i = 0; i < instruction.size(); i++)
 		{
-			if(instruction[i]->opcode != OPCODE_NULL)
-			{
-				instruction[size] = instruction[i];
-				size++;
-			}
-			else
+			Instruction *copy = instruction[i];
+
+			if(copy->opcode != OPCODE_MOV || copy->dst.type != PARAMETER_TEMP || copy->dst.saturate || copy->predicate)
 			{
-				delete instruction[i];
+				continue;
 			}
-		}
 
-		instruction.resize(size);
-	}
+			const SourceParameter &src = copy->src[0];
 
-	void Shader::analyzeDirtyConstants()
-	{
-		dirtyConstantsF = 0;
-		dirtyConstantsI = 0;
-		dirtyConstantsB = 0;
+			if(src.modifier != MODIFIER_NONE)
+			{
+				continue;
+			}
 
-		for(const auto &inst : instruction)
-		{
-			switch(inst->opcode)
+			if(src.type == PARAMETER_TEMP && src.index == copy->dst.index)
 			{
-			case OPCODE_DEF:
-				if(inst->dst.index + 1 > dirtyConstantsF)
-				{
-					dirtyConstantsF = inst->dst.index + 1;
-				}
-				break;
-			case OPCODE_DEFI:
-				if(inst->dst.index + 1 > dirtyConstantsI)
+				bool identity = true;
+
+				for(int c = 0; c < 4; c++)
 				{
-					dirtyConstantsI = inst->dst.index + 1;
+					if((copy->dst.mask & (1 << c)) && ((src.swizzle >> (2 * c)) & 0x3) != c)
+					{
+						identity = false;
+					}
 				}
-				break;
-			case OPCODE_DEFB:
-				if(inst->dst.index + 1 > dirtyConstantsB)
+
+				if(identity)
 				{
-					dirtyConstantsB = inst->dst.index + 1;
+					copy->opcode = OPCODE_NULL;
+					changed = true;
 				}
-				break;
-			default:
-				break;
+
+				continue;
 			}
-		}
-	}
 
-	void Shader::analyzeDynamicBranching()
-	{
-		dynamicBranching = false;
-		containsLeave = false;
-		containsBreak = false;
-		containsContinue = false;
-		containsDefine = false;
+			if(src.type != PARAMETER_TEMP && src.type != PARAMETER_INPUT && src.type != PARAMETER_CONST && src.type != PARAMETER_FLOAT4LITERAL)
+			{
+				continue;
+			}
 
-		// Determine global presence of branching instructions
-		for(const auto &inst : instruction)
-		{
-			switch(inst->opcode)
+			if(src.type != PARAMETER_FLOAT4LITERAL && src.rel.type != PARAMETER_VOID)
 			{
-			case OPCODE_CALLNZ:
-			case OPCODE_IF:
-			case OPCODE_IFC:
-			case OPCODE_BREAK:
-			case OPCODE_BREAKC:
-			case OPCODE_CMP:
-			case OPCODE_BREAKP:
-			case OPCODE_LEAVE:
-			case OPCODE_CONTINUE:
-				if(inst->src[0].type != PARAMETER_CONSTBOOL)
-				{
-					dynamicBranching = true;
-				}
+				continue;
+			}
 
-				if(inst->opcode == OPCODE_LEAVE)
+			unsigned int available = copy->dst.mask;   // Components still holding the copied value
+			int sourceComponents = readComponents(copy, src);
+
+			for(size_t j = i + 1; j < instruction.size() && available != 0; j++)
+			{
+				Instruction *inst = instruction[j];
+
+				if(inst->opcode == OPCODE_NULL)
 				{
-					containsLeave = true;
+					continue;
 				}
 
-				if(inst->isBreak())
+				if(!isComponentwise(inst->opcode) && !isSideEffectFree(inst->opcode) && !isSampling(inst))
 				{
-					containsBreak = true;
+					break;   // Control flow, or an instruction with implicit operands
 				}
 
-				if(inst->opcode == OPCODE_CONTINUE)
+				for(int k = 0; k < 5; k++)
+				{
+					SourceParameter &use = inst->src[k];
+
+					if(k == 1 && inst->opcode >= OPCODE_M4X4 && inst->opcode <= OPCODE_M3X2)
+					{
+						continue;   // Matrix rows in consecutive registers
+					}
+
+					if(use.type == PARAMETER_TEMP && use.index == copy->dst.index && (readComponents(inst, use) & ~available) == 0)
+					{
+						unsigned int swizzle = 0;
+
+						for(int c = 0; c < 4; c++)
+						{
+							int component = (use.swizzle >> (2 * c)) & 0x3;
+							swizzle |= ((src.swizzle >> (2 * component)) & 0x3) << (2 * c);
+						}
+
+						Modifier modifier = use.modifier;
+						use = src;
+						use.swizzle = swizzle;
+						use.modifier = modifier;
+						changed = true;
+					}
+				}
+
+				if(inst->dst.type == PARAMETER_TEMP)
+				{
+					if(inst->dst.index == copy->dst.index)
+					{
+						available &= ~inst->dst.mask;
+					}
+
+					if(src.type == PARAMETER_TEMP && inst->dst.index == src.index && (inst->dst.mask & sourceComponents) != 0)
+					{
+						break;
+					}
+				}
+			}
+		}
+
+		return changed;
+	}
+
+	bool Shader::foldConstants()
+	{
+		// Evaluate arithmetic on literals, and drop multiplications by one
+		bool changed = false;
+
+		for(auto &inst : instruction)
+		{
+			bool floatOperation = inst->opcode == OPCODE_ADD || inst->opcode == OPCODE_SUB || inst->opcode == OPCODE_MUL || inst->opcode == OPCODE_MAD;
+			bool intOperation = inst->opcode == OPCODE_IADD || inst->opcode == OPCODE_ISUB || inst->opcode == OPCODE_IMUL;
+
+			if(!floatOperation && !intOperation)
+			{
+				continue;
+			}
+
+			int operands = (inst->opcode == OPCODE_MAD) ? 3 : 2;
+			bool literal[3] = {false, false, false};
+			bool one[3] = {false, false, false};
+			float value[3][4] = {};
+
+			for(int k = 0; k < operands; k++)
+			{
+				const SourceParameter &src = inst->src[k];
+
+				if(src.type == PARAMETER_FLOAT4LITERAL && src.modifier == MODIFIER_NONE)
+				{
+					literal[k] = true;
+					one[k] = floatOperation;
+
+					for(int c = 0; c < 4; c++)
+					{
+						value[k][c] = src.value[(src.swizzle >> (2 * c)) & 0x3];
+
+						if((inst->dst.mask & (1 << c)) && value[k][c] != 1.0f)
+						{
+							one[k] = false;
+						}
+					}
+				}
+			}
+
+			if(literal[0] && literal[1] && (operands == 2 || literal[2]))
+			{
+				float result[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+				bool exact = true;
+
+				for(int c = 0; c < 4; c++)
+				{
+					if(!(inst->dst.mask & (1 << c)))
+					{
+						continue;
+					}
+
+					if(floatOperation)
+					{
+						float x = value[0][c];
+						float y = value[1][c];
+
+						switch(inst->opcode)
+						{
+						case OPCODE_ADD: result[c] = x + y;   break;
+						case OPCODE_SUB: result[c] = x - y;   break;
+						case OPCODE_MUL: result[c] = x * y;   break;
+						case OPCODE_MAD: result[c] = x * y; result[c] = result[c] + value[2][c]; break;
+						default: ASSERT(false);
+						}
+
+						// Leave denormals and non-finite results to the generated code
+						float operand[4] = {x, y, value[2][c], result[c]};
+
+						for(int k = 0; k < 4; k++)
+						{
+							if(operand[k] != 0.0f && !std::isnormal(operand[k]))
+							{
+								exact = false;
+							}
+						}
+					}
+					else
+					{
+						unsigned int x;
+						unsigned int y;
+						unsigned int z;
+						memcpy(&x, &value[0][c], sizeof(x));
+						memcpy(&y, &value[1][c], sizeof(y));
+
+						switch(inst->opcode)
+						{
+						case OPCODE_IADD: z = x + y; break;
+						case OPCODE_ISUB: z = x - y; break;
+						case OPCODE_IMUL: z = x * y; break;
+						default: ASSERT(false); z = 0;
+						}
+
+						memcpy(&result[c], &z, sizeof(z));
+					}
+				}
+
+				if(exact)
+				{
+					inst->opcode = OPCODE_MOV;
+					inst->src[0] = SourceParameter();
+					inst->src[0].type = PARAMETER_FLOAT4LITERAL;
+					memcpy(inst->src[0].value, result, sizeof(result));
+					inst->src[1] = SourceParameter();
+					inst->src[2] = SourceParameter();
+					changed = true;
+				}
+			}
+			else if(inst->opcode == OPCODE_MUL && (one[0] || one[1]))
+			{
+				inst->opcode = OPCODE_MOV;
+				inst->src[0] = inst->src[one[0] ? 1 : 0];
+				inst->src[1] = SourceParameter();
+				changed = true;
+			}
+			else if(inst->opcode == OPCODE_MAD && (one[0] || one[1]))
+			{
+				inst->opcode = OPCODE_ADD;
+				inst->src[0] = inst->src[one[0] ? 1 : 0];
+				inst->src[1] = inst->src[2];
+				inst->src[2] = SourceParameter();
+				changed = true;
+			}
+		}
+
+		return changed;
+	}
+
+	bool Shader::eliminateDeadWrites()
+	{
+		// Trim temporary register writes to the components read anywhere in the shader,
+		// and remove the instructions of which no result is read at all
+		std::vector<unsigned char> readMask;
+
+		if(!analyzeTemporaryReads(readMask))
+		{
+			return false;
+		}
+
+		bool changed = false;
+
+		for(auto &inst : instruction)
+		{
+			if(inst->opcode == OPCODE_NULL || inst->dst.type != PARAMETER_TEMP)
+			{
+				continue;
+			}
+
+			if(!isComponentwise(inst->opcode) && !isSideEffectFree(inst->opcode))
+			{
+				continue;
+			}
+
+			unsigned char live = inst->dst.mask & readMask[inst->dst.index];
+
+			if(live == 0)
+			{
+				inst->opcode = OPCODE_NULL;
+				changed = true;
+			}
+			else if(live != inst->dst.mask && isComponentwise(inst->opcode))
+			{
+				inst->dst.mask = live;
+				changed = true;
+			}
+		}
+
+		return changed;
+	}
+
+	bool Shader::eliminateRedundantSamples()
+	{
+		// Replace texture sampling which repeats an earlier one with the same sampler, coordinates and
+		// function by a copy of its result, up to the next control flow instruction or overwrite of
+		// the operands or result. Pixel shaders execute straight-line code for the whole quad, so
+		// implicit derivatives are the same as well.
+		bool changed = false;
+
+		for(size_t i = 0; i < instruction.size(); i++)
+		{
+			const Instruction *sample = instruction[i];
+
+			if(!isSampling(sample) || sample->dst.type != PARAMETER_TEMP || sample->dst.rel.type != PARAMETER_VOID || sample->predicate)
+			{
+				continue;
+			}
+
+			bool relative = false;
+			bool overwritten = false;   // The result replaces one of the operands
+
+			for(int k = 0; k < 5; k++)
+			{
+				const SourceParameter &src = sample->src[k];
+
+				if(src.type != PARAMETER_VOID && src.type != PARAMETER_FLOAT4LITERAL && src.rel.type != PARAMETER_VOID)
+				{
+					relative = true;
+				}
+
+				if(src.type == PARAMETER_TEMP && src.index == sample->dst.index)
+				{
+					overwritten = true;
+				}
+			}
+
+			if(relative || overwritten)
+			{
+				continue;
+			}
+
+			unsigned int available = sample->dst.mask;   // Components still holding the sampled value
+
+			for(size_t j = i + 1; j < instruction.size() && available != 0; j++)
+			{
+				Instruction *inst = instruction[j];
+
+				if(inst->opcode == OPCODE_NULL)
+				{
+					continue;
+				}
+
+				if(!isComponentwise(inst->opcode) && !isSideEffectFree(inst->opcode) && !isSampling(inst))
+				{
+					break;   // Control flow, or an instruction with implicit operands
+				}
+
+				if(isSameSample(sample, inst) && inst->dst.type == PARAMETER_TEMP && inst->dst.rel.type == PARAMETER_VOID &&
+				   !inst->predicate && (inst->dst.mask & ~available) == 0)
+				{
+					inst->opcode = OPCODE_MOV;
+					inst->control = CONTROL_RESERVED0;
+					inst->dst.shift = 0;   // Already applied to the sampled value
+
+					for(int k = 0; k < 5; k++)
+					{
+						inst->src[k] = SourceParameter();
+					}
+
+					inst->src[0].type = PARAMETER_TEMP;
+					inst->src[0].index = sample->dst.index;
+					changed = true;
+				}
+
+				if(inst->dst.type == PARAMETER_TEMP)
+				{
+					if(inst->dst.rel.type != PARAMETER_VOID)
+					{
+						break;
+					}
+
+					if(inst->dst.index == sample->dst.index)
+					{
+						available &= ~inst->dst.mask;
+					}
+
+					bool clobbered = false;
+
+					for(int k = 0; k < 5; k++)
+					{
+						const SourceParameter &src = sample->src[k];
+
+						if(src.type == PARAMETER_TEMP && src.index == inst->dst.index && (inst->dst.mask & readComponents(sample, src)) != 0)
+						{
+							clobbered = true;
+						}
+					}
+
+					if(clobbered)
+					{
+						break;
+					}
+				}
+			}
+		}
+
+		return changed;
+	}
+
+	bool Shader::analyzeTemporaryReads(std::vector<unsigned char> &readMask) const
+	{
+		// Gathers the components of each temporary register that any instruction reads.
+		// Returns false when temporaries are indexed, as any of them could then be read.
+		for(const auto &inst : instruction)
+		{
+			if(inst->opcode == OPCODE_NULL)
+			{
+				continue;
+			}
+
+			const Parameter *operand[6] = {&inst->dst, &inst->src[0], &inst->src[1], &inst->src[2], &inst->src[3], &inst->src[4]};
+
+			for(int k = 0; k < 6; k++)
+			{
+				const Parameter &param = *operand[k];
+
+				if(param.type == PARAMETER_VOID || param.type == PARAMETER_LABEL || param.type == PARAMETER_FLOAT4LITERAL ||
+				   param.type == PARAMETER_BOOL1LITERAL || param.type == PARAMETER_INT4LITERAL)
+				{
+					continue;
+				}
+
+				if(param.rel.type != PARAMETER_VOID)
+				{
+					if(param.type == PARAMETER_TEMP)
+					{
+						return false;
+					}
+
+					if(param.rel.type == PARAMETER_TEMP)
+					{
+						if(readMask.size() <= param.rel.index) readMask.resize(param.rel.index + 1, 0);
+						readMask[param.rel.index] = 0xF;
+					}
+				}
+
+				if(param.type != PARAMETER_TEMP)
+				{
+					continue;
+				}
+
+				unsigned int first = param.index;
+				unsigned int last = param.index;
+				int components = 0;
+
+				if(k == 0)
+				{
+					// Instructions other than known operations may read their destination (e.g. texkill)
+					if(isComponentwise(inst->opcode) || isSideEffectFree(inst->opcode))
+					{
+						continue;
+					}
+
+					components = 0xF;
+				}
+				else
+				{
+					components = readComponents(inst, inst->src[k - 1]);
+
+					if(k == 2 && inst->opcode >= OPCODE_M4X4 && inst->opcode <= OPCODE_M3X2)
+					{
+						last = first + 3;   // Matrix rows in consecutive registers
+					}
+				}
+
+				if(readMask.size() <= last) readMask.resize(last + 1, 0);
+
+				for(unsigned int r = first; r <= last; r++)
+				{
+					readMask[r] |= components;
+				}
+			}
+		}
+
+		for(const auto &inst : instruction)
+		{
+			if(inst->dst.type == PARAMETER_TEMP && readMask.size() <= inst->dst.index)
+			{
+				readMask.resize(inst->dst.index + 1, 0);
+			}
+		}
+
+		return true;
+	}
+
+	bool Shader::isComponentwise(Opcode opcode)
+	{
+		// Operations of which each result component only depends on the same swizzled component of the sources
+		switch(opcode)
+		{
+		case OPCODE_MOV:
+		case OPCODE_ADD:
+		case OPCODE_SUB:
+		case OPCODE_MAD:
+		case OPCODE_MUL:
+		case OPCODE_MIN:
+		case OPCODE_MAX:
+		case OPCODE_SLT:
+		case OPCODE_SGE:
+		case OPCODE_LRP:
+		case OPCODE_FRC:
+		case OPCODE_SGN:
+		case OPCODE_ABS:
+		case OPCODE_CMP0:
+		case OPCODE_CMP:
+		case OPCODE_DFDX:
+		case OPCODE_DFDY:
+		case OPCODE_FWIDTH:
+		case OPCODE_COS:
+		case OPCODE_SIN:
+		case OPCODE_TAN:
+		case OPCODE_ACOS:
+		case OPCODE_ASIN:
+		case OPCODE_ATAN:
+		case OPCODE_ATAN2:
+		case OPCODE_COSH:
+		case OPCODE_SINH:
+		case OPCODE_TANH:
+		case OPCODE_ACOSH:
+		case OPCODE_ASINH:
+		case OPCODE_ATANH:
+		case OPCODE_TRUNC:
+		case OPCODE_FLOOR:
+		case OPCODE_ROUND:
+		case OPCODE_ROUNDEVEN:
+		case OPCODE_CEIL:
+		case OPCODE_SQRT:
+		case OPCODE_RSQ:
+		case OPCODE_DIV:
+		case OPCODE_MOD:
+		case OPCODE_EXP2:
+		case OPCODE_LOG2:
+		case OPCODE_POW:
+		case OPCODE_F2B:
+		case OPCODE_B2F:
+		case OPCODE_F2I:
+		case OPCODE_I2F:
+		case OPCODE_F2U:
+		case OPCODE_U2F:
+		case OPCODE_I2B:
+		case OPCODE_B2I:
+		case OPCODE_NEG:
+		case OPCODE_NOT:
+		case OPCODE_OR:
+		case OPCODE_XOR:
+		case OPCODE_AND:
+		case OPCODE_EQ:
+		case OPCODE_NE:
+		case OPCODE_STEP:
+		case OPCODE_SMOOTH:
+		case OPCODE_ISNAN:
+		case OPCODE_ISINF:
+		case OPCODE_FLOATBITSTOINT:
+		case OPCODE_FLOATBITSTOUINT:
+		case OPCODE_INTBITSTOFLOAT:
+		case OPCODE_UINTBITSTOFLOAT:
+		case OPCODE_ICMP:
+		case OPCODE_UCMP:
+		case OPCODE_SELECT:
+		case OPCODE_INEG:
+		case OPCODE_IABS:
+		case OPCODE_ISGN:
+		case OPCODE_IADD:
+		case OPCODE_ISUB:
+		case OPCODE_IMUL:
+		case OPCODE_IDIV:
+		case OPCODE_IMAD:
+		case OPCODE_IMOD:
+		case OPCODE_SHL:
+		case OPCODE_ISHR:
+		case OPCODE_IMIN:
+		case OPCODE_IMAX:
+		case OPCODE_UDIV:
+		case OPCODE_UMOD:
+		case OPCODE_USHR:
+		case OPCODE_UMIN:
+		case OPCODE_UMAX:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool Shader::isSideEffectFree(Opcode opcode)
+	{
+		// Operations other than the componentwise ones which only write their destination register
+		switch(opcode)
+		{
+		case OPCODE_RCPX:
+		case OPCODE_RSQX:
+		case OPCODE_DP1:
+		case OPCODE_DP2:
+		case OPCODE_DP2ADD:
+		case OPCODE_DP3:
+		case OPCODE_DP4:
+		case OPCODE_DET2:
+		case OPCODE_DET3:
+		case OPCODE_DET4:
+		case OPCODE_EXP2X:
+		case OPCODE_LOG2X:
+		case OPCODE_EXP:
+		case OPCODE_LOG:
+		case OPCODE_POWX:
+		case OPCODE_CRS:
+		case OPCODE_NRM2:
+		case OPCODE_NRM3:
+		case OPCODE_NRM4:
+		case OPCODE_LEN2:
+		case OPCODE_LEN3:
+		case OPCODE_LEN4:
+		case OPCODE_DIST1:
+		case OPCODE_DIST2:
+		case OPCODE_DIST3:
+		case OPCODE_DIST4:
+		case OPCODE_SINCOS:
+		case OPCODE_M4X4:
+		case OPCODE_M4X3:
+		case OPCODE_M3X4:
+		case OPCODE_M3X3:
+		case OPCODE_M3X2:
+		case OPCODE_ALL:
+		case OPCODE_ANY:
+		case OPCODE_EXTRACT:
+		case OPCODE_INSERT:
+		case OPCODE_FORWARD1:
+		case OPCODE_FORWARD2:
+		case OPCODE_FORWARD3:
+		case OPCODE_FORWARD4:
+		case OPCODE_REFLECT1:
+		case OPCODE_REFLECT2:
+		case OPCODE_REFLECT3:
+		case OPCODE_REFLECT4:
+		case OPCODE_REFRACT1:
+		case OPCODE_REFRACT2:
+		case OPCODE_REFRACT3:
+		case OPCODE_REFRACT4:
+		case OPCODE_PACKSNORM2x16:
+		case OPCODE_PACKUNORM2x16:
+		case OPCODE_PACKHALF2x16:
+		case OPCODE_UNPACKSNORM2x16:
+		case OPCODE_UNPACKUNORM2x16:
+		case OPCODE_UNPACKHALF2x16:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	int Shader::readComponents(const Instruction *instruction, const SourceParameter &src)
+	{
+		// Componentwise operations only read the swizzled components selected by the write mask
+		unsigned int mask = isComponentwise(instruction->opcode) ? instruction->dst.mask : 0xF;
+		int components = 0;
+
+		for(int c = 0; c < 4; c++)
+		{
+			if(mask & (1 << c))
+			{
+				components |= 1 << ((src.swizzle >> (2 * c)) & 0x3);
+			}
+		}
+
+		return components;
+	}
+
+	bool Shader::isSampling(const Instruction *instruction)
+	{
+		// Texture instructions only write their destination register, and take the sampler as the second operand
+		return instruction->src[1].type == PARAMETER_SAMPLER;
+	}
+
+	bool Shader::isSameSample(const Instruction *a, const Instruction *b)
+	{
+		if(!isSampling(b) || a->opcode != b->opcode || a->control != b->control || a->samplerType != b->samplerType)
+		{
+			return false;
+		}
+
+		if(a->dst.saturate != b->dst.saturate || a->dst.partialPrecision != b->dst.partialPrecision || a->dst.shift != b->dst.shift)
+		{
+			return false;
+		}
+
+		for(int k = 0; k < 5; k++)
+		{
+			const SourceParameter &x = a->src[k];
+			const SourceParameter &y = b->src[k];
+
+			if(x.type != y.type || x.swizzle != y.swizzle || x.modifier != y.modifier || x.bufferIndex != y.bufferIndex)
+			{
+				return false;
+			}
+
+			if(x.type == PARAMETER_FLOAT4LITERAL ? memcmp(x.value, y.value, sizeof(x.value)) != 0 : x.index != y.index)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Shader::hoistUniforms()
+	{
+		// Instructions at the top level of main() which only depend on uniforms and literals compute the same
+		// value for every vertex or pixel. They're moved into the prologue, and replaced by reads of its results.
+		for(const Instruction *inst : instruction)
+		{
+			if(inst->opcode == OPCODE_DEF)
+			{
+				return false;   // Constants defined in the shader are substituted at compile time
+			}
+		}
+
+		size_t begin = 0;
+
+		if(instruction.size() >= 2 && instruction[0]->opcode == OPCODE_CALL && instruction[1]->opcode == OPCODE_RET)
+		{
+			begin = instruction.size();
+
+			for(size_t i = 2; i < instruction.size(); i++)
+			{
+				if(instruction[i]->opcode == OPCODE_LABEL && instruction[i]->dst.label == instruction[0]->dst.label)
+				{
+					begin = i + 1;
+					break;
+				}
+			}
+		}
+
+		size_t end = begin;
+
+		while(end < instruction.size() && instruction[end]->opcode != OPCODE_LABEL && instruction[end]->opcode != OPCODE_RET)
+		{
+			end++;
+		}
+
+		size_t limit = end;   // Hoisting stops here
+
+		unsigned int slots = 0;   // Result vectors already stored by the prologue
+		unsigned int temporaries = 0;
+
+		for(const Instruction *inst : prologue)
+		{
+			if(inst->dst.type == PARAMETER_CONST)
+			{
+				slots++;
+			}
+			else if(inst->dst.index + 1 > temporaries)
+			{
+				temporaries = inst->dst.index + 1;
+			}
+		}
+
+		// Only results which are read by the remaining instructions need a constant register. When they
+		// don't all fit, hoisting stops before the first one which doesn't, until the stores do fit.
+		std::vector<Instruction*> copy;
+		std::vector<bool> store;
+
+		while(true)
+		{
+			hoistableCopies(begin, limit, temporaries, copy);
+
+			unsigned int stores = slots;
+			size_t overflow = limit;
+
+			store.assign(instruction.size(), false);
+
+			for(size_t i = begin; i < limit && overflow == limit; i++)
+			{
+				// Copies of uniforms and literals stay, the prologue only tracks their value
+				bool kept = copy[i] && instruction[i]->opcode == OPCODE_MOV && instruction[i]->src[0].type != PARAMETER_TEMP;
+
+				if(copy[i] && !kept && isReadUnhoisted(i, end, copy))
+				{
+					store[i] = true;
+
+					if(++stores > PROLOGUE_UNIFORM_VECTORS)
+					{
+						overflow = i;
+					}
+				}
+			}
+
+			if(overflow == limit)
+			{
+				break;
+			}
+
+			for(Instruction *inst : copy)
+			{
+				delete inst;
+			}
+
+			limit = overflow;
+		}
+
+		bool hoisted = false;
+		std::vector<Instruction*> added;
+
+		for(size_t i = begin; i < limit; i++)
+		{
+			Instruction *inst = instruction[i];
+
+			if(!copy[i])
+			{
+				continue;
+			}
+
+			added.push_back(copy[i]);
+
+			if(inst->opcode == OPCODE_MOV && inst->src[0].type != PARAMETER_TEMP)
+			{
+				continue;
+			}
+
+			if(store[i])
+			{
+				Instruction *result = new Instruction(OPCODE_MOV);
+				result->dst.type = PARAMETER_CONST;
+				result->dst.index = prologueBase() + slots++;
+				result->dst.mask = inst->dst.mask;
+				result->src[0].type = PARAMETER_TEMP;
+				result->src[0].index = copy[i]->dst.index;
+				added.push_back(result);
+
+				inst->opcode = OPCODE_MOV;
+				inst->dst.saturate = false;
+				inst->src[0] = SourceParameter();
+				inst->src[0].type = PARAMETER_CONST;
+				inst->src[0].index = result->dst.index;
+				inst->src[1] = SourceParameter();
+				inst->src[2] = SourceParameter();
+			}
+			else
+			{
+				inst->opcode = OPCODE_NULL;   // Only read by other hoisted instructions
+			}
+
+			hoisted = true;
+		}
+
+		// Copies of uniforms and literals are only needed by hoisted instructions. Shaders which get
+		// optimized again after being copied would otherwise grow their prologue each time.
+		if(hoisted)
+		{
+			prologue.insert(prologue.end(), added.begin(), added.end());
+		}
+		else
+		{
+			for(Instruction *inst : added)
+			{
+				delete inst;
+			}
+		}
+
+		return hoisted;
+	}
+
+	void Shader::hoistableCopies(size_t begin, size_t end, unsigned int temporaries, std::vector<Instruction*> &copy) const
+	{
+		// Copies the instructions of main() in [begin, end) which can be evaluated by the prologue, on renamed temporaries
+		std::vector<unsigned char> uniform;   // Components of each temporary holding a per-draw value
+		std::vector<unsigned int> renamed;    // Prologue temporary holding that value
+		size_t count = prologue.size();
+		int depth = 0;
+
+		copy.assign(instruction.size(), nullptr);
+
+		for(size_t i = begin; i < end; i++)
+		{
+			const Instruction *inst = instruction[i];
+
+			switch(inst->opcode)
+			{
+			case OPCODE_NULL:
+				continue;
+			case OPCODE_CALL:
+			case OPCODE_CALLNZ:
+				uniform.assign(uniform.size(), 0);   // Functions can write any temporary
+				continue;
+			case OPCODE_IF:
+			case OPCODE_IFC:
+			case OPCODE_LOOP:
+			case OPCODE_REP:
+			case OPCODE_WHILE:
+			case OPCODE_SWITCH:
+				depth++;
+				continue;
+			case OPCODE_ENDIF:
+			case OPCODE_ENDLOOP:
+			case OPCODE_ENDREP:
+			case OPCODE_ENDWHILE:
+			case OPCODE_ENDSWITCH:
+				depth--;
+				continue;
+			default:
+				break;
+			}
+
+			if(inst->dst.type != PARAMETER_TEMP)
+			{
+				continue;
+			}
+
+			if(uniform.size() <= inst->dst.index)
+			{
+				uniform.resize(inst->dst.index + 1, 0);
+				renamed.resize(inst->dst.index + 1, 0);
+			}
+
+			// Leave room for storing the results
+			bool candidate = depth == 0 && isPrologueInstruction(inst) && !inst->isPredicated() &&
+			                 count + PROLOGUE_UNIFORM_VECTORS < MAX_PROLOGUE_INSTRUCTIONS &&
+			                 (uniform[inst->dst.index] != 0 || temporaries < MAX_PROLOGUE_TEMPORARIES);
+
+			for(int k = 0; k < 3 && candidate; k++)
+			{
+				const SourceParameter &src = inst->src[k];
+
+				if(src.type == PARAMETER_TEMP)
+				{
+					candidate = src.index < uniform.size() && (readComponents(inst, src) & ~uniform[src.index]) == 0;
+				}
+				else if(src.type == PARAMETER_CONST)
+				{
+					candidate = src.bufferIndex == -1;
+				}
+			}
+
+			if(!candidate)
+			{
+				uniform[inst->dst.index] &= ~inst->dst.mask;
+				continue;
+			}
+
+			if(uniform[inst->dst.index] == 0)
+			{
+				renamed[inst->dst.index] = temporaries++;
+			}
+
+			copy[i] = new Instruction(*inst);
+			copy[i]->dst.index = renamed[inst->dst.index];
+
+			for(int k = 0; k < 3; k++)
+			{
+				if(copy[i]->src[k].type == PARAMETER_TEMP)
+				{
+					copy[i]->src[k].index = renamed[copy[i]->src[k].index];
+				}
+			}
+
+			uniform[inst->dst.index] |= inst->dst.mask;
+			count++;
+		}
+	}
+
+	bool Shader::isReadUnhoisted(size_t i, size_t end, const std::vector<Instruction*> &copy) const
+	{
+		// Whether the result of hoisted instruction i is read by an instruction staying in main(), before being overwritten
+		const unsigned int index = instruction[i]->dst.index;
+		unsigned int remaining = instruction[i]->dst.mask;
+		int depth = 0;
+
+		for(size_t j = i + 1; j < end; j++)
+		{
+			const Instruction *inst = instruction[j];
+
+			switch(inst->opcode)
+			{
+			case OPCODE_NULL:
+				continue;
+			case OPCODE_CALL:
+			case OPCODE_CALLNZ:
+				return true;
+			case OPCODE_IF:
+			case OPCODE_IFC:
+			case OPCODE_LOOP:
+			case OPCODE_REP:
+			case OPCODE_WHILE:
+			case OPCODE_SWITCH:
+				depth++;
+				break;
+			case OPCODE_ENDIF:
+			case OPCODE_ENDLOOP:
+			case OPCODE_ENDREP:
+			case OPCODE_ENDWHILE:
+			case OPCODE_ENDSWITCH:
+				depth--;
+				break;
+			default:
+				break;
+			}
+
+			bool known = isComponentwise(inst->opcode) || isSideEffectFree(inst->opcode);
+
+			if(!copy[j])
+			{
+				if(inst->dst.type == PARAMETER_TEMP && inst->dst.index == index && !known)
+				{
+					return true;   // May read its destination
+				}
+
+				for(int k = 0; k < 5; k++)
+				{
+					const SourceParameter &src = inst->src[k];
+
+					if(src.type == PARAMETER_VOID || src.type == PARAMETER_LABEL || src.type == PARAMETER_FLOAT4LITERAL ||
+					   src.type == PARAMETER_BOOL1LITERAL || src.type == PARAMETER_INT4LITERAL)
+					{
+						continue;
+					}
+
+					if(src.rel.type == PARAMETER_TEMP && src.rel.index == index)
+					{
+						return true;
+					}
+
+					// Matrix rows are in consecutive registers
+					unsigned int last = (k == 1 && inst->opcode >= OPCODE_M4X4 && inst->opcode <= OPCODE_M3X2) ? src.index + 3 : src.index;
+
+					if(src.type == PARAMETER_TEMP && index >= src.index && index <= last && (readComponents(inst, src) & remaining) != 0)
+					{
+						return true;
+					}
+				}
+			}
+
+			if(inst->dst.type == PARAMETER_TEMP && inst->dst.index == index && depth == 0 && known && !inst->isPredicated())
+			{
+				remaining &= ~inst->dst.mask;
+
+				if(remaining == 0)
+				{
+					return false;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool Shader::isPrologueInstruction(const Instruction *instruction)
+	{
+		// Operations for which evaluatePrologue() produces the same bits as the generated code
+		int operands = 0;
+
+		switch(instruction->opcode)
+		{
+		case OPCODE_MOV:
+		case OPCODE_ABS:
+		case OPCODE_NEG:
+			operands = 1;
+			break;
+		case OPCODE_ADD:
+		case OPCODE_SUB:
+		case OPCODE_MUL:
+		case OPCODE_MIN:
+		case OPCODE_MAX:
+		case OPCODE_DP2:
+		case OPCODE_DP3:
+		case OPCODE_DP4:
+			operands = 2;
+			break;
+		case OPCODE_MAD:
+			operands = 3;
+			break;
+		default:
+			return false;
+		}
+
+		const DestinationParameter &dst = instruction->dst;
+
+		if((dst.type != PARAMETER_TEMP && dst.type != PARAMETER_CONST) || dst.shift != 0 || dst.rel.type != PARAMETER_VOID)
+		{
+			return false;
+		}
+
+		for(int k = 0; k < 5; k++)
+		{
+			const SourceParameter &src = instruction->src[k];
+
+			if(k >= operands)
+			{
+				if(src.type != PARAMETER_VOID)
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			if(src.modifier != MODIFIER_NONE && src.modifier != MODIFIER_NEGATE &&
+			   src.modifier != MODIFIER_ABS && src.modifier != MODIFIER_ABS_NEGATE)
+			{
+				return false;
+			}
+
+			if(src.type != PARAMETER_TEMP && src.type != PARAMETER_CONST && src.type != PARAMETER_FLOAT4LITERAL)
+			{
+				return false;
+			}
+
+			if(src.type != PARAMETER_FLOAT4LITERAL && src.rel.type != PARAMETER_VOID)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	unsigned int Shader::prologueBase() const
+	{
+		// Vertex shaders read c[VERTEX_UNIFORM_VECTORS] as zero for out of range indices
+		return (shaderType == SHADER_PIXEL) ? FRAGMENT_UNIFORM_VECTORS : VERTEX_UNIFORM_VECTORS + 1;
+	}
+
+	bool Shader::isValidInstruction(const Instruction *instruction) const
+	{
+		Opcode opcode = instruction->opcode;
+
+		bool known = (opcode <= OPCODE_DEFI) ||
+		             (opcode >= OPCODE_TEXCOORD && opcode <= OPCODE_BREAKP) ||
+		             (opcode >= OPCODE_NULL && opcode <= OPCODE_UMAX) ||
+		             (opcode == OPCODE_END);
+
+		if(!known || instruction->control > CONTROL_RESERVED1)
+		{
+			return false;
+		}
+
+		// Calls and labels index the label tables, and every other instruction must not
+		bool labeled = instruction->isCall() || opcode == OPCODE_LABEL;
+
+		if(labeled != (instruction->dst.type == PARAMETER_LABEL) || !isValidParameter(instruction->dst, -1, 1))
+		{
+			return false;
+		}
+
+		for(int i = 0; i < 5; i++)
+		{
+			const SourceParameter &src = instruction->src[i];
+			unsigned int rows = 1;
+
+			if(i == 1)   // Matrix rows are read from consecutive registers
+			{
+				switch(opcode)
+				{
+				case OPCODE_M3X2: rows = 2; break;
+				case OPCODE_M3X3: rows = 3; break;
+				case OPCODE_M3X4: rows = 4; break;
+				case OPCODE_M4X3: rows = 3; break;
+				case OPCODE_M4X4: rows = 4; break;
+				default:                    break;
+				}
+			}
+
+			if(src.type == PARAMETER_LABEL || src.modifier > MODIFIER_NOT ||
+			   src.bufferIndex < -1 || src.bufferIndex >= MAX_UNIFORM_BUFFER_BINDINGS ||
+			   !isValidParameter(src, src.bufferIndex, rows))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Shader::isValidParameter(const Parameter &parameter, int bufferIndex, unsigned int rows) const
+	{
+		switch(parameter.type)
+		{
+		case PARAMETER_VOID:
+		case PARAMETER_FLOAT4LITERAL:
+		case PARAMETER_BOOL1LITERAL:
+		case PARAMETER_INT4LITERAL:
+			return true;
+		case PARAMETER_LABEL:
+			return parameter.label < MAX_LABELS;
+		default:
+			break;
+		}
+
+		// Uniform buffer members are addressed by their byte offset instead
+		unsigned int count = (parameter.type == PARAMETER_CONST && bufferIndex != -1) ? MAX_UNIFORM_BLOCK_SIZE : registerCount(parameter.type);
+
+		if(parameter.index >= count || count - parameter.index < rows)
+		{
+			return false;
+		}
+
+		if(parameter.rel.type != PARAMETER_VOID)
+		{
+			unsigned int relativeCount = (parameter.rel.type == PARAMETER_CONST && bufferIndex != -1) ? MAX_UNIFORM_BLOCK_SIZE : registerCount(parameter.rel.type);
+
+			if(parameter.rel.index >= relativeCount)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	unsigned int Shader::registerCount(ParameterType type) const
+	{
+		switch(type)
+		{
+		case PARAMETER_TEMP:      return NUM_TEMPORARY_REGISTERS;
+		case PARAMETER_CONST:     return prologueBase() + PROLOGUE_UNIFORM_VECTORS;
+		case PARAMETER_CONSTINT:  return 16;   // DrawData's integer and boolean registers
+		case PARAMETER_CONSTBOOL: return 16;
+		case PARAMETER_LOOP:      return 1;
+		case PARAMETER_PREDICATE: return 1;
+		default:                  return 0;
+		}
+	}
+
+	bool Shader::hasPrologue() const
+	{
+		return !prologue.empty();
+	}
+
+	unsigned int Shader::specializeConstants(const float4 *c, int threshold, unsigned int value[MAX_SPECIALIZED_UNIFORMS]) const
+	{
+		unsigned int bits[MAX_SPECIALIZED_UNIFORMS];
+
+		for(size_t k = 0; k < specializable.size(); k++)
+		{
+			memcpy(&bits[k], &c[specializable[k] / 4][specializable[k] % 4], sizeof(bits[k]));
+		}
+
+		specializationMutex.lock();
+
+		bool changed = false;
+
+		for(size_t k = 0; k < specializable.size(); k++)
+		{
+			if(bits[k] != specializableValue[k])
+			{
+				// Uniforms which change faster than the threshold would only churn the routine cache
+				if(specializableDraws[k] < threshold)
+				{
+					volatileConstants |= 1 << k;
+				}
+
+				changed = changed || !(volatileConstants & (1 << k));
+				specializableValue[k] = bits[k];
+				specializableDraws[k] = 0;
+			}
+			else if(specializableDraws[k] < threshold)
+			{
+				specializableDraws[k]++;
+			}
+		}
+
+		// Specialize on all the stable uniforms at once, to create a single routine per combination
+		if(changed)
+		{
+			stableDraws = 0;
+		}
+		else if(stableDraws < threshold)
+		{
+			stableDraws++;
+		}
+
+		unsigned int mask = 0;
+
+		if(stableDraws >= threshold)
+		{
+			for(size_t k = 0; k < specializable.size(); k++)
+			{
+				if(!(volatileConstants & (1 << k)))
+				{
+					mask |= 1 << k;
+					value[k] = bits[k];   // What this draw's constants hold, not another context's
+				}
+			}
+		}
+
+		specializationMutex.unlock();
+
+		return mask;
+	}
+
+	unsigned int Shader::getSpecializableConstant(int k) const
+	{
+		return specializable[k];
+	}
+
+	void Shader::evaluatePrologue(float4 *c) const
+	{
+		float4 r[MAX_PROLOGUE_TEMPORARIES];
+
+		for(const Instruction *inst : prologue)
+		{
+			float4 s[3];
+
+			for(int k = 0; k < 3; k++)
+			{
+				const SourceParameter &src = inst->src[k];
+				float4 v = {0.0f, 0.0f, 0.0f, 0.0f};
+
+				switch(src.type)
+				{
+				case PARAMETER_TEMP:          v = r[src.index];                  break;
+				case PARAMETER_CONST:         v = c[src.index];                  break;
+				case PARAMETER_FLOAT4LITERAL: memcpy(&v, src.value, sizeof(v));  break;
+				default:                                                         break;
+				}
+
+				for(int i = 0; i < 4; i++)
+				{
+					float x = v[(src.swizzle >> (2 * i)) & 0x3];
+
+					switch(src.modifier)
+					{
+					case MODIFIER_NEGATE:     x = -x;             break;
+					case MODIFIER_ABS:        x = fabsf(x);       break;
+					case MODIFIER_ABS_NEGATE: x = -fabsf(x);      break;
+					default:                                      break;
+					}
+
+					s[k][i] = x;
+				}
+			}
+
+			float4 d;
+			float dot = 0.0f;
+			int terms = (inst->opcode == OPCODE_DP2) ? 2 : (inst->opcode == OPCODE_DP3) ? 3 : 4;
+
+			for(int i = 0; i < terms; i++)
+			{
+				// Summed in the same order as the generated code, and kept in separate statements so it can't be contracted
+				float product = s[0][i] * s[1][i];
+				dot = (i == 0) ? product : dot + product;
+			}
+
+			for(int i = 0; i < 4; i++)
+			{
+				float x = s[0][i];
+				float y = s[1][i];
+
+				switch(inst->opcode)
+				{
+				case OPCODE_MOV: d[i] = x;                    break;
+				case OPCODE_ABS: d[i] = fabsf(x);             break;
+				case OPCODE_NEG: d[i] = -x;                   break;
+				case OPCODE_ADD: d[i] = x + y;                break;
+				case OPCODE_SUB: d[i] = x - y;                break;
+				case OPCODE_MUL: d[i] = x * y;                break;
+				case OPCODE_MAD: d[i] = x * y; d[i] = d[i] + s[2][i]; break;   // Not fused, like the generated code
+				case OPCODE_MIN: d[i] = (x < y) ? x : y;      break;   // minps semantics for NaN
+				case OPCODE_MAX: d[i] = (x > y) ? x : y;      break;
+				case OPCODE_DP2:
+				case OPCODE_DP3:
+				case OPCODE_DP4: d[i] = dot;                  break;
+				default: ASSERT(false); d[i] = 0.0f;
+				}
+
+				if(inst->dst.saturate)
+				{
+					d[i] = (d[i] > 0.0f) ? d[i] : 0.0f;
+					d[i] = (d[i] < 1.0f) ? d[i] : 1.0f;
+				}
+			}
+
+			float4 &dst = (inst->dst.type == PARAMETER_TEMP) ? r[inst->dst.index] : c[inst->dst.index];
+
+			for(int i = 0; i < 4; i++)
+			{
+				if(inst->dst.mask & (1 << i))
+				{
+					dst[i] = d[i];
+				}
+			}
+		}
+	}
+
+	void Shader::removeNull()
+	{
+		size_t size = 0;
+		for(size_t i = 0; i < instruction.size(); i++)
+		{
+			if(instruction[i]->opcode != OPCODE_NULL)
+			{
+				instruction[size] = instruction[i];
+				size++;
+			}
+			else
+			{
+				delete instruction[i];
+			}
+		}
+
+		instruction.resize(size);
+	}
+
+	void Shader::analyzeDirtyConstants()
+	{
+		dirtyConstantsF = 0;
+		dirtyConstantsI = 0;
+		dirtyConstantsB = 0;
+
+		analyzeDefinitions();
+
+		for(const Instruction *inst : definitions)
+		{
+			switch(inst->opcode)
+			{
+			case OPCODE_DEF:
+				if(inst->dst.index + 1 > dirtyConstantsF)
+				{
+					dirtyConstantsF = inst->dst.index + 1;
+				}
+				break;
+			case OPCODE_DEFI:
+				if(inst->dst.index + 1 > dirtyConstantsI)
+				{
+					dirtyConstantsI = inst->dst.index + 1;
+				}
+				break;
+			case OPCODE_DEFB:
+				if(inst->dst.index + 1 > dirtyConstantsB)
+				{
+					dirtyConstantsB = inst->dst.index + 1;
+				}
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	void Shader::analyzeDefinitions()
+	{
+		definitions.clear();
+
+		for(const Instruction *inst : instruction)
+		{
+			if(inst->opcode == OPCODE_DEF || inst->opcode == OPCODE_DEFI || inst->opcode == OPCODE_DEFB)
+			{
+				definitions.push_back(inst);
+			}
+		}
+	}
+
+	void Shader::analyzeDynamicBranching()
+	{
+		dynamicBranching = false;
+		containsLeave = false;
+		containsBreak = false;
+		containsContinue = false;
+		containsDefine = false;
+
+		// Determine global presence of branching instructions
+		for(const auto &inst : instruction)
+		{
+			switch(inst->opcode)
+			{
+			case OPCODE_CALLNZ:
+			case OPCODE_IF:
+			case OPCODE_IFC:
+			case OPCODE_BREAK:
+			case OPCODE_BREAKC:
+			case OPCODE_CMP:
+			case OPCODE_BREAKP:
+			case OPCODE_LEAVE:
+			case OPCODE_CONTINUE:
+				if(inst->src[0].type != PARAMETER_CONSTBOOL)
+				{
+					dynamicBranching = true;
+				}
+
+				if(inst->opcode == OPCODE_LEAVE)
+				{
+					containsLeave = true;
+				}
+
+				if(inst->isBreak())
+				{
+					containsBreak = true;
+				}
+
+				if(inst->opcode == OPCODE_CONTINUE)
 				{
 					containsContinue = true;
 				}
@@ -1681,15 +3457,37 @@ namespace sw
 		int continueDepth = 0;
 		bool leaveReturn = false;
 		unsigned int functionBegin = 0;
+		std::vector<bool> uniformBranch;   // Nested if statements which don't mask execution
 
 		for(unsigned int i = 0; i < instruction.size(); i++)
 		{
 			// If statements and loops
-			if(instruction[i]->isBranch() || instruction[i]->isLoop())
+			if(instruction[i]->isBranch())
+			{
+				uniformBranch.push_back(instruction[i]->analysisUniform);
+
+				if(!instruction[i]->analysisUniform)
+				{
+					branchDepth++;
+				}
+			}
+			else if(instruction[i]->isLoop())
 			{
 				branchDepth++;
 			}
-			else if(instruction[i]->opcode == OPCODE_ENDIF || instruction[i]->isEndLoop())
+			else if(instruction[i]->opcode == OPCODE_ENDIF)
+			{
+				if(uniformBranch.empty() || !uniformBranch.back())
+				{
+					branchDepth--;
+				}
+
+				if(!uniformBranch.empty())
+				{
+					uniformBranch.pop_back();
+				}
+			}
+			else if(instruction[i]->isEndLoop())
 			{
 				branchDepth--;
 			}
@@ -1794,6 +3592,80 @@ namespace sw
 		}
 	}
 
+	void Shader::analyzeSpecializableConstants()
+	{
+		// Uniform components which are compared or branched on directly, typically feature switches
+		specializable.clear();
+
+		for(const auto &inst : instruction)
+		{
+			int components[5] = {0, 0, 0, 0, 0};   // Read components of each source, as a bit mask
+
+			switch(inst->opcode)
+			{
+			case OPCODE_IF:
+			case OPCODE_CALLNZ:
+				components[0] = 1 << (inst->src[0].swizzle & 0x3);
+				break;
+			case OPCODE_IFC:
+			case OPCODE_BREAKC:
+				components[0] = 1 << (inst->src[0].swizzle & 0x3);
+				components[1] = 1 << (inst->src[1].swizzle & 0x3);
+				break;
+			case OPCODE_CMP:
+			case OPCODE_ICMP:
+			case OPCODE_UCMP:
+			case OPCODE_EQ:
+			case OPCODE_NE:
+				for(int j = 0; j < 2; j++)
+				{
+					for(int c = 0; c < 4; c++)
+					{
+						if(inst->dst.mask & (1 << c))
+						{
+							components[j] |= 1 << ((inst->src[j].swizzle >> (2 * c)) & 0x3);
+						}
+					}
+				}
+				break;
+			default:
+				break;
+			}
+
+			for(int j = 0; j < 5; j++)
+			{
+				const SourceParameter &src = inst->src[j];
+
+				// Values computed by the prologue aren't known when the routine is selected
+				if(!components[j] || src.type != PARAMETER_CONST || src.rel.type != PARAMETER_VOID ||
+				   src.bufferIndex != -1 || src.index >= prologueBase())
+				{
+					continue;
+				}
+
+				for(int c = 0; c < 4; c++)
+				{
+					unsigned int constant = src.index * 4 + c;
+
+					if((components[j] & (1 << c)) && specializable.size() < MAX_SPECIALIZED_UNIFORMS &&
+					   std::find(specializable.begin(), specializable.end(), constant) == specializable.end())
+					{
+						specializable.push_back(constant);
+					}
+				}
+			}
+		}
+
+		for(int k = 0; k < MAX_SPECIALIZED_UNIFORMS; k++)
+		{
+			specializableValue[k] = 0;
+			specializableDraws[k] = INT_MAX;   // The first change doesn't make it volatile
+		}
+
+		volatileConstants = 0;
+		stableDraws = 0;
+	}
+
 	void Shader::markFunctionAnalysis(unsigned int functionLabel, Analysis flag)
 	{
 		bool marker = false;
@@ -1877,7 +3749,7 @@ namespace sw
 	// This is used to know what basic block to return to.
 	void Shader::analyzeCallSites()
 	{
-		int callSiteIndex[2048] = {0};
+		int callSiteIndex[MAX_LABELS] = {0};
 
 		for(auto &inst : instruction)
 		{
@@ -1896,6 +3768,8 @@ namespace sw
 		indirectAddressableInput = false;
 		indirectAddressableOutput = false;
 
+		bool undeclaredIndexing = false;   // Temporaries indexed outside of the declared range
+
 		for(const auto &inst : instruction)
 		{
 			if(inst->dst.rel.type != PARAMETER_VOID)
@@ -1907,6 +3781,11 @@ namespace sw
 				case PARAMETER_OUTPUT: indirectAddressableOutput = true;      break;
 				default: break;
 				}
+
+				if(inst->dst.type == PARAMETER_TEMP && (inst->dst.index < indexedTemporariesBegin || inst->dst.index >= indexedTemporariesEnd))
+				{
+					undeclaredIndexing = true;
+				}
 			}
 
 			for(int j = 0; j < 3; j++)
@@ -1920,8 +3799,24 @@ namespace sw
 					case PARAMETER_OUTPUT: indirectAddressableOutput = true;      break;
 					default: break;
 					}
+
+					if(inst->src[j].type == PARAMETER_TEMP && (inst->src[j].index < indexedTemporariesBegin || inst->src[j].index >= indexedTemporariesEnd))
+					{
+						undeclaredIndexing = true;
+					}
 				}
 			}
 		}
+
+		if(!indirectAddressableTemporaries)
+		{
+			indexedTemporariesBegin = 0;
+			indexedTemporariesEnd = 0;
+		}
+		else if(undeclaredIndexing)
+		{
+			indexedTemporariesBegin = 0;
+			indexedTemporariesEnd = NUM_TEMPORARY_REGISTERS;
+		}
 	}
 }
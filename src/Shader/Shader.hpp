@@ -15,7 +15,10 @@
 #ifndef sw_Shader_hpp
 #define sw_Shader_hpp
 
+#include "Main/Config.hpp"
 #include "Common/Types.hpp"
+#include "Common/Thread.hpp"
+#include "Common/MutexLock.hpp"
 
 #include <string>
 #include <vector>
@@ -394,6 +397,9 @@ namespace sw
 			ANALYSIS_BREAK    = 0x00000002,
 			ANALYSIS_CONTINUE = 0x00000004,
 			ANALYSIS_LEAVE    = 0x00000008,
+
+			// Flag indicating a branch condition has the same value for all pixels of a quad
+			ANALYSIS_UNIFORM  = 0x00000010,
 		};
 
 		struct Relative
@@ -458,7 +464,7 @@ namespace sw
 				};
 			};
 
-			DestinationParameter() : mask(0xF), saturate(false), partialPrecision(false), centroid(false), shift(0)
+			DestinationParameter() : mask(0xF), saturate(false), partialPrecision(false), centroid(false), mediumPrecision(false), shift(0)
 			{
 			}
 
@@ -469,6 +475,7 @@ namespace sw
 			bool saturate         : 1;
 			bool partialPrecision : 1;
 			bool centroid         : 1;
+			bool mediumPrecision  : 1;   // GLSL mediump, transcendentals only need 2^-10 relative precision
 			signed char shift     : 4;
 		};
 
@@ -549,6 +556,7 @@ namespace sw
 					unsigned int analysisBreak : 1;
 					unsigned int analysisContinue : 1;
 					unsigned int analysisLeave : 1;
+					unsigned int analysisUniform : 1;
 				};
 			};
 		};
@@ -558,12 +566,17 @@ namespace sw
 		virtual ~Shader();
 
 		int getSerialID() const;
+		uint64_t getFingerprint() const;   // Identifies the contents across processes, unlike the serial ID
+		virtual void serialize(std::vector<unsigned int> &data) const;
+		virtual bool deserialize(const unsigned int *&data, const unsigned int *end);   // Into an empty shader of the same type
 		size_t getLength() const;
 		ShaderType getShaderType() const;
 		unsigned short getShaderModel() const;
 
 		void append(Instruction *instruction);
 		void declareSampler(int i);
+		void declareIndexedTemporaries(int first, int count);
+		void disableOptimization() { optimization = false; }   // Keeps the instructions as written, for #pragma optimize(off)
 
 		const Instruction *getInstruction(size_t i) const;
 		int size(unsigned long opcode) const;
@@ -583,6 +596,10 @@ namespace sw
 		bool containsDefineInstruction() const;
 		bool usesSampler(int i) const;
 
+		// The DEF, DEFI and DEFB instructions in program order, gathered once instead of searched for on each use
+		const std::vector<const Instruction*> &getDefinitions() const;
+		const Instruction *getDefinition(unsigned int index) const;   // First DEF of float register 'index', if any
+
 		struct Semantic
 		{
 			Semantic(unsigned char usage = 0xFF, unsigned char index = 0xFF, bool flat = false) : usage(usage), index(index), centroid(false), flat(flat)
@@ -599,6 +616,19 @@ namespace sw
 				return usage != 0xFF;
 			}
 
+			unsigned int pack() const
+			{
+				return usage | index << 8 | centroid << 16 | flat << 17;
+			}
+
+			static Semantic unpack(unsigned int word)
+			{
+				Semantic semantic(word & 0xFF, (word >> 8) & 0xFF, (word & 0x20000) != 0);
+				semantic.centroid = (word & 0x10000) != 0;
+
+				return semantic;
+			}
+
 			unsigned char usage;
 			unsigned char index;
 			bool centroid;
@@ -607,6 +637,16 @@ namespace sw
 
 		void optimize();
 
+		// Evaluates the instructions hoisted out of the shader for being the same for every vertex or pixel,
+		// storing their results into the extra constant registers which follow the uniform vectors
+		void evaluatePrologue(float4 *c) const;
+		bool hasPrologue() const;
+
+		// Returns a mask of the uniform components controlling branches which kept their value for at least
+		// 'threshold' draws, and their bits, so a routine can be specialized on them
+		unsigned int specializeConstants(const float4 *c, int threshold, unsigned int value[MAX_SPECIALIZED_UNIFORMS]) const;
+		unsigned int getSpecializableConstant(int k) const;   // Register index times four plus component
+
 		// FIXME: Private
 		unsigned int dirtyConstantsF;
 		unsigned int dirtyConstantsI;
@@ -616,18 +656,45 @@ namespace sw
 		bool indirectAddressableInput;
 		bool indirectAddressableOutput;
 
+		// Range of temporaries which can be indexed dynamically, and have to be kept in memory
+		unsigned int indexedTemporariesBegin;
+		unsigned int indexedTemporariesEnd;
+
 	protected:
 		void parse(const unsigned long *token);
 
 		void optimizeLeave();
 		void optimizeCall();
+		bool propagateCopies();
+		bool foldConstants();
+		bool eliminateDeadWrites();
+		bool eliminateRedundantSamples();
+		bool hoistUniforms();
+		void hoistableCopies(size_t begin, size_t end, unsigned int temporaries, std::vector<Instruction*> &copy) const;
+		bool isReadUnhoisted(size_t i, size_t end, const std::vector<Instruction*> &copy) const;
+		bool analyzeTemporaryReads(std::vector<unsigned char> &readMask) const;
 		void removeNull();
 
+		static bool isComponentwise(Opcode opcode);
+		static bool isSideEffectFree(Opcode opcode);
+		static int readComponents(const Instruction *instruction, const SourceParameter &src);
+		static bool isSampling(const Instruction *instruction);
+		static bool isSameSample(const Instruction *a, const Instruction *b);
+		static bool isPrologueInstruction(const Instruction *instruction);
+		unsigned int prologueBase() const;
+
+		// Checks that a deserialized instruction only addresses registers the program generators have storage for
+		bool isValidInstruction(const Instruction *instruction) const;
+		bool isValidParameter(const Parameter &parameter, int bufferIndex, unsigned int rows) const;
+		virtual unsigned int registerCount(ParameterType type) const;   // Zero for register types this shader type lacks
+
 		void analyzeDirtyConstants();
+		void analyzeDefinitions();
 		void analyzeDynamicBranching();
 		void analyzeSamplers();
 		void analyzeCallSites();
 		void analyzeIndirectAddressing();
+		void analyzeSpecializableConstants();
 		void markFunctionAnalysis(unsigned int functionLabel, Analysis flag);
 
 		ShaderType shaderType;
@@ -644,18 +711,40 @@ namespace sw
 		};
 
 		std::vector<Instruction*> instruction;
+		std::vector<Instruction*> prologue;   // Evaluated once per draw, on densely numbered temporaries
+
+		enum
+		{
+			MAX_PROLOGUE_INSTRUCTIONS = 8 * PROLOGUE_UNIFORM_VECTORS,
+			MAX_PROLOGUE_TEMPORARIES = MAX_PROLOGUE_INSTRUCTIONS,
+			MAX_LABELS = 2048   // Size of the program generators' label tables
+		};
+
+		std::vector<unsigned int> specializable;   // Register index times four plus component
+
+		// Draws since each specializable constant last changed value, and since any of the stable ones did.
+		// Contexts sharing the shader draw with it concurrently, so this history is guarded by specializationMutex.
+		mutable MutexLock specializationMutex;
+		mutable unsigned int specializableValue[MAX_SPECIALIZED_UNIFORMS];
+		mutable int specializableDraws[MAX_SPECIALIZED_UNIFORMS];
+		mutable unsigned int volatileConstants;   // Changed within fewer draws than the threshold
+		mutable int stableDraws;
 
 		unsigned short usedSamplers;   // Bit flags
+		size_t unoptimizedLength;      // Instruction count before optimize(), zero if not optimized
+		bool optimization;             // Whether optimize() transforms the data flow
 
 	private:
 		const int serialID;
-		static volatile int serialCounter;
+		static AtomicInt serialCounter;   // Shaders are also compiled on background threads
 
 		bool dynamicBranching;
 		bool containsBreak;
 		bool containsContinue;
 		bool containsLeave;
 		bool containsDefine;
+
+		std::vector<const Instruction*> definitions;
 	};
 }
 
@@ -130,6 +130,18 @@ namespace sw
 		// For the fractional part use a polynomial
 		// which approximates 2^f in the 0 to 1 range.
 		Float4 f = x0 - Float4(i);
+
+		if(pp)
+		{
+			// Cubic minimax polynomial, relative error below 2^-13
+			Float4 ff = Float4(7.8024521e-2f);
+			ff = ff * f + Float4(2.2606716e-1f);
+			ff = ff * f + Float4(6.9583356e-1f);
+			ff = ff * f + Float4(9.9992520e-1f);
+
+			return ii * ff;
+		}
+
 		Float4 ff = As<Float4>(Int4(0x3AF61905));     // 1.8775767e-3f
 		ff = ff * f + As<Float4>(Int4(0x3C134806));   // 8.9893397e-3f
 		ff = ff * f + As<Float4>(Int4(0x3D64AA23));   // 5.5826318e-2f
@@ -149,6 +161,21 @@ namespace sw
 
 		x0 = x;
 
+		if(pp)
+		{
+			// log2(2^e * (1 + t)) = e + t * p(t), without the rational approximation's division or
+			// special cases for infinity. Absolute error below 2^-13.
+			Float4 e = Float4(As<Int4>(As<UInt4>(As<Int4>(x0) & Int4(0x7F800000)) >> 23) - Int4(127));
+			Float4 t = As<Float4>((As<Int4>(x0) & Int4(0x007FFFFF)) | As<Int4>(Float4(1.0f))) - Float4(1.0f);
+
+			Float4 p = Float4(-8.4768698e-2f);
+			p = p * t + Float4(3.2559577e-1f);
+			p = p * t + Float4(-6.7994410e-1f);
+			p = p * t + Float4(1.4390147e+0f);
+
+			return e + t * p;
+		}
+
 		x1 = As<Float4>(As<Int4>(x0) & Int4(0x7F800000));
 		x1 = As<Float4>(As<UInt4>(x1) >> 8);
 		x1 = As<Float4>(As<Int4>(x1) | As<Int4>(Float4(1.0f)));
@@ -276,12 +303,27 @@ namespace sw
 		return sine_pi(y, pp);
 	}
 
-	Float4 sine(RValue<Float4> x, bool pp)
+	Float4 sine(RValue<Float4> x, bool pp, bool mp)
 	{
 		// Reduce to [-0.5, 0.5] range
 		Float4 y = x * Float4(1.59154943e-1f);   // 1/2pi
 		y = y - Round(y);
 
+		if(!pp && mp)
+		{
+			// Fold into [-0.25, 0.25] using sin(pi - x) = sin(x), and evaluate
+			// an odd quintic minimax polynomial. Absolute error below 2^-13.
+			Float4 z = Float4(0.25f) - Abs(Abs(y) - Float4(0.25f));
+			z = As<Float4>(As<Int4>(z) | (As<Int4>(y) & Int4(0x80000000)));
+
+			Float4 z2 = z * z;
+			Float4 p = Float4(7.3585518e+1f);
+			p = p * z2 + Float4(-4.1095242e+1f);
+			p = p * z2 + Float4(6.2812800e+0f);
+
+			return z * p;
+		}
+
 		if(!pp)
 		{
 			// From the paper: "A Fast, Vectorizable Algorithm for Producing Single-Precision Sine-Cosine Pairs"
@@ -314,11 +356,11 @@ namespace sw
 		return sin;
 	}
 
-	Float4 cosine(RValue<Float4> x, bool pp)
+	Float4 cosine(RValue<Float4> x, bool pp, bool mp)
 	{
 		// cos(x) = sin(x + pi/2)
 		Float4 y = x + Float4(1.57079632e+0f);
-		return sine(y, pp);
+		return sine(y, pp, mp);
 	}
 
 	Float4 tangent(RValue<Float4> x, bool pp)
@@ -560,14 +602,127 @@ namespace sw
 		}
 	}
 
+	Float4 halfToFloat(RValue<Int4> halfBits)
+	{
+		// Same results as sw::half, which has no infinity or NaN encodings
+		Int4 h = halfBits;
+		Int4 sign = (h & Int4(0x8000)) << 16;
+		Int4 magnitude = h & Int4(0x7FFF);
+		Int4 normal = (magnitude << 13) + Int4((127 - 15) << 23);
+		Int4 denormal = As<Int4>(Float4(magnitude) * Float4(1.0f / 0x01000000));   // Exact for 10-bit mantissas
+		Int4 isDenormal = CmpLT(magnitude, Int4(0x0400));
+
+		return As<Float4>(sign | (isDenormal & denormal) | (~isDenormal & normal));
+	}
+
+	Int4 floatToHalf(RValue<Float4> value)
+	{
+		// Same results as sw::half, which clamps to the largest magnitude instead of encoding infinity or NaN
+		UInt4 f = As<UInt4>(value);
+		UInt4 sign = (f >> 16) & UInt4(0x8000);
+		UInt4 magnitude = f & UInt4(0x7FFFFFFF);
+		UInt4 normal = magnitude + UInt4(0xC8000000);   // Rebias the exponent
+		UInt4 shift = Min(UInt4(113) - (magnitude >> 23), UInt4(24));   // Only used for denormals
+		UInt4 denormal = ((magnitude & UInt4(0x007FFFFF)) | UInt4(0x00800000)) >> shift;
+		UInt4 isDenormal = CmpLT(magnitude, UInt4(0x38800000));
+		UInt4 isInfinity = CmpNLE(magnitude, UInt4(0x47FFEFFF));
+
+		UInt4 bits = (isDenormal & denormal) | (~isDenormal & normal);
+		bits = (bits + UInt4(0x00000FFF) + ((bits >> 13) & UInt4(1))) >> 13;   // Round to nearest even
+
+		return As<Int4>(sign | (isInfinity & UInt4(0x7FFF)) | (~isInfinity & bits));
+	}
+
+	RegisterFile::RegisterFile(int size, bool indirectAddressable) : RegisterFile(size, 0, indirectAddressable ? size : 0)
+	{
+	}
+
+	RegisterFile::RegisterFile(int size, int indexedBegin, int indexedEnd)
+		: size(size), indexedBegin(indexedBegin), indexedEnd(indexedEnd), x(nullptr), y(nullptr), z(nullptr), w(nullptr), variable(4 * size, nullptr)
+	{
+		ASSERT(indexedBegin >= 0 && indexedBegin <= indexedEnd && indexedEnd <= size);
+
+		if(indexedEnd > indexedBegin)
+		{
+			x = new Array<Float4>(indexedEnd - indexedBegin);
+			y = new Array<Float4>(indexedEnd - indexedBegin);
+			z = new Array<Float4>(indexedEnd - indexedBegin);
+			w = new Array<Float4>(indexedEnd - indexedBegin);
+		}
+	}
+
+	RegisterFile::~RegisterFile()
+	{
+		delete x;
+		delete y;
+		delete z;
+		delete w;
+
+		for(auto &v : variable)
+		{
+			delete v;
+		}
+	}
+
+	Register RegisterFile::operator[](int i)
+	{
+		ASSERT(i >= 0 && i < size);
+
+		if(i >= indexedBegin && i < indexedEnd)
+		{
+			return Register(x[0][i - indexedBegin], y[0][i - indexedBegin], z[0][i - indexedBegin], w[0][i - indexedBegin]);
+		}
+
+		if(!variable[4 * i])
+		{
+			for(int c = 0; c < 4; c++)
+			{
+				variable[4 * i + c] = new Array<Float4>();
+			}
+		}
+
+		return Register(variable[4 * i + 0][0][0], variable[4 * i + 1][0][0], variable[4 * i + 2][0][0], variable[4 * i + 3][0][0]);
+	}
+
+	Register RegisterFile::operator[](RValue<Int> i)
+	{
+		ASSERT(x);
+
+		Int index = arrayIndex(i);
+
+		return Register(x[0][index], y[0][index], z[0][index], w[0][index]);
+	}
+
+	Int RegisterFile::arrayIndex(RValue<Int> i)
+	{
+		if(indexedBegin == 0 && indexedEnd == size)
+		{
+			return i;
+		}
+
+		// Neighboring registers aren't in the array, so keep out-of-bounds indices within it
+		return Min(Max(i - Int(indexedBegin), Int(0)), Int(indexedEnd - indexedBegin - 1));
+	}
+
+	Int4 RegisterFile::arrayIndex(RValue<Int4> i)
+	{
+		if(indexedBegin == 0 && indexedEnd == size)
+		{
+			return i;
+		}
+
+		return Min(Max(i - Int4(indexedBegin), Int4(0)), Int4(indexedEnd - indexedBegin - 1));
+	}
+
 	const Vector4f RegisterFile::operator[](RValue<Int4> index)
 	{
-		ASSERT(indirectAddressable);
+		ASSERT(x);
 
-		Int index0 = Extract(index, 0);
-		Int index1 = Extract(index, 1);
-		Int index2 = Extract(index, 2);
-		Int index3 = Extract(index, 3);
+		Int4 element = arrayIndex(index);
+		Int index0 = Extract(element, 0);
+		Int index1 = Extract(element, 1);
+		Int index2 = Extract(element, 2);
+		Int index3 = Extract(element, 3);
 
 		Vector4f r;
 
@@ -596,12 +751,13 @@ namespace sw
 
 	void RegisterFile::scatter_x(Int4 index, RValue<Float4> r)
 	{
-		ASSERT(indirectAddressable);
+		ASSERT(x);
 
-		Int index0 = Extract(index, 0);
-		Int index1 = Extract(index, 1);
-		Int index2 = Extract(index, 2);
-		Int index3 = Extract(index, 3);
+		Int4 element = arrayIndex(index);
+		Int index0 = Extract(element, 0);
+		Int index1 = Extract(element, 1);
+		Int index2 = Extract(element, 2);
+		Int index3 = Extract(element, 3);
 
 		x[0][index0] = Insert(x[0][index0], Extract(r, 0), 0);
 		x[0][index1] = Insert(x[0][index1], Extract(r, 1), 1);
@@ -611,12 +767,13 @@ namespace sw
 
 	void RegisterFile::scatter_y(Int4 index, RValue<Float4> r)
 	{
-		ASSERT(indirectAddressable);
+		ASSERT(x);
 
-		Int index0 = Extract(index, 0);
-		Int index1 = Extract(index, 1);
-		Int index2 = Extract(index, 2);
-		Int index3 = Extract(index, 3);
+		Int4 element = arrayIndex(index);
+		Int index0 = Extract(element, 0);
+		Int index1 = Extract(element, 1);
+		Int index2 = Extract(element, 2);
+		Int index3 = Extract(element, 3);
 
 		y[0][index0] = Insert(y[0][index0], Extract(r, 0), 0);
 		y[0][index1] = Insert(y[0][index1], Extract(r, 1), 1);
@@ -626,12 +783,13 @@ namespace sw
 
 	void RegisterFile::scatter_z(Int4 index, RValue<Float4> r)
 	{
-		ASSERT(indirectAddressable);
+		ASSERT(x);
 
-		Int index0 = Extract(index, 0);
-		Int index1 = Extract(index, 1);
-		Int index2 = Extract(index, 2);
-		Int index3 = Extract(index, 3);
+		Int4 element = arrayIndex(index);
+		Int index0 = Extract(element, 0);
+		Int index1 = Extract(element, 1);
+		Int index2 = Extract(element, 2);
+		Int index3 = Extract(element, 3);
 
 		z[0][index0] = Insert(z[0][index0], Extract(r, 0), 0);
 		z[0][index1] = Insert(z[0][index1], Extract(r, 1), 1);
@@ -641,12 +799,13 @@ namespace sw
 
 	void RegisterFile::scatter_w(Int4 index, RValue<Float4> r)
 	{
-		ASSERT(indirectAddressable);
+		ASSERT(x);
 
-		Int index0 = Extract(index, 0);
-		Int index1 = Extract(index, 1);
-		Int index2 = Extract(index, 2);
-		Int index3 = Extract(index, 3);
+		Int4 element = arrayIndex(index);
+		Int index0 = Extract(element, 0);
+		Int index1 = Extract(element, 1);
+		Int index2 = Extract(element, 2);
+		Int index3 = Extract(element, 3);
 
 		w[0][index0] = Insert(w[0][index0], Extract(r, 0), 0);
 		w[0][index1] = Insert(w[0][index1], Extract(r, 1), 1);
@@ -1589,20 +1748,20 @@ namespace sw
 		dst.y = sine_pi(src.x, pp);
 	}
 
-	void ShaderCore::cos(Vector4f &dst, const Vector4f &src, bool pp)
+	void ShaderCore::cos(Vector4f &dst, const Vector4f &src, bool pp, bool mp)
 	{
-		dst.x = cosine(src.x, pp);
-		dst.y = cosine(src.y, pp);
-		dst.z = cosine(src.z, pp);
-		dst.w = cosine(src.w, pp);
+		dst.x = cosine(src.x, pp, mp);
+		dst.y = cosine(src.y, pp, mp);
+		dst.z = cosine(src.z, pp, mp);
+		dst.w = cosine(src.w, pp, mp);
 	}
 
-	void ShaderCore::sin(Vector4f &dst, const Vector4f &src, bool pp)
+	void ShaderCore::sin(Vector4f &dst, const Vector4f &src, bool pp, bool mp)
 	{
-		dst.x = sine(src.x, pp);
-		dst.y = sine(src.y, pp);
-		dst.z = sine(src.z, pp);
-		dst.w = sine(src.w, pp);
+		dst.x = sine(src.x, pp, mp);
+		dst.y = sine(src.y, pp, mp);
+		dst.z = sine(src.z, pp, mp);
+		dst.w = sine(src.w, pp, mp);
 	}
 
 	void ShaderCore::tan(Vector4f &dst, const Vector4f &src, bool pp)
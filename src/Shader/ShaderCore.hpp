@@ -19,6 +19,8 @@
 #include "Reactor/Reactor.hpp"
 #include "Common/Debug.hpp"
 
+#include <vector>
+
 namespace sw
 {
 	class Vector4s
@@ -63,8 +65,8 @@ namespace sw
 	Float4 modulo(RValue<Float4> x, RValue<Float4> y);
 	Float4 sine_pi(RValue<Float4> x, bool pp = false);     // limited to [-pi, pi] range
 	Float4 cosine_pi(RValue<Float4> x, bool pp = false);   // limited to [-pi, pi] range
-	Float4 sine(RValue<Float4> x, bool pp = false);
-	Float4 cosine(RValue<Float4> x, bool pp = false);
+	Float4 sine(RValue<Float4> x, bool pp = false, bool mp = false);     // mp: 2^-10 precision suffices
+	Float4 cosine(RValue<Float4> x, bool pp = false, bool mp = false);
 	Float4 tangent(RValue<Float4> x, bool pp = false);
 	Float4 arccos(RValue<Float4> x, bool pp = false);
 	Float4 arcsin(RValue<Float4> x, bool pp = false);
@@ -90,6 +92,9 @@ namespace sw
 	void transpose2x4(Float4 &row0, Float4 &row1, Float4 &row2, Float4 &row3);
 	void transpose4xN(Float4 &row0, Float4 &row1, Float4 &row2, Float4 &row3, int N);
 
+	Float4 halfToFloat(RValue<Int4> halfBits);   // Of sw::half, in the low 16 bits
+	Int4 floatToHalf(RValue<Float4> value);
+
 	class Register
 	{
 	public:
@@ -150,61 +155,13 @@ namespace sw
 	class RegisterFile
 	{
 	public:
-		RegisterFile(int size, bool indirectAddressable) : size(size), indirectAddressable(indirectAddressable)
-		{
-			if(indirectAddressable)
-			{
-				x = new Array<Float4>(size);
-				y = new Array<Float4>(size);
-				z = new Array<Float4>(size);
-				w = new Array<Float4>(size);
-			}
-			else
-			{
-				x = new Array<Float4>[size];
-				y = new Array<Float4>[size];
-				z = new Array<Float4>[size];
-				w = new Array<Float4>[size];
-			}
-		}
-
-		~RegisterFile()
-		{
-			if(indirectAddressable)
-			{
-				delete x;
-				delete y;
-				delete z;
-				delete w;
-			}
-			else
-			{
-				delete[] x;
-				delete[] y;
-				delete[] z;
-				delete[] w;
-			}
-		}
+		RegisterFile(int size, bool indirectAddressable);
+		RegisterFile(int size, int indexedBegin, int indexedEnd);   // Only [indexedBegin, indexedEnd) can be indexed dynamically
 
-		Register operator[](int i)
-		{
-			if(indirectAddressable)
-			{
-				return Register(x[0][i], y[0][i], z[0][i], w[0][i]);
-			}
-			else
-			{
-				return Register(x[i][0], y[i][0], z[i][0], w[i][0]);
-			}
-		}
-
-		Register operator[](RValue<Int> i)
-		{
-			ASSERT(indirectAddressable);
-
-			return Register(x[0][i], y[0][i], z[0][i], w[0][i]);
-		}
+		~RegisterFile();
 
+		Register operator[](int i);
+		Register operator[](RValue<Int> i);
 		const Vector4f operator[](RValue<Int4> i);   // Gather operation (read only).
 
 		void scatter_x(Int4 i, RValue<Float4> r);
@@ -213,12 +170,19 @@ namespace sw
 		void scatter_w(Int4 i, RValue<Float4> r);
 
 	protected:
+		Int arrayIndex(RValue<Int> i);
+		Int4 arrayIndex(RValue<Int4> i);
+
 		const int size;
-		const bool indirectAddressable;
+		const int indexedBegin;
+		const int indexedEnd;
+
+		// The indexed registers are backed by memory, the others are separate variables created on first use
 		Array<Float4> *x;
 		Array<Float4> *y;
 		Array<Float4> *z;
 		Array<Float4> *w;
+		std::vector<Array<Float4>*> variable;
 	};
 
 	template<int S, bool I = false>
@@ -228,6 +192,10 @@ namespace sw
 		RegisterArray(bool indirectAddressable = I) : RegisterFile(S, indirectAddressable)
 		{
 		}
+
+		RegisterArray(int indexedBegin, int indexedEnd) : RegisterFile(S, indexedBegin, indexedEnd)
+		{
+		}
 	};
 
 	class ShaderCore
@@ -337,8 +305,8 @@ namespace sw
 		void nrm3(Vector4f &dst, const Vector4f &src, bool pp = false);
 		void nrm4(Vector4f &dst, const Vector4f &src, bool pp = false);
 		void sincos(Vector4f &dst, const Vector4f &src, bool pp = false);
-		void cos(Vector4f &dst, const Vector4f &src, bool pp = false);
-		void sin(Vector4f &dst, const Vector4f &src, bool pp = false);
+		void cos(Vector4f &dst, const Vector4f &src, bool pp = false, bool mp = false);
+		void sin(Vector4f &dst, const Vector4f &src, bool pp = false, bool mp = false);
 		void tan(Vector4f &dst, const Vector4f &src, bool pp = false);
 		void acos(Vector4f &dst, const Vector4f &src, bool pp = false);
 		void asin(Vector4f &dst, const Vector4f &src, bool pp = false);
@@ -239,13 +239,28 @@ namespace sw
 			o[C1].z = Float4(0.0f);
 			o[C1].w = Float4(0.0f);
 
+			// Colors of the material which don't come from the vertex are already multiplied by those of the lights
+			bool ambientMaterial = (state.vertexAmbientMaterialSourceActive == MATERIAL_MATERIAL);
+
 			Vector4f ambient;
-			Float4 globalAmbient = *Pointer<Float4>(data + OFFSET(DrawData,ff.globalAmbient));   // FIXME: Unpack
+			Float4 globalAmbient = *Pointer<Float4>(data + (ambientMaterial ? OFFSET(DrawData,ff.globalAmbientMaterial) : OFFSET(DrawData,ff.globalAmbient)));   // FIXME: Unpack
 
 			ambient.x = globalAmbient.x;
 			ambient.y = globalAmbient.y;
 			ambient.z = globalAmbient.z;
 
+			Vector4f C;   // Camera vector
+
+			if(state.vertexSpecularActive)
+			{
+				Vector4f S;
+
+				S.x = Float4(0.0f) - vertexPosition.x;
+				S.y = Float4(0.0f) - vertexPosition.y;
+				S.z = Float4(0.0f) - vertexPosition.z;
+				C = normalize(S);
+			}
+
 			for(int i = 0; i < 8; i++)
 			{
 				if(!(state.vertexLightActive & (1 << i)))
@@ -284,7 +299,7 @@ namespace sw
 
 				// Ambient per light
 				{
-					Float4 lightAmbient = *Pointer<Float4>(data + OFFSET(DrawData,ff.lightAmbient[i]));   // FIXME: Unpack
+					Float4 lightAmbient = *Pointer<Float4>(data + (ambientMaterial ? OFFSET(DrawData,ff.lightAmbientMaterial[i]) : OFFSET(DrawData,ff.lightAmbient[i])));   // FIXME: Unpack
 
 					ambient.x = ambient.x + lightAmbient.x * att;
 					ambient.y = ambient.y + lightAmbient.y * att;
@@ -300,52 +315,51 @@ namespace sw
 					dot = Max(dot, Float4(0.0f));
 					dot *= att;
 
-					Vector4f diff;
-
 					if(state.vertexDiffuseMaterialSourceActive == MATERIAL_MATERIAL)
 					{
-						diff.x = diff.y = diff.z = *Pointer<Float4>(data + OFFSET(DrawData,ff.materialDiffuse));   // FIXME: Unpack
-						diff.x = diff.x.xxxx;
-						diff.y = diff.y.yyyy;
-						diff.z = diff.z.zzzz;
-					}
-					else if(state.vertexDiffuseMaterialSourceActive == MATERIAL_COLOR1)
-					{
-						diff = v[Color0];
+						Float4 lightDiffuse = *Pointer<Float4>(data + OFFSET(DrawData,ff.lightDiffuseMaterial[i]));
+
+						o[C0].x = o[C0].x + dot * lightDiffuse.x;   // FIXME: Clamp first?
+						o[C0].y = o[C0].y + dot * lightDiffuse.y;   // FIXME: Clamp first?
+						o[C0].z = o[C0].z + dot * lightDiffuse.z;   // FIXME: Clamp first?
 					}
-					else if(state.vertexDiffuseMaterialSourceActive == MATERIAL_COLOR2)
+					else
 					{
-						diff = v[Color1];
-					}
-					else ASSERT(false);
+						Vector4f diff;
 
-					Float4 lightDiffuse = *Pointer<Float4>(data + OFFSET(DrawData,ff.lightDiffuse[i]));
+						if(state.vertexDiffuseMaterialSourceActive == MATERIAL_COLOR1)
+						{
+							diff = v[Color0];
+						}
+						else if(state.vertexDiffuseMaterialSourceActive == MATERIAL_COLOR2)
+						{
+							diff = v[Color1];
+						}
+						else ASSERT(false);
 
-					o[C0].x = o[C0].x + diff.x * dot * lightDiffuse.x;   // FIXME: Clamp first?
-					o[C0].y = o[C0].y + diff.y * dot * lightDiffuse.y;   // FIXME: Clamp first?
-					o[C0].z = o[C0].z + diff.z * dot * lightDiffuse.z;   // FIXME: Clamp first?
+						Float4 lightDiffuse = *Pointer<Float4>(data + OFFSET(DrawData,ff.lightDiffuse[i]));
+
+						o[C0].x = o[C0].x + diff.x * dot * lightDiffuse.x;   // FIXME: Clamp first?
+						o[C0].y = o[C0].y + diff.y * dot * lightDiffuse.y;   // FIXME: Clamp first?
+						o[C0].z = o[C0].z + diff.z * dot * lightDiffuse.z;   // FIXME: Clamp first?
+					}
 				}
 
 				// Specular
 				if(state.vertexSpecularActive)
 				{
 					Vector4f S;
-					Vector4f C;   // Camera vector
+					Vector4f H;   // Half vector
 					Float4 pow;
 
 					pow = *Pointer<Float>(data + OFFSET(DrawData,ff.materialShininess));
 
-					S.x = Float4(0.0f) - vertexPosition.x;
-					S.y = Float4(0.0f) - vertexPosition.y;
-					S.z = Float4(0.0f) - vertexPosition.z;
-					C = normalize(S);
-
 					S.x = L.x + C.x;
 					S.y = L.y + C.y;
 					S.z = L.z + C.z;
-					C = normalize(S);
+					H = normalize(S);
 
-					Float4 dot = Max(dot3(C, normal), Float4(0.0f));   // FIXME: max(dot3(C, normal), 0)
+					Float4 dot = Max(dot3(H, normal), Float4(0.0f));   // FIXME: max(dot3(H, normal), 0)
 
 					Float4 P = power(dot, pow);
 					P *= att;
@@ -354,27 +368,30 @@ namespace sw
 
 					if(state.vertexSpecularMaterialSourceActive == MATERIAL_MATERIAL)
 					{
-						Float4 materialSpecular = *Pointer<Float4>(data + OFFSET(DrawData,ff.materialSpecular));   // FIXME: Unpack
+						Float4 lightSpecular = *Pointer<Float4>(data + OFFSET(DrawData,ff.lightSpecularMaterial[i]));   // FIXME: Unpack
 
-						spec.x = materialSpecular.x;
-						spec.y = materialSpecular.y;
-						spec.z = materialSpecular.z;
-					}
-					else if(state.vertexSpecularMaterialSourceActive == MATERIAL_COLOR1)
-					{
-						spec = v[Color0];
+						spec.x = lightSpecular.x;
+						spec.y = lightSpecular.y;
+						spec.z = lightSpecular.z;
 					}
-					else if(state.vertexSpecularMaterialSourceActive == MATERIAL_COLOR2)
+					else
 					{
-						spec = v[Color1];
-					}
-					else ASSERT(false);
+						if(state.vertexSpecularMaterialSourceActive == MATERIAL_COLOR1)
+						{
+							spec = v[Color0];
+						}
+						else if(state.vertexSpecularMaterialSourceActive == MATERIAL_COLOR2)
+						{
+							spec = v[Color1];
+						}
+						else ASSERT(false);
 
-					Float4 lightSpecular = *Pointer<Float4>(data + OFFSET(DrawData,ff.lightSpecular[i]));
+						Float4 lightSpecular = *Pointer<Float4>(data + OFFSET(DrawData,ff.lightSpecular[i]));
 
-					spec.x *= lightSpecular.x;
-					spec.y *= lightSpecular.y;
-					spec.z *= lightSpecular.z;
+						spec.x *= lightSpecular.x;
+						spec.y *= lightSpecular.y;
+						spec.z *= lightSpecular.z;
+					}
 
 					spec.x *= P;
 					spec.y *= P;
@@ -399,15 +416,7 @@ namespace sw
 				}
 			}
 
-			if(state.vertexAmbientMaterialSourceActive == MATERIAL_MATERIAL)
-			{
-				Float4 materialAmbient = *Pointer<Float4>(data + OFFSET(DrawData,ff.materialAmbient));   // FIXME: Unpack
-
-				ambient.x = ambient.x * materialAmbient.x;
-				ambient.y = ambient.y * materialAmbient.y;
-				ambient.z = ambient.z * materialAmbient.z;
-			}
-			else if(state.vertexAmbientMaterialSourceActive == MATERIAL_COLOR1)
+			if(state.vertexAmbientMaterialSourceActive == MATERIAL_COLOR1)
 			{
 				Vector4f materialDiffuse = v[Color0];
 
@@ -423,7 +432,7 @@ namespace sw
 				ambient.y = ambient.y * materialSpecular.y;
 				ambient.z = ambient.z * materialSpecular.z;
 			}
-			else ASSERT(false);
+			else ASSERT(ambientMaterial);
 
 			o[C0].x = o[C0].x + ambient.x;
 			o[C0].y = o[C0].y + ambient.y;
@@ -535,13 +544,13 @@ namespace sw
 
 		for(int stage = 0; stage < 8; stage++)
 		{
-			processTextureCoordinate(stage, normal, position);
+			processTextureCoordinate(stage, normal, vertexPosition);
 		}
 
 		processPointSize();
 	}
 
-	void VertexPipeline::processTextureCoordinate(int stage, Vector4f &normal, Vector4f &position)
+	void VertexPipeline::processTextureCoordinate(int stage, Vector4f &normal, Vector4f &vertexPosition)
 	{
 		if(state.output[T0 + stage].write)
 		{
@@ -617,7 +626,7 @@ namespace sw
 				break;
 			case TEXGEN_POSITION:
 				{
-					Vector4f Pn = transformBlend(v[Position], Pointer<Byte>(data + OFFSET(DrawData,ff.cameraTransformT)), true);   // Position in camera space
+					Vector4f Pn = vertexPosition;   // Position in camera space
 
 					Pn.w = Float4(1.0f);
 
@@ -642,7 +651,7 @@ namespace sw
 							Vector4f Ec;   // Eye vector in camera space
 							Vector4f N2;
 
-							Ec = transformBlend(v[Position], Pointer<Byte>(data + OFFSET(DrawData,ff.cameraTransformT)), true);
+							Ec = vertexPosition;
 							Ec = normalize(Ec);
 
 							// R = E - 2 * N * (E . N)
@@ -693,7 +702,7 @@ namespace sw
 							Vector4f Ec;   // Eye vector in camera space
 							Vector4f N2;
 
-							Ec = transformBlend(v[Position], Pointer<Byte>(data + OFFSET(DrawData,ff.cameraTransformT)), true);
+							Ec = vertexPosition;
 							Ec = normalize(Ec);
 
 							// R = E - 2 * N * (E . N)
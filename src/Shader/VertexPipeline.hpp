@@ -31,7 +31,7 @@ namespace sw
 
 	private:
 		void pipeline(UInt &index) override;
-		void processTextureCoordinate(int stage, Vector4f &normal, Vector4f &position);
+		void processTextureCoordinate(int stage, Vector4f &normal, Vector4f &vertexPosition);   // Position in camera space
 		void processPointSize();
 
 		Vector4f transformBlend(const Register &src, const Pointer<Byte> &matrix, bool homogenous);
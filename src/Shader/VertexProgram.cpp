@@ -24,7 +24,7 @@
 namespace sw
 {
 	VertexProgram::VertexProgram(const VertexProcessor::State &state, const VertexShader *shader)
-		: VertexRoutine(state, shader), shader(shader), r(shader->indirectAddressableTemporaries)
+		: VertexRoutine(state, shader), shader(shader), r(shader->indexedTemporariesBegin, shader->indexedTemporariesEnd)
 	{
 		ifDepth = 0;
 		loopRepDepth = 0;
@@ -51,7 +51,7 @@ namespace sw
 
 		if(shader->isInstanceIdDeclared())
 		{
-			instanceID = *Pointer<Int>(data + OFFSET(DrawData,instanceID));
+			instanceID = *Pointer<Int>(task + OFFSET(VertexTask,instanceID));
 		}
 	}
 
@@ -100,7 +100,12 @@ namespace sw
 			}
 		}
 
-		// Create all call site return blocks up front
+		for(int i = 0; i < VERTEX_TEXTURE_IMAGE_UNITS; i++)
+		{
+			samplerSites[i] = 0;
+		}
+
+		// Create all call site return blocks up front, and count the sampling sites
 		for(size_t i = 0; i < shader->getLength(); i++)
 		{
 			const Shader::Instruction *instruction = shader->getInstruction(i);
@@ -113,6 +118,19 @@ namespace sw
 				ASSERT(callRetBlock[dst.label].size() == dst.callSite);
 				callRetBlock[dst.label].push_back(Nucleus::createBasicBlock());
 			}
+
+			const Src &sampler = instruction->src[1];
+
+			if(sampler.type == Shader::PARAMETER_SAMPLER && opcode != Shader::OPCODE_TEXSIZE)
+			{
+				for(int j = 0; j < VERTEX_TEXTURE_IMAGE_UNITS; j++)
+				{
+					if(sampler.rel.type == Shader::PARAMETER_VOID ? j == (int)sampler.index : shader->usesSampler(j))
+					{
+						samplerSites[j]++;
+					}
+				}
+			}
 		}
 
 		for(size_t i = 0; i < shader->getLength(); i++)
@@ -136,6 +154,7 @@ namespace sw
 			Control control = instruction->control;
 			bool integer = dst.type == Shader::PARAMETER_ADDR;
 			bool pp = dst.partialPrecision;
+			bool mp = pp || dst.mediumPrecision;   // 2^-10 relative precision suffices
 
 			Vector4f d;
 			Vector4f s0;
@@ -190,9 +209,9 @@ namespace sw
 			case Shader::OPCODE_DET4:       det4(d, s0, s1, s2, s3);        break;
 			case Shader::OPCODE_ATT:        att(d, s0, s1);                 break;
 			case Shader::OPCODE_EXP2X:      exp2x(d, s0, pp);               break;
-			case Shader::OPCODE_EXP2:       exp2(d, s0, pp);                break;
+			case Shader::OPCODE_EXP2:       exp2(d, s0, mp);                break;
 			case Shader::OPCODE_EXPP:       expp(d, s0, shaderModel);       break;
-			case Shader::OPCODE_EXP:        exp(d, s0, pp);                 break;
+			case Shader::OPCODE_EXP:        exp(d, s0, mp);                 break;
 			case Shader::OPCODE_FRC:        frc(d, s0);                     break;
 			case Shader::OPCODE_TRUNC:      trunc(d, s0);                   break;
 			case Shader::OPCODE_FLOOR:      floor(d, s0);                   break;
@@ -201,9 +220,9 @@ namespace sw
 			case Shader::OPCODE_CEIL:       ceil(d, s0);                    break;
 			case Shader::OPCODE_LIT:        lit(d, s0);                     break;
 			case Shader::OPCODE_LOG2X:      log2x(d, s0, pp);               break;
-			case Shader::OPCODE_LOG2:       log2(d, s0, pp);                break;
+			case Shader::OPCODE_LOG2:       log2(d, s0, mp);                break;
 			case Shader::OPCODE_LOGP:       logp(d, s0, shaderModel);       break;
-			case Shader::OPCODE_LOG:        log(d, s0, pp);                 break;
+			case Shader::OPCODE_LOG:        log(d, s0, mp);                 break;
 			case Shader::OPCODE_LRP:        lrp(d, s0, s1, s2);             break;
 			case Shader::OPCODE_STEP:       step(d, s0, s1);                break;
 			case Shader::OPCODE_SMOOTH:     smooth(d, s0, s1, s2);          break;
@@ -250,7 +269,7 @@ namespace sw
 			case Shader::OPCODE_NRM3:       nrm3(d, s0, pp);                break;
 			case Shader::OPCODE_NRM4:       nrm4(d, s0, pp);                break;
 			case Shader::OPCODE_POWX:       powx(d, s0, s1, pp);            break;
-			case Shader::OPCODE_POW:        pow(d, s0, s1, pp);             break;
+			case Shader::OPCODE_POW:        pow(d, s0, s1, mp);             break;
 			case Shader::OPCODE_RCPX:       rcpx(d, s0, pp);                break;
 			case Shader::OPCODE_DIV:        div(d, s0, s1);                 break;
 			case Shader::OPCODE_IDIV:       idiv(d, s0, s1);                break;
@@ -263,7 +282,7 @@ namespace sw
 			case Shader::OPCODE_USHR:       ushr(d, s0, s1);                break;
 			case Shader::OPCODE_RSQX:       rsqx(d, s0, pp);                break;
 			case Shader::OPCODE_SQRT:       sqrt(d, s0, pp);                break;
-			case Shader::OPCODE_RSQ:        rsq(d, s0, pp);                 break;
+			case Shader::OPCODE_RSQ:        rsq(d, s0, mp);                 break;
 			case Shader::OPCODE_LEN2:       len2(d.x, s0, pp);              break;
 			case Shader::OPCODE_LEN3:       len3(d.x, s0, pp);              break;
 			case Shader::OPCODE_LEN4:       len4(d.x, s0, pp);              break;
@@ -275,8 +294,8 @@ namespace sw
 			case Shader::OPCODE_SGN:        sgn(d, s0);                     break;
 			case Shader::OPCODE_ISGN:       isgn(d, s0);                    break;
 			case Shader::OPCODE_SINCOS:     sincos(d, s0, pp);              break;
-			case Shader::OPCODE_COS:        cos(d, s0, pp);                 break;
-			case Shader::OPCODE_SIN:        sin(d, s0, pp);                 break;
+			case Shader::OPCODE_COS:        cos(d, s0, pp, mp);             break;
+			case Shader::OPCODE_SIN:        sin(d, s0, pp, mp);             break;
 			case Shader::OPCODE_TAN:        tan(d, s0);                     break;
 			case Shader::OPCODE_ACOS:       acos(d, s0);                    break;
 			case Shader::OPCODE_ASIN:       asin(d, s0);                    break;
@@ -607,6 +626,20 @@ namespace sw
 			}
 		}
 
+		if(!sharedSampler.empty())
+		{
+			BasicBlock *continuationBlock = Nucleus::getInsertBlock();
+
+			for(auto &shared : sharedSampler)
+			{
+				shared.second->emit();
+				delete shared.second;
+			}
+
+			sharedSampler.clear();
+			Nucleus::setInsertBlock(continuationBlock);
+		}
+
 		if(currentLabel != -1)
 		{
 			Nucleus::setInsertBlock(returnBlock);
@@ -847,24 +880,20 @@ namespace sw
 			c.z = c.z.zzzz;
 			c.w = c.w.wwww;
 
-			if(shader->containsDefineInstruction())   // Constant may be known at compile time
+			if(const Shader::Instruction *definition = shader->getDefinition(i))   // Constant known at compile time
 			{
-				for(size_t j = 0; j < shader->getLength(); j++)
-				{
-					const Shader::Instruction &instruction = *shader->getInstruction(j);
-
-					if(instruction.opcode == Shader::OPCODE_DEF)
-					{
-						if(instruction.dst.index == i)
-						{
-							c.x = Float4(instruction.src[0].value[0]);
-							c.y = Float4(instruction.src[0].value[1]);
-							c.z = Float4(instruction.src[0].value[2]);
-							c.w = Float4(instruction.src[0].value[3]);
+				c.x = Float4(definition->src[0].value[0]);
+				c.y = Float4(definition->src[0].value[1]);
+				c.z = Float4(definition->src[0].value[2]);
+				c.w = Float4(definition->src[0].value[3]);
+			}
 
-							break;
-						}
-					}
+			for(int k = 0; k < MAX_SPECIALIZED_UNIFORMS; k++)
+			{
+				// Uniform known when the routine was selected
+				if((state.specializedUniforms & (1 << k)) && src.bufferIndex == -1 && shader->getSpecializableConstant(k) / 4 == i)
+				{
+					c[shader->getSpecializableConstant(k) % 4] = As<Float4>(Int4(static_cast<int>(state.specializedValue[k])));
 				}
 			}
 		}
@@ -1604,7 +1633,7 @@ namespace sw
 
 	void VertexProgram::TEXSIZE(Vector4f &dst, Float4 &lod, const Src &src1)
 	{
-		Pointer<Byte> texture = data + OFFSET(DrawData, mipmap[TEXTURE_IMAGE_UNITS]) + src1.index * sizeof(Texture);
+		Pointer<Byte> texture = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData, mipmap[TEXTURE_IMAGE_UNITS]) + src1.index * sizeof(Texture*));
 		dst = SamplerCore::textureSize(texture, lod);
 	}
 
@@ -1644,7 +1673,20 @@ namespace sw
 
 	Vector4f VertexProgram::sampleTexture(int sampler, Vector4f &uvwq, Float4 &lod, Vector4f &dsx, Vector4f &dsy, Vector4f &offset, SamplerFunction function)
 	{
-		Pointer<Byte> texture = data + OFFSET(DrawData, mipmap[TEXTURE_IMAGE_UNITS]) + sampler * sizeof(Texture);
+		Pointer<Byte> texture = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData, mipmap[TEXTURE_IMAGE_UNITS]) + sampler * sizeof(Texture*));
+
+		if(samplerSites[sampler] > 1)
+		{
+			SharedSampler *&shared = sharedSampler[(sampler << 8) | (function.method << 4) | function.option];
+
+			if(!shared)
+			{
+				shared = new SharedSampler(constants, state.sampler[sampler], function);
+			}
+
+			return shared->sampleTexture(texture, uvwq, lod, dsx, dsy, offset);
+		}
+
 		return SamplerCore(constants, state.sampler[sampler]).sampleTexture(texture, uvwq.x, uvwq.y, uvwq.z, uvwq.w, lod, dsx, dsy, offset, function);
 	}
 }
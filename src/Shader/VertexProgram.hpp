@@ -22,6 +22,8 @@
 #include "Renderer/Stream.hpp"
 #include "Common/Types.hpp"
 
+#include <map>
+
 namespace sw
 {
 	struct Stream;
@@ -133,6 +135,9 @@ namespace sw
 		std::vector<BasicBlock*> callRetBlock[2048];
 		BasicBlock *returnBlock;
 		bool isConditionalIf[24 + 24];
+
+		int samplerSites[VERTEX_TEXTURE_IMAGE_UNITS];   // Sampling instructions using each sampler
+		std::map<int, SharedSampler*> sharedSampler;   // By sampler index and function
 	};
 }
 
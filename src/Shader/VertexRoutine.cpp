@@ -18,7 +18,6 @@
 #include "Constants.hpp"
 #include "Renderer/Vertex.hpp"
 #include "Renderer/Renderer.hpp"
-#include "Common/Half.hpp"
 #include "Common/Debug.hpp"
 
 namespace sw
@@ -42,8 +41,11 @@ namespace sw
 		const bool textureSampling = state.textureSampling;
 
 		Pointer<Byte> cache = task + OFFSET(VertexTask,vertexCache);
-		Pointer<Byte> vertexCache = cache + OFFSET(VertexCache,vertex);
-		Pointer<Byte> tagCache = cache + OFFSET(VertexCache,tag);
+		Pointer<Byte> vertexCache = *Pointer<Pointer<Byte>>(cache + OFFSET(VertexCache,vertex));
+		Pointer<Byte> tagCache = *Pointer<Pointer<Byte>>(cache + OFFSET(VertexCache,tag));
+		Pointer<Byte> victimCache = *Pointer<Pointer<Byte>>(cache + OFFSET(VertexCache,victim));
+		UInt setMask = *Pointer<UInt>(cache + OFFSET(VertexCache,setMask));
+		UInt misses = 0;
 
 		UInt vertexCount = *Pointer<UInt>(task + OFFSET(VertexTask,vertexCount));
 		UInt primitiveNumber = *Pointer<UInt>(task + OFFSET(VertexTask, primitiveStart));
@@ -54,23 +56,39 @@ namespace sw
 		Do
 		{
 			UInt index = *Pointer<UInt>(batch);
-			UInt tagIndex = index & 0x0000003C;
+			UInt set = (index >> 2) & setMask;
 			UInt indexQ = !textureSampling ? UInt(index & 0xFFFFFFFC) : index;   // FIXME: TEXLDL hack to have independent LODs, hurts performance.
 
-			If(*Pointer<UInt>(tagCache + tagIndex) != indexQ)
+			Pointer<Byte> tagSet = tagCache + set * UInt(VertexCache::WAYS * (int)sizeof(unsigned int));
+			UInt way = 0;
+
+			If(*Pointer<UInt>(tagSet + sizeof(unsigned int)) == indexQ)
+			{
+				way = 1;
+			}
+			Else
 			{
-				*Pointer<UInt>(tagCache + tagIndex) = indexQ;
+				If(*Pointer<UInt>(tagSet) != indexQ)   // Miss in both ways
+				{
+					way = *Pointer<UInt>(victimCache + set * UInt((int)sizeof(unsigned int)));
+					*Pointer<UInt>(tagSet + way * UInt((int)sizeof(unsigned int))) = indexQ;
 
-				readInput(indexQ);
-				pipeline(indexQ);
-				postTransform();
-				computeClipFlags();
+					readInput(indexQ);
+					pipeline(indexQ);
+					postTransform();
+					computeClipFlags();
 
-				Pointer<Byte> cacheLine0 = vertexCache + tagIndex * UInt((int)sizeof(Vertex));
-				writeCache(cacheLine0);
+					Pointer<Byte> cacheLine0 = vertexCache + (set * UInt(VertexCache::WAYS) + way) * UInt((int)sizeof(Vertex[4]));
+					writeCache(cacheLine0);
+
+					misses++;
+				}
 			}
 
-			UInt cacheIndex = index & 0x0000003F;
+			// Replace the least recently used way
+			*Pointer<UInt>(victimCache + set * UInt((int)sizeof(unsigned int))) = way ^ 1;
+
+			UInt cacheIndex = (set * UInt(VertexCache::WAYS) + way) * 4 + (index & 3);
 			Pointer<Byte> cacheLine = vertexCache + cacheIndex * UInt((int)sizeof(Vertex));
 			writeVertex(vertex, cacheLine);
 
@@ -92,6 +110,8 @@ namespace sw
 		}
 		Until(vertexCount == 0)
 
+		*Pointer<UInt>(cache + OFFSET(VertexCache,misses)) = misses;
+
 		Return();
 	}
 
@@ -102,6 +122,11 @@ namespace sw
 			Pointer<Byte> input = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,input) + sizeof(void*) * i);
 			UInt stride = *Pointer<UInt>(data + OFFSET(DrawData,stride) + sizeof(unsigned int) * i);
 
+			if(state.input[i].instanced)
+			{
+				input += *Pointer<UInt>(task + OFFSET(VertexTask,instanceOffset) + sizeof(unsigned int) * i);
+			}
+
 			v[i] = readStream(input, stride, state.input[i], index);
 		}
 	}
@@ -110,11 +135,15 @@ namespace sw
 	{
 		int pos = state.positionRegister;
 
-		Int4 maxX = CmpLT(o[pos].w, o[pos].x);
-		Int4 maxY = CmpLT(o[pos].w, o[pos].y);
+		// The sides are only clipped when outside of the guard band
+		Float4 guardX = o[pos].w * *Pointer<Float4>(data + OFFSET(DrawData,guardBandX));
+		Float4 guardY = o[pos].w * *Pointer<Float4>(data + OFFSET(DrawData,guardBandY));
+
+		Int4 maxX = CmpLT(guardX, o[pos].x);
+		Int4 maxY = CmpLT(guardY, o[pos].y);
 		Int4 maxZ = CmpLT(o[pos].w, o[pos].z);
-		Int4 minX = CmpNLE(-o[pos].w, o[pos].x);
-		Int4 minY = CmpNLE(-o[pos].w, o[pos].y);
+		Int4 minX = CmpNLE(-guardX, o[pos].x);
+		Int4 minY = CmpNLE(-guardY, o[pos].y);
 		Int4 minZ = symmetricNormalizedDepth ? CmpNLE(-o[pos].w, o[pos].z) : CmpNLE(Float4(0.0f), o[pos].z);
 
 		clipFlags = *Pointer<Int>(constants + OFFSET(Constants,maxX) + SignMask(maxX) * 4);   // FIXME: Array indexing
@@ -491,57 +520,12 @@ namespace sw
 			break;
 		case STREAMTYPE_HALF:
 			{
-				if(stream.count >= 1)
-				{
-					UShort x0 = *Pointer<UShort>(source0 + 0);
-					UShort x1 = *Pointer<UShort>(source1 + 0);
-					UShort x2 = *Pointer<UShort>(source2 + 0);
-					UShort x3 = *Pointer<UShort>(source3 + 0);
-
-					v.x.x = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(x0) * 4);
-					v.x.y = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(x1) * 4);
-					v.x.z = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(x2) * 4);
-					v.x.w = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(x3) * 4);
-				}
+				v.x = halfToFloat(Int4(*Pointer<UShort4>(source0)));
+				v.y = halfToFloat(Int4(*Pointer<UShort4>(source1)));
+				v.z = halfToFloat(Int4(*Pointer<UShort4>(source2)));
+				v.w = halfToFloat(Int4(*Pointer<UShort4>(source3)));
 
-				if(stream.count >= 2)
-				{
-					UShort y0 = *Pointer<UShort>(source0 + 2);
-					UShort y1 = *Pointer<UShort>(source1 + 2);
-					UShort y2 = *Pointer<UShort>(source2 + 2);
-					UShort y3 = *Pointer<UShort>(source3 + 2);
-
-					v.y.x = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(y0) * 4);
-					v.y.y = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(y1) * 4);
-					v.y.z = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(y2) * 4);
-					v.y.w = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(y3) * 4);
-				}
-
-				if(stream.count >= 3)
-				{
-					UShort z0 = *Pointer<UShort>(source0 + 4);
-					UShort z1 = *Pointer<UShort>(source1 + 4);
-					UShort z2 = *Pointer<UShort>(source2 + 4);
-					UShort z3 = *Pointer<UShort>(source3 + 4);
-
-					v.z.x = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(z0) * 4);
-					v.z.y = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(z1) * 4);
-					v.z.z = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(z2) * 4);
-					v.z.w = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(z3) * 4);
-				}
-
-				if(stream.count >= 4)
-				{
-					UShort w0 = *Pointer<UShort>(source0 + 6);
-					UShort w1 = *Pointer<UShort>(source1 + 6);
-					UShort w2 = *Pointer<UShort>(source2 + 6);
-					UShort w3 = *Pointer<UShort>(source3 + 6);
-
-					v.w.x = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(w0) * 4);
-					v.w.y = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(w1) * 4);
-					v.w.z = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(w2) * 4);
-					v.w.w = *Pointer<Float>(constants + OFFSET(Constants,half2float) + Int(w3) * 4);
-				}
+				transpose4xN(v.x, v.y, v.z, v.w, stream.count);
 			}
 			break;
 		case STREAMTYPE_INDICES:
@@ -770,15 +754,27 @@ namespace sw
 					Pointer<Byte> t = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData, vs.t[i])) + (tOffset * str * sizeof(float));
 					Pointer<Byte> v = vertex + OFFSET(Vertex, v) + reg * sizeof(float);
 
-					For(UInt r = 0, r < row, r++)
+					// Every vertex has its own range in the buffer, so primitive units can write in parallel.
+					// Whole registers are copied with one unaligned vector store instead of component by component.
+					If(col == 4)
 					{
-						UInt rOffsetX = r * col * sizeof(float);
-						UInt rOffset4 = r * sizeof(float4);
-
-						For(UInt c = 0, c < col, c++)
+						For(UInt r = 0, r < row, r++)
+						{
+							*Pointer<Float4>(t + r * sizeof(float4), sizeof(float)) = *Pointer<Float4>(v + r * sizeof(float4), sizeof(float));
+						}
+					}
+					Else
+					{
+						For(UInt r = 0, r < row, r++)
 						{
-							UInt cOffset = c * sizeof(float);
-							*Pointer<Float>(t + rOffsetX + cOffset) = *Pointer<Float>(v + rOffset4 + cOffset);
+							UInt rOffsetX = r * col * sizeof(float);
+							UInt rOffset4 = r * sizeof(float4);
+
+							For(UInt c = 0, c < col, c++)
+							{
+								UInt cOffset = c * sizeof(float);
+								*Pointer<Float>(t + rOffsetX + cOffset) = *Pointer<Float>(v + rOffset4 + cOffset);
+							}
 						}
 					}
 				}
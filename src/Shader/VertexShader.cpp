@@ -23,12 +23,14 @@ namespace sw
 {
 	VertexShader::VertexShader(const VertexShader *vs) : Shader()
 	{
+		shaderType = SHADER_VERTEX;
 		shaderModel = 0x0300;
 		positionRegister = Pos;
 		pointSizeRegister = Unused;
 		instanceIdDeclared = false;
 		vertexIdDeclared = false;
 		textureSampling = false;
+		positionShader = nullptr;
 
 		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
 		{
@@ -43,6 +45,11 @@ namespace sw
 				append(new sw::Shader::Instruction(*vs->getInstruction(i)));
 			}
 
+			for(const Instruction *inst : vs->prologue)
+			{
+				prologue.push_back(new Instruction(*inst));
+			}
+
 			memcpy(output, vs->output, sizeof(output));
 			memcpy(input, vs->input, sizeof(input));
 			memcpy(attribType, vs->attribType, sizeof(attribType));
@@ -51,6 +58,7 @@ namespace sw
 			instanceIdDeclared = vs->instanceIdDeclared;
 			vertexIdDeclared = vs->vertexIdDeclared;
 			usedSamplers = vs->usedSamplers;
+			optimization = vs->optimization;
 
 			optimize();
 			analyze();
@@ -66,6 +74,7 @@ namespace sw
 		instanceIdDeclared = false;
 		vertexIdDeclared = false;
 		textureSampling = false;
+		positionShader = nullptr;
 
 		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
 		{
@@ -79,6 +88,89 @@ namespace sw
 
 	VertexShader::~VertexShader()
 	{
+		delete positionShader;
+	}
+
+	void VertexShader::serialize(std::vector<unsigned int> &data) const
+	{
+		Shader::serialize(data);
+
+		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+		{
+			const Semantic &semantic = input[i];
+			data.push_back(semantic.pack());
+			data.push_back(attribType[i]);
+		}
+
+		for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
+		{
+			for(int j = 0; j < 4; j++)
+			{
+				const Semantic &semantic = output[i][j];
+				data.push_back(semantic.pack());
+			}
+		}
+
+		data.push_back(positionRegister);
+		data.push_back(pointSizeRegister);
+		data.push_back(instanceIdDeclared | vertexIdDeclared << 1 | textureSampling << 2);
+	}
+
+	bool VertexShader::deserialize(const unsigned int *&data, const unsigned int *end)
+	{
+		if(!Shader::deserialize(data, end) || end - data < MAX_VERTEX_INPUTS * 2 + MAX_VERTEX_OUTPUTS * 4 + 3)
+		{
+			return false;
+		}
+
+		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+		{
+			input[i] = Semantic::unpack(*data++);
+			attribType[i] = static_cast<AttribType>(*data++);
+
+			if(attribType[i] > ATTRIBTYPE_LAST)
+			{
+				return false;
+			}
+		}
+
+		for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
+		{
+			for(int j = 0; j < 4; j++)
+			{
+				output[i][j] = Semantic::unpack(*data++);
+			}
+		}
+
+		positionRegister = static_cast<int>(*data++);
+		pointSizeRegister = static_cast<int>(*data++);
+
+		if(positionRegister < 0 || positionRegister >= MAX_VERTEX_OUTPUTS || pointSizeRegister < 0 || pointSizeRegister > Unused)
+		{
+			return false;
+		}
+
+		unsigned int flags = *data++;
+		instanceIdDeclared = (flags & 1) != 0;
+		vertexIdDeclared = (flags & 2) != 0;
+		textureSampling = (flags & 4) != 0;
+
+		return true;
+	}
+
+	unsigned int VertexShader::registerCount(ParameterType type) const
+	{
+		switch(type)
+		{
+		case PARAMETER_INPUT:    return MAX_VERTEX_INPUTS;
+		case PARAMETER_ADDR:     return 1;
+		case PARAMETER_RASTOUT:  return 3;   // Position, fog and point size
+		case PARAMETER_ATTROUT:  return MAX_VERTEX_OUTPUTS - C0;
+		case PARAMETER_OUTPUT:   return (shaderModel < 0x0300) ? MAX_VERTEX_OUTPUTS - T0 : MAX_VERTEX_OUTPUTS;
+		case PARAMETER_MISCTYPE: return VertexIDIndex + 1;
+		case PARAMETER_SAMPLER:  return VERTEX_TEXTURE_IMAGE_UNITS;
+		default:                 return Shader::registerCount(type);
+		}
 	}
 
 	int VertexShader::validate(const unsigned long *const token)
@@ -163,11 +255,11 @@ namespace sw
 		attribType[inputIdx] = aType;
 	}
 
-	void VertexShader::setOutput(int outputIdx, int nbComponents, const sw::Shader::Semantic& semantic)
+	void VertexShader::setOutput(int outputIdx, int nbComponents, const sw::Shader::Semantic& semantic, unsigned int mask)
 	{
 		for(int i = 0; i < nbComponents; ++i)
 		{
-			output[outputIdx][i] = semantic;
+			output[outputIdx][i] = (mask & (1 << i)) ? semantic : sw::Shader::Semantic();
 		}
 	}
 
@@ -198,6 +290,158 @@ namespace sw
 		return output[outputIdx][component];
 	}
 
+	void VertexShader::eliminateDeadOutputs()
+	{
+		if(shaderModel < 0x0300 || indirectAddressableOutput)
+		{
+			return;
+		}
+
+		// Outputs can be read back like temporaries
+		unsigned char readMask[MAX_VERTEX_OUTPUTS] = {0};
+
+		for(const auto &inst : instruction)
+		{
+			for(const auto &src : inst->src)
+			{
+				if(src.type == PARAMETER_OUTPUT)
+				{
+					readMask[src.index] |= readComponents(inst, src);
+				}
+			}
+		}
+
+		bool changed = false;
+
+		for(auto &inst : instruction)
+		{
+			if(inst->dst.type != PARAMETER_OUTPUT || (!isComponentwise(inst->opcode) && !isSideEffectFree(inst->opcode)))
+			{
+				continue;
+			}
+
+			unsigned char live = readMask[inst->dst.index];
+
+			for(int c = 0; c < 4; c++)
+			{
+				if(output[inst->dst.index][c].active())
+				{
+					live |= 1 << c;
+				}
+			}
+
+			live &= inst->dst.mask;
+
+			if(live == 0)
+			{
+				inst->opcode = OPCODE_NULL;
+				changed = true;
+			}
+			else if(live != inst->dst.mask && isComponentwise(inst->opcode))
+			{
+				inst->dst.mask = live;
+				changed = true;
+			}
+		}
+
+		if(changed)   // Remove the computations which only fed the dead outputs
+		{
+			size_t length = unoptimizedLength;
+
+			optimize();
+			analyze();
+
+			unoptimizedLength = length;
+		}
+	}
+
+	const VertexShader *VertexShader::getPositionShader() const
+	{
+		if(!positionShader)
+		{
+			positionShader = new VertexShader(this);
+
+			for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
+			{
+				if(i != positionRegister && i != pointSizeRegister)
+				{
+					for(int c = 0; c < 4; c++)
+					{
+						positionShader->output[i][c] = Semantic();
+					}
+				}
+			}
+
+			positionShader->eliminateDeadOutputs();
+		}
+
+		return positionShader;
+	}
+
+	void VertexShader::compactOutputs(int outputMap[MAX_VERTEX_OUTPUTS])
+	{
+		for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
+		{
+			outputMap[i] = i;
+		}
+
+		if(shaderModel < 0x0300 || indirectAddressableOutput)
+		{
+			return;   // Shader model 2.x and below use fixed output registers
+		}
+
+		// Active outputs keep their relative order, so multi-register varyings stay contiguous
+		int slot = 0;
+
+		for(int pass = 0; pass < 2; pass++)
+		{
+			for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
+			{
+				bool active = output[i][0].active() || output[i][1].active() || output[i][2].active() || output[i][3].active();
+
+				if(active == (pass == 0))
+				{
+					outputMap[i] = slot++;
+				}
+			}
+		}
+
+		for(auto &inst : instruction)
+		{
+			if(inst->dst.type == PARAMETER_OUTPUT)
+			{
+				inst->dst.index = outputMap[inst->dst.index];
+			}
+
+			for(auto &src : inst->src)
+			{
+				if(src.type == PARAMETER_OUTPUT)
+				{
+					src.index = outputMap[src.index];
+				}
+			}
+		}
+
+		Semantic compacted[MAX_VERTEX_OUTPUTS][4];
+
+		for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
+		{
+			for(int c = 0; c < 4; c++)
+			{
+				compacted[outputMap[i]][c] = output[i][c];
+			}
+		}
+
+		memcpy(output, compacted, sizeof(output));
+
+		positionRegister = outputMap[positionRegister];
+
+		if(pointSizeRegister != Unused)
+		{
+			pointSizeRegister = outputMap[pointSizeRegister];
+		}
+	}
+
 	void VertexShader::analyze()
 	{
 		analyzeInput();
@@ -208,6 +452,7 @@ namespace sw
 		analyzeSamplers();
 		analyzeCallSites();
 		analyzeIndirectAddressing();
+		analyzeSpecializableConstants();
 	}
 
 	void VertexShader::analyzeInput()
@@ -38,15 +38,26 @@ namespace sw
 		virtual ~VertexShader();
 
 		static int validate(const unsigned long *const token);   // Returns number of instructions if valid
+		void serialize(std::vector<unsigned int> &data) const override;
+		bool deserialize(const unsigned int *&data, const unsigned int *end) override;
 		bool containsTextureSampling() const;
 
 		void setInput(int inputIdx, const Semantic& semantic, AttribType attribType = ATTRIBTYPE_FLOAT);
-		void setOutput(int outputIdx, int nbComponents, const Semantic& semantic);
+		void setOutput(int outputIdx, int nbComponents, const Semantic& semantic, unsigned int mask = 0xF);   // Other components get no semantic
 		void setPositionRegister(int posReg);
 		void setPointSizeRegister(int ptSizeReg);
 		void declareInstanceId() { instanceIdDeclared = true; }
 		void declareVertexId() { vertexIdDeclared = true; }
 
+		// Removes the computation of the output components which were left without a semantic when linking
+		void eliminateDeadOutputs();
+
+		// Renumbers the outputs so the ones with a semantic occupy the lowest registers, and returns the new register of each
+		void compactOutputs(int outputMap[MAX_VERTEX_OUTPUTS]);
+
+		// Copy which only computes the position and point size, for draws which don't use the other outputs
+		const VertexShader *getPositionShader() const;
+
 		const Semantic& getInput(int inputIdx) const;
 		const Semantic& getOutput(int outputIdx, int component) const;
 		AttribType getAttribType(int inputIndex) const;
@@ -56,6 +67,8 @@ namespace sw
 		bool isVertexIdDeclared() const { return vertexIdDeclared; }
 
 	private:
+		unsigned int registerCount(ParameterType type) const override;
+
 		void analyze();
 		void analyzeInput();
 		void analyzeOutput();
@@ -72,6 +85,8 @@ namespace sw
 		bool instanceIdDeclared;
 		bool vertexIdDeclared;
 		bool textureSampling;
+
+		mutable VertexShader *positionShader;   // Created on first use
 	};
 }
 
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+# Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Generates Constants.cpp, the initializer of the sw::Constants lookup tables. Being constant
+# initialized puts them in read-only memory which all processes map from the library file,
+# instead of computing them into private memory in every process.
+#
+# Floating-point values are computed with single precision rounding after every operation and
+# the C library's powf(), so they're identical to what sw::sRGBtoLinear() and sw::linearToSRGB()
+# return. Run it after changing the members of sw::Constants.
+
+import ctypes
+import ctypes.util
+import os
+import struct
+
+libm = ctypes.CDLL(ctypes.util.find_library('m'))
+libm.powf.restype = ctypes.c_float
+libm.powf.argtypes = [ctypes.c_float, ctypes.c_float]
+
+def f32(x):
+    return struct.unpack('f', struct.pack('f', x))[0]
+
+def powf(x, y):
+    return libm.powf(x, y)
+
+def sRGBtoLinear(c):
+    if c <= f32(0.04045):
+        return f32(c * f32(0.07739938))
+    return powf(f32(f32(c + f32(0.055)) * f32(0.9478673)), f32(2.4))
+
+def linearToSRGB(c):
+    if c <= f32(0.0031308):
+        return f32(c * f32(12.92))
+    return f32(f32(f32(1.055) * powf(c, f32(0.4166667))) - f32(0.055))
+
+def clamp(x, lo, hi):
+    return min(max(x, lo), hi)
+
+def unorm16(x):
+    return int(f32(f32(x * 0xFFFF) + 0.5))   # Truncated like the cast to unsigned short
+
+def mask(i, bit, ones):
+    return ones if i >> bit & 1 else 0
+
+def literal(value, kind):
+    if kind == 'float':
+        if value == 0.0 and struct.pack('f', value) != struct.pack('f', 0.0):
+            return '-0.0f'
+        text = '%.9g' % value
+        if 'e' not in text and '.' not in text:
+            text += '.0'
+        return text + 'f'
+    if kind == 'qword':
+        return '0x%016X' % value
+    if kind == 'dword':
+        return '0x%08X' % value
+    if kind == 'word':
+        return '0x%04X' % value
+    if kind == 'byte':
+        return '0x%02X' % value
+    return '%d' % value
+
+def braced(values, kind, indent, perLine):
+    if not isinstance(values[0], list):
+        text = [literal(value, kind) for value in values]
+        if len(text) <= perLine:
+            return '{' + ', '.join(text) + '}'
+        lines = [', '.join(text[i:i + perLine]) for i in range(0, len(text), perLine)]
+        return '{\n' + ',\n'.join(indent + '\t' + line for line in lines) + '\n' + indent + '}'
+    inner = [braced(value, kind, indent + '\t', perLine) for value in values]
+    if all('\n' not in element for element in inner) and len(inner) * len(inner[0]) <= 100:
+        return '{' + ', '.join(inner) + '}'
+    return '{\n' + ',\n'.join(indent + '\t' + element for element in inner) + '\n' + indent + '}'
+
+members = []
+
+def member(name, kind, values, perLine=8):
+    members.append((name, kind, values, perLine))
+
+for n in range(3):
+    member('transposeBit%d' % n, 'dword', [sum((i >> b & 1) << (4 * b + n) for b in range(4)) for i in range(16)])
+
+member('cWeight', 'word', [[min(0x10000 // max(i, 1), 0xFFFF)] * 4 for i in range(17)])
+member('uvWeight', 'float', [[f32(1.0 / max(i, 1))] * 4 for i in range(17)])
+member('uvStart', 'float', [[f32(-float(max(i - 1, 0)) / (2 * max(i, 1))) if i > 1 else -0.0] * 4 for i in range(17)])
+
+member('occlusionCount', 'int', [bin(i).count('1') for i in range(16)], 16)
+
+member('maskB4Q', 'byte', [[mask(i, j % 4, 0xFF) for j in range(8)] for i in range(16)])
+member('invMaskB4Q', 'byte', [[0xFF - mask(i, j % 4, 0xFF) for j in range(8)] for i in range(16)])
+member('maskW4Q', 'word', [[mask(i, j, 0xFFFF) for j in range(4)] for i in range(16)])
+member('invMaskW4Q', 'word', [[0xFFFF - mask(i, j, 0xFFFF) for j in range(4)] for i in range(16)])
+member('maskD4X', 'dword', [[mask(i, j, 0xFFFFFFFF) for j in range(4)] for i in range(16)])
+member('invMaskD4X', 'dword', [[0xFFFFFFFF - mask(i, j, 0xFFFFFFFF) for j in range(4)] for i in range(16)])
+
+ones64 = 0xFFFFFFFFFFFFFFFF
+
+for q in range(4):
+    member('maskQ%dQ' % q, 'qword', [mask(i, q, ones64) for i in range(16)], 4)
+for q in range(4):
+    member('invMaskQ%dQ' % q, 'qword', [ones64 - mask(i, q, ones64) for i in range(16)], 4)
+for x in range(4):
+    member('maskX%dX' % x, 'dword', [[mask(i, x, 0xFFFFFFFF)] * 4 for i in range(16)])
+for x in range(4):
+    member('invMaskX%dX' % x, 'dword', [[0xFFFFFFFF - mask(i, x, 0xFFFFFFFF)] * 4 for i in range(16)])
+
+member('maskD01Q', 'dword', [[mask(i, 0, 0xFFFFFFFF), mask(i, 1, 0xFFFFFFFF)] for i in range(16)])
+member('maskD23Q', 'dword', [[mask(i, 2, 0xFFFFFFFF), mask(i, 3, 0xFFFFFFFF)] for i in range(16)])
+member('invMaskD01Q', 'dword', [[0xFFFFFFFF - mask(i, 0, 0xFFFFFFFF), 0xFFFFFFFF - mask(i, 1, 0xFFFFFFFF)] for i in range(16)])
+member('invMaskD23Q', 'dword', [[0xFFFFFFFF - mask(i, 2, 0xFFFFFFFF), 0xFFFFFFFF - mask(i, 3, 0xFFFFFFFF)] for i in range(16)])
+member('maskQ01X', 'qword', [[mask(i, 0, ones64), mask(i, 1, ones64)] for i in range(16)])
+member('maskQ23X', 'qword', [[mask(i, 2, ones64), mask(i, 3, ones64)] for i in range(16)])
+member('invMaskQ01X', 'qword', [[ones64 - mask(i, 0, ones64), ones64 - mask(i, 1, ones64)] for i in range(16)])
+member('invMaskQ23X', 'qword', [[ones64 - mask(i, 2, ones64), ones64 - mask(i, 3, ones64)] for i in range(16)])
+member('maskW01Q', 'word', [[mask(i, j % 2, 0xFFFF) for j in range(4)] for i in range(4)])
+member('maskD01X', 'dword', [[mask(i, j % 2, 0xFFFFFFFF) for j in range(4)] for i in range(4)])
+member('mask565Q', 'word', [[mask(i, 0, 0x001F) | mask(i, 1, 0x07E0) | mask(i, 2, 0xF800)] * 4 for i in range(8)])
+
+member('sRGBtoLinear8_16', 'word', [unorm16(sRGBtoLinear(f32(i / 0xFF))) for i in range(256)])
+member('sRGBtoLinear6_16', 'word', [unorm16(sRGBtoLinear(f32(i / 0x3F))) for i in range(64)])
+member('sRGBtoLinear5_16', 'word', [unorm16(sRGBtoLinear(f32(i / 0x1F))) for i in range(32)])
+member('sRGBtoLinear8_32F', 'float', [sRGBtoLinear(f32(i / 0xFF)) for i in range(256)], 4)
+
+member('linearToSRGB12_16', 'word', [int(clamp(f32(f32(linearToSRGB(f32(i / 0x0FFF)) * 0xFFFF) + 0.5), 0.0, 65535.0)) for i in range(0x1000)])
+member('sRGB8boundary', 'float', [0.0 if i == 0 else 2.0 if i == 256 else sRGBtoLinear(f32(f32(i - 0.5) / 0xFF)) for i in range(257)], 4)
+member('sRGBtoLinear12_16', 'word', [int(clamp(f32(f32(sRGBtoLinear(f32(i / 0x0FFF)) * 0xFFFF) + 0.5), 0.0, 65535.0)) for i in range(0x1000)])
+
+sampleX = [+0.3125, -0.3125, -0.1250, +0.1250]
+sampleY = [+0.1250, -0.1250, +0.3125, -0.3125]
+
+member('sampleX', 'float', [[[sampleX[q] if c & (1 << i) else 0.0 for i in range(4)] for c in range(16)] for q in range(4)])
+member('sampleY', 'float', [[[sampleY[q] if c & (1 << i) else 0.0 for i in range(4)] for c in range(16)] for q in range(4)])
+member('weight', 'float', [[1.0 if c & (1 << i) else 0.0 for i in range(4)] for c in range(16)])
+
+member('Xf', 'int', [-5, +5, +2, -2])
+member('Yf', 'int', [-2, +2, -5, +5])
+
+member('X', 'float', [[x] * 4 for x in [-0.3125, +0.3125, +0.1250, -0.1250]])
+member('Y', 'float', [[y] * 4 for y in [-0.1250, +0.1250, -0.3125, +0.3125]])
+
+for name, bit in [('maxX', 0), ('maxY', 1), ('maxZ', 2), ('minX', 3), ('minY', 4), ('minZ', 5), ('fini', 7)]:
+    member(name, 'dword', [sum((i >> b & 1) << (8 * b + bit) for b in range(4)) for i in range(16)])
+
+member('maxPos', 'dword', [0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFE])
+
+for name, scale in [('unscaleByte', 0xFF), ('unscaleSByte', 0x7F), ('unscaleShort', 0x7FFF), ('unscaleUShort', 0xFFFF),
+                    ('unscaleInt', 0x7FFFFFFF), ('unscaleUInt', 0xFFFFFFFF), ('unscaleFixed', 0x00010000)]:
+    member(name, 'float', [f32(1.0 / f32(scale))] * 4)
+
+header = '''// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by generate_constants.py, do not edit.
+
+#include "Constants.hpp"
+
+namespace sw
+{
+	const Constants constants =   // Declared extern in Constants.hpp, so it gets external linkage
+	{
+'''
+
+footer = '''	};
+}
+'''
+
+with open(os.path.join(os.path.dirname(os.path.abspath(__file__)), 'Constants.cpp'), 'w') as output:
+    output.write(header)
+    for index, (name, kind, values, perLine) in enumerate(members):
+        separator = ',' if index + 1 < len(members) else ''
+        output.write('\t\t// %s\n' % name)
+        output.write('\t\t' + braced(values, kind, '\t\t', perLine) + separator + '\n')
+        if index + 1 < len(members):
+            output.write('\n')
+    output.write(footer)
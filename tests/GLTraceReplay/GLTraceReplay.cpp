@@ -0,0 +1,793 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// GLTraceReplay.cpp: Plays back the OpenGL ES calls captured with the CommandTrace option of
+// SwiftShader.ini (see src/OpenGL/libGLESv2/CommandTrace.h) into pbuffers, and reports the time
+// taken by each frame. This measures the renderer on the same workload before and after a change,
+// without the application's own work or the presentation of the frames.
+//
+// Usage: GLTraceReplay [--repeat <passes>] [--skip <frames>] [--quiet] <trace>
+
+#define GL_GLEXT_PROTOTYPES
+
+#include "libGLESv2/CommandTrace.h"
+
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
+#include <GLES3/gl3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+using es2::CommandTrace;
+
+namespace
+{
+	// Reads the arguments of one record, in the order the entry points wrote them
+	class Reader
+	{
+	public:
+		Reader(const unsigned char *data, size_t size, std::vector<std::vector<uint64_t>> &copies)
+			: data(data), size(size), copies(copies)
+		{
+		}
+
+		template<typename T>
+		typename std::enable_if<!std::is_pointer<T>::value, T>::type get()
+		{
+			T value = T();
+
+			if(take(sizeof(T)))
+			{
+				memcpy(&value, data + position - sizeof(T), sizeof(T));
+			}
+
+			return value;
+		}
+
+		template<typename T>
+		typename std::enable_if<std::is_pointer<T>::value, T>::type get()
+		{
+			return (T)memory();
+		}
+
+		// Returns a copy of the captured memory, which is aligned and followed by a null terminator
+		// since strings are captured without one, or the captured buffer offset, or null.
+		const void *memory()
+		{
+			lastSize = 0;
+			uint32_t bytes = get<uint32_t>();
+
+			if(bytes == CommandTrace::NullData)
+			{
+				return nullptr;
+			}
+
+			if(bytes == CommandTrace::OffsetData)
+			{
+				return (const void*)(intptr_t)get<int64_t>();
+			}
+
+			if(!take(bytes))
+			{
+				return nullptr;
+			}
+
+			if(copies.size() <= memoryCount)
+			{
+				copies.resize(memoryCount + 1);
+			}
+
+			std::vector<uint64_t> &copy = copies[memoryCount++];
+			copy.resize(bytes / sizeof(uint64_t) + 1);
+			copy[bytes / sizeof(uint64_t)] = 0;
+			memcpy(copy.data(), data + position - bytes, bytes);
+			lastSize = bytes;
+
+			return copy.data();
+		}
+
+		size_t memorySize() const { return lastSize; }   // Of the last memory argument
+		bool atEnd() const { return position == size; }
+		bool overrun() const { return overran; }
+
+	private:
+		bool take(size_t bytes)
+		{
+			if(overran || bytes > size - position)
+			{
+				overran = true;
+				return false;
+			}
+
+			position += bytes;
+			return true;
+		}
+
+		const unsigned char *const data;
+		const size_t size;
+		size_t position = 0;
+		bool overran = false;
+
+		std::vector<std::vector<uint64_t>> &copies;   // Reused by each record, to avoid allocations
+		size_t memoryCount = 0;
+		size_t lastSize = 0;
+	};
+
+	template<int...> struct Indices {};
+	template<int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+	template<int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+	template<typename... P, int... I>
+	void call(void (GL_APIENTRY *function)(P...), const std::tuple<P...> &arguments, Indices<I...>)
+	{
+		function(std::get<I>(arguments)...);
+	}
+
+	// Calls an entry point with the record's arguments, which were captured in the types of its parameters
+	template<typename... P>
+	void invoke(Reader &reader, void (GL_APIENTRY *function)(P...))
+	{
+		// Unlike function arguments, the elements of a braced initializer are evaluated in order
+		std::tuple<P...> arguments{reader.get<P>()...};
+		call(function, arguments, typename MakeIndices<sizeof...(P)>::type());
+	}
+
+	// The OES, EXT and NV entry points which are not exported are replayed with the equivalent ES 3.0 ones
+	void GL_APIENTRY framebufferTexture3D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset)
+	{
+		glFramebufferTextureLayer(target, attachment, texture, level, zoffset);
+	}
+
+	class Replay
+	{
+	public:
+		Replay(EGLDisplay display, const std::vector<unsigned char> &trace) : display(display), trace(trace)
+		{
+		}
+
+		~Replay()
+		{
+			eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+			for(Surface &context : contexts)
+			{
+				if(context.surface != EGL_NO_SURFACE) eglDestroySurface(display, context.surface);
+				if(context.context != EGL_NO_CONTEXT) eglDestroyContext(display, context.context);
+			}
+		}
+
+		// Replays the whole trace, adding the duration of each frame in milliseconds
+		bool run(std::vector<double> &frameTimes)
+		{
+			auto frameStart = std::chrono::steady_clock::now();
+			size_t position = 2 * sizeof(uint32_t);
+
+			while(position < trace.size())
+			{
+				uint16_t call;
+				uint32_t size;
+
+				if(trace.size() - position < sizeof(call) + sizeof(size))
+				{
+					return fail("truncated record header");
+				}
+
+				memcpy(&call, &trace[position], sizeof(call));
+				memcpy(&size, &trace[position + sizeof(call)], sizeof(size));
+				position += sizeof(call) + sizeof(size);
+
+				if(size > trace.size() - position)
+				{
+					return fail("truncated record");   // A trace is only complete up to its last frame
+				}
+
+				Reader reader(&trace[position], size, copies);
+				position += size;
+
+				if(call == CommandTrace::Frame)
+				{
+					glFinish();
+
+					auto frameEnd = std::chrono::steady_clock::now();
+					frameTimes.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+					frameStart = frameEnd;
+				}
+				else if(!execute((CommandTrace::Call)call, reader))
+				{
+					return false;
+				}
+				else if(reader.overrun())
+				{
+					return fail("arguments exceed the record");
+				}
+
+				record++;
+			}
+
+			return true;
+		}
+
+	private:
+		struct Surface
+		{
+			EGLContext context;
+			EGLSurface surface;
+			EGLint width;
+			EGLint height;
+		};
+
+		bool fail(const char *message)
+		{
+			fprintf(stderr, "Record %lu: %s\n", (unsigned long)record, message);
+			return false;
+		}
+
+		bool execute(CommandTrace::Call call, Reader &reader)
+		{
+			switch(call)
+			{
+			case CommandTrace::MakeCurrent:                   return makeCurrent(reader);
+			case CommandTrace::ClientArray:                   return clientArray(reader);
+			case CommandTrace::ActiveTexture:                 invoke(reader, glActiveTexture);                      break;
+			case CommandTrace::AttachShader:                  invoke(reader, glAttachShader);                       break;
+			case CommandTrace::BeginQueryEXT:                 invoke(reader, glBeginQueryEXT);                      break;
+			case CommandTrace::BindAttribLocation:            invoke(reader, glBindAttribLocation);                 break;
+			case CommandTrace::BindBuffer:                    invoke(reader, glBindBuffer);                         break;
+			case CommandTrace::BindFramebuffer:               invoke(reader, glBindFramebuffer);                    break;
+			case CommandTrace::BindRenderbuffer:              invoke(reader, glBindRenderbuffer);                   break;
+			case CommandTrace::BindTexture:                   invoke(reader, glBindTexture);                        break;
+			case CommandTrace::BlendColor:                    invoke(reader, glBlendColor);                         break;
+			case CommandTrace::BlendEquation:                 invoke(reader, glBlendEquation);                      break;
+			case CommandTrace::BlendEquationSeparate:         invoke(reader, glBlendEquationSeparate);              break;
+			case CommandTrace::BlendFunc:                     invoke(reader, glBlendFunc);                          break;
+			case CommandTrace::BlendFuncSeparate:             invoke(reader, glBlendFuncSeparate);                  break;
+			case CommandTrace::BlitFramebufferANGLE:          invoke(reader, glBlitFramebufferANGLE);               break;
+			case CommandTrace::BlitFramebufferNV:             invoke(reader, glBlitFramebuffer);                    break;
+			case CommandTrace::BufferData:                    return bufferData(reader);
+			case CommandTrace::BufferSubData:                 return bufferSubData(reader);
+			case CommandTrace::Clear:                         invoke(reader, glClear);                              break;
+			case CommandTrace::ClearColor:                    invoke(reader, glClearColor);                         break;
+			case CommandTrace::ClearDepthf:                   invoke(reader, glClearDepthf);                        break;
+			case CommandTrace::ClearStencil:                  invoke(reader, glClearStencil);                       break;
+			case CommandTrace::ColorMask:                     invoke(reader, glColorMask);                          break;
+			case CommandTrace::CompileShader:                 invoke(reader, glCompileShader);                      break;
+			case CommandTrace::CompressedTexImage2D:          invoke(reader, glCompressedTexImage2D);               break;
+			case CommandTrace::CompressedTexImage3D:          invoke(reader, glCompressedTexImage3D);               break;
+			case CommandTrace::CompressedTexSubImage2D:       invoke(reader, glCompressedTexSubImage2D);            break;
+			case CommandTrace::CompressedTexSubImage3D:       invoke(reader, glCompressedTexSubImage3D);            break;
+			case CommandTrace::CopyTexImage2D:                invoke(reader, glCopyTexImage2D);                     break;
+			case CommandTrace::CopyTexSubImage2D:             invoke(reader, glCopyTexSubImage2D);                  break;
+			case CommandTrace::CopyTexSubImage3D:             invoke(reader, glCopyTexSubImage3D);                  break;
+			case CommandTrace::CreateProgram:                 return createProgram(reader);
+			case CommandTrace::CreateShader:                  return createShader(reader);
+			case CommandTrace::CullFace:                      invoke(reader, glCullFace);                           break;
+			case CommandTrace::DeleteBuffers:                 invoke(reader, glDeleteBuffers);                      break;
+			case CommandTrace::DeleteFramebuffers:            invoke(reader, glDeleteFramebuffers);                 break;
+			case CommandTrace::DeleteProgram:                 invoke(reader, glDeleteProgram);                      break;
+			case CommandTrace::DeleteQueriesEXT:              invoke(reader, glDeleteQueriesEXT);                   break;
+			case CommandTrace::DeleteRenderbuffers:           invoke(reader, glDeleteRenderbuffers);                break;
+			case CommandTrace::DeleteShader:                  invoke(reader, glDeleteShader);                       break;
+			case CommandTrace::DeleteTextures:                invoke(reader, glDeleteTextures);                     break;
+			case CommandTrace::DepthFunc:                     invoke(reader, glDepthFunc);                          break;
+			case CommandTrace::DepthMask:                     invoke(reader, glDepthMask);                          break;
+			case CommandTrace::DepthRangef:                   invoke(reader, glDepthRangef);                        break;
+			case CommandTrace::DetachShader:                  invoke(reader, glDetachShader);                       break;
+			case CommandTrace::Disable:                       invoke(reader, glDisable);                            break;
+			case CommandTrace::DisableVertexAttribArray:      invoke(reader, glDisableVertexAttribArray);           break;
+			case CommandTrace::DrawArrays:                    invoke(reader, glDrawArrays);                         break;
+			case CommandTrace::DrawArraysInstanced:           invoke(reader, glDrawArraysInstanced);                break;
+			case CommandTrace::DrawBuffersEXT:                invoke(reader, glDrawBuffersEXT);                     break;
+			case CommandTrace::DrawElements:                  invoke(reader, glDrawElements);                       break;
+			case CommandTrace::DrawElementsInstanced:         invoke(reader, glDrawElementsInstanced);              break;
+			case CommandTrace::Enable:                        invoke(reader, glEnable);                             break;
+			case CommandTrace::EnableVertexAttribArray:       invoke(reader, glEnableVertexAttribArray);            break;
+			case CommandTrace::EndQueryEXT:                   invoke(reader, glEndQueryEXT);                        break;
+			case CommandTrace::Finish:                        invoke(reader, glFinish);                             break;
+			case CommandTrace::Flush:                         invoke(reader, glFlush);                              break;
+			case CommandTrace::FramebufferRenderbuffer:       invoke(reader, glFramebufferRenderbuffer);            break;
+			case CommandTrace::FramebufferTexture2D:          invoke(reader, glFramebufferTexture2D);               break;
+			case CommandTrace::FramebufferTexture3D:          invoke(reader, framebufferTexture3D);                 break;
+			case CommandTrace::FrontFace:                     invoke(reader, glFrontFace);                          break;
+			case CommandTrace::GenBuffers:                    return generated(reader, glGenBuffers);
+			case CommandTrace::GenerateMipmap:                invoke(reader, glGenerateMipmap);                     break;
+			case CommandTrace::GenFramebuffers:               return generated(reader, glGenFramebuffers);
+			case CommandTrace::GenQueriesEXT:                 return generated(reader, glGenQueriesEXT);
+			case CommandTrace::GenRenderbuffers:              return generated(reader, glGenRenderbuffers);
+			case CommandTrace::GenTextures:                   return generated(reader, glGenTextures);
+			case CommandTrace::Hint:                          invoke(reader, glHint);                               break;
+			case CommandTrace::LineWidth:                     invoke(reader, glLineWidth);                          break;
+			case CommandTrace::LinkProgram:                   invoke(reader, glLinkProgram);                        break;
+			case CommandTrace::PixelStorei:                   invoke(reader, glPixelStorei);                        break;
+			case CommandTrace::PolygonOffset:                 invoke(reader, glPolygonOffset);                      break;
+			case CommandTrace::QueryCounterEXT:               invoke(reader, glQueryCounterEXT);                    break;
+			case CommandTrace::ReadPixels:                    return readPixels(reader);
+			case CommandTrace::RenderbufferStorage:           invoke(reader, glRenderbufferStorage);                break;
+			case CommandTrace::RenderbufferStorageMultisample: invoke(reader, glRenderbufferStorageMultisampleANGLE); break;
+			case CommandTrace::SampleCoverage:                invoke(reader, glSampleCoverage);                     break;
+			case CommandTrace::Scissor:                       invoke(reader, glScissor);                            break;
+			case CommandTrace::ShaderSource:                  return shaderSource(reader);
+			case CommandTrace::StencilFunc:                   invoke(reader, glStencilFunc);                        break;
+			case CommandTrace::StencilFuncSeparate:           invoke(reader, glStencilFuncSeparate);                break;
+			case CommandTrace::StencilMask:                   invoke(reader, glStencilMask);                        break;
+			case CommandTrace::StencilMaskSeparate:           invoke(reader, glStencilMaskSeparate);                break;
+			case CommandTrace::StencilOp:                     invoke(reader, glStencilOp);                          break;
+			case CommandTrace::StencilOpSeparate:             invoke(reader, glStencilOpSeparate);                  break;
+			case CommandTrace::TexImage2D:                    invoke(reader, glTexImage2D);                         break;
+			case CommandTrace::TexImage3D:                    invoke(reader, glTexImage3DOES);                      break;
+			case CommandTrace::TexParameterf:                 invoke(reader, glTexParameterf);                      break;
+			case CommandTrace::TexParameterfv:                invoke(reader, glTexParameterfv);                     break;
+			case CommandTrace::TexParameteri:                 invoke(reader, glTexParameteri);                      break;
+			case CommandTrace::TexParameteriv:                invoke(reader, glTexParameteriv);                     break;
+			case CommandTrace::TexSubImage2D:                 invoke(reader, glTexSubImage2D);                      break;
+			case CommandTrace::TexSubImage3D:                 invoke(reader, glTexSubImage3D);                      break;
+			case CommandTrace::Uniform1f:                     invoke(reader, glUniform1f);                          break;
+			case CommandTrace::Uniform1fv:                    invoke(reader, glUniform1fv);                         break;
+			case CommandTrace::Uniform1i:                     invoke(reader, glUniform1i);                          break;
+			case CommandTrace::Uniform1iv:                    invoke(reader, glUniform1iv);                         break;
+			case CommandTrace::Uniform2f:                     invoke(reader, glUniform2f);                          break;
+			case CommandTrace::Uniform2fv:                    invoke(reader, glUniform2fv);                         break;
+			case CommandTrace::Uniform2i:                     invoke(reader, glUniform2i);                          break;
+			case CommandTrace::Uniform2iv:                    invoke(reader, glUniform2iv);                         break;
+			case CommandTrace::Uniform3f:                     invoke(reader, glUniform3f);                          break;
+			case CommandTrace::Uniform3fv:                    invoke(reader, glUniform3fv);                         break;
+			case CommandTrace::Uniform3i:                     invoke(reader, glUniform3i);                          break;
+			case CommandTrace::Uniform3iv:                    invoke(reader, glUniform3iv);                         break;
+			case CommandTrace::Uniform4f:                     invoke(reader, glUniform4f);                          break;
+			case CommandTrace::Uniform4fv:                    invoke(reader, glUniform4fv);                         break;
+			case CommandTrace::Uniform4i:                     invoke(reader, glUniform4i);                          break;
+			case CommandTrace::Uniform4iv:                    invoke(reader, glUniform4iv);                         break;
+			case CommandTrace::UniformMatrix2fv:              invoke(reader, glUniformMatrix2fv);                   break;
+			case CommandTrace::UniformMatrix3fv:              invoke(reader, glUniformMatrix3fv);                   break;
+			case CommandTrace::UniformMatrix4fv:              invoke(reader, glUniformMatrix4fv);                   break;
+			case CommandTrace::UseProgram:                    invoke(reader, glUseProgram);                         break;
+			case CommandTrace::VertexAttrib1f:                invoke(reader, glVertexAttrib1f);                     break;
+			case CommandTrace::VertexAttrib1fv:               invoke(reader, glVertexAttrib1fv);                    break;
+			case CommandTrace::VertexAttrib2f:                invoke(reader, glVertexAttrib2f);                     break;
+			case CommandTrace::VertexAttrib2fv:               invoke(reader, glVertexAttrib2fv);                    break;
+			case CommandTrace::VertexAttrib3f:                invoke(reader, glVertexAttrib3f);                     break;
+			case CommandTrace::VertexAttrib3fv:               invoke(reader, glVertexAttrib3fv);                    break;
+			case CommandTrace::VertexAttrib4f:                invoke(reader, glVertexAttrib4f);                     break;
+			case CommandTrace::VertexAttrib4fv:               invoke(reader, glVertexAttrib4fv);                    break;
+			case CommandTrace::VertexAttribDivisor:           invoke(reader, glVertexAttribDivisor);                break;
+			case CommandTrace::VertexAttribPointer:           return vertexAttribPointer(reader);
+			case CommandTrace::Viewport:                      invoke(reader, glViewport);                           break;
+			default:
+				return fail("unknown call");   // Captured by a newer version
+			}
+
+			return true;
+		}
+
+		bool makeCurrent(Reader &reader)
+		{
+			uint32_t id = reader.get<uint32_t>();
+			EGLint clientVersion = reader.get<EGLint>();
+			EGLint width = std::max(reader.get<EGLint>(), 1);   // Contexts made current without a surface get a 1x1 one
+			EGLint height = std::max(reader.get<EGLint>(), 1);
+			EGLint attributes[7];
+
+			for(EGLint &attribute : attributes)
+			{
+				attribute = reader.get<EGLint>();
+			}
+
+			if(id > contexts.size())
+			{
+				return fail("context ID out of sequence");
+			}
+
+			if(id == contexts.size())
+			{
+				EGLConfig config = chooseConfig(clientVersion, attributes);
+
+				if(!config)
+				{
+					return fail("no config matches the captured one");
+				}
+
+				const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, clientVersion, EGL_NONE};
+				EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+				if(context == EGL_NO_CONTEXT)
+				{
+					return fail("eglCreateContext failed");
+				}
+
+				contexts.push_back({context, EGL_NO_SURFACE, 0, 0});
+				configs.push_back(config);
+			}
+
+			Surface &current = contexts[id];
+
+			if(current.width != width || current.height != height)
+			{
+				if(current.surface != EGL_NO_SURFACE)
+				{
+					eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+					eglDestroySurface(display, current.surface);
+				}
+
+				const EGLint surfaceAttributes[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+				current.surface = eglCreatePbufferSurface(display, configs[id], surfaceAttributes);
+				current.width = width;
+				current.height = height;
+
+				if(current.surface == EGL_NO_SURFACE)
+				{
+					return fail("eglCreatePbufferSurface failed");
+				}
+			}
+
+			if(!eglMakeCurrent(display, current.surface, current.surface, current.context))
+			{
+				return fail("eglMakeCurrent failed");
+			}
+
+			return true;
+		}
+
+		// Finds the config with exactly the captured red, green, blue, alpha, depth and stencil bits and samples
+		EGLConfig chooseConfig(EGLint clientVersion, const EGLint attributes[7])
+		{
+			static const EGLint names[7] = {EGL_RED_SIZE, EGL_GREEN_SIZE, EGL_BLUE_SIZE, EGL_ALPHA_SIZE, EGL_DEPTH_SIZE, EGL_STENCIL_SIZE, EGL_SAMPLES};
+			EGLint renderableType = (clientVersion >= 3) ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_ES2_BIT;
+
+			const EGLint request[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, renderableType, EGL_NONE};
+			EGLint count = 0;
+			eglChooseConfig(display, request, nullptr, 0, &count);
+			std::vector<EGLConfig> candidates(std::max(count, 1));
+			eglChooseConfig(display, request, candidates.data(), count, &count);
+
+			for(EGLint i = 0; i < count; i++)
+			{
+				bool match = true;
+
+				for(int j = 0; j < 7 && match; j++)
+				{
+					EGLint value = 0;
+					eglGetConfigAttrib(display, candidates[i], names[j], &value);
+					match = (value == attributes[j]);
+				}
+
+				if(match)
+				{
+					return candidates[i];
+				}
+			}
+
+			return nullptr;
+		}
+
+		// Client-side vertex arrays are set from the memory captured before the draw call which reads them
+		bool clientArray(Reader &reader)
+		{
+			GLuint index = reader.get<GLuint>();
+			GLint size = reader.get<GLint>();
+			GLenum type = reader.get<GLenum>();
+			GLboolean normalized = reader.get<GLboolean>();
+			GLsizei stride = reader.get<GLsizei>();
+			const void *memory = reader.memory();
+
+			if(index >= clientArrays.size())
+			{
+				clientArrays.resize(index + 1);
+			}
+
+			std::vector<unsigned char> &array = clientArrays[index];
+			array.assign((const unsigned char*)memory, (const unsigned char*)memory + reader.memorySize());
+
+			GLint arrayBuffer = 0;
+			glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glVertexAttribPointer(index, size, type, normalized, stride, array.data());
+			glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+
+			return true;
+		}
+
+		bool bufferData(Reader &reader)
+		{
+			GLenum target = reader.get<GLenum>();
+			GLsizeiptr size = (GLsizeiptr)reader.get<int64_t>();
+			const void *data = reader.memory();
+			GLenum usage = reader.get<GLenum>();
+
+			glBufferData(target, size, data, usage);
+
+			return true;
+		}
+
+		bool bufferSubData(Reader &reader)
+		{
+			GLenum target = reader.get<GLenum>();
+			GLintptr offset = (GLintptr)reader.get<int64_t>();
+			GLsizeiptr size = (GLsizeiptr)reader.get<int64_t>();
+			const void *data = reader.memory();
+
+			glBufferSubData(target, offset, size, data);
+
+			return true;
+		}
+
+		bool vertexAttribPointer(Reader &reader)
+		{
+			GLuint index = reader.get<GLuint>();
+			GLint size = reader.get<GLint>();
+			GLenum type = reader.get<GLenum>();
+			GLboolean normalized = reader.get<GLboolean>();
+			GLsizei stride = reader.get<GLsizei>();
+			const void *pointer = (const void*)(intptr_t)reader.get<int64_t>();
+
+			// Client memory pointers are replaced by a ClientArray record before each draw which uses them
+			glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+
+			return true;
+		}
+
+		bool shaderSource(Reader &reader)
+		{
+			GLuint shader = reader.get<GLuint>();
+			GLsizei count = reader.get<GLsizei>();
+
+			if(reader.atEnd())
+			{
+				glShaderSource(shader, count, nullptr, nullptr);
+				return true;
+			}
+
+			strings.clear();
+			lengths.clear();
+
+			for(GLsizei i = 0; i < count && !reader.overrun(); i++)
+			{
+				strings.push_back((const GLchar*)reader.memory());
+				lengths.push_back((GLint)reader.memorySize());
+			}
+
+			glShaderSource(shader, count, strings.data(), lengths.data());
+
+			return true;
+		}
+
+		bool readPixels(Reader &reader)
+		{
+			GLint x = reader.get<GLint>();
+			GLint y = reader.get<GLint>();
+			GLsizei width = reader.get<GLsizei>();
+			GLsizei height = reader.get<GLsizei>();
+			GLenum format = reader.get<GLenum>();
+			GLenum type = reader.get<GLenum>();
+			void *offset = (void*)reader.memory();   // Null unless into a pixel pack buffer
+			uint32_t size = reader.get<uint32_t>();
+
+			if(!offset)
+			{
+				pixels.resize(std::max(size, 1u));
+			}
+
+			glReadPixels(x, y, width, height, format, type, offset ? offset : pixels.data());
+
+			return true;
+		}
+
+		// Object names are allocated in the same order as when capturing, so names used by later calls match
+		bool generated(Reader &reader, void (GL_APIENTRY *generate)(GLsizei, GLuint*))
+		{
+			GLsizei n = reader.get<GLsizei>();
+			const GLuint *expected = reader.get<const GLuint*>();
+
+			names.resize(std::max(n, 1));
+			generate(n, names.data());
+
+			if(expected && n > 0 && memcmp(names.data(), expected, n * sizeof(GLuint)) != 0)
+			{
+				return fail("generated names differ from the captured ones");
+			}
+
+			return true;
+		}
+
+		bool createProgram(Reader &reader)
+		{
+			return created(glCreateProgram(), reader.get<GLuint>());
+		}
+
+		bool createShader(Reader &reader)
+		{
+			GLenum type = reader.get<GLenum>();
+
+			return created(glCreateShader(type), reader.get<GLuint>());
+		}
+
+		bool created(GLuint name, GLuint expected)
+		{
+			if(name != expected)
+			{
+				return fail("created name differs from the captured one");
+			}
+
+			return true;
+		}
+
+		const EGLDisplay display;
+		const std::vector<unsigned char> &trace;
+		size_t record = 0;
+
+		std::vector<Surface> contexts;   // Indexed by the captured context ID
+		std::vector<EGLConfig> configs;
+
+		std::vector<std::vector<uint64_t>> copies;
+		std::vector<std::vector<unsigned char>> clientArrays;   // Indexed by attribute
+		std::vector<const GLchar*> strings;
+		std::vector<GLint> lengths;
+		std::vector<unsigned char> pixels;
+		std::vector<GLuint> names;
+	};
+
+	bool load(const char *path, std::vector<unsigned char> &trace)
+	{
+		FILE *file = fopen(path, "rb");
+
+		if(!file)
+		{
+			fprintf(stderr, "Could not open %s\n", path);
+			return false;
+		}
+
+		unsigned char chunk[65536];
+		size_t bytes;
+
+		while((bytes = fread(chunk, 1, sizeof(chunk), file)) > 0)
+		{
+			trace.insert(trace.end(), chunk, chunk + bytes);
+		}
+
+		fclose(file);
+
+		uint32_t header[2] = {};
+
+		if(trace.size() >= sizeof(header))
+		{
+			memcpy(header, trace.data(), sizeof(header));
+		}
+
+		if(header[0] != CommandTrace::MAGIC || header[1] != CommandTrace::VERSION)
+		{
+			fprintf(stderr, "%s is not a version %d SwiftShader GL trace\n", path, CommandTrace::VERSION);
+			return false;
+		}
+
+		return true;
+	}
+
+	void usage()
+	{
+		fprintf(stderr, "Usage: GLTraceReplay [--repeat <passes>] [--skip <frames>] [--quiet] <trace>\n"
+		                "  --repeat  Replays the trace this many times, each in new contexts\n"
+		                "  --skip    Leaves this many frames of each pass out of the summary, such as loading frames\n"
+		                "  --quiet   Only prints the summary\n");
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *path = nullptr;
+	int repeat = 1;
+	int skip = 0;
+	bool quiet = false;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+		{
+			repeat = std::max(atoi(argv[++i]), 1);
+		}
+		else if(strcmp(argv[i], "--skip") == 0 && i + 1 < argc)
+		{
+			skip = std::max(atoi(argv[++i]), 0);
+		}
+		else if(strcmp(argv[i], "--quiet") == 0)
+		{
+			quiet = true;
+		}
+		else if(argv[i][0] != '-' && !path)
+		{
+			path = argv[i];
+		}
+		else
+		{
+			usage();
+			return 1;
+		}
+	}
+
+	std::vector<unsigned char> trace;
+
+	if(!path)
+	{
+		usage();
+		return 1;
+	}
+
+	if(!load(path, trace))
+	{
+		return 1;
+	}
+
+	EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if(!eglInitialize(display, nullptr, nullptr))
+	{
+		fprintf(stderr, "eglInitialize failed\n");
+		return 1;
+	}
+
+	std::vector<double> summary;
+
+	for(int pass = 0; pass < repeat; pass++)
+	{
+		std::vector<double> frameTimes;
+		bool complete = Replay(display, trace).run(frameTimes);
+
+		if(!quiet)
+		{
+			for(size_t frame = 0; frame < frameTimes.size(); frame++)
+			{
+				printf("pass %d frame %lu: %.3f ms\n", pass, (unsigned long)frame, frameTimes[frame]);
+			}
+		}
+
+		if(!complete)
+		{
+			eglTerminate(display);
+			return 1;
+		}
+
+		if(frameTimes.size() > (size_t)skip)
+		{
+			summary.insert(summary.end(), frameTimes.begin() + skip, frameTimes.end());
+		}
+	}
+
+	eglTerminate(display);
+
+	if(summary.empty())
+	{
+		printf("No frames to summarize\n");
+		return 0;
+	}
+
+	std::sort(summary.begin(), summary.end());
+
+	double total = 0.0;
+
+	for(double time : summary)
+	{
+		total += time;
+	}
+
+	double mean = total / summary.size();
+	double median = summary[summary.size() / 2];
+
+	printf("%lu frames: min %.3f ms, median %.3f ms, mean %.3f ms, max %.3f ms (%.1f frames/s)\n",
+	       (unsigned long)summary.size(), summary.front(), median, mean, summary.back(), 1000.0 / mean);
+
+	return 0;
+}
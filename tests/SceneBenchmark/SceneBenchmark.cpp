@@ -0,0 +1,641 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// SceneBenchmark.cpp: Renders a scene of spinning textured cubes, like OGLSimpleCube, into a pbuffer
+// without any window, and reports the distribution of the frame times. The scene complexity scales
+// with the number of cubes and textures, the layers of full screen overdraw behind them, the
+// multisampling and the resolution. The renderer's own settings, like its thread count, come from
+// SwiftShader.ini as usual, so runs with different settings can be compared on the same scene.
+//
+// Usage: SceneBenchmark [--width <pixels>] [--height <pixels>] [--objects <cubes>] [--textures <count>]
+//                       [--overdraw <layers>] [--front-to-back] [--samples <count>]
+//                       [--frames <count>] [--warmup <frames>] [--quiet]
+
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct Options
+	{
+		int width = 1024;
+		int height = 768;
+		int objects = 64;
+		int textures = 4;
+		int overdraw = 0;             // Full screen layers behind the cubes
+		bool frontToBack = false;     // Draws the layers nearest first, so depth testing rejects the hidden ones
+		int samples = 1;
+		int frames = 200;
+		int warmup = 10;              // Not included in the statistics, they include the routine compilation
+		bool quiet = false;
+	};
+
+	const char *const cubeVertexShader =
+		"#version 300 es\n"
+		"in vec3 position;\n"
+		"in vec3 normal;\n"
+		"in vec2 texCoord;\n"
+		"uniform mat4 transform;\n"
+		"uniform mat3 rotation;\n"
+		"out vec2 uv;\n"
+		"out float light;\n"
+		"void main()\n"
+		"{\n"
+		"	uv = texCoord;\n"
+		"	light = 0.3 + 0.7 * max(dot(rotation * normal, normalize(vec3(0.3, 0.5, 1.0))), 0.0);\n"
+		"	gl_Position = transform * vec4(position, 1.0);\n"
+		"}\n";
+
+	const char *const cubeFragmentShader =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D tex;\n"
+		"in vec2 uv;\n"
+		"in float light;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = vec4(texture(tex, uv).rgb * light, 1.0);\n"
+		"}\n";
+
+	const char *const layerVertexShader =
+		"#version 300 es\n"
+		"in vec2 position;\n"
+		"uniform float depth;\n"
+		"out vec2 uv;\n"
+		"void main()\n"
+		"{\n"
+		"	uv = position * 0.5 + 0.5;\n"
+		"	gl_Position = vec4(position, depth, 1.0);\n"
+		"}\n";
+
+	const char *const layerFragmentShader =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D tex;\n"
+		"uniform vec4 tint;\n"
+		"in vec2 uv;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = texture(tex, uv * 4.0) * tint;\n"
+		"}\n";
+
+	// Column-major, like OpenGL
+	struct Matrix
+	{
+		float m[16];
+
+		static Matrix identity()
+		{
+			Matrix matrix = {};
+			matrix.m[0] = matrix.m[5] = matrix.m[10] = matrix.m[15] = 1.0f;
+			return matrix;
+		}
+
+		static Matrix perspective(float fovy, float aspect, float near, float far)
+		{
+			float f = 1.0f / tanf(fovy / 2.0f);
+			Matrix matrix = {};
+			matrix.m[0] = f / aspect;
+			matrix.m[5] = f;
+			matrix.m[10] = (far + near) / (near - far);
+			matrix.m[11] = -1.0f;
+			matrix.m[14] = 2.0f * far * near / (near - far);
+			return matrix;
+		}
+
+		static Matrix translation(float x, float y, float z)
+		{
+			Matrix matrix = identity();
+			matrix.m[12] = x;
+			matrix.m[13] = y;
+			matrix.m[14] = z;
+			return matrix;
+		}
+
+		static Matrix rotation(float angle, float x, float y, float z)
+		{
+			float length = sqrtf(x * x + y * y + z * z);
+			x /= length; y /= length; z /= length;
+			float c = cosf(angle);
+			float s = sinf(angle);
+			float t = 1.0f - c;
+
+			Matrix matrix = identity();
+			matrix.m[0] = t * x * x + c;     matrix.m[4] = t * x * y - s * z; matrix.m[8] = t * x * z + s * y;
+			matrix.m[1] = t * x * y + s * z; matrix.m[5] = t * y * y + c;     matrix.m[9] = t * y * z - s * x;
+			matrix.m[2] = t * x * z - s * y; matrix.m[6] = t * y * z + s * x; matrix.m[10] = t * z * z + c;
+			return matrix;
+		}
+
+		Matrix operator*(const Matrix &other) const
+		{
+			Matrix product;
+
+			for(int column = 0; column < 4; column++)
+			{
+				for(int row = 0; row < 4; row++)
+				{
+					float sum = 0.0f;
+
+					for(int i = 0; i < 4; i++)
+					{
+						sum += m[i * 4 + row] * other.m[column * 4 + i];
+					}
+
+					product.m[column * 4 + row] = sum;
+				}
+			}
+
+			return product;
+		}
+	};
+
+	void usage()
+	{
+		printf("Usage: SceneBenchmark [--width <pixels>] [--height <pixels>] [--objects <cubes>] [--textures <count>]\n"
+		       "                      [--overdraw <layers>] [--front-to-back] [--samples <count>]\n"
+		       "                      [--frames <count>] [--warmup <frames>] [--quiet]\n");
+	}
+
+	bool parse(int argc, char **argv, Options &options)
+	{
+		for(int i = 1; i < argc; i++)
+		{
+			int *value = nullptr;
+			int minimum = 1;
+
+			if(strcmp(argv[i], "--width") == 0) value = &options.width;
+			else if(strcmp(argv[i], "--height") == 0) value = &options.height;
+			else if(strcmp(argv[i], "--objects") == 0) { value = &options.objects; minimum = 0; }
+			else if(strcmp(argv[i], "--textures") == 0) value = &options.textures;
+			else if(strcmp(argv[i], "--overdraw") == 0) { value = &options.overdraw; minimum = 0; }
+			else if(strcmp(argv[i], "--samples") == 0) value = &options.samples;
+			else if(strcmp(argv[i], "--frames") == 0) value = &options.frames;
+			else if(strcmp(argv[i], "--warmup") == 0) { value = &options.warmup; minimum = 0; }
+			else if(strcmp(argv[i], "--front-to-back") == 0) { options.frontToBack = true; continue; }
+			else if(strcmp(argv[i], "--quiet") == 0) { options.quiet = true; continue; }
+			else return false;
+
+			if(i + 1 >= argc)
+			{
+				return false;
+			}
+
+			*value = std::max(atoi(argv[++i]), minimum);
+		}
+
+		return true;
+	}
+
+	GLuint compile(GLenum type, const char *source)
+	{
+		GLuint shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		GLint compiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+
+		if(!compiled)
+		{
+			char log[1024] = "";
+			glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+			fprintf(stderr, "Shader compilation failed: %s\n", log);
+		}
+
+		return shader;
+	}
+
+	GLuint link(const char *vertexSource, const char *fragmentSource, const char *const *attributes, int attributeCount)
+	{
+		GLuint program = glCreateProgram();
+		GLuint vertexShader = compile(GL_VERTEX_SHADER, vertexSource);
+		GLuint fragmentShader = compile(GL_FRAGMENT_SHADER, fragmentSource);
+
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+
+		for(int i = 0; i < attributeCount; i++)
+		{
+			glBindAttribLocation(program, i, attributes[i]);
+		}
+
+		glLinkProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		return program;
+	}
+
+	// Mipmapped checkerboards with a different pair of colors each
+	std::vector<GLuint> createTextures(int count)
+	{
+		const int size = 256;
+		std::vector<GLuint> textures(count);
+		std::vector<unsigned char> texels(size * size * 4);
+
+		glGenTextures(count, textures.data());
+
+		for(int t = 0; t < count; t++)
+		{
+			unsigned char a[3] = {(unsigned char)(80 + 47 * t), (unsigned char)(200 - 31 * t), (unsigned char)(120 + 73 * t)};
+			unsigned char b[3] = {(unsigned char)(255 - a[0]), (unsigned char)(255 - a[1]), (unsigned char)(255 - a[2])};
+
+			for(int y = 0; y < size; y++)
+			{
+				for(int x = 0; x < size; x++)
+				{
+					const unsigned char *color = (((x >> 5) ^ (y >> 5)) & 1) ? a : b;
+					unsigned char *texel = &texels[(y * size + x) * 4];
+
+					texel[0] = color[0];
+					texel[1] = color[1];
+					texel[2] = color[2];
+					texel[3] = 255;
+				}
+			}
+
+			glBindTexture(GL_TEXTURE_2D, textures[t]);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+			glGenerateMipmap(GL_TEXTURE_2D);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		}
+
+		return textures;
+	}
+
+	// Interleaved position, normal and texture coordinates of the 24 vertices of a unit cube
+	void createCube(GLuint &vertexBuffer, GLuint &indexBuffer)
+	{
+		const float faces[6][3][3] =   // Normal, then the two tangents spanning the face
+		{
+			{{ 0,  0,  1}, {1, 0,  0}, {0, 1,  0}},
+			{{ 0,  0, -1}, {-1, 0, 0}, {0, 1,  0}},
+			{{ 1,  0,  0}, {0, 0, -1}, {0, 1,  0}},
+			{{-1,  0,  0}, {0, 0,  1}, {0, 1,  0}},
+			{{ 0,  1,  0}, {1, 0,  0}, {0, 0, -1}},
+			{{ 0, -1,  0}, {1, 0,  0}, {0, 0,  1}},
+		};
+
+		std::vector<float> vertices;
+		std::vector<GLushort> indices;
+
+		for(int face = 0; face < 6; face++)
+		{
+			const float *n = faces[face][0];
+			const float *u = faces[face][1];
+			const float *v = faces[face][2];
+
+			for(int corner = 0; corner < 4; corner++)
+			{
+				float s = (corner == 1 || corner == 2) ? 1.0f : 0.0f;
+				float t = (corner >= 2) ? 1.0f : 0.0f;
+
+				for(int i = 0; i < 3; i++)
+				{
+					vertices.push_back(0.5f * n[i] + (s - 0.5f) * u[i] + (t - 0.5f) * v[i]);
+				}
+
+				vertices.insert(vertices.end(), {n[0], n[1], n[2], s, t});
+			}
+
+			GLushort base = (GLushort)(face * 4);
+			indices.insert(indices.end(), {base, (GLushort)(base + 1), (GLushort)(base + 2), base, (GLushort)(base + 2), (GLushort)(base + 3)});
+		}
+
+		glGenBuffers(1, &vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+		glGenBuffers(1, &indexBuffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+	}
+
+	double percentile(const std::vector<double> &sorted, double fraction)
+	{
+		size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	class Scene
+	{
+	public:
+		explicit Scene(const Options &options) : options(options)
+		{
+		}
+
+		bool initialize()
+		{
+			const char *const cubeAttributes[] = {"position", "normal", "texCoord"};
+			const char *const layerAttributes[] = {"position"};
+
+			cubeProgram = link(cubeVertexShader, cubeFragmentShader, cubeAttributes, 3);
+			layerProgram = link(layerVertexShader, layerFragmentShader, layerAttributes, 1);
+
+			transformLocation = glGetUniformLocation(cubeProgram, "transform");
+			rotationLocation = glGetUniformLocation(cubeProgram, "rotation");
+			depthLocation = glGetUniformLocation(layerProgram, "depth");
+			tintLocation = glGetUniformLocation(layerProgram, "tint");
+
+			textures = createTextures(options.textures);
+			createCube(cubeVertices, cubeIndices);
+
+			const float quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+			glGenBuffers(1, &layerVertices);
+			glBindBuffer(GL_ARRAY_BUFFER, layerVertices);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+			if(options.samples > 1)
+			{
+				// Rendered into a multisampled framebuffer, which each frame resolves into a single sampled one
+				glGenRenderbuffers(3, renderbuffers);
+				glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+				glRenderbufferStorageMultisample(GL_RENDERBUFFER, options.samples, GL_RGBA8, options.width, options.height);
+				glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+				glRenderbufferStorageMultisample(GL_RENDERBUFFER, options.samples, GL_DEPTH_COMPONENT24, options.width, options.height);
+				glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[2]);
+				glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, options.width, options.height);
+
+				glGenFramebuffers(1, &resolveFramebuffer);
+				glBindFramebuffer(GL_FRAMEBUFFER, resolveFramebuffer);
+				glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[2]);
+
+				glGenFramebuffers(1, &framebuffer);
+				glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+				glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+				glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+				if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+				{
+					fprintf(stderr, "The %d sample framebuffer is incomplete\n", options.samples);
+					return false;
+				}
+			}
+
+			glViewport(0, 0, options.width, options.height);
+			glEnable(GL_DEPTH_TEST);
+			glEnable(GL_CULL_FACE);
+
+			return glGetError() == GL_NO_ERROR;
+		}
+
+		void draw(int frame)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			drawCubes(frame);
+			drawLayers();
+
+			if(framebuffer)
+			{
+				glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+				glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFramebuffer);
+				glBlitFramebuffer(0, 0, options.width, options.height, 0, 0, options.width, options.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+				glBindFramebuffer(GL_READ_FRAMEBUFFER, resolveFramebuffer);
+			}
+		}
+
+	private:
+		// On a grid filling the view, each spinning around its own axis
+		void drawCubes(int frame)
+		{
+			if(options.objects == 0)
+			{
+				return;
+			}
+
+			glUseProgram(cubeProgram);
+			glBindBuffer(GL_ARRAY_BUFFER, cubeVertices);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeIndices);
+			glEnableVertexAttribArray(0);
+			glEnableVertexAttribArray(1);
+			glEnableVertexAttribArray(2);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+
+			float aspect = (float)options.width / options.height;
+			Matrix projection = Matrix::perspective(0.8f, aspect, 1.0f, 100.0f);
+			int columns = (int)ceilf(sqrtf(options.objects * aspect));
+			int rows = (options.objects + columns - 1) / columns;
+			float spacing = 1.6f;
+			float distance = std::max(columns / aspect, (float)rows) * spacing * 1.2f + 2.0f;
+
+			for(int i = 0; i < options.objects; i++)
+			{
+				float x = (i % columns - (columns - 1) * 0.5f) * spacing;
+				float y = (i / columns - (rows - 1) * 0.5f) * spacing;
+				float angle = 0.02f * frame + 0.7f * i;
+
+				Matrix rotation = Matrix::rotation(angle, 1.0f + (i % 3), 1.0f + (i % 5), 0.5f);
+				Matrix transform = projection * Matrix::translation(x, y, -distance) * rotation;
+				float normalMatrix[9] =
+				{
+					rotation.m[0], rotation.m[1], rotation.m[2],
+					rotation.m[4], rotation.m[5], rotation.m[6],
+					rotation.m[8], rotation.m[9], rotation.m[10],
+				};
+
+				glBindTexture(GL_TEXTURE_2D, textures[i % textures.size()]);
+				glUniformMatrix4fv(transformLocation, 1, GL_FALSE, transform.m);
+				glUniformMatrix3fv(rotationLocation, 1, GL_FALSE, normalMatrix);
+				glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, nullptr);
+			}
+
+			glDisableVertexAttribArray(1);
+			glDisableVertexAttribArray(2);
+		}
+
+		// Behind the cubes, all passing the depth test when drawn back to front
+		void drawLayers()
+		{
+			if(options.overdraw == 0)
+			{
+				return;
+			}
+
+			glUseProgram(layerProgram);
+			glBindBuffer(GL_ARRAY_BUFFER, layerVertices);
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+			for(int layer = 0; layer < options.overdraw; layer++)
+			{
+				int order = options.frontToBack ? layer : options.overdraw - 1 - layer;
+				float depth = 0.995f + 0.004f * order / options.overdraw;   // Nearer for lower orders, but behind the cubes
+
+				glBindTexture(GL_TEXTURE_2D, textures[layer % textures.size()]);
+				glUniform1f(depthLocation, depth);
+				glUniform4f(tintLocation, 0.5f + 0.5f * (order & 1), 0.5f, 0.5f + 0.5f * ((order >> 1) & 1), 1.0f);
+				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			}
+		}
+
+		const Options &options;
+
+		GLuint cubeProgram = 0;
+		GLuint layerProgram = 0;
+		GLint transformLocation = -1;
+		GLint rotationLocation = -1;
+		GLint depthLocation = -1;
+		GLint tintLocation = -1;
+
+		std::vector<GLuint> textures;
+		GLuint cubeVertices = 0;
+		GLuint cubeIndices = 0;
+		GLuint layerVertices = 0;
+
+		GLuint framebuffer = 0;          // Zero when rendering directly into the pbuffer
+		GLuint resolveFramebuffer = 0;
+		GLuint renderbuffers[3] = {};
+	};
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+
+	if(!parse(argc, argv, options))
+	{
+		usage();
+		return 1;
+	}
+
+	EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if(!eglInitialize(display, nullptr, nullptr))
+	{
+		fprintf(stderr, "eglInitialize failed\n");
+		return 1;
+	}
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 8,
+		EGL_DEPTH_SIZE, 24,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+
+	if(!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+	{
+		fprintf(stderr, "No pbuffer configuration with OpenGL ES 3 support\n");
+		eglTerminate(display);
+		return 1;
+	}
+
+	const EGLint surfaceAttributes[] = {EGL_WIDTH, options.width, EGL_HEIGHT, options.height, EGL_NONE};
+	const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+	if(surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+	{
+		fprintf(stderr, "Failed to create the %dx%d pbuffer and its context\n", options.width, options.height);
+		eglTerminate(display);
+		return 1;
+	}
+
+	Scene scene(options);
+
+	if(!scene.initialize())
+	{
+		fprintf(stderr, "Failed to set up the scene\n");
+		eglTerminate(display);
+		return 1;
+	}
+
+	printf("%dx%d, %d samples, %d cubes, %d textures, %d overdraw layers drawn %s\n",
+	       options.width, options.height, options.samples, options.objects, options.textures, options.overdraw,
+	       options.frontToBack ? "front to back" : "back to front");
+
+	std::vector<double> frameTimes;
+	unsigned char pixel[4];
+
+	for(int frame = 0; frame < options.warmup + options.frames; frame++)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		scene.draw(frame);
+
+		// Waits for the frame like presenting it would, with a read which costs next to nothing
+		glReadPixels(0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+		eglSwapBuffers(display, surface);
+
+		double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if(!options.quiet)
+		{
+			printf("frame %d: %.3f ms%s\n", frame, time, frame < options.warmup ? " (warmup)" : "");
+		}
+
+		if(frame >= options.warmup)
+		{
+			frameTimes.push_back(time);
+		}
+	}
+
+	GLenum error = glGetError();
+
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext(display, context);
+	eglDestroySurface(display, surface);
+	eglTerminate(display);
+
+	if(error != GL_NO_ERROR)
+	{
+		fprintf(stderr, "Rendering failed with GL error 0x%04X\n", error);
+		return 1;
+	}
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+
+	double total = 0.0;
+
+	for(double time : frameTimes)
+	{
+		total += time;
+	}
+
+	double mean = total / frameTimes.size();
+
+	printf("%lu frames: min %.3f ms, p50 %.3f ms, p90 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms, mean %.3f ms (%.1f frames/s)\n",
+	       (unsigned long)frameTimes.size(), frameTimes.front(), percentile(frameTimes, 0.5), percentile(frameTimes, 0.9),
+	       percentile(frameTimes, 0.95), percentile(frameTimes, 0.99), frameTimes.back(), mean, 1000.0 / mean);
+
+	return 0;
+}
@@ -0,0 +1,126 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ClipperBenchmarks.cpp: Clips random triangles which all cross the near plane, like the ones
+// close to the eye in first-person views, and some which also cross the viewport sides or user
+// clip planes, to measure how many triangles per second the clipper hands to setup.
+
+#include "Renderer/Clipper.hpp"
+#include "Renderer/Polygon.hpp"
+#include "Renderer/Renderer.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+using namespace sw;
+
+namespace
+{
+	const int triangleCount = 4096;
+
+	enum Scene
+	{
+		NEAR_ONLY,    // Crossing the near plane
+		NEAR_SIDES,   // Also crossing the left or right side
+		USER_PLANES   // Crossing the near plane and two user clip planes
+	};
+
+	struct Triangles
+	{
+		std::vector<float4> vertices;
+		std::vector<int> clipFlags;
+	};
+
+	Triangles generate(Scene scene)
+	{
+		std::mt19937 engine(1);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+		Triangles triangles;
+
+		for(int t = 0; t < triangleCount; t++)
+		{
+			int clipFlags = Clipper::CLIP_FINITE | Clipper::CLIP_NEAR;
+
+			for(int k = 0; k < 3; k++)
+			{
+				float w = 1.5f + 0.5f * unit(engine);
+				float x = 0.9f * unit(engine) * w;
+				float y = 0.9f * unit(engine) * w;
+				float z = (k == 0 ? -0.5f : 0.5f) * w;
+
+				if(scene == NEAR_SIDES && k == 1)
+				{
+					x = (t % 2 ? 3.0f : -3.0f) * w;
+					clipFlags |= (t % 2) ? Clipper::CLIP_RIGHT : Clipper::CLIP_LEFT;
+				}
+
+				triangles.vertices.push_back(vector(x, y, z, w));
+			}
+
+			if(scene == USER_PLANES)
+			{
+				clipFlags |= Clipper::CLIP_PLANE0 | Clipper::CLIP_PLANE1;
+			}
+
+			triangles.clipFlags.push_back(clipFlags);
+		}
+
+		return triangles;
+	}
+
+	void setUp(DrawCall &draw, Scene scene)
+	{
+		draw.clipFlags = 0;
+
+		if(scene == USER_PLANES)
+		{
+			draw.clipFlags = Clipper::CLIP_PLANE0 | Clipper::CLIP_PLANE1;
+			draw.data->clipPlane[0] = Plane(1.0f, 0.5f, 0.0f, 0.2f);
+			draw.data->clipPlane[1] = Plane(-0.5f, 1.0f, 0.0f, 0.3f);
+		}
+	}
+
+	void Clip(benchmark::State &state, Scene scene)
+	{
+		Clipper clipper(false);
+		DrawCall draw;
+		setUp(draw, scene);
+
+		Triangles triangles = generate(scene);
+		int64_t visible = 0;
+
+		for(auto _ : state)
+		{
+			for(int t = 0; t < triangleCount; t++)
+			{
+				const float4 *V = &triangles.vertices[3 * t];
+				Polygon polygon(&V[0], &V[1], &V[2]);
+
+				visible += clipper.clip(polygon, triangles.clipFlags[t], draw);
+			}
+		}
+
+		state.counters["triangles/s"] = benchmark::Counter((double)state.iterations() * triangleCount, benchmark::Counter::kIsRate);
+		state.counters["visible"] = (double)visible / state.iterations();
+	}
+}
+
+BENCHMARK_CAPTURE(Clip, NearOnly, NEAR_ONLY);
+BENCHMARK_CAPTURE(Clip, NearAndSides, NEAR_SIDES);
+BENCHMARK_CAPTURE(Clip, UserPlanes, USER_PLANES);
+
+BENCHMARK_MAIN();
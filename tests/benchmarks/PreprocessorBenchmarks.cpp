@@ -0,0 +1,147 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// PreprocessorBenchmarks.cpp: Runs the GLSL preprocessor alone over generated shaders of about
+// 10000 lines, the size of large shaders after their includes are pasted in, to measure how many
+// tokens per second it delivers to the parser. The shaders range from plain code to code which
+// mostly consists of nested function-like macro invocations.
+
+#include "OpenGL/compiler/preprocessor/DiagnosticsBase.h"
+#include "OpenGL/compiler/preprocessor/DirectiveHandlerBase.h"
+#include "OpenGL/compiler/preprocessor/Preprocessor.h"
+#include "OpenGL/compiler/preprocessor/Token.h"
+
+#include "benchmark/benchmark.h"
+
+#include <string>
+
+namespace
+{
+	const int lineCount = 10000;
+
+	class Diagnostics : public pp::Diagnostics
+	{
+	public:
+		int errors = 0;
+
+	protected:
+		void print(ID id, const pp::SourceLocation &loc, const std::string &text) override
+		{
+			errors++;
+		}
+	};
+
+	class DirectiveHandler : public pp::DirectiveHandler
+	{
+	public:
+		void handleError(const pp::SourceLocation &loc, const std::string &msg) override {}
+		void handlePragma(const pp::SourceLocation &loc, const std::string &name, const std::string &value, bool stdgl) override {}
+		void handleExtension(const pp::SourceLocation &loc, const std::string &name, const std::string &behavior) override {}
+		void handleVersion(const pp::SourceLocation &loc, int version) override {}
+	};
+
+	// Statements without any macros
+	std::string plainShader()
+	{
+		std::string source = "precision highp float;\nuniform vec4 u[16];\nvarying vec4 v;\n";
+
+		for(int i = 0; source.size() < 40 * lineCount; i++)
+		{
+			std::string n = std::to_string(i);
+			source += "vec4 f" + n + "(vec4 a, float b)\n{\n";
+			source += "\tvec4 t" + n + " = a * u[" + std::to_string(i % 16) + "] + vec4(b, " + n + ".0, 0.5, 1.0);\n";
+			source += "\tt" + n + ".xy += normalize(t" + n + ".zw) * dot(a.xyz, v.xyz);\n";
+			source += "\treturn clamp(t" + n + ", 0.0, 1.0) * (b >= 0.5 ? 1.0 : 2.0);\n}\n";
+		}
+
+		return source;
+	}
+
+	// Object-like macros and conditional blocks around otherwise plain code
+	std::string objectMacroShader()
+	{
+		std::string source = "precision highp float;\n#define SCALE 0.5\n#define BIAS vec4(0.25)\n#define COUNT 16\n#define ENABLE_FOG 1\n";
+
+		for(int i = 0; source.size() < 40 * lineCount; i++)
+		{
+			std::string n = std::to_string(i);
+			source += "#define VALUE" + n + " (SCALE * " + n + ".0 + BIAS.x)\n";
+			source += "#if defined(ENABLE_FOG) && COUNT > " + std::to_string(i % 32) + "\n";
+			source += "float g" + n + "(float a) { return a * VALUE" + n + " + SCALE; }\n";
+			source += "#else\nfloat g" + n + "(float a) { return a; }\n#endif\n";
+		}
+
+		return source;
+	}
+
+	// Nested function-like macros with several arguments, like generated shader permutations
+	std::string functionMacroShader()
+	{
+		std::string source =
+			"precision highp float;\n"
+			"#define MUL(a, b) ((a) * (b))\n"
+			"#define MAD(a, b, c) (MUL(a, b) + (c))\n"
+			"#define LERP(a, b, t) MAD((b) - (a), t, a)\n"
+			"#define SAMPLE(s, uv, bias) texture2D(s, LERP(uv, (uv).yx, bias), bias)\n"
+			"#define LIGHT(n, l, color) MUL(max(dot(n, l), 0.0), color)\n"
+			"uniform sampler2D s;\nvarying vec2 uv;\nvarying vec3 n;\n";
+
+		for(int i = 0; source.size() < 40 * lineCount; i++)
+		{
+			std::string n = std::to_string(i);
+			source += "vec4 h" + n + "(vec3 l, vec4 c)\n{\n";
+			source += "\tvec4 t = SAMPLE(s, uv * " + n + ".0, MAD(0.5, c.x, 0.25));\n";
+			source += "\treturn LERP(t, LIGHT(n, l, c), MUL(c.w, " + n + ".0));\n}\n";
+		}
+
+		return source;
+	}
+
+	void Preprocess(benchmark::State &state, std::string (*generate)())
+	{
+		const std::string source = generate();
+		const char *string = source.c_str();
+		int64_t tokens = 0;
+		int errors = 0;
+
+		for(auto _ : state)
+		{
+			Diagnostics diagnostics;
+			DirectiveHandler directiveHandler;
+			pp::Preprocessor preprocessor(&diagnostics, &directiveHandler, pp::PreprocessorSettings());
+			preprocessor.init(1, &string, nullptr);
+
+			pp::Token token;
+			do
+			{
+				preprocessor.lex(&token);
+				tokens++;
+			}
+			while(token.type != pp::Token::LAST);
+
+			errors += diagnostics.errors;
+		}
+
+		state.counters["tokens/s"] = benchmark::Counter((double)tokens, benchmark::Counter::kIsRate);
+		state.counters["source_bytes"] = (double)source.size();
+		state.counters["errors"] = errors;
+		state.SetBytesProcessed(state.iterations() * source.size());
+	}
+}
+
+BENCHMARK_CAPTURE(Preprocess, Plain, plainShader)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(Preprocess, ObjectMacros, objectMacroShader)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(Preprocess, FunctionMacros, functionMacroShader)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,295 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ReactorBenchmarks.cpp: Measures the code generated by one Reactor back-end, independently of
+// the renderer. Each kernel resembles a part of the routines SwiftShader generates, and is
+// benchmarked both for compile time and code size, and for the throughput of the generated code,
+// at each optimization level.
+
+#include "Reactor/Reactor.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace sw;
+
+namespace
+{
+	// All kernels take (destination, source, table, count) and process count elements of 16 bytes
+	typedef void (*Kernel)(void *destination, const void *source, const void *table, int count);
+
+	const int tableSize = 256;   // Texels in the table looked up by the gather kernel
+
+	// Alpha blending of RGBA floating-point pixels, like the pixel pipeline's blending stage
+	Routine *blend()
+	{
+		Function<Void(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Int)> function;
+		{
+			Pointer<Byte> destination = function.Arg<0>();
+			Pointer<Byte> source = function.Arg<1>();
+			Int count = function.Arg<3>();
+
+			For(Int i = 0, i < count, i++)
+			{
+				Float4 s = *Pointer<Float4>(source + 16 * i, 16);
+				Float4 d = *Pointer<Float4>(destination + 16 * i, 16);
+				Float4 alpha = s.wwww;
+
+				*Pointer<Float4>(destination + 16 * i, 16) = s * alpha + d * (Float4(1.0f) - alpha);
+			}
+
+			Return();
+		}
+
+		return function(L"Blend");
+	}
+
+	// Wrapping of texture coordinates and texel offsets, like the sampler's address computation
+	Routine *address()
+	{
+		Function<Void(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Int)> function;
+		{
+			Pointer<Byte> destination = function.Arg<0>();
+			Pointer<Byte> source = function.Arg<1>();
+			Int count = function.Arg<3>();
+
+			For(Int i = 0, i < count, i++)
+			{
+				Float4 u = *Pointer<Float4>(source + 16 * i, 16);
+				Int4 x = RoundInt(Frac(u) * Float4(float(tableSize)));
+				x = Max(Min(x, Int4(tableSize - 1)), Int4(0));
+
+				*Pointer<Int4>(destination + 16 * i, 16) = x * Int4(4);
+			}
+
+			Return();
+		}
+
+		return function(L"Address");
+	}
+
+	// Table lookups at computed offsets, like fetching the texels of a quad
+	Routine *gather()
+	{
+		Function<Void(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Int)> function;
+		{
+			Pointer<Byte> destination = function.Arg<0>();
+			Pointer<Byte> source = function.Arg<1>();
+			Pointer<Byte> table = function.Arg<2>();
+			Int count = function.Arg<3>();
+
+			For(Int i = 0, i < count, i++)
+			{
+				Int4 offset = *Pointer<Int4>(source + 16 * i, 16) & Int4((tableSize - 1) * 4);
+				Int4 texel;
+
+				texel = Insert(texel, *Pointer<Int>(table + Extract(offset, 0)), 0);
+				texel = Insert(texel, *Pointer<Int>(table + Extract(offset, 1)), 1);
+				texel = Insert(texel, *Pointer<Int>(table + Extract(offset, 2)), 2);
+				texel = Insert(texel, *Pointer<Int>(table + Extract(offset, 3)), 3);
+
+				*Pointer<Int4>(destination + 16 * i, 16) = texel;
+			}
+
+			Return();
+		}
+
+		return function(L"Gather");
+	}
+
+	// Data dependent loops and branches, like shaders with dynamic control flow
+	Routine *branch()
+	{
+		Function<Void(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Int)> function;
+		{
+			Pointer<Byte> destination = function.Arg<0>();
+			Pointer<Byte> source = function.Arg<1>();
+			Int count = function.Arg<3>();
+
+			For(Int i = 0, i < 4 * count, i++)
+			{
+				Int value = (*Pointer<Int>(source + 4 * i) & Int(0xFFFF)) | Int(1);
+				Int steps = 0;
+
+				While(value != Int(1) && steps < Int(64))
+				{
+					If((value & Int(1)) == Int(0))
+					{
+						value = value >> 1;
+					}
+					Else
+					{
+						value = value * Int(3) + Int(1);
+					}
+
+					steps++;
+				}
+
+				*Pointer<Int>(destination + 4 * i) = steps;
+			}
+
+			Return();
+		}
+
+		return function(L"Branch");
+	}
+
+	struct KernelInfo
+	{
+		const char *name;
+		Routine *(*build)();
+	};
+
+	const KernelInfo kernels[] =
+	{
+		{"Blend", blend},
+		{"Address", address},
+		{"Gather", gather},
+		{"Branch", branch},
+	};
+
+	const char *levelNames[] = {"Quick", "Default", "Hot"};
+
+	// Generates the routine at the given level, restoring the default level afterwards
+	Routine *build(const KernelInfo &kernel, OptimizationLevel level)
+	{
+		Nucleus::setOptimizationLevel(level);
+		Routine *routine = kernel.build();
+		Nucleus::setOptimizationLevel(OptimizationDefault);
+
+		return routine;
+	}
+
+	void Compile(benchmark::State &state, const KernelInfo &kernel)
+	{
+		OptimizationLevel level = (OptimizationLevel)state.range(0);
+		state.SetLabel(levelNames[level]);
+
+		RoutineTelemetry::reset();
+		RoutineTelemetry::setEnabled(true);
+
+		for(auto _ : state)
+		{
+			Routine *routine = build(kernel, level);
+
+			if(!routine)
+			{
+				state.SkipWithError("Routine generation failed");
+				break;
+			}
+
+			delete routine;
+		}
+
+		RoutineTelemetry::setEnabled(false);
+
+		std::map<std::string, RoutineStatistics> statistics = RoutineTelemetry::getStatistics();
+		const RoutineStatistics &entry = statistics[kernel.name];
+
+		if(entry.compilations > 0)
+		{
+			double compilations = (double)entry.compilations;
+
+			state.counters["code_bytes"] = entry.codeSize / compilations;
+			state.counters["build_us"] = 1e6 * entry.buildTime / compilations;
+			state.counters["optimize_us"] = 1e6 * entry.optimizeTime / compilations;
+			state.counters["codegen_us"] = 1e6 * entry.codegenTime / compilations;
+		}
+
+		RoutineTelemetry::reset();
+	}
+
+	void Execute(benchmark::State &state, const KernelInfo &kernel)
+	{
+		OptimizationLevel level = (OptimizationLevel)state.range(0);
+		int count = (int)state.range(1);
+		state.SetLabel(levelNames[level]);
+
+		Routine *routine = build(kernel, level);
+
+		if(!routine)
+		{
+			state.SkipWithError("Routine generation failed");
+			return;
+		}
+
+		Kernel entry = (Kernel)routine->getEntry();
+
+		// Elements are four floats or integers. Integer data is also a valid float, and vice versa.
+		std::vector<float> source(4 * count);
+		std::vector<float> destination(4 * count, 0.5f);
+		std::vector<int> table(tableSize);
+
+		for(int i = 0; i < 4 * count; i++)
+		{
+			source[i] = (float)((i * 37) % 1024) / 512.0f;
+		}
+
+		for(int i = 0; i < tableSize; i++)
+		{
+			table[i] = i * 0x00010101;
+		}
+
+		for(auto _ : state)
+		{
+			entry(destination.data(), source.data(), table.data(), count);
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+		state.SetBytesProcessed(state.iterations() * count * 16);
+
+		delete routine;
+	}
+
+	void registerBenchmarks()
+	{
+		for(const KernelInfo &kernel : kernels)
+		{
+			std::string name = kernel.name;
+
+			benchmark::RegisterBenchmark(("Compile/" + name).c_str(), Compile, kernel)
+				->DenseRange(OptimizationQuick, OptimizationHot)
+				->ArgName("level")
+				->Unit(benchmark::kMicrosecond);
+
+			benchmark::RegisterBenchmark(("Execute/" + name).c_str(), Execute, kernel)
+				->ArgsProduct({{OptimizationQuick, OptimizationDefault, OptimizationHot}, {64, 4096}})
+				->ArgNames({"level", "count"});
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	benchmark::Initialize(&argc, argv);
+
+	if(benchmark::ReportUnrecognizedArguments(argc, argv))
+	{
+		return 1;
+	}
+
+	#if defined(REACTOR_BACKEND_NAME)
+		benchmark::AddCustomContext("reactor_backend", REACTOR_BACKEND_NAME);
+	#endif
+
+	registerBenchmarks();
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,560 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// RoutineBenchmarks.cpp: Generates vertex and pixel routines for random but plausible pipeline
+// states, like VertexRoutineFuzzer does for correctness, to measure how many routines per second
+// the JIT produces and how the routine cache behaves when an application cycles through more
+// states than it holds. The states use the fixed-function pipelines, which don't need shaders.
+
+#include "Renderer/RoutineCache.hpp"
+#include "Renderer/PixelProcessor.hpp"
+#include "Renderer/VertexProcessor.hpp"
+#include "Shader/PixelPipeline.hpp"
+#include "Shader/VertexPipeline.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace sw;
+
+namespace
+{
+	const char *levelNames[] = {"Quick", "Default", "Hot"};
+
+	class Random
+	{
+	public:
+		explicit Random(unsigned int seed) : engine(seed) {}
+
+		int operator()(int n)   // In [0, n)
+		{
+			return std::uniform_int_distribution<int>(0, n - 1)(engine);
+		}
+
+		bool chance(int percent)
+		{
+			return (*this)(100) < percent;
+		}
+
+		template<typename T, size_t N>
+		T pick(const T (&values)[N])
+		{
+			return values[(*this)((int)N)];
+		}
+
+		double uniform()
+		{
+			return std::uniform_real_distribution<double>(0.0, 1.0)(engine);
+		}
+
+	private:
+		std::mt19937 engine;
+	};
+
+	Sampler::State randomSampler(Random &random)
+	{
+		const Format formats[] = {FORMAT_A8R8G8B8, FORMAT_A8B8G8R8, FORMAT_X8R8G8B8, FORMAT_R5G6B5, FORMAT_L8, FORMAT_A8};
+		const FilterType filters[] = {FILTER_POINT, FILTER_LINEAR, FILTER_LINEAR, FILTER_ANISOTROPIC};
+		const MipmapType mipmaps[] = {MIPMAP_NONE, MIPMAP_POINT, MIPMAP_LINEAR};
+		const AddressingMode addressing[] = {ADDRESSING_WRAP, ADDRESSING_CLAMP, ADDRESSING_MIRROR};
+
+		Sampler::State sampler;
+
+		sampler.textureType = TEXTURE_2D;
+		sampler.textureFormat = random.pick(formats);
+		sampler.textureFilter = random.pick(filters);
+		sampler.mipmapFilter = random.pick(mipmaps);
+		sampler.addressingModeU = random.pick(addressing);
+		sampler.addressingModeV = random.chance(75) ? sampler.addressingModeU : random.pick(addressing);
+		sampler.addressingModeW = ADDRESSING_WRAP;
+		sampler.swizzleR = SWIZZLE_RED;
+		sampler.swizzleG = SWIZZLE_GREEN;
+		sampler.swizzleB = SWIZZLE_BLUE;
+		sampler.swizzleA = SWIZZLE_ALPHA;
+		sampler.compare = COMPARE_BYPASS;
+
+		return sampler;
+	}
+
+	// Combinations an application using the fixed-function pipeline would plausibly set up,
+	// with the common cases more likely than the exotic ones
+	PixelProcessor::State randomPixelState(Random &random)
+	{
+		const DepthCompareMode depthModes[] = {DEPTH_LESS, DEPTH_LESSEQUAL, DEPTH_LESSEQUAL, DEPTH_EQUAL, DEPTH_ALWAYS, DEPTH_GREATER};
+		const AlphaCompareMode alphaModes[] = {ALPHA_GREATER, ALPHA_GREATEREQUAL, ALPHA_NOTEQUAL};
+		const StencilCompareMode stencilModes[] = {STENCIL_ALWAYS, STENCIL_EQUAL, STENCIL_NOTEQUAL, STENCIL_LESS};
+		const StencilOperation stencilOperations[] = {OPERATION_KEEP, OPERATION_KEEP, OPERATION_REPLACE, OPERATION_INCRSAT, OPERATION_DECRSAT, OPERATION_INVERT};
+		const BlendFactor sourceFactors[] = {BLEND_ONE, BLEND_SOURCEALPHA, BLEND_SOURCEALPHA, BLEND_DEST, BLEND_ZERO};
+		const BlendFactor destFactors[] = {BLEND_ZERO, BLEND_ONE, BLEND_INVSOURCEALPHA, BLEND_INVSOURCEALPHA, BLEND_SOURCE};
+		const BlendOperation blendOperations[] = {BLENDOP_ADD, BLENDOP_ADD, BLENDOP_ADD, BLENDOP_SUB, BLENDOP_MAX};
+		const Format targetFormats[] = {FORMAT_A8R8G8B8, FORMAT_A8R8G8B8, FORMAT_X8R8G8B8, FORMAT_A8B8G8R8, FORMAT_R5G6B5};
+		const FogMode fogModes[] = {FOG_LINEAR, FOG_EXP, FOG_EXP2};
+		const TextureStage::StageOperation colorOperations[] = {TextureStage::STAGE_MODULATE, TextureStage::STAGE_MODULATE, TextureStage::STAGE_SELECTARG1, TextureStage::STAGE_ADD, TextureStage::STAGE_MODULATE2X, TextureStage::STAGE_BLENDTEXTUREALPHA};
+		const TextureStage::StageOperation alphaOperations[] = {TextureStage::STAGE_SELECTARG1, TextureStage::STAGE_SELECTARG2, TextureStage::STAGE_MODULATE};
+
+		PixelProcessor::State state;
+
+		state.perspective = true;
+		state.logicalOperation = LOGICALOP_COPY;
+		state.frontFaceCCW = random.chance(50);
+
+		if(random.chance(80))
+		{
+			state.depthTestActive = true;
+			state.depthCompareMode = random.pick(depthModes);
+			state.depthWriteEnable = random.chance(70);
+			state.quadLayoutDepthBuffer = random.chance(50);
+		}
+
+		if(random.chance(15))
+		{
+			state.alphaCompareMode = random.pick(alphaModes);
+		}
+
+		if(random.chance(20))
+		{
+			state.stencilActive = true;
+			state.stencilCompareMode = random.pick(stencilModes);
+			state.stencilFailOperation = random.pick(stencilOperations);
+			state.stencilPassOperation = random.pick(stencilOperations);
+			state.stencilZFailOperation = random.pick(stencilOperations);
+			state.noStencilMask = random.chance(80);
+			state.noStencilWriteMask = random.chance(80);
+			state.twoSidedStencil = random.chance(25);
+			state.stencilCompareModeCCW = state.twoSidedStencil ? random.pick(stencilModes) : state.stencilCompareMode;
+			state.stencilFailOperationCCW = state.twoSidedStencil ? random.pick(stencilOperations) : state.stencilFailOperation;
+			state.stencilPassOperationCCW = state.twoSidedStencil ? random.pick(stencilOperations) : state.stencilPassOperation;
+			state.stencilZFailOperationCCW = state.twoSidedStencil ? random.pick(stencilOperations) : state.stencilZFailOperation;
+			state.noStencilMaskCCW = state.noStencilMask;
+			state.noStencilWriteMaskCCW = state.noStencilWriteMask;
+		}
+
+		if(random.chance(35))
+		{
+			state.alphaBlendActive = true;
+			state.sourceBlendFactor = random.pick(sourceFactors);
+			state.destBlendFactor = random.pick(destFactors);
+			state.blendOperation = random.pick(blendOperations);
+			bool separate = random.chance(20);
+			state.sourceBlendFactorAlpha = separate ? random.pick(sourceFactors) : state.sourceBlendFactor;
+			state.destBlendFactorAlpha = separate ? random.pick(destFactors) : state.destBlendFactor;
+			state.blendOperationAlpha = separate ? random.pick(blendOperations) : state.blendOperation;
+		}
+
+		state.colorWriteMask = random.chance(90) ? 0xF : 0x7;
+		state.targetFormat[0] = random.pick(targetFormats);
+		state.multiSample = random.chance(25) ? 4 : 1;
+		state.multiSampleMask = 0xF;
+
+		if(state.multiSample > 1 && state.alphaCompareMode != ALPHA_ALWAYS && random.chance(50))
+		{
+			state.transparencyAntialiasing = TRANSPARENCY_ALPHA_TO_COVERAGE;
+		}
+
+		if(random.chance(15))
+		{
+			state.fogActive = true;
+			state.pixelFogMode = random.chance(50) ? random.pick(fogModes) : FOG_NONE;
+			state.fog.component = true;
+		}
+
+		state.color[0].component = 0xF;
+
+		if(random.chance(20))
+		{
+			state.specularAdd = true;
+			state.color[1].component = 0x7;
+		}
+
+		int stages = random(3);   // Zero to two textures
+
+		for(int stage = 0; stage < 8; stage++)
+		{
+			TextureStage::State &textureStage = state.textureStage[stage];
+
+			if(stage == 0 || stage < stages)
+			{
+				bool textured = stage < stages;
+
+				textureStage.stageOperation = textured ? random.pick(colorOperations) : TextureStage::STAGE_SELECTARG1;
+				textureStage.firstArgument = textured ? TextureStage::SOURCE_TEXTURE : TextureStage::SOURCE_DIFFUSE;
+				textureStage.secondArgument = (stage == 0) ? TextureStage::SOURCE_DIFFUSE : TextureStage::SOURCE_CURRENT;
+				textureStage.thirdArgument = TextureStage::SOURCE_CURRENT;
+				textureStage.stageOperationAlpha = random.pick(alphaOperations);
+				textureStage.firstArgumentAlpha = textured ? TextureStage::SOURCE_TEXTURE : TextureStage::SOURCE_DIFFUSE;
+				textureStage.secondArgumentAlpha = (stage == 0) ? TextureStage::SOURCE_DIFFUSE : TextureStage::SOURCE_CURRENT;
+				textureStage.thirdArgumentAlpha = TextureStage::SOURCE_CURRENT;
+				textureStage.firstModifier = TextureStage::MODIFIER_COLOR;
+				textureStage.secondModifier = TextureStage::MODIFIER_COLOR;
+				textureStage.thirdModifier = TextureStage::MODIFIER_COLOR;
+				textureStage.firstModifierAlpha = TextureStage::MODIFIER_COLOR;
+				textureStage.secondModifierAlpha = TextureStage::MODIFIER_COLOR;
+				textureStage.thirdModifierAlpha = TextureStage::MODIFIER_COLOR;
+				textureStage.destinationArgument = TextureStage::DESTINATION_CURRENT;
+				textureStage.usesTexture = textured;
+
+				if(textured)
+				{
+					state.sampler[stage] = randomSampler(random);
+					state.texture[stage].component = 0x3;
+				}
+			}
+		}
+
+		state.hash = state.computeHash();
+
+		return state;
+	}
+
+	VertexProcessor::State randomVertexState(Random &random)
+	{
+		const FogMode fogModes[] = {FOG_LINEAR, FOG_EXP, FOG_EXP2};
+		const MaterialSource materialSources[] = {MATERIAL_MATERIAL, MATERIAL_MATERIAL, MATERIAL_COLOR1};
+		const TexGen texGens[] = {TEXGEN_PASSTHRU, TEXGEN_PASSTHRU, TEXGEN_PASSTHRU, TEXGEN_POSITION, TEXGEN_NORMAL, TEXGEN_SPHEREMAP};
+
+		VertexProcessor::State state;
+
+		state.fixedFunction = true;
+		state.positionRegister = Pos;
+		state.pointSizeRegister = Pts;
+		state.verticesPerPrimitive = 3;
+		state.multiSampling = random.chance(25);
+
+		state.input[Position].type = STREAMTYPE_FLOAT;
+		state.input[Position].count = random.chance(80) ? 3 : 4;
+		state.output[Pos].write = 0xF;
+
+		if(random.chance(10))
+		{
+			state.vertexBlendMatrixCount = 1 + random(3);
+			state.indexedVertexBlendEnable = random.chance(50);
+			state.input[BlendWeight].type = STREAMTYPE_FLOAT;
+			state.input[BlendWeight].count = state.vertexBlendMatrixCount;
+
+			if(state.indexedVertexBlendEnable)
+			{
+				state.input[BlendIndices].type = STREAMTYPE_INDICES;
+				state.input[BlendIndices].count = 1;
+			}
+		}
+
+		bool colors = random.chance(60);
+
+		if(colors)
+		{
+			state.input[Color0].type = STREAMTYPE_COLOR;
+			state.input[Color0].count = 4;
+			state.input[Color0].normalized = true;
+		}
+
+		state.vertexLightingActive = random.chance(50);
+		state.diffuseActive = true;
+		state.output[C0].write = 0xF;
+
+		if(state.vertexLightingActive)
+		{
+			state.vertexLightActive = (1 << (1 + random(4))) - 1;
+			state.specularActive = random.chance(30);
+			state.vertexSpecularActive = state.specularActive;
+			state.localViewerActive = random.chance(20);
+			state.normalizeNormals = random.chance(50);
+			state.vertexDiffuseMaterialSourceActive = colors ? random.pick(materialSources) : MATERIAL_MATERIAL;
+			state.vertexAmbientMaterialSourceActive = colors ? random.pick(materialSources) : MATERIAL_MATERIAL;
+			state.vertexSpecularMaterialSourceActive = MATERIAL_MATERIAL;
+			state.vertexEmissiveMaterialSourceActive = MATERIAL_MATERIAL;
+
+			if(state.specularActive)
+			{
+				state.output[C1].write = 0xF;
+			}
+		}
+
+		int textures = random(3);
+		bool normalUsed = state.vertexLightingActive;
+
+		for(int stage = 0; stage < textures; stage++)
+		{
+			TexGen texGen = random.pick(texGens);
+
+			state.textureState[stage].texGenActive = texGen;
+			state.textureState[stage].texCoordIndexActive = stage;
+			state.textureState[stage].textureTransformCountActive = random.chance(20) ? 2 : 0;
+			state.output[T0 + stage].write = 0x3;
+
+			if(texGen == TEXGEN_PASSTHRU)
+			{
+				state.input[TexCoord0 + stage].type = STREAMTYPE_FLOAT;
+				state.input[TexCoord0 + stage].count = 2;
+			}
+			else if(texGen != TEXGEN_POSITION)
+			{
+				normalUsed = true;
+			}
+		}
+
+		if(normalUsed)
+		{
+			state.vertexNormalActive = true;
+			state.input[Normal].type = STREAMTYPE_FLOAT;
+			state.input[Normal].count = 3;
+		}
+		else
+		{
+			state.normalizeNormals = false;
+			state.localViewerActive = false;
+		}
+
+		if(random.chance(15))
+		{
+			state.fogActive = true;
+			state.vertexFogMode = random.chance(50) ? random.pick(fogModes) : FOG_NONE;
+			state.rangeFogActive = state.vertexFogMode != FOG_NONE && random.chance(30);
+			state.output[Fog].xWrite = true;
+		}
+
+		state.output[C0].clamp = 0xF;
+		state.output[C1].clamp = 0xF;
+		state.output[Fog].xClamp = true;
+
+		state.hash = state.computeHash();
+
+		return state;
+	}
+
+	Routine *generate(const PixelProcessor::State &state, OptimizationLevel level)
+	{
+		Nucleus::setOptimizationLevel(level);
+
+		PixelPipeline generator(state, nullptr);
+		generator.generate();
+		Routine *routine = generator(L"PixelRoutine_%0.8X", state.shaderID);
+
+		Nucleus::setOptimizationLevel(OptimizationDefault);
+
+		return routine;
+	}
+
+	Routine *generate(const VertexProcessor::State &state, OptimizationLevel level)
+	{
+		Nucleus::setOptimizationLevel(level);
+
+		VertexPipeline generator(state);
+		generator.generate();
+		Routine *routine = generator(L"VertexRoutine_%0.8X", (unsigned int)state.shaderID);
+
+		Nucleus::setOptimizationLevel(OptimizationDefault);
+
+		return routine;
+	}
+
+	// Distinct states, so each one is a cache miss the first time it's used
+	template<class State>
+	std::vector<State> randomStates(State (*randomState)(Random&), int count, unsigned int seed)
+	{
+		Random random(seed);
+		std::vector<State> states;
+		int attempts = 0;
+
+		while((int)states.size() < count && attempts++ < 100 * count)
+		{
+			State state = randomState(random);
+			bool unique = true;
+
+			for(const State &existing : states)
+			{
+				if(existing == state)
+				{
+					unique = false;
+					break;
+				}
+			}
+
+			if(unique)
+			{
+				states.push_back(state);
+			}
+		}
+
+		return states;
+	}
+
+	template<class State>
+	struct RoutineKind
+	{
+		const char *name;   // As grouped by RoutineTelemetry
+		State (*randomState)(Random&);
+	};
+
+	const RoutineKind<VertexProcessor::State> vertexKind = {"VertexRoutine", randomVertexState};
+	const RoutineKind<PixelProcessor::State> pixelKind = {"PixelRoutine", randomPixelState};
+
+	void reportTelemetry(benchmark::State &state, const char *name)
+	{
+		std::map<std::string, RoutineStatistics> statistics = RoutineTelemetry::getStatistics();
+		const RoutineStatistics &entry = statistics[name];
+
+		if(entry.compilations > 0)
+		{
+			double compilations = (double)entry.compilations;
+
+			state.counters["code_bytes"] = entry.codeSize / compilations;
+			state.counters["build_us"] = 1e6 * entry.buildTime / compilations;
+			state.counters["optimize_us"] = 1e6 * entry.optimizeTime / compilations;
+			state.counters["codegen_us"] = 1e6 * entry.codegenTime / compilations;
+		}
+	}
+
+	// Every iteration generates the routine of a state not seen before, which is what the JIT
+	// has to keep up with when an application warms up or a cache is too small
+	template<class State>
+	void Generate(benchmark::State &state, const RoutineKind<State> &kind)
+	{
+		OptimizationLevel level = (OptimizationLevel)state.range(0);
+		state.SetLabel(levelNames[level]);
+
+		std::vector<State> states = randomStates(kind.randomState, 256, 1);
+		size_t next = 0;
+
+		RoutineTelemetry::reset();
+		RoutineTelemetry::setEnabled(true);
+
+		for(auto _ : state)
+		{
+			Routine *routine = generate(states[next++ % states.size()], level);
+
+			if(!routine)
+			{
+				state.SkipWithError("Routine generation failed");
+				break;
+			}
+
+			delete routine;
+		}
+
+		RoutineTelemetry::setEnabled(false);
+
+		state.SetItemsProcessed(state.iterations());   // Routines per second
+		state.counters["distinct_states"] = (double)states.size();
+		reportTelemetry(state, kind.name);
+
+		RoutineTelemetry::reset();
+	}
+
+	// Simulates draws cycling through a working set of states with a skewed distribution, a few
+	// hot ones and a long tail, looked up in a routine cache which may be smaller than the set.
+	// Reports the hit rate, the misses beyond the first use of each state, which are the ones a
+	// larger cache would avoid, and the generated code kept alive by the cache.
+	template<class State>
+	void Churn(benchmark::State &state, const RoutineKind<State> &kind)
+	{
+		int cacheSize = (int)state.range(0);
+		int workingSet = (int)state.range(1);
+
+		std::vector<State> states = randomStates(kind.randomState, workingSet, 2);
+		std::vector<bool> used(states.size(), false);
+		Random random(3);
+
+		RoutineCache<State, typename State::Hash> cache(cacheSize);
+		int64_t generated = 0;
+		int64_t firstUses = 0;
+
+		RoutineTelemetry::reset();
+		RoutineTelemetry::setEnabled(true);
+
+		for(auto _ : state)
+		{
+			// Cubing a uniform variable makes the low indices much more likely
+			double u = random.uniform();
+			size_t index = (size_t)(u * u * u * states.size());
+			const State &key = states[index];
+
+			Routine *routine = cache.acquire(key);
+
+			if(!routine)
+			{
+				routine = cache.acquire(key, generate(key, OptimizationDefault));
+				generated++;
+			}
+
+			if(!used[index])
+			{
+				used[index] = true;
+				firstUses++;
+			}
+
+			routine->unbind();
+		}
+
+		RoutineTelemetry::setEnabled(false);
+
+		std::map<std::string, RoutineStatistics> statistics = RoutineTelemetry::getStatistics();
+		const RoutineStatistics &entry = statistics[kind.name];
+		double lookups = (double)cache.getHits() + (double)cache.getMisses();
+		double resident = (double)(generated - cache.getEvictions());
+		double codeSize = entry.compilations > 0 ? (double)entry.codeSize / entry.compilations : 0.0;
+
+		state.SetItemsProcessed(state.iterations());   // Draws per second
+		state.counters["hit_rate"] = lookups > 0 ? cache.getHits() / lookups : 0.0;
+		state.counters["capacity_misses"] = (double)(generated - firstUses);
+		state.counters["evictions"] = (double)cache.getEvictions();
+		state.counters["routines_per_s"] = benchmark::Counter((double)generated, benchmark::Counter::kIsRate);
+		state.counters["resident_routines"] = resident;
+		state.counters["resident_code_bytes"] = resident * codeSize;   // Using the average size
+
+		RoutineTelemetry::reset();
+	}
+
+	template<class State>
+	void registerBenchmarks(const char *name, const RoutineKind<State> &kind)
+	{
+		benchmark::RegisterBenchmark((std::string("Generate/") + name).c_str(), Generate<State>, kind)
+			->DenseRange(OptimizationQuick, OptimizationHot)
+			->ArgName("level")
+			->Unit(benchmark::kMicrosecond);
+
+		// Working sets which fit, slightly exceed, and far exceed the cache. Each iteration is one draw,
+		// and a fixed number of them makes the runs with different cache sizes comparable.
+		benchmark::RegisterBenchmark((std::string("Churn/") + name).c_str(), Churn<State>, kind)
+			->ArgsProduct({{16, 64}, {12, 80, 256}})
+			->ArgNames({"cache", "states"})
+			->Iterations(500)
+			->Unit(benchmark::kMicrosecond);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	benchmark::Initialize(&argc, argv);
+
+	if(benchmark::ReportUnrecognizedArguments(argc, argv))
+	{
+		return 1;
+	}
+
+	#if defined(REACTOR_BACKEND_NAME)
+		benchmark::AddCustomContext("reactor_backend", REACTOR_BACKEND_NAME);
+	#endif
+
+	registerBenchmarks("Vertex", vertexKind);
+	registerBenchmarks("Pixel", pixelKind);
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+
+	return 0;
+}
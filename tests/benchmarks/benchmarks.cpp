@@ -0,0 +1,800 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput benchmarks of the rendering hot paths: fill rate, triangle rate, texture sampling,
+// texture uploads, blits, presentation and shader compilation. Except for texture uploads, which
+// don't involve the renderer, each one runs for a range of renderer thread counts, which is the
+// first argument of the benchmark.
+
+#include "benchmark/benchmark.h"
+
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+#include <GLES2/gl2ext.h>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <X11/Xlib.h>
+#define BENCHMARK_X11 1
+#endif
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int WIDTH = 1024;
+const int HEIGHT = 1024;
+
+const char *const passthroughVertexShader =
+	"#version 300 es\n"
+	"in vec2 position;\n"
+	"out vec2 texCoord;\n"
+	"uniform vec2 texScale;\n"
+	"void main()\n"
+	"{\n"
+	"	texCoord = (position * 0.5 + 0.5) * texScale;\n"
+	"	gl_Position = vec4(position, 0.0, 1.0);\n"
+	"}\n";
+
+const char *const colorFragmentShader =
+	"#version 300 es\n"
+	"precision mediump float;\n"
+	"uniform vec4 color;\n"
+	"out vec4 fragColor;\n"
+	"void main()\n"
+	"{\n"
+	"	fragColor = color;\n"
+	"}\n";
+
+const char *const textureFragmentShader =
+	"#version 300 es\n"
+	"precision mediump float;\n"
+	"uniform sampler2D tex;\n"
+	"in vec2 texCoord;\n"
+	"out vec4 fragColor;\n"
+	"void main()\n"
+	"{\n"
+	"	fragColor = texture(tex, texCoord);\n"
+	"}\n";
+
+const float fullscreenQuad[] =
+{
+	-1.0f, -1.0f,
+	 1.0f, -1.0f,
+	-1.0f,  1.0f,
+	-1.0f,  1.0f,
+	 1.0f, -1.0f,
+	 1.0f,  1.0f,
+};
+
+// The renderer reads its settings when a context gets created, from the working directory
+void configureThreadCount(int threadCount)
+{
+	FILE *file = fopen("SwiftShader.ini", "w");
+
+	if(file)
+	{
+		fprintf(file, "[Processor]\nThreadCount=%d\n", threadCount);
+		fclose(file);
+	}
+}
+
+// Current ES 3.0 context rendering to a pbuffer, or to a window where available when asked for
+class BenchmarkContext
+{
+public:
+	BenchmarkContext(benchmark::State &state, int threadCount, bool window = false)
+	{
+		configureThreadCount(threadCount);
+
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+		if(display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+		{
+			state.SkipWithError("Could not initialize EGL");
+			return;
+		}
+
+		const EGLint configAttributes[] =
+		{
+			EGL_SURFACE_TYPE, window ? EGL_WINDOW_BIT : EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+			EGL_RED_SIZE, 8,
+			EGL_GREEN_SIZE, 8,
+			EGL_BLUE_SIZE, 8,
+			EGL_ALPHA_SIZE, 8,
+			EGL_DEPTH_SIZE, 24,
+			EGL_NONE
+		};
+
+		EGLConfig config;
+		EGLint configCount = 0;
+
+		if(!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount != 1)
+		{
+			state.SkipWithError("No suitable EGL config");
+			return;
+		}
+
+		if(window)
+		{
+			#if defined(BENCHMARK_X11)
+				x11Display = XOpenDisplay(nullptr);
+
+				if(x11Display)
+				{
+					nativeWindow = XCreateSimpleWindow(x11Display, DefaultRootWindow(x11Display), 0, 0, WIDTH, HEIGHT, 0, 0, 0);
+					XMapWindow(x11Display, nativeWindow);
+					XFlush(x11Display);
+
+					surface = eglCreateWindowSurface(display, config, (EGLNativeWindowType)nativeWindow, nullptr);
+				}
+			#endif
+		}
+		else
+		{
+			const EGLint surfaceAttributes[] = {EGL_WIDTH, WIDTH, EGL_HEIGHT, HEIGHT, EGL_NONE};
+			surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+		}
+
+		if(surface == EGL_NO_SURFACE)
+		{
+			state.SkipWithError(window ? "No window system to present to" : "Could not create a pbuffer");
+			return;
+		}
+
+		const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+		context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+		if(context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+		{
+			state.SkipWithError("Could not create an ES 3.0 context");
+			return;
+		}
+
+		glViewport(0, 0, WIDTH, HEIGHT);
+
+		glGenBuffers(1, &quadBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, quadBuffer);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(fullscreenQuad), fullscreenQuad, GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glEnableVertexAttribArray(0);
+
+		valid = true;
+	}
+
+	~BenchmarkContext()
+	{
+		if(valid)
+		{
+			glDeleteBuffers(1, &quadBuffer);
+		}
+
+		if(display != EGL_NO_DISPLAY)
+		{
+			eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+			if(context != EGL_NO_CONTEXT)
+			{
+				eglDestroyContext(display, context);
+			}
+
+			if(surface != EGL_NO_SURFACE)
+			{
+				eglDestroySurface(display, surface);
+			}
+
+			eglTerminate(display);
+		}
+
+		#if defined(BENCHMARK_X11)
+			if(x11Display)
+			{
+				XDestroyWindow(x11Display, nativeWindow);
+				XCloseDisplay(x11Display);
+			}
+		#endif
+	}
+
+	bool isValid() const { return valid; }
+
+	void swapBuffers() { eglSwapBuffers(display, surface); }
+
+	// Leaves the program in use, with texture coordinates spanning the texture once
+	GLuint createProgram(const char *vertexSource, const char *fragmentSource)
+	{
+		GLuint program = glCreateProgram();
+		GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+		GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glBindAttribLocation(program, 0, "position");
+		glLinkProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+		if(!linked)
+		{
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		glUseProgram(program);
+		glUniform2f(glGetUniformLocation(program, "texScale"), 1.0f, 1.0f);
+
+		return program;
+	}
+
+	void drawQuad()
+	{
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+	}
+
+private:
+	static GLuint compileShader(GLenum type, const char *source)
+	{
+		GLuint shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		return shader;
+	}
+
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLSurface surface = EGL_NO_SURFACE;
+	EGLContext context = EGL_NO_CONTEXT;
+	GLuint quadBuffer = 0;
+	bool valid = false;
+
+	#if defined(BENCHMARK_X11)
+		Display *x11Display = nullptr;
+		Window nativeWindow = 0;
+	#endif
+};
+
+// Renderer thread counts from 1 up to the number of cores, in powers of two
+void ThreadCounts(benchmark::internal::Benchmark *benchmark, const std::vector<std::vector<int64_t>> &arguments)
+{
+	int cores = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+	std::vector<std::vector<int64_t>> combinations = {{}};
+
+	for(const std::vector<int64_t> &values : arguments)
+	{
+		std::vector<std::vector<int64_t>> extended;
+
+		for(const std::vector<int64_t> &combination : combinations)
+		{
+			for(int64_t value : values)
+			{
+				extended.push_back(combination);
+				extended.back().push_back(value);
+			}
+		}
+
+		combinations.swap(extended);
+	}
+
+	for(int threads = 1; threads <= cores; threads *= 2)
+	{
+		for(const std::vector<int64_t> &combination : combinations)
+		{
+			std::vector<int64_t> args = {threads};
+			args.insert(args.end(), combination.begin(), combination.end());
+			benchmark->Args(args);
+		}
+	}
+
+	benchmark->UseRealTime();   // The work happens on the renderer's threads
+}
+
+struct TextureFormat
+{
+	const char *name;
+	GLenum internalFormat;
+	GLenum format;
+	GLenum type;
+};
+
+const TextureFormat textureFormats[] =
+{
+	{"RGBA8",   GL_RGBA8,   GL_RGBA, GL_UNSIGNED_BYTE},
+	{"RGB565",  GL_RGB565,  GL_RGB,  GL_UNSIGNED_SHORT_5_6_5},
+	{"R8",      GL_R8,      GL_RED,  GL_UNSIGNED_BYTE},
+	{"RGBA16F", GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT},
+	{"RGBA32F", GL_RGBA32F, GL_RGBA, GL_FLOAT},
+	{"SRGB8_A8", GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE},
+};
+
+const int textureFormatCount = sizeof(textureFormats) / sizeof(textureFormats[0]);
+
+GLuint createTexture(const TextureFormat &format, int width, int height, bool mipmapped)
+{
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexStorage2D(GL_TEXTURE_2D, mipmapped ? 11 : 1, format.internalFormat, width, height);
+
+	return texture;
+}
+
+// Pixels per second by fragment operations: 0 = none, 1 = depth test passing, 2 = depth test failing,
+// 3 = alpha blending, 4 = alpha blending and depth test passing.
+void FillRate(benchmark::State &state)
+{
+	BenchmarkContext context(state, static_cast<int>(state.range(0)));
+
+	if(!context.isValid())
+	{
+		return;
+	}
+
+	const int quads = 8;
+	int mode = static_cast<int>(state.range(1));
+	const char *const labels[] = {"opaque", "depth pass", "depth fail", "blend", "blend depth pass"};
+	state.SetLabel(labels[mode]);
+
+	GLuint program = context.createProgram(passthroughVertexShader, colorFragmentShader);
+	glUniform4f(glGetUniformLocation(program, "color"), 0.5f, 0.25f, 0.75f, 0.5f);
+
+	if(mode == 1 || mode == 2 || mode == 4)
+	{
+		glEnable(GL_DEPTH_TEST);
+		glDepthFunc(mode == 2 ? GL_LESS : GL_LEQUAL);
+	}
+
+	if(mode == 3 || mode == 4)
+	{
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+
+	context.drawQuad();   // Generates the routines outside of the measurements
+	glFinish();
+
+	for(auto _ : state)
+	{
+		if(mode == 2)
+		{
+			state.PauseTiming();
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			context.drawQuad();   // Lays down the depth the measured quads fail against
+			glFinish();
+			state.ResumeTiming();
+		}
+
+		for(int i = 0; i < quads; i++)
+		{
+			context.drawQuad();
+		}
+
+		glFinish();
+	}
+
+	state.counters["pixels/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * quads * WIDTH * HEIGHT, benchmark::Counter::kIsRate);
+
+	glDeleteProgram(program);
+}
+
+BENCHMARK(FillRate)->Apply([](benchmark::internal::Benchmark *b) { ThreadCounts(b, {{0, 1, 2, 3, 4}}); });
+
+struct BlendMode
+{
+	const char *name;
+	GLenum sourceFactor;
+	GLenum destFactor;
+};
+
+const BlendMode blendModes[] =
+{
+	{"premultiplied", GL_ONE,            GL_ONE_MINUS_SRC_ALPHA},
+	{"additive",      GL_ONE,            GL_ONE},
+	{"alpha",         GL_SRC_ALPHA,      GL_ONE_MINUS_SRC_ALPHA},
+	{"multiply",      GL_DST_COLOR,      GL_ZERO},
+	{"constant",      GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA},
+};
+
+const int blendModeCount = sizeof(blendModes) / sizeof(blendModes[0]);
+
+// Pixels per second by blend function, into the RGBA8 default framebuffer (0) or an RGBA16F renderbuffer (1)
+void BlendRate(benchmark::State &state)
+{
+	BenchmarkContext context(state, static_cast<int>(state.range(0)));
+
+	if(!context.isValid())
+	{
+		return;
+	}
+
+	const int quads = 8;
+	const BlendMode &mode = blendModes[state.range(1)];
+	bool floatTarget = state.range(2) != 0;
+	state.SetLabel(std::string(mode.name) + (floatTarget ? " RGBA16F" : " RGBA8"));
+
+	GLuint framebuffer = 0;
+	GLuint renderbuffer = 0;
+
+	if(floatTarget)
+	{
+		glGenRenderbuffers(1, &renderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA16F, WIDTH, HEIGHT);
+
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+
+		if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			state.SkipWithError("RGBA16F is not color-renderable");
+		}
+	}
+
+	GLuint program = context.createProgram(passthroughVertexShader, colorFragmentShader);
+	glUniform4f(glGetUniformLocation(program, "color"), 0.5f, 0.25f, 0.75f, 0.5f);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(mode.sourceFactor, mode.destFactor);
+	glBlendColor(0.0f, 0.0f, 0.0f, 0.25f);
+
+	context.drawQuad();   // Generates the routines outside of the measurements
+	glFinish();
+
+	for(auto _ : state)
+	{
+		for(int i = 0; i < quads; i++)
+		{
+			context.drawQuad();
+		}
+
+		glFinish();
+	}
+
+	state.counters["pixels/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * quads * WIDTH * HEIGHT, benchmark::Counter::kIsRate);
+
+	glDeleteProgram(program);
+	glDeleteFramebuffers(1, &framebuffer);
+	glDeleteRenderbuffers(1, &renderbuffer);
+}
+
+BENCHMARK(BlendRate)->Apply([](benchmark::internal::Benchmark *b) { ThreadCounts(b, {{0, 1, 2, 3, 4}, {0, 1}}); });
+
+// Triangles per second by the size of their legs in pixels
+void TriangleRate(benchmark::State &state)
+{
+	BenchmarkContext context(state, static_cast<int>(state.range(0)));
+
+	if(!context.isValid())
+	{
+		return;
+	}
+
+	int size = static_cast<int>(state.range(1));
+	int cells = std::min(WIDTH / size, 128);
+	int repeats = std::max(128 / cells, 1) * std::max(128 / cells, 1);   // Roughly the same triangle count for all sizes
+
+	std::vector<float> vertices;
+
+	for(int y = 0; y < cells; y++)
+	{
+		for(int x = 0; x < cells; x++)
+		{
+			float x0 = 2.0f * x * size / WIDTH - 1.0f;
+			float y0 = 2.0f * y * size / HEIGHT - 1.0f;
+			float x1 = 2.0f * (x + 1) * size / WIDTH - 1.0f;
+			float y1 = 2.0f * (y + 1) * size / HEIGHT - 1.0f;
+
+			const float cell[] = {x0, y0, x1, y0, x0, y1, x0, y1, x1, y0, x1, y1};
+			vertices.insert(vertices.end(), cell, cell + 12);
+		}
+	}
+
+	GLuint buffer;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+	GLuint program = context.createProgram(passthroughVertexShader, colorFragmentShader);
+	glUniform4f(glGetUniformLocation(program, "color"), 0.5f, 0.25f, 0.75f, 1.0f);
+
+	GLsizei vertexCount = static_cast<GLsizei>(vertices.size() / 2);
+
+	glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+	glFinish();
+
+	for(auto _ : state)
+	{
+		for(int i = 0; i < repeats; i++)
+		{
+			glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+		}
+
+		glFinish();
+	}
+
+	state.counters["triangles/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * repeats * vertexCount / 3, benchmark::Counter::kIsRate);
+
+	glDeleteProgram(program);
+	glDeleteBuffers(1, &buffer);
+}
+
+BENCHMARK(TriangleRate)->Apply([](benchmark::internal::Benchmark *b) { ThreadCounts(b, {{1, 4, 16, 64}}); });
+
+// Texels per second by texture format and filter: 0 = nearest, 1 = bilinear, 2 = trilinear, 3 = 16x anisotropic.
+// The texture gets minified by two in one direction, so all mipmapped filters access the two largest levels.
+void TexelRate(benchmark::State &state)
+{
+	BenchmarkContext context(state, static_cast<int>(state.range(0)));
+
+	if(!context.isValid())
+	{
+		return;
+	}
+
+	const TextureFormat &format = textureFormats[state.range(1)];
+	int filter = static_cast<int>(state.range(2));
+	const char *const filters[] = {"nearest", "bilinear", "trilinear", "anisotropic"};
+	state.SetLabel(std::string(format.name) + " " + filters[filter]);
+
+	GLuint texture = createTexture(format, WIDTH, HEIGHT, filter >= 2);
+
+	if(filter >= 2)
+	{
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (filter == 0) ? GL_NEAREST : (filter == 1) ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (filter == 0) ? GL_NEAREST : GL_LINEAR);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, (filter == 3) ? 16.0f : 1.0f);
+
+	GLuint program = context.createProgram(passthroughVertexShader, textureFragmentShader);
+	glUniform1i(glGetUniformLocation(program, "tex"), 0);
+	glUniform2f(glGetUniformLocation(program, "texScale"), 2.0f, 1.0f);
+
+	if(glGetError() != GL_NO_ERROR)
+	{
+		state.SkipWithError("Texture format or filter not supported");
+	}
+
+	const int quads = 4;
+
+	context.drawQuad();
+	glFinish();
+
+	for(auto _ : state)
+	{
+		for(int i = 0; i < quads; i++)
+		{
+			context.drawQuad();
+		}
+
+		glFinish();
+	}
+
+	state.counters["texels/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * quads * WIDTH * HEIGHT, benchmark::Counter::kIsRate);
+
+	glDeleteProgram(program);
+	glDeleteTextures(1, &texture);
+}
+
+BENCHMARK(TexelRate)->Apply([](benchmark::internal::Benchmark *b) { ThreadCounts(b, {{0, 1, 2, 3, 4, 5}, {0, 1, 2, 3}}); });
+
+struct UploadFormat
+{
+	const char *name;
+	GLenum internalFormat;
+	GLenum format;
+	GLenum type;
+	int pixelSize;   // In bytes, of the client data
+};
+
+// Client formats which get converted while they are uploaded, plus RGBA8 which gets copied
+const UploadFormat uploadFormats[] =
+{
+	{"RGBA8",              GL_RGBA8,          GL_RGBA, GL_UNSIGNED_BYTE,                4},
+	{"RGB8",               GL_RGB8,           GL_RGB,  GL_UNSIGNED_BYTE,                3},
+	{"RGBA4",              GL_RGBA4,          GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4,       2},
+	{"RGB5_A1",            GL_RGB5_A1,        GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1,       2},
+	{"R11F_G11F_B10F",     GL_R11F_G11F_B10F, GL_RGB,  GL_UNSIGNED_INT_10F_11F_11F_REV, 4},
+	{"R16F from float",    GL_R16F,           GL_RED,  GL_FLOAT,                        4},
+	{"RGB16F from float",  GL_RGB16F,         GL_RGB,  GL_FLOAT,                        12},
+	{"RGBA16F from float", GL_RGBA16F,        GL_RGBA, GL_FLOAT,                        16},
+};
+
+const int uploadFormatCount = sizeof(uploadFormats) / sizeof(uploadFormats[0]);
+
+// Client data bytes per second uploaded with glTexSubImage2D, by format
+void TextureUpload(benchmark::State &state)
+{
+	BenchmarkContext context(state, 0);
+
+	if(!context.isValid())
+	{
+		return;
+	}
+
+	const UploadFormat &format = uploadFormats[state.range(0)];
+	state.SetLabel(format.name);
+
+	std::vector<unsigned char> pixels(static_cast<size_t>(WIDTH) * HEIGHT * format.pixelSize);
+
+	for(size_t i = 0; i < pixels.size(); i++)
+	{
+		pixels[i] = static_cast<unsigned char>(i * 7 / 5);
+	}
+
+	if(format.type == GL_FLOAT)
+	{
+		float *values = reinterpret_cast<float*>(pixels.data());
+
+		for(size_t i = 0; i < pixels.size() / sizeof(float); i++)
+		{
+			values[i] = static_cast<float>(i % 1000) / 999.0f;
+		}
+	}
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexStorage2D(GL_TEXTURE_2D, 1, format.internalFormat, WIDTH, HEIGHT);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if(glGetError() != GL_NO_ERROR)
+	{
+		state.SkipWithError("Texture format not supported");
+	}
+
+	for(auto _ : state)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, WIDTH, HEIGHT, format.format, format.type, pixels.data());
+	}
+
+	glFinish();
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * pixels.size());
+
+	glDeleteTextures(1, &texture);
+}
+
+BENCHMARK(TextureUpload)->DenseRange(0, uploadFormatCount - 1)->UseRealTime();   // Large uploads get converted on several threads
+
+// Blitter throughput in pixels per second by source and destination format, unscaled or minified by two with linear filtering
+void Blit(benchmark::State &state)
+{
+	BenchmarkContext context(state, static_cast<int>(state.range(0)));
+
+	if(!context.isValid())
+	{
+		return;
+	}
+
+	const TextureFormat &sourceFormat = textureFormats[state.range(1)];
+	const TextureFormat &destinationFormat = textureFormats[state.range(2)];
+	bool scaled = state.range(3) != 0;
+	state.SetLabel(std::string(sourceFormat.name) + " to " + destinationFormat.name + (scaled ? " scaled" : ""));
+
+	int sourceWidth = scaled ? 2 * WIDTH : WIDTH;
+	int sourceHeight = scaled ? 2 * HEIGHT : HEIGHT;
+
+	GLuint textures[2] = {createTexture(sourceFormat, sourceWidth, sourceHeight, false), createTexture(destinationFormat, WIDTH, HEIGHT, false)};
+	GLuint framebuffers[2];
+	glGenFramebuffers(2, framebuffers);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[0], 0);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[1], 0);
+
+	if(glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE ||
+	   glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		state.SkipWithError("Format not color renderable");
+	}
+
+	glBlitFramebuffer(0, 0, sourceWidth, sourceHeight, 0, 0, WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, scaled ? GL_LINEAR : GL_NEAREST);
+	glFinish();
+
+	for(auto _ : state)
+	{
+		glBlitFramebuffer(0, 0, sourceWidth, sourceHeight, 0, 0, WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, scaled ? GL_LINEAR : GL_NEAREST);
+		glFinish();
+	}
+
+	state.counters["pixels/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * WIDTH * HEIGHT, benchmark::Counter::kIsRate);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDeleteFramebuffers(2, framebuffers);
+	glDeleteTextures(2, textures);
+}
+
+BENCHMARK(Blit)->Apply([](benchmark::internal::Benchmark *b) { ThreadCounts(b, {{0, 1, 3, 4, 5}, {0, 1, 3, 4, 5}, {0, 1}}); });
+
+// Time to present a frame to a window, which is mostly the FrameBuffer::copy() of the back buffer
+void Present(benchmark::State &state)
+{
+	BenchmarkContext context(state, static_cast<int>(state.range(0)), true);
+
+	if(!context.isValid())
+	{
+		return;
+	}
+
+	glClearColor(0.5f, 0.25f, 0.75f, 1.0f);
+
+	for(auto _ : state)
+	{
+		state.PauseTiming();
+		glClear(GL_COLOR_BUFFER_BIT);
+		glFinish();
+		state.ResumeTiming();
+
+		context.swapBuffers();
+	}
+
+	state.counters["frames/s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(Present)->Apply([](benchmark::internal::Benchmark *b) { ThreadCounts(b, {}); });
+
+// Latency from linking a new program to its first draw completing, which includes generating the
+// vertex, setup and pixel routines. Every iteration uses a different shader so none can be reused.
+void ShaderCompile(benchmark::State &state)
+{
+	BenchmarkContext context(state, static_cast<int>(state.range(0)));
+
+	if(!context.isValid())
+	{
+		return;
+	}
+
+	glViewport(0, 0, 1, 1);
+	int serial = 0;
+
+	for(auto _ : state)
+	{
+		std::string fragmentShader =
+			"#version 300 es\n"
+			"precision mediump float;\n"
+			"in vec2 texCoord;\n"
+			"out vec4 fragColor;\n"
+			"void main()\n"
+			"{\n"
+			"	vec4 color = vec4(texCoord, " + std::to_string(++serial) + ".0, 1.0);\n"
+			"	for(int i = 0; i < 4; i++)\n"
+			"	{\n"
+			"		color = color * color.wzyx + vec4(0.25);\n"
+			"	}\n"
+			"	fragColor = normalize(color);\n"
+			"}\n";
+
+		GLuint program = context.createProgram(passthroughVertexShader, fragmentShader.c_str());
+		context.drawQuad();
+		glFinish();
+
+		state.PauseTiming();
+		glDeleteProgram(program);
+		state.ResumeTiming();
+	}
+
+	state.counters["programs/s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(ShaderCompile)->Apply([](benchmark::internal::Benchmark *b) { ThreadCounts(b, {}); });
+}
@@ -0,0 +1,69 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <direct.h>
+#else
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string>
+
+int main(int argc, char **argv)
+{
+	// Each benchmark configures its thread count through a SwiftShader.ini in the working directory,
+	// so run in a directory of our own instead of overwriting the user's settings.
+	#if defined(_WIN32)
+		char path[MAX_PATH];
+		GetTempPathA(MAX_PATH, path);
+		std::string directory = std::string(path) + "SwiftShaderBenchmarks";
+		_mkdir(directory.c_str());
+		bool entered = _chdir(directory.c_str()) == 0;
+	#else
+		char directory[] = "/tmp/SwiftShaderBenchmarksXXXXXX";
+		bool entered = mkdtemp(directory) && chdir(directory) == 0;
+	#endif
+
+	if(!entered)
+	{
+		fprintf(stderr, "Could not create a working directory for the benchmarks\n");
+		return 1;
+	}
+
+	::benchmark::Initialize(&argc, argv);
+
+	if(::benchmark::ReportUnrecognizedArguments(argc, argv))
+	{
+		return 1;
+	}
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	remove("SwiftShader.ini");
+
+	#if !defined(_WIN32)
+		if(chdir("/") == 0)
+		{
+			rmdir(directory);
+		}
+	#endif
+
+	return 0;
+}
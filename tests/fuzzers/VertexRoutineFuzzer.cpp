@@ -12,8 +12,6 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "OpenGL/compiler/InitializeGlobals.h"
-#include "OpenGL/compiler/InitializeParseContext.h"
 #include "OpenGL/compiler/TranslatorASM.h"
 
 // TODO: Debug macros of the GLSL compiler clash with core SwiftShader's.
@@ -31,18 +29,15 @@
 namespace {
 
 // TODO(cwallez@google.com): Like in ANGLE, disable most of the pool allocator for fuzzing
-// This is a helper class to make sure all the resources used by the compiler are initialized
-class ScopedPoolAllocatorAndTLS {
+// This is a helper class to give this thread a pool allocator for anything allocated
+// outside of the compiler's own Init() and compile() calls, which bind theirs.
+class ScopedPoolAllocator {
 	public:
-		ScopedPoolAllocatorAndTLS() {
-			InitializeParseContextIndex();
-			InitializePoolIndex();
+		ScopedPoolAllocator() {
 			SetGlobalPoolAllocator(&allocator);
 		}
-		~ScopedPoolAllocatorAndTLS() {
+		~ScopedPoolAllocator() {
 			SetGlobalPoolAllocator(nullptr);
-			FreePoolIndex();
-			FreeParseContextIndex();
 		}
 
 	private:
@@ -95,7 +90,7 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
 		return 0;
 	}
 
-	std::unique_ptr<ScopedPoolAllocatorAndTLS> allocatorAndTLS(new ScopedPoolAllocatorAndTLS);
+	std::unique_ptr<ScopedPoolAllocator> allocator(new ScopedPoolAllocator);
 	std::unique_ptr<sw::VertexShader> shader(new sw::VertexShader);
 	std::unique_ptr<FakeVS> fakeVS(new FakeVS(shader.get()));
 	
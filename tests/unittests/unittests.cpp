@@ -25,12 +25,20 @@
 #include <GL/glcorearb.h>
 #include <GL/glext.h>
 
+#if !defined(ANGLE_DISABLE_TRACE)
+#define ANGLE_DISABLE_TRACE   // The trace log isn't exported from the libraries
+#endif
+#include "OpenGL/common/NameSpace.hpp"
+#include "Renderer/LRUCache.hpp"
+
 #if defined(_WIN32)
 #include <Windows.h>
 #endif
 
 #include <string.h>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #define EXPECT_GLENUM_EQ(expected, actual) EXPECT_EQ(static_cast<GLenum>(expected), static_cast<GLenum>(actual))
 
@@ -1355,6 +1363,1856 @@ TEST_F(SwiftShaderTest, TextureRectangle_CopyTexSubImage)
 	Uninitialize();
 }
 
+namespace
+{
+	// Program binaries are a 24 byte header, ending with the FNV-1a checksum of the words which follow it
+	const size_t programBinaryHeaderSize = 24;
+
+	void updateProgramBinaryChecksum(std::vector<unsigned char> &binary)
+	{
+		uint64_t checksum = 0xCBF29CE484222325;
+
+		for(size_t i = programBinaryHeaderSize; i < binary.size(); i++)
+		{
+			checksum = (checksum ^ binary[i]) * 1099511628211;
+		}
+
+		memcpy(&binary[programBinaryHeaderSize - sizeof(checksum)], &checksum, sizeof(checksum));
+	}
+}
+
+class ProgramBinaryTest : public SwiftShaderTest
+{
+protected:
+	void SetUp() override
+	{
+		SwiftShaderTest::SetUp();
+		Initialize(3, false);
+
+		const std::string vs =
+			"#version 300 es\n"
+			"in vec4 position;\n"
+			"uniform vec4 color[2];\n"
+			"out vec4 varyingColor;\n"
+			"void main()\n"
+			"{\n"
+			"	varyingColor = color[1];\n"
+			"	gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+			"}\n";
+
+		const std::string fs =
+			"#version 300 es\n"
+			"precision mediump float;\n"
+			"in vec4 varyingColor;\n"
+			"out vec4 fragColor;\n"
+			"void main()\n"
+			"{\n"
+			"	fragColor = varyingColor;\n"
+			"}\n";
+
+		ph = createProgram(vs, fs);
+
+		// Relink with a transform feedback varying, whose register and column end the binary
+		const char *varyings[] = { "varyingColor" };
+		glTransformFeedbackVaryings(ph.program, 1, varyings, GL_INTERLEAVED_ATTRIBS);
+		glLinkProgram(ph.program);
+		GLint linkStatus = GL_FALSE;
+		glGetProgramiv(ph.program, GL_LINK_STATUS, &linkStatus);
+		EXPECT_EQ(GL_TRUE, linkStatus);
+
+		GLint length = 0;
+		glGetProgramiv(ph.program, GL_PROGRAM_BINARY_LENGTH, &length);
+		EXPECT_GT(length, static_cast<GLint>(programBinaryHeaderSize));
+
+		binary.resize(length);
+		GLsizei written = 0;
+		glGetProgramBinary(ph.program, length, &written, &format, binary.data());
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+		EXPECT_EQ(length, written);
+	}
+
+	void TearDown() override
+	{
+		deleteProgram(ph);
+		Uninitialize();
+	}
+
+	// Returns the link status of a new program loaded from the binary
+	GLint loadProgramBinary(const std::vector<unsigned char> &data, GLuint *loaded = nullptr)
+	{
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, format, data.data(), static_cast<GLsizei>(data.size()));
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		GLint linkStatus = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+
+		if(loaded)
+		{
+			*loaded = program;
+		}
+		else
+		{
+			glDeleteProgram(program);
+		}
+
+		return linkStatus;
+	}
+
+	ProgramHandles ph;
+	std::vector<unsigned char> binary;
+	GLenum format = GL_NONE;
+};
+
+// Tests that a program loaded from its binary draws like the original.
+TEST_F(ProgramBinaryTest, RoundTrip)
+{
+	GLuint program = 0;
+	EXPECT_EQ(GL_TRUE, loadProgramBinary(binary, &program));
+
+	GLint location = glGetUniformLocation(program, "color[1]");
+	EXPECT_NE(-1, location);
+	EXPECT_EQ(0, glGetAttribLocation(program, "position"));
+
+	glUseProgram(program);
+	glUniform4f(location, 0.0f, 1.0f, 0.0f, 1.0f);
+	glClearColor(0.0, 0.0, 0.0, 0.0);
+	glClear(GL_COLOR_BUFFER_BIT);
+	drawQuad(program);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	unsigned char green[4] = { 0, 255, 0, 255 };
+	expectFramebufferColor(green);
+
+	// The binary of the loaded program is the same
+	std::vector<unsigned char> reloaded(binary.size());
+	GLsizei written = 0;
+	glGetProgramBinary(program, static_cast<GLsizei>(reloaded.size()), &written, &format, reloaded.data());
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+	EXPECT_EQ(binary, reloaded);
+
+	glDeleteProgram(program);
+}
+
+// Tests that binaries which end early are rejected, without an error.
+TEST_F(ProgramBinaryTest, Truncated)
+{
+	for(size_t size : { size_t(0), programBinaryHeaderSize / 2, programBinaryHeaderSize, binary.size() / 2, binary.size() - 4, binary.size() - 1 })
+	{
+		std::vector<unsigned char> truncated(binary.begin(), binary.begin() + size);
+		EXPECT_EQ(GL_FALSE, loadProgramBinary(truncated));
+	}
+
+	// Also when the checksum was updated to match
+	std::vector<unsigned char> truncated(binary.begin(), binary.end() - 4);
+	updateProgramBinaryChecksum(truncated);
+	EXPECT_EQ(GL_FALSE, loadProgramBinary(truncated));
+}
+
+// Tests that binaries which don't match their checksum are rejected.
+TEST_F(ProgramBinaryTest, BadChecksum)
+{
+	std::vector<unsigned char> corrupted = binary;
+	corrupted.back() ^= 1;
+	EXPECT_EQ(GL_FALSE, loadProgramBinary(corrupted));
+
+	corrupted = binary;
+	corrupted[programBinaryHeaderSize - 1] ^= 1;
+	EXPECT_EQ(GL_FALSE, loadProgramBinary(corrupted));
+
+	// Recomputing the checksum of the unmodified words reproduces the binary
+	std::vector<unsigned char> recomputed = binary;
+	updateProgramBinaryChecksum(recomputed);
+	EXPECT_EQ(binary, recomputed);
+}
+
+// Tests that binaries with a valid checksum but indices out of range are rejected.
+TEST_F(ProgramBinaryTest, OutOfRangeIndex)
+{
+	// The last words are the transform feedback varying's register and column, and the zero fragment output count
+	const size_t reg = binary.size() - 12;
+	const size_t col = binary.size() - 8;
+
+	uint32_t word = 0xFFFFFFFF;
+	memcpy(&word, &binary[binary.size() - 4], sizeof(word));
+	EXPECT_EQ(0u, word);
+	memcpy(&word, &binary[col], sizeof(word));
+	EXPECT_EQ(0u, word);
+
+	for(uint32_t value : { 34u, 1000u, 0xFFFFFFFFu })
+	{
+		std::vector<unsigned char> corrupted = binary;
+		memcpy(&corrupted[reg], &value, sizeof(value));
+		updateProgramBinaryChecksum(corrupted);
+		EXPECT_EQ(GL_FALSE, loadProgramBinary(corrupted));
+	}
+
+	for(uint32_t value : { 4u, 0xFFFFFFFFu })
+	{
+		std::vector<unsigned char> corrupted = binary;
+		memcpy(&corrupted[col], &value, sizeof(value));
+		updateProgramBinaryChecksum(corrupted);
+		EXPECT_EQ(GL_FALSE, loadProgramBinary(corrupted));
+	}
+
+	// The pixel shader's first instruction follows ten words, with its destination register type and index after eight more
+	const size_t dstType = programBinaryHeaderSize + 18 * 4;
+	const size_t dstIndex = programBinaryHeaderSize + 19 * 4;
+
+	memcpy(&word, &binary[dstType], sizeof(word));
+	EXPECT_LT(word, 18u);   // A register, not a label or literal
+
+	for(uint32_t value : { 0x10000u, 0xFFFFFFFFu })
+	{
+		std::vector<unsigned char> corrupted = binary;
+		memcpy(&corrupted[dstIndex], &value, sizeof(value));
+		updateProgramBinaryChecksum(corrupted);
+		EXPECT_EQ(GL_FALSE, loadProgramBinary(corrupted));
+	}
+}
+
+// Decodes single ASTC blocks by fetching every texel into a float framebuffer.
+// The expected values are worked out from the ASTC specification.
+class ASTCTest : public SwiftShaderTest
+{
+protected:
+	// Fields are written least significant bit first, in the order the decoder reads them
+	struct Block
+	{
+		unsigned char bytes[16] = {};
+
+		void set(int start, int count, unsigned int value)
+		{
+			for(int i = 0; i < count; i++)
+			{
+				int bit = start + i;
+				bytes[bit / 8] &= ~(1 << (bit % 8));
+				bytes[bit / 8] |= ((value >> i) & 1) << (bit % 8);
+			}
+		}
+
+		// Weights are stored from the most significant bit of the block downwards
+		void setWeight(int index, int bits, unsigned int value)
+		{
+			for(int i = 0; i < bits; i++)
+			{
+				set(127 - (index * bits + i), 1, (value >> i) & 1);
+			}
+		}
+	};
+
+	void SetUp() override
+	{
+		SwiftShaderTest::SetUp();
+		Initialize(3, false);
+
+		const std::string vs =
+			"#version 300 es\n"
+			"in vec4 position;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+			"}\n";
+
+		const std::string fs =
+			"#version 300 es\n"
+			"precision highp float;\n"
+			"uniform highp sampler2D tex;\n"
+			"out vec4 fragColor;\n"
+			"void main()\n"
+			"{\n"
+			"	fragColor = texelFetch(tex, ivec2(gl_FragCoord.xy), 0);\n"
+			"}\n";
+
+		ph = createProgram(vs, fs);
+	}
+
+	void TearDown() override
+	{
+		deleteProgram(ph);
+		Uninitialize();
+	}
+
+	// Void-extent blocks hold one color for the whole block, UNORM16 for LDR or FP16 for HDR
+	static Block voidExtentBlock(bool hdr, unsigned short r, unsigned short g, unsigned short b, unsigned short a)
+	{
+		Block block;
+		block.set(0, 9, 0x1FC);
+		block.set(9, 1, hdr ? 1 : 0);
+		block.set(10, 2, 3);
+		block.set(12, 26, 0x3FFFFFF);   // No extent coordinates
+		block.set(38, 26, 0x3FFFFFF);
+		block.set(64, 16, r);
+		block.set(80, 16, g);
+		block.set(96, 16, b);
+		block.set(112, 16, a);
+
+		return block;
+	}
+
+	// A single partition with a 4x4 grid of 2 bit weights, whose endpoint values get 8 bits each
+	static Block directBlock(int mode, const std::vector<unsigned int> &values, const unsigned int weights[16])
+	{
+		Block block;
+		block.set(0, 11, 0x042);   // 4x4 grid of weights 0 to 3, one plane
+		block.set(11, 2, 0);       // One partition
+		block.set(13, 4, mode);
+
+		for(size_t i = 0; i < values.size(); i++)
+		{
+			block.set(17 + 8 * static_cast<int>(i), 8, values[i]);
+		}
+
+		for(int i = 0; i < 16; i++)
+		{
+			block.setWeight(i, 2, weights[i]);
+		}
+
+		return block;
+	}
+
+	// Returns the decoded RGBA texels, bottom row first
+	std::vector<float> decode(GLenum format, int width, int height, const Block &block)
+	{
+		GLuint tex = 0;
+		glGenTextures(1, &tex);
+		glBindTexture(GL_TEXTURE_2D, tex);
+		glCompressedTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, sizeof(block.bytes), block.bytes);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		GLuint target = 0;
+		glGenTextures(1, &target);
+		glBindTexture(GL_TEXTURE_2D, target);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+
+		GLuint fbo = 0;
+		glGenFramebuffers(1, &fbo);
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+		EXPECT_GLENUM_EQ(GL_FRAMEBUFFER_COMPLETE, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+
+		glBindTexture(GL_TEXTURE_2D, tex);
+		glViewport(0, 0, width, height);
+		drawQuad(ph.program, "tex");
+
+		std::vector<float> texels(width * height * 4);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, texels.data());
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &fbo);
+		glDeleteTextures(1, &target);
+		glDeleteTextures(1, &tex);
+
+		return texels;
+	}
+
+	static void expectTexel(const std::vector<float> &texels, int width, int x, int y, const float expected[4], float tolerance = 1.0e-6f)
+	{
+		const float *texel = &texels[(x + y * width) * 4];
+
+		for(int c = 0; c < 4; c++)
+		{
+			EXPECT_NEAR(expected[c], texel[c], tolerance) << "texel " << x << ", " << y << " component " << c;
+		}
+	}
+
+	static void expectUniform(const std::vector<float> &texels, int width, int height, const float expected[4], float tolerance = 1.0e-6f)
+	{
+		for(int y = 0; y < height; y++)
+		{
+			for(int x = 0; x < width; x++)
+			{
+				expectTexel(texels, width, x, y, expected, tolerance);
+			}
+		}
+	}
+
+	static float unorm16(unsigned int C)
+	{
+		return C / 65535.0f;
+	}
+
+	ProgramHandles ph;
+};
+
+namespace
+{
+	struct Footprint
+	{
+		int width;
+		int height;
+		GLenum format;
+		GLenum srgbFormat;
+	};
+
+	const Footprint astcFootprints[] =
+	{
+		{4, 4, GL_COMPRESSED_RGBA_ASTC_4x4_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR},
+		{5, 4, GL_COMPRESSED_RGBA_ASTC_5x4_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4_KHR},
+		{5, 5, GL_COMPRESSED_RGBA_ASTC_5x5_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5_KHR},
+		{6, 6, GL_COMPRESSED_RGBA_ASTC_6x6_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6_KHR},
+		{8, 6, GL_COMPRESSED_RGBA_ASTC_8x6_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x6_KHR},
+		{8, 8, GL_COMPRESSED_RGBA_ASTC_8x8_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR},
+		{10, 8, GL_COMPRESSED_RGBA_ASTC_10x8_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x8_KHR},
+		{10, 10, GL_COMPRESSED_RGBA_ASTC_10x10_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x10_KHR},
+		{12, 10, GL_COMPRESSED_RGBA_ASTC_12x10_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x10_KHR},
+		{12, 12, GL_COMPRESSED_RGBA_ASTC_12x12_KHR, GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR},
+	};
+
+	const float astcErrorColor[4] = { 1.0f, 0.0f, 1.0f, 1.0f };   // Magenta
+}
+
+// Tests that LDR void-extent blocks decode to their UNORM16 color, and to its top 8 bits for sRGB.
+TEST_F(ASTCTest, VoidExtentLDR)
+{
+	const Block block = voidExtentBlock(false, 0xFFFF, 0x0000, 0x8000, 0x4000);
+	const Block srgbBlock = voidExtentBlock(false, 0xFF00, 0x80FF, 0x0000, 0xFFFF);
+
+	const float expected[4] = { 1.0f, 0.0f, unorm16(0x8000), unorm16(0x4000) };
+	const float expectedSRGB[4] = { 1.0f, 0.2158605f, 0.0f, 1.0f };   // sRGB 128 is linear 0.2158605
+
+	for(const Footprint &footprint : astcFootprints)
+	{
+		SCOPED_TRACE(testing::Message() << footprint.width << "x" << footprint.height);
+
+		expectUniform(decode(footprint.format, footprint.width, footprint.height, block), footprint.width, footprint.height, expected);
+		expectUniform(decode(footprint.srgbFormat, footprint.width, footprint.height, srgbBlock), footprint.width, footprint.height, expectedSRGB, 1.0e-3f);
+	}
+
+	// The two bits after the HDR flag must be set
+	Block reserved = block;
+	reserved.set(10, 2, 1);
+	expectUniform(decode(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 4, 4, reserved), 4, 4, astcErrorColor);
+}
+
+// Tests that HDR void-extent blocks decode to their FP16 color, which sRGB formats can't hold.
+TEST_F(ASTCTest, VoidExtentHDR)
+{
+	const Block block = voidExtentBlock(true, 0x4000, 0x4400, 0x3800, 0x3C00);
+	const float expected[4] = { 2.0f, 4.0f, 0.5f, 1.0f };
+
+	for(const Footprint &footprint : astcFootprints)
+	{
+		SCOPED_TRACE(testing::Message() << footprint.width << "x" << footprint.height);
+
+		expectUniform(decode(footprint.format, footprint.width, footprint.height, block), footprint.width, footprint.height, expected);
+		expectUniform(decode(footprint.srgbFormat, footprint.width, footprint.height, block), footprint.width, footprint.height, astcErrorColor);
+	}
+}
+
+// Tests interpolating LDR RGBA endpoints with each weight of a 4x4 grid.
+TEST_F(ASTCTest, LDRDirect)
+{
+	// Endpoints (0, 64, 255, 255) and (255, 128, 0, 255), which don't get blue contracted
+	const std::vector<unsigned int> values = { 0, 255, 64, 128, 255, 0, 255, 255 };
+
+	// Weights 0 to 3 unquantize to 0, 21, 43 and 64, left to right, then right to left
+	const unsigned int weights[16] = { 0, 1, 2, 3, 0, 1, 2, 3, 3, 2, 1, 0, 3, 2, 1, 0 };
+
+	// (C0 * (64 - w) + C1 * w + 32) >> 6, with C0 and C1 the endpoints times 257
+	const float expected[4][4] =
+	{
+		{ unorm16(0),     unorm16(16448), unorm16(65535), 1.0f },
+		{ unorm16(21504), unorm16(21845), unorm16(44031), 1.0f },
+		{ unorm16(44031), unorm16(27499), unorm16(21504), 1.0f },
+		{ unorm16(65535), unorm16(32896), unorm16(0),     1.0f },
+	};
+
+	std::vector<float> texels = decode(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 4, 4, directBlock(12, values, weights));
+
+	for(int y = 0; y < 4; y++)
+	{
+		for(int x = 0; x < 4; x++)
+		{
+			expectTexel(texels, 4, x, y, expected[weights[x + y * 4]]);
+		}
+	}
+
+	// sRGB endpoints are expanded to (e << 8) | 0x80 and only the top 8 bits are kept
+	std::vector<float> srgbTexels = decode(GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR, 4, 4, directBlock(12, values, weights));
+	const float left[4] = { 0.0f, 0.0512695f, 1.0f, 1.0f };    // sRGB (0, 64, 255)
+	const float right[4] = { 1.0f, 0.2158605f, 0.0f, 1.0f };   // sRGB (255, 128, 0)
+
+	expectTexel(srgbTexels, 4, 0, 0, left, 1.0e-3f);
+	expectTexel(srgbTexels, 4, 3, 0, right, 1.0e-3f);
+	expectTexel(srgbTexels, 4, 0, 3, right, 1.0e-3f);
+	expectTexel(srgbTexels, 4, 3, 3, left, 1.0e-3f);
+}
+
+// Tests that LDR RGB endpoints whose second sum is smaller get swapped and blue contracted.
+TEST_F(ASTCTest, LDRBlueContraction)
+{
+	// v1 + v3 + v5 < v0 + v2 + v4, so e0 = ((v1 + v5) / 2, (v3 + v5) / 2, v5) and e1 = ((v0 + v4) / 2, (v2 + v4) / 2, v4)
+	const std::vector<unsigned int> values = { 200, 100, 200, 50, 100, 20 };
+	const unsigned int weights[16] = { 0, 3, 0, 3, 3, 0, 3, 0, 0, 3, 0, 3, 3, 0, 3, 0 };
+
+	const float e0[4] = { 60 / 255.0f, 35 / 255.0f, 20 / 255.0f, 1.0f };
+	const float e1[4] = { 150 / 255.0f, 150 / 255.0f, 100 / 255.0f, 1.0f };
+
+	std::vector<float> texels = decode(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 4, 4, directBlock(8, values, weights));
+
+	for(int y = 0; y < 4; y++)
+	{
+		for(int x = 0; x < 4; x++)
+		{
+			expectTexel(texels, 4, x, y, weights[x + y * 4] ? e1 : e0);
+		}
+	}
+}
+
+// Tests that a 4x4 weight grid maps its corners onto the corners of every block footprint.
+TEST_F(ASTCTest, Footprints)
+{
+	const std::vector<unsigned int> values = { 0, 255, 64, 128, 255, 0, 255, 255 };
+	const unsigned int weights[16] = { 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 3 };
+
+	const float expected[4][4] =
+	{
+		{ unorm16(0),     unorm16(16448), unorm16(65535), 1.0f },
+		{ unorm16(21504), unorm16(21845), unorm16(44031), 1.0f },
+		{ unorm16(44031), unorm16(27499), unorm16(21504), 1.0f },
+		{ unorm16(65535), unorm16(32896), unorm16(0),     1.0f },
+	};
+
+	for(const Footprint &footprint : astcFootprints)
+	{
+		SCOPED_TRACE(testing::Message() << footprint.width << "x" << footprint.height);
+
+		int w = footprint.width;
+		int h = footprint.height;
+		std::vector<float> texels = decode(footprint.format, w, h, directBlock(12, values, weights));
+
+		expectTexel(texels, w, 0, 0, expected[0]);
+		expectTexel(texels, w, w - 1, 0, expected[1]);
+		expectTexel(texels, w, 0, h - 1, expected[2]);
+		expectTexel(texels, w, w - 1, h - 1, expected[3]);
+	}
+}
+
+// Tests interpolating HDR luminance endpoints, which happens on their logarithmic encoding.
+TEST_F(ASTCTest, HDRLuminance)
+{
+	// Mode 2 makes the endpoints v0 << 4 and v1 << 4, which are 2.0 and 512.0, with an alpha of 1.0
+	const std::vector<unsigned int> values = { 0x80, 0xC0 };
+	const unsigned int weights[16] = { 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3 };
+
+	// Weights 21 and 43 interpolate to 38144 and 43776, which convert to FP16 0x4A40 and 0x5540
+	const float luminance[4] = { 2.0f, 12.5f, 84.0f, 512.0f };
+
+	std::vector<float> texels = decode(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 4, 4, directBlock(2, values, weights));
+
+	for(int y = 0; y < 4; y++)
+	{
+		for(int x = 0; x < 4; x++)
+		{
+			const float expected[4] = { luminance[x], luminance[x], luminance[x], 1.0f };
+			expectTexel(texels, 4, x, y, expected);
+		}
+	}
+
+	// HDR endpoint modes are an error in sRGB formats
+	expectUniform(decode(GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR, 4, 4, directBlock(2, values, weights)), 4, 4, astcErrorColor);
+}
+
+// Tests that blocks the specification calls illegal decode to the error color.
+TEST_F(ASTCTest, ErrorBlocks)
+{
+	const std::vector<unsigned int> values = { 0, 255, 64, 128, 255, 0, 255, 255 };
+	const unsigned int weights[16] = {};
+
+	Block reservedMode;   // Block mode 0 is reserved
+
+	Block largeGrid = directBlock(12, values, weights);
+	largeGrid.set(0, 11, 0x044);   // 12x4 weight grid, wider than the block
+
+	Block fewWeightBits = directBlock(12, values, weights);
+	fewWeightBits.set(0, 11, 0x041);   // 4x4 grid of weights 0 to 1, only 16 weight bits
+
+	Block manyWeightBits = directBlock(12, values, weights);
+	manyWeightBits.set(0, 11, 0x642);   // Two planes of 4x4 weights 0 to 15, 128 weight bits
+
+	Block colorOverflow = directBlock(12, values, weights);
+	colorOverflow.set(0, 11, 0x453);   // Two planes of 4x4 weights 0 to 7 leave 13 bits for the 8 endpoint values
+
+	for(const Block &block : { reservedMode, largeGrid, fewWeightBits, manyWeightBits, colorOverflow })
+	{
+		expectUniform(decode(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 4, 4, block), 4, 4, astcErrorColor);
+		expectUniform(decode(GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR, 4, 4, block), 4, 4, astcErrorColor);
+	}
+}
+
+#ifndef EGL_SWIFTSHADER_performance_profile
+#define EGL_SWIFTSHADER_performance_profile 1
+#define EGL_DRAW_MERGING_SWIFTSHADER 0x34BF
+typedef EGLBoolean (EGLAPIENTRYP PFNEGLSETPERFORMANCEPROFILESWIFTSHADERPROC) (const EGLint *attrib_list);
+#endif
+
+// Tests that appending draws to the previous draw call, which depends on
+// whether it's still in flight, doesn't change the vertex IDs. Each point
+// gets its own pixel, colored by gl_VertexID.
+TEST_F(SwiftShaderTest, DrawMergingVertexID)
+{
+	Initialize(3, false);
+
+	auto setPerformanceProfile = reinterpret_cast<PFNEGLSETPERFORMANCEPROFILESWIFTSHADERPROC>(eglGetProcAddress("eglSetPerformanceProfileSWIFTSHADER"));
+	ASSERT_NE(nullptr, setPerformanceProfile);
+
+	GLuint renderbuffer = 0;
+	glGenRenderbuffers(1, &renderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 64, 64);
+	GLuint framebuffer = 0;
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+	EXPECT_GLENUM_EQ(GL_FRAMEBUFFER_COMPLETE, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+	glViewport(0, 0, 64, 64);
+
+	const std::string vs =
+		"#version 300 es\n"
+		"in vec2 position;\n"
+		"flat out int id;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = vec4((position + 0.5) / 32.0 - 1.0, 0.0, 1.0);\n"
+		"	gl_PointSize = 1.0;\n"
+		"	id = gl_VertexID;\n"
+		"}\n";
+
+	const std::string fs =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"flat in int id;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = vec4(float(id % 256), float(id / 256), 0.0, 255.0) / 255.0;\n"
+		"}\n";
+
+	ProgramHandles ph = createProgram(vs, fs);
+	glUseProgram(ph.program);
+
+	// A buffer, so consecutive draws continue in the same vertex stream
+	std::vector<float> positions;
+
+	for(int i = 0; i < 64 * 64; i++)
+	{
+		positions.push_back(static_cast<float>(i % 64));
+		positions.push_back(static_cast<float>(i / 64));
+	}
+
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float), positions.data(), GL_STATIC_DRAW);
+	GLint location = glGetAttribLocation(ph.program, "position");
+	glVertexAttribPointer(location, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+	glEnableVertexAttribArray(location);
+
+	auto draw = [&](EGLint merging)
+	{
+		const EGLint attributes[] = { EGL_DRAW_MERGING_SWIFTSHADER, merging, EGL_NONE };
+		EXPECT_EQ((EGLBoolean)EGL_TRUE, setPerformanceProfile(attributes));
+
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// Each draw continues where the previous one ended
+		for(int row = 0; row < 64; row++)
+		{
+			glDrawArrays(GL_POINTS, row * 64, 64);
+		}
+
+		std::vector<unsigned char> pixels(64 * 64 * 4);
+		glReadPixels(0, 0, 64, 64, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		return pixels;
+	};
+
+	std::vector<unsigned char> separate = draw(EGL_FALSE);
+	std::vector<unsigned char> merged = draw(EGL_TRUE);
+	EXPECT_EQ(separate, merged);
+
+	setPerformanceProfile(nullptr);
+
+	glDisableVertexAttribArray(location);
+	glDeleteBuffers(1, &buffer);
+	glDeleteFramebuffers(1, &framebuffer);
+	glDeleteRenderbuffers(1, &renderbuffer);
+	deleteProgram(ph);
+	Uninitialize();
+}
+
+// Tests the EXT_disjoint_timer_query elapsed time and timestamp queries. The
+// results use the same clock as glGetInteger64v(GL_TIMESTAMP_EXT), so they're
+// bounded by timestamps taken around them.
+class TimerQueryTest : public SwiftShaderTest
+{
+protected:
+	void SetUp() override
+	{
+		SwiftShaderTest::SetUp();
+		Initialize(3, false);
+
+		const char *extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+		EXPECT_THAT(extensions, testing::HasSubstr("GL_EXT_disjoint_timer_query"));
+
+		genQueries = reinterpret_cast<PFNGLGENQUERIESEXTPROC>(eglGetProcAddress("glGenQueriesEXT"));
+		deleteQueries = reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(eglGetProcAddress("glDeleteQueriesEXT"));
+		beginQuery = reinterpret_cast<PFNGLBEGINQUERYEXTPROC>(eglGetProcAddress("glBeginQueryEXT"));
+		endQuery = reinterpret_cast<PFNGLENDQUERYEXTPROC>(eglGetProcAddress("glEndQueryEXT"));
+		queryCounter = reinterpret_cast<PFNGLQUERYCOUNTEREXTPROC>(eglGetProcAddress("glQueryCounterEXT"));
+		getQueryiv = reinterpret_cast<PFNGLGETQUERYIVEXTPROC>(eglGetProcAddress("glGetQueryivEXT"));
+		getQueryObjectuiv = reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(eglGetProcAddress("glGetQueryObjectuivEXT"));
+		getQueryObjectui64v = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(eglGetProcAddress("glGetQueryObjectui64vEXT"));
+
+		ASSERT_NE(nullptr, genQueries);
+		ASSERT_NE(nullptr, deleteQueries);
+		ASSERT_NE(nullptr, beginQuery);
+		ASSERT_NE(nullptr, endQuery);
+		ASSERT_NE(nullptr, queryCounter);
+		ASSERT_NE(nullptr, getQueryiv);
+		ASSERT_NE(nullptr, getQueryObjectuiv);
+		ASSERT_NE(nullptr, getQueryObjectui64v);
+
+		const std::string vs =
+			"attribute vec4 position;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+			"}\n";
+
+		const std::string fs =
+			"precision mediump float;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_FragColor = vec4(0.0, 1.0, 0.0, 1.0);\n"
+			"}\n";
+
+		ph = createProgram(vs, fs);
+	}
+
+	void TearDown() override
+	{
+		deleteProgram(ph);
+		Uninitialize();
+	}
+
+	GLuint64 timestamp()
+	{
+		GLint64 time = 0;
+		glGetInteger64v(GL_TIMESTAMP_EXT, &time);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+		EXPECT_GT(time, 0);
+
+		return static_cast<GLuint64>(time);
+	}
+
+	GLuint isAvailable(GLuint query)
+	{
+		GLuint available = GL_FALSE;
+		getQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		return available;
+	}
+
+	GLuint64 getResult(GLuint query)
+	{
+		GLuint64 result = 0;
+		getQueryObjectui64v(query, GL_QUERY_RESULT_EXT, &result);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		return result;
+	}
+
+	void drawQuads(int count)
+	{
+		for(int i = 0; i < count; i++)
+		{
+			drawQuad(ph.program);
+		}
+	}
+
+	PFNGLGENQUERIESEXTPROC genQueries = nullptr;
+	PFNGLDELETEQUERIESEXTPROC deleteQueries = nullptr;
+	PFNGLBEGINQUERYEXTPROC beginQuery = nullptr;
+	PFNGLENDQUERYEXTPROC endQuery = nullptr;
+	PFNGLQUERYCOUNTEREXTPROC queryCounter = nullptr;
+	PFNGLGETQUERYIVEXTPROC getQueryiv = nullptr;
+	PFNGLGETQUERYOBJECTUIVEXTPROC getQueryObjectuiv = nullptr;
+	PFNGLGETQUERYOBJECTUI64VEXTPROC getQueryObjectui64v = nullptr;
+
+	ProgramHandles ph;
+};
+
+TEST_F(TimerQueryTest, Properties)
+{
+	GLint bits = 0;
+	getQueryiv(GL_TIME_ELAPSED_EXT, GL_QUERY_COUNTER_BITS_EXT, &bits);
+	EXPECT_EQ(64, bits);
+	getQueryiv(GL_TIMESTAMP_EXT, GL_QUERY_COUNTER_BITS_EXT, &bits);
+	EXPECT_EQ(64, bits);
+
+	GLint disjoint = GL_TRUE;
+	glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+	EXPECT_EQ(GL_FALSE, disjoint);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	GLuint query = 0;
+	genQueries(1, &query);
+
+	queryCounter(query, GL_TIME_ELAPSED_EXT);
+	EXPECT_GLENUM_EQ(GL_INVALID_ENUM, glGetError());
+	beginQuery(GL_TIMESTAMP_EXT, query);
+	EXPECT_GLENUM_EQ(GL_INVALID_ENUM, glGetError());
+	queryCounter(query + 1, GL_TIMESTAMP_EXT);   // Not generated
+	EXPECT_GLENUM_EQ(GL_INVALID_OPERATION, glGetError());
+
+	// Only one elapsed time query can be active, and it can't be a timestamp too
+	GLint current = 0;
+	beginQuery(GL_TIME_ELAPSED_EXT, query);
+	getQueryiv(GL_TIME_ELAPSED_EXT, GL_CURRENT_QUERY_EXT, &current);
+	EXPECT_EQ(static_cast<GLint>(query), current);
+	beginQuery(GL_TIME_ELAPSED_EXT, query);
+	EXPECT_GLENUM_EQ(GL_INVALID_OPERATION, glGetError());
+	queryCounter(query, GL_TIMESTAMP_EXT);
+	EXPECT_GLENUM_EQ(GL_INVALID_OPERATION, glGetError());
+	endQuery(GL_TIME_ELAPSED_EXT);
+	getQueryiv(GL_TIME_ELAPSED_EXT, GL_CURRENT_QUERY_EXT, &current);
+	EXPECT_EQ(0, current);
+
+	deleteQueries(1, &query);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+}
+
+TEST_F(TimerQueryTest, TimeElapsed)
+{
+	GLuint query[2] = { 0, 0 };
+	genQueries(2, query);
+
+	// Without any draw calls no time elapses
+	beginQuery(GL_TIME_ELAPSED_EXT, query[0]);
+	endQuery(GL_TIME_ELAPSED_EXT);
+	EXPECT_EQ(0u, getResult(query[0]));
+	EXPECT_EQ(static_cast<GLuint>(GL_TRUE), isAvailable(query[0]));
+
+	GLuint64 before = timestamp();
+	beginQuery(GL_TIME_ELAPSED_EXT, query[0]);
+	drawQuads(8);
+	endQuery(GL_TIME_ELAPSED_EXT);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	isAvailable(query[0]);   // Either way, rendering is asynchronous
+	glFinish();
+	EXPECT_EQ(static_cast<GLuint>(GL_TRUE), isAvailable(query[0]));
+	GLuint64 after = timestamp();
+
+	GLuint64 elapsed = getResult(query[0]);
+	EXPECT_GT(elapsed, 0u);
+	EXPECT_LE(elapsed, after - before);
+
+	// Getting the result waits for the draw calls, without finishing
+	before = timestamp();
+	beginQuery(GL_TIME_ELAPSED_EXT, query[1]);
+	drawQuads(8);
+	endQuery(GL_TIME_ELAPSED_EXT);
+	elapsed = getResult(query[1]);
+	after = timestamp();
+
+	EXPECT_EQ(static_cast<GLuint>(GL_TRUE), isAvailable(query[1]));
+	EXPECT_GT(elapsed, 0u);
+	EXPECT_LE(elapsed, after - before);
+
+	// Draw calls after the query ended don't count
+	drawQuads(8);
+	EXPECT_EQ(elapsed, getResult(query[1]));
+
+	// The 32-bit result keeps the low bits
+	GLuint elapsed32 = 0;
+	getQueryObjectuiv(query[1], GL_QUERY_RESULT_EXT, &elapsed32);
+	EXPECT_EQ(static_cast<GLuint>(elapsed), elapsed32);
+
+	deleteQueries(2, query);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+}
+
+TEST_F(TimerQueryTest, Timestamp)
+{
+	GLuint query[4] = { 0, 0, 0, 0 };
+	genQueries(4, query);
+
+	glFinish();
+
+	// With nothing in flight the timestamp completes at once
+	GLuint64 before = timestamp();
+	queryCounter(query[0], GL_TIMESTAMP_EXT);
+	EXPECT_EQ(static_cast<GLuint>(GL_TRUE), isAvailable(query[0]));
+	GLuint64 idle = getResult(query[0]);
+	EXPECT_LE(before, idle);
+	EXPECT_LE(idle, timestamp());
+
+	// Timestamps after draw calls complete once those draw calls did
+	before = timestamp();
+	drawQuads(4);
+	queryCounter(query[1], GL_TIMESTAMP_EXT);
+	drawQuads(4);
+	queryCounter(query[2], GL_TIMESTAMP_EXT);
+	drawQuads(4);
+	queryCounter(query[3], GL_TIMESTAMP_EXT);
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+	glFinish();
+	GLuint64 after = timestamp();
+
+	GLuint64 time[3];
+
+	for(int i = 0; i < 3; i++)
+	{
+		EXPECT_EQ(static_cast<GLuint>(GL_TRUE), isAvailable(query[i + 1]));
+		time[i] = getResult(query[i + 1]);
+	}
+
+	// The results are monotonic
+	EXPECT_LE(before, time[0]);
+	EXPECT_LE(time[0], time[1]);
+	EXPECT_LE(time[1], time[2]);
+	EXPECT_LE(time[2], after);
+
+	// Getting the result of a pending timestamp waits for it
+	drawQuads(4);
+	queryCounter(query[0], GL_TIMESTAMP_EXT);
+	GLuint64 reused = getResult(query[0]);
+	EXPECT_EQ(static_cast<GLuint>(GL_TRUE), isAvailable(query[0]));
+	EXPECT_LE(after, reused);
+	EXPECT_LE(reused, timestamp());
+
+	// Deleting pending timestamps is fine
+	drawQuads(4);
+	queryCounter(query[1], GL_TIMESTAMP_EXT);
+	queryCounter(query[1], GL_TIMESTAMP_EXT);
+	deleteQueries(4, query);
+	glFinish();
+	EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+}
+
+// Tests GL_PRIMITIVE_RESTART_FIXED_INDEX on strips and fans, for each index
+// type and with the indices in client memory or a buffer. Positions are in
+// pixels of an 8x8 framebuffer. Quad column c covers pixels 2c and 2c + 1,
+// and is drawn by vertices 2c (top), 2c + 1 (bottom), 2c + 2 and 2c + 3.
+class PrimitiveRestartTest : public SwiftShaderTest
+{
+protected:
+	static const GLuint restart = 0xFFFFFFFF;   // Replaced by the index type's restart index
+
+	void SetUp() override
+	{
+		SwiftShaderTest::SetUp();
+		Initialize(3, false);
+
+		glGenRenderbuffers(1, &renderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 8, 8);
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+		EXPECT_GLENUM_EQ(GL_FRAMEBUFFER_COMPLETE, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+		glViewport(0, 0, 8, 8);
+
+		glGenBuffers(1, &indexBuffer);
+
+		const std::string vs =
+			"#version 300 es\n"
+			"in vec2 position;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_Position = vec4(position / 4.0 - 1.0, 0.0, 1.0);\n"
+			"}\n";
+
+		const std::string fs =
+			"#version 300 es\n"
+			"precision mediump float;\n"
+			"out vec4 fragColor;\n"
+			"void main()\n"
+			"{\n"
+			"	fragColor = vec4(0.0, 1.0, 0.0, 1.0);\n"
+			"}\n";
+
+		ph = createProgram(vs, fs);
+		glUseProgram(ph.program);
+
+		glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+	}
+
+	void TearDown() override
+	{
+		glDeleteBuffers(1, &indexBuffer);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &renderbuffer);
+		deleteProgram(ph);
+		Uninitialize();
+	}
+
+	// Clears the framebuffer and draws the indices converted to the type
+	void draw(GLenum mode, const std::vector<float> &positions, const std::vector<GLuint> &indices, GLenum type, bool buffer)
+	{
+		size_t size = (type == GL_UNSIGNED_BYTE) ? 1 : (type == GL_UNSIGNED_SHORT) ? 2 : 4;
+		std::vector<unsigned char> data(indices.size() * size);
+
+		for(size_t i = 0; i < indices.size(); i++)
+		{
+			GLuint index = indices[i];
+			unsigned char byteIndex = static_cast<unsigned char>(index);   // The restart index truncates to the type's maximum
+			unsigned short shortIndex = static_cast<unsigned short>(index);
+
+			switch(size)
+			{
+			case 1: memcpy(&data[i * size], &byteIndex, size); break;
+			case 2: memcpy(&data[i * size], &shortIndex, size); break;
+			case 4: memcpy(&data[i * size], &index, size); break;
+			}
+		}
+
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		GLint location = glGetAttribLocation(ph.program, "position");
+		glVertexAttribPointer(location, 2, GL_FLOAT, GL_FALSE, 0, positions.data());
+		glEnableVertexAttribArray(location);
+
+		GLsizei count = static_cast<GLsizei>(indices.size());
+
+		if(buffer)
+		{
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
+			glDrawElements(mode, count, type, nullptr);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		}
+		else
+		{
+			glDrawElements(mode, count, type, data.data());
+		}
+
+		glDisableVertexAttribArray(location);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+	}
+
+	// Checks a row of pixels, 'X' for drawn, '.' for clear and '?' for either
+	void expectRow(int y, const char pattern[9])
+	{
+		unsigned char row[8][4];
+		glReadPixels(0, y, 8, 1, GL_RGBA, GL_UNSIGNED_BYTE, row);
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		std::string drawn;
+
+		for(int x = 0; x < 8; x++)
+		{
+			drawn += (pattern[x] == '?') ? '?' : (row[x][1] == 255) ? 'X' : '.';
+		}
+
+		EXPECT_EQ(std::string(pattern), drawn) << "row " << y;
+	}
+
+	// Runs the check for each index type, with client side and buffer indices
+	template<class Check>
+	void forEachIndexSource(Check check)
+	{
+		for(GLenum type : { GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT })
+		{
+			for(bool buffer : { false, true })
+			{
+				SCOPED_TRACE(testing::Message() << "type 0x" << std::hex << type << (buffer ? " buffer" : " client"));
+				check(type, buffer);
+			}
+		}
+	}
+
+	static std::vector<float> quadColumns()
+	{
+		std::vector<float> positions;
+
+		for(int c = 0; c <= 4; c++)
+		{
+			positions.insert(positions.end(), { 2.0f * c, 8.0f, 2.0f * c, 0.0f });
+		}
+
+		return positions;
+	}
+
+	ProgramHandles ph;
+	GLuint renderbuffer = 0;
+	GLuint framebuffer = 0;
+	GLuint indexBuffer = 0;
+};
+
+TEST_F(PrimitiveRestartTest, TriangleStrips)
+{
+	const std::vector<float> positions = quadColumns();
+
+	forEachIndexSource([&](GLenum type, bool buffer)
+	{
+		// Without the restart the strip would also cover column 1
+		draw(GL_TRIANGLE_STRIP, positions, { 0, 1, 2, 3, restart, 4, 5, 6, 7 }, type, buffer);
+		expectRow(1, "XX..XX..");
+		expectRow(6, "XX..XX..");
+
+		draw(GL_TRIANGLE_STRIP, positions, { restart, 0, 1, 2, 3 }, type, buffer);
+		expectRow(1, "XX......");
+		expectRow(6, "XX......");
+
+		draw(GL_TRIANGLE_STRIP, positions, { 0, 1, 2, 3, restart }, type, buffer);
+		expectRow(1, "XX......");
+		expectRow(6, "XX......");
+
+		// Consecutive restarts, and a strip too short for a triangle
+		draw(GL_TRIANGLE_STRIP, positions, { restart, restart, 2, 3, 4, 5, restart, restart, 0, 1, restart, 6, 7, 8, 9, restart }, type, buffer);
+		expectRow(1, "..XX..XX");
+		expectRow(6, "..XX..XX");
+
+		// The winding alternates from the start of each strip. A single triangle
+		// covers the top left half of column 0, and the next strip isn't culled.
+		glEnable(GL_CULL_FACE);
+		draw(GL_TRIANGLE_STRIP, positions, { 0, 1, 2, restart, 4, 5, 6, 7 }, type, buffer);
+		expectRow(1, "....XX..");
+		expectRow(6, "XX..XX..");
+		glDisable(GL_CULL_FACE);
+	});
+}
+
+TEST_F(PrimitiveRestartTest, TriangleFans)
+{
+	const std::vector<float> positions = quadColumns();
+
+	forEachIndexSource([&](GLenum type, bool buffer)
+	{
+		// Without the restart the fan around vertex 0 would continue into columns 1 and 2
+		glEnable(GL_CULL_FACE);
+		draw(GL_TRIANGLE_FAN, positions, { 0, 1, 3, 2, restart, 4, 5, 7, 6 }, type, buffer);
+		expectRow(1, "XX..XX..");
+		expectRow(6, "XX..XX..");
+		glDisable(GL_CULL_FACE);
+
+		draw(GL_TRIANGLE_FAN, positions, { restart, 2, 3, 5, 4 }, type, buffer);
+		expectRow(1, "..XX....");
+		expectRow(6, "..XX....");
+
+		draw(GL_TRIANGLE_FAN, positions, { 6, 7, 9, 8, restart }, type, buffer);
+		expectRow(1, "......XX");
+		expectRow(6, "......XX");
+
+		draw(GL_TRIANGLE_FAN, positions, { restart, 2, 3, 5, 4, restart, restart, 0, 1, restart, 6, 7, 9, 8, restart }, type, buffer);
+		expectRow(1, "..XX..XX");
+		expectRow(6, "..XX..XX");
+	});
+}
+
+TEST_F(PrimitiveRestartTest, LineStrips)
+{
+	// Along the middle of row 4, the pixels at the ends of each line may or may not be drawn
+	const std::vector<float> positions = { 0.0f, 4.5f, 2.0f, 4.5f, 6.0f, 4.5f, 8.0f, 4.5f };
+
+	forEachIndexSource([&](GLenum type, bool buffer)
+	{
+		// Without the restart the strip would also cover pixels 3 and 4
+		draw(GL_LINE_STRIP, positions, { 0, 1, restart, 2, 3 }, type, buffer);
+		expectRow(4, "?X?..?X?");
+		expectRow(3, "........");
+
+		draw(GL_LINE_STRIP, positions, { restart, 0, 1 }, type, buffer);
+		expectRow(4, "?X?.....");
+
+		draw(GL_LINE_STRIP, positions, { 2, 3, restart }, type, buffer);
+		expectRow(4, ".....?X?");
+
+		// Strips of a single vertex draw nothing
+		draw(GL_LINE_STRIP, positions, { restart, 1, restart, restart, 2, 3, restart, 0 }, type, buffer);
+		expectRow(4, ".....?X?");
+	});
+}
+
+TEST_F(PrimitiveRestartTest, OnlyRestarts)
+{
+	const std::vector<float> positions = quadColumns();
+
+	forEachIndexSource([&](GLenum type, bool buffer)
+	{
+		// No primitives remain, so nothing gets drawn and the draw calls don't fail
+		for(GLenum mode : { GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_LINE_STRIP })
+		{
+			SCOPED_TRACE(testing::Message() << "mode 0x" << std::hex << mode);
+
+			draw(mode, positions, { restart }, type, buffer);
+			expectRow(1, "........");
+			expectRow(4, "........");
+			expectRow(6, "........");
+
+			draw(mode, positions, { restart, restart, restart, restart, restart }, type, buffer);
+			expectRow(1, "........");
+			expectRow(4, "........");
+			expectRow(6, "........");
+		}
+
+		// Subsequent draw calls aren't affected
+		draw(GL_TRIANGLE_STRIP, positions, { 0, 1, 2, 3 }, type, buffer);
+		expectRow(1, "XX......");
+		expectRow(6, "XX......");
+	});
+}
+
+// sw::Shader::optimize() rewrites the data flow of the instructions, which '#pragma optimize(off)'
+// disables. Rendering each shader both ways has to produce the same pixels.
+class ShaderOptimizationTest : public SwiftShaderTest
+{
+protected:
+	void SetUp() override
+	{
+		SwiftShaderTest::SetUp();
+		Initialize(3, false);
+
+		glGenRenderbuffers(1, &renderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 16, 16);
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+		EXPECT_GLENUM_EQ(GL_FRAMEBUFFER_COMPLETE, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+		glViewport(0, 0, 16, 16);
+	}
+
+	void TearDown() override
+	{
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &renderbuffer);
+		Uninitialize();
+	}
+
+	// Inserts the pragma after the version directive
+	static std::string unoptimized(const std::string &source)
+	{
+		size_t line = source.find('\n') + 1;
+
+		return source.substr(0, line) + "#pragma optimize(off)\n" + source.substr(line);
+	}
+
+	// Draws a quad with the uniform array 'u' set, if used
+	std::vector<unsigned char> render(const std::string &vs, const std::string &fs)
+	{
+		ProgramHandles ph = createProgram(vs, fs);
+		glUseProgram(ph.program);
+
+		GLint location = glGetUniformLocation(ph.program, "u");
+
+		if(location != -1)
+		{
+			float u[8][4];
+
+			for(int i = 0; i < 8; i++)
+			{
+				u[i][0] = (i + 1) / 8.0f;
+				u[i][1] = (8 - i) / 16.0f;
+				u[i][2] = (i % 3) / 4.0f;
+				u[i][3] = 0.5f + (i % 2) / 4.0f;
+			}
+
+			glUniform4fv(location, 8, &u[0][0]);
+		}
+
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		drawQuad(ph.program);
+
+		std::vector<unsigned char> pixels(16 * 16 * 4);
+		glReadPixels(0, 0, 16, 16, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		EXPECT_GLENUM_EQ(GL_NONE, glGetError());
+
+		deleteProgram(ph);
+
+		return pixels;
+	}
+
+	void expectUnchangedOutput(const std::string &vs, const std::string &fs)
+	{
+		std::vector<unsigned char> reference = render(unoptimized(vs), unoptimized(fs));
+		std::vector<unsigned char> optimized = render(vs, fs);
+
+		// Varies across the quad, so it isn't trivially the same
+		EXPECT_NE(0, memcmp(&reference[0], &reference[reference.size() - 4], 4));
+
+		for(size_t i = 0; i < reference.size(); i++)
+		{
+			if(reference[i] != optimized[i])
+			{
+				ADD_FAILURE() << "pixel " << (i / 4) % 16 << "," << i / 64 << " component " << i % 4 << ": " << (int)optimized[i] << " instead of " << (int)reference[i];
+				break;
+			}
+		}
+	}
+
+	static const std::string passthroughVS;
+
+	GLuint renderbuffer = 0;
+	GLuint framebuffer = 0;
+};
+
+const std::string ShaderOptimizationTest::passthroughVS =
+	"#version 300 es\n"
+	"in vec3 position;\n"
+	"out vec2 v;\n"
+	"void main()\n"
+	"{\n"
+	"	v = position.xy * 0.5 + 0.5;\n"
+	"	gl_Position = vec4(position, 1.0);\n"
+	"}\n";
+
+TEST_F(ShaderOptimizationTest, RelativeAddressing)
+{
+	// Copies of dynamically indexed uniforms
+	expectUnchangedOutput(passthroughVS,
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform vec4 u[8];\n"
+		"in vec2 v;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	int i = int(v.x * 7.99);\n"
+		"	vec4 a = u[i];\n"
+		"	vec4 b = a;\n"
+		"	int j = (i + int(v.y * 4.0)) & 7;\n"
+		"	b.yz = u[j].xw;\n"
+		"	vec4 c = b;\n"
+		"	color = vec4(c.xy, a.zw) * 0.5 + u[7 - i] * 0.5;\n"
+		"}\n");
+
+	// Dynamically indexed temporaries, written after being copied
+	expectUnchangedOutput(passthroughVS,
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform vec4 u[8];\n"
+		"in vec2 v;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 t[4];\n"
+		"	for(int k = 0; k < 4; k++) t[k] = u[k] * v.x;\n"
+		"	int i = int(v.y * 3.99);\n"
+		"	t[i].xz = v.yx;\n"
+		"	vec4 a = t[i];\n"
+		"	t[i] = vec4(0.25);\n"
+		"	color = a * 0.5 + t[(i + 1) & 3] * 0.5 + t[i] * 0.25;\n"
+		"}\n");
+
+	// Dynamically indexed uniforms in the vertex shader
+	expectUnchangedOutput(
+		"#version 300 es\n"
+		"uniform vec4 u[8];\n"
+		"in vec3 position;\n"
+		"out vec4 w;\n"
+		"void main()\n"
+		"{\n"
+		"	int i = int((position.x + 1.0) * 3.5);\n"
+		"	vec4 a = u[i];\n"
+		"	a.zw = position.yx;\n"
+		"	vec4 b = a;\n"
+		"	if(position.y > 0.0) b.x = u[7 - i].y;\n"
+		"	w = b * 0.5 + 0.5;\n"
+		"	gl_Position = vec4(position, 1.0);\n"
+		"}\n",
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"in vec4 w;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	color = w;\n"
+		"}\n");
+}
+
+TEST_F(ShaderOptimizationTest, PartialWriteMasks)
+{
+	expectUnchangedOutput(passthroughVS,
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"in vec2 v;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 a;\n"
+		"	a.xy = v;\n"
+		"	a.zw = v.yx * 0.5;\n"
+		"	a.y = 0.75;\n"   // Overwrites part of an earlier write
+		"	vec4 b = a;\n"
+		"	b.xz = b.zx;\n"  // Swizzles a copy onto itself
+		"	vec3 c = b.wzy;\n"
+		"	c.x = a.x * 0.5;\n"
+		"	color = vec4(c, b.x) * 0.75 + a.wzyx * 0.25;\n"
+		"}\n");
+}
+
+TEST_F(ShaderOptimizationTest, DynamicBranching)
+{
+	expectUnchangedOutput(passthroughVS,
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"in vec2 v;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 a = vec4(0.0);\n"
+		"	vec4 b = vec4(v, 0.5, 1.0);\n"
+		"	if(v.x > 0.5)\n"
+		"	{\n"
+		"		a.xy = v.yx;\n"
+		"		b = a;\n"   // Copied on one side of the branch only
+		"	}\n"
+		"	else\n"
+		"	{\n"
+		"		a.zw = v;\n"
+		"	}\n"
+		"	int n = int(v.y * 8.0);\n"
+		"	for(int k = 0; k < 8; k++)\n"
+		"	{\n"
+		"		if(k >= n) break;\n"
+		"		if((k & 1) == 0) continue;\n"
+		"		a.x += 0.0625;\n"
+		"		b.w = a.x;\n"
+		"	}\n"
+		"	vec4 c = b;\n"   // Only read when the next branch is taken
+		"	if(v.y > 0.25) a = c * 0.5 + a * 0.5;\n"
+		"	color = a;\n"
+		"}\n");
+}
+
+TEST_F(ShaderOptimizationTest, ConditionalWrites)
+{
+	// GLSL has no predicated instructions, selections and discards are the nearest
+	expectUnchangedOutput(passthroughVS,
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform vec4 u[8];\n"
+		"in vec2 v;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 a = u[0];\n"
+		"	a.x = v.x > v.y ? v.x : a.x;\n"
+		"	a.yw = v.x < 0.25 ? vec2(1.0) : a.wy;\n"
+		"	vec4 b = mix(a, u[1], bvec4(v.x > 0.5, false, true, v.y > 0.5));\n"
+		"	if(v.x + v.y > 1.75) discard;\n"
+		"	color = b;\n"
+		"}\n");
+}
+
+TEST_F(ShaderOptimizationTest, HoistedUniformsOverwritten)
+{
+	// Uniform computations get hoisted into the per-draw prologue, while the registers
+	// holding their results get written again before the results are read
+	expectUnchangedOutput(passthroughVS,
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform vec4 u[8];\n"
+		"in vec2 v;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 a = u[0] * u[1] + u[2];\n"
+		"	vec4 b = a;\n"
+		"	a = vec4(v, 0.0, 1.0);\n"
+		"	a.xy += u[3].xy * u[4].x;\n"
+		"	vec4 h = u[5] * u[6];\n"
+		"	h.x = v.x;\n"
+		"	vec4 c = u[7] * 0.5;\n"
+		"	if(v.y > 0.5) c.yz = v;\n"
+		"	color = a * 0.25 + b * 0.25 + h.wzyx * 0.25 + c * 0.25;\n"
+		"}\n");
+}
+
+TEST_F(ShaderOptimizationTest, HoistedUniformsInLoops)
+{
+	expectUnchangedOutput(passthroughVS,
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform vec4 u[8];\n"
+		"in vec2 v;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 acc = vec4(0.0);\n"
+		"	int n = int(v.x * 8.0);\n"
+		"	vec4 h = u[0] * u[1];\n"   // Changes on each iteration
+		"	for(int k = 0; k < 8; k++)\n"
+		"	{\n"
+		"		if(k >= n) break;\n"
+		"		acc += h * 0.125;\n"
+		"		h = h.yzwx * u[2].x + u[3] * 0.25;\n"
+		"	}\n"
+		"	vec4 g = u[4] + u[5];\n"   // Only read in the loop
+		"	for(int k = 0; k < n; k++)\n"
+		"	{\n"
+		"		acc.x += g.y * 0.0625;\n"
+		"		acc.zw += (u[6].xy * u[7].zw) * 0.0625;\n"
+		"	}\n"
+		"	color = acc;\n"
+		"}\n");
+
+	// Loop carried uniform computations in the vertex shader
+	expectUnchangedOutput(
+		"#version 300 es\n"
+		"uniform vec4 u[8];\n"
+		"in vec3 position;\n"
+		"out vec4 w;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 h = u[0] * u[1];\n"
+		"	vec4 acc = vec4(0.0);\n"
+		"	for(int k = 0; k < 4; k++)\n"
+		"	{\n"
+		"		h = h * u[2] + u[3] * 0.25;\n"
+		"		acc += h * (position.x + 1.0) * 0.125;\n"
+		"	}\n"
+		"	w = acc;\n"
+		"	gl_Position = vec4(position, 1.0);\n"
+		"}\n",
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"in vec4 w;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	color = w;\n"
+		"}\n");
+}
+
+// The LRUCache is header-only, so it's tested directly. The entries count
+// their bindings, and the hashes are test-local because the default one isn't
+// exported from the libraries.
+namespace
+{
+	struct LRUEntry
+	{
+		void bind() { bindings++; }
+		void unbind() { bindings--; }
+
+		int bindings = 0;
+	};
+
+	struct IdentityHash
+	{
+		unsigned int operator()(const int &key) const { return static_cast<unsigned int>(key); }
+	};
+
+	struct CollidingHash   // Chains all entries in a single bucket
+	{
+		unsigned int operator()(const int &) const { return 0; }
+	};
+}
+
+template<class Hash>
+static void testEvictionOrder()
+{
+	LRUEntry entry[8];   // Outlives the cache, which unbinds the remaining entries
+	sw::LRUCache<int, LRUEntry, Hash> cache(4);
+
+	for(int i = 0; i < 4; i++)
+	{
+		EXPECT_EQ(&entry[i], cache.add(i, &entry[i]));
+		EXPECT_EQ(1, entry[i].bindings);
+	}
+
+	EXPECT_EQ(&entry[0], cache.query(0));   // Now the most recently used
+	EXPECT_EQ(0u, cache.getEvictions());
+
+	cache.add(4, &entry[4]);   // Evicts 1, the least recently used
+	EXPECT_EQ(1u, cache.getEvictions());
+	EXPECT_EQ(0, entry[1].bindings);
+	EXPECT_EQ(nullptr, cache.query(1));
+
+	cache.add(5, &entry[5]);   // Evicts 2
+	EXPECT_EQ(2u, cache.getEvictions());
+	EXPECT_EQ(0, entry[2].bindings);
+	EXPECT_EQ(nullptr, cache.query(2));
+
+	EXPECT_EQ(&entry[3], cache.query(3));
+	EXPECT_EQ(&entry[0], cache.query(0));
+	EXPECT_EQ(&entry[4], cache.query(4));
+	EXPECT_EQ(&entry[5], cache.query(5));
+
+	cache.add(6, &entry[6]);   // The queries above left 3 as the least recently used
+	EXPECT_EQ(0, entry[3].bindings);
+	EXPECT_EQ(nullptr, cache.query(3));
+
+	EXPECT_EQ(5u, cache.getHits());
+	EXPECT_EQ(3u, cache.getMisses());
+	EXPECT_EQ(3u, cache.getEvictions());
+
+	for(int i : { 0, 4, 5, 6 })
+	{
+		EXPECT_EQ(1, entry[i].bindings);
+	}
+}
+
+template<class Hash>
+static void testLookupThenReplace()
+{
+	LRUEntry entry[8];   // Outlives the cache, which unbinds the remaining entries
+	sw::LRUCache<int, LRUEntry, Hash> cache(4);
+
+	for(int i = 0; i < 4; i++)
+	{
+		cache.add(i, &entry[i]);
+	}
+
+	// A routine cache replaces a looked up entry with an updated one
+	EXPECT_EQ(&entry[1], cache.query(1));
+	EXPECT_EQ(&entry[4], cache.replace(1, &entry[4]));
+	EXPECT_EQ(0, entry[1].bindings);
+	EXPECT_EQ(1, entry[4].bindings);
+	EXPECT_EQ(&entry[4], cache.query(1));
+	EXPECT_EQ(0u, cache.getEvictions());
+
+	// Replacing doesn't change the recency, so 0 is still evicted first
+	cache.replace(0, &entry[5]);
+	EXPECT_EQ(0, entry[0].bindings);
+	cache.add(6, &entry[6]);
+	EXPECT_EQ(0, entry[5].bindings);
+	EXPECT_EQ(nullptr, cache.query(0));
+	EXPECT_EQ(1u, cache.getEvictions());
+
+	// Replacing a key which isn't cached adds it, evicting 2
+	EXPECT_EQ(&entry[7], cache.replace(0, &entry[7]));
+	EXPECT_EQ(1, entry[7].bindings);
+	EXPECT_EQ(0, entry[2].bindings);
+	EXPECT_EQ(&entry[7], cache.query(0));
+	EXPECT_EQ(nullptr, cache.query(2));
+	EXPECT_EQ(2u, cache.getEvictions());
+}
+
+template<class Hash>
+static void testResize()
+{
+	LRUEntry entry[8];
+
+	{
+		sw::LRUCache<int, LRUEntry, Hash> cache(8);
+
+		for(int i = 0; i < 6; i++)
+		{
+			cache.add(i, &entry[i]);
+		}
+
+		cache.query(0);
+		cache.query(1);
+
+		cache.resize(3);   // Rounds up to 4, keeping 1, 0, 5 and 4
+		EXPECT_EQ(4, cache.getSize());
+		EXPECT_EQ(2u, cache.getEvictions());
+		EXPECT_EQ(0, entry[2].bindings);
+		EXPECT_EQ(0, entry[3].bindings);
+
+		for(int i : { 0, 1, 4, 5 })
+		{
+			EXPECT_EQ(1, entry[i].bindings);
+		}
+
+		cache.add(6, &entry[6]);   // The kept entries retain their order, so 4 goes first
+		EXPECT_EQ(0, entry[4].bindings);
+		EXPECT_EQ(nullptr, cache.query(4));
+		EXPECT_EQ(&entry[5], cache.query(5));
+		EXPECT_EQ(&entry[0], cache.query(0));
+		EXPECT_EQ(&entry[1], cache.query(1));
+		EXPECT_EQ(&entry[6], cache.query(6));
+	}
+
+	for(int i = 0; i < 8; i++)   // Destroying the cache unbinds everything
+	{
+		EXPECT_EQ(0, entry[i].bindings);
+	}
+}
+
+// Each test runs with a spreading hash and with one that chains all entries in a single bucket
+TEST(LRUCacheTest, EvictionOrder)
+{
+	testEvictionOrder<IdentityHash>();
+	testEvictionOrder<CollidingHash>();
+}
+
+TEST(LRUCacheTest, LookupThenReplace)
+{
+	testLookupThenReplace<IdentityHash>();
+	testLookupThenReplace<CollidingHash>();
+}
+
+TEST(LRUCacheTest, Resize)
+{
+	testResize<IdentityHash>();
+	testResize<CollidingHash>();
+}
+
+// The NameSpace is header-only too. Objects are only stored as pointers, so
+// plain integers stand in for them.
+class NameSpaceTest : public testing::Test
+{
+protected:
+	void TearDown() override
+	{
+		// Releases all names in ascending order, the destructor asserts they're gone
+		while(!names.empty())
+		{
+			GLuint name = names.firstName();
+			EXPECT_TRUE(names.isReserved(name));
+			names.remove(name);
+			EXPECT_FALSE(names.isReserved(name));
+		}
+	}
+
+	// Checks that visiting all names yields the expected ones in ascending order
+	void expectNames(const std::vector<GLuint> &expected)
+	{
+		ASSERT_FALSE(names.empty());
+
+		std::vector<GLuint> visited;
+		GLuint name = names.firstName();
+
+		do
+		{
+			visited.push_back(name);
+		}
+		while(names.nextName(name));
+
+		EXPECT_EQ(expected, visited);
+		EXPECT_EQ(expected.back(), names.lastName());
+	}
+
+	gl::NameSpace<int> names;
+	int object[8] = {};
+};
+
+TEST_F(NameSpaceTest, FirstNameAllocation)
+{
+	EXPECT_TRUE(names.empty());
+	EXPECT_EQ(1u, names.allocate(&object[0]));   // Zero is the default object's name
+	EXPECT_EQ(2u, names.allocate(&object[1]));
+	EXPECT_EQ(1u, names.firstName());
+	EXPECT_FALSE(names.isReserved(0));
+
+	names.insert(4, &object[2]);
+	EXPECT_EQ(3u, names.allocate(&object[3]));
+	EXPECT_EQ(5u, names.allocate(&object[4]));   // Skips the inserted name
+	expectNames({ 1, 2, 3, 4, 5 });
+
+	EXPECT_EQ(&object[0], names.find(1));
+	EXPECT_EQ(&object[2], names.find(4));
+	EXPECT_EQ(&object[4], names.find(5));
+	EXPECT_EQ(nullptr, names.find(6));
+
+	// Names can be reserved before there's an object for them
+	GLuint name = names.allocate();
+	EXPECT_EQ(6u, name);
+	EXPECT_TRUE(names.isReserved(name));
+	EXPECT_EQ(nullptr, names.find(name));
+	names.insert(name, &object[5]);
+	EXPECT_EQ(&object[5], names.find(name));
+
+	gl::NameSpace<int, 0> zeroBased;
+	EXPECT_EQ(0u, zeroBased.allocate(&object[0]));
+	EXPECT_EQ(1u, zeroBased.allocate(&object[1]));
+	EXPECT_EQ(0u, zeroBased.firstName());
+	zeroBased.remove(0);
+	zeroBased.remove(1);
+	EXPECT_TRUE(zeroBased.empty());
+}
+
+TEST_F(NameSpaceTest, SparseNames)
+{
+	// Names far beyond the allocated ones are held apart from the dense ones
+	names.insert(1000000, &object[0]);
+	EXPECT_EQ(1000000u, names.firstName());
+	EXPECT_EQ(1000000u, names.lastName());
+	EXPECT_EQ(1u, names.allocate(&object[1]));
+
+	names.insert(0xFFFFFFFF, &object[2]);
+	names.insert(0x80000000, &object[3]);
+	names.insert(200, &object[4]);
+	expectNames({ 1, 200, 1000000, 0x80000000, 0xFFFFFFFF });
+
+	EXPECT_EQ(&object[0], names.find(1000000));
+	EXPECT_EQ(&object[2], names.find(0xFFFFFFFF));
+	EXPECT_EQ(&object[3], names.find(0x80000000));
+	EXPECT_EQ(nullptr, names.find(0xFFFFFFFE));
+	EXPECT_FALSE(names.isReserved(0xFFFFFFFE));
+
+	// Growing the dense names up to the sparse ones takes them in
+	for(GLuint name = 50; name <= 150; name += 50)
+	{
+		names.insert(name, &object[5]);
+	}
+
+	expectNames({ 1, 50, 100, 150, 200, 1000000, 0x80000000, 0xFFFFFFFF });
+	EXPECT_EQ(&object[4], names.find(200));
+	EXPECT_EQ(2u, names.allocate(&object[6]));
+
+	// Inserting a name again replaces its object
+	names.insert(0xFFFFFFFF, &object[7]);
+	names.insert(200, &object[7]);
+	EXPECT_EQ(&object[7], names.find(0xFFFFFFFF));
+	EXPECT_EQ(&object[7], names.find(200));
+
+	EXPECT_EQ(&object[7], names.remove(0xFFFFFFFF));
+	EXPECT_EQ(nullptr, names.remove(0xFFFFFFFF));
+	EXPECT_EQ(0x80000000u, names.lastName());
+}
+
+TEST_F(NameSpaceTest, RemoveThenReuse)
+{
+	for(GLuint name = 1; name <= 5; name++)
+	{
+		EXPECT_EQ(name, names.allocate(&object[name]));
+	}
+
+	EXPECT_EQ(&object[3], names.remove(3));
+	EXPECT_FALSE(names.isReserved(3));
+	EXPECT_EQ(nullptr, names.find(3));
+	EXPECT_EQ(nullptr, names.remove(3));
+	EXPECT_EQ(nullptr, names.remove(7));   // Never allocated
+
+	EXPECT_EQ(3u, names.allocate(&object[0]));   // The freed name is reused
+	EXPECT_EQ(&object[0], names.find(3));
+	EXPECT_EQ(6u, names.allocate(&object[6]));
+
+	// The lowest free names get reused first
+	names.remove(4);
+	names.remove(2);
+	EXPECT_EQ(2u, names.allocate(&object[2]));
+	EXPECT_EQ(4u, names.allocate(&object[4]));
+	EXPECT_EQ(7u, names.allocate(&object[7]));
+
+	// Removing the first name changes it
+	names.remove(1);
+	EXPECT_EQ(2u, names.firstName());
+	expectNames({ 2, 3, 4, 5, 6, 7 });
+
+	// Reserved names without an object are freed as well
+	GLuint name = names.allocate();
+	EXPECT_EQ(1u, name);
+	EXPECT_EQ(nullptr, names.remove(name));
+	EXPECT_FALSE(names.isReserved(name));
+
+	// Sparse names can be reused too
+	names.insert(1000000, &object[1]);
+	EXPECT_EQ(&object[1], names.remove(1000000));
+	EXPECT_FALSE(names.isReserved(1000000));
+	names.insert(1000000, &object[2]);
+	EXPECT_EQ(&object[2], names.find(1000000));
+	EXPECT_EQ(1000000u, names.lastName());
+}
+
 #ifndef EGL_ANGLE_iosurface_client_buffer
 #define EGL_ANGLE_iosurface_client_buffer 1
 #define EGL_IOSURFACE_ANGLE 0x3454